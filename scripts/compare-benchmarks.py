@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+"""
+Compare two result files of mlpack_benchmarks (for instance, of two releases)
+and print the ratio of the median times of each configuration that is in both.
+
+  scripts/compare-benchmarks.py baseline.jsonl candidate.jsonl [--threshold 5]
+
+Configurations whose median time changed by more than the threshold (in
+percent) are marked; with --fail-on-regression, the exit code is 1 if any
+configuration got slower by more than the threshold.
+"""
+import argparse
+import json
+import sys
+
+def load(filename):
+    """Return a dict mapping (name, params) to the result record."""
+    results = {}
+    with open(filename) as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            record = json.loads(line)
+            if record.get("type") != "result":
+                continue
+            key = (record["name"],
+                   json.dumps(record["params"], sort_keys=True))
+            results[key] = record
+    return results
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compare two mlpack_benchmarks result files.")
+    parser.add_argument("baseline")
+    parser.add_argument("candidate")
+    parser.add_argument("--threshold", type=float, default=5.0,
+        help="change (in percent) of the median time to report (default 5)")
+    parser.add_argument("--fail-on-regression", action="store_true",
+        help="exit with status 1 if any configuration is slower")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    candidate = load(args.candidate)
+
+    regressions = 0
+    print("%-28s %12s %12s %8s  %s" %
+        ("name", "base (s)", "new (s)", "ratio", "params"))
+    for key in sorted(set(baseline) & set(candidate)):
+        old = baseline[key]["median_s"]
+        new = candidate[key]["median_s"]
+        ratio = (new / old) if old > 0 else float("inf")
+        change = 100.0 * (ratio - 1.0)
+        mark = ""
+        if change > args.threshold:
+            mark = "  SLOWER"
+            regressions += 1
+        elif change < -args.threshold:
+            mark = "  FASTER"
+        print("%-28s %12.6g %12.6g %8.3f  %s%s" %
+            (key[0], old, new, ratio, key[1], mark))
+
+    missing = len(set(baseline) ^ set(candidate))
+    if missing > 0:
+        print("%d configuration(s) are only in one of the files." % missing)
+
+    if args.fail_on_regression and regressions > 0:
+        sys.exit(1)
+
+if __name__ == "__main__":
+    main()
@@ -367,6 +367,7 @@ do
         "hpt.md"
         "cv.md"
         "timer.md"
+        "benchmarks.md"
         "bindings.md"
         "iodoc.md"
         "distances.md"
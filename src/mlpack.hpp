@@ -41,10 +41,13 @@
 #include "mlpack/methods/emst.hpp"
 #include "mlpack/methods/fastmks.hpp"
 #include "mlpack/methods/gmm.hpp"
+#include "mlpack/methods/hdbscan.hpp"
 #include "mlpack/methods/hmm.hpp"
+#include "mlpack/methods/hnsw.hpp"
 #include "mlpack/methods/hoeffding_trees.hpp"
 #include "mlpack/methods/kde.hpp"
 #include "mlpack/methods/kernel_pca.hpp"
+#include "mlpack/methods/kernel_svm.hpp"
 #include "mlpack/methods/kmeans.hpp"
 #include "mlpack/methods/lars.hpp"
 #include "mlpack/methods/linear_regression.hpp"
@@ -62,6 +65,7 @@
 #include "mlpack/methods/nystroem_method.hpp"
 #include "mlpack/methods/pca.hpp"
 #include "mlpack/methods/perceptron.hpp"
+#include "mlpack/methods/pq.hpp"
 #include "mlpack/methods/preprocess.hpp"
 #include "mlpack/methods/quic_svd.hpp"
 #include "mlpack/methods/radical.hpp"
@@ -69,12 +73,14 @@
 #include "mlpack/methods/randomized_svd.hpp"
 #include "mlpack/methods/range_search.hpp"
 #include "mlpack/methods/rann.hpp"
+#include "mlpack/methods/regularization_path.hpp"
 #include "mlpack/methods/regularized_svd.hpp"
 #include "mlpack/methods/reinforcement_learning.hpp"
 #include "mlpack/methods/softmax_regression.hpp"
 #include "mlpack/methods/sparse_autoencoder.hpp"
 #include "mlpack/methods/sparse_coding.hpp"
 #include "mlpack/methods/svdplusplus.hpp"
+#include "mlpack/methods/xgboost.hpp"
 
 // Include reverse compatibility.
 #include "mlpack/namespace_compat.hpp"
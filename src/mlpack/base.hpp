@@ -81,6 +81,21 @@
   #error "Need to enable C++17 mode in your compiler"
 #endif
 
+// If requested, Armadillo allocates memory through MemoryTracker, so that the
+// memory held by matrices is tracked.  This must be set before Armadillo is
+// included.
+#include <mlpack/core/util/memory_tracker.hpp>
+#ifdef MLPACK_TRACK_ARMA_MEMORY
+  #if defined(ARMA_INCLUDES)
+    #error "MLPACK_TRACK_ARMA_MEMORY must be set before including Armadillo"
+  #elif defined(ARMA_ALIEN_MEM_ALLOC_FUNCTION)
+    #error "MLPACK_TRACK_ARMA_MEMORY cannot be used with another allocator"
+  #endif
+  #define ARMA_ALIEN_MEM_ALLOC_FUNCTION \
+      mlpack::util::MemoryTracker::ArmaAllocate
+  #define ARMA_ALIEN_MEM_FREE_FUNCTION mlpack::util::MemoryTracker::ArmaFree
+#endif
+
 // Now include Armadillo and traits that we use for it.
 #include <armadillo>
 #include <mlpack/core/util/arma_traits.hpp>
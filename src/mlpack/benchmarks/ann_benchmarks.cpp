@@ -0,0 +1,97 @@
+/**
+ * @file benchmarks/ann_benchmarks.cpp
+ *
+ * Benchmarks of the forward pass, the backward pass and the gradient of
+ * individual neural network layers, on a batch of random inputs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+/**
+ * Benchmark Forward(), Backward() and Gradient() of the given layer, with the
+ * given input dimensions and batch size.  The weights are random.
+ */
+template<typename LayerType>
+static void LayerBenchmarks(BenchmarkRunner& runner,
+                            LayerType& layer,
+                            const std::vector<size_t>& inputDimensions,
+                            const size_t batchSize,
+                            BenchmarkParams params)
+{
+  layer.InputDimensions() = inputDimensions;
+  layer.ComputeOutputDimensions();
+
+  // The layer uses the memory of the weights, so they must outlive it.
+  arma::mat weights(layer.WeightSize(), 1, arma::fill::randn);
+  weights *= 0.01;
+  layer.SetWeights(weights);
+
+  size_t inputSize = 1;
+  for (const size_t d : inputDimensions)
+    inputSize *= d;
+
+  const arma::mat input(inputSize, batchSize, arma::fill::randu);
+  arma::mat output(layer.OutputSize(), batchSize);
+  const arma::mat error(layer.OutputSize(), batchSize, arma::fill::randn);
+  arma::mat delta(inputSize, batchSize);
+  arma::mat gradient(layer.WeightSize(), 1);
+
+  params.Add("batch_size", batchSize);
+  runner.Run("ann/forward", params, [&]()
+  {
+    layer.Forward(input, output);
+    DoNotOptimize(output);
+  }, batchSize);
+
+  // Backward() may use the results of the last Forward().
+  layer.Forward(input, output);
+  runner.Run("ann/backward", params, [&]()
+  {
+    layer.Backward(input, output, error, delta);
+    DoNotOptimize(delta);
+  }, batchSize);
+
+  runner.Run("ann/gradient", params, [&]()
+  {
+    layer.Gradient(input, error, gradient);
+    DoNotOptimize(gradient);
+  }, batchSize);
+}
+
+MLPACK_BENCHMARK(ANNBenchmarkGroup)
+{
+  const size_t batchSize = runner.Scaled(256);
+
+  for (const size_t size : { 64, 512, 2048 })
+  {
+    Linear linear(size);
+    BenchmarkParams params;
+    params.Add("layer", "linear").Add("in", size).Add("out", size);
+    LayerBenchmarks(runner, linear, { size }, batchSize, params);
+  }
+
+  // A LeNet-like first layer (one 28x28 map) and a deeper layer (16 32x32
+  // maps), both with 3x3 kernels.
+  const std::vector<std::vector<size_t>> convInputs = {
+      { 28, 28, 1 }, { 32, 32, 16 } };
+  for (const std::vector<size_t>& inputDimensions : convInputs)
+  {
+    Convolution convolution(16, 3, 3, 1, 1, 1, 1, "none");
+    BenchmarkParams params;
+    params.Add("layer", "convolution").Add("width", inputDimensions[0])
+        .Add("height", inputDimensions[1]).Add("in_maps", inputDimensions[2])
+        .Add("out_maps", 16).Add("kernel", 3);
+    LayerBenchmarks(runner, convolution, inputDimensions,
+        std::max(batchSize / 8, (size_t) 1), params);
+  }
+}
@@ -0,0 +1,279 @@
+/**
+ * @file benchmarks/benchmark.hpp
+ *
+ * A small harness for the mlpack_benchmarks suite.  Each benchmark group is a
+ * function registered with MLPACK_BENCHMARK(); it generates its data and calls
+ * BenchmarkRunner::Run() once per configuration that it measures.  Every
+ * measurement is written as one JSON object per line (JSON Lines), so that
+ * the results of two runs (for instance, of two releases) can be compared
+ * with a script.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BENCHMARKS_BENCHMARK_HPP
+#define MLPACK_BENCHMARKS_BENCHMARK_HPP
+
+#include <mlpack/core.hpp>
+
+#include <chrono>
+#include <functional>
+#include <iomanip>
+
+namespace mlpack {
+namespace benchmarks {
+
+//! Options shared by all benchmarks, given on the command line.
+struct BenchmarkOptions
+{
+  //! Number of timed runs of each configuration.
+  size_t repetitions = 5;
+  //! Number of untimed runs of each configuration before the timed runs.
+  size_t warmups = 1;
+  //! Factor applied to the problem sizes of all benchmarks.
+  double scale = 1.0;
+  //! Random seed; it is set before each benchmark group, so the data of a
+  //! group does not depend on which other groups are run.
+  size_t seed = 42;
+  //! Only configurations whose name contains this string are run.
+  std::string filter;
+};
+
+/**
+ * The parameters of one benchmark configuration (e.g. the tree type and the
+ * leaf size), written with its result.
+ */
+class BenchmarkParams
+{
+ public:
+  //! Add a string parameter.
+  BenchmarkParams& Add(const std::string& name, const std::string& value)
+  {
+    params.emplace_back(name, Quote(value));
+    return *this;
+  }
+
+  //! Add a string parameter.
+  BenchmarkParams& Add(const std::string& name, const char* value)
+  {
+    return Add(name, std::string(value));
+  }
+
+  //! Add a numeric parameter.
+  template<typename T>
+  BenchmarkParams& Add(const std::string& name,
+                       const T value,
+                       const std::enable_if_t<std::is_arithmetic_v<T>>* = 0)
+  {
+    std::ostringstream oss;
+    oss << std::setprecision(17) << value;
+    params.emplace_back(name, oss.str());
+    return *this;
+  }
+
+  //! Write the parameters as a JSON object.
+  std::string ToJSON() const
+  {
+    std::string json = "{";
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+      json += (i > 0 ? ", " : "") + Quote(params[i].first) + ": " +
+          params[i].second;
+    }
+    return json + "}";
+  }
+
+  //! Quote and escape the given string for JSON.
+  static std::string Quote(const std::string& str)
+  {
+    std::string quoted = "\"";
+    for (const char c : str)
+    {
+      if (c == '"' || c == '\\')
+        quoted += std::string("\\") + c;
+      else if (c == '\n')
+        quoted += "\\n";
+      else
+        quoted += c;
+    }
+    return quoted + "\"";
+  }
+
+ private:
+  //! The names and (JSON-formatted) values of the parameters.
+  std::vector<std::pair<std::string, std::string>> params;
+};
+
+/**
+ * Prevent the compiler from optimizing away the computation of the given
+ * value.
+ */
+template<typename T>
+inline void DoNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r"(&value) : "memory");
+#else
+  static volatile const void* sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * The BenchmarkRunner times configurations and writes their results.
+ */
+class BenchmarkRunner
+{
+ public:
+  /**
+   * Create the runner.
+   *
+   * @param options Options of the run.
+   * @param output Stream to write the results to.
+   */
+  BenchmarkRunner(const BenchmarkOptions& options, std::ostream& output) :
+      options(options),
+      output(output),
+      failures(0)
+  { }
+
+  //! Return whether configurations with the given name are run.
+  bool Enabled(const std::string& name) const
+  {
+    return options.filter.empty() ||
+        name.find(options.filter) != std::string::npos;
+  }
+
+  //! Scale the given problem size by the --scale option (to at least 1).
+  size_t Scaled(const size_t n) const
+  {
+    return std::max((size_t) 1, (size_t) std::llround(n * options.scale));
+  }
+
+  /**
+   * Time the given function, after the warmup runs, and write one result
+   * record with the given name and parameters.  The function is run
+   * `options.repetitions` times; the minimum, median, mean and standard
+   * deviation of the times are written.  If `items` is nonzero, the number of
+   * items processed per second (at the median time) is written too.
+   *
+   * If the function throws, the error is written instead of the times, and
+   * the failure is counted.
+   *
+   * @param name Name of the configuration, like "knn/search".
+   * @param params Parameters of the configuration.
+   * @param f Function to time.
+   * @param items Number of items (points, bytes, ...) processed by one run.
+   */
+  template<typename FunctionType>
+  void Run(const std::string& name,
+           const BenchmarkParams& params,
+           FunctionType&& f,
+           const size_t items = 0)
+  {
+    if (!Enabled(name))
+      return;
+
+    std::vector<double> times;
+    try
+    {
+      for (size_t i = 0; i < options.warmups; ++i)
+        f();
+
+      for (size_t i = 0; i < std::max(options.repetitions, (size_t) 1); ++i)
+      {
+        const auto start = std::chrono::steady_clock::now();
+        f();
+        const auto end = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double>(end - start).count());
+      }
+    }
+    catch (std::exception& e)
+    {
+      ++failures;
+      output << "{\"type\": \"error\", \"name\": " <<
+          BenchmarkParams::Quote(name) << ", \"params\": " << params.ToJSON()
+          << ", \"what\": " << BenchmarkParams::Quote(e.what()) << "}"
+          << std::endl;
+      return;
+    }
+
+    std::sort(times.begin(), times.end());
+    const size_t n = times.size();
+    const double median = (n % 2 == 1) ? times[n / 2] :
+        0.5 * (times[n / 2 - 1] + times[n / 2]);
+    double mean = 0.0;
+    for (const double t : times)
+      mean += t / n;
+    double variance = 0.0;
+    for (const double t : times)
+      variance += (t - mean) * (t - mean);
+    const double stddev = (n > 1) ? std::sqrt(variance / (n - 1)) : 0.0;
+
+    output << std::setprecision(9) << "{\"type\": \"result\", \"name\": " <<
+        BenchmarkParams::Quote(name) << ", \"params\": " << params.ToJSON() <<
+        ", \"repetitions\": " << n << ", \"min_s\": " << times[0] <<
+        ", \"median_s\": " << median << ", \"mean_s\": " << mean <<
+        ", \"stddev_s\": " << stddev;
+    if (items > 0 && median > 0.0)
+      output << ", \"items_per_s\": " << (items / median);
+    output << "}" << std::endl;
+  }
+
+  //! Get the options of the run.
+  const BenchmarkOptions& Options() const { return options; }
+
+  //! Get the number of configurations that failed.
+  size_t Failures() const { return failures; }
+
+ private:
+  //! The options of the run.
+  const BenchmarkOptions& options;
+  //! The stream to write the results to.
+  std::ostream& output;
+  //! The number of configurations that failed.
+  size_t failures;
+};
+
+//! The type of a benchmark group.
+using BenchmarkFunction = std::function<void(BenchmarkRunner&)>;
+
+//! Get the list of registered benchmark groups.
+inline std::vector<std::pair<std::string, BenchmarkFunction>>& Registry()
+{
+  static std::vector<std::pair<std::string, BenchmarkFunction>> registry;
+  return registry;
+}
+
+//! Register a benchmark group; used by MLPACK_BENCHMARK().
+inline bool RegisterBenchmark(const std::string& name, BenchmarkFunction f)
+{
+  Registry().emplace_back(name, std::move(f));
+  return true;
+}
+
+} // namespace benchmarks
+} // namespace mlpack
+
+/**
+ * Define and register a benchmark group.  Use it like a function definition
+ * that takes a `BenchmarkRunner& runner`:
+ *
+ * @code
+ * MLPACK_BENCHMARK(LinearRegressionBenchmarks)
+ * {
+ *   arma::mat data(10, runner.Scaled(100000), arma::fill::randu);
+ *   ...
+ *   runner.Run("linear_regression/train", BenchmarkParams(), [&]() { ... });
+ * }
+ * @endcode
+ */
+#define MLPACK_BENCHMARK(NAME) \
+    static void NAME(mlpack::benchmarks::BenchmarkRunner& runner); \
+    static const bool NAME##Registered = \
+        mlpack::benchmarks::RegisterBenchmark(#NAME, NAME); \
+    static void NAME(mlpack::benchmarks::BenchmarkRunner& runner)
+
+#endif
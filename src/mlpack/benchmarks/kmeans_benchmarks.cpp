@@ -0,0 +1,82 @@
+/**
+ * @file benchmarks/kmeans_benchmarks.cpp
+ *
+ * Benchmarks of the k-means Lloyd step types: one iteration (a
+ * microbenchmark) and a full clustering from fixed initial centroids (a
+ * macrobenchmark).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+/**
+ * Benchmark one Lloyd iteration of the given step type (including the setup
+ * of the step type, such as building a tree, since that is part of the cost of
+ * the first iteration), and a full clustering with at most 10 iterations.
+ * Both start from the same initial centroids.
+ */
+template<template<typename, typename> class StepType>
+static void StepBenchmarks(BenchmarkRunner& runner,
+                           const std::string& stepName,
+                           const arma::mat& data,
+                           const arma::mat& initialCentroids)
+{
+  BenchmarkParams params;
+  params.Add("step", stepName).Add("n", data.n_cols).Add("d", data.n_rows)
+      .Add("k", initialCentroids.n_cols);
+
+  runner.Run("kmeans/iterate", params, [&]()
+  {
+    EuclideanDistance distance;
+    StepType<EuclideanDistance, arma::mat> step(data, distance);
+    arma::mat newCentroids;
+    arma::Col<size_t> counts;
+    DoNotOptimize(step.Iterate(initialCentroids, newCentroids, counts));
+  }, data.n_cols);
+
+  BenchmarkParams clusterParams = params;
+  clusterParams.Add("max_iterations", 10);
+  runner.Run("kmeans/cluster", clusterParams, [&]()
+  {
+    KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+        StepType> kmeans(10);
+    arma::mat centroids = initialCentroids;
+    kmeans.Cluster(data, centroids.n_cols, centroids, true);
+    DoNotOptimize(centroids);
+  }, data.n_cols);
+}
+
+MLPACK_BENCHMARK(KMeansBenchmarkGroup)
+{
+  // 50 well-separated Gaussian clusters in 10 dimensions; the initial
+  // centroids are random points of the dataset.
+  const size_t k = 50;
+  arma::mat data(10, runner.Scaled(100000), arma::fill::randn);
+  const arma::mat centers = 20.0 * arma::mat(10, k, arma::fill::randu);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) += centers.col(i % k);
+
+  const arma::uvec initial = arma::randperm(data.n_cols,
+      std::min(k, (size_t) data.n_cols));
+  const arma::mat initialCentroids = data.cols(initial);
+
+  StepBenchmarks<NaiveKMeans>(runner, "naive", data, initialCentroids);
+  StepBenchmarks<BlasKMeans>(runner, "blas", data, initialCentroids);
+  StepBenchmarks<ElkanKMeans>(runner, "elkan", data, initialCentroids);
+  StepBenchmarks<HamerlyKMeans>(runner, "hamerly", data, initialCentroids);
+  StepBenchmarks<PellegMooreKMeans>(runner, "pelleg_moore", data,
+      initialCentroids);
+  StepBenchmarks<DefaultDualTreeKMeans>(runner, "dual_tree", data,
+      initialCentroids);
+  StepBenchmarks<CoverTreeDualTreeKMeans>(runner, "dual_tree_cover", data,
+      initialCentroids);
+}
@@ -0,0 +1,62 @@
+/**
+ * @file benchmarks/load_save_benchmarks.cpp
+ *
+ * Benchmarks of saving and loading numeric matrices in each file format.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include "benchmark.hpp"
+
+#include <filesystem>
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+MLPACK_BENCHMARK(LoadSaveBenchmarkGroup)
+{
+  const arma::mat data(20, runner.Scaled(200000), arma::fill::randu);
+
+  // The files are written to the temporary directory, and removed at the end.
+  const std::filesystem::path dir = std::filesystem::temp_directory_path();
+  const std::vector<std::pair<std::string, std::string>> formats = {
+      { "csv", "csv" }, { "tsv", "tsv" }, { "txt", "raw_ascii" },
+      { "bin", "arma_binary" } };
+
+  for (const auto& format : formats)
+  {
+    const std::string filename = (dir / ("mlpack_benchmark_data." +
+        format.first)).string();
+
+    BenchmarkParams params;
+    params.Add("format", format.second).Add("n", data.n_cols)
+        .Add("d", data.n_rows);
+
+    runner.Run("data/save", params, [&]()
+    {
+      data::Save(filename, data, true);
+    }, data.n_cols);
+
+    // The data/load benchmark needs the file even if data/save is filtered
+    // out.
+    if (runner.Enabled("data/load"))
+    {
+      data::Save(filename, data, true);
+      BenchmarkParams loadParams = params;
+      loadParams.Add("bytes", std::filesystem::file_size(filename));
+      runner.Run("data/load", loadParams, [&]()
+      {
+        arma::mat loaded;
+        data::Load(filename, loaded, true);
+        DoNotOptimize(loaded);
+      }, data.n_cols);
+    }
+
+    std::error_code error;
+    std::filesystem::remove(filename, error);
+  }
+}
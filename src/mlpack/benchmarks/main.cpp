@@ -0,0 +1,159 @@
+/**
+ * @file benchmarks/main.cpp
+ *
+ * Main file for the mlpack_benchmarks suite.  This parses the options, writes
+ * a context record (versions, number of threads and options) and runs every
+ * registered benchmark group.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include "benchmark.hpp"
+
+#include <fstream>
+
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+static void PrintUsage(const char* program)
+{
+  std::cerr << "Usage: " << program << " [options]" << std::endl
+      << std::endl
+      << "Options:" << std::endl
+      << "  --filter <string>     Only run configurations whose name contains "
+      << "<string>." << std::endl
+      << "  --repetitions <n>     Number of timed runs of each configuration "
+      << "(default 5)." << std::endl
+      << "  --warmups <n>         Number of untimed runs before the timed runs "
+      << "(default 1)." << std::endl
+      << "  --scale <factor>      Scale the problem sizes (default 1)."
+      << std::endl
+      << "  --seed <n>            Random seed (default 42)." << std::endl
+      << "  --output <file>       Write the results to <file> instead of "
+      << "stdout." << std::endl
+      << "  --list                List the benchmark groups and exit."
+      << std::endl
+      << "  --help                Print this message and exit." << std::endl
+      << std::endl
+      << "Results are written as JSON Lines: a \"context\" record, then one "
+      << "\"result\" (or" << std::endl
+      << "\"error\") record per configuration." << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  BenchmarkOptions options;
+  std::string outputFile;
+  bool list = false;
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      const std::string arg = argv[i];
+      const bool hasValue = (i + 1 < argc);
+      if (arg == "--help" || arg == "-h")
+      {
+        PrintUsage(argv[0]);
+        return 0;
+      }
+      else if (arg == "--list")
+      {
+        list = true;
+      }
+      else if (arg == "--filter" && hasValue)
+      {
+        options.filter = argv[++i];
+      }
+      else if (arg == "--repetitions" && hasValue)
+      {
+        options.repetitions = std::stoul(argv[++i]);
+      }
+      else if (arg == "--warmups" && hasValue)
+      {
+        options.warmups = std::stoul(argv[++i]);
+      }
+      else if (arg == "--scale" && hasValue)
+      {
+        options.scale = std::stod(argv[++i]);
+      }
+      else if (arg == "--seed" && hasValue)
+      {
+        options.seed = std::stoul(argv[++i]);
+      }
+      else if (arg == "--output" && hasValue)
+      {
+        outputFile = argv[++i];
+      }
+      else
+      {
+        std::cerr << "Unknown or incomplete option '" << arg << "'."
+            << std::endl << std::endl;
+        PrintUsage(argv[0]);
+        return 1;
+      }
+    }
+  }
+  catch (std::exception& e)
+  {
+    std::cerr << "Invalid option value: " << e.what() << std::endl;
+    return 1;
+  }
+
+  // Run the groups in a fixed order, whatever the order of linking.
+  std::sort(Registry().begin(), Registry().end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  if (list)
+  {
+    for (const auto& benchmark : Registry())
+      std::cout << benchmark.first << std::endl;
+    return 0;
+  }
+
+  std::ofstream file;
+  if (!outputFile.empty())
+  {
+    file.open(outputFile);
+    if (!file.is_open())
+    {
+      std::cerr << "Cannot open '" << outputFile << "' for writing."
+          << std::endl;
+      return 1;
+    }
+  }
+  std::ostream& output = outputFile.empty() ? std::cout : file;
+
+  #ifdef MLPACK_USE_OPENMP
+  const size_t threads = omp_get_max_threads();
+  #else
+  const size_t threads = 1;
+  #endif
+
+  output << "{\"type\": \"context\", \"mlpack_version\": " <<
+      BenchmarkParams::Quote(util::GetVersion()) <<
+      ", \"armadillo_version\": " <<
+      BenchmarkParams::Quote(arma::arma_version::as_string()) <<
+      ", \"threads\": " << threads <<
+      ", \"repetitions\": " << options.repetitions <<
+      ", \"warmups\": " << options.warmups <<
+      ", \"scale\": " << options.scale <<
+      ", \"seed\": " << options.seed <<
+      ", \"filter\": " << BenchmarkParams::Quote(options.filter) << "}"
+      << std::endl;
+
+  BenchmarkRunner runner(options, output);
+  for (const auto& benchmark : Registry())
+  {
+    RandomSeed(options.seed);
+    benchmark.second(runner);
+  }
+
+  return (runner.Failures() == 0) ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+/**
+ * @file benchmarks/serialization_benchmarks.cpp
+ *
+ * Benchmarks of saving and loading models with cereal, in memory, in the
+ * binary and JSON formats.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+#include <mlpack/methods/gmm.hpp>
+#include <mlpack/methods/linear_regression.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+/**
+ * Benchmark saving the given model to a string (with the given output archive
+ * type) and loading it back (with the given input archive type).  The number
+ * of items of the results is the size of the serialized model in bytes.
+ */
+template<typename IArchiveType, typename OArchiveType, typename ModelType>
+static void ArchiveBenchmarks(BenchmarkRunner& runner,
+                              const std::string& modelName,
+                              const std::string& formatName,
+                              ModelType& model)
+{
+  // Serialize once to get the size of the model.
+  std::string serialized;
+  {
+    std::ostringstream oss;
+    {
+      OArchiveType ar(oss);
+      ar(cereal::make_nvp("model", model));
+    }
+    serialized = oss.str();
+  }
+
+  BenchmarkParams params;
+  params.Add("model", modelName).Add("format", formatName)
+      .Add("bytes", serialized.size());
+
+  runner.Run("serialization/save", params, [&]()
+  {
+    std::ostringstream oss;
+    {
+      OArchiveType ar(oss);
+      ar(cereal::make_nvp("model", model));
+    }
+    DoNotOptimize(oss);
+  }, serialized.size());
+
+  runner.Run("serialization/load", params, [&]()
+  {
+    std::istringstream iss(serialized);
+    ModelType loaded;
+    {
+      IArchiveType ar(iss);
+      ar(cereal::make_nvp("model", loaded));
+    }
+    DoNotOptimize(loaded);
+  }, serialized.size());
+}
+
+//! Benchmark the given model with the binary and JSON archives.
+template<typename ModelType>
+static void SerializationBenchmarks(BenchmarkRunner& runner,
+                                    const std::string& modelName,
+                                    ModelType& model)
+{
+  ArchiveBenchmarks<cereal::BinaryInputArchive, cereal::BinaryOutputArchive>(
+      runner, modelName, "binary", model);
+  ArchiveBenchmarks<cereal::JSONInputArchive, cereal::JSONOutputArchive>(
+      runner, modelName, "json", model);
+}
+
+MLPACK_BENCHMARK(SerializationBenchmarkGroup)
+{
+  if (!runner.Enabled("serialization/save") &&
+      !runner.Enabled("serialization/load"))
+    return;
+
+  // A kd-tree nearest neighbor model holds the tree and the dataset.
+  {
+    const arma::mat data(3, runner.Scaled(100000), arma::fill::randu);
+    KNN knn(data);
+    SerializationBenchmarks(runner, "knn_kd_tree", knn);
+  }
+
+  // A small mixture of Gaussians.
+  {
+    const arma::mat data(10, runner.Scaled(10000), arma::fill::randn);
+    GMM gmm(20, 10);
+    gmm.Train(data, 1, false, EMFit<>(5));
+    SerializationBenchmarks(runner, "gmm", gmm);
+  }
+
+  // A linear model with many dimensions.
+  {
+    const arma::mat data(1000, runner.Scaled(5000), arma::fill::randu);
+    const arma::rowvec responses(data.n_cols, arma::fill::randu);
+    LinearRegression<> lr(data, responses);
+    SerializationBenchmarks(runner, "linear_regression", lr);
+  }
+
+  // A multilayer perceptron with about 1.3 million weights.
+  {
+    FFN<MeanSquaredError> ffn;
+    ffn.Add<Linear>(1024);
+    ffn.Add<ReLU>();
+    ffn.Add<Linear>(512);
+    ffn.Add<ReLU>();
+    ffn.Add<Linear>(10);
+    ffn.Reset(784);
+    SerializationBenchmarks(runner, "ffn_mlp", ffn);
+  }
+}
@@ -0,0 +1,131 @@
+/**
+ * @file benchmarks/tree_benchmarks.cpp
+ *
+ * Benchmarks of tree construction and of k-nearest-neighbor search with each
+ * tree type, for several leaf sizes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+#include "benchmark.hpp"
+
+using namespace mlpack;
+using namespace mlpack::benchmarks;
+
+/**
+ * Benchmark the construction of a tree of the given type with the given leaf
+ * size, and dual-tree and single-tree 5-nearest-neighbor search on it.
+ */
+template<template<typename, typename, typename> class TreeType>
+static void TreeBenchmarks(BenchmarkRunner& runner,
+                           const std::string& treeName,
+                           const arma::mat& data,
+                           const std::string& dataName,
+                           const size_t leafSize)
+{
+  using KNNType = NeighborSearch<NearestNeighborSort, EuclideanDistance,
+      arma::mat, TreeType>;
+  using Tree = typename KNNType::Tree;
+
+  BenchmarkParams params;
+  params.Add("tree", treeName).Add("data", dataName).Add("n", data.n_cols)
+      .Add("d", data.n_rows).Add("leaf_size", leafSize);
+
+  runner.Run("tree/build", params, [&]()
+  {
+    std::vector<size_t> oldFromNew;
+    Tree tree(data, oldFromNew, leafSize);
+    DoNotOptimize(tree);
+  }, data.n_cols);
+
+  if (!runner.Enabled("tree/knn_dual_tree") &&
+      !runner.Enabled("tree/knn_single_tree"))
+    return;
+
+  std::vector<size_t> oldFromNew;
+  KNNType knn(Tree(data, oldFromNew, leafSize));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  BenchmarkParams searchParams = params;
+  searchParams.Add("k", 5);
+  runner.Run("tree/knn_dual_tree", searchParams, [&]()
+  {
+    knn.Search(5, neighbors, distances);
+  }, data.n_cols);
+
+  knn.SearchMode() = SINGLE_TREE_MODE;
+  runner.Run("tree/knn_single_tree", searchParams, [&]()
+  {
+    knn.Search(5, neighbors, distances);
+  }, data.n_cols);
+}
+
+/**
+ * The cover tree has no leaf size; benchmark it with the default base.
+ */
+static void CoverTreeBenchmarks(BenchmarkRunner& runner,
+                                const arma::mat& data,
+                                const std::string& dataName)
+{
+  using KNNType = NeighborSearch<NearestNeighborSort, EuclideanDistance,
+      arma::mat, StandardCoverTree>;
+  using Tree = typename KNNType::Tree;
+
+  BenchmarkParams params;
+  params.Add("tree", "cover").Add("data", dataName).Add("n", data.n_cols)
+      .Add("d", data.n_rows).Add("base", 2.0);
+
+  runner.Run("tree/build", params, [&]()
+  {
+    Tree tree(data, 2.0);
+    DoNotOptimize(tree);
+  }, data.n_cols);
+
+  if (!runner.Enabled("tree/knn_dual_tree"))
+    return;
+
+  KNNType knn(Tree(data, 2.0));
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+
+  BenchmarkParams searchParams = params;
+  searchParams.Add("k", 5);
+  runner.Run("tree/knn_dual_tree", searchParams, [&]()
+  {
+    knn.Search(5, neighbors, distances);
+  }, data.n_cols);
+}
+
+MLPACK_BENCHMARK(TreeBenchmarkGroup)
+{
+  // A low-dimensional dataset (like a point cloud), and a clustered dataset of
+  // moderate dimensionality.
+  const arma::mat uniform(3, runner.Scaled(100000), arma::fill::randu);
+
+  arma::mat clustered(10, runner.Scaled(50000), arma::fill::randn);
+  const arma::mat centers(10, 20, arma::fill::randu);
+  for (size_t i = 0; i < clustered.n_cols; ++i)
+    clustered.col(i) = 0.05 * clustered.col(i) + 10.0 * centers.col(i % 20);
+
+  for (const size_t leafSize : { 5, 20, 80 })
+  {
+    TreeBenchmarks<KDTree>(runner, "kd", uniform, "uniform_3d", leafSize);
+    TreeBenchmarks<KDTree>(runner, "kd", clustered, "clustered_10d",
+        leafSize);
+    TreeBenchmarks<BallTree>(runner, "ball", uniform, "uniform_3d", leafSize);
+    TreeBenchmarks<BallTree>(runner, "ball", clustered, "clustered_10d",
+        leafSize);
+    TreeBenchmarks<VPTree>(runner, "vp", clustered, "clustered_10d",
+        leafSize);
+    TreeBenchmarks<Octree>(runner, "octree", uniform, "uniform_3d", leafSize);
+  }
+
+  CoverTreeBenchmarks(runner, uniform, "uniform_3d");
+  CoverTreeBenchmarks(runner, clustered, "clustered_10d");
+}
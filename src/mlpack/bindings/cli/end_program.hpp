@@ -15,15 +15,59 @@
 
 #include <mlpack/core/util/io.hpp>
 
+#include <unordered_set>
+
 namespace mlpack {
 namespace bindings {
 namespace cli {
 
+/**
+ * Delete the memory held by the parameters (i.e. the models).  The same
+ * pointer may be held twice, and it is only deleted once.  Memory at any of
+ * the addresses in `keep` is not deleted; the serving mode uses this to hold
+ * on to the input models between requests.
+ */
+inline void DeleteParamsMemory(util::Params& params,
+                               const std::unordered_set<void*>& keep = {})
+{
+  // If we are holding any pointers, then we "own" them.  But we may hold the
+  // same pointer twice, so we have to be careful to not delete it multiple
+  // times.
+  std::map<std::string, util::ParamData>& parameters = params.Parameters();
+  std::unordered_map<void*, util::ParamData*> memoryAddresses;
+  for (auto& it : parameters)
+  {
+    util::ParamData& data = it.second;
+
+    void* result;
+    params.functionMap[data.tname]["GetAllocatedMemory"](data, NULL,
+        (void*) &result);
+    if (result != NULL && memoryAddresses.count(result) == 0 &&
+        keep.count(result) == 0)
+      memoryAddresses[result] = &data;
+  }
+
+  // Now we have all the unique addresses that need to be deleted.
+  std::unordered_map<void*, util::ParamData*>::const_iterator it2;
+  it2 = memoryAddresses.begin();
+  while (it2 != memoryAddresses.end())
+  {
+    util::ParamData& data = *(it2->second);
+
+    params.functionMap[data.tname]["DeleteAllocatedMemory"](data, NULL, NULL);
+
+    ++it2;
+  }
+}
+
 /**
  * Handle command-line program termination.  If --help or --info was passed, we
  * won't make it here, so we don't have to write any contingencies for that.
+ * The models at the addresses in `keep` are not deleted.
  */
-inline void EndProgram(util::Params& params, util::Timers& timers)
+inline void EndProgram(util::Params& params,
+                       util::Timers& timers,
+                       const std::unordered_set<void*>& keep = {})
 {
   // Stop the timers.
   timers.StopAllTimers();
@@ -77,34 +121,31 @@ inline void EndProgram(util::Params& params, util::Timers& timers)
     {
       Log::Info << "  " << it2.first << ": " << timers.Print(it2.second);
     }
-  }
 
-  // Lastly clean up any memory.  If we are holding any pointers, then we "own"
-  // them.  But we may hold the same pointer twice, so we have to be careful to
-  // not delete it multiple times.
-  std::unordered_map<void*, util::ParamData*> memoryAddresses;
-  for (auto& it : parameters)
-  {
-    util::ParamData& data = it.second;
-
-    void* result;
-    params.functionMap[data.tname]["GetAllocatedMemory"](data, NULL,
-        (void*) &result);
-    if (result != NULL && memoryAddresses.count(result) == 0)
-      memoryAddresses[result] = &data;
+    // Print the memory used during each timer, merged in the same way.
+    std::map<std::string, util::PhaseMemory> memoryMap =
+        timers.GetAllMemory();
+    std::map<std::string, util::PhaseMemory> globalMemoryMap =
+        Timer::GetAllMemory();
+    for (auto& it : globalMemoryMap)
+      memoryMap[it.first].Merge(it.second);
+
+    Log::Info << "Program memory (peak resident set size; peak tracked "
+        << "memory; tracked allocations):" << std::endl;
+    for (auto& it2 : memoryMap)
+    {
+      const util::PhaseMemory& m = it2.second;
+      Log::Info << "  " << it2.first << ": "
+          << ((m.peakRSS > 0) ? util::Timers::PrintBytes(m.peakRSS) :
+              std::string("unknown")) << "; "
+          << util::Timers::PrintBytes(m.peakTrackedBytes) << "; "
+          << m.allocations << " ("
+          << util::Timers::PrintBytes(m.allocatedBytes) << ")" << std::endl;
+    }
   }
 
-  // Now we have all the unique addresses that need to be deleted.
-  std::unordered_map<void*, util::ParamData*>::const_iterator it2;
-  it2 = memoryAddresses.begin();
-  while (it2 != memoryAddresses.end())
-  {
-    util::ParamData& data = *(it2->second);
-
-    params.functionMap[data.tname]["DeleteAllocatedMemory"](data, NULL, NULL);
-
-    ++it2;
-  }
+  // Lastly clean up any memory.
+  DeleteParamsMemory(params, keep);
 }
 
 } // namespace cli
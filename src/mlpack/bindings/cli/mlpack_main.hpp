@@ -88,6 +88,7 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/io.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 // Forward definition of the binding function.
 void BINDING_FUNCTION(mlpack::util::Params&, mlpack::util::Timers&);
@@ -98,11 +99,27 @@ int main(int argc, char** argv)
   // Parse the command-line options; put them into CLI.
   mlpack::util::Params params =
       mlpack::bindings::cli::ParseCommandLine(argc, argv);
+
+  // In serving mode, the binding is run for each request read from stdin.
+  if (params.Has("serve"))
+  {
+    mlpack::Timer::EnableTiming();
+    mlpack::bindings::cli::Serve(argc, argv, BINDING_FUNCTION);
+    return 0;
+  }
+
   // Create a new timer object for this call.
   mlpack::util::Timers timers;
   timers.Enabled() = true;
   mlpack::Timer::EnableTiming();
 
+  // With --verbose, the memory used during each timer is printed too.
+  if (params.Has("verbose"))
+  {
+    timers.MemoryTracking() = true;
+    mlpack::Timer::EnableMemoryTracking();
+  }
+
   // A "total_time" timer is run by default for each mlpack program.
   timers.Start("total_time");
   BINDING_FUNCTION(params, timers);
@@ -123,5 +140,13 @@ PARAM_GLOBAL(bool, "verbose", "Display informational messages and the full "
     false, true, false, false);
 PARAM_GLOBAL(bool, "version", "Display the version of mlpack.", "V", "bool",
     false, true, false, false);
+PARAM_GLOBAL(int, "threads", "Maximum number of threads used by mlpack and by "
+    "the BLAS library (if it is OpenBLAS or MKL); 0 uses the default.", "",
+    "int", false, true, false, 0);
+PARAM_GLOBAL(bool, "serve", "Serve requests from standard input: each line "
+    "holds the options of one run, which are added to the given options.  "
+    "Input models are only loaded once.  After each run, 'done' or an 'error: '"
+    " message is printed on its own line.", "", "bool", false, true, false,
+    false);
 
 #endif
@@ -131,6 +131,20 @@ mlpack::util::Params ParseCommandLine(
     Log::Info.ignoreInput = false;
   }
 
+  // Limit the number of threads of OpenMP and BLAS, if requested.  (Bindings
+  // that are only built for testing may not have that option.)
+  if (parameters.count("threads") > 0 && params.Has("threads"))
+  {
+    const int threads = params.Get<int>("threads");
+    if (threads < 0)
+    {
+      Log::Fatal << "Invalid value for --threads (" << threads << "); it must "
+          << "be nonnegative." << std::endl;
+    }
+
+    Threads::Set((size_t) threads);
+  }
+
   // Now, issue an error if we forgot any required options.
   for (std::map<std::string, util::ParamData>::const_iterator iter =
        parameters.begin(); iter != parameters.end(); ++iter)
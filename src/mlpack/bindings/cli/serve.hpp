@@ -0,0 +1,224 @@
+/**
+ * @file bindings/cli/serve.hpp
+ *
+ * The serving mode of command-line bindings: the binding is run once for each
+ * request read from a stream, and the input models are only loaded once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_BINDINGS_CLI_SERVE_HPP
+#define MLPACK_BINDINGS_CLI_SERVE_HPP
+
+#include <mlpack/core.hpp>
+#include "parse_command_line.hpp"
+#include "end_program.hpp"
+
+namespace mlpack {
+namespace bindings {
+namespace cli {
+
+/**
+ * Split a request into command-line arguments.  Arguments are separated by
+ * whitespace; single or double quotes group characters (including whitespace)
+ * into one argument.  A std::invalid_argument exception is thrown if a quote is
+ * not closed.
+ *
+ * @param request One line of a request stream.
+ */
+inline std::vector<std::string> SplitRequest(const std::string& request)
+{
+  std::vector<std::string> args;
+  std::string arg;
+  bool inArg = false;
+  char quote = '\0';
+  for (const char c : request)
+  {
+    if (quote != '\0')
+    {
+      if (c == quote)
+        quote = '\0';
+      else
+        arg += c;
+    }
+    else if (c == '"' || c == '\'')
+    {
+      quote = c;
+      inArg = true;
+    }
+    else if (std::isspace((unsigned char) c))
+    {
+      if (inArg)
+        args.push_back(arg);
+      arg.clear();
+      inArg = false;
+    }
+    else
+    {
+      arg += c;
+      inArg = true;
+    }
+  }
+
+  if (quote != '\0')
+  {
+    throw std::invalid_argument("unterminated quote in request '" + request +
+        "'");
+  }
+
+  if (inArg)
+    args.push_back(arg);
+
+  return args;
+}
+
+/**
+ * Run a binding in serving mode.  Each line of `in` is a request: its options
+ * are added to the options given on the command line (`argv`), and the binding
+ * is run with them.  After each request, a line with `done` is written to
+ * `out`, or a line starting with `error: ` if the request failed; the outputs
+ * of the binding itself are written as usual, before that line.  Empty lines
+ * are ignored, and serving stops at the end of `in`.
+ *
+ * The input models are only loaded by the first request that uses them, and
+ * are kept for the next requests that give the same model file, so that the
+ * time to load a model is not spent again for each request.  If a binding
+ * modifies its input model (e.g. by training it further), the next requests
+ * get the modified model.
+ *
+ * The `--help`, `--info` and `--version` options can't be given in a request.
+ * An option given on the command line can't be given again in a request.
+ *
+ * @param argc Number of command-line arguments.
+ * @param argv Command-line arguments.
+ * @param bindingFunction Function that runs the binding.
+ * @param in Stream to read the requests from.
+ * @param out Stream to write the status of each request to.
+ * @param bindingName Name of the binding, if not `BINDING_NAME` (this is only
+ *      used for testing).
+ */
+template<typename BindingFunctionType>
+void Serve(int argc,
+           char** argv,
+           BindingFunctionType bindingFunction,
+           std::istream& in = std::cin,
+           std::ostream& out = std::cout,
+           const char* bindingName = "")
+{
+  const std::vector<std::string> baseArgs(argv, argv + argc);
+
+  // The input models that have been loaded, by parameter name.  Each holds the
+  // parameter that loaded it (with the name of its file).
+  std::map<std::string, util::ParamData> models;
+  std::unordered_set<void*> modelMemory;
+  // The functions that handle the types of the models.
+  util::Params::FunctionMapType functionMap;
+
+  std::string request;
+  while (std::getline(in, request))
+  {
+    util::Params params;
+    try
+    {
+      const std::vector<std::string> requestArgs = SplitRequest(request);
+      if (requestArgs.empty())
+        continue;
+
+      for (const std::string& arg : requestArgs)
+      {
+        if (arg == "--help" || arg == "-h" || arg == "--info" ||
+            arg == "--version" || arg == "-V")
+        {
+          throw std::invalid_argument("option " + arg + " can't be given in "
+              "a request");
+        }
+      }
+
+      std::vector<std::string> args(baseArgs);
+      args.insert(args.end(), requestArgs.begin(), requestArgs.end());
+      std::vector<char*> cArgs;
+      for (std::string& arg : args)
+        cArgs.push_back(&arg[0]);
+
+      params = ParseCommandLine((int) cArgs.size(), cArgs.data(), bindingName);
+      if (functionMap.empty())
+        functionMap = params.functionMap;
+
+      // Give the binding the models that are already loaded, if the request
+      // uses the same files.
+      std::map<std::string, util::ParamData>& parameters = params.Parameters();
+      for (auto& it : models)
+      {
+        util::ParamData& d = parameters.at(it.first);
+        std::string file, loadedFile;
+        params.functionMap[d.tname]["GetPrintableParam"](d, NULL,
+            (void*) &file);
+        params.functionMap[d.tname]["GetPrintableParam"](it.second, NULL,
+            (void*) &loadedFile);
+        if (d.wasPassed && file == loadedFile)
+        {
+          d.value = it.second.value;
+          d.loaded = true;
+        }
+      }
+
+      util::Timers timers;
+      timers.Enabled() = true;
+      timers.Start("total_time");
+      bindingFunction(params, timers);
+      timers.Stop("total_time");
+
+      // Keep the input models that this request loaded; they replace the
+      // models of the same parameters from earlier requests.
+      for (auto& it : parameters)
+      {
+        util::ParamData& d = it.second;
+        if (!d.input || !d.loaded)
+          continue;
+
+        void* memory;
+        params.functionMap[d.tname]["GetAllocatedMemory"](d, NULL,
+            (void*) &memory);
+        if (memory == NULL || modelMemory.count(memory) > 0)
+          continue;
+
+        if (models.count(it.first) > 0)
+        {
+          util::ParamData& old = models.at(it.first);
+          void* oldMemory;
+          functionMap[old.tname]["GetAllocatedMemory"](old, NULL,
+              (void*) &oldMemory);
+          modelMemory.erase(oldMemory);
+          functionMap[old.tname]["DeleteAllocatedMemory"](old, NULL, NULL);
+        }
+
+        models[it.first] = d;
+        modelMemory.insert(memory);
+      }
+
+      EndProgram(params, timers, modelMemory);
+      out << "done" << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+      // The models loaded by the failed request are not kept.
+      DeleteParamsMemory(params, modelMemory);
+      out << "error: " << e.what() << std::endl;
+    }
+  }
+
+  // Clean up the models.
+  for (auto& it : models)
+  {
+    util::ParamData& d = it.second;
+    functionMap[d.tname]["DeleteAllocatedMemory"](d, NULL, NULL);
+  }
+}
+
+} // namespace cli
+} // namespace bindings
+} // namespace mlpack
+
+#endif
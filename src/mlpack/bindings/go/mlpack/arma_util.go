@@ -90,12 +90,22 @@ func (m *mlpackArma) allocArmaPtrMatWithInfo(p *params,
   runtime.KeepAlive(m)
 }
 
+// Returns a slice holding the elements of the given Gonum matrix one row after
+// another.  This is the underlying data of the matrix, without a copy, unless
+// the matrix is a view whose rows are not stored next to each other.
+func contiguousData(m *mat.Dense) []float64 {
+  blas64General := m.RawMatrix()
+  if blas64General.Stride != blas64General.Cols {
+    blas64General = mat.DenseCopyOf(m).RawMatrix()
+  }
+  return blas64General.Data
+}
+
 // Passes a Gonum matrix to C by using the underlying data from the Gonum matrix.
 func gonumToArmaMat(p *params, identifier string, m *mat.Dense, trans bool) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Dims()
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := contiguousData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -107,8 +117,7 @@ func gonumToArmaMat(p *params, identifier string, m *mat.Dense, trans bool) {
 func gonumToArmaUmat(p *params, identifier string, m *mat.Dense) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Dims()
-  blas64General := m.RawMatrix()
-  data := blas64General.Data
+  data := contiguousData(m)
 
   // Pass pointer of the underlying matrix to mlpack.
   ptr := unsafe.Pointer(&data[0])
@@ -215,8 +224,7 @@ func gonumToArmaMatWithInfo(p *params,
                             m *matrixWithInfo) {
   // Get the number of elements in the Armadillo column.
   r, c := m.Data.Dims()
-  blas64General := m.Data.RawMatrix()
-  dataAndInfo := blas64General.Data
+  dataAndInfo := contiguousData(m.Data)
   boolarray := m.Categoricals
   // Pass pointer of the underlying matrix to mlpack.
   boolptr := unsafe.Pointer(&boolarray[0])
@@ -33,12 +33,12 @@ void mlpackToArmaMat(void* params,
 {
   util::Params& p = *((util::Params*) params);
 
-  // Advanced constructor.
+  // Advanced constructor.  Without a transpose, the matrix is an alias of the
+  // Go memory, which is not copied.  The transpose must not be done in place,
+  // since that would overwrite the memory of a square Go matrix.
   arma::mat m(mat, row, col, false, false);
-
-  // Transpose if necessary.
   if (transpose)
-    arma::inplace_trans(m);
+    m = arma::mat(m.t());
 
   // Set input parameter with corresponding matrix in IO.
   SetParam(p, identifier, m);
@@ -23,7 +23,7 @@ extern "C" {
  */
 void* mlpackGetParams(const char* bindingName)
 {
-  util::Params* p = new util::Params(IO::Parameters(bindingName));
+  util::Params* p = IO::AcquireParameters(bindingName);
   return (void*) p;
 }
 
@@ -42,7 +42,7 @@ void* mlpackGetTimers()
 void mlpackCleanParams(void* params)
 {
   util::Params* p = (util::Params*) params;
-  delete p;
+  IO::ReleaseParameters(p);
 }
 
 /**
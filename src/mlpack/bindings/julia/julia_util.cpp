@@ -24,7 +24,7 @@ extern "C" {
  */
 void* GetParameters(const char* bindingName)
 {
-  util::Params* p = new util::Params(IO::Parameters(bindingName));
+  util::Params* p = IO::AcquireParameters(bindingName);
   return (void*) p;
 }
 
@@ -34,7 +34,7 @@ void* GetParameters(const char* bindingName)
 void DeleteParameters(void* in)
 {
   util::Params* p = (util::Params*) in;
-  delete p;
+  IO::ReleaseParameters(p);
 }
 
 /**
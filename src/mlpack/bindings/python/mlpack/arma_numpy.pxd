@@ -29,6 +29,13 @@ cdef Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
 cdef Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
                                  bool takeOwnership) except +
 
+"""
+Convert a numpy ndarray to a matrix with the same shape (without a copy if the
+ndarray is Fortran-ordered).
+"""
+cdef Mat[double]* numpy_to_mat_trans_d( \
+    numpy.ndarray[numpy.double_t, ndim=2] X, bool takeOwnership) except +
+
 """
 Convert an Armadillo object to a numpy ndarray of the given type.
 """
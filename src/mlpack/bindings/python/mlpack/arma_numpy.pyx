@@ -53,8 +53,10 @@ cdef Mat[double]* numpy_to_mat_d(numpy.ndarray[numpy.double_t, ndim=2] X, \
   """
   cdef int flags = PyArray_FLAGS(X)
   if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
-    # If needed, make a copy where we own the memory.
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    # If needed, make a copy where we own the memory.  A contiguous array that
+    # does not own its memory (such as a view) is used directly, unless its
+    # memory has to be taken.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -75,9 +77,10 @@ cdef Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
   """
   cdef int flags = PyArray_FLAGS(X)
   if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  A contiguous array that does not own its memory (such as
+    # a view) is used directly, unless its memory has to be taken.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -91,6 +94,31 @@ cdef Mat[size_t]* numpy_to_mat_s(numpy.ndarray[numpy.npy_intp, ndim=2] X, \
 
   return m
 
+cdef Mat[double]* numpy_to_mat_trans_d( \
+    numpy.ndarray[numpy.double_t, ndim=2] X, bool takeOwnership) except +:
+  """
+  Convert a numpy ndarray to a matrix with the same shape (so, the transpose of
+  the matrix given by numpy_to_mat_d()).  A Fortran-ordered ndarray holds
+  exactly the memory of that matrix, so it is used without a copy.  The memory
+  will still be owned by numpy.
+  """
+  cdef int flags = PyArray_FLAGS(X)
+  if not (flags & numpy.NPY_ARRAY_F_CONTIGUOUS) or \
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    # If needed, make a copy where we own the memory.
+    X = X.copy(order="F")
+    takeOwnership = True
+
+  cdef Mat[double]* m = new Mat[double](<double*> PyArray_DATA(X),
+      PyArray_SHAPE(X)[0], PyArray_SHAPE(X)[1], isWin, False)
+
+  # Take ownership of the memory, if we need to and we are not on Windows.
+  if takeOwnership and not isWin:
+    PyArray_CLEARFLAGS(X, numpy.NPY_ARRAY_OWNDATA)
+    SetMemState[Mat[double]](m[0], 0)
+
+  return m
+
 cdef numpy.ndarray[numpy.double_t, ndim=2] mat_to_numpy_d(Mat[double]& X) \
     except +:
   """
@@ -141,9 +169,10 @@ cdef Row[double]* numpy_to_row_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   """
   cdef int flags = PyArray_FLAGS(X)
   if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  A contiguous array that does not own its memory (such as
+    # a view) is used directly, unless its memory has to be taken.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -165,9 +194,10 @@ cdef Row[size_t]* numpy_to_row_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   """
   cdef int flags = PyArray_FLAGS(X)
   if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  A contiguous array that does not own its memory (such as
+    # a view) is used directly, unless its memory has to be taken.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -228,9 +258,10 @@ cdef Col[double]* numpy_to_col_d(numpy.ndarray[numpy.double_t, ndim=1] X, \
   """
   cdef int flags = PyArray_FLAGS(X)
   if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  A contiguous array that does not own its memory (such as
+    # a view) is used directly, unless its memory has to be taken.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -252,9 +283,10 @@ cdef Col[size_t]* numpy_to_col_s(numpy.ndarray[numpy.npy_intp, ndim=1] X, \
   """
   cdef int flags = PyArray_FLAGS(X)
   if not (flags & numpy.NPY_ARRAY_C_CONTIGUOUS) or \
-    (not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
+    (takeOwnership and not (flags & numpy.NPY_ARRAY_OWNDATA) and not isWin):
     # If needed, make a copy where we own the memory, except on Windows where
-    # we never copy.
+    # we never copy.  A contiguous array that does not own its memory (such as
+    # a view) is used directly, unless its memory has to be taken.
     X = X.copy(order="C")
     takeOwnership = True
 
@@ -37,9 +37,16 @@ try:
 except:
   buffer = memoryview
 
-def to_matrix(x, dtype=np.double, copy=False):
+def to_matrix(x, dtype=np.double, copy=False, order='C'):
   """
-  Given some array-like X, return a numpy ndarray of the same type.
+  Given some array-like X, return a numpy ndarray of the same type, with the
+  given memory layout ('C' for row-major or 'F' for column-major).  The second
+  element of the returned tuple indicates whether the ndarray is a new copy.
+
+  A numpy ndarray that already has the right dtype and layout is returned
+  without a copy (unless copy is True).  Any other array is converted with a
+  single copy, which changes its dtype (for instance from float32 or int32)
+  and its layout at the same time.
   """
   # Make sure it's array-like at all.
   if not hasattr(x, '__len__') and \
@@ -47,28 +54,25 @@ def to_matrix(x, dtype=np.double, copy=False):
       not hasattr(x, '__array__'):
     raise TypeError("given argument is not array-like")
 
-  if (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.c_contiguous):
+  contiguous = 'c_contiguous' if order == 'C' else 'f_contiguous'
+  if isinstance(x, np.ndarray) and x.dtype == dtype and x.flags[contiguous]:
     if copy: # Copy the matrix if required.
-      return x.copy("C"), True
+      return x.copy(order), True
     else:
       return x, False
-  elif (isinstance(x, np.ndarray) and x.dtype == dtype and x.flags.f_contiguous):
-    # A copy is always necessary here.
-    return x.copy("C"), True
   else:
     if isinstance(x, pd.core.series.Series) or isinstance(x, pd.DataFrame):
-      # We can only avoid a copy if the dtype is the same and the copy flag is
-      # false.  I'm actually not sure if this is possible, since in everything I
-      # have found, Pandas stores with F_CONTIGUOUS not C_CONTIGUOUS.
+      # We can only avoid a copy if the dtype and the layout are the same and
+      # the copy flag is false.  Pandas usually stores with F_CONTIGUOUS, so
+      # this is mostly possible when order is 'F'.
       y = x.values
-      if copy == False and y.dtype == dtype and y.flags.c_contiguous:
-        return np.ndarray(y.shape, buffer=x.values, dtype=dtype, order='C'),\
-            False
+      if copy == False and y.dtype == dtype and y.flags[contiguous]:
+        return y, False
       else:
         # We have to make a copy or change the dtype, so just do this directly.
-        return np.array(y, dtype=dtype, order='C', copy=True), True
+        return np.array(y, dtype=dtype, order=order, copy=True), True
     else:
-      return np.array(x, copy=True, dtype=dtype, order='C'), True
+      return np.array(x, copy=True, dtype=dtype, order=order), True
 
 
 def to_matrix_with_info(x, dtype, copy=False):
@@ -89,11 +93,9 @@ def to_matrix_with_info(x, dtype, copy=False):
     else:
       d = np.zeros([x.shape[1]], dtype=bool)
 
-    # Copy the matrix if needed.
-    if copy:
-      return (x.copy(order="C"), True, d)
-    else:
-      return (x, False, d)
+    # Convert the matrix to the right dtype and layout, or copy it, if needed.
+    t = to_matrix(x, dtype=dtype, copy=copy)
+    return (t[0], t[1], d)
 
   if isinstance(x, pd.DataFrame) or isinstance(x, pd.Series):
     # It's a pandas dataframe.  So we need to see if any of the dtypes are
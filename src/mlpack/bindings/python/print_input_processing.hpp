@@ -277,12 +277,21 @@ void PrintInputProcessing(
    * The value of the final boolean passed to SetParam is determined by whether
    * the matrix is transposed or not.  That boolean is omitted if the parameter
    * is a row or column.
+   *
+   * A numpy ndarray with one point per row is, in memory, the transpose of a
+   * C-ordered Armadillo matrix.  So, a double matrix that must not be
+   * transposed is instead converted to a Fortran-ordered ndarray, which is
+   * then used as-is by numpy_to_mat_trans_d(), without a copy or a transpose.
    */
   std::cout << prefix << "# Detect if the parameter was passed; set if so."
       << std::endl;
   std::string name = GetValidName(d.name);
-  std::string transStr =
-      (d.noTranspose ? std::string("True") : std::string("False"));
+  const bool fortran = (d.noTranspose && std::is_same_v<T, arma::mat>);
+  std::string transStr = ((d.noTranspose && !fortran) ? std::string("True") :
+      std::string("False"));
+  const std::string orderStr = (fortran ? ", order='F'" : "");
+  const std::string convertStr = (fortran ? std::string("numpy_to_mat_trans_d")
+      : "numpy_to_" + GetArmaType<T>() + "_" + GetNumpyTypeChar<T>());
 
   if (!d.required)
   {
@@ -314,14 +323,14 @@ void PrintInputProcessing(
       std::cout << prefix << "if " << name << " is not None:" << std::endl;
       std::cout << prefix << "  " << name << "_tuple = to_matrix("
           << name << ", dtype=" << GetNumpyType<typename T::elem_type>()
-          << ", copy=p.Has('copy_all_inputs'))" << std::endl;
+          << ", copy=p.Has('copy_all_inputs')" << orderStr << ")"
+          << std::endl;
       std::cout << prefix << "  if len(" << name << "_tuple[0].shape"
           << ") < 2:" << std::endl;
       std::cout << prefix << "    " << name << "_tuple[0].shape = (" << name
           << "_tuple[0].shape[0], 1)" << std::endl;
-      std::cout << prefix << "  " << name << "_mat = numpy_to_"
-          << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << name
-          << "_tuple[0], " << name << "_tuple[1])" << std::endl;
+      std::cout << prefix << "  " << name << "_mat = " << convertStr << "("
+          << name << "_tuple[0], " << name << "_tuple[1])" << std::endl;
       std::cout << prefix << "  SetParam[" << GetCythonType<T>(d)
           << "](p, <const string> '" << d.name << "', dereference("
           << name << "_mat), " << transStr << ")" << std::endl;
@@ -357,13 +366,13 @@ void PrintInputProcessing(
     {
       std::cout << prefix << name << "_tuple = to_matrix(" << name
           << ", dtype=" << GetNumpyType<typename T::elem_type>()
-          << ", copy=p.Has('copy_all_inputs'))" << std::endl;
+          << ", copy=p.Has('copy_all_inputs')" << orderStr << ")"
+          << std::endl;
       std::cout << prefix << "if len(" << name << "_tuple[0].shape) < 2:"
           << std::endl;
       std::cout << prefix << "  " << name << "_tuple[0].shape = (" << name
           << "_tuple[0].shape[0], 1)" << std::endl;
-      std::cout << prefix << name << "_mat = numpy_to_"
-          << GetArmaType<T>() << "_" << GetNumpyTypeChar<T>() << "(" << name
+      std::cout << prefix << name << "_mat = " << convertStr << "(" << name
           << "_tuple[0], " << name << "_tuple[1])" << std::endl;
       std::cout << prefix << "SetParam[" << GetCythonType<T>(d)
           << "](p, <const string> '" << d.name << "', dereference(" << name
@@ -77,7 +77,7 @@ void PrintPYX(const util::BindingDetails& doc,
   cout << "from .arma_numpy cimport numpy_to_mat_d, numpy_to_mat_s, "
       << "mat_to_numpy_d, mat_to_numpy_s, numpy_to_row_d, numpy_to_row_s, "
       << "row_to_numpy_d, row_to_numpy_s, numpy_to_col_d, numpy_to_col_s, "
-      << "col_to_numpy_d, col_to_numpy_s" << endl;
+      << "col_to_numpy_d, col_to_numpy_s, numpy_to_mat_trans_d" << endl;
   cout << "from .io cimport IO" << endl;
   cout << "from .params cimport Params" << endl;
   cout << "from .timers cimport Timers" << endl;
@@ -100,7 +100,10 @@ std::string PrintTypeDoc(
     {
       return "A 2-d arraylike containing data.  This can be a list of lists, a "
           "numpy ndarray, or a pandas DataFrame.  If the dtype is not already "
-          "float64, it will be converted.";
+          "float64, it will be converted.  A C-ordered float64 ndarray (or a "
+          "contiguous view of one) is used without a copy; any other matrix "
+          "(for instance a float32 or Fortran-ordered ndarray) is converted "
+          "with a single copy.";
     }
   }
   else if (std::is_same_v<typename T::elem_type, size_t>)
@@ -132,6 +132,63 @@ class TestToMatrix(unittest.TestCase):
 
     self.assertEqual(p1['data'], p2['data'])
 
+  def testNumpyViewToMatrix(self):
+    """
+    Make sure that a contiguous view of a numpy matrix is not copied.
+    """
+    m1 = np.random.randn(100, 5)
+    m2, copied = to_matrix(m1[10:20])
+
+    self.assertFalse(copied)
+    self.assertEqual(m2.shape, (10, 5))
+    self.assertEqual(m2.__array_interface__['data'],
+                     m1[10:20].__array_interface__['data'])
+
+  def testFortranToMatrix(self):
+    """
+    Make sure that a Fortran-ordered matrix is only copied if a C-ordered
+    matrix is needed.
+    """
+    m1 = np.asfortranarray(np.random.randn(100, 5))
+    m2, copied = to_matrix(m1, order='F')
+
+    self.assertFalse(copied)
+    self.assertEqual(m1.__array_interface__['data'],
+                     m2.__array_interface__['data'])
+
+    m3, copied = to_matrix(m1)
+
+    self.assertTrue(copied)
+    self.assertTrue(m3.flags.c_contiguous)
+    self.assertTrue(np.array_equal(m1, m3))
+
+  def testFloat32ToMatrix(self):
+    """
+    Make sure that float32 and int32 matrices are converted, in any layout.
+    """
+    m1 = np.random.randn(100, 5).astype(np.float32)
+    for m in [m1, np.asfortranarray(m1)]:
+      m2, copied = to_matrix(m)
+
+      self.assertTrue(copied)
+      self.assertEqual(m2.dtype, np.dtype(np.double))
+      self.assertTrue(m2.flags.c_contiguous)
+      self.assertTrue(np.array_equal(m2, m))
+
+      m3, copied, dims = to_matrix_with_info(m, np.double)
+
+      self.assertTrue(copied)
+      self.assertEqual(m3.dtype, np.dtype(np.double))
+      self.assertTrue(np.array_equal(m3, m))
+      self.assertEqual(dims.shape[0], 5)
+
+    l1 = np.arange(100, dtype=np.int32)
+    l2, copied = to_matrix(l1, dtype=np.intp)
+
+    self.assertTrue(copied)
+    self.assertEqual(l2.dtype, np.dtype(np.intp))
+    self.assertTrue(np.array_equal(l1, l2))
+
   def testPandasToMatrixNoCategorical(self):
     """
     Make sure that if we pass a Pandas dataframe with no categorical features,
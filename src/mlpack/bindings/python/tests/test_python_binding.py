@@ -586,6 +586,29 @@ class TestPythonBinding(unittest.TestCase):
                         tmatrix_in=x,
                         copy_all_inputs=True)
 
+  def testTransMatrixFortran(self):
+    """
+    The same test as above, but with Fortran-ordered and float32 inputs, which
+    are converted differently.
+    """
+    x = np.random.rand(20, 10)
+    test_python_binding(string_in='hello',
+                        int_in=12,
+                        double_in=4.0,
+                        mat_req_in=[[1.0]],
+                        col_req_in=[1.0],
+                        matrix_in=x,
+                        tmatrix_in=np.asfortranarray(x))
+
+    y = np.random.rand(20, 10).astype(np.float32)
+    test_python_binding(string_in='hello',
+                        int_in=12,
+                        double_in=4.0,
+                        mat_req_in=[[1.0]],
+                        col_req_in=[1.0],
+                        matrix_in=np.asfortranarray(y),
+                        tmatrix_in=y)
+
   def testCol(self):
     """
     Test a column vector input parameter.
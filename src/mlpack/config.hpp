@@ -23,6 +23,24 @@
 // #define MLPACK_HAS_BFD_DL
 #endif
 
+//
+// If MLPACK_HAS_ARROW is enabled, data::Load() and data::ArrowReader can read
+// Apache Parquet and Arrow IPC files; mlpack programs must then be linked with
+// the Arrow and Parquet libraries (e.g. -larrow -lparquet).
+//
+#ifndef MLPACK_HAS_ARROW
+// #define MLPACK_HAS_ARROW
+#endif
+
+//
+// If MLPACK_HAS_ZLIB is enabled, data::BlobModelWriter can compress the blobs
+// of blob model files, and data::BlobModelReader can read compressed blobs;
+// mlpack programs must then be linked with zlib (e.g. -lz).
+//
+#ifndef MLPACK_HAS_ZLIB
+// #define MLPACK_HAS_ZLIB
+#endif
+
 //
 // If the version of mlpack is built from a git repository and is not an
 // official release, then MLPACK_GIT_VERSION will be defined.  This causes
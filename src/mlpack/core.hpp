@@ -67,4 +67,8 @@
   #include <omp.h>
 #endif
 
+// Control of the number of OpenMP and BLAS threads.
+#include <mlpack/core/util/threads.hpp>
+#include <mlpack/core/util/first_touch.hpp>
+
 #endif
@@ -17,13 +17,118 @@
 #include <cereal/archives/json.hpp>
 
 #include <mlpack/core/cereal/array_wrapper.hpp>
+#include <mlpack/core/cereal/blob_archive.hpp>
 
 #include <armadillo>
 
+namespace cereal {
+
+/**
+ * Whether the elements of Armadillo objects are serialized with Archive as
+ * one block of raw memory, instead of one element at a time.  This gives
+ * exactly the same bytes as serializing the elements one at a time (so files
+ * saved either way can be loaded either way), but without the per-element
+ * overhead.  Binary archives store any arithmetic or complex element as raw
+ * memory; portable binary archives can only do so for arithmetic elements,
+ * since each element is byte-swapped as a whole if needed.
+ */
+template<typename Archive, typename eT>
+struct IsRawArmaArchive
+{
+  static constexpr bool value =
+      ((std::is_same_v<Archive, BinaryOutputArchive> ||
+        std::is_same_v<Archive, BinaryInputArchive>) &&
+       (std::is_arithmetic_v<eT> || arma::is_cx<eT>::yes)) ||
+      ((std::is_same_v<Archive, PortableBinaryOutputArchive> ||
+        std::is_same_v<Archive, PortableBinaryInputArchive>) &&
+       std::is_arithmetic_v<eT>);
+};
+
+/**
+ * Save the given elements of an Armadillo object: as one block of memory if
+ * IsRawArmaArchive holds, and one element at a time otherwise.  A
+ * BlobOutputArchive stores large blocks as blobs instead.
+ */
+template<typename Archive, typename eT>
+void SaveArmaArray(Archive& ar,
+                   const eT* mem,
+                   const size_t n,
+                   const char* name)
+{
+  if constexpr (IsRawArmaArchive<Archive, eT>::value)
+  {
+    const size_t size = n * sizeof(eT);
+    if constexpr (std::is_same_v<Archive, BinaryOutputArchive>)
+    {
+      BlobOutputArchive* blobAr = dynamic_cast<BlobOutputArchive*>(&ar);
+      if (blobAr != NULL && size > 0 && size >= blobAr->MinBlobSize())
+      {
+        uint64_t blob = blobAr->SaveBlob((const char*) mem, size);
+        ar(CEREAL_NVP(blob));
+        return;
+      }
+    }
+
+    if (size > 0)
+      ar(binary_data(mem, size));
+  }
+  else
+  {
+    for (size_t i = 0; i < n; ++i)
+      ar(make_nvp(name, const_cast<eT&>(mem[i])));
+  }
+}
+
+/**
+ * Load the given number of elements of an Armadillo object, saved with
+ * SaveArmaArray().  If `allowMap` is true and the elements are a blob that
+ * can be used directly, the memory of the blob is returned; otherwise, the
+ * elements are copied into the memory returned by `allocate()`, and NULL is
+ * returned.
+ */
+template<typename Archive, typename eT, typename AllocateFunctionType>
+eT* LoadArmaArray(Archive& ar,
+                  const size_t n,
+                  AllocateFunctionType&& allocate,
+                  const char* name,
+                  const bool allowMap)
+{
+  if constexpr (IsRawArmaArchive<Archive, eT>::value)
+  {
+    const size_t size = n * sizeof(eT);
+    if constexpr (std::is_same_v<Archive, BinaryInputArchive>)
+    {
+      BlobInputArchive* blobAr = dynamic_cast<BlobInputArchive*>(&ar);
+      if (blobAr != NULL && size > 0 && size >= blobAr->MinBlobSize())
+      {
+        uint64_t blob;
+        ar(CEREAL_NVP(blob));
+        char* mapped = allowMap ? blobAr->MapBlob(blob, size) : NULL;
+        if (mapped != NULL)
+          return (eT*) mapped;
+
+        blobAr->LoadBlob(blob, (char*) allocate(), size);
+        return NULL;
+      }
+    }
+
+    eT* mem = allocate();
+    if (size > 0)
+      ar(binary_data(mem, size));
+  }
+  else
+  {
+    eT* mem = allocate();
+    for (size_t i = 0; i < n; ++i)
+      ar(make_nvp(name, mem[i]));
+  }
+
+  return NULL;
+}
+
 /**
  * Add an external serialization function for SpMat.
  */
-namespace cereal {
 
 template<typename Archive, typename eT>
 void serialize(Archive& ar, arma::SpMat<eT>& mat)
@@ -50,13 +155,24 @@ void serialize(Archive& ar, arma::SpMat<eT>& mat)
     // column pointers, if necessary, so we don't need to worry about them.
   }
 
-  // Serialize the values held in the sparse matrix.
-  for (size_t i = 0; i < mat.n_nonzero; ++i)
-    ar(cereal::make_nvp("value", arma::access::rw(mat.values[i])));
-  for (size_t i = 0; i < mat.n_nonzero; ++i)
-    ar(cereal::make_nvp("row_index", arma::access::rw(mat.row_indices[i])));
-  for (size_t i = 0; i < mat.n_cols + 1; ++i)
-    ar(cereal::make_nvp("col_ptr", arma::access::rw(mat.col_ptrs[i])));
+  // Serialize the values held in the sparse matrix.  The sparse matrix owns
+  // its memory, so blobs are always copied.
+  if (cereal::is_loading<Archive>())
+  {
+    LoadArmaArray<Archive, eT>(ar, mat.n_nonzero,
+        [&]() { return arma::access::rwp(mat.values); }, "value", false);
+    LoadArmaArray<Archive, arma::uword>(ar, mat.n_nonzero,
+        [&]() { return arma::access::rwp(mat.row_indices); }, "row_index",
+        false);
+    LoadArmaArray<Archive, arma::uword>(ar, mat.n_cols + 1,
+        [&]() { return arma::access::rwp(mat.col_ptrs); }, "col_ptr", false);
+  }
+  else
+  {
+    SaveArmaArray(ar, mat.values, mat.n_nonzero, "value");
+    SaveArmaArray(ar, mat.row_indices, mat.n_nonzero, "row_index");
+    SaveArmaArray(ar, mat.col_ptrs, mat.n_cols + 1, "col_ptr");
+  }
 }
 
 // Add an external serialization function for Mat.
@@ -74,13 +190,28 @@ void serialize(Archive& ar, arma::Mat<eT>& mat)
 
   if (cereal::is_loading<Archive>())
   {
-    mat.set_size(n_rows, n_cols);
-    arma::access::rw(mat.vec_state) = vec_state;
+    // A blob may be used directly as the memory of the matrix; a matrix that
+    // uses auxiliary memory without being strictly bound to it gives the
+    // memory to the matrix it is moved into.
+    eT* mapped = LoadArmaArray<Archive, eT>(ar, (size_t) n_rows * n_cols,
+        [&]()
+        {
+          mat.set_size(n_rows, n_cols);
+          arma::access::rw(mat.vec_state) = vec_state;
+          return mat.memptr();
+        }, "elem", true);
+
+    if (mapped != NULL)
+    {
+      mat = arma::Mat<eT>(mapped, n_rows, n_cols, false, false);
+      arma::access::rw(mat.vec_state) = vec_state;
+    }
+  }
+  else
+  {
+    // Directly serialize the contents of the matrix's memory.
+    SaveArmaArray(ar, mat.memptr(), mat.n_elem, "elem");
   }
-
-  // Directly serialize the contents of the matrix's memory.
-  for (size_t i = 0; i < mat.n_elem; ++i)
-    ar(cereal::make_nvp("elem", arma::access::rw(mat.mem[i])));
 }
 
 // Add a serialization function for armadillo Cube
@@ -96,12 +227,20 @@ void serialize(Archive& ar, arma::Cube<eT>& cube)
   ar(CEREAL_NVP(n_cols));
   ar(CEREAL_NVP(n_slices));
 
-  if (cereal::is_loading<Archive>())
-    cube.set_size(n_rows, n_cols, n_slices);
-
   // Directly serialize the contents of the cube's memory.
-  for (size_t i = 0; i < cube.n_elem; ++i)
-    ar(cereal::make_nvp("elem", arma::access::rw(cube.mem[i])));
+  if (cereal::is_loading<Archive>())
+  {
+    LoadArmaArray<Archive, eT>(ar, (size_t) n_rows * n_cols * n_slices,
+        [&]()
+        {
+          cube.set_size(n_rows, n_cols, n_slices);
+          return cube.memptr();
+        }, "elem", false);
+  }
+  else
+  {
+    SaveArmaArray(ar, cube.memptr(), cube.n_elem, "elem");
+  }
 }
 
 } // end namespace cereal
@@ -0,0 +1,118 @@
+/**
+ * @file core/cereal/blob_archive.hpp
+ *
+ * Binary archives that store the memory of large Armadillo objects as separate
+ * blobs, for the blob model format of data::BlobModelWriter and
+ * data::BlobModelReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_CEREAL_BLOB_ARCHIVE_HPP
+#define MLPACK_CORE_CEREAL_BLOB_ARCHIVE_HPP
+
+#include <cereal/archives/binary.hpp>
+
+namespace cereal {
+
+/**
+ * A BinaryOutputArchive that can also store blocks of raw memory ("blobs")
+ * outside of the archive.  It is used exactly like a BinaryOutputArchive (and
+ * every type is serialized with the BinaryOutputArchive overloads), except
+ * that the serialization functions of Armadillo matrices and cubes check for
+ * it, and store the memory of objects of at least MinBlobSize() bytes with
+ * SaveBlob() instead of writing it to the archive.
+ */
+class BlobOutputArchive : public BinaryOutputArchive
+{
+ public:
+  /**
+   * Create the archive on the given stream.
+   *
+   * @param stream Stream to write the archive to.
+   * @param minBlobSize Minimum size (in bytes) of the objects that are stored
+   *     as blobs.
+   */
+  BlobOutputArchive(std::ostream& stream, const size_t minBlobSize) :
+      BinaryOutputArchive(stream),
+      minBlobSize(minBlobSize)
+  {
+    // Nothing to do.
+  }
+
+  virtual ~BlobOutputArchive() { }
+
+  /**
+   * Store the given memory as a blob, and return the index of the blob, which
+   * is then written to the archive.
+   *
+   * @param data Memory to store.
+   * @param size Size of the memory, in bytes.
+   */
+  virtual uint64_t SaveBlob(const char* data, const size_t size) = 0;
+
+  //! Get the minimum size of the objects that are stored as blobs.
+  size_t MinBlobSize() const { return minBlobSize; }
+
+ private:
+  //! The minimum size of the objects that are stored as blobs.
+  size_t minBlobSize;
+};
+
+/**
+ * The BinaryInputArchive that reads archives written by a BlobOutputArchive.
+ * The memory of objects of at least MinBlobSize() bytes is taken from the blob
+ * whose index is read from the archive.
+ */
+class BlobInputArchive : public BinaryInputArchive
+{
+ public:
+  /**
+   * Create the archive on the given stream.
+   *
+   * @param stream Stream to read the archive from.
+   * @param minBlobSize Minimum size (in bytes) of the objects that were stored
+   *     as blobs.
+   */
+  BlobInputArchive(std::istream& stream, const size_t minBlobSize) :
+      BinaryInputArchive(stream),
+      minBlobSize(minBlobSize)
+  {
+    // Nothing to do.
+  }
+
+  virtual ~BlobInputArchive() { }
+
+  /**
+   * Get the memory of the given blob, if the object may use it directly
+   * instead of a copy: the memory must stay valid (and may be written to) for
+   * as long as the object uses it.  Otherwise, NULL is returned, and the blob
+   * must be copied with LoadBlob().
+   *
+   * @param blob Index of the blob.
+   * @param size Expected size of the blob, in bytes.
+   */
+  virtual char* MapBlob(const uint64_t blob, const size_t size) = 0;
+
+  /**
+   * Copy the given blob into the given memory.
+   *
+   * @param blob Index of the blob.
+   * @param data Memory to copy the blob into.
+   * @param size Expected size of the blob, in bytes.
+   */
+  virtual void LoadBlob(const uint64_t blob, char* data, const size_t size) = 0;
+
+  //! Get the minimum size of the objects that were stored as blobs.
+  size_t MinBlobSize() const { return minBlobSize; }
+
+ private:
+  //! The minimum size of the objects that were stored as blobs.
+  size_t minBlobSize;
+};
+
+} // namespace cereal
+
+#endif
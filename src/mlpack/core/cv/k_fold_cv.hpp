@@ -176,9 +176,44 @@ class KFoldCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs& ...args);
 
+  /**
+   * Run k-fold cross-validation on only the first folds, as a cheap estimate
+   * of the result of Evaluate() (e.g. for SuccessiveHalving).  The model of the
+   * last evaluated fold is stored in `model` instead of being kept for
+   * Model(), so this can be called from several threads at once.
+   *
+   * @param budget Fraction of the folds to evaluate, in (0, 1]; at least one
+   *     fold is evaluated, and all folds with a budget of 1.
+   * @param model Pointer to store the model of the last evaluated fold in.
+   * @param args Arguments for MLAlgorithm (in addition to the passed
+   *     ones in the constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double PartialEvaluate(const double budget,
+                         std::unique_ptr<MLAlgorithm>& model,
+                         const MLAlgorithmArgs& ...args);
+
   //! Access and modify a model from the last run of k-fold cross-validation.
   MLAlgorithm& Model();
 
+  //! Get the maximum number of folds that are trained and evaluated at once.
+  size_t FoldThreads() const { return foldThreads; }
+  /**
+   * Modify the maximum number of folds that are trained and evaluated at once
+   * (1 by default; 0 means as many as OpenMP allows).  With more than one,
+   * each fold is trained on its own OpenMP thread with its own model, and any
+   * OpenMP loops inside the training of a fold run on that thread only.  This
+   * helps small models, which cannot use many threads for a single training.
+   * Each fold holds its own model at the same time, so this also bounds the
+   * memory used for the models.
+   *
+   * Before a fold is trained in parallel, the random number generators of its
+   * thread are seeded with a seed drawn once per Evaluate() call plus the
+   * index of the fold, so that the result does not depend on the number of
+   * threads.
+   */
+  size_t& FoldThreads() { return foldThreads; }
+
  private:
   //! A short alias for CVBase.
   using Base = CVBase<MLAlgorithm, MatType, PredictionsType, WeightsType>;
@@ -223,6 +258,8 @@ class KFoldCV
 
   //! A pointer to a model from the last run of k-fold cross-validation.
   std::unique_ptr<MLAlgorithm> modelPtr;
+  //! The maximum number of folds that are trained and evaluated at once.
+  size_t foldThreads;
 
   /**
    * Assert the k parameter and data consistency and initialize fields required
@@ -258,7 +295,9 @@ class KFoldCV
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = std::enable_if_t<Enabled>>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  double TrainAndEvaluate(const size_t numFolds,
+                          std::unique_ptr<MLAlgorithm>& model,
+                          const MLAlgorithmArgs& ...mlAlgorithmArgs);
 
   /**
    * Train and run evaluation in the case of supporting weighted learning.
@@ -267,7 +306,22 @@ class KFoldCV
            bool Enabled = Base::MIE::SupportsWeights,
            typename = std::enable_if_t<Enabled>,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs& ...mlAlgorithmArgs);
+  double TrainAndEvaluate(const size_t numFolds,
+                          std::unique_ptr<MLAlgorithm>& model,
+                          const MLAlgorithmArgs& ...mlAlgorithmArgs);
+
+  /**
+   * Train a model on each of the first `numFolds` folds with the given
+   * function (called as `train(i)`, returning the model of the ith fold),
+   * evaluate it on the validation subset of the fold, and store the model of
+   * the last fold in `model`.  The folds are run in parallel if FoldThreads()
+   * allows it.
+   */
+  template<typename TrainFunctionType>
+  void EvaluateFolds(const TrainFunctionType& train,
+                     const size_t numFolds,
+                     arma::vec& evaluations,
+                     std::unique_ptr<MLAlgorithm>& model);
 
   /**
    * Calculate the index of the first column of the ith validation subset.
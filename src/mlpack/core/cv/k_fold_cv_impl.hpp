@@ -134,7 +134,8 @@ KFoldCV<MLAlgorithm,
                               const PredictionsType& ys,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    foldThreads(1)
 {
   if (k < 2)
     throw std::invalid_argument("KFoldCV: k should not be less than 2");
@@ -165,7 +166,8 @@ KFoldCV<MLAlgorithm,
                               const WeightsType& weights,
                               const bool shuffle) :
     base(std::move(base)),
-    k(k)
+    k(k),
+    foldThreads(1)
 {
   Base::AssertWeightsConsistency(xs, weights);
 
@@ -190,7 +192,33 @@ double KFoldCV<MLAlgorithm,
                PredictionsType,
                WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate(k, modelPtr, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double KFoldCV<MLAlgorithm,
+               Metric,
+               MatType,
+               PredictionsType,
+               WeightsType>::PartialEvaluate(
+    const double budget,
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
+{
+  if (!(budget > 0.0 && budget <= 1.0))
+  {
+    throw std::invalid_argument("KFoldCV::PartialEvaluate(): budget must be "
+        "in (0, 1]");
+  }
+
+  const size_t numFolds = std::min(k, std::max((size_t) 1,
+      (size_t) std::ceil(budget * k)));
+  return TrainAndEvaluate(numFolds, model, args...);
 }
 
 template<typename MLAlgorithm,
@@ -241,17 +269,21 @@ double KFoldCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    const size_t numFolds,
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
+  arma::vec evaluations;
+  EvaluateFolds([&](const size_t i)
+  {
+    return base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
+        args...);
+  }, numFolds, evaluations, model);
 
   size_t numInvalidScores = 0;
-  for (size_t i = 0; i < k; ++i)
+  for (size_t i = 0; i < numFolds; ++i)
   {
-    MLAlgorithm&& model  = base.Train(GetTrainingSubset(xs, i),
-        GetTrainingSubset(ys, i), args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
     if (std::isnan(evaluations(i)) || std::isinf(evaluations(i)))
     {
       ++numInvalidScores;
@@ -259,11 +291,9 @@ double KFoldCV<MLAlgorithm,
           << "a score of " << evaluations(i) << "; ignoring when computing "
           << "the average score." << std::endl;
     }
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
   }
 
-  if (numInvalidScores == k)
+  if (numInvalidScores == numFolds)
   {
     Log::Warn << "KFoldCV::TrainAndEvaluate(): all folds returned invalid "
         << "scores!  Returning 0.0 as overall score." << std::endl;
@@ -283,26 +313,103 @@ double KFoldCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    const size_t numFolds,
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
 {
-  arma::vec evaluations(k);
-
-  for (size_t i = 0; i < k; ++i)
+  arma::vec evaluations;
+  EvaluateFolds([&](const size_t i)
   {
-    MLAlgorithm&& model = (weights.n_elem > 0) ?
+    return (weights.n_elem > 0) ?
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             GetTrainingSubset(weights, i), args...) :
         base.Train(GetTrainingSubset(xs, i), GetTrainingSubset(ys, i),
             args...);
-    evaluations(i) = Metric::Evaluate(model, GetValidationSubset(xs, i),
-        GetValidationSubset(ys, i));
-    if (i == k - 1)
-      modelPtr.reset(new MLAlgorithm(std::move(model)));
-  }
+  }, numFolds, evaluations, model);
 
   return arma::mean(evaluations);
 }
 
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename TrainFunctionType>
+void KFoldCV<MLAlgorithm,
+             Metric,
+             MatType,
+             PredictionsType,
+             WeightsType>::EvaluateFolds(const TrainFunctionType& train,
+                                         const size_t numFolds,
+                                         arma::vec& evaluations,
+                                         std::unique_ptr<MLAlgorithm>& model)
+{
+  evaluations.set_size(numFolds);
+
+  #ifdef MLPACK_USE_OPENMP
+  const size_t threads = std::min(numFolds, (foldThreads == 0) ?
+      (size_t) omp_get_max_threads() : foldThreads);
+  #else
+  const size_t threads = 1;
+  #endif
+
+  if (threads <= 1)
+  {
+    for (size_t i = 0; i < numFolds; ++i)
+    {
+      MLAlgorithm&& foldModel = train(i);
+      evaluations(i) = Metric::Evaluate(foldModel, GetValidationSubset(xs, i),
+          GetValidationSubset(ys, i));
+      if (i == numFolds - 1)
+        model.reset(new MLAlgorithm(std::move(foldModel)));
+    }
+
+    return;
+  }
+
+  // The folds are seeded from the generator of this thread, so that the
+  // result only depends on its state.
+  const size_t seed = RandGen()();
+
+  // Exceptions cannot leave the parallel loop, so the first one is kept and
+  // thrown afterwards.
+  std::exception_ptr error;
+
+  #pragma omp parallel for num_threads(threads) schedule(dynamic)
+  for (size_t i = 0; i < numFolds; ++i)
+  {
+    // Each fold gets its own team, so that OpenMP loops inside the training
+    // are not split between the threads that run different folds.
+    #pragma omp parallel num_threads(1)
+    {
+      try
+      {
+        RandGen().seed((uint32_t) (seed + i));
+        arma::arma_rng::set_seed(seed + i);
+
+        MLAlgorithm foldModel = train(i);
+        evaluations(i) = Metric::Evaluate(foldModel,
+            GetValidationSubset(xs, i), GetValidationSubset(ys, i));
+        if (i == numFolds - 1)
+          model.reset(new MLAlgorithm(std::move(foldModel)));
+      }
+      catch (...)
+      {
+        #pragma omp critical
+        {
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
 template<typename MLAlgorithm,
          typename Metric,
          typename MatType,
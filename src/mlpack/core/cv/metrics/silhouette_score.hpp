@@ -35,6 +35,13 @@ namespace mlpack {
  * @f}
  *
  * The Overall Silhouette Score is the mean of individual silhoutte scores.
+ *
+ * When the scores are computed from the data (and not from precomputed
+ * distances), the distances are computed in blocks of points, in parallel,
+ * and only the per-cluster sums of distances are stored, so the memory used is
+ * linear in the number of points.  The time is still quadratic; for large
+ * datasets, Sampled() estimates the overall score from a random sample of
+ * points, with a confidence interval.
  */
 class SilhouetteScore
 {
@@ -52,6 +59,30 @@ class SilhouetteScore
                         const arma::Row<size_t>& labels,
                         const Metric& metric);
 
+  /**
+   * Estimate the overall silhouette score as the mean score of a random sample
+   * of points (each scored exactly, against all points), and give a confidence
+   * interval for it.  This takes time linear in the number of points.
+   *
+   * @param X Column-major data used for clustering.
+   * @param labels Labels assigned to data by clustering.
+   * @param metric Metric to be used to calculate dissimilarity.
+   * @param numSamples Number of points to sample (without replacement); with
+   *     at least as many as there are points, the score is exact.
+   * @param lower Lower bound of the confidence interval.
+   * @param upper Upper bound of the confidence interval.
+   * @param confidence Confidence level of the interval.
+   * @return (double) estimated silhouette score.
+   */
+  template<typename DataType, typename Metric>
+  static double Sampled(const DataType& X,
+                        const arma::Row<size_t>& labels,
+                        const Metric& metric,
+                        const size_t numSamples,
+                        double& lower,
+                        double& upper,
+                        const double confidence = 0.95);
+
   /**
    * Find the individual silhouette scores for precomputted dissimilarites.
    *
@@ -96,6 +127,23 @@ class SilhouetteScore
    * to maximize the metric.
    */
   static const bool NeedsMinimization = false;
+
+ private:
+  /**
+   * Find the silhouette scores of the given points, with the distance between
+   * points i and j given by `distance(i, j)`.  The points are handled in blocks
+   * in parallel, and for each point only the sum of its distances to each
+   * cluster is stored.
+   *
+   * @param points Indices of the points to score.
+   * @param labels Labels assigned to data by clustering.
+   * @param distance Function returning the distance between two points.
+   * @return (arma::rowvec) silhouette score of each of the given points.
+   */
+  template<typename DistanceFunctionType>
+  static arma::rowvec PointsScore(const arma::uvec& points,
+                                  const arma::Row<size_t>& labels,
+                                  const DistanceFunctionType& distance);
 };
 
 } // namespace mlpack
@@ -25,49 +25,72 @@ double SilhouetteScore::Overall(const DataType& X,
   return arma::mean(SamplesScore(X, labels, metric));
 }
 
+template<typename DataType, typename Metric>
+double SilhouetteScore::Sampled(const DataType& X,
+                                const arma::Row<size_t>& labels,
+                                const Metric& metric,
+                                const size_t numSamples,
+                                double& lower,
+                                double& upper,
+                                const double confidence)
+{
+  util::CheckSameSizes(X, labels, "SilhouetteScore::Sampled()");
+  if (numSamples == 0)
+  {
+    throw std::invalid_argument("SilhouetteScore::Sampled(): the number of "
+        "samples must be positive");
+  }
+  if (!(confidence > 0.0 && confidence < 1.0))
+  {
+    throw std::invalid_argument("SilhouetteScore::Sampled(): the confidence "
+        "must be in (0, 1)");
+  }
+
+  const size_t n = X.n_cols;
+  const size_t m = std::min(numSamples, n);
+  arma::uvec points;
+  if (m == n)
+    points = arma::linspace<arma::uvec>(0, n - 1, n);
+  else
+    points = arma::sort(arma::randperm<arma::uvec>(n, m));
+
+  const arma::rowvec scores = PointsScore(points, labels,
+      [&](const size_t i, const size_t j)
+      {
+        return metric.Evaluate(X.col(i), X.col(j));
+      });
+
+  const double mean = arma::mean(scores);
+
+  // Standard error of the mean of a sample without replacement (with the
+  // finite population correction, so the interval vanishes when m == n).
+  double halfWidth = 0.0;
+  if (m > 1 && m < n)
+  {
+    const double standardError = arma::stddev(scores) / std::sqrt((double) m) *
+        std::sqrt((double) (n - m) / (double) (n - 1));
+    halfWidth = Quantile(0.5 + confidence / 2.0) * standardError;
+  }
+
+  lower = mean - halfWidth;
+  upper = mean + halfWidth;
+  return mean;
+}
+
 template<typename DataType>
 arma::rowvec SilhouetteScore::SamplesScore(const DataType& distances,
                                            const arma::Row<size_t>& labels)
 {
   util::CheckSameSizes(distances, labels, "SilhouetteScore::SamplesScore()");
 
-  // Stores the silhouette scores of individual samples.
-  arma::rowvec sampleScores(distances.n_rows);
-  // Finds one index per cluster.
-  arma::ucolvec clusterLabels = arma::find_unique(labels, false);
-
-  for (size_t i = 0; i < distances.n_rows; i++)
-  {
-    double interClusterDistance = DBL_MAX, intraClusterDistance = 0;
-    double minInterClusterDistance = DBL_MAX;
-    for (size_t j = 0; j < clusterLabels.n_elem; j++)
-    {
-      size_t clusterLabel = labels(clusterLabels(j));
-      if (labels(i) != clusterLabel) {
-        interClusterDistance = MeanDistanceFromCluster(
-          distances.col(i), labels, clusterLabel, false);
-        if (interClusterDistance < minInterClusterDistance) {
-          minInterClusterDistance = interClusterDistance;
-        }
-      } else {
-        intraClusterDistance = MeanDistanceFromCluster(
-          distances.col(i), labels, clusterLabel, true);
-        if (intraClusterDistance == 0) {
-          // s(i) = 0, no more calculation needed.
-          break;
-        }
-      }
-    }
-    if (intraClusterDistance == 0) {
-      // i is the only element in the cluster.
-      sampleScores(i) = 0.0;
-    } else {
-      sampleScores(i) = minInterClusterDistance - intraClusterDistance;
-      sampleScores(i) /= std::max(
-        intraClusterDistance, minInterClusterDistance);
-    }
-  }
-  return sampleScores;
+  // Columns are contiguous, so the distances from point i are read from its
+  // column.
+  const size_t n = distances.n_rows;
+  return PointsScore(arma::linspace<arma::uvec>(0, n - 1, n), labels,
+      [&](const size_t i, const size_t j)
+      {
+        return distances(j, i);
+      });
 }
 
 template<typename DataType, typename Metric>
@@ -76,8 +99,87 @@ arma::rowvec SilhouetteScore::SamplesScore(const DataType& X,
                                            const Metric& metric)
 {
   util::CheckSameSizes(X, labels, "SilhouetteScore::SamplesScore()");
-  DataType distances = PairwiseDistances(X, metric);
-  return SamplesScore(distances, labels);
+
+  // The distances are computed when needed, so that the full distance matrix
+  // is never stored.
+  const size_t n = X.n_cols;
+  return PointsScore(arma::linspace<arma::uvec>(0, n - 1, n), labels,
+      [&](const size_t i, const size_t j)
+      {
+        return metric.Evaluate(X.col(i), X.col(j));
+      });
+}
+
+template<typename DistanceFunctionType>
+arma::rowvec SilhouetteScore::PointsScore(
+    const arma::uvec& points,
+    const arma::Row<size_t>& labels,
+    const DistanceFunctionType& distance)
+{
+  // Map each label to the index of its cluster, and count the points of each
+  // cluster.
+  const arma::Row<size_t> clusterLabels = arma::unique(labels);
+  arma::uvec clusters(labels.n_elem);
+  arma::vec counts(clusterLabels.n_elem, arma::fill::zeros);
+  for (size_t j = 0; j < labels.n_elem; ++j)
+  {
+    clusters[j] = std::lower_bound(clusterLabels.begin(), clusterLabels.end(),
+        labels[j]) - clusterLabels.begin();
+    counts[clusters[j]] += 1.0;
+  }
+
+  arma::rowvec scores(points.n_elem);
+
+  // Each block of points is scored against all points at once, so that the
+  // points of the block stay in cache while the others are streamed.
+  const size_t blockSize = 64;
+  const size_t numBlocks = (points.n_elem + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t block = 0; block < numBlocks; ++block)
+  {
+    const size_t begin = block * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_elem);
+
+    // Sums of the distances from each point of the block to each cluster.
+    arma::mat sums(clusterLabels.n_elem, end - begin, arma::fill::zeros);
+    for (size_t j = 0; j < labels.n_elem; ++j)
+    {
+      for (size_t b = begin; b < end; ++b)
+      {
+        if (points[b] != j)
+          sums(clusters[j], b - begin) += distance(points[b], j);
+      }
+    }
+
+    for (size_t b = begin; b < end; ++b)
+    {
+      const size_t cluster = clusters[points[b]];
+      // a(i) is 0 if i is the only element of its cluster (and s(i) = 0).
+      const double intraClusterDistance = (counts[cluster] > 1.0) ?
+          sums(cluster, b - begin) / (counts[cluster] - 1.0) : 0.0;
+      if (intraClusterDistance == 0.0)
+      {
+        scores[b] = 0.0;
+        continue;
+      }
+
+      double minInterClusterDistance = DBL_MAX;
+      for (size_t c = 0; c < clusterLabels.n_elem; ++c)
+      {
+        if (c != cluster)
+        {
+          minInterClusterDistance = std::min(minInterClusterDistance,
+              sums(c, b - begin) / counts[c]);
+        }
+      }
+
+      scores[b] = (minInterClusterDistance - intraClusterDistance) /
+          std::max(intraClusterDistance, minInterClusterDistance);
+    }
+  }
+
+  return scores;
 }
 
 inline double SilhouetteScore::MeanDistanceFromCluster(
@@ -207,6 +207,25 @@ class SimpleCV
   template<typename... MLAlgorithmArgs>
   double Evaluate(const MLAlgorithmArgs&... args);
 
+  /**
+   * Train on only the first points of the training set and assess performance
+   * on the whole validation set, as a cheap estimate of the result of
+   * Evaluate() (e.g. for SuccessiveHalving).  The trained model is stored in
+   * `model` instead of being kept for Model(), so this can be called from
+   * several threads at once.
+   *
+   * @param budget Fraction of the training set to train on, in (0, 1]; at
+   *     least one point is used, and the whole training set with a budget of
+   *     1.
+   * @param model Pointer to store the trained model in.
+   * @param args Arguments for the given MLAlgorithm taken by its constructor
+   *     (in addition to the passed ones in the SimpleCV constructor).
+   */
+  template<typename... MLAlgorithmArgs>
+  double PartialEvaluate(const double budget,
+                         std::unique_ptr<MLAlgorithm>& model,
+                         const MLAlgorithmArgs&... args);
+
   //! Access and modify the last trained model.
   MLAlgorithm& Model();
 
@@ -285,21 +304,27 @@ class SimpleCV
                                    const size_t lastCol);
 
   /**
-   * Train and run evaluation in the case of non-weighted learning.
+   * Train on the first `numPoints` training points and run evaluation in the
+   * case of non-weighted learning.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = !Base::MIE::SupportsWeights,
            typename = std::enable_if_t<Enabled>>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  double TrainAndEvaluate(const size_t numPoints,
+                          std::unique_ptr<MLAlgorithm>& model,
+                          const MLAlgorithmArgs&... args);
 
   /**
-   * Train and run evaluation in the case of supporting weighted learning.
+   * Train on the first `numPoints` training points and run evaluation in the
+   * case of supporting weighted learning.
    */
   template<typename... MLAlgorithmArgs,
            bool Enabled = Base::MIE::SupportsWeights,
            typename = std::enable_if_t<Enabled>,
            typename = void>
-  double TrainAndEvaluate(const MLAlgorithmArgs&... args);
+  double TrainAndEvaluate(const size_t numPoints,
+                          std::unique_ptr<MLAlgorithm>& model,
+                          const MLAlgorithmArgs&... args);
 };
 
 } // namespace mlpack
@@ -193,7 +193,33 @@ double SimpleCV<MLAlgorithm,
                 PredictionsType,
                 WeightsType>::Evaluate(const MLAlgorithmArgs&... args)
 {
-  return TrainAndEvaluate(args...);
+  return TrainAndEvaluate(trainingXs.n_cols, modelPtr, args...);
+}
+
+template<typename MLAlgorithm,
+         typename Metric,
+         typename MatType,
+         typename PredictionsType,
+         typename WeightsType>
+template<typename... MLAlgorithmArgs>
+double SimpleCV<MLAlgorithm,
+                Metric,
+                MatType,
+                PredictionsType,
+                WeightsType>::PartialEvaluate(
+    const double budget,
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
+{
+  if (!(budget > 0.0 && budget <= 1.0))
+  {
+    throw std::invalid_argument("SimpleCV::PartialEvaluate(): budget must be "
+        "in (0, 1]");
+  }
+
+  const size_t numPoints = std::min((size_t) trainingXs.n_cols,
+      std::max((size_t) 1, (size_t) std::ceil(budget * trainingXs.n_cols)));
+  return TrainAndEvaluate(numPoints, model, args...);
 }
 
 template<typename MLAlgorithm,
@@ -290,11 +316,17 @@ double SimpleCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    const size_t numPoints,
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
 {
-  modelPtr.reset(new MLAlgorithm(base.Train(trainingXs, trainingYs, args...)));
+  // The subsets are aliases, so nothing is copied.
+  model.reset(new MLAlgorithm(base.Train(
+      GetSubset(trainingXs, 0, numPoints - 1),
+      GetSubset(trainingYs, 0, numPoints - 1), args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*model, validationXs, validationYs);
 }
 
 template<typename MLAlgorithm,
@@ -307,16 +339,23 @@ double SimpleCV<MLAlgorithm,
                 Metric,
                 MatType,
                 PredictionsType,
-                WeightsType>::TrainAndEvaluate(const MLAlgorithmArgs&... args)
+                WeightsType>::TrainAndEvaluate(
+    const size_t numPoints,
+    std::unique_ptr<MLAlgorithm>& model,
+    const MLAlgorithmArgs&... args)
 {
+  // The subsets are aliases, so nothing is copied.
   if (trainingWeights.n_elem > 0)
-    modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, trainingWeights, args...)));
+    model.reset(new MLAlgorithm(base.Train(
+        GetSubset(trainingXs, 0, numPoints - 1),
+        GetSubset(trainingYs, 0, numPoints - 1),
+        GetSubset(trainingWeights, 0, numPoints - 1), args...)));
   else
-    modelPtr.reset(new MLAlgorithm(
-        base.Train(trainingXs, trainingYs, args...)));
+    model.reset(new MLAlgorithm(base.Train(
+        GetSubset(trainingXs, 0, numPoints - 1),
+        GetSubset(trainingYs, 0, numPoints - 1), args...)));
 
-  return Metric::Evaluate(*modelPtr, validationXs, validationYs);
+  return Metric::Evaluate(*model, validationXs, validationYs);
 }
 
 } // namespace mlpack
@@ -0,0 +1,230 @@
+/**
+ * @file core/data/arrow_reader.hpp
+ *
+ * Definition of ArrowReader, which reads Apache Parquet and Arrow IPC files
+ * into matrices, one row group (or record batch) at a time.  This is only
+ * available if mlpack is compiled with Arrow support (MLPACK_HAS_ARROW).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ARROW_READER_HPP
+#define MLPACK_CORE_DATA_ARROW_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef MLPACK_HAS_ARROW
+
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <parquet/arrow/reader.h>
+
+#include "dataset_mapper.hpp"
+#include "extension.hpp"
+#include "types.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * ArrowReader reads a table stored in Apache Parquet (`.parquet`) or Arrow IPC
+ * (`.arrow`, `.feather`) format.  Each row of the table is a point, and each
+ * of the selected columns is a dimension; as with data::Load(), points are the
+ * columns of the loaded matrices, unless `transpose` is false.  The table can
+ * be read all at once with Read(), or one row group (for Parquet) or record
+ * batch (for Arrow IPC) at a time with Next(), so that tables that do not fit
+ * in memory can be processed in blocks.
+ *
+ * Numeric and boolean columns are converted to the element type of the matrix;
+ * null values become NaN (or 0 for integral element types).  When a column
+ * already has the element type of the matrix, it has no null values, and
+ * `transpose` is false, it is copied with a single memcpy into the column of
+ * the matrix.  Arrow IPC files are memory mapped, so their columns are never
+ * copied before that.
+ *
+ * String columns, including dictionary-encoded ones, can only be read with a
+ * DatasetInfo; they are categorical dimensions, and each entry of a dictionary
+ * is mapped once with the DatasetInfo, instead of once for every value.  The
+ * same DatasetInfo must be used for every block, so that the values of each
+ * block are mapped consistently.  Parquet string columns are read as
+ * dictionaries.
+ *
+ * @code
+ * // Only read two columns of the table, one row group at a time.
+ * data::ArrowReader reader("features.parquet", { "x", "y" });
+ * arma::mat block;
+ * while (reader.Next(block))
+ *   std::cout << arma::mean(block, 1);
+ * @endcode
+ *
+ * std::runtime_error is thrown if the file cannot be opened or read, if a
+ * selected column does not exist or has an unsupported type, or if a string
+ * column is read without a DatasetInfo; std::invalid_argument is thrown if a
+ * given DatasetInfo has the wrong dimensionality.
+ */
+class ArrowReader
+{
+ public:
+  /**
+   * Open the given file, and read its schema.
+   *
+   * @param filename Name of the file to read.
+   * @param columns Names of the columns to read, in the order of the
+   *     dimensions; if empty, every column is read.
+   * @param type Type of the file (ParquetBinary, ArrowBinary or AutoDetect, in
+   *     which case the type is found from the extension).
+   */
+  ArrowReader(const std::string& filename,
+              const std::vector<std::string>& columns =
+                  std::vector<std::string>(),
+              const FileType type = FileType::AutoDetect);
+
+  /**
+   * Read the rest of the table into the given matrix, whose memory is
+   * allocated once.  The table must only have numeric and boolean columns.
+   *
+   * @param matrix Matrix to store the table into.
+   * @param transpose If true, each row of the table is a column of the matrix.
+   */
+  template<typename eT>
+  void Read(arma::Mat<eT>& matrix, const bool transpose = true);
+
+  /**
+   * Read the rest of the table into the given matrix, mapping string columns
+   * with the given DatasetInfo.
+   *
+   * @param matrix Matrix to store the table into.
+   * @param info DatasetInfo to map string columns with.
+   * @param transpose If true, each row of the table is a column of the matrix.
+   */
+  template<typename eT, typename PolicyType>
+  void Read(arma::Mat<eT>& matrix,
+            DatasetMapper<PolicyType>& info,
+            const bool transpose = true);
+
+  /**
+   * Read the next row group or record batch into the given matrix.  The table
+   * must only have numeric and boolean columns.
+   *
+   * @param block Matrix to store the block into.
+   * @param transpose If true, each row of the table is a column of the block.
+   * @return false if all blocks were read; the block is then empty.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& block, const bool transpose = true);
+
+  /**
+   * Read the next row group or record batch into the given matrix, mapping
+   * string columns with the given DatasetInfo.
+   *
+   * @param block Matrix to store the block into.
+   * @param info DatasetInfo to map string columns with.
+   * @param transpose If true, each row of the table is a column of the block.
+   * @return false if all blocks were read; the block is then empty.
+   */
+  template<typename eT, typename PolicyType>
+  bool Next(arma::Mat<eT>& block,
+            DatasetMapper<PolicyType>& info,
+            const bool transpose = true);
+
+  //! Go back to the first block.
+  void Reset() { batch = 0; }
+
+  //! Get the number of dimensions (selected columns).
+  size_t Dimensionality() const { return names.size(); }
+  //! Get the names of the dimensions.
+  const std::vector<std::string>& Columns() const { return names; }
+  //! Get the number of points (rows) of the table.
+  size_t Points() const { return points; }
+  //! Get the number of row groups or record batches.
+  size_t Blocks() const { return batches; }
+  //! Get the number of blocks read since the file was opened or reset.
+  size_t Position() const { return batch; }
+
+ private:
+  //! Set up the given DatasetInfo for the selected columns.
+  template<typename PolicyType>
+  void InitializeMapper(DatasetMapper<PolicyType>& info) const;
+
+  //! Get the number of points of the given block.
+  size_t BlockPoints(const size_t block) const;
+
+  //! Read every remaining block into the given matrix, whose memory is
+  //! allocated once, mapping strings with `mapString(string, dimension)`.
+  template<typename eT, typename MapFunctionType>
+  void ReadAll(arma::Mat<eT>& matrix,
+               const bool transpose,
+               MapFunctionType&& mapString);
+
+  //! Read the next block into the given matrix, starting at the given point,
+  //! and mapping strings with `mapString(string, dimension)`.  Returns the
+  //! number of points that were read.
+  template<typename eT, typename MapFunctionType>
+  size_t NextInto(arma::Mat<eT>& matrix,
+                  const size_t offset,
+                  const bool transpose,
+                  MapFunctionType&& mapString);
+
+  //! Get the chunks of each selected column of the next block.
+  size_t NextChunks(std::vector<arrow::ArrayVector>& chunks);
+
+  //! Convert one chunk of a column into the given dimension of the matrix,
+  //! starting at the given point.
+  template<typename eT, typename MapFunctionType>
+  void CopyChunk(const arrow::Array& chunk,
+                 const size_t dimension,
+                 const size_t offset,
+                 arma::Mat<eT>& matrix,
+                 const bool transpose,
+                 MapFunctionType& mapString) const;
+
+  //! Convert one chunk of a numeric column of the given Arrow array type.
+  template<typename ArrayType, typename eT>
+  void CopyValues(const arrow::Array& chunk,
+                  const size_t dimension,
+                  const size_t offset,
+                  arma::Mat<eT>& matrix,
+                  const bool transpose) const;
+
+  //! Get the string at the given position of a string array.
+  std::string GetString(const arrow::Array& array, const size_t i) const;
+
+  //! Throw a std::runtime_error if the given status is an error.
+  void Check(const arrow::Status& status) const;
+
+  //! The name of the file.
+  std::string filename;
+  //! The type of the file.
+  FileType type;
+  //! The mapped file.
+  std::shared_ptr<arrow::io::RandomAccessFile> input;
+  //! The reader of a Parquet file.
+  std::unique_ptr<parquet::arrow::FileReader> parquetReader;
+  //! The reader of an Arrow IPC file.
+  std::shared_ptr<arrow::ipc::RecordBatchFileReader> ipcReader;
+  //! The names of the selected columns.
+  std::vector<std::string> names;
+  //! The indices of the selected columns in the schema.
+  std::vector<int> fieldIndices;
+  //! Whether each selected column holds strings.
+  std::vector<bool> categorical;
+  //! The number of points of the table.
+  size_t points;
+  //! The number of row groups or record batches.
+  size_t batches;
+  //! The next block to read.
+  size_t batch;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "arrow_reader_impl.hpp"
+
+#endif // MLPACK_HAS_ARROW
+
+#endif
@@ -0,0 +1,489 @@
+/**
+ * @file core/data/arrow_reader_impl.hpp
+ *
+ * Implementation of ArrowReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_ARROW_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_ARROW_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "arrow_reader.hpp"
+
+#include <cstring>
+
+namespace mlpack {
+namespace data {
+
+inline ArrowReader::ArrowReader(const std::string& filename,
+                                const std::vector<std::string>& columns,
+                                const FileType inputType) :
+    filename(filename),
+    type(inputType),
+    points(0),
+    batches(0),
+    batch(0)
+{
+  if (type == FileType::AutoDetect)
+  {
+    const std::string extension = Extension(filename);
+    if (extension == "parquet")
+      type = FileType::ParquetBinary;
+    else if (extension == "arrow" || extension == "feather")
+      type = FileType::ArrowBinary;
+  }
+
+  if (type != FileType::ParquetBinary && type != FileType::ArrowBinary)
+  {
+    throw std::runtime_error("ArrowReader::ArrowReader(): cannot read '" +
+        filename + "': only Parquet and Arrow IPC files are supported");
+  }
+
+  // Arrow IPC files are read straight from the mapping, without copies.
+  arrow::Result<std::shared_ptr<arrow::io::MemoryMappedFile>> file =
+      arrow::io::MemoryMappedFile::Open(filename, arrow::io::FileMode::READ);
+  Check(file.status());
+  input = *file;
+
+  std::shared_ptr<arrow::Schema> schema;
+  if (type == FileType::ParquetBinary)
+  {
+    // Read string columns as dictionaries, so that each string only has to be
+    // mapped once per row group.  Leaf columns are fields for flat schemas.
+    parquet::arrow::FileReaderBuilder builder;
+    Check(builder.Open(input));
+    const parquet::SchemaDescriptor* parquetSchema =
+        builder.raw_reader()->metadata()->schema();
+    parquet::ArrowReaderProperties properties =
+        parquet::default_arrow_reader_properties();
+    for (int i = 0; i < parquetSchema->num_columns(); ++i)
+    {
+      if (parquetSchema->Column(i)->physical_type() ==
+          parquet::Type::BYTE_ARRAY)
+        properties.set_read_dictionary(i, true);
+    }
+
+    Check(builder.properties(properties)->Build(&parquetReader));
+    Check(parquetReader->GetSchema(&schema));
+    batches = parquetReader->num_row_groups();
+  }
+  else
+  {
+    arrow::Result<std::shared_ptr<arrow::ipc::RecordBatchFileReader>> reader =
+        arrow::ipc::RecordBatchFileReader::Open(input);
+    Check(reader.status());
+    ipcReader = *reader;
+    schema = ipcReader->schema();
+    batches = ipcReader->num_record_batches();
+  }
+
+  // Select the columns.
+  if (columns.empty())
+  {
+    for (int i = 0; i < schema->num_fields(); ++i)
+    {
+      names.push_back(schema->field(i)->name());
+      fieldIndices.push_back(i);
+    }
+  }
+  else
+  {
+    for (const std::string& name : columns)
+    {
+      const int i = schema->GetFieldIndex(name);
+      if (i == -1)
+      {
+        throw std::runtime_error("ArrowReader::ArrowReader(): '" + filename +
+            "' has no (unique) column named '" + name + "'");
+      }
+
+      names.push_back(name);
+      fieldIndices.push_back(i);
+    }
+  }
+
+  // Check that every selected column can be converted.
+  for (const int i : fieldIndices)
+  {
+    std::shared_ptr<arrow::DataType> fieldType = schema->field(i)->type();
+    if (fieldType->id() == arrow::Type::DICTIONARY)
+    {
+      fieldType = std::static_pointer_cast<arrow::DictionaryType>(
+          fieldType)->value_type();
+      if (fieldType->id() != arrow::Type::STRING &&
+          fieldType->id() != arrow::Type::LARGE_STRING)
+      {
+        throw std::runtime_error("ArrowReader::ArrowReader(): column '" +
+            schema->field(i)->name() + "' of '" + filename + "' is a "
+            "dictionary of unsupported type " + fieldType->ToString());
+      }
+    }
+
+    const arrow::Type::type id = fieldType->id();
+    const bool isString = (id == arrow::Type::STRING ||
+        id == arrow::Type::LARGE_STRING);
+    if (!isString && id != arrow::Type::BOOL && !arrow::is_integer(id) &&
+        id != arrow::Type::FLOAT && id != arrow::Type::DOUBLE)
+    {
+      throw std::runtime_error("ArrowReader::ArrowReader(): column '" +
+          schema->field(i)->name() + "' of '" + filename + "' has "
+          "unsupported type " + fieldType->ToString());
+    }
+
+    categorical.push_back(isString);
+  }
+
+  for (size_t b = 0; b < batches; ++b)
+    points += BlockPoints(b);
+}
+
+template<typename eT>
+void ArrowReader::Read(arma::Mat<eT>& matrix, const bool transpose)
+{
+  for (size_t d = 0; d < names.size(); ++d)
+  {
+    if (categorical[d])
+    {
+      throw std::runtime_error("ArrowReader::Read(): column '" + names[d] +
+          "' holds strings, and must be read with a DatasetInfo");
+    }
+  }
+
+  ReadAll(matrix, transpose, [](const std::string&, const size_t) -> eT
+  {
+    return 0;
+  });
+}
+
+template<typename eT, typename PolicyType>
+void ArrowReader::Read(arma::Mat<eT>& matrix,
+                       DatasetMapper<PolicyType>& info,
+                       const bool transpose)
+{
+  InitializeMapper(info);
+  ReadAll(matrix, transpose, [&](const std::string& s, const size_t d)
+  {
+    return info.template MapString<eT>(s, d);
+  });
+}
+
+template<typename eT>
+bool ArrowReader::Next(arma::Mat<eT>& block, const bool transpose)
+{
+  for (size_t d = 0; d < names.size(); ++d)
+  {
+    if (categorical[d])
+    {
+      throw std::runtime_error("ArrowReader::Next(): column '" + names[d] +
+          "' holds strings, and must be read with a DatasetInfo");
+    }
+  }
+
+  if (batch == batches)
+  {
+    block.clear();
+    return false;
+  }
+
+  const size_t blockPoints = BlockPoints(batch);
+  block.set_size(transpose ? names.size() : blockPoints,
+      transpose ? blockPoints : names.size());
+  NextInto(block, 0, transpose, [](const std::string&, const size_t) -> eT
+  {
+    return 0;
+  });
+  return true;
+}
+
+template<typename eT, typename PolicyType>
+bool ArrowReader::Next(arma::Mat<eT>& block,
+                       DatasetMapper<PolicyType>& info,
+                       const bool transpose)
+{
+  InitializeMapper(info);
+  if (batch == batches)
+  {
+    block.clear();
+    return false;
+  }
+
+  const size_t blockPoints = BlockPoints(batch);
+  block.set_size(transpose ? names.size() : blockPoints,
+      transpose ? blockPoints : names.size());
+  NextInto(block, 0, transpose, [&](const std::string& s, const size_t d)
+  {
+    return info.template MapString<eT>(s, d);
+  });
+  return true;
+}
+
+template<typename PolicyType>
+void ArrowReader::InitializeMapper(DatasetMapper<PolicyType>& info) const
+{
+  if (info.Dimensionality() == 0)
+  {
+    info.SetDimensionality(names.size());
+  }
+  else if (info.Dimensionality() != names.size())
+  {
+    std::ostringstream oss;
+    oss << "ArrowReader: given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << names.size();
+    throw std::invalid_argument(oss.str());
+  }
+
+  for (size_t d = 0; d < names.size(); ++d)
+  {
+    if (categorical[d])
+      info.Type(d) = Datatype::categorical;
+  }
+}
+
+inline size_t ArrowReader::BlockPoints(const size_t block) const
+{
+  if (type == FileType::ParquetBinary)
+    return parquetReader->parquet_reader()->metadata()->RowGroup(
+        block)->num_rows();
+
+  // This does not copy anything, since the file is mapped.
+  arrow::Result<std::shared_ptr<arrow::RecordBatch>> recordBatch =
+      ipcReader->ReadRecordBatch(block);
+  Check(recordBatch.status());
+  return (*recordBatch)->num_rows();
+}
+
+template<typename eT, typename MapFunctionType>
+void ArrowReader::ReadAll(arma::Mat<eT>& matrix,
+                          const bool transpose,
+                          MapFunctionType&& mapString)
+{
+  size_t total = 0;
+  for (size_t b = batch; b < batches; ++b)
+    total += BlockPoints(b);
+
+  matrix.set_size(transpose ? names.size() : total,
+      transpose ? total : names.size());
+  size_t offset = 0;
+  while (batch < batches)
+    offset += NextInto(matrix, offset, transpose, mapString);
+}
+
+template<typename eT, typename MapFunctionType>
+size_t ArrowReader::NextInto(arma::Mat<eT>& matrix,
+                             const size_t offset,
+                             const bool transpose,
+                             MapFunctionType&& mapString)
+{
+  std::vector<arrow::ArrayVector> chunks;
+  const size_t blockPoints = NextChunks(chunks);
+
+  // Numeric columns are independent, so they can be converted in parallel
+  // when each of them is a contiguous column of the matrix.  Strings have to
+  // be mapped in order.
+  const bool parallel = !transpose &&
+      std::find(categorical.begin(), categorical.end(), true) ==
+      categorical.end();
+
+  #pragma omp parallel for schedule(dynamic) if (parallel)
+  for (size_t d = 0; d < names.size(); ++d)
+  {
+    size_t position = offset;
+    for (const std::shared_ptr<arrow::Array>& chunk : chunks[d])
+    {
+      CopyChunk(*chunk, d, position, matrix, transpose, mapString);
+      position += chunk->length();
+    }
+  }
+
+  return blockPoints;
+}
+
+inline size_t ArrowReader::NextChunks(std::vector<arrow::ArrayVector>& chunks)
+{
+  chunks.resize(names.size());
+  if (type == FileType::ParquetBinary)
+  {
+    std::shared_ptr<arrow::Table> table;
+    Check(parquetReader->ReadRowGroup(batch, fieldIndices, &table));
+    ++batch;
+
+    // The columns of the table may not be in the order they were asked for.
+    for (size_t d = 0; d < names.size(); ++d)
+      chunks[d] = table->GetColumnByName(names[d])->chunks();
+    return table->num_rows();
+  }
+
+  arrow::Result<std::shared_ptr<arrow::RecordBatch>> recordBatch =
+      ipcReader->ReadRecordBatch(batch);
+  Check(recordBatch.status());
+  ++batch;
+
+  for (size_t d = 0; d < names.size(); ++d)
+    chunks[d] = { (*recordBatch)->column(fieldIndices[d]) };
+  return (*recordBatch)->num_rows();
+}
+
+template<typename eT, typename MapFunctionType>
+void ArrowReader::CopyChunk(const arrow::Array& chunk,
+                            const size_t dimension,
+                            const size_t offset,
+                            arma::Mat<eT>& matrix,
+                            const bool transpose,
+                            MapFunctionType& mapString) const
+{
+  auto value = [&](const size_t i) -> eT&
+  {
+    return transpose ? matrix(dimension, offset + i) :
+        matrix(offset + i, dimension);
+  };
+
+  switch (chunk.type_id())
+  {
+    case arrow::Type::DOUBLE:
+      CopyValues<arrow::DoubleArray>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::FLOAT:
+      CopyValues<arrow::FloatArray>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::INT8:
+      CopyValues<arrow::Int8Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::INT16:
+      CopyValues<arrow::Int16Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::INT32:
+      CopyValues<arrow::Int32Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::INT64:
+      CopyValues<arrow::Int64Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::UINT8:
+      CopyValues<arrow::UInt8Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::UINT16:
+      CopyValues<arrow::UInt16Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::UINT32:
+      CopyValues<arrow::UInt32Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+    case arrow::Type::UINT64:
+      CopyValues<arrow::UInt64Array>(chunk, dimension, offset, matrix,
+          transpose);
+      break;
+
+    case arrow::Type::BOOL:
+    {
+      const arrow::BooleanArray& values =
+          static_cast<const arrow::BooleanArray&>(chunk);
+      for (int64_t i = 0; i < values.length(); ++i)
+      {
+        value(i) = values.IsNull(i) ? std::numeric_limits<eT>::quiet_NaN() :
+            (eT) values.Value(i);
+      }
+      break;
+    }
+
+    case arrow::Type::STRING:
+    case arrow::Type::LARGE_STRING:
+    {
+      for (int64_t i = 0; i < chunk.length(); ++i)
+      {
+        value(i) = mapString(chunk.IsNull(i) ? std::string() :
+            GetString(chunk, i), dimension);
+      }
+      break;
+    }
+
+    case arrow::Type::DICTIONARY:
+    {
+      // Map each entry of the dictionary once; the values are then indices
+      // into the mapped entries.
+      const arrow::DictionaryArray& values =
+          static_cast<const arrow::DictionaryArray&>(chunk);
+      const arrow::Array& dictionary = *values.dictionary();
+      std::vector<eT> mapped(dictionary.length());
+      for (int64_t k = 0; k < dictionary.length(); ++k)
+        mapped[k] = mapString(GetString(dictionary, k), dimension);
+
+      for (int64_t i = 0; i < values.length(); ++i)
+      {
+        value(i) = values.IsNull(i) ? mapString(std::string(), dimension) :
+            mapped[values.GetValueIndex(i)];
+      }
+      break;
+    }
+
+    default:
+      // The types of the columns were checked when the file was opened.
+      break;
+  }
+}
+
+template<typename ArrayType, typename eT>
+void ArrowReader::CopyValues(const arrow::Array& chunk,
+                             const size_t dimension,
+                             const size_t offset,
+                             arma::Mat<eT>& matrix,
+                             const bool transpose) const
+{
+  using CType = typename ArrayType::value_type;
+  const ArrayType& values = static_cast<const ArrayType&>(chunk);
+  const CType* raw = values.raw_values();
+  const size_t n = values.length();
+
+  if constexpr (std::is_same_v<CType, eT>)
+  {
+    if (!transpose && values.null_count() == 0)
+    {
+      std::memcpy(matrix.colptr(dimension) + offset, raw, n * sizeof(eT));
+      return;
+    }
+  }
+
+  for (size_t i = 0; i < n; ++i)
+  {
+    const eT v = values.IsNull(i) ? std::numeric_limits<eT>::quiet_NaN() :
+        (eT) raw[i];
+    if (transpose)
+      matrix(dimension, offset + i) = v;
+    else
+      matrix(offset + i, dimension) = v;
+  }
+}
+
+inline std::string ArrowReader::GetString(const arrow::Array& array,
+                                          const size_t i) const
+{
+  if (array.type_id() == arrow::Type::STRING)
+    return static_cast<const arrow::StringArray&>(array).GetString(i);
+  else
+    return static_cast<const arrow::LargeStringArray&>(array).GetString(i);
+}
+
+inline void ArrowReader::Check(const arrow::Status& status) const
+{
+  if (!status.ok())
+  {
+    throw std::runtime_error("ArrowReader: cannot read '" + filename + "': " +
+        status.ToString());
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,397 @@
+/**
+ * @file core/data/blob_model.hpp
+ *
+ * Definition of BlobModelWriter and BlobModelReader, which save and load
+ * models in a container format where the memory of large matrices is stored
+ * as raw, aligned blobs that can be copied or memory mapped on load, and where
+ * each model (or submodel) in the file can be loaded on its own.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BLOB_MODEL_HPP
+#define MLPACK_CORE_DATA_BLOB_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/cereal/blob_archive.hpp>
+#include <mlpack/core/util/log.hpp>
+#include <string>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header at the start of a blob model file.  It is followed by the blobs
+ * and the serialized entries, and then by the index table (at `indexOffset`),
+ * which lists the entries and blobs of the file.  All values are stored in the
+ * byte order of the machine that saved the file.
+ */
+struct BlobModelHeader
+{
+  //! Identifies the file as a blob model; always "MLPKBLOB".
+  char magic[8];
+  //! The version of the file format.
+  uint64_t version;
+  //! Always 0x0102030405060708, to detect files with another byte order.
+  uint64_t byteOrder;
+  //! The minimum size (in bytes) of the objects that are stored as blobs.
+  uint64_t minBlobSize;
+  //! The offset of the index table in the file.
+  uint64_t indexOffset;
+  //! The size of the index table, in bytes.
+  uint64_t indexSize;
+};
+
+//! An object (model or submodel) stored in a blob model file.
+struct BlobModelEntry
+{
+  //! The name of the object.
+  std::string name;
+  //! The offset of the serialized object in the file.
+  uint64_t offset;
+  //! The size of the serialized object, in bytes.
+  uint64_t size;
+  //! The index of the first blob of the object.
+  uint64_t firstBlob;
+  //! The number of blobs of the object.
+  uint64_t numBlobs;
+
+  //! Serialize the entry.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(name));
+    ar(CEREAL_NVP(offset));
+    ar(CEREAL_NVP(size));
+    ar(CEREAL_NVP(firstBlob));
+    ar(CEREAL_NVP(numBlobs));
+  }
+};
+
+//! A block of raw memory stored in a blob model file.
+struct BlobModelBlob
+{
+  //! The offset of the blob in the file (a multiple of 64).
+  uint64_t offset;
+  //! The size of the blob in the file, in bytes.
+  uint64_t size;
+  //! The size of the memory held by the blob, in bytes.
+  uint64_t rawSize;
+  //! Whether the blob is compressed with zlib.
+  bool compressed;
+
+  //! Serialize the blob.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(offset));
+    ar(CEREAL_NVP(size));
+    ar(CEREAL_NVP(rawSize));
+    ar(CEREAL_NVP(compressed));
+  }
+};
+
+/**
+ * BlobModelWriter saves models (or any other objects that cereal can
+ * serialize) into a blob model file, which can be read with BlobModelReader.
+ * Each object is stored as a named entry, serialized with cereal's binary
+ * archive, except that the memory of every Armadillo matrix, sparse matrix and
+ * cube of at least `minBlobSize` bytes is stored as a raw blob, aligned to 64
+ * bytes.  The blobs are written to the file as they are serialized, so no copy
+ * of them is held in memory.
+ *
+ * If `compress` is true, each blob is compressed with zlib, and kept
+ * compressed if that makes it smaller.  This requires mlpack to be configured
+ * with zlib support (MLPACK_HAS_ZLIB); compressed blobs must always be copied
+ * when loaded.
+ *
+ * The index table is written when the writer is closed (with Close(), or when
+ * it is destroyed).  Submodels that may be needed separately, such as the
+ * trees of a large random forest, can be added as entries of their own, so
+ * that they can be loaded one at a time.
+ *
+ * @code
+ * RandomForest<> rf(data, labels, 3, 500);
+ *
+ * data::BlobModelWriter writer("forest.mlblob");
+ * for (size_t i = 0; i < rf.NumTrees(); ++i)
+ *   writer.Add("tree" + std::to_string(i), rf.Tree(i));
+ * writer.Close();
+ * @endcode
+ *
+ * std::runtime_error is thrown if the file cannot be written, and
+ * std::invalid_argument if two entries have the same name.
+ */
+class BlobModelWriter
+{
+ public:
+  //! The default minimum size (in bytes) of the objects stored as blobs.
+  static constexpr size_t DefaultMinBlobSize = 4096;
+
+  /**
+   * Create the given file, for writing.
+   *
+   * @param filename Name of the file to write.
+   * @param compress Whether to compress the blobs with zlib.
+   * @param minBlobSize Minimum size (in bytes) of the objects that are stored
+   *     as blobs.
+   */
+  BlobModelWriter(const std::string& filename,
+                  const bool compress = false,
+                  const size_t minBlobSize = DefaultMinBlobSize);
+
+  //! Write the index table, if Close() was not called, and close the file.
+  ~BlobModelWriter();
+
+  //! The writer holds an open file, so it cannot be copied.
+  BlobModelWriter(const BlobModelWriter&) = delete;
+  //! The writer holds an open file, so it cannot be copied.
+  BlobModelWriter& operator=(const BlobModelWriter&) = delete;
+
+  /**
+   * Serialize the given object into the file, as an entry with the given name.
+   *
+   * @param name Name of the entry.
+   * @param object Object to save.
+   */
+  template<typename T>
+  void Add(const std::string& name, const T& object);
+
+  //! Write the index table and close the file.  No entry can be added after.
+  void Close();
+
+  //! Get the number of entries that were added.
+  size_t NumEntries() const { return entries.size(); }
+
+ private:
+  //! The archive that stores blobs with the writer.
+  class Archive : public cereal::BlobOutputArchive
+  {
+   public:
+    Archive(std::ostream& stream, BlobModelWriter& writer) :
+        cereal::BlobOutputArchive(stream, writer.minBlobSize),
+        writer(writer)
+    { }
+
+    uint64_t SaveBlob(const char* data, const size_t size)
+    {
+      return writer.WriteBlob(data, size);
+    }
+
+   private:
+    BlobModelWriter& writer;
+  };
+
+  //! Write the given memory as a blob, and return the index of the blob.
+  uint64_t WriteBlob(const char* data, const size_t size);
+
+  //! Write the given memory at the next multiple of 64 bytes of the file, and
+  //! return its offset.
+  uint64_t WriteAligned(const char* data, const size_t size);
+
+  //! The name of the file.
+  std::string filename;
+  //! The stream the file is written to.
+  std::ofstream stream;
+  //! The offset of the end of the file.
+  uint64_t position;
+  //! Whether the blobs are compressed.
+  bool compress;
+  //! The minimum size of the objects that are stored as blobs.
+  size_t minBlobSize;
+  //! The entries that were added.
+  std::vector<BlobModelEntry> entries;
+  //! The blobs that were written.
+  std::vector<BlobModelBlob> blobs;
+};
+
+/**
+ * BlobModelReader reads the entries of a file written by BlobModelWriter.  The
+ * file is mapped into memory when it is opened, and only its header and index
+ * table are read; each entry is deserialized only when it is loaded with
+ * Load(), so a single submodel can be taken from a large file at the cost of
+ * reading that submodel only.
+ *
+ * By default, the blobs of every loaded matrix are copied out of the mapping.
+ * If `mapped` is true, each dense matrix of a loaded object (whose blob is not
+ * compressed) instead uses the mapped memory directly, so it is never read or
+ * copied until it is used, and processes that load the same file share its
+ * memory through the page cache.  The mapping (see Mapping()) must then be
+ * kept alive for as long as the loaded objects are used; changes to the
+ * matrices are never written back to the file.
+ *
+ * @code
+ * data::BlobModelReader reader("forest.mlblob");
+ * DecisionTree<> tree;
+ * reader.Load("tree17", tree);
+ * @endcode
+ *
+ * std::runtime_error is thrown if the file cannot be mapped or is not a valid
+ * blob model, or if an entry cannot be loaded.
+ */
+class BlobModelReader
+{
+ public:
+  /**
+   * Map the given file, and read its index table.
+   *
+   * @param filename Name of the file to read.
+   * @param mapped Whether loaded matrices use the mapped memory directly.
+   */
+  BlobModelReader(const std::string& filename, const bool mapped = false);
+
+  /**
+   * Load (deserialize) the entry with the given name into the given object.
+   *
+   * @param name Name of the entry.
+   * @param object Object to load into.
+   */
+  template<typename T>
+  void Load(const std::string& name, T& object) const;
+
+  //! Get the names of the entries of the file, in the order they were added.
+  std::vector<std::string> Names() const;
+  //! Return whether the file has an entry with the given name.
+  bool Contains(const std::string& name) const;
+
+  //! Get the mapping of the file, which must outlive objects that were loaded
+  //! with `mapped = true`.
+  const std::shared_ptr<MappedFile>& Mapping() const { return file; }
+  //! Get whether loaded matrices use the mapped memory directly.
+  bool Mapped() const { return mapped; }
+
+ private:
+  //! The archive that reads blobs of one entry with the reader.
+  class Archive : public cereal::BlobInputArchive
+  {
+   public:
+    Archive(std::istream& stream,
+            const BlobModelReader& reader,
+            const BlobModelEntry& entry) :
+        cereal::BlobInputArchive(stream, reader.header.minBlobSize),
+        reader(reader),
+        entry(entry)
+    { }
+
+    char* MapBlob(const uint64_t blob, const size_t size)
+    {
+      return reader.MapBlob(entry, blob, size);
+    }
+
+    void LoadBlob(const uint64_t blob, char* data, const size_t size)
+    {
+      reader.LoadBlob(entry, blob, data, size);
+    }
+
+   private:
+    const BlobModelReader& reader;
+    const BlobModelEntry& entry;
+  };
+
+  //! Find the entry with the given name, or throw.
+  const BlobModelEntry& FindEntry(const std::string& name) const;
+
+  //! Check that the given blob belongs to the given entry and has the given
+  //! size, and return it.
+  const BlobModelBlob& CheckBlob(const BlobModelEntry& entry,
+                                 const uint64_t blob,
+                                 const size_t size) const;
+
+  //! Get the memory of the given blob, or NULL if it must be copied.
+  char* MapBlob(const BlobModelEntry& entry,
+                const uint64_t blob,
+                const size_t size) const;
+
+  //! Copy (and decompress, if needed) the given blob into the given memory.
+  void LoadBlob(const BlobModelEntry& entry,
+                const uint64_t blob,
+                char* data,
+                const size_t size) const;
+
+  //! The name of the file.
+  std::string filename;
+  //! The mapping of the file.
+  std::shared_ptr<MappedFile> file;
+  //! Whether loaded matrices use the mapped memory directly.
+  bool mapped;
+  //! The header of the file.
+  BlobModelHeader header;
+  //! The entries of the file.
+  std::vector<BlobModelEntry> entries;
+  //! The blobs of the file.
+  std::vector<BlobModelBlob> blobs;
+};
+
+/**
+ * Save the given model into a new blob model file, as its only entry.  This is
+ * a shortcut for BlobModelWriter::Add().
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a save failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ *
+ * @param filename Name of the file to save to.
+ * @param name Name of the model in the file.
+ * @param model Model to save.
+ * @param compress Whether to compress the blobs with zlib.
+ * @param fatal If an error should be reported as fatal (default false).
+ */
+template<typename ModelType>
+bool SaveBlobModel(const std::string& filename,
+                   const std::string& name,
+                   const ModelType& model,
+                   const bool compress = false,
+                   const bool fatal = false);
+
+/**
+ * Load the model with the given name from a blob model file.  This is a
+ * shortcut for BlobModelReader::Load().  If `mapped` is true, the matrices of
+ * the model use the mapped file directly, and the model must not be used after
+ * `mapping` (which holds the mapping of the file) is destroyed.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a load failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ *
+ * @param filename Name of the file to load.
+ * @param name Name of the model in the file.
+ * @param model Model to load into.
+ * @param mapping Set to the mapping the matrices of the model live in, if
+ *     `mapped` is true.
+ * @param mapped Whether the matrices of the model use the mapped file.
+ * @param fatal If an error should be reported as fatal (default false).
+ */
+template<typename ModelType>
+bool LoadBlobModel(const std::string& filename,
+                   const std::string& name,
+                   ModelType& model,
+                   std::shared_ptr<MappedFile>& mapping,
+                   const bool mapped = false,
+                   const bool fatal = false);
+
+/**
+ * Load the model with the given name from a blob model file, copying all of
+ * its matrices.  This is a shortcut for BlobModelReader::Load().
+ *
+ * @param filename Name of the file to load.
+ * @param name Name of the model in the file.
+ * @param model Model to load into.
+ * @param fatal If an error should be reported as fatal (default false).
+ */
+template<typename ModelType>
+bool LoadBlobModel(const std::string& filename,
+                   const std::string& name,
+                   ModelType& model,
+                   const bool fatal = false);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "blob_model_impl.hpp"
+
+#endif
@@ -0,0 +1,522 @@
+/**
+ * @file core/data/blob_model_impl.hpp
+ *
+ * Implementation of BlobModelWriter, BlobModelReader, SaveBlobModel() and
+ * LoadBlobModel().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_BLOB_MODEL_IMPL_HPP
+#define MLPACK_CORE_DATA_BLOB_MODEL_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "blob_model.hpp"
+
+#include "mapped_model.hpp"
+
+#include <cstring>
+#include <sstream>
+
+#ifdef MLPACK_HAS_ZLIB
+  #include <zlib.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+//! Blobs start at a multiple of this many bytes in the file.
+static const uint64_t blobModelAlignment = 64;
+
+//! The value of BlobModelHeader::byteOrder.
+static const uint64_t blobModelByteOrder = 0x0102030405060708;
+
+namespace details {
+
+#ifdef MLPACK_HAS_ZLIB
+
+//! zlib takes sizes as unsigned ints, so memory is passed to it in chunks of
+//! at most this many bytes.
+static const size_t zlibMaxChunk = size_t(1) << 30;
+
+/**
+ * Compress the given memory with zlib into `out`, and return true if the
+ * compressed memory is smaller.  Otherwise, compression is stopped as soon as
+ * the output is as large as the input, and false is returned.
+ */
+inline bool BlobCompress(const char* data,
+                         const size_t size,
+                         std::vector<char>& out)
+{
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  if (deflateInit(&zs, Z_DEFAULT_COMPRESSION) != Z_OK)
+    throw std::runtime_error("cannot initialize zlib compression");
+
+  out.resize(size);
+  size_t inPos = 0, outPos = 0;
+  int flush = Z_NO_FLUSH;
+  do
+  {
+    const size_t inChunk = std::min(size - inPos, zlibMaxChunk);
+    zs.next_in = (Bytef*) (data + inPos);
+    zs.avail_in = (uInt) inChunk;
+    inPos += inChunk;
+    flush = (inPos == size) ? Z_FINISH : Z_NO_FLUSH;
+
+    do
+    {
+      if (outPos == out.size())
+      {
+        // The compressed memory would not be smaller.
+        deflateEnd(&zs);
+        return false;
+      }
+
+      const size_t outChunk = std::min(out.size() - outPos, zlibMaxChunk);
+      zs.next_out = (Bytef*) (out.data() + outPos);
+      zs.avail_out = (uInt) outChunk;
+      deflate(&zs, flush);
+      outPos += outChunk - zs.avail_out;
+    } while (zs.avail_out == 0);
+  } while (flush != Z_FINISH);
+
+  deflateEnd(&zs);
+  out.resize(outPos);
+  return outPos < size;
+}
+
+/**
+ * Decompress the given memory with zlib into `out`, which must be exactly the
+ * size of the decompressed memory.  Return false if the compressed memory is
+ * corrupted or has another size.
+ */
+inline bool BlobDecompress(const char* data,
+                           const size_t size,
+                           char* out,
+                           const size_t outSize)
+{
+  z_stream zs;
+  std::memset(&zs, 0, sizeof(zs));
+  if (inflateInit(&zs) != Z_OK)
+    throw std::runtime_error("cannot initialize zlib decompression");
+
+  size_t inPos = 0, outPos = 0;
+  int result = Z_OK;
+  while (result == Z_OK)
+  {
+    if (zs.avail_in == 0 && inPos < size)
+    {
+      const size_t inChunk = std::min(size - inPos, zlibMaxChunk);
+      zs.next_in = (Bytef*) (data + inPos);
+      zs.avail_in = (uInt) inChunk;
+      inPos += inChunk;
+    }
+
+    if (zs.avail_out == 0 && outPos < outSize)
+    {
+      const size_t outChunk = std::min(outSize - outPos, zlibMaxChunk);
+      zs.next_out = (Bytef*) (out + outPos);
+      zs.avail_out = (uInt) outChunk;
+      outPos += outChunk;
+    }
+
+    result = inflate(&zs, Z_NO_FLUSH);
+  }
+
+  inflateEnd(&zs);
+  return (result == Z_STREAM_END && zs.avail_out == 0 && outPos == outSize);
+}
+
+#endif
+
+//! Return the given offset, rounded up to a multiple of the alignment.
+inline uint64_t BlobModelAlign(const uint64_t offset)
+{
+  return (offset + blobModelAlignment - 1) / blobModelAlignment *
+      blobModelAlignment;
+}
+
+} // namespace details
+
+inline BlobModelWriter::BlobModelWriter(const std::string& filename,
+                                        const bool compress,
+                                        const size_t minBlobSize) :
+    filename(filename),
+    position(0),
+    compress(compress),
+    minBlobSize(std::max(minBlobSize, size_t(1)))
+{
+#ifndef MLPACK_HAS_ZLIB
+  if (compress)
+  {
+    throw std::runtime_error("BlobModelWriter: compression requires mlpack "
+        "to be configured with zlib support (MLPACK_HAS_ZLIB)");
+  }
+#endif
+
+  stream.open(filename, std::ofstream::out | std::ofstream::binary |
+      std::ofstream::trunc);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("BlobModelWriter: cannot open file '" + filename +
+        "' for writing");
+  }
+
+  // The header is written again by Close(), once the index table is known.
+  BlobModelHeader header;
+  std::memset(&header, 0, sizeof(header));
+  stream.write((const char*) &header, sizeof(header));
+  position = sizeof(header);
+}
+
+inline BlobModelWriter::~BlobModelWriter()
+{
+  if (stream.is_open())
+  {
+    try
+    {
+      Close();
+    }
+    catch (std::exception& e)
+    {
+      Log::Warn << e.what() << std::endl;
+    }
+  }
+}
+
+template<typename T>
+void BlobModelWriter::Add(const std::string& name, const T& object)
+{
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("BlobModelWriter::Add(): the file '" + filename +
+        "' was already closed");
+  }
+
+  for (const BlobModelEntry& entry : entries)
+  {
+    if (entry.name == name)
+    {
+      throw std::invalid_argument("BlobModelWriter::Add(): there is already "
+          "an entry called '" + name + "'");
+    }
+  }
+
+  // The blobs are written to the file while the object is serialized; the
+  // rest of the object is written after them.
+  BlobModelEntry entry;
+  entry.name = name;
+  entry.firstBlob = blobs.size();
+
+  std::ostringstream objectStream(std::ios::out | std::ios::binary);
+  {
+    Archive ar(objectStream, *this);
+    ar(cereal::make_nvp(name.c_str(), object));
+  }
+
+  const std::string objectString = objectStream.str();
+  entry.numBlobs = blobs.size() - entry.firstBlob;
+  entry.size = objectString.size();
+  entry.offset = WriteAligned(objectString.data(), objectString.size());
+  entries.push_back(std::move(entry));
+}
+
+inline void BlobModelWriter::Close()
+{
+  if (!stream.is_open())
+    return;
+
+  std::ostringstream indexStream(std::ios::out | std::ios::binary);
+  {
+    cereal::BinaryOutputArchive ar(indexStream);
+    ar(CEREAL_NVP(entries));
+    ar(CEREAL_NVP(blobs));
+  }
+  const std::string indexString = indexStream.str();
+
+  BlobModelHeader header;
+  std::memcpy(header.magic, "MLPKBLOB", 8);
+  header.version = 1;
+  header.byteOrder = blobModelByteOrder;
+  header.minBlobSize = minBlobSize;
+  header.indexSize = indexString.size();
+  header.indexOffset = WriteAligned(indexString.data(), indexString.size());
+
+  stream.seekp(0);
+  stream.write((const char*) &header, sizeof(header));
+  const bool good = stream.good();
+  stream.close();
+  if (!good)
+  {
+    throw std::runtime_error("BlobModelWriter: error writing to file '" +
+        filename + "'");
+  }
+}
+
+inline uint64_t BlobModelWriter::WriteBlob(const char* data, const size_t size)
+{
+  BlobModelBlob blob;
+  blob.rawSize = size;
+  blob.compressed = false;
+
+#ifdef MLPACK_HAS_ZLIB
+  if (compress)
+  {
+    std::vector<char> compressed;
+    if (details::BlobCompress(data, size, compressed))
+    {
+      blob.compressed = true;
+      blob.size = compressed.size();
+      blob.offset = WriteAligned(compressed.data(), compressed.size());
+    }
+  }
+#endif
+
+  if (!blob.compressed)
+  {
+    blob.size = size;
+    blob.offset = WriteAligned(data, size);
+  }
+
+  blobs.push_back(blob);
+  return blobs.size() - 1;
+}
+
+inline uint64_t BlobModelWriter::WriteAligned(const char* data,
+                                              const size_t size)
+{
+  const uint64_t offset = details::BlobModelAlign(position);
+  const char padding[blobModelAlignment] = { 0 };
+  stream.write(padding, offset - position);
+  stream.write(data, size);
+  if (!stream.good())
+  {
+    throw std::runtime_error("BlobModelWriter: error writing to file '" +
+        filename + "'");
+  }
+
+  position = offset + size;
+  return offset;
+}
+
+inline BlobModelReader::BlobModelReader(const std::string& filename,
+                                        const bool mapped) :
+    filename(filename),
+    mapped(mapped)
+{
+  file = std::make_shared<MappedFile>(filename);
+
+  // Check that the file is a valid blob model.
+  if (file->Size() < sizeof(header))
+  {
+    throw std::runtime_error("BlobModelReader: file '" + filename + "' is not "
+        "a blob model");
+  }
+
+  std::memcpy(&header, file->Data(), sizeof(header));
+  if (std::memcmp(header.magic, "MLPKBLOB", 8) != 0)
+  {
+    throw std::runtime_error("BlobModelReader: file '" + filename + "' is not "
+        "a blob model");
+  }
+  else if (header.version != 1)
+  {
+    throw std::runtime_error("BlobModelReader: file '" + filename + "' has an "
+        "unknown blob model version");
+  }
+  else if (header.byteOrder != blobModelByteOrder)
+  {
+    throw std::runtime_error("BlobModelReader: file '" + filename + "' was "
+        "saved on a machine with another byte order");
+  }
+  else if (header.indexOffset > file->Size() ||
+           header.indexSize > file->Size() - header.indexOffset)
+  {
+    throw std::runtime_error("BlobModelReader: file '" + filename + "' is "
+        "truncated or corrupted");
+  }
+
+  MappedModelBuffer buffer(file->Data() + header.indexOffset,
+      header.indexSize);
+  std::istream indexStream(&buffer);
+  cereal::BinaryInputArchive ar(indexStream);
+  ar(CEREAL_NVP(entries));
+  ar(CEREAL_NVP(blobs));
+
+  for (const BlobModelEntry& entry : entries)
+  {
+    if (entry.offset > file->Size() ||
+        entry.size > file->Size() - entry.offset ||
+        entry.firstBlob > blobs.size() ||
+        entry.numBlobs > blobs.size() - entry.firstBlob)
+    {
+      throw std::runtime_error("BlobModelReader: file '" + filename + "' is "
+          "truncated or corrupted");
+    }
+  }
+
+  for (const BlobModelBlob& blob : blobs)
+  {
+    if (blob.offset % blobModelAlignment != 0 ||
+        blob.offset > file->Size() ||
+        blob.size > file->Size() - blob.offset)
+    {
+      throw std::runtime_error("BlobModelReader: file '" + filename + "' is "
+          "truncated or corrupted");
+    }
+  }
+}
+
+template<typename T>
+void BlobModelReader::Load(const std::string& name, T& object) const
+{
+  const BlobModelEntry& entry = FindEntry(name);
+
+  MappedModelBuffer buffer(file->Data() + entry.offset, entry.size);
+  std::istream objectStream(&buffer);
+  Archive ar(objectStream, *this, entry);
+  ar(cereal::make_nvp(name.c_str(), object));
+}
+
+inline std::vector<std::string> BlobModelReader::Names() const
+{
+  std::vector<std::string> names;
+  for (const BlobModelEntry& entry : entries)
+    names.push_back(entry.name);
+
+  return names;
+}
+
+inline bool BlobModelReader::Contains(const std::string& name) const
+{
+  for (const BlobModelEntry& entry : entries)
+    if (entry.name == name)
+      return true;
+
+  return false;
+}
+
+inline const BlobModelEntry& BlobModelReader::FindEntry(
+    const std::string& name) const
+{
+  for (const BlobModelEntry& entry : entries)
+    if (entry.name == name)
+      return entry;
+
+  throw std::runtime_error("BlobModelReader: file '" + filename + "' has no "
+      "entry called '" + name + "'");
+}
+
+inline const BlobModelBlob& BlobModelReader::CheckBlob(
+    const BlobModelEntry& entry,
+    const uint64_t blob,
+    const size_t size) const
+{
+  if (blob < entry.firstBlob || blob - entry.firstBlob >= entry.numBlobs ||
+      blobs[blob].rawSize != size)
+  {
+    throw std::runtime_error("BlobModelReader: entry '" + entry.name + "' of "
+        "file '" + filename + "' is corrupted");
+  }
+
+  return blobs[blob];
+}
+
+inline char* BlobModelReader::MapBlob(const BlobModelEntry& entry,
+                                      const uint64_t blob,
+                                      const size_t size) const
+{
+  const BlobModelBlob& b = CheckBlob(entry, blob, size);
+  if (!mapped || b.compressed)
+    return NULL;
+
+  return file->Data() + b.offset;
+}
+
+inline void BlobModelReader::LoadBlob(const BlobModelEntry& entry,
+                                      const uint64_t blob,
+                                      char* data,
+                                      const size_t size) const
+{
+  const BlobModelBlob& b = CheckBlob(entry, blob, size);
+  if (!b.compressed)
+  {
+    std::memcpy(data, file->Data() + b.offset, size);
+    return;
+  }
+
+#ifdef MLPACK_HAS_ZLIB
+  if (!details::BlobDecompress(file->Data() + b.offset, b.size, data, size))
+  {
+    throw std::runtime_error("BlobModelReader: entry '" + entry.name + "' of "
+        "file '" + filename + "' is corrupted");
+  }
+#else
+  throw std::runtime_error("BlobModelReader: entry '" + entry.name + "' of "
+      "file '" + filename + "' is compressed, but mlpack was configured "
+      "without zlib support (MLPACK_HAS_ZLIB)");
+#endif
+}
+
+template<typename ModelType>
+bool SaveBlobModel(const std::string& filename,
+                   const std::string& name,
+                   const ModelType& model,
+                   const bool compress,
+                   const bool fatal)
+{
+  try
+  {
+    BlobModelWriter writer(filename, compress);
+    writer.Add(name, model);
+    writer.Close();
+  }
+  catch (std::exception& e)
+  {
+    return MappedModelError("Unable to save object '" + name + "' to '" +
+        filename + "': " + e.what() + ".", fatal);
+  }
+
+  return true;
+}
+
+template<typename ModelType>
+bool LoadBlobModel(const std::string& filename,
+                   const std::string& name,
+                   ModelType& model,
+                   std::shared_ptr<MappedFile>& mapping,
+                   const bool mapped,
+                   const bool fatal)
+{
+  try
+  {
+    BlobModelReader reader(filename, mapped);
+    reader.Load(name, model);
+    mapping = mapped ? reader.Mapping() : std::shared_ptr<MappedFile>();
+  }
+  catch (std::exception& e)
+  {
+    return MappedModelError("Unable to load object '" + name + "' from '" +
+        filename + "': " + e.what() + ".", fatal);
+  }
+
+  return true;
+}
+
+template<typename ModelType>
+bool LoadBlobModel(const std::string& filename,
+                   const std::string& name,
+                   ModelType& model,
+                   const bool fatal)
+{
+  std::shared_ptr<MappedFile> mapping;
+  return LoadBlobModel(filename, name, model, mapping, false, fatal);
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
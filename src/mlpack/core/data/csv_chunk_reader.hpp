@@ -0,0 +1,181 @@
+/**
+ * @file core/data/csv_chunk_reader.hpp
+ *
+ * Definition of CSVChunkReader, which reads a numeric CSV file a fixed number
+ * of rows at a time, so that datasets larger than memory can be processed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CSV_CHUNK_READER_HPP
+#define MLPACK_CORE_DATA_CSV_CHUNK_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "load_csv.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * CSVChunkReader reads a numeric delimited text file in chunks of at most a
+ * given number of rows, instead of loading the whole file into memory as
+ * data::Load() does.  Like data::Load(), each row of the file becomes a column
+ * (a point) of the returned chunk.  The delimiter is chosen from the extension
+ * of the file: ',' for .csv, a tab for .tsv, and any whitespace for .txt (and
+ * anything else).
+ *
+ * @code
+ * data::CSVChunkReader reader("huge_dataset.csv", 100000);
+ * arma::mat chunk;
+ * while (reader.Next(chunk))
+ * {
+ *   // Process the 100000 (or fewer) points in `chunk`.
+ * }
+ * @endcode
+ *
+ * If the file cannot be opened, or if a row cannot be parsed or has a different
+ * number of values than the first row, a std::runtime_error is thrown.
+ */
+class CSVChunkReader
+{
+ public:
+  /**
+   * Open the given file for reading.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of rows (points) in each chunk.
+   */
+  CSVChunkReader(const std::string& filename, const size_t chunkSize) :
+      filename(filename),
+      chunkSize(chunkSize),
+      stream(filename),
+      dimensionality(0),
+      line(0)
+  {
+    if (!stream.is_open())
+      throw std::runtime_error("cannot open file '" + filename + "'");
+    if (chunkSize == 0)
+      throw std::invalid_argument("CSVChunkReader: chunk size must be "
+          "positive");
+
+    const std::string extension = Extension(filename);
+    if (extension == "csv")
+      delimiter = ',';
+    else if (extension == "tsv")
+      delimiter = '\t';
+    else
+      delimiter = ' ';
+  }
+
+  /**
+   * Read the next chunk of the file.  The chunk has as many rows as the file
+   * has columns, and at most ChunkSize() columns.  Blank lines are skipped.
+   *
+   * @param chunk Matrix to store the chunk into.
+   * @return false if the end of the file was reached and no points were read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk)
+  {
+    std::vector<eT> values;
+    size_t points = 0;
+    std::string lineString;
+    while (points < chunkSize && std::getline(stream, lineString))
+    {
+      ++line;
+      const size_t oldSize = values.size();
+      ParseLine(lineString, values);
+      if (values.size() == oldSize)
+        continue;
+
+      // The first line decides the dimensionality of the dataset.
+      if (dimensionality == 0)
+        dimensionality = values.size();
+      else if (values.size() - oldSize != dimensionality)
+        throw std::runtime_error("line " + std::to_string(line) + " of '" +
+            filename + "' has " + std::to_string(values.size() - oldSize) +
+            " values, but " + std::to_string(dimensionality) +
+            " were expected");
+
+      ++points;
+    }
+
+    if (points == 0)
+    {
+      chunk.set_size(dimensionality, 0);
+      return false;
+    }
+
+    chunk = arma::Mat<eT>(values.data(), dimensionality, points);
+    return true;
+  }
+
+  //! Go back to the start of the file, for another pass over the dataset.
+  void Reset()
+  {
+    stream.clear();
+    stream.seekg(0);
+    line = 0;
+  }
+
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Get the dimensionality of the dataset (0 before the first point is read).
+  size_t Dimensionality() const { return dimensionality; }
+
+ private:
+  //! Append the values of the given line to the given vector.
+  template<typename eT>
+  void ParseLine(const std::string& lineString, std::vector<eT>& values)
+  {
+    std::stringstream lineStream(lineString);
+    std::string token;
+    const size_t oldSize = values.size();
+    while ((delimiter == ' ') ? bool(lineStream >> token) :
+        bool(std::getline(lineStream, token, delimiter)))
+    {
+      eT value;
+      if (!parser.ConvertToken(value, Trim(token)))
+        throw std::runtime_error("cannot parse '" + token + "' on line " +
+            std::to_string(line) + " of '" + filename + "'");
+      values.push_back(value);
+    }
+
+    // A line with only whitespace is blank.
+    if (values.size() == oldSize + 1 && Trim(lineString).empty())
+      values.pop_back();
+  }
+
+  //! Return the given token without leading and trailing whitespace.
+  static std::string Trim(const std::string& token)
+  {
+    const size_t begin = token.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+      return "";
+    const size_t end = token.find_last_not_of(" \t\r");
+    return token.substr(begin, end - begin + 1);
+  }
+
+  //! The name of the file.
+  std::string filename;
+  //! The maximum number of points in each chunk.
+  size_t chunkSize;
+  //! The stream the file is read from.
+  std::ifstream stream;
+  //! The delimiter between values (' ' means any whitespace).
+  char delimiter;
+  //! The dimensionality of the dataset.
+  size_t dimensionality;
+  //! The number of lines read so far.
+  size_t line;
+  //! Used to convert tokens to numbers.
+  LoadCSV parser;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
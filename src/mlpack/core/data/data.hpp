@@ -19,6 +19,9 @@
 
 #include "load.hpp"
 #include "save.hpp"
+#include "mapped_model.hpp"
+#include "mapped_matrix.hpp"
+#include "blob_model.hpp"
 
 #include "imputation_methods/imputation_methods.hpp"
 #include "map_policies/map_policies.hpp"
@@ -29,6 +32,8 @@
 #include "binarize.hpp"
 #include "check_categorical_param.hpp"
 #include "confusion_matrix.hpp"
+#include "csv_chunk_reader.hpp"
+#include "matrix_reader.hpp"
 #include "dataset_mapper.hpp"
 #include "image_info.hpp"
 #include "image_resize_crop.hpp"
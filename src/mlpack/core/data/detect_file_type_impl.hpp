@@ -36,6 +36,8 @@ inline std::string GetStringType(const FileType& type)
     case FileType::PGMBinary:   return "PGM data";
     case FileType::HDF5Binary:  return "HDF5 data";
     case FileType::CoordASCII:  return "ASCII formatted sparse coordinate data";
+    case FileType::ParquetBinary: return "Parquet data";
+    case FileType::ArrowBinary: return "Arrow IPC data";
     default:                    return "";
   }
 }
@@ -292,6 +294,14 @@ inline FileType AutoDetect(std::fstream& stream, const std::string& filename)
   {
     detectedLoadType = FileType::HDF5Binary;
   }
+  else if (extension == "parquet")
+  {
+    detectedLoadType = FileType::ParquetBinary;
+  }
+  else if (extension == "arrow" || extension == "feather")
+  {
+    detectedLoadType = FileType::ArrowBinary;
+  }
   else // Unknown extension...
   {
     detectedLoadType = FileType::FileTypeUnknown;
@@ -46,27 +46,44 @@ class CustomImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    // replace the target value to custom value
-    if (columnMajor)
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Impute all of the given dimensions at once, in a single parallel pass over
+   * the points.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (mappedValues.size() != dimensions.size())
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          input(dimension, i) = customValue;
-        }
-      }
+      throw std::invalid_argument("CustomImputation::Impute(): " +
+          std::to_string(mappedValues.size()) + " mapped values were given "
+          "for " + std::to_string(dimensions.size()) + " dimensions!");
     }
-    else
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+
+    // replace the target values to the custom value
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < numPoints; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      for (size_t d = 0; d < dimensions.size(); ++d)
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          input(i, dimension) = customValue;
-        }
+        T& value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (value == mappedValues[d] || std::isnan(value))
+          value = customValue;
       }
     }
   }
@@ -39,32 +39,78 @@ class ListwiseDeletion
               const size_t dimension,
               const bool columnMajor = true)
   {
-    std::vector<arma::uword> colsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
 
-    if (columnMajor)
+  /**
+   * Remove every row or column that contains the mapped value in any of the
+   * given dimensions.  The points to keep are found in a single parallel pass,
+   * and are then moved in place to the front of the matrix, which is shrunk
+   * once at the end.  This gives the same result as imputing each dimension
+   * in turn.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the dimensions.
+   * @param dimensions Indices of the dimensions to check.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (mappedValues.size() != dimensions.size())
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-         if (!(input(dimension, i) == mappedValue ||
-             std::isnan(input(dimension, i))))
-         {
-           colsToKeep.push_back(i);
-         }
-      }
-      input = input.cols(arma::uvec(colsToKeep));
+      throw std::invalid_argument("ListwiseDeletion::Impute(): " +
+          std::to_string(mappedValues.size()) + " mapped values were given "
+          "for " + std::to_string(dimensions.size()) + " dimensions!");
     }
-    else
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    std::vector<char> keep(numPoints, 1);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < numPoints; ++i)
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      for (size_t d = 0; d < dimensions.size(); ++d)
       {
-        if (!(input(i, dimension) == mappedValue ||
-             std::isnan(input(i, dimension))))
+        const T value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (value == mappedValues[d] || std::isnan(value))
         {
-           colsToKeep.push_back(i);
+          keep[i] = 0;
+          break;
         }
       }
-      input = input.rows(arma::uvec(colsToKeep));
     }
+
+    // Move each point to keep to the first free position; points only move
+    // towards the front, so no point to keep is overwritten.
+    size_t kept = 0;
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      if (!keep[i])
+        continue;
+
+      if (kept != i)
+      {
+        if (columnMajor)
+          input.col(kept) = input.col(i);
+        else
+          input.row(kept) = input.row(i);
+      }
+      ++kept;
+    }
+
+    if (kept == numPoints)
+      return;
+
+    if (columnMajor)
+      input.resize(input.n_rows, kept);
+    else
+      input.resize(kept, input.n_cols);
   }
 }; // class ListwiseDeletion
 
@@ -39,61 +39,87 @@ class MeanImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    double sum = 0;
-    size_t elems = 0; // excluding nan or missing target
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
+
+  /**
+   * Impute all of the given dimensions at once: the means of all dimensions
+   * are computed in a single parallel pass over the points, and the missing
+   * values are replaced in a second one.  This gives the same result as
+   * imputing each dimension in turn.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (mappedValues.size() != dimensions.size())
+    {
+      throw std::invalid_argument("MeanImputation::Impute(): " +
+          std::to_string(mappedValues.size()) + " mapped values were given "
+          "for " + std::to_string(dimensions.size()) + " dimensions!");
+    }
 
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    const size_t numDims = dimensions.size();
 
+    // Calculate the number of elements of each dimension and their sum,
+    // excluding the mapped value or NaN.  Each thread sums its own points.
+    arma::vec sums(numDims, arma::fill::zeros);
+    arma::Col<size_t> elems(numDims, arma::fill::zeros);
 
-    // calculate number of elements and sum of them excluding mapped value or
-    // nan. while doing that, remember where mappedValue or NaN exists.
-    if (columnMajor)
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
+      arma::vec threadSums(numDims, arma::fill::zeros);
+      arma::Col<size_t> threadElems(numDims, arma::fill::zeros);
+
+      #pragma omp for schedule(static)
+      for (size_t i = 0; i < numPoints; ++i)
       {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
+        for (size_t d = 0; d < numDims; ++d)
         {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elems++;
-          sum += input(dimension, i);
+          const T value = columnMajor ? input(dimensions[d], i) :
+              input(i, dimensions[d]);
+          if (!(value == mappedValues[d] || std::isnan(value)))
+          {
+            threadSums[d] += value;
+            ++threadElems[d];
+          }
         }
       }
-    }
-    else
-    {
-      for (size_t i = 0; i < input.n_rows; ++i)
+
+      #pragma omp critical
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
-        {
-          targets.emplace_back(i, dimension);
-        }
-        else
-        {
-          elems++;
-          sum += input(i, dimension);
-        }
+        sums += threadSums;
+        elems += threadElems;
       }
     }
 
-    if (elems == 0)
+    if (numDims > 0 && elems.min() == 0)
       Log::Fatal << "it is impossible to calculate mean; no valid elements in "
           << "the dimension" << std::endl;
 
-    // calculate mean;
-    const double mean = sum / elems;
+    // calculate means.
+    const arma::vec means = sums / arma::conv_to<arma::vec>::from(elems);
 
-    // Now replace the calculated mean to the missing variables
-    // It only needs to loop through targets vector, not the whole matrix.
-    for (const PairType& target : targets)
+    // Now replace the calculated means to the missing variables.
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < numPoints; ++i)
     {
-      input(target.first, target.second) = mean;
+      for (size_t d = 0; d < numDims; ++d)
+      {
+        T& value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (value == mappedValues[d] || std::isnan(value))
+          value = means[d];
+      }
     }
   }
 }; // class MeanImputation
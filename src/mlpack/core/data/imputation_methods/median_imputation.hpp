@@ -40,49 +40,92 @@ class MedianImputation
               const size_t dimension,
               const bool columnMajor = true)
   {
-    using PairType = std::pair<size_t, size_t>;
-    // dimensions and indexes are saved as pairs inside this vector.
-    std::vector<PairType> targets;
-    // good elements are kept inside this vector.
-    std::vector<double> elemsToKeep;
+    Impute(input, std::vector<T>(1, mappedValue),
+        std::vector<size_t>(1, dimension), columnMajor);
+  }
 
-    if (columnMajor)
+  /**
+   * Impute all of the given dimensions at once.  The medians of the
+   * dimensions are computed in parallel, each by one thread that gathers the
+   * valid elements into its own buffer and finds the middle ones with
+   * std::nth_element() instead of sorting them; the missing values are then
+   * replaced in a single parallel pass over the points.  This gives the same
+   * result as imputing each dimension in turn.
+   *
+   * @param input Matrix that contains the mapped values.
+   * @param mappedValues Value that the user wants to get rid of, for each of
+   *     the dimensions.
+   * @param dimensions Indices of the dimensions to impute.
+   * @param columnMajor State of whether the input matrix is columnMajor or not.
+   */
+  void Impute(arma::Mat<T>& input,
+              const std::vector<T>& mappedValues,
+              const std::vector<size_t>& dimensions,
+              const bool columnMajor = true)
+  {
+    if (mappedValues.size() != dimensions.size())
     {
-      for (size_t i = 0; i < input.n_cols; ++i)
-      {
-        if (input(dimension, i) == mappedValue ||
-            std::isnan(input(dimension, i)))
-        {
-          targets.emplace_back(dimension, i);
-        }
-        else
-        {
-          elemsToKeep.push_back(input(dimension, i));
-        }
-      }
+      throw std::invalid_argument("MedianImputation::Impute(): " +
+          std::to_string(mappedValues.size()) + " mapped values were given "
+          "for " + std::to_string(dimensions.size()) + " dimensions!");
     }
-    else
+
+    const size_t numPoints = columnMajor ? input.n_cols : input.n_rows;
+    const size_t numDims = dimensions.size();
+    std::vector<double> medians(numDims);
+    size_t emptyDimensions = 0;
+
+    #pragma omp parallel
     {
-      for (size_t i = 0; i < input.n_rows; ++i)
+      // good elements are kept inside this buffer.
+      std::vector<double> elemsToKeep;
+
+      #pragma omp for schedule(dynamic) reduction(+:emptyDimensions)
+      for (size_t d = 0; d < numDims; ++d)
       {
-        if (input(i, dimension) == mappedValue ||
-            std::isnan(input(i, dimension)))
+        elemsToKeep.clear();
+        for (size_t i = 0; i < numPoints; ++i)
         {
-          targets.emplace_back(i, dimension);
+          const T value = columnMajor ? input(dimensions[d], i) :
+              input(i, dimensions[d]);
+          if (!(value == mappedValues[d] || std::isnan(value)))
+            elemsToKeep.push_back(value);
         }
-        else
+
+        if (elemsToKeep.empty())
         {
-           elemsToKeep.push_back(input(i, dimension));
+          ++emptyDimensions;
+          continue;
+        }
+
+        // For an even number of elements, the median is the average of the
+        // two middle ones; the lower one is the largest of the lower half.
+        const size_t middle = elemsToKeep.size() / 2;
+        std::nth_element(elemsToKeep.begin(), elemsToKeep.begin() + middle,
+            elemsToKeep.end());
+        medians[d] = elemsToKeep[middle];
+        if (elemsToKeep.size() % 2 == 0)
+        {
+          medians[d] = (medians[d] + *std::max_element(elemsToKeep.begin(),
+              elemsToKeep.begin() + middle)) / 2;
         }
       }
     }
 
-    // calculate median
-    const double median = arma::median(arma::vec(elemsToKeep));
+    if (emptyDimensions > 0)
+      Log::Fatal << "it is impossible to calculate median; no valid elements "
+          << "in the dimension" << std::endl;
 
-    for (const PairType& target : targets)
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < numPoints; ++i)
     {
-       input(target.first, target.second) = median;
+      for (size_t d = 0; d < numDims; ++d)
+      {
+        T& value = columnMajor ? input(dimensions[d], i) :
+            input(i, dimensions[d]);
+        if (value == mappedValues[d] || std::isnan(value))
+          value = medians[d];
+      }
     }
   }
 }; // class MedianImputation
@@ -17,6 +17,7 @@
 #include <mlpack/prereqs.hpp>
 #include <string>
 
+#include "arrow_reader.hpp"
 #include "format.hpp"
 #include "dataset_mapper.hpp"
 #include "detect_file_type.hpp"
@@ -24,6 +25,9 @@
 #include "load_csv.hpp"
 #include "load_arff.hpp"
 #include "load_image.hpp"
+#include "mapped_file.hpp"
+
+#include <mlpack/core/util/first_touch.hpp>
 
 namespace mlpack {
 namespace data /** Functions to load and save matrices and models. */ {
@@ -44,6 +48,10 @@ namespace data /** Functions to load and save matrices and models. */ {
  *  - Raw binary (arma::raw_binary), denoted by .bin
  *  - Armadillo binary (arma::arma_binary), denoted by .bin
  *  - HDF5 (arma::hdf5_binary), denoted by .hdf, .hdf5, .h5, or .he5
+ *  - Apache Parquet, denoted by .parquet, and Apache Arrow IPC, denoted by
+ *    .arrow or .feather, if mlpack is compiled with MLPACK_HAS_ARROW (only
+ *    numeric columns; see ArrowReader to select columns or read the file in
+ *    blocks)
  *
  * By default, this function will try to automatically determine the type of
  * file to load based on its extension and by inspecting the file.  If you know
@@ -67,6 +75,9 @@ namespace data /** Functions to load and save matrices and models. */ {
  * @param fatal If an error should be reported as fatal (default false).
  * @param transpose If true, transpose the matrix after loading (default true).
  * @param inputLoadType Used to determine the type of file to load (default arma::auto_detect).
+ * @param firstTouch If true, move the loaded matrix to memory first touched in
+ *     parallel, so that on NUMA machines each thread of mlpack's parallel loops
+ *     reads its points from local memory (default false; see FirstTouch()).
  * @return Boolean value indicating success or failure of load.
  */
 template<typename eT>
@@ -74,7 +85,8 @@ bool Load(const std::string& filename,
           arma::Mat<eT>& matrix,
           const bool fatal = false,
           const bool transpose = true,
-          const FileType inputLoadType = FileType::AutoDetect);
+          const FileType inputLoadType = FileType::AutoDetect,
+          const bool firstTouch = false);
 
 /**
  * Loads a sparse matrix from file, using arma::coord_ascii format.  This
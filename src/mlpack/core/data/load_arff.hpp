@@ -54,6 +54,46 @@ void LoadARFF(const std::string& filename,
               arma::Mat<eT>& matrix,
               DatasetMapper<PolicyType>& info);
 
+/**
+ * Read the header of an ARFF dataset from the given stream, up to and
+ * including the @data line, and set up the given DatasetInfo with the types of
+ * the dimensions and the categories that the header lists, like LoadARFF().
+ * The stream is left at the first line of the data.  An exception is thrown on
+ * failure.
+ *
+ * @param ifs Stream to read the header from.
+ * @param info DatasetInfo object; can be default-constructed or pre-existing.
+ * @param categoryStrings Filled with the categories of each dimension whose
+ *     categories are listed in the header.
+ * @return Number of lines in the header.
+ */
+template<typename eT, typename PolicyType>
+size_t LoadARFFHeader(std::istream& ifs,
+                      DatasetMapper<PolicyType>& info,
+                      std::map<size_t, std::vector<std::string>>&
+                          categoryStrings);
+
+/**
+ * Parse one (trimmed) line of the @data section of an ARFF dataset into the
+ * given column of the given matrix, with the DatasetInfo and categories set up
+ * by LoadARFFHeader().  An exception is thrown on failure.
+ *
+ * @param line Line to parse.
+ * @param lineNumber Number of the line in the file, for error messages.
+ * @param info DatasetInfo object to map categorical values with.
+ * @param categoryStrings Categories listed in the header of the file.
+ * @param matrix Matrix to store the point in.
+ * @param column Column of the matrix to store the point in.
+ */
+template<typename eT, typename PolicyType>
+void LoadARFFPoint(std::string& line,
+                   const size_t lineNumber,
+                   DatasetMapper<PolicyType>& info,
+                   const std::map<size_t, std::vector<std::string>>&
+                       categoryStrings,
+                   arma::Mat<eT>& matrix,
+                   const size_t column);
+
 } // namespace data
 } // namespace mlpack
 
@@ -30,6 +30,278 @@ void LoadCSV::LoadCategoricalCSV(arma::Mat<eT> &inout,
     NonTransposeParse(inout, infoSet);
 }
 
+template<typename eT, typename PolicyType>
+void LoadCSV::LoadCategoricalCSV(arma::Mat<eT>& inout,
+                                 DatasetMapper<PolicyType>& infoSet,
+                                 const char* data,
+                                 const size_t size,
+                                 const bool transpose)
+{
+  using LineType = std::pair<const char*, const char*>;
+  using DictionaryType = std::unordered_map<std::string_view, size_t>;
+
+  const size_t numBlocks = (size + ParseBlockSize - 1) / ParseBlockSize;
+
+  // Remove whitespace from either side of the given range.
+  auto trim = [](const char*& begin, const char*& end)
+  {
+    while (begin != end && std::isspace((unsigned char) *begin))
+      ++begin;
+    while (end != begin && std::isspace((unsigned char) *(end - 1)))
+      --end;
+  };
+
+  // Call f(begin, end) on each token of the given line, with the same rules as
+  // the serial parser: tokens are trimmed, and a token that starts with a
+  // quote extends to the next piece that ends with a quote.
+  auto forEachToken = [&](const char* begin, const char* end, auto&& f)
+  {
+    const char* piece = begin;
+    while (true)
+    {
+      const char* pieceEnd = std::find(piece, end, delim);
+      const char* tokenBegin = piece;
+      const char* tokenEnd = pieceEnd;
+      trim(tokenBegin, tokenEnd);
+
+      if (tokenBegin != tokenEnd && *tokenBegin == '"' &&
+          *(tokenEnd - 1) != '"')
+      {
+        while (pieceEnd != end)
+        {
+          piece = pieceEnd + 1;
+          pieceEnd = std::find(piece, end, delim);
+          if (pieceEnd != piece && *(pieceEnd - 1) == '"')
+            break;
+        }
+        tokenEnd = pieceEnd;
+      }
+
+      f(tokenBegin, tokenEnd);
+      if (pieceEnd == end)
+        break;
+      piece = pieceEnd + 1;
+    }
+  };
+
+  // Find the non-empty lines that start in each block, and count their tokens.
+  std::vector<std::vector<LineType>> blockLines(numBlocks);
+  std::vector<std::vector<size_t>> blockCounts(numBlocks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const char* blockEnd = data + std::min(size, (b + 1) * ParseBlockSize);
+    const char* line = data + b * ParseBlockSize;
+    if (b > 0 && *(line - 1) != '\n')
+    {
+      line = std::find(line, data + size, '\n');
+      line = (line == data + size) ? line : line + 1;
+    }
+
+    while (line < blockEnd)
+    {
+      const char* next = std::find(line, data + size, '\n');
+      const char* begin = line;
+      const char* end = next;
+      trim(begin, end);
+      if (begin != end)
+      {
+        size_t count = 0;
+        forEachToken(begin, end, [&](const char*, const char*) { ++count; });
+        blockLines[b].push_back(LineType(begin, end));
+        blockCounts[b].push_back(count);
+      }
+
+      line = (next == data + size) ? next : next + 1;
+    }
+  }
+
+  // Find the index of the first line of each block, and check that all lines
+  // have the same number of tokens.
+  std::vector<size_t> blockFirstLines(numBlocks, 0);
+  size_t lines = 0, tokens = 0;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    blockFirstLines[b] = lines;
+    for (size_t i = 0; i < blockCounts[b].size(); ++i, ++lines)
+    {
+      if (lines == 0)
+        tokens = blockCounts[b][i];
+
+      if (blockCounts[b][i] != tokens)
+      {
+        std::ostringstream oss;
+        oss << "LoadCSV::LoadCategoricalCSV(): wrong number of dimensions ("
+            << blockCounts[b][i] << ") on line " << lines << "; should be "
+            << tokens << " dimensions.";
+        throw std::runtime_error(oss.str());
+      }
+    }
+  }
+
+  // If the matrix is transposed, each line is a point; otherwise, each line is
+  // a dimension.
+  const size_t dims = transpose ? tokens : lines;
+  const size_t points = transpose ? lines : tokens;
+  if (infoSet.Dimensionality() == 0)
+  {
+    infoSet.SetDimensionality(dims);
+  }
+  else if (infoSet.Dimensionality() != dims)
+  {
+    std::ostringstream oss;
+    oss << "data::LoadCSV(): given DatasetInfo has dimensionality "
+        << infoSet.Dimensionality() << ", but data has dimensionality "
+        << dims;
+    throw std::invalid_argument(oss.str());
+  }
+
+  inout.set_size(dims, points);
+
+  // The dimension of the token at the given position of the given line.
+  auto dimension = [&](const size_t line, const size_t position)
+  {
+    return transpose ? position : line;
+  };
+
+  // In the first pass, find the types of the dimensions.  Types only change
+  // from numeric to categorical, so the types found by each thread can be
+  // merged in any order.
+  if (PolicyType::NeedsFirstPass)
+  {
+    #pragma omp parallel
+    {
+      PolicyType policy(infoSet.Policy());
+      DatasetMapper<PolicyType> threadInfo(policy, dims);
+      for (size_t d = 0; d < dims; ++d)
+        threadInfo.Type(d) = infoSet.Type(d);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        for (size_t i = 0; i < blockLines[b].size(); ++i)
+        {
+          size_t position = 0;
+          forEachToken(blockLines[b][i].first, blockLines[b][i].second,
+              [&](const char* begin, const char* end)
+              {
+                threadInfo.template MapFirstPass<eT>(std::string(begin, end),
+                    dimension(blockFirstLines[b] + i, position++));
+              });
+        }
+      }
+
+      #pragma omp critical
+      {
+        for (size_t d = 0; d < dims; ++d)
+        {
+          if (threadInfo.Type(d) == Datatype::categorical)
+            infoSet.Type(d) = Datatype::categorical;
+        }
+      }
+    }
+  }
+
+  std::vector<char> categorical(dims, 0);
+  for (size_t d = 0; d < dims; ++d)
+    categorical[d] = (infoSet.Type(d) == Datatype::categorical);
+
+  // In the second pass, convert the numeric values, and collect the distinct
+  // tokens of the categorical dimensions of each block.  For a block, the
+  // dictionaries are indexed by the dimension relative to the first dimension
+  // of the block.
+  std::vector<std::vector<std::vector<std::string_view>>> blockTokens(
+      numBlocks);
+  std::vector<std::vector<size_t>> blockIds(numBlocks);
+
+  #pragma omp parallel
+  {
+    PolicyType policy(infoSet.Policy());
+    DatasetMapper<PolicyType> threadInfo(policy, dims);
+    for (size_t d = 0; d < dims; ++d)
+      threadInfo.Type(d) = infoSet.Type(d);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t firstDim = transpose ? 0 : blockFirstLines[b];
+      const size_t blockDims = transpose ? dims : blockLines[b].size();
+      std::vector<DictionaryType> dictionaries(blockDims);
+      blockTokens[b].resize(blockDims);
+
+      for (size_t i = 0; i < blockLines[b].size(); ++i)
+      {
+        const size_t line = blockFirstLines[b] + i;
+        size_t position = 0;
+        forEachToken(blockLines[b][i].first, blockLines[b][i].second,
+            [&](const char* begin, const char* end)
+            {
+              const size_t d = dimension(line, position);
+              const size_t point = transpose ? line : position;
+              ++position;
+
+              if (!categorical[d])
+              {
+                inout.at(d, point) = threadInfo.template MapString<eT>(
+                    std::string(begin, end), d);
+                return;
+              }
+
+              const std::string_view token(begin, end - begin);
+              std::vector<std::string_view>& dimTokens =
+                  blockTokens[b][d - firstDim];
+              const auto it = dictionaries[d - firstDim].emplace(token,
+                  dimTokens.size()).first;
+              if (it->second == dimTokens.size())
+                dimTokens.push_back(token);
+              blockIds[b].push_back(it->second);
+            });
+      }
+    }
+  }
+
+  // Map the distinct tokens of each block, in the order of the blocks, which
+  // is the order in which the serial parser first sees them.
+  std::vector<std::vector<std::vector<eT>>> blockValues(numBlocks);
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t firstDim = transpose ? 0 : blockFirstLines[b];
+    blockValues[b].resize(blockTokens[b].size());
+    for (size_t i = 0; i < blockTokens[b].size(); ++i)
+    {
+      blockValues[b][i].reserve(blockTokens[b][i].size());
+      for (const std::string_view& token : blockTokens[b][i])
+      {
+        blockValues[b][i].push_back(infoSet.template MapString<eT>(
+            std::string(token), firstDim + i));
+      }
+    }
+  }
+
+  // Last, write the values of the categorical dimensions, in the order in
+  // which the tokens were collected.
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t firstDim = transpose ? 0 : blockFirstLines[b];
+    size_t k = 0;
+    for (size_t i = 0; i < blockLines[b].size(); ++i)
+    {
+      const size_t line = blockFirstLines[b] + i;
+      for (size_t position = 0; position < tokens; ++position)
+      {
+        const size_t d = dimension(line, position);
+        if (categorical[d])
+        {
+          inout.at(d, transpose ? line : position) =
+              blockValues[b][d - firstDim][blockIds[b][k++]];
+        }
+      }
+    }
+  }
+}
+
 inline void LoadCSV::CategoricalMatSize(
     std::stringstream& lineStream, size_t& col, const char delim)
 {
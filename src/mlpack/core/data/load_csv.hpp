@@ -43,8 +43,13 @@
 #define MLPACK_CORE_DATA_LOAD_CSV_HPP
 
 #include <mlpack/core/util/log.hpp>
+#include <cctype>
+#include <charconv>
+#include <cstring>
 #include <set>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include "string_algorithms.hpp"
 #include "extension.hpp"
@@ -113,6 +118,28 @@ class LoadCSV
   template<typename eT>
   bool LoadNumericCSV(arma::Mat<eT>& x, std::fstream& f);
 
+  /**
+   * Returns a bool value showing whether data was loaded successfully or not.
+   *
+   * Parses the contents of a csv file that is already in memory (for instance
+   * a MappedFile), with the same rules as the stream version above, but in
+   * parallel.  The first pass finds the lines and the number of columns of each
+   * block of the contents; the second pass converts the values of each block
+   * straight into the matrix, which is only allocated once.  If transpose is
+   * true, each line of the file becomes a column of the matrix, so that no
+   * transposition is needed afterwards.
+   *
+   * @param x Matrix in which data will be loaded.
+   * @param data Contents of the file.
+   * @param size Size of the contents of the file, in bytes.
+   * @param transpose If true, load each line of the file into a column.
+   */
+  template<typename eT>
+  bool LoadNumericCSV(arma::Mat<eT>& x,
+                      const char* data,
+                      const size_t size,
+                      const bool transpose);
+
   /**
   * Converts the given string token to assigned datatype and assigns
   * this value to the given address. The address here will be a
@@ -127,6 +154,18 @@ class LoadCSV
   template<typename eT>
   bool ConvertToken(eT& val, const std::string& token);
 
+  /**
+   * Converts the token in the given range of characters, like the version
+   * above.  Common numbers are converted with std::from_chars(), if the
+   * standard library supports it for the type, without copying the token.
+   *
+   * @param val Token's value will be assigned to this address.
+   * @param begin Start of the token.
+   * @param end End of the token (one past its last character).
+   */
+  template<typename eT>
+  bool ConvertToken(eT& val, const char* begin, const char* end);
+
   /**
    * Calculate the number of columns in each row
    * and assign the value to the col. This function
@@ -154,6 +193,39 @@ class LoadCSV
                           DatasetMapper<PolicyType> &infoSet,
                           const bool transpose = true);
 
+  /**
+   * Load the contents of a csv file that is already in memory (for instance a
+   * MappedFile) into the given matrix with the given DatasetMapper, in
+   * parallel, with the same result as the version above.  Lines that are empty
+   * are skipped.  Throws exceptions on errors.
+   *
+   * Each block of the contents is handled by one thread.  The first pass over
+   * the blocks finds the lines and the types of the dimensions, with a copy of
+   * the mapper for each thread.  The second pass converts the numeric values,
+   * and collects the distinct tokens of each categorical dimension in each
+   * block, in order of first occurrence, in a dictionary that refers to the
+   * contents of the file (so no strings are allocated).  The dictionaries are
+   * then passed to the mapper in the order of the blocks, so that each
+   * distinct token is mapped once, and gets the same value as when the file is
+   * loaded serially; last, the categorical values are written in parallel.
+   *
+   * This is only correct for policies where a token in a numeric dimension is
+   * never mapped, and the value of a token in a categorical dimension only
+   * depends on the tokens that were mapped before it, such as IncrementPolicy.
+   *
+   * @param inout Matrix to load into.
+   * @param infoSet DatasetMapper to use while loading.
+   * @param data Contents of the file.
+   * @param size Size of the contents of the file, in bytes.
+   * @param transpose If true, the matrix should be transposed on loading.
+   */
+  template<typename eT, typename PolicyType>
+  void LoadCategoricalCSV(arma::Mat<eT>& inout,
+                          DatasetMapper<PolicyType>& infoSet,
+                          const char* data,
+                          const size_t size,
+                          const bool transpose = true);
+
   /**
   * Peek at the file to determine the number of rows and columns in the matrix,
   * assuming a non-transposed matrix.  This will also take a first pass over
@@ -295,6 +367,9 @@ class LoadCSV
   template<typename T, typename PolicyType>
   void TransposeParse(arma::Mat<T>& inout, DatasetMapper<PolicyType>& infoSet);
 
+  //! Number of bytes of each block of the file parsed by one thread.
+  static constexpr size_t ParseBlockSize = 8 * 1024 * 1024;
+
   //! Extension (type) of file.
   std::string extension;
   //! Name of file.
@@ -302,7 +377,7 @@ class LoadCSV
   //! Opened stream for reading.
   std::fstream inFile;
   //! Delimiter char.
-  char delim;
+  char delim = ',';
 };
 
 } // namespace data
@@ -16,6 +16,7 @@
 #include <mlpack/core/stb/stb.hpp>
 
 #include "image_info.hpp"
+#include "image_resize_crop.hpp"
 
 namespace mlpack {
 namespace data {
@@ -40,7 +41,10 @@ bool Load(const std::string& filename,
           const bool fatal = false);
 
 /**
- * Load the image file into the given matrix.
+ * Load the image files into the given matrix, one image per column.  All of
+ * the images must have the dimensions of the first one.  The images are
+ * decoded in parallel, straight into their columns, so only one decoded image
+ * per thread is held in memory besides the matrix.
  *
  * @param files A vector consisting of filenames.
  * @param matrix Matrix to save the image from.
@@ -54,6 +58,33 @@ bool Load(const std::vector<std::string>& files,
           ImageInfo& info,
           const bool fatal = false);
 
+/**
+ * Load the image files into the given matrix, one image per column, resizing
+ * each image to the given dimensions as it is decoded, as ResizeImages() (or,
+ * if `crop` is true, ResizeCropImages()) would.  So, the images may have
+ * different dimensions, and the full-size images are never held in one
+ * matrix.  The images are decoded and resized in parallel, and are resized in
+ * 8-bit precision before they are converted to `eT`.  On return, `info` holds
+ * the new dimensions.
+ *
+ * @param files A vector consisting of filenames.
+ * @param matrix Matrix to load the images into.
+ * @param info An object of ImageInfo class.
+ * @param newWidth The width to resize each image to.
+ * @param newHeight The height to resize each image to.
+ * @param crop If true, keep the aspect ratio and crop the images.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @return Boolean value indicating success or failure of load.
+ */
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const size_t newWidth,
+          const size_t newHeight,
+          const bool crop = false,
+          const bool fatal = false);
+
 // Implementation found in load_image.hpp.
 inline bool LoadImage(const std::string& filename,
                       arma::Mat<unsigned char>& matrix,
@@ -45,58 +45,14 @@ bool Load(const std::string& filename,
   return true;
 }
 
-// Image loading API for multiple files.
-template<typename eT>
-bool Load(const std::vector<std::string>& files,
-          arma::Mat<eT>& matrix,
-          ImageInfo& info,
-          const bool fatal)
+// Decode the given image file into a column of the given matrix, without
+// reporting errors; an error message is stored in `error` instead.  This is
+// used by LoadImage() and, in parallel, by Load() for several files.
+inline bool DecodeImage(const std::string& filename,
+                        arma::Mat<unsigned char>& matrix,
+                        ImageInfo& info,
+                        std::string& error)
 {
-  if (files.size() == 0)
-  {
-    std::ostringstream oss;
-    oss << "Load(): vector of image files is empty." << std::endl;
-
-    if (fatal)
-      Log::Fatal << oss.str();
-    else
-      Log::Warn << oss.str();
-
-    return false;
-  }
-
-  arma::Mat<unsigned char> img;
-  bool status = LoadImage(files[0], img, info, fatal);
-
-  if (!status)
-    return false;
-
-  // Decide matrix dimension using the image height and width.
-  arma::Mat<unsigned char> tmpMatrix(
-      info.Width() * info.Height() * info.Channels(), files.size());
-  tmpMatrix.col(0) = img;
-
-  for (size_t i = 1; i < files.size() ; ++i)
-  {
-    arma::Mat<unsigned char> colImg(tmpMatrix.colptr(i), tmpMatrix.n_rows, 1,
-        false, true);
-    status = LoadImage(files[i], colImg, info, fatal);
-
-    if (!status)
-      return false;
-  }
-
-  matrix = arma::conv_to<arma::Mat<eT>>::from(tmpMatrix);
-  return true;
-}
-
-inline bool LoadImage(const std::string& filename,
-                      arma::Mat<unsigned char>& matrix,
-                      ImageInfo& info,
-                      const bool fatal)
-{
-  unsigned char* image;
-
   if (!ImageFormatSupported(filename))
   {
     std::ostringstream oss;
@@ -105,22 +61,14 @@ inline bool LoadImage(const std::string& filename,
     auto x = LoadFileTypes();
     for (auto extension : x)
       oss << " " << extension;
-    oss << "." << std::endl;
-
-    if (fatal)
-    {
-      Log::Fatal << oss.str();
-    }
-    else
-    {
-      Log::Warn << oss.str();
-    }
-
+    oss << ".";
+    error = oss.str();
     return false;
   }
 
   // Temporary variables needed as stb_image.h supports int parameters.
   int tempWidth, tempHeight, tempChannels;
+  unsigned char* image;
 
   // For grayscale images.
   if (info.Channels() == 1)
@@ -136,17 +84,9 @@ inline bool LoadImage(const std::string& filename,
 
   if (!image)
   {
-    if (fatal)
-    {
-      Log::Fatal << "Load(): failed to load image '" << filename << "': "
-          << stbi_failure_reason() << std::endl;
-    }
-    else
-    {
-      Log::Warn << "Load(): failed to load image '" << filename << "': "
-          << stbi_failure_reason() << std::endl;
-    }
-
+    // The failure reason of stb_image is thread-local.
+    error = "Load(): failed to load image '" + filename + "': " +
+        stbi_failure_reason();
     return false;
   }
 
@@ -165,6 +105,160 @@ inline bool LoadImage(const std::string& filename,
   return true;
 }
 
+// Load several images, resizing them if newWidth is not 0.
+template<typename eT>
+bool LoadImages(const std::vector<std::string>& files,
+                arma::Mat<eT>& matrix,
+                ImageInfo& info,
+                const size_t newWidth,
+                const size_t newHeight,
+                const bool crop,
+                const bool fatal)
+{
+  if (files.size() == 0)
+  {
+    std::ostringstream oss;
+    oss << "Load(): vector of image files is empty." << std::endl;
+
+    if (fatal)
+      Log::Fatal << oss.str();
+    else
+      Log::Warn << oss.str();
+
+    return false;
+  }
+
+  // Each image is decoded with the requested number of channels.
+  const ImageInfo requestedInfo(info);
+  auto resize = [&](arma::Mat<unsigned char>& image, ImageInfo& imageInfo)
+  {
+    if (newWidth == 0)
+      return;
+    else if (crop)
+      ResizeCropImages(image, imageInfo, newWidth, newHeight);
+    else
+      ResizeImages(image, imageInfo, newWidth, newHeight);
+  };
+
+  // The first image gives the dimensions of the matrix.
+  arma::Mat<unsigned char> img;
+  if (!LoadImage(files[0], img, info, fatal))
+    return false;
+  resize(img, info);
+
+  matrix.set_size(img.n_elem, files.size());
+  matrix.col(0) = arma::conv_to<arma::Col<eT>>::from(img);
+
+  // Decode the other images in parallel, straight into their columns.  Errors
+  // can't be reported inside the parallel region, so the error of the first
+  // image that failed is kept.
+  size_t failedIndex = files.size();
+  std::string failure;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 1; i < files.size(); ++i)
+  {
+    arma::Mat<unsigned char> image;
+    ImageInfo imageInfo(requestedInfo);
+    std::string error;
+    if (DecodeImage(files[i], image, imageInfo, error))
+    {
+      resize(image, imageInfo);
+      if (image.n_elem != matrix.n_rows)
+      {
+        std::ostringstream oss;
+        oss << "Load(): image '" << files[i] << "' has dimensions "
+            << imageInfo.Width() << " x " << imageInfo.Height() << " x "
+            << imageInfo.Channels() << ", but image '" << files[0]
+            << "' has dimensions " << info.Width() << " x " << info.Height()
+            << " x " << info.Channels() << ".";
+        error = oss.str();
+      }
+    }
+
+    if (!error.empty())
+    {
+      #pragma omp critical
+      {
+        if (i < failedIndex)
+        {
+          failedIndex = i;
+          failure = error;
+        }
+      }
+      continue;
+    }
+
+    matrix.col(i) = arma::conv_to<arma::Col<eT>>::from(image);
+  }
+
+  if (failedIndex != files.size())
+  {
+    if (fatal)
+      Log::Fatal << failure << std::endl;
+    else
+      Log::Warn << failure << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
+// Image loading API for multiple files.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const bool fatal)
+{
+  return LoadImages(files, matrix, info, 0, 0, false, fatal);
+}
+
+// Image loading API for multiple files, with resizing.
+template<typename eT>
+bool Load(const std::vector<std::string>& files,
+          arma::Mat<eT>& matrix,
+          ImageInfo& info,
+          const size_t newWidth,
+          const size_t newHeight,
+          const bool crop,
+          const bool fatal)
+{
+  if (newWidth == 0 || newHeight == 0)
+  {
+    if (fatal)
+      Log::Fatal << "Load(): the new width and height of the images must be "
+          << "positive." << std::endl;
+    else
+      Log::Warn << "Load(): the new width and height of the images must be "
+          << "positive." << std::endl;
+
+    return false;
+  }
+
+  return LoadImages(files, matrix, info, newWidth, newHeight, crop, fatal);
+}
+
+inline bool LoadImage(const std::string& filename,
+                      arma::Mat<unsigned char>& matrix,
+                      ImageInfo& info,
+                      const bool fatal)
+{
+  std::string error;
+  if (!DecodeImage(filename, matrix, info, error))
+  {
+    if (fatal)
+      Log::Fatal << error << std::endl;
+    else
+      Log::Warn << error << std::endl;
+
+    return false;
+  }
+
+  return true;
+}
+
 } // namespace data
 } // namespace mlpack
 
@@ -84,7 +84,8 @@ bool Load(const std::string& filename,
           arma::Mat<eT>& matrix,
           const bool fatal,
           const bool transpose,
-          const FileType inputLoadType)
+          const FileType inputLoadType,
+          const bool firstTouch)
 {
   Timer::Start("loading_data");
 
@@ -149,6 +150,50 @@ bool Load(const std::string& filename,
   }
 #endif
 
+  if (loadType == FileType::ParquetBinary || loadType == FileType::ArrowBinary)
+  {
+#ifdef MLPACK_HAS_ARROW
+    Log::Info << "Loading '" << filename << "' as " << stringType << ".  "
+        << std::flush;
+    try
+    {
+      ArrowReader reader(filename, std::vector<std::string>(), loadType);
+      reader.Read(matrix, transpose);
+    }
+    catch (std::exception& e)
+    {
+      Log::Info << std::endl;
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+
+    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+    if (firstTouch)
+      FirstTouch(matrix);
+
+    Timer::Stop("loading_data");
+    return true;
+#else
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Attempted to load '" << filename << "' as " << stringType
+          << ", but mlpack was compiled without Arrow support "
+          << "(MLPACK_HAS_ARROW).  Load failed." << std::endl;
+    else
+      Log::Warn << "Attempted to load '" << filename << "' as " << stringType
+          << ", but mlpack was compiled without Arrow support "
+          << "(MLPACK_HAS_ARROW).  Load failed." << std::endl;
+
+    return false;
+#endif
+  }
+
   // Try to load the file; but if it's raw_binary, it could be a problem.
   if (loadType == FileType::RawBinary)
     Log::Warn << "Loading '" << filename << "' as " << stringType << "; "
@@ -159,18 +204,47 @@ bool Load(const std::string& filename,
 
   // We can't use the stream if the type is HDF5.
   bool success;
+  bool transposed = false;
   LoadCSV loader;
 
   if (loadType != FileType::HDF5Binary)
   {
     if (loadType == FileType::CSVASCII)
-      success = loader.LoadNumericCSV(matrix, stream);
+    {
+      // If the file can be mapped into memory, it is parsed in parallel, and
+      // straight into the transposed matrix if needed.
+      std::unique_ptr<MappedFile> file;
+      try
+      {
+        file.reset(new MappedFile(filename));
+      }
+      catch (std::runtime_error& /* e */)
+      {
+        // Fall back to the stream.
+      }
+
+      if (file)
+      {
+        success = loader.LoadNumericCSV(matrix, file->Data(), file->Size(),
+            transpose);
+        transposed = transpose;
+      }
+      else
+      {
+        success = loader.LoadNumericCSV(matrix, stream);
+      }
+    }
     else
+    {
       success = matrix.load(stream, ToArmaFileType(loadType));
+    }
   }
   else
     success = matrix.load(filename, ToArmaFileType(loadType));
 
+  // The matrix still has to be transposed if the CSV parser did not do it.
+  const bool needTranspose = transpose && !transposed;
+
   if (!success)
   {
     Log::Info << std::endl;
@@ -183,15 +257,18 @@ bool Load(const std::string& filename,
     return false;
   }
   else
-    Log::Info << "Size is " << (transpose ? matrix.n_cols : matrix.n_rows)
-        << " x " << (transpose ? matrix.n_rows : matrix.n_cols) << ".\n";
+    Log::Info << "Size is " << (needTranspose ? matrix.n_cols : matrix.n_rows)
+        << " x " << (needTranspose ? matrix.n_rows : matrix.n_cols) << ".\n";
 
   // Now transpose the matrix, if necessary.
-  if (transpose)
+  if (needTranspose)
   {
     success = inplace_transpose(matrix, fatal);
   }
 
+  if (success && firstTouch)
+    FirstTouch(matrix);
+
   Timer::Stop("loading_data");
 
   // Finally, return the success indicator.
@@ -234,7 +311,31 @@ bool Load(const std::string& filename,
     try
     {
       LoadCSV loader(filename);
-      loader.LoadCategoricalCSV(matrix, info, transpose);
+
+      // Files are loaded in parallel from a memory mapping with
+      // IncrementPolicy, which gives the same mappings as the serial loader.
+      std::unique_ptr<MappedFile> file;
+      if constexpr (std::is_same_v<PolicyType, IncrementPolicy>)
+      {
+        try
+        {
+          file.reset(new MappedFile(filename));
+        }
+        catch (std::runtime_error& /* e */)
+        {
+          // Fall back to the stream.
+        }
+      }
+
+      if (file)
+      {
+        loader.LoadCategoricalCSV(matrix, info, file->Data(), file->Size(),
+            transpose);
+      }
+      else
+      {
+        loader.LoadCategoricalCSV(matrix, info, transpose);
+      }
     }
     catch (std::exception& e)
     {
@@ -272,6 +373,42 @@ bool Load(const std::string& filename,
       return false;
     }
   }
+  else if (extension == "parquet" || extension == "arrow" ||
+           extension == "feather")
+  {
+#ifdef MLPACK_HAS_ARROW
+    Log::Info << "Loading '" << filename << "' as "
+        << (extension == "parquet" ? "Parquet" : "Arrow IPC") << " dataset.  "
+        << std::flush;
+    try
+    {
+      ArrowReader reader(filename);
+      reader.Read(matrix, info, transpose);
+    }
+    catch (std::exception& e)
+    {
+      Timer::Stop("loading_data");
+      if (fatal)
+        Log::Fatal << e.what() << std::endl;
+      else
+        Log::Warn << e.what() << std::endl;
+
+      return false;
+    }
+#else
+    Timer::Stop("loading_data");
+    if (fatal)
+      Log::Fatal << "Attempted to load '" << filename << "', but mlpack was "
+          << "compiled without Arrow support (MLPACK_HAS_ARROW).  Load failed."
+          << std::endl;
+    else
+      Log::Warn << "Attempted to load '" << filename << "', but mlpack was "
+          << "compiled without Arrow support (MLPACK_HAS_ARROW).  Load failed."
+          << std::endl;
+
+    return false;
+#endif
+  }
   else
   {
     // The type is unknown.
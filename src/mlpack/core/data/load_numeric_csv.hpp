@@ -120,6 +120,78 @@ bool LoadCSV::ConvertToken(eT& val,
   return true;
 }
 
+template<typename eT>
+bool LoadCSV::ConvertToken(eT& val, const char* begin, const char* end)
+{
+  // Empty tokens and the special values (+/-INF and NAN) are handled like in
+  // the std::string version.
+  const size_t n = size_t(end - begin);
+  if (n == 0)
+  {
+    val = eT(0);
+    return true;
+  }
+  else if (n == 3 || n == 4)
+  {
+    const size_t offset = (n == 4 && (*begin == '-' || *begin == '+')) ? 1 : 0;
+    const char c = begin[offset];
+    if (c == 'i' || c == 'I' || c == 'n' || c == 'N')
+      return ConvertToken(val, std::string(begin, end));
+  }
+
+  // Like strtod() and strtoll(), skip leading whitespace and a '+' sign, and
+  // ignore anything after the number.
+  const char* first = begin;
+  while (first != end && std::isspace((unsigned char) *first))
+    ++first;
+  if (first != end && *first == '+' && first + 1 != end && *(first + 1) != '-')
+    ++first;
+
+  if constexpr (std::is_integral_v<eT>)
+  {
+    std::from_chars_result result;
+    if constexpr (std::is_signed_v<eT>)
+    {
+      long long tmp = 0;
+      result = std::from_chars(first, end, tmp, 10);
+      val = eT(tmp);
+    }
+    else
+    {
+      // Negative numbers are converted to 0.
+      if (*begin == '-')
+      {
+        val = eT(0);
+        return true;
+      }
+
+      unsigned long long tmp = 0;
+      result = std::from_chars(first, end, tmp, 10);
+      val = eT(tmp);
+    }
+
+    if (result.ec == std::errc())
+      return true;
+  }
+#if defined(__cpp_lib_to_chars)
+  else if constexpr (std::is_floating_point_v<eT>)
+  {
+    // Convert to double first, like strtod() does.
+    double tmp = 0.0;
+    const std::from_chars_result result = std::from_chars(first, end, tmp);
+    if (result.ec == std::errc())
+    {
+      val = eT(tmp);
+      return true;
+    }
+  }
+#endif
+
+  // Anything else (values out of range, or no support for floating-point
+  // std::from_chars()) goes through the std::string version.
+  return ConvertToken(val, std::string(begin, end));
+}
+
 template<typename eT>
 bool LoadCSV::LoadNumericCSV(arma::Mat<eT>& x, std::fstream& f)
 {
@@ -174,6 +246,152 @@ bool LoadCSV::LoadNumericCSV(arma::Mat<eT>& x, std::fstream& f)
   return loadOkay;
 }
 
+template<typename eT>
+bool LoadCSV::LoadNumericCSV(arma::Mat<eT>& x,
+                             const char* data,
+                             const size_t size,
+                             const bool transpose)
+{
+  const size_t numBlocks = (size + ParseBlockSize - 1) / ParseBlockSize;
+
+  // The lines of each block are the lines that start in it.  As with
+  // std::getline(), the file ends at the first empty line.
+  std::vector<size_t> blockLines(numBlocks, 0), blockCols(numBlocks, 0);
+  std::vector<char> blockEnds(numBlocks, 0);
+
+  // Find the start of the first line that starts at or after the given
+  // position.
+  auto lineStart = [&](const size_t pos)
+  {
+    if (pos == 0 || data[pos - 1] == '\n')
+      return pos;
+
+    const char* next = static_cast<const char*>(std::memchr(data + pos, '\n',
+        size - pos));
+    return (next == NULL) ? size : size_t(next - data) + 1;
+  };
+
+  // Find the end of the line that starts at the given position.
+  auto lineEnd = [&](const size_t pos)
+  {
+    const char* next = static_cast<const char*>(std::memchr(data + pos, '\n',
+        size - pos));
+    return (next == NULL) ? size : size_t(next - data);
+  };
+
+  // In the first pass, count the lines and columns of each block.
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t blockEnd = std::min(size, (b + 1) * ParseBlockSize);
+    size_t pos = lineStart(b * ParseBlockSize);
+    while (pos < blockEnd)
+    {
+      if (data[pos] == '\n')
+      {
+        blockEnds[b] = 1;
+        break;
+      }
+
+      const size_t end = lineEnd(pos);
+      const size_t cols = 1 + std::count(data + pos, data + end, ',');
+      blockCols[b] = std::max(blockCols[b], cols);
+      ++blockLines[b];
+      pos = end + 1;
+    }
+  }
+
+  // Find the row of the first line of each block, and the size of the matrix.
+  // If the number of columns differs between rows, the highest number is used,
+  // and missing elements are filled with 0.
+  std::vector<size_t> blockRows(numBlocks, 0);
+  size_t rows = 0, cols = 0, usedBlocks = numBlocks;
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    blockRows[b] = rows;
+    rows += blockLines[b];
+    cols = std::max(cols, blockCols[b]);
+    if (blockEnds[b])
+    {
+      usedBlocks = b + 1;
+      break;
+    }
+  }
+
+  if (transpose)
+    x.set_size(cols, rows);
+  else
+    x.set_size(rows, cols);
+
+  // In the second pass, convert the values.  The first failure of each block
+  // is kept, so the first one in the file can be reported.
+  std::vector<size_t> failedRows(usedBlocks, rows), failedCols(usedBlocks, 0);
+  std::vector<std::string> failedTokens(usedBlocks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < usedBlocks; ++b)
+  {
+    size_t pos = lineStart(b * ParseBlockSize);
+    for (size_t row = blockRows[b]; row < blockRows[b] + blockLines[b]; ++row)
+    {
+      const size_t end = lineEnd(pos);
+      const char* token = data + pos;
+      size_t col = 0;
+      while (true)
+      {
+        const char* tokenEnd = std::find(token, data + end, ',');
+        eT tmpVal = eT(0);
+        if (!ConvertToken<eT>(tmpVal, token, tokenEnd))
+        {
+          failedRows[b] = row;
+          failedCols[b] = col;
+          failedTokens[b] = std::string(token, tokenEnd);
+          break;
+        }
+
+        if (transpose)
+          x.at(col, row) = tmpVal;
+        else
+          x.at(row, col) = tmpVal;
+        ++col;
+
+        if (tokenEnd == data + end)
+          break;
+        token = tokenEnd + 1;
+      }
+
+      if (failedRows[b] != rows)
+        break;
+
+      // Fill the missing elements of short lines with 0.
+      for (; col < cols; ++col)
+      {
+        if (transpose)
+          x.at(col, row) = eT(0);
+        else
+          x.at(row, col) = eT(0);
+      }
+
+      pos = end + 1;
+    }
+  }
+
+  for (size_t b = 0; b < usedBlocks; ++b)
+  {
+    if (failedRows[b] != rows)
+    {
+      // Printing failed token and it's location.
+      Log::Warn << "Failed to convert token " << failedTokens[b] << ", at row "
+          << failedRows[b] << ", column " << failedCols[b] << " of matrix!"
+          << std::endl;
+
+      return false;
+    }
+  }
+
+  return true;
+}
+
 inline void LoadCSV::NumericMatSize(std::stringstream& lineStream,
                                     size_t& col,
                                     const char delim)
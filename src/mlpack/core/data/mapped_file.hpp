@@ -0,0 +1,176 @@
+/**
+ * @file core/data/mapped_file.hpp
+ *
+ * A read-only memory mapping of a file, used to load large matrices without
+ * copying them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_FILE_HPP
+#define MLPACK_CORE_DATA_MAPPED_FILE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+namespace mlpack {
+namespace data {
+
+/**
+ * MappedFile maps an entire file into memory, so that its contents can be used
+ * directly (for instance as the memory of an Armadillo matrix) without reading
+ * the file.  The mapping is private: pages are shared with every other process
+ * that maps the same file until they are written to, and changes are never
+ * written back to the file.  The file is unmapped when the object is destroyed.
+ */
+class MappedFile
+{
+ public:
+  /**
+   * Map the given file into memory.  If the file cannot be opened or mapped, a
+   * std::runtime_error is thrown.
+   *
+   * By default, the pages of the file are only read when they are first
+   * accessed.  If populate is true, the whole file is read into the page cache
+   * while it is mapped (with MAP_POPULATE, where available), so that later
+   * accesses do not fault.  If hugePages is true, the kernel is advised to
+   * back the mapping with huge pages (MADV_HUGEPAGE, where available), which
+   * reduces TLB misses for random access to large files.  Both options are
+   * only hints, and are ignored on Windows.
+   *
+   * @param filename Name of the file to map.
+   * @param populate Whether to read the whole file while it is mapped.
+   * @param hugePages Whether to advise the use of huge pages.
+   */
+  MappedFile(const std::string& filename,
+             const bool populate = false,
+             const bool hugePages = false) :
+      data(NULL),
+      size(0)
+  {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      throw std::runtime_error("cannot open file '" + filename + "'");
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize))
+    {
+      CloseHandle(file);
+      throw std::runtime_error("cannot get size of file '" + filename + "'");
+    }
+
+    size = (size_t) fileSize.QuadPart;
+    if (size > 0)
+    {
+      HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0,
+          NULL);
+      CloseHandle(file);
+      if (mapping == NULL)
+        throw std::runtime_error("cannot map file '" + filename + "'");
+
+      data = (char*) MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+      CloseHandle(mapping);
+      if (data == NULL)
+        throw std::runtime_error("cannot map file '" + filename + "'");
+    }
+    else
+    {
+      CloseHandle(file);
+    }
+    (void) populate;
+    (void) hugePages;
+#else
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error("cannot open file '" + filename + "'");
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0)
+    {
+      close(fd);
+      throw std::runtime_error("cannot get size of file '" + filename + "'");
+    }
+
+    size = (size_t) fileStat.st_size;
+    if (size > 0)
+    {
+      int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+      if (populate)
+        flags |= MAP_POPULATE;
+#endif
+
+      void* result = mmap(NULL, size, PROT_READ | PROT_WRITE, flags, fd, 0);
+      close(fd);
+      if (result == MAP_FAILED)
+        throw std::runtime_error("cannot map file '" + filename + "'");
+
+      data = (char*) result;
+
+#ifndef MAP_POPULATE
+      // Without MAP_POPULATE, ask for the file to be read ahead instead.
+      if (populate)
+        madvise(data, size, MADV_WILLNEED);
+#endif
+#ifdef MADV_HUGEPAGE
+      if (hugePages)
+        madvise(data, size, MADV_HUGEPAGE);
+#else
+      (void) hugePages;
+#endif
+    }
+    else
+    {
+      close(fd);
+    }
+#endif
+  }
+
+  // A mapping cannot be copied.
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile& operator=(const MappedFile& other) = delete;
+
+  //! Unmap the file.
+  ~MappedFile()
+  {
+    if (data == NULL)
+      return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(data, size);
+#endif
+  }
+
+  //! Get the mapped contents of the file.
+  char* Data() const { return data; }
+  //! Get the size of the file in bytes.
+  size_t Size() const { return size; }
+
+ private:
+  //! The mapped contents of the file.
+  char* data;
+  //! The size of the file in bytes.
+  size_t size;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file core/data/mapped_matrix.hpp
+ *
+ * Load matrices stored in Armadillo's binary format or as raw binary data by
+ * memory mapping the file, so that the matrix uses the mapped memory and is
+ * never read or copied.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/log.hpp>
+#include <string>
+
+#include "detect_file_type.hpp"
+#include "mapped_model.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Save a matrix in Armadillo's binary format, with the header padded so that
+ * the elements start at a page boundary.  The file can be loaded with
+ * data::Load() (or Armadillo's `load()`) as any other Armadillo binary file,
+ * and with LoadMapped() without any copy.  Unlike data::Save(), the matrix is
+ * saved as it is, without being transposed.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a save failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ *
+ * @param filename Name of the file to save to.
+ * @param matrix Matrix to save.
+ * @param fatal If an error should be reported as fatal (default false).
+ */
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal = false);
+
+/**
+ * Load a matrix from a file in Armadillo's binary format (FileType::ArmaBinary)
+ * or from raw binary data (FileType::RawBinary) by mapping the file into
+ * memory.  The loaded matrix uses the mapped memory directly (it is strictly
+ * bound to it, so it cannot be resized), and so loading takes constant time, no
+ * matter the size of the matrix; pages are only read from disk when they are
+ * first accessed.  Processes that map the same file share one copy of it
+ * through the page cache.  The mapping is private: changes to the matrix affect
+ * neither the file nor other processes.
+ *
+ * The given `mapping` holds the mapped file, and must be kept alive for as long
+ * as the matrix is used; the matrix must be a matrix that is not already bound
+ * to a mapping.  Copies of the matrix (including matrices that it is moved
+ * into) hold their own memory.
+ *
+ * The elements of an Armadillo binary file must have the type `eT`.  A raw
+ * binary file is loaded as a single column.  Matrices are not transposed, so,
+ * unlike with data::Load(), each column of a file that was saved with
+ * data::Save() is a dimension of the loaded matrix; files that are meant to be
+ * mapped are best saved with SaveMapped(), which also aligns the elements to a
+ * page boundary.  If the elements in the file are not aligned for `eT`, they
+ * are copied into the matrix instead, and a warning is printed.
+ *
+ * If `populate` is true, the whole file is read while it is mapped, so that
+ * later accesses do not fault; if `hugePages` is true, the kernel is advised to
+ * back the mapping with huge pages.  Both are only hints; see MappedFile.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a load failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ *
+ * @code
+ * arma::mat dataset;
+ * std::shared_ptr<data::MappedFile> mapping;
+ * data::LoadMapped("dataset.bin", dataset, mapping, true);
+ * // Only the pages of the first ten columns are read from disk.
+ * const arma::vec means = arma::mean(dataset.cols(0, 9), 1);
+ * @endcode
+ *
+ * @param filename Name of the file to load.
+ * @param matrix Matrix to load into.
+ * @param mapping Set to the mapping that holds the elements of the matrix.
+ * @param fatal If an error should be reported as fatal (default false).
+ * @param populate Whether to read the whole file while it is mapped.
+ * @param hugePages Whether to advise the use of huge pages.
+ * @param inputLoadType Type of the file (ArmaBinary, RawBinary or AutoDetect).
+ */
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                std::shared_ptr<MappedFile>& mapping,
+                const bool fatal = false,
+                const bool populate = false,
+                const bool hugePages = false,
+                const FileType inputLoadType = FileType::AutoDetect);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_matrix_impl.hpp"
+
+#endif
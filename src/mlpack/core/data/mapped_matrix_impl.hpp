@@ -0,0 +1,169 @@
+/**
+ * @file core/data/mapped_matrix_impl.hpp
+ *
+ * Implementation of SaveMapped() and LoadMapped() for matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MATRIX_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "mapped_matrix.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+
+//! Get the header that Armadillo gives binary files of matrices with elements
+//! of type eT.
+template<typename eT>
+inline std::string ArmaBinaryHeader()
+{
+  static_assert(std::is_arithmetic_v<eT>, "Only matrices of integral or "
+      "floating-point elements can be mapped.");
+
+  if constexpr (std::is_floating_point_v<eT>)
+    return "ARMA_MAT_BIN_FN00" + std::to_string(sizeof(eT));
+  else if constexpr (std::is_signed_v<eT>)
+    return "ARMA_MAT_BIN_IS00" + std::to_string(sizeof(eT));
+  else
+    return "ARMA_MAT_BIN_IU00" + std::to_string(sizeof(eT));
+}
+
+template<typename eT>
+bool SaveMapped(const std::string& filename,
+                const arma::Mat<eT>& matrix,
+                const bool fatal)
+{
+  // Armadillo reads the header, the number of rows and the number of columns
+  // separated by any whitespace, and then skips one character; so padding
+  // before the sizes puts the elements at a page boundary.
+  const std::string type = ArmaBinaryHeader<eT>() + "\n";
+  const std::string sizes = std::to_string(matrix.n_rows) + " " +
+      std::to_string(matrix.n_cols) + "\n";
+  const std::string header = type + std::string(mappedModelAlignment -
+      type.size() - sizes.size(), ' ') + sizes;
+
+  std::ofstream stream(filename, std::ios::binary);
+  if (!stream.is_open())
+  {
+    return MappedModelError("Unable to open file '" + filename + "' to save "
+        "the matrix.", fatal);
+  }
+
+  stream.write(header.data(), header.size());
+  stream.write((const char*) matrix.memptr(), matrix.n_elem * sizeof(eT));
+  if (!stream.good())
+  {
+    return MappedModelError("Error writing to file '" + filename + "' while "
+        "saving the matrix.", fatal);
+  }
+
+  return true;
+}
+
+template<typename eT>
+bool LoadMapped(const std::string& filename,
+                arma::Mat<eT>& matrix,
+                std::shared_ptr<MappedFile>& mapping,
+                const bool fatal,
+                const bool populate,
+                const bool hugePages,
+                const FileType inputLoadType)
+{
+  FileType loadType = inputLoadType;
+  if (loadType == FileType::AutoDetect)
+  {
+    std::fstream stream(filename, std::fstream::in | std::fstream::binary);
+    if (!stream.is_open())
+      return MappedModelError("Cannot open file '" + filename + "'.", fatal);
+
+    loadType = AutoDetect(stream, filename);
+  }
+
+  if (loadType != FileType::ArmaBinary && loadType != FileType::RawBinary)
+  {
+    return MappedModelError("Unable to map '" + filename + "': only "
+        "Armadillo binary and raw binary files can be mapped.", fatal);
+  }
+  else if (matrix.mem_state == 2)
+  {
+    return MappedModelError("Unable to map '" + filename + "': the matrix is "
+        "already bound to other memory.", fatal);
+  }
+
+  std::shared_ptr<MappedFile> file;
+  try
+  {
+    file = std::make_shared<MappedFile>(filename, populate, hugePages);
+  }
+  catch (std::runtime_error& e)
+  {
+    return MappedModelError(std::string("Unable to map '") + filename +
+        "': " + e.what() + ".", fatal);
+  }
+
+  size_t offset = 0, rows = 0, cols = 0;
+  if (loadType == FileType::ArmaBinary)
+  {
+    // Parse the header in place; it is followed by one separating character.
+    MappedModelBuffer buffer(file->Data(), file->Size());
+    std::istream headerStream(&buffer);
+    std::string header;
+    headerStream >> header >> rows >> cols;
+    headerStream.get();
+    if (!headerStream.good() || header.compare(0, 12, "ARMA_MAT_BIN") != 0)
+    {
+      return MappedModelError("File '" + filename + "' is not an Armadillo "
+          "binary file.", fatal);
+    }
+    else if (header != ArmaBinaryHeader<eT>())
+    {
+      return MappedModelError("The element type of the matrix in '" +
+          filename + "' does not match the element type of the matrix to "
+          "load into.", fatal);
+    }
+
+    offset = buffer.Position();
+    if (cols != 0 && rows > (file->Size() - offset) / sizeof(eT) / cols)
+    {
+      return MappedModelError("File '" + filename + "' is truncated.",
+          fatal);
+    }
+  }
+  else
+  {
+    rows = file->Size() / sizeof(eT);
+    cols = 1;
+  }
+
+  eT* elements = (eT*) (file->Data() + offset);
+  if (((uintptr_t) elements) % alignof(eT) != 0)
+  {
+    Log::Warn << "LoadMapped(): the elements in '" << filename << "' are not "
+        << "aligned, so they are copied; save the matrix with "
+        << "data::SaveMapped() to avoid that." << std::endl;
+    matrix.set_size(rows, cols);
+    std::memcpy(matrix.memptr(), elements, rows * cols * sizeof(eT));
+    mapping.reset();
+    return true;
+  }
+
+  // Moving from a temporary that is strictly bound to the mapped memory hands
+  // the binding over to the matrix.
+  matrix = arma::Mat<eT>(elements, rows, cols, false, true);
+  mapping = file;
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
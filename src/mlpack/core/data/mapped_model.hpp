@@ -0,0 +1,108 @@
+/**
+ * @file core/data/mapped_model.hpp
+ *
+ * Save and load models that hold a large reference set (such as NSModel,
+ * RSModel and KDEModel) in a format where the reference set can be memory
+ * mapped instead of being deserialized.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MODEL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MODEL_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/log.hpp>
+#include <string>
+
+#include "mapped_file.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The header at the start of a mapped model file.  It is followed by the
+ * reference set (at `dataOffset`, stored column-major) and then by the rest of
+ * the model, serialized with cereal's binary archive (at `modelOffset`).  All
+ * values are stored in the byte order of the machine that saved the file.
+ */
+struct MappedModelHeader
+{
+  //! Identifies the file as a mapped model; always "MLPKMMAP".
+  char magic[8];
+  //! The version of the file format.
+  uint64_t version;
+  //! The size of each element of the reference set, in bytes.
+  uint64_t elemSize;
+  //! The number of rows of the reference set.
+  uint64_t nRows;
+  //! The number of columns of the reference set.
+  uint64_t nCols;
+  //! The offset of the reference set in the file.
+  uint64_t dataOffset;
+  //! The offset of the serialized model in the file.
+  uint64_t modelOffset;
+  //! The size of the serialized model, in bytes.
+  uint64_t modelSize;
+};
+
+/**
+ * Save a trained model so that it can be loaded with LoadMapped().  The
+ * reference set of the model (which is already permuted if the model holds a
+ * tree that rearranges its dataset) is written as raw memory, aligned to a page
+ * boundary; the rest of the model, including the tree structure, is serialized
+ * as usual.
+ *
+ * `ModelType` must provide `Dataset()`, which returns the reference set held by
+ * the model, and `Mapping()`, which returns a modifiable
+ * `std::shared_ptr<MappedFile>` that holds the mapping the reference set lives
+ * in (see LoadMapped()).  NSModel, RSModel and KDEModel satisfy these
+ * requirements.
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a save failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ *
+ * @param filename Name of the file to save to.
+ * @param name Name of the model in the file.
+ * @param model Model to save.
+ * @param fatal If an error should be reported as fatal (default false).
+ */
+template<typename ModelType>
+bool SaveMapped(const std::string& filename,
+                const std::string& name,
+                ModelType& model,
+                const bool fatal = false);
+
+/**
+ * Load a model saved with SaveMapped().  The file is mapped into memory, and
+ * the reference set of the loaded model uses the mapped memory directly, so it
+ * is never read or copied; only the (much smaller) rest of the model is
+ * deserialized.  Processes that load the same file share the memory of the
+ * reference set through the page cache.  The model keeps the mapping alive
+ * until it is destroyed or another file is loaded into it with LoadMapped().
+ *
+ * If the parameter 'fatal' is set to true, then an exception will be thrown in
+ * the event of a load failure.  Otherwise, the method will return false and the
+ * relevant error information will be printed to Log::Warn.
+ *
+ * @param filename Name of the file to load.
+ * @param name Name of the model in the file.
+ * @param model Model to load into.
+ * @param fatal If an error should be reported as fatal (default false).
+ */
+template<typename ModelType>
+bool LoadMapped(const std::string& filename,
+                const std::string& name,
+                ModelType& model,
+                const bool fatal = false);
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "mapped_model_impl.hpp"
+
+#endif
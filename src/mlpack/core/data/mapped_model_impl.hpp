@@ -0,0 +1,200 @@
+/**
+ * @file core/data/mapped_model_impl.hpp
+ *
+ * Implementation of SaveMapped() and LoadMapped().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MAPPED_MODEL_IMPL_HPP
+#define MLPACK_CORE_DATA_MAPPED_MODEL_IMPL_HPP
+
+// In case it hasn't already been included.
+#include "mapped_model.hpp"
+
+#include <cstring>
+#include <sstream>
+
+namespace mlpack {
+namespace data {
+
+//! The reference set starts at a multiple of this many bytes in the file, so
+//! that it is aligned to a page once the file is mapped.
+static const uint64_t mappedModelAlignment = 4096;
+
+//! A read-only stream buffer over a block of memory, so that cereal can read
+//! from the mapped file directly.
+class MappedModelBuffer : public std::streambuf
+{
+ public:
+  MappedModelBuffer(char* begin, const size_t size)
+  {
+    setg(begin, begin, begin + size);
+  }
+
+  //! Get the number of bytes that were read.
+  size_t Position() const { return gptr() - eback(); }
+};
+
+//! Report an error during SaveMapped() or LoadMapped().
+inline bool MappedModelError(const std::string& message, const bool fatal)
+{
+  if (fatal)
+    Log::Fatal << message << std::endl;
+  else
+    Log::Warn << message << std::endl;
+
+  return false;
+}
+
+template<typename ModelType>
+bool SaveMapped(const std::string& filename,
+                const std::string& name,
+                ModelType& model,
+                const bool fatal)
+{
+  using MatType = std::remove_cv_t<std::remove_reference_t<
+      decltype(model.Dataset())>>;
+  using ElemType = typename MatType::elem_type;
+
+  // Take the reference set out of the model while the rest of the model is
+  // serialized, so that it is not serialized with the model.  The model owns
+  // its reference set, so it is safe to modify it.
+  MatType& dataset = const_cast<MatType&>(model.Dataset());
+  MatType referenceSet(std::move(dataset));
+  dataset.reset();
+
+  std::ostringstream modelStream(std::ios::out | std::ios::binary);
+  std::string error;
+  try
+  {
+    cereal::BinaryOutputArchive ar(modelStream);
+    ar(cereal::make_nvp(name.c_str(), model));
+  }
+  catch (cereal::Exception& e)
+  {
+    error = e.what();
+  }
+
+  dataset = std::move(referenceSet);
+  if (!error.empty())
+    return MappedModelError(error, fatal);
+
+  const std::string modelString = modelStream.str();
+
+  MappedModelHeader header;
+  std::memcpy(header.magic, "MLPKMMAP", 8);
+  header.version = 1;
+  header.elemSize = sizeof(ElemType);
+  header.nRows = dataset.n_rows;
+  header.nCols = dataset.n_cols;
+  header.dataOffset = mappedModelAlignment;
+  header.modelOffset = header.dataOffset + dataset.n_elem * sizeof(ElemType);
+  header.modelSize = modelString.size();
+
+  std::ofstream ofs(filename, std::ofstream::out | std::ofstream::binary);
+  if (!ofs.is_open())
+  {
+    return MappedModelError("Unable to open file '" + filename + "' to save "
+        "object '" + name + "'.", fatal);
+  }
+
+  const std::vector<char> padding(header.dataOffset - sizeof(header), 0);
+  ofs.write((const char*) &header, sizeof(header));
+  ofs.write(padding.data(), padding.size());
+  ofs.write((const char*) dataset.memptr(), dataset.n_elem * sizeof(ElemType));
+  ofs.write(modelString.data(), modelString.size());
+  if (!ofs.good())
+  {
+    return MappedModelError("Error writing to file '" + filename + "' while "
+        "saving object '" + name + "'.", fatal);
+  }
+
+  return true;
+}
+
+template<typename ModelType>
+bool LoadMapped(const std::string& filename,
+                const std::string& name,
+                ModelType& model,
+                const bool fatal)
+{
+  using MatType = std::remove_cv_t<std::remove_reference_t<
+      decltype(model.Dataset())>>;
+  using ElemType = typename MatType::elem_type;
+
+  std::shared_ptr<MappedFile> file;
+  try
+  {
+    file = std::make_shared<MappedFile>(filename);
+  }
+  catch (std::runtime_error& e)
+  {
+    return MappedModelError("Unable to load object '" + name + "': " +
+        e.what() + ".", fatal);
+  }
+
+  // Check that the file is a valid mapped model with the right element type.
+  MappedModelHeader header;
+  if (file->Size() < sizeof(header))
+  {
+    return MappedModelError("File '" + filename + "' is not a mapped model.",
+        fatal);
+  }
+
+  std::memcpy(&header, file->Data(), sizeof(header));
+  const uint64_t dataSize = header.nRows * header.nCols * header.elemSize;
+  if (std::memcmp(header.magic, "MLPKMMAP", 8) != 0)
+  {
+    return MappedModelError("File '" + filename + "' is not a mapped model.",
+        fatal);
+  }
+  else if (header.version != 1)
+  {
+    return MappedModelError("File '" + filename + "' has an unknown mapped "
+        "model version.", fatal);
+  }
+  else if (header.elemSize != sizeof(ElemType))
+  {
+    return MappedModelError("The element type of the reference set in '" +
+        filename + "' does not match the element type of the model.", fatal);
+  }
+  else if (header.dataOffset % mappedModelAlignment != 0 ||
+           header.dataOffset + dataSize > header.modelOffset ||
+           header.modelOffset + header.modelSize > file->Size())
+  {
+    return MappedModelError("File '" + filename + "' is truncated or "
+        "corrupted.", fatal);
+  }
+
+  // Deserialize everything but the reference set.
+  try
+  {
+    MappedModelBuffer buffer(file->Data() + header.modelOffset,
+        header.modelSize);
+    std::istream modelStream(&buffer);
+    cereal::BinaryInputArchive ar(modelStream);
+    ar(cereal::make_nvp(name.c_str(), model));
+  }
+  catch (cereal::Exception& e)
+  {
+    return MappedModelError(e.what(), fatal);
+  }
+
+  // Now point the (empty) reference set of the model at the mapped memory.  A
+  // matrix that uses auxiliary memory without being strictly bound to it gives
+  // the memory to the matrix it is moved into.
+  MatType& dataset = const_cast<MatType&>(model.Dataset());
+  dataset = MatType((ElemType*) (file->Data() + header.dataOffset),
+      header.nRows, header.nCols, false, false);
+  model.Mapping() = file;
+
+  return true;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,237 @@
+/**
+ * @file core/data/matrix_reader.hpp
+ *
+ * Definition of MatrixReader, which reads a dataset from a file one block of
+ * points at a time, so that models can be trained on datasets that do not fit
+ * in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MATRIX_READER_HPP
+#define MLPACK_CORE_DATA_MATRIX_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "extension.hpp"
+#include "load_arff.hpp"
+#include "load_csv.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * MatrixReader reads a dataset from a file in blocks of at most a given number
+ * of points, instead of loading the whole file into memory as data::Load()
+ * does.  Each point is a column of the returned blocks, as with data::Load()
+ * (with `transpose = true`).  Methods with incremental or batch training, such
+ * as NaiveBayesClassifier, HoeffdingTree, or StreamingKMeans, can then be
+ * trained one block at a time.
+ *
+ * The format is chosen from the extension of the file:
+ *
+ *  - `.csv`, `.tsv` and `.txt`: comma-, tab- and whitespace-separated text,
+ *    one point per line.  Blank lines are skipped, and a token that starts
+ *    with a double quote extends to the next token that ends with one.
+ *  - `.arff`: ARFF (dense data only); lines starting with `%` are skipped.
+ *  - `.bin`: Armadillo's binary format, with any element type.
+ *  - `.h5`, `.hdf5`, `.hdf` and `.he5`: HDF5, as saved by Armadillo (the
+ *    matrix is the dataset called `dataset`); only if Armadillo was compiled
+ *    with HDF5 support.
+ *
+ * For the binary formats, `transpose` has the same meaning as for
+ * data::Load(): if true (the default), each row of the stored matrix is a
+ * point, as for matrices saved by data::Save(); if false, each column is a
+ * point, which is faster to read.  Text and ARFF files can only be read with
+ * `transpose = true`.
+ *
+ * Categorical data is read with a DatasetInfo, which must be the same object
+ * for every block, so that the values of each block are mapped consistently.
+ * On the first block, the DatasetInfo is set up from the header of an ARFF
+ * file, or, for a text file, with a separate first pass over the whole file
+ * (which holds only one line in memory at a time) to find the types of the
+ * dimensions, just as data::Load() does.  A pre-existing DatasetInfo (for
+ * instance from the training set) may be given, and must have the
+ * dimensionality of the file.
+ *
+ * @code
+ * // The last dimension of each point holds its label.
+ * data::MatrixReader reader("huge_dataset.csv", 100000);
+ * NaiveBayesClassifier<> nbc(reader.Dimensionality() - 1, 3);
+ * arma::mat block;
+ * while (reader.Next(block))
+ * {
+ *   const arma::Row<size_t> labels =
+ *       arma::conv_to<arma::Row<size_t>>::from(block.row(block.n_rows - 1));
+ *   block.shed_row(block.n_rows - 1);
+ *   nbc.Train(block, labels, 3, true);
+ * }
+ * @endcode
+ *
+ * std::runtime_error is thrown if the file cannot be opened or parsed, and
+ * std::invalid_argument if a given DatasetInfo has the wrong dimensionality.
+ */
+class MatrixReader
+{
+ public:
+  /**
+   * Open the given file for reading, and read its header, if it has one (or
+   * the first line of a text file, to find the dimensionality).
+   *
+   * @param filename Name of the file to read.
+   * @param blockSize Maximum number of points in each block.
+   * @param transpose If true, each row of a stored binary matrix is a point.
+   */
+  MatrixReader(const std::string& filename,
+               const size_t blockSize,
+               const bool transpose = true);
+
+  //! Close the file.
+  ~MatrixReader();
+
+  //! The reader holds an open file, so it cannot be copied.
+  MatrixReader(const MatrixReader&) = delete;
+  //! The reader holds an open file, so it cannot be copied.
+  MatrixReader& operator=(const MatrixReader&) = delete;
+
+  /**
+   * Read the next block of numeric points.  The block has Dimensionality()
+   * rows and at most BlockSize() columns.  An ARFF file with categorical
+   * dimensions must be read with a DatasetInfo instead.
+   *
+   * @param block Matrix to store the block into.
+   * @return false if all points were read; the block is then empty.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& block);
+
+  /**
+   * Read the next block of points, mapping categorical values with the given
+   * DatasetInfo, which must be the same object for every block.
+   *
+   * @param block Matrix to store the block into.
+   * @param info DatasetInfo to map categorical values with.
+   * @return false if all points were read; the block is then empty.
+   */
+  template<typename eT, typename PolicyType>
+  bool Next(arma::Mat<eT>& block, DatasetMapper<PolicyType>& info);
+
+  /**
+   * Go back to the first point, for another pass over the dataset.  The
+   * mappings of the DatasetInfo are kept.
+   */
+  void Reset();
+
+  //! Get the maximum number of points in each block.
+  size_t BlockSize() const { return blockSize; }
+  //! Get the dimensionality of the dataset (for a text file, the number of
+  //! tokens on its first line).
+  size_t Dimensionality() const { return dimensionality; }
+  //! Get the number of points read since the file was opened or reset.
+  size_t Position() const { return position; }
+
+ private:
+  //! The formats that can be read.
+  enum struct Format
+  {
+    Text,
+    ARFF,
+    ArmaBinary,
+    HDF5
+  };
+
+  //! Set up the given DatasetInfo for the file, before the first block.
+  template<typename eT, typename PolicyType>
+  void InitializeMapper(DatasetMapper<PolicyType>& info);
+
+  //! Read a block of a text file, converting each token with the given
+  //! function, called as `convert(token, dimension)`.
+  template<typename eT, typename ConvertFunctionType>
+  bool NextText(arma::Mat<eT>& block, ConvertFunctionType&& convert);
+
+  //! Read a block of an ARFF file.
+  template<typename eT, typename PolicyType>
+  bool NextARFF(arma::Mat<eT>& block, DatasetMapper<PolicyType>& info);
+
+  //! Read a block of an Armadillo binary file.
+  template<typename eT>
+  bool NextBinary(arma::Mat<eT>& block);
+
+  //! Read the given number of points from an Armadillo binary file whose
+  //! elements have the given type.
+  template<typename FileElemType, typename eT>
+  void ReadBinary(arma::Mat<eT>& block, const size_t count);
+
+  //! Read a block of an HDF5 file.
+  template<typename eT>
+  bool NextHDF5(arma::Mat<eT>& block);
+
+  //! Read the next line that is not blank (or a comment, for ARFF) from the
+  //! given stream, without whitespace on either side.
+  bool NextLine(std::istream& input,
+                std::string& lineString,
+                size_t& lineNumber) const;
+
+  //! Read the tokens of the next line of a text file from the given stream,
+  //! checking that there is one for each dimension.
+  bool NextTokens(std::istream& input,
+                  size_t& lineNumber,
+                  std::vector<std::string>& tokens) const;
+
+  //! Split the given line of a text file into trimmed tokens.
+  void Tokenize(const std::string& lineString,
+                std::vector<std::string>& tokens) const;
+
+  //! The name of the file.
+  std::string filename;
+  //! The maximum number of points in each block.
+  size_t blockSize;
+  //! Whether each row of a stored binary matrix is a point.
+  bool transpose;
+  //! The format of the file.
+  Format format;
+  //! The stream the file is read from (except for HDF5).
+  std::ifstream stream;
+  //! Position of the first point in the stream.
+  std::streampos dataStart;
+  //! The delimiter between values of a text file (' ' means any whitespace).
+  char delimiter;
+  //! The dimensionality of the dataset.
+  size_t dimensionality;
+  //! The number of points of a binary file.
+  size_t points;
+  //! The number of points read since the file was opened or reset.
+  size_t position;
+  //! The number of lines read from a text or ARFF file.
+  size_t linesRead;
+  //! The number of lines of the header of an ARFF file.
+  size_t headerLines;
+  //! Whether a DatasetInfo was set up for the file.
+  bool mapperReady;
+  //! The header of an Armadillo binary file.
+  std::string binaryHeader;
+  //! Mappings of an ARFF file that is read without a DatasetInfo.
+  DatasetInfo arffInfo;
+  //! Categories listed in the header of an ARFF file.
+  std::map<size_t, std::vector<std::string>> categoryStrings;
+  //! Used to convert tokens to numbers.
+  LoadCSV parser;
+
+#ifdef ARMA_USE_HDF5
+  //! The HDF5 file.
+  hid_t hdf5File;
+  //! The HDF5 dataset of the matrix.
+  hid_t hdf5Dataset;
+#endif
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "matrix_reader_impl.hpp"
+
+#endif
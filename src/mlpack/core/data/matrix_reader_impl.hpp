@@ -0,0 +1,587 @@
+/**
+ * @file core/data/matrix_reader_impl.hpp
+ *
+ * Implementation of MatrixReader.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_MATRIX_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_MATRIX_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "matrix_reader.hpp"
+
+namespace mlpack {
+namespace data {
+
+#ifdef ARMA_USE_HDF5
+/**
+ * Get the native HDF5 type of the given element type, so that HDF5 converts
+ * the stored elements while reading them.
+ */
+template<typename eT>
+inline hid_t HDF5ElemType()
+{
+  static_assert(std::is_arithmetic_v<eT>, "MatrixReader: HDF5 files can only "
+      "be read into matrices of arithmetic types!");
+
+  if constexpr (std::is_same_v<eT, double>)
+    return H5T_NATIVE_DOUBLE;
+  else if constexpr (std::is_floating_point_v<eT>)
+    return H5T_NATIVE_FLOAT;
+  else if constexpr (sizeof(eT) == 1)
+    return std::is_signed_v<eT> ? H5T_NATIVE_INT8 : H5T_NATIVE_UINT8;
+  else if constexpr (sizeof(eT) == 2)
+    return std::is_signed_v<eT> ? H5T_NATIVE_INT16 : H5T_NATIVE_UINT16;
+  else if constexpr (sizeof(eT) == 4)
+    return std::is_signed_v<eT> ? H5T_NATIVE_INT32 : H5T_NATIVE_UINT32;
+  else
+    return std::is_signed_v<eT> ? H5T_NATIVE_INT64 : H5T_NATIVE_UINT64;
+}
+#endif
+
+inline MatrixReader::MatrixReader(const std::string& filename,
+                                  const size_t blockSize,
+                                  const bool transpose) :
+    filename(filename),
+    blockSize(blockSize),
+    transpose(transpose),
+    format(Format::Text),
+    dataStart(0),
+    delimiter(','),
+    dimensionality(0),
+    points(0),
+    position(0),
+    linesRead(0),
+    headerLines(0),
+    mapperReady(false)
+#ifdef ARMA_USE_HDF5
+    , hdf5File(-1),
+    hdf5Dataset(-1)
+#endif
+{
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("MatrixReader::MatrixReader(): the block size "
+        "must be positive!");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "csv" || extension == "tsv" || extension == "txt")
+  {
+    format = Format::Text;
+    delimiter = (extension == "csv") ? ',' :
+        ((extension == "tsv") ? '\t' : ' ');
+  }
+  else if (extension == "arff")
+  {
+    format = Format::ARFF;
+  }
+  else if (extension == "bin")
+  {
+    format = Format::ArmaBinary;
+  }
+  else if (extension == "h5" || extension == "hdf5" || extension == "hdf" ||
+           extension == "he5")
+  {
+    format = Format::HDF5;
+  }
+  else
+  {
+    throw std::runtime_error("MatrixReader::MatrixReader(): cannot read '" +
+        filename + "': unknown extension '" + extension + "'!");
+  }
+
+  if (!transpose && (format == Format::Text || format == Format::ARFF))
+  {
+    throw std::invalid_argument("MatrixReader::MatrixReader(): text and ARFF "
+        "files can only be read with transpose = true!");
+  }
+
+  if (format == Format::HDF5)
+  {
+#ifdef ARMA_USE_HDF5
+    hdf5File = H5Fopen(filename.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (hdf5File < 0)
+    {
+      throw std::runtime_error("MatrixReader::MatrixReader(): cannot open "
+          "file '" + filename + "'!");
+    }
+
+    hdf5Dataset = H5Dopen(hdf5File, "dataset", H5P_DEFAULT);
+    hsize_t dims[2] = { 0, 0 };
+    int rank = -1;
+    if (hdf5Dataset >= 0)
+    {
+      const hid_t space = H5Dget_space(hdf5Dataset);
+      rank = H5Sget_simple_extent_ndims(space);
+      if (rank == 2)
+        H5Sget_simple_extent_dims(space, dims, NULL);
+      H5Sclose(space);
+    }
+
+    if (rank != 2)
+    {
+      if (hdf5Dataset >= 0)
+        H5Dclose(hdf5Dataset);
+      H5Fclose(hdf5File);
+      throw std::runtime_error("MatrixReader::MatrixReader(): '" + filename +
+          "' does not hold a matrix called 'dataset'!");
+    }
+
+    // Armadillo stores each column of the matrix as a row of the dataset.
+    dimensionality = transpose ? dims[0] : dims[1];
+    points = transpose ? dims[1] : dims[0];
+    return;
+#else
+    throw std::runtime_error("MatrixReader::MatrixReader(): cannot read '" +
+        filename + "', because Armadillo was compiled without HDF5 support!");
+#endif
+  }
+
+  stream.open(filename, std::ios::in | std::ios::binary);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("MatrixReader::MatrixReader(): cannot open file '"
+        + filename + "'!");
+  }
+
+  if (format == Format::Text)
+  {
+    // The first line gives the dimensionality.
+    std::string lineString;
+    std::vector<std::string> tokens;
+    size_t lineNumber = 0;
+    if (NextLine(stream, lineString, lineNumber))
+    {
+      Tokenize(lineString, tokens);
+      dimensionality = tokens.size();
+    }
+
+    Reset();
+  }
+  else if (format == Format::ARFF)
+  {
+    headerLines = LoadARFFHeader<double>(stream, arffInfo, categoryStrings);
+    dimensionality = arffInfo.Dimensionality();
+    dataStart = stream.tellg();
+    linesRead = headerLines;
+  }
+  else
+  {
+    size_t rows = 0, cols = 0;
+    stream >> binaryHeader >> rows >> cols;
+    stream.get();
+
+    const std::vector<std::string> types = { "FN008", "FN004", "IU008",
+        "IS008", "IU004", "IS004", "IU002", "IS002", "IU001", "IS001" };
+    const std::string prefix = "ARMA_MAT_BIN_";
+    if (!stream.good() || binaryHeader.size() != prefix.size() + 5 ||
+        binaryHeader.compare(0, prefix.size(), prefix) != 0 ||
+        std::find(types.begin(), types.end(),
+            binaryHeader.substr(prefix.size())) == types.end())
+    {
+      throw std::runtime_error("MatrixReader::MatrixReader(): '" + filename +
+          "' is not a binary Armadillo matrix!");
+    }
+
+    dataStart = stream.tellg();
+    dimensionality = transpose ? cols : rows;
+    points = transpose ? rows : cols;
+  }
+}
+
+inline MatrixReader::~MatrixReader()
+{
+#ifdef ARMA_USE_HDF5
+  if (hdf5Dataset >= 0)
+    H5Dclose(hdf5Dataset);
+  if (hdf5File >= 0)
+    H5Fclose(hdf5File);
+#endif
+}
+
+template<typename eT>
+bool MatrixReader::Next(arma::Mat<eT>& block)
+{
+  if (format == Format::Text)
+  {
+    return NextText(block, [&](const std::string& token, const size_t)
+    {
+      eT value;
+      if (!parser.ConvertToken(value, token))
+      {
+        throw std::runtime_error("MatrixReader::Next(): cannot parse '" +
+            token + "' on line " + std::to_string(linesRead) + " of '" +
+            filename + "'!");
+      }
+      return value;
+    });
+  }
+  else if (format == Format::ARFF)
+  {
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      if (arffInfo.Type(d) == Datatype::categorical)
+      {
+        throw std::runtime_error("MatrixReader::Next(): '" + filename + "' "
+            "has categorical dimensions, so it must be read with a "
+            "DatasetInfo!");
+      }
+    }
+
+    return NextARFF(block, arffInfo);
+  }
+  else if (format == Format::ArmaBinary)
+  {
+    return NextBinary(block);
+  }
+  else
+  {
+    return NextHDF5(block);
+  }
+}
+
+template<typename eT, typename PolicyType>
+bool MatrixReader::Next(arma::Mat<eT>& block, DatasetMapper<PolicyType>& info)
+{
+  if (!mapperReady)
+  {
+    InitializeMapper<eT>(info);
+    mapperReady = true;
+  }
+
+  if (format == Format::Text)
+  {
+    return NextText(block, [&](const std::string& token, const size_t d)
+    {
+      return info.template MapString<eT>(token, d);
+    });
+  }
+  else if (format == Format::ARFF)
+  {
+    return NextARFF(block, info);
+  }
+  else if (format == Format::ArmaBinary)
+  {
+    return NextBinary(block);
+  }
+  else
+  {
+    return NextHDF5(block);
+  }
+}
+
+inline void MatrixReader::Reset()
+{
+  if (format != Format::HDF5)
+  {
+    stream.clear();
+    stream.seekg(dataStart);
+  }
+
+  position = 0;
+  linesRead = headerLines;
+}
+
+template<typename eT, typename PolicyType>
+void MatrixReader::InitializeMapper(DatasetMapper<PolicyType>& info)
+{
+  // The header of an ARFF file sets up the mapper.
+  if (format == Format::ARFF)
+  {
+    std::ifstream header(filename, std::ios::in | std::ios::binary);
+    LoadARFFHeader<eT>(header, info, categoryStrings);
+    return;
+  }
+
+  if (info.Dimensionality() == 0)
+  {
+    info.SetDimensionality(dimensionality);
+  }
+  else if (info.Dimensionality() != dimensionality)
+  {
+    std::ostringstream oss;
+    oss << "MatrixReader::Next(): given DatasetInfo has dimensionality "
+        << info.Dimensionality() << ", but data has dimensionality "
+        << dimensionality;
+    throw std::invalid_argument(oss.str());
+  }
+
+  if (format != Format::Text || !PolicyType::NeedsFirstPass)
+    return;
+
+  // Take a first pass through the whole file with a separate stream, so that
+  // the types of the dimensions are the same for every block.
+  std::ifstream input(filename, std::ios::in | std::ios::binary);
+  std::vector<std::string> tokens;
+  size_t lineNumber = 0;
+  while (NextTokens(input, lineNumber, tokens))
+  {
+    for (size_t d = 0; d < tokens.size(); ++d)
+      info.template MapFirstPass<eT>(tokens[d], d);
+  }
+}
+
+template<typename eT, typename ConvertFunctionType>
+bool MatrixReader::NextText(arma::Mat<eT>& block,
+                            ConvertFunctionType&& convert)
+{
+  std::vector<eT> values;
+  std::vector<std::string> tokens;
+  size_t count = 0;
+  while (count < blockSize && NextTokens(stream, linesRead, tokens))
+  {
+    for (size_t d = 0; d < tokens.size(); ++d)
+      values.push_back(convert(tokens[d], d));
+    ++count;
+  }
+
+  if (count == 0)
+  {
+    block.set_size(dimensionality, 0);
+    return false;
+  }
+
+  block = arma::Mat<eT>(values.data(), dimensionality, count);
+  position += count;
+  return true;
+}
+
+template<typename eT, typename PolicyType>
+bool MatrixReader::NextARFF(arma::Mat<eT>& block,
+                            DatasetMapper<PolicyType>& info)
+{
+  std::string lineString;
+  block.zeros(dimensionality, blockSize);
+  size_t count = 0;
+  while (count < blockSize && NextLine(stream, lineString, linesRead))
+  {
+    LoadARFFPoint(lineString, linesRead, info, categoryStrings, block, count);
+    ++count;
+  }
+
+  if (count == 0)
+  {
+    block.set_size(dimensionality, 0);
+    return false;
+  }
+
+  block.resize(dimensionality, count);
+  position += count;
+  return true;
+}
+
+template<typename eT>
+bool MatrixReader::NextBinary(arma::Mat<eT>& block)
+{
+  if (position >= points)
+  {
+    block.set_size(dimensionality, 0);
+    return false;
+  }
+
+  const size_t count = std::min(blockSize, points - position);
+  const std::string type = binaryHeader.substr(binaryHeader.size() - 5);
+  if (type == "FN008")
+    ReadBinary<double>(block, count);
+  else if (type == "FN004")
+    ReadBinary<float>(block, count);
+  else if (type == "IU008")
+    ReadBinary<arma::u64>(block, count);
+  else if (type == "IS008")
+    ReadBinary<arma::s64>(block, count);
+  else if (type == "IU004")
+    ReadBinary<arma::u32>(block, count);
+  else if (type == "IS004")
+    ReadBinary<arma::s32>(block, count);
+  else if (type == "IU002")
+    ReadBinary<arma::u16>(block, count);
+  else if (type == "IS002")
+    ReadBinary<arma::s16>(block, count);
+  else if (type == "IU001")
+    ReadBinary<arma::u8>(block, count);
+  else
+    ReadBinary<arma::s8>(block, count);
+
+  position += count;
+  return true;
+}
+
+template<typename FileElemType, typename eT>
+void MatrixReader::ReadBinary(arma::Mat<eT>& block, const size_t count)
+{
+  arma::Mat<FileElemType> buffer;
+  if (transpose)
+  {
+    // Each dimension is a column of the stored matrix, so the block is read
+    // one dimension at a time.
+    buffer.set_size(count, dimensionality);
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      stream.seekg(dataStart + std::streamoff((d * points + position) *
+          sizeof(FileElemType)));
+      stream.read(reinterpret_cast<char*>(buffer.colptr(d)),
+          std::streamsize(count * sizeof(FileElemType)));
+    }
+  }
+  else
+  {
+    buffer.set_size(dimensionality, count);
+    stream.seekg(dataStart + std::streamoff(position * dimensionality *
+        sizeof(FileElemType)));
+    stream.read(reinterpret_cast<char*>(buffer.memptr()),
+        std::streamsize(buffer.n_elem * sizeof(FileElemType)));
+  }
+
+  if (!stream.good())
+  {
+    throw std::runtime_error("MatrixReader::Next(): '" + filename + "' ended "
+        "before all points were read!");
+  }
+
+  if (transpose)
+    block = arma::conv_to<arma::Mat<eT>>::from(buffer.t());
+  else
+    block = arma::conv_to<arma::Mat<eT>>::from(buffer);
+}
+
+template<typename eT>
+bool MatrixReader::NextHDF5(arma::Mat<eT>& block)
+{
+  if (position >= points)
+  {
+    block.set_size(dimensionality, 0);
+    return false;
+  }
+
+#ifdef ARMA_USE_HDF5
+  const size_t count = std::min(blockSize, points - position);
+
+  // Select the rows (or columns) of the stored matrix that hold the points.
+  hsize_t offset[2], counts[2];
+  offset[0] = transpose ? 0 : position;
+  offset[1] = transpose ? position : 0;
+  counts[0] = transpose ? dimensionality : count;
+  counts[1] = transpose ? count : dimensionality;
+
+  const hid_t fileSpace = H5Dget_space(hdf5Dataset);
+  H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, offset, NULL, counts, NULL);
+  const hid_t memSpace = H5Screate_simple(2, counts, NULL);
+
+  // The selection is read in row-major order.
+  arma::Mat<eT> buffer(counts[1], counts[0]);
+  const herr_t status = H5Dread(hdf5Dataset, HDF5ElemType<eT>(), memSpace,
+      fileSpace, H5P_DEFAULT, buffer.memptr());
+  H5Sclose(memSpace);
+  H5Sclose(fileSpace);
+
+  if (status < 0)
+  {
+    throw std::runtime_error("MatrixReader::Next(): cannot read the points of "
+        "'" + filename + "'!");
+  }
+
+  if (transpose)
+    block = buffer.t();
+  else
+    block = std::move(buffer);
+
+  position += count;
+  return true;
+#else
+  // The constructor does not allow this.
+  return false;
+#endif
+}
+
+inline bool MatrixReader::NextLine(std::istream& input,
+                                   std::string& lineString,
+                                   size_t& lineNumber) const
+{
+  while (std::getline(input, lineString))
+  {
+    ++lineNumber;
+    Trim(lineString);
+    if (lineString.empty() || (format == Format::ARFF && lineString[0] == '%'))
+      continue;
+
+    return true;
+  }
+
+  return false;
+}
+
+inline bool MatrixReader::NextTokens(std::istream& input,
+                                     size_t& lineNumber,
+                                     std::vector<std::string>& tokens) const
+{
+  std::string lineString;
+  if (!NextLine(input, lineString, lineNumber))
+    return false;
+
+  Tokenize(lineString, tokens);
+  if (tokens.size() != dimensionality)
+  {
+    throw std::runtime_error("MatrixReader::Next(): line " +
+        std::to_string(lineNumber) + " of '" + filename + "' has " +
+        std::to_string(tokens.size()) + " values, but " +
+        std::to_string(dimensionality) + " were expected!");
+  }
+
+  return true;
+}
+
+inline void MatrixReader::Tokenize(const std::string& lineString,
+                                   std::vector<std::string>& tokens) const
+{
+  // Split the line at the delimiter, or at runs of whitespace.
+  std::vector<std::string> pieces;
+  if (delimiter == ' ')
+  {
+    std::istringstream lineStream(lineString);
+    std::string piece;
+    while (lineStream >> piece)
+      pieces.push_back(piece);
+  }
+  else
+  {
+    size_t begin = 0;
+    while (true)
+    {
+      const size_t end = lineString.find(delimiter, begin);
+      pieces.push_back(lineString.substr(begin, end - begin));
+      if (end == std::string::npos)
+        break;
+      begin = end + 1;
+    }
+  }
+
+  // Trim the pieces, and join the pieces of quoted tokens.
+  tokens.clear();
+  for (size_t i = 0; i < pieces.size(); ++i)
+  {
+    std::string token = pieces[i];
+    Trim(token);
+    if (!token.empty() && token.front() == '"' && token.back() != '"')
+    {
+      while (i + 1 < pieces.size())
+      {
+        token += delimiter;
+        token += pieces[++i];
+        if (!pieces[i].empty() && pieces[i].back() == '"')
+          break;
+      }
+    }
+
+    tokens.push_back(std::move(token));
+  }
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -62,6 +62,40 @@ void OneHotEncoding(const arma::Mat<eT>& input,
                     arma::Mat<eT>& output,
                     const data::DatasetInfo& datasetInfo);
 
+/**
+ * Overloaded function for the above functions, which one-hot encodes the given
+ * dimensions of a matrix into a sparse matrix.  This is much smaller than the
+ * dense encoding when the encoded dimensions have many values, and is built
+ * directly (in parallel, if OpenMP is enabled), so that the dense encoding is
+ * never stored.  Other than its type, the output is the same as that of the
+ * dense overload; zero values of the dimensions that are not encoded are not
+ * stored.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output);
+
+/**
+ * Overloaded function for the above functions, which takes a matrix as input
+ * and also a DatasetInfo object (such as the one filled by data::Load() for a
+ * file with categorical dimensions) and outputs a sparse matrix.  This
+ * function encodes all the dimensions marked `Datatype::categorical` in the
+ * data::DatasetInfo.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Encoded sparse matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo);
+
 } // namespace data
 } // namespace mlpack
 
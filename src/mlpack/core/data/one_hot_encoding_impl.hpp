@@ -18,6 +18,68 @@
 
 namespace mlpack {
 namespace data {
+namespace details {
+
+/**
+ * Map the values of each of the given dimensions of `input` to the rows of the
+ * one-hot encoding, in the order in which the values first appear, and find
+ * the first row of each dimension in the encoded matrix.  Each dimension is
+ * mapped by a single thread, so the mappings do not depend on the number of
+ * threads.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param mappings Vector to store the mappings of each dimension into (empty
+ *     for dimensions that are not encoded).
+ * @param encoded Vector to store whether each dimension is encoded into.
+ * @param dimensionOffsets Vector to store the first row of each dimension
+ *     into; its last element is the number of rows of the encoded matrix.
+ */
+template<typename eT>
+void OneHotEncodingMappings(
+    const arma::Mat<eT>& input,
+    const arma::Col<size_t>& indices,
+    std::vector<std::unordered_map<eT, size_t>>& mappings,
+    std::vector<char>& encoded,
+    arma::Col<size_t>& dimensionOffsets)
+{
+  mappings.clear();
+  mappings.resize(input.n_rows);
+  encoded.assign(input.n_rows, 0);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= input.n_rows)
+    {
+      throw std::invalid_argument("data::OneHotEncoding(): dimension " +
+          std::to_string(indices[i]) + " cannot be encoded, because the "
+          "dataset has only " + std::to_string(input.n_rows) +
+          " dimensions!");
+    }
+
+    encoded[indices[i]] = 1;
+  }
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t row = 0; row < (size_t) input.n_rows; ++row)
+  {
+    if (!encoded[row])
+      continue;
+
+    for (size_t col = 0; col < input.n_cols; ++col)
+      mappings[row].emplace(input(row, col), mappings[row].size());
+  }
+
+  // Dimensions that are not encoded take a single row.
+  dimensionOffsets.set_size(input.n_rows + 1);
+  dimensionOffsets[0] = 0;
+  for (size_t row = 0; row < input.n_rows; ++row)
+  {
+    dimensionOffsets[row + 1] = dimensionOffsets[row] +
+        (encoded[row] ? mappings[row].size() : 1);
+  }
+}
+
+} // namespace details
 
 /**
  * Given a set of labels of a particular datatype, convert them to binary
@@ -55,12 +117,25 @@ void OneHotEncoding(const RowType& labelsIn,
       ++curLabel;
     }
   }
-  // Resize output matrix to necessary size, and fill it with zeros.
-  output.zeros(curLabel, labelsIn.n_elem);
-  // Fill ones in at the required places.
-  for (size_t i = 0; i < labelsIn.n_elem; ++i)
+  if constexpr (arma::is_SpMat<MatType>::value)
+  {
+    // Build the sparse matrix directly: each column has exactly one nonzero.
+    const arma::uvec rowIndices = arma::conv_to<arma::uvec>::from(labels);
+    const arma::uvec colPtrs = arma::linspace<arma::uvec>(0, labelsIn.n_elem,
+        labelsIn.n_elem + 1);
+    const arma::Col<typename MatType::elem_type> values(labelsIn.n_elem,
+        arma::fill::ones);
+    output = MatType(rowIndices, colPtrs, values, curLabel, labelsIn.n_elem);
+  }
+  else
   {
-    output(labels[i], i) = 1;
+    // Resize output matrix to necessary size, and fill it with zeros.
+    output.zeros(curLabel, labelsIn.n_elem);
+    // Fill ones in at the required places.
+    for (size_t i = 0; i < labelsIn.n_elem; ++i)
+    {
+      output(labels[i], i) = 1;
+    }
   }
   labelMap.clear();
 }
@@ -86,61 +161,102 @@ void OneHotEncoding(const arma::Mat<eT>& input,
     return;
   }
 
-  // First, we need to compute the size of the output matrix.
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<char> encoded;
+  arma::Col<size_t> dimensionOffsets;
+  details::OneHotEncodingMappings(input, indices, mappings, encoded,
+      dimensionOffsets);
 
-  // This vector will eventually hold the offsets for each dimension in the
-  // one-hot encoded matrix, but first it will just hold the counts of
-  // dimensions for each dimension.
-  arma::Col<size_t> dimensionOffsets(input.n_rows, arma::fill::ones);
-  // This will hold the mappings from a value that should be one-hot encoded to
-  // the index of the dimension it should take.
-  std::unordered_map<size_t, std::unordered_map<eT, size_t>> mappings;
-  for (size_t i = 0; i < indices.n_elem; ++i)
-  {
-    dimensionOffsets[indices[i]] = 0;
-    mappings.insert(
-        std::make_pair(indices[i], std::unordered_map<eT, size_t>()));
-  }
+  // Now, initialize the output matrix to the right size.
+  output.zeros(dimensionOffsets[input.n_rows], input.n_cols);
 
-  for (size_t col = 0; col < input.n_cols; ++col)
+  // Finally, one-hot encode the matrix.  Each point is encoded independently.
+  #pragma omp parallel for schedule(static)
+  for (size_t col = 0; col < (size_t) input.n_cols; ++col)
   {
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      if (mappings.count(row) != 0)
+      if (encoded[row])
+      {
+        output(dimensionOffsets[row] + mappings[row].at(input(row, col)),
+            col) = eT(1);
+      }
+      else
       {
-        // We have to one-hot encode this point.
-        if (mappings[row].count(input(row, col)) == 0)
-          mappings[row][input(row, col)] = dimensionOffsets[row]++;
+        // No need for one-hot encoding.
+        output(dimensionOffsets[row], col) = input(row, col);
       }
     }
   }
+}
+
+/**
+ * Overloaded function for the above function, which one-hot encodes the given
+ * dimensions of a matrix into a sparse matrix.  The sparse matrix is built
+ * directly, so the dense encoding is never stored.
+ *
+ * @param input Input dataset to be encoded.
+ * @param indices Index of rows to be encoded.
+ * @param output Encoded sparse matrix.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    const arma::Col<size_t>& indices,
+                    arma::SpMat<eT>& output)
+{
+  std::vector<std::unordered_map<eT, size_t>> mappings;
+  std::vector<char> encoded;
+  arma::Col<size_t> dimensionOffsets;
+  details::OneHotEncodingMappings(input, indices, mappings, encoded,
+      dimensionOffsets);
 
-  // Turn the dimension counts into offsets.  Note that the last element is the
-  // total number of dimensions, and the first element is the offset for
-  // dimension *2* (not 1).
-  for (size_t i = 1; i < dimensionOffsets.n_elem; ++i)
-    dimensionOffsets[i] += dimensionOffsets[i - 1];
+  // Count the nonzeros of each point: one for each encoded dimension, and one
+  // for each other dimension that is nonzero.
+  arma::uvec colPtrs(input.n_cols + 1);
+  colPtrs[0] = 0;
 
-  // Now, initialize the output matrix to the right size.
-  output.zeros(dimensionOffsets[dimensionOffsets.n_elem - 1], input.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (size_t col = 0; col < (size_t) input.n_cols; ++col)
+  {
+    size_t nonZeros = 0;
+    for (size_t row = 0; row < input.n_rows; ++row)
+    {
+      if (encoded[row] || input(row, col) != eT(0))
+        ++nonZeros;
+    }
+    colPtrs[col + 1] = nonZeros;
+  }
 
-  // Finally, one-hot encode the matrix.
   for (size_t col = 0; col < input.n_cols; ++col)
+    colPtrs[col + 1] += colPtrs[col];
+
+  // Fill each column; the rows of each dimension come after the rows of the
+  // previous dimensions, so the row indices of each column are sorted.
+  arma::uvec rowIndices(colPtrs[input.n_cols]);
+  arma::Col<eT> values(colPtrs[input.n_cols]);
+
+  #pragma omp parallel for schedule(static)
+  for (size_t col = 0; col < (size_t) input.n_cols; ++col)
   {
+    size_t i = colPtrs[col];
     for (size_t row = 0; row < input.n_rows; ++row)
     {
-      const size_t dimOffset = (row == 0) ? 0 : dimensionOffsets[row - 1];
-      if (mappings.count(row) != 0)
+      if (encoded[row])
       {
-        output(dimOffset + mappings[row][input(row, col)], col) = eT(1);
+        rowIndices[i] = dimensionOffsets[row] +
+            mappings[row].at(input(row, col));
+        values[i++] = eT(1);
       }
-      else
+      else if (input(row, col) != eT(0))
       {
-        // No need for one-hot encoding.
-        output(dimOffset, col) = input(row, col);
+        rowIndices[i] = dimensionOffsets[row];
+        values[i++] = input(row, col);
       }
     }
   }
+
+  output = arma::SpMat<eT>(rowIndices, colPtrs, values,
+      dimensionOffsets[input.n_rows], input.n_cols);
 }
 
 /**
@@ -169,6 +285,33 @@ void OneHotEncoding(const arma::Mat<eT>& input,
   OneHotEncoding(input, arma::Col<size_t>(indices), output);
 }
 
+/**
+ * Overloaded function for the above function, which takes a matrix as input
+ * and also a DatasetInfo object and outputs a sparse matrix.
+ * This function encodes all the dimensions marked `Datatype::categorical`
+ * in the data::DatasetInfo, without storing the dense encoding.
+ *
+ * @param input Input dataset to be encoded.
+ * @param output Encoded sparse matrix.
+ * @param datasetInfo DatasetInfo object that has information about data.
+ */
+template<typename eT>
+void OneHotEncoding(const arma::Mat<eT>& input,
+                    arma::SpMat<eT>& output,
+                    const data::DatasetInfo& datasetInfo)
+{
+  std::vector<size_t> indices;
+  for (size_t i = 0; i < datasetInfo.Dimensionality(); ++i)
+  {
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      indices.push_back(i);
+    }
+  }
+
+  OneHotEncoding(input, arma::Col<size_t>(indices), output);
+}
+
 } // namespace data
 } // namespace mlpack
 
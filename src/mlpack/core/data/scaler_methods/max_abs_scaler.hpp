@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_MAX_ABS_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -42,6 +43,10 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The statistics are computed in a single parallel pass; `PartialFit()` fits
+ * the scaler one block of points at a time, and `Transform(data)` scales a
+ * matrix in place.
  */
 class MaxAbsScaler
 {
@@ -54,8 +59,28 @@ class MaxAbsScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMin = min(input, 1);
-    itemMax = arma::max(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features incrementally: the statistics of the given block
+   * of points are added to those of the earlier blocks given to PartialFit()
+   * since the last Fit(), so that a dataset that does not fit in memory can be
+   * fitted one block at a time.  (The statistics are not serialized, so this
+   * starts over after the scaler is loaded.)
+   *
+   * @param input Block of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    if (statistics.Count() == 0)
+      return;
+
+    itemMin = statistics.Min();
+    itemMax = statistics.Max();
     scale = arma::max(arma::abs(itemMin), arma::abs(itemMax));
     // Handling zeros in scale vector.
     scale.for_each([](arma::vec::elem_type& val) { val =
@@ -70,14 +95,34 @@ class MaxAbsScaler
    */
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
+  {
+    output = input;
+    Transform(output);
+  }
+
+  /**
+   * Function to scale features in place, without any temporary matrix.
+   *
+   * @param data Dataset to scale the features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
   {
     if (scale.is_empty())
     {
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = input.each_col() / scale;
+    util::CheckSameDimensionality(data, scale,
+        "MaxAbsScaler::Transform()");
+
+    #pragma omp parallel for
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      typename MatType::elem_type* column = data.colptr(j);
+      for (size_t i = 0; i < data.n_rows; ++i)
+        column[i] = column[i] / scale[i];
+    }
   }
 
   /**
@@ -114,6 +159,8 @@ class MaxAbsScaler
   arma::vec itemMax;
   // Vector which is used to scale up each feature.
   arma::vec scale;
+  // Statistics of the points given to PartialFit().
+  ScalingStatistics statistics;
 }; // class MaxAbsScaler
 
 } // namespace data
@@ -14,6 +14,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/math/ccov.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -69,10 +70,33 @@ class PCAWhitening
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features incrementally: the statistics of the given block
+   * of points are added to those of the earlier blocks given to PartialFit()
+   * since the last Fit(), so that a dataset that does not fit in memory can be
+   * fitted one block at a time.  (The statistics are not serialized, so this
+   * starts over after the scaler is loaded.)  The eigendecomposition is
+   * computed again after each block, so the blocks should have many more
+   * points than dimensions.
+   *
+   * @param input Block of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input, true);
+    if (statistics.Count() == 0)
+      return;
+
+    itemMean = statistics.Mean();
     // Get eigenvectors and eigenvalues of covariance of input matrix.
-    eig_sym(eigenValues, eigenVectors, ColumnCovariance(
-        input.each_col() - itemMean));
+    const size_t n = statistics.Count();
+    eig_sym(eigenValues, eigenVectors, statistics.Scatter() /
+        (double) ((n > 1) ? n - 1 : 1));
     eigenValues += epsilon;
   }
 
@@ -85,15 +109,21 @@ class PCAWhitening
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
   {
-    if (eigenValues.is_empty() || eigenVectors.is_empty())
-    {
-      throw std::runtime_error("Call Fit() before Transform(), please"
-          " refer to the documentation.");
-    }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean);
-    output = arma::diagmat(1.0 / (sqrt(eigenValues))) * eigenVectors.t()
-        * output;
+    output = input;
+    Transform(output);
+  }
+
+  /**
+   * Function for PCA whitening in place, one block of points at a time (in
+   * parallel), without a temporary matrix as large as the dataset.
+   *
+   * @param data Dataset to whiten the features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    Whiten(data, arma::diagmat(1.0 / sqrt(eigenValues)) * eigenVectors.t(),
+        "PCAWhitening::Transform()");
   }
 
   /**
@@ -129,6 +159,40 @@ class PCAWhitening
   }
 
  private:
+  // ZCAWhitening whitens with Whiten().
+  friend class ZCAWhitening;
+
+  /**
+   * Center the given dataset and multiply it by the given whitening matrix, in
+   * place, one block of points at a time.
+   */
+  template<typename MatType>
+  void Whiten(MatType& data,
+              const arma::mat& whitening,
+              const std::string& callerDescription) const
+  {
+    if (eigenValues.is_empty() || eigenVectors.is_empty())
+    {
+      throw std::runtime_error("Call Fit() before Transform(), please"
+          " refer to the documentation.");
+    }
+    util::CheckSameDimensionality(data, itemMean, callerDescription);
+
+    const size_t blockSize = 1024;
+    const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+
+      MatType block = data.cols(begin, end - 1);
+      block.each_col() -= itemMean;
+      data.cols(begin, end - 1) = whitening * block;
+    }
+  }
+
   // Vector which holds mean of each feature.
   arma::vec itemMean;
   // Mat which hold the eigenvectors.
@@ -137,6 +201,8 @@ class PCAWhitening
   double epsilon;
   // Vector which hold the eigenvalues.
   arma::vec eigenValues;
+  // Statistics of the points given to PartialFit().
+  ScalingStatistics statistics;
 }; // class PCAWhitening
 
 } // namespace data
@@ -16,6 +16,7 @@
 #include "mean_normalization.hpp"
 #include "min_max_scaler.hpp"
 #include "pca_whitening.hpp"
+#include "scaling_statistics.hpp"
 #include "standard_scaler.hpp"
 #include "zca_whitening.hpp"
 
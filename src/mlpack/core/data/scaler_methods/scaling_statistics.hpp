@@ -0,0 +1,216 @@
+/**
+ * @file core/data/scaler_methods/scaling_statistics.hpp
+ *
+ * ScalingStatistics class, which accumulates the statistics of each dimension
+ * of a dataset that the scalers are fitted with.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_SCALER_METHODS_SCALING_STATISTICS_HPP
+#define MLPACK_CORE_DATA_SCALER_METHODS_SCALING_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * ScalingStatistics holds the number of points, and the mean, sum of squared
+ * deviations, minimum and maximum of each dimension of a dataset, and
+ * optionally its centered scatter matrix.  The statistics are updated one
+ * block of points at a time, in a single parallel pass that only takes memory
+ * proportional to the dimensionality: each thread accumulates its points with
+ * Welford's algorithm, and the statistics of the threads and of the blocks are
+ * merged with the pairwise update of Chan, Golub and LeVeque.  So, a scaler
+ * can be fitted on a dataset that is streamed from disk, and gives the same
+ * result (up to rounding) as when it is fitted on the whole dataset at once.
+ */
+class ScalingStatistics
+{
+ public:
+  //! Create empty statistics.  The dimensionality is set by the first block.
+  ScalingStatistics() : count(0) { }
+
+  /**
+   * Add the given block of points (one per column) to the statistics.  The
+   * block must have the dimensionality of the earlier blocks.
+   *
+   * @param input Block of points to add.
+   * @param computeScatter If true, also accumulate the scatter matrix; this
+   *     must be the same for every block.
+   */
+  template<typename MatType>
+  void Update(const MatType& input, const bool computeScatter = false)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (count > 0 && input.n_rows != mean.n_elem)
+    {
+      throw std::invalid_argument("ScalingStatistics::Update(): the block "
+          "has " + std::to_string(input.n_rows) + " dimensions, but the "
+          "earlier blocks have " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const size_t numBlocks = (input.n_cols + BlockSize - 1) / BlockSize;
+
+    #pragma omp parallel
+    {
+      // The statistics of the blocks of this thread.
+      ScalingStatistics threadStats;
+      ScalingStatistics blockStats;
+      MatType centered;
+
+      #pragma omp for schedule(static)
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        const size_t begin = b * BlockSize;
+        const size_t end = std::min(begin + BlockSize, (size_t) input.n_cols);
+
+        blockStats.Initialize(input.n_rows, computeScatter);
+        for (size_t j = begin; j < end; ++j)
+          blockStats.Add(input.colptr(j));
+
+        if (computeScatter)
+        {
+          centered = input.cols(begin, end - 1);
+          centered.each_col() -= arma::conv_to<arma::Col<
+              typename MatType::elem_type>>::from(blockStats.mean);
+          blockStats.scatter = arma::conv_to<arma::mat>::from(
+              centered * centered.t());
+        }
+
+        threadStats.Merge(blockStats);
+      }
+
+      #pragma omp critical
+      Merge(threadStats);
+    }
+  }
+
+  /**
+   * Add the statistics of another (disjoint) set of points to these.
+   *
+   * @param other Statistics to add.
+   */
+  void Merge(const ScalingStatistics& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    if (other.mean.n_elem != mean.n_elem)
+    {
+      throw std::invalid_argument("ScalingStatistics::Merge(): the "
+          "statistics have " + std::to_string(other.mean.n_elem) +
+          " dimensions, but these have " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const size_t total = count + other.count;
+    const double weight = (double) count * other.count / total;
+    const arma::vec delta = other.mean - mean;
+
+    if (!scatter.is_empty() || !other.scatter.is_empty())
+    {
+      if (scatter.n_elem != other.scatter.n_elem)
+      {
+        throw std::invalid_argument("ScalingStatistics::Merge(): only one of "
+            "the statistics has a scatter matrix!");
+      }
+
+      scatter += other.scatter + weight * (delta * delta.t());
+    }
+
+    m2 += other.m2 + weight * (delta % delta);
+    mean += ((double) other.count / total) * delta;
+    min = arma::min(min, other.min);
+    max = arma::max(max, other.max);
+    count = total;
+  }
+
+  //! Forget all points, so the next block may have any dimensionality.
+  void Reset()
+  {
+    count = 0;
+    mean.clear();
+    m2.clear();
+    min.clear();
+    max.clear();
+    scatter.clear();
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the dimensionality of the points (0 if there are none).
+  size_t Dimensionality() const { return mean.n_elem; }
+  //! Get the mean of each dimension.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the centered sum of squares of each dimension.
+  const arma::vec& M2() const { return m2; }
+  //! Get the minimum of each dimension.
+  const arma::vec& Min() const { return min; }
+  //! Get the maximum of each dimension.
+  const arma::vec& Max() const { return max; }
+  //! Get the centered scatter matrix (empty if it is not accumulated).
+  const arma::mat& Scatter() const { return scatter; }
+
+ private:
+  //! Set up empty statistics with the given dimensionality.
+  void Initialize(const size_t dimensionality, const bool computeScatter)
+  {
+    count = 0;
+    mean.zeros(dimensionality);
+    m2.zeros(dimensionality);
+    min.set_size(dimensionality);
+    min.fill(std::numeric_limits<double>::infinity());
+    max.set_size(dimensionality);
+    max.fill(-std::numeric_limits<double>::infinity());
+    if (!computeScatter)
+      scatter.clear();
+  }
+
+  //! Add the given point with Welford's algorithm.
+  template<typename eT>
+  void Add(const eT* point)
+  {
+    ++count;
+    for (size_t i = 0; i < mean.n_elem; ++i)
+    {
+      const double x = point[i];
+      const double delta = x - mean[i];
+      mean[i] += delta / count;
+      m2[i] += delta * (x - mean[i]);
+      min[i] = std::min(min[i], x);
+      max[i] = std::max(max[i], x);
+    }
+  }
+
+  //! Number of points in each block that is processed by one thread.
+  static constexpr size_t BlockSize = 1024;
+
+  //! Number of points.
+  size_t count;
+  //! Mean of each dimension.
+  arma::vec mean;
+  //! Centered sum of squares of each dimension.
+  arma::vec m2;
+  //! Minimum of each dimension.
+  arma::vec min;
+  //! Maximum of each dimension.
+  arma::vec max;
+  //! Centered scatter matrix.
+  arma::mat scatter;
+};
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_DATA_STANDARD_SCALE_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "scaling_statistics.hpp"
 
 namespace mlpack {
 namespace data {
@@ -43,6 +44,10 @@ namespace data {
  * // Retransform the input.
  * scale.InverseTransform(output, input);
  * @endcode
+ *
+ * The statistics are computed in a single parallel pass; `PartialFit()` fits
+ * the scaler one block of points at a time, and `Transform(data)` scales a
+ * matrix in place.
  */
 class StandardScaler
 {
@@ -55,8 +60,28 @@ class StandardScaler
   template<typename MatType>
   void Fit(const MatType& input)
   {
-    itemMean = arma::mean(input, 1);
-    itemStdDev = arma::stddev(input, 1, 1);
+    statistics.Reset();
+    PartialFit(input);
+  }
+
+  /**
+   * Function to fit features incrementally: the statistics of the given block
+   * of points are added to those of the earlier blocks given to PartialFit()
+   * since the last Fit(), so that a dataset that does not fit in memory can be
+   * fitted one block at a time.  (The statistics are not serialized, so this
+   * starts over after the scaler is loaded.)
+   *
+   * @param input Block of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    statistics.Update(input);
+    if (statistics.Count() == 0)
+      return;
+
+    itemMean = statistics.Mean();
+    itemStdDev = arma::sqrt(statistics.M2() / statistics.Count());
     // Handle zeros in scale vector.
     itemStdDev.for_each([](arma::vec::elem_type& val) { val =
         (val == 0) ? 1 : val; });
@@ -70,14 +95,34 @@ class StandardScaler
    */
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
+  {
+    output = input;
+    Transform(output);
+  }
+
+  /**
+   * Function to scale features in place, without any temporary matrix.
+   *
+   * @param data Dataset to scale the features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
   {
     if (itemMean.is_empty() || itemStdDev.is_empty())
     {
       throw std::runtime_error("Call Fit() before Transform(), please"
         " refer to the documentation.");
     }
-    output.copy_size(input);
-    output = (input.each_col() - itemMean).each_col() / itemStdDev;
+    util::CheckSameDimensionality(data, itemMean,
+        "StandardScaler::Transform()");
+
+    #pragma omp parallel for
+    for (size_t j = 0; j < data.n_cols; ++j)
+    {
+      typename MatType::elem_type* column = data.colptr(j);
+      for (size_t i = 0; i < data.n_rows; ++i)
+        column[i] = (column[i] - itemMean[i]) / itemStdDev[i];
+    }
   }
 
   /**
@@ -110,6 +155,8 @@ class StandardScaler
   arma::vec itemMean;
   // Vector which holds standard devation of each feature.
   arma::vec itemStdDev;
+  // Statistics of the points given to PartialFit().
+  ScalingStatistics statistics;
 }; // class StandardScaler
 
 } // namespace data
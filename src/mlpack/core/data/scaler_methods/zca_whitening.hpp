@@ -64,6 +64,23 @@ class ZCAWhitening
     pca.Fit(input);
   }
 
+  /**
+   * Function to fit features incrementally: the statistics of the given block
+   * of points are added to those of the earlier blocks given to PartialFit()
+   * since the last Fit(), so that a dataset that does not fit in memory can be
+   * fitted one block at a time.  (The statistics are not serialized, so this
+   * starts over after the scaler is loaded.)  The eigendecomposition is
+   * computed again after each block, so the blocks should have many more
+   * points than dimensions.
+   *
+   * @param input Block of the dataset to fit.
+   */
+  template<typename MatType>
+  void PartialFit(const MatType& input)
+  {
+    pca.PartialFit(input);
+  }
+
   /**
    * Function for ZCA whitening.
    *
@@ -73,8 +90,22 @@ class ZCAWhitening
   template<typename MatType>
   void Transform(const MatType& input, MatType& output)
   {
-    pca.Transform(input, output);
-    output = pca.EigenVectors() * output;
+    output = input;
+    Transform(output);
+  }
+
+  /**
+   * Function for ZCA whitening in place, one block of points at a time (in
+   * parallel), without a temporary matrix as large as the dataset.
+   *
+   * @param data Dataset to whiten the features of.
+   */
+  template<typename MatType>
+  void Transform(MatType& data)
+  {
+    pca.Whiten(data, pca.EigenVectors() * arma::diagmat(1.0 /
+        sqrt(pca.EigenValues())) * pca.EigenVectors().t(),
+        "ZCAWhitening::Transform()");
   }
 
   /**
@@ -18,6 +18,284 @@
 namespace mlpack {
 namespace data {
 
+/**
+ * Copy the columns of `input` with the given indices, in order, into `output`.
+ * For dense matrices, the columns are copied in parallel straight into
+ * `output`; other types (such as sparse matrices) use `input.cols(indices)`.
+ * `input` and `output` may be the same object.
+ *
+ * This is what Split() and StratifiedSplit() use to build their outputs, and
+ * it can be used with the indices given by SplitIndices(),
+ * StratifiedSplitIndices(), or KFoldSplitIndices() to copy only the part of a
+ * dataset that is needed at a time.
+ *
+ * @param input Matrix to copy columns from.
+ * @param indices Indices of the columns to copy.
+ * @param output Matrix to store the columns into.
+ */
+template<typename MatType>
+void GatherColumns(const MatType& input,
+                   const arma::uvec& indices,
+                   MatType& output)
+{
+  if (!indices.is_empty() && indices.max() >= input.n_cols)
+  {
+    throw std::invalid_argument("data::GatherColumns(): index " +
+        std::to_string(indices.max()) + " is out of range for a matrix with " +
+        std::to_string(input.n_cols) + " columns!");
+  }
+
+  if constexpr (arma::is_Mat<MatType>::value)
+  {
+    if (&input == &output)
+    {
+      MatType gathered;
+      GatherColumns(input, indices, gathered);
+      output = std::move(gathered);
+      return;
+    }
+
+    output.set_size(input.n_rows, indices.n_elem);
+    const size_t nRows = input.n_rows;
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < (size_t) indices.n_elem; ++i)
+    {
+      const typename MatType::elem_type* column = input.colptr(indices[i]);
+      std::copy(column, column + nRows, output.colptr(i));
+    }
+  }
+  else if (indices.is_empty())
+  {
+    output.set_size(input.n_rows, 0);
+  }
+  else
+  {
+    output = input.cols(indices);
+  }
+}
+
+/**
+ * Split the indices of a dataset with the given number of points into the
+ * indices of a training set and of a test set, the same way Split() splits the
+ * points themselves.  No points are copied, so the two sets take no memory
+ * beyond their indices; a set can be used lazily as `input.cols(indices)`, or
+ * copied with GatherColumns() when a matrix is needed.
+ *
+ * @code
+ * arma::uvec trainIndices, testIndices;
+ * data::SplitIndices(dataset.n_cols, trainIndices, testIndices, 0.2);
+ *
+ * // Only the training set is copied, and the copy is done in parallel.
+ * arma::mat trainData;
+ * data::GatherColumns(dataset, trainIndices, trainData);
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param trainIndices Vector to store the indices of the training set into.
+ * @param testIndices Vector to store the indices of the test set into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, the
+ *     first points are in the training set. (Default true.)
+ */
+inline void SplitIndices(const size_t numPoints,
+                         arma::uvec& trainIndices,
+                         arma::uvec& testIndices,
+                         const double testRatio,
+                         const bool shuffleData = true)
+{
+  const size_t testSize = static_cast<size_t>(numPoints * testRatio);
+  const size_t trainSize = numPoints - testSize;
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  trainIndices = order.head(trainSize);
+  testIndices = order.tail(testSize);
+}
+
+/**
+ * Split the indices of a labeled dataset into the indices of a training set
+ * and of a test set with the same ratios of each label, the same way
+ * StratifiedSplit() splits the points themselves.  As with SplitIndices(), no
+ * points are copied.
+ *
+ * @param inputLabel Labels of the dataset.
+ * @param trainIndices Vector to store the indices of the training set into.
+ * @param testIndices Vector to store the indices of the test set into.
+ * @param testRatio Percentage of dataset to use for test set (between 0 and 1).
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     sample is visited in linear order. (Default true.)
+ */
+template<typename LabelsType,
+         typename = std::enable_if_t<arma::is_arma_type<LabelsType>::value> >
+void StratifiedSplitIndices(const LabelsType& inputLabel,
+                            arma::uvec& trainIndices,
+                            arma::uvec& testIndices,
+                            const double testRatio,
+                            const bool shuffleData = true)
+{
+  /**
+   * Basic idea:
+   * Let us say we have to stratify a dataset based on labels:
+   * 0 0 0 0 0 (5 0s)
+   * 1 1 1 1 1 1 1 1 1 1 1 (11 1s)
+   *
+   * Let our test ratio be 0.2.
+   * Then, the number of 0 labels in our test set = floor(5 * 0.2) = 1.
+   * The number of 1 labels in our test set = floor(11 * 0.2) = 2.
+   *
+   * In our first pass over the dataset,
+   * We visit each label and keep count of each label in our 'labelCounts' uvec.
+   *
+   * We then take a second pass over the dataset.
+   * We now maintain an additional uvec 'testLabelCounts' to hold the label
+   * counts of our test set.
+   *
+   * In this pass, when we encounter a label we check the 'testLabelCounts' uvec
+   * for the count of this label in the test set.
+   * If this count is less than the required number of labels in the test set,
+   * we add the data to the test set and increment the label count in the uvec.
+   * If this count is equal to or more than the required count in the test set,
+   * we add this data to the train set.
+   *
+   * Based on the above steps, we get the following labels in the split set:
+   * Train set (4 0s, 9 1s)
+   * 0 0 0 0
+   * 1 1 1 1 1 1 1 1 1
+   *
+   * Test set (1 0s, 2 1s)
+   * 0
+   * 1 1
+   */
+  const size_t numPoints = inputLabel.n_elem;
+  arma::uvec labelCounts;
+  arma::uvec testLabelCounts;
+  size_t testSize = 0;
+  if (numPoints > 0)
+  {
+    labelCounts.zeros(inputLabel.max() + 1);
+    testLabelCounts.zeros(labelCounts.n_elem);
+  }
+
+  for (typename LabelsType::elem_type label : inputLabel)
+    ++labelCounts[label];
+
+  for (arma::uword labelCount : labelCounts)
+    testSize += floor(labelCount * testRatio);
+
+  trainIndices.set_size(numPoints - testSize);
+  testIndices.set_size(testSize);
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  // Each label goes to the test set until the test set has enough of it.
+  size_t trainIdx = 0;
+  size_t testIdx = 0;
+  for (arma::uword i : order)
+  {
+    typename LabelsType::elem_type label = inputLabel[i];
+    if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
+    {
+      testLabelCounts[label] += 1;
+      testIndices[testIdx++] = i;
+    }
+    else
+    {
+      trainIndices[trainIdx++] = i;
+    }
+  }
+}
+
+/**
+ * Split the indices of a dataset with the given number of points into `k`
+ * folds for k-fold cross-validation.  As in KFoldCV, the first `k - 1` folds
+ * have `numPoints / k` points each, and the last fold has the remaining ones.
+ * No points are copied; the training set of fold `i` (every other fold) can be
+ * found with KFoldTrainingIndices().
+ *
+ * @code
+ * std::vector<arma::uvec> folds;
+ * data::KFoldSplitIndices(dataset.n_cols, 5, folds);
+ *
+ * arma::uvec trainIndices;
+ * arma::mat trainData, testData;
+ * for (size_t i = 0; i < folds.size(); ++i)
+ * {
+ *   data::KFoldTrainingIndices(folds, i, trainIndices);
+ *   data::GatherColumns(dataset, trainIndices, trainData);
+ *   data::GatherColumns(dataset, folds[i], testData);
+ *   // Train and evaluate a model...
+ * }
+ * @endcode
+ *
+ * @param numPoints Number of points in the dataset.
+ * @param k Number of folds (at least 2, and at most the number of points).
+ * @param folds Vector to store the indices of each fold into.
+ * @param shuffleData If true, the sample order is shuffled; otherwise, each
+ *     fold is a contiguous range of points. (Default true.)
+ */
+inline void KFoldSplitIndices(const size_t numPoints,
+                              const size_t k,
+                              std::vector<arma::uvec>& folds,
+                              const bool shuffleData = true)
+{
+  if (k < 2 || k > numPoints)
+  {
+    throw std::invalid_argument("data::KFoldSplitIndices(): k must be at "
+        "least 2 and at most the number of points (" +
+        std::to_string(numPoints) + "), but it is " + std::to_string(k) + "!");
+  }
+
+  arma::uvec order = arma::linspace<arma::uvec>(0, numPoints - 1, numPoints);
+  if (shuffleData)
+    order = arma::shuffle(order);
+
+  const size_t binSize = numPoints / k;
+  folds.resize(k);
+  for (size_t i = 0; i < k - 1; ++i)
+    folds[i] = order.subvec(i * binSize, (i + 1) * binSize - 1);
+  folds[k - 1] = order.tail(numPoints - (k - 1) * binSize);
+}
+
+/**
+ * Find the indices of the training set of the given fold of a k-fold split
+ * from KFoldSplitIndices(): the indices of every other fold, in order.
+ *
+ * @param folds Indices of each fold.
+ * @param fold Fold whose points are held out.
+ * @param trainIndices Vector to store the indices of the training set into.
+ */
+inline void KFoldTrainingIndices(const std::vector<arma::uvec>& folds,
+                                 const size_t fold,
+                                 arma::uvec& trainIndices)
+{
+  if (fold >= folds.size())
+  {
+    throw std::invalid_argument("data::KFoldTrainingIndices(): fold " +
+        std::to_string(fold) + " is out of range for a split with " +
+        std::to_string(folds.size()) + " folds!");
+  }
+
+  size_t trainSize = 0;
+  for (size_t i = 0; i < folds.size(); ++i)
+    trainSize += (i == fold) ? 0 : folds[i].n_elem;
+
+  trainIndices.set_size(trainSize);
+  size_t offset = 0;
+  for (size_t i = 0; i < folds.size(); ++i)
+  {
+    if (i == fold || folds[i].is_empty())
+      continue;
+
+    trainIndices.subvec(offset, offset + folds[i].n_elem - 1) = folds[i];
+    offset += folds[i].n_elem;
+  }
+}
+
 /**
  * This helper function splits any `input` data into training and testing parts.
  * In order to shuffle the input data before spliting, an array of shuffled
@@ -43,11 +321,10 @@ void SplitHelper(const InputType& input,
   // Shuffling and splitting simultaneously.
   if (!order.is_empty())
   {
-    if (trainSize > 0)
-      train = input.cols(order.subvec(0, trainSize - 1));
-
-    if (trainSize < input.n_cols)
-      test = input.cols(order.subvec(trainSize, order.n_elem - 1));
+    const arma::uvec trainOrder = order.head(trainSize);
+    const arma::uvec testOrder = order.tail(testSize);
+    GatherColumns(input, trainOrder, train);
+    GatherColumns(input, testOrder, test);
   }
   // Splitting only.
   else
@@ -155,113 +432,21 @@ void StratifiedSplit(const arma::Mat<T>& input,
                      const double testRatio,
                      const bool shuffleData = true)
 {
-  /**
-   * Basic idea:
-   * Let us say we have to stratify a dataset based on labels:
-   * 0 0 0 0 0 (5 0s)
-   * 1 1 1 1 1 1 1 1 1 1 1 (11 1s)
-   *
-   * Let our test ratio be 0.2.
-   * Then, the number of 0 labels in our test set = floor(5 * 0.2) = 1.
-   * The number of 1 labels in our test set = floor(11 * 0.2) = 2.
-   *
-   * In our first pass over the dataset,
-   * We visit each label and keep count of each label in our 'labelCounts' uvec.
-   *
-   * We then take a second pass over the dataset.
-   * We now maintain an additional uvec 'testLabelCounts' to hold the label
-   * counts of our test set.
-   *
-   * In this pass, when we encounter a label we check the 'testLabelCounts' uvec
-   * for the count of this label in the test set.
-   * If this count is less than the required number of labels in the test set,
-   * we add the data to the test set and increment the label count in the uvec.
-   * If this count is equal to or more than the required count in the test set,
-   * we add this data to the train set.
-   *
-   * Based on the above steps, we get the following labels in the split set:
-   * Train set (4 0s, 9 1s)
-   * 0 0 0 0
-   * 1 1 1 1 1 1 1 1 1
-   *
-   * Test set (1 0s, 2 1s)
-   * 0
-   * 1 1
-   */
   const bool typeCheck = (arma::is_Row<LabelsType>::value)
       || (arma::is_Col<LabelsType>::value);
   if (!typeCheck)
     throw std::runtime_error("data::Split(): when stratified sampling is done, "
         "labels must have type `arma::Row<>`!");
   util::CheckSameSizes(input, inputLabel, "data::Split()");
-  size_t trainIdx = 0;
-  size_t testIdx = 0;
-  size_t trainSize = 0;
-  size_t testSize = 0;
-  arma::uvec labelCounts;
-  arma::uvec testLabelCounts;
-  typename LabelsType::elem_type maxLabel = inputLabel.max();
-
-  labelCounts.zeros(maxLabel+1);
-  testLabelCounts.zeros(maxLabel+1);
-
-  for (typename LabelsType::elem_type label : inputLabel)
-    ++labelCounts[label];
-
-  for (arma::uword labelCount : labelCounts)
-  {
-    testSize += floor(labelCount * testRatio);
-    trainSize += labelCount - floor(labelCount * testRatio);
-  }
-
-  trainData.set_size(input.n_rows, trainSize);
-  testData.set_size(input.n_rows, testSize);
-  trainLabel.set_size(inputLabel.n_rows, trainSize);
-  testLabel.set_size(inputLabel.n_rows, testSize);
 
-  if (shuffleData)
-  {
-    arma::uvec order = arma::shuffle(
-        arma::linspace<arma::uvec>(0, input.n_cols - 1, input.n_cols));
+  arma::uvec trainIndices, testIndices;
+  StratifiedSplitIndices(inputLabel, trainIndices, testIndices, testRatio,
+      shuffleData);
 
-    for (arma::uword i : order)
-    {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
-    }
-  }
-  else
-  {
-    for (arma::uword i = 0; i < input.n_cols; i++)
-    {
-      typename LabelsType::elem_type label = inputLabel[i];
-      if (testLabelCounts[label] < floor(labelCounts[label] * testRatio))
-      {
-        testLabelCounts[label] += 1;
-        testData.col(testIdx) = input.col(i);
-        testLabel[testIdx] = inputLabel[i];
-        testIdx += 1;
-      }
-      else
-      {
-        trainData.col(trainIdx) = input.col(i);
-        trainLabel[trainIdx] = inputLabel[i];
-        trainIdx += 1;
-      }
-    }
-  }
+  GatherColumns(input, trainIndices, trainData);
+  GatherColumns(input, testIndices, testData);
+  GatherColumns(inputLabel, trainIndices, trainLabel);
+  GatherColumns(inputLabel, testIndices, testLabel);
 }
 
 /**
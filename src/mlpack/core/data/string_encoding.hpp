@@ -16,6 +16,7 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/data/string_encoding_dictionary.hpp>
 #include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <unordered_set>
 #include <vector>
 
 namespace mlpack {
@@ -26,6 +27,19 @@ namespace data {
  * algorithms. The encoder writes data either in the column-major order or
  * in the row-major order depending on the output data type.
  *
+ * With policies that encode each token from its count in the string (like
+ * BagOfWordsEncodingPolicy and TfIdfEncodingPolicy), a corpus is encoded
+ * into an `arma::SpMat` in parallel, with OpenMP: the strings are split into
+ * chunks, each chunk collects the tokens that are not in the dictionary yet,
+ * and the new tokens of all chunks are then labeled in the order they first
+ * occur, so the labels are the same as when encoding one string at a time.
+ * Then, the dictionary is only read, and the nonzero values of each chunk are
+ * computed and written into the sparse matrix directly.
+ *
+ * Policies that hash the tokens (like HashingEncodingPolicy) do not use the
+ * dictionary; they encode a corpus into an `arma::SpMat` in one parallel
+ * pass.
+ *
  * @tparam EncodingPolicyType Type of the encoding algorithm itself.
  * @tparam DictionaryType Type of the dictionary.
  */
@@ -84,6 +98,20 @@ class StringEncoding
   void CreateMap(const std::string& input,
                  const TokenizerType& tokenizer);
 
+  /**
+   * Add the tokens of all the given strings to the dictionary, in parallel.
+   * The new tokens get the same labels as if `CreateMap()` was called on each
+   * string in order.  The tokenizer is called from several threads at once.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   *
+   * @param input Corpus of text to add to the dictionary.
+   * @param tokenizer The tokenizer object.
+   */
+  template<typename TokenizerType>
+  void CreateMap(const std::vector<std::string>& input,
+                 const TokenizerType& tokenizer);
+
   /**
    * Clear the dictionary.
    */
@@ -201,6 +229,56 @@ class StringEncoding
                     std::enable_if_t<StringEncodingPolicyTraits<
                         PolicyType>::onePassEncoding>* = 0);
 
+  /**
+   * A helper function to encode the given text into a sparse matrix, in
+   * parallel.  This is an optimized overload for policies that compute the
+   * value of each token from its count in the string.  The encoder writes
+   * data in the column-major order.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename TokenizerType, typename PolicyType, typename ElemType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::SpMat<ElemType>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy,
+                    std::enable_if_t<StringEncodingPolicyTraits<
+                        PolicyType>::sparseEncoding>* = 0);
+
+  /**
+   * A helper function to encode the given text into a sparse matrix, in
+   * parallel, with a policy that hashes each token instead of using the
+   * dictionary.  The encoder writes data in the column-major order.
+   *
+   * @tparam TokenizerType Type of the tokenizer.
+   * @tparam PolicyType The type of the encoding policy. It has to be
+   *                    equal to EncodingPolicyType.
+   * @tparam ElemType Type of the output values.
+   *
+   * @param input Corpus of text to encode.
+   * @param output Output matrix to store the result.
+   * @param tokenizer The tokenizer object.
+   * @param policy The policy object.
+   */
+  template<typename TokenizerType, typename PolicyType, typename ElemType>
+  void EncodeHelper(const std::vector<std::string>& input,
+                    arma::SpMat<ElemType>& output,
+                    const TokenizerType& tokenizer,
+                    PolicyType& policy,
+                    std::enable_if_t<StringEncodingPolicyTraits<
+                        PolicyType>::hashingEncoding>* = 0);
+
+  //! The number of strings in each chunk that is processed by one thread.
+  static constexpr size_t ChunkSize = 1024;
+
  private:
   //! The encoding policy object.
   EncodingPolicyType encodingPolicy;
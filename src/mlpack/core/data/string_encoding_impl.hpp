@@ -86,6 +86,60 @@ void StringEncoding<EncodingPolicyType, DictionaryType>::CreateMap(
   }
 }
 
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::CreateMap(
+    const std::vector<std::string>& input,
+    const TokenizerType& tokenizer)
+{
+  using TokenType = std::remove_reference_t<decltype(
+      tokenizer(std::declval<std::string_view&>()))>;
+
+  static_assert(
+      std::is_same_v<TokenType,
+                     std::remove_reference_t<typename DictionaryType::
+                        TokenType>>,
+      "The dictionary token type doesn't match the return value type "
+      "of the tokenizer.");
+
+  // The tokens of each chunk that are not in the dictionary, in the order
+  // they first occur in.  The dictionary is not modified until all chunks are
+  // done.
+  const size_t numChunks = (input.size() + ChunkSize - 1) / ChunkSize;
+  std::vector<std::vector<TokenType>> newTokens(numChunks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    std::unordered_set<TokenType> seen;
+    const size_t end = std::min((c + 1) * ChunkSize, input.size());
+    for (size_t i = c * ChunkSize; i < end; ++i)
+    {
+      std::string_view strView(input[i]);
+      TokenType token = tokenizer(strView);
+
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        if (!dictionary.HasToken(token) && seen.insert(token).second)
+          newTokens[c].push_back(token);
+
+        token = tokenizer(strView);
+      }
+    }
+  }
+
+  // The chunks are in the order of the strings, so this labels the tokens in
+  // the order they first occur in.
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    for (TokenType& token : newTokens[c])
+    {
+      if (!dictionary.HasToken(token))
+        dictionary.AddToken(std::move(token));
+    }
+  }
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename OutputType, typename TokenizerType>
 void StringEncoding<EncodingPolicyType, DictionaryType>::Encode(
@@ -105,6 +159,9 @@ EncodeHelper(const std::vector<std::string>& input,
              const TokenizerType& tokenizer,
              PolicyType& policy)
 {
+  static_assert(!StringEncodingPolicyTraits<PolicyType>::hashingEncoding,
+      "Policies that hash the tokens can only encode into arma::SpMat.");
+
   size_t numColumns = 0;
 
   policy.Reset();
@@ -196,6 +253,192 @@ EncodeHelper(const std::vector<std::string>& input,
   }
 }
 
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType, typename ElemType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             arma::SpMat<ElemType>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy,
+             std::enable_if_t<StringEncodingPolicyTraits<
+                 PolicyType>::sparseEncoding>*)
+{
+  policy.Reset();
+
+  // The first pass adds the extracted tokens to the dictionary; after that,
+  // the dictionary is only read.
+  CreateMap(input, tokenizer);
+
+  // The second pass finds the labels of the tokens of each string, and the
+  // number of times each occurs, in the order of the labels.
+  const size_t numChunks = (input.size() + ChunkSize - 1) / ChunkSize;
+  std::vector<size_t> linesSizes(input.size());
+  std::vector<size_t> linesNonZeros(input.size());
+  std::vector<std::vector<size_t>> chunkRows(numChunks);
+  std::vector<std::vector<size_t>> chunkCounts(numChunks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    std::vector<size_t> labels;
+    const size_t end = std::min((c + 1) * ChunkSize, input.size());
+    for (size_t i = c * ChunkSize; i < end; ++i)
+    {
+      std::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+
+      labels.clear();
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        labels.push_back(dictionary.Value(token));
+        token = tokenizer(strView);
+      }
+
+      std::sort(labels.begin(), labels.end());
+      const size_t previousNonZeros = chunkRows[c].size();
+      for (size_t j = 0; j < labels.size();)
+      {
+        size_t k = j + 1;
+        while (k < labels.size() && labels[k] == labels[j])
+          ++k;
+
+        // The labels are assigned sequentially starting from one.
+        chunkRows[c].push_back(labels[j] - 1);
+        chunkCounts[c].push_back(k - j);
+        j = k;
+      }
+
+      linesSizes[i] = labels.size();
+      linesNonZeros[i] = chunkRows[c].size() - previousNonZeros;
+    }
+  }
+
+  // Count the strings that contain each token.
+  std::vector<size_t> numContainingStrings(dictionary.Size());
+  for (size_t c = 0; c < numChunks; ++c)
+    for (const size_t row : chunkRows[c])
+      ++numContainingStrings[row];
+
+  arma::uvec colPtrs(input.size() + 1);
+  colPtrs[0] = 0;
+  for (size_t i = 0; i < input.size(); ++i)
+    colPtrs[i + 1] = colPtrs[i] + linesNonZeros[i];
+
+  // Now compute the values of each chunk and write them to their place in
+  // the sparse matrix.
+  arma::uvec rowIndices(colPtrs[input.size()]);
+  arma::Col<ElemType> values(colPtrs[input.size()]);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const size_t begin = c * ChunkSize;
+    const size_t end = std::min(begin + ChunkSize, input.size());
+    for (size_t j = colPtrs[begin], pos = 0; j < colPtrs[end]; ++j, ++pos)
+      rowIndices[j] = chunkRows[c][pos];
+
+    for (size_t i = begin, pos = 0; i < end; ++i)
+    {
+      for (size_t j = colPtrs[i]; j < colPtrs[i + 1]; ++j, ++pos)
+      {
+        values[j] = policy.template SparseValue<ElemType>(chunkCounts[c][pos],
+            linesSizes[i], input.size(), numContainingStrings[rowIndices[j]]);
+      }
+    }
+
+    // Release the memory of the chunk as soon as possible.
+    std::vector<size_t>().swap(chunkRows[c]);
+    std::vector<size_t>().swap(chunkCounts[c]);
+  }
+
+  output = arma::SpMat<ElemType>(rowIndices, colPtrs, values,
+      dictionary.Size(), input.size());
+}
+
+template<typename EncodingPolicyType, typename DictionaryType>
+template<typename TokenizerType, typename PolicyType, typename ElemType>
+void StringEncoding<EncodingPolicyType, DictionaryType>::
+EncodeHelper(const std::vector<std::string>& input,
+             arma::SpMat<ElemType>& output,
+             const TokenizerType& tokenizer,
+             PolicyType& policy,
+             std::enable_if_t<StringEncodingPolicyTraits<
+                 PolicyType>::hashingEncoding>*)
+{
+  policy.Reset();
+
+  // Hash the tokens of each string, and sum the values of the tokens that
+  // hash to each dimension, in the order of the dimensions.
+  const size_t numChunks = (input.size() + ChunkSize - 1) / ChunkSize;
+  std::vector<size_t> linesNonZeros(input.size());
+  std::vector<std::vector<std::pair<size_t, ElemType>>> chunkValues(
+      numChunks);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    std::vector<std::pair<size_t, int>> hashes;
+    const size_t end = std::min((c + 1) * ChunkSize, input.size());
+    for (size_t i = c * ChunkSize; i < end; ++i)
+    {
+      std::string_view strView(input[i]);
+      auto token = tokenizer(strView);
+
+      hashes.clear();
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        int sign;
+        const size_t index = policy.Index(token, sign);
+        hashes.emplace_back(index, sign);
+        token = tokenizer(strView);
+      }
+
+      std::sort(hashes.begin(), hashes.end());
+      const size_t previousNonZeros = chunkValues[c].size();
+      for (size_t j = 0; j < hashes.size();)
+      {
+        int sum = 0;
+        size_t k = j;
+        for (; k < hashes.size() && hashes[k].first == hashes[j].first; ++k)
+          sum += hashes[k].second;
+
+        // Tokens with opposite signs may cancel out.
+        if (sum != 0)
+          chunkValues[c].emplace_back(hashes[j].first, (ElemType) sum);
+        j = k;
+      }
+
+      linesNonZeros[i] = chunkValues[c].size() - previousNonZeros;
+    }
+  }
+
+  arma::uvec colPtrs(input.size() + 1);
+  colPtrs[0] = 0;
+  for (size_t i = 0; i < input.size(); ++i)
+    colPtrs[i + 1] = colPtrs[i] + linesNonZeros[i];
+
+  // Write the values of each chunk to their place in the sparse matrix.
+  arma::uvec rowIndices(colPtrs[input.size()]);
+  arma::Col<ElemType> values(colPtrs[input.size()]);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const size_t begin = colPtrs[c * ChunkSize];
+    for (size_t pos = 0; pos < chunkValues[c].size(); ++pos)
+    {
+      rowIndices[begin + pos] = chunkValues[c][pos].first;
+      values[begin + pos] = chunkValues[c][pos].second;
+    }
+
+    // Release the memory of the chunk as soon as possible.
+    std::vector<std::pair<size_t, ElemType>>().swap(chunkValues[c]);
+  }
+
+  output = arma::SpMat<ElemType>(rowIndices, colPtrs, values,
+      policy.Dimensionality(), input.size());
+}
+
 template<typename EncodingPolicyType, typename DictionaryType>
 template<typename Archive>
 void StringEncoding<EncodingPolicyType, DictionaryType>::serialize(
@@ -146,6 +146,28 @@ class BagOfWordsEncodingPolicy
                               size_t /* value */)
   { }
 
+  /**
+   * The function returns the encoded value of a token from the number of
+   * times it occurs in a line.  This is used to encode sparse output in
+   * parallel.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param numOccurrences The number of the token occurrences in the line.
+   * @param * (numTokens) The total number of tokens in the line (not used).
+   * @param * (numLines) The number of lines (not used).
+   * @param * (numContainingLines) The number of lines which contain the
+   *     token (not used).
+   */
+  template<typename ElemType>
+  static ElemType SparseValue(const size_t numOccurrences,
+                              const size_t /* numTokens */,
+                              const size_t /* numLines */,
+                              const size_t /* numContainingLines */)
+  {
+    return numOccurrences;
+  }
+
   /**
    * Serialize the class to the given archive.
    */
@@ -156,6 +178,32 @@ class BagOfWordsEncodingPolicy
   }
 };
 
+/**
+ * The specialization provides some information about the bag of words encoding
+ * policy.
+ */
+template<>
+struct StringEncodingPolicyTraits<BagOfWordsEncodingPolicy>
+{
+  /**
+   * Indicates if the policy is able to encode the token at once without
+   * any information about other tokens as well as the total tokens count.
+   */
+  static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy computes the value of each token from the number
+   * of times it occurs in the string.
+   */
+  static const bool sparseEncoding = true;
+
+  /**
+   * Indicates if the policy hashes each token instead of using the
+   * dictionary.
+   */
+  static const bool hashingEncoding = false;
+};
+
 /**
  * A convenient alias for the StringEncoding class with BagOfWordsEncodingPolicy
  * and the default dictionary for the given token type.
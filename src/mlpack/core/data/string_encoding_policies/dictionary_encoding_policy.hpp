@@ -133,6 +133,18 @@ struct StringEncodingPolicyTraits<DictionaryEncodingPolicy>
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = true;
+
+  /**
+   * Indicates if the policy computes the value of each token from the number
+   * of times it occurs in the string.
+   */
+  static const bool sparseEncoding = false;
+
+  /**
+   * Indicates if the policy hashes each token instead of using the
+   * dictionary.
+   */
+  static const bool hashingEncoding = false;
 };
 
 /**
@@ -0,0 +1,203 @@
+/**
+ * @file core/data/string_encoding_policies/hashing_encoding_policy.hpp
+ *
+ * Definition of the HashingEncodingPolicy class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_STR_ENCODING_POLICIES_HASHING_ENCODING_POLICY_HPP
+#define MLPACK_CORE_DATA_STR_ENCODING_POLICIES_HASHING_ENCODING_POLICY_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/data/string_encoding_policies/policy_traits.hpp>
+#include <mlpack/core/data/string_encoding.hpp>
+
+namespace mlpack {
+namespace data {
+
+/**
+ * Definition of the HashingEncodingPolicy class.
+ *
+ * HashingEncodingPolicy is used as a helper class for StringEncoding.  It
+ * implements the hashing trick: instead of looking up each token in a
+ * dictionary, the encoder hashes the token into one of 2^k dimensions, so
+ * that each dataset item is mapped to a vector of size 2^k whatever the number
+ * of distinct tokens.  The i-th coordinate of the output vector is the number
+ * of occurrences of the tokens that hash to i; with an alternating sign (the
+ * default), each token is counted as +1 or -1, also depending on its hash, so
+ * that collisions cancel out in expectation.
+ *
+ * No dictionary is built (the dictionary of the StringEncoding object stays
+ * empty), so the strings are encoded in a single pass, in parallel, and the
+ * memory taken by the vocabulary does not grow with the data.  The output
+ * must be an `arma::SpMat`, which can be used directly by models with sparse
+ * support, such as `LogisticRegression<arma::sp_mat>` or
+ * `SoftmaxRegression<arma::sp_mat>`.
+ *
+ * The hash is 64-bit FNV-1a followed by the MurmurHash3 finalizer, so the
+ * encoding is the same on every platform.
+ */
+class HashingEncodingPolicy
+{
+ public:
+  /**
+   * Construct the policy with 2^bits output dimensions.
+   *
+   * @param bits Logarithm (base 2) of the number of output dimensions; it must
+   *     be between 1 and 31.
+   * @param alternateSign If true, each token is counted as +1 or -1 depending
+   *     on its hash; otherwise, as +1.
+   */
+  HashingEncodingPolicy(const size_t bits = 20,
+                        const bool alternateSign = true) :
+      bits(bits),
+      alternateSign(alternateSign)
+  {
+    if (bits == 0 || bits > 31)
+    {
+      throw std::invalid_argument("HashingEncodingPolicy::"
+          "HashingEncodingPolicy(): the number of bits must be between 1 and "
+          "31!");
+    }
+  }
+
+  /**
+   * Clear the necessary internal variables.
+   */
+  static void Reset()
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Return the dimension that the given token is hashed to, and set `sign` to
+   * the value that each occurrence of the token adds to it (+1 or -1).
+   *
+   * @param token The token to hash.
+   * @param sign Set to the sign of the token.
+   */
+  size_t Index(const std::string_view token, int& sign) const
+  {
+    return HashIndex(HashBytes(token.data(), token.size()), sign);
+  }
+
+  /**
+   * Return the dimension that the given token (for instance, a character given
+   * by CharExtract) is hashed to, and set `sign` to the value that each
+   * occurrence of the token adds to it (+1 or -1).
+   *
+   * @param token The token to hash.
+   * @param sign Set to the sign of the token.
+   */
+  template<typename TokenType>
+  std::enable_if_t<std::is_integral_v<TokenType>, size_t>
+  Index(const TokenType token, int& sign) const
+  {
+    const uint64_t value = static_cast<uint64_t>(token);
+    unsigned char bytes[sizeof(uint64_t)];
+    for (size_t i = 0; i < sizeof(uint64_t); ++i)
+      bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+
+    return HashIndex(HashBytes(reinterpret_cast<const char*>(bytes),
+        sizeof(uint64_t)), sign);
+  }
+
+  //! Get the number of output dimensions (2^bits).
+  size_t Dimensionality() const { return size_t(1) << bits; }
+
+  //! Get the logarithm (base 2) of the number of output dimensions.
+  size_t Bits() const { return bits; }
+  //! Modify the logarithm (base 2) of the number of output dimensions.
+  size_t& Bits() { return bits; }
+
+  //! Get whether tokens are counted with an alternating sign.
+  bool AlternateSign() const { return alternateSign; }
+  //! Modify whether tokens are counted with an alternating sign.
+  bool& AlternateSign() { return alternateSign; }
+
+  /**
+   * Serialize the class to the given archive.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(bits));
+    ar(CEREAL_NVP(alternateSign));
+  }
+
+ private:
+  //! Return the dimension of the given hash, and set the sign.
+  size_t HashIndex(const uint64_t hash, int& sign) const
+  {
+    // The low bits give the dimension, and the highest bit gives the sign.
+    sign = (alternateSign && (hash >> 63)) ? -1 : 1;
+    return hash & ((uint64_t(1) << bits) - 1);
+  }
+
+  //! Hash the given bytes with FNV-1a, and mix the bits of the result.
+  static uint64_t HashBytes(const char* data, const size_t size)
+  {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; ++i)
+    {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 1099511628211ULL;
+    }
+
+    // The finalizer of MurmurHash3 makes every bit depend on every input bit.
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  //! Logarithm (base 2) of the number of output dimensions.
+  size_t bits;
+  //! Whether tokens are counted with an alternating sign.
+  bool alternateSign;
+};
+
+/**
+ * The specialization provides some information about the hashing encoding
+ * policy.
+ */
+template<>
+struct StringEncodingPolicyTraits<HashingEncodingPolicy>
+{
+  /**
+   * Indicates if the policy is able to encode the token at once without
+   * any information about other tokens as well as the total tokens count.
+   */
+  static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy computes the value of each token from the number
+   * of times it occurs in the string.
+   */
+  static const bool sparseEncoding = false;
+
+  /**
+   * Indicates if the policy hashes each token instead of using the
+   * dictionary.
+   */
+  static const bool hashingEncoding = true;
+};
+
+/**
+ * A convenient alias for the StringEncoding class with HashingEncodingPolicy.
+ * The dictionary is not used.
+ *
+ * @tparam TokenType Type of the tokens.
+ */
+template<typename TokenType>
+using HashingEncoding = StringEncoding<HashingEncodingPolicy,
+                                       StringEncodingDictionary<TokenType>>;
+} // namespace data
+} // namespace mlpack
+
+#endif
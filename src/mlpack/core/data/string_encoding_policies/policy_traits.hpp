@@ -31,6 +31,20 @@ struct StringEncodingPolicyTraits
    * any information about other tokens as well as the total tokens count.
    */
   static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy computes the value of each token from the number
+   * of times it occurs in the string, the number of tokens in the string, the
+   * number of strings, and the number of strings that contain the token (with
+   * `SparseValue()`), so that sparse output can be encoded in parallel.
+   */
+  static const bool sparseEncoding = false;
+
+  /**
+   * Indicates if the policy hashes each token instead of using the
+   * dictionary (with `Index()`), so that no dictionary is built.
+   */
+  static const bool hashingEncoding = false;
 };
 
 } // namespace data
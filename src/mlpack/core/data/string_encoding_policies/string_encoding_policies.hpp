@@ -14,6 +14,7 @@
 
 #include "bag_of_words_encoding_policy.hpp"
 #include "dictionary_encoding_policy.hpp"
+#include "hashing_encoding_policy.hpp"
 #include "tf_idf_encoding_policy.hpp"
 
 #include "policy_traits.hpp"
@@ -217,6 +217,29 @@ class TfIdfEncodingPolicy
     linesSizes[line]++;
   }
 
+  /**
+   * The function returns the tf-idf value of a token from the number of times
+   * it occurs in a line.  This is used to encode sparse output in parallel,
+   * without the statistics of `PreprocessToken()`.
+   *
+   * @tparam ElemType Type of the output values.
+   *
+   * @param numOccurrences The number of the token occurrences in the line.
+   * @param numTokens The total number of tokens in the line.
+   * @param numLines The total number of lines in the input dataset.
+   * @param numContainingLines The number of lines in the input dataset which
+   *     contain the token.
+   */
+  template<typename ElemType>
+  ElemType SparseValue(const size_t numOccurrences,
+                       const size_t numTokens,
+                       const size_t numLines,
+                       const size_t numContainingLines) const
+  {
+    return TermFrequency<ElemType>(numOccurrences, numTokens) *
+        InverseDocumentFrequency<ElemType>(numLines, numContainingLines);
+  }
+
   //! Return token frequencies.
   const std::vector<std::unordered_map<size_t, size_t>>&
       TokensFrequences() const { return tokensFrequences; }
@@ -275,7 +298,7 @@ class TfIdfEncodingPolicy
    */
   template<typename ValueType>
   ValueType TermFrequency(const size_t numOccurrences,
-                          const size_t numTokens)
+                          const size_t numTokens) const
   {
     switch (tfType)
     {
@@ -304,7 +327,7 @@ class TfIdfEncodingPolicy
    */
   template<typename ValueType>
   ValueType InverseDocumentFrequency(const size_t totalNumLines,
-                                     const size_t numOccurrences)
+                                     const size_t numOccurrences) const
   {
     if (smoothIdf)
     {
@@ -334,6 +357,32 @@ class TfIdfEncodingPolicy
   bool smoothIdf;
 };
 
+/**
+ * The specialization provides some information about the tf-idf encoding
+ * policy.
+ */
+template<>
+struct StringEncodingPolicyTraits<TfIdfEncodingPolicy>
+{
+  /**
+   * Indicates if the policy is able to encode the token at once without
+   * any information about other tokens as well as the total tokens count.
+   */
+  static const bool onePassEncoding = false;
+
+  /**
+   * Indicates if the policy computes the value of each token from the number
+   * of times it occurs in the string.
+   */
+  static const bool sparseEncoding = true;
+
+  /**
+   * Indicates if the policy hashes each token instead of using the
+   * dictionary.
+   */
+  static const bool hashingEncoding = false;
+};
+
 /**
  * A convenient alias for the StringEncoding class with TfIdfEncodingPolicy
  * and the default dictionary for the given token type.
@@ -41,8 +41,10 @@ enum struct FileType
               // classes
   HDF5Binary, // HDF5: open binary format, not specific to Armadillo, which can
               // store arbitrary data
-  CoordASCII  // simple co-ordinate format for sparse matrices (indices start at
+  CoordASCII, // simple co-ordinate format for sparse matrices (indices start at
               // zero)
+  ParquetBinary, // Apache Parquet columnar format (needs MLPACK_HAS_ARROW)
+  ArrowBinary    // Apache Arrow IPC (Feather) format (needs MLPACK_HAS_ARROW)
 };
 
 /**
@@ -54,11 +54,24 @@ namespace mlpack {
  *
  * @tparam Power Power of metric; i.e. Power = 1 gives the L1-norm (Manhattan
  *    distance).
+ * The dimensionality of the points can also be fixed at compile time with the
+ * Dim template parameter; for instance, LMetric<2, true, 2> is the Euclidean
+ * distance between 2-dimensional points.  The loops over the dimensions then
+ * have a constant trip count (and are unrolled for small dimensionalities),
+ * and an HRectBound with this metric holds its ranges inline instead of in an
+ * array on the heap; this is much faster for low-dimensional data, such as
+ * geospatial points.  All the points given to the metric must then have Dim
+ * dimensions.
+ *
+ * @tparam Power Power of metric; i.e. Power = 1 gives the L1-norm (Manhattan
+ *    distance).
  * @tparam TakeRoot If true, the Power'th root of the result is taken before it
  *    is returned.  Setting this to false causes the metric to not satisfy the
  *    Triangle Inequality (be careful!).
+ * @tparam Dim Dimensionality of the points, or 0 if it is only known at
+ *    runtime.
  */
-template<int TPower, bool TTakeRoot = true>
+template<int TPower, bool TTakeRoot = true, size_t TDim = 0>
 class LMetric
 {
  public:
@@ -90,6 +103,8 @@ class LMetric
   static const int Power = TPower;
   //! Whether or not the root is taken.
   static const bool TakeRoot = TTakeRoot;
+  //! The dimensionality of the points (0 if it is only known at runtime).
+  static const size_t Dim = TDim;
 };
 
 // Convenience typedefs.
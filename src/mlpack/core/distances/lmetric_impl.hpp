@@ -17,14 +17,42 @@
 
 namespace mlpack {
 
-// Unspecialized implementation.  This should almost never be used...
-template<int Power, bool TakeRoot>
+// Unspecialized implementation.  This is used when the dimensionality is fixed,
+// and otherwise should almost never be used...
+template<int Power, bool TakeRoot, size_t Dim>
 template<typename VecTypeA, typename VecTypeB>
-typename VecTypeA::elem_type LMetric<Power, TakeRoot>::Evaluate(
+typename VecTypeA::elem_type LMetric<Power, TakeRoot, Dim>::Evaluate(
     const VecTypeA& a,
     const VecTypeB& b)
 {
-  typename VecTypeA::elem_type sum = 0;
+  using ElemType = typename VecTypeA::elem_type;
+  if constexpr (Dim > 0)
+  {
+    // With a constant number of iterations, the compiler can unroll this loop,
+    // which is much faster than Armadillo expressions for small vectors.
+    ElemType sum = 0;
+    for (size_t i = 0; i < Dim; ++i)
+    {
+      const ElemType diff = std::abs(a[i] - b[i]);
+      if constexpr (Power == 1)
+        sum += diff;
+      else if constexpr (Power == 2)
+        sum += diff * diff;
+      else if constexpr (Power == INT_MAX)
+        sum = std::max(sum, diff);
+      else
+        sum += std::pow(diff, Power);
+    }
+
+    if constexpr (!TakeRoot || Power == 1 || Power == INT_MAX)
+      return sum;
+    else if constexpr (Power == 2)
+      return std::sqrt(sum);
+    else
+      return std::pow(sum, (1.0 / Power));
+  }
+
+  ElemType sum = 0;
   for (size_t i = 0; i < a.n_elem; ++i)
     sum += std::pow(fabs(a[i] - b[i]), Power);
 
@@ -39,6 +39,9 @@ class DiagonalGaussianDistribution
   static const constexpr ElemType log2pi =
       1.83787706640934533908193770912475883;
 
+  //! Compute sum_j (x_j - mean_j)^2 / cov_j for the k elements of x.
+  ElemType WeightedSquaredDistance(const ElemType* x, const size_t k) const;
+
  public:
   //! Default constructor, which creates a Gaussian with zero dimension.
   DiagonalGaussianDistribution() : logDetCov(0.0) { /* nothing to do. */ }
@@ -94,7 +97,9 @@ class DiagonalGaussianDistribution
 
   /**
    * Calculate the multivariate Gaussian log probability density function for
-   * each data point (column) in the given matrix.
+   * each data point (column) in the given matrix.  Each log probability is
+   * computed in a single (vectorized) pass over its point, without temporary
+   * matrices; large matrices are split over threads with OpenMP.
    *
    * @param observations Matrix of observations.
    * @param logProbabilities Output log probabilities for each observation.
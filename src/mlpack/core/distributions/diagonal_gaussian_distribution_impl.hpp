@@ -50,9 +50,8 @@ DiagonalGaussianDistribution<MatType>::LogProbability(
     const VecType& observation) const
 {
   const size_t k = observation.n_elem;
-  const VecType diff = observation - mean;
-  const VecType logExponent = diff.t() * arma::diagmat(invCov) * diff;
-  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * logExponent(0);
+  return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 *
+      WeightedSquaredDistance(observation.memptr(), k);
 }
 
 template<typename MatType>
@@ -61,16 +60,39 @@ inline void DiagonalGaussianDistribution<MatType>::LogProbability(
     VecType& logProbabilities) const
 {
   const size_t k = observations.n_rows;
+  const size_t n = observations.n_cols;
+  const ElemType logNormalizer = -0.5 * k * log2pi - 0.5 * logDetCov;
+
+  // The log-exponent of each point is computed in one pass over the point,
+  // without any temporary matrix, and the points are split over threads when
+  // there are enough of them.
+  logProbabilities.set_size(n);
+  #pragma omp parallel for schedule(static) if (n * k >= 65536)
+  for (size_t i = 0; i < n; ++i)
+  {
+    logProbabilities[i] = logNormalizer - 0.5 *
+        WeightedSquaredDistance(observations.colptr(i), k);
+  }
+}
 
-  // Column i of 'diffs' is the difference between observations.col(i) and
-  // the mean.
-  MatType diffs = observations.each_col() - mean;
+template<typename MatType>
+inline typename DiagonalGaussianDistribution<MatType>::ElemType
+DiagonalGaussianDistribution<MatType>::WeightedSquaredDistance(
+    const ElemType* x,
+    const size_t k) const
+{
+  const ElemType* m = mean.memptr();
+  const ElemType* w = invCov.memptr();
 
-  // Calculates log of exponent equation in multivariate Gaussian
-  // distribution. We use only diagonal part for faster computation.
-  VecType logExponents = -0.5 * trans(diffs % diffs) * invCov;
+  ElemType sum = 0;
+  #pragma omp simd reduction(+:sum)
+  for (size_t j = 0; j < k; ++j)
+  {
+    const ElemType diff = x[j] - m[j];
+    sum += diff * diff * w[j];
+  }
 
-  logProbabilities = -0.5 * k * log2pi - 0.5 * logDetCov + logExponents;
+  return sum;
 }
 
 template<typename MatType>
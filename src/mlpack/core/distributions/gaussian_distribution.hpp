@@ -14,6 +14,8 @@
 #define MLPACK_CORE_DISTRIBUTIONS_GAUSSIAN_DISTRIBUTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
+#include <mlpack/core/math/covariance_accumulator.hpp>
 
 namespace mlpack {
 
@@ -44,6 +46,9 @@ class GaussianDistribution
   static const constexpr ElemType log2pi =
       1.83787706640934533908193770912475883;
 
+  //! Number of columns processed together by the batch LogProbability().
+  static constexpr size_t logProbabilityBlockSize = 1024;
+
  public:
   /**
    * Default constructor, which creates a Gaussian with zero dimension.
@@ -111,16 +116,28 @@ class GaussianDistribution
    */
   void LogProbability(const MatType& x, VecType& logProbabilities) const
   {
-    // Column i of 'diffs' is the difference between x.col(i) and the mean.
-    MatType diffs = x;
-    diffs.each_col() -= mean;
-
-    // Now, we only want to calculate the diagonal elements of (diffs' * cov^-1
-    // * diffs).  We just don't need any of the other elements.
-    logProbabilities = -0.5 * x.n_rows * log2pi - 0.5 * logDetCov +
-        sum(diffs % (-0.5 * invCov * diffs), 0).t();
+    MatType workspace;
+    LogProbability(x, logProbabilities, workspace);
   }
 
+  /**
+   * Returns the log probability of the given matrix, using the given
+   * workspace for temporary results.  The workspace is resized to twice the
+   * size of x if needed; when the same workspace is given to successive calls
+   * with batches of the same size, no memory is allocated.  The Mahalanobis
+   * terms are computed with a triangular solve against the Cholesky factor of
+   * the covariance, over blocks of columns that are processed in parallel
+   * with OpenMP.
+   *
+   * @param x List of observations.
+   * @param logProbabilities Output log probabilities for each input
+   *     observation.
+   * @param workspace Matrix to use for temporary results.
+   */
+  void LogProbability(const MatType& x,
+                      VecType& logProbabilities,
+                      MatType& workspace) const;
+
   /**
    * Return a randomly generated observation according to the probability
    * distribution defined by this object.
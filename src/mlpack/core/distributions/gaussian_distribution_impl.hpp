@@ -85,6 +85,54 @@ GaussianDistribution<MatType>::LogProbability(const VecType& observation) const
   return -0.5 * k * log2pi - 0.5 * logDetCov - 0.5 * v(0);
 }
 
+template<typename MatType>
+inline void GaussianDistribution<MatType>::LogProbability(
+    const MatType& x,
+    VecType& logProbabilities,
+    MatType& workspace) const
+{
+  const size_t d = x.n_rows;
+  const size_t n = x.n_cols;
+  logProbabilities.set_size(n);
+
+  // The first n columns of the workspace hold the differences between the
+  // points and the mean, and the last n columns hold the whitened differences
+  // L^-1 (x - mean), where cov = L L^T.  Then the Mahalanobis term of each
+  // point is the squared norm of its whitened difference.  (set_size() keeps
+  // the memory if the size does not change.)
+  workspace.set_size(d, 2 * n);
+  const ElemType logNormalizer = -0.5 * d * log2pi - 0.5 * logDetCov;
+
+  const size_t numBlocks = (n + logProbabilityBlockSize - 1) /
+      logProbabilityBlockSize;
+  #pragma omp parallel for schedule(static) if (numBlocks > 1)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * logProbabilityBlockSize;
+    const size_t count = std::min(logProbabilityBlockSize, n - begin);
+
+    MatType diffs, z;
+    MakeAlias(diffs, workspace, d, count, begin * d);
+    MakeAlias(z, workspace, d, count, (n + begin) * d);
+
+    diffs = x.cols(begin, begin + count - 1);
+    diffs.each_col() -= mean;
+
+    // Solve L z = diffs for the whole block at once.
+    arma::solve(z, arma::trimatl(covLower), diffs, arma::solve_opts::fast);
+
+    for (size_t j = 0; j < count; ++j)
+    {
+      const ElemType* zj = z.colptr(j);
+      ElemType sqNorm = 0;
+      for (size_t r = 0; r < d; ++r)
+        sqNorm += zj[r] * zj[r];
+
+      logProbabilities[begin + j] = logNormalizer - 0.5 * sqNorm;
+    }
+  }
+}
+
 template<typename MatType>
 inline typename GaussianDistribution<MatType>::VecType
 GaussianDistribution<MatType>::Random() const
@@ -100,33 +148,18 @@ GaussianDistribution<MatType>::Random() const
 template<typename MatType>
 inline void GaussianDistribution<MatType>::Train(const MatType& observations)
 {
-  if (observations.n_cols > 0)
-  {
-    mean.zeros(observations.n_rows);
-    covariance.zeros(observations.n_rows, observations.n_rows);
-  }
-  else // This will end up just being empty.
+  if (observations.n_cols == 0) // This will end up just being empty.
   {
     Log::Fatal << "Observation columns equal to 0." << std::endl;
   }
 
-  // Calculate the mean.
-  for (size_t i = 0; i < observations.n_cols; ++i)
-    mean += observations.col(i);
-
-  // Normalize the mean.
-  mean /= observations.n_cols;
-
-  // Now calculate the covariance.
-  for (size_t i = 0; i < observations.n_cols; ++i)
-  {
-    VecType obsNoMean = observations.col(i) - mean;
-    covariance += obsNoMean * trans(obsNoMean);
-  }
-
-  // Finish estimating the covariance by normalizing, with the (1 / (n - 1)) so
-  // that it is the unbiased estimator.
-  covariance /= (observations.n_cols - 1);
+  // Calculate the mean and the covariance in one blocked, parallel pass.  The
+  // covariance is normalized with (1 / (n - 1)), so that it is the unbiased
+  // estimator.
+  CovarianceAccumulator<MatType> statistics;
+  statistics.Update(observations);
+  mean = statistics.Mean();
+  covariance = statistics.Covariance();
 
   // Ensure that the covariance is positive definite.
   PositiveDefiniteConstraint::ApplyConstraint(covariance);
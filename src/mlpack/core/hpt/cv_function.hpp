@@ -65,13 +65,30 @@ class CVFunction
              const BoundArgs&... args);
 
   /**
-   * Run cross-validation with the bound and passed parameters.
+   * Run cross-validation with the bound and passed parameters.  If Memoize()
+   * is set and the same parameters were already evaluated, the objective of
+   * that evaluation is returned instead.
    *
    * @param parameters Arguments (rather than the bound arguments) that should
    *     be passed into the Evaluate method of the CVType object.
    */
   double Evaluate(const arma::mat& parameters);
 
+  /**
+   * Run cross-validation with the bound and passed parameters on only part of
+   * the data, with the PartialEvaluate() method of the CVType object.  Unlike
+   * Evaluate(), this can be called from several threads at once (the best
+   * model is updated under a lock); only evaluations with the full budget of 1
+   * can change the best model.  Evaluations are memoized as with Evaluate()
+   * (separately for each budget).
+   *
+   * @param parameters Arguments (rather than the bound arguments) that should
+   *     be passed into the PartialEvaluate method of the CVType object.
+   * @param budget Fraction of the data to evaluate on, in (0, 1] (see the
+   *     PartialEvaluate method of the CVType object).
+   */
+  double PartialEvaluate(const arma::mat& parameters, const double budget);
+
   /**
    * Evaluate numerically the gradient of the CVFunction with the given
    * parameters.
@@ -85,6 +102,18 @@ class CVFunction
   //! Access and modify the best model so far.
   MLAlgorithm& BestModel() { return bestModel; }
 
+  //! Get whether objectives are memoized, so that cross-validation is not run
+  //! again for parameters that were already evaluated.
+  bool Memoize() const { return memoize; }
+  //! Modify whether objectives are memoized (true by default).  Turn this off
+  //! if repeated evaluations of randomized algorithms should be independent.
+  bool& Memoize() { return memoize; }
+
+  //! Get the number of evaluations answered from the memoized objectives.
+  size_t CacheHits() const { return cacheHits; }
+  //! Get the number of evaluations that ran cross-validation.
+  size_t CacheMisses() const { return cacheMisses; }
+
  private:
   //! The type of tuples of BoundArgs.
   using BoundArgsTupleType = std::tuple<BoundArgs...>;
@@ -124,36 +153,72 @@ class CVFunction
   //! Minimum absolute increase of arguments for calculation of gradient.
   double minDelta;
 
+  //! Whether objectives are memoized.
+  bool memoize;
+
+  //! The memoized objectives, keyed on the parameters followed by the budget.
+  std::map<std::vector<double>, double> cache;
+
+  //! The number of evaluations answered from the cache.
+  size_t cacheHits;
+
+  //! The number of evaluations that ran cross-validation.
+  size_t cacheMisses;
+
+  /**
+   * Look up the objective of the given parameters and budget in the cache, and
+   * count the hit or miss.  Returns false if it has not been memoized (or if
+   * Memoize() is not set).
+   */
+  bool LookUp(const arma::mat& parameters,
+              const double budget,
+              double& objective);
+
+  //! Memoize the objective of the given parameters and budget.
+  void Store(const arma::mat& parameters,
+             const double budget,
+             const double objective);
+
   /**
-   * Collect all arguments and run cross-validation.
+   * Collect the next argument, and call the given function with all the
+   * arguments once they are collected.
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename FunctionType,
            typename... Args,
            typename =
                std::enable_if_t<(BoundArgIndex + ParamIndex < TotalArgs)>>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Call(const arma::mat& parameters,
+                     const FunctionType& function,
+                     const Args&... args);
 
   /**
-   * Run cross-validation with the collected arguments.
+   * Call the given function with the collected arguments.
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename FunctionType,
            typename... Args,
            typename =
                std::enable_if_t<BoundArgIndex + ParamIndex == TotalArgs>,
            typename = void>
-  inline double Evaluate(const arma::mat& parameters, const Args&... args);
+  inline double Call(const arma::mat& parameters,
+                     const FunctionType& function,
+                     const Args&... args);
 
   /**
    * Put the bound argument (at the BoundArgIndex position) as the next one.
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename FunctionType,
            typename... Args,
            typename = std::enable_if_t<
                UseBoundArg<BoundArgIndex, ParamIndex>::value>>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           const FunctionType& function,
+                           const Args&... args);
 
   /**
    * Put the element (at the ParamIndex position) of the parameters as the next
@@ -161,11 +226,14 @@ class CVFunction
    */
   template<size_t BoundArgIndex,
            size_t ParamIndex,
+           typename FunctionType,
            typename... Args,
            typename = std::enable_if_t<
                !UseBoundArg<BoundArgIndex, ParamIndex>::value>,
            typename = void>
-  inline double PutNextArg(const arma::mat& parameters, const Args&... args);
+  inline double PutNextArg(const arma::mat& parameters,
+                           const FunctionType& function,
+                           const Args&... args);
 };
 
 
@@ -54,7 +54,10 @@ CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::CVFunction(
     boundArgs(args...),
     bestObjective(std::numeric_limits<double>::max()),
     relativeDelta(relativeDelta),
-    minDelta(minDelta)
+    minDelta(minDelta),
+    memoize(true),
+    cacheHits(0),
+    cacheMisses(0)
 { /* Nothing left to do. */ }
 
 template<typename CVType,
@@ -64,7 +67,65 @@ template<typename CVType,
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
     const arma::mat& parameters)
 {
-  return Evaluate<0, 0>(parameters);
+  double objective;
+  if (LookUp(parameters, 1.0, objective))
+    return objective;
+
+  objective = Call<0, 0>(parameters, [this](const auto&... args)
+  {
+    double objective = cv.Evaluate(args...);
+
+    // Change the best model if we have got a better score, or if we probably
+    // have not assigned any valid (trained) model yet.
+    if (bestObjective > objective ||
+        bestObjective == std::numeric_limits<double>::max())
+    {
+      bestObjective = objective;
+      bestModel = std::move(cv.Model());
+    }
+
+    return objective;
+  });
+
+  Store(parameters, 1.0, objective);
+  return objective;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::
+PartialEvaluate(const arma::mat& parameters, const double budget)
+{
+  double objective;
+  if (LookUp(parameters, budget, objective))
+    return objective;
+
+  objective = Call<0, 0>(parameters, [this, budget](const auto&... args)
+  {
+    std::unique_ptr<MLAlgorithm> model;
+    double objective = cv.PartialEvaluate(budget, model, args...);
+
+    // Only a model trained with the full budget can be the best model.
+    if (budget >= 1.0)
+    {
+      #pragma omp critical(CVFunctionBestModel)
+      {
+        if (bestObjective > objective ||
+            bestObjective == std::numeric_limits<double>::max())
+        {
+          bestObjective = objective;
+          bestModel = std::move(*model);
+        }
+      }
+    }
+
+    return objective;
+  });
+
+  Store(parameters, budget, objective);
+  return objective;
 }
 
 template<typename CVType,
@@ -88,19 +149,78 @@ void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Gradient(
   }
 }
 
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+bool CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::LookUp(
+    const arma::mat& parameters,
+    const double budget,
+    double& objective)
+{
+  if (!memoize)
+  {
+    #pragma omp atomic
+    ++cacheMisses;
+    return false;
+  }
+
+  std::vector<double> key(parameters.begin(), parameters.end());
+  key.push_back(budget);
+
+  bool found = false;
+  #pragma omp critical(CVFunctionCache)
+  {
+    const auto it = cache.find(key);
+    if (it != cache.end())
+    {
+      objective = it->second;
+      found = true;
+      ++cacheHits;
+    }
+    else
+    {
+      ++cacheMisses;
+    }
+  }
+
+  return found;
+}
+
+template<typename CVType,
+         typename MLAlgorithm,
+         size_t TotalArgs,
+         typename... BoundArgs>
+void CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Store(
+    const arma::mat& parameters,
+    const double budget,
+    const double objective)
+{
+  if (!memoize)
+    return;
+
+  std::vector<double> key(parameters.begin(), parameters.end());
+  key.push_back(budget);
+
+  #pragma omp critical(CVFunctionCache)
+  cache[std::move(key)] = objective;
+}
+
 template<typename CVType,
          typename MLAlgorithm,
          size_t TotalArgs,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename FunctionType,
          typename... Args,
          typename>
-double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Call(
     const arma::mat& parameters,
+    const FunctionType& function,
     const Args&... args)
 {
-  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, args...);
+  return PutNextArg<BoundArgIndex, ParamIndex>(parameters, function, args...);
 }
 
 template<typename CVType,
@@ -109,25 +229,16 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename FunctionType,
          typename... Args,
          typename,
          typename>
-double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Evaluate(
+double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::Call(
     const arma::mat& /* parameters */,
+    const FunctionType& function,
     const Args&... args)
 {
-  double objective = cv.Evaluate(args...);
-
-  // Change the best model if we have got a better score, or if we probably
-  // have not assigned any valid (trained) model yet.
-  if (bestObjective > objective ||
-      bestObjective == std::numeric_limits<double>::max())
-  {
-    bestObjective = objective;
-    bestModel = std::move(cv.Model());
-  }
-
-  return objective;
+  return function(args...);
 }
 
 template<typename CVType,
@@ -136,14 +247,16 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename FunctionType,
          typename... Args,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    const FunctionType& function,
     const Args&... args)
 {
-  return Evaluate<BoundArgIndex + 1, ParamIndex>(
-      parameters, args..., std::get<BoundArgIndex>(boundArgs).value);
+  return Call<BoundArgIndex + 1, ParamIndex>(parameters, function, args...,
+      std::get<BoundArgIndex>(boundArgs).value);
 }
 
 template<typename CVType,
@@ -152,21 +265,23 @@ template<typename CVType,
          typename... BoundArgs>
 template<size_t BoundArgIndex,
          size_t ParamIndex,
+         typename FunctionType,
          typename... Args,
          typename,
          typename>
 double CVFunction<CVType, MLAlgorithm, TotalArgs, BoundArgs...>::PutNextArg(
     const arma::mat& parameters,
+    const FunctionType& function,
     const Args&... args)
 {
   if (datasetInfo.Type(ParamIndex) == data::Datatype::categorical)
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
+    return Call<BoundArgIndex, ParamIndex + 1>(parameters, function, args...,
         datasetInfo.UnmapString(size_t(parameters(ParamIndex, 0)), ParamIndex));
   }
   else
   {
-    return Evaluate<BoundArgIndex, ParamIndex + 1>(parameters, args...,
+    return Call<BoundArgIndex, ParamIndex + 1>(parameters, function, args...,
         parameters(ParamIndex, 0));
   }
 }
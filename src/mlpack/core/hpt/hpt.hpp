@@ -15,6 +15,8 @@
 #include <mlpack/core/cv/meta_info_extractor.hpp>
 #include <mlpack/core/hpt/deduce_hp_types.hpp>
 #include <mlpack/core/hpt/cv_function.hpp>
+#include <mlpack/core/hpt/parallel_grid_search.hpp>
+#include <mlpack/core/hpt/successive_halving.hpp>
 #include <ensmallen.hpp>
 
 namespace mlpack {
@@ -71,8 +73,9 @@ namespace mlpack {
  * @tparam Metric A metric to assess the quality of a trained model.
  * @tparam CV A cross-validation strategy used to assess a set of
  *     hyper-parameters.
- * @tparam OptimizerType An optimization strategy (GridSearch and
- *     GradientDescent are supported).
+ * @tparam OptimizerType An optimization strategy (GridSearch,
+ *     ParallelGridSearch, SuccessiveHalving and GradientDescent are
+ *     supported).
  * @tparam MatType The type of data.
  * @tparam PredictionsType The type of predictions (should be passed when the
  *     predictions type is a template parameter in Train methods of the given
@@ -150,6 +153,31 @@ class HyperParameterTuner
    */
   double& MinDelta() { return minDelta; }
 
+  /**
+   * Get whether the objective of each set of hyper-parameters is memoized
+   * during Optimize(), so that cross-validation is not run again when the
+   * optimizer revisits the same values (as gradient-based optimizers do).
+   *
+   * The default value is true.
+   */
+  bool Memoize() const { return memoize; }
+
+  /**
+   * Modify whether the objective of each set of hyper-parameters is memoized
+   * during Optimize().  Turn this off if repeated evaluations of a randomized
+   * algorithm should be independent.
+   *
+   * The default value is true.
+   */
+  bool& Memoize() { return memoize; }
+
+  //! Get the number of evaluations of the last run that were answered from the
+  //! memoized objectives.
+  size_t CacheHits() const { return cacheHits; }
+
+  //! Get the number of evaluations of the last run that ran cross-validation.
+  size_t CacheMisses() const { return cacheMisses; }
+
   /**
    * Find the best hyper-parameters by using the given Optimizer. For each
    * hyper-parameter one of the following should be passed as an argument.
@@ -228,6 +256,15 @@ class HyperParameterTuner
    */
   double minDelta;
 
+  //! Whether objectives are memoized during Optimize().
+  bool memoize;
+
+  //! The number of evaluations of the last run answered from the cache.
+  size_t cacheHits;
+
+  //! The number of evaluations of the last run that ran cross-validation.
+  size_t cacheMisses;
+
   /**
    * A type function to check whether the element I of the tuple type is a
    * PreFixedArg.
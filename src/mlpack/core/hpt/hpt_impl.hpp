@@ -31,7 +31,12 @@ HyperParameterTuner<MLAlgorithm,
                     MatType,
                     PredictionsType,
                     WeightsType>::HyperParameterTuner(const CVArgs&... args) :
-    cv(args...), relativeDelta(0.01), minDelta(1e-10) {}
+    cv(args...),
+    relativeDelta(0.01),
+    minDelta(1e-10),
+    memoize(true),
+    cacheHits(0),
+    cacheMisses(0) {}
 
 template<typename MLAlgorithm,
          typename Metric,
@@ -103,11 +108,18 @@ void HyperParameterTuner<MLAlgorithm,
 
   CVFunction<CVType, MLAlgorithm, totalArgs, FixedArgs...>
       cvFunction(cv, datasetInfo, relativeDelta, minDelta, fixedArgs...);
+  cvFunction.Memoize() = memoize;
   bestObjective = Metric::NeedsMinimization ? optimizer.Optimize(cvFunction,
       bestParams, categoricalDimensions, numCategories) :
       -optimizer.Optimize(cvFunction, bestParams, categoricalDimensions,
       numCategories);
-      bestModel = std::move(cvFunction.BestModel());
+  bestModel = std::move(cvFunction.BestModel());
+  cacheHits = cvFunction.CacheHits();
+  cacheMisses = cvFunction.CacheMisses();
+
+  Log::Info << "HyperParameterTuner::Optimize(): " << cacheHits << " of "
+      << (cacheHits + cacheMisses) << " evaluations were memoized."
+      << std::endl;
 }
 
 template<typename MLAlgorithm,
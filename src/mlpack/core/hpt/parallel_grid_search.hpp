@@ -0,0 +1,114 @@
+/**
+ * @file core/hpt/parallel_grid_search.hpp
+ *
+ * A grid search optimizer for HyperParameterTuner that evaluates the points of
+ * the grid in parallel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_PARALLEL_GRID_SEARCH_HPP
+#define MLPACK_CORE_HPT_PARALLEL_GRID_SEARCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * ParallelGridSearch is a drop-in replacement for ens::GridSearch as the
+ * optimizer of HyperParameterTuner: it tries every combination of the values
+ * of the hyper-parameters, and returns the best one (the first one, in the
+ * order of ens::GridSearch, if several are equally good), but the combinations
+ * are evaluated in parallel with OpenMP.
+ *
+ * The function to optimize must have the PartialEvaluate(parameters, budget)
+ * method of CVFunction, which can be called from several threads at once.
+ * Each combination is evaluated with its own seed for the random number
+ * generators, so the result does not depend on the number of threads.
+ *
+ * @code
+ * HyperParameterTuner<LinearRegression, MSE, KFoldCV, ParallelGridSearch>
+ *     hpt(5, data, responses);
+ * hpt.Optimizer().Threads() = 4;
+ * double bestLambda;
+ * std::tie(bestLambda) = hpt.Optimize(arma::vec("0.0 0.01 0.1 1.0"));
+ * @endcode
+ */
+class ParallelGridSearch
+{
+ public:
+  /**
+   * Create the optimizer.
+   *
+   * @param threads Number of combinations to evaluate at once; 0 means the
+   *     maximum number of OpenMP threads.
+   */
+  ParallelGridSearch(const size_t threads = 0) : threads(threads) { }
+
+  /**
+   * Find the best combination of the values of the hyper-parameters, and
+   * return its objective.
+   *
+   * @param function Function to optimize (a CVFunction).
+   * @param bestParameters Matrix to store the best combination in.
+   * @param categoricalDimensions Whether each dimension is categorical; all of
+   *     them must be.
+   * @param numCategories Number of values of each dimension.
+   */
+  template<typename FunctionType, typename MatType>
+  double Optimize(FunctionType& function,
+                  MatType& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the number of combinations to evaluate at once.
+  size_t Threads() const { return threads; }
+  //! Modify the number of combinations to evaluate at once.
+  size_t& Threads() { return threads; }
+
+  /**
+   * Store every combination of the values of the hyper-parameters as a column
+   * of the given matrix, in the order of ens::GridSearch (the last dimension
+   * changes fastest).  Also used by SuccessiveHalving.
+   *
+   * @param categoricalDimensions Whether each dimension is categorical; all of
+   *     them must be.
+   * @param numCategories Number of values of each dimension.
+   * @param grid Matrix to store the combinations in.
+   */
+  static void Grid(const std::vector<bool>& categoricalDimensions,
+                   const arma::Row<size_t>& numCategories,
+                   arma::mat& grid);
+
+  /**
+   * Evaluate the function with the given budget on each column of the given
+   * matrix, in parallel.  A NaN objective is stored as DBL_MAX.  Also used by
+   * SuccessiveHalving.
+   *
+   * @param function Function to evaluate (a CVFunction).
+   * @param configurations Combinations to evaluate, one per column.
+   * @param budget Budget to pass to PartialEvaluate().
+   * @param threads Number of combinations to evaluate at once; 0 means the
+   *     maximum number of OpenMP threads.
+   * @param objectives Vector to store the objectives in.
+   */
+  template<typename FunctionType>
+  static void EvaluateAll(FunctionType& function,
+                          const arma::mat& configurations,
+                          const double budget,
+                          const size_t threads,
+                          arma::vec& objectives);
+
+ private:
+  //! The number of combinations to evaluate at once.
+  size_t threads;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "parallel_grid_search_impl.hpp"
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file core/hpt/parallel_grid_search_impl.hpp
+ *
+ * Implementation of ParallelGridSearch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_PARALLEL_GRID_SEARCH_IMPL_HPP
+#define MLPACK_CORE_HPT_PARALLEL_GRID_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "parallel_grid_search.hpp"
+
+namespace mlpack {
+
+template<typename FunctionType, typename MatType>
+double ParallelGridSearch::Optimize(
+    FunctionType& function,
+    MatType& bestParameters,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  arma::mat grid;
+  Grid(categoricalDimensions, numCategories, grid);
+
+  arma::vec objectives;
+  EvaluateAll(function, grid, 1.0, threads, objectives);
+
+  // index_min() returns the first of equal minima.
+  const size_t best = objectives.index_min();
+  bestParameters = arma::conv_to<MatType>::from(grid.col(best));
+  return objectives[best];
+}
+
+inline void ParallelGridSearch::Grid(
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories,
+    arma::mat& grid)
+{
+  if (categoricalDimensions.size() != numCategories.n_elem)
+  {
+    throw std::invalid_argument("ParallelGridSearch::Grid(): the sizes of "
+        "categoricalDimensions and numCategories do not match");
+  }
+
+  size_t points = 1;
+  for (size_t d = 0; d < numCategories.n_elem; ++d)
+  {
+    if (!categoricalDimensions[d])
+    {
+      throw std::invalid_argument("ParallelGridSearch::Grid(): all "
+          "dimensions must be categorical");
+    }
+    points *= numCategories[d];
+  }
+
+  grid.set_size(numCategories.n_elem, points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    // Decompose i in mixed radix, with the last dimension as the lowest digit.
+    size_t rest = i;
+    for (size_t d = numCategories.n_elem; d > 0; --d)
+    {
+      grid(d - 1, i) = (double) (rest % numCategories[d - 1]);
+      rest /= numCategories[d - 1];
+    }
+  }
+}
+
+template<typename FunctionType>
+void ParallelGridSearch::EvaluateAll(FunctionType& function,
+                                     const arma::mat& configurations,
+                                     const double budget,
+                                     const size_t threads,
+                                     arma::vec& objectives)
+{
+  objectives.set_size(configurations.n_cols);
+
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) configurations.n_cols, (threads == 0) ?
+      (size_t) omp_get_max_threads() : threads));
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  // Every configuration is evaluated with its own seed, so that the results
+  // do not depend on the number of threads or on the schedule.
+  const size_t seed = RandGen()();
+  std::exception_ptr error;
+
+  #pragma omp parallel for num_threads(numThreads) schedule(dynamic)
+  for (size_t i = 0; i < configurations.n_cols; ++i)
+  {
+    // Each configuration gets its own team, so that OpenMP loops inside the
+    // training are not split between the threads that run different ones.
+    #pragma omp parallel num_threads(1)
+    {
+      try
+      {
+        RandGen().seed((uint32_t) (seed + i));
+        arma::arma_rng::set_seed(seed + i);
+
+        const double objective = function.PartialEvaluate(
+            configurations.col(i), budget);
+        objectives[i] = std::isnan(objective) ?
+            std::numeric_limits<double>::max() : objective;
+      }
+      catch (...)
+      {
+        #pragma omp critical
+        {
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+    }
+  }
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file core/hpt/successive_halving.hpp
+ *
+ * An early-stopping optimizer for HyperParameterTuner that evaluates every
+ * candidate cheaply first, and spends the full budget only on the best ones.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "parallel_grid_search.hpp"
+
+namespace mlpack {
+
+/**
+ * SuccessiveHalving searches the same grid of values of the hyper-parameters
+ * as ens::GridSearch, but with early stopping: all combinations are first
+ * evaluated with a small budget (e.g. only the first folds of KFoldCV, or only
+ * part of the training set of SimpleCV), then only the best 1 / eta of them
+ * are evaluated again with a budget eta times larger, and so on, until the
+ * survivors are evaluated with the full budget.  The best of those is
+ * returned.  This is much cheaper than a full grid search on large grids, but
+ * may miss the best combination if the small budgets are too noisy.
+ *
+ * The combinations of each round are evaluated in parallel, as with
+ * ParallelGridSearch; the function to optimize must have the
+ * PartialEvaluate(parameters, budget) method of CVFunction.
+ *
+ * @code
+ * HyperParameterTuner<LinearRegression, MSE, KFoldCV, SuccessiveHalving>
+ *     hpt(10, data, responses);
+ * // Start with one fold of ten, and keep the best quarter in each round.
+ * hpt.Optimizer().MinBudget() = 0.1;
+ * hpt.Optimizer().Eta() = 4;
+ * double bestLambda;
+ * std::tie(bestLambda) = hpt.Optimize(arma::regspace<arma::vec>(0, 0.1, 5));
+ * @endcode
+ */
+class SuccessiveHalving
+{
+ public:
+  /**
+   * Create the optimizer.
+   *
+   * @param minBudget Budget of the first round, in (0, 1].
+   * @param eta Factor by which the number of combinations shrinks, and the
+   *     budget grows, in each round; must be greater than 1.
+   * @param threads Number of combinations to evaluate at once; 0 means the
+   *     maximum number of OpenMP threads.
+   */
+  SuccessiveHalving(const double minBudget = 0.1,
+                    const double eta = 3.0,
+                    const size_t threads = 0) :
+      minBudget(minBudget),
+      eta(eta),
+      threads(threads)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Find the best combination of the values of the hyper-parameters, and
+   * return its objective (with the full budget).
+   *
+   * @param function Function to optimize (a CVFunction).
+   * @param bestParameters Matrix to store the best combination in.
+   * @param categoricalDimensions Whether each dimension is categorical; all of
+   *     them must be.
+   * @param numCategories Number of values of each dimension.
+   */
+  template<typename FunctionType, typename MatType>
+  double Optimize(FunctionType& function,
+                  MatType& bestParameters,
+                  const std::vector<bool>& categoricalDimensions,
+                  const arma::Row<size_t>& numCategories);
+
+  //! Get the budget of the first round.
+  double MinBudget() const { return minBudget; }
+  //! Modify the budget of the first round.
+  double& MinBudget() { return minBudget; }
+
+  //! Get the factor by which the combinations shrink in each round.
+  double Eta() const { return eta; }
+  //! Modify the factor by which the combinations shrink in each round.
+  double& Eta() { return eta; }
+
+  //! Get the number of combinations to evaluate at once.
+  size_t Threads() const { return threads; }
+  //! Modify the number of combinations to evaluate at once.
+  size_t& Threads() { return threads; }
+
+ private:
+  //! The budget of the first round.
+  double minBudget;
+  //! The factor by which the combinations shrink in each round.
+  double eta;
+  //! The number of combinations to evaluate at once.
+  size_t threads;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "successive_halving_impl.hpp"
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * @file core/hpt/successive_halving_impl.hpp
+ *
+ * Implementation of SuccessiveHalving.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+#define MLPACK_CORE_HPT_SUCCESSIVE_HALVING_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "successive_halving.hpp"
+
+namespace mlpack {
+
+template<typename FunctionType, typename MatType>
+double SuccessiveHalving::Optimize(
+    FunctionType& function,
+    MatType& bestParameters,
+    const std::vector<bool>& categoricalDimensions,
+    const arma::Row<size_t>& numCategories)
+{
+  if (!(minBudget > 0.0 && minBudget <= 1.0))
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): the minimum "
+        "budget must be in (0, 1]");
+  }
+
+  if (!(eta > 1.0))
+  {
+    throw std::invalid_argument("SuccessiveHalving::Optimize(): eta must be "
+        "greater than 1");
+  }
+
+  arma::mat configurations;
+  ParallelGridSearch::Grid(categoricalDimensions, numCategories,
+      configurations);
+
+  arma::vec objectives;
+  double budget = minBudget;
+  while (budget < 1.0 && configurations.n_cols > 1)
+  {
+    ParallelGridSearch::EvaluateAll(function, configurations, budget, threads,
+        objectives);
+
+    // Keep the best combinations, in their original order, so that ties are
+    // still broken as by ens::GridSearch.
+    const size_t survivors = std::max((size_t) 1,
+        (size_t) std::ceil(configurations.n_cols / eta));
+    const arma::uvec order = arma::stable_sort_index(objectives);
+    const arma::uvec kept = arma::sort(order.head(survivors));
+    configurations = arma::mat(configurations.cols(kept));
+
+    Log::Info << "SuccessiveHalving::Optimize(): kept " << survivors
+        << " combinations after evaluating with budget " << budget << "."
+        << std::endl;
+
+    budget = std::min(1.0, budget * eta);
+  }
+
+  ParallelGridSearch::EvaluateAll(function, configurations, 1.0, threads,
+      objectives);
+
+  // index_min() returns the first of equal minima.
+  const size_t best = objectives.index_min();
+  bestParameters = arma::conv_to<MatType>::from(configurations.col(best));
+  return objectives[best];
+}
+
+} // namespace mlpack
+
+#endif
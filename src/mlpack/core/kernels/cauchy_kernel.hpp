@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_CAUCHY_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 #include <mlpack/core/distances/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
 
@@ -67,6 +68,19 @@ class CauchyKernel
         std::pow(EuclideanDistance::Evaluate(a, b) / bandwidth, 2)));
   }
 
+  /**
+   * Evaluate the Cauchy kernel between every column of a and every column of
+   * b, with the squared distances computed by a matrix product.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    SquaredDistanceBlock(a, b, out);
+    out = 1.0 / (1.0 + out / (bandwidth * bandwidth));
+  }
+
   /**
    * Serialize the kernel.
    */
@@ -15,6 +15,7 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 
 namespace mlpack {
 
@@ -40,6 +41,20 @@ class CosineSimilarity
   template<typename VecTypeA, typename VecTypeB>
   static double Evaluate(const VecTypeA& a, const VecTypeB& b);
 
+  /**
+   * Computes the cosine similarity between every column of a and every column
+   * of b, with one matrix product for all the dot products; as in Evaluate(),
+   * the similarity with a zero vector is 0.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the a.n_cols x b.n_cols similarities in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void EvaluateBlock(const MatTypeA& a,
+                            const MatTypeB& b,
+                            arma::mat& out);
+
   //! Serialize the class (there's nothing to save).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
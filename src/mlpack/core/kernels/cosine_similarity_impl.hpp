@@ -31,6 +31,26 @@ double CosineSimilarity::Evaluate(const VecTypeA& a, const VecTypeB& b)
     return dot(a, b) / denominator;
 }
 
+template<typename MatTypeA, typename MatTypeB>
+void CosineSimilarity::EvaluateBlock(const MatTypeA& a,
+                                     const MatTypeB& b,
+                                     arma::mat& out)
+{
+  InnerProductBlock(a, b, out);
+
+  // Zero norms are replaced by 1, since the dot products with a zero vector
+  // are already 0.
+  arma::vec aNorms = arma::conv_to<arma::vec>::from(
+      arma::sqrt(arma::sum(arma::square(a), 0)).t());
+  arma::rowvec bNorms = arma::conv_to<arma::rowvec>::from(
+      arma::sqrt(arma::sum(arma::square(b), 0)));
+  aNorms.replace(0.0, 1.0);
+  bNorms.replace(0.0, 1.0);
+
+  out.each_col() /= aNorms;
+  out.each_row() /= bNorms;
+}
+
 } // namespace mlpack
 
 #endif
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_EPANECHNIKOV_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
 
 namespace mlpack {
@@ -50,6 +51,19 @@ class EpanechnikovKernel
   template<typename VecTypeA, typename VecTypeB>
   double Evaluate(const VecTypeA& a, const VecTypeB& b) const;
 
+  /**
+   * Evaluate the Epanechnikov kernel between every column of a and every
+   * column of b, with the squared distances computed by a matrix product.
+   *
+   * @param a First set of points.
+   * @param b Second set of points.
+   * @param out Matrix to store the a.n_cols x b.n_cols kernel values in.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const;
+
   /**
    * Evaluate the Epanechnikov kernel given that the distance between the two
    * input points is known.
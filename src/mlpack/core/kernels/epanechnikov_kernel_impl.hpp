@@ -40,6 +40,15 @@ inline double EpanechnikovKernel::Normalizer(const size_t dimension)
       (std::tgamma(dimension / 2.0 + 1.0) * (dimension + 2.0));
 }
 
+template<typename MatTypeA, typename MatTypeB>
+inline void EpanechnikovKernel::EvaluateBlock(const MatTypeA& a,
+                                              const MatTypeB& b,
+                                              arma::mat& out) const
+{
+  SquaredDistanceBlock(a, b, out);
+  out = arma::clamp(1.0 - out * inverseBandwidthSquared, 0.0, DBL_MAX);
+}
+
 /**
  * Evaluate the kernel not for two points but for a numerical value.
  */
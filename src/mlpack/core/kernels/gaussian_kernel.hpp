@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_GAUSSIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 #include <mlpack/core/distances/lmetric.hpp>
 #include <mlpack/core/kernels/kernel_traits.hpp>
 
@@ -67,6 +68,20 @@ class GaussianKernel
     return std::exp(gamma * SquaredEuclideanDistance::Evaluate(a, b));
   }
 
+  /**
+   * Evaluate the Gaussian kernel between every column of a and every column
+   * of b, with the squared distances computed by a matrix product (see
+   * SquaredDistanceBlock()).
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    SquaredDistanceBlock(a, b, out);
+    out = arma::exp(gamma * out);
+  }
+
   /**
    * Evaluation of the Gaussian kernel given the distance between two points.
    *
@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_HYPERBOLIC_TANGENT_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 
 namespace mlpack {
 
@@ -61,6 +62,20 @@ class HyperbolicTangentKernel
     return tanh(scale * dot(a, b) + offset);
   }
 
+  /**
+   * Evaluate the hyperbolic tangent kernel between every column of a and
+   * every column of b, with all the dot products computed by one matrix
+   * product.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    InnerProductBlock(a, b, out);
+    out = arma::tanh(scale * out + offset);
+  }
+
   //! Get scale factor.
   double Scale() const { return scale; }
   //! Modify scale factor.
@@ -0,0 +1,116 @@
+/**
+ * @file core/kernels/kernel_block.hpp
+ *
+ * Evaluation of a kernel between every pair of points of two sets at once, and
+ * the matrix products that the EvaluateBlock() methods of the kernels are built
+ * on.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_KERNELS_KERNEL_BLOCK_HPP
+#define MLPACK_CORE_KERNELS_KERNEL_BLOCK_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_traits.hpp>
+
+namespace mlpack {
+
+/**
+ * Compute out(i, j) = a_i^T b_j for every column a_i of a and b_j of b, with a
+ * single matrix product.
+ */
+template<typename MatTypeA, typename MatTypeB>
+inline void InnerProductBlock(const MatTypeA& a,
+                              const MatTypeB& b,
+                              arma::mat& out)
+{
+  out = arma::conv_to<arma::mat>::from(a.t() * b);
+}
+
+/**
+ * Compute out(i, j) = || a_i - b_j ||^2 for every column a_i of a and b_j of b,
+ * as || a_i ||^2 + || b_j ||^2 - 2 a_i^T b_j, with a single matrix product.
+ * Negative results of rounding errors are set to 0.
+ */
+template<typename MatTypeA, typename MatTypeB>
+inline void SquaredDistanceBlock(const MatTypeA& a,
+                                 const MatTypeB& b,
+                                 arma::mat& out)
+{
+  InnerProductBlock(a, b, out);
+  out *= -2.0;
+  out.each_col() += arma::conv_to<arma::vec>::from(
+      arma::sum(arma::square(a), 0).t());
+  out.each_row() += arma::conv_to<arma::rowvec>::from(
+      arma::sum(arma::square(b), 0));
+  out.clamp(0.0, DBL_MAX);
+}
+
+/**
+ * Compute out(i, j) = K(a_i, b_j) for every column a_i of a and b_j of b.  If
+ * the kernel has an EvaluateBlock() method (see HasEvaluateBlock) and the
+ * matrices are dense, it is used; otherwise the kernel is evaluated on each
+ * pair of points, in parallel.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a First set of points.
+ * @param b Second set of points.
+ * @param out Matrix to store the a.n_cols x b.n_cols kernel values in.
+ */
+template<typename KernelType, typename MatTypeA, typename MatTypeB>
+void KernelBlock(KernelType& kernel,
+                 const MatTypeA& a,
+                 const MatTypeB& b,
+                 arma::mat& out)
+{
+  if constexpr (HasEvaluateBlock<KernelType>::value &&
+      !arma::is_arma_sparse_type<MatTypeA>::value &&
+      !arma::is_arma_sparse_type<MatTypeB>::value)
+  {
+    kernel.EvaluateBlock(a, b, out);
+  }
+  else
+  {
+    out.set_size(a.n_cols, b.n_cols);
+    #pragma omp parallel for
+    for (size_t j = 0; j < (size_t) b.n_cols; ++j)
+      for (size_t i = 0; i < (size_t) a.n_cols; ++i)
+        out(i, j) = kernel.Evaluate(a.col(i), b.col(j));
+  }
+}
+
+/**
+ * Compute the kernel matrix out(i, j) = K(a_i, a_j) of a set of points, as
+ * KernelBlock(kernel, a, a, out) does; when the kernel is evaluated on each
+ * pair of points, only the upper triangular part is evaluated.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param a Set of points.
+ * @param out Matrix to store the a.n_cols x a.n_cols kernel matrix in.
+ */
+template<typename KernelType, typename MatType>
+void KernelBlock(KernelType& kernel, const MatType& a, arma::mat& out)
+{
+  if constexpr (HasEvaluateBlock<KernelType>::value &&
+      !arma::is_arma_sparse_type<MatType>::value)
+  {
+    kernel.EvaluateBlock(a, a, out);
+  }
+  else
+  {
+    out.set_size(a.n_cols, a.n_cols);
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t j = 0; j < (size_t) a.n_cols; ++j)
+      for (size_t i = 0; i <= j; ++i)
+        out(i, j) = kernel.Evaluate(a.col(i), a.col(j));
+
+    out = arma::symmatu(out);
+  }
+}
+
+} // namespace mlpack
+
+#endif
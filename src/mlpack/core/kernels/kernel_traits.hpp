@@ -13,6 +13,8 @@
 #ifndef MLPACK_CORE_KERNELS_KERNEL_TRAITS_HPP
 #define MLPACK_CORE_KERNELS_KERNEL_TRAITS_HPP
 
+#include <mlpack/prereqs.hpp>
+
 namespace mlpack {
 
 /**
@@ -37,6 +39,27 @@ class KernelTraits
   static const bool UsesSquaredDistance = false;
 };
 
+/**
+ * HasEvaluateBlock<KernelType>::value is true if the kernel has a method
+ *
+ * @code
+ * void EvaluateBlock(const MatTypeA& a, const MatTypeB& b, arma::mat& out);
+ * @endcode
+ *
+ * that computes out(i, j) = K(a_i, b_j) for every column a_i of a and b_j of b
+ * at once (typically with a matrix product), for dense matrices.  KernelBlock()
+ * uses that method when it is available, and evaluates the kernel on each pair
+ * of points otherwise.
+ */
+template<typename KernelType, typename = void>
+struct HasEvaluateBlock : std::false_type { };
+
+template<typename KernelType>
+struct HasEvaluateBlock<KernelType, std::void_t<decltype(
+    std::declval<KernelType&>().EvaluateBlock(std::declval<const arma::mat&>(),
+        std::declval<const arma::mat&>(), std::declval<arma::mat&>()))>> :
+    std::true_type { };
+
 } // namespace mlpack
 
 #endif
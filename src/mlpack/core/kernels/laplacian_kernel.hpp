@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_LAPLACIAN_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 
 namespace mlpack {
 
@@ -55,6 +56,19 @@ class LaplacianKernel
     return std::exp(-EuclideanDistance::Evaluate(a, b) / bandwidth);
   }
 
+  /**
+   * Evaluate the Laplacian kernel between every column of a and every column
+   * of b, with the distances computed by a matrix product.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    SquaredDistanceBlock(a, b, out);
+    out = arma::exp(-arma::sqrt(out) / bandwidth);
+  }
+
   /**
    * Evaluation of the Laplacian kernel given the distance between two points.
    *
@@ -15,6 +15,7 @@
 #define MLPACK_CORE_KERNELS_LINEAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 
 namespace mlpack {
 
@@ -54,6 +55,18 @@ class LinearKernel
     return dot(a, b);
   }
 
+  /**
+   * Compute the dot product of every column of a with every column of b, as
+   * one matrix product.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  static void EvaluateBlock(const MatTypeA& a,
+                            const MatTypeB& b,
+                            arma::mat& out)
+  {
+    InnerProductBlock(a, b, out);
+  }
+
   //! Serialize the kernel (it has no members... do nothing).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
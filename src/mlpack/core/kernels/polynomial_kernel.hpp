@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_POLYNOMIAL_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 
 namespace mlpack {
 
@@ -56,6 +57,19 @@ class PolynomialKernel
     return std::pow((dot(a, b) + offset), degree);
   }
 
+  /**
+   * Evaluate the polynomial kernel between every column of a and every column
+   * of b, with all the dot products computed by one matrix product.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    InnerProductBlock(a, b, out);
+    out = arma::pow(out + offset, degree);
+  }
+
   //! Get the degree of the polynomial.
   const double& Degree() const { return degree; }
   //! Modify the degree of the polynomial.
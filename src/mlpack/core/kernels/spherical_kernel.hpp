@@ -11,6 +11,7 @@
 #define MLPACK_CORE_KERNELS_SPHERICAL_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 
 namespace mlpack {
 
@@ -54,6 +55,20 @@ class SphericalKernel
         1.0 : 0.0;
   }
 
+  /**
+   * Evaluate the spherical kernel between every column of a and every column
+   * of b, with the squared distances computed by a matrix product.  Because of
+   * rounding, points at exactly the bandwidth may fall on either side.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    SquaredDistanceBlock(a, b, out);
+    out = arma::conv_to<arma::mat>::from(out <= bandwidthSquared);
+  }
+
   double Normalizer(size_t dimension) const
   {
     return std::pow(bandwidth, (double) dimension) *
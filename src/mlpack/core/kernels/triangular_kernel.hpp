@@ -13,6 +13,7 @@
 #define MLPACK_CORE_KERNELS_TRIANGULAR_KERNEL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
 #include <mlpack/core/distances/lmetric.hpp>
 
 namespace mlpack {
@@ -50,6 +51,19 @@ class TriangularKernel
     return std::max(0.0, (1 - EuclideanDistance::Evaluate(a, b) / bandwidth));
   }
 
+  /**
+   * Evaluate the triangular kernel between every column of a and every column
+   * of b, with the distances computed by a matrix product.
+   */
+  template<typename MatTypeA, typename MatTypeB>
+  void EvaluateBlock(const MatTypeA& a,
+                     const MatTypeB& b,
+                     arma::mat& out) const
+  {
+    SquaredDistanceBlock(a, b, out);
+    out = arma::clamp(1.0 - arma::sqrt(out) / bandwidth, 0.0, DBL_MAX);
+  }
+
   /**
    * Evaluate the triangular kernel given that the distance between the two
    * points is known.
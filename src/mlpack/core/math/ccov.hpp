@@ -4,7 +4,8 @@
  * @author Conrad Sanderson
  *
  * ColumnCovariance(X) is the same as cov(trans(X)) but without the cost of
- * computing trans(X).
+ * computing trans(X).  For real matrices, it is computed with a
+ * CovarianceAccumulator, without a centered copy of X.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -16,6 +17,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "covariance_accumulator.hpp"
+
 namespace mlpack {
 
 template<typename eT>
@@ -0,0 +1,204 @@
+/**
+ * @file core/math/covariance_accumulator.hpp
+ *
+ * CovarianceAccumulator, which computes the mean and covariance of a dataset
+ * in a single blocked, parallel pass, without a centered copy of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_COVARIANCE_ACCUMULATOR_HPP
+#define MLPACK_CORE_MATH_COVARIANCE_ACCUMULATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * CovarianceAccumulator holds the number of points, the mean and the centered
+ * scatter matrix of a dataset, and can be updated one block of points at a
+ * time.  Each block is split into sub-blocks of BlockSize points; the scatter
+ * matrix of each sub-block is computed from a centered copy of that sub-block
+ * only, and the statistics of the sub-blocks, of the threads and of the
+ * blocks are merged with the pairwise update of Chan, Golub and LeVeque.
+ * So, the extra memory is proportional to the dimensionality (and the number
+ * of threads), not to the number of points: a covariance can be computed on
+ * a dataset that is streamed from disk, and gives the same result (up to
+ * rounding) as when it is computed on the whole dataset at once.
+ *
+ * For a fixed number of threads, the result does not depend on the
+ * scheduling of the threads.
+ *
+ * @code
+ * CovarianceAccumulator<arma::mat> acc;
+ * data::MatrixReader reader("points.bin", 100000);
+ * arma::mat block;
+ * while (reader.Next(block))
+ *   acc.Update(block);
+ *
+ * arma::mat cov = acc.Covariance();
+ * @endcode
+ *
+ * @tparam MatType Type of the mean and scatter matrix (e.g. arma::mat or
+ *     arma::fmat).
+ */
+template<typename MatType = arma::mat>
+class CovarianceAccumulator
+{
+ public:
+  //! The element type of the statistics.
+  using ElemType = typename MatType::elem_type;
+  //! The vector type of the mean.
+  using VecType = typename GetColType<MatType>::type;
+
+  //! Create empty statistics.  The dimensionality is set by the first block.
+  CovarianceAccumulator() : count(0) { }
+
+  /**
+   * Add the given block of points (one per column) to the statistics.  The
+   * block must have the dimensionality of the earlier blocks.
+   *
+   * @param input Block of points to add.
+   */
+  template<typename InMatType>
+  void Update(const InMatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (count > 0 && input.n_rows != mean.n_elem)
+    {
+      throw std::invalid_argument("CovarianceAccumulator::Update(): the "
+          "block has " + std::to_string(input.n_rows) + " dimensions, but the "
+          "earlier blocks have " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const size_t numBlocks = (input.n_cols + BlockSize - 1) / BlockSize;
+
+    #ifdef MLPACK_USE_OPENMP
+    const size_t numThreads = std::min((size_t) omp_get_max_threads(),
+        numBlocks);
+    #else
+    const size_t numThreads = 1;
+    #endif
+
+    // The statistics of each thread are merged in the order of the threads,
+    // so that the result does not depend on the scheduling.
+    std::vector<CovarianceAccumulator> threadStats(numThreads);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+      #ifdef MLPACK_USE_OPENMP
+      CovarianceAccumulator& stats = threadStats[omp_get_thread_num()];
+      #else
+      CovarianceAccumulator& stats = threadStats[0];
+      #endif
+      CovarianceAccumulator blockStats;
+      MatType centered;
+
+      #pragma omp for schedule(static)
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        const size_t begin = b * BlockSize;
+        const size_t end = std::min(begin + BlockSize, (size_t) input.n_cols);
+
+        centered = arma::conv_to<MatType>::from(input.cols(begin, end - 1));
+        blockStats.count = end - begin;
+        blockStats.mean = arma::mean(centered, 1);
+        centered.each_col() -= blockStats.mean;
+        blockStats.scatter = centered * centered.t();
+
+        stats.Merge(blockStats);
+      }
+    }
+
+    for (size_t t = 0; t < numThreads; ++t)
+      Merge(threadStats[t]);
+  }
+
+  /**
+   * Add the statistics of another (disjoint) set of points to these.
+   *
+   * @param other Statistics to add.
+   */
+  void Merge(const CovarianceAccumulator& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    if (other.mean.n_elem != mean.n_elem)
+    {
+      throw std::invalid_argument("CovarianceAccumulator::Merge(): the "
+          "statistics have " + std::to_string(other.mean.n_elem) +
+          " dimensions, but these have " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const size_t total = count + other.count;
+    const ElemType weight = ElemType(count) * ElemType(other.count) /
+        ElemType(total);
+    const VecType delta = other.mean - mean;
+
+    scatter += other.scatter + weight * (delta * delta.t());
+    mean += (ElemType(other.count) / ElemType(total)) * delta;
+    count = total;
+  }
+
+  //! Forget all points, so the next block may have any dimensionality.
+  void Reset()
+  {
+    count = 0;
+    mean.clear();
+    scatter.clear();
+  }
+
+  /**
+   * Get the covariance of the points.
+   *
+   * @param normType If 0, normalize with Count() - 1 (the unbiased
+   *     estimator); if 1, normalize with Count().
+   */
+  MatType Covariance(const size_t normType = 0) const
+  {
+    if (normType > 1)
+    {
+      throw std::invalid_argument("CovarianceAccumulator::Covariance(): "
+          "normType must be 0 or 1!");
+    }
+
+    const ElemType normVal = (normType == 0) ?
+        ((count > 1) ? ElemType(count - 1) : ElemType(1)) : ElemType(count);
+    return (count == 0) ? MatType() : MatType(scatter / normVal);
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the dimensionality of the points (0 if there are none).
+  size_t Dimensionality() const { return mean.n_elem; }
+  //! Get the mean of the points.
+  const VecType& Mean() const { return mean; }
+  //! Get the centered scatter matrix of the points.
+  const MatType& Scatter() const { return scatter; }
+
+ private:
+  //! Number of points in each sub-block that is processed by one thread.
+  static constexpr size_t BlockSize = 1024;
+
+  //! Number of points.
+  size_t count;
+  //! Mean of the points.
+  VecType mean;
+  //! Centered scatter matrix of the points.
+  MatType scatter;
+};
+
+} // namespace mlpack
+
+#endif
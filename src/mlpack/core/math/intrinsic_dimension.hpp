@@ -0,0 +1,111 @@
+/**
+ * @file core/math/intrinsic_dimension.hpp
+ *
+ * Estimation of the intrinsic dimension of a dataset with the TwoNN estimator.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_INTRINSIC_DIMENSION_HPP
+#define MLPACK_CORE_MATH_INTRINSIC_DIMENSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Estimate the intrinsic dimension of the given dataset (one point per
+ * column) with the TwoNN estimator of Facco et al. (2017).  For each point,
+ * the ratio of the distances to its second and first nearest neighbors
+ * follows a Pareto distribution whose shape is the intrinsic dimension; the
+ * estimate is the maximum likelihood estimate of that shape.
+ *
+ * At most `maxPoints` points, chosen at random, are used, and their nearest
+ * neighbors are found by brute force among themselves, so the cost is
+ * O(maxPoints^2 * dimensionality).  Points that have a duplicate are ignored.
+ * If fewer than 3 distinct points are available, the dimensionality of the
+ * dataset is returned.
+ *
+ * @code
+ * // Points on a 2-dimensional plane in 10 dimensions.
+ * arma::mat data = arma::randn<arma::mat>(10, 2) *
+ *     arma::randu<arma::mat>(2, 5000);
+ * const double d = EstimateIntrinsicDimension(data); // About 2.
+ * @endcode
+ *
+ * @param data Dataset to estimate the intrinsic dimension of.
+ * @param maxPoints Maximum number of points to use.
+ */
+template<typename MatType>
+double EstimateIntrinsicDimension(const MatType& data,
+                                  const size_t maxPoints = 1000)
+{
+  using ElemType = typename MatType::elem_type;
+
+  const size_t n = std::min((size_t) data.n_cols, maxPoints);
+  if (n < 3)
+    return (double) data.n_rows;
+
+  arma::Mat<ElemType> sample;
+  if (n == data.n_cols)
+    sample = data;
+  else
+    sample = data.cols(arma::randperm(data.n_cols, n));
+
+  // Squared distances between all points of the sample.
+  const arma::Col<ElemType> norms = arma::sum(arma::square(sample), 0).t();
+  const arma::Mat<ElemType> products = sample.t() * sample;
+
+  double logRatios = 0.0;
+  size_t count = 0;
+
+  #pragma omp parallel for reduction(+:logRatios, count) schedule(static)
+  for (size_t i = 0; i < n; ++i)
+  {
+    // Find the two smallest (nonzero) distances from point i.
+    double first = DBL_MAX;
+    double second = DBL_MAX;
+    bool duplicate = false;
+    for (size_t j = 0; j < n; ++j)
+    {
+      if (j == i)
+        continue;
+
+      const double dist = std::max(0.0, (double) (norms[i] + norms[j] -
+          2 * products(j, i)));
+      if (dist == 0.0)
+      {
+        duplicate = true;
+        break;
+      }
+
+      if (dist < first)
+      {
+        second = first;
+        first = dist;
+      }
+      else if (dist < second)
+      {
+        second = dist;
+      }
+    }
+
+    if (!duplicate && second > first)
+    {
+      // The distances are squared, so the log of their ratio is halved.
+      logRatios += 0.5 * std::log(second / first);
+      ++count;
+    }
+  }
+
+  if (count < 3 || logRatios == 0.0)
+    return (double) data.n_rows;
+
+  return std::min((double) count / logRatios, (double) data.n_rows);
+}
+
+} // namespace mlpack
+
+#endif
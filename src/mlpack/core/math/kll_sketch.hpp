@@ -0,0 +1,227 @@
+/**
+ * @file core/math/kll_sketch.hpp
+ *
+ * KLLSketch, a mergeable sketch of a stream of values that gives approximate
+ * quantiles in memory that does not grow with the number of values.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_KLL_SKETCH_HPP
+#define MLPACK_CORE_MATH_KLL_SKETCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * KLLSketch summarizes a stream of values so that any quantile of the values
+ * can be estimated, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{karnin2016optimal,
+ *   title={Optimal quantile approximation in streams},
+ *   author={Karnin, Z. and Lang, K. and Liberty, E.},
+ *   booktitle={Proceedings of the 57th Annual IEEE Symposium on Foundations
+ *       of Computer Science (FOCS '16)},
+ *   pages={71--78},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * The values are kept in a stack of compactors; a value in compactor h stands
+ * for 2^h values of the stream.  When the sketch is full, a compactor whose
+ * capacity is reached is sorted, and every other value of it (starting from
+ * the first or the second one, at random) is moved to the next compactor.  The
+ * capacity of the top compactor is k, and that of each compactor below is 2/3
+ * of the one above it (but at least 2), so the sketch holds at most about 3k
+ * values.  With high probability, the error of the rank of an estimated
+ * quantile is then about 2% of the number of values for the default k = 200,
+ * and is inversely proportional to k; while fewer than k values have been
+ * inserted, the quantiles are exact.
+ *
+ * Two sketches of disjoint streams can be merged into a sketch of both, so
+ * sketches can be built in parallel.  The random choices of each sketch come
+ * from its own generator, so a sketch is not affected by other sketches or by
+ * mlpack's random seed, and inserting the same values in the same order
+ * always gives the same sketch.
+ *
+ * @code
+ * KLLSketch<> sketch;
+ * for (size_t i = 0; i < data.n_cols; ++i)
+ *   sketch.Insert(data(0, i));
+ *
+ * const double median = sketch.Quantile(0.5);
+ * @endcode
+ *
+ * @tparam ElemType Type of the values.
+ */
+template<typename ElemType = double>
+class KLLSketch
+{
+ public:
+  /**
+   * Create an empty sketch.
+   *
+   * @param k Capacity of the top compactor; the accuracy and the memory of
+   *     the sketch grow with k.
+   * @param seed Seed of the generator of the random choices of the sketch.
+   */
+  KLLSketch(const size_t k = 200, const size_t seed = 0) :
+      k(std::max(k, (size_t) 2)),
+      count(0),
+      size(0),
+      maxSize(0),
+      generator(seed)
+  {
+    AddCompactor();
+  }
+
+  //! Add the given value to the sketch.  NaN values are ignored.
+  void Insert(const ElemType value)
+  {
+    if (std::isnan(value))
+      return;
+
+    compactors[0].push_back(value);
+    ++count;
+    ++size;
+    if (size >= maxSize)
+      Compress();
+  }
+
+  /**
+   * Add all the values of another sketch to this one; afterwards, this is a
+   * sketch of the values of both.
+   *
+   * @param other Sketch to add.
+   */
+  void Merge(const KLLSketch& other)
+  {
+    while (compactors.size() < other.compactors.size())
+      AddCompactor();
+
+    for (size_t h = 0; h < other.compactors.size(); ++h)
+    {
+      compactors[h].insert(compactors[h].end(), other.compactors[h].begin(),
+          other.compactors[h].end());
+    }
+
+    count += other.count;
+    size += other.size;
+    while (size >= maxSize)
+      Compress();
+  }
+
+  /**
+   * Estimate the given quantile of the values: the smallest value of the
+   * sketch whose estimated rank is at least q times the number of values.
+   * If the sketch is empty, NaN is returned.
+   *
+   * @param q Quantile to estimate, in [0, 1].
+   */
+  ElemType Quantile(const double q) const
+  {
+    if (q < 0.0 || q > 1.0)
+    {
+      throw std::invalid_argument("KLLSketch::Quantile(): quantile must be "
+          "in [0, 1]!");
+    }
+
+    if (count == 0)
+      return std::numeric_limits<ElemType>::quiet_NaN();
+
+    std::vector<std::pair<ElemType, size_t>> values;
+    values.reserve(size);
+    size_t totalWeight = 0;
+    for (size_t h = 0; h < compactors.size(); ++h)
+    {
+      for (const ElemType value : compactors[h])
+        values.emplace_back(value, size_t(1) << h);
+      totalWeight += compactors[h].size() << h;
+    }
+    std::sort(values.begin(), values.end());
+
+    // The first value of the sketch is the first quantile.
+    const double target = std::max(q * totalWeight, 1.0);
+    size_t weight = 0;
+    for (const std::pair<ElemType, size_t>& value : values)
+    {
+      weight += value.second;
+      if (weight >= target)
+        return value.first;
+    }
+
+    return values.back().first;
+  }
+
+  //! Get the number of values inserted in the sketch.
+  size_t Count() const { return count; }
+  //! Get the number of values held by the sketch.
+  size_t Size() const { return size; }
+  //! Get the capacity of the top compactor.
+  size_t K() const { return k; }
+
+ private:
+  //! Add a compactor on top of the others, and update the capacities.
+  void AddCompactor()
+  {
+    compactors.emplace_back();
+    maxSize = 0;
+    for (size_t h = 0; h < compactors.size(); ++h)
+      maxSize += Capacity(h);
+  }
+
+  //! Get the capacity of compactor h.
+  size_t Capacity(const size_t h) const
+  {
+    const size_t depth = compactors.size() - h - 1;
+    return std::max((size_t) std::ceil(k * std::pow(2.0 / 3.0, depth)),
+        (size_t) 2);
+  }
+
+  //! Compact the lowest compactor whose capacity is reached.
+  void Compress()
+  {
+    for (size_t h = 0; h < compactors.size(); ++h)
+    {
+      if (compactors[h].size() < Capacity(h))
+        continue;
+
+      if (h + 1 == compactors.size())
+        AddCompactor();
+
+      // If the compactor holds an odd number of values, the largest one
+      // stays.
+      std::vector<ElemType>& compactor = compactors[h];
+      std::sort(compactor.begin(), compactor.end());
+      const size_t pairs = compactor.size() / 2;
+      const size_t offset = generator() & 1;
+      for (size_t i = 0; i < pairs; ++i)
+        compactors[h + 1].push_back(compactor[2 * i + offset]);
+      compactor.erase(compactor.begin(), compactor.begin() + 2 * pairs);
+
+      size -= pairs;
+      return;
+    }
+  }
+
+  //! Capacity of the top compactor.
+  size_t k;
+  //! Number of values inserted.
+  size_t count;
+  //! Number of values held by all the compactors.
+  size_t size;
+  //! Sum of the capacities of the compactors.
+  size_t maxSize;
+  //! The values of each compactor.
+  std::vector<std::vector<ElemType>> compactors;
+  //! Generator of the random choices.
+  std::mt19937_64 generator;
+};
+
+} // namespace mlpack
+
+#endif
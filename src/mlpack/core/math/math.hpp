@@ -14,10 +14,15 @@
 
 #include "ccov.hpp"
 #include "columns_to_blocks.hpp"
+#include "covariance_accumulator.hpp"
 #include "digamma.hpp"
+#include "intrinsic_dimension.hpp"
+#include "kll_sketch.hpp"
 #include "log_add.hpp"
 #include "make_alias.hpp"
+#include "moments_accumulator.hpp"
 #include "multiply_slices.hpp"
+#include "philox.hpp"
 #include "quantile.hpp"
 #include "random_basis.hpp"
 #include "random.hpp"
@@ -0,0 +1,287 @@
+/**
+ * @file core/math/moments_accumulator.hpp
+ *
+ * MomentsAccumulator, which computes the mean, variance, skewness, kurtosis,
+ * minimum and maximum of each dimension of a dataset in a single blocked,
+ * parallel pass.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_MATH_MOMENTS_ACCUMULATOR_HPP
+#define MLPACK_CORE_MATH_MOMENTS_ACCUMULATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * MomentsAccumulator holds the number of points, and the mean, the sums of the
+ * second, third and fourth powers of the deviations from the mean, the minimum
+ * and the maximum of each dimension of a dataset, and can be updated one block
+ * of points at a time.  As in CovarianceAccumulator, each block is split into
+ * sub-blocks of BlockSize points that are processed in parallel, and the
+ * statistics of the sub-blocks, of the threads and of the blocks are merged
+ * with the pairwise update of Chan, Golub and LeVeque, extended to the third
+ * and fourth moments as in the following report:
+ *
+ * @code
+ * @techreport{pebay2008formulas,
+ *   title={Formulas for robust, one-pass parallel computation of covariances
+ *       and arbitrary-order statistical moments},
+ *   author={P{\'e}bay, P.},
+ *   institution={Sandia National Laboratories},
+ *   number={SAND2008-6212},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * So all the statistics are computed in one pass over a dataset that may be
+ * streamed from disk, with memory proportional to the dimensionality (and the
+ * number of threads), and they are the same (up to rounding) as when they are
+ * computed on the whole dataset at once.  For a fixed number of threads, the
+ * result does not depend on the scheduling of the threads.
+ *
+ * @code
+ * MomentsAccumulator<arma::mat> acc;
+ * data::CSVChunkReader reader("points.csv", 100000);
+ * arma::mat block;
+ * while (reader.Next(block))
+ *   acc.Update(block);
+ *
+ * arma::vec skewness = acc.Skewness();
+ * @endcode
+ *
+ * @tparam MatType Type of matrix whose column type holds the statistics (e.g.
+ *     arma::mat or arma::fmat).
+ */
+template<typename MatType = arma::mat>
+class MomentsAccumulator
+{
+ public:
+  //! The element type of the statistics.
+  using ElemType = typename MatType::elem_type;
+  //! The vector type of the statistics.
+  using VecType = typename GetColType<MatType>::type;
+
+  //! Create empty statistics.  The dimensionality is set by the first block.
+  MomentsAccumulator() : count(0) { }
+
+  /**
+   * Add the given block of points (one per column) to the statistics.  The
+   * block must have the dimensionality of the earlier blocks.
+   *
+   * @param input Block of points to add.
+   */
+  template<typename InMatType>
+  void Update(const InMatType& input)
+  {
+    if (input.n_cols == 0)
+      return;
+
+    if (count > 0 && input.n_rows != mean.n_elem)
+    {
+      throw std::invalid_argument("MomentsAccumulator::Update(): the block "
+          "has " + std::to_string(input.n_rows) + " dimensions, but the "
+          "earlier blocks have " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const size_t numBlocks = (input.n_cols + BlockSize - 1) / BlockSize;
+
+    #ifdef MLPACK_USE_OPENMP
+    const size_t numThreads = std::min((size_t) omp_get_max_threads(),
+        numBlocks);
+    #else
+    const size_t numThreads = 1;
+    #endif
+
+    // The statistics of each thread are merged in the order of the threads,
+    // so that the result does not depend on the scheduling.
+    std::vector<MomentsAccumulator> threadStats(numThreads);
+
+    #pragma omp parallel num_threads(numThreads)
+    {
+      #ifdef MLPACK_USE_OPENMP
+      MomentsAccumulator& stats = threadStats[omp_get_thread_num()];
+      #else
+      MomentsAccumulator& stats = threadStats[0];
+      #endif
+      MomentsAccumulator blockStats;
+      MatType centered, squared;
+
+      #pragma omp for schedule(static)
+      for (size_t b = 0; b < numBlocks; ++b)
+      {
+        const size_t begin = b * BlockSize;
+        const size_t end = std::min(begin + BlockSize, (size_t) input.n_cols);
+
+        centered = arma::conv_to<MatType>::from(input.cols(begin, end - 1));
+        blockStats.count = end - begin;
+        blockStats.minimum = arma::min(centered, 1);
+        blockStats.maximum = arma::max(centered, 1);
+        blockStats.mean = arma::mean(centered, 1);
+        centered.each_col() -= blockStats.mean;
+        squared = arma::square(centered);
+        blockStats.m2 = arma::sum(squared, 1);
+        blockStats.m3 = arma::sum(squared % centered, 1);
+        blockStats.m4 = arma::sum(arma::square(squared), 1);
+
+        stats.Merge(blockStats);
+      }
+    }
+
+    for (size_t t = 0; t < numThreads; ++t)
+      Merge(threadStats[t]);
+  }
+
+  /**
+   * Add the statistics of another (disjoint) set of points to these.
+   *
+   * @param other Statistics to add.
+   */
+  void Merge(const MomentsAccumulator& other)
+  {
+    if (other.count == 0)
+      return;
+
+    if (count == 0)
+    {
+      *this = other;
+      return;
+    }
+
+    if (other.mean.n_elem != mean.n_elem)
+    {
+      throw std::invalid_argument("MomentsAccumulator::Merge(): the "
+          "statistics have " + std::to_string(other.mean.n_elem) +
+          " dimensions, but these have " + std::to_string(mean.n_elem) + "!");
+    }
+
+    const ElemType n1 = ElemType(count);
+    const ElemType n2 = ElemType(other.count);
+    const ElemType n = n1 + n2;
+    const VecType delta = other.mean - mean;
+    const VecType delta2 = arma::square(delta);
+
+    // Each sum uses the lower-order sums of both sets before the update.
+    m4 += other.m4 + (n1 * n2 * (n1 * n1 - n1 * n2 + n2 * n2) / (n * n * n)) *
+        arma::square(delta2) + (6 / (n * n)) * delta2 %
+        (n1 * n1 * other.m2 + n2 * n2 * m2) + (4 / n) * delta %
+        (n1 * other.m3 - n2 * m3);
+    m3 += other.m3 + (n1 * n2 * (n1 - n2) / (n * n)) * (delta2 % delta) +
+        (3 / n) * delta % (n1 * other.m2 - n2 * m2);
+    m2 += other.m2 + (n1 * n2 / n) * delta2;
+    mean += (n2 / n) * delta;
+    minimum = arma::min(minimum, other.minimum);
+    maximum = arma::max(maximum, other.maximum);
+    count += other.count;
+  }
+
+  //! Forget all points, so the next block may have any dimensionality.
+  void Reset()
+  {
+    count = 0;
+    mean.clear();
+    m2.clear();
+    m3.clear();
+    m4.clear();
+    minimum.clear();
+    maximum.clear();
+  }
+
+  /**
+   * Get the variance of each dimension.
+   *
+   * @param normType If 0, normalize with Count() - 1 (the unbiased
+   *     estimator); if 1, normalize with Count().
+   */
+  VecType Variance(const size_t normType = 0) const
+  {
+    CheckNormType(normType, "Variance");
+    const ElemType normVal = (normType == 0) ?
+        ((count > 1) ? ElemType(count - 1) : ElemType(1)) : ElemType(count);
+    return (count == 0) ? VecType() : VecType(m2 / normVal);
+  }
+
+  /**
+   * Get the skewness of each dimension.
+   *
+   * @param normType If 0, get the sample skewness (with the unbiased
+   *     variance); if 1, get the population skewness.
+   */
+  VecType Skewness(const size_t normType = 0) const
+  {
+    const ElemType n = ElemType(count);
+    const VecType s3 = arma::pow(arma::sqrt(Variance(normType)), 3);
+    if (normType == 1)
+      return m3 / (n * s3);
+    else
+      return (n / ((n - 1) * (n - 2))) * (m3 / s3);
+  }
+
+  /**
+   * Get the excess kurtosis of each dimension.
+   *
+   * @param normType If 0, get the sample excess kurtosis (with the unbiased
+   *     variance); if 1, get the population excess kurtosis.
+   */
+  VecType Kurtosis(const size_t normType = 0) const
+  {
+    CheckNormType(normType, "Kurtosis");
+    const ElemType n = ElemType(count);
+    if (normType == 1)
+      return n * (m4 / arma::square(m2)) - 3;
+
+    const VecType s4 = arma::square(Variance(normType));
+    const ElemType normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
+    const ElemType norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+    return normC * (m4 / s4) - norm3;
+  }
+
+  //! Get the number of points.
+  size_t Count() const { return count; }
+  //! Get the dimensionality of the points (0 if there are none).
+  size_t Dimensionality() const { return mean.n_elem; }
+  //! Get the mean of each dimension.
+  const VecType& Mean() const { return mean; }
+  //! Get the minimum of each dimension.
+  const VecType& Min() const { return minimum; }
+  //! Get the maximum of each dimension.
+  const VecType& Max() const { return maximum; }
+
+ private:
+  //! Throw if the given normalization type is not 0 or 1.
+  static void CheckNormType(const size_t normType, const std::string& name)
+  {
+    if (normType > 1)
+    {
+      throw std::invalid_argument("MomentsAccumulator::" + name + "(): "
+          "normType must be 0 or 1!");
+    }
+  }
+
+  //! Number of points in each sub-block that is processed by one thread.
+  static constexpr size_t BlockSize = 1024;
+
+  //! Number of points.
+  size_t count;
+  //! Mean of each dimension.
+  VecType mean;
+  //! Sum of the squared deviations from the mean of each dimension.
+  VecType m2;
+  //! Sum of the cubed deviations from the mean of each dimension.
+  VecType m3;
+  //! Sum of the fourth powers of the deviations from the mean of each
+  //! dimension.
+  VecType m4;
+  //! Minimum of each dimension.
+  VecType minimum;
+  //! Maximum of each dimension.
+  VecType maximum;
+};
+
+} // namespace mlpack
+
+#endif
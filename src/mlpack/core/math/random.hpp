@@ -40,6 +40,17 @@ inline std::mt19937& RandGen()
   return randGen;
 }
 
+/**
+ * Get the global seed of the counter-based generators returned by RandStream().
+ * Unlike the seeds of RandGen(), the seed is the same for every thread: it is
+ * set by RandomSeed(), and should not be modified while other threads use it.
+ */
+inline uint64_t& RandStreamSeed()
+{
+  static uint64_t streamSeed = std::mt19937::default_seed;
+  return streamSeed;
+}
+
 //! Global uniform distribution.
 inline std::uniform_real_distribution<>& RandUniformDist()
 {
@@ -56,7 +67,8 @@ inline std::normal_distribution<>& RandNormalDist()
 }
 
 /**
- * Set the random seed used by the random functions (Random() and RandInt()).
+ * Set the random seed used by the random functions (Random() and RandInt()),
+ * and by the counter-based generators returned by RandStream().
  * The seed is casted to a 32-bit integer before being given to the random
  * number generator, but a size_t is taken as a parameter for API consistency.
  *
@@ -66,6 +78,7 @@ inline void RandomSeed(const size_t seed)
 {
   #if (!defined(BINDING_TYPE) || BINDING_TYPE != BINDING_TYPE_TEST)
     RandGen().seed((uint32_t) (seed + RandGenSeedOffset()));
+    RandStreamSeed() = seed;
     #if (BINDING_TYPE == BINDING_TYPE_R)
       // To suppress Found 'srand', possibly from 'srand' (C).
       (void) seed;
@@ -92,6 +105,7 @@ inline void FixedRandomSeed()
   std::uniform_int_distribution<size_t> dist;
   const size_t seed = dist(rng);
   RandGen().seed((uint32_t) seed + RandGenSeedOffset());
+  RandStreamSeed() = seed;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed + RandGenSeedOffset());
 }
@@ -99,6 +113,7 @@ inline void FixedRandomSeed()
 inline void CustomRandomSeed(const size_t seed)
 {
   RandGen().seed((uint32_t) seed + RandGenSeedOffset());
+  RandStreamSeed() = seed;
   srand((unsigned int) seed);
   arma::arma_rng::set_seed(seed + RandGenSeedOffset());
 }
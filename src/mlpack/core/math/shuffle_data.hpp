@@ -76,7 +76,7 @@ void ShuffleData(const MatType& inputPoints,
   {
     MatType newOutputPoints(locations, values, inputPoints.n_rows,
         inputPoints.n_cols, true);
-    LabelsType newOutputLabels(inputLabels.n_elem);
+    LabelsType newOutputLabels(inputLabels.n_rows, inputLabels.n_cols);
     newOutputLabels.cols(ordering) = inputLabels;
 
     outputPoints = std::move(newOutputPoints);
@@ -86,7 +86,7 @@ void ShuffleData(const MatType& inputPoints,
   {
     outputPoints = MatType(locations, values, inputPoints.n_rows,
         inputPoints.n_cols, true);
-    outputLabels.set_size(inputLabels.n_elem);
+    outputLabels.set_size(inputLabels.n_rows, inputLabels.n_cols);
     outputLabels.cols(ordering) = inputLabels;
   }
 }
@@ -89,6 +89,12 @@ class BLEU
    *                {"this", "is", "generated", "paragraph", "2"}}
    * ```
    * @param smooth Whether or not to apply Lin et al. 2004 smoothing.
+   *
+   * The tokens can be of any hashable type with operator==, e.g.
+   * std::string, std::string_view or integer token ids; integer ids are the
+   * fastest.  The n-grams are counted with hash tables, and the sentences are
+   * processed in parallel with OpenMP.
+   *
    * @return The Evaluate method returns the BLEU Score. This method also
    * calculates other BLEU metrics (brevity penalty, translation length, reference
    * length, ratio and precisions) which can be accessed by their corresponding
@@ -128,13 +134,46 @@ class BLEU
 
  private:
   /**
-   * Extracts all the n-grams.
+   * An n-gram of a tokenized sequence, identified by the position of its
+   * first token and its order (number of tokens), with a precomputed hash.
+   */
+  template<typename IteratorType>
+  struct NGram
+  {
+    //! Iterator to the first token.
+    IteratorType begin;
+    //! Number of tokens.
+    size_t order;
+    //! Hash of the tokens.
+    size_t hash;
+
+    bool operator==(const NGram& other) const
+    {
+      return (order == other.order) && (hash == other.hash) &&
+          std::equal(begin, std::next(begin, order), other.begin);
+    }
+  };
+
+  //! Hash function for NGram, which returns the precomputed hash.
+  struct NGramHash
+  {
+    template<typename NGramType>
+    size_t operator()(const NGramType& ngram) const { return ngram.hash; }
+  };
+
+  /**
+   * Call f() on each n-gram of the given segment, with order between 1 and
+   * maxOrder.
    *
    * @tparam WordVector Type of the tokenized vector.
    * @param segment Tokenized sequence represented in form of vector.
+   * @param tokenHashes Auxiliary memory for the hashes of the tokens.
+   * @param f Function to call on each NGram.
    */
-  template <typename WordVector>
-  std::map<WordVector, size_t> GetNGrams(const WordVector& segment);
+  template<typename WordVector, typename FunctionType>
+  void ForEachNGram(const WordVector& segment,
+                    std::vector<size_t>& tokenHashes,
+                    FunctionType&& f) const;
 
   //! Locally-stored value of maximum length of tokens in n-grams.
   size_t maxOrder;
@@ -27,21 +27,34 @@ BLEU<ElemType, PrecisionType>::BLEU(const size_t maxOrder) :
 }
 
 template <typename ElemType, typename PrecisionType>
-template <typename WordVector>
-std::map<WordVector, size_t> BLEU<ElemType, PrecisionType>::GetNGrams(
-    const WordVector& segment)
+template <typename WordVector, typename FunctionType>
+void BLEU<ElemType, PrecisionType>::ForEachNGram(
+    const WordVector& segment,
+    std::vector<size_t>& tokenHashes,
+    FunctionType&& f) const
 {
-  std::map<WordVector, size_t> ngramsCount;
-  for (size_t order = 1; order < maxOrder + 1; ++order)
+  using TokenType = typename WordVector::value_type;
+
+  const size_t n = segment.size();
+  tokenHashes.resize(n);
+  std::hash<TokenType> tokenHash;
+  size_t i = 0;
+  for (auto it = segment.cbegin(); it != segment.cend(); ++it, ++i)
+    tokenHashes[i] = tokenHash(*it);
+
+  // The hash of each n-gram is built from the hash of the n-gram one token
+  // shorter.
+  auto it = segment.cbegin();
+  for (i = 0; i < n; ++i, ++it)
   {
-    for (size_t i = 0; i + order < segment.size() + 1; ++i)
+    size_t hash = 0;
+    for (size_t order = 1; order < maxOrder + 1 && i + order < n + 1; ++order)
     {
-      WordVector seq = WordVector(segment.cbegin() + i,
-                                  segment.cbegin() + i + order);
-      ngramsCount[seq]++;
+      hash ^= tokenHashes[i + order - 1] + 0x9e3779b97f4a7c15ULL +
+          (hash << 6) + (hash >> 2);
+      f(NGram<typename WordVector::const_iterator>{ it, order, hash });
     }
   }
-  return ngramsCount;
 }
 
 template <typename ElemType, typename PrecisionType>
@@ -54,6 +67,21 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
   // WordVector is a string container type.
   // Also, TranslationCorpusType is an array of such containers.
   using WordVector = typename TranslationCorpusType::value_type;
+  using ReferenceType = typename ReferenceCorpusType::value_type;
+  using NGramType = NGram<typename WordVector::const_iterator>;
+
+  // Collect the pairs of references and translations, so that they can be
+  // processed in parallel.
+  std::vector<const ReferenceType*> references;
+  std::vector<const WordVector*> translations;
+  auto refIt = referenceCorpus.cbegin();
+  auto trIt = translationCorpus.cbegin();
+  for (; refIt != referenceCorpus.cend() && trIt != translationCorpus.cend();
+      ++refIt, ++trIt)
+  {
+    references.push_back(&(*refIt));
+    translations.push_back(&(*trIt));
+  }
 
   // matchesByOrder: It catches how many times sequence of a particular order
   // is encountered in both reference corpus and translation corpus.
@@ -68,71 +96,94 @@ ElemType BLEU<ElemType, PrecisionType>::Evaluate(
   // translationLength: It is the sum of length of each paragraphs.
   referenceLength = 0, translationLength = 0;
 
-  auto refIt = referenceCorpus.cbegin();
-  auto trIt = translationCorpus.cbegin();
-  for (; refIt != referenceCorpus.cend() && trIt != translationCorpus.cend();
-      ++refIt, ++trIt)
+  // Each thread accumulates its own counts, which are merged at the end.
+  // All counts are integers, so the result does not depend on the number of
+  // threads.
+  #pragma omp parallel
   {
-    size_t min = std::numeric_limits<size_t>::max();
-    for (const auto& t : *refIt)
+    std::vector<size_t> threadMatches(maxOrder, 0);
+    std::vector<size_t> threadPossibleMatches(maxOrder, 0);
+    size_t threadReferenceLength = 0, threadTranslationLength = 0;
+
+    // counts: for each n-gram of the translation, the number of times it
+    // occurs in the translation and the maximum number of times it occurs in
+    // any reference.  refCounts: the counts of the n-grams of one reference
+    // that are also in the translation.  The tables are reused across
+    // sentences.
+    std::unordered_map<NGramType, std::pair<size_t, size_t>, NGramHash>
+        counts;
+    std::unordered_map<NGramType, size_t, NGramHash> refCounts;
+    std::vector<size_t> tokenHashes;
+
+    #pragma omp for schedule(dynamic, 64)
+    for (size_t s = 0; s < translations.size(); ++s)
     {
-      if (min > t.size())
+      const ReferenceType& refs = *references[s];
+      const WordVector& translation = *translations[s];
+
+      size_t min = std::numeric_limits<size_t>::max();
+      for (const auto& t : refs)
       {
-        min = t.size();
+        if (min > t.size())
+        {
+          min = t.size();
+        }
       }
-    }
 
-    if (min == std::numeric_limits<size_t>::max())
-      min = 0;
+      if (min == std::numeric_limits<size_t>::max())
+        min = 0;
 
-    referenceLength += min;
-    translationLength += trIt->size();
+      threadReferenceLength += min;
+      threadTranslationLength += translation.size();
 
-    // mergedRefNGramCounts: It accumulates all the similar n-grams from
-    // various references or documents, so that there is no repetition of
-    // any key (sequence of order n).
-    std::map<WordVector, size_t> mergedRefNGramCounts;
-    for (const auto& t : *refIt)
-    {
-      // ngram: It holds the n-grams of each document/reference.
-      const std::map<WordVector, size_t> ngrams = GetNGrams(t);
-      for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
+      counts.clear();
+      ForEachNGram(translation, tokenHashes, [&](const NGramType& ngram)
+      {
+        ++counts[ngram].first;
+      });
+
+      // Only the n-grams of the references that are also in the translation
+      // can match.
+      for (const auto& t : refs)
       {
-        mergedRefNGramCounts[it->first] = std::max(it->second,
-            mergedRefNGramCounts[it->first]);
+        refCounts.clear();
+        ForEachNGram(t, tokenHashes, [&](const NGramType& ngram)
+        {
+          if (counts.count(ngram) > 0)
+            ++refCounts[ngram];
+        });
+
+        for (const auto& refCount : refCounts)
+        {
+          size_t& maxCount = counts[refCount.first].second;
+          maxCount = std::max(maxCount, refCount.second);
+        }
       }
-    }
-    // translationNGramCounts: It extracts the n-grams of the generated text
-    // sequence.
-    const std::map<WordVector, size_t> translationNGramCounts
-        = GetNGrams(*trIt);
-
-    // overlap: It holds those keys (sequence of order n) which are common to
-    // reference corpus and translation corpus.
-    std::map<WordVector, size_t> overlap;
-    for (auto it = translationNGramCounts.cbegin();
-         it != translationNGramCounts.cend();
-         ++it)
-    {
-      auto mergedIt = mergedRefNGramCounts.find(it->first);
-      if (mergedIt != mergedRefNGramCounts.end())
+
+      // The matches of each n-gram are clipped to the maximum number of times
+      // it occurs in any reference.
+      for (const auto& count : counts)
       {
-        // If the key (sequence of order n) is present in both translation
-        // corpus as well as reference corpus, then the minimum number of
-        // counts it has occurred in any is considered.
-        overlap[it->first] = std::min(mergedIt->second, it->second);
+        threadMatches[count.first.order - 1] += std::min(count.second.first,
+            count.second.second);
       }
-    }
 
-    for (auto it = overlap.cbegin(); it != overlap.cend(); ++it)
-    {
-      matchesByOrder[it->first.size() - 1] += it->second;
+      for (size_t order = 1; order < maxOrder + 1; ++order)
+      {
+        if (order < translation.size() + 1)
+          threadPossibleMatches[order - 1] += translation.size() - order + 1;
+      }
     }
 
-    for (size_t order = 1; order < maxOrder + 1; ++order)
+    #pragma omp critical(BLEUEvaluateReduce)
     {
-      if (order < trIt->size() + 1)
-        possibleMatchesByOrder[order - 1] += trIt->size() - order + 1;
+      for (size_t i = 0; i < maxOrder; ++i)
+      {
+        matchesByOrder[i] += threadMatches[i];
+        possibleMatchesByOrder[i] += threadPossibleMatches[i];
+      }
+      referenceLength += threadReferenceLength;
+      translationLength += threadTranslationLength;
     }
   }
 
@@ -30,6 +30,12 @@ namespace mlpack {
  * Where x0 and y0 are bottom left bounding box coordinates and h, w are
  * height and width of the bounding box.
  *
+ * When there are many boxes, NMS uses a uniform grid over the boxes, so that
+ * each box is only compared with the selected boxes that are close to it,
+ * instead of with all remaining boxes.  EvaluatePerClass() performs NMS
+ * separately for each class (in parallel), and EvaluateBatch() performs NMS
+ * on many images (in parallel).
+ *
  * @tparam UseCoordinates Toggles between the two representation of bounding box.
  *                        If true, each value in vector represents a coordinate 
  *                        in the formate x0, y0, x1, y1. Else the bounding box is
@@ -69,11 +75,120 @@ class NMS
                        OutputType& selectedIndices,
                        const double threshold = 0.5);
 
+  /**
+   * Performs non-maximal suppression separately for the boxes of each class:
+   * a box can only be suppressed by a box with the same label.  The classes
+   * are processed in parallel.
+   *
+   * @param boundingBoxes Column major representation of bounding boxes, as in
+   *                      Evaluate().
+   * @param confidenceScores Vector containing confidence score corresponding
+   *                         to each bounding box.
+   * @param labels Vector containing the class label of each bounding box.
+   * @param selectedIndices Output of NMS: the indices of the selected
+   *                        bounding boxes of all classes, sorted in
+   *                        descending order of the confidence scores.
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *                  of the same class that have IoU greater than the
+   *                  threshold.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename LabelsType,
+      typename OutputType
+  >
+  static void EvaluatePerClass(const BoundingBoxesType& boundingBoxes,
+                               const ConfidenceScoreType& confidenceScores,
+                               const LabelsType& labels,
+                               OutputType& selectedIndices,
+                               const double threshold = 0.5);
+
+  /**
+   * Performs non-maximal suppression on the bounding boxes of many images.
+   * The images are processed in parallel.
+   *
+   * @param boundingBoxes Bounding boxes of each image, as in Evaluate().
+   * @param confidenceScores Confidence scores of the bounding boxes of each
+   *                         image.
+   * @param selectedIndices Output of NMS for each image, as in Evaluate().
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *                  that have IoU greater than the threshold.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename OutputType
+  >
+  static void EvaluateBatch(
+      const std::vector<BoundingBoxesType>& boundingBoxes,
+      const std::vector<ConfidenceScoreType>& confidenceScores,
+      std::vector<OutputType>& selectedIndices,
+      const double threshold = 0.5);
+
+  /**
+   * Performs non-maximal suppression separately for the boxes of each class,
+   * on the bounding boxes of many images.  The images are processed in
+   * parallel.
+   *
+   * @param boundingBoxes Bounding boxes of each image, as in Evaluate().
+   * @param confidenceScores Confidence scores of the bounding boxes of each
+   *                         image.
+   * @param labels Class labels of the bounding boxes of each image.
+   * @param selectedIndices Output of NMS for each image, as in
+   *                        EvaluatePerClass().
+   * @param threshold Threshold used to discard all overlapping bounding boxes
+   *                  of the same class that have IoU greater than the
+   *                  threshold.
+   */
+  template<
+      typename BoundingBoxesType,
+      typename ConfidenceScoreType,
+      typename LabelsType,
+      typename OutputType
+  >
+  static void EvaluateBatch(
+      const std::vector<BoundingBoxesType>& boundingBoxes,
+      const std::vector<ConfidenceScoreType>& confidenceScores,
+      const std::vector<LabelsType>& labels,
+      std::vector<OutputType>& selectedIndices,
+      const double threshold = 0.5);
+
   static const bool useCoordinates = UseCoordinates;
 
+  //! Minimum number of bounding boxes for which Evaluate() uses a grid.
+  static constexpr size_t gridMinBoxes = 32;
+
   //! Serialize the metric.
   template <typename Archive>
   void serialize(Archive &ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Compute the corners {x1, y1, x2, y2} and the area of each bounding box.
+   */
+  template<typename BoundingBoxesType>
+  static void Corners(const BoundingBoxesType& boundingBoxes,
+                      arma::mat& corners,
+                      arma::rowvec& area);
+
+  /**
+   * Performs greedy NMS on the given boxes, using a uniform grid to find the
+   * selected boxes that may overlap each box.
+   *
+   * @param corners Corners of all bounding boxes (from Corners()).
+   * @param area Area of all bounding boxes (from Corners()).
+   * @param order Indices of the boxes to consider, in descending order of the
+   *     confidence scores.
+   * @param threshold IoU threshold.
+   * @param selected Indices of the selected boxes, in descending order of the
+   *     confidence scores.
+   */
+  static void GridSuppress(const arma::mat& corners,
+                           const arma::rowvec& area,
+                           const std::vector<size_t>& order,
+                           const double threshold,
+                           std::vector<size_t>& selected);
 }; // Class NMS.
 
 } // namespace mlpack
@@ -42,6 +42,28 @@ void NMS<UseCoordinates>::Evaluate(
       "scores for " + std::to_string(boundingBoxes.n_cols) +
       " bounding boxes.");
 
+  // With many boxes, only compare each box with the selected boxes close to
+  // it.
+  if (boundingBoxes.n_cols >= gridMinBoxes)
+  {
+    arma::mat corners;
+    arma::rowvec area;
+    Corners(boundingBoxes, corners, area);
+
+    const arma::uvec sortedIndices = arma::sort_index(confidenceScores);
+    std::vector<size_t> order(sortedIndices.n_elem);
+    for (size_t i = 0; i < order.size(); ++i)
+      order[i] = sortedIndices[sortedIndices.n_elem - 1 - i];
+
+    std::vector<size_t> selected;
+    GridSuppress(corners, area, order, threshold, selected);
+
+    selectedIndices.set_size(selected.size());
+    for (size_t i = 0; i < selected.size(); ++i)
+      selectedIndices[i] = selected[i];
+    return;
+  }
+
   // Clear selected bounding boxes.
   selectedIndices.clear();
 
@@ -91,10 +113,10 @@ void NMS<UseCoordinates>::Evaluate(
     BoundingBoxesType y1 = boundingBoxes.submat(arma::uvec(1).fill(1),
         sortedIndices);
 
-    size_t selectedX2 = boundingBoxes(2, selectedIndex);
-    size_t selectedY2 = boundingBoxes(3, selectedIndex);
-    size_t selectedX1 = boundingBoxes(0, selectedIndex);
-    size_t selectedY1 = boundingBoxes(1, selectedIndex);
+    double selectedX2 = boundingBoxes(2, selectedIndex);
+    double selectedY2 = boundingBoxes(3, selectedIndex);
+    double selectedX1 = boundingBoxes(0, selectedIndex);
+    double selectedY1 = boundingBoxes(1, selectedIndex);
 
     if (!UseCoordinates)
     {
@@ -107,8 +129,8 @@ void NMS<UseCoordinates>::Evaluate(
 
     // Calculate points of intersection between the bounding box with
     // highest confidence score and remaining bounding boxes.
-    x2 = arma::clamp(x2, DBL_MIN, selectedX2);
-    y2 = arma::clamp(y2, DBL_MIN, selectedY2);
+    x2 = arma::clamp(x2, -DBL_MAX, selectedX2);
+    y2 = arma::clamp(y2, -DBL_MAX, selectedY2);
     x1 = arma::clamp(x1, selectedX1, DBL_MAX);
     y1 = arma::clamp(y1, selectedY1, DBL_MAX);
 
@@ -126,6 +148,289 @@ void NMS<UseCoordinates>::Evaluate(
   selectedIndices = arma::flipud(selectedIndices);
 }
 
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename LabelsType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::EvaluatePerClass(
+    const BoundingBoxesType& boundingBoxes,
+    const ConfidenceScoreType& confidenceScores,
+    const LabelsType& labels,
+    OutputType& selectedIndices,
+    const double threshold)
+{
+  using LabelType = typename LabelsType::elem_type;
+
+  Log::Assert(boundingBoxes.n_rows == 4, "Bounding boxes must "
+      "contain only 4 rows determining coordinates of bounding "
+      "box either in {x1, y1, x2, y2} or {x1, y1, h, w} format."
+      "Refer to the documentation for more information.");
+
+  if (labels.n_elem != boundingBoxes.n_cols ||
+      confidenceScores.n_elem != boundingBoxes.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "NMS::EvaluatePerClass(): got " << boundingBoxes.n_cols
+        << " bounding boxes, but " << confidenceScores.n_elem
+        << " confidence scores and " << labels.n_elem << " labels!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  arma::mat corners;
+  arma::rowvec area;
+  Corners(boundingBoxes, corners, area);
+
+  // Group the boxes by label, each group in descending order of the
+  // confidence scores.  rank[i] is the position of box i in that order over
+  // all boxes.
+  const arma::uvec sortedIndices = arma::sort_index(confidenceScores);
+  std::vector<size_t> rank(sortedIndices.n_elem);
+  std::map<LabelType, size_t> classIndices;
+  std::vector<std::vector<size_t>> orders;
+  for (size_t i = 0; i < sortedIndices.n_elem; ++i)
+  {
+    const size_t box = sortedIndices[sortedIndices.n_elem - 1 - i];
+    rank[box] = i;
+
+    auto it = classIndices.find(labels[box]);
+    if (it == classIndices.end())
+    {
+      it = classIndices.insert(std::make_pair(labels[box],
+          orders.size())).first;
+      orders.emplace_back();
+    }
+    orders[it->second].push_back(box);
+  }
+
+  std::vector<std::vector<size_t>> classSelected(orders.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t c = 0; c < orders.size(); ++c)
+    GridSuppress(corners, area, orders[c], threshold, classSelected[c]);
+
+  // Merge the selected boxes of all classes.
+  std::vector<size_t> selected;
+  for (size_t c = 0; c < classSelected.size(); ++c)
+  {
+    selected.insert(selected.end(), classSelected[c].begin(),
+        classSelected[c].end());
+  }
+  std::sort(selected.begin(), selected.end(),
+      [&rank](const size_t a, const size_t b) { return rank[a] < rank[b]; });
+
+  selectedIndices.set_size(selected.size());
+  for (size_t i = 0; i < selected.size(); ++i)
+    selectedIndices[i] = selected[i];
+}
+
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::EvaluateBatch(
+    const std::vector<BoundingBoxesType>& boundingBoxes,
+    const std::vector<ConfidenceScoreType>& confidenceScores,
+    std::vector<OutputType>& selectedIndices,
+    const double threshold)
+{
+  if (confidenceScores.size() != boundingBoxes.size())
+  {
+    std::ostringstream oss;
+    oss << "NMS::EvaluateBatch(): got bounding boxes for "
+        << boundingBoxes.size() << " images, but confidence scores for "
+        << confidenceScores.size() << " images!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  selectedIndices.resize(boundingBoxes.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < boundingBoxes.size(); ++i)
+  {
+    Evaluate(boundingBoxes[i], confidenceScores[i], selectedIndices[i],
+        threshold);
+  }
+}
+
+template<bool UseCoordinates>
+template<
+    typename BoundingBoxesType,
+    typename ConfidenceScoreType,
+    typename LabelsType,
+    typename OutputType
+>
+void NMS<UseCoordinates>::EvaluateBatch(
+    const std::vector<BoundingBoxesType>& boundingBoxes,
+    const std::vector<ConfidenceScoreType>& confidenceScores,
+    const std::vector<LabelsType>& labels,
+    std::vector<OutputType>& selectedIndices,
+    const double threshold)
+{
+  if (confidenceScores.size() != boundingBoxes.size() ||
+      labels.size() != boundingBoxes.size())
+  {
+    std::ostringstream oss;
+    oss << "NMS::EvaluateBatch(): got bounding boxes for "
+        << boundingBoxes.size() << " images, but confidence scores for "
+        << confidenceScores.size() << " images and labels for "
+        << labels.size() << " images!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // Check the sizes before the parallel loop, so that no exception is thrown
+  // inside of it.
+  for (size_t i = 0; i < boundingBoxes.size(); ++i)
+  {
+    if (labels[i].n_elem != boundingBoxes[i].n_cols ||
+        confidenceScores[i].n_elem != boundingBoxes[i].n_cols)
+    {
+      std::ostringstream oss;
+      oss << "NMS::EvaluateBatch(): image " << i << " has "
+          << boundingBoxes[i].n_cols << " bounding boxes, but "
+          << confidenceScores[i].n_elem << " confidence scores and "
+          << labels[i].n_elem << " labels!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
+  selectedIndices.resize(boundingBoxes.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < boundingBoxes.size(); ++i)
+  {
+    EvaluatePerClass(boundingBoxes[i], confidenceScores[i], labels[i],
+        selectedIndices[i], threshold);
+  }
+}
+
+template<bool UseCoordinates>
+template<typename BoundingBoxesType>
+void NMS<UseCoordinates>::Corners(
+    const BoundingBoxesType& boundingBoxes,
+    arma::mat& corners,
+    arma::rowvec& area)
+{
+  corners = arma::conv_to<arma::mat>::from(boundingBoxes);
+  if (UseCoordinates)
+  {
+    area = (corners.row(2) - corners.row(0)) %
+        (corners.row(3) - corners.row(1));
+  }
+  else
+  {
+    area = corners.row(2) % corners.row(3);
+
+    // Change height - width representation to coordinate represention.
+    corners.row(2) += corners.row(0);
+    corners.row(3) += corners.row(1);
+  }
+}
+
+template<bool UseCoordinates>
+void NMS<UseCoordinates>::GridSuppress(
+    const arma::mat& corners,
+    const arma::rowvec& area,
+    const std::vector<size_t>& order,
+    const double threshold,
+    std::vector<size_t>& selected)
+{
+  selected.clear();
+  if (order.empty())
+    return;
+
+  // The IoU is never negative, so with a negative threshold the first box
+  // suppresses all of the others.
+  if (threshold < 0.0)
+  {
+    selected.push_back(order[0]);
+    return;
+  }
+
+  // Find the extent of the boxes and their mean size.
+  double minX = DBL_MAX, minY = DBL_MAX, maxX = -DBL_MAX, maxY = -DBL_MAX;
+  double meanWidth = 0.0, meanHeight = 0.0;
+  for (const size_t i : order)
+  {
+    minX = std::min(minX, std::min(corners(0, i), corners(2, i)));
+    minY = std::min(minY, std::min(corners(1, i), corners(3, i)));
+    maxX = std::max(maxX, std::max(corners(0, i), corners(2, i)));
+    maxY = std::max(maxY, std::max(corners(1, i), corners(3, i)));
+    meanWidth += std::abs(corners(2, i) - corners(0, i));
+    meanHeight += std::abs(corners(3, i) - corners(1, i));
+  }
+  meanWidth /= order.size();
+  meanHeight /= order.size();
+
+  // Use cells of about the mean box size, but no more than about 4 cells per
+  // box in total.
+  const size_t maxCells = (size_t) std::ceil(std::sqrt(4.0 * order.size()));
+  auto gridSize = [maxCells](const double range, const double size)
+  {
+    if (!(range > 0.0) || !(size > 0.0))
+      return (size_t) 1;
+    return (size_t) std::max(1.0, std::min((double) maxCells,
+        std::ceil(range / size)));
+  };
+  const size_t nx = gridSize(maxX - minX, meanWidth);
+  const size_t ny = gridSize(maxY - minY, meanHeight);
+  const double scaleX = (maxX > minX) ? nx / (maxX - minX) : 0.0;
+  const double scaleY = (maxY > minY) ? ny / (maxY - minY) : 0.0;
+  auto cell = [](const double v, const double min, const double scale,
+                 const size_t n)
+  {
+    return std::min(n - 1, (size_t) ((v - min) * scale));
+  };
+
+  // Each cell holds the selected boxes that overlap it.
+  std::vector<std::vector<size_t>> grid(nx * ny);
+  for (const size_t i : order)
+  {
+    const size_t x1 = cell(std::min(corners(0, i), corners(2, i)), minX,
+        scaleX, nx);
+    const size_t x2 = cell(std::max(corners(0, i), corners(2, i)), minX,
+        scaleX, nx);
+    const size_t y1 = cell(std::min(corners(1, i), corners(3, i)), minY,
+        scaleY, ny);
+    const size_t y2 = cell(std::max(corners(1, i), corners(3, i)), minY,
+        scaleY, ny);
+
+    // Boxes that do not share a cell do not intersect, so their IoU is 0 and
+    // they cannot suppress each other.
+    bool suppressed = false;
+    for (size_t y = y1; y <= y2 && !suppressed; ++y)
+    {
+      for (size_t x = x1; x <= x2 && !suppressed; ++x)
+      {
+        for (const size_t j : grid[y * nx + x])
+        {
+          const double width = std::max(std::min(corners(2, i),
+              corners(2, j)) - std::max(corners(0, i), corners(0, j)), 0.0);
+          const double height = std::max(std::min(corners(3, i),
+              corners(3, j)) - std::max(corners(1, i), corners(1, j)), 0.0);
+          const double intersection = width * height;
+          const double iou = intersection /
+              (area[i] - intersection + area[j]);
+          if (!(iou <= threshold))
+          {
+            suppressed = true;
+            break;
+          }
+        }
+      }
+    }
+
+    if (suppressed)
+      continue;
+
+    selected.push_back(i);
+    for (size_t y = y1; y <= y2; ++y)
+      for (size_t x = x1; x <= x2; ++x)
+        grid[y * nx + x].push_back(i);
+  }
+}
+
 template<bool UseCoordinates>
 template<typename Archive>
 void NMS<UseCoordinates>::serialize(
@@ -0,0 +1,112 @@
+/**
+ * @file core/tree/best_first_single_tree_traverser.hpp
+ *
+ * An anytime single-tree traverser that visits the reference nodes in order of
+ * their score (best first), and can stop after a time limit or a number of
+ * visited nodes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <chrono>
+
+namespace mlpack {
+
+/**
+ * A single-tree traverser that keeps the unvisited reference nodes in a
+ * priority queue ordered by their score (for nearest neighbor search, the
+ * minimum distance between the query point and the node), and always visits
+ * the best one next.  So, the best candidates are found early, and the
+ * traversal can be stopped at any time: after TimeLimit() seconds or after
+ * MaxNodes() nodes have been visited for each query point (but not before
+ * a leaf has been visited).  If it is not stopped, the traversal is exhaustive
+ * and gives the same results as SingleTreeTraverser.  Base cases are only
+ * computed in the leaves, so the tree must hold each point in exactly one leaf
+ * (which is not the case for spill trees).
+ *
+ * After each traversal, Completed() tells whether every node was visited or
+ * pruned, and if not, BestUnvisitedScore() is the best score of the nodes that
+ * were not visited: no reference point that was not considered has a better
+ * score.
+ *
+ * The RuleType class must implement Score(queryIndex, node), Rescore(),
+ * and BaseCase(), like NeighborSearchRules.
+ */
+template<typename TreeType, typename RuleType>
+class BestFirstSingleTreeTraverser
+{
+ public:
+  /**
+   * Instantiate the traverser with the given rule set.
+   */
+  BestFirstSingleTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse the tree with the given point, until every node is visited or
+   * pruned, or the time limit or the node budget is reached.
+   *
+   * @param queryIndex The index of the point in the query set which is being
+   *     used as the query point.
+   * @param referenceNode The tree node to be traversed.
+   */
+  void Traverse(const size_t queryIndex, TreeType& referenceNode);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+
+  //! Get the maximum time of each traversal, in seconds (0 means no limit).
+  double TimeLimit() const { return timeLimit; }
+  //! Modify the maximum time of each traversal, in seconds (0 means no limit).
+  double& TimeLimit() { return timeLimit; }
+
+  //! Get the maximum number of nodes visited in each traversal (0 means no
+  //! limit).
+  size_t MaxNodes() const { return maxNodes; }
+  //! Modify the maximum number of nodes visited in each traversal (0 means no
+  //! limit).
+  size_t& MaxNodes() { return maxNodes; }
+
+  //! Get whether the last traversal visited or pruned every node.
+  bool Completed() const { return completed; }
+  //! Get the best score of the nodes that the last traversal did not visit
+  //! (DBL_MAX if it was completed).
+  double BestUnvisitedScore() const { return bestUnvisitedScore; }
+  //! Get the number of nodes visited by the last traversal.
+  size_t NodesVisited() const { return nodesVisited; }
+
+ private:
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of nodes which have been pruned during traversal.
+  size_t numPrunes;
+
+  //! The maximum time of each traversal, in seconds.
+  double timeLimit;
+  //! The maximum number of nodes visited in each traversal.
+  size_t maxNodes;
+
+  //! Whether the last traversal visited or pruned every node.
+  bool completed;
+  //! The best score of the nodes that the last traversal did not visit.
+  double bestUnvisitedScore;
+  //! The number of nodes visited by the last traversal.
+  size_t nodesVisited;
+
+  //! The queue of nodes to visit, reused between traversals.
+  std::vector<std::pair<double, TreeType*>> queue;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "best_first_single_tree_traverser_impl.hpp"
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @file core/tree/best_first_single_tree_traverser_impl.hpp
+ *
+ * Implementation of the best-first anytime single-tree traverser.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_BEST_FIRST_SINGLE_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "best_first_single_tree_traverser.hpp"
+
+namespace mlpack {
+
+template<typename TreeType, typename RuleType>
+BestFirstSingleTreeTraverser<TreeType, RuleType>::BestFirstSingleTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    timeLimit(0.0),
+    maxNodes(0),
+    completed(true),
+    bestUnvisitedScore(DBL_MAX),
+    nodesVisited(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void BestFirstSingleTreeTraverser<TreeType, RuleType>::Traverse(
+    const size_t queryIndex,
+    TreeType& referenceNode)
+{
+  using Clock = std::chrono::steady_clock;
+  const Clock::time_point deadline = Clock::now() +
+      std::chrono::duration_cast<Clock::duration>(
+      std::chrono::duration<double>(timeLimit));
+
+  // A min-heap of the nodes to visit, by score.
+  const auto worse = [](const std::pair<double, TreeType*>& a,
+                        const std::pair<double, TreeType*>& b)
+  {
+    return a.first > b.first;
+  };
+
+  queue.clear();
+  nodesVisited = 0;
+  bool visitedLeaf = false;
+  completed = true;
+  bestUnvisitedScore = DBL_MAX;
+
+  const double rootScore = rule.Score(queryIndex, referenceNode);
+  if (rootScore == DBL_MAX)
+  {
+    ++numPrunes;
+    return;
+  }
+  queue.emplace_back(rootScore, &referenceNode);
+
+  while (!queue.empty())
+  {
+    std::pop_heap(queue.begin(), queue.end(), worse);
+    const std::pair<double, TreeType*> next = queue.back();
+    queue.pop_back();
+
+    // The bound may have improved since the node was scored.
+    const double score = rule.Rescore(queryIndex, *next.second, next.first);
+    if (score == DBL_MAX)
+    {
+      ++numPrunes;
+      continue;
+    }
+
+    // Stop if the budget is spent (but not before a leaf has been visited,
+    // so that there are candidates); the node is not visited.
+    if (visitedLeaf && ((maxNodes > 0 && nodesVisited >= maxNodes) ||
+        (timeLimit > 0.0 && Clock::now() >= deadline)))
+    {
+      completed = false;
+      bestUnvisitedScore = score;
+      break;
+    }
+
+    TreeType& node = *next.second;
+    ++nodesVisited;
+
+    // Every point is held by exactly one leaf (in the trees that hold points
+    // in internal nodes, like the cover tree, those are also in a leaf).
+    if (node.IsLeaf())
+    {
+      for (size_t i = 0; i < node.NumPoints(); ++i)
+        rule.BaseCase(queryIndex, node.Point(i));
+      visitedLeaf = true;
+    }
+
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+    {
+      const double childScore = rule.Score(queryIndex, node.Child(i));
+      if (childScore == DBL_MAX)
+      {
+        ++numPrunes;
+        continue;
+      }
+
+      queue.emplace_back(childScore, &node.Child(i));
+      std::push_heap(queue.begin(), queue.end(), worse);
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
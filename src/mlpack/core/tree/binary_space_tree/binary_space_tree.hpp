@@ -13,11 +13,41 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "../node_pool.hpp"
 #include "../statistic.hpp"
 #include "midpoint_split.hpp"
+#include "mean_split.hpp"
 
 namespace mlpack {
 
+/**
+ * IsParallelSplit is true for split types that can split disjoint nodes of the
+ * same tree at the same time, and that do not use random numbers (so that the
+ * tree does not depend on the order in which nodes are split).  When OpenMP is
+ * enabled, BinarySpaceTrees that use these splits build large subtrees in
+ * parallel.
+ */
+template<template<typename SplitBoundType, typename SplitMatType>
+         class SplitType>
+struct IsParallelSplit
+{
+  static const bool value = false;
+};
+
+//! MidpointSplit has no state, so nodes can be split in parallel.
+template<>
+struct IsParallelSplit<MidpointSplit>
+{
+  static const bool value = true;
+};
+
+//! MeanSplit has no state, so nodes can be split in parallel.
+template<>
+struct IsParallelSplit<MeanSplit>
+{
+  static const bool value = true;
+};
+
 /**
  * A binary space partitioning tree, such as a KD-tree or a ball tree.  Once the
  * bound and type of dataset is defined, the tree will construct itself.  Call
@@ -31,6 +61,15 @@ namespace mlpack {
  * This tree does take one runtime parameter in the constructor, which is the
  * max leaf size to be used.
  *
+ * The nodes of a tree that is built from a dataset are allocated from a
+ * NodePool owned by the root, so that building a tree takes only a few
+ * allocations and nodes built one after another are close in memory.
+ *
+ * If OpenMP is enabled and IsParallelSplit<SplitType> is true, subtrees with
+ * many points are built in parallel with OpenMP tasks.  Each subtree only
+ * reorders its own range of points, so the tree and the mappings are the same
+ * as for a serial build.
+ *
  * @tparam DistanceType The distance metric used for tree-building.  The
  *     BoundType may place restrictions on the metrics that can be used.
  * @tparam StatisticType Extra data contained in the node.  See statistic.hpp
@@ -88,6 +127,19 @@ class BinarySpaceTree
   //! The dataset.  If we are the root of the tree, we own the dataset and must
   //! delete it.
   MatType* dataset;
+  //! The pool that holds the memory of the nodes of the tree.  It is owned by
+  //! the root, and shared by all of its descendants.  This is NULL for trees
+  //! that were copied or loaded, whose nodes are allocated individually.
+  NodePool<BinarySpaceTree>* nodePool;
+  //! If true, the memory of this node belongs to the pool of its parent.
+  bool pooled;
+  //! If true, the descendants of this node are stored contiguously in
+  //! breadth-first order (see Compact()).
+  bool compact;
+
+  //! Children with at least this many points are built in a separate OpenMP
+  //! task, if IsParallelSplit<SplitType> is true.
+  static constexpr size_t minParallelBuildSize = 4096;
 
  public:
   //! A single-tree traverser for binary space trees; see
@@ -325,6 +377,61 @@ class BinarySpaceTree
    */
   ~BinarySpaceTree();
 
+  /**
+   * Move all descendant nodes of this tree into a single contiguous block of
+   * memory, in breadth-first order.  This can only be called on the root of
+   * the tree, and is meant to be called once the tree is fully built.  The
+   * structure of the tree does not change, so all traversers work the same
+   * way; but nodes that are visited together during a traversal are much more
+   * likely to be close in memory, which reduces cache misses for large trees.
+   *
+   * Any pointers or references to descendant nodes are invalidated.  If the
+   * tree is copied, the copy is not compacted.
+   */
+  void Compact();
+
+  //! Return whether the descendants of this node are stored contiguously (see
+  //! Compact()).
+  bool IsCompact() const { return compact; }
+
+  /**
+   * Insert the given points into the tree and into the dataset held by the
+   * tree.  This can only be called on the root of the tree.  Each point is
+   * added to the leaf whose bound is closest to it, and the bounds of that leaf
+   * and of its ancestors are expanded to hold it.  Leaves are not split, so
+   * they may grow beyond the maximum leaf size; rebuild the tree when enough
+   * points have been inserted.
+   *
+   * The points of each node must be contiguous in the dataset, so the dataset
+   * is rearranged, and `oldFromNew` (the mapping filled when the tree was
+   * built) is updated to match.  The new points are given the original indices
+   * following the existing points, as if they were appended to the original
+   * dataset.  Any references to the columns of the dataset are invalidated.
+   *
+   * @param points Points to insert.
+   * @param oldFromNew Mapping from the positions of the points in the dataset
+   *     to their original indices.
+   */
+  void Insert(const MatType& points, std::vector<size_t>& oldFromNew);
+
+  /**
+   * Remove the points with the given original indices from the tree and from
+   * the dataset held by the tree.  This can only be called on the root of the
+   * tree.  The bounds of the nodes that held the points are not tightened:
+   * they remain valid, but they may be looser than necessary until the tree is
+   * rebuilt.
+   *
+   * The dataset is rearranged and `oldFromNew` is updated, as for Insert().
+   * The remaining points are renumbered as if the points were removed from the
+   * original dataset with `shed_cols()`: each original index is reduced by the
+   * number of removed indices smaller than it.
+   *
+   * @param indices Original indices of the points to remove.
+   * @param oldFromNew Mapping from the positions of the points in the dataset
+   *     to their original indices.
+   */
+  void Remove(const arma::uvec& indices, std::vector<size_t>& oldFromNew);
+
   //! Return the bound object for this node.
   const BoundType<DistanceType, ElemType>& Bound() const { return bound; }
   //! Return the bound object for this node.
@@ -562,6 +669,55 @@ class BinarySpaceTree
    */
   void UpdateBound(HollowBallBound<DistanceType, ElemType>& boundToUpdate);
 
+  /**
+   * Build the children of this node with the given functions, which construct
+   * the left and right child.  If the node is large enough and the split type
+   * allows it, the left child is built in a separate OpenMP task.
+   *
+   * @param buildLeft Function that builds the left child.
+   * @param buildRight Function that builds the right child.
+   */
+  template<typename LeftFunction, typename RightFunction>
+  void BuildChildren(LeftFunction& buildLeft, RightFunction& buildRight);
+
+  /**
+   * Return uninitialized memory for a new child node, taken from the node pool
+   * of the tree if it has one.
+   */
+  void* AllocateNode();
+
+  /**
+   * Free the children of this node (and all their descendants), whether they
+   * are held in a node pool or were allocated individually, and set the child
+   * pointers to NULL.
+   */
+  void FreeChildren();
+
+  /**
+   * Collect the leaves of this node, in the order of their points in the
+   * dataset.
+   *
+   * @param leaves Vector to store the leaves in.
+   */
+  void GetLeaves(std::vector<BinarySpaceTree*>& leaves);
+
+  /**
+   * Set the first point and the number of points of this node and all of its
+   * descendants after the dataset has been rearranged by Insert() or
+   * Remove(), given the new number of points in each leaf.  The cached
+   * distances and the statistic of every node whose points changed are
+   * recomputed.
+   *
+   * @param leafCounts Number of points in each leaf, in the order given by
+   *     GetLeaves().
+   * @param leaf Index of the first leaf of this node in `leafCounts`; this is
+   *     advanced past the leaves of this node.
+   * @param newBegin The new index of the first point of this node.
+   */
+  void ResetCounts(const std::vector<size_t>& leafCounts,
+                   size_t& leaf,
+                   const size_t newBegin);
+
  public:
   /**
    * Serialize the tree.
@@ -15,8 +15,13 @@
 #include "binary_space_tree.hpp"
 
 #include <mlpack/core/util/log.hpp>
+#include <map>
 #include <queue>
 
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 
 // Default constructor.
@@ -38,7 +43,10 @@ BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
     stat(*this),
     parentDistance(0),
     furthestDescendantDistance(0),
-    dataset(NULL)
+    dataset(NULL),
+    nodePool(NULL),
+    pooled(false),
+    compact(false)
 {
   // Nothing to do.
 }
@@ -64,7 +72,10 @@ BinarySpaceTree(
     count(data.n_cols), /* and spans all of the dataset. */
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodePool(new NodePool<BinarySpaceTree>()),
+    pooled(false),
+    compact(false)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<DistanceType, ElemType>, MatType> splitter;
@@ -94,7 +105,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodePool(new NodePool<BinarySpaceTree>()),
+    pooled(false),
+    compact(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(data.n_cols);
@@ -130,7 +144,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(data)) // Copies the dataset.
+    dataset(new MatType(data)), // Copies the dataset.
+    nodePool(new NodePool<BinarySpaceTree>()),
+    pooled(false),
+    compact(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(data.n_cols);
@@ -167,7 +184,10 @@ BinarySpaceTree(MatType&& data, const size_t maxLeafSize) :
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodePool(new NodePool<BinarySpaceTree>()),
+    pooled(false),
+    compact(false)
 {
   // Do the actual splitting of this node.
   SplitType<BoundType<DistanceType, ElemType>, MatType> splitter;
@@ -197,7 +217,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodePool(new NodePool<BinarySpaceTree>()),
+    pooled(false),
+    compact(false)
 {
   // Initialize oldFromNew correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -233,7 +256,10 @@ BinarySpaceTree(
     count(data.n_cols),
     bound(data.n_rows),
     parentDistance(0), // Parent distance for the root is 0: it has no parent.
-    dataset(new MatType(std::move(data)))
+    dataset(new MatType(std::move(data))),
+    nodePool(new NodePool<BinarySpaceTree>()),
+    pooled(false),
+    compact(false)
 {
   // Initialize the oldFromNew vector correctly.
   oldFromNew.resize(dataset->n_cols);
@@ -274,7 +300,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset()) // Point to the parent's dataset.
+    dataset(&parent->Dataset()), // Point to the parent's dataset.
+    nodePool(parent->nodePool),
+    pooled(parent->nodePool != NULL),
+    compact(false)
 {
   // Perform the actual splitting.
   SplitNode(maxLeafSize, splitter);
@@ -305,7 +334,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset().n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodePool(parent->nodePool),
+    pooled(parent->nodePool != NULL),
+    compact(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -341,7 +373,10 @@ BinarySpaceTree(
     begin(begin),
     count(count),
     bound(parent->Dataset()->n_rows),
-    dataset(&parent->Dataset())
+    dataset(&parent->Dataset()),
+    nodePool(parent->nodePool),
+    pooled(parent->nodePool != NULL),
+    compact(false)
 {
   // Hopefully the vector is initialized correctly!  We can't check that
   // entirely but we can do a minor sanity check.
@@ -385,7 +420,10 @@ BinarySpaceTree(
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
     // Copy matrix, but only if we are the root.
-    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL)
+    dataset((other.parent == NULL) ? new MatType(*other.dataset) : NULL),
+    nodePool(NULL),
+    pooled(false),
+    compact(false)
 {
   // Create left and right children (if any).
   if (other.Left())
@@ -443,8 +481,11 @@ operator=(const BinarySpaceTree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  FreeChildren();
+  if (!pooled)
+    delete nodePool;
+  nodePool = NULL;
+  compact = false;
 
   left = NULL;
   right = NULL;
@@ -517,8 +558,11 @@ operator=(BinarySpaceTree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  delete left;
-  delete right;
+  FreeChildren();
+  if (!pooled)
+    delete nodePool;
+  nodePool = NULL;
+  compact = false;
 
   parent = other.Parent();
   left = other.Left();
@@ -531,6 +575,8 @@ operator=(BinarySpaceTree&& other)
   furthestDescendantDistance = other.FurthestDescendantDistance();
   minimumBoundDistance = other.MinimumBoundDistance();
   dataset = other.dataset;
+  nodePool = other.pooled ? NULL : other.nodePool;
+  compact = other.compact;
 
   other.left = NULL;
   other.right = NULL;
@@ -541,6 +587,14 @@ operator=(BinarySpaceTree&& other)
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodePool = NULL;
+  other.compact = false;
+
+  // Set new parent.
+  if (left)
+    left->parent = this;
+  if (right)
+    right->parent = this;
 
   return *this;
 }
@@ -569,7 +623,10 @@ BinarySpaceTree(BinarySpaceTree&& other) :
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
     minimumBoundDistance(other.minimumBoundDistance),
-    dataset(other.dataset)
+    dataset(other.dataset),
+    nodePool(other.pooled ? NULL : other.nodePool),
+    pooled(false),
+    compact(other.compact)
 {
   // Now we are a clone of the other tree.  But we must also clear the other
   // tree's contents, so it doesn't delete anything when it is destructed.
@@ -582,6 +639,8 @@ BinarySpaceTree(BinarySpaceTree&& other) :
   other.furthestDescendantDistance = 0.0;
   other.minimumBoundDistance = 0.0;
   other.dataset = NULL;
+  other.nodePool = NULL;
+  other.compact = false;
 
   // Set new parent.
   if (left)
@@ -629,8 +688,12 @@ template<typename DistanceType,
 BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
     ~BinarySpaceTree()
 {
-  delete left;
-  delete right;
+  FreeChildren();
+
+  // The memory of our descendants can only be released once they have all been
+  // destroyed.
+  if (!pooled)
+    delete nodePool;
 
   // If we're the root, delete the matrix.
   if (!parent)
@@ -988,10 +1051,17 @@ BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
 
   // Now that we know the split column, we will recursively split the children
   // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, splitter,
-      maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      splitter, maxLeafSize);
+  auto buildLeft = [&]()
+  {
+    left = new (AllocateNode()) BinarySpaceTree(this, begin, splitCol - begin,
+        splitter, maxLeafSize);
+  };
+  auto buildRight = [&]()
+  {
+    right = new (AllocateNode()) BinarySpaceTree(this, splitCol,
+        begin + count - splitCol, splitter, maxLeafSize);
+  };
+  BuildChildren(buildLeft, buildRight);
 
   // Calculate parent distances for those two nodes.
   arma::Col<ElemType> center, leftCenter, rightCenter;
@@ -1058,11 +1128,19 @@ SplitNode(std::vector<size_t>& oldFromNew,
   assert(splitCol < begin + count);
 
   // Now that we know the split column, we will recursively split the children
-  // by calling their constructors (which perform this splitting process).
-  left = new BinarySpaceTree(this, begin, splitCol - begin, oldFromNew,
-      splitter, maxLeafSize);
-  right = new BinarySpaceTree(this, splitCol, begin + count - splitCol,
-      oldFromNew, splitter, maxLeafSize);
+  // by calling their constructors (which perform this splitting process).  The
+  // children write to disjoint ranges of oldFromNew.
+  auto buildLeft = [&]()
+  {
+    left = new (AllocateNode()) BinarySpaceTree(this, begin, splitCol - begin,
+        oldFromNew, splitter, maxLeafSize);
+  };
+  auto buildRight = [&]()
+  {
+    right = new (AllocateNode()) BinarySpaceTree(this, splitCol,
+        begin + count - splitCol, oldFromNew, splitter, maxLeafSize);
+  };
+  BuildChildren(buildLeft, buildRight);
 
   // Calculate parent distances for those two nodes.
   arma::Col<ElemType> center, leftCenter, rightCenter;
@@ -1125,6 +1203,480 @@ UpdateBound(HollowBallBound<DistanceType, ElemType>& boundToUpdate)
     boundToUpdate |= dataset->cols(begin, begin + count - 1);
 }
 
+/**
+ * Move all descendant nodes into one contiguous block of memory, in
+ * breadth-first order.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    Compact()
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Compact(): can only be "
+        "called on the root of a tree!");
+  }
+
+  // If the nodes are already stored contiguously, they are already in
+  // breadth-first order.
+  if (compact || left == NULL)
+    return;
+
+  // Collect all descendants in breadth-first order, along with the position of
+  // their children in that order.  The root has children at positions 0 and 1.
+  std::vector<BinarySpaceTree*> nodes;
+  std::vector<size_t> leftIndices, rightIndices;
+  nodes.push_back(left);
+  nodes.push_back(right);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    leftIndices.push_back(nodes.size());
+    rightIndices.push_back(nodes.size() + 1);
+    if (nodes[i]->left)
+    {
+      nodes.push_back(nodes[i]->left);
+      nodes.push_back(nodes[i]->right);
+    }
+  }
+
+  // Move each node into a new pool whose first block holds the whole tree.
+  // Each old node is left empty by the move, so it can be destroyed without
+  // affecting the rest of the tree.  Nodes that were allocated individually may
+  // own a pool of their own; those can only be freed once every old node has
+  // been destroyed.
+  NodePool<BinarySpaceTree>* newPool =
+      new NodePool<BinarySpaceTree>(nodes.size());
+  std::vector<NodePool<BinarySpaceTree>*> oldPools;
+  if (!pooled)
+    oldPools.push_back(nodePool);
+
+  std::vector<BinarySpaceTree*> newNodes(nodes.size());
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    newNodes[i] = new (newPool->Allocate())
+        BinarySpaceTree(std::move(*nodes[i]));
+    oldPools.push_back(newNodes[i]->nodePool);
+    newNodes[i]->nodePool = newPool;
+    newNodes[i]->pooled = true;
+
+    if (nodes[i]->pooled)
+      nodes[i]->~BinarySpaceTree();
+    else
+      delete nodes[i];
+  }
+
+  for (size_t i = 0; i < oldPools.size(); ++i)
+    delete oldPools[i];
+
+  // Now point every node at the copies of its children and parent.
+  left = newNodes[0];
+  right = newNodes[1];
+  left->parent = this;
+  right->parent = this;
+  for (size_t i = 0; i < newNodes.size(); ++i)
+  {
+    if (newNodes[i]->left)
+    {
+      newNodes[i]->left = newNodes[leftIndices[i]];
+      newNodes[i]->right = newNodes[rightIndices[i]];
+      newNodes[i]->left->parent = newNodes[i];
+      newNodes[i]->right->parent = newNodes[i];
+    }
+  }
+
+  nodePool = newPool;
+  pooled = false;
+  compact = true;
+}
+
+/**
+ * Insert points into the leaves of the tree, expanding the bounds on the way.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    Insert(const MatType& points, std::vector<size_t>& oldFromNew)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Insert(): can only be "
+        "called on the root of a tree!");
+  }
+
+  if (oldFromNew.size() != dataset->n_cols)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Insert(): oldFromNew must "
+        "hold one index for each point in the tree!");
+  }
+
+  if (points.n_cols == 0)
+    return;
+
+  // A tree built on an empty dataset has no dimensionality yet.
+  if (dataset->n_cols == 0 && left == NULL)
+  {
+    dataset->set_size(points.n_rows, 0);
+    bound = BoundType<DistanceType, ElemType>(points.n_rows);
+  }
+
+  if (points.n_rows != dataset->n_rows)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Insert(): points must have "
+        "the same dimensionality as the dataset!");
+  }
+
+  // Find the leaf that each point belongs to.  At each node, the point goes to
+  // the child whose bound is closest to it; if the point is equally close to
+  // both children, it goes to the child with fewer points.
+  std::vector<BinarySpaceTree*> pointLeaves(points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const arma::Col<ElemType> point(points.col(i));
+    BinarySpaceTree* node = this;
+    node->bound |= points.cols(i, i);
+    while (node->left != NULL)
+    {
+      const ElemType leftDistance = node->left->bound.MinDistance(point);
+      const ElemType rightDistance = node->right->bound.MinDistance(point);
+      if (leftDistance < rightDistance || (leftDistance == rightDistance &&
+          node->left->count <= node->right->count))
+        node = node->left;
+      else
+        node = node->right;
+
+      node->bound |= points.cols(i, i);
+    }
+
+    pointLeaves[i] = node;
+  }
+
+  std::vector<BinarySpaceTree*> leaves;
+  GetLeaves(leaves);
+  std::map<const BinarySpaceTree*, size_t> leafIndices;
+  for (size_t j = 0; j < leaves.size(); ++j)
+    leafIndices[leaves[j]] = j;
+
+  std::vector<std::vector<size_t>> newPoints(leaves.size());
+  for (size_t i = 0; i < points.n_cols; ++i)
+    newPoints[leafIndices[pointLeaves[i]]].push_back(i);
+
+  // Lay out the dataset again, with the new points of each leaf after its
+  // existing points.
+  const size_t oldSize = dataset->n_cols;
+  MatType newDataset(dataset->n_rows, oldSize + points.n_cols);
+  std::vector<size_t> newOldFromNew(newDataset.n_cols);
+  std::vector<size_t> leafCounts(leaves.size());
+  size_t position = 0;
+  for (size_t j = 0; j < leaves.size(); ++j)
+  {
+    const BinarySpaceTree* leaf = leaves[j];
+    for (size_t k = 0; k < leaf->count; ++k, ++position)
+    {
+      newDataset.col(position) = dataset->col(leaf->begin + k);
+      newOldFromNew[position] = oldFromNew[leaf->begin + k];
+    }
+
+    for (size_t k = 0; k < newPoints[j].size(); ++k, ++position)
+    {
+      newDataset.col(position) = points.col(newPoints[j][k]);
+      newOldFromNew[position] = oldSize + newPoints[j][k];
+    }
+
+    leafCounts[j] = leaf->count + newPoints[j].size();
+  }
+
+  *dataset = std::move(newDataset);
+  oldFromNew.swap(newOldFromNew);
+
+  size_t leaf = 0;
+  ResetCounts(leafCounts, leaf, 0);
+}
+
+/**
+ * Remove points from the leaves of the tree, leaving the bounds as they are.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    Remove(const arma::uvec& indices, std::vector<size_t>& oldFromNew)
+{
+  if (parent != NULL)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Remove(): can only be "
+        "called on the root of a tree!");
+  }
+
+  if (oldFromNew.size() != dataset->n_cols)
+  {
+    throw std::invalid_argument("BinarySpaceTree::Remove(): oldFromNew must "
+        "hold one index for each point in the tree!");
+  }
+
+  // Mark the points to remove by their original index.
+  std::vector<bool> removed(oldFromNew.size(), false);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    if (indices[i] >= removed.size())
+    {
+      throw std::invalid_argument("BinarySpaceTree::Remove(): point index "
+          "out of range!");
+    }
+
+    removed[indices[i]] = true;
+  }
+
+  // Each remaining point moves down by the number of removed points before it
+  // in the original order.
+  std::vector<size_t> shift(removed.size());
+  size_t numRemoved = 0;
+  for (size_t i = 0; i < removed.size(); ++i)
+  {
+    shift[i] = numRemoved;
+    if (removed[i])
+      ++numRemoved;
+  }
+
+  if (numRemoved == 0)
+    return;
+
+  std::vector<BinarySpaceTree*> leaves;
+  GetLeaves(leaves);
+
+  MatType newDataset(dataset->n_rows, dataset->n_cols - numRemoved);
+  std::vector<size_t> newOldFromNew(newDataset.n_cols);
+  std::vector<size_t> leafCounts(leaves.size());
+  size_t position = 0;
+  for (size_t j = 0; j < leaves.size(); ++j)
+  {
+    const BinarySpaceTree* leaf = leaves[j];
+    const size_t leafBegin = position;
+    for (size_t k = 0; k < leaf->count; ++k)
+    {
+      const size_t oldIndex = oldFromNew[leaf->begin + k];
+      if (removed[oldIndex])
+        continue;
+
+      newDataset.col(position) = dataset->col(leaf->begin + k);
+      newOldFromNew[position] = oldIndex - shift[oldIndex];
+      ++position;
+    }
+
+    leafCounts[j] = position - leafBegin;
+  }
+
+  *dataset = std::move(newDataset);
+  oldFromNew.swap(newOldFromNew);
+
+  size_t leaf = 0;
+  ResetCounts(leafCounts, leaf, 0);
+}
+
+/**
+ * Collect the leaves of the tree in the order of the dataset.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    GetLeaves(std::vector<BinarySpaceTree*>& leaves)
+{
+  if (left == NULL)
+  {
+    leaves.push_back(this);
+  }
+  else
+  {
+    left->GetLeaves(leaves);
+    right->GetLeaves(leaves);
+  }
+}
+
+/**
+ * Update the points held by each node after the dataset was rearranged.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    ResetCounts(const std::vector<size_t>& leafCounts,
+                size_t& leaf,
+                const size_t newBegin)
+{
+  const size_t oldCount = count;
+  begin = newBegin;
+  if (left == NULL)
+  {
+    count = leafCounts[leaf];
+    ++leaf;
+  }
+  else
+  {
+    left->ResetCounts(leafCounts, leaf, begin);
+    right->ResetCounts(leafCounts, leaf, begin + left->count);
+    count = left->count + right->count;
+  }
+
+  // Points are only ever added or only ever removed at once, so the points of
+  // a node have changed if and only if their number has.
+  if (count == oldCount)
+    return;
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+  if (left != NULL)
+  {
+    arma::Col<ElemType> center, leftCenter, rightCenter;
+    Center(center);
+    left->Center(leftCenter);
+    right->Center(rightCenter);
+
+    left->ParentDistance() = bound.Distance().Evaluate(center, leftCenter);
+    right->ParentDistance() = bound.Distance().Evaluate(center, rightCenter);
+  }
+
+  stat = StatisticType(*this);
+}
+
+/**
+ * Build the children of this node, in parallel if the node is large enough.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+template<typename LeftFunction, typename RightFunction>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    BuildChildren(LeftFunction& buildLeft, RightFunction& buildRight)
+{
+  #ifdef MLPACK_USE_OPENMP
+  if (IsParallelSplit<SplitType>::value && count >= minParallelBuildSize &&
+      omp_get_max_threads() > 1)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is large enough; start a team of threads
+      // that will run the tasks created below this node.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          #pragma omp task
+          buildLeft();
+
+          buildRight();
+          #pragma omp taskwait
+        }
+      }
+    }
+    else
+    {
+      #pragma omp task
+      buildLeft();
+
+      buildRight();
+      #pragma omp taskwait
+    }
+
+    return;
+  }
+  #endif
+
+  buildLeft();
+  buildRight();
+}
+
+/**
+ * Get memory for a new child node: from the node pool of the tree if there is
+ * one, and from the heap otherwise.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void*
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    AllocateNode()
+{
+  if (nodePool != NULL)
+    return nodePool->Allocate();
+  else
+    return ::operator new(sizeof(BinarySpaceTree));
+}
+
+/**
+ * Free the children of this node, whether they are held in a node pool or were
+ * allocated individually.
+ */
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename BoundDistanceType,
+                  typename BoundElemType,
+                  typename...> class BoundType,
+         template<typename SplitBoundType,
+                  typename SplitMatType> class SplitType>
+void
+BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
+    FreeChildren()
+{
+  // The memory of pooled nodes is released when the pool is destroyed.
+  BinarySpaceTree* children[2] = { left, right };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    if (children[i] == NULL)
+      continue;
+    else if (children[i]->pooled)
+      children[i]->~BinarySpaceTree();
+    else
+      delete children[i];
+  }
+
+  left = NULL;
+  right = NULL;
+}
+
 /**
  * Serialize the tree.
  */
@@ -1144,13 +1696,15 @@ BinarySpaceTree<DistanceType, StatisticType, MatType, BoundType, SplitType>::
   // If we're loading, and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    if (left)
-      delete left;
-    if (right)
-      delete right;
+    FreeChildren();
+    if (!pooled)
+      delete nodePool;
     if (!parent)
       delete dataset;
 
+    nodePool = NULL;
+    compact = false;
+
     parent = NULL;
     left = NULL;
     right = NULL;
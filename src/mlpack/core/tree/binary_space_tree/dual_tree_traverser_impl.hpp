@@ -17,6 +17,8 @@
 // In case it hasn't been included yet.
 #include "dual_tree_traverser.hpp"
 
+#include <mlpack/core/tree/block_base_case.hpp>
+
 namespace mlpack {
 
 template<typename DistanceType,
@@ -78,21 +80,45 @@ DualTreeTraverser<RuleType>::Traverse(
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.Begin() + queryNode.Count();
     const size_t refEnd = referenceNode.Begin() + referenceNode.Count();
-    for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+    if constexpr (HasBlockBaseCase<RuleType>::value)
     {
-      // See if we need to investigate this point (this function should be
-      // implemented for the single-tree recursion too).  Restore the traversal
-      // information first.
-      rule.TraversalInfo() = traversalInfo;
-      const double childScore = rule.Score(query, referenceNode);
+      // Collect the query points that we need to investigate, and then let the
+      // rules evaluate all of their base cases at once.
+      arma::uvec queries(queryNode.Count());
+      size_t numQueries = 0;
+      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+      {
+        rule.TraversalInfo() = traversalInfo;
+        if (rule.Score(query, referenceNode) != DBL_MAX)
+          queries[numQueries++] = query;
+      }
 
-      if (childScore == DBL_MAX)
-        continue; // We can't improve this particular point.
+      if (numQueries > 0)
+      {
+        queries.resize(numQueries);
+        rule.BlockBaseCase(queries, referenceNode.Begin(),
+            referenceNode.Count());
+        numBaseCases += numQueries * referenceNode.Count();
+      }
+    }
+    else
+    {
+      for (size_t query = queryNode.Begin(); query < queryEnd; ++query)
+      {
+        // See if we need to investigate this point (this function should be
+        // implemented for the single-tree recursion too).  Restore the
+        // traversal information first.
+        rule.TraversalInfo() = traversalInfo;
+        const double childScore = rule.Score(query, referenceNode);
+
+        if (childScore == DBL_MAX)
+          continue; // We can't improve this particular point.
 
-      for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
-        rule.BaseCase(query, ref);
+        for (size_t ref = referenceNode.Begin(); ref < refEnd; ++ref)
+          rule.BaseCase(query, ref);
 
-      numBaseCases += referenceNode.Count();
+        numBaseCases += referenceNode.Count();
+      }
     }
   }
   else if (((!queryNode.IsLeaf()) && referenceNode.IsLeaf()) ||
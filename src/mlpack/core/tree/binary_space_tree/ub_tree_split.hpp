@@ -36,8 +36,9 @@ class UBTreeSplit
   //! An information about the partition.
   struct SplitInfo
   {
-    //! This vector contains addresses of all points in the dataset.
-    std::vector<std::pair<arma::Col<AddressElemType>, size_t>>* addresses;
+    //! The old index of each point, in the order of the addresses, if the
+    //! dataset has to be rearranged (only for the root); otherwise NULL.
+    const std::vector<size_t>* order;
   };
 
   /**
@@ -90,23 +91,42 @@ class UBTreeSplit
                              std::vector<size_t>& oldFromNew);
 
  private:
-  //! This vector contains addresses of all points in the dataset.
-  std::vector<std::pair<arma::Col<AddressElemType>, size_t>> addresses;
+  //! The addresses of all points in the dataset, one per column, in sorted
+  //! order.  They are computed once, for the root, and used by all nodes.
+  arma::Mat<AddressElemType> addresses;
+  //! The old index of each point, in the order of the addresses.
+  std::vector<size_t> addressOrder;
 
   /**
-   * Calculate addresses for all points in the dataset.
+   * Calculate the addresses of all points in the dataset (in parallel), and
+   * sort them.
    *
    * @param data The dataset used by the binary space tree.
    */
   void InitializeAddresses(const MatType& data);
 
-  //! A comparator for sorting addresses.
-  static bool ComparePair(
-      const std::pair<arma::Col<AddressElemType>, size_t>& p1,
-      const std::pair<arma::Col<AddressElemType>, size_t>& p2)
-  {
-    return CompareAddresses(p1.first, p2.first) < 0;
-  }
+  /**
+   * Sort the given indices by their addresses in the given unsorted matrix of
+   * addresses, with a most-significant-digit radix sort over the bytes of the
+   * address words, starting at the given byte.  The sort is stable.  Large
+   * buckets are sorted in parallel with OpenMP tasks.
+   *
+   * @param unsorted Addresses of the points, one per column.
+   * @param indices Indices to sort.
+   * @param buffer Temporary storage for as many indices.
+   * @param count Number of indices to sort.
+   * @param digit First byte of the addresses that may differ.
+   */
+  static void RadixSort(const arma::Mat<AddressElemType>& unsorted,
+                        size_t* indices,
+                        size_t* buffer,
+                        const size_t count,
+                        size_t digit);
+
+  //! Ranges with at most this many indices are sorted with std::sort().
+  static constexpr size_t minRadixSortSize = 64;
+  //! Buckets with at least this many indices are sorted in parallel.
+  static constexpr size_t minParallelSortSize = 16384;
 };
 
 } // namespace mlpack
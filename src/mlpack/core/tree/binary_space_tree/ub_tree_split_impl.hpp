@@ -16,6 +16,10 @@
 #include "ub_tree_split.hpp"
 #include <mlpack/core/tree/bounds.hpp>
 
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 
 template<typename BoundType, typename MatType>
@@ -28,20 +32,17 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
   constexpr size_t order = sizeof(AddressElemType) * CHAR_BIT;
   if (begin == 0 && count == data.n_cols)
   {
-    // Calculate all addresses.
+    // Calculate and sort all addresses.  They are kept for the splits of all
+    // the descendants of this node.
     InitializeAddresses(data);
 
-    // Probably this is not a good idea. Maybe it is better to get
-    // a number of distinct samples and find the median.
-    std::sort(addresses.begin(), addresses.end(), ComparePair);
-
-    // Save the vector in order to rearrange the dataset later.
-    splitInfo.addresses = &addresses;
+    // Save the order in order to rearrange the dataset later.
+    splitInfo.order = &addressOrder;
   }
   else
   {
     // We have already rearranged the dataset.
-    splitInfo.addresses = NULL;
+    splitInfo.order = NULL;
   }
 
   // The bound shouldn't contain too many subrectangles.
@@ -53,8 +54,8 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
   {
     // Omit leading equal bits.
     size_t row = 0;
-    arma::Col<AddressElemType>& lo = addresses[begin + count - 1].first;
-    const arma::Col<AddressElemType>& hi = addresses[begin + count].first;
+    AddressElemType* lo = addresses.colptr(begin + count - 1);
+    const AddressElemType* hi = addresses.colptr(begin + count);
 
     for (; row < data.n_rows; row++)
       if (lo[row] != hi[row])
@@ -96,8 +97,8 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
   {
     // Omit leading equal bits.
     size_t row = 0;
-    const arma::Col<AddressElemType>& lo = addresses[begin - 1].first;
-    arma::Col<AddressElemType>& hi = addresses[begin].first;
+    const AddressElemType* lo = addresses.colptr(begin - 1);
+    AddressElemType* hi = addresses.colptr(begin);
 
     for (; row < data.n_rows; row++)
       if (lo[row] != hi[row])
@@ -133,8 +134,8 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
   // Set the minimum and the maximum addresses.
   for (size_t k = 0; k < bound.Dim(); ++k)
   {
-    bound.LoAddress()[k] = addresses[begin].first[k];
-    bound.HiAddress()[k] = addresses[begin + count - 1].first[k];
+    bound.LoAddress()[k] = addresses(k, begin);
+    bound.HiAddress()[k] = addresses(k, begin + count - 1);
   }
   bound.UpdateAddressBounds(data.cols(begin, begin + count - 1));
 
@@ -144,52 +145,201 @@ bool UBTreeSplit<BoundType, MatType>::SplitNode(BoundType& bound,
 template<typename BoundType, typename MatType>
 void UBTreeSplit<BoundType, MatType>::InitializeAddresses(const MatType& data)
 {
-  addresses.resize(data.n_cols);
+  const size_t n = data.n_cols;
 
   // Calculate all addresses.
-  for (size_t i = 0; i < data.n_cols; ++i)
+  arma::Mat<AddressElemType> unsorted(data.n_rows, n);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n; ++i)
   {
-    addresses[i].first.zeros(data.n_rows);
-    PointToAddress(addresses[i].first, data.col(i));
-    addresses[i].second = i;
+    arma::Col<AddressElemType> address(unsorted.colptr(i), data.n_rows,
+        false, true);
+    PointToAddress(address, data.col(i));
   }
+
+  // Sort the points by their addresses.
+  addressOrder.resize(n);
+  for (size_t i = 0; i < n; ++i)
+    addressOrder[i] = i;
+
+  std::vector<size_t> buffer(n);
+  RadixSort(unsorted, addressOrder.data(), buffer.data(), n, 0);
+
+  // Keep the sorted addresses, so that each node uses contiguous columns.
+  addresses.set_size(data.n_rows, n);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n; ++i)
+    addresses.col(i) = unsorted.col(addressOrder[i]);
 }
 
 template<typename BoundType, typename MatType>
-size_t UBTreeSplit<BoundType, MatType>::PerformSplit(
-    MatType& data,
-    const size_t begin,
+void UBTreeSplit<BoundType, MatType>::RadixSort(
+    const arma::Mat<AddressElemType>& unsorted,
+    size_t* indices,
+    size_t* buffer,
     const size_t count,
-    const SplitInfo& splitInfo)
+    size_t digit)
 {
-  // For the first time we have to rearrange the dataset.
-  if (splitInfo.addresses)
+  constexpr size_t bytesPerWord = sizeof(AddressElemType);
+  const size_t numDigits = unsorted.n_rows * bytesPerWord;
+
+  // The first word of an address is the most significant, and so is the
+  // first byte of each word.
+  auto byteOf = [&](const size_t index, const size_t d)
+  {
+    const size_t shift = (bytesPerWord - 1 - d % bytesPerWord) * CHAR_BIT;
+    return (size_t) ((unsorted(d / bytesPerWord, index) >> shift) & 255);
+  };
+
+  if (count <= minRadixSortSize)
   {
-    std::vector<size_t> newFromOld(data.n_cols);
-    std::vector<size_t> oldFromNew(data.n_cols);
+    // The indices of equal addresses are still in increasing order, so ties
+    // broken by the index keep the sort stable.
+    const size_t firstWord = digit / bytesPerWord;
+    std::sort(indices, indices + count, [&](const size_t a, const size_t b)
+    {
+      for (size_t w = firstWord; w < unsorted.n_rows; ++w)
+        if (unsorted(w, a) != unsorted(w, b))
+          return unsorted(w, a) < unsorted(w, b);
+      return a < b;
+    });
+    return;
+  }
 
-    for (size_t i = 0; i < splitInfo.addresses->size(); ++i)
+  // Large ranges that are not sorted in parallel already are counted and
+  // scattered in chunks, one chunk per thread.  The offsets are laid out so
+  // that the indices of a chunk go after the indices with the same digit in
+  // the earlier chunks, which keeps the sort stable and independent of the
+  // number of threads.
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numChunks = (omp_in_parallel() || count < minParallelSortSize)
+      ? 1 : std::max((size_t) 1, std::min((size_t) omp_get_max_threads(),
+      count / minParallelSortSize));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  std::vector<size_t> offsets(256 * numChunks);
+  size_t bucketBegins[257];
+
+  // Skip the digits that are the same for all the addresses.
+  for (; digit < numDigits; ++digit)
+  {
+    std::fill(offsets.begin(), offsets.end(), 0);
+
+    #pragma omp parallel for schedule(static) if (numChunks > 1)
+    for (size_t c = 0; c < numChunks; ++c)
     {
-      newFromOld[i] = i;
-      oldFromNew[i] = i;
+      size_t* chunkOffsets = offsets.data() + 256 * c;
+      const size_t last = (c + 1) * count / numChunks;
+      for (size_t i = c * count / numChunks; i < last; ++i)
+        ++chunkOffsets[byteOf(indices[i], digit)];
     }
 
-    for (size_t i = 0; i < splitInfo.addresses->size(); ++i)
+    size_t total = 0;
+    size_t numBuckets = 0;
+    for (size_t v = 0; v < 256; ++v)
     {
-      size_t index = (*splitInfo.addresses)[i].second;
-      size_t oldI = oldFromNew[i];
-      size_t newIndex = newFromOld[index];
+      bucketBegins[v] = total;
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        const size_t chunkCount = offsets[256 * c + v];
+        offsets[256 * c + v] = total;
+        total += chunkCount;
+      }
+
+      if (total > bucketBegins[v])
+        ++numBuckets;
+    }
+    bucketBegins[256] = total;
 
-      data.swap_cols(i, newFromOld[index]);
+    if (numBuckets > 1)
+      break;
+  }
 
-      size_t tmp = newFromOld[index];
-      newFromOld[index] = i;
-      newFromOld[oldI] = tmp;
+  // All the addresses are equal.
+  if (digit == numDigits)
+    return;
 
-      tmp = oldFromNew[i];
-      oldFromNew[i] = oldFromNew[newIndex];
-      oldFromNew[newIndex] = tmp;
+  #pragma omp parallel for schedule(static) if (numChunks > 1)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    size_t* chunkOffsets = offsets.data() + 256 * c;
+    const size_t last = (c + 1) * count / numChunks;
+    for (size_t i = c * count / numChunks; i < last; ++i)
+      buffer[chunkOffsets[byteOf(indices[i], digit)]++] = indices[i];
+  }
+  std::copy(buffer, buffer + count, indices);
+
+  // Sort each bucket by the following digits.
+  auto sortBucket = [&](const size_t v)
+  {
+    const size_t bucketBegin = bucketBegins[v];
+    RadixSort(unsorted, indices + bucketBegin, buffer + bucketBegin,
+        bucketBegins[v + 1] - bucketBegin, digit + 1);
+  };
+
+  #ifdef MLPACK_USE_OPENMP
+  if (count >= minParallelSortSize && omp_get_max_threads() > 1)
+  {
+    // Sort the large buckets with tasks; the buckets use disjoint parts of
+    // the indices and the buffer.
+    auto sortBuckets = [&]()
+    {
+      for (size_t v = 0; v < 256; ++v)
+      {
+        if (bucketBegins[v + 1] - bucketBegins[v] >= minParallelSortSize)
+        {
+          #pragma omp task firstprivate(v)
+          sortBucket(v);
+        }
+        else if (bucketBegins[v + 1] - bucketBegins[v] > 1)
+        {
+          sortBucket(v);
+        }
+      }
+      #pragma omp taskwait
+    };
+
+    if (!omp_in_parallel())
+    {
+      // Start a team of threads that will run the tasks created below.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        sortBuckets();
+      }
     }
+    else
+    {
+      sortBuckets();
+    }
+
+    return;
+  }
+  #endif
+
+  for (size_t v = 0; v < 256; ++v)
+    if (bucketBegins[v + 1] - bucketBegins[v] > 1)
+      sortBucket(v);
+}
+
+template<typename BoundType, typename MatType>
+size_t UBTreeSplit<BoundType, MatType>::PerformSplit(
+    MatType& data,
+    const size_t begin,
+    const size_t count,
+    const SplitInfo& splitInfo)
+{
+  // For the first time we have to rearrange the dataset.
+  if (splitInfo.order)
+  {
+    const std::vector<size_t>& sortedOrder = *splitInfo.order;
+    MatType sorted(data.n_rows, data.n_cols);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < sortedOrder.size(); ++i)
+      sorted.col(i) = data.col(sortedOrder[i]);
+    data = std::move(sorted);
   }
 
   // Since the dataset is sorted we can easily obtain the split column.
@@ -205,29 +355,15 @@ size_t UBTreeSplit<BoundType, MatType>::PerformSplit(
     std::vector<size_t>& oldFromNew)
 {
   // For the first time we have to rearrange the dataset.
-  if (splitInfo.addresses)
+  if (splitInfo.order)
   {
-    std::vector<size_t> newFromOld(data.n_cols);
+    PerformSplit(data, begin, count, splitInfo);
 
-    for (size_t i = 0; i < splitInfo.addresses->size(); ++i)
-      newFromOld[i] = i;
-
-    for (size_t i = 0; i < splitInfo.addresses->size(); ++i)
-    {
-      size_t index = (*splitInfo.addresses)[i].second;
-      size_t oldI = oldFromNew[i];
-      size_t newIndex = newFromOld[index];
-
-      data.swap_cols(i, newFromOld[index]);
-
-      size_t tmp = newFromOld[index];
-      newFromOld[index] = i;
-      newFromOld[oldI] = tmp;
-
-      tmp = oldFromNew[i];
-      oldFromNew[i] = oldFromNew[newIndex];
-      oldFromNew[newIndex] = tmp;
-    }
+    const std::vector<size_t>& sortedOrder = *splitInfo.order;
+    std::vector<size_t> newOldFromNew(sortedOrder.size());
+    for (size_t i = 0; i < sortedOrder.size(); ++i)
+      newOldFromNew[i] = oldFromNew[sortedOrder[i]];
+    oldFromNew = std::move(newOldFromNew);
   }
 
   // Since the dataset is sorted we can easily obtain the split column.
@@ -0,0 +1,39 @@
+/**
+ * @file core/tree/block_base_case.hpp
+ *
+ * Definition of HasBlockBaseCase, used by traversers to detect whether a
+ * RuleType can compute the base cases of a whole leaf at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_BLOCK_BASE_CASE_HPP
+#define MLPACK_CORE_TREE_BLOCK_BASE_CASE_HPP
+
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+
+/**
+ * HasBlockBaseCase<RuleType>::value is true if the given RuleType has a method
+ * of the form
+ *
+ * @code
+ * void BlockBaseCase(const arma::uvec& queryIndices,
+ *                    const size_t referenceBegin,
+ *                    const size_t referenceCount);
+ * @endcode
+ *
+ * which must have the same effect as calling BaseCase(q, r) for every query
+ * point q in `queryIndices` and every r in [referenceBegin, referenceBegin +
+ * referenceCount).  Traversers for trees whose leaves hold contiguous points
+ * (such as the BinarySpaceTree) use it in place of the usual base case loop,
+ * so that the distances of a leaf combination can be computed together.
+ */
+HAS_ANY_METHOD_FORM(BlockBaseCase, HasBlockBaseCase)
+
+} // namespace mlpack
+
+#endif
@@ -65,11 +65,35 @@ class CosineTree
    * input matrix's projection on the obtained subspace is less than a fraction
    * of the norm of the input matrix.
    *
+   * The centroids, cosines, Gram-Schmidt projections and Monte Carlo
+   * estimates of each step are computed in parallel with OpenMP.
+   *
+   * @param dataset Matrix for which the CosineTree is constructed.
+   * @param epsilon Error tolerance fraction for calculated subspace.
+   * @param delta Cumulative probability for Monte Carlo error lower bound.
+   */
+  CosineTree(const MatType& dataset,
+             const double epsilon,
+             const double delta);
+
+  /**
+   * Construct the CosineTree and the basis for the given matrix like the
+   * constructor above, but warm-started from the given basis (for instance,
+   * the basis of a previous, slightly different version of the matrix).  The
+   * orthonormalized columns of the initial basis are part of the subspace from
+   * the start, so the tree only has to be split until the part of the matrix
+   * that they do not capture is small enough; if they already capture enough
+   * of the matrix, the root is not split at all.  The final basis holds the
+   * orthonormalized initial basis followed by the basis vectors of the tree
+   * that are not zero.
+   *
    * @param dataset Matrix for which the CosineTree is constructed.
+   * @param initialBasis Initial basis, with one column per basis vector.
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
    */
   CosineTree(const MatType& dataset,
+             const MatType& initialBasis,
              const double epsilon,
              const double delta);
 
@@ -256,6 +280,8 @@ class CosineTree
   double delta;
   //! Subspace basis of the input dataset.
   MatType basis;
+  //! Orthonormalized initial basis that the tree was warm-started from.
+  MatType fixedBasis;
   //! Parent of the node.
   CosineTree* parent;
   //! Left child of the node.
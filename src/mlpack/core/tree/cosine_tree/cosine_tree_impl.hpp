@@ -30,6 +30,7 @@ inline CosineTree<MatType>::CosineTree(const MatType& dataset) :
   l2NormsSquared.zeros(numColumns);
 
   // Set indices and calculate squared norms of the columns.
+  #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < numColumns; ++i)
   {
     indices[i] = i;
@@ -80,12 +81,38 @@ template<typename MatType>
 inline CosineTree<MatType>::CosineTree(const MatType& dataset,
                                        const double epsilon,
                                        const double delta) :
+    CosineTree(dataset, MatType(), epsilon, delta)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+inline CosineTree<MatType>::CosineTree(const MatType& dataset,
+                                       const MatType& initialBasis,
+                                       const double epsilon,
+                                       const double delta) :
     dataset(&dataset),
     delta(delta),
     left(NULL),
     right(NULL),
     localDataset(false)
 {
+  if (initialBasis.n_cols > 0)
+  {
+    if (initialBasis.n_rows != dataset.n_rows)
+    {
+      std::ostringstream oss;
+      oss << "CosineTree::CosineTree(): initial basis has "
+          << initialBasis.n_rows << " rows, but the dataset has "
+          << dataset.n_rows << " rows!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // Only the span of the initial basis matters, so orthonormalize it.
+    MatType r;
+    arma::qr_econ(fixedBasis, r, initialBasis);
+  }
+
   // Declare the cosine tree priority queue.
   CosineNodeQueue<MatType> treeQueue;
   CompareCosineNode comp;
@@ -98,8 +125,10 @@ inline CosineTree<MatType>::CosineTree(const MatType& dataset,
   treeQueue.push_back(&root);
   // treeQueue is empty now, so we don't need to call std::push_heap here.
 
-  // Initialize Monte Carlo error estimate for comparison.
-  double monteCarloError = root.FrobNormSquared();
+  // Initialize Monte Carlo error estimate for comparison.  If we were given
+  // an initial basis, it may already capture most of the dataset.
+  double monteCarloError = (fixedBasis.n_cols > 0) ?
+      MonteCarloError(&root, treeQueue) : root.FrobNormSquared();
 
   while (treeQueue.size() > 0 &&
          (monteCarloError > epsilon * root.FrobNormSquared()))
@@ -390,18 +419,26 @@ inline void CosineTree<MatType>::ModifiedGramSchmidt(
   // Set new basis vector to centroid.
   newBasisVector = centroid;
 
-  // Variables for iterating throught the priority queue.
-  CosineTree *currentNode;
-  typename CosineNodeQueue<MatType>::const_iterator i = treeQueue.cbegin();
+  // Remove the projection onto the initial basis, if we have one.
+  if (fixedBasis.n_cols > 0)
+    newBasisVector -= fixedBasis * (fixedBasis.t() * centroid);
 
   // For every vector in the current basis, remove its projection from the
-  // centroid.
-  for ( ; i != treeQueue.cend(); ++i)
+  // centroid.  The projections are independent, so each thread sums the
+  // projections onto its share of the queue.
+  #pragma omp parallel
   {
-    currentNode = *i;
+    VecType threadProjection(centroid.n_elem, arma::fill::zeros);
 
-    double projection = (double) dot(currentNode->BasisVector(), centroid);
-    newBasisVector -= projection * currentNode->BasisVector();
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < treeQueue.size(); ++i)
+    {
+      const VecType& b = treeQueue[i]->BasisVector();
+      threadProjection += (double) dot(b, centroid) * b;
+    }
+
+    #pragma omp critical
+    newBasisVector -= threadProjection;
   }
 
   // If additional basis vector is passed, take it into account.
@@ -445,25 +482,29 @@ inline double CosineTree<MatType>::MonteCarloError(
     projectionSize = treeQueue.size() + 2;
   else
     projectionSize = treeQueue.size();
+  projectionSize += fixedBasis.n_cols;
 
   // For each sample, calculate the weighted projection onto the current basis.
+  #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < numSamples; ++i)
   {
     // Initialize projection as a vector of zeros.
     VecType projection;
     projection.zeros(projectionSize);
 
-    CosineTree *currentNode;
-    typename CosineNodeQueue<MatType>::const_iterator j = treeQueue.cbegin();
-
     size_t k = 0;
     // Compute the projection of the sampled vector onto the existing subspace.
-    for ( ; j != treeQueue.cend(); ++j, ++k)
+    for ( ; k < treeQueue.size(); ++k)
     {
-      currentNode = *j;
-
       projection(k) = dot(dataset.col(sampledIndices[i]),
-                                currentNode->BasisVector());
+                                treeQueue[k]->BasisVector());
+    }
+    // Take the projection onto the initial basis, if we have one.
+    if (fixedBasis.n_cols > 0)
+    {
+      projection.subvec(k, k + fixedBasis.n_cols - 1) =
+          fixedBasis.t() * dataset.col(sampledIndices[i]);
+      k += fixedBasis.n_cols;
     }
     // If two additional vectors are passed, take their projections.
     if (addBasisVector1 && addBasisVector2)
@@ -506,6 +547,24 @@ template<typename MatType>
 inline void CosineTree<MatType>::ConstructBasis(
     CosineNodeQueue<MatType>& treeQueue)
 {
+  // When warm-started, the basis is the initial basis followed by the basis
+  // vectors of the queue that are not zero; those are the vectors of nodes
+  // whose centroid is (numerically) in the span of the initial basis, such as
+  // the root's if it was never split.
+  if (fixedBasis.n_cols > 0)
+  {
+    std::vector<size_t> nonzero;
+    for (size_t i = 0; i < treeQueue.size(); ++i)
+      if (arma::norm(treeQueue[i]->BasisVector(), 2) > 0)
+        nonzero.push_back(i);
+
+    basis.set_size(dataset->n_rows, fixedBasis.n_cols + nonzero.size());
+    basis.cols(0, fixedBasis.n_cols - 1) = fixedBasis;
+    for (size_t i = 0; i < nonzero.size(); ++i)
+      basis.col(fixedBasis.n_cols + i) = treeQueue[nonzero[i]]->BasisVector();
+    return;
+  }
+
   // Initialize basis as matrix of zeros.
   basis.zeros(dataset->n_rows, treeQueue.size());
 
@@ -659,6 +718,7 @@ inline void CosineTree<MatType>::CalculateCosines(
   // Initialize cosine vector as a vector of zeros.
   cosines.zeros(numColumns);
 
+  #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < numColumns; ++i)
   {
     // If norm is zero, store cosine value as zero. Else, calculate cosine value
@@ -682,10 +742,18 @@ inline void CosineTree<MatType>::CalculateCentroid()
   // Initialize centroid as vector of zeros.
   centroid.zeros(dataset->n_rows);
 
-  // Calculate centroid of columns in the node.
-  for (size_t i = 0; i < numColumns; ++i)
+  // Calculate centroid of columns in the node.  Each thread sums its share of
+  // the columns.
+  #pragma omp parallel
   {
-    centroid += dataset->col(indices[i]);
+    VecType threadSum(dataset->n_rows, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < numColumns; ++i)
+      threadSum += dataset->col(indices[i]);
+
+    #pragma omp critical
+    centroid += threadSum;
   }
   centroid /= numColumns;
 }
@@ -18,6 +18,8 @@
 #include "../statistic.hpp"
 #include "first_point_is_root.hpp"
 
+#include <deque>
+
 namespace mlpack {
 
 /**
@@ -569,6 +571,42 @@ class CoverTree
    */
   void RemoveNewImplicitNodes();
 
+  //! The minimum number of points for which ComputeDistances() uses several
+  //! threads.
+  static constexpr size_t parallelDistanceThreshold = 4096;
+
+  //! The index and distance buffers of the children built at one depth of the
+  //! recursion of the construction.
+  struct BuildBuffers
+  {
+    arma::Col<size_t> indices;
+    arma::vec distances;
+  };
+
+  //! Temporary storage for the construction of the tree.
+  struct BuildWorkspace
+  {
+    //! The buffers for each depth of the recursion; a deque keeps references
+    //! to the buffers of lower depths valid when it grows.
+    std::deque<BuildBuffers> levels;
+    //! The current depth of the recursion.
+    size_t depth = 0;
+    //! The buffers used by SortPointSet().
+    std::vector<size_t> sortIndices;
+    std::vector<double> sortDistances;
+  };
+
+  /**
+   * Get the construction workspace of the calling thread.  The buffers are
+   * reused by all of the nodes that the thread builds, and released when the
+   * construction of the root is done.
+   */
+  static BuildWorkspace& Workspace()
+  {
+    thread_local BuildWorkspace workspace;
+    return workspace;
+  }
+
  private:
   size_t distanceComps;
 };
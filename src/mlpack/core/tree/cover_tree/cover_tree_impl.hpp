@@ -1146,6 +1146,15 @@ CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
                    size_t& farSetSize,
                    size_t& usedSetSize)
 {
+  // The children of this node are built with the buffers of the current
+  // recursion depth; we don't allocate new buffers for every child.
+  BuildWorkspace& workspace = Workspace();
+  if (workspace.levels.size() <= workspace.depth)
+    workspace.levels.emplace_back();
+  arma::Col<size_t>& childIndices = workspace.levels[workspace.depth].indices;
+  arma::vec& childDistances = workspace.levels[workspace.depth].distances;
+  ++workspace.depth;
+
   // Determine the next scale level.  This should be the first level where there
   // are any points in the far set.  So, if we know the maximum distance in the
   // distances array, this will be the largest i such that
@@ -1186,6 +1195,10 @@ CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
     // [ far | all used ].
     SortPointSet(indices, distances, 0, usedSetSize, farSetSize);
 
+    // Release the workspace when the construction of the tree is done.
+    if (--workspace.depth == 0)
+      workspace = BuildWorkspace();
+
     return;
   }
 
@@ -1275,11 +1288,15 @@ CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
     }
 
     // Create the near and far set indices and distance vectors.  We don't fill
-    // in the self-point, yet.
-    arma::Col<size_t> childIndices(nearSetSize + farSetSize);
+    // in the self-point, yet.  The buffers are only grown; every function
+    // that uses them is given the size of the point set explicitly.
+    if (childIndices.n_elem < nearSetSize + farSetSize)
+    {
+      childIndices.set_size(nearSetSize + farSetSize);
+      childDistances.set_size(nearSetSize + farSetSize);
+    }
     childIndices.rows(0, (nearSetSize + farSetSize - 2)) = indices.rows(1,
         nearSetSize + farSetSize - 1);
-    arma::vec childDistances(nearSetSize + farSetSize);
 
     // Build distances for the child.
     ComputeDistances(indices[0], childIndices, childDistances, nearSetSize
@@ -1325,6 +1342,10 @@ CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
       usedSetSize); ++i)
     if (distances[i] > furthestDescendantDistance)
       furthestDescendantDistance = distances[i];
+
+  // Release the workspace when the construction of the tree is done.
+  if (--workspace.depth == 0)
+    workspace = BuildWorkspace();
 }
 
 template<
@@ -1399,7 +1420,11 @@ void CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
 {
   // For each point, rebuild the distances.  The indices do not need to be
   // modified.
+  // The points of large sets are split between threads; for small sets this
+  // would cost more than computing the distances.
   distanceComps += pointSetSize;
+  #pragma omp parallel for schedule(static) \
+      if (pointSetSize >= parallelDistanceThreshold)
   for (size_t i = 0; i < pointSetSize; ++i)
   {
     distances[i] = distance->Evaluate(dataset->col(pointIndex),
@@ -1431,8 +1456,16 @@ size_t CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
   if (bufferSize == 0)
     return (childFarSetSize + farSetSize);
 
-  size_t* indicesBuffer = new size_t[bufferSize];
-  ElemType* distancesBuffer = new ElemType[bufferSize];
+  // The buffers are reused by every SortPointSet() call of the construction.
+  // The distances are always stored as doubles, whatever ElemType is.
+  BuildWorkspace& workspace = Workspace();
+  if (workspace.sortIndices.size() < bufferSize)
+  {
+    workspace.sortIndices.resize(bufferSize);
+    workspace.sortDistances.resize(bufferSize);
+  }
+  size_t* indicesBuffer = workspace.sortIndices.data();
+  double* distancesBuffer = workspace.sortDistances.data();
 
   // The start of the memory region to copy to the buffer.
   const size_t bufferFromLocation = ((bufferSize == farSetSize) ?
@@ -1451,22 +1484,19 @@ size_t CoverTree<DistanceType, StatisticType, MatType, RootPointPolicy>::
   memcpy(indicesBuffer, indices.memptr() + bufferFromLocation,
       sizeof(size_t) * bufferSize);
   memcpy(distancesBuffer, distances.memptr() + bufferFromLocation,
-      sizeof(ElemType) * bufferSize);
+      sizeof(double) * bufferSize);
 
   // Now move the other memory.
   memmove(indices.memptr() + directToLocation,
       indices.memptr() + directFromLocation, sizeof(size_t) * bigCopySize);
   memmove(distances.memptr() + directToLocation,
-      distances.memptr() + directFromLocation, sizeof(ElemType) * bigCopySize);
+      distances.memptr() + directFromLocation, sizeof(double) * bigCopySize);
 
   // Now copy the temporary memory to the right place.
   memcpy(indices.memptr() + bufferToLocation, indicesBuffer,
       sizeof(size_t) * bufferSize);
   memcpy(distances.memptr() + bufferToLocation, distancesBuffer,
-      sizeof(ElemType) * bufferSize);
-
-  delete[] indicesBuffer;
-  delete[] distancesBuffer;
+      sizeof(double) * bufferSize);
 
   // This returns the complete size of the far set.
   return (childFarSetSize + farSetSize);
@@ -30,8 +30,8 @@ struct IsLMetric
 };
 
 //! Specialization for IsLMetric when the argument is of type LMetric.
-template<int Power, bool TakeRoot>
-struct IsLMetric<LMetric<Power, TakeRoot>>
+template<int Power, bool TakeRoot, size_t Dim>
+struct IsLMetric<LMetric<Power, TakeRoot, Dim>>
 {
   static const bool Value = true;
 };
@@ -41,6 +41,11 @@ struct IsLMetric<LMetric<Power, TakeRoot>>
  * with the LMetric class.  Be sure to use the same template parameters for
  * LMetric as you do for HRectBound -- otherwise odd results may occur.
  *
+ * If the dimensionality of the LMetric is fixed at compile time (e.g.
+ * LMetric<2, true, 2>), the bound holds its ranges inline, and its loops over
+ * the dimensions have a constant trip count; otherwise, the ranges are
+ * allocated on the heap.
+ *
  * @tparam DistanceType Type of distance metric to use; must be of type LMetric.
  * @tparam ElemType Element type (double/float/int/etc.).
  */
@@ -53,14 +58,18 @@ class HRectBound
       "HRectBound can only be used with the LMetric<> metric type.");
 
  public:
+  //! The dimensionality fixed by the distance metric (0 if it is only known at
+  //! runtime).
+  static constexpr size_t FixedDim = DistanceType::Dim;
+
   /**
-   * Empty constructor; creates a bound of dimensionality 0.
+   * Empty constructor; creates a bound of dimensionality 0 (or FixedDim).
    */
   HRectBound();
 
   /**
    * Initializes to specified dimensionality with each dimension the empty
-   * set.
+   * set.  If the dimensionality is fixed, it must be FixedDim (or 0).
    *
    * @param dimension Dimensionality of bound.
    */
@@ -88,7 +97,7 @@ class HRectBound
   void Clear();
 
   //! Gets the dimensionality.
-  size_t Dim() const { return dim; }
+  size_t Dim() const { return (FixedDim > 0) ? FixedDim : dim; }
 
   //! Get the range for a particular dimension.  No bounds checking.  Be
   //! careful: this may make MinWidth() invalid.
@@ -241,10 +250,15 @@ class HRectBound
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  //! The type that holds the bounds: an inline array if the dimensionality is
+  //! fixed, and otherwise an array on the heap.
+  using BoundsType = std::conditional_t<(FixedDim > 0),
+      std::array<RangeType<ElemType>, FixedDim>, RangeType<ElemType>*>;
+
   //! The dimensionality of the bound.
   size_t dim;
   //! The bounds for each dimension.
-  RangeType<ElemType>* bounds;
+  BoundsType bounds;
   //! Cached minimum width of bound.
   ElemType minWidth;
   //! Instantiated distance metric (likely has size 0).
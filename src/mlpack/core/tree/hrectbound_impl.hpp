@@ -25,8 +25,8 @@ namespace mlpack {
  */
 template<typename DistanceType, typename ElemType>
 inline HRectBound<DistanceType, ElemType>::HRectBound() :
-    dim(0),
-    bounds(NULL),
+    dim(FixedDim),
+    bounds(),
     minWidth(0)
 { /* Nothing to do. */ }
 
@@ -37,9 +37,27 @@ inline HRectBound<DistanceType, ElemType>::HRectBound() :
 template<typename DistanceType, typename ElemType>
 inline HRectBound<DistanceType, ElemType>::HRectBound(const size_t dimension) :
     dim(dimension),
-    bounds(new RangeType<ElemType>[dim]),
+    bounds(),
     minWidth(0)
-{ /* Nothing to do. */ }
+{
+  if constexpr (FixedDim > 0)
+  {
+    if (dimension != FixedDim && dimension != 0)
+    {
+      std::ostringstream oss;
+      oss << "HRectBound::HRectBound(): dimensionality " << dimension
+          << " does not match the dimensionality of the distance metric ("
+          << FixedDim << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    dim = FixedDim;
+  }
+  else
+  {
+    bounds = new RangeType<ElemType>[dim];
+  }
+}
 
 /**
  * Copy constructor necessary to prevent memory leaks.
@@ -48,12 +66,20 @@ template<typename DistanceType, typename ElemType>
 inline HRectBound<DistanceType, ElemType>::HRectBound(
     const HRectBound<DistanceType, ElemType>& other) :
     dim(other.Dim()),
-    bounds(new RangeType<ElemType>[dim]),
+    bounds(),
     minWidth(other.MinWidth())
 {
-  // Copy other bounds over.
-  for (size_t i = 0; i < dim; ++i)
-    bounds[i] = other[i];
+  if constexpr (FixedDim > 0)
+  {
+    bounds = other.bounds;
+  }
+  else
+  {
+    // Copy other bounds over.
+    bounds = new RangeType<ElemType>[dim];
+    for (size_t i = 0; i < Dim(); ++i)
+      bounds[i] = other[i];
+  }
 }
 
 /**
@@ -68,19 +94,26 @@ inline HRectBound<
   if (this == &other)
     return *this;
 
-  if (dim != other.Dim())
+  if constexpr (FixedDim > 0)
   {
-    // Reallocation is necessary.
-    if (bounds)
-      delete[] bounds;
-
-    dim = other.Dim();
-    bounds = new RangeType<ElemType>[dim];
+    bounds = other.bounds;
   }
+  else
+  {
+    if (dim != other.Dim())
+    {
+      // Reallocation is necessary.
+      if (bounds)
+        delete[] bounds;
 
-  // Now copy each of the bound values.
-  for (size_t i = 0; i < dim; ++i)
-    bounds[i] = other[i];
+      dim = other.Dim();
+      bounds = new RangeType<ElemType>[dim];
+    }
+
+    // Now copy each of the bound values.
+    for (size_t i = 0; i < Dim(); ++i)
+      bounds[i] = other[i];
+  }
 
   minWidth = other.MinWidth();
 
@@ -97,10 +130,13 @@ inline HRectBound<DistanceType, ElemType>::HRectBound(
     bounds(other.bounds),
     minWidth(other.minWidth)
 {
-  // Fix the other bound.
-  other.dim = 0;
-  other.bounds = NULL;
-  other.minWidth = 0.0;
+  // Fix the other bound.  Inline bounds are just copied.
+  if constexpr (FixedDim == 0)
+  {
+    other.dim = 0;
+    other.bounds = NULL;
+    other.minWidth = 0.0;
+  }
 }
 
 /**
@@ -113,12 +149,22 @@ HRectBound<DistanceType, ElemType>::operator=(
 {
   if (this != &other)
   {
-    bounds = other.bounds;
-    minWidth = other.minWidth;
     dim = other.dim;
-    other.dim = 0;
-    other.bounds = nullptr;
-    other.minWidth = 0.0;
+    minWidth = other.minWidth;
+    if constexpr (FixedDim > 0)
+    {
+      bounds = other.bounds;
+    }
+    else
+    {
+      // Don't leak the bounds that are replaced.
+      if (bounds)
+        delete[] bounds;
+      bounds = other.bounds;
+      other.dim = 0;
+      other.bounds = nullptr;
+      other.minWidth = 0.0;
+    }
   }
   return *this;
 }
@@ -129,8 +175,11 @@ HRectBound<DistanceType, ElemType>::operator=(
 template<typename DistanceType, typename ElemType>
 inline HRectBound<DistanceType, ElemType>::~HRectBound()
 {
-  if (bounds)
-    delete[] bounds;
+  if constexpr (FixedDim == 0)
+  {
+    if (bounds)
+      delete[] bounds;
+  }
 }
 
 /**
@@ -139,7 +188,7 @@ inline HRectBound<DistanceType, ElemType>::~HRectBound()
 template<typename DistanceType, typename ElemType>
 inline void HRectBound<DistanceType, ElemType>::Clear()
 {
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
     bounds[i] = RangeType<ElemType>();
   minWidth = 0;
 }
@@ -157,7 +206,7 @@ inline void HRectBound<DistanceType, ElemType>::Center(
   if (!(center.n_elem == dim))
     center.set_size(dim);
 
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
     center(i) = bounds[i].Mid();
 }
 
@@ -168,7 +217,7 @@ template<typename DistanceType, typename ElemType>
 inline void HRectBound<DistanceType, ElemType>::RecomputeMinWidth()
 {
   minWidth = std::numeric_limits<ElemType>::max();
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
     minWidth = std::min(minWidth, bounds[i].Width());
 }
 
@@ -181,7 +230,7 @@ template<typename DistanceType, typename ElemType>
 inline ElemType HRectBound<DistanceType, ElemType>::Volume() const
 {
   ElemType volume = 1.0;
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
   {
     if (bounds[i].Lo() >= bounds[i].Hi())
       return 0;
@@ -201,12 +250,12 @@ inline ElemType HRectBound<DistanceType, ElemType>::MinDistance(
     const VecType& point,
     typename std::enable_if_t<IsVector<VecType>::value>* /* junk */) const
 {
-  Log::Assert(point.n_elem == dim);
+  Log::Assert(point.n_elem == Dim());
 
   ElemType sum = 0;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < Dim(); d++)
   {
     lower = bounds[d].Lo() - point[d];
     higher = point[d] - bounds[d].Hi();
@@ -261,14 +310,12 @@ ElemType HRectBound<DistanceType, ElemType>::MinDistance(
   Log::Assert(dim == other.dim);
 
   ElemType sum = 0;
-  const RangeType<ElemType>* mbound = bounds;
-  const RangeType<ElemType>* obound = other.bounds;
 
   ElemType lower, higher;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < Dim(); d++)
   {
-    lower = obound->Lo() - mbound->Hi();
-    higher = mbound->Lo() - obound->Hi();
+    lower = other.bounds[d].Lo() - bounds[d].Hi();
+    higher = bounds[d].Lo() - other.bounds[d].Hi();
     // We invoke the following:
     //   x + fabs(x) = max(x * 2, 0)
     //   (x * 2)^2 / 4 = x^2
@@ -286,10 +333,6 @@ ElemType HRectBound<DistanceType, ElemType>::MinDistance(
       sum += std::pow((lower + std::fabs(lower)) + (higher + std::fabs(higher)),
           (ElemType) DistanceType::Power);
     }
-
-    // Move bound pointers.
-    mbound++;
-    obound++;
   }
 
   // The compiler should optimize out this if statement entirely.
@@ -323,9 +366,9 @@ inline ElemType HRectBound<DistanceType, ElemType>::MaxDistance(
 {
   ElemType sum = 0;
 
-  Log::Assert(point.n_elem == dim);
+  Log::Assert(point.n_elem == Dim());
 
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < Dim(); d++)
   {
     ElemType v = std::max(fabs(point[d] - bounds[d].Lo()),
         fabs(bounds[d].Hi() - point[d]));
@@ -367,7 +410,7 @@ inline ElemType HRectBound<DistanceType, ElemType>::MaxDistance(
   Log::Assert(dim == other.dim);
 
   ElemType v;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < Dim(); d++)
   {
     v = std::max(fabs(other.bounds[d].Hi() - bounds[d].Lo()),
         fabs(bounds[d].Hi() - other.bounds[d].Lo()));
@@ -410,7 +453,7 @@ HRectBound<DistanceType, ElemType>::RangeDistance(
   Log::Assert(dim == other.dim);
 
   ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < Dim(); d++)
   {
     v1 = other.bounds[d].Lo() - bounds[d].Hi();
     v2 = bounds[d].Lo() - other.bounds[d].Hi();
@@ -479,10 +522,10 @@ HRectBound<DistanceType, ElemType>::RangeDistance(
   ElemType loSum = 0;
   ElemType hiSum = 0;
 
-  Log::Assert(point.n_elem == dim);
+  Log::Assert(point.n_elem == Dim());
 
   ElemType v1, v2, vLo, vHi;
-  for (size_t d = 0; d < dim; d++)
+  for (size_t d = 0; d < Dim(); d++)
   {
     v1 = bounds[d].Lo() - point[d]; // Negative if point[d] > lo.
     v2 = point[d] - bounds[d].Hi(); // Negative if point[d] < hi.
@@ -552,11 +595,14 @@ template<typename MatType>
 inline HRectBound<DistanceType, ElemType>&
 HRectBound<DistanceType, ElemType>::operator|=(const MatType& data)
 {
-  if (dim == 0)
+  if constexpr (FixedDim == 0)
   {
-    delete[] bounds;
-    dim = data.n_rows;
-    bounds = new RangeType<ElemType>[dim];
+    if (dim == 0)
+    {
+      delete[] bounds;
+      dim = data.n_rows;
+      bounds = new RangeType<ElemType>[dim];
+    }
   }
 
   Log::Assert(data.n_rows == dim);
@@ -565,7 +611,7 @@ HRectBound<DistanceType, ElemType>::operator|=(const MatType& data)
   arma::Col<ElemType> maxs(max(data, 1));
 
   minWidth = std::numeric_limits<ElemType>::max();
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
   {
     bounds[i] |= RangeType<ElemType>(mins[i], maxs[i]);
     const ElemType width = bounds[i].Width();
@@ -583,17 +629,20 @@ template<typename DistanceType, typename ElemType>
 inline HRectBound<DistanceType, ElemType>&
 HRectBound<DistanceType, ElemType>::operator|=(const HRectBound& other)
 {
-  if (dim == 0)
+  if constexpr (FixedDim == 0)
   {
-    delete[] bounds;
-    dim = other.dim;
-    bounds = new RangeType<ElemType>[dim];
+    if (dim == 0)
+    {
+      delete[] bounds;
+      dim = other.dim;
+      bounds = new RangeType<ElemType>[dim];
+    }
   }
 
   Log::Assert(other.dim == dim);
 
   minWidth = std::numeric_limits<ElemType>::max();
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
   {
     bounds[i] |= other.bounds[i];
     const ElemType width = bounds[i].Width();
@@ -612,7 +661,7 @@ template<typename VecType>
 inline bool HRectBound<DistanceType, ElemType>::Contains(
     const VecType& point) const
 {
-  for (size_t i = 0; i < point.n_elem; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
   {
     if (!bounds[i].Contains(point(i)))
       return false;
@@ -628,7 +677,7 @@ template<typename DistanceType, typename ElemType>
 inline bool HRectBound<DistanceType, ElemType>::Contains(
     const HRectBound& bound) const
 {
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
   {
     const RangeType<ElemType>& r_a = bounds[i];
     const RangeType<ElemType>& r_b = bound.bounds[i];
@@ -650,7 +699,7 @@ HRectBound<DistanceType, ElemType>::operator&(const HRectBound& bound) const
 {
   HRectBound<DistanceType, ElemType> result(dim);
 
-  for (size_t k = 0; k < dim; ++k)
+  for (size_t k = 0; k < Dim(); ++k)
   {
     result[k].Lo() = std::max(bounds[k].Lo(), bound.bounds[k].Lo());
     result[k].Hi() = std::min(bounds[k].Hi(), bound.bounds[k].Hi());
@@ -665,7 +714,7 @@ template<typename DistanceType, typename ElemType>
 inline HRectBound<DistanceType, ElemType>&
 HRectBound<DistanceType, ElemType>::operator&=(const HRectBound& bound)
 {
-  for (size_t k = 0; k < dim; ++k)
+  for (size_t k = 0; k < Dim(); ++k)
   {
     bounds[k].Lo() = std::max(bounds[k].Lo(), bound.bounds[k].Lo());
     bounds[k].Hi() = std::min(bounds[k].Hi(), bound.bounds[k].Hi());
@@ -682,7 +731,7 @@ inline ElemType HRectBound<DistanceType, ElemType>::Overlap(
 {
   ElemType volume = 1.0;
 
-  for (size_t k = 0; k < dim; ++k)
+  for (size_t k = 0; k < Dim(); ++k)
   {
     ElemType lo = std::max(bounds[k].Lo(), bound.bounds[k].Lo());
     ElemType hi = std::min(bounds[k].Hi(), bound.bounds[k].Hi());
@@ -702,7 +751,7 @@ template<typename DistanceType, typename ElemType>
 inline ElemType HRectBound<DistanceType, ElemType>::Diameter() const
 {
   ElemType d = 0;
-  for (size_t i = 0; i < dim; ++i)
+  for (size_t i = 0; i < Dim(); ++i)
     d += std::pow(bounds[i].Hi() - bounds[i].Lo(),
         (ElemType) DistanceType::Power);
 
@@ -720,7 +769,10 @@ void HRectBound<DistanceType, ElemType>::serialize(
     const uint32_t /* version */)
 {
   // We can't serialize a raw array directly, so wrap it.
-  ar(CEREAL_POINTER_ARRAY(bounds, dim));
+  if constexpr (FixedDim > 0)
+    ar(CEREAL_NVP(bounds));
+  else
+    ar(CEREAL_POINTER_ARRAY(bounds, dim));
   ar(CEREAL_NVP(minWidth));
   ar(CEREAL_NVP(distance));
 }
@@ -0,0 +1,48 @@
+/**
+ * @file core/tree/incremental_tree.hpp
+ *
+ * Definitions of HasRemove and HasDelete, used to detect trees that points can
+ * be added to and removed from without rebuilding the tree.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_INCREMENTAL_TREE_HPP
+#define MLPACK_CORE_TREE_INCREMENTAL_TREE_HPP
+
+#include <mlpack/core/util/sfinae_utility.hpp>
+
+namespace mlpack {
+
+/**
+ * HasRemove<TreeType>::value is true if the given TreeType rearranges its
+ * dataset and can insert and remove points while keeping the mapping to the
+ * original indices up to date, with methods of the form
+ *
+ * @code
+ * void Insert(const MatType& points, std::vector<size_t>& oldFromNew);
+ * void Remove(const arma::uvec& indices, std::vector<size_t>& oldFromNew);
+ * @endcode
+ *
+ * (see BinarySpaceTree::Insert() and BinarySpaceTree::Remove()).
+ */
+HAS_ANY_METHOD_FORM(Remove, HasRemove)
+
+/**
+ * HasDelete<TreeType>::value is true if the given TreeType does not rearrange
+ * its dataset and can insert and delete points with methods of the form
+ *
+ * @code
+ * void Insert(const MatType& points);
+ * void Delete(const size_t pointIndex);
+ * @endcode
+ *
+ * (see RectangleTree::Insert() and RectangleTree::Delete()).
+ */
+HAS_ANY_METHOD_FORM(Delete, HasDelete)
+
+} // namespace mlpack
+
+#endif
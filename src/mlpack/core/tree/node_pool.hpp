@@ -0,0 +1,111 @@
+/**
+ * @file core/tree/node_pool.hpp
+ *
+ * A simple pool of memory for tree nodes.  Nodes are placed in large blocks of
+ * memory, so that building a tree takes only a few allocations, and all of the
+ * memory is released at once when the pool is destroyed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_NODE_POOL_HPP
+#define MLPACK_CORE_TREE_NODE_POOL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * NodePool holds memory for tree nodes of type `NodeType`.  Memory is handed
+ * out one node at a time with Allocate(), and is taken from blocks whose size
+ * doubles each time a block is filled (up to a maximum size), so that the
+ * number of allocations is logarithmic in the number of nodes.
+ *
+ * The pool only manages memory: a node is constructed with placement new into
+ * the memory returned by Allocate(), and the node's destructor must be called
+ * explicitly before the pool is destroyed.  All memory is released when the
+ * pool is destroyed; individual nodes are never freed.
+ *
+ * Allocate() may be called from multiple threads at once.
+ *
+ * @tparam NodeType Type of node that is stored in the pool.
+ */
+template<typename NodeType>
+class NodePool
+{
+ public:
+  /**
+   * Create an empty pool.  No memory is allocated until the first call to
+   * Allocate().
+   *
+   * @param initialBlockSize Number of nodes that the first block can hold.
+   */
+  NodePool(const size_t initialBlockSize = 64) :
+      blockSize(std::max(initialBlockSize, (size_t) 1)),
+      used(0)
+  { /* Nothing to do. */ }
+
+  // A pool cannot be copied, since nodes hold pointers into it.
+  NodePool(const NodePool& other) = delete;
+  NodePool& operator=(const NodePool& other) = delete;
+
+  //! Release all memory held by the pool.
+  ~NodePool()
+  {
+    std::allocator<NodeType> allocator;
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+      allocator.deallocate(blocks[i], blockSizes[i]);
+      util::MemoryTracker::Free(blockSizes[i] * sizeof(NodeType));
+    }
+  }
+
+  /**
+   * Return uninitialized memory for one node.  The memory stays valid until
+   * the pool is destroyed.
+   */
+  NodeType* Allocate()
+  {
+    NodeType* result;
+    #pragma omp critical(mlpackNodePoolAllocate)
+    {
+      if (blocks.empty() || used == blockSizes.back())
+      {
+        // The next block is larger, so that we need only a few blocks.
+        const size_t newSize = blocks.empty() ? blockSize :
+            std::min(2 * blockSizes.back(), maxBlockSize);
+        blocks.push_back(std::allocator<NodeType>().allocate(newSize));
+        blockSizes.push_back(newSize);
+        util::MemoryTracker::Allocate(newSize * sizeof(NodeType));
+        used = 0;
+      }
+
+      result = blocks.back() + used;
+      ++used;
+    }
+
+    return result;
+  }
+
+  //! Get the number of blocks of memory held by the pool.
+  size_t NumBlocks() const { return blocks.size(); }
+
+ private:
+  //! The largest number of nodes that will be held in one block.
+  static constexpr size_t maxBlockSize = 65536;
+
+  //! The size of the first block.
+  size_t blockSize;
+  //! Each block of memory.
+  std::vector<NodeType*> blocks;
+  //! The number of nodes each block can hold.
+  std::vector<size_t> blockSizes;
+  //! The number of nodes used in the last block.
+  size_t used;
+};
+
+} // namespace mlpack
+
+#endif
@@ -14,10 +14,22 @@
 
 #include <mlpack/prereqs.hpp>
 #include "../hrectbound.hpp"
+#include "../node_pool.hpp"
 #include "../statistic.hpp"
 
 namespace mlpack {
 
+//! The ways in which an Octree can be built.
+enum OctreeBuildType
+{
+  //! Split each node around the center of its cell, permuting the points of
+  //! the node recursively (the default).
+  MIDPOINT_OCTREE_BUILD,
+  //! Sort all points once by their Morton (Z-order) codes, and derive the
+  //! nodes from the prefixes of the codes.
+  MORTON_OCTREE_BUILD
+};
+
 template<typename DistanceType = EuclideanDistance,
          typename StatisticType = EmptyStatistic,
          typename MatType = arma::mat>
@@ -62,6 +74,11 @@ class Octree
   ElemType furthestDescendantDistance;
   //! An instantiated distance metric.
   DistanceType distance;
+  //! The pool that holds the memory of the nodes of the tree.  It is owned by
+  //! the root, and is NULL for trees that were copied or loaded.
+  NodePool<Octree>* nodePool;
+  //! If true, the memory of this node belongs to the pool of its parent.
+  bool pooled;
 
  public:
   /**
@@ -156,6 +173,78 @@ class Octree
          std::vector<size_t>& newFromOld,
          const size_t maxLeafSize = 20);
 
+  /**
+   * Construct this as the root node of an octree on the given dataset, using
+   * the given build algorithm.  This copies the dataset.
+   *
+   * With MORTON_OCTREE_BUILD, the Morton code of each point (the interleaved
+   * bits of its quantized coordinates in the bounding cube of the dataset) is
+   * computed in parallel, the codes are radix-sorted in parallel, and the
+   * dataset is permuted once into that order; then the children of each node
+   * are the runs of points whose codes share a longer prefix.  Such a tree
+   * splits its nodes at the same planes as a midpoint build, but chains of
+   * nodes with a single child are collapsed, and the points of every node are
+   * contiguous in Z-order.  The Morton build is meant for low-dimensional data
+   * (such as 3-D point clouds): each dimension is quantized to
+   * min(32, 64 / dimensionality) bits, and a node whose points all fall in the
+   * same finest cell becomes a leaf, even if it holds more than maxLeafSize
+   * points.
+   *
+   * @param data Dataset to create tree from.  This will be copied!
+   * @param buildType Algorithm to build the tree with.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(const MatType& data,
+         const OctreeBuildType buildType,
+         const size_t maxLeafSize = 20);
+
+  /**
+   * Construct this as the root node of an octree on the given dataset, using
+   * the given build algorithm (see the constructor above).  This copies the
+   * dataset and modifies its ordering; a mapping of the old point indices to
+   * the new point indices is filled.
+   *
+   * @param data Dataset to create tree from.  This will be copied!
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *      each new point.
+   * @param buildType Algorithm to build the tree with.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(const MatType& data,
+         std::vector<size_t>& oldFromNew,
+         const OctreeBuildType buildType,
+         const size_t maxLeafSize = 20);
+
+  /**
+   * Construct this as the root node of an octree on the given dataset, using
+   * the given build algorithm (see the constructors above).  This will take
+   * ownership of the dataset.
+   *
+   * @param data Dataset to create tree from.
+   * @param buildType Algorithm to build the tree with.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(MatType&& data,
+         const OctreeBuildType buildType,
+         const size_t maxLeafSize = 20);
+
+  /**
+   * Construct this as the root node of an octree on the given dataset, using
+   * the given build algorithm (see the constructors above).  This will take
+   * ownership of the dataset and modify its ordering; a mapping of the old
+   * point indices to the new point indices is filled.
+   *
+   * @param data Dataset to create tree from.
+   * @param oldFromNew Vector which will be filled with the old positions for
+   *      each new point.
+   * @param buildType Algorithm to build the tree with.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(MatType&& data,
+         std::vector<size_t>& oldFromNew,
+         const OctreeBuildType buildType,
+         const size_t maxLeafSize = 20);
+
   /**
    * Construct this node as a child of the given parent, starting at column
    * begin and using count points.  The ordering of that subset of points in the
@@ -414,6 +503,66 @@ class Octree
   friend class cereal::access;
 
  private:
+  //! Nodes with at least this many points build their children in OpenMP
+  //! tasks during a Morton build.
+  static constexpr size_t minParallelBuildSize = 4096;
+
+  /**
+   * Construct this node as a child of the given parent during a Morton build,
+   * starting at column begin and using count points, whose sorted Morton codes
+   * are given.
+   *
+   * @param parent Parent of this node.
+   * @param begin Index of the first point of the node.
+   * @param count Number of points in the node.
+   * @param codes Morton codes of all points of the dataset, in dataset order.
+   * @param maxLeafSize Maximum number of points in a leaf node.
+   */
+  Octree(Octree* parent,
+         const size_t begin,
+         const size_t count,
+         const uint64_t* codes,
+         const size_t maxLeafSize);
+
+  /**
+   * Build the tree below this root node with the given algorithm, filling
+   * oldFromNew if it is not NULL, and set the furthest descendant distance.
+   */
+  void BuildRoot(const OctreeBuildType buildType,
+                 std::vector<size_t>* oldFromNew,
+                 const size_t maxLeafSize);
+
+  /**
+   * Compute the Morton codes of the points, sort the dataset by them (updating
+   * oldFromNew if it is not NULL), and build the children of this root node.
+   */
+  void MortonBuild(std::vector<size_t>* oldFromNew, const size_t maxLeafSize);
+
+  /**
+   * Split the node into the runs of points whose Morton codes agree on the
+   * first group of bits (one bit per dimension) where the codes of the node
+   * differ.
+   *
+   * @param codes Sorted Morton codes of all points of the dataset.
+   * @param maxLeafSize Maximum number of points allowed in a leaf.
+   */
+  void MortonSplitNode(const uint64_t* codes, const size_t maxLeafSize);
+
+  /**
+   * Sort the given codes (and the order vector along with them) on their
+   * lowest `bits` bits, with a stable, parallel LSD radix sort.
+   */
+  static void RadixSort(std::vector<uint64_t>& codes,
+                        std::vector<size_t>& order,
+                        const size_t bits);
+
+  //! Return uninitialized memory for a new child node, taken from the node
+  //! pool of the tree if it has one.
+  void* AllocateNode();
+
+  //! Free the children of this node (and all their descendants).
+  void FreeChildren();
+
   /**
    * Split the node, using the given center and the given maximum width of this
    * node.
@@ -16,6 +16,10 @@
 #include <mlpack/core/tree/perform_split.hpp>
 #include <stack>
 
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 
 //! Construct the tree.
@@ -27,7 +31,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(const MatType& dataset,
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
 {
   if (count > 0)
   {
@@ -65,7 +71,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -108,7 +116,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(dataset)),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -153,7 +163,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(MatType&& dataset,
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
 {
   if (count > 0)
   {
@@ -191,7 +203,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -234,7 +248,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     bound(dataset.n_rows),
     dataset(new MatType(std::move(dataset))),
     parent(NULL),
-    parentDistance(0.0)
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
 {
   oldFromNew.resize(this->dataset->n_cols);
   for (size_t i = 0; i < this->dataset->n_cols; ++i)
@@ -270,6 +286,100 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     newFromOld[oldFromNew[i]] = i;
 }
 
+//! Construct the tree with the given build algorithm.
+template<typename DistanceType, typename StatisticType, typename MatType>
+Octree<DistanceType, StatisticType, MatType>::Octree(
+    const MatType& dataset,
+    const OctreeBuildType buildType,
+    const size_t maxLeafSize) :
+    begin(0),
+    count(dataset.n_cols),
+    bound(dataset.n_rows),
+    dataset(new MatType(dataset)),
+    parent(NULL),
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
+{
+  BuildRoot(buildType, NULL, maxLeafSize);
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
+//! Construct the tree with the given build algorithm.
+template<typename DistanceType, typename StatisticType, typename MatType>
+Octree<DistanceType, StatisticType, MatType>::Octree(
+    const MatType& dataset,
+    std::vector<size_t>& oldFromNew,
+    const OctreeBuildType buildType,
+    const size_t maxLeafSize) :
+    begin(0),
+    count(dataset.n_cols),
+    bound(dataset.n_rows),
+    dataset(new MatType(dataset)),
+    parent(NULL),
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
+{
+  oldFromNew.resize(this->dataset->n_cols);
+  for (size_t i = 0; i < this->dataset->n_cols; ++i)
+    oldFromNew[i] = i;
+
+  BuildRoot(buildType, &oldFromNew, maxLeafSize);
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
+//! Construct the tree with the given build algorithm.
+template<typename DistanceType, typename StatisticType, typename MatType>
+Octree<DistanceType, StatisticType, MatType>::Octree(
+    MatType&& dataset,
+    const OctreeBuildType buildType,
+    const size_t maxLeafSize) :
+    begin(0),
+    count(dataset.n_cols),
+    bound(dataset.n_rows),
+    dataset(new MatType(std::move(dataset))),
+    parent(NULL),
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
+{
+  BuildRoot(buildType, NULL, maxLeafSize);
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
+//! Construct the tree with the given build algorithm.
+template<typename DistanceType, typename StatisticType, typename MatType>
+Octree<DistanceType, StatisticType, MatType>::Octree(
+    MatType&& dataset,
+    std::vector<size_t>& oldFromNew,
+    const OctreeBuildType buildType,
+    const size_t maxLeafSize) :
+    begin(0),
+    count(dataset.n_cols),
+    bound(dataset.n_rows),
+    dataset(new MatType(std::move(dataset))),
+    parent(NULL),
+    parentDistance(0.0),
+    nodePool(new NodePool<Octree>()),
+    pooled(false)
+{
+  oldFromNew.resize(this->dataset->n_cols);
+  for (size_t i = 0; i < this->dataset->n_cols; ++i)
+    oldFromNew[i] = i;
+
+  BuildRoot(buildType, &oldFromNew, maxLeafSize);
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Construct a child node.
 template<typename DistanceType, typename StatisticType, typename MatType>
 Octree<DistanceType, StatisticType, MatType>::Octree(
@@ -283,7 +393,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     count(count),
     bound(parent->dataset->n_rows),
     dataset(parent->dataset),
-    parent(parent)
+    parent(parent),
+    nodePool(parent->nodePool),
+    pooled(parent->nodePool != NULL)
 {
   // Calculate empirical center of data.
   bound |= dataset->cols(begin, begin + count - 1);
@@ -318,7 +430,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
     count(count),
     bound(parent->dataset->n_rows),
     dataset(parent->dataset),
-    parent(parent)
+    parent(parent),
+    nodePool(parent->nodePool),
+    pooled(parent->nodePool != NULL)
 {
   // Calculate empirical center of data.
   bound |= dataset->cols(begin, begin + count - 1);
@@ -339,6 +453,41 @@ Octree<DistanceType, StatisticType, MatType>::Octree(
   stat = StatisticType(*this);
 }
 
+//! Construct a child node during a Morton build.
+template<typename DistanceType, typename StatisticType, typename MatType>
+Octree<DistanceType, StatisticType, MatType>::Octree(
+    Octree* parent,
+    const size_t begin,
+    const size_t count,
+    const uint64_t* codes,
+    const size_t maxLeafSize) :
+    begin(begin),
+    count(count),
+    bound(parent->dataset->n_rows),
+    dataset(parent->dataset),
+    parent(parent),
+    nodePool(parent->nodePool),
+    pooled(parent->nodePool != NULL)
+{
+  // Calculate empirical center of data.
+  bound |= dataset->cols(begin, begin + count - 1);
+
+  // Now split the node.
+  MortonSplitNode(codes, maxLeafSize);
+
+  // Calculate the distance from the empirical center of this node to the
+  // empirical center of the parent.
+  arma::Col<ElemType> trueCenter, parentCenter;
+  bound.Center(trueCenter);
+  parent->Bound().Center(parentCenter);
+  parentDistance = distance.Evaluate(trueCenter, parentCenter);
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+
+  // Initialize the statistic.
+  stat = StatisticType(*this);
+}
+
 //! Copy the given tree.
 template<typename DistanceType, typename StatisticType, typename MatType>
 Octree<DistanceType, StatisticType, MatType>::Octree(const Octree& other) :
@@ -350,7 +499,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(const Octree& other) :
     stat(other.stat),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    distance(other.distance)
+    distance(other.distance),
+    nodePool(NULL),
+    pooled(false)
 {
   // If we have any children, we need to create them, and then ensure that their
   // parent links are set right.
@@ -374,9 +525,10 @@ operator=(const Octree& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
+  FreeChildren();
+  if (!pooled)
+    delete nodePool;
+  nodePool = NULL;
 
   begin = other.begin;
   count = other.count;
@@ -411,7 +563,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree(Octree&& other) :
     stat(std::move(other.stat)),
     parentDistance(other.parentDistance),
     furthestDescendantDistance(other.furthestDescendantDistance),
-    distance(std::move(other.distance))
+    distance(std::move(other.distance)),
+    nodePool(other.pooled ? NULL : other.nodePool),
+    pooled(false)
 {
   // Update the parent pointers of the direct children.
   for (size_t i = 0; i < children.size(); ++i)
@@ -423,6 +577,7 @@ Octree<DistanceType, StatisticType, MatType>::Octree(Octree&& other) :
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.parent = NULL;
+  other.nodePool = NULL;
 }
 
 //! Move assignment operator: take ownership of the given tree.
@@ -437,9 +592,10 @@ operator=(Octree&& other)
 
   // Freeing memory that will not be used anymore.
   delete dataset;
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
+  FreeChildren();
+  if (!pooled)
+    delete nodePool;
+  nodePool = NULL;
 
   children = std::move(other.children);
   begin = other.begin;
@@ -451,6 +607,7 @@ operator=(Octree&& other)
   parentDistance = other.ParentDistance();
   furthestDescendantDistance = other.furthestDescendantDistance();
   distance = std::move(other.distance);
+  nodePool = other.pooled ? NULL : other.nodePool;
 
   // Update the parent pointers of the direct children.
   for (size_t i = 0; i < children.size(); ++i)
@@ -462,6 +619,7 @@ operator=(Octree&& other)
   other.parentDistance = 0.0;
   other.furthestDescendantDistance = 0.0;
   other.parent = NULL;
+  other.nodePool = NULL;
 
   return *this;
 }
@@ -474,7 +632,9 @@ Octree<DistanceType, StatisticType, MatType>::Octree() :
     dataset(new MatType()),
     parent(NULL),
     parentDistance(0.0),
-    furthestDescendantDistance(0.0)
+    furthestDescendantDistance(0.0),
+    nodePool(NULL),
+    pooled(false)
 {
   // Nothing to do.
 }
@@ -497,10 +657,11 @@ Octree<DistanceType, StatisticType, MatType>::~Octree()
   if (!parent)
     delete dataset;
 
-  // Now delete each of the children.
-  for (size_t i = 0; i < children.size(); ++i)
-    delete children[i];
-  children.clear();
+  // Now delete each of the children.  Their memory can only be released once
+  // they have all been destroyed.
+  FreeChildren();
+  if (!pooled)
+    delete nodePool;
 }
 
 template<typename DistanceType, typename StatisticType, typename MatType>
@@ -713,14 +874,15 @@ void Octree<DistanceType, StatisticType, MatType>::serialize(
   // If we're loading and we have children, they need to be deleted.
   if (cereal::is_loading<Archive>())
   {
-    for (size_t i = 0; i < children.size(); ++i)
-      delete children[i];
-    children.clear();
+    FreeChildren();
+    if (!pooled)
+      delete nodePool;
 
     if (!parent)
       delete dataset;
 
     parent = NULL;
+    nodePool = NULL;
   }
 
   bool hasParent = (parent != NULL);
@@ -863,7 +1025,7 @@ void Octree<DistanceType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children.push_back(new (AllocateNode()) Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], childCenter, childWidth,
         maxLeafSize));
   }
@@ -965,12 +1127,294 @@ void Octree<DistanceType, StatisticType, MatType>::SplitNode(
         childCenter[d] = center[d] + childWidth;
     }
 
-    children.push_back(new Octree(this, childBegins[i],
+    children.push_back(new (AllocateNode()) Octree(this, childBegins[i],
         childBegins[i + 1] - childBegins[i], oldFromNew, childCenter,
         childWidth, maxLeafSize));
   }
 }
 
+//! Build the tree below the root with the given algorithm.
+template<typename DistanceType, typename StatisticType, typename MatType>
+void Octree<DistanceType, StatisticType, MatType>::BuildRoot(
+    const OctreeBuildType buildType,
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  if (count == 0)
+  {
+    furthestDescendantDistance = 0.0;
+    return;
+  }
+
+  // Calculate empirical center of data.
+  bound |= *dataset;
+
+  if (buildType == MORTON_OCTREE_BUILD)
+  {
+    MortonBuild(oldFromNew, maxLeafSize);
+  }
+  else
+  {
+    arma::Col<ElemType> center;
+    bound.Center(center);
+
+    ElemType maxWidth = 0.0;
+    for (size_t i = 0; i < bound.Dim(); ++i)
+      if (bound[i].Hi() - bound[i].Lo() > maxWidth)
+        maxWidth = bound[i].Hi() - bound[i].Lo();
+
+    if (oldFromNew != NULL)
+      SplitNode(center, maxWidth, *oldFromNew, maxLeafSize);
+    else
+      SplitNode(center, maxWidth, maxLeafSize);
+  }
+
+  furthestDescendantDistance = 0.5 * bound.Diameter();
+}
+
+//! Sort the dataset by Morton code and build the children of the root.
+template<typename DistanceType, typename StatisticType, typename MatType>
+void Octree<DistanceType, StatisticType, MatType>::MortonBuild(
+    std::vector<size_t>* oldFromNew,
+    const size_t maxLeafSize)
+{
+  const size_t dims = dataset->n_rows;
+  if (dims == 0 || dims > 64)
+  {
+    throw std::invalid_argument("Octree::Octree(): a Morton build needs data "
+        "with between 1 and 64 dimensions, but the data has " +
+        std::to_string(dims) + "!");
+  }
+
+  // The points are quantized in the bounding cube of the dataset, so that the
+  // cells of the nodes are cubes, as with the midpoint build.
+  const size_t bitsPerDim = std::min((size_t) 64 / dims, (size_t) 32);
+  const uint64_t maxCell = (uint64_t(1) << bitsPerDim) - 1;
+  double maxWidth = 0.0;
+  arma::vec lo(dims);
+  for (size_t d = 0; d < dims; ++d)
+  {
+    lo[d] = bound[d].Lo();
+    maxWidth = std::max(maxWidth, double(bound[d].Hi() - bound[d].Lo()));
+  }
+  const double scale = (maxWidth > 0.0) ?
+      double(uint64_t(1) << bitsPerDim) / maxWidth : 0.0;
+
+  // Bit b of the cell in dimension d is bit (b * dims + d) of the code, so the
+  // highest group of dims bits selects the child of the root, and so on.
+  std::vector<uint64_t> codes(count);
+  std::vector<size_t> order(count);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < count; ++i)
+  {
+    uint64_t code = 0;
+    for (size_t d = 0; d < dims; ++d)
+    {
+      const double x = std::floor((double((*dataset)(d, i)) - lo[d]) * scale);
+      const uint64_t cell = std::min((uint64_t) std::max(x, 0.0), maxCell);
+      for (size_t b = 0; b < bitsPerDim; ++b)
+        code |= ((cell >> b) & 1) << (b * dims + d);
+    }
+
+    codes[i] = code;
+    order[i] = i;
+  }
+
+  RadixSort(codes, order, bitsPerDim * dims);
+
+  // Permute the dataset (and the mappings) once into Morton order.
+  MatType sorted(dims, count);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < count; ++i)
+    sorted.col(i) = dataset->col(order[i]);
+  *dataset = std::move(sorted);
+
+  if (oldFromNew != NULL)
+  {
+    std::vector<size_t> newOldFromNew(count);
+    for (size_t i = 0; i < count; ++i)
+      newOldFromNew[i] = (*oldFromNew)[order[i]];
+    *oldFromNew = std::move(newOldFromNew);
+  }
+
+  MortonSplitNode(codes.data(), maxLeafSize);
+}
+
+//! Split the node on the first differing group of bits of its Morton codes.
+template<typename DistanceType, typename StatisticType, typename MatType>
+void Octree<DistanceType, StatisticType, MatType>::MortonSplitNode(
+    const uint64_t* codes,
+    const size_t maxLeafSize)
+{
+  // No need to split if we have fewer than the maximum number of points in this
+  // node.
+  if (count <= maxLeafSize)
+    return;
+
+  // The codes are sorted, so the first and the last code of the node differ
+  // the most.  If they are the same, all the points are in the same finest
+  // cell, and the node cannot be split.
+  const uint64_t difference = codes[begin] ^ codes[begin + count - 1];
+  if (difference == 0)
+    return;
+
+  size_t highBit = 63;
+  while ((difference >> highBit) == 0)
+    --highBit;
+
+  // All points agree on the bits above this group; each child holds the points
+  // with one value of the group.  The group is skipped in every node where all
+  // the points have the same value, so no node has a single child.
+  const size_t dims = dataset->n_rows;
+  const size_t shift = (highBit / dims) * dims;
+  const uint64_t lowMask = (uint64_t(1) << shift) - 1;
+
+  std::vector<size_t> childBegins;
+  const uint64_t* end = codes + begin + count;
+  for (size_t start = begin; start < begin + count; )
+  {
+    childBegins.push_back(start);
+    start = std::upper_bound(codes + start, end, codes[start] | lowMask) -
+        codes;
+  }
+  childBegins.push_back(begin + count);
+
+  children.resize(childBegins.size() - 1);
+  auto buildChild = [&](const size_t i)
+  {
+    children[i] = new (AllocateNode()) Octree(this, childBegins[i],
+        childBegins[i + 1] - childBegins[i], codes, maxLeafSize);
+  };
+
+  #ifdef MLPACK_USE_OPENMP
+  if (count >= minParallelBuildSize && omp_get_max_threads() > 1)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is large enough; start a team of threads
+      // that will run the tasks created below this node.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          for (size_t i = 0; i < children.size(); ++i)
+          {
+            #pragma omp task firstprivate(i)
+            buildChild(i);
+          }
+          #pragma omp taskwait
+        }
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < children.size(); ++i)
+      {
+        #pragma omp task firstprivate(i)
+        buildChild(i);
+      }
+      #pragma omp taskwait
+    }
+
+    return;
+  }
+  #endif
+
+  for (size_t i = 0; i < children.size(); ++i)
+    buildChild(i);
+}
+
+//! Stable, parallel LSD radix sort of the codes.
+template<typename DistanceType, typename StatisticType, typename MatType>
+void Octree<DistanceType, StatisticType, MatType>::RadixSort(
+    std::vector<uint64_t>& codes,
+    std::vector<size_t>& order,
+    const size_t bits)
+{
+  const size_t n = codes.size();
+
+  // Each chunk of the input is counted and scattered by one thread.  The
+  // offsets are laid out so that the points of a chunk go after the points
+  // with the same digit in the earlier chunks, which keeps the sort stable and
+  // independent of the number of threads.
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numChunks = std::max((size_t) 1, std::min(
+      (size_t) omp_get_max_threads(), n / 16384));
+  #else
+  const size_t numChunks = 1;
+  #endif
+
+  std::vector<uint64_t> codesBuffer(n);
+  std::vector<size_t> orderBuffer(n);
+  std::vector<size_t> offsets(256 * numChunks);
+
+  for (size_t shift = 0; shift < bits; shift += 8)
+  {
+    std::fill(offsets.begin(), offsets.end(), 0);
+
+    #pragma omp parallel for schedule(static) if (numChunks > 1)
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      size_t* chunkOffsets = offsets.data() + 256 * c;
+      const size_t last = (c + 1) * n / numChunks;
+      for (size_t i = c * n / numChunks; i < last; ++i)
+        ++chunkOffsets[(codes[i] >> shift) & 255];
+    }
+
+    size_t total = 0;
+    for (size_t v = 0; v < 256; ++v)
+    {
+      for (size_t c = 0; c < numChunks; ++c)
+      {
+        const size_t chunkCount = offsets[256 * c + v];
+        offsets[256 * c + v] = total;
+        total += chunkCount;
+      }
+    }
+
+    #pragma omp parallel for schedule(static) if (numChunks > 1)
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      size_t* chunkOffsets = offsets.data() + 256 * c;
+      const size_t last = (c + 1) * n / numChunks;
+      for (size_t i = c * n / numChunks; i < last; ++i)
+      {
+        const size_t position = chunkOffsets[(codes[i] >> shift) & 255]++;
+        codesBuffer[position] = codes[i];
+        orderBuffer[position] = order[i];
+      }
+    }
+
+    codes.swap(codesBuffer);
+    order.swap(orderBuffer);
+  }
+}
+
+//! Get memory for a new child node.
+template<typename DistanceType, typename StatisticType, typename MatType>
+void* Octree<DistanceType, StatisticType, MatType>::AllocateNode()
+{
+  if (nodePool != NULL)
+    return nodePool->Allocate();
+  else
+    return ::operator new(sizeof(Octree));
+}
+
+//! Free the children of this node.
+template<typename DistanceType, typename StatisticType, typename MatType>
+void Octree<DistanceType, StatisticType, MatType>::FreeChildren()
+{
+  // The memory of pooled nodes is released when the pool is destroyed.
+  for (size_t i = 0; i < children.size(); ++i)
+  {
+    if (children[i]->pooled)
+      children[i]->~Octree();
+    else
+      delete children[i];
+  }
+  children.clear();
+}
+
 } // namespace mlpack
 
 #endif
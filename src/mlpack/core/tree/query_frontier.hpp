@@ -0,0 +1,68 @@
+/**
+ * @file core/tree/query_frontier.hpp
+ *
+ * A utility that splits a tree into a set of disjoint subtrees (a "frontier")
+ * that can be processed independently, i.e. by different threads during a
+ * dual-tree traversal.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_QUERY_FRONTIER_HPP
+#define MLPACK_CORE_TREE_QUERY_FRONTIER_HPP
+
+namespace mlpack {
+
+/**
+ * Collect a set of nodes of the given tree such that the subtrees rooted at
+ * those nodes are disjoint and together hold every descendant point of the
+ * root.  The tree is expanded level by level (breadth-first) until at least
+ * `minNodes` nodes are collected or only leaves remain.  Each node of the
+ * frontier can then be used as the root of an independent query traversal.
+ *
+ * Points held directly by non-leaf nodes are not considered; this is correct
+ * for all mlpack trees, where the points of internal nodes (if any) are also
+ * held by a descendant.
+ *
+ * @param root Root of the tree to split.
+ * @param minNodes Minimum number of subtrees to collect, if possible.
+ * @param frontier Vector to store the roots of the collected subtrees in.
+ */
+template<typename TreeType>
+void QueryFrontier(TreeType& root,
+                   const size_t minNodes,
+                   std::vector<TreeType*>& frontier)
+{
+  frontier.clear();
+  frontier.push_back(&root);
+
+  bool expanded = true;
+  while (expanded && frontier.size() < minNodes)
+  {
+    expanded = false;
+    std::vector<TreeType*> nextLevel;
+    nextLevel.reserve(2 * frontier.size());
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      TreeType* node = frontier[i];
+      if (node->IsLeaf())
+      {
+        nextLevel.push_back(node);
+      }
+      else
+      {
+        for (size_t j = 0; j < node->NumChildren(); ++j)
+          nextLevel.push_back(&node->Child(j));
+        expanded = true;
+      }
+    }
+
+    frontier.swap(nextLevel);
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -43,5 +43,6 @@
 #include "rectangle_tree/r_plus_plus_tree_descent_heuristic.hpp"
 #include "rectangle_tree/traits.hpp"
 #include "rectangle_tree/typedef.hpp"
+#include "rectangle_tree/concurrent_rectangle_tree.hpp"
 
 #endif
@@ -0,0 +1,137 @@
+/**
+ * @file core/tree/rectangle_tree/concurrent_rectangle_tree.hpp
+ *
+ * A wrapper around a RectangleTree that can be searched by many threads while
+ * other threads insert and delete points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_RECTANGLE_TREE_CONCURRENT_RECTANGLE_TREE_HPP
+#define MLPACK_CORE_TREE_RECTANGLE_TREE_CONCURRENT_RECTANGLE_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mutex>
+#include <shared_mutex>
+
+namespace mlpack {
+
+/**
+ * ConcurrentRectangleTree holds a RectangleTree (or any other tree type that
+ * supports Insert() and Delete()) and lets any number of reader threads search
+ * it while writer threads update it, without keeping a second copy of the
+ * tree.  Readers run with a shared lock, so they never wait for each other;
+ * updates run with an exclusive lock, so a reader only ever sees the tree
+ * before or after a complete update, and never a half-split node or a dataset
+ * that is being resized.
+ *
+ * Readers wait while an update is applied, so updates should be batched: one
+ * Insert() call with many points, or one Write() call that applies several
+ * InsertPoint() and DeletePoint() calls, holds the lock once.
+ *
+ * @code
+ * ConcurrentRectangleTree<RStarTree<>> tree(RStarTree<>(data));
+ *
+ * // In any number of reader threads:
+ * tree.Read([&](RStarTree<>& t)
+ * {
+ *   RangeSearch<EuclideanDistance, arma::mat, RStarTree> rs(&t);
+ *   rs.Search(queries, Range(0.0, 0.1), neighbors, distances);
+ * });
+ *
+ * // In a writer thread:
+ * tree.Insert(newPoints);
+ * @endcode
+ *
+ * References to nodes or to the dataset of the tree must not be kept after
+ * Read() returns, since an update may invalidate them.
+ *
+ * @tparam TreeType Type of the tree that is held.
+ */
+template<typename TreeType>
+class ConcurrentRectangleTree
+{
+ public:
+  /**
+   * Create the object, taking ownership of the given tree.
+   *
+   * @param tree The tree; it must be the root of the tree.
+   */
+  ConcurrentRectangleTree(TreeType&& tree) : tree(std::move(tree)) { }
+
+  /**
+   * Call f(tree) while holding a shared lock, and return its result.  Other
+   * readers may call Read() at the same time, so f must not modify the tree;
+   * non-const access is given so that search objects that need a non-const
+   * tree pointer (like RangeSearch) can be built on it.
+   *
+   * @param f Function to call with the tree.
+   */
+  template<typename FunctionType>
+  decltype(auto) Read(FunctionType&& f) const
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return f(tree);
+  }
+
+  /**
+   * Call f(tree) while holding an exclusive lock, and return its result.  Use
+   * this to apply several updates (for instance with InsertPoint() and
+   * DeletePoint()) at once.
+   *
+   * @param f Function to call with the tree.
+   */
+  template<typename FunctionType>
+  decltype(auto) Write(FunctionType&& f)
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return f(tree);
+  }
+
+  /**
+   * Insert the given points into the tree and its dataset; see
+   * RectangleTree::Insert().
+   *
+   * @param points Points to insert.
+   */
+  template<typename InMatType>
+  void Insert(const InMatType& points)
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    tree.Insert(points);
+  }
+
+  /**
+   * Delete the point with the given index from the tree and its dataset; see
+   * RectangleTree::Delete().
+   *
+   * @param pointIndex Index of the point to delete.
+   */
+  void Delete(const size_t pointIndex)
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    tree.Delete(pointIndex);
+  }
+
+  /**
+   * Get the number of points held in the tree.
+   */
+  size_t NumDescendants() const
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return tree.NumDescendants();
+  }
+
+ private:
+  //! The tree.  It is mutable so that readers can get a non-const reference.
+  mutable TreeType tree;
+  //! The lock that protects the tree.
+  mutable std::shared_mutex mutex;
+};
+
+} // namespace mlpack
+
+#endif
@@ -116,6 +116,78 @@ RectangleTree(MatType&& data,
   BuildStatistics(this);
 }
 
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<DistanceType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(const MatType& data,
+              const RectangleTreeBulkLoad bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(data)),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoad);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+RectangleTree<DistanceType, StatisticType, MatType, SplitType, DescentType,
+              AuxiliaryInformationType>::
+RectangleTree(MatType&& data,
+              const RectangleTreeBulkLoad bulkLoad,
+              const size_t maxLeafSize,
+              const size_t minLeafSize,
+              const size_t maxNumChildren,
+              const size_t minNumChildren) :
+    maxNumChildren(maxNumChildren),
+    minNumChildren(minNumChildren),
+    numChildren(0),
+    children(maxNumChildren + 1), // Add one to make splitting the node simpler.
+    parent(NULL),
+    count(0),
+    numDescendants(0),
+    maxLeafSize(maxLeafSize),
+    minLeafSize(minLeafSize),
+    bound(data.n_rows),
+    parentDistance(0),
+    dataset(new MatType(std::move(data))),
+    ownsDataset(true),
+    points(maxLeafSize + 1), // Add one to make splitting the node simpler.
+    auxiliaryInfo(this)
+{
+  BulkLoad(bulkLoad);
+
+  // Initialize statistic recursively after tree construction is complete.
+  BuildStatistics(this);
+}
+
 template<typename DistanceType,
          typename StatisticType,
          typename MatType,
@@ -419,6 +491,175 @@ RectangleTree(
   ar(CEREAL_NVP(*this));
 }
 
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<DistanceType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoad(const RectangleTreeBulkLoad bulkLoad)
+{
+  // The auxiliary information of other tree types depends on the order in
+  // which the points are inserted.
+  static_assert(std::is_same_v<AuxiliaryInformationType<RectangleTree>,
+      NoAuxiliaryInformation<RectangleTree>> ||
+      std::is_same_v<AuxiliaryInformationType<RectangleTree>,
+      XTreeAuxiliaryInformation<RectangleTree>>,
+      "RectangleTree: bulk loading is only available for trees without "
+      "auxiliary information or with XTreeAuxiliaryInformation.");
+
+  if (!TreeTraits<RectangleTree>::HasOverlappingChildren &&
+      bulkLoad != STR_BULK_LOAD)
+  {
+    throw std::invalid_argument("RectangleTree: trees whose children cannot "
+        "overlap can only be bulk-loaded with STR_BULK_LOAD!");
+  }
+
+  const size_t n = dataset->n_cols;
+  if (n == 0)
+    return;
+
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+
+  if (bulkLoad == HILBERT_BULK_LOAD)
+  {
+    // Sort all of the points by their Hilbert values; the points of every node
+    // are then a contiguous range of that order.
+    using HilbertValueType = DiscreteHilbertValue<ElemType>;
+    using HilbertElemType = typename HilbertValueType::HilbertElemType;
+    arma::Mat<HilbertElemType> values(dataset->n_rows, n);
+    for (size_t i = 0; i < n; ++i)
+      values.col(i) = HilbertValueType::CalculateValue(dataset->col(i));
+
+    std::sort(order.begin(), order.end(),
+        [&values](const size_t a, const size_t b)
+        {
+          const HilbertElemType* valueA = values.colptr(a);
+          const HilbertElemType* valueB = values.colptr(b);
+          for (size_t i = 0; i < values.n_rows; ++i)
+          {
+            if (valueA[i] != valueB[i])
+              return valueA[i] < valueB[i];
+          }
+          return false;
+        });
+  }
+
+  // Use the smallest height at which the tree can hold all of the points.
+  size_t height = 0;
+  size_t capacity = maxLeafSize;
+  while (capacity < n)
+  {
+    capacity *= maxNumChildren;
+    ++height;
+  }
+
+  BulkLoadNode(order, 0, n, height, bulkLoad);
+}
+
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<DistanceType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+BulkLoadNode(std::vector<size_t>& order,
+             const size_t begin,
+             const size_t end,
+             const size_t height,
+             const RectangleTreeBulkLoad bulkLoad)
+{
+  const size_t numPoints = end - begin;
+  numDescendants = numPoints;
+
+  if (height == 0)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      points[count++] = order[i];
+      bound |= dataset->col(order[i]);
+    }
+    return;
+  }
+
+  // Use as few children as possible, but never only one.  Since the root has
+  // the smallest possible height and the points are split evenly, every child
+  // gets at least half of the points it can hold, so the fill requirements are
+  // satisfied as long as the minimum fills are at most half of the maximums.
+  size_t childCapacity = maxLeafSize;
+  for (size_t i = 1; i < height; ++i)
+    childCapacity *= maxNumChildren;
+  const size_t numNodeChildren = std::min(numPoints, std::max((size_t) 2,
+      (numPoints + childCapacity - 1) / childCapacity));
+
+  if (bulkLoad == STR_BULK_LOAD)
+  {
+    TilePoints(order, begin, numPoints, numNodeChildren, 0, numNodeChildren,
+        0);
+  }
+
+  for (size_t i = 0; i < numNodeChildren; ++i)
+  {
+    RectangleTree* child = new RectangleTree(this);
+    children[numChildren++] = child;
+    child->BulkLoadNode(order, begin + i * numPoints / numNodeChildren,
+        begin + (i + 1) * numPoints / numNodeChildren, height - 1, bulkLoad);
+    bound |= child->Bound();
+  }
+}
+
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         typename SplitType,
+         typename DescentType,
+         template<typename> class AuxiliaryInformationType>
+void RectangleTree<DistanceType, StatisticType, MatType, SplitType, DescentType,
+                   AuxiliaryInformationType>::
+TilePoints(std::vector<size_t>& order,
+           const size_t begin,
+           const size_t numPoints,
+           const size_t numChildren,
+           const size_t firstChild,
+           const size_t lastChild,
+           const size_t dim) const
+{
+  const size_t numTiles = lastChild - firstChild;
+  if (numTiles <= 1)
+    return;
+
+  // Sort the points along this dimension.
+  const MatType& data = *dataset;
+  std::sort(order.begin() + begin + firstChild * numPoints / numChildren,
+      order.begin() + begin + lastChild * numPoints / numChildren,
+      [&data, dim](const size_t a, const size_t b)
+      {
+        return data(dim, a) < data(dim, b);
+      });
+
+  // In the last dimension, the tiles are consecutive runs of the sorted
+  // points.
+  if (dim + 1 >= data.n_rows)
+    return;
+
+  // Otherwise cut the points into slabs of whole tiles, and tile each slab
+  // along the remaining dimensions.
+  const size_t numSlabs = std::min(numTiles, (size_t) std::ceil(
+      std::pow((double) numTiles, 1.0 / (data.n_rows - dim)) - 1e-9));
+  const size_t tilesPerSlab = (numTiles + numSlabs - 1) / numSlabs;
+  for (size_t first = firstChild; first < lastChild; first += tilesPerSlab)
+  {
+    TilePoints(order, begin, numPoints, numChildren, first,
+        std::min(first + tilesPerSlab, lastChild), dim + 1);
+  }
+}
+
 /**
  * Deletes this node, deallocating the memory for the children and calling
  * their destructors in turn.  This will invalidate any pointers or references
@@ -41,7 +41,9 @@ class SpillTree<DistanceType, StatisticType, MatType, HyperplaneType,
   SpillDualTreeTraverser(RuleType& rule);
 
   /**
-   * Traverse the two trees.  This does not reset the number of prunes.
+   * Traverse the two trees.  This does not reset the number of prunes.  If
+   * MaxLeaves() is not 0, at most that many reference leaves (or brute-force
+   * searched nodes) are visited for each query node.
    *
    * @param queryNode The query node to be traversed.
    * @param referenceNode The reference node to be traversed.
@@ -72,6 +74,15 @@ class SpillTree<DistanceType, StatisticType, MatType, HyperplaneType,
   //! Modify the number of times a base case was calculated.
   size_t& NumBaseCases() { return numBaseCases; }
 
+  //! Get the maximum number of reference leaves visited for each query node (0
+  //! means no limit).
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of reference leaves visited for each query
+  //! node.  With a limit, the time of each query is bounded regardless of the
+  //! overlapping size of the reference tree, but the results may be less
+  //! accurate.  The counts are kept between calls to Traverse().
+  size_t& MaxLeaves() { return maxLeaves; }
+
  private:
   //! Reference to the rules with which the trees will be traversed.
   RuleType& rule;
@@ -88,6 +99,12 @@ class SpillTree<DistanceType, StatisticType, MatType, HyperplaneType,
   //! The number of times a base case was calculated.
   size_t numBaseCases;
 
+  //! The maximum number of reference leaves visited for each query node.
+  size_t maxLeaves;
+
+  //! The number of reference leaves visited for each query node.
+  std::unordered_map<const SpillTree*, size_t> leavesVisited;
+
   //! Traversal information, held in the class so that it isn't continually
   //! being reallocated.
   typename RuleType::TraversalInfoType traversalInfo;
@@ -34,7 +34,8 @@ SpillDualTreeTraverser<RuleType, Defeatist>::SpillDualTreeTraverser(
     numPrunes(0),
     numVisited(0),
     numScores(0),
-    numBaseCases(0)
+    numBaseCases(0),
+    maxLeaves(0)
 { /* Nothing to do. */ }
 
 template<typename DistanceType,
@@ -53,6 +54,18 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
         referenceNode,
     const bool bruteForce)
 {
+  // If the leaf budget of a query leaf is spent, there is nothing left to do
+  // for it.
+  if (maxLeaves > 0 && queryNode.IsLeaf())
+  {
+    const auto it = leavesVisited.find(&queryNode);
+    if (it != leavesVisited.end() && it->second >= maxLeaves)
+    {
+      ++numPrunes;
+      return;
+    }
+  }
+
   // Increment the visit counter.
   ++numVisited;
 
@@ -76,6 +89,17 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
   {
     // If both are leaves or if we explicitly need to do brute-force search, we
     // must evaluate the base cases.
+    if (maxLeaves > 0)
+    {
+      size_t& visited = leavesVisited[&queryNode];
+      if (visited >= maxLeaves)
+      {
+        ++numPrunes;
+        return;
+      }
+
+      ++visited;
+    }
 
     // Loop through each of the points in each node.
     const size_t queryEnd = queryNode.NumDescendants();
@@ -140,6 +164,7 @@ SpillDualTreeTraverser<RuleType, Defeatist>::Traverse(
         // point in the query node.
         const size_t queryEnd = queryNode.NumPoints();
         DefeatistSingleTreeTraverser<RuleType> st(rule);
+        st.MaxLeaves() = maxLeaves;
         // Loop through each of the points in query node.
         for (size_t query = 0; query < queryEnd; ++query)
         {
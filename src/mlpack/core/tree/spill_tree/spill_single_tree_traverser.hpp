@@ -40,7 +40,8 @@ class SpillTree<DistanceType, StatisticType, MatType, HyperplaneType,
   SpillSingleTreeTraverser(RuleType& rule);
 
   /**
-   * Traverse the tree with the given point.
+   * Traverse the tree with the given point.  If MaxLeaves() is not 0, at most
+   * that many leaves (or brute-force searched nodes) are visited for the point.
    *
    * @param queryIndex The index of the point in the query set which is being
    *     used as the query point.
@@ -57,12 +58,31 @@ class SpillTree<DistanceType, StatisticType, MatType, HyperplaneType,
   //! Modify the number of prunes.
   size_t& NumPrunes() { return numPrunes; }
 
+  //! Get the maximum number of leaves visited for each query point (0 means
+  //! no limit).
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of leaves visited for each query point.  With a
+  //! limit, the time of each query is bounded regardless of the overlapping
+  //! size of the tree, but the results may be less accurate.
+  size_t& MaxLeaves() { return maxLeaves; }
+
  private:
+  //! Traverse the given node, counting the visited leaves.
+  void TraverseNode(const size_t queryIndex,
+                    SpillTree& referenceNode,
+                    const bool bruteForce = false);
+
   //! Reference to the rules with which the tree will be traversed.
   RuleType& rule;
 
   //! The number of nodes which have been pruned during traversal.
   size_t numPrunes;
+
+  //! The maximum number of leaves visited for each query point.
+  size_t maxLeaves;
+
+  //! The number of leaves visited for the current query point.
+  size_t leavesVisited;
 };
 
 } // namespace mlpack
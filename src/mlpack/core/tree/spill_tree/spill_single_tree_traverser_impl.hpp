@@ -31,7 +31,9 @@ SpillTree<DistanceType, StatisticType, MatType, HyperplaneType, SplitType>::
 SpillSingleTreeTraverser<RuleType, Defeatist>::SpillSingleTreeTraverser(
     RuleType& rule) :
     rule(rule),
-    numPrunes(0)
+    numPrunes(0),
+    maxLeaves(0),
+    leavesVisited(0)
 { /* Nothing to do. */ }
 
 template<typename DistanceType,
@@ -49,6 +51,33 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
         referenceNode,
     const bool bruteForce)
 {
+  // The leaf budget is counted separately for each query point.
+  leavesVisited = 0;
+  TraverseNode(queryIndex, referenceNode, bruteForce);
+}
+
+template<typename DistanceType,
+         typename StatisticType,
+         typename MatType,
+         template<typename HyperplaneDistanceType> class HyperplaneType,
+         template<typename SplitDistanceType, typename SplitMatType>
+             class SplitType>
+template<typename RuleType, bool Defeatist>
+void
+SpillTree<DistanceType, StatisticType, MatType, HyperplaneType, SplitType>::
+SpillSingleTreeTraverser<RuleType, Defeatist>::TraverseNode(
+    const size_t queryIndex,
+    SpillTree<DistanceType, StatisticType, MatType, HyperplaneType, SplitType>&
+        referenceNode,
+    const bool bruteForce)
+{
+  // Stop once the leaf budget of the query point is spent.
+  if (maxLeaves > 0 && leavesVisited >= maxLeaves)
+  {
+    ++numPrunes;
+    return;
+  }
+
   // If we have too few points, then we need to backtrack up one level and
   // brute-force search.
   if (!bruteForce && Defeatist &&
@@ -56,10 +85,11 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
       (referenceNode.Parent() != NULL) &&
       (referenceNode.Parent()->Overlap()))
   {
-    Traverse(queryIndex, *referenceNode.Parent(), true);
+    TraverseNode(queryIndex, *referenceNode.Parent(), true);
   }
   else if (referenceNode.IsLeaf() || bruteForce)
   {
+    ++leavesVisited;
     for (size_t i = 0; i < referenceNode.NumDescendants(); ++i)
       rule.BaseCase(queryIndex, referenceNode.Descendant(i));
   }
@@ -69,7 +99,7 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
     {
       // If referenceNode is a overlapping node we do defeatist search.
       size_t bestChild = rule.GetBestChild(queryIndex, referenceNode);
-      Traverse(queryIndex, referenceNode.Child(bestChild));
+      TraverseNode(queryIndex, referenceNode.Child(bestChild));
       ++numPrunes;
     }
     else
@@ -81,27 +111,27 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
       if (leftScore < rightScore)
       {
         // Recurse to the left.
-        Traverse(queryIndex, *referenceNode.Left());
+        TraverseNode(queryIndex, *referenceNode.Left());
 
         // Is it still valid to recurse to the right?
         rightScore = rule.Rescore(queryIndex, *referenceNode.Right(),
             rightScore);
 
         if (rightScore != DBL_MAX) // Recurse to the right.
-          Traverse(queryIndex, *referenceNode.Right());
+          TraverseNode(queryIndex, *referenceNode.Right());
         else
           ++numPrunes;
       }
       else if (rightScore < leftScore)
       {
         // Recurse to the right.
-        Traverse(queryIndex, *referenceNode.Right());
+        TraverseNode(queryIndex, *referenceNode.Right());
 
         // Is it still valid to recurse to the left?
         leftScore = rule.Rescore(queryIndex, *referenceNode.Left(), leftScore);
 
         if (leftScore != DBL_MAX) // Recurse to the left.
-          Traverse(queryIndex, *referenceNode.Left());
+          TraverseNode(queryIndex, *referenceNode.Left());
         else
           ++numPrunes;
       }
@@ -114,14 +144,14 @@ SpillSingleTreeTraverser<RuleType, Defeatist>::Traverse(
         else
         {
           // Choose the left first.
-          Traverse(queryIndex, *referenceNode.Left());
+          TraverseNode(queryIndex, *referenceNode.Left());
 
           // Is it still valid to recurse to the right?
           rightScore = rule.Rescore(queryIndex, *referenceNode.Right(),
               rightScore);
 
           if (rightScore != DBL_MAX)
-            Traverse(queryIndex, *referenceNode.Right());
+            TraverseNode(queryIndex, *referenceNode.Right());
           else
             ++numPrunes;
         }
@@ -0,0 +1,144 @@
+/**
+ * @file core/tree/symmetric_dual_tree_traverser.hpp
+ *
+ * A dual-tree traverser for self-joins, which traverses a tree against itself
+ * and visits each unordered pair of nodes (and of points) only once.  The
+ * RuleType class must apply each base case and each score to both nodes of
+ * the pair.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SYMMETRIC_DUAL_TREE_TRAVERSER_HPP
+#define MLPACK_CORE_TREE_SYMMETRIC_DUAL_TREE_TRAVERSER_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "tree_traits.hpp"
+
+namespace mlpack {
+
+/**
+ * The SymmetricTraversalTraits class tells whether a tree type can be used by
+ * the SymmetricDualTreeTraverser: every point must be held by exactly one leaf
+ * of the tree, so that two different nodes of the tree either hold disjoint
+ * sets of points, or one of them is an ancestor of the other.  This is false
+ * for cover trees (whose points are held by internal nodes too) and for spill
+ * trees (whose children may share points).
+ */
+template<typename TreeType>
+class SymmetricTraversalTraits
+{
+ public:
+  //! Whether the tree type can be traversed symmetrically.
+  static const bool Supported = !TreeTraits<TreeType>::HasSelfChildren &&
+      !TreeTraits<TreeType>::HasDuplicatedPoints;
+};
+
+/**
+ * The SymmetricDualTreeTraverser traverses a tree against itself for a
+ * monochromatic search (a self-join), where the query set is the reference
+ * set.  The usual dual-tree traversal visits each pair of nodes (a, b) twice,
+ * once with a as the query node and once with b as the query node; this
+ * traverser only visits one of the two, and in leaves it only calls
+ * `BaseCase(i, j)` for one of the two orders of each pair of distinct points.
+ *
+ * The traversal starts at the pair (root, root).  The children of a pair of
+ * identical nodes are the pairs (c_i, c_j) with i <= j; the children of a pair
+ * of different nodes are the pairs of their children, like in the usual
+ * traversal.  Since every point is held by exactly one leaf, the two nodes of
+ * each visited pair are identical or disjoint.
+ *
+ * The rules must therefore be symmetric:
+ *
+ *  - `BaseCase(i, j)` must record the result for both i and j;
+ *  - `Score(a, b)` and `Rescore(a, b, oldScore)` may only prune the pair if
+ *    it can be pruned both for the points of a against b and for the points of
+ *    b against a, and if a pair of nodes is known to be entirely in the results
+ *    (as in range search), both directions must be added.
+ *
+ * Pairs of identical nodes are never scored.
+ *
+ * @tparam TreeType Type of tree to traverse; SymmetricTraversalTraits must
+ *     allow it.
+ * @tparam RuleType Type of symmetric rules.
+ */
+template<typename TreeType, typename RuleType>
+class SymmetricDualTreeTraverser
+{
+ public:
+  static_assert(SymmetricTraversalTraits<TreeType>::Supported,
+      "SymmetricDualTreeTraverser: each point of the tree must be held by "
+      "exactly one leaf.");
+
+  /**
+   * Instantiate the symmetric dual-tree traverser with the given rule set.
+   */
+  SymmetricDualTreeTraverser(RuleType& rule);
+
+  /**
+   * Traverse all unordered pairs of nodes and points of the given tree.
+   *
+   * @param root The tree to traverse against itself.
+   */
+  void Traverse(TreeType& root);
+
+  /**
+   * Traverse the pairs of descendants of the given nodes of the same tree,
+   * which must be identical or disjoint.  If they are disjoint, each pair of
+   * their descendants is visited once; if they are identical, this is the same
+   * as Traverse(a).  Disjoint subtrees of a tree can thus be traversed
+   * independently.  This does not reset the statistics of the traverser.
+   *
+   * @param a The first node.
+   * @param b The second node.
+   */
+  void Traverse(TreeType& a, TreeType& b);
+
+  //! Get the number of prunes.
+  size_t NumPrunes() const { return numPrunes; }
+  //! Modify the number of prunes.
+  size_t& NumPrunes() { return numPrunes; }
+
+  //! Get the number of visited combinations.
+  size_t NumVisited() const { return numVisited; }
+  //! Modify the number of visited combinations.
+  size_t& NumVisited() { return numVisited; }
+
+  //! Get the number of times a node combination was scored.
+  size_t NumScores() const { return numScores; }
+  //! Modify the number of times a node combination was scored.
+  size_t& NumScores() { return numScores; }
+
+  //! Get the number of times a base case was calculated.
+  size_t NumBaseCases() const { return numBaseCases; }
+  //! Modify the number of times a base case was calculated.
+  size_t& NumBaseCases() { return numBaseCases; }
+
+ private:
+  //! Recurse into a pair of nodes that was not pruned.
+  void TraverseScored(TreeType& a, TreeType& b);
+
+  //! Reference to the rules with which the tree will be traversed.
+  RuleType& rule;
+
+  //! The number of prunes.
+  size_t numPrunes;
+
+  //! The number of node combinations that have been visited during traversal.
+  size_t numVisited;
+
+  //! The number of times a node combination was scored.
+  size_t numScores;
+
+  //! The number of times a base case was calculated.
+  size_t numBaseCases;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "symmetric_dual_tree_traverser_impl.hpp"
+
+#endif
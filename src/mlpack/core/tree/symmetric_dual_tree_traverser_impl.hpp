@@ -0,0 +1,171 @@
+/**
+ * @file core/tree/symmetric_dual_tree_traverser_impl.hpp
+ *
+ * Implementation of the SymmetricDualTreeTraverser, which visits each
+ * unordered pair of nodes of a tree only once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_SYMMETRIC_DUAL_TREE_TRAVERSER_IMPL_HPP
+#define MLPACK_CORE_TREE_SYMMETRIC_DUAL_TREE_TRAVERSER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "symmetric_dual_tree_traverser.hpp"
+
+namespace mlpack {
+
+template<typename TreeType, typename RuleType>
+SymmetricDualTreeTraverser<TreeType, RuleType>::SymmetricDualTreeTraverser(
+    RuleType& rule) :
+    rule(rule),
+    numPrunes(0),
+    numVisited(0),
+    numScores(0),
+    numBaseCases(0)
+{ /* Nothing to do. */ }
+
+template<typename TreeType, typename RuleType>
+void SymmetricDualTreeTraverser<TreeType, RuleType>::Traverse(TreeType& root)
+{
+  Traverse(root, root);
+}
+
+template<typename TreeType, typename RuleType>
+void SymmetricDualTreeTraverser<TreeType, RuleType>::Traverse(
+    TreeType& a,
+    TreeType& b)
+{
+  ++numVisited;
+
+  // A node is never pruned against itself.
+  if (&a != &b)
+  {
+    ++numScores;
+    if (rule.Score(a, b) == DBL_MAX)
+    {
+      ++numPrunes;
+      return;
+    }
+  }
+
+  TraverseScored(a, b);
+}
+
+template<typename TreeType, typename RuleType>
+void SymmetricDualTreeTraverser<TreeType, RuleType>::TraverseScored(
+    TreeType& a,
+    TreeType& b)
+{
+  if (a.IsLeaf() && b.IsLeaf())
+  {
+    if (&a == &b)
+    {
+      // Each pair of distinct points once.
+      for (size_t i = 0; i < a.NumPoints(); ++i)
+      {
+        for (size_t j = i + 1; j < a.NumPoints(); ++j)
+        {
+          rule.BaseCase(a.Point(i), a.Point(j));
+          ++numBaseCases;
+        }
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < a.NumPoints(); ++i)
+      {
+        for (size_t j = 0; j < b.NumPoints(); ++j)
+        {
+          rule.BaseCase(a.Point(i), b.Point(j));
+          ++numBaseCases;
+        }
+      }
+    }
+
+    return;
+  }
+
+  // Collect the pairs of children to recurse into, with their scores.  Pairs
+  // of identical nodes get a score of 0, so they are visited first; this
+  // usually tightens the bounds of the rules the most.
+  struct ChildPair
+  {
+    double score;
+    TreeType* a;
+    TreeType* b;
+  };
+
+  std::vector<ChildPair> pairs;
+  if (&a == &b)
+  {
+    pairs.reserve(a.NumChildren() * (a.NumChildren() + 1) / 2);
+    for (size_t i = 0; i < a.NumChildren(); ++i)
+    {
+      pairs.push_back({ 0.0, &a.Child(i), &a.Child(i) });
+      for (size_t j = i + 1; j < a.NumChildren(); ++j)
+      {
+        ++numScores;
+        pairs.push_back({ rule.Score(a.Child(i), a.Child(j)), &a.Child(i),
+            &a.Child(j) });
+      }
+    }
+  }
+  else if (a.IsLeaf())
+  {
+    pairs.reserve(b.NumChildren());
+    for (size_t j = 0; j < b.NumChildren(); ++j)
+    {
+      ++numScores;
+      pairs.push_back({ rule.Score(a, b.Child(j)), &a, &b.Child(j) });
+    }
+  }
+  else if (b.IsLeaf())
+  {
+    pairs.reserve(a.NumChildren());
+    for (size_t i = 0; i < a.NumChildren(); ++i)
+    {
+      ++numScores;
+      pairs.push_back({ rule.Score(a.Child(i), b), &a.Child(i), &b });
+    }
+  }
+  else
+  {
+    pairs.reserve(a.NumChildren() * b.NumChildren());
+    for (size_t i = 0; i < a.NumChildren(); ++i)
+    {
+      for (size_t j = 0; j < b.NumChildren(); ++j)
+      {
+        ++numScores;
+        pairs.push_back({ rule.Score(a.Child(i), b.Child(j)), &a.Child(i),
+            &b.Child(j) });
+      }
+    }
+  }
+
+  std::stable_sort(pairs.begin(), pairs.end(),
+      [](const ChildPair& x, const ChildPair& y) { return x.score < y.score; });
+
+  for (size_t i = 0; i < pairs.size(); ++i)
+  {
+    ++numVisited;
+    if (pairs[i].a != pairs[i].b)
+    {
+      // Earlier recursions may have tightened the bounds.
+      if (pairs[i].score == DBL_MAX ||
+          rule.Rescore(*pairs[i].a, *pairs[i].b, pairs[i].score) == DBL_MAX)
+      {
+        ++numPrunes;
+        continue;
+      }
+    }
+
+    TraverseScored(*pairs[i].a, *pairs[i].b);
+  }
+}
+
+} // namespace mlpack
+
+#endif
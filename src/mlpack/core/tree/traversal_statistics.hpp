@@ -0,0 +1,227 @@
+/**
+ * @file core/tree/traversal_statistics.hpp
+ *
+ * Definition of TraversalStatistics, an optional collector of detailed
+ * statistics about tree traversals that RuleType classes record into.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+#define MLPACK_CORE_TREE_TRAVERSAL_STATISTICS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * TraversalStatistics collects statistics about one or more tree traversals,
+ * beyond the total number of base cases and scores that a RuleType already
+ * counts.  This is useful to find out why a search is slow: for instance, few
+ * prunes at the top levels of the tree suggest a tree type that does not fit
+ * the data, and many base cases per leaf suggest a leaf size that is too
+ * large.  The statistics collected are:
+ *
+ *  - the number of scores and prunes at each level of the reference tree
+ *    (the root is level 0);
+ *  - the number of base cases, and the number of visits to reference leaves
+ *    that were not pruned;
+ *  - the number of node combinations that were revisited (rescored) after
+ *    being scored, and how many of those were pruned;
+ *  - the deepest query and reference nodes that were scored.
+ *
+ * Collection is opt-in: a RuleType that supports it has a `Statistics()`
+ * member that holds a pointer to a TraversalStatistics object, which is NULL
+ * by default.  When it is set, every call to `Score()`, `Rescore()` and
+ * `BaseCase()` is recorded.  Finding the level of a node takes time
+ * proportional to its depth, so collection slows down the traversal.  A
+ * TraversalStatistics object must not be shared between threads; instead,
+ * each thread records into its own object, and the results are combined with
+ * Merge().
+ */
+class TraversalStatistics
+{
+ public:
+  //! Create an empty set of statistics.
+  TraversalStatistics() { Reset(); }
+
+  //! Clear all statistics.
+  void Reset()
+  {
+    levelScores.clear();
+    levelPrunes.clear();
+    baseCases = 0;
+    leafVisits = 0;
+    rescores = 0;
+    rescorePrunes = 0;
+    maxQueryDepth = 0;
+    maxReferenceDepth = 0;
+  }
+
+  /**
+   * Record the score of a reference node (for single-tree traversals).
+   *
+   * @param referenceNode Reference node that was scored.
+   * @param score Score that was returned; DBL_MAX means a prune.
+   */
+  template<typename TreeType>
+  void RecordScore(const TreeType& referenceNode, const double score)
+  {
+    const size_t depth = Depth(referenceNode);
+    if (depth >= levelScores.size())
+    {
+      levelScores.resize(depth + 1, 0);
+      levelPrunes.resize(depth + 1, 0);
+    }
+
+    ++levelScores[depth];
+    maxReferenceDepth = std::max(maxReferenceDepth, depth);
+    if (score == DBL_MAX)
+      ++levelPrunes[depth];
+    else if (referenceNode.NumChildren() == 0)
+      ++leafVisits;
+  }
+
+  /**
+   * Record the score of a combination of a query node and a reference node
+   * (for dual-tree traversals).
+   *
+   * @param queryNode Query node that was scored.
+   * @param referenceNode Reference node that was scored.
+   * @param score Score that was returned; DBL_MAX means a prune.
+   */
+  template<typename TreeType>
+  void RecordScore(const TreeType& queryNode,
+                   const TreeType& referenceNode,
+                   const double score)
+  {
+    maxQueryDepth = std::max(maxQueryDepth, Depth(queryNode));
+    RecordScore(referenceNode, score);
+  }
+
+  /**
+   * Record that a node (or node combination) was rescored.
+   *
+   * @param score Score that was returned; DBL_MAX means a prune.
+   */
+  void RecordRescore(const double score)
+  {
+    ++rescores;
+    if (score == DBL_MAX)
+      ++rescorePrunes;
+  }
+
+  //! Record the given number of base cases.
+  void RecordBaseCases(const size_t count = 1) { baseCases += count; }
+
+  //! Add the statistics of another collector to this one.
+  void Merge(const TraversalStatistics& other)
+  {
+    if (other.levelScores.size() > levelScores.size())
+    {
+      levelScores.resize(other.levelScores.size(), 0);
+      levelPrunes.resize(other.levelPrunes.size(), 0);
+    }
+
+    for (size_t i = 0; i < other.levelScores.size(); ++i)
+    {
+      levelScores[i] += other.levelScores[i];
+      levelPrunes[i] += other.levelPrunes[i];
+    }
+
+    baseCases += other.baseCases;
+    leafVisits += other.leafVisits;
+    rescores += other.rescores;
+    rescorePrunes += other.rescorePrunes;
+    maxQueryDepth = std::max(maxQueryDepth, other.maxQueryDepth);
+    maxReferenceDepth = std::max(maxReferenceDepth, other.maxReferenceDepth);
+  }
+
+  //! Get the number of scores at each level of the reference tree.
+  const std::vector<size_t>& LevelScores() const { return levelScores; }
+  //! Get the number of prunes at each level of the reference tree.
+  const std::vector<size_t>& LevelPrunes() const { return levelPrunes; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+  //! Get the number of visits to reference leaves that were not pruned.
+  size_t LeafVisits() const { return leafVisits; }
+  //! Get the average number of base cases per visit to a reference leaf.
+  double BaseCasesPerLeaf() const
+  {
+    return (leafVisits == 0) ? 0.0 : double(baseCases) / leafVisits;
+  }
+
+  //! Get the number of node combinations that were revisited (rescored).
+  size_t Rescores() const { return rescores; }
+  //! Get the number of revisited node combinations that were pruned.
+  size_t RescorePrunes() const { return rescorePrunes; }
+
+  //! Get the level of the deepest query node that was scored.
+  size_t MaxQueryDepth() const { return maxQueryDepth; }
+  //! Get the level of the deepest reference node that was scored.
+  size_t MaxReferenceDepth() const { return maxReferenceDepth; }
+
+  /**
+   * Print the statistics to the given stream (such as Log::Info), one line
+   * per statistic and per level of the reference tree.
+   *
+   * @param stream Stream to print to.
+   */
+  template<typename StreamType>
+  void Print(StreamType& stream) const
+  {
+    stream << "Traversal statistics:" << std::endl;
+    stream << "  " << baseCases << " base cases in " << leafVisits
+        << " visits to reference leaves (" << BaseCasesPerLeaf()
+        << " base cases per leaf visit)." << std::endl;
+    stream << "  " << rescores << " node combinations were revisited; "
+        << rescorePrunes << " of them were pruned." << std::endl;
+    stream << "  Deepest query node scored: level " << maxQueryDepth
+        << "; deepest reference node scored: level " << maxReferenceDepth
+        << "." << std::endl;
+    for (size_t i = 0; i < levelScores.size(); ++i)
+    {
+      const double prunePercentage = (levelScores[i] == 0) ? 0.0 :
+          100.0 * levelPrunes[i] / levelScores[i];
+      stream << "  Level " << i << ": " << levelScores[i] << " scores, "
+          << levelPrunes[i] << " prunes (" << prunePercentage << "%)."
+          << std::endl;
+    }
+  }
+
+ private:
+  //! Return the level of the given node in its tree.
+  template<typename TreeType>
+  static size_t Depth(const TreeType& node)
+  {
+    size_t depth = 0;
+    for (const TreeType* n = node.Parent(); n != NULL; n = n->Parent())
+      ++depth;
+
+    return depth;
+  }
+
+  //! The number of scores at each level of the reference tree.
+  std::vector<size_t> levelScores;
+  //! The number of prunes at each level of the reference tree.
+  std::vector<size_t> levelPrunes;
+  //! The number of base cases.
+  size_t baseCases;
+  //! The number of visits to reference leaves that were not pruned.
+  size_t leafVisits;
+  //! The number of node combinations that were rescored.
+  size_t rescores;
+  //! The number of rescored node combinations that were pruned.
+  size_t rescorePrunes;
+  //! The level of the deepest query node scored.
+  size_t maxQueryDepth;
+  //! The level of the deepest reference node scored.
+  size_t maxReferenceDepth;
+};
+
+} // namespace mlpack
+
+#endif
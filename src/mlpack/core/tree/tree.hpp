@@ -27,6 +27,12 @@
 
 #include "statistic.hpp"
 #include "traversal_info.hpp"
+#include "block_base_case.hpp"
+#include "incremental_tree.hpp"
+#include "traversal_statistics.hpp"
 #include "greedy_single_tree_traverser.hpp"
+#include "best_first_single_tree_traverser.hpp"
+#include "query_frontier.hpp"
+#include "symmetric_dual_tree_traverser.hpp"
 
 #endif
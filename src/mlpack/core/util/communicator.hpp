@@ -0,0 +1,309 @@
+/**
+ * @file core/util/communicator.hpp
+ *
+ * Communicators for the distributed algorithms of mlpack (for instance,
+ * DistributedNeighborSearch and DistributedKMeans).  A communicator connects
+ * the processes (ranks) that run an algorithm together, and provides the few
+ * collective operations those algorithms need.  LocalCommunicator runs on one
+ * process; MPICommunicator is available when MPI is used.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_COMMUNICATOR_HPP
+#define MLPACK_CORE_UTIL_COMMUNICATOR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A communicator of a single process.  It can be used to run a distributed
+ * algorithm on one machine without MPI.
+ *
+ * Every communicator has the same interface: `Rank()` and `Size()`, and the
+ * collective operations below, which must be called by every rank in the same
+ * order.  The elements must be trivially copyable.
+ */
+class LocalCommunicator
+{
+ public:
+  //! Get the index of this process.
+  size_t Rank() const { return 0; }
+  //! Get the number of processes.
+  size_t Size() const { return 1; }
+
+  /**
+   * Replace the given elements, on every rank, by their sum over all ranks.
+   * The sum is computed in the same order on every rank.
+   *
+   * @param data Elements to sum.
+   * @param n Number of elements.
+   */
+  template<typename T>
+  void AllReduceSum(T* /* data */, const size_t /* n */) { }
+
+  /**
+   * Start replacing the given elements by their sum over all ranks, like
+   * AllReduceSum(); the sum is only complete after the next call to WaitAll(),
+   * and the elements must not be used until then.  This lets computations
+   * overlap with the communication.
+   *
+   * @param data Elements to sum.
+   * @param n Number of elements.
+   */
+  template<typename T>
+  void StartAllReduceSum(T* /* data */, const size_t /* n */) { }
+
+  //! Wait until every sum started with StartAllReduceSum() is complete.
+  void WaitAll() { }
+
+  /**
+   * Send the given elements to every rank; `received[r]` is set to the
+   * elements sent by rank r.  Each rank may send a different number of
+   * elements.
+   *
+   * @param send Elements to send.
+   * @param received Elements received from each rank.
+   */
+  template<typename T>
+  void AllGather(const std::vector<T>& send,
+                 std::vector<std::vector<T>>& received)
+  {
+    received.assign(1, send);
+  }
+
+  /**
+   * Send `send[r]` to rank r, for each r; `received[r]` is set to the elements
+   * that rank r sent to this rank.
+   *
+   * @param send Elements to send to each rank.
+   * @param received Elements received from each rank.
+   */
+  template<typename T>
+  void AllToAll(const std::vector<std::vector<T>>& send,
+                std::vector<std::vector<T>>& received)
+  {
+    received = send;
+  }
+};
+
+#ifdef MLPACK_HAS_MPI
+
+/**
+ * A communicator that wraps an MPI communicator.  MPI support is not enabled
+ * by default: include `<mpi.h>` and define `MLPACK_HAS_MPI` before including
+ * mlpack, and call `MPI_Init()` before creating an MPICommunicator.
+ *
+ * The elements are sent as bytes, so each message (the elements sent by one
+ * rank to another) is limited to 2^31 - 1 bytes; the distributed algorithms
+ * split their work into batches to stay below this limit.
+ */
+class MPICommunicator
+{
+ public:
+  /**
+   * Wrap the given MPI communicator.
+   *
+   * @param comm MPI communicator of the processes.
+   */
+  MPICommunicator(MPI_Comm comm = MPI_COMM_WORLD) : comm(comm)
+  {
+    int r, s;
+    Check(MPI_Comm_rank(comm, &r), "MPI_Comm_rank");
+    Check(MPI_Comm_size(comm, &s), "MPI_Comm_size");
+    rank = r;
+    size = s;
+  }
+
+  //! Get the index of this process.
+  size_t Rank() const { return rank; }
+  //! Get the number of processes.
+  size_t Size() const { return size; }
+
+  //! Replace the given elements by their sum over all ranks.
+  template<typename T>
+  void AllReduceSum(T* data, const size_t n)
+  {
+    Check(MPI_Allreduce(MPI_IN_PLACE, data, Count(n), Type<T>(), MPI_SUM,
+        comm), "MPI_Allreduce");
+  }
+
+  //! Start replacing the given elements by their sum over all ranks; the sum
+  //! is complete after the next call to WaitAll().
+  template<typename T>
+  void StartAllReduceSum(T* data, const size_t n)
+  {
+    requests.emplace_back();
+    Check(MPI_Iallreduce(MPI_IN_PLACE, data, Count(n), Type<T>(), MPI_SUM,
+        comm, &requests.back()), "MPI_Iallreduce");
+
+    // Many MPI implementations only progress nonblocking collectives during
+    // MPI calls, so the pending sums are tested each time one is started.
+    int done;
+    Check(MPI_Testall((int) requests.size(), requests.data(), &done,
+        MPI_STATUSES_IGNORE), "MPI_Testall");
+  }
+
+  //! Wait until every sum started with StartAllReduceSum() is complete.
+  void WaitAll()
+  {
+    if (!requests.empty())
+    {
+      Check(MPI_Waitall((int) requests.size(), requests.data(),
+          MPI_STATUSES_IGNORE), "MPI_Waitall");
+      requests.clear();
+    }
+  }
+
+  //! Send the given elements to every rank.
+  template<typename T>
+  void AllGather(const std::vector<T>& send,
+                 std::vector<std::vector<T>>& received)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "MPICommunicator can "
+        "only send trivially copyable elements!");
+
+    int sendBytes = Count(send.size() * sizeof(T));
+    std::vector<int> receiveBytes(size), displacements(size);
+    Check(MPI_Allgather(&sendBytes, 1, MPI_INT, receiveBytes.data(), 1,
+        MPI_INT, comm), "MPI_Allgather");
+
+    const size_t total = Displacements(receiveBytes, displacements);
+    std::vector<char> buffer(total);
+    Check(MPI_Allgatherv(send.data(), sendBytes, MPI_BYTE, buffer.data(),
+        receiveBytes.data(), displacements.data(), MPI_BYTE, comm),
+        "MPI_Allgatherv");
+
+    Split(buffer, receiveBytes, displacements, received);
+  }
+
+  //! Send `send[r]` to rank r, for each r.
+  template<typename T>
+  void AllToAll(const std::vector<std::vector<T>>& send,
+                std::vector<std::vector<T>>& received)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "MPICommunicator can "
+        "only send trivially copyable elements!");
+
+    std::vector<int> sendBytes(size), sendDisplacements(size);
+    for (size_t r = 0; r < size; ++r)
+      sendBytes[r] = Count(send[r].size() * sizeof(T));
+    const size_t sendTotal = Displacements(sendBytes, sendDisplacements);
+
+    std::vector<char> sendBuffer(sendTotal);
+    for (size_t r = 0; r < size; ++r)
+    {
+      if (sendBytes[r] > 0)
+      {
+        std::memcpy(sendBuffer.data() + sendDisplacements[r], send[r].data(),
+            sendBytes[r]);
+      }
+    }
+
+    std::vector<int> receiveBytes(size), receiveDisplacements(size);
+    Check(MPI_Alltoall(sendBytes.data(), 1, MPI_INT, receiveBytes.data(), 1,
+        MPI_INT, comm), "MPI_Alltoall");
+    const size_t receiveTotal = Displacements(receiveBytes,
+        receiveDisplacements);
+
+    std::vector<char> receiveBuffer(receiveTotal);
+    Check(MPI_Alltoallv(sendBuffer.data(), sendBytes.data(),
+        sendDisplacements.data(), MPI_BYTE, receiveBuffer.data(),
+        receiveBytes.data(), receiveDisplacements.data(), MPI_BYTE, comm),
+        "MPI_Alltoallv");
+
+    Split(receiveBuffer, receiveBytes, receiveDisplacements, received);
+  }
+
+ private:
+  //! Throw if the given MPI call failed.
+  static void Check(const int result, const char* function)
+  {
+    if (result != MPI_SUCCESS)
+    {
+      throw std::runtime_error(std::string("MPICommunicator: ") + function +
+          "() failed with error code " + std::to_string(result) + "!");
+    }
+  }
+
+  //! Convert the given count to an MPI count, or throw if it is too large.
+  static int Count(const size_t count)
+  {
+    if (count > (size_t) std::numeric_limits<int>::max())
+    {
+      throw std::invalid_argument("MPICommunicator: message of " +
+          std::to_string(count) + " elements is too large for MPI!");
+    }
+    return (int) count;
+  }
+
+  //! Compute the displacements of the given counts; return the total.
+  static size_t Displacements(const std::vector<int>& counts,
+                              std::vector<int>& displacements)
+  {
+    size_t total = 0;
+    for (size_t r = 0; r < counts.size(); ++r)
+    {
+      displacements[r] = Count(total);
+      total += counts[r];
+    }
+    Count(total);
+    return total;
+  }
+
+  //! Split the given buffer into the elements received from each rank.
+  template<typename T>
+  static void Split(const std::vector<char>& buffer,
+                    const std::vector<int>& bytes,
+                    const std::vector<int>& displacements,
+                    std::vector<std::vector<T>>& received)
+  {
+    received.resize(bytes.size());
+    for (size_t r = 0; r < bytes.size(); ++r)
+    {
+      received[r].resize(bytes[r] / sizeof(T));
+      if (bytes[r] > 0)
+      {
+        std::memcpy(received[r].data(), buffer.data() + displacements[r],
+            bytes[r]);
+      }
+    }
+  }
+
+  //! Get the MPI type of the given element type, for reductions.
+  template<typename T>
+  static MPI_Datatype Type()
+  {
+    if constexpr (std::is_same_v<T, double>)
+      return MPI_DOUBLE;
+    else if constexpr (std::is_same_v<T, float>)
+      return MPI_FLOAT;
+    else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> &&
+        sizeof(T) == 8)
+      return MPI_UINT64_T;
+    else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T> &&
+        sizeof(T) == 4)
+      return MPI_UINT32_T;
+    else
+      static_assert(sizeof(T) == 0, "MPICommunicator::AllReduceSum() only "
+          "supports float, double and unsigned integer elements!");
+  }
+
+  //! The MPI communicator.
+  MPI_Comm comm;
+  //! The index of this process.
+  size_t rank;
+  //! The number of processes.
+  size_t size;
+  //! The sums started with StartAllReduceSum() that may not be complete.
+  std::vector<MPI_Request> requests;
+};
+
+#endif
+
+} // namespace mlpack
+
+#endif
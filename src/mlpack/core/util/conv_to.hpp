@@ -57,6 +57,56 @@ class ConvTo
   }
 };
 
+/**
+ * Move the given matrix into `output`, converting its elements if `output` has
+ * a different type.  After the call, `input` is empty in both cases.  This is
+ * useful for code that accepts data of one type but holds it as another (for
+ * instance, a model that stores its data in single precision).
+ *
+ * @param input Matrix to move from.
+ * @param output Matrix to move (or convert) the input into.
+ */
+template<typename InputType, typename OutputType>
+inline void MoveOrConvert(InputType& input, OutputType& output)
+{
+  if constexpr (std::is_same_v<InputType, OutputType>)
+  {
+    output = std::move(input);
+  }
+  else
+  {
+    output = ConvTo<OutputType>::From(input);
+    input.clear();
+  }
+}
+
+/**
+ * Get the contents of the given dense matrix as an Armadillo matrix in host
+ * memory.  If `input` is already an Armadillo matrix, it is returned without a
+ * copy; otherwise (for instance, for a Bandicoot matrix in GPU memory), it is
+ * copied into `buffer`, which is returned.  This lets code that computes on
+ * any matrix type read the (small) results on the CPU.
+ *
+ * @param input Matrix to read.
+ * @param buffer Host matrix to copy `input` into, if needed.
+ */
+template<typename InputType>
+inline const arma::Mat<typename InputType::elem_type>& HostMatrix(
+    const InputType& input,
+    arma::Mat<typename InputType::elem_type>& buffer)
+{
+  if constexpr (std::is_same_v<InputType,
+      arma::Mat<typename InputType::elem_type>>)
+  {
+    return input;
+  }
+  else
+  {
+    buffer = arma::Mat<typename InputType::elem_type>(input);
+    return buffer;
+  }
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,67 @@
+/**
+ * @file core/util/first_touch.hpp
+ *
+ * Move the memory of a matrix to the NUMA nodes of the threads that will use
+ * it.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_FIRST_TOUCH_HPP
+#define MLPACK_CORE_UTIL_FIRST_TOUCH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Copy the given matrix into new memory that is written for the first time
+ * ("first touched") in parallel, with the same static schedule over columns as
+ * the parallel loops of mlpack's algorithms (`#pragma omp parallel for
+ * schedule(static)` over the points).  On NUMA machines, the operating system
+ * places each page of memory on the node of the thread that touches it first,
+ * so each thread of those loops then reads its points from local memory,
+ * instead of reading everything from the node of the thread that loaded the
+ * data.
+ *
+ * This only helps if the threads do not move between nodes; see
+ * Threads::Pin().  Matrices that do not own their memory are left unchanged.
+ * Vectors are split by elements, as they usually hold one value per point.
+ *
+ * @param matrix Matrix to move.
+ */
+template<typename MatType>
+void FirstTouch(MatType& matrix)
+{
+  using ElemType = typename MatType::elem_type;
+
+  // The memory of aliases can't be replaced.
+  if (matrix.mem_state != 0)
+    return;
+
+  // Setting the size does not touch the memory.
+  MatType touched;
+  touched.set_size(matrix.n_rows, matrix.n_cols);
+
+  const ElemType* source = matrix.memptr();
+  ElemType* destination = touched.memptr();
+  const bool isVector = (matrix.n_rows == 1 || matrix.n_cols == 1);
+  const size_t blocks = isVector ? matrix.n_elem : matrix.n_cols;
+  const size_t blockSize = isVector ? 1 : matrix.n_rows;
+
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < blocks; ++i)
+  {
+    std::copy(source + i * blockSize, source + (i + 1) * blockSize,
+        destination + i * blockSize);
+  }
+
+  // Moving the matrix keeps the new memory.
+  matrix = std::move(touched);
+}
+
+} // namespace mlpack
+
+#endif
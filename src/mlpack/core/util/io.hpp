@@ -247,9 +247,36 @@ class IO
    * Return a new Params object initialized with all the parameters of the
    * binding `bindingName`.  This is intended to be called at the beginning of
    * the run of a binding.
+   *
+   * The parameters of each binding are merged with the persistent parameters
+   * only on the first call; later calls copy the cached result, so that
+   * calling a binding many times in a process (e.g. from Python) does not
+   * rebuild its parameter maps every time.  The cache is cleared whenever a
+   * parameter, function, or documentation is added.
    */
   static util::Params Parameters(const std::string& bindingName);
 
+  /**
+   * Return a heap-allocated Params object initialized with all the parameters
+   * of the binding `bindingName`, just like Parameters(), for bindings that
+   * hold their parameters by pointer (such as the Go and Julia bindings).  The
+   * object must be given back with ReleaseParameters() instead of being
+   * deleted.  Objects that were released are reused, so that a process that
+   * calls the same binding many times does not allocate a new set of
+   * parameter maps for every call.
+   */
+  static util::Params* AcquireParameters(const std::string& bindingName);
+
+  /**
+   * Give back a Params object returned by AcquireParameters().  Its values are
+   * reset to the defaults of its binding (this frees any data it holds), and
+   * it is kept for the next call of AcquireParameters(), or deleted if enough
+   * objects are already kept for that binding.
+   *
+   * @param params Params object to give back; may be NULL.
+   */
+  static void ReleaseParameters(util::Params* params);
+
   /**
    * Retrieve the singleton.  As an end user, if you are just using the IO
    * object, you should not need to use this function---the other static
@@ -290,6 +317,26 @@ class IO
   //! Map of binding details.
   std::map<std::string, util::BindingDetails> docs;
 
+#ifndef MLPACK_NO_STD_MUTEX
+  //! Ensure only one thread can modify the prototype map at a time.
+  std::mutex prototypeMutex;
+#endif
+  //! Cached result of Parameters(), for each binding name.
+  std::map<std::string, util::Params> prototypes;
+  //! Released Params objects that can be reused by AcquireParameters(), for
+  //! each binding name.
+  std::map<std::string, std::vector<std::unique_ptr<util::Params>>> pool;
+  //! The maximum number of released Params objects kept for each binding.
+  static constexpr size_t maxPooledParameters = 16;
+
+  //! Get the cached result of Parameters() for the given binding, building it
+  //! if needed.  The prototype mutex must be held.
+  static const util::Params& Prototype(const std::string& bindingName);
+
+  //! Clear the cached results of Parameters() and the released Params
+  //! objects, after the maps they are built from have changed.
+  static void ClearPrototypes();
+
   //! Holds the timer objects.
   util::Timers timer;
 
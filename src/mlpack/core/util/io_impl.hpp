@@ -88,6 +88,7 @@ inline void IO::AddParameter(const std::string& bindingName,
     bindingAliases[data.alias] = data.name;
 
   bindingParams[data.name] = std::move(data);
+  ClearPrototypes();
 }
 
 /**
@@ -105,6 +106,7 @@ inline void IO::AddFunction(const std::string& type,
   std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
 #endif
   GetSingleton().functionMap[type][name] = func;
+  ClearPrototypes();
 }
 
 /**
@@ -120,6 +122,7 @@ inline void IO::AddBindingName(const std::string& bindingName,
   std::lock_guard<std::mutex> lock(GetSingleton().mapMutex);
 #endif
   GetSingleton().docs[bindingName].name = name;
+  ClearPrototypes();
 }
 
 /**
@@ -135,6 +138,7 @@ inline void IO::AddShortDescription(const std::string& bindingName,
   std::lock_guard<std::mutex> lock(GetSingleton().docMutex);
 #endif
   GetSingleton().docs[bindingName].shortDescription = shortDescription;
+  ClearPrototypes();
 }
 
 /**
@@ -151,6 +155,7 @@ inline void IO::AddLongDescription(
   std::lock_guard<std::mutex> lock(GetSingleton().docMutex);
 #endif
   GetSingleton().docs[bindingName].longDescription = longDescription;
+  ClearPrototypes();
 }
 
 /**
@@ -166,6 +171,7 @@ inline void IO::AddExample(const std::string& bindingName,
   std::lock_guard<std::mutex> lock(GetSingleton().docMutex);
 #endif
   GetSingleton().docs[bindingName].example.push_back(std::move(example));
+  ClearPrototypes();
 }
 
 /**
@@ -184,6 +190,7 @@ inline void IO::AddSeeAlso(const std::string& bindingName,
 #endif
   GetSingleton().docs[bindingName].seeAlso.push_back(
       std::make_pair(description, link));
+  ClearPrototypes();
 }
 
 // Returns the sole instance of this class.
@@ -206,23 +213,87 @@ inline util::Timers& IO::GetTimers()
  */
 inline util::Params IO::Parameters(const std::string& bindingName)
 {
-  // We don't need a mutex here, because we are only randomly accessing elements
-  // of the maps.
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(GetSingleton().prototypeMutex);
+#endif
+  return Prototype(bindingName);
+}
+
+// Return a Params object for the binding, reusing a released one if possible.
+inline util::Params* IO::AcquireParameters(const std::string& bindingName)
+{
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(GetSingleton().prototypeMutex);
+#endif
+  std::vector<std::unique_ptr<util::Params>>& released =
+      GetSingleton().pool[bindingName];
+  if (released.empty())
+    return new util::Params(Prototype(bindingName));
+
+  // Released objects were already reset to the defaults.
+  util::Params* params = released.back().release();
+  released.pop_back();
+  return params;
+}
+
+// Reset the given Params object and keep it for AcquireParameters().
+inline void IO::ReleaseParameters(util::Params* params)
+{
+  // If the object is not kept, it is deleted after the lock is released.
+  std::unique_ptr<util::Params> p(params);
+  if (!p)
+    return;
+
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(GetSingleton().prototypeMutex);
+#endif
+  const std::string bindingName = p->BindingName();
+  std::vector<std::unique_ptr<util::Params>>& released =
+      GetSingleton().pool[bindingName];
+  if (released.size() >= maxPooledParameters)
+    return;
+
+  // Assigning the prototype reuses the nodes of the maps of the object.
+  *p = Prototype(bindingName);
+  released.push_back(std::move(p));
+}
+
+// Get the cached Params object of a binding.
+inline const util::Params& IO::Prototype(const std::string& bindingName)
+{
+  std::map<std::string, util::Params>& prototypes = GetSingleton().prototypes;
+  std::map<std::string, util::Params>::const_iterator it =
+      prototypes.find(bindingName);
+  if (it != prototypes.end())
+    return it->second;
+
   std::map<char, std::string> resultAliases =
       GetSingleton().aliases[bindingName];
   // Merge in any persistent parameters (e.g. parameters in the "" binding map).
-  std::map<char, std::string> persistentAliases = GetSingleton().aliases[""];
+  const std::map<char, std::string>& persistentAliases =
+      GetSingleton().aliases[""];
   resultAliases.insert(persistentAliases.begin(), persistentAliases.end());
 
   std::map<std::string, util::ParamData> resultParams =
       GetSingleton().parameters[bindingName];
   // Merge in any persistent parameters (e.g. parameters in the "" binding map).
-  std::map<std::string, util::ParamData> persistentParams =
+  const std::map<std::string, util::ParamData>& persistentParams =
       GetSingleton().parameters[""];
   resultParams.insert(persistentParams.begin(), persistentParams.end());
 
-  return util::Params(resultAliases, resultParams, GetSingleton().functionMap,
-      bindingName, GetSingleton().docs[bindingName]);
+  return prototypes.emplace(bindingName, util::Params(resultAliases,
+      resultParams, GetSingleton().functionMap, bindingName,
+      GetSingleton().docs[bindingName])).first->second;
+}
+
+// Clear the cached results of Parameters().
+inline void IO::ClearPrototypes()
+{
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(GetSingleton().prototypeMutex);
+#endif
+  GetSingleton().prototypes.clear();
+  GetSingleton().pool.clear();
 }
 
 } // namespace mlpack
@@ -0,0 +1,360 @@
+/**
+ * @file core/util/memory_tracker.hpp
+ *
+ * Accounting of the memory used by mlpack: the bytes held by tree node pools,
+ * by large buffers, and (optionally) by Armadillo matrices, and the resident
+ * set size of the process, per phase of a program.
+ *
+ * This file only uses the standard library, since it is included before
+ * Armadillo (see MLPACK_TRACK_ARMA_MEMORY).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_MEMORY_TRACKER_HPP
+#define MLPACK_CORE_UTIL_MEMORY_TRACKER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <fstream>
+#ifndef MLPACK_NO_STD_MUTEX
+#include <mutex>
+#endif
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__APPLE__)
+  #include <sys/resource.h>
+#endif
+
+namespace mlpack {
+namespace util {
+
+/**
+ * The memory used during one or more runs of a phase of a program (for
+ * instance, a timer of Timers).  All sizes are in bytes.
+ */
+struct PhaseMemory
+{
+  //! The largest number of tracked bytes held at once during the phase
+  //! (including those allocated before the phase started).
+  size_t peakTrackedBytes = 0;
+  //! The number of tracked bytes allocated during the phase.
+  size_t allocatedBytes = 0;
+  //! The number of tracked allocations during the phase.
+  size_t allocations = 0;
+  //! The largest resident set size of the process during the phase, or 0 if
+  //! it is not known on this system.
+  size_t peakRSS = 0;
+
+  //! Add another run of the same phase: the peaks are the largest of both,
+  //! and the allocations are summed.
+  void Merge(const PhaseMemory& other)
+  {
+    peakTrackedBytes = std::max(peakTrackedBytes, other.peakTrackedBytes);
+    allocatedBytes += other.allocatedBytes;
+    allocations += other.allocations;
+    peakRSS = std::max(peakRSS, other.peakRSS);
+  }
+};
+
+/**
+ * MemoryTracker counts the bytes of the allocations that are reported to it
+ * with Allocate() and Free(): the memory blocks of the tree node pools, large
+ * buffers like the results of range searches (see TrackedBytes), and, if
+ * MLPACK_TRACK_ARMA_MEMORY is defined before mlpack (and Armadillo) is
+ * included, the memory of every Armadillo matrix that is not small enough to
+ * be stored inside the matrix object.  Counting takes a few atomic operations
+ * per allocation.
+ *
+ * Phases measure the memory used between BeginPhase() and EndPhase(); phases
+ * may overlap in any order.  Timers measures a phase for each timer when
+ * `MemoryTracking()` is enabled.  Each call to BeginPhase() or EndPhase() also
+ * reads the resident set size of the process (from /proc on Linux), so phases
+ * should not be much shorter than a millisecond.  On Linux, the peak resident
+ * set size is reset at each call (by writing to /proc/self/clear_refs), so
+ * that the peak of each phase can be measured; if this is not allowed, the
+ * peak of a phase is the peak of the process until the end of the phase.
+ */
+class MemoryTracker
+{
+ public:
+  //! Record an allocation of the given number of bytes.
+  static void Allocate(const size_t bytes)
+  {
+    State& s = GetState();
+    const size_t current = s.current.fetch_add(bytes,
+        std::memory_order_relaxed) + bytes;
+    s.allocated.fetch_add(bytes, std::memory_order_relaxed);
+    s.allocations.fetch_add(1, std::memory_order_relaxed);
+    UpdateMax(s.peak, current);
+    UpdateMax(s.totalPeak, current);
+  }
+
+  //! Record that the given number of bytes were freed.
+  static void Free(const size_t bytes)
+  {
+    GetState().current.fetch_sub(bytes, std::memory_order_relaxed);
+  }
+
+  //! Get the number of tracked bytes that are currently allocated.
+  static size_t CurrentBytes() { return GetState().current; }
+
+  //! Get the largest number of tracked bytes that were allocated at once.
+  static size_t PeakBytes() { return GetState().totalPeak; }
+
+  //! Get the current resident set size of the process, or 0 if it is not
+  //! known on this system.
+  static size_t CurrentRSS() { return ReadRSS("VmRSS:"); }
+
+  //! Get the largest resident set size of the process so far (or since it
+  //! was last reset by a phase, on Linux), or 0 if it is not known on this
+  //! system.
+  static size_t PeakRSS()
+  {
+    #if defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+      return (size_t) usage.ru_maxrss; // Bytes on macOS.
+    return 0;
+    #else
+    return ReadRSS("VmHWM:");
+    #endif
+  }
+
+  /**
+   * Start a phase, and return its id, to be passed to EndPhase().
+   */
+  static size_t BeginPhase()
+  {
+    State& s = GetState();
+    #ifndef MLPACK_NO_STD_MUTEX
+    std::lock_guard<std::mutex> lock(s.mutex);
+    #endif
+    UpdatePhases(s);
+
+    Phase phase;
+    phase.id = s.nextId++;
+    phase.startAllocated = s.allocated;
+    phase.startAllocations = s.allocations;
+    phase.memory.peakTrackedBytes = s.current;
+    phase.memory.peakRSS = CurrentRSS();
+    s.phases.push_back(phase);
+    return phase.id;
+  }
+
+  /**
+   * End the phase with the given id, and return the memory used during it.
+   */
+  static PhaseMemory EndPhase(const size_t id)
+  {
+    State& s = GetState();
+    #ifndef MLPACK_NO_STD_MUTEX
+    std::lock_guard<std::mutex> lock(s.mutex);
+    #endif
+    UpdatePhases(s);
+
+    PhaseMemory memory;
+    for (size_t i = 0; i < s.phases.size(); ++i)
+    {
+      if (s.phases[i].id != id)
+        continue;
+
+      memory = s.phases[i].memory;
+      memory.allocatedBytes = s.allocated - s.phases[i].startAllocated;
+      memory.allocations = s.allocations - s.phases[i].startAllocations;
+      s.phases.erase(s.phases.begin() + i);
+      break;
+    }
+
+    return memory;
+  }
+
+  /**
+   * Allocate memory for Armadillo, and record the allocation.  This is used
+   * as ARMA_ALIEN_MEM_ALLOC_FUNCTION when MLPACK_TRACK_ARMA_MEMORY is
+   * defined.  The size of the allocation is stored before the memory, which
+   * is aligned to HeaderSize bytes.
+   */
+  static void* ArmaAllocate(const size_t bytes)
+  {
+    void* memory = ::operator new(bytes + HeaderSize,
+        std::align_val_t(HeaderSize), std::nothrow);
+    if (memory == nullptr)
+      return nullptr;
+
+    *static_cast<size_t*>(memory) = bytes;
+    Allocate(bytes);
+    return static_cast<char*>(memory) + HeaderSize;
+  }
+
+  /**
+   * Free memory allocated by ArmaAllocate(), and record it.  This is used as
+   * ARMA_ALIEN_MEM_FREE_FUNCTION when MLPACK_TRACK_ARMA_MEMORY is defined.
+   */
+  static void ArmaFree(void* memory)
+  {
+    if (memory == nullptr)
+      return;
+
+    char* start = static_cast<char*>(memory) - HeaderSize;
+    Free(*reinterpret_cast<size_t*>(start));
+    ::operator delete(start, std::align_val_t(HeaderSize));
+  }
+
+  //! The size of the header of the allocations of ArmaAllocate(), which is
+  //! also their alignment.
+  static constexpr size_t HeaderSize = 64;
+
+ private:
+  //! A phase that has not ended yet.
+  struct Phase
+  {
+    size_t id;
+    size_t startAllocated;
+    size_t startAllocations;
+    PhaseMemory memory;
+  };
+
+  //! The state of the tracker.
+  struct State
+  {
+    std::atomic<size_t> current{0};
+    //! The peak since the last call to UpdatePhases().
+    std::atomic<size_t> peak{0};
+    std::atomic<size_t> totalPeak{0};
+    std::atomic<size_t> allocated{0};
+    std::atomic<size_t> allocations{0};
+
+    #ifndef MLPACK_NO_STD_MUTEX
+    std::mutex mutex;
+    #endif
+    std::vector<Phase> phases;
+    size_t nextId = 0;
+    //! Whether the peak resident set size can be reset.
+    bool resetRSS = true;
+  };
+
+  //! Get the state.  It is never destroyed, since Armadillo matrices may be
+  //! freed during the destruction of static objects.
+  static State& GetState()
+  {
+    static State* state = new State();
+    return *state;
+  }
+
+  //! Set `value` to `candidate` if it is larger.
+  static void UpdateMax(std::atomic<size_t>& value, const size_t candidate)
+  {
+    size_t old = value.load(std::memory_order_relaxed);
+    while (old < candidate && !value.compare_exchange_weak(old, candidate,
+        std::memory_order_relaxed)) { }
+  }
+
+  /**
+   * Add the peaks since the last call to every phase that has not ended, and
+   * reset them.  Since this is done whenever a phase starts or ends, the peak
+   * of each phase is the largest of the peaks of the intervals it spans.  The
+   * mutex must be held.
+   */
+  static void UpdatePhases(State& s)
+  {
+    const size_t peak = s.peak.exchange(s.current);
+    const size_t peakRSS = PeakRSS();
+    for (Phase& phase : s.phases)
+    {
+      phase.memory.peakTrackedBytes = std::max(phase.memory.peakTrackedBytes,
+          peak);
+      phase.memory.peakRSS = std::max(phase.memory.peakRSS, peakRSS);
+    }
+
+    #if defined(__linux__)
+    // Writing 5 to clear_refs resets the peak resident set size of the
+    // process to its current resident set size.
+    if (s.resetRSS)
+    {
+      std::ofstream clearRefs("/proc/self/clear_refs");
+      clearRefs << "5" << std::flush;
+      s.resetRSS = clearRefs.good();
+    }
+    #endif
+  }
+
+  //! Read the given field of /proc/self/status, in bytes, or return 0.
+  static size_t ReadRSS(const std::string& field)
+  {
+    #if defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string name;
+    while (status >> name)
+    {
+      if (name == field)
+      {
+        size_t kilobytes = 0;
+        status >> kilobytes;
+        return 1024 * kilobytes;
+      }
+      status.ignore(4096, '\n');
+    }
+    #else
+    (void) field;
+    #endif
+    return 0;
+  }
+};
+
+/**
+ * TrackedBytes records a buffer of the given size with MemoryTracker for as
+ * long as it exists, for buffers whose memory is not tracked otherwise (like
+ * the neighbor lists of a range search).
+ *
+ * @code
+ * rangeSearch.Search(range, neighbors, distances);
+ * util::TrackedBytes tracked(util::NestedVectorBytes(neighbors) +
+ *     util::NestedVectorBytes(distances));
+ * @endcode
+ */
+class TrackedBytes
+{
+ public:
+  //! Record a buffer of the given size.
+  TrackedBytes(const size_t bytes = 0) : bytes(0) { Reset(bytes); }
+
+  //! Record that the buffer was freed.
+  ~TrackedBytes() { MemoryTracker::Free(bytes); }
+
+  TrackedBytes(const TrackedBytes&) = delete;
+  TrackedBytes& operator=(const TrackedBytes&) = delete;
+
+  //! Change the size of the buffer that is recorded.
+  void Reset(const size_t newBytes)
+  {
+    MemoryTracker::Free(bytes);
+    bytes = newBytes;
+    if (bytes > 0)
+      MemoryTracker::Allocate(bytes);
+  }
+
+ private:
+  //! The size of the buffer.
+  size_t bytes;
+};
+
+//! Return the number of bytes held by the given vector of vectors.
+template<typename T>
+size_t NestedVectorBytes(const std::vector<std::vector<T>>& v)
+{
+  size_t bytes = v.capacity() * sizeof(std::vector<T>);
+  for (const std::vector<T>& inner : v)
+    bytes += inner.capacity() * sizeof(T);
+  return bytes;
+}
+
+} // namespace util
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,156 @@
+/**
+ * @file core/util/threads.hpp
+ *
+ * Control of the number of threads that mlpack uses, both in its own OpenMP
+ * regions and in the BLAS library called by Armadillo.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_HPP
+#define MLPACK_CORE_UTIL_THREADS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
+#ifdef __linux__
+  #include <sched.h>
+#endif
+
+namespace mlpack {
+
+/**
+ * The Threads class holds the number of threads that mlpack may use.  Each
+ * OpenMP region in mlpack uses up to that many threads, and so does the BLAS
+ * library that Armadillo calls for matrix products, if it is OpenBLAS or MKL
+ * (other BLAS libraries can't be controlled, and use their own settings).
+ *
+ * When an OpenMP region calls BLAS in each of its threads (for instance, a
+ * random forest whose trees each multiply matrices), running both in parallel
+ * starts far more threads than there are cores.  The regions of mlpack that do
+ * this hold a ThreadBudget, which makes BLAS single-threaded while the region
+ * runs; and code that may run inside a parallel region can check
+ * Threads::InParallel() to avoid starting another level of threads.
+ *
+ * @code
+ * // Use at most 4 threads in mlpack and BLAS.
+ * Threads::Set(4);
+ * @endcode
+ *
+ * The command-line bindings set the number of threads with `--threads`.
+ */
+class Threads
+{
+ public:
+  /**
+   * Set the number of threads that mlpack (and BLAS, if it can be controlled)
+   * may use.  0 restores the defaults, which are the numbers of threads of
+   * OpenMP and BLAS before the first call to Set().
+   */
+  static void Set(const size_t numThreads);
+
+  //! Get the number of threads that mlpack may use.
+  static size_t Get();
+
+  //! Return whether the caller runs inside an active OpenMP parallel region.
+  static bool InParallel();
+
+  /**
+   * Get the number of threads available to a parallel region started by the
+   * caller: 1 inside a parallel region (so that regions are not nested), and
+   * Get() outside of one.
+   */
+  static size_t Available();
+
+  /**
+   * Set the number of threads of the BLAS library.  Returns false (and does
+   * nothing) if the BLAS library can't be controlled.
+   */
+  static bool SetBLASThreads(const size_t numThreads);
+
+  //! Get the number of threads of the BLAS library (0 if unknown).
+  static size_t BLASThreads();
+
+  /**
+   * Pin each thread of the OpenMP regions of Get() threads to one CPU, so that
+   * the threads don't move between NUMA nodes, away from the memory they
+   * touched first (see FirstTouch()).  Thread t is pinned to the t-th CPU that
+   * the process could use before the first call to Pin(); this includes the
+   * calling thread, which is thread 0.  If the OpenMP runtime binds threads
+   * already (OMP_PROC_BIND is set), nothing is changed.  Returns false if the
+   * threads can't be pinned (only Linux is supported).
+   */
+  static bool Pin();
+
+ private:
+  //! Get the number of threads set with Set() (0 if it was never called).
+  static size_t& Budget();
+
+  //! Get the number of threads of OpenMP before the first call to Set().
+  static size_t DefaultThreads();
+
+  //! Get the number of threads of BLAS before the first call to Set().
+  static size_t DefaultBLASThreads();
+
+  //! Get the CPUs that the process could use before the first call to Pin().
+  static const std::vector<size_t>& AllowedCPUs();
+};
+
+/**
+ * A ThreadBudget gives a number of threads to the OpenMP regions started by
+ * this thread while it exists, and makes BLAS single-threaded if those regions
+ * are parallel, so that each of their threads can call BLAS without starting
+ * threads of its own.  Everything is restored when the ThreadBudget is
+ * destroyed.  Inside a parallel region, the budget is always one thread.
+ *
+ * @code
+ * ThreadBudget budget;
+ * #pragma omp parallel for
+ * for (size_t i = 0; i < numTrees; ++i)
+ *   trees[i].Train(...); // Uses BLAS in each thread.
+ * @endcode
+ */
+class ThreadBudget
+{
+ public:
+  /**
+   * Limit the OpenMP regions started by this thread to the given number of
+   * threads (0 means Threads::Available()).  The budget is never more than
+   * Threads::Available().
+   *
+   * @param numThreads Maximum number of threads of the OpenMP regions.
+   * @param serialBLAS Whether to make BLAS single-threaded if the budget is
+   *     more than one thread.
+   */
+  ThreadBudget(const size_t numThreads = 0, const bool serialBLAS = true);
+
+  //! Restore the previous number of threads of OpenMP and BLAS.
+  ~ThreadBudget();
+
+  // A ThreadBudget can't be copied; it belongs to a scope.
+  ThreadBudget(const ThreadBudget&) = delete;
+  ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+  //! Get the number of threads given to the OpenMP regions.
+  size_t NumThreads() const { return numThreads; }
+
+ private:
+  //! The number of threads given to the OpenMP regions.
+  size_t numThreads;
+  //! The number of OpenMP threads before the budget.
+  size_t oldThreads;
+  //! The number of BLAS threads before the budget (0 if not changed).
+  size_t oldBLASThreads;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "threads_impl.hpp"
+
+#endif
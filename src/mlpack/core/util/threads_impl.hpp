@@ -0,0 +1,222 @@
+/**
+ * @file core/util/threads_impl.hpp
+ *
+ * Implementation of the Threads and ThreadBudget classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_UTIL_THREADS_IMPL_HPP
+#define MLPACK_CORE_UTIL_THREADS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "threads.hpp"
+
+// The number of threads of OpenBLAS and MKL is set through their own
+// functions.  They are declared weak, so that they are null if neither library
+// is linked; this needs an ELF platform.  Define
+// MLPACK_NO_BLAS_THREAD_CONTROL to never touch the BLAS threads.
+#if defined(__ELF__) && defined(__GNUC__) && \
+    !defined(MLPACK_NO_BLAS_THREAD_CONTROL)
+  #define MLPACK_HAS_BLAS_THREAD_CONTROL
+
+extern "C"
+{
+  void openblas_set_num_threads(int) __attribute__((weak));
+  int openblas_get_num_threads(void) __attribute__((weak));
+  void MKL_Set_Num_Threads(int) __attribute__((weak));
+  int MKL_Get_Max_Threads(void) __attribute__((weak));
+}
+#endif
+
+namespace mlpack {
+
+inline void Threads::Set(const size_t numThreads)
+{
+  // Record the defaults before they are changed for the first time.
+  const size_t defaultThreads = DefaultThreads();
+  const size_t defaultBLASThreads = DefaultBLASThreads();
+
+  Budget() = numThreads;
+  #ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads((int) ((numThreads == 0) ? defaultThreads :
+        numThreads));
+  #else
+    (void) defaultThreads;
+  #endif
+
+  if (numThreads > 0)
+    SetBLASThreads(numThreads);
+  else if (defaultBLASThreads > 0)
+    SetBLASThreads(defaultBLASThreads);
+}
+
+inline size_t Threads::Get()
+{
+  if (Budget() > 0)
+    return Budget();
+
+  #ifdef MLPACK_USE_OPENMP
+    return (size_t) omp_get_max_threads();
+  #else
+    return 1;
+  #endif
+}
+
+inline bool Threads::InParallel()
+{
+  #ifdef MLPACK_USE_OPENMP
+    return omp_in_parallel();
+  #else
+    return false;
+  #endif
+}
+
+inline size_t Threads::Available()
+{
+  return InParallel() ? 1 : Get();
+}
+
+inline bool Threads::SetBLASThreads(const size_t numThreads)
+{
+  #ifdef MLPACK_HAS_BLAS_THREAD_CONTROL
+    if (openblas_set_num_threads)
+    {
+      openblas_set_num_threads((int) numThreads);
+      return true;
+    }
+    else if (MKL_Set_Num_Threads)
+    {
+      MKL_Set_Num_Threads((int) numThreads);
+      return true;
+    }
+  #endif
+
+  (void) numThreads;
+  return false;
+}
+
+inline size_t Threads::BLASThreads()
+{
+  #ifdef MLPACK_HAS_BLAS_THREAD_CONTROL
+    if (openblas_get_num_threads)
+      return (size_t) openblas_get_num_threads();
+    else if (MKL_Get_Max_Threads)
+      return (size_t) MKL_Get_Max_Threads();
+  #endif
+
+  return 0;
+}
+
+inline bool Threads::Pin()
+{
+  #if defined(MLPACK_USE_OPENMP) && defined(__linux__)
+    // The OpenMP runtime binds the threads itself.
+    if (omp_get_proc_bind() != omp_proc_bind_false)
+      return true;
+
+    const std::vector<size_t>& cpus = AllowedCPUs();
+    if (cpus.empty())
+      return false;
+
+    size_t failures = 0;
+    #pragma omp parallel num_threads((int) Get()) reduction(+:failures)
+    {
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(cpus[omp_get_thread_num() % cpus.size()], &cpuSet);
+      if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) != 0)
+        ++failures;
+    }
+
+    return (failures == 0);
+  #else
+    return false;
+  #endif
+}
+
+inline size_t& Threads::Budget()
+{
+  static size_t budget = 0;
+  return budget;
+}
+
+inline size_t Threads::DefaultThreads()
+{
+  #ifdef MLPACK_USE_OPENMP
+    static const size_t defaultThreads = (size_t) omp_get_max_threads();
+    return defaultThreads;
+  #else
+    return 1;
+  #endif
+}
+
+inline size_t Threads::DefaultBLASThreads()
+{
+  static const size_t defaultBLASThreads = BLASThreads();
+  return defaultBLASThreads;
+}
+
+inline const std::vector<size_t>& Threads::AllowedCPUs()
+{
+  // Once the calling thread is pinned, its affinity is a single CPU, so the
+  // CPUs are recorded by the first call.
+  static const std::vector<size_t> allowedCPUs = []()
+  {
+    std::vector<size_t> cpus;
+    #ifdef __linux__
+      cpu_set_t cpuSet;
+      CPU_ZERO(&cpuSet);
+      if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0)
+      {
+        for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+          if (CPU_ISSET(cpu, &cpuSet))
+            cpus.push_back(cpu);
+      }
+    #endif
+    return cpus;
+  }();
+
+  return allowedCPUs;
+}
+
+inline ThreadBudget::ThreadBudget(const size_t requested,
+                                  const bool serialBLAS) :
+    numThreads(Threads::Available()),
+    oldThreads(1),
+    oldBLASThreads(0)
+{
+  if (requested > 0)
+    numThreads = std::min(numThreads, requested);
+
+  #ifdef MLPACK_USE_OPENMP
+    oldThreads = (size_t) omp_get_max_threads();
+    omp_set_num_threads((int) numThreads);
+  #endif
+
+  // The BLAS settings are shared by all threads, so they are only changed by
+  // a budget of several threads, which can only exist outside of parallel
+  // regions.
+  if (serialBLAS && numThreads > 1)
+  {
+    const size_t blasThreads = Threads::BLASThreads();
+    if (blasThreads > 1 && Threads::SetBLASThreads(1))
+      oldBLASThreads = blasThreads;
+  }
+}
+
+inline ThreadBudget::~ThreadBudget()
+{
+  #ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads((int) oldThreads);
+  #endif
+
+  if (oldBLASThreads > 0)
+    Threads::SetBLASThreads(oldBLASThreads);
+}
+
+} // namespace mlpack
+
+#endif
@@ -24,6 +24,9 @@
 #endif
 #include <string>
 #include <thread> // std::thread is used for thread safety.
+#include <vector>
+
+#include "memory_tracker.hpp"
 
 #if defined(_WIN32)
   // uint64_t isn't defined on every windows.
@@ -100,6 +103,24 @@ class Timer
    * Returns a copy of all the timers used via this interface.
    */
   static std::map<std::string, std::chrono::microseconds> GetAllTimers();
+
+  /**
+   * Enable the tracking of the memory used while each timer runs (see
+   * util::Timers::MemoryTracking()).  Do not run this while timers are
+   * running!
+   */
+  static void EnableMemoryTracking();
+
+  /**
+   * Disable the tracking of the memory used while each timer runs.  Do not run
+   * this while timers are running!
+   */
+  static void DisableMemoryTracking();
+
+  /**
+   * Returns a copy of the memory used while each timer of this interface ran.
+   */
+  static std::map<std::string, util::PhaseMemory> GetAllMemory();
 };
 
 namespace util {
@@ -107,8 +128,16 @@ namespace util {
 class Timers
 {
  public:
+  //! Convenience typedef for the clock used by the timers.
+  using ClockType = std::chrono::high_resolution_clock;
+
   //! Default to disabled.
-  Timers() : enabled(false) { }
+  Timers() :
+      enabled(false),
+      tracing(false),
+      memoryTracking(false),
+      traceStart(ClockType::now())
+  { }
 
   /**
    * Returns a copy of all the timers used via this interface.
@@ -137,6 +166,37 @@ class Timers
    */
   static std::string Print(const std::chrono::microseconds& totalDuration);
 
+  /**
+   * Returns a copy of the memory used while each timer ran, for the timers
+   * that ran while memory tracking was enabled.
+   */
+  std::map<std::string, PhaseMemory> GetAllMemory();
+
+  /**
+   * Returns the memory used while the given timer ran (over all of its runs
+   * while memory tracking was enabled).
+   *
+   * @param timerName The name of the timer in question.
+   */
+  PhaseMemory GetMemory(const std::string& timerName);
+
+  /**
+   * Add the memory used during a run of the given timer that was measured
+   * elsewhere.  This is what ScopedTimer uses.
+   *
+   * @param timerName The name of the timer in question.
+   * @param phaseMemory Memory used during the run.
+   */
+  void AddMemory(const std::string& timerName, const PhaseMemory& phaseMemory);
+
+  /**
+   * Prints the given number of bytes, in the largest unit (B, KiB, MiB, GiB or
+   * TiB) it is at least one of.
+   *
+   * @param bytes The number of bytes to print.
+   */
+  static std::string PrintBytes(const size_t bytes);
+
   /**
    * Initializes a timer, available like a normal value specified on
    * the command line.  Timers are of type timeval.  If a timer is started, then
@@ -158,17 +218,79 @@ class Timers
   void Stop(const std::string& timerName,
             const std::thread::id& threadId = std::thread::id());
 
+  /**
+   * Add the time between `start` and `end` to the given timer, as if it had
+   * been started at `start` and stopped at `end`.  This is what ScopedTimer
+   * uses; the timer does not need to be started, and only one lock is taken.
+   *
+   * @param timerName The name of the timer in question.
+   * @param start Time the timed section started.
+   * @param end Time the timed section ended.
+   * @param threadId Id of the thread that ran the timed section.
+   */
+  void Add(const std::string& timerName,
+           const ClockType::time_point& start,
+           const ClockType::time_point& end,
+           const std::thread::id& threadId = std::thread::id());
+
   /**
    * Stop all timers.
    */
   void StopAllTimers();
 
+  /**
+   * Write every timed section recorded while tracing was enabled to the given
+   * stream, in the JSON trace event format that can be opened with
+   * chrome://tracing or Perfetto.  Each section is a complete ("X") event,
+   * and sections of each thread get their own track.
+   *
+   * @param stream Stream to write the trace to.
+   */
+  void PrintTrace(std::ostream& stream);
+
   //! Modify whether or not timing is enabled.
   std::atomic<bool>& Enabled() { return enabled; }
   //! Get whether or not timing is enabled.
   bool Enabled() const { return enabled; }
 
+  //! Modify whether or not each timed section is recorded for PrintTrace().
+  //! This has no effect if timing is not enabled.
+  std::atomic<bool>& Tracing() { return tracing; }
+  //! Get whether or not each timed section is recorded for PrintTrace().
+  bool Tracing() const { return tracing; }
+
+  //! Modify whether or not the memory used while each timer runs is measured
+  //! (see MemoryTracker).  This has no effect if timing is not enabled.
+  std::atomic<bool>& MemoryTracking() { return memoryTracking; }
+  //! Get whether or not the memory used while each timer runs is measured.
+  bool MemoryTracking() const { return memoryTracking; }
+
  private:
+  //! A timed section, recorded while tracing is enabled.
+  struct TraceEvent
+  {
+    //! Name of the timer.
+    std::string name;
+    //! Id of the thread that ran the section.
+    std::thread::id threadId;
+    //! Start of the section, relative to traceStart.
+    std::chrono::microseconds start;
+    //! Length of the section.
+    std::chrono::microseconds duration;
+  };
+
+  //! Add the given section to the given timer, and record it if tracing is
+  //! enabled.  The mutex must be held.
+  void AddSection(const std::string& timerName,
+                  const ClockType::time_point& start,
+                  const ClockType::time_point& end,
+                  const std::thread::id& threadId);
+
+  //! End the memory phase of the given running timer, if it has one, and add
+  //! it to the memory of the timer.  The mutex must be held.
+  void EndMemoryPhase(const std::string& timerName,
+                      const std::thread::id& threadId);
+
   //! A map of all the timers that are being tracked.
   std::map<std::string, std::chrono::microseconds> timers;
 #ifndef MLPACK_NO_STD_MUTEX
@@ -181,6 +303,102 @@ class Timers
 
   //! Whether or not timing is enabled.
   std::atomic<bool> enabled;
+  //! Whether or not each timed section is recorded.
+  std::atomic<bool> tracing;
+  //! Whether or not the memory used while each timer runs is measured.
+  std::atomic<bool> memoryTracking;
+  //! The MemoryTracker phases of the running timers.
+  std::map<std::thread::id, std::map<std::string, size_t>> memoryPhases;
+  //! The memory used while each timer ran.
+  std::map<std::string, PhaseMemory> memory;
+  //! The time that the start of recorded sections is relative to.
+  ClockType::time_point traceStart;
+  //! The recorded sections.
+  std::vector<TraceEvent> traceEvents;
+};
+
+/**
+ * ScopedTimer times the scope it is declared in: the section between its
+ * construction and its destruction is added to a timer of the given Timers
+ * object (or of the global timers used by the Timer class).  If timing is
+ * disabled when it is constructed, it does nothing at all.
+ *
+ * Scoped timers can be nested; the name of a nested timer is prefixed by the
+ * names of the scoped timers that are running around it on the same thread,
+ * separated by slashes.  The section is added with a single call of
+ * Timers::Add(), so there is no start/stop bookkeeping.
+ *
+ * @code
+ * void Train(util::Timers& timers)
+ * {
+ *   util::ScopedTimer t(timers, "training");
+ *   for (size_t i = 0; i < maxIterations; ++i)
+ *   {
+ *     // Timed as "training/step".
+ *     util::ScopedTimer s(timers, "step");
+ *     Step();
+ *   }
+ * }
+ * @endcode
+ *
+ * Threads started inside a timed scope (e.g. by OpenMP) start with no running
+ * scoped timers, so their timers are not prefixed.
+ *
+ * If memory tracking is enabled for the Timers object, the memory used during
+ * the section is also added to the timer (see Timers::GetAllMemory()).
+ */
+class ScopedTimer
+{
+ public:
+  /**
+   * Start timing the section for the given timer of the given Timers object.
+   *
+   * @param timers Timers object to add the section to.
+   * @param timerName Name of the timer, without the names of enclosing scoped
+   *     timers.
+   */
+  ScopedTimer(Timers& timers, const std::string& timerName);
+
+  /**
+   * Start timing the section for the given timer of the global timers (those
+   * of Timer::Start() and Timer::Stop()).
+   *
+   * @param timerName Name of the timer, without the names of enclosing scoped
+   *     timers.
+   */
+  explicit ScopedTimer(const std::string& timerName);
+
+  //! Stop timing the section and add it to the timer.
+  ~ScopedTimer();
+
+  //! A scoped timer cannot be copied.
+  ScopedTimer(const ScopedTimer&) = delete;
+  //! A scoped timer cannot be copied.
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  //! Get the full name of the timer, or an empty string if timing was
+  //! disabled.
+  const std::string& Name() const { return name; }
+
+ private:
+  //! Start timing, if timing is enabled.
+  void Begin(const std::string& timerName);
+
+  //! Get the names of the scoped timers running on this thread.
+  static std::string& Path();
+
+  //! The Timers object to add the section to, or NULL if timing is disabled.
+  Timers* timers;
+  //! The full name of the timer.
+  std::string name;
+  //! The length of the path of the enclosing scoped timers.
+  size_t parentLength;
+  //! The time the section started.
+  Timers::ClockType::time_point start;
+  //! Whether the memory used during the section is measured.
+  bool trackMemory;
+  //! The MemoryTracker phase of the section, if memory is measured.
+  size_t memoryPhase;
 };
 
 } // namespace util
@@ -69,6 +69,23 @@ inline std::map<std::string, std::chrono::microseconds> Timer::GetAllTimers()
   return IO::GetSingleton().timer.GetAllTimers();
 }
 
+// Enable memory tracking.
+inline void Timer::EnableMemoryTracking()
+{
+  IO::GetSingleton().timer.MemoryTracking() = true;
+}
+
+// Disable memory tracking.
+inline void Timer::DisableMemoryTracking()
+{
+  IO::GetSingleton().timer.MemoryTracking() = false;
+}
+
+inline std::map<std::string, util::PhaseMemory> Timer::GetAllMemory()
+{
+  return IO::GetSingleton().timer.GetAllMemory();
+}
+
 namespace util {
 
 // Reset a Timers object.
@@ -79,6 +96,15 @@ inline void Timers::Reset()
 #endif
   timers.clear();
   timerStartTime.clear();
+  traceEvents.clear();
+
+  // The phases of running timers must still be ended.
+  for (auto& it : memoryPhases)
+    for (auto& it2 : it.second)
+      MemoryTracker::EndPhase(it2.second);
+  memoryPhases.clear();
+  memory.clear();
+  traceStart = ClockType::now();
 }
 
 inline std::map<std::string, std::chrono::microseconds> Timers::GetAllTimers()
@@ -101,6 +127,52 @@ inline std::chrono::microseconds Timers::Get(const std::string& timerName)
   return timers[timerName];
 }
 
+inline std::map<std::string, PhaseMemory> Timers::GetAllMemory()
+{
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(timersMutex);
+#endif
+  return memory;
+}
+
+inline PhaseMemory Timers::GetMemory(const std::string& timerName)
+{
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(timersMutex);
+#endif
+  std::map<std::string, PhaseMemory>::const_iterator it =
+      memory.find(timerName);
+  return (it == memory.end()) ? PhaseMemory() : it->second;
+}
+
+inline void Timers::AddMemory(const std::string& timerName,
+                              const PhaseMemory& phaseMemory)
+{
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(timersMutex);
+#endif
+  memory[timerName].Merge(phaseMemory);
+}
+
+inline std::string Timers::PrintBytes(const size_t bytes)
+{
+  const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+  size_t unit = 0;
+  double value = (double) bytes;
+  while (value >= 1024.0 && unit < 4)
+  {
+    value /= 1024.0;
+    ++unit;
+  }
+
+  std::ostringstream oss;
+  if (unit == 0)
+    oss << bytes << " B";
+  else
+    oss << std::fixed << std::setprecision(1) << value << " " << units[unit];
+  return oss.str();
+}
+
 inline std::string Timers::Print(const std::chrono::microseconds& totalDuration)
 {
   // Convert microseconds to seconds.
@@ -181,15 +253,16 @@ inline void Timers::StopAllTimers()
   for (auto it : timerStartTime)
   {
     for (auto it2 : it.second)
-    {
-      timers[it2.first] +=
-          std::chrono::duration_cast<std::chrono::microseconds>(
-          currTime - it2.second);
-    }
+      AddSection(it2.first, it2.second, currTime, it.first);
   }
 
+  for (auto& it : memoryPhases)
+    for (auto& it2 : it.second)
+      memory[it2.first].Merge(MemoryTracker::EndPhase(it2.second));
+
   // If all timers are stopped, we can clear the maps.
   timerStartTime.clear();
+  memoryPhases.clear();
 }
 
 inline void Timers::Start(const std::string& timerName,
@@ -222,6 +295,9 @@ inline void Timers::Start(const std::string& timerName,
   }
 
   timerStartTime[threadId][timerName] = currTime;
+
+  if (memoryTracking)
+    memoryPhases[threadId][timerName] = MemoryTracker::BeginPhase();
 }
 
 inline void Timers::Stop(const std::string& timerName,
@@ -248,8 +324,9 @@ inline void Timers::Stop(const std::string& timerName,
       std::chrono::high_resolution_clock::now();
 
   // Calculate the delta time.
-  timers[timerName] += std::chrono::duration_cast<std::chrono::microseconds>(
-      currTime - timerStartTime[threadId][timerName]);
+  AddSection(timerName, timerStartTime[threadId][timerName], currTime,
+      threadId);
+  EndMemoryPhase(timerName, threadId);
 
   // Remove the entries.
   timerStartTime[threadId].erase(timerName);
@@ -257,5 +334,148 @@ inline void Timers::Stop(const std::string& timerName,
     timerStartTime.erase(threadId);
 }
 
+inline void Timers::Add(const std::string& timerName,
+                        const ClockType::time_point& start,
+                        const ClockType::time_point& end,
+                        const std::thread::id& threadId)
+{
+  // Don't do anything if we aren't timing.
+  if (!enabled)
+    return;
+
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(timersMutex);
+#endif
+  AddSection(timerName, start, end, threadId);
+}
+
+inline void Timers::AddSection(const std::string& timerName,
+                               const ClockType::time_point& start,
+                               const ClockType::time_point& end,
+                               const std::thread::id& threadId)
+{
+  const std::chrono::microseconds duration =
+      std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+  timers[timerName] += duration;
+
+  if (tracing)
+  {
+    traceEvents.push_back({ timerName, threadId,
+        std::chrono::duration_cast<std::chrono::microseconds>(start -
+        traceStart), duration });
+  }
+}
+
+inline void Timers::EndMemoryPhase(const std::string& timerName,
+                                   const std::thread::id& threadId)
+{
+  auto it = memoryPhases.find(threadId);
+  if (it == memoryPhases.end())
+    return;
+
+  auto it2 = it->second.find(timerName);
+  if (it2 == it->second.end())
+    return;
+
+  memory[timerName].Merge(MemoryTracker::EndPhase(it2->second));
+  it->second.erase(it2);
+  if (it->second.empty())
+    memoryPhases.erase(it);
+}
+
+inline void Timers::PrintTrace(std::ostream& stream)
+{
+#ifndef MLPACK_NO_STD_MUTEX
+  std::lock_guard<std::mutex> lock(timersMutex);
+#endif
+
+  // Number the threads in the order they appear, for the track ids.
+  std::map<std::thread::id, size_t> threadIndices;
+
+  stream << "{\"traceEvents\": [";
+  for (size_t i = 0; i < traceEvents.size(); ++i)
+  {
+    const TraceEvent& e = traceEvents[i];
+    const size_t tid = threadIndices.insert(std::make_pair(e.threadId,
+        threadIndices.size())).first->second;
+
+    // Timer names are escaped as JSON strings.
+    std::string name;
+    for (const char c : e.name)
+    {
+      if (c == '"' || c == '\\')
+        name += '\\';
+      if ((unsigned char) c >= 0x20)
+        name += c;
+    }
+
+    stream << ((i == 0) ? "\n" : ",\n") << "  {\"name\": \"" << name
+        << "\", \"cat\": \"mlpack\", \"ph\": \"X\", \"ts\": "
+        << e.start.count() << ", \"dur\": " << e.duration.count()
+        << ", \"pid\": 0, \"tid\": " << tid << "}";
+  }
+  stream << "\n]}" << std::endl;
+}
+
+inline ScopedTimer::ScopedTimer(Timers& timers, const std::string& timerName) :
+    timers(&timers),
+    parentLength(0),
+    trackMemory(false),
+    memoryPhase(0)
+{
+  Begin(timerName);
+}
+
+inline ScopedTimer::ScopedTimer(const std::string& timerName) :
+    timers(&IO::GetTimers()),
+    parentLength(0),
+    trackMemory(false),
+    memoryPhase(0)
+{
+  Begin(timerName);
+}
+
+inline void ScopedTimer::Begin(const std::string& timerName)
+{
+  if (!timers->Enabled())
+  {
+    timers = NULL;
+    return;
+  }
+
+  std::string& path = Path();
+  parentLength = path.size();
+  if (!path.empty())
+    path += '/';
+  path += timerName;
+  name = path;
+
+  if (timers->MemoryTracking())
+  {
+    trackMemory = true;
+    memoryPhase = MemoryTracker::BeginPhase();
+  }
+
+  start = Timers::ClockType::now();
+}
+
+inline ScopedTimer::~ScopedTimer()
+{
+  if (timers == NULL)
+    return;
+
+  const Timers::ClockType::time_point end = Timers::ClockType::now();
+  timers->Add(name, start, end, std::this_thread::get_id());
+  if (trackMemory)
+    timers->AddMemory(name, MemoryTracker::EndPhase(memoryPhase));
+  Path().resize(parentLength);
+}
+
+inline std::string& ScopedTimer::Path()
+{
+  static thread_local std::string path;
+  return path;
+}
+
 } // namespace util
 } // namespace mlpack
@@ -194,17 +194,17 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
   {
     wl[i].Classify(test, predictedLabels);
 
+    // Each point has its own column, so the votes can be added in parallel.
+    #pragma omp parallel for schedule(static)
     for (size_t j = 0; j < predictedLabels.n_cols; ++j)
       probabilities(predictedLabels(j), j) += alpha[i];
   }
 
-  arma::uword maxIndex = 0;
-
+  #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < predictedLabels.n_cols; ++i)
   {
     probabilities.col(i) /= accu(probabilities.col(i));
-    maxIndex = probabilities.col(i).index_max();
-    predictedLabels(i) = maxIndex;
+    predictedLabels(i) = (size_t) probabilities.col(i).index_max();
   }
 }
 
@@ -349,12 +349,14 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
   MatType tempData(data);
 
   // This matrix is a helper matrix used to calculate the final hypothesis.
-  MatType sumFinalH(numClasses, predictedLabels.n_cols);
+  // It (and D) are dense even if the data is sparse, since every element is
+  // used.
+  arma::Mat<ElemType> sumFinalH(numClasses, predictedLabels.n_cols);
   sumFinalH.zeros();
 
   // Load the initial weights into a 2-D matrix.
   const ElemType initWeight = 1.0 / ElemType(data.n_cols * numClasses);
-  MatType D(numClasses, data.n_cols);
+  arma::Mat<ElemType> D(numClasses, data.n_cols);
   D.fill(initWeight);
 
   // Weights are stored in this row vector.
@@ -371,9 +373,6 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
     // rt = (sum) D(i) y(i) ht(xi)
     rt = 0.0;
 
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = sum(D);
 
@@ -388,14 +387,18 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
 
     w.Classify(tempData, predictedLabels);
 
-    // Now, calculate alpha(t) using ht.
+    // Now, calculate alpha(t) using ht.  The weight of each point is the sum
+    // of its column of D, which is already held in `weights`.  The signed
+    // weights are summed after the parallel loop, so that rt does not depend
+    // on the number of threads.
+    arma::Row<ElemType> signedWeights(D.n_cols);
+    #pragma omp parallel for schedule(static)
     for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
     {
-      if (predictedLabels(j) == labels(j))
-        rt += accu(D.col(j));
-      else
-        rt -= accu(D.col(j));
+      signedWeights[j] = (predictedLabels(j) == labels(j)) ? weights[j] :
+          -weights[j];
     }
+    rt = accu(signedWeights);
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
       break;
@@ -418,42 +421,24 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
+    // Now start modifying the weights.  Every point only changes its own
+    // column of D and sumFinalH, so the points are updated in parallel; zt,
+    // the normalization constant, is summed afterwards.
+    const ElemType expo = std::exp(alphat);
+    #pragma omp parallel for schedule(static)
     for (size_t j = 0; j < D.n_cols; ++j)
     {
-      const ElemType expo = std::exp(alphat);
       if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
+        D.col(j) /= expo; // * exp(-1 * alphat * yt(j,k) * ht(j,k));
       else
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
+        D.col(j) *= expo;
+
+      // Add to the final hypothesis matrix.
+      // sumFinalH(k, j) += (alphat * ht(k, j));
+      sumFinalH.col(j) -= alphat;
+      sumFinalH(labels(j), j) += 2 * alphat;
     }
+    zt = accu(D);
 
     // Normalize D.
     D /= zt;
@@ -76,10 +76,17 @@ class SimpleResidueTermination
   bool IsConverged(MatType& W, MatType& H)
   {
     // Calculate the norm and compute the residue, but do it by hand, so as to
-    // avoid calculating (W*H), which may be very large.
+    // avoid calculating (W*H), which may be very large.  The norm of
+    // W * H.col(j) is sqrt(H.col(j)^T W^T W H.col(j)), so only the small Gram
+    // matrix of W is needed.
+    const MatType gram = W.t() * W;
     double norm = 0.0;
-    for (size_t j = 0; j < H.n_cols; ++j)
-      norm += arma::norm(W * H.col(j), "fro");
+    #pragma omp parallel for reduction(+:norm)
+    for (size_t j = 0; j < (size_t) H.n_cols; ++j)
+    {
+      norm += std::sqrt(std::max((double) arma::dot(H.col(j),
+          gram * H.col(j)), 0.0));
+    }
     residue = fabs(normOld - norm) / normOld;
 
     // Store the norm.
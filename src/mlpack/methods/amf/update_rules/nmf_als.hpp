@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "sparse_products.hpp"
+
 namespace mlpack {
 
 /**
@@ -86,6 +88,28 @@ class NMFALSUpdate
     }
   }
 
+  /**
+   * The update rule for the basis matrix W, when V is sparse.  V * H^T is
+   * computed from the nonzero elements of V in parallel; the pseudoinverse is
+   * only of the small matrix H * H^T.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename eT>
+  inline static void WUpdate(const arma::SpMat<eT>& V,
+                             arma::Mat<eT>& W,
+                             const arma::Mat<eT>& H)
+  {
+    arma::Mat<eT> vht;
+    DenseTimesSparse(H, arma::SpMat<eT>(V.t()), vht);
+    W = vht.t() * pinv(H * H.t());
+
+    // Set all negative numbers to 0.
+    W.clamp(0.0, std::numeric_limits<eT>::max());
+  }
+
   /**
    * The update rule for the encoding matrix H. The formula used is
    *
@@ -117,6 +141,28 @@ class NMFALSUpdate
     }
   }
 
+  /**
+   * The update rule for the encoding matrix H, when V is sparse.  W^T * V is
+   * computed from the nonzero elements of V in parallel; the pseudoinverse is
+   * only of the small matrix W^T * W.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename eT>
+  inline static void HUpdate(const arma::SpMat<eT>& V,
+                             const arma::Mat<eT>& W,
+                             arma::Mat<eT>& H)
+  {
+    arma::Mat<eT> wtv;
+    DenseTimesSparse(arma::Mat<eT>(W.t()), V, wtv);
+    H = pinv(W.t() * W) * wtv;
+
+    // Set all negative numbers to 0.
+    H.clamp(0.0, std::numeric_limits<eT>::max());
+  }
+
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "sparse_products.hpp"
+
 namespace mlpack {
 
 /**
@@ -70,8 +72,26 @@ class NMFMultiplicativeDistanceUpdate
                              WHMatType& W,
                              const WHMatType& H)
   {
-    WHMatType zz = W * H * H.t();
-    W = (W % (V * H.t())) / (W * H * H.t() + 1e-15);
+    W = (W % (V * H.t())) / (W * (H * H.t()) + 1e-15);
+  }
+
+  /**
+   * The update rule for the basis matrix W, when V is sparse.  V * H^T is
+   * computed from the nonzero elements of V in parallel, and the denominator
+   * only needs the small matrix H * H^T.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename eT>
+  inline static void WUpdate(const arma::SpMat<eT>& V,
+                             arma::Mat<eT>& W,
+                             const arma::Mat<eT>& H)
+  {
+    arma::Mat<eT> vht;
+    DenseTimesSparse(H, arma::SpMat<eT>(V.t()), vht);
+    W = (W % vht.t()) / (W * (H * H.t()) + 1e-15);
   }
 
   /**
@@ -93,8 +113,26 @@ class NMFMultiplicativeDistanceUpdate
                              const WHMatType& W,
                              WHMatType& H)
   {
-    WHMatType zz = W.t() * W * H;
-    H = (H % (W.t() * V)) / (W.t() * W * H + 1e-15);
+    H = (H % (W.t() * V)) / ((W.t() * W) * H + 1e-15);
+  }
+
+  /**
+   * The update rule for the encoding matrix H, when V is sparse.  W^T * V is
+   * computed from the nonzero elements of V in parallel, and the denominator
+   * only needs the small matrix W^T * W.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to be updated.
+   */
+  template<typename eT>
+  inline static void HUpdate(const arma::SpMat<eT>& V,
+                             const arma::Mat<eT>& W,
+                             arma::Mat<eT>& H)
+  {
+    arma::Mat<eT> wtv;
+    DenseTimesSparse(arma::Mat<eT>(W.t()), V, wtv);
+    H = (H % wtv) / ((W.t() * W) * H + 1e-15);
   }
 
   //! Serialize the object (in this case, there is nothing to serialize).
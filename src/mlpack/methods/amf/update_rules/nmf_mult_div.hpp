@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "sparse_products.hpp"
+
 namespace mlpack {
 
 /**
@@ -85,6 +87,29 @@ class NMFMultiplicativeDivergenceUpdate
         (repmat(sum(H, 1).t(), W.n_rows, 1) + 1e-15);
   }
 
+  /**
+   * The update rule for the basis matrix W, when V is sparse.  The ratios
+   * V / (W * H) are only computed at the nonzero elements of V (they are zero
+   * everywhere else), so W * H is never formed, and the product with H^T only
+   * visits those nonzero elements.  Both steps are parallel.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix to be updated.
+   * @param H Encoding matrix.
+   */
+  template<typename eT>
+  inline static void WUpdate(const arma::SpMat<eT>& V,
+                             arma::Mat<eT>& W,
+                             const arma::Mat<eT>& H)
+  {
+    arma::SpMat<eT> ratios;
+    SparseRatios(V, W, H, ratios);
+
+    arma::Mat<eT> ratiosHt;
+    DenseTimesSparse(H, arma::SpMat<eT>(ratios.t()), ratiosHt);
+    W %= ratiosHt.t() / (repmat(sum(H, 1).t(), W.n_rows, 1) + 1e-15);
+  }
+
   /**
    * The update rule for the encoding matrix H. The formula used is
    *
@@ -110,6 +135,28 @@ class NMFMultiplicativeDivergenceUpdate
         (repmat(sum(W, 0).t(), 1, H.n_cols) + 1e-15);
   }
 
+  /**
+   * The update rule for the encoding matrix H, when V is sparse.  Like the
+   * sparse update rule for W, the ratios V / (W * H) are only computed at the
+   * nonzero elements of V.
+   *
+   * @param V Sparse input matrix to be factorized.
+   * @param W Basis matrix.
+   * @param H Encoding matrix to updated.
+   */
+  template<typename eT>
+  inline static void HUpdate(const arma::SpMat<eT>& V,
+                             const arma::Mat<eT>& W,
+                             arma::Mat<eT>& H)
+  {
+    arma::SpMat<eT> ratios;
+    SparseRatios(V, W, H, ratios);
+
+    arma::Mat<eT> wtRatios;
+    DenseTimesSparse(arma::Mat<eT>(W.t()), ratios, wtRatios);
+    H %= wtRatios / (repmat(sum(W, 0).t(), 1, H.n_cols) + 1e-15);
+  }
+
   //! Serialize the object (in this case, there is nothing to serialize).
   template<typename Archive>
   void serialize(Archive& /* ar */, const uint32_t /* version */) { }
@@ -0,0 +1,94 @@
+/**
+ * @file methods/amf/update_rules/sparse_products.hpp
+ *
+ * Products of sparse and dense matrices used by the NMF update rules when the
+ * input matrix is sparse.  They only ever touch the nonzero elements of the
+ * sparse matrix, and they are parallelized over its columns with OpenMP.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_AMF_UPDATE_RULES_SPARSE_PRODUCTS_HPP
+#define MLPACK_METHODS_AMF_UPDATE_RULES_SPARSE_PRODUCTS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Compute `out = F * S`, for a dense matrix F and a sparse matrix S.  Each
+ * column of the result is a combination of the columns of F given by the
+ * nonzero elements of the same column of S, so the columns are computed in
+ * parallel.  To compute `S * F^T`, call this with the transpose of S and take
+ * the transpose of the result.
+ *
+ * @param F Dense matrix, with one column for each row of S.
+ * @param S Sparse matrix.
+ * @param out Resulting dense matrix, of size F.n_rows x S.n_cols.
+ */
+template<typename eT>
+inline void DenseTimesSparse(const arma::Mat<eT>& F,
+                             const arma::SpMat<eT>& S,
+                             arma::Mat<eT>& out)
+{
+  // Make sure that the CSC arrays are up to date before reading them from
+  // several threads.
+  S.sync();
+  const arma::uword* colPtrs = S.col_ptrs;
+  const arma::uword* rowIndices = S.row_indices;
+  const eT* values = S.values;
+
+  out.zeros(F.n_rows, S.n_cols);
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t j = 0; j < (size_t) S.n_cols; ++j)
+  {
+    for (arma::uword k = colPtrs[j]; k < colPtrs[j + 1]; ++k)
+      out.col(j) += values[k] * F.col(rowIndices[k]);
+  }
+}
+
+/**
+ * Compute the elementwise ratio `V / (W * H + 1e-15)` at the nonzero elements
+ * of V only.  The ratio is zero wherever V is zero, so the result has the same
+ * sparsity pattern as V, and W * H is never formed: only one inner product of
+ * a row of W and a column of H is computed for each nonzero element of V.
+ *
+ * @param V Sparse input matrix.
+ * @param W Basis matrix.
+ * @param H Encoding matrix.
+ * @param ratios Resulting sparse matrix of ratios.
+ */
+template<typename eT>
+inline void SparseRatios(const arma::SpMat<eT>& V,
+                         const arma::Mat<eT>& W,
+                         const arma::Mat<eT>& H,
+                         arma::SpMat<eT>& ratios)
+{
+  // Make sure that the CSC arrays are up to date before reading them from
+  // several threads.
+  V.sync();
+  const arma::uvec colPtrs(V.col_ptrs, V.n_cols + 1);
+  const arma::uvec rowIndices(V.row_indices, V.n_nonzero);
+
+  // Hold the rows of W as columns, so that they are contiguous.
+  const arma::Mat<eT> wt = W.t();
+  arma::Col<eT> values(V.n_nonzero);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t j = 0; j < (size_t) V.n_cols; ++j)
+  {
+    for (arma::uword k = colPtrs[j]; k < colPtrs[j + 1]; ++k)
+    {
+      values[k] = V.values[k] /
+          (arma::dot(wt.col(rowIndices[k]), H.col(j)) + 1e-15);
+    }
+  }
+
+  ratios = arma::SpMat<eT>(rowIndices, colPtrs, values, V.n_rows, V.n_cols);
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,274 @@
+/**
+ * @file methods/ann/activation_functions/fast_math.hpp
+ *
+ * Vectorizable approximations of exp(), expm1(), log(), and tanh(), used by
+ * the activation functions on dense matrices.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_MATH_HPP
+#define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_FAST_MATH_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The number of series terms used by FastExp(), FastExpm1(), FastTanh(), and
+ * FastLog() for the element type eT.  With the default number of terms the
+ * results for double are within a few ulps of the standard library; for
+ * float (and for double when MLPACK_ANN_REDUCED_ACCURACY_ACTIVATIONS is
+ * defined), fewer terms are used, giving a relative error of about 1e-8.
+ * Specialize this struct to choose another accuracy for a type.
+ */
+template<typename eT>
+struct FastMathTerms
+{
+  static constexpr size_t Exp = 7;
+  static constexpr size_t Log = 5;
+};
+
+template<>
+struct FastMathTerms<double>
+{
+#ifdef MLPACK_ANN_REDUCED_ACCURACY_ACTIVATIONS
+  static constexpr size_t Exp = 7;
+  static constexpr size_t Log = 5;
+#else
+  static constexpr size_t Exp = 12;
+  static constexpr size_t Log = 10;
+#endif
+};
+
+namespace detail {
+
+inline uint64_t FastMathBits(const double x)
+{
+  uint64_t bits;
+  std::memcpy(&bits, &x, sizeof(double));
+  return bits;
+}
+
+inline double FastMathFromBits(const uint64_t bits)
+{
+  double x;
+  std::memcpy(&x, &bits, sizeof(double));
+  return x;
+}
+
+// Horner evaluation of sum_{k = K}^{Terms} r^(k - K + 1) K! / k!, unrolled at
+// compile time so that the callers' loops can be vectorized.
+template<size_t K, size_t Terms>
+struct FastExpSeries
+{
+  static double Eval(const double r)
+  {
+    return r * (1.0 / K) * (1.0 + FastExpSeries<K + 1, Terms>::Eval(r));
+  }
+};
+
+template<size_t Terms>
+struct FastExpSeries<Terms, Terms>
+{
+  static double Eval(const double r) { return r * (1.0 / Terms); }
+};
+
+// Evaluation of sum_{k = K}^{Terms} s2^(k - K) / (2k - 1).
+template<size_t K, size_t Terms>
+struct FastLogSeries
+{
+  static double Eval(const double s2)
+  {
+    return 1.0 / (2 * K - 1) + s2 * FastLogSeries<K + 1, Terms>::Eval(s2);
+  }
+};
+
+template<size_t Terms>
+struct FastLogSeries<Terms, Terms>
+{
+  static double Eval(const double /* s2 */) { return 1.0 / (2 * Terms - 1); }
+};
+
+// Adding this to a double in [-2^51, 2^51] rounds it to an integer n, and
+// stores n in the low bits of the result.
+constexpr double fastMathShift = 6755399441055744.0; // 1.5 * 2^52.
+
+/**
+ * Split x into n log(2) + r with |r| <= log(2) / 2, returning r and storing
+ * n + fastMathShift in shifted.  x is clamped to the range where 2^n is a
+ * normal number.
+ */
+inline double FastExpReduce(const double x, double& shifted)
+{
+  const double xc = std::min(std::max(x, -708.0), 709.0);
+  shifted = xc * 1.4426950408889634 + fastMathShift;
+  const double n = shifted - fastMathShift;
+  // log(2) in two parts, so that n * log(2) is exact.
+  return (xc - n * 6.93147180369123816490e-01) -
+      n * 1.90821492927058770002e-10;
+}
+
+// Compute 2^n from the value stored by FastExpReduce().
+inline double FastExpScale(const double shifted)
+{
+  return FastMathFromBits((FastMathBits(shifted) + 1023) << 52);
+}
+
+/**
+ * Approximate exp(x) - 1.  The sum of the first Terms terms of the series of
+ * exp(r) - 1 is scaled by 2^n; for small x, n = 0 and the series is used
+ * directly, so that there is no cancellation.
+ */
+template<size_t Terms>
+inline double FastExpm1(const double x)
+{
+  double shifted;
+  const double r = FastExpReduce(x, shifted);
+  const double p = FastExpSeries<1, Terms>::Eval(r);
+  double y = (std::abs(x) < 0.34657359027997264) ? p :
+      ((1.0 + p) * FastExpScale(shifted) - 1.0);
+  y = (x > 709.78) ? std::numeric_limits<double>::infinity() : y;
+  y = (x < -708.39) ? -1.0 : y;
+  return (x != x) ? x : y;
+}
+
+} // namespace detail
+
+/**
+ * Approximate exp(x).  The argument is reduced to [-log(2) / 2, log(2) / 2],
+ * where a series with the given number of terms is used; then the result is
+ * scaled by a power of two built directly from its bits.  There are no
+ * branches or calls, so loops over this function can be vectorized.  Results
+ * that would be subnormal are flushed to zero.
+ *
+ * @param x Input value.
+ * @tparam Terms Number of series terms (between 2 and 20).
+ */
+template<typename eT, size_t Terms = FastMathTerms<eT>::Exp>
+inline eT FastExp(const eT x)
+{
+  static_assert(Terms >= 2 && Terms <= 20, "FastExp(): invalid Terms");
+  const double xd = (double) x;
+  double shifted;
+  const double r = detail::FastExpReduce(xd, shifted);
+  double y = (1.0 + detail::FastExpSeries<1, Terms>::Eval(r)) *
+      detail::FastExpScale(shifted);
+  y = (xd > 709.78) ? std::numeric_limits<double>::infinity() : y;
+  y = (xd < -708.39) ? 0.0 : y;
+  return (eT) ((xd != xd) ? xd : y);
+}
+
+/**
+ * Approximate exp(x) - 1, accurate also for small x.
+ *
+ * @param x Input value.
+ * @tparam Terms Number of series terms (between 2 and 20).
+ */
+template<typename eT, size_t Terms = FastMathTerms<eT>::Exp>
+inline eT FastExpm1(const eT x)
+{
+  static_assert(Terms >= 2 && Terms <= 20, "FastExpm1(): invalid Terms");
+  return (eT) detail::FastExpm1<Terms>((double) x);
+}
+
+/**
+ * Approximate log(x).  x is split into m 2^e with m in [sqrt(1/2), sqrt(2)),
+ * and log(m) = 2 atanh((m - 1) / (m + 1)) is computed with the given number
+ * of terms of the series of atanh().
+ *
+ * @param x Input value.
+ * @tparam Terms Number of series terms (between 2 and 20).
+ */
+template<typename eT, size_t Terms = FastMathTerms<eT>::Log>
+inline eT FastLog(const eT x)
+{
+  static_assert(Terms >= 2 && Terms <= 20, "FastLog(): invalid Terms");
+  const double xd = (double) x;
+
+  // Scale subnormals into the normal range.
+  const bool subnormal = (xd < std::numeric_limits<double>::min());
+  const double xs = subnormal ? xd * 18014398509481984.0 /* 2^54 */ : xd;
+  const uint64_t bits = detail::FastMathBits(xs);
+  double m = detail::FastMathFromBits((bits & 0x000fffffffffffffULL) |
+      0x3ff0000000000000ULL);
+  double e = detail::FastMathFromBits(
+      detail::FastMathBits(detail::fastMathShift) + ((bits >> 52) & 0x7ff)) -
+      detail::fastMathShift - (subnormal ? 1077.0 : 1023.0);
+  const bool large = (m > 1.4142135623730951);
+  m = large ? 0.5 * m : m;
+  e = large ? e + 1.0 : e;
+
+  const double s = (m - 1.0) / (m + 1.0);
+  const double p = detail::FastLogSeries<1, Terms>::Eval(s * s);
+  double y = (e * 1.90821492927058770002e-10 + 2.0 * s * p) +
+      e * 6.93147180369123816490e-01;
+
+  y = (xd == 0.0) ? -std::numeric_limits<double>::infinity() : y;
+  y = (xd < 0.0) ? std::numeric_limits<double>::quiet_NaN() : y;
+  y = (xd == std::numeric_limits<double>::infinity()) ? xd : y;
+  return (eT) ((xd != xd) ? xd : y);
+}
+
+/**
+ * Approximate tanh(x), computed as e / (e + 2) with e = expm1(2|x|).
+ *
+ * @param x Input value.
+ * @tparam Terms Number of series terms (between 2 and 20).
+ */
+template<typename eT, size_t Terms = FastMathTerms<eT>::Exp>
+inline eT FastTanh(const eT x)
+{
+  static_assert(Terms >= 2 && Terms <= 20, "FastTanh(): invalid Terms");
+  const double xd = (double) x;
+  // tanh(20) is 1 in double precision.
+  const double e = detail::FastExpm1<Terms>(2.0 * std::min(std::abs(xd),
+      20.0));
+  const double y = std::copysign(e / (e + 2.0), xd);
+  return (eT) ((xd != xd) ? xd : y);
+}
+
+/**
+ * Whether the activation functions can apply their fast implementations to
+ * the given types: dense Armadillo matrices or cubes with floating-point
+ * elements, whose memory can be traversed directly.
+ */
+template<typename... MatTypes>
+struct UseFastActivation
+{
+  template<typename MatType>
+  static constexpr bool IsDense()
+  {
+    if constexpr (arma::is_Mat<MatType>::value ||
+                  arma::is_Cube<MatType>::value)
+      return std::is_floating_point_v<typename MatType::elem_type>;
+    else
+      return false;
+  }
+
+  static constexpr bool value = (IsDense<MatTypes>() && ...);
+};
+
+/**
+ * Set y(i) = f(x(i)) for every element of the dense matrix x, in a loop that
+ * the compiler can vectorize.  x and y may be the same matrix.
+ */
+template<typename InputType, typename OutputType, typename FunctionType>
+inline void FastActivationApply(const InputType& x,
+                                OutputType& y,
+                                const FunctionType& f)
+{
+  y.set_size(arma::size(x));
+  const typename InputType::elem_type* in = x.memptr();
+  typename OutputType::elem_type* out = y.memptr();
+
+  #pragma omp simd
+  for (size_t i = 0; i < (size_t) x.n_elem; ++i)
+    out[i] = f(in[i]);
+}
+
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "fast_math.hpp"
+
 namespace mlpack {
 
 /**
@@ -52,8 +54,19 @@ class GELUFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType& x, OutputVecType& y)
   {
-    y = 0.5 * x % (1 + arma::tanh(std::sqrt(2 / M_PI) *
-        (x + 0.044715 * pow(x, 3))));
+    if constexpr (UseFastActivation<InputVecType, OutputVecType>::value)
+    {
+      FastActivationApply(x, y, [](const auto xi)
+      {
+        return 0.5 * xi * (1 + FastTanh(std::sqrt(2 / M_PI) *
+            (xi + 0.044715 * xi * xi * xi)));
+      });
+    }
+    else
+    {
+      y = 0.5 * x % (1 + arma::tanh(std::sqrt(2 / M_PI) *
+          (x + 0.044715 * pow(x, 3))));
+    }
   }
 
   /**
@@ -84,11 +97,25 @@ class GELUFunction
                     const OutputVecType& /* y */,
                     DerivVecType& dy)
   {
-    dy = 0.5 * arma::tanh(0.0356774 * pow(x, 3) + 0.797885 * x) +
-        (0.0535161 * pow(x, 3) + 0.398942 * x) %
-        pow(1 / arma::cosh(0.0356774 * pow(x, 3) +
-        0.797885 * x), 2) + 0.5;
-    dy(arma::find(x < -10)).fill(0); // catch overflows
+    if constexpr (UseFastActivation<InputVecType, DerivVecType>::value)
+    {
+      // sech^2(u) = 1 - tanh^2(u).
+      FastActivationApply(x, dy, [](const auto xi)
+      {
+        const auto x3 = xi * xi * xi;
+        const auto t = FastTanh(0.0356774 * x3 + 0.797885 * xi);
+        return (xi < -10) ? 0.0 :
+            0.5 * t + (0.0535161 * x3 + 0.398942 * xi) * (1 - t * t) + 0.5;
+      });
+    }
+    else
+    {
+      dy = 0.5 * arma::tanh(0.0356774 * pow(x, 3) + 0.797885 * x) +
+          (0.0535161 * pow(x, 3) + 0.398942 * x) %
+          pow(1 / arma::cosh(0.0356774 * pow(x, 3) +
+          0.797885 * x), 2) + 0.5;
+      dy(arma::find(x < -10)).fill(0); // catch overflows
+    }
   }
 }; // class GELUFunction
 
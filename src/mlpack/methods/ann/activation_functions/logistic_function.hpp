@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "fast_math.hpp"
+
 namespace mlpack {
 
 /**
@@ -57,7 +59,15 @@ class LogisticFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType& x, OutputVecType& y)
   {
-    y = (1.0 / (1 + exp(-x)));
+    if constexpr (UseFastActivation<InputVecType, OutputVecType>::value)
+    {
+      FastActivationApply(x, y, [](const auto xi)
+          { return 1 / (1 + FastExp(-xi)); });
+    }
+    else
+    {
+      y = (1.0 / (1 + exp(-x)));
+    }
   }
 
   /**
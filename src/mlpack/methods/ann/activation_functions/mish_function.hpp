@@ -24,6 +24,8 @@
 #define MLPACK_METHODS_ANN_ACTIVATION_FUNCTIONS_MISH_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+
+#include "fast_math.hpp"
 #include <algorithm>
 
 namespace mlpack {
@@ -60,7 +62,20 @@ class MishFunction
   template <typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType &x, OutputVecType &y)
   {
-    y = x % (exp(2 * x) + 2 * exp(x)) / (2 + 2 * exp(x) + exp(2 * x));
+    if constexpr (UseFastActivation<InputVecType, OutputVecType>::value)
+    {
+      // For large x, exp(2x) overflows, and tanh(softplus(x)) is 1.
+      FastActivationApply(x, y, [](const auto xi)
+      {
+        const auto e = FastExp(xi);
+        const auto n = e * (e + 2);
+        return (xi > 20) ? xi : xi * n / (n + 2);
+      });
+    }
+    else
+    {
+      y = x % (exp(2 * x) + 2 * exp(x)) / (2 + 2 * exp(x) + exp(2 * x));
+    }
   }
 
   /**
@@ -89,9 +104,22 @@ class MishFunction
                     const OutputVecType& /* y */,
                     DerivVecType& dy)
   {
-    dy = exp(x) % (4 * (x + 1) + exp(x) % (4 * x + 6) +
-        4 * exp(2 * x) + exp(3 * x)) /
-        pow(exp(2 * x) + 2 * exp(x) + 2, 2);
+    if constexpr (UseFastActivation<InputVecType, DerivVecType>::value)
+    {
+      FastActivationApply(x, dy, [](const auto xi)
+      {
+        const auto e = FastExp(xi);
+        const auto d = e * (e + 2) + 2;
+        return (xi > 20) ? 1.0 : e * (4 * (xi + 1) + e * (4 * xi + 6) +
+            4 * e * e + e * e * e) / (d * d);
+      });
+    }
+    else
+    {
+      dy = exp(x) % (4 * (x + 1) + exp(x) % (4 * x + 6) +
+          4 * exp(2 * x) + exp(3 * x)) /
+          pow(exp(2 * x) + 2 * exp(x) + 2, 2);
+    }
   }
 }; // class MishFunction
 
@@ -30,6 +30,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "fast_math.hpp"
+
 namespace mlpack {
 
 /**
@@ -63,7 +65,15 @@ class SILUFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType &x, OutputVecType &y)
   {
-    y = x / (1.0 + exp(-x));
+    if constexpr (UseFastActivation<InputVecType, OutputVecType>::value)
+    {
+      FastActivationApply(x, y, [](const auto xi)
+          { return xi / (1 + FastExp(-xi)); });
+    }
+    else
+    {
+      y = x / (1.0 + exp(-x));
+    }
   }
 
   /**
@@ -28,6 +28,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "fast_math.hpp"
+
 namespace mlpack {
 
 /**
@@ -65,10 +67,26 @@ class SoftplusFunction
   template<typename InputType, typename OutputType>
   static void Fn(const InputType& x, OutputType& y)
   {
-    y.set_size(arma::size(x));
+    if constexpr (UseFastActivation<InputType, OutputType>::value)
+    {
+      // f(x) = max(x, 0) + log(1 + e) with e = exp(-|x|); log(1 + e) is
+      // computed as log(u) e / (u - 1), with u = 1 + e rounded, so that small
+      // values of e are not lost.
+      FastActivationApply(x, y, [](const auto xi)
+      {
+        const auto e = FastExp(-std::abs(xi));
+        const auto u = 1 + e;
+        const auto l = (u == 1) ? e : FastLog(u) * e / (u - 1);
+        return ((xi > 0) ? xi : 0) + l;
+      });
+    }
+    else
+    {
+      y.set_size(arma::size(x));
 
-    for (size_t i = 0; i < x.n_elem; ++i)
-      y(i) = Fn(x(i));
+      for (size_t i = 0; i < x.n_elem; ++i)
+        y(i) = Fn(x(i));
+    }
   }
 
   /**
@@ -95,7 +113,15 @@ class SoftplusFunction
                     const OutputType& /* y */,
                     DerivType& dy)
   {
-    dy = 1.0 / (1 + exp(-x));
+    if constexpr (UseFastActivation<InputType, DerivType>::value)
+    {
+      FastActivationApply(x, dy, [](const auto xi)
+          { return 1 / (1 + FastExp(-xi)); });
+    }
+    else
+    {
+      dy = 1.0 / (1 + exp(-x));
+    }
   }
 
   /**
@@ -16,6 +16,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "fast_math.hpp"
+
 namespace mlpack {
 
 /**
@@ -51,7 +53,15 @@ class SwishFunction
   static void Fn(const MatType& x, MatType& y,
      const typename std::enable_if_t<IsMatrix<MatType>::value>* = 0)
   {
-    y = x / (1.0 + exp(-x));
+    if constexpr (UseFastActivation<MatType>::value)
+    {
+      FastActivationApply(x, y, [](const auto xi)
+          { return xi / (1 + FastExp(-xi)); });
+    }
+    else
+    {
+      y = x / (1.0 + exp(-x));
+    }
   }
 
   /**
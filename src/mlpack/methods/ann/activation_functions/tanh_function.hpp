@@ -14,6 +14,8 @@
 
 #include <mlpack/prereqs.hpp>
 
+#include "fast_math.hpp"
+
 namespace mlpack {
 
 /**
@@ -48,7 +50,10 @@ class TanhFunction
   template<typename InputVecType, typename OutputVecType>
   static void Fn(const InputVecType& x, OutputVecType& y)
   {
-    y = arma::tanh(x);
+    if constexpr (UseFastActivation<InputVecType, OutputVecType>::value)
+      FastActivationApply(x, y, [](const auto xi) { return FastTanh(xi); });
+    else
+      y = arma::tanh(x);
   }
 
   /**
@@ -27,6 +27,7 @@
 #include "loss_functions/loss_functions.hpp"
 #include "regularizer/regularizer.hpp"
 
+#include "dag_network.hpp"
 #include "ffn.hpp"
 #include "rnn.hpp"
 
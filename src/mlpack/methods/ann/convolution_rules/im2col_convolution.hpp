@@ -0,0 +1,385 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution as a matrix product, by unrolling the
+ * patches of the input into the columns of a matrix (im2col).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+
+/**
+ * Computes the two-dimensional convolution by lowering it to a matrix product.
+ * Every patch of the input that the filter is applied to is copied into a
+ * column of a matrix (im2col), so that the convolution is the product of the
+ * transpose of that matrix with the vectorised filter.  The results are the
+ * same as with NaiveConvolution, but the work is done by BLAS.
+ *
+ * The real benefit comes when the rule is used by the ConvolutionType layer:
+ * then the patches of all the input maps of a point are unrolled at once, and
+ * all the output maps are computed with a single matrix product with the
+ * filters (and similarly for the backward pass and the gradient, with Col2Im()
+ * as the adjoint of Im2Col()).  The matrix of patches has
+ * (filter size * input maps) rows and (output size) columns, so this trades
+ * memory for speed.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /**
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static std::enable_if_t<std::is_same_v<Border, ValidConvolution>, void>
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    using eT = typename InMatType::elem_type;
+    // See NaiveConvolution for the computation of the output size.
+    if (!appending)
+    {
+      const size_t filterRows = filter.n_rows * dilationH - (dilationH - 1);
+      const size_t filterCols = filter.n_cols * dilationW - (dilationW - 1);
+      const size_t outputRows = (input.n_rows - filterRows + dH) / dH;
+      const size_t outputCols = (input.n_cols - filterCols + dW) / dW;
+      output.zeros(outputRows, outputCols);
+    }
+
+    arma::Mat<eT> columns;
+    Im2Col(input.memptr(), input.n_rows, input.n_cols, 1, filter.n_rows,
+        filter.n_cols, dH, dW, dilationH, dilationW, output.n_rows,
+        output.n_cols, columns);
+
+    const arma::Col<eT> result = columns.t() * arma::vectorise(filter);
+    output += arma::reshape(result, output.n_rows, output.n_cols);
+  }
+
+  /**
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static std::enable_if_t<std::is_same_v<Border, FullConvolution>, void>
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    // Pad the input so that the full convolution is the valid convolution of
+    // the padded input.
+    const size_t filterRows = filter.n_rows * dilationH - (dilationH - 1);
+    const size_t filterCols = filter.n_cols * dilationW - (dilationW - 1);
+    const size_t paddingRows = filterRows - 1;
+    const size_t paddingCols = filterCols - 1;
+
+    InMatType inputPadded(input.n_rows + 2 * paddingRows,
+        input.n_cols + 2 * paddingCols, arma::fill::zeros);
+    inputPadded.submat(paddingRows, paddingCols, paddingRows + input.n_rows - 1,
+        paddingCols + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, dW, dH, dilationW, dilationH, appending);
+  }
+
+  /**
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename CubeType>
+  static void Convolution(
+      const CubeType& input,
+      const CubeType& filter,
+      CubeType& output,
+      const size_t dW = 1,
+      const size_t dH = 1,
+      const size_t dilationW = 1,
+      const size_t dilationH = 1,
+      const bool appending = false,
+      const typename std::enable_if_t<IsCube<CubeType>::value>* = 0)
+  {
+    using MatType = typename GetDenseMatType<CubeType>::type;
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH,
+          appending);
+    }
+  }
+
+  /**
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename MatType, typename CubeType>
+  static void Convolution(
+      const MatType& input,
+      const CubeType& filter,
+      CubeType& output,
+      const size_t dW = 1,
+      const size_t dH = 1,
+      const size_t dilationW = 1,
+      const size_t dilationH = 1,
+      const bool appending = false,
+      const typename std::enable_if_t<IsMatrix<MatType>::value>* = 0,
+      const typename std::enable_if_t<IsCube<CubeType>::value>* = 0)
+  {
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, filter.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH, appending);
+    }
+  }
+
+  /**
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename MatType, typename CubeType>
+  static void Convolution(
+      const CubeType& input,
+      const MatType& filter,
+      CubeType& output,
+      const size_t dW = 1,
+      const size_t dH = 1,
+      const size_t dilationW = 1,
+      const size_t dilationH = 1,
+      const bool appending = false,
+      const typename std::enable_if_t<IsMatrix<MatType>::value>* = 0,
+      const typename std::enable_if_t<IsCube<CubeType>::value>* = 0)
+  {
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH, appending);
+    }
+  }
+  /**
+   * Unroll the patches of a column-major stack of input maps into the columns
+   * of a matrix.  The column i + j * outputRows holds the patch that gives the
+   * output element (i, j), and the row ki + kj * filterRows +
+   * m * filterRows * filterCols of that column holds the input element of map
+   * m that is multiplied with the filter element (ki, kj); so the product of
+   * the transpose of the matrix with a vectorised stack of filters (one for
+   * each input map) is the vectorised sum of their convolutions.
+   *
+   * @param input Pointer to the first input map; the maps are stored one after
+   *     another.
+   * @param inputRows Number of rows of each input map.
+   * @param inputCols Number of columns of each input map.
+   * @param maps Number of input maps.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param dilationRows Dilation of the filter along the rows.
+   * @param dilationCols Dilation of the filter along the columns.
+   * @param outputRows Number of rows of the output.
+   * @param outputCols Number of columns of the output.
+   * @param columns Matrix to store the patches in.
+   */
+  template<typename eT, typename MatType>
+  static void Im2Col(const eT* input,
+                     const size_t inputRows,
+                     const size_t inputCols,
+                     const size_t maps,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t dilationRows,
+                     const size_t dilationCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     MatType& columns)
+  {
+    columns.set_size(filterRows * filterCols * maps, outputRows * outputCols);
+    eT* columnPtr = columns.memptr();
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        for (size_t m = 0; m < maps; ++m)
+        {
+          const eT* mapPtr = input + m * inputRows * inputCols;
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            const eT* inputPtr = mapPtr + (j * strideCols + kj * dilationCols) *
+                inputRows + i * strideRows;
+            for (size_t ki = 0; ki < filterRows; ++ki, ++columnPtr,
+                inputPtr += dilationRows)
+              *columnPtr = *inputPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * The adjoint of Im2Col(): add each element of the columns to the input
+   * element it was copied from.  The output maps must be initialized (usually
+   * to zero) before the call.  All the parameters have the same meaning as for
+   * Im2Col().
+   */
+  template<typename eT, typename MatType>
+  static void Col2Im(const MatType& columns,
+                     const size_t inputRows,
+                     const size_t inputCols,
+                     const size_t maps,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t dilationRows,
+                     const size_t dilationCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     eT* input)
+  {
+    const eT* columnPtr = columns.memptr();
+    for (size_t j = 0; j < outputCols; ++j)
+    {
+      for (size_t i = 0; i < outputRows; ++i)
+      {
+        for (size_t m = 0; m < maps; ++m)
+        {
+          eT* mapPtr = input + m * inputRows * inputCols;
+          for (size_t kj = 0; kj < filterCols; ++kj)
+          {
+            eT* inputPtr = mapPtr + (j * strideCols + kj * dilationCols) *
+                inputRows + i * strideRows;
+            for (size_t ki = 0; ki < filterRows; ++ki, ++columnPtr,
+                inputPtr += dilationRows)
+              *inputPtr += *columnPtr;
+          }
+        }
+      }
+    }
+  }
+};  // class Im2ColConvolution
+
+/**
+ * This is true if the convolution rule is an Im2ColConvolution, so that the
+ * ConvolutionType layer can lower the convolution of all maps to matrix
+ * products.
+ */
+template<typename ConvolutionRuleType>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,525 @@
+/**
+ * @file methods/ann/convolution_rules/winograd_convolution.hpp
+ *
+ * Implementation of the convolution with 3x3 filters using Winograd's minimal
+ * filtering algorithm F(2x2, 3x3).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_WINOGRAD_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "border_modes.hpp"
+#include "naive_convolution.hpp"
+
+namespace mlpack {
+
+/**
+ * Computes the two-dimensional convolution with a 3x3 filter, unit strides and
+ * no dilation using the Winograd transform F(2x2, 3x3).  The output is
+ * computed in 2x2 tiles; each tile is obtained from a 4x4 tile d of the input
+ * as
+ *
+ *   Y = A^T [(G g G^T) .* (B^T d B)] A,
+ *
+ * so that the 36 multiplications of the direct computation are replaced by 16
+ * elementwise multiplications (a 2.25x reduction).  The filter transform
+ * G g G^T only depends on the filter, so when many maps are convolved (see
+ * MultiMapConvolution()) it is computed once for each filter, the input
+ * transform once for each input map and the output transform once for each
+ * output map, while the elementwise products summed over the input maps become
+ * 16 matrix products.  This is the fast algorithm of:
+ *
+ * @code
+ * @inproceedings{lavin2016fast,
+ *   title={Fast Algorithms for Convolutional Neural Networks},
+ *   author={Lavin, Andrew and Gray, Scott},
+ *   booktitle={Proceedings of the IEEE Conference on Computer Vision and
+ *       Pattern Recognition (CVPR)},
+ *   pages={4013--4021},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Filters of other sizes, strides and dilations are handled by
+ * NaiveConvolution.  The ConvolutionType and GroupedConvolutionType layers use
+ * this rule automatically in the forward pass instead of the default
+ * NaiveConvolution when the filters are 3x3 and the strides are 1.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class WinogradConvolution
+{
+ public:
+  /**
+   * Return true if the Winograd transform can be used for a convolution with
+   * the given filter size, strides and dilations.
+   */
+  static bool Supports(const size_t filterRows,
+                       const size_t filterCols,
+                       const size_t dW = 1,
+                       const size_t dH = 1,
+                       const size_t dilationW = 1,
+                       const size_t dilationH = 1)
+  {
+    return (filterRows == 3 && filterCols == 3 && dW == 1 && dH == 1 &&
+        dilationW == 1 && dilationH == 1);
+  }
+
+  /**
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static std::enable_if_t<std::is_same_v<Border, ValidConvolution>, void>
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    using eT = typename InMatType::elem_type;
+    if (!Supports(filter.n_rows, filter.n_cols, dW, dH, dilationW, dilationH))
+    {
+      NaiveConvolution<ValidConvolution>::Convolution(input, filter, output,
+          dW, dH, dilationW, dilationH, appending);
+      return;
+    }
+
+    if (!appending)
+      output.zeros(input.n_rows - 2, input.n_cols - 2);
+
+    eT u[16], v[16];
+    TransformFilter(filter.memptr(), u);
+    for (size_t tj = 0; tj < (output.n_cols + 1) / 2; ++tj)
+    {
+      for (size_t ti = 0; ti < (output.n_rows + 1) / 2; ++ti)
+      {
+        TransformInput(input.memptr(), input.n_rows, input.n_cols, 2 * ti,
+            2 * tj, v);
+        for (size_t k = 0; k < 16; ++k)
+          v[k] *= u[k];
+        TransformOutput(v, output.memptr(), output.n_rows, output.n_cols,
+            2 * ti, 2 * tj);
+      }
+    }
+  }
+
+  /**
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static std::enable_if_t<std::is_same_v<Border, FullConvolution>, void>
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    // Pad the input so that the full convolution is the valid convolution of
+    // the padded input.
+    const size_t filterRows = filter.n_rows * dilationH - (dilationH - 1);
+    const size_t filterCols = filter.n_cols * dilationW - (dilationW - 1);
+    const size_t paddingRows = filterRows - 1;
+    const size_t paddingCols = filterCols - 1;
+
+    InMatType inputPadded(input.n_rows + 2 * paddingRows,
+        input.n_cols + 2 * paddingCols, arma::fill::zeros);
+    inputPadded.submat(paddingRows, paddingCols, paddingRows + input.n_rows - 1,
+        paddingCols + input.n_cols - 1) = input;
+
+    WinogradConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, dW, dH, dilationW, dilationH, appending);
+  }
+
+  /**
+   * Compute the Winograd transforms of a block of 3x3 filters, for use with
+   * MultiMapConvolution().  The filter for output map o and input map m is the
+   * slice firstSlice + o * inMaps + m of the given cube, and its transform is
+   * stored in transformedFilters(o, m, k) for k = 0, ..., 15.
+   *
+   * @param filters Cube of 3x3 filters.
+   * @param firstSlice Slice of the filter of the first maps.
+   * @param outMaps Number of output maps.
+   * @param inMaps Number of input maps.
+   * @param transformedFilters Cube to store the transformed filters in.
+   */
+  template<typename FilCubeType, typename TransformedCubeType>
+  static void TransformFilters(const FilCubeType& filters,
+                               const size_t firstSlice,
+                               const size_t outMaps,
+                               const size_t inMaps,
+                               TransformedCubeType& transformedFilters)
+  {
+    using eT = typename FilCubeType::elem_type;
+    transformedFilters.set_size(outMaps, inMaps, 16);
+    eT u[16];
+    for (size_t o = 0; o < outMaps; ++o)
+    {
+      for (size_t m = 0; m < inMaps; ++m)
+      {
+        TransformFilter(filters.slice(firstSlice + o * inMaps + m).memptr(), u);
+        for (size_t k = 0; k < 16; ++k)
+          transformedFilters(o, m, k) = u[k];
+      }
+    }
+  }
+
+  /**
+   * Convolve the input maps firstInputMap, ..., firstInputMap + inMaps - 1 of
+   * the input cube with 3x3 filters, and add the sums over the input maps to
+   * the output maps firstOutputMap, ..., firstOutputMap + outMaps - 1 of the
+   * output cube (valid mode, unit strides; the output maps must already have
+   * their size).  The filters are given as transforms computed with
+   * TransformFilters(), which also give the number of maps.
+   *
+   * @param input Cube of input maps.
+   * @param firstInputMap Slice of the first input map.
+   * @param transformedFilters Transformed filters (outMaps x inMaps x 16).
+   * @param output Cube of output maps.
+   * @param firstOutputMap Slice of the first output map.
+   */
+  template<typename InCubeType, typename TransformedCubeType,
+           typename OutCubeType>
+  static void MultiMapConvolution(const InCubeType& input,
+                                  const size_t firstInputMap,
+                                  const TransformedCubeType& transformedFilters,
+                                  OutCubeType& output,
+                                  const size_t firstOutputMap)
+  {
+    using eT = typename InCubeType::elem_type;
+
+    const size_t outMaps = transformedFilters.n_rows;
+    const size_t inMaps = transformedFilters.n_cols;
+    const size_t tileRows = (output.n_rows + 1) / 2;
+    const size_t tileCols = (output.n_cols + 1) / 2;
+    const size_t tiles = tileRows * tileCols;
+
+    // transformedInput(m, t, k) is element k of the transform of tile t of
+    // input map m.
+    InCubeType transformedInput(inMaps, tiles, 16);
+    eT v[16];
+    for (size_t m = 0; m < inMaps; ++m)
+    {
+      const eT* inputPtr = input.slice(firstInputMap + m).memptr();
+      for (size_t tj = 0, t = 0; tj < tileCols; ++tj)
+      {
+        for (size_t ti = 0; ti < tileRows; ++ti, ++t)
+        {
+          TransformInput(inputPtr, input.n_rows, input.n_cols, 2 * ti, 2 * tj,
+              v);
+          for (size_t k = 0; k < 16; ++k)
+            transformedInput(m, t, k) = v[k];
+        }
+      }
+    }
+
+    // The sum over the input maps of the elementwise products of the
+    // transforms is a matrix product for each of the 16 elements.
+    InCubeType products(outMaps, tiles, 16);
+    for (size_t k = 0; k < 16; ++k)
+    {
+      products.slice(k) = transformedFilters.slice(k) *
+          transformedInput.slice(k);
+    }
+
+    for (size_t o = 0; o < outMaps; ++o)
+    {
+      eT* outputPtr = output.slice(firstOutputMap + o).memptr();
+      for (size_t tj = 0, t = 0; tj < tileCols; ++tj)
+      {
+        for (size_t ti = 0; ti < tileRows; ++ti, ++t)
+        {
+          for (size_t k = 0; k < 16; ++k)
+            v[k] = products(o, t, k);
+          TransformOutput(v, outputPtr, output.n_rows, output.n_cols, 2 * ti,
+              2 * tj);
+        }
+      }
+    }
+  }
+
+  /**
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename CubeType>
+  static void Convolution(
+      const CubeType& input,
+      const CubeType& filter,
+      CubeType& output,
+      const size_t dW = 1,
+      const size_t dH = 1,
+      const size_t dilationW = 1,
+      const size_t dilationH = 1,
+      const bool appending = false,
+      const typename std::enable_if_t<IsCube<CubeType>::value>* = 0)
+  {
+    using MatType = typename GetDenseMatType<CubeType>::type;
+    MatType convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0),
+        filter.slice(0), convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH,
+          appending);
+    }
+  }
+
+  /**
+   * Perform a convolution using dense matrix as input and a 3rd order tensors
+   * as filter and output.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename MatType, typename CubeType>
+  static void Convolution(
+      const MatType& input,
+      const CubeType& filter,
+      CubeType& output,
+      const size_t dW = 1,
+      const size_t dH = 1,
+      const size_t dilationW = 1,
+      const size_t dilationH = 1,
+      const bool appending = false,
+      const typename std::enable_if_t<IsMatrix<MatType>::value>* = 0,
+      const typename std::enable_if_t<IsCube<CubeType>::value>* = 0)
+  {
+    MatType convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input, filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, filter.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < filter.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input, filter.slice(i),
+          output.slice(i), dW, dH, dilationW, dilationH, appending);
+    }
+  }
+
+  /**
+   * Perform a convolution using a 3rd order tensors as input and output and a
+   * dense matrix as filter.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename MatType, typename CubeType>
+  static void Convolution(
+      const CubeType& input,
+      const MatType& filter,
+      CubeType& output,
+      const size_t dW = 1,
+      const size_t dH = 1,
+      const size_t dilationW = 1,
+      const size_t dilationH = 1,
+      const bool appending = false,
+      const typename std::enable_if_t<IsMatrix<MatType>::value>* = 0,
+      const typename std::enable_if_t<IsCube<CubeType>::value>* = 0)
+  {
+    MatType convOutput;
+    WinogradConvolution<BorderMode>::Convolution(input.slice(0), filter,
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      WinogradConvolution<BorderMode>::Convolution(input.slice(i), filter,
+          output.slice(i), dW, dH, dilationW, dilationH, appending);
+    }
+  }
+ private:
+  /**
+   * Compute the transform G g G^T of a 3x3 filter g (column-major), where
+   *
+   *   G = [1 0 0; 1/2 1/2 1/2; 1/2 -1/2 1/2; 0 0 1].
+   */
+  template<typename eT>
+  static void TransformFilter(const eT* g, eT* u)
+  {
+    // s = G g, a 4x3 matrix.
+    eT s[12];
+    for (size_t c = 0; c < 3; ++c)
+    {
+      const eT* col = g + 3 * c;
+      s[4 * c] = col[0];
+      s[4 * c + 1] = (col[0] + col[1] + col[2]) / 2;
+      s[4 * c + 2] = (col[0] - col[1] + col[2]) / 2;
+      s[4 * c + 3] = col[2];
+    }
+
+    // u = s G^T, a 4x4 matrix.
+    for (size_t r = 0; r < 4; ++r)
+    {
+      u[r] = s[r];
+      u[r + 4] = (s[r] + s[r + 4] + s[r + 8]) / 2;
+      u[r + 8] = (s[r] - s[r + 4] + s[r + 8]) / 2;
+      u[r + 12] = s[r + 8];
+    }
+  }
+
+  /**
+   * Compute the transform B^T d B of the 4x4 tile d of the input (column-major,
+   * with the given number of rows and columns) whose top left element is
+   * (row, col); elements outside of the input are zero.  Here
+   *
+   *   B^T = [1 0 -1 0; 0 1 1 0; 0 -1 1 0; 0 1 0 -1].
+   */
+  template<typename eT>
+  static void TransformInput(const eT* input,
+                             const size_t rows,
+                             const size_t cols,
+                             const size_t row,
+                             const size_t col,
+                             eT* v)
+  {
+    eT d[16];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      for (size_t r = 0; r < 4; ++r)
+      {
+        d[r + 4 * c] = (row + r < rows && col + c < cols) ?
+            input[(col + c) * rows + row + r] : eT(0);
+      }
+    }
+
+    // t = B^T d.
+    eT t[16];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      const eT* x = d + 4 * c;
+      t[4 * c] = x[0] - x[2];
+      t[4 * c + 1] = x[1] + x[2];
+      t[4 * c + 2] = x[2] - x[1];
+      t[4 * c + 3] = x[1] - x[3];
+    }
+
+    // v = t B.
+    for (size_t r = 0; r < 4; ++r)
+    {
+      v[r] = t[r] - t[r + 8];
+      v[r + 4] = t[r + 4] + t[r + 8];
+      v[r + 8] = t[r + 8] - t[r + 4];
+      v[r + 12] = t[r + 4] - t[r + 12];
+    }
+  }
+
+  /**
+   * Add the transform A^T m A of the 4x4 products m to the 2x2 tile of the
+   * output (column-major, with the given number of rows and columns) whose top
+   * left element is (row, col); elements outside of the output are ignored.
+   * Here
+   *
+   *   A^T = [1 1 1 0; 0 1 -1 -1].
+   */
+  template<typename eT>
+  static void TransformOutput(const eT* m,
+                              eT* output,
+                              const size_t rows,
+                              const size_t cols,
+                              const size_t row,
+                              const size_t col)
+  {
+    // s = A^T m, a 2x4 matrix.
+    eT s[8];
+    for (size_t c = 0; c < 4; ++c)
+    {
+      const eT* x = m + 4 * c;
+      s[2 * c] = x[0] + x[1] + x[2];
+      s[2 * c + 1] = x[1] - x[2] - x[3];
+    }
+
+    // y = s A, a 2x2 matrix.
+    for (size_t r = 0; r < 2; ++r)
+    {
+      if (row + r >= rows)
+        continue;
+
+      output[col * rows + row + r] += s[r] + s[r + 2] + s[r + 4];
+      if (col + 1 < cols)
+        output[(col + 1) * rows + row + r] += s[r + 2] - s[r + 4] - s[r + 6];
+    }
+  }
+};  // class WinogradConvolution
+
+} // namespace mlpack
+
+#endif
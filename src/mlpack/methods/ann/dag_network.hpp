@@ -0,0 +1,549 @@
+/**
+ * @file methods/ann/dag_network.hpp
+ *
+ * Definition of the DAGNetwork class, which implements neural networks whose
+ * layers form a directed acyclic graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DAG_NETWORK_HPP
+#define MLPACK_METHODS_ANN_DAG_NETWORK_HPP
+
+#include <mlpack/core.hpp>
+
+#include "init_rules/init_rules.hpp"
+#include "loss_functions/loss_functions.hpp"
+#include "layer/layer.hpp"
+
+#include <ensmallen.hpp>
+
+namespace mlpack {
+
+/**
+ * Implementation of a neural network whose layers are connected as a directed
+ * acyclic graph, instead of the chain of an `FFN`.  This allows models with
+ * several branches (like two-tower models, or residual connections) without
+ * wrapping the branches in `Concat` or `AddMerge` layers.
+ *
+ * Layers are added with `Add()`, which returns the index of the layer, and
+ * connected with `Connect(parent, child)`.  The layers without parents get the
+ * input of the network, and exactly one layer (the output layer of the graph)
+ * may have no children.  If a layer has several parents, their outputs are
+ * concatenated (in the order of the `Connect()` calls) to form its input, or
+ * summed, if `SumInputs()` is set for the layer.
+ *
+ * @code
+ * // Two towers on the same input, merged by a linear layer.
+ * DAGNetwork<> model;
+ * const size_t a = model.Add<Linear>(16);
+ * const size_t aRelu = model.Add<ReLU>();
+ * const size_t b = model.Add<Linear>(16);
+ * const size_t bRelu = model.Add<ReLU>();
+ * const size_t merge = model.Add<Linear>(3);
+ * const size_t out = model.Add<LogSoftMax>();
+ * model.Connect(a, aRelu);
+ * model.Connect(b, bRelu);
+ * model.Connect(aRelu, merge);
+ * model.Connect(bRelu, merge);
+ * model.Connect(merge, out);
+ * @endcode
+ *
+ * During `Forward()` and `Backward()`, each layer runs as an OpenMP task as
+ * soon as the layers it depends on are done, so independent branches run at
+ * the same time (see `BranchThreads()`).  The intermediate matrices are
+ * assigned to a set of buffers before the first pass: a buffer is given to a
+ * new matrix once every layer that reads its previous matrix is guaranteed to
+ * have run, so that no extra synchronization is needed.  The deltas of the
+ * backward pass always share buffers this way, and so do the outputs of the
+ * layers when no backward pass follows (in `Predict()` and `Evaluate()`).
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam MatType Type of matrix to be given as input to the network.
+ */
+template<
+    typename OutputLayerType = NegativeLogLikelihood,
+    typename InitializationRuleType = RandomInitialization,
+    typename MatType = arma::mat>
+class DAGNetwork
+{
+ public:
+  /**
+   * Create the DAGNetwork object.
+   *
+   * @param outputLayer Output layer used to evaluate the network.
+   * @param initializeRule Optional instantiated InitializationRule object
+   *        for initializing the network parameter.
+   */
+  DAGNetwork(OutputLayerType outputLayer = OutputLayerType(),
+             InitializationRuleType initializeRule = InitializationRuleType());
+
+  //! Copy constructor.
+  DAGNetwork(const DAGNetwork& other);
+  //! Move constructor.
+  DAGNetwork(DAGNetwork&& other);
+  //! Copy operator.
+  DAGNetwork& operator=(const DAGNetwork& other);
+  //! Move assignment operator.
+  DAGNetwork& operator=(DAGNetwork&& other);
+
+  //! Destroy the layers of the network.
+  ~DAGNetwork();
+
+  /**
+   * Add a new layer to the model, and return its index.  The layer is not
+   * connected to anything yet.
+   *
+   * @param args The layer parameter.
+   */
+  template<typename LayerType, typename... Args>
+  size_t Add(Args... args)
+  {
+    return Add(new LayerType(args...));
+  }
+
+  /**
+   * Add a new layer to the model, and return its index.  The network takes
+   * ownership of the layer, which must not be added twice.  Note that any
+   * trainable weights of this layer will be reset!
+   *
+   * @param layer The Layer to be added to the model.
+   */
+  size_t Add(Layer<MatType>* layer);
+
+  /**
+   * Make the output of the layer `parent` an input of the layer `child`.  An
+   * exception is thrown if the connection already exists or would create a
+   * cycle.
+   *
+   * @param parent Index of the layer whose output is used.
+   * @param child Index of the layer that uses the output.
+   */
+  void Connect(const size_t parent, const size_t child);
+
+  /**
+   * Set whether the outputs of the parents of the given layer are summed
+   * (`true`) instead of concatenated (`false`, the default) to form its input.
+   * The outputs of the parents must have the same size to be summed.
+   *
+   * @param layer Index of the layer.
+   * @param sum Whether to sum the inputs of the layer.
+   */
+  void SumInputs(const size_t layer, const bool sum = true);
+
+  //! Get whether the inputs of the given layer are summed.
+  bool SumInputs(const size_t layer) const { return sumInputs[layer]; }
+
+  //! Get the layers of the network, in the order they were added.
+  const std::vector<Layer<MatType>*>& Network() const { return network; }
+
+  //! Get the parents of the given layer.
+  const std::vector<size_t>& Parents(const size_t layer) const
+  {
+    return parents[layer];
+  }
+
+  //! Get the children of the given layer.
+  const std::vector<size_t>& Children(const size_t layer) const
+  {
+    return children[layer];
+  }
+
+  /**
+   * Get the number of threads that run independent layers at the same time.
+   */
+  size_t BranchThreads() const { return branchThreads; }
+  /**
+   * Modify the number of threads that run independent layers at the same time
+   * (0, the default, means as many as are available).  While several threads
+   * are used, BLAS is single-threaded, so that the layers don't compete for
+   * cores; for networks with few, large branches, 1 may be faster, since each
+   * layer then gets all the threads of BLAS.  Networks without branches always
+   * run their layers one after the other.
+   */
+  size_t& BranchThreads() { return branchThreads; }
+
+  /**
+   * Train the network on the given input data using the given optimizer.
+   *
+   * If no parameters have ever been set, or if their size does not match the
+   * number of weights needed for the current input size, the network will be
+   * initialized using `InitializationRuleType`.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(MatType predictors,
+                                    MatType responses,
+                                    OptimizerType& optimizer,
+                                    CallbackTypes&&... callbacks);
+
+  /**
+   * Train the network on the given input data, using the RMSProp optimizer by
+   * default.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(MatType predictors,
+                                    MatType responses,
+                                    CallbackTypes&&... callbacks);
+
+  /**
+   * Predict the responses to a given set of predictors.  The responses will be
+   * the output of the last layer of the graph.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 128);
+
+  //! Return the number of weights in the model.
+  size_t WeightSize();
+
+  /**
+   * Set the logical dimensions of the input.  This is given to each layer
+   * without parents; see `FFN::InputDimensions()`.
+   */
+  std::vector<size_t>& InputDimensions()
+  {
+    inputDimensionsAreSet = false;
+    return inputDimensions;
+  }
+  //! Get the logical dimensions of the input.
+  const std::vector<size_t>& InputDimensions() const { return inputDimensions; }
+
+  //! Return the current set of weights.  These are linearized: this contains
+  //! the weights of every layer, in the order the layers were added.
+  const MatType& Parameters() const { return parameters; }
+  //! Modify the current set of weights.
+  MatType& Parameters() { return parameters; }
+
+  /**
+   * Reset all weights of each layer using `InitializationRuleType`, and
+   * prepare the network to accept an input size of `inputDimensionality` (if
+   * passed), or whatever input size has been set with `InputDimensions()`.
+   */
+  void Reset(const size_t inputDimensionality = 0);
+
+  /**
+   * Set all the layers in the network to training mode, if `training` is
+   * `true`, or to testing mode, if `training` is `false`.
+   */
+  void SetNetworkMode(const bool training);
+
+  /**
+   * Perform a manual forward pass of the data.  The outputs of all layers are
+   * kept for a following call to `Backward()`.
+   *
+   * @param inputs The input data.
+   * @param results The predicted results.
+   */
+  void Forward(const MatType& inputs, MatType& results);
+
+  /**
+   * Perform a manual backward pass of the data, after `Forward()` was called
+   * with the same inputs.
+   *
+   * @param inputs Inputs of current pass.
+   * @param targets The training target.
+   * @param gradients Computed gradients.
+   * @return Training error of the current pass.
+   */
+  typename MatType::elem_type Backward(const MatType& inputs,
+                                       const MatType& targets,
+                                       MatType& gradients);
+
+  /**
+   * Evaluate the network with the given predictors and responses.
+   *
+   * @param predictors Input variables.
+   * @param responses Target outputs for input variables.
+   */
+  typename MatType::elem_type Evaluate(const MatType& predictors,
+                                       const MatType& responses);
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+  //
+  // Only ensmallen utility functions for training are found below here.
+  // They aren't generally useful otherwise.
+  //
+
+  /**
+   * Evaluate the network with the given parameters on all the points.
+   *
+   * @param parameters Matrix model parameters.
+   */
+  typename MatType::elem_type Evaluate(const MatType& parameters);
+
+  /**
+   * Evaluate the network with the given parameters, but using only a number
+   * of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  typename MatType::elem_type Evaluate(const MatType& parameters,
+                                       const size_t begin,
+                                       const size_t batchSize);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters on all
+   * the points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param gradient Matrix to output gradient into.
+   */
+  typename MatType::elem_type EvaluateWithGradient(const MatType& parameters,
+                                                   MatType& gradient);
+
+  /**
+   * Evaluate the network and its gradient with the given parameters, but
+   * using only a number of data points.
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  typename MatType::elem_type EvaluateWithGradient(const MatType& parameters,
+                                                   const size_t begin,
+                                                   MatType& gradient,
+                                                   const size_t batchSize);
+
+  /**
+   * Evaluate the gradient of the network with the given parameters, and with
+   * respect to only a number of points in the dataset.
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  //! Return the number of separable functions (the number of predictor
+  //! points).
+  size_t NumFunctions() const { return responses.n_cols; }
+
+  //! Shuffle the order of function visitation.
+  void Shuffle();
+
+  /**
+   * Prepare the network for training on the given data.
+   *
+   * @param predictors Input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(MatType predictors, MatType responses);
+
+ private:
+  /**
+   * The assignment of the matrices of a pass to buffers.  Each layer i may
+   * store two matrices: matrix 2i and matrix 2i + 1.
+   */
+  struct BufferPlan
+  {
+    //! The buffer of each matrix (SIZE_MAX if it isn't stored).
+    std::vector<size_t> buffer;
+    //! The number of rows (per point of the batch) of each matrix.
+    std::vector<size_t> rows;
+    //! The number of rows (per point of the batch) of each buffer.
+    std::vector<size_t> bufferRows;
+  };
+
+  /**
+   * Compute the order of the layers, the input dimensions of each layer, and
+   * the buffer plans of the passes.  This throws if the graph is invalid.
+   */
+  void UpdateDimensions(const std::string& functionName,
+                        const size_t inputDimensionality = 0);
+
+  /**
+   * Assign the matrices of a pass to buffers.  `predecessors[i][j]` is true if
+   * layer j always finishes its part of the pass before layer i starts.
+   * Matrix m is written by layer m / 2 and read by the layers in
+   * `readers[m]`, and has `rows[m]` rows per point (0 if it isn't stored).
+   * If `reuse` is false, each matrix gets its own buffer.
+   */
+  static void PlanBuffers(
+      const std::vector<size_t>& order,
+      const std::vector<std::vector<bool>>& predecessors,
+      const std::vector<std::vector<size_t>>& readers,
+      const std::vector<size_t>& rows,
+      const bool reuse,
+      BufferPlan& plan);
+
+  /**
+   * Make each matrix of the given plan an alias of its buffer, for the given
+   * batch size.  The buffers are enlarged if needed.
+   */
+  static void SetBuffers(const BufferPlan& plan,
+                         const size_t batchSize,
+                         std::vector<MatType>& buffers,
+                         std::vector<MatType>& first,
+                         std::vector<MatType>& second);
+
+  /**
+   * Run `task(i)` for each layer i, once `remaining[i]` of the layers before
+   * it are done; `next[i]` holds the layers after layer i.  If the network
+   * has branches, the tasks run in parallel.
+   */
+  template<typename TaskType>
+  void Schedule(const std::vector<size_t>& order,
+                const std::vector<std::vector<size_t>>& next,
+                std::vector<size_t> remaining,
+                const TaskType& task);
+
+  //! Run the task of layer i, and then the tasks of the layers that become
+  //! ready.
+  template<typename TaskType>
+  static void RunTask(const size_t i,
+                      const std::vector<std::vector<size_t>>& next,
+                      std::vector<size_t>& remaining,
+                      const TaskType& task,
+                      std::exception_ptr& exception);
+
+  //! Get the input of layer i (for layers with several parents, this must be
+  //! called after the parents are merged).
+  const MatType& LayerInput(const size_t i, const MatType& input) const;
+
+  /**
+   * Run the forward pass on the given input, and store the output of the
+   * network in `output`, which must have the right size.  If `keep` is true,
+   * the outputs of all layers are kept for the backward pass; otherwise, their
+   * buffers are shared.
+   */
+  void ForwardPass(const MatType& input, MatType& output, const bool keep);
+
+  //! Run the backward pass and compute the gradient with respect to the
+  //! parameters, after the forward pass on the same input.
+  void BackwardPass(const MatType& input, MatType& gradient);
+
+  //! Return the sum of the losses of the layers.
+  typename MatType::elem_type Loss() const;
+
+  //! Initialize the weights of the layers.
+  void InitializeWeights();
+
+  //! Make the weights of each layer alias `parameters`.
+  void SetLayerMemory();
+
+  //! Ensure that the network can be used on inputs of the given size.
+  void CheckNetwork(const std::string& functionName,
+                    const size_t inputDimensionality,
+                    const bool setMode = false,
+                    const bool training = false);
+
+  //! Instantiated output layer used to evaluate the network.
+  OutputLayerType outputLayer;
+
+  //! Instantiated InitializationRule object for initializing the network
+  //! parameter.
+  InitializationRuleType initializeRule;
+
+  //! The layers of the network.
+  std::vector<Layer<MatType>*> network;
+  //! The parents of each layer.
+  std::vector<std::vector<size_t>> parents;
+  //! The children of each layer.
+  std::vector<std::vector<size_t>> children;
+  //! Whether the inputs of each layer are summed instead of concatenated.
+  std::vector<bool> sumInputs;
+
+  //! The number of threads that run independent layers.
+  size_t branchThreads;
+
+  //! The current parameters of the network.
+  MatType parameters;
+
+  //! The input dimensions of the network.
+  std::vector<size_t> inputDimensions;
+
+  //! The matrix of data points (predictors).
+  MatType predictors;
+  //! The matrix of responses to the input data points.
+  MatType responses;
+
+  //! The layers in an order where each layer comes after its parents.
+  std::vector<size_t> order;
+  //! The index of the layer without children.
+  size_t sink;
+  //! Whether some layers can run at the same time.
+  bool hasBranches;
+  //! The row of the merged input of each layer where each parent starts.
+  std::vector<std::vector<size_t>> parentOffsets;
+
+  //! The plan of the forward pass when the outputs are kept.
+  BufferPlan keepPlan;
+  //! The plan of the forward pass when the outputs are not kept.
+  BufferPlan sharedPlan;
+  //! The plan of the backward pass.
+  BufferPlan backwardPlan;
+
+  //! The buffers of the forward pass.
+  std::vector<MatType> forwardBuffers;
+  //! The buffers of the backward pass.
+  std::vector<MatType> backwardBuffers;
+
+  //! The output of each layer (aliases of buffers).
+  std::vector<MatType> layerOutputs;
+  //! The merged input of each layer with several parents.
+  std::vector<MatType> layerInputs;
+  //! The delta with respect to the input of each layer.
+  std::vector<MatType> layerDeltas;
+  //! The delta with respect to the output of each layer with several
+  //! children.
+  std::vector<MatType> outputDeltas;
+  //! The gradient of each layer (aliases of the gradient).
+  std::vector<MatType> layerGradients;
+
+  //! The output of the network.
+  MatType networkOutput;
+  //! The error of the output layer.
+  MatType error;
+
+  //! Whether the layers point at the memory of `parameters`.
+  bool layerMemoryIsSet;
+  //! Whether the dimensions and plans of the network are up to date.
+  bool inputDimensionsAreSet;
+}; // class DAGNetwork
+
+} // namespace mlpack
+
+// Include implementation.
+#include "dag_network_impl.hpp"
+
+#endif
@@ -0,0 +1,1320 @@
+/**
+ * @file methods/ann/dag_network_impl.hpp
+ *
+ * Implementation of the DAGNetwork class, which implements neural networks
+ * whose layers form a directed acyclic graph.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DAG_NETWORK_IMPL_HPP
+#define MLPACK_METHODS_ANN_DAG_NETWORK_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dag_network.hpp"
+
+namespace mlpack {
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::DAGNetwork(OutputLayerType outputLayer,
+              InitializationRuleType initializeRule) :
+    outputLayer(std::move(outputLayer)),
+    initializeRule(std::move(initializeRule)),
+    branchThreads(0),
+    sink(0),
+    hasBranches(false),
+    layerMemoryIsSet(false),
+    inputDimensionsAreSet(false)
+{
+  /* Nothing to do here. */
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::DAGNetwork(const DAGNetwork& other) :
+    outputLayer(other.outputLayer),
+    initializeRule(other.initializeRule),
+    parents(other.parents),
+    children(other.children),
+    sumInputs(other.sumInputs),
+    branchThreads(other.branchThreads),
+    parameters(other.parameters),
+    inputDimensions(other.inputDimensions),
+    predictors(other.predictors),
+    responses(other.responses),
+    sink(0),
+    hasBranches(false),
+    // These will be set correctly in the first Forward() call.
+    layerMemoryIsSet(false),
+    inputDimensionsAreSet(false)
+{
+  for (size_t i = 0; i < other.network.size(); ++i)
+    network.push_back(other.network[i]->Clone());
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::DAGNetwork(DAGNetwork&& other) :
+    outputLayer(std::move(other.outputLayer)),
+    initializeRule(std::move(other.initializeRule)),
+    network(std::move(other.network)),
+    parents(std::move(other.parents)),
+    children(std::move(other.children)),
+    sumInputs(std::move(other.sumInputs)),
+    branchThreads(other.branchThreads),
+    parameters(std::move(other.parameters)),
+    inputDimensions(std::move(other.inputDimensions)),
+    predictors(std::move(other.predictors)),
+    responses(std::move(other.responses)),
+    sink(0),
+    hasBranches(false),
+    // Aliases will not be correct after a std::move(), so we will manually
+    // reset them.
+    layerMemoryIsSet(false),
+    inputDimensionsAreSet(false)
+{
+  other.network.clear();
+  other.parents.clear();
+  other.children.clear();
+  other.sumInputs.clear();
+  other.inputDimensionsAreSet = false;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+DAGNetwork<OutputLayerType, InitializationRuleType, MatType>& DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::operator=(const DAGNetwork& other)
+{
+  if (this != &other)
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+      delete network[i];
+    network.clear();
+    for (size_t i = 0; i < other.network.size(); ++i)
+      network.push_back(other.network[i]->Clone());
+
+    outputLayer = other.outputLayer;
+    initializeRule = other.initializeRule;
+    parents = other.parents;
+    children = other.children;
+    sumInputs = other.sumInputs;
+    branchThreads = other.branchThreads;
+    parameters = other.parameters;
+    inputDimensions = other.inputDimensions;
+    predictors = other.predictors;
+    responses = other.responses;
+
+    // Copying will not preserve Armadillo aliases correctly, so we will reset
+    // those.
+    layerMemoryIsSet = false;
+    inputDimensionsAreSet = false;
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+DAGNetwork<OutputLayerType, InitializationRuleType, MatType>& DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::operator=(DAGNetwork&& other)
+{
+  if (this != &other)
+  {
+    for (size_t i = 0; i < network.size(); ++i)
+      delete network[i];
+
+    outputLayer = std::move(other.outputLayer);
+    initializeRule = std::move(other.initializeRule);
+    network = std::move(other.network);
+    parents = std::move(other.parents);
+    children = std::move(other.children);
+    sumInputs = std::move(other.sumInputs);
+    branchThreads = other.branchThreads;
+    parameters = std::move(other.parameters);
+    inputDimensions = std::move(other.inputDimensions);
+    predictors = std::move(other.predictors);
+    responses = std::move(other.responses);
+    layerMemoryIsSet = false;
+    inputDimensionsAreSet = false;
+
+    other.network.clear();
+    other.parents.clear();
+    other.children.clear();
+    other.sumInputs.clear();
+    other.inputDimensionsAreSet = false;
+  }
+
+  return *this;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::~DAGNetwork()
+{
+  for (size_t i = 0; i < network.size(); ++i)
+    delete network[i];
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+size_t DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Add(Layer<MatType>* layer)
+{
+  network.push_back(layer);
+  parents.push_back(std::vector<size_t>());
+  children.push_back(std::vector<size_t>());
+  sumInputs.push_back(false);
+  inputDimensionsAreSet = false;
+
+  return network.size() - 1;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Connect(const size_t parent, const size_t child)
+{
+  if (parent >= network.size() || child >= network.size())
+  {
+    throw std::invalid_argument("DAGNetwork::Connect(): invalid layer index!");
+  }
+
+  if (std::find(children[parent].begin(), children[parent].end(), child) !=
+      children[parent].end())
+  {
+    throw std::invalid_argument("DAGNetwork::Connect(): the layers are "
+        "already connected!");
+  }
+
+  // The connection creates a cycle if the parent can be reached from the
+  // child.
+  std::vector<bool> visited(network.size(), false);
+  std::vector<size_t> stack(1, child);
+  visited[child] = true;
+  while (!stack.empty())
+  {
+    const size_t i = stack.back();
+    stack.pop_back();
+    if (i == parent)
+    {
+      throw std::invalid_argument("DAGNetwork::Connect(): the connection "
+          "would create a cycle!");
+    }
+
+    for (size_t c : children[i])
+    {
+      if (!visited[c])
+      {
+        visited[c] = true;
+        stack.push_back(c);
+      }
+    }
+  }
+
+  parents[child].push_back(parent);
+  children[parent].push_back(child);
+  inputDimensionsAreSet = false;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SumInputs(const size_t layer, const bool sum)
+{
+  if (layer >= network.size())
+  {
+    throw std::invalid_argument("DAGNetwork::SumInputs(): invalid layer "
+        "index!");
+  }
+
+  sumInputs[layer] = sum;
+  inputDimensionsAreSet = false;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(MatType predictors,
+         MatType responses,
+         OptimizerType& optimizer,
+         CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Ensure that the network can be used.
+  CheckNetwork("DAGNetwork::Train()", this->predictors.n_rows, true, true);
+
+  // Train the model.
+  Timer::Start("dag_network_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(*this, parameters, callbacks...);
+  Timer::Stop("dag_network_optimization");
+
+  Log::Info << "DAGNetwork::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(MatType predictors,
+         MatType responses,
+         CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer,
+      callbacks...);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(const MatType& predictors, MatType& results, const size_t batchSize)
+{
+  // Ensure that the network is configured correctly.
+  CheckNetwork("DAGNetwork::Predict()", predictors.n_rows, true, false);
+
+  results.set_size(network[sink]->OutputSize(), predictors.n_cols);
+
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    MatType predictorAlias, resultAlias;
+    MakeAlias(predictorAlias, predictors, predictors.n_rows,
+        effectiveBatchSize, i * predictors.n_rows);
+    MakeAlias(resultAlias, results, results.n_rows, effectiveBatchSize,
+        i * results.n_rows);
+
+    ForwardPass(predictorAlias, resultAlias, false);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+size_t DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::WeightSize()
+{
+  // If the input dimensions have not yet been propagated to the network, we
+  // must do that now.
+  if (!inputDimensionsAreSet)
+    UpdateDimensions("DAGNetwork::WeightSize()");
+
+  size_t total = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    total += network[i]->WeightSize();
+  return total;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Reset(const size_t inputDimensionality)
+{
+  parameters.clear();
+
+  if (inputDimensionality != 0)
+  {
+    CheckNetwork("DAGNetwork::Reset()", inputDimensionality, true, false);
+  }
+  else if (inputDimensions.size() > 0)
+  {
+    size_t inputDim = inputDimensions[0];
+    for (size_t i = 1; i < inputDimensions.size(); i++)
+      inputDim *= inputDimensions[i];
+    CheckNetwork("DAGNetwork::Reset()", inputDim, true, false);
+  }
+  else
+  {
+    throw std::invalid_argument("DAGNetwork::Reset(): cannot reset network "
+        "when no input dimensionality is given, and `InputDimensions()` has "
+        "not been set!");
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SetNetworkMode(const bool training)
+{
+  for (size_t i = 0; i < network.size(); ++i)
+    network[i]->Training() = training;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Forward(const MatType& inputs, MatType& results)
+{
+  // Ensure the network is valid.
+  CheckNetwork("DAGNetwork::Forward()", inputs.n_rows);
+
+  // The outputs of all layers are kept in case we do a backward pass.
+  networkOutput.set_size(network[sink]->OutputSize(), inputs.n_cols);
+  ForwardPass(inputs, networkOutput, true);
+
+  // It's possible the user passed `networkOutput` as `results`.
+  if (&results != &networkOutput)
+    results = networkOutput;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Backward(const MatType& inputs,
+            const MatType& targets,
+            MatType& gradients)
+{
+  const typename MatType::elem_type res =
+      outputLayer.Forward(networkOutput, targets) + Loss();
+
+  // Compute the error of the output layer.
+  outputLayer.Backward(networkOutput, targets, error);
+
+  // The gradient should have the same size as the parameters.
+  gradients.set_size(parameters.n_rows, parameters.n_cols);
+  BackwardPass(inputs, gradients);
+
+  return res;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(const MatType& predictors, const MatType& responses)
+{
+  // Sanity check: ensure network is valid.
+  CheckNetwork("DAGNetwork::Evaluate()", predictors.n_rows);
+
+  networkOutput.set_size(network[sink]->OutputSize(), predictors.n_cols);
+  ForwardPass(predictors, networkOutput, false);
+
+  return outputLayer.Forward(networkOutput, responses) + Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename Archive>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  #if !defined(MLPACK_ENABLE_ANN_SERIALIZATION) && \
+      !defined(MLPACK_ANN_IGNORE_SERIALIZATION_WARNING)
+    // See FFN::serialize() for more information.
+    throw std::runtime_error("Cannot serialize a neural network unless "
+        "MLPACK_ENABLE_ANN_SERIALIZATION is defined!  See the \"Additional "
+        "build options\" section of the README for more information.");
+
+    (void) ar;
+  #else
+    ar(CEREAL_NVP(outputLayer));
+    ar(CEREAL_NVP(initializeRule));
+
+    // Any layers we hold will be replaced.
+    if (cereal::is_loading<Archive>())
+    {
+      for (size_t i = 0; i < network.size(); ++i)
+        delete network[i];
+      network.clear();
+    }
+
+    // Serialize the layers and their connections; the children are the same
+    // connections, so they are recomputed.
+    ar(CEREAL_VECTOR_POINTER(network));
+    ar(CEREAL_NVP(parents));
+    ar(CEREAL_NVP(sumInputs));
+    ar(CEREAL_NVP(branchThreads));
+    ar(CEREAL_NVP(parameters));
+    ar(CEREAL_NVP(inputDimensions));
+
+    if (cereal::is_loading<Archive>())
+    {
+      children.clear();
+      children.resize(network.size());
+      for (size_t i = 0; i < parents.size(); ++i)
+        for (size_t p : parents[i])
+          children[p].push_back(i);
+
+      predictors.clear();
+      responses.clear();
+      networkOutput.clear();
+
+      layerMemoryIsSet = false;
+      inputDimensionsAreSet = false;
+    }
+  #endif
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(const MatType& parameters)
+{
+  typename MatType::elem_type res = 0;
+  for (size_t i = 0; i < NumFunctions(); ++i)
+    res += Evaluate(parameters, i, 1);
+
+  return res;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(const MatType& /* parameters */,
+            const size_t begin,
+            const size_t batchSize)
+{
+  CheckNetwork("DAGNetwork::Evaluate()", predictors.n_rows);
+
+  MatType predictorsBatch, responsesBatch;
+  MakeAlias(predictorsBatch, predictors, predictors.n_rows, batchSize,
+      begin * predictors.n_rows);
+  MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
+      begin * responses.n_rows);
+
+  networkOutput.set_size(network[sink]->OutputSize(), batchSize);
+  ForwardPass(predictorsBatch, networkOutput, false);
+
+  return outputLayer.Forward(networkOutput, responsesBatch) + Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::EvaluateWithGradient(const MatType& parameters, MatType& gradient)
+{
+  typename MatType::elem_type res = 0;
+  res += EvaluateWithGradient(parameters, 0, gradient, 1);
+  MatType tmpGradient(gradient.n_rows, gradient.n_cols,
+      GetFillType<MatType>::none);
+  for (size_t i = 1; i < NumFunctions(); ++i)
+  {
+    res += EvaluateWithGradient(parameters, i, tmpGradient, 1);
+    gradient += tmpGradient;
+  }
+
+  return res;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::EvaluateWithGradient(const MatType& parameters,
+                        const size_t begin,
+                        MatType& gradient,
+                        const size_t batchSize)
+{
+  CheckNetwork("DAGNetwork::EvaluateWithGradient()", predictors.n_rows);
+
+  // Alias the batches so we don't copy memory.
+  MatType predictorsBatch, responsesBatch;
+  MakeAlias(predictorsBatch, predictors, predictors.n_rows, batchSize,
+      begin * predictors.n_rows);
+  MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
+      begin * responses.n_rows);
+
+  networkOutput.set_size(network[sink]->OutputSize(), batchSize);
+  ForwardPass(predictorsBatch, networkOutput, true);
+
+  const typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
+      responsesBatch) + Loss();
+
+  // Now perform the backward pass, which also computes the gradient.
+  outputLayer.Backward(networkOutput, responsesBatch, error);
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  BackwardPass(predictorsBatch, gradient);
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(const MatType& parameters,
+            const size_t begin,
+            MatType& gradient,
+            const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Shuffle()
+{
+  ShuffleData(predictors, responses, predictors, responses);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetData(MatType predictors, MatType responses)
+{
+  this->predictors = std::move(predictors);
+  this->responses = std::move(responses);
+
+  // Set the network to training mode.
+  SetNetworkMode(true);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::UpdateDimensions(const std::string& functionName,
+                    const size_t inputDimensionality)
+{
+  if (network.size() == 0)
+  {
+    throw std::invalid_argument(functionName + ": cannot use network with no "
+        "layers!");
+  }
+
+  // If the input dimensions are completely unset, then assume our input is
+  // flat.
+  if (inputDimensions.size() == 0)
+    inputDimensions = { inputDimensionality };
+
+  size_t totalInputSize = 1;
+  for (size_t i = 0; i < inputDimensions.size(); ++i)
+    totalInputSize *= inputDimensions[i];
+
+  if (totalInputSize != inputDimensionality && inputDimensionality != 0)
+  {
+    throw std::logic_error(functionName + ": input size does not match expected"
+        " size set with InputDimensions()!");
+  }
+
+  // Sort the layers so that each layer comes after its parents.  Connect()
+  // never creates cycles, but the connections may have been loaded.
+  const size_t n = network.size();
+  std::vector<size_t> remaining(n);
+  order.clear();
+  for (size_t i = 0; i < n; ++i)
+  {
+    remaining[i] = parents[i].size();
+    if (remaining[i] == 0)
+      order.push_back(i);
+  }
+  const size_t roots = order.size();
+  for (size_t k = 0; k < order.size(); ++k)
+    for (size_t c : children[order[k]])
+      if (--remaining[c] == 0)
+        order.push_back(c);
+
+  if (order.size() != n)
+  {
+    throw std::invalid_argument(functionName + ": the connections of the "
+        "layers form a cycle!");
+  }
+
+  sink = SIZE_MAX;
+  hasBranches = (roots > 1);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (children[i].size() > 1)
+      hasBranches = true;
+
+    if (children[i].empty())
+    {
+      if (sink != SIZE_MAX)
+      {
+        throw std::invalid_argument(functionName + ": exactly one layer of the"
+            " network must have no children!");
+      }
+      sink = i;
+    }
+  }
+
+  // Propagate the input dimensions through the graph.  The outputs of several
+  // parents are concatenated along their last dimension if the other
+  // dimensions are the same, and flattened and stacked otherwise.
+  std::vector<size_t> inputRows(n);
+  parentOffsets.assign(n, std::vector<size_t>());
+  for (size_t k = 0; k < n; ++k)
+  {
+    const size_t i = order[k];
+    std::vector<size_t> dims;
+    if (parents[i].size() == 0)
+    {
+      dims = inputDimensions;
+    }
+    else
+    {
+      dims = network[parents[i][0]]->OutputDimensions();
+      size_t rows = 0;
+      bool sameShape = true;
+      for (size_t p : parents[i])
+      {
+        const std::vector<size_t>& parentDims = network[p]->OutputDimensions();
+        const size_t parentRows = network[p]->OutputSize();
+        if (sumInputs[i] && parentRows != network[parents[i][0]]->OutputSize())
+        {
+          throw std::invalid_argument(functionName + ": the outputs of the "
+              "parents of layer " + std::to_string(i) + " can't be summed, "
+              "since their sizes differ!");
+        }
+
+        sameShape = sameShape && (dims.size() > 0) &&
+            (parentDims.size() == dims.size()) &&
+            std::equal(dims.begin(), dims.end() - 1, parentDims.begin());
+        parentOffsets[i].push_back(sumInputs[i] ? 0 : rows);
+        if (!sumInputs[i])
+          rows += parentRows;
+      }
+
+      if (parents[i].size() > 1 && !sumInputs[i])
+      {
+        if (sameShape)
+        {
+          dims.back() = 0;
+          for (size_t p : parents[i])
+            dims.back() += network[p]->OutputDimensions().back();
+        }
+        else
+        {
+          dims = { rows };
+        }
+      }
+    }
+
+    network[i]->InputDimensions() = dims;
+    inputRows[i] = 1;
+    for (size_t d = 0; d < dims.size(); ++d)
+      inputRows[i] *= dims[d];
+  }
+
+  // predecessors[i][j] is true when layer j is done before layer i starts:
+  // for the forward pass, when j is an ancestor of i; for the backward pass,
+  // when j is a descendant of i.
+  std::vector<std::vector<bool>> forwardPredecessors(n,
+      std::vector<bool>(n, false));
+  std::vector<std::vector<bool>> backwardPredecessors(n,
+      std::vector<bool>(n, false));
+  for (size_t k = 0; k < n; ++k)
+  {
+    const size_t i = order[k];
+    for (size_t p : parents[i])
+    {
+      for (size_t j = 0; j < n; ++j)
+        if (forwardPredecessors[p][j])
+          forwardPredecessors[i][j] = true;
+      forwardPredecessors[i][p] = true;
+    }
+
+    const size_t r = order[n - 1 - k];
+    for (size_t c : children[r])
+    {
+      for (size_t j = 0; j < n; ++j)
+        if (backwardPredecessors[c][j])
+          backwardPredecessors[r][j] = true;
+      backwardPredecessors[r][c] = true;
+    }
+  }
+
+  // In the forward pass, layer i writes its output (matrix 2i), which its
+  // children read, and the merged input of its parents (matrix 2i + 1), which
+  // only it reads.  The output of the sink is the output of the network.
+  std::vector<std::vector<size_t>> readers(2 * n);
+  std::vector<size_t> rows(2 * n, 0);
+  for (size_t i = 0; i < n; ++i)
+  {
+    readers[2 * i] = children[i];
+    if (i != sink)
+      rows[2 * i] = network[i]->OutputSize();
+    readers[2 * i + 1] = { i };
+    if (parents[i].size() > 1)
+      rows[2 * i + 1] = inputRows[i];
+  }
+  PlanBuffers(order, forwardPredecessors, readers, rows, false, keepPlan);
+  PlanBuffers(order, forwardPredecessors, readers, rows, true, sharedPlan);
+
+  // In the backward pass, layer i writes the delta with respect to its input
+  // (matrix 2i), which its parents read, and the delta with respect to its
+  // output (matrix 2i + 1), which only it reads.  The latter is only stored
+  // if it is not simply the delta of its only child.
+  const std::vector<size_t> reverseOrder(order.rbegin(), order.rend());
+  for (size_t i = 0; i < n; ++i)
+  {
+    readers[2 * i] = parents[i];
+    rows[2 * i] = inputRows[i];
+    readers[2 * i + 1] = { i };
+    rows[2 * i + 1] = 0;
+    if (i != sink)
+    {
+      const size_t c = children[i][0];
+      if (children[i].size() > 1 || (parents[c].size() > 1 && !sumInputs[c]))
+        rows[2 * i + 1] = network[i]->OutputSize();
+    }
+  }
+  PlanBuffers(reverseOrder, backwardPredecessors, readers, rows, true,
+      backwardPlan);
+
+  layerOutputs.resize(n);
+  layerInputs.resize(n);
+  layerDeltas.resize(n);
+  outputDeltas.resize(n);
+  layerGradients.resize(n);
+
+  inputDimensionsAreSet = true;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PlanBuffers(const std::vector<size_t>& order,
+               const std::vector<std::vector<bool>>& predecessors,
+               const std::vector<std::vector<size_t>>& readers,
+               const std::vector<size_t>& rows,
+               const bool reuse,
+               BufferPlan& plan)
+{
+  plan.buffer.assign(rows.size(), SIZE_MAX);
+  plan.rows = rows;
+  plan.bufferRows.clear();
+
+  // The matrix that last used each buffer.
+  std::vector<size_t> owners;
+  for (size_t k = 0; k < order.size(); ++k)
+  {
+    const size_t i = order[k];
+    for (size_t m = 2 * i; m < 2 * i + 2; ++m)
+    {
+      if (rows[m] == 0)
+        continue;
+
+      // A buffer is free for layer i if the layers that wrote and read its
+      // last matrix are all done before layer i starts.  Of the free buffers,
+      // take the smallest one that is large enough, or else the largest one.
+      size_t best = SIZE_MAX;
+      for (size_t b = 0; reuse && b < owners.size(); ++b)
+      {
+        const size_t owner = owners[b];
+        bool free = predecessors[i][owner / 2];
+        for (size_t r = 0; r < readers[owner].size() && free; ++r)
+          free = predecessors[i][readers[owner][r]];
+        if (!free)
+          continue;
+
+        if (best == SIZE_MAX)
+        {
+          best = b;
+          continue;
+        }
+
+        const bool fits = (plan.bufferRows[b] >= rows[m]);
+        const bool bestFits = (plan.bufferRows[best] >= rows[m]);
+        if ((fits && (!bestFits ||
+             plan.bufferRows[b] < plan.bufferRows[best])) ||
+            (!fits && !bestFits && plan.bufferRows[b] > plan.bufferRows[best]))
+        {
+          best = b;
+        }
+      }
+
+      if (best == SIZE_MAX)
+      {
+        best = owners.size();
+        owners.push_back(m);
+        plan.bufferRows.push_back(0);
+      }
+
+      owners[best] = m;
+      plan.bufferRows[best] = std::max(plan.bufferRows[best], rows[m]);
+      plan.buffer[m] = best;
+    }
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SetBuffers(const BufferPlan& plan,
+              const size_t batchSize,
+              std::vector<MatType>& buffers,
+              std::vector<MatType>& first,
+              std::vector<MatType>& second)
+{
+  if (buffers.size() < plan.bufferRows.size())
+    buffers.resize(plan.bufferRows.size());
+  for (size_t b = 0; b < plan.bufferRows.size(); ++b)
+  {
+    if (buffers[b].n_elem < plan.bufferRows[b] * batchSize)
+      buffers[b].set_size(plan.bufferRows[b] * batchSize, 1);
+  }
+
+  for (size_t m = 0; m < plan.buffer.size(); ++m)
+  {
+    if (plan.buffer[m] == SIZE_MAX)
+      continue;
+
+    MatType& alias = (m % 2 == 0) ? first[m / 2] : second[m / 2];
+    MakeAlias(alias, buffers[plan.buffer[m]], plan.rows[m], batchSize);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename TaskType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Schedule(const std::vector<size_t>& order,
+            const std::vector<std::vector<size_t>>& next,
+            std::vector<size_t> remaining,
+            const TaskType& task)
+{
+  if (!hasBranches || branchThreads == 1)
+  {
+    for (size_t k = 0; k < order.size(); ++k)
+      task(order[k]);
+    return;
+  }
+
+  // BLAS is single-threaded while the layers run in parallel.
+  ThreadBudget budget(branchThreads);
+  if (budget.NumThreads() == 1)
+  {
+    for (size_t k = 0; k < order.size(); ++k)
+      task(order[k]);
+    return;
+  }
+
+  // The layers that are ready at the start must be found before any task
+  // runs, since the tasks change `remaining`.
+  std::vector<size_t> ready;
+  for (size_t k = 0; k < order.size(); ++k)
+    if (remaining[order[k]] == 0)
+      ready.push_back(order[k]);
+
+  std::exception_ptr exception;
+  #pragma omp parallel
+  {
+    #pragma omp single
+    {
+      for (size_t k = 0; k < ready.size(); ++k)
+        RunTask(ready[k], next, remaining, task, exception);
+    }
+  }
+
+  if (exception)
+    std::rethrow_exception(exception);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename TaskType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::RunTask(const size_t i,
+           const std::vector<std::vector<size_t>>& next,
+           std::vector<size_t>& remaining,
+           const TaskType& task,
+           std::exception_ptr& exception)
+{
+  // The task gets pointers, since references would be copied into it.
+  const std::vector<std::vector<size_t>>* nextPtr = &next;
+  std::vector<size_t>* remainingPtr = &remaining;
+  const TaskType* taskPtr = &task;
+  std::exception_ptr* exceptionPtr = &exception;
+
+  #pragma omp task firstprivate(i, nextPtr, remainingPtr, taskPtr, \
+      exceptionPtr)
+  {
+    // An exception can't leave a task, so the first one is thrown after the
+    // pass.
+    try
+    {
+      (*taskPtr)(i);
+    }
+    catch (...)
+    {
+      #pragma omp critical(DAGNetworkException)
+      {
+        if (!*exceptionPtr)
+          *exceptionPtr = std::current_exception();
+      }
+    }
+
+    // Start the layers that don't wait for any other layer anymore.
+    for (size_t c : (*nextPtr)[i])
+    {
+      size_t left;
+      #pragma omp atomic capture
+      left = --(*remainingPtr)[c];
+
+      if (left == 0)
+        RunTask(c, *nextPtr, *remainingPtr, *taskPtr, *exceptionPtr);
+    }
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+const MatType& DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::LayerInput(const size_t i, const MatType& input) const
+{
+  if (parents[i].size() == 0)
+    return input;
+  else if (parents[i].size() == 1)
+    return layerOutputs[parents[i][0]];
+  else
+    return layerInputs[i];
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ForwardPass(const MatType& input, MatType& output, const bool keep)
+{
+  SetBuffers(keep ? keepPlan : sharedPlan, input.n_cols, forwardBuffers,
+      layerOutputs, layerInputs);
+  MakeAlias(layerOutputs[sink], output, output.n_rows, output.n_cols);
+
+  std::vector<size_t> remaining(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+    remaining[i] = parents[i].size();
+
+  Schedule(order, children, remaining, [&](const size_t i)
+  {
+    // Merge the outputs of the parents, if there are several.
+    if (parents[i].size() > 1)
+    {
+      MatType& merged = layerInputs[i];
+      for (size_t k = 0; k < parents[i].size(); ++k)
+      {
+        const MatType& parentOutput = layerOutputs[parents[i][k]];
+        if (!sumInputs[i])
+        {
+          merged.rows(parentOffsets[i][k], parentOffsets[i][k] +
+              parentOutput.n_rows - 1) = parentOutput;
+        }
+        else if (k == 0)
+        {
+          merged = parentOutput;
+        }
+        else
+        {
+          merged += parentOutput;
+        }
+      }
+    }
+
+    network[i]->Forward(LayerInput(i, input), layerOutputs[i]);
+  });
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::BackwardPass(const MatType& input, MatType& gradient)
+{
+  SetBuffers(backwardPlan, input.n_cols, backwardBuffers, layerDeltas,
+      outputDeltas);
+
+  // Each layer writes its own part of the gradient.
+  size_t start = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weightSize = network[i]->WeightSize();
+    MakeAlias(layerGradients[i], gradient, weightSize, 1, start);
+    start += weightSize;
+  }
+
+  std::vector<size_t> remaining(network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+    remaining[i] = children[i].size();
+  const std::vector<size_t> reverseOrder(order.rbegin(), order.rend());
+
+  Schedule(reverseOrder, parents, remaining, [&](const size_t i)
+  {
+    // The delta with respect to the output of the layer is the sum of the
+    // parts of the deltas of its children that correspond to it.
+    const MatType* gy = &error;
+    if (i != sink)
+    {
+      const size_t c = children[i][0];
+      if (children[i].size() == 1 && (parents[c].size() == 1 || sumInputs[c]))
+      {
+        gy = &layerDeltas[c];
+      }
+      else
+      {
+        MatType& delta = outputDeltas[i];
+        for (size_t k = 0; k < children[i].size(); ++k)
+        {
+          const size_t child = children[i][k];
+          const size_t index = std::find(parents[child].begin(),
+              parents[child].end(), i) - parents[child].begin();
+          const size_t offset = parentOffsets[child][index];
+          if (k == 0)
+            delta = layerDeltas[child].rows(offset, offset + delta.n_rows - 1);
+          else
+            delta += layerDeltas[child].rows(offset, offset + delta.n_rows - 1);
+        }
+        gy = &delta;
+      }
+    }
+
+    const MatType& layerInput = LayerInput(i, input);
+    network[i]->Backward(layerInput, layerOutputs[i], *gy, layerDeltas[i]);
+    network[i]->Gradient(layerInput, *gy, layerGradients[i]);
+  });
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Loss() const
+{
+  typename MatType::elem_type loss = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    loss += network[i]->Loss();
+  return loss;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::InitializeWeights()
+{
+  // Reset the network parameters with the given initialization rule.
+  NetworkInitialization<InitializationRuleType> networkInit(initializeRule);
+  networkInit.Initialize(network, parameters);
+
+  // Override the weight matrix of each layer if necessary.
+  size_t start = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weightSize = network[i]->WeightSize();
+    MatType weights;
+    MakeAlias(weights, parameters, weightSize, 1, start);
+    network[i]->CustomInitialize(weights, weightSize);
+    start += weightSize;
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SetLayerMemory()
+{
+  size_t start = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const size_t weightSize = network[i]->WeightSize();
+    Log::Assert(start + weightSize <= parameters.n_elem,
+        "DAGNetwork::SetLayerMemory(): parameter size does not match total "
+        "layer weight size!");
+
+    MatType weights;
+    MakeAlias(weights, parameters, weightSize, 1, start);
+    network[i]->SetWeights(weights);
+    start += weightSize;
+  }
+
+  Log::Assert(start == parameters.n_elem,
+      "DAGNetwork::SetLayerMemory(): total layer weight size does not match "
+      "parameter size!");
+  layerMemoryIsSet = true;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void DAGNetwork<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::CheckNetwork(const std::string& functionName,
+                const size_t inputDimensionality,
+                const bool setMode,
+                const bool training)
+{
+  // Check the graph and the input dimensions of each layer, and plan the
+  // buffers of the passes.
+  if (!inputDimensionsAreSet)
+  {
+    UpdateDimensions(functionName, inputDimensionality);
+    layerMemoryIsSet = false;
+  }
+
+  // We may need to initialize the `parameters` matrix if it is empty or the
+  // wrong size.
+  size_t weightSize = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    weightSize += network[i]->WeightSize();
+  if (parameters.n_elem != weightSize)
+  {
+    parameters.clear();
+    InitializeWeights();
+    layerMemoryIsSet = false;
+  }
+
+  // Make sure each layer is pointing at the right memory.
+  if (!layerMemoryIsSet)
+    SetLayerMemory();
+
+  if (setMode)
+    SetNetworkMode(training);
+}
+
+} // namespace mlpack
+
+#endif
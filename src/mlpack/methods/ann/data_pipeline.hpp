@@ -0,0 +1,199 @@
+/**
+ * @file methods/ann/data_pipeline.hpp
+ *
+ * Definition of DataPipeline, which prepares the batches of training data of a
+ * network on other threads while the network is trained on the current batch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_PIPELINE_HPP
+#define MLPACK_METHODS_ANN_DATA_PIPELINE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <deque>
+#include <functional>
+#include <future>
+
+namespace mlpack {
+
+/**
+ * A DataPipeline gives the batches of training data of an FFN (see
+ * `FFN::Train()`) from a function that loads the given points, for instance
+ * from disk, and then applies any number of transforms to them, such as
+ * scaling (see `AddScaler()`), one-hot encoding, or augmentation.  While the
+ * network is trained on one batch, the next `prefetch` batches are loaded and
+ * transformed on other threads, so that input and preprocessing overlap with
+ * training.
+ *
+ * The points are visited in the order given by `Order()`, which starts as the
+ * identity and is a new random permutation after every `Shuffle()` (that is,
+ * at every epoch, if the optimizer shuffles).  Batches are prepared in the
+ * order they are requested; if a batch that was not prepared is requested, it
+ * is loaded on the calling thread.
+ *
+ * @code
+ * // Load the points with the given indices from disk; the first dimension of
+ * // each point holds its label.
+ * auto load = [](const arma::uvec& indices, arma::mat& predictors,
+ *                arma::mat& responses)
+ * {
+ *   ReadPoints("dataset.bin", indices, predictors); // User-supplied.
+ *   responses = predictors.row(0);
+ *   predictors.shed_row(0);
+ * };
+ *
+ * DataPipeline<> pipeline(numPoints, load);
+ * pipeline.AddScaler(scaler); // A data::StandardScaler fitted on a sample.
+ *
+ * FFN<NegativeLogLikelihood> model;
+ * // ... add layers ...
+ * ens::Adam optimizer(0.001, 64);
+ * model.Train(pipeline, optimizer);
+ * @endcode
+ *
+ * @tparam MatType Type of the predictors and responses.
+ */
+template<typename MatType = arma::mat>
+class DataPipeline
+{
+ public:
+  //! Type of the function that loads the points with the given indices.
+  using LoadFunctionType = std::function<void(const arma::uvec& indices,
+      MatType& predictors, MatType& responses)>;
+  //! Type of a function that transforms a batch in place.
+  using TransformFunctionType = std::function<void(MatType& predictors,
+      MatType& responses)>;
+
+  /**
+   * Create a pipeline over the given number of points, which are loaded with
+   * `load(indices, predictors, responses)`.  The function must set
+   * `predictors` and `responses` to one column for each index.  If `prefetch`
+   * is more than 1, it is called from several threads at once.
+   *
+   * @param points Number of points of the dataset.
+   * @param load Function that loads the points with the given indices.
+   * @param prefetch Number of batches to prepare ahead of the current one.
+   */
+  DataPipeline(const size_t points,
+               LoadFunctionType load,
+               const size_t prefetch = 1);
+
+  /**
+   * Create a pipeline over the given dataset, which must not be modified or
+   * destroyed while the pipeline is used.  This is useful to transform the
+   * batches on the fly, for instance with augmentation.
+   *
+   * @param predictors Predictors of the dataset.
+   * @param responses Responses of the dataset.
+   * @param prefetch Number of batches to prepare ahead of the current one.
+   */
+  DataPipeline(const MatType& predictors,
+               const MatType& responses,
+               const size_t prefetch = 1);
+
+  //! Wait for the batches that are being prepared.
+  ~DataPipeline() { Reset(); }
+
+  //! The pipeline is used by its threads, so it cannot be copied.
+  DataPipeline(const DataPipeline&) = delete;
+  //! The pipeline is used by its threads, so it cannot be copied.
+  DataPipeline& operator=(const DataPipeline&) = delete;
+
+  /**
+   * Add a transform, which is applied to each batch after it is loaded and
+   * after the earlier transforms, as `transform(predictors, responses)`.  If
+   * `Prefetch()` is more than 1, it is called from several threads at once.
+   */
+  void AddTransform(TransformFunctionType transform);
+
+  /**
+   * Add a transform that scales the predictors of each batch with the given
+   * (fitted) scaler from `data::`, such as `data::StandardScaler` or
+   * `data::MinMaxScaler`.
+   */
+  template<typename ScalerType>
+  void AddScaler(ScalerType scaler);
+
+  /**
+   * Get the given batch of points (in the order of `Order()`) into the given
+   * matrices.  If it was prepared, it is taken without a copy; otherwise it is
+   * loaded now.  Then, the batches that follow are prepared.
+   *
+   * @param begin Position of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param predictors Matrix to store the predictors of the batch into.
+   * @param responses Matrix to store the responses of the batch into.
+   */
+  void Batch(const size_t begin,
+             const size_t batchSize,
+             MatType& predictors,
+             MatType& responses);
+
+  /**
+   * Load and transform the given batch of points now, on the calling thread.
+   *
+   * @param begin Position of the first point of the batch.
+   * @param batchSize Number of points of the batch.
+   * @param predictors Matrix to store the predictors of the batch into.
+   * @param responses Matrix to store the responses of the batch into.
+   */
+  void Load(const size_t begin,
+            const size_t batchSize,
+            MatType& predictors,
+            MatType& responses) const;
+
+  //! Visit the points in a new random order, and start preparing the first
+  //! batch in that order.
+  void Shuffle();
+
+  //! Drop the batches that are prepared, after waiting for them.
+  void Reset() { pending.clear(); }
+
+  //! Get the number of points.
+  size_t Points() const { return points; }
+  //! Get the order the points are visited in.
+  const arma::uvec& Order() const { return order; }
+  //! Get the number of batches that are prepared ahead.
+  size_t Prefetch() const { return prefetch; }
+  //! Modify the number of batches that are prepared ahead.
+  size_t& Prefetch() { return prefetch; }
+
+ private:
+  //! A batch that is being prepared.
+  struct PendingBatch
+  {
+    size_t begin;
+    size_t batchSize;
+    std::future<std::pair<MatType, MatType>> batch;
+  };
+
+  //! Prepare the batches of the given size that follow the given position,
+  //! until `prefetch` batches are pending or the end of the points.
+  void Schedule(size_t begin, const size_t batchSize);
+
+  //! The number of points.
+  size_t points;
+  //! The function that loads points.
+  LoadFunctionType load;
+  //! The transforms, applied in order.
+  std::vector<TransformFunctionType> transforms;
+  //! The number of batches that are prepared ahead.
+  size_t prefetch;
+  //! The order the points are visited in.
+  arma::uvec order;
+  //! The size of the last requested batch.
+  size_t lastBatchSize;
+  //! The batches that are being prepared, in order.
+  std::deque<PendingBatch> pending;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "data_pipeline_impl.hpp"
+
+#endif
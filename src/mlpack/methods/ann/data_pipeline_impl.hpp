@@ -0,0 +1,161 @@
+/**
+ * @file methods/ann/data_pipeline_impl.hpp
+ *
+ * Implementation of DataPipeline.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DATA_PIPELINE_IMPL_HPP
+#define MLPACK_METHODS_ANN_DATA_PIPELINE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "data_pipeline.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+DataPipeline<MatType>::DataPipeline(const size_t points,
+                                    LoadFunctionType load,
+                                    const size_t prefetch) :
+    points(points),
+    load(std::move(load)),
+    prefetch(prefetch),
+    lastBatchSize(0)
+{
+  if (points == 0)
+  {
+    throw std::invalid_argument("DataPipeline::DataPipeline(): there must be "
+        "at least one point!");
+  }
+
+  order = arma::regspace<arma::uvec>(0, points - 1);
+}
+
+template<typename MatType>
+DataPipeline<MatType>::DataPipeline(const MatType& predictors,
+                                    const MatType& responses,
+                                    const size_t prefetch) :
+    DataPipeline(predictors.n_cols,
+        [&predictors, &responses](const arma::uvec& indices,
+                                  MatType& predictorsBatch,
+                                  MatType& responsesBatch)
+        {
+          predictorsBatch = predictors.cols(indices);
+          responsesBatch = responses.cols(indices);
+        }, prefetch)
+{
+  util::CheckSameSizes(predictors, responses, "DataPipeline::DataPipeline()",
+      "responses");
+}
+
+template<typename MatType>
+void DataPipeline<MatType>::AddTransform(TransformFunctionType transform)
+{
+  // The batches that are prepared do not have the new transform.
+  Reset();
+  transforms.push_back(std::move(transform));
+}
+
+template<typename MatType>
+template<typename ScalerType>
+void DataPipeline<MatType>::AddScaler(ScalerType scaler)
+{
+  AddTransform([scaler](MatType& predictors, MatType& /* responses */)
+      mutable
+  {
+    scaler.Transform(predictors);
+  });
+}
+
+template<typename MatType>
+void DataPipeline<MatType>::Batch(const size_t begin,
+                                  const size_t batchSize,
+                                  MatType& predictors,
+                                  MatType& responses)
+{
+  if (!pending.empty() && pending.front().begin == begin &&
+      pending.front().batchSize == batchSize)
+  {
+    std::pair<MatType, MatType> batch = pending.front().batch.get();
+    pending.pop_front();
+    predictors = std::move(batch.first);
+    responses = std::move(batch.second);
+  }
+  else
+  {
+    // The batches that are prepared are not the ones that are needed.
+    Reset();
+    Load(begin, batchSize, predictors, responses);
+  }
+
+  lastBatchSize = batchSize;
+  Schedule(begin + batchSize, batchSize);
+}
+
+template<typename MatType>
+void DataPipeline<MatType>::Load(const size_t begin,
+                                 const size_t batchSize,
+                                 MatType& predictors,
+                                 MatType& responses) const
+{
+  if (batchSize == 0 || begin + batchSize > points)
+  {
+    throw std::invalid_argument("DataPipeline::Load(): the batch of " +
+        std::to_string(batchSize) + " points at " + std::to_string(begin) +
+        " is not within the " + std::to_string(points) + " points!");
+  }
+
+  load(order.subvec(begin, begin + batchSize - 1), predictors, responses);
+  if (predictors.n_cols != batchSize || responses.n_cols != batchSize)
+  {
+    throw std::runtime_error("DataPipeline::Load(): the load function gave " +
+        std::to_string(predictors.n_cols) + " predictors and " +
+        std::to_string(responses.n_cols) + " responses for " +
+        std::to_string(batchSize) + " points!");
+  }
+
+  for (const TransformFunctionType& transform : transforms)
+    transform(predictors, responses);
+}
+
+template<typename MatType>
+void DataPipeline<MatType>::Shuffle()
+{
+  // Wait for the batches that use the old order.
+  Reset();
+  order = arma::randperm<arma::uvec>(points);
+
+  if (lastBatchSize > 0)
+    Schedule(0, std::min(lastBatchSize, points));
+}
+
+template<typename MatType>
+void DataPipeline<MatType>::Schedule(size_t begin, const size_t batchSize)
+{
+  if (!pending.empty())
+    begin = pending.back().begin + pending.back().batchSize;
+
+  while (pending.size() < prefetch)
+  {
+    // Without shuffling, the next epoch visits the points in the same order.
+    if (begin >= points)
+      begin = 0;
+
+    const size_t size = std::min(batchSize, points - begin);
+    pending.push_back({ begin, size, std::async(std::launch::async,
+        [this, begin, size]()
+        {
+          std::pair<MatType, MatType> batch;
+          Load(begin, size, batch.first, batch.second);
+          return batch;
+        }) });
+    begin += size;
+  }
+}
+
+} // namespace mlpack
+
+#endif
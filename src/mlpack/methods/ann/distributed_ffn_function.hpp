@@ -0,0 +1,122 @@
+/**
+ * @file methods/ann/distributed_ffn_function.hpp
+ *
+ * Definition of DistributedFFNFunction, the objective function that the
+ * optimizer is given by `FFN::TrainDistributed()`.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_DISTRIBUTED_FFN_FUNCTION_HPP
+#define MLPACK_METHODS_ANN_DISTRIBUTED_FFN_FUNCTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/communicator.hpp>
+
+namespace mlpack {
+
+/**
+ * The separable objective function of a network whose training data is split
+ * across the ranks of a communicator.  Batch `[begin, begin + batchSize)` is
+ * made of the points `[begin, begin + batchSize)` of every rank, so the
+ * objective and the gradient of a batch are the sums over all ranks of the
+ * objectives and gradients of the local batches.  Every rank has the same
+ * optimizer (with the same parameters), so each one computes the same steps,
+ * and the parameters stay the same on every rank.
+ *
+ * The number of functions is the smallest number of points of a rank; if the
+ * ranks do not have the same number of points, at each epoch only that many
+ * of the points of each rank (the first ones after shuffling) are used.
+ *
+ * This is used by `FFN::TrainDistributed()`, and is not generally meant to be
+ * used otherwise.
+ *
+ * @tparam NetworkType Type of the network (an FFN).
+ * @tparam CommunicatorType Type of communicator (e.g. LocalCommunicator or
+ *     MPICommunicator).
+ * @tparam MatType Type of the parameters of the network.
+ */
+template<typename NetworkType, typename CommunicatorType, typename MatType>
+class DistributedFFNFunction
+{
+ public:
+  //! The type of the elements of the parameters.
+  using ElemType = typename MatType::elem_type;
+
+  /**
+   * The number of elements of the gradient that are summed over the ranks at
+   * once.  The gradients of the layers are grouped until they have at least
+   * this many elements, so that small layers do not each pay for the latency
+   * of a message.
+   */
+  static constexpr size_t BucketSize = 1 << 19;
+
+  /**
+   * Create the function of the given network, which holds the training points
+   * of this rank.  This is a collective operation.
+   *
+   * @param network Network to train.
+   * @param comm Communicator of the ranks.
+   */
+  DistributedFFNFunction(NetworkType& network, CommunicatorType& comm) :
+      network(network),
+      comm(comm)
+  {
+    std::vector<std::vector<size_t>> points;
+    comm.AllGather(std::vector<size_t>(1, network.NumFunctions()), points);
+
+    numFunctions = points[0][0];
+    for (size_t r = 1; r < points.size(); ++r)
+      numFunctions = std::min(numFunctions, points[r][0]);
+  }
+
+  //! Return the number of points of each batch that can be used.
+  size_t NumFunctions() const { return numFunctions; }
+
+  //! Shuffle the points of this rank.
+  void Shuffle() { network.Shuffle(); }
+
+  //! Return the objective of the given batch, summed over all ranks.
+  ElemType Evaluate(const MatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize)
+  {
+    ElemType objective = network.Evaluate(parameters, begin, batchSize);
+    comm.AllReduceSum(&objective, 1);
+    return objective;
+  }
+
+  //! Compute the objective and gradient of the given batch, summed over all
+  //! ranks.
+  ElemType EvaluateWithGradient(const MatType& /* parameters */,
+                                const size_t begin,
+                                MatType& gradient,
+                                const size_t batchSize)
+  {
+    return network.DistributedEvaluateWithGradient(begin, gradient, batchSize,
+        comm, BucketSize);
+  }
+
+  //! Compute the gradient of the given batch, summed over all ranks.
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize)
+  {
+    EvaluateWithGradient(parameters, begin, gradient, batchSize);
+  }
+
+ private:
+  //! The network to train.
+  NetworkType& network;
+  //! The communicator of the ranks.
+  CommunicatorType& comm;
+  //! The smallest number of points of a rank.
+  size_t numFunctions;
+};
+
+} // namespace mlpack
+
+#endif
@@ -40,7 +40,7 @@ BernoulliDistribution<DataType>::BernoulliDistribution(
   }
   else
   {
-    probability = arma::mat(logits.memptr(), logits.n_rows,
+    probability = DataType(logits.memptr(), logits.n_rows,
         logits.n_cols, false, false);
   }
 }
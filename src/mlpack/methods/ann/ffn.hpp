@@ -18,6 +18,9 @@
 #include "forward_decls.hpp"
 #include "init_rules/init_rules.hpp"
 #include "loss_functions/loss_functions.hpp"
+#include "ffn_workspace.hpp"
+#include "data_pipeline.hpp"
+#include "distributed_ffn_function.hpp"
 
 #include <ensmallen.hpp>
 
@@ -125,6 +128,32 @@ class FFN
     return network.Network();
   }
 
+  /**
+   * Get whether the time and estimated operations of each layer are recorded
+   * during `Train()`, `Predict()` and `Evaluate()`.
+   */
+  bool Profiling() const { return network.Profiling(); }
+  /**
+   * Modify whether the time and estimated operations of each layer are
+   * recorded during `Train()`, `Predict()` and `Evaluate()`.  This is disabled
+   * by default.  With `TrainingThreads()`, only the part of each batch that is
+   * computed by the first thread is recorded.
+   */
+  bool& Profiling() { return network.Profiling(); }
+
+  //! Get the statistics of each layer recorded while `Profiling()` was
+  //! enabled.
+  const std::vector<LayerProfile>& Profile() const { return network.Profile(); }
+
+  //! Reset the statistics of each layer.
+  void ResetProfile() { network.ResetProfile(); }
+
+  //! Print the statistics of each layer as a table to the given stream.
+  void PrintProfile(std::ostream& stream = std::cout) const
+  {
+    network.PrintProfile(stream);
+  }
+
   /**
    * Train the feedforward network on the given input data using the given
    * optimizer.
@@ -190,6 +219,175 @@ class FFN
                                     MatType responses,
                                     CallbackTypes&&... callbacks);
 
+  /**
+   * Train the feedforward network on the batches given by the given
+   * DataPipeline, which loads and transforms the next batches on other threads
+   * while the network is trained on the current one.  This is useful when the
+   * dataset does not fit in memory, or when loading or preprocessing the
+   * batches takes a significant part of the training time.  The pipeline is
+   * shuffled with the optimizer's `Shuffle()` calls, and its batches have the
+   * batch size of the optimizer.
+   *
+   * The network is initialized like for `Train()`, with the dimensionality of
+   * the first point of the pipeline.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param pipeline Pipeline that gives the batches of training data.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(DataPipeline<MatType>& pipeline,
+                                    OptimizerType& optimizer,
+                                    CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network with data parallelism across the ranks of
+   * the given communicator (for instance, the processes of an MPI job), each
+   * of which holds a part of the training data.  This is a collective
+   * operation: every rank must call it with the same network, the same
+   * optimizer settings, and its own `predictors` and `responses`.
+   *
+   * The network is initialized like for `Train()`, and then every rank starts
+   * from the parameters of rank 0.  Each batch of the optimizer is made of a
+   * batch of the same size of every rank (so the effective batch size is the
+   * batch size of the optimizer times the number of ranks), and its gradient
+   * is the sum of the gradients of the local batches.  The gradients of the
+   * last layers are summed over the ranks while the backward pass of the
+   * first layers runs.  So, every rank takes the same steps, and has the same
+   * parameters at the end.
+   *
+   * The optimizer must be one for separable functions, like `ens::SGD` or
+   * `ens::Adam`.  Each rank should have the same number of points; otherwise
+   * only as many points as the smallest rank has are used at each epoch.
+   * With `TrainingThreads()` larger than 1, the batch of each rank is split
+   * between threads, and its gradient is summed over the ranks after the
+   * backward pass instead of during it.  Like with `TrainingThreads()`, the
+   * penalties of the layers (e.g. weight decay) are counted once per rank.
+   *
+   * @tparam CommunicatorType Type of communicator (e.g. LocalCommunicator or
+   *     MPICommunicator).
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables of this rank.
+   * @param responses Outputs results from input training variables of this
+   *     rank.
+   * @param comm Communicator of the ranks.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model over all ranks (NaN or
+   *     Inf on error).
+   */
+  template<typename CommunicatorType,
+           typename OptimizerType,
+           typename... CallbackTypes>
+  typename MatType::elem_type TrainDistributed(MatType predictors,
+                                               MatType responses,
+                                               CommunicatorType& comm,
+                                               OptimizerType& optimizer,
+                                               CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network like `Train()`, but pass sparse gradients
+   * (`arma::SpMat`) to the optimizer.  Layers with row-sparse gradients, like
+   * the Embedding layer, then only give the rows that were used by each batch,
+   * and optimizers whose update only depends on the gradient (like `ens::SGD`
+   * with `ens::VanillaUpdate`) only update those rows.  This is much faster for
+   * large embedding tables, where most rows are not used by a batch.
+   *
+   * The optimizer must support sparse gradients; see the ensmallen
+   * documentation.  The gradient of each batch is computed with one thread.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type TrainSparse(MatType predictors,
+                                          MatType responses,
+                                          OptimizerType& optimizer,
+                                          CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on sparse input data (for instance, hashed
+   * bag-of-words features) using the given optimizer.  The first layer of the
+   * network must accept sparse input (`Linear` or `LinearNoBias`); it computes
+   * its output and gradient from the nonzero elements of each batch only, and
+   * all the other layers work on dense matrices as usual.  The input is never
+   * converted to a dense matrix.
+   *
+   * The network is initialized like for `Train()`.  With sparse input, the
+   * gradient of each batch is computed with one thread (`TrainingThreads()`
+   * is ignored).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::SpMat<typename MatType::elem_type> predictors,
+      MatType responses,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on sparse input data, like the overload
+   * above, with a default-constructed optimizer (by default, RMSProp).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      arma::SpMat<typename MatType::elem_type> predictors,
+      MatType responses,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the feedforward network on sparse input data like `Train()`, but pass
+   * sparse gradients to the optimizer like `TrainSparse()` does for dense
+   * input.  The first layer then only gives the gradients of the weights of the
+   * input units that are nonzero in each batch, so with an optimizer like
+   * `ens::SGD` with `ens::VanillaUpdate`, the cost of each step is proportional
+   * to the number of nonzero elements of the batch instead of the size of the
+   * first layer.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Sparse input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type TrainSparse(
+      arma::SpMat<typename MatType::elem_type> predictors,
+      MatType responses,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will be
    * the output of the output layer when `predictors` is passed through the
@@ -203,6 +401,78 @@ class FFN
                MatType& results,
                const size_t batchSize = 128);
 
+  /**
+   * Predict the responses to a given set of sparse predictors, like the
+   * overload above.  The first layer of the network must accept sparse input
+   * (see the sparse overload of `Train()`).
+   *
+   * @param predictors Sparse input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const arma::SpMat<typename MatType::elem_type>& predictors,
+               MatType& results,
+               const size_t batchSize = 128);
+
+  /**
+   * Prepare the network for inference with `FFNWorkspace`s: the weights are
+   * initialized if needed, the dimensions of the layers are computed for a
+   * (flat 1-d) input size of `inputDimensionality` (if passed) or whatever
+   * input size has been set with `InputDimensions()`, and the network is set to
+   * prediction mode.  After this, the overload of `Predict()` that takes a
+   * workspace can be called from any number of threads at once, as long as the
+   * network is not modified (for instance by `Train()`) in the meantime.
+   */
+  void Freeze(const size_t inputDimensionality = 0);
+
+  /**
+   * Predict the responses to a given set of predictors with the given
+   * workspace, without modifying the network, which must have been prepared
+   * with `Freeze()`.  The workspace holds the intermediate activations and
+   * copies of the layers, and is set up by the first call; later calls with at
+   * most as many points in each batch reuse its memory.  Concurrent calls must
+   * use different workspaces.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Workspace to use for the forward passes.
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               FFNWorkspace<MatType>& workspace,
+               const size_t batchSize = 128) const;
+
+  /**
+   * Quantize the network for inference: each `Linear`, `LinearNoBias` and
+   * `Convolution` layer is replaced by a `QuantizedLinear` or
+   * `QuantizedConvolution` layer, which stores its weights as int8 values with
+   * one scale per output unit or map, and quantizes its input with a scale
+   * found from the largest absolute value of its input on the given
+   * calibration data.  The quantized layers can't be trained; a quantized
+   * network can be saved and loaded as usual.
+   *
+   * @param calibrationData Sample of the data the network will predict on.
+   * @param batchSize Batch size to use for the calibration passes.
+   */
+  void Quantize(const MatType& calibrationData, const size_t batchSize = 128);
+
+  /**
+   * Prune the network for inference: in each `Linear` and `LinearNoBias`
+   * layer, the given fraction of the weights with the smallest magnitudes are
+   * set to zero, and the layer is replaced by a `SparseLinear` layer, which
+   * only stores and multiplies the remaining weights.  With a block size larger
+   * than 1, square blocks of weights are pruned and stored together (see
+   * `PruneWeights()`), which makes the forward pass easier to vectorize.  The
+   * pruned layers can't be trained; a pruned network can be saved and loaded
+   * as usual.
+   *
+   * @param sparsity Fraction of the weights (or blocks) of each layer to set
+   *     to zero, in [0, 1].
+   * @param blockSize Size of the square blocks of weights to prune.
+   */
+  void Prune(const double sparsity, const size_t blockSize = 1);
+
   // Return the number of weights in the model.
   size_t WeightSize();
 
@@ -239,6 +509,25 @@ class FFN
   //! time a forward pass is done.
   MatType& Parameters() { return parameters; }
 
+  /**
+   * Get the number of threads that each batch is split between during
+   * training.
+   */
+  size_t TrainingThreads() const { return trainingThreads; }
+  /**
+   * Modify the number of threads that each batch is split between during
+   * training (1 by default; 0 means as many as OpenMP allows).  With more than
+   * one thread, each thread runs the forward and backward passes of a part of
+   * the batch with its own copy of the layers, which share the parameters, and
+   * the gradients are summed before the optimizer step.  This helps networks
+   * with small layers, which multithreaded BLAS can't parallelize well.
+   *
+   * Layers that use statistics of the batch (like `BatchNorm`) compute them
+   * on the part of each thread, and the running statistics are only kept from
+   * the first part.
+   */
+  size_t& TrainingThreads() { return trainingThreads; }
+
   /**
    * Reset the stored data of the network entirely.  This resets all weights of
    * each layer using `InitializationRuleType`, and prepares the network to
@@ -318,6 +607,18 @@ class FFN
   typename MatType::elem_type Evaluate(const MatType& predictors,
                                        const MatType& responses);
 
+  /**
+   * Evaluate the feedforward network with the given sparse predictors and
+   * responses.  The first layer of the network must accept sparse input (see
+   * the sparse overload of `Train()`).
+   *
+   * @param predictors Sparse input variables.
+   * @param responses Target outputs for input variables.
+   */
+  typename MatType::elem_type Evaluate(
+      const arma::SpMat<typename MatType::elem_type>& predictors,
+      const MatType& responses);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -412,13 +713,56 @@ class FFN
                 MatType& gradient,
                 const size_t batchSize);
 
+  /**
+   * Note: this function is implemented so that it can be used by ensmallen's
+   * optimizers.  It's not generally meant to be used otherwise.
+   *
+   * Evaluate the feedforward network like the overload above, but compute a
+   * sparse gradient with `SparseGradient()` of each layer (see
+   * `TrainSparse()`).
+   *
+   * @param parameters Matrix model parameters.
+   * @param begin Index of the starting point to use for objective function
+   *        evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be passed at a time to use for
+   *        objective function evaluation.
+   */
+  typename MatType::elem_type EvaluateWithGradient(
+      const MatType& parameters,
+      const size_t begin,
+      arma::SpMat<typename MatType::elem_type>& gradient,
+      const size_t batchSize);
+
+  /**
+   * Note: this function is implemented so that it can be used by ensmallen's
+   * optimizers.  It's not generally meant to be used otherwise.
+   *
+   * Evaluate the sparse gradient of the feedforward network with respect to
+   * only a number of points in the dataset (see `TrainSparse()`).
+   *
+   * @param parameters Matrix of the model parameters to be optimized.
+   * @param begin Index of the starting point to use for objective function
+   *        gradient evaluation.
+   * @param gradient Sparse matrix to output gradient into.
+   * @param batchSize Number of points to be processed as a batch for objective
+   *        function gradient evaluation.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                arma::SpMat<typename MatType::elem_type>& gradient,
+                const size_t batchSize);
+
   /**
    * Note: this function is implemented so that it can be used by ensmallen's
    * optimizers.  It's not generally meant to be used otherwise.
    *
    * Return the number of separable functions (the number of predictor points).
    */
-  size_t NumFunctions() const { return responses.n_cols; }
+  size_t NumFunctions() const
+  {
+    return (pipeline != NULL) ? pipeline->Points() : responses.n_cols;
+  }
 
   /**
    * Note: this function is implemented so that it can be used by ensmallen's
@@ -440,6 +784,18 @@ class FFN
    */
   void ResetData(MatType predictors, MatType responses);
 
+  /**
+   * Prepare the network for training on the given sparse data.
+   *
+   * This function won't actually trigger the training process, and is
+   * generally only useful internally.
+   *
+   * @param predictors Sparse input data variables.
+   * @param responses Outputs results from input data variables.
+   */
+  void ResetData(arma::SpMat<typename MatType::elem_type> predictors,
+                 MatType responses);
+
  private:
   // Helper functions.
 
@@ -468,6 +824,96 @@ class FFN
                     const bool setMode = false,
                     const bool training = false);
 
+  /**
+   * Perform the forward and backward passes of the given batch, and return the
+   * objective.  The gradient can then be computed with `network.Gradient()` or
+   * `network.SparseGradient()`, using `predictorsBatch` and `error`.
+   */
+  typename MatType::elem_type ForwardBackward(const size_t begin,
+                                              const size_t batchSize,
+                                              MatType& predictorsBatch);
+
+  /**
+   * Perform the forward and backward passes of the given batch of the sparse
+   * training data, and return the objective.  The gradient can then be
+   * computed with `network.SparseInputGradient()` or
+   * `network.SparseInputSparseGradient()`, using `predictorsBatch` and `error`.
+   */
+  typename MatType::elem_type SparseForwardBackward(
+      const size_t begin,
+      const size_t batchSize,
+      arma::SpMat<typename MatType::elem_type>& predictorsBatch);
+
+  /**
+   * Make the given batch available in `predictors` and `responses`, and return
+   * the column it starts at.  When training with a DataPipeline, the batch is
+   * taken from the pipeline, and starts at column 0.
+   */
+  size_t PrepareBatch(const size_t begin, const size_t batchSize);
+
+  /**
+   * Compute the objective and gradient of the given batch like
+   * EvaluateWithGradient(), but split between the given number of threads.
+   */
+  typename MatType::elem_type ParallelEvaluateWithGradient(
+      const size_t begin,
+      MatType& gradient,
+      const size_t batchSize,
+      const size_t threads);
+
+  /**
+   * Compute the objective and gradient of the given batch like
+   * EvaluateWithGradient(), and sum them over the ranks of the given
+   * communicator.  The gradients of the layers are summed in groups of at
+   * least `bucketSize` elements, from the last layer, as soon as they are
+   * computed.
+   */
+  template<typename CommunicatorType>
+  typename MatType::elem_type DistributedEvaluateWithGradient(
+      const size_t begin,
+      MatType& gradient,
+      const size_t batchSize,
+      CommunicatorType& comm,
+      const size_t bucketSize);
+
+  /**
+   * Ensure that the network was prepared with `Freeze()` and that the input
+   * has the expected dimensionality, and set up the workspace for batches of
+   * at most `batchSize` points if it is not set up yet.
+   *
+   * @param functionName Name of function to use if an exception is thrown.
+   * @param inputDimensionality Given dimensionality of the input data.
+   * @param workspace Workspace to set up.
+   * @param batchSize Maximum number of points of each forward pass.
+   */
+  void CheckFrozenNetwork(const std::string& functionName,
+                          const size_t inputDimensionality,
+                          FFNWorkspace<MatType>& workspace,
+                          const size_t batchSize) const;
+
+  /**
+   * Return a quantized copy of the given layer, with the given input scale, or
+   * NULL if the layer can't be quantized.
+   */
+  static Layer<MatType>* QuantizedLayer(Layer<MatType>* layer,
+                                        const double inputScale);
+
+  /**
+   * Return a pruned copy of the given layer, or NULL if the layer can't be
+   * pruned.
+   */
+  static Layer<MatType>* PrunedLayer(Layer<MatType>* layer,
+                                     const double sparsity,
+                                     const size_t blockSize);
+
+  /**
+   * Return a quantized copy of the given layer if it is a convolution layer of
+   * type ConvType, or NULL otherwise.
+   */
+  template<typename ConvType>
+  static Layer<MatType>* QuantizedConvolutionLayer(Layer<MatType>* layer,
+                                                   const double inputScale);
+
   /**
    * Set the input and output dimensions of each layer in the network correctly.
    * The size of the input is taken, in case `inputDimensions` has not been set
@@ -533,6 +979,10 @@ class FFN
   //! the ensmallen optimizer will not provide training data.
   MatType predictors;
 
+  //! The sparse data points, when training with sparse input; `predictors` is
+  //! then empty.  This member is empty otherwise.
+  arma::SpMat<typename MatType::elem_type> sparsePredictors;
+
   //! The matrix of responses to the input data points.  This member is empty,
   //! except during training.
   MatType responses;
@@ -545,6 +995,23 @@ class FFN
   //! Locally-stored error of the backward pass; used by the gradient pass.
   MatType error;
 
+  //! The number of threads that each batch is split between during training.
+  size_t trainingThreads;
+  //! Copies of the network for the threads other than the first during
+  //! training; their weights are aliases of `parameters`.
+  std::vector<MultiLayer<MatType>> threadNetworks;
+  //! The output of the backward pass of each copy of the network.
+  std::vector<MatType> threadDeltas;
+  //! The gradient of each copy of the network.
+  std::vector<MatType> threadGradients;
+  //! The parameters the copies of the network are set up for.
+  const typename MatType::elem_type* threadParameters;
+
+  //! The pipeline that gives the batches during `Train()` with a
+  //! DataPipeline, or NULL.  `predictors` and `responses` then hold only the
+  //! current batch.
+  DataPipeline<MatType>* pipeline;
+
   //! If true, each layer has its memory properly set for a forward/backward
   //! pass.
   bool layerMemoryIsSet;
@@ -555,6 +1022,11 @@ class FFN
 
   // RNN will call `CheckNetwork()`, which is private.
   friend class RNN<OutputLayerType, InitializationRuleType, MatType>;
+
+  // The function of distributed training calls
+  // `DistributedEvaluateWithGradient()`, which is private.
+  template<typename, typename, typename>
+  friend class DistributedFFNFunction;
 }; // class FFN
 
 } // namespace mlpack
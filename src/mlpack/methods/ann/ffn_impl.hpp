@@ -27,6 +27,9 @@ FFN<
 >::FFN(OutputLayerType outputLayer, InitializationRuleType initializeRule) :
     outputLayer(std::move(outputLayer)),
     initializeRule(std::move(initializeRule)),
+    trainingThreads(1),
+    threadParameters(NULL),
+    pipeline(NULL),
     layerMemoryIsSet(false),
     inputDimensionsAreSet(false)
 {
@@ -47,7 +50,12 @@ FFN<
     parameters(network.parameters),
     inputDimensions(network.inputDimensions),
     predictors(network.predictors),
+    sparsePredictors(network.sparsePredictors),
     responses(network.responses),
+    trainingThreads(network.trainingThreads),
+    // The copies of the network for training threads are made when needed.
+    threadParameters(NULL),
+    pipeline(NULL),
     // These will be set correctly in the first Forward() call.
     layerMemoryIsSet(false),
     inputDimensionsAreSet(false)
@@ -69,7 +77,12 @@ FFN<
     parameters(std::move(network.parameters)),
     inputDimensions(std::move(network.inputDimensions)),
     predictors(std::move(network.predictors)),
+    sparsePredictors(std::move(network.sparsePredictors)),
     responses(std::move(network.responses)),
+    trainingThreads(network.trainingThreads),
+    // The copies of the network for training threads are made when needed.
+    threadParameters(NULL),
+    pipeline(NULL),
     // Aliases will not be correct after a std::move(), so we will manually
     // reset them.
     layerMemoryIsSet(false),
@@ -95,10 +108,15 @@ FFN<OutputLayerType, InitializationRuleType, MatType>& FFN<
     parameters = other.parameters;
     inputDimensions = other.inputDimensions;
     predictors = other.predictors;
+    sparsePredictors = other.sparsePredictors;
     responses = other.responses;
     networkOutput = other.networkOutput;
     networkDelta = other.networkDelta;
     error = other.error;
+    trainingThreads = other.trainingThreads;
+    threadNetworks.clear();
+    threadParameters = NULL;
+    pipeline = NULL;
     inputDimensionsAreSet = other.inputDimensionsAreSet;
 
     // Copying will not preserve Armadillo aliases correctly, so we will reset
@@ -126,10 +144,15 @@ FFN<OutputLayerType, InitializationRuleType, MatType>& FFN<
     parameters = std::move(other.parameters);
     inputDimensions = std::move(other.inputDimensions);
     predictors = std::move(other.predictors);
+    sparsePredictors = std::move(other.sparsePredictors);
     responses = std::move(other.responses);
     networkOutput = std::move(other.networkOutput);
     networkDelta = std::move(other.networkDelta);
     error = std::move(other.error);
+    trainingThreads = other.trainingThreads;
+    threadNetworks.clear();
+    threadParameters = NULL;
+    pipeline = NULL;
     inputDimensionsAreSet = std::move(other.inputDimensionsAreSet);
     layerMemoryIsSet = std::move(other.layerMemoryIsSet);
   }
@@ -157,6 +180,10 @@ typename MatType::elem_type FFN<
   // Ensure that the network can be used.
   CheckNetwork("FFN::Train()", this->predictors.n_rows, true, true);
 
+  // The copies of the network for training threads are made again, in case
+  // the network changed since the last call.
+  threadParameters = NULL;
+
   // Train the model.
   Timer::Start("ffn_optimization");
   const typename MatType::elem_type out =
@@ -168,6 +195,131 @@ typename MatType::elem_type FFN<
   return out;
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(DataPipeline<MatType>& pipeline,
+         OptimizerType& optimizer,
+         CallbackTypes&&... callbacks)
+{
+  // The first point gives the dimensionality of the input.
+  MatType firstPredictors, firstResponses;
+  pipeline.Load(0, 1, firstPredictors, firstResponses);
+  ResetData(std::move(firstPredictors), std::move(firstResponses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, pipeline.Points());
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::Train()", this->predictors.n_rows, true, true);
+
+  threadParameters = NULL;
+
+  // The batches are now taken from the pipeline.
+  this->pipeline = &pipeline;
+
+  Timer::Start("ffn_optimization");
+  typename MatType::elem_type out;
+  try
+  {
+    out = optimizer.Optimize(*this, parameters, callbacks...);
+  }
+  catch (...)
+  {
+    Timer::Stop("ffn_optimization");
+    this->pipeline = NULL;
+    pipeline.Reset();
+    throw;
+  }
+  Timer::Stop("ffn_optimization");
+
+  this->pipeline = NULL;
+  pipeline.Reset();
+
+  Log::Info << "FFN::Train(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename CommunicatorType,
+         typename OptimizerType,
+         typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::TrainDistributed(MatType predictors,
+                    MatType responses,
+                    CommunicatorType& comm,
+                    OptimizerType& optimizer,
+                    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::TrainDistributed()", this->predictors.n_rows, true, true);
+
+  threadParameters = NULL;
+
+  // Every rank starts from the parameters of rank 0.
+  if (comm.Rank() != 0)
+    parameters.zeros();
+  comm.AllReduceSum(parameters.memptr(), parameters.n_elem);
+
+  DistributedFFNFunction<FFN, CommunicatorType, MatType> function(*this, comm);
+  WarnMessageMaxIterations<OptimizerType>(optimizer, function.NumFunctions());
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(function, parameters, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::TrainDistributed(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::TrainSparse(MatType predictors,
+               MatType responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks)
+{
+  typedef arma::SpMat<typename MatType::elem_type> GradType;
+
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer, this->predictors.n_cols);
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::TrainSparse()", this->predictors.n_rows, true, true);
+
+  // Train the model, with sparse gradients.
+  Timer::Start("ffn_optimization");
+  const typename MatType::elem_type out = optimizer.template Optimize<
+      FFN, MatType, GradType>(*this, parameters, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::TrainSparse(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -185,6 +337,89 @@ typename MatType::elem_type FFN<
       callbacks...);
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(arma::SpMat<typename MatType::elem_type> predictors,
+         MatType responses,
+         OptimizerType& optimizer,
+         CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer,
+      sparsePredictors.n_cols);
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::Train()", sparsePredictors.n_rows, true, true);
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(*this, parameters, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::Train(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(arma::SpMat<typename MatType::elem_type> predictors,
+         MatType responses,
+         CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses), optimizer,
+      callbacks...);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::TrainSparse(arma::SpMat<typename MatType::elem_type> predictors,
+               MatType responses,
+               OptimizerType& optimizer,
+               CallbackTypes&&... callbacks)
+{
+  typedef arma::SpMat<typename MatType::elem_type> GradType;
+
+  ResetData(std::move(predictors), std::move(responses));
+
+  WarnMessageMaxIterations<OptimizerType>(optimizer,
+      sparsePredictors.n_cols);
+
+  // Ensure that the network can be used.
+  CheckNetwork("FFN::TrainSparse()", sparsePredictors.n_rows, true, true);
+
+  // Train the model, with sparse gradients.
+  Timer::Start("ffn_optimization");
+  const typename MatType::elem_type out = optimizer.template Optimize<
+      FFN, MatType, GradType>(*this, parameters, callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFN::TrainSparse(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -215,6 +450,219 @@ void FFN<
   }
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(const arma::SpMat<typename MatType::elem_type>& predictors,
+           MatType& results,
+           const size_t batchSize)
+{
+  // Ensure that the network is configured correctly.
+  CheckNetwork("FFN::Predict()", predictors.n_rows, true, false);
+
+  results.set_size(network.OutputSize(), predictors.n_cols);
+
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    // The columns of a sparse matrix are contiguous, so extracting a batch
+    // only copies its nonzero elements.
+    const arma::SpMat<typename MatType::elem_type> predictorsBatch =
+        predictors.cols(i, i + effectiveBatchSize - 1);
+    MatType resultAlias;
+    MakeAlias(resultAlias, results, results.n_rows, effectiveBatchSize,
+        i * results.n_rows);
+
+    network.SparseInputForward(predictorsBatch, resultAlias);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Freeze(const size_t inputDimensionality)
+{
+  if (inputDimensionality == 0 && inputDimensions.size() == 0)
+  {
+    throw std::invalid_argument("FFN::Freeze(): cannot freeze network when no "
+        "input dimensionality is given, and `InputDimensions()` has not been "
+        "set!");
+  }
+
+  CheckNetwork("FFN::Freeze()", inputDimensionality, true, false);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(const MatType& predictors,
+           MatType& results,
+           FFNWorkspace<MatType>& workspace,
+           const size_t batchSize) const
+{
+  CheckFrozenNetwork("FFN::Predict()", predictors.n_rows, workspace,
+      std::min(batchSize, size_t(predictors.n_cols)));
+  results.set_size(workspace.Layers().back()->OutputSize(), predictors.n_cols);
+
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    MatType predictorAlias, resultAlias;
+
+    MakeAlias(predictorAlias, predictors, predictors.n_rows,
+        effectiveBatchSize, i * predictors.n_rows);
+    MakeAlias(resultAlias, results, results.n_rows, effectiveBatchSize,
+        i * results.n_rows);
+
+    workspace.Forward(predictorAlias, resultAlias);
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Quantize(const MatType& calibrationData, const size_t batchSize)
+{
+  CheckNetwork("FFN::Quantize()", calibrationData.n_rows, true, false);
+
+  // Find the largest absolute value of the input of each layer on the
+  // calibration data.
+  std::vector<Layer<MatType>*>& layers = network.Network();
+  std::vector<double> maxInputs(layers.size(), 0.0);
+  for (size_t i = 0; i < calibrationData.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(calibrationData.n_cols) - i);
+
+    MatType layerInput = calibrationData.cols(i, i + effectiveBatchSize - 1);
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+      maxInputs[l] = std::max(maxInputs[l],
+          (double) arma::abs(layerInput).max());
+
+      MatType layerOutput(layers[l]->OutputSize(), effectiveBatchSize);
+      layers[l]->Forward(layerInput, layerOutput);
+      layerInput = std::move(layerOutput);
+    }
+  }
+
+  // Replace the layers that can be quantized, and keep the parameters of the
+  // other layers.
+  MatType newParameters(parameters.n_elem, 1);
+  size_t start = 0;
+  size_t newStart = 0;
+  for (size_t l = 0; l < layers.size(); ++l)
+  {
+    const size_t weightSize = layers[l]->WeightSize();
+    Layer<MatType>* quantized = QuantizedLayer(layers[l],
+        QuantizationScale(maxInputs[l]));
+    if (quantized != NULL)
+    {
+      // The dimensions of the network are unchanged, so they won't be
+      // propagated again.
+      quantized->InputDimensions() = layers[l]->InputDimensions();
+      delete layers[l];
+      layers[l] = quantized;
+    }
+    else if (weightSize > 0)
+    {
+      newParameters.rows(newStart, newStart + weightSize - 1) =
+          parameters.rows(start, start + weightSize - 1);
+      newStart += weightSize;
+    }
+
+    start += weightSize;
+  }
+
+  newParameters.resize(newStart, 1);
+  parameters = std::move(newParameters);
+
+  // The dimensions of the new layers must be set, and the layers must point at
+  // the new parameters.
+  inputDimensionsAreSet = false;
+  layerMemoryIsSet = false;
+  CheckNetwork("FFN::Quantize()", calibrationData.n_rows, true, false);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Prune(const double sparsity, const size_t blockSize)
+{
+  if (sparsity < 0.0 || sparsity > 1.0)
+    throw std::invalid_argument("FFN::Prune(): sparsity must be in [0, 1]!");
+  if (blockSize == 0)
+    throw std::invalid_argument("FFN::Prune(): block size must be positive!");
+  if (parameters.is_empty())
+  {
+    throw std::logic_error("FFN::Prune(): the network must be trained (or "
+        "reset) before it is pruned!");
+  }
+
+  CheckNetwork("FFN::Prune()", 0, true, false);
+
+  // Replace the layers that can be pruned, and keep the parameters of the
+  // other layers.
+  std::vector<Layer<MatType>*>& layers = network.Network();
+  MatType newParameters(parameters.n_elem, 1);
+  size_t start = 0;
+  size_t newStart = 0;
+  for (size_t l = 0; l < layers.size(); ++l)
+  {
+    const size_t weightSize = layers[l]->WeightSize();
+    Layer<MatType>* pruned = PrunedLayer(layers[l], sparsity, blockSize);
+    if (pruned != NULL)
+    {
+      // The dimensions of the network are unchanged, so they won't be
+      // propagated again.
+      pruned->InputDimensions() = layers[l]->InputDimensions();
+      delete layers[l];
+      layers[l] = pruned;
+    }
+    else if (weightSize > 0)
+    {
+      newParameters.rows(newStart, newStart + weightSize - 1) =
+          parameters.rows(start, start + weightSize - 1);
+      newStart += weightSize;
+    }
+
+    start += weightSize;
+  }
+
+  newParameters.resize(newStart, 1);
+  parameters = std::move(newParameters);
+
+  // The dimensions of the new layers must be set, and the layers must point at
+  // the new parameters.
+  inputDimensionsAreSet = false;
+  layerMemoryIsSet = false;
+  CheckNetwork("FFN::Prune()", 0, true, false);
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -353,14 +801,32 @@ typename MatType::elem_type FFN<
     OutputLayerType,
     InitializationRuleType,
     MatType
->::Evaluate(const MatType& predictors, const MatType& responses)
+>::Evaluate(const MatType& predictors, const MatType& responses)
+{
+  // Sanity check: ensure network is valid.
+  CheckNetwork("FFN::Evaluate()", predictors.n_rows);
+
+  // Set networkOutput to the right size if needed, then perform the forward
+  // pass.
+  network.Forward(predictors, networkOutput);
+
+  return outputLayer.Forward(networkOutput, responses) + network.Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(const arma::SpMat<typename MatType::elem_type>& predictors,
+            const MatType& responses)
 {
   // Sanity check: ensure network is valid.
   CheckNetwork("FFN::Evaluate()", predictors.n_rows);
 
-  // Set networkOutput to the right size if needed, then perform the forward
-  // pass.
-  network.Forward(predictors, networkOutput);
+  network.SparseInputForward(predictors, networkOutput);
 
   return outputLayer.Forward(networkOutput, responses) + network.Loss();
 }
@@ -404,6 +870,7 @@ void FFN<
       // We can clear these members, since it's not possible to serialize in the
       // middle of training and resume.
       predictors.clear();
+      sparsePredictors.reset();
       responses.clear();
 
       networkOutput.clear();
@@ -428,7 +895,7 @@ typename MatType::elem_type FFN<
 >::Evaluate(const MatType& parameters)
 {
   typename MatType::elem_type res = 0;
-  for (size_t i = 0; i < predictors.n_cols; ++i)
+  for (size_t i = 0; i < NumFunctions(); ++i)
     res += Evaluate(parameters, i, 1);
 
   return res;
@@ -445,6 +912,22 @@ typename MatType::elem_type FFN<
             const size_t begin,
             const size_t batchSize)
 {
+  if (sparsePredictors.n_cols > 0)
+  {
+    CheckNetwork("FFN::Evaluate()", sparsePredictors.n_rows);
+
+    networkOutput.set_size(network.OutputSize(), batchSize);
+    const arma::SpMat<typename MatType::elem_type> predictorsBatch =
+        sparsePredictors.cols(begin, begin + batchSize - 1);
+    MatType responsesBatch;
+    MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
+        begin * responses.n_rows);
+    network.SparseInputForward(predictorsBatch, networkOutput);
+
+    return outputLayer.Forward(networkOutput, responsesBatch) + network.Loss();
+  }
+
+  const size_t first = PrepareBatch(begin, batchSize);
   CheckNetwork("FFN::Evaluate()", predictors.n_rows);
 
   // Set networkOutput to the right size if needed, then perform the forward
@@ -452,9 +935,9 @@ typename MatType::elem_type FFN<
   networkOutput.set_size(network.OutputSize(), batchSize);
   MatType predictorsBatch, responsesBatch;
   MakeAlias(predictorsBatch, predictors, predictors.n_rows, batchSize,
-      begin * predictors.n_rows);
+      first * predictors.n_rows);
   MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
-      begin * responses.n_rows);
+      first * responses.n_rows);
   network.Forward(predictorsBatch, networkOutput);
 
   return outputLayer.Forward(networkOutput, responsesBatch) + network.Loss();
@@ -473,7 +956,7 @@ typename MatType::elem_type FFN<
   res += EvaluateWithGradient(parameters, 0, gradient, 1);
   MatType tmpGradient(gradient.n_rows, gradient.n_cols,
       GetFillType<MatType>::none);
-  for (size_t i = 1; i < predictors.n_cols; ++i)
+  for (size_t i = 1; i < NumFunctions(); ++i)
   {
     res += EvaluateWithGradient(parameters, i, tmpGradient, 1);
     gradient += tmpGradient;
@@ -494,14 +977,100 @@ typename MatType::elem_type FFN<
                         MatType& gradient,
                         const size_t batchSize)
 {
+  if (sparsePredictors.n_cols > 0)
+  {
+    CheckNetwork("FFN::EvaluateWithGradient()", sparsePredictors.n_rows);
+
+    arma::SpMat<typename MatType::elem_type> predictorsBatch;
+    const typename MatType::elem_type obj = SparseForwardBackward(begin,
+        batchSize, predictorsBatch);
+
+    gradient.set_size(parameters.n_rows, parameters.n_cols);
+    network.SparseInputGradient(predictorsBatch, error, gradient);
+
+    return obj;
+  }
+
+  const size_t first = PrepareBatch(begin, batchSize);
+  CheckNetwork("FFN::EvaluateWithGradient()", predictors.n_rows);
+
+  // Split the batch between threads, if requested.
+  size_t threads = trainingThreads;
+  #ifdef MLPACK_USE_OPENMP
+  if (threads == 0)
+    threads = omp_get_max_threads();
+  #endif
+  threads = std::min(threads, batchSize);
+  if (threads > 1)
+    return ParallelEvaluateWithGradient(first, gradient, batchSize, threads);
+
+  MatType predictorsBatch;
+  const typename MatType::elem_type obj = ForwardBackward(first, batchSize,
+      predictorsBatch);
+
+  // Now compute the gradients.
+  // The gradient should have the same size as the parameters.
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  network.Gradient(predictorsBatch, error, gradient);
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::EvaluateWithGradient(const MatType& /* parameters */,
+                        const size_t begin,
+                        arma::SpMat<typename MatType::elem_type>& gradient,
+                        const size_t batchSize)
+{
+  if (sparsePredictors.n_cols > 0)
+  {
+    CheckNetwork("FFN::EvaluateWithGradient()", sparsePredictors.n_rows);
+
+    arma::SpMat<typename MatType::elem_type> predictorsBatch;
+    const typename MatType::elem_type obj = SparseForwardBackward(begin,
+        batchSize, predictorsBatch);
+
+    network.SparseInputSparseGradient(predictorsBatch, error, gradient);
+
+    return obj;
+  }
+
+  const size_t first = PrepareBatch(begin, batchSize);
   CheckNetwork("FFN::EvaluateWithGradient()", predictors.n_rows);
 
+  MatType predictorsBatch;
+  const typename MatType::elem_type obj = ForwardBackward(first, batchSize,
+      predictorsBatch);
+
+  // Each layer gives its gradient as a sparse matrix.
+  network.SparseGradient(predictorsBatch, error, gradient);
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ForwardBackward(const size_t begin,
+                   const size_t batchSize,
+                   MatType& predictorsBatch)
+{
   // Set networkOutput to the right size if needed, then perform the forward
   // pass.
   networkOutput.set_size(network.OutputSize(), batchSize);
 
   // Alias the batches so we don't copy memory.
-  MatType predictorsBatch, responsesBatch;
+  MatType responsesBatch;
   MakeAlias(predictorsBatch, predictors, predictors.n_rows,
       batchSize, begin * predictors.n_rows);
   MakeAlias(responsesBatch, responses, responses.n_rows,
@@ -519,10 +1088,244 @@ typename MatType::elem_type FFN<
   networkDelta.set_size(predictors.n_rows, batchSize);
   network.Backward(predictorsBatch, networkOutput, error, networkDelta);
 
-  // Now compute the gradients.
-  // The gradient should have the same size as the parameters.
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SparseForwardBackward(
+    const size_t begin,
+    const size_t batchSize,
+    arma::SpMat<typename MatType::elem_type>& predictorsBatch)
+{
+  networkOutput.set_size(network.OutputSize(), batchSize);
+
+  // Only the nonzero elements of the batch are copied.
+  predictorsBatch = sparsePredictors.cols(begin, begin + batchSize - 1);
+  MatType responsesBatch;
+  MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
+      begin * responses.n_rows);
+
+  network.SparseInputForward(predictorsBatch, networkOutput);
+
+  const typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
+      responsesBatch) + network.Loss();
+
+  // Now perform the backward pass; there is no delta for the sparse input.
+  outputLayer.Backward(networkOutput, responsesBatch, error);
+  network.SparseInputBackward(networkOutput, error);
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+size_t FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PrepareBatch(const size_t begin, const size_t batchSize)
+{
+  if (pipeline == NULL)
+    return begin;
+
+  pipeline->Batch(begin, batchSize, predictors, responses);
+  return 0;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ParallelEvaluateWithGradient(const size_t begin,
+                                MatType& gradient,
+                                const size_t batchSize,
+                                const size_t threads)
+{
+  // Each part of the batch multiplies matrices in its own thread, so BLAS must
+  // be single-threaded while they run.
+  ThreadBudget budget(threads);
+
+  // Make a copy of the network for each thread but the first (which uses the
+  // network itself), if needed.  The copies share the parameters.
+  if (threadNetworks.size() != threads - 1 ||
+      threadParameters != parameters.memptr())
+  {
+    threadNetworks = std::vector<MultiLayer<MatType>>(threads - 1, network);
+    for (size_t t = 0; t < threadNetworks.size(); ++t)
+    {
+      threadNetworks[t].InputDimensions() = network.InputDimensions();
+      threadNetworks[t].ComputeOutputDimensions();
+      threadNetworks[t].SetWeights(parameters);
+    }
+
+    threadDeltas.resize(threads - 1);
+    threadGradients.resize(threads - 1);
+    threadParameters = parameters.memptr();
+  }
+
+  // Only the part of the batch of the first thread is profiled.
+  for (size_t t = 0; t < threadNetworks.size(); ++t)
+  {
+    threadNetworks[t].Training() = network.Training();
+    threadNetworks[t].Profiling() = false;
+  }
+
+  networkOutput.set_size(network.OutputSize(), batchSize);
+
+  // Run the forward pass of each part of the batch; the outputs go to the
+  // right columns of networkOutput.
+  #pragma omp parallel for num_threads(threads) schedule(static, 1)
+  for (size_t t = 0; t < threads; ++t)
+  {
+    // Each thread gets its own team, so that the OpenMP loops inside the
+    // layers are not split between the threads that run different parts.
+    #pragma omp parallel num_threads(1)
+    {
+      MultiLayer<MatType>& threadNetwork = (t == 0) ? network :
+          threadNetworks[t - 1];
+      const size_t first = t * batchSize / threads;
+      const size_t points = (t + 1) * batchSize / threads - first;
+
+      MatType predictorsPart, outputPart;
+      MakeAlias(predictorsPart, predictors, predictors.n_rows, points,
+          (begin + first) * predictors.n_rows);
+      MakeAlias(outputPart, networkOutput, networkOutput.n_rows, points,
+          first * networkOutput.n_rows);
+      threadNetwork.Forward(predictorsPart, outputPart);
+    }
+  }
+
+  // The loss is computed on the whole batch, so it does not depend on the
+  // number of threads.
+  MatType responsesBatch;
+  MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
+      begin * responses.n_rows);
+  const typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
+      responsesBatch) + network.Loss();
+  outputLayer.Backward(networkOutput, responsesBatch, error);
+
+  // Now run the backward and gradient passes of each part, each into its own
+  // gradient.
   gradient.set_size(parameters.n_rows, parameters.n_cols);
-  network.Gradient(predictorsBatch, error, gradient);
+  #pragma omp parallel for num_threads(threads) schedule(static, 1)
+  for (size_t t = 0; t < threads; ++t)
+  {
+    #pragma omp parallel num_threads(1)
+    {
+      MultiLayer<MatType>& threadNetwork = (t == 0) ? network :
+          threadNetworks[t - 1];
+      MatType& threadDelta = (t == 0) ? networkDelta : threadDeltas[t - 1];
+      MatType& threadGradient = (t == 0) ? gradient : threadGradients[t - 1];
+      const size_t first = t * batchSize / threads;
+      const size_t points = (t + 1) * batchSize / threads - first;
+
+      MatType predictorsPart, outputPart, errorPart;
+      MakeAlias(predictorsPart, predictors, predictors.n_rows, points,
+          (begin + first) * predictors.n_rows);
+      MakeAlias(outputPart, networkOutput, networkOutput.n_rows, points,
+          first * networkOutput.n_rows);
+      MakeAlias(errorPart, error, error.n_rows, points, first * error.n_rows);
+
+      threadDelta.set_size(predictors.n_rows, points);
+      threadNetwork.Backward(predictorsPart, outputPart, errorPart,
+          threadDelta);
+
+      threadGradient.set_size(parameters.n_rows, parameters.n_cols);
+      threadNetwork.Gradient(predictorsPart, errorPart, threadGradient);
+    }
+  }
+
+  // Sum the gradients of all the parts.
+  for (size_t t = 0; t < threadGradients.size(); ++t)
+    gradient += threadGradients[t];
+
+  return obj;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename CommunicatorType>
+typename MatType::elem_type FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::DistributedEvaluateWithGradient(const size_t begin,
+                                   MatType& gradient,
+                                   const size_t batchSize,
+                                   CommunicatorType& comm,
+                                   const size_t bucketSize)
+{
+  CheckNetwork("FFN::EvaluateWithGradient()", predictors.n_rows);
+
+  size_t threads = trainingThreads;
+  #ifdef MLPACK_USE_OPENMP
+  if (threads == 0)
+    threads = omp_get_max_threads();
+  #endif
+  threads = std::min(threads, batchSize);
+  if (threads > 1)
+  {
+    // The gradient is only complete once every part of the batch is done.
+    typename MatType::elem_type obj = ParallelEvaluateWithGradient(begin,
+        gradient, batchSize, threads);
+    comm.StartAllReduceSum(&obj, 1);
+    comm.StartAllReduceSum(gradient.memptr(), gradient.n_elem);
+    comm.WaitAll();
+    return obj;
+  }
+
+  networkOutput.set_size(network.OutputSize(), batchSize);
+  MatType predictorsBatch, responsesBatch;
+  MakeAlias(predictorsBatch, predictors, predictors.n_rows, batchSize,
+      begin * predictors.n_rows);
+  MakeAlias(responsesBatch, responses, responses.n_rows, batchSize,
+      begin * responses.n_rows);
+  network.Forward(predictorsBatch, networkOutput);
+
+  typename MatType::elem_type obj = outputLayer.Forward(networkOutput,
+      responsesBatch) + network.Loss();
+  comm.StartAllReduceSum(&obj, 1);
+
+  outputLayer.Backward(networkOutput, responsesBatch, error);
+
+  // The gradients of the layers are computed from the last one, and each
+  // layer's gradient is just before the next layer's in `gradient`; so the
+  // gradients that are not summed yet are always contiguous.  They are summed
+  // as soon as there are enough of them, during the backward pass of the
+  // previous layers.
+  typename MatType::elem_type* bucket = NULL;
+  size_t bucketElements = 0;
+  networkDelta.set_size(predictors.n_rows, batchSize);
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  network.BackwardGradient(predictorsBatch, networkOutput, error, networkDelta,
+      gradient, [&](MatType& layerGradient)
+      {
+        if (layerGradient.n_elem == 0)
+          return;
+
+        bucket = layerGradient.memptr();
+        bucketElements += layerGradient.n_elem;
+        if (bucketElements >= bucketSize)
+        {
+          comm.StartAllReduceSum(bucket, bucketElements);
+          bucketElements = 0;
+        }
+      });
+
+  if (bucketElements > 0)
+    comm.StartAllReduceSum(bucket, bucketElements);
+  comm.WaitAll();
 
   return obj;
 }
@@ -542,6 +1345,21 @@ void FFN<
   this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(const MatType& parameters,
+            const size_t begin,
+            arma::SpMat<typename MatType::elem_type>& gradient,
+            const size_t batchSize)
+{
+  this->EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -551,7 +1369,12 @@ void FFN<
     MatType
 >::Shuffle()
 {
-  ShuffleData(predictors, responses, predictors, responses);
+  if (pipeline != NULL)
+    pipeline->Shuffle();
+  else if (sparsePredictors.n_cols > 0)
+    ShuffleData(sparsePredictors, responses, sparsePredictors, responses);
+  else
+    ShuffleData(predictors, responses, predictors, responses);
 }
 
 template<typename OutputLayerType,
@@ -564,6 +1387,25 @@ void FFN<
 >::ResetData(MatType predictors, MatType responses)
 {
   this->predictors = std::move(predictors);
+  this->sparsePredictors.reset();
+  this->responses = std::move(responses);
+
+  // Set the network to training mode.
+  SetNetworkMode(true);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetData(arma::SpMat<typename MatType::elem_type> predictors,
+             MatType responses)
+{
+  this->predictors.clear();
+  this->sparsePredictors = std::move(predictors);
   this->responses = std::move(responses);
 
   // Set the network to training mode.
@@ -603,6 +1445,9 @@ void FFN<
 
   network.SetWeights(parameters);
   layerMemoryIsSet = true;
+
+  // The copies of the network for training threads must be made again.
+  threadParameters = NULL;
 }
 
 template<typename OutputLayerType,
@@ -652,6 +1497,138 @@ void FFN<
     SetNetworkMode(training);
 }
 
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::CheckFrozenNetwork(const std::string& functionName,
+                      const size_t inputDimensionality,
+                      FFNWorkspace<MatType>& workspace,
+                      const size_t batchSize) const
+{
+  if (!inputDimensionsAreSet || !layerMemoryIsSet)
+  {
+    throw std::logic_error(functionName + ": the network must be prepared with "
+        "Freeze() before predicting with a workspace!");
+  }
+
+  size_t inputSize = 1;
+  for (size_t i = 0; i < inputDimensions.size(); ++i)
+    inputSize *= inputDimensions[i];
+  if (inputDimensionality != inputSize)
+  {
+    throw std::invalid_argument(functionName + ": input size does not match "
+        "expected size set with InputDimensions()!");
+  }
+
+  if (!workspace.IsSetUp(network.Network().size(), parameters, batchSize))
+    workspace.Reset(network.Network(), parameters, batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+Layer<MatType>* FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::QuantizedLayer(Layer<MatType>* layer, const double inputScale)
+{
+  LinearType<MatType>* linear = dynamic_cast<LinearType<MatType>*>(layer);
+  if (linear != nullptr)
+  {
+    return new QuantizedLinearType<MatType>(linear->Weight(), linear->Bias(),
+        inputScale);
+  }
+
+  LinearNoBiasType<MatType>* linearNoBias =
+      dynamic_cast<LinearNoBiasType<MatType>*>(layer);
+  if (linearNoBias != nullptr)
+  {
+    // LinearNoBias only exposes its flat parameters; view them with one row
+    // per output unit.
+    MatType weight;
+    MakeAlias(weight, linearNoBias->Parameters(), linearNoBias->OutputSize(),
+        linearNoBias->WeightSize() / linearNoBias->OutputSize());
+    return new QuantizedLinearType<MatType>(weight, MatType(), inputScale);
+  }
+
+  Layer<MatType>* conv = QuantizedConvolutionLayer<ConvolutionType<
+      NaiveConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>, MatType>>(layer, inputScale);
+  if (conv == NULL)
+  {
+    conv = QuantizedConvolutionLayer<ConvolutionType<
+        Im2ColConvolution<ValidConvolution>,
+        Im2ColConvolution<FullConvolution>,
+        Im2ColConvolution<ValidConvolution>, MatType>>(layer, inputScale);
+  }
+
+  return conv;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+Layer<MatType>* FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PrunedLayer(Layer<MatType>* layer,
+               const double sparsity,
+               const size_t blockSize)
+{
+  LinearType<MatType>* linear = dynamic_cast<LinearType<MatType>*>(layer);
+  if (linear != nullptr)
+  {
+    MatType weight(linear->Weight());
+    PruneWeights(weight, sparsity, blockSize);
+    return new SparseLinearType<MatType>(weight, linear->Bias(), blockSize);
+  }
+
+  LinearNoBiasType<MatType>* linearNoBias =
+      dynamic_cast<LinearNoBiasType<MatType>*>(layer);
+  if (linearNoBias != nullptr)
+  {
+    // LinearNoBias only exposes its flat parameters; copy them with one row
+    // per output unit.
+    MatType weight = arma::reshape(linearNoBias->Parameters(),
+        linearNoBias->OutputSize(),
+        linearNoBias->WeightSize() / linearNoBias->OutputSize());
+    PruneWeights(weight, sparsity, blockSize);
+    return new SparseLinearType<MatType>(weight, MatType(), blockSize);
+  }
+
+  return NULL;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename ConvType>
+Layer<MatType>* FFN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::QuantizedConvolutionLayer(Layer<MatType>* layer, const double inputScale)
+{
+  ConvType* conv = dynamic_cast<ConvType*>(layer);
+  if (conv == nullptr)
+    return NULL;
+
+  // The bias is only part of the weights if the layer uses one.
+  const bool useBias = (conv->WeightSize() == conv->Weight().n_elem +
+      conv->Maps());
+  return new QuantizedConvolutionType<MatType>(conv->Weight(),
+      useBias ? conv->Bias() : MatType(), conv->Maps(), conv->StrideWidth(),
+      conv->StrideHeight(), conv->PadWLeft(), conv->PadWRight(),
+      conv->PadHTop(), conv->PadHBottom(), inputScale);
+}
+
 template<typename OutputLayerType,
          typename InitializationRuleType,
          typename MatType>
@@ -0,0 +1,384 @@
+/**
+ * @file methods/ann/ffn_workspace.hpp
+ *
+ * Definition of the FFNWorkspace class, which holds everything a thread needs
+ * to make predictions with a shared feedforward network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_WORKSPACE_HPP
+#define MLPACK_METHODS_ANN_FFN_WORKSPACE_HPP
+
+#include <mlpack/core.hpp>
+
+#include "layer/layer.hpp"
+#include "layer/recurrent_layer.hpp"
+
+namespace mlpack {
+
+/**
+ * The workspace for inference with a frozen FFN (see FFN::Freeze()).  It holds
+ * copies of the layers of the network in testing mode, whose weights are
+ * aliases of the parameters of the network, and two activation buffers sized
+ * for the largest layer, that the layers write to in turn.  Delta and gradient
+ * buffers are never allocated.
+ *
+ * Layers keep temporary state during Forward() (and recurrent layers keep the
+ * state of the previous time steps), so a network can't be used by several
+ * threads at once; but with one FFNWorkspace per thread, any number of threads
+ * can call FFN::Predict() (or RNN::Predict()) with the same network
+ * concurrently.  Once the workspace is set up (by the first call to
+ * Predict()), predictions of at most BatchSize() points at a time do not
+ * allocate the activations again.
+ *
+ * If `fuseLayers` is true, the copies of the layers are also simplified for
+ * inference when the workspace is set up: a BatchNorm layer that follows a
+ * Linear or Convolution layer (with a bias) is folded into the weights and bias
+ * of that layer, which are then stored in the workspace, and elementwise
+ * activations (ReLU, Sigmoid, TanH, LeakyReLU, HardTanH, ELU) are applied in
+ * place to the output of the layer before them, so that they don't need a pass
+ * over a second buffer.  The predictions are the same, up to rounding.
+ *
+ * @tparam MatType Matrix representation used by the network.
+ */
+template<typename MatType = arma::mat>
+class FFNWorkspace
+{
+ public:
+  /**
+   * Create an empty workspace; it is set up by FFN::Predict().
+   *
+   * @param fuseLayers Whether to fold BatchNorm layers and fuse activations
+   *     when the workspace is set up.
+   */
+  FFNWorkspace(const bool fuseLayers = false) :
+      fuseLayers(fuseLayers),
+      networkSize(0),
+      parameters(NULL),
+      numParameters(0),
+      batchSize(0)
+  { }
+
+  //! Workspaces can't be copied, as each one is meant for one thread.
+  FFNWorkspace(const FFNWorkspace&) = delete;
+  //! Workspaces can't be copied, as each one is meant for one thread.
+  FFNWorkspace& operator=(const FFNWorkspace&) = delete;
+
+  //! Take ownership of the layers and buffers of the given workspace.
+  FFNWorkspace(FFNWorkspace&& other) :
+      layers(std::move(other.layers)),
+      inPlace(std::move(other.inPlace)),
+      foldedWeights(std::move(other.foldedWeights)),
+      fuseLayers(other.fuseLayers),
+      networkSize(other.networkSize),
+      parameters(other.parameters),
+      numParameters(other.numParameters),
+      batchSize(other.batchSize)
+  {
+    activations[0] = std::move(other.activations[0]);
+    activations[1] = std::move(other.activations[1]);
+    other.layers.clear();
+    other.inPlace.clear();
+    other.foldedWeights.clear();
+    other.networkSize = 0;
+    other.parameters = NULL;
+    other.numParameters = 0;
+    other.batchSize = 0;
+  }
+
+  //! Free the copies of the layers.
+  ~FFNWorkspace() { Clear(); }
+
+  /**
+   * Set up the workspace for the given layers, whose input dimensions must be
+   * set, and their parameters.  The parameters are not copied, so they must
+   * not be freed while the workspace is in use.
+   *
+   * @param network Layers of the network.
+   * @param parametersIn Parameters of all the layers.
+   * @param batchSizeIn Maximum number of points of each forward pass.
+   */
+  void Reset(const std::vector<Layer<MatType>*>& network,
+             const MatType& parametersIn,
+             const size_t batchSizeIn)
+  {
+    Clear();
+
+    size_t start = 0;
+    size_t maxOutputSize = 0;
+    layers.reserve(network.size());
+    inPlace.reserve(network.size());
+    // The folded weights must not move, as the layers hold aliases of them.
+    foldedWeights.reserve(network.size());
+    for (size_t i = 0; i < network.size(); ++i)
+    {
+      Layer<MatType>* layer = network[i]->Clone();
+      layer->Training() = false;
+      layer->InputDimensions() = network[i]->InputDimensions();
+      layer->ComputeOutputDimensions();
+
+      const size_t weightSize = layer->WeightSize();
+      Log::Assert(start + weightSize <= parametersIn.n_elem,
+          "FFNWorkspace::Reset(): parameter size does not match total layer "
+          "weight size!");
+      MatType layerWeights;
+      MakeAlias(layerWeights, parametersIn, weightSize, 1, start);
+      layer->SetWeights(layerWeights);
+      start += weightSize;
+
+      // An elementwise activation can overwrite the output of the layer before
+      // it, unless that is the input of the network, or it is the last layer.
+      inPlace.push_back(fuseLayers && !layers.empty() &&
+          i + 1 < network.size() && IsElementwise(layer));
+
+      if (fuseLayers && i + 1 < network.size())
+      {
+        const BatchNormType<MatType>* batchNorm =
+            dynamic_cast<const BatchNormType<MatType>*>(network[i + 1]);
+        if (batchNorm != nullptr &&
+            start + batchNorm->WeightSize() <= parametersIn.n_elem &&
+            FoldBatchNorm(layer, *batchNorm, parametersIn, start))
+        {
+          // The BatchNorm layer is not needed anymore.
+          start += batchNorm->WeightSize();
+          ++i;
+        }
+      }
+
+      // The output of the last layer goes directly to the results.
+      if (i + 1 < network.size())
+        maxOutputSize = std::max(maxOutputSize, layer->OutputSize());
+      layers.push_back(layer);
+    }
+
+    activations[0].set_size(maxOutputSize, batchSizeIn);
+    activations[1].set_size(maxOutputSize, batchSizeIn);
+    networkSize = network.size();
+    parameters = parametersIn.memptr();
+    numParameters = parametersIn.n_elem;
+    batchSize = batchSizeIn;
+  }
+
+  /**
+   * Return true if the workspace is set up for a network with the given number
+   * of layers and parameters, and for passes of the given number of points.
+   */
+  bool IsSetUp(const size_t numLayers,
+               const MatType& parametersIn,
+               const size_t numPoints) const
+  {
+    return (networkSize == numLayers && parameters == parametersIn.memptr() &&
+        numParameters == parametersIn.n_elem && numPoints <= batchSize);
+  }
+
+  /**
+   * Pass the input through the copies of the layers.  The input must have at
+   * most BatchSize() columns, and the output must already have the right size.
+   *
+   * @param input Input data.
+   * @param output Output of the last layer.
+   */
+  void Forward(const MatType& input, MatType& output)
+  {
+    const MatType* layerInput = &input;
+    MatType layerOutputs[2];
+    size_t next = 0;
+    for (size_t i = 0; i + 1 < layers.size(); ++i)
+    {
+      if (inPlace[i])
+      {
+        // Overwrite the output of the previous layer.
+        MatType& layerOutput = layerOutputs[1 - next];
+        layers[i]->Forward(layerOutput, layerOutput);
+        continue;
+      }
+
+      MatType& layerOutput = layerOutputs[next];
+      MakeAlias(layerOutput, activations[next], layers[i]->OutputSize(),
+          input.n_cols);
+      layers[i]->Forward(*layerInput, layerOutput);
+      layerInput = &layerOutput;
+      next = 1 - next;
+    }
+
+    layers.back()->Forward(*layerInput, output);
+  }
+
+  /**
+   * Clear the state of the copies of the recurrent layers, so that they store
+   * up to `memorySize` previous states for the given batch size (see
+   * RecurrentLayer::ClearRecurrentState()).
+   */
+  void ClearRecurrentState(const size_t memorySize, const size_t batchSizeIn)
+  {
+    for (Layer<MatType>* l : layers)
+    {
+      RecurrentLayer<MatType>* r = dynamic_cast<RecurrentLayer<MatType>*>(l);
+      if (r != nullptr)
+        r->ClearRecurrentState(memorySize, batchSizeIn);
+    }
+  }
+
+  //! Set the current step index of the copies of the recurrent layers.
+  void CurrentStep(const size_t step, const bool end)
+  {
+    for (Layer<MatType>* l : layers)
+    {
+      RecurrentLayer<MatType>* r = dynamic_cast<RecurrentLayer<MatType>*>(l);
+      if (r != nullptr)
+        r->CurrentStep(step, end);
+    }
+  }
+
+  //! Get the maximum number of points of each forward pass.
+  size_t BatchSize() const { return batchSize; }
+
+  //! Get whether BatchNorm layers are folded and activations are fused.
+  bool FuseLayers() const { return fuseLayers; }
+
+  //! Get the copies of the layers.
+  const std::vector<Layer<MatType>*>& Layers() const { return layers; }
+
+ private:
+  //! Free the copies of the layers.
+  void Clear()
+  {
+    for (size_t i = 0; i < layers.size(); ++i)
+      delete layers[i];
+    layers.clear();
+    inPlace.clear();
+    foldedWeights.clear();
+  }
+
+  //! Return true if the layer is an activation that can be computed in place.
+  static bool IsElementwise(const Layer<MatType>* layer)
+  {
+    return (dynamic_cast<const ReLUType<MatType>*>(layer) != nullptr ||
+        dynamic_cast<const SigmoidType<MatType>*>(layer) != nullptr ||
+        dynamic_cast<const TanHType<MatType>*>(layer) != nullptr ||
+        dynamic_cast<const LeakyReLUType<MatType>*>(layer) != nullptr ||
+        dynamic_cast<const HardTanHType<MatType>*>(layer) != nullptr ||
+        dynamic_cast<const ELUType<MatType>*>(layer) != nullptr);
+  }
+
+  /**
+   * Fold the given BatchNorm layer, whose weights start at `start` in the
+   * parameters, into the weights of the given copy of a Linear or Convolution
+   * layer with a bias.  Return false if the layer is of another kind, or if
+   * the channels of the BatchNorm layer don't match its outputs.
+   */
+  bool FoldBatchNorm(Layer<MatType>* layer,
+                     const BatchNormType<MatType>& batchNorm,
+                     const MatType& parametersIn,
+                     const size_t start)
+  {
+    typedef typename MatType::elem_type ElemType;
+
+    // In testing mode, BatchNorm computes
+    // scale * (x - mean) + beta, with scale = gamma / sqrt(variance + eps).
+    MatType gamma, beta;
+    MakeAlias(gamma, parametersIn, batchNorm.InputSize(), 1, start);
+    MakeAlias(beta, parametersIn, batchNorm.InputSize(), 1,
+        start + batchNorm.InputSize());
+    const MatType scale = gamma / sqrt(batchNorm.TrainingVariance() +
+        (ElemType) batchNorm.Epsilon());
+    const MatType shift = beta - scale % batchNorm.TrainingMean();
+
+    LinearType<MatType>* linear = dynamic_cast<LinearType<MatType>*>(layer);
+    if (linear != nullptr)
+    {
+      // Each output of the layer belongs to the channel
+      // (index / InputDimension()) % InputSize().
+      const size_t outSize = linear->Weight().n_rows;
+      if (outSize != batchNorm.InputDimension() * batchNorm.InputSize() *
+          batchNorm.HigherDimension())
+        return false;
+
+      foldedWeights.push_back(linear->Parameters());
+      linear->SetWeights(foldedWeights.back());
+      for (size_t i = 0; i < outSize; ++i)
+      {
+        const size_t c = (i / batchNorm.InputDimension()) %
+            batchNorm.InputSize();
+        linear->Weight().row(i) *= scale[c];
+        linear->Bias()[i] = scale[c] * linear->Bias()[i] + shift[c];
+      }
+      return true;
+    }
+
+    return FoldIntoConvolution<ConvolutionType<
+            NaiveConvolution<ValidConvolution>,
+            NaiveConvolution<FullConvolution>,
+            NaiveConvolution<ValidConvolution>, MatType>>(layer, batchNorm,
+            scale, shift) ||
+        FoldIntoConvolution<ConvolutionType<
+            Im2ColConvolution<ValidConvolution>,
+            Im2ColConvolution<FullConvolution>,
+            Im2ColConvolution<ValidConvolution>, MatType>>(layer, batchNorm,
+            scale, shift);
+  }
+
+  /**
+   * Fold the scale and shift of a BatchNorm layer into the filters and bias of
+   * the given copy of a convolution layer, if it is of type ConvType, it has a
+   * bias and every output map is a channel of the BatchNorm layer.
+   */
+  template<typename ConvType>
+  bool FoldIntoConvolution(Layer<MatType>* layer,
+                           const BatchNormType<MatType>& batchNorm,
+                           const MatType& scale,
+                           const MatType& shift)
+  {
+    ConvType* conv = dynamic_cast<ConvType*>(layer);
+    if (conv == nullptr || conv->WeightSize() != conv->Weight().n_elem +
+        conv->Maps())
+      return false;
+
+    const std::vector<size_t>& outputDimensions = conv->OutputDimensions();
+    if (batchNorm.InputSize() != conv->Maps() || batchNorm.InputDimension() !=
+        outputDimensions[0] * outputDimensions[1])
+      return false;
+
+    foldedWeights.push_back(conv->Parameters());
+    conv->SetWeights(foldedWeights.back());
+    const size_t inMaps = conv->Weight().n_slices / conv->Maps();
+    for (size_t outMap = 0; outMap < conv->Maps(); ++outMap)
+    {
+      for (size_t inMap = 0; inMap < inMaps; ++inMap)
+        conv->Weight().slice(outMap * inMaps + inMap) *= scale[outMap];
+      conv->Bias()[outMap] = scale[outMap] * conv->Bias()[outMap] +
+          shift[outMap];
+    }
+    return true;
+  }
+
+  //! Copies of the layers of the network, in testing mode.
+  std::vector<Layer<MatType>*> layers;
+  //! Whether each copy of a layer overwrites the output of the previous one.
+  std::vector<bool> inPlace;
+  //! The weights of the layers that BatchNorm layers were folded into.
+  std::vector<MatType> foldedWeights;
+  //! Whether BatchNorm layers are folded and activations are fused.
+  bool fuseLayers;
+  //! The number of layers of the network the workspace is set up for.
+  size_t networkSize;
+  //! The two activation buffers.
+  MatType activations[2];
+  //! The parameters the weights of the layers are aliases of.
+  const typename MatType::elem_type* parameters;
+  //! The number of parameters.
+  size_t numParameters;
+  //! The maximum number of points of each forward pass.
+  size_t batchSize;
+};
+
+//! The workspace for inference with a frozen RNN is the same as for an FFN.
+template<typename MatType = arma::mat>
+using RNNWorkspace = FFNWorkspace<MatType>;
+
+} // namespace mlpack
+
+#endif
@@ -69,7 +69,7 @@ class KathirvalavakumarSubavathiInitialization
   KathirvalavakumarSubavathiInitialization(const MatType& data,
                                            const double s) : s(s)
   {
-    dataSum = sum(data % data);
+    dataSum = ConvTo<arma::rowvec>::From(sum(data % data));
   }
 
   /**
@@ -83,8 +83,7 @@ class KathirvalavakumarSubavathiInitialization
   template<typename MatType>
   void Initialize(MatType& W, const size_t rows, const size_t cols)
   {
-    using RowType = typename GetRowType<MatType>::type;
-    RowType b = s * sqrt(3 / (rows * dataSum));
+    arma::rowvec b = s * sqrt(3 / (rows * dataSum));
     const double theta = b.min();
     RandomInitialization randomInit(-theta, theta);
     randomInit.Initialize(W, rows, cols);
@@ -100,8 +99,7 @@ class KathirvalavakumarSubavathiInitialization
   void Initialize(MatType& W,
       const typename std::enable_if_t<IsMatrix<MatType>::value>* = 0)
   {
-    using RowType = typename GetRowType<MatType>::type;
-    RowType b = s * sqrt(3 / (W.n_rows * dataSum));
+    arma::rowvec b = s * sqrt(3 / (W.n_rows * dataSum));
     const double theta = b.min();
     RandomInitialization randomInit(-theta, theta);
     randomInit.Initialize(W);
@@ -87,12 +87,46 @@ class AddMergeType : public MultiLayer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  /**
+   * Compute the gradient with `Gradient()` and convert it to a sparse matrix;
+   * the sequential version of `MultiLayer` can't be used here.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated sparse gradient.
+   */
+  void SparseGradient(const MatType& input,
+                      const MatType& error,
+                      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    Layer<MatType>::SparseGradient(input, error, gradient);
+  }
+
+  /**
+   * The sequential sparse-input passes of `MultiLayer` can't be used here,
+   * so this layer can't be the first layer of a network with sparse input.
+   */
+  void SparseInputForward(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      MatType& output)
+  {
+    Layer<MatType>::SparseInputForward(input, output);
+  }
+
   //! Compute the size of the output given `InputDimensions()`.
   void ComputeOutputDimensions();
 
   //! Serialize the AddMergeType.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Memory for the output of all layers but the first during the forward
+  //! pass.
+  MatType tempOutput;
+  //! Memory for the delta of all layers but the first during the backward
+  //! pass.
+  MatType tempDelta;
 };
 
 using AddMerge = AddMergeType<arma::mat>;
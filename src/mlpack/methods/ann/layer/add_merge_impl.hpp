@@ -68,18 +68,14 @@ void AddMergeType<MatType>::Forward(
   for (size_t i = 0; i < this->network.size(); ++i)
     this->network[i]->Training() = this->training;
 
-  // Note that we use `output` for the last layer; layerOutputs is only used for
-  // intermediate values between layers.
   if (this->network.size() > 1)
   {
-    // Initialize temporary memory for the forward pass.
-    MatType tempOutput;
+    // Forward pass every layer in network with same input.  Reduce the outputs
+    // to single output by adding element-wise; the first layer writes directly
+    // into `output`, and the memory for the other layers is reused between
+    // calls.
+    this->network[0]->Forward(input, output);
     tempOutput.set_size(arma::size(output));
-
-    // Forward pass every layer in network with same input.
-    // Reduce the outputs to single output by adding element-wise.
-    this->network[0]->Forward(input, tempOutput);
-    output = tempOutput;
     for (size_t i = 1; i < this->network.size(); i++)
     {
       this->network[i]->Forward(input, tempOutput);
@@ -106,12 +102,10 @@ void AddMergeType<MatType>::Backward(
 {
   if (this->network.size() > 1)
   {
-    // Initialize temporary memory for the backward pass.
-    MatType tempDelta;
+    // Just like the forward pass, the first layer writes directly into `g`.
+    this->network[0]->Backward(input, output, gy, g);
     tempDelta.set_size(arma::size(g));
-
-    g.zeros();
-    for (size_t i = 0; i < this->network.size(); i++)
+    for (size_t i = 1; i < this->network.size(); i++)
     {
       this->network[i]->Backward(input, output, gy, tempDelta);
       g += tempDelta;
@@ -190,6 +190,12 @@ class BatchNormType : public Layer<MatType>
   //! Get the number of input units / channels.
   size_t InputSize() const { return size; }
 
+  //! Get the number of elements of each channel in the axes below minAxis.
+  size_t InputDimension() const { return inputDimension; }
+
+  //! Get the number of groups of channels in the axes above maxAxis.
+  size_t HigherDimension() const { return higherDimension; }
+
   //! Get the epsilon value.
   const double &Epsilon() const { return eps; }
   //! Modify the epsilon.
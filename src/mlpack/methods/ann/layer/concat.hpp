@@ -116,6 +116,32 @@ class ConcatType : public MultiLayer<MatType>
                 const MatType& error,
                 MatType& /* gradient */);
 
+  /**
+   * Compute the gradient with `Gradient()` and convert it to a sparse matrix;
+   * the sequential version of `MultiLayer` can't be used here.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated sparse gradient.
+   */
+  void SparseGradient(const MatType& input,
+                      const MatType& error,
+                      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    Layer<MatType>::SparseGradient(input, error, gradient);
+  }
+
+  /**
+   * The sequential sparse-input passes of `MultiLayer` can't be used here,
+   * so this layer can't be the first layer of a network with sparse input.
+   */
+  void SparseInputForward(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      MatType& output)
+  {
+    Layer<MatType>::SparseInputForward(input, output);
+  }
+
   /**
    * This is the overload of Gradient() that runs a specific layer with the
    * given input.
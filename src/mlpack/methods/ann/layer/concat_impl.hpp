@@ -90,17 +90,7 @@ ConcatType<MatType>& ConcatType<MatType>::operator=(ConcatType&& other)
 template<typename MatType>
 void ConcatType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  // The implementation of MultiLayer is fine: this will allocate a matrix that
-  // is able to hold each child layer's output.
-  this->InitializeForwardPassMemory(input.n_cols);
-
-  // Pass the input through all the layers in the network.
-  for (size_t i = 0; i < this->network.size(); ++i)
-  {
-    this->network[i]->Forward(input, this->layerOutputs[i]);
-  }
-
-  // Now concatenate the outputs along the correct axis.
+  // The outputs are concatenated along the correct axis.
   // We can actually use Armadillo to do this for us---we will treat the axis of
   // interest as "columns", any axes that come before the axis of interest as
   // 'flattened slices', and any axes that come after the axis of interest as
@@ -119,6 +109,35 @@ void ConcatType<MatType>::Forward(const MatType& input, MatType& output)
   for (size_t i = axis + 1; i < this->outputDimensions.size(); ++i)
     slices *= this->outputDimensions[i];
 
+  if (slices == 1)
+  {
+    // The output of each layer is a contiguous block of `output` (this is the
+    // case for a single point, when concatenating along the last axis), so the
+    // layers can write directly into aliases of `output`, like FFN aliases the
+    // weights of each layer, and nothing has to be copied.  The aliases are
+    // kept in `layerOutputs` for the backward pass.
+    size_t start = 0;
+    for (size_t i = 0; i < this->network.size(); ++i)
+    {
+      const size_t layerOutputSize = this->network[i]->OutputSize();
+      MakeAlias(this->layerOutputs[i], output, layerOutputSize, 1, start);
+      this->network[i]->Forward(input, this->layerOutputs[i]);
+      start += layerOutputSize;
+    }
+
+    return;
+  }
+
+  // Otherwise, the implementation of MultiLayer is fine: this will allocate a
+  // matrix that is able to hold each child layer's output.
+  this->InitializeForwardPassMemory(input.n_cols);
+
+  // Pass the input through all the layers in the network.
+  for (size_t i = 0; i < this->network.size(); ++i)
+  {
+    this->network[i]->Forward(input, this->layerOutputs[i]);
+  }
+
   std::vector<arma::Cube<typename MatType::elem_type>> layerOutputAliases(
       this->layerOutputs.size());
   for (size_t i = 0; i < this->layerOutputs.size(); ++i)
@@ -170,9 +189,18 @@ void ConcatType<MatType>::Backward(
   for (size_t i = 0; i < this->network.size(); ++i)
   {
     const size_t cols = this->network[i]->OutputDimensions()[axis];
-    MatType delta = gyTmp.cols(startCol, startCol + cols - 1);
-    // Reshape so that the batch size is the number of columns.
-    delta.reshape(delta.n_elem / gy.n_cols, gy.n_cols);
+    MatType delta;
+    if (slices == 1)
+    {
+      // The error of the layer is a contiguous block of `gy`.
+      MakeAlias(delta, gy, rows * cols, 1, rows * startCol);
+    }
+    else
+    {
+      delta = gyTmp.cols(startCol, startCol + cols - 1);
+      // Reshape so that the batch size is the number of columns.
+      delta.reshape(delta.n_elem / gy.n_cols, gy.n_cols);
+    }
     this->network[i]->Backward(
         input,
         this->layerOutputs[i],
@@ -219,9 +247,18 @@ void ConcatType<MatType>::Backward(
   }
 
   const size_t cols = this->network[index]->OutputDimensions()[axis];
-  MatType delta = gyTmp.cols(startCol, startCol + cols - 1);
-  // Reshape so that the batch size is the number of columns.
-  delta.reshape(delta.n_elem / gy.n_cols, gy.n_cols);
+  MatType delta;
+  if (slices == 1)
+  {
+    // The error of the layer is a contiguous block of `gy`.
+    MakeAlias(delta, gy, rows * cols, 1, rows * startCol);
+  }
+  else
+  {
+    delta = gyTmp.cols(startCol, startCol + cols - 1);
+    // Reshape so that the batch size is the number of columns.
+    delta.reshape(delta.n_elem / gy.n_cols, gy.n_cols);
+  }
 
   this->network[index]->Backward(input, this->layerOutputs[index], delta, g);
 }
@@ -253,8 +290,16 @@ void ConcatType<MatType>::Gradient(
     const size_t cols = this->network[i]->OutputDimensions()[axis];
     const size_t params = this->network[i]->WeightSize();
 
-    MatType err = errorTmp.cols(startCol, startCol + cols - 1);
-    err.reshape(err.n_elem / input.n_cols, input.n_cols);
+    MatType err;
+    if (slices == 1)
+    {
+      MakeAlias(err, error, rows * cols, 1, rows * startCol);
+    }
+    else
+    {
+      err = errorTmp.cols(startCol, startCol + cols - 1);
+      err.reshape(err.n_elem / input.n_cols, input.n_cols);
+    }
     MatType gradientAlias;
     MakeAlias(gradientAlias, gradient, params, 1, startParam);
     this->network[i]->Gradient(input, err, gradientAlias);
@@ -296,8 +341,16 @@ void ConcatType<MatType>::Gradient(
   const size_t cols = this->network[index]->OutputDimensions()[axis];
   const size_t params = this->network[index]->WeightSize();
 
-  MatType err = errorTmp.cols(startCol, startCol + cols - 1);
-  err.reshape(err.n_elem / input.n_cols, input.n_cols);
+  MatType err;
+  if (slices == 1)
+  {
+    MakeAlias(err, error, rows * cols, 1, rows * startCol);
+  }
+  else
+  {
+    err = errorTmp.cols(startCol, startCol + cols - 1);
+    err.reshape(err.n_elem / input.n_cols, input.n_cols);
+  }
   MatType gradientAlias;
   MakeAlias(gradientAlias, gradient, params, 1, startParam);
   this->network[index]->Gradient(input, err, gradientAlias);
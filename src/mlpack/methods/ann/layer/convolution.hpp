@@ -13,11 +13,14 @@
 #define MLPACK_METHODS_ANN_LAYER_CONVOLUTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/threads.hpp>
 
 #include <mlpack/methods/ann/convolution_rules/border_modes.hpp>
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer.hpp"
@@ -260,6 +263,14 @@ class ConvolutionType : public Layer<MatType>
         (useBias ? maps : 0);
   }
 
+  //! Estimate the floating-point operations of Forward() for one point: each
+  //! output element takes a multiply-add for each weight of its kernels.
+  double ForwardFLOPs()
+  {
+    return (2.0 * inMaps * kernelWidth * kernelHeight + 1) *
+        this->OutputSize();
+  }
+
   //! Compute the output dimensions of the layer based on `InputDimensions()`.
   void ComputeOutputDimensions();
 
@@ -294,6 +305,38 @@ class ConvolutionType : public Layer<MatType>
    */
   void InitializeSamePadding();
 
+  /**
+   * Forward pass with the Im2ColConvolution rule: for each input point, the
+   * patches of all the input maps are unrolled, and all the output maps are
+   * computed with one matrix product with the filters.
+   *
+   * @param input The (padded) input.
+   * @param output The output of the layer.
+   */
+  void ForwardGEMM(const MatType& input, MatType& output);
+
+  /**
+   * Backward pass with the Im2ColConvolution rule: the error of the patches is
+   * computed with one matrix product with the filters, and is then added back
+   * to the input maps with Col2Im().  gTemp must be an alias of g.
+   *
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void BackwardGEMM(const MatType& gy, MatType& g);
+
+  /**
+   * Gradient computation with the Im2ColConvolution rule: the gradient of the
+   * filters is the product of the unrolled patches with the error.
+   *
+   * @param input The (padded) input.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void GradientGEMM(const MatType& input,
+                    const MatType& error,
+                    MatType& gradient);
+
   /**
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -402,6 +445,12 @@ using Convolution = ConvolutionType<NaiveConvolution<ValidConvolution>,
                                     NaiveConvolution<ValidConvolution>,
                                     arma::mat>;
 
+// Convolution layer that lowers the convolutions to matrix products (im2col).
+using GEMMConvolution = ConvolutionType<Im2ColConvolution<ValidConvolution>,
+                                        Im2ColConvolution<FullConvolution>,
+                                        Im2ColConvolution<ValidConvolution>,
+                                        arma::mat>;
+
 } // namespace mlpack
 
 // Include implementation.
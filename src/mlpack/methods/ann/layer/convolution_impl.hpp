@@ -321,6 +321,46 @@ void ConvolutionType<
       this->outputDimensions[1], maps * higherInDimensions * batchSize);
   outputTemp.zeros();
 
+  if constexpr (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardGEMM(usingPadding ? inputPadded : input, output);
+    return;
+  }
+
+  // With the default rule, 3x3 filters with unit strides are convolved with
+  // the Winograd transform instead, for all the maps of a point at once.
+  if constexpr (std::is_same_v<ForwardConvolutionRule,
+      NaiveConvolution<ValidConvolution>>)
+  {
+    if (WinogradConvolution<>::Supports(kernelWidth, kernelHeight,
+        strideWidth, strideHeight))
+    {
+      CubeType transformedFilters;
+      WinogradConvolution<>::TransformFilters(weight, 0, maps, inMaps,
+          transformedFilters);
+
+      // Each point multiplies matrices, so BLAS is single-threaded meanwhile;
+      // inside a parallel region (e.g. multithreaded training), the loop is
+      // not parallelized again.
+      ThreadBudget budget;
+      #pragma omp parallel for schedule(dynamic)
+      for (size_t offset = 0; offset < (higherInDimensions * batchSize);
+          ++offset)
+      {
+        WinogradConvolution<>::MultiMapConvolution(inputTemp, offset * inMaps,
+            transformedFilters, outputTemp, offset * maps);
+
+        if (useBias)
+        {
+          for (size_t outMap = 0; outMap < maps; ++outMap)
+            outputTemp.slice(outMap + offset * maps) += bias(outMap);
+        }
+      }
+
+      return;
+    }
+  }
+
   // We "ignore" dimensions higher than the third---that means that we just pass
   // them through and treat them like different input points.
   //
@@ -385,6 +425,12 @@ void ConvolutionType<
   const bool usingPadding =
       (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
 
+  if constexpr (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    BackwardGEMM(gy, g);
+    return;
+  }
+
   // To perform the backward pass, we need to rotate all the filters.
   CubeType rotatedFilters(weight.n_rows,
       weight.n_cols, weight.n_slices);
@@ -500,6 +546,12 @@ void ConvolutionType<
   const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
   const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
 
+  if constexpr (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    GradientGEMM(usingPadding ? inputPadded : input, error, gradient);
+    return;
+  }
+
   CubeType inputTemp(
       const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
       paddedRows, paddedCols, inMaps * batchSize, false, false);
@@ -548,6 +600,180 @@ void ConvolutionType<
   }
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::ForwardGEMM(const MatType& input, MatType& output)
+{
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  const size_t outputSize = this->outputDimensions[0] *
+      this->outputDimensions[1];
+
+  // Column i of the filter matrix holds the filters of output map i for all
+  // the input maps, in the order of the rows of the unrolled patches.
+  MatType filters;
+  MakeAlias(filters, weights, weight.n_elem / maps, maps);
+
+  // The dimensions higher than the third are treated as different input
+  // points, like in the other convolution rules.
+  #pragma omp parallel
+  {
+    MatType columns, pointOutput;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t offset = 0; offset < (higherInDimensions * batchSize);
+        ++offset)
+    {
+      Im2ColConvolution<>::Im2Col(
+          input.memptr() + offset * inMaps * paddedRows * paddedCols,
+          paddedRows, paddedCols, inMaps, kernelWidth, kernelHeight,
+          strideWidth, strideHeight, 1, 1, this->outputDimensions[0],
+          this->outputDimensions[1], columns);
+
+      // Column i of the output of this point is output map i.
+      MakeAlias(pointOutput, output, outputSize, maps,
+          offset * maps * outputSize);
+      pointOutput = columns.t() * filters;
+      if (useBias)
+        pointOutput.each_row() += bias.t();
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::BackwardGEMM(const MatType& gy, MatType& g)
+{
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  const size_t outputSize = this->outputDimensions[0] *
+      this->outputDimensions[1];
+
+  MatType filters;
+  MakeAlias(filters, weights, weight.n_elem / maps, maps);
+
+  // Without padding the error can be added to g directly (it is zeroed by
+  // Backward()); otherwise it is added to the padded input, and then cropped.
+  MatType gPadded;
+  if (usingPadding)
+  {
+    gPadded.zeros(paddedRows * paddedCols * inMaps * higherInDimensions,
+        batchSize);
+  }
+  MatType& target = usingPadding ? gPadded : g;
+
+  #pragma omp parallel
+  {
+    MatType columns, pointError;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t offset = 0; offset < (higherInDimensions * batchSize);
+        ++offset)
+    {
+      MakeAlias(pointError, gy, outputSize, maps, offset * maps * outputSize);
+      columns = filters * pointError.t();
+      Im2ColConvolution<>::Col2Im(columns, paddedRows, paddedCols, inMaps,
+          kernelWidth, kernelHeight, strideWidth, strideHeight, 1, 1,
+          this->outputDimensions[0], this->outputDimensions[1],
+          target.memptr() + offset * inMaps * paddedRows * paddedCols);
+    }
+  }
+
+  if (usingPadding)
+  {
+    CubeType gPaddedCube;
+    MakeAlias(gPaddedCube, gPadded, paddedRows, paddedCols,
+        inMaps * higherInDimensions * batchSize);
+    gTemp = gPaddedCube.tube(
+        padWLeft,
+        padHTop,
+        padWLeft + gTemp.n_rows - 1,
+        padHTop + gTemp.n_cols - 1);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::GradientGEMM(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  const size_t outputSize = this->outputDimensions[0] *
+      this->outputDimensions[1];
+
+  // The gradient of the filters has the same layout as the filter matrix; the
+  // gradient of the bias follows it.
+  gradient.zeros();
+  MatType filtersGradient;
+  MakeAlias(filtersGradient, gradient, weight.n_elem / maps, maps);
+
+  #pragma omp parallel
+  {
+    MatType columns, pointError;
+    MatType localGradient(filtersGradient.n_rows, maps, arma::fill::zeros);
+    MatType localBiasGradient(1, maps, arma::fill::zeros);
+
+    #pragma omp for schedule(dynamic)
+    for (size_t offset = 0; offset < (higherInDimensions * batchSize);
+        ++offset)
+    {
+      Im2ColConvolution<>::Im2Col(
+          input.memptr() + offset * inMaps * paddedRows * paddedCols,
+          paddedRows, paddedCols, inMaps, kernelWidth, kernelHeight,
+          strideWidth, strideHeight, 1, 1, this->outputDimensions[0],
+          this->outputDimensions[1], columns);
+
+      MakeAlias(pointError, error, outputSize, maps,
+          offset * maps * outputSize);
+      localGradient += columns * pointError;
+      if (useBias)
+        localBiasGradient += sum(pointError, 0);
+    }
+
+    #pragma omp critical
+    {
+      filtersGradient += localGradient;
+      if (useBias)
+      {
+        gradient.rows(weight.n_elem, weight.n_elem + maps - 1) +=
+            localBiasGradient.t();
+      }
+    }
+  }
+}
+
 template<
     typename ForwardConvolutionRule,
     typename BackwardConvolutionRule,
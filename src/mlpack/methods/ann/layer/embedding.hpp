@@ -0,0 +1,165 @@
+/**
+ * @file methods/ann/layer/embedding.hpp
+ *
+ * Definition of the Embedding layer, which maps categorical indices to
+ * columns of a trainable table.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_EMBEDDING_HPP
+#define MLPACK_METHODS_ANN_LAYER_EMBEDDING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * The Embedding layer maps each element of its input, which must be an index
+ * in `[0, vocabSize)`, to the corresponding embedding of size
+ * `embeddingSize`.  The embeddings are held in a trainable table with one
+ * column for each index, and an input point with `n` indices gives an output
+ * of `n` embeddings, one after another.
+ *
+ * Only the embeddings of the indices in a batch have a nonzero gradient.
+ * `Gradient()` fills the dense gradient of the whole table, but
+ * `SparseGradient()` only stores the embeddings that were used, so that for
+ * large vocabularies the gradient and the update can take time proportional
+ * to the batch instead of the table (see `FFN::TrainSparse()`).
+ *
+ * The indices are not differentiable, so the Embedding layer is usually the
+ * first layer of a network, and `Backward()` gives a zero delta.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class EmbeddingType : public Layer<MatType>
+{
+ public:
+  //! Convenience typedef for the element type of the matrices.
+  using ElemType = typename MatType::elem_type;
+
+  //! Create an empty Embedding object.
+  EmbeddingType();
+
+  /**
+   * Create the Embedding object with the given vocabulary and embedding sizes.
+   *
+   * @param vocabSize Number of different indices (columns of the table).
+   * @param embeddingSize Size of each embedding.
+   */
+  EmbeddingType(const size_t vocabSize, const size_t embeddingSize);
+
+  //! Clone the EmbeddingType object. This handles polymorphism correctly.
+  EmbeddingType* Clone() const { return new EmbeddingType(*this); }
+
+  //! Copy constructor.
+  EmbeddingType(const EmbeddingType& layer);
+
+  //! Move constructor.
+  EmbeddingType(EmbeddingType&& layer);
+
+  //! Copy assignment operator.
+  EmbeddingType& operator=(const EmbeddingType& layer);
+
+  //! Move assignment operator.
+  EmbeddingType& operator=(EmbeddingType&& layer);
+
+  //! Virtual destructor.
+  virtual ~EmbeddingType() { }
+
+  //! Reset the layer parameter.
+  void SetWeights(const MatType& weightsIn);
+
+  /**
+   * Ordinary feed forward pass: look up the embedding of each index of the
+   * input.
+   *
+   * @param input Indices of each point, one point per column.
+   * @param output Resulting embeddings.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The indices can't be differentiated, so this gives a zero delta.
+   *
+   * @param input The input data (x) given to the forward pass.
+   * @param output The propagated data (f(x)) resulting from Forward()
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& g);
+
+  /**
+   * Calculate the dense gradient of the whole table, using the output delta
+   * and the indices of the input.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& error,
+                MatType& gradient);
+
+  /**
+   * Calculate the gradient of the table as a sparse matrix, which only holds
+   * the embeddings of the indices of the input.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated sparse gradient.
+   */
+  void SparseGradient(const MatType& input,
+                      const MatType& error,
+                      arma::SpMat<ElemType>& gradient);
+
+  //! Get the parameters.
+  const MatType& Parameters() const { return weight; }
+  //! Modify the parameters.
+  MatType& Parameters() { return weight; }
+
+  //! Get the number of different indices.
+  size_t VocabSize() const { return vocabSize; }
+
+  //! Get the size of each embedding.
+  size_t EmbeddingSize() const { return embeddingSize; }
+
+  //! Get the number of weights in the layer.
+  size_t WeightSize() const { return vocabSize * embeddingSize; }
+
+  //! Compute the output dimensions of the layer using `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of different indices.
+  size_t vocabSize;
+
+  //! Locally-stored size of each embedding.
+  size_t embeddingSize;
+
+  //! Locally-stored table, with the embedding of each index in a column.
+  MatType weight;
+}; // class EmbeddingType
+
+// Standard Embedding layer.
+using Embedding = EmbeddingType<arma::mat>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "embedding_impl.hpp"
+
+#endif
@@ -0,0 +1,194 @@
+/**
+ * @file methods/ann/layer/embedding_impl.hpp
+ *
+ * Implementation of the Embedding layer, which maps categorical indices to
+ * columns of a trainable table.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_EMBEDDING_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_EMBEDDING_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "embedding.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+EmbeddingType<MatType>::EmbeddingType() :
+    Layer<MatType>(),
+    vocabSize(0),
+    embeddingSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+EmbeddingType<MatType>::EmbeddingType(
+    const size_t vocabSize,
+    const size_t embeddingSize) :
+    Layer<MatType>(),
+    vocabSize(vocabSize),
+    embeddingSize(embeddingSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+EmbeddingType<MatType>::EmbeddingType(const EmbeddingType& layer) :
+    Layer<MatType>(layer),
+    vocabSize(layer.vocabSize),
+    embeddingSize(layer.embeddingSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+EmbeddingType<MatType>::EmbeddingType(EmbeddingType&& layer) :
+    Layer<MatType>(std::move(layer)),
+    vocabSize(layer.vocabSize),
+    embeddingSize(layer.embeddingSize)
+{
+  // Reset parameters of other layer.
+  layer.vocabSize = 0;
+  layer.embeddingSize = 0;
+}
+
+template<typename MatType>
+EmbeddingType<MatType>&
+EmbeddingType<MatType>::operator=(const EmbeddingType& layer)
+{
+  if (this != &layer)
+  {
+    Layer<MatType>::operator=(layer);
+    vocabSize = layer.vocabSize;
+    embeddingSize = layer.embeddingSize;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+EmbeddingType<MatType>&
+EmbeddingType<MatType>::operator=(EmbeddingType&& layer)
+{
+  if (this != &layer)
+  {
+    Layer<MatType>::operator=(std::move(layer));
+    vocabSize = layer.vocabSize;
+    embeddingSize = layer.embeddingSize;
+
+    // Reset parameters of other layer.
+    layer.vocabSize = 0;
+    layer.embeddingSize = 0;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void EmbeddingType<MatType>::SetWeights(const MatType& weightsIn)
+{
+  MakeAlias(weight, weightsIn, embeddingSize, vocabSize);
+}
+
+template<typename MatType>
+void EmbeddingType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  // The embeddings of all the indices of the batch are stored one after
+  // another, so the whole output can be gathered at once.
+  const arma::uvec indices = ConvTo<arma::uvec>::From(vectorise(input));
+  MatType outputAlias;
+  MakeAlias(outputAlias, output, embeddingSize, indices.n_elem);
+  outputAlias = weight.cols(indices);
+}
+
+template<typename MatType>
+void EmbeddingType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& g)
+{
+  g.zeros();
+}
+
+template<typename MatType>
+void EmbeddingType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  const arma::uvec indices = ConvTo<arma::uvec>::From(vectorise(input));
+  MatType errorAlias, gradientAlias;
+  MakeAlias(errorAlias, error, embeddingSize, indices.n_elem);
+  MakeAlias(gradientAlias, gradient, embeddingSize, vocabSize);
+
+  gradientAlias.zeros();
+  for (size_t i = 0; i < indices.n_elem; ++i)
+    gradientAlias.col(indices[i]) += errorAlias.col(i);
+}
+
+template<typename MatType>
+void EmbeddingType<MatType>::SparseGradient(
+    const MatType& input,
+    const MatType& error,
+    arma::SpMat<ElemType>& gradient)
+{
+  const arma::uvec indices = ConvTo<arma::uvec>::From(vectorise(input));
+  MatType errorAlias;
+  MakeAlias(errorAlias, error, embeddingSize, indices.n_elem);
+
+  // Sum the errors of each distinct index; `unique()` sorts the indices, so
+  // the position of each index can be found with a binary search.
+  const arma::uvec usedIndices = arma::unique(indices);
+  MatType usedGradient(embeddingSize, usedIndices.n_elem,
+      GetFillType<MatType>::zeros);
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t j = std::lower_bound(usedIndices.begin(), usedIndices.end(),
+        indices[i]) - usedIndices.begin();
+    usedGradient.col(j) += errorAlias.col(i);
+  }
+
+  // The locations are already sorted, since the indices are.
+  arma::umat locations(2, usedGradient.n_elem, arma::fill::zeros);
+  for (size_t j = 0; j < usedIndices.n_elem; ++j)
+  {
+    for (size_t r = 0; r < embeddingSize; ++r)
+      locations(0, j * embeddingSize + r) = usedIndices[j] * embeddingSize + r;
+  }
+
+  gradient = arma::SpMat<ElemType>(locations,
+      arma::Col<ElemType>(usedGradient.memptr(), usedGradient.n_elem),
+      WeightSize(), 1, false, false);
+}
+
+template<typename MatType>
+void EmbeddingType<MatType>::ComputeOutputDimensions()
+{
+  size_t inSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    inSize *= this->inputDimensions[i];
+
+  // The input is flattened, and each index gives one embedding.
+  this->outputDimensions = { embeddingSize, inSize };
+}
+
+template<typename MatType>
+template<typename Archive>
+void EmbeddingType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(vocabSize));
+  ar(CEREAL_NVP(embeddingSize));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,226 @@
+/**
+ * @file methods/ann/layer/fast_lstm.hpp
+ * @author Marcus Edel
+ *
+ * Definition of the Fast LSTM class, which implements a Fast LSTM network
+ * layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FAST_LSTM_HPP
+#define MLPACK_METHODS_ANN_LAYER_FAST_LSTM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * An implementation of a faster version of the LSTM network layer, which does
+ * not use peephole connections between the cell and the gates.  Without them,
+ * the input, output and forget gates and the block input only depend on x_t and
+ * h_{t - 1}, so they are all computed in a single step:
+ *
+ * i_t = sigmoid(W_i x_t + U_i h_{t - 1} + b_i)
+ * o_t = sigmoid(W_o x_t + U_o h_{t - 1} + b_o)
+ * f_t = sigmoid(W_f x_t + U_f h_{t - 1} + b_f)
+ * z_t =    tanh(W_z x_t + U_z h_{t - 1} + b_z)
+ * c_t = f_t % c_{t - 1} + i_t % z_t
+ * h_t = o_t % tanh(c_t)
+ *
+ * The weights of the four gates are stored stacked in that order, so that each
+ * step takes one matrix product for the input and one for the recurrent
+ * connections, and everything else is a single pass.  No memory is allocated
+ * at each step once the first step of a sequence is done.
+ *
+ * For more information, see the following.
+ *
+ * ```
+ * @article{Hochreiter1997,
+ *   author  = {Hochreiter, Sepp and Schmidhuber, J\"{u}rgen},
+ *   title   = {Long Short-term Memory},
+ *   journal = {Neural Comput.},
+ *   year    = {1997},
+ *   url     = {https://www.bioinf.jku.at/publications/older/2604.pdf}
+ * }
+ * ```
+ *
+ * \see LSTM for an implementation of the LSTM layer with peephole connections.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class FastLSTMType : public RecurrentLayer<MatType>
+{
+ public:
+  //! Create the FastLSTM object.
+  FastLSTMType();
+
+  /**
+   * Create the FastLSTM layer object using the specified parameters.
+   *
+   * @param outSize The number of output units.
+   */
+  FastLSTMType(const size_t outSize);
+
+  //! Clone the FastLSTMType object. This handles polymorphism correctly.
+  FastLSTMType* Clone() const { return new FastLSTMType(*this); }
+
+  //! Copy the given FastLSTMType object.
+  FastLSTMType(const FastLSTMType& other);
+  //! Take ownership of the given FastLSTMType object's data.
+  FastLSTMType(FastLSTMType&& other);
+  //! Copy the given FastLSTMType object.
+  FastLSTMType& operator=(const FastLSTMType& other);
+  //! Take ownership of the given FastLSTMType object's data.
+  FastLSTMType& operator=(FastLSTMType&& other);
+
+  virtual ~FastLSTMType() { }
+
+  /**
+   * Reset the layer parameter. The method is called to
+   * assign the allocated memory to the internal learnable parameters.
+   */
+  void SetWeights(const MatType& weightsIn);
+
+  /**
+   * Ordinary feed-forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The input data (x) given to the forward pass.
+   * @param output The propagated data (f(x)) resulting from Forward()
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& gy,
+                MatType& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& /* error */,
+                MatType& gradient);
+
+  // Get the parameters.
+  const MatType& Parameters() const { return weights; }
+  // Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  // Get the input weights of the input, output and forget gates and the block
+  // input, stacked in that order.
+  const MatType& InputWeight() const { return inputWeight; }
+  // Modify the input weights of the four gates.
+  MatType& InputWeight() { return inputWeight; }
+
+  // Get the biases of the four gates, stacked like the input weights.
+  const MatType& Bias() const { return bias; }
+  // Modify the biases of the four gates.
+  MatType& Bias() { return bias; }
+
+  // Get the recurrent weights of the four gates, stacked like the input
+  // weights.
+  const MatType& RecurrentWeight() const { return recurrentWeight; }
+  // Modify the recurrent weights of the four gates.
+  MatType& RecurrentWeight() { return recurrentWeight; }
+
+  // Get the total number of trainable parameters.
+  size_t WeightSize() const;
+
+  // Get the total number of recurrent state parameters.
+  size_t RecurrentSize() const;
+
+  // Given a properly set InputDimensions(), compute the output dimensions.
+  void ComputeOutputDimensions()
+  {
+    inSize = this->inputDimensions[0];
+    for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+      inSize *= this->inputDimensions[i];
+    this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+        1);
+
+    // The FastLSTM layer flattens its input.
+    this->outputDimensions[0] = outSize;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  // Locally-stored number of input units.
+  size_t inSize;
+
+  // Locally-stored number of output units.
+  size_t outSize;
+
+  // Locally-stored weight object.
+  MatType weights;
+
+  // Aliases of the parameters in `weights`.
+  MatType inputWeight;
+  MatType bias;
+  MatType recurrentWeight;
+
+  // These matrices are internally used for computation only; they are aliases
+  // for recurrent state.
+  MatType thisRecurrent;
+  MatType prevRecurrent;
+  MatType thisCell;
+  MatType prevCell;
+  MatType inputGate;
+  MatType outputGate;
+  MatType forgetGate;
+  MatType blockInput;
+
+  // These matrices are also internally used for computation only.  They are
+  // allocated at the first step and then reused, since the batch size does
+  // not change during a sequence.
+  //
+  // The stacked gates before the nonlinearities.
+  MatType gates;
+  // The deltas of the four gates before the nonlinearities, stacked like the
+  // rows of `inputWeight`.
+  MatType deltaGates;
+  // The delta of the output, dh_t.
+  MatType deltaY;
+
+  // Calling this function will set all the aliases for the functions above to
+  // the correct places in the current recurrent state methods.
+  void SetInternalAliases(const size_t batchSize);
+}; // class FastLSTMType
+
+// Convenience typedefs.
+
+// Standard FastLSTM layer.
+using FastLSTM = FastLSTMType<arma::mat>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "fast_lstm_impl.hpp"
+
+#endif
@@ -0,0 +1,358 @@
+/**
+ * @file methods/ann/layer/fast_lstm_impl.hpp
+ * @author Marcus Edel
+ *
+ * Implementation of the Fast LSTM class, which implements a fast lstm network
+ * layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FAST_LSTM_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FAST_LSTM_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fast_lstm.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType() :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType(const size_t outSize) :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType(const FastLSTMType& layer) :
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType(FastLSTMType&& layer) :
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
+{
+  layer.inSize = 0;
+  layer.outSize = 0;
+}
+
+template<typename MatType>
+FastLSTMType<MatType>& FastLSTMType<MatType>::operator=(
+    const FastLSTMType& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+FastLSTMType<MatType>& FastLSTMType<MatType>::operator=(FastLSTMType&& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+
+    layer.inSize = 0;
+    layer.outSize = 0;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::SetWeights(const MatType& weightsIn)
+{
+  MakeAlias(weights, weightsIn, WeightSize(), 1);
+
+  const size_t inputWeightSize = 4 * outSize * inSize;
+  MakeAlias(inputWeight, weightsIn, 4 * outSize, inSize);
+  MakeAlias(bias, weightsIn, 4 * outSize, 1, inputWeightSize);
+  MakeAlias(recurrentWeight, weightsIn, 4 * outSize, outSize,
+      inputWeightSize + 4 * outSize);
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience alias.
+  const size_t batchSize = input.n_cols;
+
+  // The internal quantities are stored as recurrent state; so, set aliases
+  // correctly for this time step.
+  SetInternalAliases(batchSize);
+
+  // Compute internal state:
+  //
+  // i_t = sigmoid(W_i x_t + U_i h_{t - 1} + b_i)
+  // o_t = sigmoid(W_o x_t + U_o h_{t - 1} + b_o)
+  // f_t = sigmoid(W_f x_t + U_f h_{t - 1} + b_f)
+  // z_t =    tanh(W_z x_t + U_z h_{t - 1} + b_z)
+  // c_t = f_t % c_{t - 1} + i_t % z_t
+  // h_t = o_t % tanh(c_t)
+  //
+  // The recurrent product is accumulated directly into the gates.
+  const bool hasPreviousStep = this->HasPreviousStep();
+  gates = inputWeight * input;
+  if (hasPreviousStep)
+    gates += recurrentWeight * prevRecurrent;
+
+  // Now the biases, nonlinearities and cell update are all computed in one
+  // pass.
+  output.set_size(outSize, batchSize);
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType i = 1 / (1 + std::exp(-(gates(r, c) + bias[r])));
+      const ElemType o = 1 / (1 + std::exp(-(gates(outSize + r, c) +
+          bias[outSize + r])));
+      const ElemType f = 1 / (1 + std::exp(-(gates(2 * outSize + r, c) +
+          bias[2 * outSize + r])));
+      const ElemType z = std::tanh(gates(3 * outSize + r, c) +
+          bias[3 * outSize + r]);
+
+      const ElemType cell = hasPreviousStep ?
+          (f * prevCell(r, c) + i * z) : (i * z);
+
+      inputGate(r, c) = i;
+      outputGate(r, c) = o;
+      forgetGate(r, c) = f;
+      blockInput(r, c) = z;
+      thisCell(r, c) = cell;
+      output(r, c) = o * std::tanh(cell);
+    }
+  }
+
+  // If necessary, store the recurrent output.  This must be last, since
+  // without BPTT the previous and current recurrent states are the same
+  // memory.
+  if (!this->AtFinalStep())
+    thisRecurrent = output;
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& output,
+    const MatType& gy,
+    MatType& g)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Compute backward partial derivatives, defined by the following equations.
+  // Like in the LSTM, `o_t` refers to the output gate *after* the nonlinearity
+  // is applied, but `do_t` refers to the delta *before* the nonlinearity.
+  //
+  // dh_t = gy + dh_t (from the next time step)
+  //
+  // do_t = dh_t % tanh(c_t) % (o_t % (1 - o_t))
+  // dc_t = dh_t % o_t % (1 - tanh(c_t) .^ 2) + dc_{t + 1} % f_{t + 1}
+  //
+  // di_t = dc_t % z_t       % (i_t % (1 - i_t))
+  // df_t = dc_t % c_{t - 1} % (f_t % (1 - f_t))
+  // dz_t = dc_t % i_t       % (1 - z_t .^ 2)
+  //
+  // dx_t = W^T dG_t, and dh_{t - 1} = U^T dG_t, where dG_t are the stacked
+  // deltas of the four gates.
+  //
+  // dh_{t - 1} and dc_t % f_t are passed to the previous time step as its
+  // recurrent gradient.
+  //
+  // Before we start, set all the internal aliases, which will contain this time
+  // step's values as computed in Forward().
+  const size_t batchSize = output.n_cols;
+  SetInternalAliases(batchSize);
+
+  const bool atFinalStep = this->AtFinalStep();
+  const bool hasPreviousStep = this->HasPreviousStep();
+
+  MatType nextDeltaCell, prevDeltaCell;
+  if (atFinalStep)
+  {
+    deltaY = gy;
+  }
+  else
+  {
+    MatType& nextGradient = this->RecurrentGradient(this->CurrentStep());
+    MatType nextDeltaY;
+    MakeAlias(nextDeltaY, nextGradient, outSize, batchSize);
+    MakeAlias(nextDeltaCell, nextGradient, outSize, batchSize,
+        outSize * batchSize);
+    deltaY = gy + nextDeltaY;
+  }
+
+  if (hasPreviousStep)
+  {
+    MakeAlias(prevDeltaCell, this->RecurrentGradient(this->PreviousStep()),
+        outSize, batchSize, outSize * batchSize);
+  }
+
+  deltaGates.set_size(4 * outSize, batchSize);
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType i = inputGate(r, c);
+      const ElemType o = outputGate(r, c);
+      const ElemType f = forgetGate(r, c);
+      const ElemType z = blockInput(r, c);
+      const ElemType tanhCell = std::tanh(thisCell(r, c));
+
+      ElemType deltaC = deltaY(r, c) * o * (1 - tanhCell * tanhCell);
+      if (!atFinalStep)
+        deltaC += nextDeltaCell(r, c);
+
+      deltaGates(r, c) = deltaC * z * (i * (1 - i));
+      deltaGates(outSize + r, c) = deltaY(r, c) * tanhCell * (o * (1 - o));
+      deltaGates(2 * outSize + r, c) = hasPreviousStep ?
+          deltaC * prevCell(r, c) * (f * (1 - f)) : 0;
+      deltaGates(3 * outSize + r, c) = deltaC * i * (1 - z * z);
+
+      if (hasPreviousStep)
+        prevDeltaCell(r, c) = deltaC * f;
+    }
+  }
+
+  if (hasPreviousStep)
+  {
+    MatType prevDeltaY;
+    MakeAlias(prevDeltaY, this->RecurrentGradient(this->PreviousStep()),
+        outSize, batchSize);
+    prevDeltaY = recurrentWeight.t() * deltaGates;
+  }
+
+  // Finally, compute deltaX (which is what we wanted all along).
+  g = inputWeight.t() * deltaGates;
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& /* error */,
+    MatType& gradient)
+{
+  // This implementation depends on Gradient() being called just after
+  // Backward(), which is something we can safely assume.  So, the deltas of
+  // this time step are already computed, and the internal aliases are set.
+  const size_t inputWeightSize = 4 * outSize * inSize;
+  const size_t recurrentOffset = inputWeightSize + 4 * outSize;
+
+  // dW = < dG_t, x_t >, db = sum(dG_t), for all four gates at once.
+  MatType inputWeightGradient, biasGradient;
+  MakeAlias(inputWeightGradient, gradient, 4 * outSize, inSize);
+  MakeAlias(biasGradient, gradient, 4 * outSize, 1, inputWeightSize);
+  inputWeightGradient = deltaGates * input.t();
+  biasGradient = sum(deltaGates, 1);
+
+  // For the recurrent weights, the gradient does not apply at the first time
+  // step.
+  if (this->HasPreviousStep())
+  {
+    // dU = < dG_t, h_{t - 1} >.
+    MatType recurrentWeightGradient;
+    MakeAlias(recurrentWeightGradient, gradient, 4 * outSize, outSize,
+        recurrentOffset);
+    recurrentWeightGradient = deltaGates * prevRecurrent.t();
+  }
+  else
+  {
+    gradient.rows(recurrentOffset, gradient.n_rows - 1).zeros();
+  }
+}
+
+template<typename MatType>
+size_t FastLSTMType<MatType>::WeightSize() const
+{
+  return 4 * inSize * outSize /* input weight connections */ +
+      4 * outSize /* input bias */ +
+      4 * outSize * outSize /* recurrent weight connections */;
+}
+
+template<typename MatType>
+size_t FastLSTMType<MatType>::RecurrentSize() const
+{
+  // We have to account for the cell, recurrent connection, and the four
+  // internal matrices: input gate, output gate, forget gate, and block input.
+  // Technically those last four are not recurrent connections, but we use them
+  // as 'stored state' that we compute in Forward() and then access in
+  // Backward().
+  return 6 * outSize;
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::SetInternalAliases(const size_t batchSize)
+{
+  // Make all of the aliases for internal state point to the correct place.
+  MatType& state = this->RecurrentState(this->CurrentStep());
+
+  // First make aliases for the recurrent connections.
+  MakeAlias(thisRecurrent, state, outSize, batchSize);
+  MakeAlias(thisCell, state, outSize, batchSize, outSize * batchSize);
+
+  // Now make aliases for the internal state members that we use as scratch
+  // space for computation.
+  MakeAlias(inputGate, state, outSize, batchSize, 2 * outSize * batchSize);
+  MakeAlias(outputGate, state, outSize, batchSize, 3 * outSize * batchSize);
+  MakeAlias(forgetGate, state, outSize, batchSize, 4 * outSize * batchSize);
+  MakeAlias(blockInput, state, outSize, batchSize, 5 * outSize * batchSize);
+
+  // Make aliases for the previous time step, too, if we can.
+  if (this->HasPreviousStep())
+  {
+    MatType& prevState = this->RecurrentState(this->PreviousStep());
+
+    MakeAlias(prevRecurrent, prevState, outSize, batchSize);
+    MakeAlias(prevCell, prevState, outSize, batchSize, outSize * batchSize);
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void FastLSTMType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<RecurrentLayer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+
+  // Clear internal scratch space if we are loading.
+  if (Archive::is_loading::value)
+  {
+    gates.clear();
+    deltaGates.clear();
+    deltaY.clear();
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -19,6 +19,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/winograd_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer.hpp"
@@ -277,6 +278,14 @@ class GroupedConvolutionType : public Layer<MatType>
         (useBias ? maps : 0);
   }
 
+  //! Estimate the floating-point operations of Forward() for one point: each
+  //! output element takes a multiply-add for each weight of its kernels.
+  double ForwardFLOPs()
+  {
+    return (2.0 * (inMaps / groups) * kernelWidth * kernelHeight + 1) *
+        this->OutputSize();
+  }
+
   //! Compute the output dimensions of the layer based on `InputDimensions()`.
   void ComputeOutputDimensions();
 
@@ -334,6 +334,48 @@ void GroupedConvolutionType<
   size_t inGroupSize = inMaps / groups;
   size_t outGroupSize = maps / groups;
 
+  // With the default rule, 3x3 filters with unit strides are convolved with
+  // the Winograd transform instead, for all the maps of a group at once.
+  if constexpr (std::is_same_v<ForwardConvolutionRule,
+      NaiveConvolution<ValidConvolution>>)
+  {
+    if (WinogradConvolution<>::Supports(kernelWidth, kernelHeight,
+        strideWidth, strideHeight))
+    {
+      std::vector<CubeType> transformedFilters(groups);
+      for (size_t group = 0; group < groups; ++group)
+      {
+        WinogradConvolution<>::TransformFilters(weight,
+            group * outGroupSize * inGroupSize, outGroupSize, inGroupSize,
+            transformedFilters[group]);
+      }
+
+      #pragma omp parallel for collapse(2) schedule(dynamic)
+      for (size_t offset = 0; offset < (higherInDimensions * batchSize);
+          ++offset)
+      {
+        for (size_t group = 0; group < groups; ++group)
+        {
+          const size_t firstOutMap = group * outGroupSize + offset * maps;
+          WinogradConvolution<>::MultiMapConvolution(inputTemp,
+              group * inGroupSize + offset * inMaps,
+              transformedFilters[group], outputTemp, firstOutMap);
+
+          if (useBias)
+          {
+            for (size_t outMap = 0; outMap < outGroupSize; ++outMap)
+            {
+              outputTemp.slice(firstOutMap + outMap) +=
+                  bias(group * outGroupSize + outMap);
+            }
+          }
+        }
+      }
+
+      return;
+    }
+  }
+
   // We "ignore" dimensions higher than the third---that means that we just pass
   // them through and treat them like different input points.
   //
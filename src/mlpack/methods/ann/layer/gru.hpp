@@ -0,0 +1,239 @@
+/**
+ * @file methods/ann/layer/gru.hpp
+ * @author Sumedh Ghaisas
+ *
+ * Definition of the GRU layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_GRU_HPP
+#define MLPACK_METHODS_ANN_LAYER_GRU_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * An implementation of a gated recurrent unit (GRU) layer, which corresponds
+ * to the following algorithm:
+ *
+ * z_t = sigmoid(W_z x_t + U_z h_{t - 1} + b_z)
+ * r_t = sigmoid(W_r x_t + U_r h_{t - 1} + b_r)
+ * o_t =    tanh(W_o x_t + U_o (r_t % h_{t - 1}) + b_o)
+ * h_t = z_t % h_{t - 1} + (1 - z_t) % o_t
+ *
+ * For more information, read the following paper:
+ *
+ * ```
+ * @inproceedings{chung2015gated,
+ *    title     = {Gated Feedback Recurrent Neural Networks.},
+ *    author    = {Chung, Junyoung and G{\"u}l{\c{c}}ehre, Caglar and Cho,
+ *                 Kyunghyun and Bengio, Yoshua},
+ *    booktitle = {ICML},
+ *    pages     = {2067--2075},
+ *    year      = {2015},
+ *    url       = {https://arxiv.org/abs/1502.02367}
+ * }
+ * ```
+ *
+ * The GRU has three gates instead of the four of the LSTM, and no cell state,
+ * so it has about 25% fewer parameters than an LSTM of the same size.
+ *
+ * The input weights of the three gates are stored as one matrix, and so are
+ * the recurrent weights of the update and reset gates, so that each step takes
+ * one matrix product for the input and two for the recurrent connections.  No
+ * memory is allocated at each step once the first step of a sequence is done.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class GRUType : public RecurrentLayer<MatType>
+{
+ public:
+  //! Create the GRU object.
+  GRUType();
+
+  /**
+   * Create the GRU layer object using the specified parameters.
+   *
+   * @param outSize The number of output units.
+   */
+  GRUType(const size_t outSize);
+
+  //! Clone the GRUType object. This handles polymorphism correctly.
+  GRUType* Clone() const { return new GRUType(*this); }
+
+  //! Copy the given GRUType object.
+  GRUType(const GRUType& other);
+  //! Take ownership of the given GRUType object's data.
+  GRUType(GRUType&& other);
+  //! Copy the given GRUType object.
+  GRUType& operator=(const GRUType& other);
+  //! Take ownership of the given GRUType object's data.
+  GRUType& operator=(GRUType&& other);
+
+  virtual ~GRUType() { }
+
+  /**
+   * Reset the layer parameter. The method is called to
+   * assign the allocated memory to the internal learnable parameters.
+   */
+  void SetWeights(const MatType& weightsIn);
+
+  /**
+   * Ordinary feed-forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The input data (x) given to the forward pass.
+   * @param output The propagated data (f(x)) resulting from Forward()
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& gy,
+                MatType& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& /* error */,
+                MatType& gradient);
+
+  // Get the parameters.
+  const MatType& Parameters() const { return weights; }
+  // Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  // Get the input weights of the update, reset and candidate gates, stacked
+  // in that order.
+  const MatType& InputWeight() const { return inputWeight; }
+  // Modify the input weights of the update, reset and candidate gates.
+  MatType& InputWeight() { return inputWeight; }
+
+  // Get the biases of the update, reset and candidate gates, stacked in that
+  // order.
+  const MatType& Bias() const { return bias; }
+  // Modify the biases of the update, reset and candidate gates.
+  MatType& Bias() { return bias; }
+
+  // Get the recurrent weights of the update and reset gates, stacked in that
+  // order.
+  const MatType& RecurrentGateWeight() const { return recurrentGateWeight; }
+  // Modify the recurrent weights of the update and reset gates.
+  MatType& RecurrentGateWeight() { return recurrentGateWeight; }
+
+  // Get the recurrent weights of the candidate gate.
+  const MatType& RecurrentCandidateWeight() const
+  { return recurrentCandidateWeight; }
+  // Modify the recurrent weights of the candidate gate.
+  MatType& RecurrentCandidateWeight() { return recurrentCandidateWeight; }
+
+  // Get the total number of trainable parameters.
+  size_t WeightSize() const;
+
+  // Get the total number of recurrent state parameters.
+  size_t RecurrentSize() const;
+
+  // Given a properly set InputDimensions(), compute the output dimensions.
+  void ComputeOutputDimensions()
+  {
+    inSize = this->inputDimensions[0];
+    for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+      inSize *= this->inputDimensions[i];
+    this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+        1);
+
+    // The GRU layer flattens its input.
+    this->outputDimensions[0] = outSize;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  // Locally-stored number of input units.
+  size_t inSize;
+
+  // Locally-stored number of output units.
+  size_t outSize;
+
+  // Locally-stored weight object.
+  MatType weights;
+
+  // Aliases of the parameters in `weights`.
+  MatType inputWeight;
+  MatType bias;
+  MatType recurrentGateWeight;
+  MatType recurrentCandidateWeight;
+
+  // These matrices are internally used for computation only; they are aliases
+  // for recurrent state.
+  MatType thisRecurrent;
+  MatType prevRecurrent;
+  MatType updateGate;
+  MatType resetGate;
+  MatType candidate;
+
+  // These matrices are also internally used for computation only.  They are
+  // allocated at the first step and then reused, since the batch size does
+  // not change during a sequence.
+  //
+  // The stacked input products of the three gates.
+  MatType gates;
+  // The recurrent products of the update and reset gates.
+  MatType recurrentGates;
+  // The recurrent product of the candidate gate.
+  MatType candidateGates;
+  // r_t % h_{t - 1}, and its delta in Backward().
+  MatType resetHidden;
+  // The deltas of the three gates before the nonlinearities, stacked like the
+  // rows of `inputWeight`; the update and reset gate deltas are kept in their
+  // own contiguous matrix, since they are also multiplied by
+  // `recurrentGateWeight`.
+  MatType deltaGates;
+  MatType deltaUpdateReset;
+  MatType deltaCandidate;
+  // The delta of the output, dh_t.
+  MatType deltaY;
+
+  // Calling this function will set all the aliases for the functions above to
+  // the correct places in the current recurrent state methods.
+  void SetInternalAliases(const size_t batchSize);
+}; // class GRUType
+
+// Convenience typedefs.
+
+// Standard GRU layer.
+using GRU = GRUType<arma::mat>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "gru_impl.hpp"
+
+#endif
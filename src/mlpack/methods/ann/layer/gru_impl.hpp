@@ -0,0 +1,388 @@
+/**
+ * @file methods/ann/layer/gru_impl.hpp
+ * @author Sumedh Ghaisas
+ *
+ * Implementation of the GRU class, which implements a gru network layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_GRU_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_GRU_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "gru.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+GRUType<MatType>::GRUType() :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>::GRUType(const size_t outSize) :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>::GRUType(const GRUType& layer) :
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>::GRUType(GRUType&& layer) :
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
+{
+  layer.inSize = 0;
+  layer.outSize = 0;
+}
+
+template<typename MatType>
+GRUType<MatType>& GRUType<MatType>::operator=(const GRUType& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+GRUType<MatType>& GRUType<MatType>::operator=(GRUType&& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+
+    layer.inSize = 0;
+    layer.outSize = 0;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void GRUType<MatType>::SetWeights(const MatType& weightsIn)
+{
+  MakeAlias(weights, weightsIn, WeightSize(), 1);
+
+  // The input weights and biases of the update, reset and candidate gates.
+  const size_t inputWeightSize = 3 * outSize * inSize;
+  MakeAlias(inputWeight, weightsIn, 3 * outSize, inSize);
+  MakeAlias(bias, weightsIn, 3 * outSize, 1, inputWeightSize);
+
+  // The recurrent weights of the update and reset gates, and then those of the
+  // candidate gate.
+  const size_t recurrentOffset = inputWeightSize + 3 * outSize;
+  MakeAlias(recurrentGateWeight, weightsIn, 2 * outSize, outSize,
+      recurrentOffset);
+  MakeAlias(recurrentCandidateWeight, weightsIn, outSize, outSize,
+      recurrentOffset + 2 * outSize * outSize);
+}
+
+template<typename MatType>
+void GRUType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience alias.
+  const size_t batchSize = input.n_cols;
+
+  // The internal quantities are stored as recurrent state; so, set aliases
+  // correctly for this time step.
+  SetInternalAliases(batchSize);
+
+  // Compute internal state:
+  //
+  // z_t = sigmoid(W_z x_t + U_z h_{t - 1} + b_z)
+  // r_t = sigmoid(W_r x_t + U_r h_{t - 1} + b_r)
+  // o_t =    tanh(W_o x_t + U_o (r_t % h_{t - 1}) + b_o)
+  // h_t = z_t % h_{t - 1} + (1 - z_t) % o_t
+  //
+  // The products of the input with the weights of all three gates are one
+  // matrix product, and so are the recurrent products of the update and reset
+  // gates.  The candidate gate needs r_t first, so its recurrent product is
+  // done after the first pass.
+  const bool hasPreviousStep = this->HasPreviousStep();
+  gates = inputWeight * input;
+  if (hasPreviousStep)
+    recurrentGates = recurrentGateWeight * prevRecurrent;
+
+  resetHidden.set_size(outSize, batchSize);
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      ElemType z = gates(r, c) + bias[r];
+      ElemType reset = gates(outSize + r, c) + bias[outSize + r];
+      if (hasPreviousStep)
+      {
+        z += recurrentGates(r, c);
+        reset += recurrentGates(outSize + r, c);
+      }
+      z = 1 / (1 + std::exp(-z));
+      reset = 1 / (1 + std::exp(-reset));
+
+      updateGate(r, c) = z;
+      resetGate(r, c) = reset;
+      resetHidden(r, c) = hasPreviousStep ? reset * prevRecurrent(r, c) : 0;
+    }
+  }
+
+  if (hasPreviousStep)
+    candidateGates = recurrentCandidateWeight * resetHidden;
+
+  // Now the candidate gate and the output.
+  output.set_size(outSize, batchSize);
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      ElemType o = gates(2 * outSize + r, c) + bias[2 * outSize + r];
+      if (hasPreviousStep)
+        o += candidateGates(r, c);
+      o = std::tanh(o);
+
+      const ElemType z = updateGate(r, c);
+      candidate(r, c) = o;
+      output(r, c) = hasPreviousStep ?
+          (z * prevRecurrent(r, c) + (1 - z) * o) : ((1 - z) * o);
+    }
+  }
+
+  // If necessary, store the recurrent output.  This must be last, since
+  // without BPTT the previous and current recurrent states are the same
+  // memory.
+  if (!this->AtFinalStep())
+    thisRecurrent = output;
+}
+
+template<typename MatType>
+void GRUType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& output,
+    const MatType& gy,
+    MatType& g)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Compute backward partial derivatives, defined by the following equations.
+  // Like in the LSTM, `z_t` refers to the update gate *after* the nonlinearity
+  // is applied, but `dz_t` refers to the delta *before* the nonlinearity.
+  //
+  // dh_t = gy + dh_t (from the next time step)
+  //
+  // do_t = dh_t % (1 - z_t) % (1 - o_t .^ 2)
+  // dz_t = dh_t % (h_{t - 1} - o_t) % (z_t % (1 - z_t))
+  // dq_t = U_o^T do_t       (the delta of q_t = r_t % h_{t - 1})
+  // dr_t = dq_t % h_{t - 1} % (r_t % (1 - r_t))
+  //
+  // dh_{t - 1} = dh_t % z_t + dq_t % r_t + U_z^T dz_t + U_r^T dr_t
+  //
+  // dx_t = W_z^T dz_t + W_r^T dr_t + W_o^T do_t
+  //
+  // dh_{t - 1} is passed to the previous time step as its recurrent gradient.
+  //
+  // Before we start, set all the internal aliases, which will contain this time
+  // step's values as computed in Forward().
+  const size_t batchSize = output.n_cols;
+  SetInternalAliases(batchSize);
+
+  if (this->AtFinalStep())
+  {
+    deltaY = gy;
+  }
+  else
+  {
+    MatType nextDeltaY;
+    MakeAlias(nextDeltaY, this->RecurrentGradient(this->CurrentStep()),
+        outSize, batchSize);
+    deltaY = gy + nextDeltaY;
+  }
+
+  const bool hasPreviousStep = this->HasPreviousStep();
+  deltaUpdateReset.set_size(2 * outSize, batchSize);
+  deltaCandidate.set_size(outSize, batchSize);
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType z = updateGate(r, c);
+      const ElemType o = candidate(r, c);
+      const ElemType prevH = hasPreviousStep ? prevRecurrent(r, c) : 0;
+
+      deltaCandidate(r, c) = deltaY(r, c) * (1 - z) * (1 - o * o);
+      deltaUpdateReset(r, c) = deltaY(r, c) * (prevH - o) * (z * (1 - z));
+      // The reset gate has no effect without a previous step.
+      deltaUpdateReset(outSize + r, c) = 0;
+    }
+  }
+
+  if (hasPreviousStep)
+  {
+    // dq_t; this is turned into the direct part of dh_{t - 1} in place.
+    resetHidden = recurrentCandidateWeight.t() * deltaCandidate;
+    for (size_t c = 0; c < batchSize; ++c)
+    {
+      for (size_t r = 0; r < outSize; ++r)
+      {
+        const ElemType reset = resetGate(r, c);
+        const ElemType deltaQ = resetHidden(r, c);
+
+        deltaUpdateReset(outSize + r, c) = deltaQ * prevRecurrent(r, c) *
+            (reset * (1 - reset));
+        resetHidden(r, c) = deltaQ * reset + deltaY(r, c) * updateGate(r, c);
+      }
+    }
+
+    MatType prevDeltaY;
+    MakeAlias(prevDeltaY, this->RecurrentGradient(this->PreviousStep()),
+        outSize, batchSize);
+    prevDeltaY = resetHidden;
+    prevDeltaY += recurrentGateWeight.t() * deltaUpdateReset;
+  }
+
+  // Finally, compute deltaX (which is what we wanted all along).
+  deltaGates.set_size(3 * outSize, batchSize);
+  deltaGates.rows(0, 2 * outSize - 1) = deltaUpdateReset;
+  deltaGates.rows(2 * outSize, 3 * outSize - 1) = deltaCandidate;
+  g = inputWeight.t() * deltaGates;
+}
+
+template<typename MatType>
+void GRUType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& /* error */,
+    MatType& gradient)
+{
+  // This implementation depends on Gradient() being called just after
+  // Backward(), which is something we can safely assume.  So, the deltas of
+  // this time step are already computed, and the internal aliases are set.
+  //
+  // The deltas of all time steps include the paths through the later time
+  // steps, so the gradient of the recurrent weights of this time step only
+  // needs h_{t - 1}.
+  const size_t batchSize = input.n_cols;
+  const size_t inputWeightSize = 3 * outSize * inSize;
+  const size_t recurrentOffset = inputWeightSize + 3 * outSize;
+
+  // dW = < dG_t, x_t >, for all three gates at once.
+  MatType inputWeightGradient, biasGradient;
+  MakeAlias(inputWeightGradient, gradient, 3 * outSize, inSize);
+  MakeAlias(biasGradient, gradient, 3 * outSize, 1, inputWeightSize);
+  inputWeightGradient = deltaGates * input.t();
+  biasGradient = sum(deltaGates, 1);
+
+  // For the recurrent weights, the gradient does not apply at the first time
+  // step.
+  if (this->HasPreviousStep())
+  {
+    // dU_z = < dz_t, h_{t - 1} >, and dU_r likewise.
+    MatType recurrentGateGradient, recurrentCandidateGradient;
+    MakeAlias(recurrentGateGradient, gradient, 2 * outSize, outSize,
+        recurrentOffset);
+    MakeAlias(recurrentCandidateGradient, gradient, outSize, outSize,
+        recurrentOffset + 2 * outSize * outSize);
+    recurrentGateGradient = deltaUpdateReset * prevRecurrent.t();
+
+    // dU_o = < do_t, r_t % h_{t - 1} >; r_t % h_{t - 1} was overwritten in
+    // Backward().
+    resetHidden.set_size(outSize, batchSize);
+    resetHidden = resetGate % prevRecurrent;
+    recurrentCandidateGradient = deltaCandidate * resetHidden.t();
+  }
+  else
+  {
+    gradient.rows(recurrentOffset, gradient.n_rows - 1).zeros();
+  }
+}
+
+template<typename MatType>
+size_t GRUType<MatType>::WeightSize() const
+{
+  return 3 * inSize * outSize /* input weight connections */ +
+      3 * outSize /* input bias */ +
+      3 * outSize * outSize /* recurrent weight connections */;
+}
+
+template<typename MatType>
+size_t GRUType<MatType>::RecurrentSize() const
+{
+  // We have to account for the recurrent connection, and the three internal
+  // matrices: update gate, reset gate, and candidate.  Technically those last
+  // three are not recurrent connections, but we use them as 'stored state'
+  // that we compute in Forward() and then access in Backward().
+  return 4 * outSize;
+}
+
+template<typename MatType>
+void GRUType<MatType>::SetInternalAliases(const size_t batchSize)
+{
+  // Make all of the aliases for internal state point to the correct place.
+  MatType& state = this->RecurrentState(this->CurrentStep());
+
+  // First make an alias for the recurrent connection.
+  MakeAlias(thisRecurrent, state, outSize, batchSize);
+
+  // Now make aliases for the internal state members that we use as scratch
+  // space for computation.
+  MakeAlias(updateGate, state, outSize, batchSize, outSize * batchSize);
+  MakeAlias(resetGate, state, outSize, batchSize, 2 * outSize * batchSize);
+  MakeAlias(candidate, state, outSize, batchSize, 3 * outSize * batchSize);
+
+  // Make an alias for the previous time step, too, if we can.
+  if (this->HasPreviousStep())
+  {
+    MatType& prevState = this->RecurrentState(this->PreviousStep());
+    MakeAlias(prevRecurrent, prevState, outSize, batchSize);
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void GRUType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<RecurrentLayer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+
+  // Clear internal scratch space if we are loading.
+  if (Archive::is_loading::value)
+  {
+    gates.clear();
+    recurrentGates.clear();
+    candidateGates.clear();
+    resetHidden.clear();
+    deltaGates.clear();
+    deltaUpdateReset.clear();
+    deltaCandidate.clear();
+    deltaY.clear();
+  }
+}
+
+} // namespace mlpack
+
+#endif
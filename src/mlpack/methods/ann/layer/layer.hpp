@@ -179,6 +179,94 @@ class Layer
                         MatType& /* gradient */)
   { /* Nothing to do here */ }
 
+  /**
+   * Compute the gradient of the layer like Gradient(), but return it as a
+   * sparse matrix with one column.  Layers whose gradient only has a few
+   * nonzero rows (like the Embedding layer) override this to avoid computing
+   * the dense gradient; by default the dense gradient is computed and
+   * converted.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated sparse gradient.
+   */
+  virtual void SparseGradient(
+      const MatType& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    MatType denseGradient(WeightSize(), 1, GetFillType<MatType>::zeros);
+    Gradient(input, error, denseGradient);
+    gradient = arma::SpMat<typename MatType::elem_type>(denseGradient);
+  }
+
+  /**
+   * Compute the output of the layer like Forward(), for a sparse input.  This
+   * is only used for the first layer of a network that is given sparse data
+   * points; layers that can be the first layer of such a network (like Linear
+   * and LinearNoBias) override this, so that the input is never converted to a
+   * dense matrix.  By default an exception is thrown.
+   *
+   * @param input Sparse input data used for evaluating the layer.
+   * @param output Resulting output.
+   */
+  virtual void SparseInputForward(
+      const arma::SpMat<typename MatType::elem_type>& /* input */,
+      MatType& /* output */)
+  {
+    throw std::invalid_argument("Layer::SparseInputForward(): this layer "
+        "cannot be the first layer of a network with sparse input!");
+  }
+
+  /**
+   * Perform the backward pass of a layer that was given a sparse input with
+   * SparseInputForward().  The error with respect to the (sparse) input is not
+   * needed, so by default nothing is done; layers that hold other layers
+   * propagate the error to them.
+   *
+   * @param output The propagated data resulting from SparseInputForward().
+   * @param gy The backpropagated error.
+   */
+  virtual void SparseInputBackward(const MatType& /* output */,
+                                   const MatType& /* gy */)
+  { /* Nothing to do here */ }
+
+  /**
+   * Compute the gradient of the layer like Gradient(), for the sparse input
+   * that was given to SparseInputForward().  By default an exception is thrown.
+   *
+   * @param input The sparse input used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  virtual void SparseInputGradient(
+      const arma::SpMat<typename MatType::elem_type>& /* input */,
+      const MatType& /* error */,
+      MatType& /* gradient */)
+  {
+    throw std::invalid_argument("Layer::SparseInputGradient(): this layer "
+        "cannot be the first layer of a network with sparse input!");
+  }
+
+  /**
+   * Compute the gradient of the layer like SparseInputGradient(), but return it
+   * as a sparse matrix with one column, like SparseGradient().  By default the
+   * dense gradient is computed and converted.
+   *
+   * @param input The sparse input used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated sparse gradient.
+   */
+  virtual void SparseInputSparseGradient(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient)
+  {
+    MatType denseGradient(WeightSize(), 1, GetFillType<MatType>::zeros);
+    SparseInputGradient(input, error, denseGradient);
+    gradient = arma::SpMat<typename MatType::elem_type>(denseGradient);
+  }
+
   /**
    * Reset the layer parameter. The method is called to assigned the allocated
    * memory to the internal layer parameters like weights and biases. The method
@@ -222,6 +310,19 @@ class Layer
   //! to the loss function when computing the objective.  (TODO: better comment)
   virtual double Loss() const { return 0; }
 
+  /**
+   * Estimate the number of floating-point operations that `Forward()` takes
+   * for one point.  This is only used for profiling (see
+   * `MultiLayer::Profiling()`).  The default counts a multiply-add for each
+   * weight and one operation for each output element, which fits dense layers;
+   * layers that apply their weights many times, like convolutions, should
+   * overload this.
+   */
+  virtual double ForwardFLOPs()
+  {
+    return 2.0 * WeightSize() + OutputSize();
+  }
+
   //! Get the input dimensions.
   const std::vector<size_t>& InputDimensions() const { return inputDimensions; }
   //! Modify the input dimensions.
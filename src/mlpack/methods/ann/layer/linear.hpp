@@ -118,6 +118,47 @@ class LinearType : public Layer<MatType>
                 const MatType& error,
                 MatType& gradient);
 
+  /**
+   * Forward pass for a sparse input (for instance, hashed bag-of-words
+   * features), as the first layer of a network.  This takes time proportional
+   * to the number of nonzero elements of the input times the number of
+   * outputs.
+   *
+   * @param input Sparse input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void SparseInputForward(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      MatType& output);
+
+  /**
+   * Calculate the gradient for a sparse input given to SparseInputForward().
+   * Only the weights of the nonzero input elements get nonzero gradients.
+   *
+   * @param input The sparse input used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void SparseInputGradient(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      const MatType& error,
+      MatType& gradient);
+
+  /**
+   * Calculate the gradient for a sparse input like SparseInputGradient(), as a
+   * sparse matrix that only holds the weights of the input units that are
+   * nonzero in the batch (and the bias).  With a regularizer, the dense
+   * gradient is computed and converted.
+   *
+   * @param input The sparse input used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated sparse gradient.
+   */
+  void SparseInputSparseGradient(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient);
+
   //! Get the parameters.
   const MatType& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -133,6 +133,82 @@ void LinearNoBiasType<MatType, RegularizerType>::Gradient(
   regularizer.Evaluate(weight, gradient);
 }
 
+template<typename MatType, typename RegularizerType>
+void LinearNoBiasType<MatType, RegularizerType>::SparseInputForward(
+    const arma::SpMat<typename MatType::elem_type>& input,
+    MatType& output)
+{
+  output = weight * input;
+}
+
+template<typename MatType, typename RegularizerType>
+void LinearNoBiasType<MatType, RegularizerType>::SparseInputGradient(
+    const arma::SpMat<typename MatType::elem_type>& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  // Each nonzero element of the input adds its column of the error to the
+  // gradient of the weights of its input unit.
+  MatType weightGradient;
+  MakeAlias(weightGradient, gradient, outSize, inSize);
+  weightGradient.zeros();
+  typename arma::SpMat<typename MatType::elem_type>::const_iterator it =
+      input.begin();
+  for (; it != input.end(); ++it)
+    weightGradient.col(it.row()) += (*it) * error.col(it.col());
+
+  regularizer.Evaluate(weight, gradient);
+}
+
+template<typename MatType, typename RegularizerType>
+void LinearNoBiasType<MatType, RegularizerType>::SparseInputSparseGradient(
+    const arma::SpMat<typename MatType::elem_type>& input,
+    const MatType& error,
+    arma::SpMat<typename MatType::elem_type>& gradient)
+{
+  using ElemType = typename MatType::elem_type;
+
+  if constexpr (!std::is_same_v<RegularizerType, NoRegularizer>)
+  {
+    // The regularizer gives a dense gradient.
+    Layer<MatType>::SparseInputSparseGradient(input, error, gradient);
+  }
+  else
+  {
+    // Each column of the transposed input holds the nonzero elements of one
+    // input unit.
+    arma::SpMat<ElemType> inputT = input.t();
+    inputT.sync();
+    size_t usedUnits = 0;
+    for (size_t u = 0; u < inputT.n_cols; ++u)
+      if (inputT.col_ptrs[u + 1] > inputT.col_ptrs[u])
+        ++usedUnits;
+
+    // The locations are sorted, since the units are visited in order.
+    arma::umat locations(2, usedUnits * outSize, arma::fill::zeros);
+    arma::Col<ElemType> values(locations.n_cols, arma::fill::zeros);
+    size_t index = 0;
+    for (size_t u = 0; u < inputT.n_cols; ++u)
+    {
+      if (inputT.col_ptrs[u + 1] == inputT.col_ptrs[u])
+        continue;
+
+      for (size_t j = inputT.col_ptrs[u]; j < inputT.col_ptrs[u + 1]; ++j)
+      {
+        values.subvec(index, index + outSize - 1) += inputT.values[j] *
+            error.col(inputT.row_indices[j]);
+      }
+
+      for (size_t r = 0; r < outSize; ++r)
+        locations(0, index + r) = u * outSize + r;
+      index += outSize;
+    }
+
+    gradient = arma::SpMat<ElemType>(locations, values, WeightSize(), 1, false,
+        false);
+  }
+}
+
 template<typename MatType, typename RegularizerType>
 void LinearNoBiasType<MatType, RegularizerType>::ComputeOutputDimensions()
 {
@@ -46,8 +46,9 @@ namespace mlpack {
  * }
  * ```
  *
- * See `FastLSTM` for a faster LSTM version which combines the calculation of
- * the input, forget, output gates and hidden state in a single step.
+ * The weights of the four gates are stacked, so that each step takes one
+ * matrix product for the input and one for the recurrent connections, and the
+ * nonlinearities and the cell update are computed in a single pass.
  *
  * @tparam MatType Matrix representation to accept as input and use for
  *    computation.
@@ -275,19 +276,24 @@ class LSTMType : public RecurrentLayer<MatType>
   // great design; we need some notion of 'working space' that a layer can have.
   MatType workspace;
   MatType deltaY;
-  MatType deltaBlockInput;
-  MatType deltaInputGate;
-  MatType deltaForgetGate;
-  MatType deltaOutputGate;
+  // The deltas of the block input, input gate, forget gate and output gate,
+  // stacked like the rows of `stackedWeight`.
+  MatType deltaGates;
   MatType deltaCell;
   // These correspond to, e.g., dy_{t + 1}.
   MatType nextDeltaY;
-  MatType nextDeltaBlockInput;
-  MatType nextDeltaInputGate;
-  MatType nextDeltaForgetGate;
-  MatType nextDeltaOutputGate;
+  MatType nextDeltaGates;
   MatType nextDeltaCell;
 
+  // The weights of the block input, input gate, forget gate and output gate,
+  // stacked into one matrix for the input and one for the recurrent
+  // connections, so that Forward() and Backward() need one matrix product
+  // each for all gates.  They are copied at the first step of each sequence.
+  MatType stackedWeight;
+  MatType stackedRecurrentWeight;
+  // The stacked gates before the nonlinearities.
+  MatType gates;
+
   // Calling this function will set all the aliases for the functions above to
   // the correct places in the current recurrent state methods.
   void SetInternalAliases(const size_t batchSize);
@@ -295,6 +301,9 @@ class LSTMType : public RecurrentLayer<MatType>
   // Calling this function will set up workspace memory for the backward pass,
   // if necessary.
   void SetBackwardWorkspace(const size_t batchSize);
+
+  // Copy the weights of each gate into the stacked weight matrices.
+  void StackWeights();
 }; // class LSTMType
 
 // Convenience typedefs.
@@ -125,6 +125,8 @@ void LSTMType<MatType>::SetWeights(const MatType& weights)
 template<typename MatType>
 void LSTMType<MatType>::Forward(const MatType& input, MatType& output)
 {
+  typedef typename MatType::elem_type ElemType;
+
   // Convenience alias.
   const size_t batchSize = input.n_cols;
 
@@ -140,52 +142,50 @@ void LSTMType<MatType>::Forward(const MatType& input, MatType& output)
   // c_t  =         z_t % i_t + c_{t - 1} % f_t
   // o_t  = sigmoid(W_o x_t + R_o y_{t - 1} + p_o % c_t + b_o)
   // y_t  =    tanh(c_t) % o_t
-
-  // Start by computing all non-recurrent portions.
-  blockInput = blockInputWeight * input + repmat(blockInputBias, 1, batchSize);
-  inputGate = inputGateWeight * input + repmat(inputGateBias, 1, batchSize);
-  forgetGate = forgetGateWeight * input + repmat(forgetGateBias, 1, batchSize);
-  outputGate = outputGateWeight * input + repmat(outputGateBias, 1, batchSize);
-
-  // Now add in recurrent portions, if needed.
-  if (this->HasPreviousStep())
-  {
-    blockInput += recurrentBlockInputWeight * prevRecurrent;
-    inputGate += recurrentInputGateWeight * prevRecurrent +
-        repmat(peepholeInputGateWeight, 1, batchSize) % prevCell;
-    forgetGate += recurrentForgetGateWeight * prevRecurrent +
-        repmat(peepholeForgetGateWeight, 1, batchSize) % prevCell;
-  }
-
-  // Apply nonlinearities.  (TODO: fast sigmoid?)
-  blockInput = tanh(blockInput);
-  inputGate = 1.0 / (1.0 + exp(-inputGate));
-  forgetGate = 1.0 / (1.0 + exp(-forgetGate));
-
-  // Compute the cell state.
+  //
+  // The weights do not change during a sequence, so they are stacked at its
+  // first step; then the four gates take one matrix product for the input and
+  // one for the recurrent connections.
+  if (!this->HasPreviousStep() || stackedWeight.n_rows != 4 * outSize ||
+      stackedWeight.n_cols != inSize)
+    StackWeights();
+
+  gates = stackedWeight * input;
   if (this->HasPreviousStep())
-    thisCell = blockInput % inputGate + prevCell % forgetGate;
-  else
-    thisCell = blockInput % inputGate;
+    gates += stackedRecurrentWeight * prevRecurrent;
 
-  // Now add recurrent portion to output gate.
-  if (this->HasPreviousStep())
+  // Now the biases, peephole connections, nonlinearities and cell update are
+  // all computed in one pass.
+  const bool hasPreviousStep = this->HasPreviousStep();
+  output.set_size(outSize, batchSize);
+  for (size_t c = 0; c < batchSize; ++c)
   {
-    outputGate += recurrentOutputGateWeight * prevRecurrent +
-        repmat(peepholeOutputGateWeight, 1, batchSize) % thisCell;
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType z = std::tanh(gates(r, c) + blockInputBias[r]);
+      ElemType i = gates(outSize + r, c) + inputGateBias[r];
+      ElemType f = gates(2 * outSize + r, c) + forgetGateBias[r];
+      if (hasPreviousStep)
+      {
+        i += peepholeInputGateWeight[r] * prevCell(r, c);
+        f += peepholeForgetGateWeight[r] * prevCell(r, c);
+      }
+      i = 1 / (1 + std::exp(-i));
+      f = 1 / (1 + std::exp(-f));
+
+      const ElemType cell = hasPreviousStep ?
+          (z * i + prevCell(r, c) * f) : (z * i);
+      const ElemType o = 1 / (1 + std::exp(-(gates(3 * outSize + r, c) +
+          outputGateBias[r] + peepholeOutputGateWeight[r] * cell)));
+
+      blockInput(r, c) = z;
+      inputGate(r, c) = i;
+      forgetGate(r, c) = f;
+      outputGate(r, c) = o;
+      thisCell(r, c) = cell;
+      output(r, c) = std::tanh(cell) * o;
+    }
   }
-  else
-  {
-    // If we don't have a previous step, we still have to consider the peephole
-    // connection.
-    outputGate += repmat(peepholeOutputGateWeight, 1, batchSize) % thisCell;
-  }
-
-  // Apply nonlinearity for output gate.
-  outputGate = 1.0 / (1.0 + exp(-outputGate));
-
-  // Finally, we can compute the output itself.
-  output = tanh(thisCell) % outputGate;
 
   // If necessary, store the recurrent output.
   if (!this->AtFinalStep())
@@ -199,6 +199,8 @@ void LSTMType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
+  typedef typename MatType::elem_type ElemType;
+
   // Compute backward partial derivatives, defined by the following equations.
   // Note that there is a little sleight of hand here between non-delta and
   // delta values.  `o_t`, for instance, refers to the output gate *after* the
@@ -220,60 +222,63 @@ void LSTMType<MatType>::Backward(
   //
   // dx_t = W_z^T dz_t + W_i^T di_t + W_f^T df_t + W_o^T do_t
   //
+  // The deltas of the four gates are stacked like the weights in Forward(), so
+  // that the sums over the gates are a single matrix product.
+  //
   // Before we start, set all the internal aliases, which will contain this time
   // step's values as computed in Forward().
   const size_t batchSize = output.n_cols;
   SetInternalAliases(batchSize);
   SetBackwardWorkspace(batchSize);
 
-  // First attempt...
   if (this->AtFinalStep())
-  {
     deltaY = gy;
-  }
   else
-  {
-    deltaY = gy + recurrentBlockInputWeight.t() * nextDeltaBlockInput +
-                  recurrentInputGateWeight.t() * nextDeltaInputGate +
-                  recurrentForgetGateWeight.t() * nextDeltaForgetGate +
-                  recurrentOutputGateWeight.t() * nextDeltaOutputGate;
-  }
+    deltaY = gy + stackedRecurrentWeight.t() * nextDeltaGates;
 
-  deltaOutputGate = deltaY % tanh(thisCell) % (outputGate % (1.0 - outputGate));
-
-  // Only first two terms if at final step
-  if (this->AtFinalStep())
-  {
-    deltaCell = deltaY % outputGate % (1.0 - square(tanh(thisCell))) +
-        repmat(peepholeOutputGateWeight, 1, batchSize) % deltaOutputGate;
-  }
-  else
+  // To update the cell state, we actually need to use the forget gate values
+  // from the next time step.
+  MatType nextForgetGate;
+  if (!this->AtFinalStep())
   {
-    // To update the cell state, we actually need to use the forget gate values
-    // from the next time step.
-    MatType nextForgetGate;
     MakeAlias(nextForgetGate, this->RecurrentState(this->CurrentStep() + 1),
         outSize, batchSize, 4 * outSize * batchSize);
-
-    deltaCell = deltaY % outputGate % (1.0 - square(tanh(thisCell))) +
-        repmat(peepholeOutputGateWeight, 1, batchSize) % deltaOutputGate +
-        repmat(peepholeInputGateWeight, 1, batchSize) % nextDeltaInputGate +
-        repmat(peepholeForgetGateWeight, 1, batchSize) % nextDeltaForgetGate +
-        nextDeltaCell % nextForgetGate;
   }
 
-  if (this->HasPreviousStep())
-    deltaForgetGate = deltaCell % prevCell % (forgetGate % (1.0 - forgetGate));
-  else
-    deltaForgetGate.zeros();
-  deltaInputGate = deltaCell % blockInput % (inputGate % (1.0 - inputGate));
-  deltaBlockInput = deltaCell % inputGate % (1.0 - square(blockInput));
+  const bool atFinalStep = this->AtFinalStep();
+  const bool hasPreviousStep = this->HasPreviousStep();
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    for (size_t r = 0; r < outSize; ++r)
+    {
+      const ElemType z = blockInput(r, c);
+      const ElemType i = inputGate(r, c);
+      const ElemType f = forgetGate(r, c);
+      const ElemType o = outputGate(r, c);
+      const ElemType tanhCell = std::tanh(thisCell(r, c));
+
+      const ElemType deltaO = deltaY(r, c) * tanhCell * (o * (1 - o));
+      ElemType deltaC = deltaY(r, c) * o * (1 - tanhCell * tanhCell) +
+          peepholeOutputGateWeight[r] * deltaO;
+      // Only the first two terms if at the final step.
+      if (!atFinalStep)
+      {
+        deltaC += peepholeInputGateWeight[r] * nextDeltaGates(outSize + r, c) +
+            peepholeForgetGateWeight[r] * nextDeltaGates(2 * outSize + r, c) +
+            nextDeltaCell(r, c) * nextForgetGate(r, c);
+      }
+
+      deltaGates(r, c) = deltaC * i * (1 - z * z);
+      deltaGates(outSize + r, c) = deltaC * z * (i * (1 - i));
+      deltaGates(2 * outSize + r, c) = hasPreviousStep ?
+          deltaC * prevCell(r, c) * (f * (1 - f)) : 0;
+      deltaGates(3 * outSize + r, c) = deltaO;
+      deltaCell(r, c) = deltaC;
+    }
+  }
 
   // Finally, compute deltaX (which is what we wanted all along).
-  g = blockInputWeight.t() * deltaBlockInput +
-      inputGateWeight.t() * deltaInputGate +
-      forgetGateWeight.t() * deltaForgetGate +
-      outputGateWeight.t() * deltaOutputGate;
+  g = stackedWeight.t() * deltaGates;
 
   // Save this alias for later.
   MakeAlias(thisY, output, output.n_rows, output.n_cols);
@@ -290,77 +295,46 @@ void LSTMType<MatType>::Gradient(
   // aliases are already set by SetBackwardWorkspace().
   //
   // In this implementation we won't use aliases; we'll just address the correct
-  // part of the gradient directly.
-
-  // dW_z = < dz_t, x_t >
-  gradient.submat(0, 0, blockInputWeight.n_elem - 1, 0) =
-      vectorise(deltaBlockInput * input.t());
-  size_t offset = blockInputWeight.n_elem;
-  // dW_i = < di_t, x_t >
-  gradient.submat(offset, 0, offset + inputGateWeight.n_elem - 1, 0) =
-      vectorise(deltaInputGate * input.t());
-  offset += inputGateWeight.n_elem;
-  // dW_f = < df_t, x_t >
-  gradient.submat(offset, 0, offset + forgetGateWeight.n_elem - 1, 0) =
-      vectorise(deltaForgetGate * input.t());
-  offset += forgetGateWeight.n_elem;
-  // dW_o = < do_t, x_t >
-  gradient.submat(offset, 0, offset + outputGateWeight.n_elem - 1, 0) =
-      vectorise(deltaOutputGate * input.t());
-  offset += outputGateWeight.n_elem;
-
-  // db_z = sum(dz_t)
-  gradient.submat(offset, 0, offset + blockInputBias.n_elem - 1, 0) =
-      sum(deltaBlockInput, 1);
-  offset += blockInputBias.n_elem;
-  // db_i = sum(di_t)
-  gradient.submat(offset, 0, offset + inputGateBias.n_elem - 1, 0) =
-      sum(deltaInputGate, 1);
-  offset += inputGateBias.n_elem;
-  // db_f = sum(df_t)
-  gradient.submat(offset, 0, offset + forgetGateBias.n_elem - 1, 0) =
-      sum(deltaForgetGate, 1);
-  offset += forgetGateBias.n_elem;
-  // db_o = sum(do_t)
-  gradient.submat(offset, 0, offset + outputGateBias.n_elem - 1, 0) =
-      sum(deltaOutputGate, 1);
-  offset += outputGateBias.n_elem;
+  // part of the gradient directly.  The gradients of the weights of all gates
+  // are computed with one matrix product of the stacked deltas, and then
+  // copied gate by gate.
+
+  // dW_z = < dz_t, x_t >, and so on for each gate.
+  const size_t inputWeightSize = outSize * inSize;
+  const MatType inputWeightGradient = deltaGates * input.t();
+  size_t offset = 0;
+  for (size_t gate = 0; gate < 4; ++gate)
+  {
+    gradient.submat(offset, 0, offset + inputWeightSize - 1, 0) =
+        vectorise(inputWeightGradient.rows(gate * outSize,
+        (gate + 1) * outSize - 1));
+    offset += inputWeightSize;
+  }
+
+  // db_z = sum(dz_t), and so on; the biases are stored in the order of the
+  // gates, like the stacked deltas.
+  gradient.submat(offset, 0, offset + 4 * outSize - 1, 0) =
+      sum(deltaGates, 1);
+  offset += 4 * outSize;
 
   // For the recurrent weights, the gradient does not apply at the first time
   // step.
-
+  const size_t recurrentWeightSize = outSize * outSize;
   if (!this->AtFinalStep())
   {
-    // dR_z = < dz_{t + 1}, y_t >
-    gradient.submat(offset, 0,
-                    offset + recurrentBlockInputWeight.n_elem - 1, 0) =
-        vectorise(nextDeltaBlockInput * thisY.t());
-    offset += recurrentBlockInputWeight.n_elem;
-
-    // dR_i = < di_{t + 1}, y_t >
-    gradient.submat(offset, 0,
-                    offset + recurrentInputGateWeight.n_elem - 1, 0) =
-        vectorise(nextDeltaInputGate * thisY.t());
-    offset += recurrentInputGateWeight.n_elem;
-
-    // dR_f = < df_{t + 1}, y_t >
-    gradient.submat(offset, 0,
-                    offset + recurrentForgetGateWeight.n_elem - 1, 0) =
-        vectorise(nextDeltaForgetGate * thisY.t());
-    offset += recurrentForgetGateWeight.n_elem;
-
-    // dR_o = < do_{t + 1}, y_t>
-    gradient.submat(offset, 0,
-                    offset + recurrentOutputGateWeight.n_elem - 1, 0) =
-        vectorise(nextDeltaOutputGate * thisY.t());
-    offset += recurrentOutputGateWeight.n_elem;
+    // dR_z = < dz_{t + 1}, y_t >, and so on for each gate.
+    const MatType recurrentWeightGradient = nextDeltaGates * thisY.t();
+    for (size_t gate = 0; gate < 4; ++gate)
+    {
+      gradient.submat(offset, 0, offset + recurrentWeightSize - 1, 0) =
+          vectorise(recurrentWeightGradient.rows(gate * outSize,
+          (gate + 1) * outSize - 1));
+      offset += recurrentWeightSize;
+    }
   }
   else
   {
-    offset += recurrentBlockInputWeight.n_elem +
-        recurrentInputGateWeight.n_elem +
-        recurrentForgetGateWeight.n_elem +
-        recurrentOutputGateWeight.n_elem;
+    offset += 4 * recurrentWeightSize;
   }
 
   // Finally, the peephole connection gradients.
@@ -368,25 +342,22 @@ void LSTMType<MatType>::Gradient(
   // dp_i = c_t % di_{t + 1}
   if (!this->AtFinalStep())
   {
-    gradient.submat(offset, 0,
-                    offset + peepholeInputGateWeight.n_elem - 1, 0) =
-        sum(thisCell % nextDeltaInputGate, 1);
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        sum(thisCell % nextDeltaGates.rows(outSize, 2 * outSize - 1), 1);
   }
-  offset += peepholeInputGateWeight.n_elem;
+  offset += outSize;
 
   // dp_f = c_t % df_{t + 1}
   if (!this->AtFinalStep())
   {
-    gradient.submat(offset, 0,
-                    offset + peepholeForgetGateWeight.n_elem - 1, 0) =
-        sum(thisCell % nextDeltaForgetGate, 1);
+    gradient.submat(offset, 0, offset + outSize - 1, 0) =
+        sum(thisCell % nextDeltaGates.rows(2 * outSize, 3 * outSize - 1), 1);
   }
-  offset += peepholeForgetGateWeight.n_elem;
+  offset += outSize;
 
   // dp_o = c_t % do_t
-  gradient.submat(offset, 0,
-                  offset + peepholeOutputGateWeight.n_elem - 1, 0) =
-      sum(thisCell % deltaOutputGate, 1);
+  gradient.submat(offset, 0, offset + outSize - 1, 0) =
+      sum(thisCell % deltaGates.rows(3 * outSize, 4 * outSize - 1), 1);
 }
 
 template<typename MatType>
@@ -439,63 +410,44 @@ void LSTMType<MatType>::SetInternalAliases(const size_t batchSize)
 template<typename MatType>
 void LSTMType<MatType>::SetBackwardWorkspace(const size_t batchSize)
 {
-  // We need to hold enough space for two time steps.
+  // We need to hold enough space for two time steps: dy, the stacked deltas of
+  // the four gates, and dc for each.
   workspace.set_size(12 * outSize, batchSize);
 
-  if (this->CurrentStep() % 2 == 0)
-  {
-    MakeAlias(deltaY, workspace, outSize, batchSize);
-    MakeAlias(deltaBlockInput, workspace, outSize, batchSize,
-        outSize * batchSize);
-    MakeAlias(deltaInputGate, workspace, outSize, batchSize,
-        2 * outSize * batchSize);
-    MakeAlias(deltaForgetGate, workspace, outSize, batchSize,
-        3 * outSize * batchSize);
-    MakeAlias(deltaOutputGate, workspace, outSize, batchSize,
-        4 * outSize * batchSize);
-    MakeAlias(deltaCell, workspace, outSize, batchSize,
-        5 * outSize * batchSize);
-
-    MakeAlias(nextDeltaY, workspace, outSize, batchSize,
-        6 * outSize * batchSize);
-    MakeAlias(nextDeltaBlockInput, workspace, outSize, batchSize,
-        7 * outSize * batchSize);
-    MakeAlias(nextDeltaInputGate, workspace, outSize, batchSize,
-        8 * outSize * batchSize);
-    MakeAlias(nextDeltaForgetGate, workspace, outSize, batchSize,
-        9 * outSize * batchSize);
-    MakeAlias(nextDeltaOutputGate, workspace, outSize, batchSize,
-        10 * outSize * batchSize);
-    MakeAlias(nextDeltaCell, workspace, outSize, batchSize,
-        11 * outSize * batchSize);
-  }
-  else
-  {
-    MakeAlias(nextDeltaY, workspace, outSize, batchSize);
-    MakeAlias(nextDeltaBlockInput, workspace, outSize, batchSize,
-        outSize * batchSize);
-    MakeAlias(nextDeltaInputGate, workspace, outSize, batchSize,
-        2 * outSize * batchSize);
-    MakeAlias(nextDeltaForgetGate, workspace, outSize, batchSize,
-        3 * outSize * batchSize);
-    MakeAlias(nextDeltaOutputGate, workspace, outSize, batchSize,
-        4 * outSize * batchSize);
-    MakeAlias(nextDeltaCell, workspace, outSize, batchSize,
-        5 * outSize * batchSize);
-
-    MakeAlias(deltaY, workspace, outSize, batchSize,
-        6 * outSize * batchSize);
-    MakeAlias(deltaBlockInput, workspace, outSize, batchSize,
-        7 * outSize * batchSize);
-    MakeAlias(deltaInputGate, workspace, outSize, batchSize,
-        8 * outSize * batchSize);
-    MakeAlias(deltaForgetGate, workspace, outSize, batchSize,
-        9 * outSize * batchSize);
-    MakeAlias(deltaOutputGate, workspace, outSize, batchSize,
-        10 * outSize * batchSize);
-    MakeAlias(deltaCell, workspace, outSize, batchSize,
-        11 * outSize * batchSize);
-  }
+  const size_t stepSize = 6 * outSize * batchSize;
+  const size_t thisOffset = (this->CurrentStep() % 2 == 0) ? 0 : stepSize;
+  const size_t nextOffset = stepSize - thisOffset;
+
+  MakeAlias(deltaY, workspace, outSize, batchSize, thisOffset);
+  MakeAlias(deltaGates, workspace, 4 * outSize, batchSize,
+      thisOffset + outSize * batchSize);
+  MakeAlias(deltaCell, workspace, outSize, batchSize,
+      thisOffset + 5 * outSize * batchSize);
+
+  MakeAlias(nextDeltaY, workspace, outSize, batchSize, nextOffset);
+  MakeAlias(nextDeltaGates, workspace, 4 * outSize, batchSize,
+      nextOffset + outSize * batchSize);
+  MakeAlias(nextDeltaCell, workspace, outSize, batchSize,
+      nextOffset + 5 * outSize * batchSize);
+}
+
+template<typename MatType>
+void LSTMType<MatType>::StackWeights()
+{
+  stackedWeight.set_size(4 * outSize, inSize);
+  stackedWeight.rows(0, outSize - 1) = blockInputWeight;
+  stackedWeight.rows(outSize, 2 * outSize - 1) = inputGateWeight;
+  stackedWeight.rows(2 * outSize, 3 * outSize - 1) = forgetGateWeight;
+  stackedWeight.rows(3 * outSize, 4 * outSize - 1) = outputGateWeight;
+
+  stackedRecurrentWeight.set_size(4 * outSize, outSize);
+  stackedRecurrentWeight.rows(0, outSize - 1) = recurrentBlockInputWeight;
+  stackedRecurrentWeight.rows(outSize, 2 * outSize - 1) =
+      recurrentInputGateWeight;
+  stackedRecurrentWeight.rows(2 * outSize, 3 * outSize - 1) =
+      recurrentForgetGateWeight;
+  stackedRecurrentWeight.rows(3 * outSize, 4 * outSize - 1) =
+      recurrentOutputGateWeight;
 }
 
 template<typename MatType>
@@ -513,18 +465,15 @@ void LSTMType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
     workspace.clear();
 
     deltaY.clear();
-    deltaBlockInput.clear();
-    deltaInputGate.clear();
-    deltaForgetGate.clear();
-    deltaOutputGate.clear();
+    deltaGates.clear();
     deltaCell.clear();
 
     nextDeltaY.clear();
-    nextDeltaBlockInput.clear();
-    nextDeltaInputGate.clear();
-    nextDeltaForgetGate.clear();
-    nextDeltaOutputGate.clear();
+    nextDeltaGates.clear();
     nextDeltaCell.clear();
+
+    stackedWeight.clear();
+    stackedRecurrentWeight.clear();
   }
 }
 
@@ -152,135 +152,28 @@ class MaxPoolingType : public Layer<MatType>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
-  /**
-   * Apply pooling to the input and store the results.
-   *
-   * @param input The input to be apply the pooling rule.
-   * @param output The pooled result.
-   * @param poolingIndices The pooled indices.
-   */
-  void PoolingOperation(
-      const arma::Cube<typename MatType::elem_type>& input,
-      arma::Cube<typename MatType::elem_type>& output,
-      arma::Cube<size_t>& poolingIndices)
-  {
-    // Iterate over all slices individually.
-    #pragma omp parallel for
-    for (size_t s = 0; s < (size_t) input.n_slices; ++s)
-    {
-      for (size_t j = 0, colidx = 0; j < output.n_cols;
-          ++j, colidx += strideHeight)
-      {
-        size_t colEnd = colidx + kernelHeight - 1;
-        // Check if the kernel along column is out of bounds.
-        if (colEnd > input.n_cols - 1)
-        {
-          // If so, we need to reduce the kernel height or terminate.
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
-        }
-        for (size_t i = 0, rowidx = 0; i < output.n_rows;
-            ++i, rowidx += strideWidth)
-        {
-          size_t rowEnd = rowidx + kernelWidth - 1;
-          // Check if the kernel along row is out of bounds.
-          if (rowEnd > input.n_rows - 1)
-          {
-            // If so, we need to reduce the kernel width or terminate.
-            if (floor)
-              continue;
-            rowEnd = input.n_rows - 1;
-          }
-          const std::tuple<size_t, typename MatType::elem_type> poolResult =
-              pooling.PoolingWithIndex(input.slice(s).submat(
-                  rowidx,
-                  colidx,
-                  rowEnd,
-                  colEnd));
-
-          // Now map the returned pooling index, which corresponds to the
-          // submatrix we gave, back to its position in the (linearized) input.
-          const size_t poolIndex = std::get<0>(poolResult);
-          const size_t poolingCol = poolIndex / (kernelWidth);
-          const size_t poolingRow = poolIndex % (kernelWidth);
-          const size_t unmappedPoolingIndex = (rowidx + poolingRow) +
-              input.n_rows * (colidx + poolingCol);
-
-          poolingIndices(i, j, s) = unmappedPoolingIndex;
-          output(i, j, s) = std::get<1>(poolResult);
-        }
-      }
-    }
-  }
+  //! Convenience typedef for the element type of the matrices.
+  using ElemType = typename MatType::elem_type;
 
   /**
-   * Apply pooling to all slices of the input and store the results, but not the
-   * indices used.
+   * Apply pooling to the given number of slices of the input, and store the
+   * results.  If `indices` is not `NULL`, the position of the maximum of each
+   * window in its input slice is stored there too.
    *
-   * @param input The input to apply the pooling rule to.
-   * @param output The pooled result.
-   */
-  void PoolingOperation(
-      const arma::Cube<typename MatType::elem_type>& input,
-      arma::Cube<typename MatType::elem_type>& output)
-  {
-    // Iterate over all slices individually.
-    #pragma omp parallel for
-    for (size_t s = 0; s < (size_t) input.n_slices; ++s)
-    {
-      for (size_t j = 0, colidx = 0; j < output.n_cols;
-          ++j, colidx += strideHeight)
-      {
-        size_t colEnd = colidx + kernelHeight - 1;
-        // Check if the kernel along column is out of bounds.
-        if (colEnd > input.n_cols - 1)
-        {
-          // If so, we need to reduce the kernel height or terminate.
-          if (floor)
-            continue;
-          colEnd = input.n_cols - 1;
-        }
-        for (size_t i = 0, rowidx = 0; i < output.n_rows;
-            ++i, rowidx += strideWidth)
-        {
-          size_t rowEnd = rowidx + kernelWidth - 1;
-          // Check if the kernel along row is out of bounds.
-          if (rowEnd > input.n_rows - 1)
-          {
-            // If so, we need to reduce the kernel width or terminate.
-            if (floor)
-              continue;
-            rowEnd = input.n_rows - 1;
-          }
-
-          output(i, j, s) = pooling.Pooling(input.slice(s).submat(
-              rowidx,
-              colidx,
-              rowEnd,
-              colEnd));
-        }
-      }
-    }
-  }
-
-  /**
-   * Apply unpooling to all slices of the input and store the results.
+   * The window is `KW` x `KH` if those are nonzero, so that the compiler can
+   * unroll the loops for the common small windows; otherwise it is
+   * `kernelWidth` x `kernelHeight`.
    *
-   * @param error The backward error.
+   * @param input The input to apply the pooling rule to.
    * @param output The pooled result.
-   * @param poolingIndices The pooled indices (from `PoolingOperation()`).
+   * @param slices The number of slices of the input (channels times points).
+   * @param indices The pooled indices, or `NULL`.
    */
-  void UnpoolingOperation(
-      const MatType& error,
-      MatType& output,
-      const arma::Mat<size_t>& poolingIndices)
-  {
-    for (size_t i = 0; i < poolingIndices.n_elem; ++i)
-    {
-      output(poolingIndices(i)) += error(i);
-    }
-  }
+  template<size_t KW, size_t KH>
+  void PoolingOperation(const ElemType* input,
+                        ElemType* output,
+                        const size_t slices,
+                        arma::u32* indices) const;
 
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
@@ -300,11 +193,10 @@ class MaxPoolingType : public Layer<MatType>
   //! Locally-stored number of channels.
   size_t channels;
 
-  //! Locally-stored pooling strategy.
-  MaxPoolingRule pooling;
-
-  //! Locally-stored pooling indices.
-  arma::Cube<size_t> poolingIndices;
+  //! Locally-stored pooling indices: for each output element, the position of
+  //! the maximum in its input slice.  These fit in 32 bits, which halves the
+  //! memory read by the backward pass.
+  arma::Col<arma::u32> poolingIndices;
 }; // class MaxPoolingType
 
 // Standard MaxPooling layer.
@@ -52,8 +52,7 @@ MaxPoolingType<MatType>::MaxPoolingType(
     strideWidth(other.strideWidth),
     strideHeight(other.strideHeight),
     floor(other.floor),
-    channels(other.channels),
-    pooling(other.pooling)
+    channels(other.channels)
 {
   // Nothing to do here.
 }
@@ -67,8 +66,7 @@ MaxPoolingType<MatType>::MaxPoolingType(
     strideWidth(std::move(other.strideWidth)),
     strideHeight(std::move(other.strideHeight)),
     floor(std::move(other.floor)),
-    channels(std::move(other.channels)),
-    pooling(std::move(other.pooling))
+    channels(std::move(other.channels))
 {
   // Nothing to do here.
 }
@@ -86,7 +84,6 @@ MaxPoolingType<MatType>::operator=(const MaxPoolingType& other)
     strideHeight = other.strideHeight;
     floor = other.floor;
     channels = other.channels;
-    pooling = other.pooling;
   }
 
   return *this;
@@ -105,7 +102,6 @@ MaxPoolingType<MatType>::operator=(MaxPoolingType&& other)
     strideHeight = std::move(other.strideHeight);
     floor = std::move(other.floor);
     channels = std::move(other.channels);
-    pooling = std::move(other.pooling);
   }
 
   return *this;
@@ -114,27 +110,23 @@ MaxPoolingType<MatType>::operator=(MaxPoolingType&& other)
 template<typename MatType>
 void MaxPoolingType<MatType>::Forward(const MatType& input, MatType& output)
 {
-  arma::Cube<typename MatType::elem_type> inputTemp(
-      const_cast<MatType&>(input).memptr(), this->inputDimensions[0],
-      this->inputDimensions[1], input.n_cols * channels, false, false);
-
-  arma::Cube<typename MatType::elem_type> outputTemp(output.memptr(),
-      this->outputDimensions[0], this->outputDimensions[1],
-      input.n_cols * channels, false, true);
-
+  arma::u32* indices = NULL;
   if (this->training)
   {
     // If we are training, we'll do a backwards pass, so we need to ensure that
     // we know what indices we used.
-    poolingIndices.set_size(this->outputDimensions[0],
-        this->outputDimensions[1], input.n_cols * channels);
-
-    PoolingOperation(inputTemp, outputTemp, poolingIndices);
+    poolingIndices.set_size(output.n_elem);
+    indices = poolingIndices.memptr();
   }
+
+  // The loops of the most common windows are unrolled.
+  const size_t slices = input.n_cols * channels;
+  if (kernelWidth == 2 && kernelHeight == 2)
+    PoolingOperation<2, 2>(input.memptr(), output.memptr(), slices, indices);
+  else if (kernelWidth == 3 && kernelHeight == 3)
+    PoolingOperation<3, 3>(input.memptr(), output.memptr(), slices, indices);
   else
-  {
-    PoolingOperation(inputTemp, outputTemp);
-  }
+    PoolingOperation<0, 0>(input.memptr(), output.memptr(), slices, indices);
 }
 
 template<typename MatType>
@@ -144,24 +136,100 @@ void MaxPoolingType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  arma::Cube<typename MatType::elem_type> mappedError =
-      arma::Cube<typename MatType::elem_type>(((MatType&) gy).memptr(),
-      this->outputDimensions[0], this->outputDimensions[1],
-      channels * input.n_cols, false, false);
+  const size_t inSize = this->inputDimensions[0] * this->inputDimensions[1];
+  const size_t outSize = this->outputDimensions[0] *
+      this->outputDimensions[1];
 
-  arma::Cube<typename MatType::elem_type> gTemp(g.memptr(),
-      this->inputDimensions[0], this->inputDimensions[1],
-      channels * input.n_cols, false, true);
+  g.zeros();
 
-  gTemp.zeros();
+  // There's no version of the backward pass without pooling indices, because
+  // if we call `Backward()`, we know for sure we are training.  Each error is
+  // added to the input element that was the maximum of its window.
+  #pragma omp parallel for
+  for (size_t s = 0; s < (size_t) (channels * input.n_cols); ++s)
+  {
+    const ElemType* error = gy.memptr() + s * outSize;
+    const arma::u32* indices = poolingIndices.memptr() + s * outSize;
+    ElemType* delta = g.memptr() + s * inSize;
+    for (size_t i = 0; i < outSize; ++i)
+      delta[indices[i]] += error[i];
+  }
+}
 
-  // There's no version of UnpoolingOperation without pooling indices, because
-  // if we call `Backward()`, we know for sure we are training.
+template<typename MatType>
+template<size_t KW, size_t KH>
+void MaxPoolingType<MatType>::PoolingOperation(
+    const ElemType* input,
+    ElemType* output,
+    const size_t slices,
+    arma::u32* indices) const
+{
+  const size_t kw = (KW == 0) ? kernelWidth : KW;
+  const size_t kh = (KH == 0) ? kernelHeight : KH;
+  const size_t inRows = this->inputDimensions[0];
+  const size_t inCols = this->inputDimensions[1];
+  const size_t outRows = this->outputDimensions[0];
+  const size_t outCols = this->outputDimensions[1];
+
+  // Iterate over all slices individually.
   #pragma omp parallel for
-  for (size_t s = 0; s < (size_t) mappedError.n_slices; s++)
+  for (size_t s = 0; s < slices; ++s)
   {
-    UnpoolingOperation(mappedError.slice(s), gTemp.slice(s),
-        poolingIndices.slice(s));
+    const ElemType* in = input + s * inRows * inCols;
+    ElemType* out = output + s * outRows * outCols;
+    for (size_t j = 0; j < outCols; ++j)
+    {
+      // If `floor` is false, the last windows may only cover part of the
+      // input.
+      const size_t colStart = std::min(j * strideHeight, inCols - 1);
+      const size_t cols = std::min(kh, inCols - colStart);
+      for (size_t i = 0; i < outRows; ++i)
+      {
+        const size_t rowStart = std::min(i * strideWidth, inRows - 1);
+        const size_t rows = std::min(kw, inRows - rowStart);
+        const ElemType* window = in + rowStart + colStart * inRows;
+
+        // Like `index_max()`, this takes the first maximum in column-major
+        // order.
+        size_t maxIndex = 0;
+        ElemType maxValue = window[0];
+        if (rows == kw && cols == kh)
+        {
+          for (size_t c = 0; c < kh; ++c)
+          {
+            for (size_t r = 0; r < kw; ++r)
+            {
+              if (window[r + c * inRows] > maxValue)
+              {
+                maxValue = window[r + c * inRows];
+                maxIndex = r + c * inRows;
+              }
+            }
+          }
+        }
+        else
+        {
+          for (size_t c = 0; c < cols; ++c)
+          {
+            for (size_t r = 0; r < rows; ++r)
+            {
+              if (window[r + c * inRows] > maxValue)
+              {
+                maxValue = window[r + c * inRows];
+                maxIndex = r + c * inRows;
+              }
+            }
+          }
+        }
+
+        out[i + j * outRows] = maxValue;
+        if (indices)
+        {
+          indices[s * outRows * outCols + i + j * outRows] =
+              (arma::u32) (rowStart + colStart * inRows + maxIndex);
+        }
+      }
+    }
   }
 }
 
@@ -122,34 +122,48 @@ class MeanPoolingType : public Layer<MatType>
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  //! Convenience typedef for the element type of the matrices.
+  using ElemType = typename MatType::elem_type;
+
   /**
-   * Apply pooling to all slices of the input and store the results.
+   * Apply pooling to the given number of slices of the input, and store the
+   * results.
+   *
+   * The window is `KW` x `KH` if those are nonzero, so that the compiler can
+   * unroll the loops for the common small windows; otherwise it is
+   * `kernelWidth` x `kernelHeight`.
    *
-   * @param input The input to be apply the pooling rule.
+   * @param input The input to apply the pooling rule to.
    * @param output The pooled result.
+   * @param slices The number of slices of the input (channels times points).
    */
-  void PoolingOperation(
-      const arma::Cube<typename MatType::elem_type>& input,
-      arma::Cube<typename MatType::elem_type>& output);
+  template<size_t KW, size_t KH>
+  void PoolingOperation(const ElemType* input,
+                        ElemType* output,
+                        const size_t slices) const;
 
   /**
-   * Apply unpooling to the input and store the results.
+   * Add the error of each window, divided by the size of the window, to each
+   * input element of the window, for the given number of slices.  `KW` and
+   * `KH` are like for `PoolingOperation()`.
    *
-   * @param input The input to be apply the unpooling rule.
-   * @param output The pooled result.
+   * @param error The backward error.
+   * @param output The unpooled result.
+   * @param slices The number of slices of the error (channels times points).
    */
-  void Unpooling(const MatType& error, MatType& output);
+  template<size_t KW, size_t KH>
+  void UnpoolingOperation(const ElemType* error,
+                          ElemType* output,
+                          const size_t slices) const;
 
   /**
-   * Return the average value of the receptive block.
+   * Apply unpooling to one slice of the error with prefix sums, which is
+   * faster than `UnpoolingOperation()` for large windows that overlap a lot.
    *
-   * @param input Input used to perform the pooling operation.  Could be an
-   *     Armadillo subview.
+   * @param error The backward error.
+   * @param output The unpooled result.
    */
-  typename MatType::elem_type Pooling(const MatType& input)
-  {
-    return arma::mean(vectorise(input));
-  }
+  void Unpooling(const MatType& error, MatType& output);
 
   //! Locally-stored width of the pooling window.
   size_t kernelWidth;
@@ -112,18 +112,14 @@ template<typename MatType>
 void MeanPoolingType<MatType>::Forward(
     const MatType& input, MatType& output)
 {
-  // Create Alias of input as 2D image as input is 1D vector.
-  arma::Cube<typename MatType::elem_type> inputTemp(
-      const_cast<MatType&>(input).memptr(), this->inputDimensions[0],
-      this->inputDimensions[1], input.n_cols * channels, false, false);
-
-  // Create Alias of output as 2D image as output is 1D vector.
-  arma::Cube<typename MatType::elem_type> outputTemp(output.memptr(),
-      this->outputDimensions[0], this->outputDimensions[1],
-      input.n_cols * channels, false, true);
-
-  // Apply Pooling to the input.
-  PoolingOperation(inputTemp, outputTemp);
+  // The loops of the most common windows are unrolled.
+  const size_t slices = input.n_cols * channels;
+  if (kernelWidth == 2 && kernelHeight == 2)
+    PoolingOperation<2, 2>(input.memptr(), output.memptr(), slices);
+  else if (kernelWidth == 3 && kernelHeight == 3)
+    PoolingOperation<3, 3>(input.memptr(), output.memptr(), slices);
+  else
+    PoolingOperation<0, 0>(input.memptr(), output.memptr(), slices);
 }
 
 template<typename MatType>
@@ -133,6 +129,39 @@ void MeanPoolingType<MatType>::Backward(
   const MatType& gy,
   MatType& g)
 {
+  // Initialize the gradient with zero.
+  g.zeros();
+
+  const size_t slices = channels * input.n_cols;
+  if (kernelWidth == 2 && kernelHeight == 2)
+  {
+    UnpoolingOperation<2, 2>(gy.memptr(), g.memptr(), slices);
+    return;
+  }
+  else if (kernelWidth == 3 && kernelHeight == 3)
+  {
+    UnpoolingOperation<3, 3>(gy.memptr(), g.memptr(), slices);
+    return;
+  }
+
+  // This condition comes by comparing the number of operations involved in the
+  // brute force method and the prefix method. Let the area of error be
+  // errorArea and area of kernal be kernelArea. Total number of operations in
+  // brute force method will be `errorArea * kernelArea` and for each element in
+  // error we are doing `kernelArea` number of operations. Whereas in the prefix
+  // method the total number of operations will be `4 * errorArea + 2 *
+  // outputArea`. The term `2 * outputArea` comes from prefix sums performed
+  // (col-wise and row-wise).  We can use this to determine which method to use.
+  const size_t errorArea = this->outputDimensions[0] *
+      this->outputDimensions[1];
+  const size_t outputArea = this->inputDimensions[0] *
+      this->inputDimensions[1];
+  if (errorArea * kernelHeight * kernelWidth <= 4 * errorArea + 2 * outputArea)
+  {
+    UnpoolingOperation<0, 0>(gy.memptr(), g.memptr(), slices);
+    return;
+  }
+
   // Create Alias of gy as 2D matrix as gy is 1D vector.
   arma::Cube<typename MatType::elem_type> mappedError =
       arma::Cube<typename MatType::elem_type>(((MatType&) gy).memptr(),
@@ -144,8 +173,6 @@ void MeanPoolingType<MatType>::Backward(
       this->inputDimensions[0], this->inputDimensions[1],
       channels * input.n_cols, false, true);
 
-  // Initialize the gradient with zero.
-  gTemp.zeros();
   #pragma omp parallel for
   for (size_t s = 0; s < (size_t) mappedError.n_slices; s++)
   {
@@ -200,204 +227,207 @@ void MeanPoolingType<MatType>::serialize(
 }
 
 template<typename MatType>
+template<size_t KW, size_t KH>
 void MeanPoolingType<MatType>::PoolingOperation(
-    const arma::Cube<typename MatType::elem_type>& input,
-    arma::Cube<typename MatType::elem_type>& output)
+    const ElemType* input,
+    ElemType* output,
+    const size_t slices) const
 {
+  const size_t kw = (KW == 0) ? kernelWidth : KW;
+  const size_t kh = (KH == 0) ? kernelHeight : KH;
+  const size_t inRows = this->inputDimensions[0];
+  const size_t inCols = this->inputDimensions[1];
+  const size_t outRows = this->outputDimensions[0];
+  const size_t outCols = this->outputDimensions[1];
+
   // Iterate over all slices individually.
   #pragma omp parallel for
-  for (size_t s = 0; s < (size_t) input.n_slices; ++s)
+  for (size_t s = 0; s < slices; ++s)
   {
-    for (size_t j = 0, colidx = 0; j < output.n_cols;
-        ++j, colidx += strideHeight)
+    const ElemType* in = input + s * inRows * inCols;
+    ElemType* out = output + s * outRows * outCols;
+    for (size_t j = 0; j < outCols; ++j)
     {
-      size_t colEnd = colidx + kernelHeight - 1;
-      // Check if the kernel along column is out of bounds.
-      if (colEnd > input.n_cols - 1)
+      // If `floor` is false, the last windows may only cover part of the
+      // input; then the mean is over that part only.
+      const size_t colStart = std::min(j * strideHeight, inCols - 1);
+      const size_t cols = std::min(kh, inCols - colStart);
+      for (size_t i = 0; i < outRows; ++i)
       {
-        // If so, we need to reduce the kernel height or terminate.
-        if (floor)
-          continue;
-        colEnd = input.n_cols - 1;
-      }
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-          ++i, rowidx += strideWidth)
-      {
-        size_t rowEnd = rowidx + kernelWidth - 1;
-        // Check if the kernel along row is out of bounds.
-        if (rowEnd > input.n_rows - 1)
+        const size_t rowStart = std::min(i * strideWidth, inRows - 1);
+        const size_t rows = std::min(kw, inRows - rowStart);
+        const ElemType* window = in + rowStart + colStart * inRows;
+
+        ElemType sum = 0;
+        if (rows == kw && cols == kh)
         {
-          // If so, we need to reduce the kernel width or terminate.
-          if (floor)
-            continue;
-          rowEnd = input.n_rows - 1;
+          for (size_t c = 0; c < kh; ++c)
+            for (size_t r = 0; r < kw; ++r)
+              sum += window[r + c * inRows];
         }
-        output(i, j, s) = Pooling(input.slice(s).submat(
-            rowidx,
-            colidx,
-            rowEnd,
-            colEnd));
+        else
+        {
+          for (size_t c = 0; c < cols; ++c)
+            for (size_t r = 0; r < rows; ++r)
+              sum += window[r + c * inRows];
+        }
+
+        out[i + j * outRows] = sum / (rows * cols);
       }
     }
   }
 }
 
 template<typename MatType>
-void MeanPoolingType<MatType>::Unpooling(
-    const MatType& error,
-    MatType& output)
+template<size_t KW, size_t KH>
+void MeanPoolingType<MatType>::UnpoolingOperation(
+    const ElemType* error,
+    ElemType* output,
+    const size_t slices) const
 {
-  // This condition comes by comparing the number of operations involved in the
-  // brute force method and the prefix method. Let the area of error be
-  // errorArea and area of kernal be kernelArea. Total number of operations in
-  // brute force method will be `errorArea * kernelArea` and for each element in
-  // error we are doing `kernelArea` number of operations. Whereas in the prefix
-  // method the total number of operations will be `4 * errorArea + 2 *
-  // outputArea`. The term `2 * outputArea` comes from prefix sums performed
-  // (col-wise and row-wise).  We can use this to determine which method to use.
-  const bool condition = (error.n_elem * kernelHeight * kernelWidth) >
-      (4 * error.n_elem + 2 * output.n_elem);
-
-  if (condition)
+  const size_t kw = (KW == 0) ? kernelWidth : KW;
+  const size_t kh = (KH == 0) ? kernelHeight : KH;
+  const size_t inRows = this->inputDimensions[0];
+  const size_t inCols = this->inputDimensions[1];
+  const size_t outRows = this->outputDimensions[0];
+  const size_t outCols = this->outputDimensions[1];
+
+  // The windows are the same as in PoolingOperation().
+  #pragma omp parallel for
+  for (size_t s = 0; s < slices; ++s)
   {
-    // If this condition is true then theoretically the prefix sum method of
-    // unpooling is faster. The aim of unpooling is to add `error(i, j) /
-    // kernelArea` to `outputArea(kernal)`. This requires `outputArea.n_elem`
-    // additions. So, total operations required will be `error.n_elem *
-    // outputArea.n_elem` operations.  To improve this method we will use an
-    // idea of prefix sums. Let's see this method in 1-D matrix then we will
-    // extend it to 2-D matrix.  Let the input be a 1-D matrix input = `[0, 0,
-    // 0, 0, 0, 0, 0, 0, 0, 0]` of size 10 and we want to add `10` to idx = 1 to
-    // idx = 5. In brute force method we can run a loop from idx = 1 to idx = 5
-    // and add `10` to each element. In prefix method We will add `+10` to idx =
-    // 1 and `-10` to idx = (5 + 1). Now the input will look like `[0, +10, 0,
-    // 0, 0, 0, -10, 0, 0, 0]`. After that we can just do prefix sum `input[i]
-    // += input[i - 1]`. Then the input becomes `[0, +10, +10, +10, +10, +10, 0,
-    // 0, 0, 0]`. So the total computation require by this method is (2
-    // additions + Prefix operations).  Note that if there are `k` such
-    // operation of adding a number of some continuous subarray. Then the brute
-    // force method will require `k * size(subarray)` operations. But the prefix
-    // method will require `2 * k + Prefix` operations, because the Prefix can
-    // be performed once at the end.  Now for 2-D matrix. Lets say we want to
-    // add `e` to all elements from input(x1 : x2, y1 : y2). So the inputArea =
-    // (x2 - x1 + 1) * (y2 - y1 + 1).
-
-    // In prefix method the following operations will be performed:
-    //    1. Add `+e` to input(x1, y1).
-    //    2. Add `-e` to input(x2 + 1, y1).
-    //    3. Add `-e` to input(x1, y2 + 1).
-    //    4. Add `+e` to input(x2 + 1, y2 + 1).
-    //    5. Perform Prefix sum over columns i.e input(i, j) += input(i, j - 1)
-    //    6. Perform Prefix sum over rows i.e input(i, j) += input(i - 1, j)
-    // So lets say if we had `k` number of such operations. The brute force
-    // method will require `kernelArea * k` operations.
-    // The prefix method will require `4 * k + Prefix operation`.
-
-    for (size_t j = 0, colidx = 0; j < output.n_cols; j += strideHeight,
-         ++colidx)
+    const ElemType* e = error + s * outRows * outCols;
+    ElemType* out = output + s * inRows * inCols;
+    for (size_t j = 0; j < outCols; ++j)
     {
-      size_t colEnd = j + kernelHeight - 1;
-      // Check if the kernel along column is out of bounds.
-      if (colEnd > output.n_cols - 1)
+      const size_t colStart = std::min(j * strideHeight, inCols - 1);
+      const size_t cols = std::min(kh, inCols - colStart);
+      for (size_t i = 0; i < outRows; ++i)
       {
-        // If so, we need to reduce the kernel height or terminate.
-        if (floor)
-          continue;
-        colEnd = output.n_cols - 1;
-      }
+        const size_t rowStart = std::min(i * strideWidth, inRows - 1);
+        const size_t rows = std::min(kw, inRows - rowStart);
+        ElemType* window = out + rowStart + colStart * inRows;
 
-      for (size_t i = 0, rowidx = 0; i < output.n_rows;
-           i += strideWidth, ++rowidx)
-      {
-        // We have to add error(i, j) to output(span(rowidx, rowEnd),
-        // span(colidx, colEnd)).
-        // The steps of prefix sum method:
-        //
-        // 1. For each (rowidx, colidx) perform:
-        //    1.1 Add +error(rowidx, colidx) to output(i, j)
-        //    1.2 Add -error(rowidx, colidx) to output(i, colend + 1)
-        //    1.3 Add -error(rowidx, colidx) to output(rowend + 1, j)
-        //    1.4 Add +error(rowidx, colidx) to output(rowend + 1, colend + 1)
-        //
-        // 2. Do prefix sum column wise i.e output(i, j) += output(i, j - 1)
-        // 2. Do prefix sum row wise i.e output(i, j) += output(i - 1, j)
-
-        size_t rowEnd = i + kernelWidth - 1;
-        // Check if the kernel along row is out of bounds.
-        if (rowEnd > output.n_rows - 1)
+        const ElemType value = e[i + j * outRows] / (rows * cols);
+        if (rows == kw && cols == kh)
         {
-          // If so, we need to reduce the kernel width or terminate.
-          if (floor)
-            continue;
-          rowEnd = output.n_rows - 1;
+          for (size_t c = 0; c < kh; ++c)
+            for (size_t r = 0; r < kw; ++r)
+              window[r + c * inRows] += value;
         }
-
-        size_t kernelArea = (rowEnd - i + 1) * (colEnd - j + 1);
-        output(i, j) += error(rowidx, colidx) / kernelArea;
-
-        if (rowEnd + 1 < output.n_rows)
+        else
         {
-          output(rowEnd + 1, j) -= error(rowidx, colidx) / kernelArea;
-
-          if (colEnd + 1 < output.n_cols)
-          {
-            output(rowEnd + 1, colEnd + 1) += error(rowidx, colidx) /
-                kernelArea;
-          }
+          for (size_t c = 0; c < cols; ++c)
+            for (size_t r = 0; r < rows; ++r)
+              window[r + c * inRows] += value;
         }
-
-        if (colEnd + 1 < output.n_cols)
-          output(i, colEnd + 1) -= error(rowidx, colidx) / kernelArea;
       }
     }
-
-    for (size_t i = 1; i < output.n_rows; ++i)
-      output.row(i) += output.row(i - 1);
-
-    for (size_t j = 1; j < output.n_cols; ++j)
-      output.col(j) += output.col(j - 1);
   }
-  else
+}
+
+template<typename MatType>
+void MeanPoolingType<MatType>::Unpooling(
+    const MatType& error,
+    MatType& output)
+{
+  // For large windows, the prefix sum method of unpooling is theoretically
+  // faster (see Backward()). The aim of unpooling is to add `error(i, j) /
+  // kernelArea` to `outputArea(kernal)`. This requires `outputArea.n_elem`
+  // additions. So, total operations required will be `error.n_elem *
+  // outputArea.n_elem` operations.  To improve this method we will use an
+  // idea of prefix sums. Let's see this method in 1-D matrix then we will
+  // extend it to 2-D matrix.  Let the input be a 1-D matrix input = `[0, 0,
+  // 0, 0, 0, 0, 0, 0, 0, 0]` of size 10 and we want to add `10` to idx = 1 to
+  // idx = 5. In brute force method we can run a loop from idx = 1 to idx = 5
+  // and add `10` to each element. In prefix method We will add `+10` to idx =
+  // 1 and `-10` to idx = (5 + 1). Now the input will look like `[0, +10, 0,
+  // 0, 0, 0, -10, 0, 0, 0]`. After that we can just do prefix sum `input[i]
+  // += input[i - 1]`. Then the input becomes `[0, +10, +10, +10, +10, +10, 0,
+  // 0, 0, 0]`. So the total computation require by this method is (2
+  // additions + Prefix operations).  Note that if there are `k` such
+  // operation of adding a number of some continuous subarray. Then the brute
+  // force method will require `k * size(subarray)` operations. But the prefix
+  // method will require `2 * k + Prefix` operations, because the Prefix can
+  // be performed once at the end.  Now for 2-D matrix. Lets say we want to
+  // add `e` to all elements from input(x1 : x2, y1 : y2). So the inputArea =
+  // (x2 - x1 + 1) * (y2 - y1 + 1).
+
+  // In prefix method the following operations will be performed:
+  //    1. Add `+e` to input(x1, y1).
+  //    2. Add `-e` to input(x2 + 1, y1).
+  //    3. Add `-e` to input(x1, y2 + 1).
+  //    4. Add `+e` to input(x2 + 1, y2 + 1).
+  //    5. Perform Prefix sum over columns i.e input(i, j) += input(i, j - 1)
+  //    6. Perform Prefix sum over rows i.e input(i, j) += input(i - 1, j)
+  // So lets say if we had `k` number of such operations. The brute force
+  // method will require `kernelArea * k` operations.
+  // The prefix method will require `4 * k + Prefix operation`.
+
+  // Without `floor`, there are fewer windows than positions in the input.
+  for (size_t j = 0, colidx = 0; j < output.n_cols && colidx < error.n_cols;
+       j += strideHeight, ++colidx)
   {
-    arma::Mat<typename MatType::elem_type> unpooledError;
-    for (size_t j = 0, colidx = 0; j < output.n_cols; j += strideHeight,
-         ++colidx)
+    size_t colEnd = j + kernelHeight - 1;
+    // Check if the kernel along column is out of bounds.
+    if (colEnd > output.n_cols - 1)
+    {
+      // If so, we need to reduce the kernel height or terminate.
+      if (floor)
+        continue;
+      colEnd = output.n_cols - 1;
+    }
+
+    for (size_t i = 0, rowidx = 0; i < output.n_rows &&
+         rowidx < error.n_rows; i += strideWidth, ++rowidx)
     {
-      size_t colEnd = j + kernelHeight - 1;
-      // Check if the kernel along column is out of bounds.
-      if (colEnd > output.n_cols - 1)
+      // We have to add error(i, j) to output(span(rowidx, rowEnd),
+      // span(colidx, colEnd)).
+      // The steps of prefix sum method:
+      //
+      // 1. For each (rowidx, colidx) perform:
+      //    1.1 Add +error(rowidx, colidx) to output(i, j)
+      //    1.2 Add -error(rowidx, colidx) to output(i, colend + 1)
+      //    1.3 Add -error(rowidx, colidx) to output(rowend + 1, j)
+      //    1.4 Add +error(rowidx, colidx) to output(rowend + 1, colend + 1)
+      //
+      // 2. Do prefix sum column wise i.e output(i, j) += output(i, j - 1)
+      // 2. Do prefix sum row wise i.e output(i, j) += output(i - 1, j)
+
+      size_t rowEnd = i + kernelWidth - 1;
+      // Check if the kernel along row is out of bounds.
+      if (rowEnd > output.n_rows - 1)
       {
-        // If so, we need to reduce the kernel height or terminate.
+        // If so, we need to reduce the kernel width or terminate.
         if (floor)
           continue;
-        colEnd = output.n_cols - 1;
+        rowEnd = output.n_rows - 1;
       }
 
-      for (size_t i = 0, rowidx = 0; i < output.n_rows; i += strideWidth,
-           ++rowidx)
+      size_t kernelArea = (rowEnd - i + 1) * (colEnd - j + 1);
+      output(i, j) += error(rowidx, colidx) / kernelArea;
+
+      if (rowEnd + 1 < output.n_rows)
       {
-        size_t rowEnd = i + kernelWidth - 1;
-        // Check if the kernel along row is out of bounds.
-        if (rowEnd > output.n_rows - 1)
+        output(rowEnd + 1, j) -= error(rowidx, colidx) / kernelArea;
+
+        if (colEnd + 1 < output.n_cols)
         {
-          // If so, we need to reduce the kernel width or terminate.
-          if (floor)
-            continue;
-          rowEnd = output.n_rows - 1;
+          output(rowEnd + 1, colEnd + 1) += error(rowidx, colidx) /
+              kernelArea;
         }
-
-        MatType outputArea = output(arma::span(i, rowEnd),
-                                    arma::span(j, colEnd));
-
-        unpooledError = arma::Mat<typename MatType::elem_type>(
-            outputArea.n_rows, outputArea.n_cols);
-        unpooledError.fill(error(rowidx, colidx) / outputArea.n_elem);
-
-        output(arma::span(i, i + outputArea.n_rows - 1),
-               arma::span(j, j + outputArea.n_cols - 1)) += unpooledError;
       }
+
+      if (colEnd + 1 < output.n_cols)
+        output(i, colEnd + 1) -= error(rowidx, colidx) / kernelArea;
     }
   }
+
+  for (size_t i = 1; i < output.n_rows; ++i)
+    output.row(i) += output.row(i - 1);
+
+  for (size_t j = 1; j < output.n_cols; ++j)
+    output.col(j) += output.col(j - 1);
 }
 
 } // namespace mlpack
@@ -12,10 +12,57 @@
 #ifndef MLPACK_METHODS_ANN_LAYER_MULTI_LAYER_HPP
 #define MLPACK_METHODS_ANN_LAYER_MULTI_LAYER_HPP
 
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
 #include "layer.hpp"
 
 namespace mlpack {
 
+/**
+ * The statistics that a MultiLayer records for one of its layers when
+ * profiling is enabled (see `MultiLayer::Profiling()`).  Times are the total
+ * wall time in seconds of all calls since profiling was last reset.
+ */
+struct LayerProfile
+{
+  LayerProfile() :
+      forwardCalls(0),
+      backwardCalls(0),
+      gradientCalls(0),
+      forwardTime(0.0),
+      backwardTime(0.0),
+      gradientTime(0.0),
+      flops(0.0),
+      outputBytes(0),
+      deltaBytes(0)
+  { }
+
+  //! Number of calls to `Forward()`.
+  size_t forwardCalls;
+  //! Number of calls to `Backward()`.
+  size_t backwardCalls;
+  //! Number of calls to `Gradient()` or `SparseGradient()`.
+  size_t gradientCalls;
+
+  //! Total time of the calls to `Forward()`, in seconds.
+  double forwardTime;
+  //! Total time of the calls to `Backward()`, in seconds.
+  double backwardTime;
+  //! Total time of the calls to `Gradient()`, in seconds.
+  double gradientTime;
+
+  //! Estimated floating-point operations of all calls; see
+  //! `Layer::ForwardFLOPs()`.
+  double flops;
+
+  //! Size in bytes of the output of the last call to `Forward()`.
+  size_t outputBytes;
+  //! Size in bytes of the delta of the last call to `Backward()`.
+  size_t deltaBytes;
+};
+
 /**
  * A "multi-layer" is a layer that is a wrapper around other layers.  It passes
  * the input through all of its child layers sequentially, returning the output
@@ -125,6 +172,95 @@ class MultiLayer : public Layer<MatType>
                         const MatType& error,
                         MatType& gradient);
 
+  /**
+   * Compute the gradients of each layer like `Gradient()`, but as a sparse
+   * matrix, using `SparseGradient()` of each layer.
+   *
+   * @param input Original input data provided to Forward().
+   * @param error Error as computed by `Backward()`.
+   * @param gradient Sparse matrix to store the gradients in.
+   */
+  virtual void SparseGradient(
+      const MatType& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient);
+
+  /**
+   * Perform the backward pass and compute the gradients of each layer, like
+   * `Backward()` followed by `Gradient()`, but layer by layer from the last
+   * one: the gradient of each layer is computed right after its backward pass,
+   * and `callback(layerGradient)` is then called with the gradient of that
+   * layer (an alias of the right part of `gradient`, which may be empty).
+   * This lets the gradients of the last layers be used (for instance, sent to
+   * other processes) while the backward pass of the first layers runs.
+   *
+   * `gradient` is expected to have the correct size already.
+   *
+   * @param input Original input data provided to Forward().
+   * @param output Output as computed by `Forward()`.
+   * @param gy Backpropagated error of the output.
+   * @param g Matrix to store the backpropagated error of the input in.
+   * @param gradient Matrix to store the gradients in.
+   * @param callback Function called with the gradient of each layer.
+   */
+  template<typename CallbackType>
+  void BackwardGradient(const MatType& input,
+                        const MatType& output,
+                        const MatType& gy,
+                        MatType& g,
+                        MatType& gradient,
+                        CallbackType&& callback);
+
+  /**
+   * Perform the forward pass of the network for a sparse input.  The first
+   * layer is given the sparse input with its `SparseInputForward()` (so it
+   * must be a layer like `Linear` or `LinearNoBias`), and the outputs of all
+   * the other layers are dense, like with `Forward()`.
+   *
+   * @param input Sparse input data to the first layer.
+   * @param output Output of the last layer.
+   */
+  virtual void SparseInputForward(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      MatType& output);
+
+  /**
+   * Perform the backward pass of the network after `SparseInputForward()`.
+   * The error is propagated back to the output of the first layer only, so no
+   * delta of the size of the (sparse) input is ever allocated.
+   *
+   * @param output Output of the last layer, given by `SparseInputForward()`.
+   * @param gy Backpropagated error of the output.
+   */
+  virtual void SparseInputBackward(const MatType& output, const MatType& gy);
+
+  /**
+   * Compute the gradients of each layer after `SparseInputBackward()`, like
+   * `Gradient()`; the first layer uses its `SparseInputGradient()`.
+   *
+   * @param input Sparse input data given to `SparseInputForward()`.
+   * @param error Error of the output of the last layer.
+   * @param gradient Matrix to store the gradients in.
+   */
+  virtual void SparseInputGradient(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      const MatType& error,
+      MatType& gradient);
+
+  /**
+   * Compute the gradients of each layer after `SparseInputBackward()` as a
+   * sparse matrix, like `SparseGradient()`; the first layer uses its
+   * `SparseInputSparseGradient()`.
+   *
+   * @param input Sparse input data given to `SparseInputForward()`.
+   * @param error Error of the output of the last layer.
+   * @param gradient Sparse matrix to store the gradients in.
+   */
+  virtual void SparseInputSparseGradient(
+      const arma::SpMat<typename MatType::elem_type>& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient);
+
   /**
    * Set the weights of the layer to use the memory given as `weightsPtr`.
    */
@@ -158,6 +294,41 @@ class MultiLayer : public Layer<MatType>
    */
   virtual double Loss() const;
 
+  /**
+   * Estimate the floating-point operations of `Forward()` for one point; this
+   * is the sum of the estimates of each layer.
+   */
+  virtual double ForwardFLOPs();
+
+  /**
+   * Get whether the time and operations of each held layer are recorded.
+   */
+  bool Profiling() const { return profiling; }
+  /**
+   * Modify whether the time and operations of each held layer are recorded.
+   * When `true`, each call to `Forward()`, `Backward()`, `Gradient()` and
+   * `SparseGradient()` of each layer is timed, and its statistics are added to
+   * `Profile()`.  This is disabled by default, and costs a clock read for each
+   * layer call when enabled.
+   */
+  bool& Profiling() { return profiling; }
+
+  //! Get the statistics of each held layer, recorded while `Profiling()` was
+  //! enabled.
+  const std::vector<LayerProfile>& Profile() const { return profile; }
+
+  //! Reset the statistics of each held layer.
+  void ResetProfile() { profile.assign(network.size(), LayerProfile()); }
+
+  /**
+   * Print the statistics of each held layer as a table: the number of calls,
+   * the time of each pass, the estimated operations and their rate, and the
+   * memory of the layer's output and delta.
+   *
+   * @param stream Stream to print the table to.
+   */
+  void PrintProfile(std::ostream& stream) const;
+
   /**
    * Add a new module to the model.
    *
@@ -213,9 +384,12 @@ class MultiLayer : public Layer<MatType>
    * assuming that the input will have the given `batchSize`.  When `Backward()`
    * is called, each internally-held layer will output the results of its
    * backwards pass into the memory allocated by this function (this is the
-   * internal member `layerDeltaMatrix` and its aliases `layerDeltas`).
+   * internal member `layerDeltaMatrix` and its aliases `layerDeltas`).  If
+   * `firstLayerDelta` is false, no memory is used for the delta of the input
+   * of the first layer (see `SparseInputBackward()`).
    */
-  void InitializeBackwardPassMemory(const size_t batchSize);
+  void InitializeBackwardPassMemory(const size_t batchSize,
+                                    const bool firstLayerDelta = true);
 
   /**
    * Initialize memory for the gradient pass.  This sets the internal aliases
@@ -225,6 +399,63 @@ class MultiLayer : public Layer<MatType>
    */
   void InitializeGradientPassMemory(MatType& gradient);
 
+  /**
+   * Call `Forward()` of layer `i`, and record its statistics if profiling is
+   * enabled.  `LayerBackward()` and `LayerGradient()` do the same for the
+   * other passes.
+   */
+  void LayerForward(const size_t i, const MatType& input, MatType& output);
+
+  //! Call `Backward()` of layer `i`, and record its statistics if profiling is
+  //! enabled.
+  void LayerBackward(const size_t i,
+                     const MatType& input,
+                     const MatType& output,
+                     const MatType& gy,
+                     MatType& g);
+
+  //! Call `Gradient()` of layer `i`, and record its statistics if profiling is
+  //! enabled.
+  void LayerGradient(const size_t i,
+                     const MatType& input,
+                     const MatType& error,
+                     MatType& gradient);
+
+  //! Call `SparseGradient()` of layer `i`, and record its statistics (like a
+  //! call to `Gradient()`) if profiling is enabled.
+  void LayerSparseGradient(
+      const size_t i,
+      const MatType& input,
+      const MatType& error,
+      arma::SpMat<typename MatType::elem_type>& gradient);
+
+  /**
+   * Call the given function, which passes a sparse input with `nonZeros`
+   * nonzero elements to the first layer, and record its statistics like a call
+   * to `Forward()` (if `forward` is true) or `Gradient()`, if profiling is
+   * enabled.
+   */
+  template<typename FunctionType>
+  void FirstLayerSparseInput(const FunctionType& function,
+                             const size_t nonZeros,
+                             const bool forward);
+
+  //! Stack the given sparse gradients of each layer into `gradient`.
+  void StackSparseGradients(
+      const std::vector<arma::SpMat<typename MatType::elem_type>>& gradients,
+      arma::SpMat<typename MatType::elem_type>& gradient) const;
+
+  //! Get the statistics of layer `i` to record a call into.
+  LayerProfile& LayerProfileOf(const size_t i);
+
+  //! Get the number of seconds since the given time.
+  static double SecondsSince(
+      const std::chrono::steady_clock::time_point& start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+        start).count();
+  }
+
   //! The internally-held network.
   std::vector<Layer<MatType>*> network;
 
@@ -251,6 +482,11 @@ class MultiLayer : public Layer<MatType>
   //! context of `Gradient()`!  We have it as a class member to avoid
   //! reallocating the `MatType`s each call to `Gradient()`.
   std::vector<MatType> layerGradients;
+
+  //! Whether the statistics of each layer are recorded.
+  bool profiling;
+  //! The recorded statistics of each layer.
+  std::vector<LayerProfile> profile;
 };
 
 } // namespace mlpack
@@ -24,7 +24,8 @@ MultiLayer<MatType>::MultiLayer() :
     Layer<MatType>(),
     inSize(0),
     totalInputSize(0),
-    totalOutputSize(0)
+    totalOutputSize(0),
+    profiling(false)
 {
   // Nothing to do.
 }
@@ -36,7 +37,9 @@ MultiLayer<MatType>::MultiLayer(const MultiLayer& other) :
     totalInputSize(other.totalInputSize),
     totalOutputSize(other.totalOutputSize),
     layerOutputMatrix(other.layerOutputMatrix),
-    layerDeltaMatrix(other.layerDeltaMatrix)
+    layerDeltaMatrix(other.layerDeltaMatrix),
+    profiling(other.profiling),
+    profile(other.profile)
 {
   // Copy each layer.
   for (size_t i = 0; i < other.network.size(); ++i)
@@ -59,7 +62,9 @@ MultiLayer<MatType>::MultiLayer(MultiLayer&& other) :
     totalInputSize(std::move(other.totalInputSize)),
     totalOutputSize(std::move(other.totalOutputSize)),
     layerOutputMatrix(std::move(other.layerOutputMatrix)),
-    layerDeltaMatrix(std::move(other.layerDeltaMatrix))
+    layerDeltaMatrix(std::move(other.layerDeltaMatrix)),
+    profiling(other.profiling),
+    profile(std::move(other.profile))
 {
   // Ensure that the aliases for layers during passes have the right size.
   layerOutputs.resize(network.size(), MatType());
@@ -93,6 +98,9 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(const MultiLayer& other)
     layerOutputMatrix = other.layerOutputMatrix;
     layerDeltaMatrix = other.layerDeltaMatrix;
 
+    profiling = other.profiling;
+    profile = other.profile;
+
     for (size_t i = 0; i < other.network.size(); ++i)
       network.push_back(other.network[i]->Clone());
 
@@ -122,6 +130,9 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(MultiLayer&& other)
 
     network = std::move(other.network);
 
+    profiling = other.profiling;
+    profile = std::move(other.profile);
+
     layerOutputs.resize(network.size(), MatType());
     layerDeltas.resize(network.size(), MatType());
     layerGradients.resize(network.size(), MatType());
@@ -159,14 +170,14 @@ void MultiLayer<MatType>::Forward(
     // Initialize memory for the forward pass (if needed).
     InitializeForwardPassMemory(input.n_cols);
 
-    network[start]->Forward(input, layerOutputs[start]);
+    LayerForward(start, input, layerOutputs[start]);
     for (size_t i = start + 1; i < end; ++i)
-      network[i]->Forward(layerOutputs[i - 1], layerOutputs[i]);
-    network[end]->Forward(layerOutputs[end - 1], output);
+      LayerForward(i, layerOutputs[i - 1], layerOutputs[i]);
+    LayerForward(end, layerOutputs[end - 1], output);
   }
   else if ((end - start) == 0 && network.size() > 0)
   {
-    network[start]->Forward(input, output);
+    LayerForward(start, input, output);
   }
   else
   {
@@ -187,16 +198,16 @@ void MultiLayer<MatType>::Backward(
     // Initialize memory for the backward pass (if needed).
     InitializeBackwardPassMemory(input.n_cols);
 
-    network.back()->Backward(layerOutputs[network.size() - 2], output, gy,
-        layerDeltas.back());
+    LayerBackward(network.size() - 1, layerOutputs[network.size() - 2],
+        output, gy, layerDeltas.back());
     for (size_t i = network.size() - 2; i > 0; --i)
-      network[i]->Backward(layerOutputs[i - 1], layerOutputs[i],
+      LayerBackward(i, layerOutputs[i - 1], layerOutputs[i],
           layerDeltas[i + 1], layerDeltas[i]);
-    network[0]->Backward(input, layerOutputs[0], layerDeltas[1], g);
+    LayerBackward(0, input, layerOutputs[0], layerDeltas[1], g);
   }
   else if (network.size() == 1)
   {
-    network[0]->Backward(input, output, gy, g);
+    LayerBackward(0, input, output, gy, g);
   }
   else
   {
@@ -217,18 +228,18 @@ void MultiLayer<MatType>::Gradient(
     // Initialize memory for the gradient pass (if needed).
     InitializeGradientPassMemory(gradient);
 
-    network.front()->Gradient(input, layerDeltas[1], layerGradients.front());
+    LayerGradient(0, input, layerDeltas[1], layerGradients.front());
     for (size_t i = 1; i < network.size() - 1; ++i)
     {
-      network[i]->Gradient(layerOutputs[i - 1], layerDeltas[i + 1],
+      LayerGradient(i, layerOutputs[i - 1], layerDeltas[i + 1],
           layerGradients[i]);
     }
-    network.back()->Gradient(layerOutputs[network.size() - 2], error,
+    LayerGradient(network.size() - 1, layerOutputs[network.size() - 2], error,
         layerGradients.back());
   }
   else if (network.size() == 1)
   {
-    network[0]->Gradient(input, error, gradient);
+    LayerGradient(0, input, error, gradient);
   }
   else
   {
@@ -236,6 +247,193 @@ void MultiLayer<MatType>::Gradient(
   }
 }
 
+template<typename MatType>
+template<typename CallbackType>
+void MultiLayer<MatType>::BackwardGradient(
+    const MatType& input,
+    const MatType& output,
+    const MatType& gy,
+    MatType& g,
+    MatType& gradient,
+    CallbackType&& callback)
+{
+  // We assume gradient has the right size already.
+  if (network.size() > 1)
+  {
+    // Initialize memory for the backward and gradient passes (if needed).
+    InitializeBackwardPassMemory(input.n_cols);
+    InitializeGradientPassMemory(gradient);
+
+    const size_t last = network.size() - 1;
+    LayerBackward(last, layerOutputs[last - 1], output, gy, layerDeltas.back());
+    LayerGradient(last, layerOutputs[last - 1], gy, layerGradients.back());
+    callback(layerGradients.back());
+    for (size_t i = last - 1; i > 0; --i)
+    {
+      LayerBackward(i, layerOutputs[i - 1], layerOutputs[i],
+          layerDeltas[i + 1], layerDeltas[i]);
+      LayerGradient(i, layerOutputs[i - 1], layerDeltas[i + 1],
+          layerGradients[i]);
+      callback(layerGradients[i]);
+    }
+    LayerBackward(0, input, layerOutputs[0], layerDeltas[1], g);
+    LayerGradient(0, input, layerDeltas[1], layerGradients.front());
+    callback(layerGradients.front());
+  }
+  else if (network.size() == 1)
+  {
+    LayerBackward(0, input, output, gy, g);
+    LayerGradient(0, input, gy, gradient);
+    callback(gradient);
+  }
+  else
+  {
+    // Empty network?
+    g = gy;
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::SparseGradient(
+    const MatType& input,
+    const MatType& error,
+    arma::SpMat<typename MatType::elem_type>& gradient)
+{
+  // Compute the sparse gradient of each layer, and then stack them.
+  std::vector<arma::SpMat<typename MatType::elem_type>> sparseGradients(
+      network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const MatType& layerInput = (i == 0) ? input : layerOutputs[i - 1];
+    const MatType& layerError = (i == network.size() - 1) ? error :
+        layerDeltas[i + 1];
+    LayerSparseGradient(i, layerInput, layerError, sparseGradients[i]);
+  }
+
+  StackSparseGradients(sparseGradients, gradient);
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::SparseInputForward(
+    const arma::SpMat<typename MatType::elem_type>& input,
+    MatType& output)
+{
+  if (network.size() == 0)
+  {
+    throw std::invalid_argument("MultiLayer::SparseInputForward(): cannot "
+        "use an empty network with sparse input!");
+  }
+
+  // Make sure training/testing mode is set right in each layer.
+  for (size_t i = 0; i < network.size(); ++i)
+    network[i]->Training() = this->training;
+
+  // Initialize memory for the forward pass (if needed).
+  InitializeForwardPassMemory(input.n_cols);
+
+  // Only the first layer sees the sparse input.
+  MatType& firstOutput = (network.size() == 1) ? output : layerOutputs[0];
+  FirstLayerSparseInput([&]()
+  {
+    network[0]->SparseInputForward(input, firstOutput);
+  }, input.n_nonzero, true);
+
+  for (size_t i = 1; i + 1 < network.size(); ++i)
+    LayerForward(i, layerOutputs[i - 1], layerOutputs[i]);
+  if (network.size() > 1)
+  {
+    LayerForward(network.size() - 1, layerOutputs[network.size() - 2],
+        output);
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::SparseInputBackward(
+    const MatType& output,
+    const MatType& gy)
+{
+  if (network.size() > 1)
+  {
+    // Initialize memory for the backward pass (if needed), without the delta
+    // of the input.
+    InitializeBackwardPassMemory(output.n_cols, false);
+
+    LayerBackward(network.size() - 1, layerOutputs[network.size() - 2],
+        output, gy, layerDeltas.back());
+    for (size_t i = network.size() - 2; i > 0; --i)
+      LayerBackward(i, layerOutputs[i - 1], layerOutputs[i],
+          layerDeltas[i + 1], layerDeltas[i]);
+    network[0]->SparseInputBackward(layerOutputs[0], layerDeltas[1]);
+  }
+  else if (network.size() == 1)
+  {
+    network[0]->SparseInputBackward(output, gy);
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::SparseInputGradient(
+    const arma::SpMat<typename MatType::elem_type>& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  // We assume gradient has the right size already.
+  if (network.size() > 1)
+  {
+    // Initialize memory for the gradient pass (if needed).
+    InitializeGradientPassMemory(gradient);
+
+    FirstLayerSparseInput([&]()
+    {
+      network[0]->SparseInputGradient(input, layerDeltas[1],
+          layerGradients.front());
+    }, input.n_nonzero, false);
+    for (size_t i = 1; i < network.size() - 1; ++i)
+    {
+      LayerGradient(i, layerOutputs[i - 1], layerDeltas[i + 1],
+          layerGradients[i]);
+    }
+    LayerGradient(network.size() - 1, layerOutputs[network.size() - 2], error,
+        layerGradients.back());
+  }
+  else if (network.size() == 1)
+  {
+    FirstLayerSparseInput([&]()
+    {
+      network[0]->SparseInputGradient(input, error, gradient);
+    }, input.n_nonzero, false);
+  }
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::SparseInputSparseGradient(
+    const arma::SpMat<typename MatType::elem_type>& input,
+    const MatType& error,
+    arma::SpMat<typename MatType::elem_type>& gradient)
+{
+  std::vector<arma::SpMat<typename MatType::elem_type>> sparseGradients(
+      network.size());
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    const MatType& layerError = (i == network.size() - 1) ? error :
+        layerDeltas[i + 1];
+    if (i > 0)
+    {
+      LayerSparseGradient(i, layerOutputs[i - 1], layerError,
+          sparseGradients[i]);
+      continue;
+    }
+
+    FirstLayerSparseInput([&]()
+    {
+      network[0]->SparseInputSparseGradient(input, layerError,
+          sparseGradients[0]);
+    }, input.n_nonzero, false);
+  }
+
+  StackSparseGradients(sparseGradients, gradient);
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::SetWeights(const MatType& weightsIn)
 {
@@ -347,6 +545,55 @@ double MultiLayer<MatType>::Loss() const
   return loss;
 }
 
+template<typename MatType>
+double MultiLayer<MatType>::ForwardFLOPs()
+{
+  double flops = 0.0;
+  for (size_t i = 0; i < network.size(); ++i)
+    flops += network[i]->ForwardFLOPs();
+
+  return flops;
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::PrintProfile(std::ostream& stream) const
+{
+  // Restore the format of the stream afterwards.
+  const std::ios_base::fmtflags flags = stream.flags();
+  const std::streamsize precision = stream.precision();
+
+  stream << std::setw(6) << "layer" << std::setw(16) << "output" << std::setw(9)
+      << "calls" << std::setw(14) << "forward (ms)" << std::setw(15)
+      << "backward (ms)" << std::setw(15) << "gradient (ms)" << std::setw(10)
+      << "GFLOP" << std::setw(10) << "GFLOP/s" << std::setw(14)
+      << "memory (KiB)" << std::endl;
+
+  for (size_t i = 0; i < profile.size() && i < network.size(); ++i)
+  {
+    const LayerProfile& stats = profile[i];
+
+    // The output dimensions of the layer, like "28x28x16".
+    std::ostringstream dims;
+    const std::vector<size_t>& outputDims = network[i]->OutputDimensions();
+    for (size_t d = 0; d < outputDims.size(); ++d)
+      dims << (d == 0 ? "" : "x") << outputDims[d];
+
+    const double time = stats.forwardTime + stats.backwardTime +
+        stats.gradientTime;
+    stream << std::setw(6) << i << std::setw(16) << dims.str() << std::setw(9)
+        << stats.forwardCalls << std::fixed << std::setprecision(3)
+        << std::setw(14) << 1e3 * stats.forwardTime << std::setw(15)
+        << 1e3 * stats.backwardTime << std::setw(15)
+        << 1e3 * stats.gradientTime << std::setw(10) << 1e-9 * stats.flops
+        << std::setw(10) << (time > 0.0 ? 1e-9 * stats.flops / time : 0.0)
+        << std::setw(14)
+        << (stats.outputBytes + stats.deltaBytes) / 1024.0 << std::endl;
+  }
+
+  stream.flags(flags);
+  stream.precision(precision);
+}
+
 template<typename MatType>
 template<typename Archive>
 void MultiLayer<MatType>::serialize(
@@ -399,16 +646,19 @@ void MultiLayer<MatType>::InitializeForwardPassMemory(const size_t batchSize)
 
 template<typename MatType>
 void MultiLayer<MatType>::InitializeBackwardPassMemory(
-    const size_t batchSize)
+    const size_t batchSize,
+    const bool firstLayerDelta)
 {
   // We need to initialize memory to store the output of each layer's Backward()
   // call.  We do this similarly to InitializeForwardPassMemory(), but we must
   // store a matrix to use as the delta for each layer.
-  if (batchSize * totalInputSize > layerDeltaMatrix.n_elem ||
-      batchSize * totalInputSize < std::floor(0.1 * layerDeltaMatrix.n_elem))
+  const size_t deltaSize = firstLayerDelta ? totalInputSize :
+      totalInputSize - inSize;
+  if (batchSize * deltaSize > layerDeltaMatrix.n_elem ||
+      batchSize * deltaSize < std::floor(0.1 * layerDeltaMatrix.n_elem))
   {
     // All deltas will be represented by one big block of memory.
-    layerDeltaMatrix = MatType(1, batchSize * totalInputSize);
+    layerDeltaMatrix = MatType(1, batchSize * deltaSize);
   }
 
   // Now, create an alias to the right place for each layer.  We assume that
@@ -419,6 +669,8 @@ void MultiLayer<MatType>::InitializeBackwardPassMemory(
     size_t layerInputSize = 1;
     for (size_t j = 0; j < this->network[i]->InputDimensions().size(); ++j)
       layerInputSize *= this->network[i]->InputDimensions()[j];
+    if (i == 0 && !firstLayerDelta)
+      layerInputSize = 0;
 
     MakeAlias(layerDeltas[i], layerDeltaMatrix, layerInputSize,
         batchSize, start * layerDeltaMatrix.n_rows);
@@ -426,6 +678,173 @@ void MultiLayer<MatType>::InitializeBackwardPassMemory(
   }
 }
 
+template<typename MatType>
+void MultiLayer<MatType>::LayerForward(
+    const size_t i, const MatType& input, MatType& output)
+{
+  if (!profiling)
+  {
+    network[i]->Forward(input, output);
+    return;
+  }
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  network[i]->Forward(input, output);
+  LayerProfile& stats = LayerProfileOf(i);
+  stats.forwardTime += SecondsSince(start);
+  ++stats.forwardCalls;
+  stats.flops += network[i]->ForwardFLOPs() * input.n_cols;
+  stats.outputBytes = output.n_elem * sizeof(typename MatType::elem_type);
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::LayerBackward(
+    const size_t i,
+    const MatType& input,
+    const MatType& output,
+    const MatType& gy,
+    MatType& g)
+{
+  if (!profiling)
+  {
+    network[i]->Backward(input, output, gy, g);
+    return;
+  }
+
+  // The backward pass is assumed to take as many operations as the forward
+  // pass.
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  network[i]->Backward(input, output, gy, g);
+  LayerProfile& stats = LayerProfileOf(i);
+  stats.backwardTime += SecondsSince(start);
+  ++stats.backwardCalls;
+  stats.flops += network[i]->ForwardFLOPs() * input.n_cols;
+  stats.deltaBytes = g.n_elem * sizeof(typename MatType::elem_type);
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::LayerGradient(
+    const size_t i,
+    const MatType& input,
+    const MatType& error,
+    MatType& gradient)
+{
+  if (!profiling)
+  {
+    network[i]->Gradient(input, error, gradient);
+    return;
+  }
+
+  // The gradient is assumed to take as many operations as the forward pass,
+  // or none if the layer has no weights.
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  network[i]->Gradient(input, error, gradient);
+  LayerProfile& stats = LayerProfileOf(i);
+  stats.gradientTime += SecondsSince(start);
+  ++stats.gradientCalls;
+  if (network[i]->WeightSize() > 0)
+    stats.flops += network[i]->ForwardFLOPs() * input.n_cols;
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::LayerSparseGradient(
+    const size_t i,
+    const MatType& input,
+    const MatType& error,
+    arma::SpMat<typename MatType::elem_type>& gradient)
+{
+  if (!profiling)
+  {
+    network[i]->SparseGradient(input, error, gradient);
+    return;
+  }
+
+  // This is recorded like a call to Gradient().
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  network[i]->SparseGradient(input, error, gradient);
+  LayerProfile& stats = LayerProfileOf(i);
+  stats.gradientTime += SecondsSince(start);
+  ++stats.gradientCalls;
+  if (network[i]->WeightSize() > 0)
+    stats.flops += network[i]->ForwardFLOPs() * input.n_cols;
+}
+
+template<typename MatType>
+template<typename FunctionType>
+void MultiLayer<MatType>::FirstLayerSparseInput(const FunctionType& function,
+                                                const size_t nonZeros,
+                                                const bool forward)
+{
+  if (!profiling)
+  {
+    function();
+    return;
+  }
+
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  function();
+  LayerProfile& stats = LayerProfileOf(0);
+  if (forward)
+  {
+    stats.forwardTime += SecondsSince(start);
+    ++stats.forwardCalls;
+  }
+  else
+  {
+    stats.gradientTime += SecondsSince(start);
+    ++stats.gradientCalls;
+  }
+
+  // Only the nonzero elements of the input are multiplied with the weights.
+  stats.flops += 2.0 * nonZeros * network[0]->OutputSize();
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::StackSparseGradients(
+    const std::vector<arma::SpMat<typename MatType::elem_type>>& gradients,
+    arma::SpMat<typename MatType::elem_type>& gradient) const
+{
+  typedef typename MatType::elem_type ElemType;
+
+  size_t nonZeros = 0;
+  for (size_t i = 0; i < gradients.size(); ++i)
+    nonZeros += gradients[i].n_nonzero;
+
+  arma::umat locations(2, nonZeros, arma::fill::zeros);
+  arma::Col<ElemType> values(nonZeros);
+  size_t gradientStart = 0, index = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    typename arma::SpMat<ElemType>::const_iterator it = gradients[i].begin();
+    for (; it != gradients[i].end(); ++it, ++index)
+    {
+      locations(0, index) = gradientStart + it.row();
+      values[index] = (*it);
+    }
+
+    gradientStart += network[i]->WeightSize();
+  }
+
+  // The locations are sorted, since each layer's gradient has one column.
+  gradient = arma::SpMat<ElemType>(locations, values, WeightSize(), 1, false,
+      false);
+}
+
+template<typename MatType>
+LayerProfile& MultiLayer<MatType>::LayerProfileOf(const size_t i)
+{
+  // Layers may have been added since the statistics were reset.
+  if (profile.size() != network.size())
+    profile.resize(network.size());
+
+  return profile[i];
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::InitializeGradientPassMemory(MatType& gradient)
 {
@@ -58,6 +58,10 @@ namespace mlpack {
  * [embedDim * (2 * srcSeqLen + tgtSeqLen), batchSize].  The
  * output data will always be of size (embedDim * tgtSeqLen, batchSize)
  *
+ * For long sequences, set `BlockSize()` so that the attention scores are
+ * computed for blocks of keys at a time instead of being stored for all pairs
+ * of target and source positions.
+ *
  * @tparam MatType Type of the input/output data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam RegularizerType Type of the regularizer to be used.
@@ -190,6 +194,20 @@ class MultiheadAttentionType : public Layer<MatType>
   //! all come from the same input).
   bool& SelfAttention() { return selfAttention; }
 
+  /**
+   * Get the number of keys whose attention scores are computed at once.  If
+   * this is 0 (the default), the scores of all keys are computed and stored
+   * for the backward pass, which takes memory proportional to
+   * `tgtSeqLen * srcSeqLen` for each head and point.  Otherwise, the keys are
+   * processed in blocks of `BlockSize()`, and the scores of each block are
+   * recomputed in the backward pass; this takes memory proportional to
+   * `tgtSeqLen * BlockSize()`, at the cost of computing the scores twice.  The
+   * results are the same either way.  This setting is not serialized.
+   */
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of keys whose attention scores are computed at once.
+  size_t& BlockSize() { return blockSize; }
+
   void ComputeOutputDimensions() override
   {
     if (this->inputDimensions.size() < 2)
@@ -267,6 +285,27 @@ class MultiheadAttentionType : public Layer<MatType>
   //! Element Type of the output.
   using ElemType = typename MatType::elem_type;
 
+  /**
+   * Compute the attention probabilities of the keys `firstKey` to `lastKey`
+   * (inclusive) for slice `slice` of the projected query and key (that is, for
+   * one head of one point), with the masks applied.
+   */
+  void BlockScores(const size_t slice,
+                   const size_t firstKey,
+                   const size_t lastKey,
+                   MatType& blockScores);
+
+  /**
+   * Backpropagate the error of the attention output `gyTemp` (of shape
+   * (tgtSeqLen, headDim, numHeads * batchSize)) to the projected value, key,
+   * and query, using either the stored scores or the blocks of scores,
+   * depending on `blockSize`.
+   */
+  void AttentionBackward(const arma::Cube<ElemType>& gyTemp,
+                         arma::Cube<ElemType>& dv,
+                         arma::Cube<ElemType>& dk,
+                         arma::Cube<ElemType>& dq);
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -293,6 +332,9 @@ class MultiheadAttentionType : public Layer<MatType>
   //! come from the same input).
   bool selfAttention;
 
+  //! Number of keys whose scores are computed at once (0 for all keys).
+  size_t blockSize;
+
   //! Locally-stored weight matrix associated with query.
   MatType queryWt;
 
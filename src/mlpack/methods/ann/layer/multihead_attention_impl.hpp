@@ -29,7 +29,8 @@ MultiheadAttentionType() :
     embedDim(0),
     numHeads(0),
     headDim(0),
-    selfAttention(false)
+    selfAttention(false),
+    blockSize(0)
 {
   // Nothing to do here.
 }
@@ -48,7 +49,8 @@ MultiheadAttentionType(
     numHeads(numHeads),
     attnMask(attnmask),
     keyPaddingMask(keypaddingmask),
-    selfAttention(selfAttention)
+    selfAttention(selfAttention),
+    blockSize(0)
 {
 }
 
@@ -132,41 +134,69 @@ Forward(const MatType& input, MatType& output)
   kProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
   vProj.reshape(srcSeqLen, headDim, numHeads * batchSize);
 
-  // Calculate the scores i.e. perform the matrix multiplication operation
-  // on qProj and kProj. Here score = qProj . kProj'
-  scores = MultiplyCube2Cube(qProj, kProj, false, true);
-
-  // Apply the attention mask if provided. The attention mask is used to black-
-  // out future sequences and generally used in Encoder-Decoder attention.
-  // The attention mask has elements -inf or 0.
-  // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
-  if (!attnMask.is_empty())
+  // Check the sizes of the masks, if they are given.
+  if (!attnMask.is_empty() &&
+      (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen))
   {
-    if (attnMask.n_rows != tgtSeqLen || attnMask.n_cols != srcSeqLen)
-      Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
-    scores.each_slice() += attnMask;
+    Log::Fatal << "The size of the 'attn_mask' is not correct.\n";
   }
 
-  // Apply the key padding mask when provided. It blacks-out any particular
-  // word in the sequence.
-  // The key padding mask has elements -inf or 0
-  // The shape of keyPaddingMask : (1, srcSeqLen).
-  if (!keyPaddingMask.is_empty())
+  if (!keyPaddingMask.is_empty() &&
+      (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen))
   {
-    if (keyPaddingMask.n_rows != 1 || keyPaddingMask.n_cols != srcSeqLen)
-        Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
-    scores.each_slice() += repmat(keyPaddingMask, tgtSeqLen, 1);
+    Log::Fatal << "The size of the 'keyPaddingMask' is not correct.\n";
   }
 
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
+  if (blockSize == 0)
   {
-    softmax.Forward(scores.slice(i), scores.slice(i));
-  }
+    // Calculate the scores i.e. perform the matrix multiplication operation
+    // on qProj and kProj. Here score = qProj . kProj'
+    scores = MultiplyCube2Cube(qProj, kProj, false, true);
+
+    // Apply the attention mask if provided. The attention mask is used to
+    // black-out future sequences and generally used in Encoder-Decoder
+    // attention.  The attention mask has elements -inf or 0.
+    // The shape of the attention mask : (tgtSeqLen, srcSeqLen).
+    if (!attnMask.is_empty())
+      scores.each_slice() += attnMask;
+
+    // Apply the key padding mask when provided. It blacks-out any particular
+    // word in the sequence.
+    // The key padding mask has elements -inf or 0
+    // The shape of keyPaddingMask : (1, srcSeqLen).
+    if (!keyPaddingMask.is_empty())
+      scores.each_slice() += repmat(keyPaddingMask, tgtSeqLen, 1);
+
+    for (size_t i = 0; i < numHeads * batchSize; ++i)
+    {
+      softmax.Forward(scores.slice(i), scores.slice(i));
+    }
 
-  // Calculate the attention output i.e. matrix multiplication of softmax
-  // output and vProj.
-  // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
-  attnOut = MultiplyCube2Cube(scores, vProj, false, false);
+    // Calculate the attention output i.e. matrix multiplication of softmax
+    // output and vProj.
+    // The shape of attnOutput : (tgtSeqLen, headDim, numHeads * batchSize).
+    attnOut = MultiplyCube2Cube(scores, vProj, false, false);
+  }
+  else
+  {
+    // The softmax normalizes the scores of each key separately, so the keys
+    // can be processed in blocks of `blockSize`, and only the scores of one
+    // block are stored at a time.  The scores are recomputed in the backward
+    // pass.
+    scores.reset();
+    attnOut.zeros(tgtSeqLen, headDim, numHeads * batchSize);
+
+    MatType blockScores;
+    for (size_t i = 0; i < numHeads * batchSize; ++i)
+    {
+      for (size_t j = 0; j < srcSeqLen; j += blockSize)
+      {
+        const size_t lastKey = std::min(j + blockSize, srcSeqLen) - 1;
+        BlockScores(i, j, lastKey, blockScores);
+        attnOut.slice(i) += blockScores * vProj.slice(i).rows(j, lastKey);
+      }
+    }
+  }
 
   // Now we will concatenate output of all the heads i.e. we will reshape
   // attnOut to (tgtSeqLen, embedDim, batchSize).
@@ -215,49 +245,31 @@ Backward(const MatType& /* input */,
   // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
   gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
 
-  // Obtain backpropagted error of value.
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  CubeType tmp = MultiplyCube2Cube(scores, gyTemp, true, false);
+  // Obtain the backpropagated errors of the projected value, key, and query.
+  // The shape of dv and dk : (srcSeqLen, headDim, numHeads * batchSize).
+  // The shape of dq : (tgtSeqLen, headDim, numHeads * batchSize).
+  CubeType dv, dk, dq;
+  AttentionBackward(gyTemp, dv, dk, dq);
 
   // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
+  dv.reshape(srcSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
     if (selfAttention)
     {
       g.submat(0, i, g.n_rows - 1, i) =
-          vectorise(trans(tmp.slice(i) * valueWt));
+          vectorise(trans(dv.slice(i) * valueWt));
     }
     else
     {
       g.submat((tgtSeqLen + srcSeqLen) * embedDim, i, g.n_rows - 1, i) =
-          vectorise(trans(tmp.slice(i) * valueWt));
+          vectorise(trans(dv.slice(i) * valueWt));
     }
   }
 
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // So the new shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  gyTemp = MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // We will perform backpropagation of softmax over each slice of gyTemp.
-    softmax.Backward({} /* unused */, scores.slice(i), gyTemp.slice(i),
-        gyTemp.slice(i));
-  }
-
-  // Obtain backpropagated error of key.
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (srcSeqLen, headDim, numHeads * batchSize).
-  tmp = MultiplyCube2Cube(gyTemp, qProj, true, false);
-
   // Concatenate results of all the attention heads.
-  tmp.reshape(srcSeqLen, embedDim, batchSize);
+  dk.reshape(srcSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
@@ -265,24 +277,18 @@ Backward(const MatType& /* input */,
     {
       // Sum the query, key, and value deltas.
       g.submat(0, i, g.n_rows - 1, i) +=
-          vectorise(trans(tmp.slice(i) * keyWt));
+          vectorise(trans(dk.slice(i) * keyWt));
     }
     else
     {
       g.submat(tgtSeqLen * embedDim, i,
                (tgtSeqLen + srcSeqLen) * embedDim - 1, i) =
-          vectorise(trans(tmp.slice(i) * keyWt));
+          vectorise(trans(dk.slice(i) * keyWt));
     }
   }
 
-  // Obtain backpropagated error of the query.
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of tmp : (tgtSeqLen, headDim, numHeads * batchSize).
-  tmp = MultiplyCube2Cube(gyTemp, kProj) / std::sqrt(headDim);
-
   // Concatenate results of all the attention heads.
-  tmp.reshape(tgtSeqLen, embedDim, batchSize);
+  dq.reshape(tgtSeqLen, embedDim, batchSize);
 
   for (size_t i = 0; i < batchSize; ++i)
   {
@@ -290,12 +296,12 @@ Backward(const MatType& /* input */,
     {
       // Sum the query, key, and value deltas.
       g.submat(0, i, g.n_rows - 1, i) +=
-          vectorise(trans(tmp.slice(i) * queryWt));
+          vectorise(trans(dq.slice(i) * queryWt));
     }
     else
     {
       g.submat(0, i, tgtSeqLen * embedDim - 1, i) =
-          vectorise(trans(tmp.slice(i) * queryWt));
+          vectorise(trans(dq.slice(i) * queryWt));
     }
   }
 }
@@ -369,84 +375,60 @@ Gradient(const MatType& input,
   // (tgtSeqLen, headDim, numHeads * batchSize).
   gyTemp.reshape(tgtSeqLen, headDim, numHeads * batchSize);
 
-  // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The new shape of errorTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  errorTemp = MultiplyCube2Cube(scores, gyTemp, true, false);
+  // Obtain the backpropagated errors of the projected value, key, and query.
+  // The shape of dv and dk : (srcSeqLen, headDim, numHeads * batchSize).
+  // The shape of dq : (tgtSeqLen, headDim, numHeads * batchSize).
+  CubeType dv, dk, dq;
+  AttentionBackward(gyTemp, dv, dk, dq);
 
   // Now we will concatenate the propagated errors from all heads i.e. we
-  // will reshape errorTemp to (srcSeqLen, embedDim, batchSize).
-  errorTemp.reshape(srcSeqLen, embedDim, batchSize);
+  // will reshape dv to (srcSeqLen, embedDim, batchSize).
+  dv.reshape(srcSeqLen, embedDim, batchSize);
 
-  // Gradient wrt. vBias, i.e. dL/d(vBias). We will take summation of errorTemp
-  // over all the batches and over all the sequences.
+  // Gradient wrt. vBias, i.e. dL/d(vBias). We will take summation of dv over
+  // all the batches and over all the sequences.
   gradient.rows(4 * wtSize + 2 * embedDim, 4 * wtSize + 3 * embedDim - 1)
-      = vectorise(sum(sum(errorTemp, 2), 0));
+      = vectorise(sum(sum(dv, 2), 0));
 
-  // Shape of v : (srcSeqLen, embedDim, batchSize).
-  // Shape of errorTemp : (srcSeqLen, embedDim, bathSize).
-  // The new shape of errorTemp : (embedDim, embedDim, batchSize).
-  errorTemp = MultiplyCube2Cube(errorTemp, v, true, true);
+  // Shape of v : (embedDim, srcSeqLen, batchSize).
+  // Shape of dv : (srcSeqLen, embedDim, bathSize).
+  // The shape of errorTemp : (embedDim, embedDim, batchSize).
+  errorTemp = MultiplyCube2Cube(dv, v, true, true);
 
   // Gradient wrt. valueWt, i.e. dL/d(valueWt). We will take summation over all
   // batches of errorTemp.
   gradient.rows(2 * wtSize, 3 * wtSize - 1) = vectorise(sum(errorTemp, 2));
 
-  // Now, the shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The new shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  errorTemp = MultiplyCube2Cube(gyTemp, vProj, false, true);
-
-  for (size_t i = 0; i < numHeads * batchSize; ++i)
-  {
-    // The shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-    // The new shape of errorTemp remain same.
-    softmax.Backward({} /* unused */, scores.slice(i), errorTemp.slice(i),
-        errorTemp.slice(i));
-  }
-
-  // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (srcSeqLen, headDim, numHeads * batchSize).
-  gyTemp = MultiplyCube2Cube(errorTemp, qProj, true, false);
-
   // We will now conctenate the propagated errors from all heads.
-  // The new shape of gyTemp : (srcSeqLen, embedDim, batchSize).
-  gyTemp.reshape(srcSeqLen, embedDim, batchSize);
+  // The new shape of dk : (srcSeqLen, embedDim, batchSize).
+  dk.reshape(srcSeqLen, embedDim, batchSize);
 
   // Gradient wrt. kBias, i.e. dL/d(kBias). We will take summation over all the
-  // batches of gyTemp and then over all the sequences.
+  // batches of dk and then over all the sequences.
   gradient.rows(4 * wtSize + embedDim, 4 * wtSize + 2 * embedDim - 1)
-      = vectorise(sum(sum(gyTemp, 2), 0));
+      = vectorise(sum(sum(dk, 2), 0));
 
   // The shape of k : (embedDim, srcSeqLen, batchSize).
-  // The shape of gyTemp : (srcSeqLen, embedDim, batchSize).
+  // The shape of dk : (srcSeqLen, embedDim, batchSize).
   // The shape of dkeyWt : (embedDim, embedDim, batchSize).
-  gyTemp = MultiplyCube2Cube(gyTemp, k, true, true);
+  gyTemp = MultiplyCube2Cube(dk, k, true, true);
 
   // Gradient wrt. keyWt, i.e. dL/d(keyWt). We will take summation over all the
   // batches of dkeyWt.
   gradient.rows(wtSize, 2 * wtSize - 1) = vectorise(sum(gyTemp, 2));
 
-  // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
-  // The shape of errorTemp : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
-  // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
-  gyTemp = MultiplyCube2Cube(errorTemp, kProj, false, false);
-
   // Now, we will concatenate propagated error of all heads.
-  gyTemp.reshape(tgtSeqLen, embedDim, batchSize);
-  gyTemp /= std::sqrt(headDim);
+  dq.reshape(tgtSeqLen, embedDim, batchSize);
 
   // Gradient wrt. qBias, i.e. dL/d(qBias). We will take summation over all the
-  // batches of gyTemp and over all the sequences.
+  // batches of dq and over all the sequences.
   gradient.rows(4 * wtSize, 4 * wtSize + embedDim - 1)
-      = vectorise(sum(sum(gyTemp, 2), 0));
+      = vectorise(sum(sum(dq, 2), 0));
 
-  // The shape of gyTemp : (tgtSeqLen, embedDim, batchSize).
+  // The shape of dq : (tgtSeqLen, embedDim, batchSize).
   // The shape of q : (embedDim, tgtSeqLen, batchSize).
   // The shape of gyTemp : (embedDim, embedDim, batchSize).
-  gyTemp = MultiplyCube2Cube(gyTemp, q, true, true);
+  gyTemp = MultiplyCube2Cube(dq, q, true, true);
 
   // Gradient wrt. queryWt, i.e. dL/d(queryBias). We will take summation over
   // all the batches of gyTemp.
@@ -456,6 +438,99 @@ Gradient(const MatType& input,
   regularizer.Evaluate(weights, gradient);
 }
 
+template <typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::
+BlockScores(const size_t slice,
+            const size_t firstKey,
+            const size_t lastKey,
+            MatType& blockScores)
+{
+  // The shape of blockScores : (tgtSeqLen, lastKey - firstKey + 1).
+  blockScores = qProj.slice(slice) *
+      trans(kProj.slice(slice).rows(firstKey, lastKey));
+
+  if (!attnMask.is_empty())
+    blockScores += attnMask.cols(firstKey, lastKey);
+
+  if (!keyPaddingMask.is_empty())
+  {
+    blockScores += repmat(keyPaddingMask.cols(firstKey, lastKey), tgtSeqLen,
+        1);
+  }
+
+  softmax.Forward(blockScores, blockScores);
+}
+
+template <typename MatType, typename RegularizerType>
+void MultiheadAttentionType<MatType, RegularizerType>::
+AttentionBackward(const arma::Cube<ElemType>& gyTemp,
+                  arma::Cube<ElemType>& dv,
+                  arma::Cube<ElemType>& dk,
+                  arma::Cube<ElemType>& dq)
+{
+  using CubeType = arma::Cube<ElemType>;
+
+  if (blockSize == 0)
+  {
+    // Obtain backpropagted error of value.
+    // Shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
+    // Shape of scores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+    // The shape of dv : (srcSeqLen, headDim, numHeads * batchSize).
+    dv = MultiplyCube2Cube(scores, gyTemp, true, false);
+
+    // The shape of gyTemp : (tgtSeqLen, headDim, numHeads * batchSize).
+    // The shape of vProj : (srcSeqLen, headDim, numHeads * batchSize).
+    // The shape of dScores : (tgtSeqLen, srcSeqLen, numHeads * batchSize).
+    CubeType dScores = MultiplyCube2Cube(gyTemp, vProj, false, true);
+
+    for (size_t i = 0; i < dScores.n_slices; ++i)
+    {
+      // We will perform backpropagation of softmax over each slice.
+      softmax.Backward({} /* unused */, scores.slice(i), dScores.slice(i),
+          dScores.slice(i));
+    }
+
+    // Obtain backpropagated error of key.
+    // The shape of qProj : (tgtSeqLen, headDim, numHeads * batchSize).
+    // The shape of dk : (srcSeqLen, headDim, numHeads * batchSize).
+    dk = MultiplyCube2Cube(dScores, qProj, true, false);
+
+    // Obtain backpropagated error of the query.
+    // The shape of kProj : (srcSeqLen, headDim, numHeads * batchSize).
+    // The shape of dq : (tgtSeqLen, headDim, numHeads * batchSize).
+    dq = MultiplyCube2Cube(dScores, kProj, false, false) / std::sqrt(headDim);
+  }
+  else
+  {
+    // Recompute the scores of each block of keys, and backpropagate through
+    // it; the errors of the keys and values of a block only depend on that
+    // block, and the error of the query is the sum over all blocks.
+    dv.set_size(srcSeqLen, headDim, gyTemp.n_slices);
+    dk.set_size(srcSeqLen, headDim, gyTemp.n_slices);
+    dq.zeros(tgtSeqLen, headDim, gyTemp.n_slices);
+
+    MatType blockScores, dScores;
+    for (size_t i = 0; i < gyTemp.n_slices; ++i)
+    {
+      for (size_t j = 0; j < srcSeqLen; j += blockSize)
+      {
+        const size_t lastKey = std::min(j + blockSize, srcSeqLen) - 1;
+        BlockScores(i, j, lastKey, blockScores);
+
+        dv.slice(i).rows(j, lastKey) = trans(blockScores) * gyTemp.slice(i);
+
+        dScores = gyTemp.slice(i) * trans(vProj.slice(i).rows(j, lastKey));
+        softmax.Backward({} /* unused */, blockScores, dScores, dScores);
+
+        dk.slice(i).rows(j, lastKey) = trans(dScores) * qProj.slice(i);
+        dq.slice(i) += dScores * kProj.slice(i).rows(j, lastKey);
+      }
+    }
+
+    dq /= std::sqrt(headDim);
+  }
+}
+
 template <typename MatType, typename RegularizerType>
 template <typename Archive>
 void MultiheadAttentionType<MatType, RegularizerType>::
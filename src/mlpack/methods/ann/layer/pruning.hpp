@@ -0,0 +1,74 @@
+/**
+ * @file methods/ann/layer/pruning.hpp
+ *
+ * Magnitude pruning of the weights of a layer, element by element or by square
+ * blocks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_PRUNING_HPP
+#define MLPACK_METHODS_ANN_LAYER_PRUNING_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Set the given fraction of the weights with the smallest magnitudes to zero.
+ * With a block size larger than 1, the weights are split into square blocks of
+ * that size (the blocks of the last rows and columns may be smaller), and the
+ * given fraction of the blocks with the smallest root mean square weight are
+ * set to zero as a whole.
+ *
+ * @param weight Weights to prune.
+ * @param sparsity Fraction of the weights (or blocks) to set to zero, in
+ *     [0, 1].
+ * @param blockSize Size of the blocks to prune (1 prunes single weights).
+ */
+template<typename MatType>
+void PruneWeights(MatType& weight,
+                  const double sparsity,
+                  const size_t blockSize = 1)
+{
+  if (sparsity < 0.0 || sparsity > 1.0)
+  {
+    throw std::invalid_argument("PruneWeights(): sparsity must be in [0, 1]!");
+  }
+
+  if (blockSize == 0)
+    throw std::invalid_argument("PruneWeights(): block size must be positive!");
+
+  const size_t blockRows = (weight.n_rows + blockSize - 1) / blockSize;
+  const size_t blockCols = (weight.n_cols + blockSize - 1) / blockSize;
+  arma::vec norms(blockRows * blockCols);
+  for (size_t j = 0; j < blockCols; ++j)
+  {
+    for (size_t i = 0; i < blockRows; ++i)
+    {
+      const size_t lastRow = std::min((i + 1) * blockSize, weight.n_rows) - 1;
+      const size_t lastCol = std::min((j + 1) * blockSize, weight.n_cols) - 1;
+      const auto block = weight.submat(i * blockSize, j * blockSize, lastRow,
+          lastCol);
+      norms[i + j * blockRows] = std::sqrt(arma::accu(arma::square(block)) /
+          block.n_elem);
+    }
+  }
+
+  const size_t pruned = (size_t) std::floor(sparsity * norms.n_elem);
+  const arma::uvec order = arma::sort_index(norms);
+  for (size_t b = 0; b < pruned; ++b)
+  {
+    const size_t i = order[b] % blockRows;
+    const size_t j = order[b] / blockRows;
+    const size_t lastRow = std::min((i + 1) * blockSize, weight.n_rows) - 1;
+    const size_t lastCol = std::min((j + 1) * blockSize, weight.n_cols) - 1;
+    weight.submat(i * blockSize, j * blockSize, lastRow, lastCol).zeros();
+  }
+}
+
+} // namespace mlpack
+
+#endif
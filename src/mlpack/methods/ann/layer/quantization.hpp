@@ -0,0 +1,94 @@
+/**
+ * @file methods/ann/layer/quantization.hpp
+ *
+ * Utility functions for the int8 quantized layers: symmetric quantization of
+ * weights (with one scale per output) and of inputs (with one scale for the
+ * layer), and integer dot products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Return the scale that maps values in [-maxAbs, maxAbs] to [-127, 127].  If
+ * all the values are zero, the scale is 1.
+ */
+inline double QuantizationScale(const double maxAbs)
+{
+  return (maxAbs > 0.0) ? maxAbs / 127.0 : 1.0;
+}
+
+/**
+ * Quantize the given value with the given scale, rounding to the nearest
+ * integer; values outside of the range of the scale are clamped.
+ */
+inline int8_t QuantizeValue(const double value, const double scale)
+{
+  const double q = std::round(value / scale);
+  return (int8_t) std::min(127.0, std::max(-127.0, q));
+}
+
+/**
+ * Quantize the given values with the given scale.  The quantized values must
+ * already have room for `n` values.
+ */
+template<typename eT>
+inline void Quantize(const eT* values,
+                     const size_t n,
+                     const double scale,
+                     int8_t* quantized)
+{
+  for (size_t i = 0; i < n; ++i)
+    quantized[i] = QuantizeValue(values[i], scale);
+}
+
+/**
+ * Quantize each column of the given weights with its own scale (so, for
+ * layers, one scale per output unit or output map).
+ *
+ * @param weights Weights to quantize; each column holds the weights of one
+ *     output.
+ * @param quantized Matrix to store the quantized weights in.
+ * @param scales Column vector to store the scale of each column in.
+ */
+template<typename MatType>
+void QuantizeColumns(const MatType& weights,
+                     arma::Mat<int8_t>& quantized,
+                     MatType& scales)
+{
+  quantized.set_size(weights.n_rows, weights.n_cols);
+  scales.set_size(weights.n_cols, 1);
+  for (size_t i = 0; i < weights.n_cols; ++i)
+  {
+    scales[i] = QuantizationScale(arma::max(arma::abs(weights.col(i))));
+    Quantize(weights.colptr(i), weights.n_rows, scales[i],
+        quantized.colptr(i));
+  }
+}
+
+/**
+ * Compute the dot product of two vectors of int8 values, accumulating in 32
+ * bits.  The loop has no dependencies between iterations other than the sum,
+ * so the compiler vectorizes it to integer multiply-adds (VNNI instructions
+ * with AVX-512, when they are enabled).
+ */
+inline int32_t QuantizedDot(const int8_t* a, const int8_t* b, const size_t n)
+{
+  int32_t result = 0;
+  for (size_t i = 0; i < n; ++i)
+    result += int32_t(a[i]) * int32_t(b[i]);
+
+  return result;
+}
+
+} // namespace mlpack
+
+#endif
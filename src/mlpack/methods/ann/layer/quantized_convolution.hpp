@@ -0,0 +1,193 @@
+/**
+ * @file methods/ann/layer/quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer, an int8 version of the
+ * Convolution layer for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+#include "layer.hpp"
+#include "quantization.hpp"
+
+namespace mlpack {
+
+/**
+ * The QuantizedConvolution layer computes the same convolution as the
+ * Convolution layer, but with the filters stored as int8 values, with one
+ * scale for each output map.  The input is quantized to int8 values with one
+ * scale for the layer (found by calibration, see FFN::Quantize()), the
+ * patches of each point are unrolled (see Im2ColConvolution) and multiplied
+ * with the filters with integer dot products, and the result is scaled back to
+ * floating point.
+ *
+ * The layer has no trainable weights and can only be used for inference; it
+ * is usually created by FFN::Quantize() from a trained Convolution layer.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedConvolutionType : public Layer<MatType>
+{
+ public:
+  //! Convenience typedef for the cube type of the filters.
+  using CubeType = typename GetCubeType<MatType>::type;
+
+  //! Create an empty QuantizedConvolution object.
+  QuantizedConvolutionType();
+
+  /**
+   * Create the QuantizedConvolution object from the filters of a Convolution
+   * layer.
+   *
+   * @param weight Filters of the layer, as returned by
+   *     Convolution::Weight(): slice `o * inMaps + i` holds the filter of
+   *     output map `o` for input map `i`.
+   * @param bias Bias of each output map, or an empty matrix for no bias.
+   * @param maps Number of output maps.
+   * @param strideWidth Stride of filter application in the x direction.
+   * @param strideHeight Stride of filter application in the y direction.
+   * @param padWLeft Left padding width of the input.
+   * @param padWRight Right padding width of the input.
+   * @param padHTop Top padding height of the input.
+   * @param padHBottom Bottom padding height of the input.
+   * @param inputScale Scale to quantize the input with; the largest absolute
+   *     value of the input that is represented is 127 * inputScale.
+   */
+  QuantizedConvolutionType(const CubeType& weight,
+                           const MatType& bias,
+                           const size_t maps,
+                           const size_t strideWidth,
+                           const size_t strideHeight,
+                           const size_t padWLeft,
+                           const size_t padWRight,
+                           const size_t padHTop,
+                           const size_t padHBottom,
+                           const double inputScale);
+
+  //! Clone the QuantizedConvolutionType object. This handles polymorphism
+  //! correctly.
+  QuantizedConvolutionType* Clone() const
+  {
+    return new QuantizedConvolutionType(*this);
+  }
+
+  //! Virtual destructor.
+  virtual ~QuantizedConvolutionType() { }
+
+  /**
+   * Ordinary feed forward pass: quantize the input and compute the convolution
+   * with integer dot products.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The layer can't be trained, so this throws std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the quantized filters (one column for each output map).
+  const arma::Mat<int8_t>& Filters() const { return filters; }
+
+  //! Get the scale of the filters of each output map.
+  const MatType& WeightScales() const { return weightScales; }
+
+  //! Get the bias of the layer (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Get the number of output maps.
+  size_t Maps() const { return maps; }
+
+  //! Get the kernel width.
+  size_t KernelWidth() const { return kernelWidth; }
+
+  //! Get the kernel height.
+  size_t KernelHeight() const { return kernelHeight; }
+
+  //! Get the scale the input is quantized with.
+  double InputScale() const { return inputScale; }
+  //! Modify the scale the input is quantized with.
+  double& InputScale() { return inputScale; }
+
+  //! Compute the output dimensions of the layer using `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of output maps.
+  size_t maps;
+
+  //! Locally-stored number of input maps.
+  size_t inMaps;
+
+  //! Locally-stored filter width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! Locally-stored quantized filters; column `o` holds the filters of output
+  //! map `o` for all the input maps, in the order of the rows of the unrolled
+  //! patches.
+  arma::Mat<int8_t> filters;
+
+  //! Locally-stored scale of the filters of each output map.
+  MatType weightScales;
+
+  //! Locally-stored bias (empty if there is no bias).
+  MatType bias;
+
+  //! Locally-stored scale of the input.
+  double inputScale;
+
+  //! Number of dimensions higher than the third, which are treated as
+  //! different points.
+  size_t higherInDimensions;
+}; // class QuantizedConvolutionType
+
+// Standard QuantizedConvolution layer.
+using QuantizedConvolution = QuantizedConvolutionType<arma::mat>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
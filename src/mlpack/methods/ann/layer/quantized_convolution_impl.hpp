@@ -0,0 +1,198 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer, an int8 version of the
+ * Convolution layer for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType() :
+    Layer<MatType>(),
+    maps(0),
+    inMaps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHBottom(0),
+    padHTop(0),
+    inputScale(1.0),
+    higherInDimensions(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType(
+    const CubeType& weight,
+    const MatType& biasIn,
+    const size_t maps,
+    const size_t strideWidth,
+    const size_t strideHeight,
+    const size_t padWLeft,
+    const size_t padWRight,
+    const size_t padHTop,
+    const size_t padHBottom,
+    const double inputScale) :
+    Layer<MatType>(),
+    maps(maps),
+    inMaps(weight.n_slices / maps),
+    kernelWidth(weight.n_rows),
+    kernelHeight(weight.n_cols),
+    strideWidth(strideWidth),
+    strideHeight(strideHeight),
+    padWLeft(padWLeft),
+    padWRight(padWRight),
+    padHBottom(padHBottom),
+    padHTop(padHTop),
+    bias(biasIn),
+    inputScale(inputScale),
+    higherInDimensions(1)
+{
+  // The filters of each output map are contiguous in the cube, and already in
+  // the order of the rows of the unrolled patches.
+  const MatType flatFilters(weight.memptr(), weight.n_elem / maps, maps);
+  QuantizeColumns(flatFilters, filters, weightScales);
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const size_t inputRows = this->inputDimensions[0];
+  const size_t inputCols = this->inputDimensions[1];
+  const size_t paddedRows = inputRows + padWLeft + padWRight;
+  const size_t paddedCols = inputCols + padHTop + padHBottom;
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  const size_t outputSize = outputRows * outputCols;
+
+  // The dimensions higher than the third are treated as different input
+  // points, like in the Convolution layer.
+  #pragma omp parallel
+  {
+    arma::Mat<int8_t> paddedInput(paddedRows * paddedCols, inMaps);
+    arma::Mat<int8_t> columns;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t offset = 0; offset < (higherInDimensions * input.n_cols);
+        ++offset)
+    {
+      // Quantize the input of this point into the padded maps.
+      paddedInput.zeros();
+      const ElemType* pointInput = input.memptr() +
+          offset * inMaps * inputRows * inputCols;
+      for (size_t m = 0; m < inMaps; ++m)
+      {
+        for (size_t j = 0; j < inputCols; ++j)
+        {
+          Quantize(pointInput + (m * inputCols + j) * inputRows, inputRows,
+              inputScale, paddedInput.colptr(m) + (j + padHTop) * paddedRows +
+              padWLeft);
+        }
+      }
+
+      Im2ColConvolution<>::Im2Col(paddedInput.memptr(), paddedRows,
+          paddedCols, inMaps, kernelWidth, kernelHeight, strideWidth,
+          strideHeight, 1, 1, outputRows, outputCols, columns);
+
+      ElemType* pointOutput = output.memptr() + offset * maps * outputSize;
+      for (size_t o = 0; o < maps; ++o)
+      {
+        const ElemType outputScale = inputScale * weightScales[o];
+        const ElemType outputBias = bias.is_empty() ? 0 : bias[o];
+        for (size_t i = 0; i < outputSize; ++i)
+        {
+          pointOutput[o * outputSize + i] = QuantizedDot(filters.colptr(o),
+              columns.colptr(i), columns.n_rows) * outputScale + outputBias;
+        }
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("QuantizedConvolution::Backward(): quantized layers "
+      "can only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::ComputeOutputDimensions()
+{
+  const size_t inputMaps = (this->inputDimensions.size() >= 3) ?
+      this->inputDimensions[2] : 1;
+  if (inputMaps != inMaps)
+  {
+    Log::Fatal << "QuantizedConvolution::ComputeOutputDimensions(): number of "
+        << "input maps (" << inputMaps << ") does not match the quantized "
+        << "filters (" << inMaps << ")!" << std::endl;
+  }
+
+  // We must ensure that the output has at least 3 dimensions, since we will
+  // be adding some number of maps to the output.
+  this->outputDimensions = std::vector<size_t>(
+      std::max(this->inputDimensions.size(), size_t(3)), 1);
+  this->outputDimensions[0] = (this->inputDimensions[0] + padWLeft +
+      padWRight - kernelWidth) / strideWidth + 1;
+  this->outputDimensions[1] = (this->inputDimensions[1] + padHTop +
+      padHBottom - kernelHeight) / strideHeight + 1;
+
+  higherInDimensions = 1;
+  for (size_t i = 3; i < this->inputDimensions.size(); ++i)
+  {
+    higherInDimensions *= this->inputDimensions[i];
+    this->outputDimensions[i] = this->inputDimensions[i];
+  }
+
+  this->outputDimensions[2] = maps;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedConvolutionType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(maps));
+  ar(CEREAL_NVP(inMaps));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(filters));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+  ar(CEREAL_NVP(higherInDimensions));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer, an int8 version of the Linear and
+ * LinearNoBias layers for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+#include "quantization.hpp"
+
+namespace mlpack {
+
+/**
+ * The QuantizedLinear layer computes y = Ax + b (or y = Ax, without a bias)
+ * like the Linear and LinearNoBias layers, but with the weights stored as int8
+ * values, with one scale for each output unit.  The input is quantized to int8
+ * values with one scale for the layer (found by calibration, see
+ * FFN::Quantize()), the dot products are computed with integers, and the
+ * result is scaled back to floating point.  This takes 8 times less memory
+ * than weights stored as doubles.
+ *
+ * The layer has no trainable weights and can only be used for inference;
+ * it is usually created by FFN::Quantize() from a trained Linear or
+ * LinearNoBias layer.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedLinearType : public Layer<MatType>
+{
+ public:
+  //! Create an empty QuantizedLinear object.
+  QuantizedLinearType();
+
+  /**
+   * Create the QuantizedLinear object from the weights of a Linear or
+   * LinearNoBias layer.
+   *
+   * @param weight Weights of the layer, with one row for each output unit.
+   * @param bias Bias of the layer, or an empty matrix for no bias.
+   * @param inputScale Scale to quantize the input with; the largest absolute
+   *     value of the input that is represented is 127 * inputScale.
+   */
+  QuantizedLinearType(const MatType& weight,
+                      const MatType& bias,
+                      const double inputScale);
+
+  //! Clone the QuantizedLinearType object. This handles polymorphism correctly.
+  QuantizedLinearType* Clone() const { return new QuantizedLinearType(*this); }
+
+  //! Virtual destructor.
+  virtual ~QuantizedLinearType() { }
+
+  /**
+   * Ordinary feed forward pass: quantize the input and compute the
+   * transformation with integer dot products.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The layer can't be trained, so this throws std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the quantized weights (one column for each output unit).
+  const arma::Mat<int8_t>& Weight() const { return weight; }
+
+  //! Get the scale of the weights of each output unit.
+  const MatType& WeightScales() const { return weightScales; }
+
+  //! Get the bias of the layer (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Get the scale the input is quantized with.
+  double InputScale() const { return inputScale; }
+  //! Modify the scale the input is quantized with.
+  double& InputScale() { return inputScale; }
+
+  //! Compute the output dimensions of the layer using `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored quantized weights, with one column per output unit.
+  arma::Mat<int8_t> weight;
+
+  //! Locally-stored scale of the weights of each output unit.
+  MatType weightScales;
+
+  //! Locally-stored bias (empty if there is no bias).
+  MatType bias;
+
+  //! Locally-stored scale of the input.
+  double inputScale;
+
+  //! Locally-stored quantized input of the last forward pass.
+  arma::Mat<int8_t> quantizedInput;
+}; // class QuantizedLinearType
+
+// Standard QuantizedLinear layer.
+using QuantizedLinear = QuantizedLinearType<arma::mat>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer, an int8 version of the Linear
+ * and LinearNoBias layers for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType() :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    inputScale(1.0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    const MatType& weightIn,
+    const MatType& biasIn,
+    const double inputScale) :
+    Layer<MatType>(),
+    inSize(weightIn.n_cols),
+    outSize(weightIn.n_rows),
+    bias(biasIn),
+    inputScale(inputScale)
+{
+  // Store the weights of each output unit contiguously, to match the columns
+  // of the quantized input.
+  QuantizeColumns(MatType(weightIn.t()), weight, weightScales);
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  quantizedInput.set_size(inSize, input.n_cols);
+  Quantize(input.memptr(), input.n_elem, inputScale,
+      quantizedInput.memptr());
+
+  #pragma omp parallel for
+  for (size_t c = 0; c < (size_t) input.n_cols; ++c)
+  {
+    for (size_t o = 0; o < outSize; ++o)
+    {
+      const int32_t sum = QuantizedDot(weight.colptr(o),
+          quantizedInput.colptr(c), inSize);
+      output(o, c) = sum * inputScale * weightScales[o];
+      if (!bias.is_empty())
+        output(o, c) += bias[o];
+    }
+  }
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("QuantizedLinear::Backward(): quantized layers can "
+      "only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::ComputeOutputDimensions()
+{
+  size_t totalInSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    totalInSize *= this->inputDimensions[i];
+
+  if (totalInSize != inSize)
+  {
+    Log::Fatal << "QuantizedLinear::ComputeOutputDimensions(): input size ("
+        << totalInSize << ") does not match the size of the quantized weights ("
+        << inSize << ")!" << std::endl;
+  }
+
+  this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+      1);
+
+  // The QuantizedLinear layer flattens its input.
+  this->outputDimensions[0] = outSize;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedLinearType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file methods/ann/layer/sparse_linear.hpp
+ *
+ * Definition of the SparseLinear layer, a version of the Linear and
+ * LinearNoBias layers with pruned (sparse) weights for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+#include "pruning.hpp"
+
+namespace mlpack {
+
+/**
+ * The SparseLinear layer computes y = Ax + b (or y = Ax, without a bias) like
+ * the Linear and LinearNoBias layers, but only stores and multiplies the
+ * nonzero weights of A, so that the cost of the forward pass and the size of
+ * the layer are proportional to the number of nonzero weights.
+ *
+ * The weights are stored in block compressed sparse row format: A is split
+ * into square blocks of `BlockSize()` rows and columns, and only the blocks
+ * with a nonzero weight are stored, as dense blocks, row of blocks by row of
+ * blocks.  With a block size of 1, this is the usual compressed sparse row
+ * format.  Larger blocks store some zeros, but their products are computed
+ * with contiguous loops that the compiler can vectorize; when the weights have
+ * been pruned by blocks (see PruneWeights()), no zeros are stored.
+ *
+ * The layer has no trainable weights and can only be used for inference; it is
+ * usually created by FFN::Prune() from a trained Linear or LinearNoBias layer.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class SparseLinearType : public Layer<MatType>
+{
+ public:
+  //! Create an empty SparseLinear object.
+  SparseLinearType();
+
+  /**
+   * Create the SparseLinear object from the (pruned) weights of a Linear or
+   * LinearNoBias layer.
+   *
+   * @param weight Weights of the layer, with one row for each output unit.
+   * @param bias Bias of the layer, or an empty matrix for no bias.
+   * @param blockSize Size of the square blocks the weights are stored in.
+   */
+  SparseLinearType(const MatType& weight,
+                   const MatType& bias,
+                   const size_t blockSize = 1);
+
+  //! Clone the SparseLinearType object. This handles polymorphism correctly.
+  SparseLinearType* Clone() const { return new SparseLinearType(*this); }
+
+  //! Virtual destructor.
+  virtual ~SparseLinearType() { }
+
+  /**
+   * Ordinary feed forward pass: multiply the input by the sparse weights and
+   * add the bias.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The layer can't be trained, so this throws std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the weights as a dense matrix, with one row for each output unit.
+  MatType DenseWeight() const;
+
+  //! Get the bias of the layer (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Get the size of the square blocks the weights are stored in.
+  size_t BlockSize() const { return blockSize; }
+
+  //! Get the number of stored weights (including the zeros of the blocks).
+  size_t NonZeros() const { return blocks.n_elem; }
+
+  //! Get the index of the first block of each row of blocks (and the number of
+  //! blocks, at the end).
+  const arma::uvec& RowPointers() const { return rowPointers; }
+
+  //! Get the column of blocks of each block.
+  const arma::uvec& BlockColumns() const { return blockColumns; }
+
+  //! Get the blocks, one per column, each stored in column-major order.
+  const MatType& Blocks() const { return blocks; }
+
+  //! Compute the output dimensions of the layer using `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored size of the blocks.
+  size_t blockSize;
+
+  //! Locally-stored index of the first block of each row of blocks.
+  arma::uvec rowPointers;
+
+  //! Locally-stored column of blocks of each block.
+  arma::uvec blockColumns;
+
+  //! Locally-stored blocks, one per column.
+  MatType blocks;
+
+  //! Locally-stored bias (empty if there is no bias).
+  MatType bias;
+}; // class SparseLinearType
+
+// Standard SparseLinear layer.
+using SparseLinear = SparseLinearType<arma::mat>;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_linear_impl.hpp"
+
+#endif
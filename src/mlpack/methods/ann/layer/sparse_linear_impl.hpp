@@ -0,0 +1,234 @@
+/**
+ * @file methods/ann/layer/sparse_linear_impl.hpp
+ *
+ * Implementation of the SparseLinear layer, a version of the Linear and
+ * LinearNoBias layers with pruned (sparse) weights for inference.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_SPARSE_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "sparse_linear.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+SparseLinearType<MatType>::SparseLinearType() :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    blockSize(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+SparseLinearType<MatType>::SparseLinearType(
+    const MatType& weight,
+    const MatType& biasIn,
+    const size_t blockSize) :
+    Layer<MatType>(),
+    inSize(weight.n_cols),
+    outSize(weight.n_rows),
+    blockSize(blockSize),
+    bias(biasIn)
+{
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("SparseLinear::SparseLinear(): block size must "
+        "be positive!");
+  }
+
+  // Store the blocks with a nonzero weight; the blocks of the last rows and
+  // columns are padded with zeros.
+  const size_t blockRows = (outSize + blockSize - 1) / blockSize;
+  const size_t blockCols = (inSize + blockSize - 1) / blockSize;
+  MatType padded(blockRows * blockSize, blockCols * blockSize,
+      arma::fill::zeros);
+  padded.submat(0, 0, outSize - 1, inSize - 1) = weight;
+
+  std::vector<size_t> columns;
+  rowPointers.set_size(blockRows + 1);
+  rowPointers[0] = 0;
+  for (size_t i = 0; i < blockRows; ++i)
+  {
+    for (size_t j = 0; j < blockCols; ++j)
+    {
+      if (arma::any(arma::vectorise(padded.submat(i * blockSize, j * blockSize,
+          (i + 1) * blockSize - 1, (j + 1) * blockSize - 1)) != 0))
+        columns.push_back(j);
+    }
+
+    rowPointers[i + 1] = columns.size();
+  }
+
+  blockColumns = arma::conv_to<arma::uvec>::from(columns);
+  blocks.set_size(blockSize * blockSize, columns.size());
+  for (size_t i = 0; i < blockRows; ++i)
+  {
+    for (size_t b = rowPointers[i]; b < rowPointers[i + 1]; ++b)
+    {
+      const size_t j = blockColumns[b];
+      blocks.col(b) = arma::vectorise(padded.submat(i * blockSize,
+          j * blockSize, (i + 1) * blockSize - 1, (j + 1) * blockSize - 1));
+    }
+  }
+}
+
+template<typename MatType>
+void SparseLinearType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  using ElemType = typename MatType::elem_type;
+
+  const size_t blockRows = rowPointers.n_elem - 1;
+  const size_t paddedInSize = ((inSize + blockSize - 1) / blockSize) *
+      blockSize;
+  const size_t paddedOutSize = blockRows * blockSize;
+
+  // The blocks of the last columns and rows read and write past the input and
+  // output, unless they are padded.
+  output.set_size(outSize, input.n_cols);
+  MatType paddedInput, paddedOutput;
+  const MatType* x = &input;
+  MatType* y = &output;
+  if (paddedInSize != inSize)
+  {
+    paddedInput.zeros(paddedInSize, input.n_cols);
+    paddedInput.rows(0, inSize - 1) = input;
+    x = &paddedInput;
+  }
+
+  if (paddedOutSize != outSize)
+  {
+    paddedOutput.set_size(paddedOutSize, input.n_cols);
+    y = &paddedOutput;
+  }
+
+  MatType paddedBias(paddedOutSize, 1, arma::fill::zeros);
+  if (!bias.is_empty())
+    paddedBias.rows(0, outSize - 1) = bias;
+
+  #pragma omp parallel for
+  for (size_t c = 0; c < (size_t) input.n_cols; ++c)
+  {
+    const ElemType* xc = x->colptr(c);
+    ElemType* yc = y->colptr(c);
+    if (blockSize == 1)
+    {
+      // Compressed sparse row format.
+      for (size_t o = 0; o < outSize; ++o)
+      {
+        ElemType sum = paddedBias[o];
+        for (size_t b = rowPointers[o]; b < rowPointers[o + 1]; ++b)
+          sum += blocks[b] * xc[blockColumns[b]];
+        yc[o] = sum;
+      }
+    }
+    else
+    {
+      for (size_t i = 0; i < blockRows; ++i)
+      {
+        ElemType* yi = yc + i * blockSize;
+        for (size_t r = 0; r < blockSize; ++r)
+          yi[r] = paddedBias[i * blockSize + r];
+
+        // Each column of the block adds a multiple of its (contiguous) values
+        // to the output.
+        for (size_t b = rowPointers[i]; b < rowPointers[i + 1]; ++b)
+        {
+          const ElemType* block = blocks.colptr(b);
+          const ElemType* xj = xc + blockColumns[b] * blockSize;
+          for (size_t k = 0; k < blockSize; ++k)
+          {
+            const ElemType xk = xj[k];
+            const ElemType* blockCol = block + k * blockSize;
+            for (size_t r = 0; r < blockSize; ++r)
+              yi[r] += blockCol[r] * xk;
+          }
+        }
+      }
+    }
+  }
+
+  if (paddedOutSize != outSize)
+    output = paddedOutput.rows(0, outSize - 1);
+}
+
+template<typename MatType>
+void SparseLinearType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("SparseLinear::Backward(): pruned layers can only be "
+      "used for inference!");
+}
+
+template<typename MatType>
+MatType SparseLinearType<MatType>::DenseWeight() const
+{
+  const size_t blockRows = rowPointers.n_elem - 1;
+  const size_t blockCols = (inSize + blockSize - 1) / blockSize;
+  MatType padded(blockRows * blockSize, blockCols * blockSize,
+      arma::fill::zeros);
+  for (size_t i = 0; i < blockRows; ++i)
+  {
+    for (size_t b = rowPointers[i]; b < rowPointers[i + 1]; ++b)
+    {
+      const size_t j = blockColumns[b];
+      padded.submat(i * blockSize, j * blockSize, (i + 1) * blockSize - 1,
+          (j + 1) * blockSize - 1) = arma::reshape(blocks.col(b), blockSize,
+          blockSize);
+    }
+  }
+
+  return padded.submat(0, 0, outSize - 1, inSize - 1);
+}
+
+template<typename MatType>
+void SparseLinearType<MatType>::ComputeOutputDimensions()
+{
+  size_t totalInSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    totalInSize *= this->inputDimensions[i];
+
+  if (totalInSize != inSize)
+  {
+    Log::Fatal << "SparseLinear::ComputeOutputDimensions(): input size ("
+        << totalInSize << ") does not match the size of the sparse weights ("
+        << inSize << ")!" << std::endl;
+  }
+
+  this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+      1);
+
+  // The SparseLinear layer flattens its input.
+  this->outputDimensions[0] = outSize;
+}
+
+template<typename MatType>
+template<typename Archive>
+void SparseLinearType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(blockSize));
+  ar(CEREAL_NVP(rowPointers));
+  ar(CEREAL_NVP(blockColumns));
+  ar(CEREAL_NVP(blocks));
+  ar(CEREAL_NVP(bias));
+}
+
+} // namespace mlpack
+
+#endif
@@ -105,6 +105,30 @@ class RNN
     return network.Network();
   }
 
+  /**
+   * Get whether the time and estimated operations of each layer are recorded.
+   */
+  bool Profiling() const { return network.Profiling(); }
+  /**
+   * Modify whether the time and estimated operations of each layer are
+   * recorded.  This is disabled by default.  Each time step is a separate call
+   * of each layer.
+   */
+  bool& Profiling() { return network.Profiling(); }
+
+  //! Get the statistics of each layer recorded while `Profiling()` was
+  //! enabled.
+  const std::vector<LayerProfile>& Profile() const { return network.Profile(); }
+
+  //! Reset the statistics of each layer.
+  void ResetProfile() { network.ResetProfile(); }
+
+  //! Print the statistics of each layer as a table to the given stream.
+  void PrintProfile(std::ostream& stream = std::cout) const
+  {
+    network.PrintProfile(stream);
+  }
+
   /**
    * Train the recurrent network on the given input data using the given
    * optimizer.
@@ -227,6 +251,67 @@ class RNN
       arma::urowvec sequenceLengths,
       CallbackTypes&&... callbacks);
 
+  /**
+   * Train the recurrent network on packed sequences of different lengths,
+   * using the given optimizer.  Sequence `i` is given by `sequenceLengths[i]`
+   * consecutive columns of `predictors`, and the sequences follow each other
+   * in order, so `predictors` has `accu(sequenceLengths)` columns and no
+   * padding.  `responses` has the same layout, or, if the network was
+   * created with `single = true`, one column for each sequence.
+   *
+   * Unlike the overloads that take a cube and sequence lengths, any batch
+   * size can be used: the sequences are sorted by decreasing length, so that
+   * each batch holds sequences of similar lengths and is only run for as many
+   * time steps as its longest sequence.  Sequences that have ended do not
+   * contribute to the objective or the gradient.  Shuffling only reorders
+   * sequences of the same length.
+   *
+   * This will use the existing model parameters as a starting point for the
+   * optimization. If this is not what you want, then you should access the
+   * parameters vector directly with Parameters() and modify it as desired.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Packed input sequences.
+   * @param responses Packed responses (or one response for each sequence).
+   * @param sequenceLengths Length of each sequence; all lengths must be
+   *     positive.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      MatType predictors,
+      MatType responses,
+      arma::urowvec sequenceLengths,
+      OptimizerType& optimizer,
+      CallbackTypes&&... callbacks);
+
+  /**
+   * Train the recurrent network on packed sequences of different lengths.  By
+   * default, the RMSProp optimization algorithm is used, but others can be
+   * specified (such as ens::SGD).  See the overload above for the layout of
+   * the data.
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Packed input sequences.
+   * @param responses Packed responses (or one response for each sequence).
+   * @param sequenceLengths Length of each sequence; all lengths must be
+   *     positive.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   *      See https://www.ensmallen.org/docs.html#callback-documentation.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType = ens::RMSProp, typename... CallbackTypes>
+  typename MatType::elem_type Train(
+      MatType predictors,
+      MatType responses,
+      arma::urowvec sequenceLengths,
+      CallbackTypes&&... callbacks);
+
   /**
    * Predict the responses to a given set of predictors. The responses will
    * reflect the output of the given output layer as returned by the
@@ -258,6 +343,67 @@ class RNN
                arma::Cube<typename MatType::elem_type>& results,
                const arma::urowvec& sequenceLengths);
 
+  /**
+   * Predict the responses to packed sequences of different lengths, laid out
+   * like with the packed overload of `Train()`.  `results` gets the same
+   * layout as `predictors` (or one column for each sequence, if the network
+   * was created with `single = true`).  The sequences are sorted by length
+   * and predicted in batches; each time step is only computed for the
+   * sequences of the batch that have not ended.
+   *
+   * @param predictors Packed input sequences.
+   * @param results Matrix to put the packed predictions into.
+   * @param sequenceLengths Length of each sequence.
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const arma::urowvec& sequenceLengths,
+               const size_t batchSize = 128);
+
+  /**
+   * Prepare the network for inference with workspaces; see `FFN::Freeze()`.
+   * After this, the overloads of `Predict()` that take a workspace can be
+   * called from any number of threads at once, as long as the network is not
+   * modified in the meantime.
+   */
+  void Freeze(const size_t inputDimensionality = 0)
+  {
+    network.Freeze(inputDimensionality);
+  }
+
+  /**
+   * Predict the responses to a given set of predictors with the given
+   * workspace, without modifying the network, which must have been prepared
+   * with `Freeze()`.  The workspace holds copies of the layers, including the
+   * state of the recurrent layers; concurrent calls must use different
+   * workspaces.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Workspace to use for the forward passes.
+   * @param batchSize Batch size to use for prediction.
+   */
+  void Predict(const arma::Cube<typename MatType::elem_type>& predictors,
+               arma::Cube<typename MatType::elem_type>& results,
+               RNNWorkspace<MatType>& workspace,
+               const size_t batchSize = 128) const;
+
+  /**
+   * Predict the responses to a given set of predictors of different lengths
+   * with the given workspace, without modifying the network, which must have
+   * been prepared with `Freeze()`.  See the other overloads of `Predict()`.
+   *
+   * @param predictors Input predictors.
+   * @param results Matrix to put output predictions of responses into.
+   * @param workspace Workspace to use for the forward passes.
+   * @param sequenceLengths Length of each sequence.
+   */
+  void Predict(const arma::Cube<typename MatType::elem_type>& predictors,
+               arma::Cube<typename MatType::elem_type>& results,
+               RNNWorkspace<MatType>& workspace,
+               const arma::urowvec& sequenceLengths) const;
+
   // Return the nujmber of weights in the model.
   size_t WeightSize() { return network.WeightSize(); }
 
@@ -292,6 +438,21 @@ class RNN
   //! Modify the number of steps allowed for BPTT.
   size_t& BPTTSteps() { return bpttSteps; }
 
+  /**
+   * Get the number of steps between checkpoints for BPTT.  If this is 0 (the
+   * default), the recurrent state of all `BPTTSteps()` steps is kept during
+   * training.  Otherwise, only the state before every block of
+   * `CheckpointSteps()` steps is kept, and each block is recomputed from it
+   * during the backward pass; this needs memory for about
+   * `BPTTSteps() / CheckpointSteps() + CheckpointSteps()` steps instead of
+   * `BPTTSteps()`, at the cost of a second forward pass for each step that is
+   * backpropagated through.
+   * Setting it to about the square root of `BPTTSteps()` uses the least memory.
+   */
+  size_t CheckpointSteps() const { return checkpointSteps; }
+  //! Modify the number of steps between checkpoints for BPTT.
+  size_t& CheckpointSteps() { return checkpointSteps; }
+
   /**
    * Reset the stored data of the network entirely.  This reset all weights of
    * each layer using `InitializationRuleType`, and prepares the network to
@@ -405,7 +566,11 @@ class RNN
                 const size_t batchSize);
 
   //! Return the number of separable functions (the number of predictor points).
-  size_t NumFunctions() const { return predictors.n_cols; }
+  size_t NumFunctions() const
+  {
+    return (packedLengths.n_elem > 0) ? packedLengths.n_elem :
+        predictors.n_cols;
+  }
 
   /**
    * Note: this function is implement so that it can be used by ensmallen's
@@ -429,6 +594,19 @@ class RNN
                  arma::Cube<typename MatType::elem_type> responses,
                  arma::urowvec sequenceLengths = arma::urowvec());
 
+  /**
+   * Prepare the network for the given packed sequences (see the packed
+   * overload of `Train()`).  This function won't actually trigger training
+   * process.
+   *
+   * @param predictors Packed input sequences.
+   * @param responses Packed responses (or one response for each sequence).
+   * @param sequenceLengths Length of each sequence.
+   */
+  void ResetData(MatType predictors,
+                 MatType responses,
+                 arma::urowvec sequenceLengths);
+
  private:
   // Helper functions.
 
@@ -442,11 +620,107 @@ class RNN
   //! Set the current step index of all recurrent layers to `step`.
   void SetCurrentStep(const size_t step, const bool end);
 
+  /**
+   * Allocate `numCheckpoints` checkpoints of the state of each recurrent layer,
+   * with a batch size of `batchSize`.
+   */
+  void InitializeCheckpoints(
+      std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+      const size_t numCheckpoints,
+      const size_t batchSize) const;
+
+  /**
+   * Save the state of each recurrent layer at time step `step` as the
+   * checkpoint of block `block` (the block that starts at `step + 1`).
+   */
+  void SaveCheckpoint(
+      std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+      const size_t block,
+      const size_t step) const;
+
+  /**
+   * Restore the state of each recurrent layer at time step `step` from the
+   * checkpoint of block `block`.
+   */
+  void RestoreCheckpoint(
+      const std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+      const size_t block,
+      const size_t step) const;
+
+  /**
+   * Restore the state before time step `first` from its checkpoint, and then
+   * recompute the forward passes of time steps `first` to `last` (inclusive),
+   * storing the outputs in `outputs`.
+   */
+  void RecomputeSteps(
+      const std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+      const arma::Cube<typename MatType::elem_type>& batchPredictors,
+      const size_t first,
+      const size_t last,
+      const size_t begin,
+      const size_t batchSize,
+      const size_t steps,
+      arma::Cube<typename MatType::elem_type>& outputs);
+
+  /**
+   * Compute the objective and the gradient of a batch of `batchSize`
+   * sequences of `steps` time steps, starting at column `begin` of
+   * `batchPredictors` and `batchResponses`.  If `activeSizes` is not empty,
+   * the sequences are sorted by decreasing length, and only the first
+   * `activeSizes[t]` of them have not ended at time step `t`.
+   */
+  template<typename GradType>
+  typename MatType::elem_type BatchEvaluateWithGradient(
+      const arma::Cube<typename MatType::elem_type>& batchPredictors,
+      const arma::Cube<typename MatType::elem_type>& batchResponses,
+      const size_t begin,
+      const size_t batchSize,
+      const size_t steps,
+      const std::vector<size_t>& activeSizes,
+      GradType& gradient);
+
+  /**
+   * Get the range `[first, last)` of the columns of a batch that have a
+   * response at time step `t` (see `BatchEvaluateWithGradient()`).
+   */
+  void ResponseColumns(const size_t t,
+                       const size_t steps,
+                       const size_t batchSize,
+                       const std::vector<size_t>& activeSizes,
+                       size_t& first,
+                       size_t& last) const;
+
+  /**
+   * Copy the `batchSize` packed sequences starting at (sorted) position
+   * `begin` into cubes with one slice for each time step of the longest of
+   * them, padded with zeros, and compute the number of sequences that have
+   * not ended at each time step.
+   */
+  void PackBatch(const size_t begin,
+                 const size_t batchSize,
+                 arma::Cube<typename MatType::elem_type>& batchPredictors,
+                 arma::Cube<typename MatType::elem_type>& batchResponses,
+                 std::vector<size_t>& activeSizes) const;
+
+  /**
+   * Check that the given packed sequences match their lengths, and compute
+   * the first column of each sequence and the order of the sequences by
+   * decreasing length (ties are kept in their original order).
+   */
+  static void PackedSequenceOrder(const std::string& functionName,
+                                  const MatType& predictors,
+                                  const arma::urowvec& sequenceLengths,
+                                  arma::uvec& offsets,
+                                  arma::uvec& order);
+
   //! Number of timesteps to consider for backpropagation through time (BPTT).
   size_t bpttSteps;
   //! Whether the network expects only one single response per sequence, or one
   //! response per time step.
   bool single;
+  //! Number of timesteps between checkpoints for BPTT (0 for no
+  //! checkpointing).
+  size_t checkpointSteps;
 
   //! The network itself is stored in this FFN object.  Note that this network
   //! may contain recursive layers, and thus we will be responsible for
@@ -465,6 +739,19 @@ class RNN
   // The length of each input sequence.  If this is empty, then every sequence
   // is assuemd to have the same length (`predictors.n_slices`).
   arma::urowvec sequenceLengths;
+
+  // Packed training sequences, followed by each other without padding.  These
+  // members are only used when training on packed sequences.
+  MatType packedPredictors;
+  // Packed responses (or one response for each sequence in single mode).
+  MatType packedResponses;
+  // The length of each packed sequence.
+  arma::urowvec packedLengths;
+  // The first column of each packed sequence.
+  arma::uvec packedOffsets;
+  // The packed sequences sorted by decreasing length; the optimizer's batches
+  // are taken in this order.
+  arma::uvec packedOrder;
 }; // class RNNType
 
 } // namespace mlpack
@@ -34,6 +34,7 @@ RNN<
     InitializationRuleType initializeRule) :
     bpttSteps(bpttSteps),
     single(single),
+    checkpointSteps(0),
     network(std::move(outputLayer), std::move(initializeRule))
 {
   /* Nothing to do here */
@@ -52,6 +53,7 @@ RNN<
     const RNN& network) :
     bpttSteps(network.bpttSteps),
     single(network.single),
+    checkpointSteps(network.checkpointSteps),
     network(network.network)
 {
   // Nothing else to do.
@@ -70,6 +72,7 @@ RNN<
     RNN&& network) :
     bpttSteps(std::move(network.bpttSteps)),
     single(std::move(network.single)),
+    checkpointSteps(std::move(network.checkpointSteps)),
     network(std::move(network.network))
 {
   // Nothing to do here.
@@ -95,9 +98,13 @@ RNN<
   {
     bpttSteps = other.bpttSteps;
     single = other.single;
+    checkpointSteps = other.checkpointSteps;
     network = other.network;
     predictors.clear();
     responses.clear();
+    packedPredictors.clear();
+    packedResponses.clear();
+    packedLengths.clear();
   }
 
   return *this;
@@ -123,9 +130,13 @@ RNN<
   {
     bpttSteps = std::move(other.bpttSteps);
     single = std::move(other.single);
+    checkpointSteps = std::move(other.checkpointSteps);
     network = std::move(other.network);
     predictors.clear();
     responses.clear();
+    packedPredictors.clear();
+    packedResponses.clear();
+    packedLengths.clear();
   }
 
   return *this;
@@ -256,6 +267,63 @@ typename MatType::elem_type RNN<
       std::move(sequenceLengths), optimizer, callbacks...);
 }
 
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    MatType predictors,
+    MatType responses,
+    arma::urowvec sequenceLengths,
+    OptimizerType& optimizer,
+    CallbackTypes&&... callbacks)
+{
+  ResetData(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths));
+
+  network.WarnMessageMaxIterations(optimizer, packedLengths.n_elem);
+
+  // Ensure that the network can be used.
+  network.CheckNetwork("RNN::Train()", packedPredictors.n_rows, true, true);
+
+  // Train the model.
+  Timer::Start("rnn_optimization");
+  const typename MatType::elem_type out =
+      optimizer.Optimize(*this, network.Parameters(), callbacks...);
+  Timer::Stop("rnn_optimization");
+
+  Log::Info << "RNN::Train(): final objective of trained model is " << out
+      << "." << std::endl;
+  return out;
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(
+    MatType predictors,
+    MatType responses,
+    arma::urowvec sequenceLengths,
+    CallbackTypes&&... callbacks)
+{
+  OptimizerType optimizer;
+  return Train(std::move(predictors), std::move(responses),
+      std::move(sequenceLengths), optimizer, callbacks...);
+}
+
 template<
     typename OutputLayerType,
     typename InitializationRuleType,
@@ -348,6 +416,156 @@ void RNN<
   }
 }
 
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(
+    const MatType& predictors,
+    MatType& results,
+    const arma::urowvec& sequenceLengths,
+    const size_t batchSize)
+{
+  arma::uvec offsets, order;
+  PackedSequenceOrder("RNN::Predict()", predictors, sequenceLengths, offsets,
+      order);
+
+  // Ensure that the network is configured correctly.
+  network.CheckNetwork("RNN::Predict()", predictors.n_rows, true, false);
+
+  results.set_size(network.network.OutputSize(),
+      single ? sequenceLengths.n_elem : predictors.n_cols);
+
+  MatType stepData, output;
+  for (size_t i = 0; i < order.n_elem; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(order.n_elem) - i);
+
+    // The first sequence of the batch is the longest.
+    const size_t steps = sequenceLengths[order[i]];
+    ResetMemoryState(0, effectiveBatchSize);
+
+    stepData.zeros(predictors.n_rows, effectiveBatchSize);
+    size_t active = effectiveBatchSize;
+    for (size_t t = 0; t < steps; ++t)
+    {
+      SetCurrentStep(t, (t == steps - 1));
+
+      // The sequences that have not ended are the first `active` of the
+      // batch; the input of the others is zero.
+      while (sequenceLengths[order[i + active - 1]] <= t)
+        stepData.col(--active).zeros();
+
+      for (size_t c = 0; c < active; ++c)
+        stepData.col(c) = predictors.col(offsets[order[i + c]] + t);
+
+      network.Forward(stepData, output);
+
+      for (size_t c = 0; c < active; ++c)
+      {
+        const size_t sequence = order[i + c];
+        if (!single)
+          results.col(offsets[sequence] + t) = output.col(c);
+        else if (t == sequenceLengths[sequence] - 1)
+          results.col(sequence) = output.col(c);
+      }
+    }
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    arma::Cube<typename MatType::elem_type>& results,
+    RNNWorkspace<MatType>& workspace,
+    const size_t batchSize) const
+{
+  // Ensure that the network was frozen, and set up the workspace if needed.
+  network.CheckFrozenNetwork("RNN::Predict()", predictors.n_rows, workspace,
+      std::min(batchSize, size_t(predictors.n_cols)));
+
+  results.set_size(workspace.Layers().back()->OutputSize(), predictors.n_cols,
+      single ? 1 : predictors.n_slices);
+
+  MatType inputAlias, outputAlias;
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    // As in Predict(), the state of each time step does not need to be stored.
+    workspace.ClearRecurrentState(0, effectiveBatchSize);
+
+    for (size_t t = 0; t < predictors.n_slices; ++t)
+    {
+      workspace.CurrentStep(t, (t == predictors.n_slices - 1));
+
+      MakeAlias(inputAlias, predictors.slice(t), predictors.n_rows,
+          effectiveBatchSize, i * predictors.n_rows);
+      MakeAlias(outputAlias, results.slice(single ? 0 : t), results.n_rows,
+          effectiveBatchSize, i * results.n_rows);
+
+      workspace.Forward(inputAlias, outputAlias);
+    }
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Predict(
+    const arma::Cube<typename MatType::elem_type>& predictors,
+    arma::Cube<typename MatType::elem_type>& results,
+    RNNWorkspace<MatType>& workspace,
+    const arma::urowvec& sequenceLengths) const
+{
+  // Ensure that the network was frozen, and set up the workspace if needed.
+  network.CheckFrozenNetwork("RNN::Predict()", predictors.n_rows, workspace,
+      1);
+
+  results.set_size(workspace.Layers().back()->OutputSize(), predictors.n_cols,
+      single ? 1 : predictors.n_slices);
+
+  MatType inputAlias, outputAlias;
+  for (size_t i = 0; i < predictors.n_cols; i++)
+  {
+    workspace.ClearRecurrentState(0, 1);
+
+    const size_t steps = sequenceLengths[i];
+    for (size_t t = 0; t < steps; ++t)
+    {
+      workspace.CurrentStep(t, (t == steps - 1));
+
+      MakeAlias(inputAlias, predictors.slice(t), predictors.n_rows, 1,
+          i * predictors.n_rows);
+      MakeAlias(outputAlias, results.slice(single ? 0 : t), results.n_rows, 1,
+          i * results.n_rows);
+
+      workspace.Forward(inputAlias, outputAlias);
+    }
+  }
+}
+
 template<
     typename OutputLayerType,
     typename InitializationRuleType,
@@ -410,6 +628,9 @@ void RNN<
       predictors.clear();
       responses.clear();
       sequenceLengths.clear();
+      packedPredictors.clear();
+      packedResponses.clear();
+      packedLengths.clear();
     }
   #endif
 }
@@ -428,6 +649,44 @@ typename MatType::elem_type RNN<
     const size_t begin,
     const size_t batchSize)
 {
+  if (packedLengths.n_elem > 0)
+  {
+    network.CheckNetwork("RNN::Evaluate()", packedPredictors.n_rows);
+
+    arma::Cube<typename MatType::elem_type> batchPredictors, batchResponses;
+    std::vector<size_t> activeSizes;
+    PackBatch(begin, batchSize, batchPredictors, batchResponses, activeSizes);
+
+    // As below, only one memory cell is needed.
+    ResetMemoryState(1, batchSize);
+    MatType output(network.network.OutputSize(), batchSize);
+
+    typename MatType::elem_type loss = network.network.Loss();
+    MatType stepData, activeOutput, responseData;
+    const size_t steps = activeSizes.size();
+    for (size_t t = 0; t < steps; ++t)
+    {
+      SetCurrentStep(t, (t == steps - 1));
+      MakeAlias(stepData, batchPredictors.slice(t), batchPredictors.n_rows,
+          batchSize);
+      network.network.Forward(stepData, output);
+
+      // Only the sequences with a response at this time step count.
+      size_t first, last;
+      ResponseColumns(t, steps, batchSize, activeSizes, first, last);
+      if (first == last)
+        continue;
+
+      MakeAlias(activeOutput, output, output.n_rows, last - first,
+          first * output.n_rows);
+      MakeAlias(responseData, batchResponses.slice(single ? 0 : t),
+          batchResponses.n_rows, last - first, first * batchResponses.n_rows);
+      loss += network.outputLayer.Forward(activeOutput, responseData);
+    }
+
+    return loss;
+  }
+
   // Ensure the network is valid.
   network.CheckNetwork("RNN::Evaluate()", predictors.n_rows);
 
@@ -476,7 +735,7 @@ typename MatType::elem_type RNN<
     const MatType& parameters,
     GradType& gradient)
 {
-  return EvaluateWithGradient(parameters, 0, gradient, predictors.n_cols);
+  return EvaluateWithGradient(parameters, 0, gradient, NumFunctions());
 }
 
 template<
@@ -495,27 +754,83 @@ typename MatType::elem_type RNN<
     GradType& gradient,
     const size_t batchSize)
 {
+  if (packedLengths.n_elem > 0)
+  {
+    network.CheckNetwork("RNN::EvaluateWithGradient()",
+        packedPredictors.n_rows);
+
+    arma::Cube<typename MatType::elem_type> batchPredictors, batchResponses;
+    std::vector<size_t> activeSizes;
+    PackBatch(begin, batchSize, batchPredictors, batchResponses, activeSizes);
+    return BatchEvaluateWithGradient(batchPredictors, batchResponses, 0,
+        batchSize, activeSizes.size(), activeSizes, gradient);
+  }
+
   network.CheckNetwork("RNN::EvaluateWithGradient()", predictors.n_rows);
 
   if (sequenceLengths.n_elem > 0 && batchSize != 1)
     throw std::invalid_argument("Batch size must be 1 for ragged sequences!");
 
+  const size_t steps = (sequenceLengths.n_elem == 0) ? predictors.n_slices :
+      sequenceLengths[begin];
+  return BatchEvaluateWithGradient(predictors, responses, begin, batchSize,
+      steps, std::vector<size_t>(), gradient);
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+template<typename GradType>
+typename MatType::elem_type RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::BatchEvaluateWithGradient(
+    const arma::Cube<typename MatType::elem_type>& batchPredictors,
+    const arma::Cube<typename MatType::elem_type>& batchResponses,
+    const size_t begin,
+    const size_t batchSize,
+    const size_t steps,
+    const std::vector<size_t>& activeSizes,
+    GradType& gradient)
+{
   typename MatType::elem_type loss = 0;
 
   // We must save anywhere between 1 and `bpttSteps` states, but we are limited
-  // by `predictors.n_slices`.
+  // by `batchPredictors.n_slices`.
   const size_t effectiveBPTTSteps = std::max(size_t(1),
-      std::min(bpttSteps, size_t(predictors.n_slices)));
+      std::min(bpttSteps, size_t(batchPredictors.n_slices)));
+
+  // With checkpointing, the recurrent state is only kept for the last
+  // `checkpointSteps + 2` steps (a block of `checkpointSteps` steps, the step
+  // before it, and the step after it).  The state before each block is saved
+  // as a checkpoint, and the blocks are recomputed from their checkpoints
+  // during the backward pass.
+  const bool useCheckpoints = (checkpointSteps > 0) &&
+      (checkpointSteps + 2 < effectiveBPTTSteps);
+  const size_t memorySize = useCheckpoints ? checkpointSteps + 2 :
+      effectiveBPTTSteps;
 
-  ResetMemoryState(effectiveBPTTSteps, batchSize);
+  ResetMemoryState(memorySize, batchSize);
 
   // This will store the outputs of the network at each time step.  Note that we
-  // only need to store `effectiveBPTTSteps` of output.  We will treat `outputs`
-  // as a circular buffer.
+  // only need to store `memorySize` of output.  We will treat `outputs` as a
+  // circular buffer.
   arma::Cube<typename MatType::elem_type> outputs(
-      network.network.OutputSize(), batchSize, effectiveBPTTSteps);
+      network.network.OutputSize(), batchSize, memorySize);
+
+  // The checkpoints are a circular buffer too, holding the blocks that BPTT
+  // can reach from the current step.
+  std::vector<arma::Cube<typename MatType::elem_type>> checkpoints;
+  if (useCheckpoints)
+  {
+    InitializeCheckpoints(checkpoints, effectiveBPTTSteps / checkpointSteps + 2,
+        batchSize);
+  }
 
-  MatType stepData, outputData, responseData;
+  MatType stepData, outputData, responseData, activeOutput, activeError;
 
   // Initialize gradient.
   gradient.zeros(network.Parameters().n_rows, network.Parameters().n_cols);
@@ -528,22 +843,27 @@ typename MatType::elem_type RNN<
   // For backpropagation through time, we must backpropagate for every
   // subsequence of length `bpttSteps`.  Before we've taken `bpttSteps` though,
   // we will be backpropagating shorter sequences.
-  const size_t steps = (sequenceLengths.n_elem == 0) ? predictors.n_slices :
-      sequenceLengths[begin];
   for (size_t t = 0; t < steps; ++t)
   {
     SetCurrentStep(t, (t == (steps - 1)));
 
     // Make an alias of the step's data for the forward pass.
-    MakeAlias(stepData, predictors.slice(t), predictors.n_rows, batchSize,
-        begin * predictors.slice(t).n_rows);
-    MakeAlias(outputData, outputs.slice(t % effectiveBPTTSteps), outputs.n_rows,
+    MakeAlias(stepData, batchPredictors.slice(t), batchPredictors.n_rows,
+        batchSize, begin * batchPredictors.n_rows);
+    MakeAlias(outputData, outputs.slice(t % memorySize), outputs.n_rows,
         outputs.n_cols);
     network.network.Forward(stepData, outputData);
 
-    // Determine what the response should be.  If we are in single mode but not
-    // at the end of the sequence, we don't do a backwards pass.
-    if (single && t != steps - 1)
+    // Save the state before each block, if we are checkpointing.
+    if (useCheckpoints && (t + 1) % checkpointSteps == 0)
+      SaveCheckpoint(checkpoints, (t + 1) / checkpointSteps, t);
+
+    // Determine what the response should be.  If no sequence has a response
+    // at this step (e.g. in single mode, if we are not at the end of a
+    // sequence), we don't do a backwards pass.
+    size_t first, last;
+    ResponseColumns(t, steps, batchSize, activeSizes, first, last);
+    if (first == last)
     {
       continue;
     }
@@ -551,8 +871,19 @@ typename MatType::elem_type RNN<
     // Now backpropagate through time, starting with the current time step and
     // moving backwards.
     MatType error;
+    bool recomputed = false;
     for (size_t step = 0; step < std::min(t + 1, effectiveBPTTSteps); ++step)
     {
+      // When we reach the end of an earlier block, its states must be
+      // recomputed from its checkpoint.
+      if (useCheckpoints && step > 0 && (t - step + 1) % checkpointSteps == 0)
+      {
+        RecomputeSteps(checkpoints, batchPredictors,
+            t - step + 1 - checkpointSteps, t - step, begin, batchSize, steps,
+            outputs);
+        recomputed = true;
+      }
+
       SetCurrentStep(t - step, (step == 0));
 
       if (step > 0)
@@ -560,9 +891,9 @@ typename MatType::elem_type RNN<
         // Past the first step, the error is zero; only recurrent terms matter.
         error.zeros();
 
-        MakeAlias(stepData, predictors.slice(t - step), predictors.n_rows,
-            batchSize, begin * predictors.slice(t - step).n_rows);
-        MakeAlias(outputData, outputs.slice((t - step) % effectiveBPTTSteps),
+        MakeAlias(stepData, batchPredictors.slice(t - step),
+            batchPredictors.n_rows, batchSize, begin * batchPredictors.n_rows);
+        MakeAlias(outputData, outputs.slice((t - step) % memorySize),
             outputs.n_rows, outputs.n_cols);
       }
       else
@@ -570,18 +901,25 @@ typename MatType::elem_type RNN<
         // Otherwise, use the backward pass on the output layer to compute the
         // error.
         const size_t responseStep = (single) ? 0 : t - step;
-        MakeAlias(stepData, predictors.slice(t - step), predictors.n_rows,
-            batchSize, begin * predictors.slice(t - step).n_rows);
-        MakeAlias(responseData, responses.slice(responseStep), responses.n_rows,
-            batchSize, begin * responses.slice(responseStep).n_rows);
-        MakeAlias(outputData, outputs.slice((t - step) % effectiveBPTTSteps),
+        MakeAlias(stepData, batchPredictors.slice(t - step),
+            batchPredictors.n_rows, batchSize, begin * batchPredictors.n_rows);
+        MakeAlias(responseData, batchResponses.slice(responseStep),
+            batchResponses.n_rows, last - first,
+            (begin + first) * batchResponses.n_rows);
+        MakeAlias(outputData, outputs.slice((t - step) % memorySize),
             outputs.n_rows, outputs.n_cols);
+        MakeAlias(activeOutput, outputs.slice((t - step) % memorySize),
+            outputs.n_rows, last - first, first * outputs.n_rows);
 
         // We only need to do this on the first time step of BPTT.
-        loss += network.outputLayer.Forward(outputData, responseData);
+        loss += network.outputLayer.Forward(activeOutput, responseData);
 
-        // Compute the output error.
-        network.outputLayer.Backward(outputData, responseData, error);
+        // Compute the output error; the columns without a response have no
+        // error.
+        error.zeros(outputs.n_rows, batchSize);
+        MakeAlias(activeError, error, error.n_rows, last - first,
+            first * error.n_rows);
+        network.outputLayer.Backward(activeOutput, responseData, activeError);
       }
 
       // Now backpropagate that error through the network, and compute the
@@ -598,6 +936,14 @@ typename MatType::elem_type RNN<
 
       gradient += currentGradient;
     }
+
+    // If earlier blocks were recomputed, they overwrote the states of the
+    // current block, which the next forward pass (and BPTT) still needs.
+    if (recomputed && t + 1 < steps)
+    {
+      RecomputeSteps(checkpoints, batchPredictors, t - (t % checkpointSteps),
+          t, begin, batchSize, steps, outputs);
+    }
   }
 
   return loss;
@@ -633,6 +979,19 @@ void RNN<
     MatType
 >::Shuffle()
 {
+  if (packedLengths.n_elem > 0)
+  {
+    // Keep the sequences sorted by length, so that the batches stay compact;
+    // only the order of the sequences of the same length is shuffled.
+    packedOrder = arma::randperm<arma::uvec>(packedLengths.n_elem);
+    std::stable_sort(packedOrder.begin(), packedOrder.end(),
+        [&](const size_t a, const size_t b)
+        {
+          return packedLengths[a] > packedLengths[b];
+        });
+    return;
+  }
+
   ShuffleData(predictors, responses, predictors, responses);
 }
 
@@ -653,6 +1012,165 @@ void RNN<
   this->predictors = std::move(predictors);
   this->responses = std::move(responses);
   this->sequenceLengths = std::move(sequenceLengths);
+  packedPredictors.clear();
+  packedResponses.clear();
+  packedLengths.clear();
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResetData(
+    MatType predictors,
+    MatType responses,
+    arma::urowvec sequenceLengths)
+{
+  PackedSequenceOrder("RNN::ResetData()", predictors, sequenceLengths,
+      packedOffsets, packedOrder);
+
+  const size_t numResponses = single ? sequenceLengths.n_elem :
+      predictors.n_cols;
+  if (responses.n_cols != numResponses)
+  {
+    std::ostringstream oss;
+    oss << "RNN::ResetData(): the responses have " << responses.n_cols
+        << " columns, but " << numResponses << " are needed for the packed "
+        << "sequences!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  packedPredictors = std::move(predictors);
+  packedResponses = std::move(responses);
+  packedLengths = std::move(sequenceLengths);
+  this->predictors.clear();
+  this->responses.clear();
+  this->sequenceLengths.clear();
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PackedSequenceOrder(
+    const std::string& functionName,
+    const MatType& predictors,
+    const arma::urowvec& sequenceLengths,
+    arma::uvec& offsets,
+    arma::uvec& order)
+{
+  offsets.set_size(sequenceLengths.n_elem);
+  size_t totalLength = 0;
+  for (size_t i = 0; i < sequenceLengths.n_elem; ++i)
+  {
+    if (sequenceLengths[i] == 0)
+    {
+      throw std::invalid_argument(functionName + ": packed sequences must "
+          "not be empty!");
+    }
+
+    offsets[i] = totalLength;
+    totalLength += sequenceLengths[i];
+  }
+
+  if (totalLength != predictors.n_cols)
+  {
+    std::ostringstream oss;
+    oss << functionName << ": the sequence lengths add up to " << totalLength
+        << ", but the packed sequences have " << predictors.n_cols
+        << " columns!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  order.set_size(sequenceLengths.n_elem);
+  for (size_t i = 0; i < order.n_elem; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+      [&](const size_t a, const size_t b)
+      {
+        return sequenceLengths[a] > sequenceLengths[b];
+      });
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::PackBatch(
+    const size_t begin,
+    const size_t batchSize,
+    arma::Cube<typename MatType::elem_type>& batchPredictors,
+    arma::Cube<typename MatType::elem_type>& batchResponses,
+    std::vector<size_t>& activeSizes) const
+{
+  // The sequences are sorted by decreasing length, so the first sequence of
+  // the batch is the longest.
+  const size_t steps = packedLengths[packedOrder[begin]];
+  batchPredictors.zeros(packedPredictors.n_rows, batchSize, steps);
+  batchResponses.zeros(packedResponses.n_rows, batchSize, single ? 1 : steps);
+  activeSizes.assign(steps, 0);
+
+  for (size_t c = 0; c < batchSize; ++c)
+  {
+    const size_t sequence = packedOrder[begin + c];
+    const size_t offset = packedOffsets[sequence];
+    for (size_t t = 0; t < packedLengths[sequence]; ++t)
+    {
+      batchPredictors.slice(t).col(c) = packedPredictors.col(offset + t);
+      if (!single)
+        batchResponses.slice(t).col(c) = packedResponses.col(offset + t);
+      ++activeSizes[t];
+    }
+
+    if (single)
+      batchResponses.slice(0).col(c) = packedResponses.col(sequence);
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ResponseColumns(
+    const size_t t,
+    const size_t steps,
+    const size_t batchSize,
+    const std::vector<size_t>& activeSizes,
+    size_t& first,
+    size_t& last) const
+{
+  if (activeSizes.empty())
+  {
+    // All the sequences have the same length.
+    first = 0;
+    last = (!single || t == steps - 1) ? batchSize : 0;
+    return;
+  }
+
+  // The sequences that have not ended are the first `activeSizes[t]`; in
+  // single mode, only those that end at step `t` have a response.
+  last = activeSizes[t];
+  first = (single && t + 1 < steps) ? activeSizes[t + 1] : 0;
 }
 
 template<
@@ -677,6 +1195,125 @@ void RNN<
   }
 }
 
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::InitializeCheckpoints(
+    std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+    const size_t numCheckpoints,
+    const size_t batchSize) const
+{
+  checkpoints.clear();
+  for (Layer<MatType>* l : network.Network())
+  {
+    // Only RecurrentLayers have state to save.
+    RecurrentLayer<MatType>* r =
+        dynamic_cast<RecurrentLayer<MatType>*>(l);
+    if (r != nullptr)
+    {
+      checkpoints.push_back(arma::Cube<typename MatType::elem_type>(
+          r->RecurrentSize(), batchSize, numCheckpoints));
+    }
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SaveCheckpoint(
+    std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+    const size_t block,
+    const size_t step) const
+{
+  size_t i = 0;
+  for (Layer<MatType>* l : network.Network())
+  {
+    RecurrentLayer<MatType>* r =
+        dynamic_cast<RecurrentLayer<MatType>*>(l);
+    if (r != nullptr)
+    {
+      checkpoints[i].slice(block % checkpoints[i].n_slices) =
+          r->RecurrentState(step);
+      ++i;
+    }
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::RestoreCheckpoint(
+    const std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+    const size_t block,
+    const size_t step) const
+{
+  size_t i = 0;
+  for (Layer<MatType>* l : network.Network())
+  {
+    RecurrentLayer<MatType>* r =
+        dynamic_cast<RecurrentLayer<MatType>*>(l);
+    if (r != nullptr)
+    {
+      r->RecurrentState(step) =
+          checkpoints[i].slice(block % checkpoints[i].n_slices);
+      ++i;
+    }
+  }
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::RecomputeSteps(
+    const std::vector<arma::Cube<typename MatType::elem_type>>& checkpoints,
+    const arma::Cube<typename MatType::elem_type>& batchPredictors,
+    const size_t first,
+    const size_t last,
+    const size_t begin,
+    const size_t batchSize,
+    const size_t steps,
+    arma::Cube<typename MatType::elem_type>& outputs)
+{
+  // Restore the state before the block, unless the block is the first one.
+  if (first > 0)
+    RestoreCheckpoint(checkpoints, first / checkpointSteps, first - 1);
+
+  MatType stepData, outputData;
+  for (size_t t = first; t <= last; ++t)
+  {
+    SetCurrentStep(t, (t == (steps - 1)));
+    MakeAlias(stepData, batchPredictors.slice(t), batchPredictors.n_rows,
+        batchSize, begin * batchPredictors.n_rows);
+    MakeAlias(outputData, outputs.slice(t % outputs.n_slices), outputs.n_rows,
+        outputs.n_cols);
+    network.network.Forward(stepData, outputData);
+  }
+}
+
 template<
     typename OutputLayerType,
     typename InitializationRuleType,
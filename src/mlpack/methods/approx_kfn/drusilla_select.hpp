@@ -82,6 +82,10 @@ class DrusillaSelect
    * the k'th row in that column will refer to the k'th candidate neighbor or
    * distance for that query point.
    *
+   * For dense data, the distances to the candidate points are computed for
+   * blocks of query points at once, with a matrix product; the blocks are
+   * processed in parallel if OpenMP is available.
+   *
    * @param querySet Set of query points to search.
    * @param k Number of furthest neighbors to search for.
    * @param neighbors Matrix to store resulting neighbors in.
@@ -109,6 +113,15 @@ class DrusillaSelect
   arma::Col<size_t>& CandidateIndices() { return candidateIndices; }
 
  private:
+  /**
+   * Search for the k furthest neighbors of the given (dense) query set, using
+   * matrix products to compute the distances to the candidate points.
+   */
+  void SearchBatched(const MatType& querySet,
+                     const size_t k,
+                     arma::Mat<size_t>& neighbors,
+                     arma::mat& distances);
+
   //! The reference set.
   MatType candidateSet;
   //! Indices of each point in the reference set.
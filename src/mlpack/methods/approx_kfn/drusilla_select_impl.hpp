@@ -177,23 +177,80 @@ void DrusillaSelect<MatType>::Search(const MatType& querySet,
     throw std::invalid_argument("DrusillaSelect::Search(): requested k is "
         "greater than number of points in candidate set!  Increase l or m.");
 
-  // We'll use the NeighborSearchRules class to perform our brute-force search.
-  // Note that we aren't using trees for our search, so we can use 'int' as a
-  // TreeType.
-  EuclideanDistance metric;
-  NeighborSearchRules<FurthestNeighborSort, EuclideanDistance,
-      KDTree<EuclideanDistance, EmptyStatistic, MatType>>
-      rules(candidateSet, querySet, k, metric, 0, false);
-
-  for (size_t q = 0; q < querySet.n_cols; ++q)
-    for (size_t r = 0; r < candidateSet.n_cols; ++r)
-      rules.BaseCase(q, r);
-
-  rules.GetResults(neighbors, distances);
-
-  // Map the neighbors back to their original indices in the reference set.
-  for (size_t i = 0; i < neighbors.n_elem; ++i)
-    neighbors[i] = candidateIndices[neighbors[i]];
+  // Dense query sets are searched with matrix products.
+  if constexpr (!arma::is_SpMat<MatType>::value)
+  {
+    SearchBatched(querySet, k, neighbors, distances);
+  }
+  else
+  {
+    // We'll use the NeighborSearchRules class to perform our brute-force
+    // search.  Note that we aren't using trees for our search, so we can use
+    // 'int' as a TreeType.
+    EuclideanDistance metric;
+    NeighborSearchRules<FurthestNeighborSort, EuclideanDistance,
+        KDTree<EuclideanDistance, EmptyStatistic, MatType>>
+        rules(candidateSet, querySet, k, metric, 0, false);
+
+    for (size_t q = 0; q < querySet.n_cols; ++q)
+      for (size_t r = 0; r < candidateSet.n_cols; ++r)
+        rules.BaseCase(q, r);
+
+    rules.GetResults(neighbors, distances);
+
+    // Map the neighbors back to their original indices in the reference set.
+    for (size_t i = 0; i < neighbors.n_elem; ++i)
+      neighbors[i] = candidateIndices[neighbors[i]];
+  }
+}
+
+template<typename MatType>
+void DrusillaSelect<MatType>::SearchBatched(const MatType& querySet,
+                                            const size_t k,
+                                            arma::Mat<size_t>& neighbors,
+                                            arma::mat& distances)
+{
+  using ElemType = typename MatType::elem_type;
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  // The squared distance between a query point q and a candidate c is
+  // |q|^2 + |c|^2 - 2 q^T c, so the distances between a block of query points
+  // and all candidates can be computed with one matrix product.
+  const arma::Col<ElemType> candidateNorms =
+      arma::sum(arma::square(candidateSet), 0).t();
+  const arma::Row<ElemType> queryNorms = arma::sum(arma::square(querySet), 0);
+
+  const size_t blockSize = 256;
+  const size_t numBlocks = (querySet.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) querySet.n_cols);
+
+    const arma::Mat<ElemType> products = candidateSet.t() *
+        querySet.cols(begin, end - 1);
+    arma::Col<ElemType> sqDistances;
+    for (size_t q = begin; q < end; ++q)
+    {
+      sqDistances = candidateNorms + queryNorms[q] -
+          2 * products.col(q - begin);
+      const arma::uvec order = arma::sort_index(sqDistances, "descend");
+
+      // The expansion of the squared distance is not accurate for close
+      // points, so the distances to the k furthest candidates are computed
+      // directly.
+      for (size_t i = 0; i < k; ++i)
+      {
+        neighbors(i, q) = candidateIndices[order[i]];
+        distances(i, q) = EuclideanDistance::Evaluate(querySet.col(q),
+            candidateSet.col(order[i]));
+      }
+    }
+  }
 }
 
 //! Serialize the model.
@@ -71,6 +71,9 @@ class QDAFN
    * can contain just one point, that is okay.)  The results will be stored in
    * the given neighbors and distances matrices, in the same format as the
    * mlpack NeighborSearch and LSHSearch classes.
+   *
+   * The query points are projected onto all lines at once, and are then
+   * searched in parallel if OpenMP is available.
    */
   void Search(const MatType& querySet,
               const size_t k,
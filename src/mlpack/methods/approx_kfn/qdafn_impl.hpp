@@ -103,7 +103,12 @@ void QDAFN<MatType>::Search(const MatType& querySet,
   neighbors.fill(size_t() - 1);
   distances.zeros(k, querySet.n_cols);
 
-  // Search for each point.
+  // Project all query points onto all lines at once.
+  const arma::mat queryProjections = lines.t() * querySet;
+
+  // Search for each point.  Each query point only writes its own column of the
+  // results, so the query points can be searched in parallel.
+  #pragma omp parallel for schedule(dynamic, 16)
   for (size_t q = 0; q < querySet.n_cols; ++q)
   {
     // Initialize a priority queue.
@@ -112,8 +117,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
     std::priority_queue<std::pair<double, size_t>> queue;
     for (size_t i = 0; i < l; ++i)
     {
-      const double val = sValues(0, i) - dot(querySet.col(q),
-          lines.col(i));
+      const double val = sValues(0, i) - queryProjections(i, q);
       queue.push(std::make_pair(val, i));
     }
 
@@ -128,7 +132,7 @@ void QDAFN<MatType>::Search(const MatType& querySet,
         resultsQueue(std::less<std::pair<double, size_t>>(), std::move(v));
     for (size_t i = 0; i < m; ++i)
     {
-      std::pair<size_t, double> p = queue.top();
+      const std::pair<double, size_t> p = queue.top();
       queue.pop();
 
       // Get index of reference point to look at.
@@ -170,8 +174,8 @@ void QDAFN<MatType>::Search(const MatType& querySet,
       // Avoid inserting any duplicates.
       if (neighbors(extracted - 1, q) != result.second)
       {
-        neighbors(extracted, q) = resultsQueue.top().second;
-        distances(extracted, q) = resultsQueue.top().first;
+        neighbors(extracted, q) = result.second;
+        distances(extracted, q) = result.first;
         ++extracted;
       }
     }
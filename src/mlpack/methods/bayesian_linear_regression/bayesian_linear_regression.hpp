@@ -16,6 +16,7 @@
 #define MLPACK_METHODS_BAYESIAN_LINEAR_REGRESSION_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/methods/linear_regression/normal_equations.hpp>
 
 namespace mlpack {
 
@@ -194,6 +195,19 @@ class BayesianLinearRegression
                  const size_t maxIterations,
                  const double tolerance);
 
+  /**
+   * Run BayesianLinearRegression on the statistics of a dataset, which were
+   * accumulated one chunk at a time (see NormalEquations), instead of on the
+   * dataset itself.  This gives the same model as training on all of the
+   * points at once, with the current settings of CenterData(), ScaleData(),
+   * MaxIterations() and Tolerance(), but the points never have to be held in
+   * memory together.
+   *
+   * @param stats Statistics of the points and responses to train on.
+   * @return Root mean squared error on the accumulated points.
+   */
+  ElemType Train(const NormalEquations<ModelMatType>& stats);
+
   /**
    * Predict \f$y\f$ for a single data point \f$x\f$ using the currently-trained
    * Bayesian ridge regression model.
@@ -410,6 +424,24 @@ class BayesianLinearRegression
   template<typename MatType, typename OutMatType>
   void CenterScaleDataPred(const MatType& data,
                            OutMatType& dataProc) const;
+
+  /**
+   * Find the solution and the hyperparameters by maximizing the evidence,
+   * given the statistics of the processed data phi and responses t.
+   *
+   * @param gram The matrix phi * phi^T.
+   * @param cross The vector phi * t^T.
+   * @param responsesVariance The variance of t.
+   * @param n The number of points.
+   * @param residuals Function that returns the squared norm of
+   *     t - omega^T * phi for the given omega.
+   */
+  template<typename ResidualsFunctionType>
+  void Optimize(const ModelMatType& gram,
+                const DenseVecType& cross,
+                const ElemType responsesVariance,
+                const size_t n,
+                ResidualsFunctionType residuals);
 };
 
 } // namespace mlpack
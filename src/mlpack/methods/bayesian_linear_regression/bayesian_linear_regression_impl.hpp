@@ -103,13 +103,95 @@ BayesianLinearRegression<ModelMatType>::Train(
 
   ModelMatType phi;
   DenseRowType t;
-  DenseVecType eigVal;
-  ModelMatType eigVec;
 
   // Preprocess the data. Center and scale.
   responsesOffset = CenterScaleData(data, responses, phi, t);
 
-  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(phi * phi.t())))
+  Optimize(phi * phi.t(), phi * t.t(), var(t, 1), data.n_cols,
+      [&](const DenseVecType& w)
+      {
+        const DenseRowType temp = t - w.t() * phi;
+        return dot(temp, temp);
+      });
+
+  return RMSE(data, responses);
+}
+
+template<typename ModelMatType>
+inline
+typename BayesianLinearRegression<ModelMatType>::ElemType
+BayesianLinearRegression<ModelMatType>::Train(
+    const NormalEquations<ModelMatType>& stats)
+{
+  if (stats.Count() == 0)
+  {
+    throw std::invalid_argument("BayesianLinearRegression::Train(): no points "
+        "have been accumulated!");
+  }
+
+  const size_t n = stats.Count();
+  const DenseVecType& means = stats.Means();
+
+  // Compute the statistics of the processed data phi and responses t, as
+  // CenterScaleData() would give them.
+  ModelMatType gram = stats.Scatter();
+  DenseVecType cross = stats.Cross();
+  ElemType responsesSquares = stats.ResponsesScatter();
+  if (centerData)
+  {
+    dataOffset = means;
+    responsesOffset = stats.ResponsesMean();
+  }
+  else
+  {
+    responsesOffset = 0;
+    gram += ((ElemType) n) * (means * means.t());
+    cross += ((ElemType) n * stats.ResponsesMean()) * means;
+    responsesSquares += ((ElemType) n) * stats.ResponsesMean() *
+        stats.ResponsesMean();
+  }
+
+  if (scaleData)
+  {
+    dataScale = sqrt(stats.Scatter().diag() / (ElemType) (n - 1));
+    gram.each_col() /= dataScale;
+    gram.each_row() /= dataScale.t();
+    cross /= dataScale;
+  }
+
+  // The squared norm of t - omega^T phi is expanded in terms of the
+  // statistics.
+  Optimize(gram, cross, stats.ResponsesScatter() / n, n,
+      [&](const DenseVecType& w)
+      {
+        return std::max(responsesSquares - 2 * dot(w, cross) +
+            dot(w, gram * w), (ElemType) 0);
+      });
+
+  // The model is affine in the points, so its error follows from the
+  // statistics too.
+  DenseVecType w = omega;
+  if (scaleData)
+    w /= dataScale;
+  const ElemType offset = (centerData) ?
+      responsesOffset - arma::dot(w, dataOffset) : responsesOffset;
+
+  return std::sqrt(stats.MeanSquaredError(w, offset));
+}
+
+template<typename ModelMatType>
+template<typename ResidualsFunctionType>
+inline void BayesianLinearRegression<ModelMatType>::Optimize(
+    const ModelMatType& gram,
+    const DenseVecType& cross,
+    const ElemType responsesVariance,
+    const size_t n,
+    ResidualsFunctionType residuals)
+{
+  DenseVecType eigVal;
+  ModelMatType eigVec;
+
+  if (!arma::eig_sym(eigVal, eigVec, arma::symmatu(gram)))
   {
     Log::Fatal << "BayesianLinearRegression::Train(): Eigendecomposition "
                << "of covariance failed!" << std::endl;
@@ -117,11 +199,11 @@ BayesianLinearRegression<ModelMatType>::Train(
 
   // Compute this quantities once and for all.
   const ModelMatType eigVecInv = inv(eigVec);
-  const DenseVecType eigVecInvPhitT = eigVecInv * phi * t.t();
+  const DenseVecType eigVecInvPhitT = eigVecInv * cross;
 
   // Initialize the hyperparameters and begin with an infinitely broad prior.
   alpha = ((ElemType) 1e-6);
-  beta = ((ElemType) 1 / (var(t, 1) * 0.1));
+  beta = ((ElemType) 1 / (responsesVariance * 0.1));
 
   unsigned short i = 0;
   ElemType crit = ((ElemType) 1.0);
@@ -139,8 +221,7 @@ BayesianLinearRegression<ModelMatType>::Train(
     alpha = gamma / dot(omega, omega);
 
     // Update beta.
-    const DenseRowType temp = t - omega.t() * phi;
-    beta = (data.n_cols - gamma) / dot(temp, temp);
+    beta = (n - gamma) / residuals(omega);
 
     // Compute the stopping criterion.
     deltaAlpha += alpha;
@@ -151,8 +232,6 @@ BayesianLinearRegression<ModelMatType>::Train(
   // Compute the covariance matrix for the uncertainties later.
   matCovariance = eigVec * diagmat(((ElemType) 1) / (beta * eigVal + alpha)) *
       eigVecInv;
-
-  return RMSE(data, responses);
 }
 
 template<typename ModelMatType>
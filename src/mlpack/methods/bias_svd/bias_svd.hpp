@@ -63,10 +63,14 @@ class BiasSVD
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
    * @param lambda Regularization parameter for the optimization.
+   * @param parallel If true, train with lock-free parallel SGD (Hogwild!),
+   *     where every thread updates the factors from its own blocks of the
+   *     shuffled ratings.
    */
   BiasSVD(const size_t iterations = 10,
           const double alpha = 0.02,
-          const double lambda = 0.05);
+          const double lambda = 0.05,
+          const bool parallel = false);
 
   /**
    * Trains the model and obtains user/item matrices and user/item bias.
@@ -92,6 +96,8 @@ class BiasSVD
   double alpha;
   //! Regularization parameter for the optimization.
   double lambda;
+  //! Whether to train with lock-free parallel SGD.
+  bool parallel;
 };
 
 } // namespace mlpack
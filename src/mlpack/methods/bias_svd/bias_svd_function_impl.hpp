@@ -317,55 +317,54 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::RandGen());
 
+    // Hogwild!: each thread takes blocks of threadShareSize ratings of the
+    // shuffled order and updates the parameters without any locks.  Each
+    // update only touches the columns of one user and one item, so the updates
+    // of different threads rarely overlap.
+    const size_t blockSize = std::max(threadShareSize, (size_t) 1);
     #pragma omp parallel
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
       size_t threadId = 0;
+      size_t numThreads = 1;
       #ifdef MLPACK_USE_OPENMP
         threadId = omp_get_thread_num();
+        numThreads = omp_get_num_threads();
       #endif
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      for (size_t start = threadId * blockSize; start < visitationOrder.n_elem;
+          start += numThreads * blockSize)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        double ratingError = rating - userBias - itemBias -
-            dot(iterate.col(user).subvec(0, rank - 1),
-                      iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * iterate.col(user).subvec(0, rank - 1));
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
+        const size_t end = std::min(start + blockSize,
+            (size_t) visitationOrder.n_elem);
+        for (size_t j = start; j < end; ++j)
         {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
+          // Indices for accessing the the correct parameter columns.
+          const size_t user = data(0, visitationOrder[j]);
+          const size_t item = data(1, visitationOrder[j]) + numUsers;
+          double* userCol = iterate.colptr(user);
+          double* itemCol = iterate.colptr(item);
+
+          // Prediction error for the example.
+          double ratingError = data(2, visitationOrder[j]) - userCol[rank] -
+              itemCol[rank];
+          for (size_t k = 0; k < rank; ++k)
+            ratingError -= userCol[k] * itemCol[k];
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          for (size_t k = 0; k < rank; ++k)
+          {
+            const double u = userCol[k];
+            userCol[k] -= stepSize * 2 * (lambda * u -
+                ratingError * itemCol[k]);
+            itemCol[k] -= stepSize * 2 * (lambda * itemCol[k] -
+                ratingError * u);
+          }
+          userCol[rank] -= stepSize * 2 * (lambda * userCol[rank] -
+              ratingError);
+          itemCol[rank] -= stepSize * 2 * (lambda * itemCol[rank] -
+              ratingError);
         }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
       }
     }
   }
@@ -12,5 +12,6 @@
 #define MLPACK_CF_HPP
 
 #include "cf/cf.hpp"
+#include "cf/item_factor_index.hpp"
 
 #endif
@@ -17,6 +17,7 @@
 #define MLPACK_METHODS_CF_CF_HPP
 
 #include <mlpack/core.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/amf/amf.hpp>
@@ -28,6 +29,25 @@
 
 namespace mlpack {
 
+// These give us HasItemFactors<T, U> and HasUserFactors<T, U> types (where U
+// is a function pointer) we can use with SFINAE to catch decomposition policies
+// whose predicted ratings are the products of their W() and H() matrices.
+HAS_MEM_FUNC(W, HasItemFactors);
+HAS_MEM_FUNC(H, HasUserFactors);
+
+// This gives us a HasItemBias<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch decomposition policies with item biases.
+HAS_MEM_FUNC(P, HasItemBias);
+
+// This gives us a HasUserBias<T, U> type (where U is a function pointer) we
+// can use with SFINAE to catch decomposition policies with user biases.
+HAS_MEM_FUNC(Q, HasUserBias);
+
+// This gives us a HasGetUserVector<T, U> type (where U is a function pointer)
+// we can use with SFINAE to catch decomposition policies whose user vectors
+// are not just the columns of H.
+HAS_MEM_FUNC(GetUserVector, HasGetUserVector);
+
 /**
  * This class implements Collaborative Filtering (CF). This implementation
  * presently supports Alternating Least Squares (ALS) for collaborative
@@ -179,6 +199,43 @@ class CFType
   //! Get the normalization object.
   const NormalizationType& Normalization() const { return normalization; }
 
+  /**
+   * Compute the neighborhood of every user once with the given neighbor search
+   * policy, and store it compactly: the IDs of the numUsersForSimilarity
+   * nearest neighbors of each user as 32-bit integers and their similarities
+   * as single-precision floats.  After this, GetRecommendations() and
+   * Predict() with the same NeighborSearchPolicy (and no more neighbors than
+   * are stored) read the neighborhoods of the queried users from the table
+   * and hand them to the InterpolationPolicy, instead of searching for them.
+   * The table is serialized with the model.  Train(), FoldInUser(),
+   * FoldInItem() and Refine() discard it, since they change the neighborhoods.
+   *
+   * The neighbor search policy is identified by its std::type_info name, so
+   * a model saved by a program built with a different compiler may have to
+   * rebuild its table.
+   *
+   * @tparam NeighborSearchPolicy The policy used to search neighbors.
+   */
+  template<typename NeighborSearchPolicy = EuclideanSearch>
+  void CacheNeighborhoods();
+
+  //! Discard the table built by CacheNeighborhoods().
+  void ClearNeighborhoodCache()
+  {
+    cachedNeighbors.reset();
+    cachedSimilarities.reset();
+    cachedSearch.clear();
+  }
+
+  //! Get the cached neighbors of each user (one column per user; empty if
+  //! CacheNeighborhoods() was not called).
+  const arma::Mat<arma::u32>& CachedNeighbors() const
+  {
+    return cachedNeighbors;
+  }
+  //! Get the cached similarities of the neighbors of each user.
+  const arma::fmat& CachedSimilarities() const { return cachedSimilarities; }
+
   /**
    * Generates the given number of recommendations for all users.
    *
@@ -203,6 +260,12 @@ class CFType
    * @tparam InterpolationPolicy The policy used to calculate interpolation
    *     weights.
    *
+   * The users are processed in parallel, in blocks of BlockSize users.  If
+   * the predicted ratings of the decomposition are the products of its W() and
+   * H() matrices (plus its item and user biases, if it has them), then the
+   * ratings of all items for a block are computed with one matrix
+   * multiplication of W() by the interpolated user vectors of the block.
+   *
    * @param numRecs Number of Recommendations.
    * @param recommendations Matrix to save recommendations.
    * @param users Users for which recommendations are to be generated.
@@ -245,6 +308,10 @@ class CFType
    * @tparam InterpolationPolicy The policy used to calculate interpolation
    *     weights.
    *
+   * The users of the combinations are processed in parallel, and the
+   * interpolated user vector of each user is only computed once for all of its
+   * combinations, if the decomposition allows it.
+   *
    * @param combinations User/item combinations to predict.
    * @param predictions Predicted ratings for each user/item combination.
    */
@@ -253,11 +320,64 @@ class CFType
   void Predict(const arma::Mat<size_t>& combinations,
                arma::vec& predictions) const;
 
+  /**
+   * Add a new user to the trained model without retraining it.  The factor of
+   * the user is the regularized least-squares fit of its normalized ratings
+   * with the item factors held fixed (along with a user bias, if the
+   * decomposition has one), and its ratings are added to the rating matrix,
+   * so that recommendations and predictions can be made for it right away.
+   * The ID of the new user is the number of users before the call.
+   *
+   * This requires a decomposition whose predicted ratings are the products of
+   * its modifiable W() and H() matrices (plus biases); for any other
+   * decomposition (such as SVDPlusPlusPolicy), std::invalid_argument is
+   * thrown.
+   *
+   * @param ratings Ratings of the new user, as a table with two rows (item,
+   *     rating) and one column for each rating.
+   * @param lambda Regularization parameter of the least-squares fit.
+   * @return The ID of the new user.
+   */
+  size_t FoldInUser(const arma::mat& ratings, const double lambda = 0.01);
+
+  /**
+   * Add a new item to the trained model without retraining it.  The factor of
+   * the item is the regularized least-squares fit of its normalized ratings
+   * with the user factors held fixed (along with an item bias, if the
+   * decomposition has one), and its ratings are added to the rating matrix.
+   * The ID of the new item is the number of items before the call.  The same
+   * requirements as for FoldInUser() apply.
+   *
+   * @param ratings Ratings of the new item, as a table with two rows (user,
+   *     rating) and one column for each rating.
+   * @param lambda Regularization parameter of the least-squares fit.
+   * @return The ID of the new item.
+   */
+  size_t FoldInItem(const arma::mat& ratings, const double lambda = 0.01);
+
+  /**
+   * Refine the factors of the given users and items only, for example after
+   * several users and items were folded in.  Each epoch fits the factor of
+   * every given user to its ratings with the item factors fixed, and then the
+   * factor of every given item with the user factors fixed, in parallel.  The
+   * factors of all other users and items are left unchanged.  The same
+   * requirements as for FoldInUser() apply.
+   *
+   * @param users Users whose factors are refined.
+   * @param items Items whose factors are refined.
+   * @param epochs Number of epochs.
+   * @param lambda Regularization parameter of the least-squares fits.
+   */
+  void Refine(const arma::Col<size_t>& users,
+              const arma::Col<size_t>& items,
+              const size_t epochs = 1,
+              const double lambda = 0.01);
+
   /**
    * Serialize the CFType model to the given archive.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
  private:
   //! Number of users for similarity.
@@ -270,6 +390,135 @@ class CFType
   arma::sp_mat cleanedData;
   //! Data normalization object.
   NormalizationType normalization;
+  //! Cached neighbors of each user, if CacheNeighborhoods() was called.
+  arma::Mat<arma::u32> cachedNeighbors;
+  //! Cached similarities of the neighbors of each user.
+  arma::fmat cachedSimilarities;
+  //! Name of the neighbor search policy that built the cache.
+  std::string cachedSearch;
+
+  //! Number of users whose ratings are computed together by
+  //! GetRecommendations().
+  static constexpr size_t BlockSize = 64;
+
+  //! Whether the predicted ratings of the decomposition are the products of
+  //! its W() and H() matrices, plus its item and user biases if it has them.
+  static constexpr bool HasFactors = HasItemFactors<DecompositionPolicy,
+      const arma::mat&(DecompositionPolicy::*)() const>::value &&
+      HasUserFactors<DecompositionPolicy,
+      const arma::mat&(DecompositionPolicy::*)() const>::value;
+
+  //! Whether the decomposition has an item bias P() and a user bias Q().
+  static constexpr bool HasBiases = HasItemBias<DecompositionPolicy,
+      const arma::vec&(DecompositionPolicy::*)() const>::value &&
+      HasUserBias<DecompositionPolicy,
+      const arma::vec&(DecompositionPolicy::*)() const>::value;
+
+  //! Whether new users and items can be folded into the decomposition: its
+  //! factors (and biases) can be modified, and the factor of a user does not
+  //! depend on the items that the user rated.
+  static constexpr bool SupportsFoldIn = HasFactors &&
+      HasItemFactors<DecompositionPolicy,
+      arma::mat&(DecompositionPolicy::*)()>::value &&
+      HasUserFactors<DecompositionPolicy,
+      arma::mat&(DecompositionPolicy::*)()>::value &&
+      !HasGetUserVector<DecompositionPolicy,
+      void(DecompositionPolicy::*)(const size_t, arma::vec&) const>::value &&
+      (!HasBiases || (HasItemBias<DecompositionPolicy,
+      arma::vec&(DecompositionPolicy::*)()>::value &&
+      HasUserBias<DecompositionPolicy,
+      arma::vec&(DecompositionPolicy::*)()>::value));
+
+  /**
+   * Interpolate the user vectors of the neighbors of a user with the given
+   * weights.  The interpolated rating of item i is then
+   * `W().row(i) * userVec + weightSum * P()(i) + bias`, where the item bias
+   * P() is zero if the decomposition has none.  This is only used when
+   * HasFactors is true.
+   *
+   * @param neighbors Neighbors of the user.
+   * @param weights Interpolation weights of the neighbors.
+   * @param userVec Resulting interpolated user vector.
+   * @param weightSum Resulting sum of the weights.
+   * @param bias Resulting interpolated user bias.
+   */
+  void InterpolateUserVector(const arma::Col<size_t>& neighbors,
+                             const arma::vec& weights,
+                             arma::vec& userVec,
+                             double& weightSum,
+                             double& bias) const;
+
+  /**
+   * Compute the interpolated ratings of all items for the given users.
+   *
+   * @param neighborhood Neighbors of each user, one column per user.
+   * @param weights Interpolation weights of the neighbors of each user.
+   * @param begin Index of the first user.
+   * @param count Number of users.
+   * @param ratings Resulting ratings, one column per user.
+   */
+  void GetBlockRatings(const arma::Mat<size_t>& neighborhood,
+                       const arma::mat& weights,
+                       const size_t begin,
+                       const size_t count,
+                       arma::mat& ratings) const;
+
+  /**
+   * Fit the factor of a user to the given normalized ratings with the item
+   * factors held fixed, or the factor of an item with the user factors held
+   * fixed.  The fixed biases are subtracted from the ratings first, and the
+   * bias of the fitted factor is fit along with it if the decomposition has
+   * biases.  This is only used when SupportsFoldIn is true.
+   *
+   * @param fixed Fixed factors, one column for each rating.
+   * @param fixedBias Fixed biases, one for each rating.
+   * @param ratings Normalized ratings.
+   * @param lambda Regularization parameter.
+   * @param factor Resulting factor.
+   * @param bias Resulting bias (zero if the decomposition has no biases).
+   */
+  static void FitFactor(const arma::mat& fixed,
+                        const arma::vec& fixedBias,
+                        const arma::vec& ratings,
+                        const double lambda,
+                        arma::vec& factor,
+                        double& bias);
+
+  /**
+   * Fit the factors of the given columns of the rating matrix (users of
+   * cleanedData, or items of its transpose) with the factors of its rows held
+   * fixed, in parallel.  Columns without ratings are left unchanged.
+   *
+   * @param data Rating matrix.
+   * @param columns Columns whose factors are fit.
+   * @param fixed Fixed factors of the rows, one per column.
+   * @param fixedBias Fixed biases of the rows (empty if none).
+   * @param lambda Regularization parameter.
+   * @param factors Factors of the columns, one per column.
+   * @param biases Biases of the columns (unused if the decomposition has no
+   *     biases).
+   */
+  static void FitColumns(const arma::sp_mat& data,
+                         const arma::Col<size_t>& columns,
+                         const arma::mat& fixed,
+                         const arma::vec& fixedBias,
+                         const double lambda,
+                         arma::mat& factors,
+                         arma::vec& biases);
+
+  /**
+   * Get the neighborhoods of the given users, from the cache built by
+   * CacheNeighborhoods() if it was built with the same neighbor search policy
+   * and holds enough neighbors, and from the decomposition otherwise.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param neighborhood Neighbors of each user, one column per user.
+   * @param similarities Similarities of the neighbors of each user.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const;
 
   //! Candidate represents a possible recommendation (value, item).
   using Candidate = std::pair<double, size_t>;
@@ -287,6 +536,10 @@ using CF = CFType<>;
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename DecompositionPolicy,
+                               typename NormalizationType),
+    (mlpack::CFType<DecompositionPolicy, NormalizationType>), (1));
+
 // Include implementation of templated functions.
 #include "cf_impl.hpp"
 
@@ -83,6 +83,7 @@ Train(const arma::mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearNeighborhoodCache();
 
   // Make a copy of data before performing normalization.
   arma::mat normalizedData(data);
@@ -122,6 +123,7 @@ Train(const arma::sp_mat& data,
       const bool mit)
 {
   this->decomposition = decomposition;
+  ClearNeighborhoodCache();
 
   // data is not used in the following decomposition.Apply() method, so we only
   // need to Normalize cleanedData.
@@ -190,78 +192,99 @@ GetRecommendations(const size_t numRecs,
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
   // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
 
   // Generate recommendations for each query user by finding the maximum numRecs
   // elements in the ratings vector.
   recommendations.set_size(numRecs, users.n_elem);
-  arma::mat values(numRecs, users.n_elem);
   recommendations.fill(SIZE_MAX);
-  values.fill(DBL_MAX);
 
   // Initialization of an InterpolationPolicy object should be put ahead of the
   // following loop, because the initialization may takes a relatively long
   // time and we don't want to repeat the initialization process in each loop.
   InterpolationPolicy interpolation(cleanedData);
 
+  // Calculate interpolation weights.  Interpolation policies may cache what
+  // they compute, so this is done for all users before the parallel loop.
+  arma::mat weights(numUsersForSimilarity, users.n_elem);
   for (size_t i = 0; i < users.n_elem; ++i)
   {
-    // First, calculate the weighted sum of neighborhood values.
-    arma::vec ratings;
-    ratings.zeros(cleanedData.n_rows);
-
-    // Calculate interpolation weights.
-    arma::vec weights(numUsersForSimilarity);
-    interpolation.GetWeights(weights, decomposition, users(i),
+    interpolation.GetWeights(weights.col(i), decomposition, users(i),
         neighborhood.col(i), similarities.col(i), cleanedData);
+  }
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
-    {
-      arma::vec neighborRatings;
-      decomposition.GetRatingOfUser(neighborhood(j, i), neighborRatings);
-      ratings += weights(j) * neighborRatings;
-    }
+  // Make sure that the CSC arrays are up to date before reading them from
+  // several threads.
+  cleanedData.sync();
+  const arma::uword* colPtrs = cleanedData.col_ptrs;
+  const arma::uword* rowIndices = cleanedData.row_indices;
 
-    // Let's build the list of candidate recomendations for the given user.
-    // Default candidate: the smallest possible value and invalid item number.
-    const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
-    std::vector<Candidate> vect(numRecs, def);
-    using CandidateList =
-        std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>;
-    CandidateList pqueue(CandidateCmp(), std::move(vect));
+  // Default candidate: the smallest possible value and invalid item number.
+  const Candidate def = std::make_pair(-DBL_MAX, cleanedData.n_rows);
+  const size_t numBlocks = (users.n_elem + BlockSize - 1) / BlockSize;
 
-    // Look through the ratings column corresponding to the current user.
-    for (size_t j = 0; j < ratings.n_rows; ++j)
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t block = 0; block < numBlocks; ++block)
+  {
+    // First, calculate the weighted sum of neighborhood values for every user
+    // of the block.
+    const size_t begin = block * BlockSize;
+    const size_t count = std::min(BlockSize, (size_t) users.n_elem - begin);
+    arma::mat ratings;
+    GetBlockRatings(neighborhood, weights, begin, count, ratings);
+
+    for (size_t b = 0; b < count; ++b)
     {
-      // Ensure that the user hasn't already rated the item.
-      // The algorithm omits rating of zero. Thus, when normalizing original
-      // ratings in Normalize(), if normalized rating equals zero, it is set
-      // to the smallest positive double value.
-      if (cleanedData(j, users(i)) != 0.0)
-        continue; // The user already rated the item.
-
-      // Is the estimated value better than the worst candidate?
-      // Denormalize rating before comparison.
-      double realRating = normalization.Denormalize(users(i), j, ratings[j]);
-      if (realRating > pqueue.top().first)
+      const size_t i = begin + b;
+
+      // Let's build the list of candidate recomendations for the given user.
+      std::vector<Candidate> vect(numRecs, def);
+      using CandidateList =
+          std::priority_queue<Candidate, std::vector<Candidate>, CandidateCmp>;
+      CandidateList pqueue(CandidateCmp(), std::move(vect));
+
+      // The items that the user already rated are the row indices of its
+      // column, in increasing order.  The algorithm omits rating of zero.
+      // Thus, when normalizing original ratings in Normalize(), if normalized
+      // rating equals zero, it is set to the smallest positive double value.
+      arma::uword k = colPtrs[users(i)];
+      const arma::uword end = colPtrs[users(i) + 1];
+
+      // Look through the ratings column corresponding to the current user.
+      for (size_t j = 0; j < ratings.n_rows; ++j)
       {
-        Candidate c = std::make_pair(realRating, j);
-        pqueue.pop();
-        pqueue.push(c);
+        // Ensure that the user hasn't already rated the item.
+        if (k < end && rowIndices[k] == j)
+        {
+          ++k;
+          continue; // The user already rated the item.
+        }
+
+        // Is the estimated value better than the worst candidate?
+        // Denormalize rating before comparison.
+        double realRating = normalization.Denormalize(users(i), j,
+            ratings(j, b));
+        if (realRating > pqueue.top().first)
+        {
+          Candidate c = std::make_pair(realRating, j);
+          pqueue.pop();
+          pqueue.push(c);
+        }
       }
-    }
 
-    for (size_t p = 1; p <= numRecs; p++)
-    {
-      recommendations(numRecs - p, i) = pqueue.top().second;
-      values(numRecs - p, i) = pqueue.top().first;
-      pqueue.pop();
+      for (size_t p = 1; p <= numRecs; p++)
+      {
+        recommendations(numRecs - p, i) = pqueue.top().second;
+        pqueue.pop();
+      }
     }
+  }
 
-    // If we were not able to come up with enough recommendations, issue a
-    // warning.
-    if (recommendations(numRecs - 1, i) == def.second)
+  // If we were not able to come up with enough recommendations, issue a
+  // warning.
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    if (numRecs > 0 && recommendations(numRecs - 1, i) == def.second)
       Log::Warn << "Could not provide " << numRecs << " recommendations "
           << "for user " << users(i) << " (not enough un-rated items)!"
           << std::endl;
@@ -292,8 +315,7 @@ Predict(const size_t user, const size_t item) const
   // Calculate the neighborhood of the queried users.
   arma::Col<size_t> users(1);
   users(0) = user;
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
 
   arma::vec weights(numUsersForSimilarity);
 
@@ -343,8 +365,7 @@ Predict(const arma::Mat<size_t>& combinations,
   // weighted sum of both the query user and the local neighborhood of the
   // query user.
   // Calculate the neighborhood of the queried users.
-  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
-      users, numUsersForSimilarity, neighborhood, similarities);
+  GetNeighborhood<NeighborSearchPolicy>(users, neighborhood, similarities);
 
   arma::mat weights(numUsersForSimilarity, users.n_elem);
 
@@ -356,33 +377,273 @@ Predict(const arma::Mat<size_t>& combinations,
         neighborhood.col(i), similarities.col(i), cleanedData);
   }
 
-  // Now that we have the neighborhoods we need, calculate the predictions.
-  predictions.set_size(combinations.n_cols);
-
+  // Find the first sorted combination of each user.
+  arma::Col<size_t> userStarts(users.n_elem + 1);
   size_t user = 0; // Cumulative user count, because we are doing it in order.
   for (size_t i = 0; i < sortedCombinations.n_cols; ++i)
   {
-    // Could this be made faster by calculating dot products for multiple items
-    // at once?
-    double rating = 0.0;
-
     // Map the combination's user to the user ID used for kNN.
     while (users[user] < sortedCombinations(0, i))
-      ++user;
+      userStarts[++user] = i;
+  }
+  userStarts[0] = 0;
+  userStarts[users.n_elem] = sortedCombinations.n_cols;
+
+  // Now that we have the neighborhoods we need, calculate the predictions.
+  predictions.set_size(combinations.n_cols);
 
-    for (size_t j = 0; j < neighborhood.n_rows; ++j)
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t u = 0; u < (size_t) users.n_elem; ++u)
+  {
+    if constexpr (HasFactors)
     {
-      rating += weights(j, user) * decomposition.GetRating(
-          neighborhood(j, user), sortedCombinations(1, i));
-    }
+      // Interpolate the user vector once for all the items of the user.
+      arma::vec userVec;
+      double weightSum, bias;
+      InterpolateUserVector(neighborhood.col(u), weights.col(u), userVec,
+          weightSum, bias);
 
-    predictions(ordering[i]) = rating;
+      for (size_t i = userStarts[u]; i < userStarts[u + 1]; ++i)
+      {
+        const size_t item = sortedCombinations(1, i);
+        double rating = arma::as_scalar(decomposition.W().row(item) *
+            userVec) + bias;
+        if constexpr (HasItemBias<DecompositionPolicy,
+            const arma::vec&(DecompositionPolicy::*)() const>::value)
+        {
+          rating += weightSum * decomposition.P()(item);
+        }
+
+        predictions(ordering[i]) = rating;
+      }
+    }
+    else
+    {
+      for (size_t i = userStarts[u]; i < userStarts[u + 1]; ++i)
+      {
+        double rating = 0.0;
+        for (size_t j = 0; j < neighborhood.n_rows; ++j)
+        {
+          rating += weights(j, u) * decomposition.GetRating(
+              neighborhood(j, u), sortedCombinations(1, i));
+        }
+
+        predictions(ordering[i]) = rating;
+      }
+    }
   }
 
   // Denormalize ratings.
   normalization.Denormalize(combinations, predictions);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+CacheNeighborhoods()
+{
+  ClearNeighborhoodCache();
+  if (cleanedData.n_cols > std::numeric_limits<arma::u32>::max())
+  {
+    Log::Warn << "CFType::CacheNeighborhoods(): too many users to store their "
+        << "IDs in 32 bits; not caching neighborhoods." << std::endl;
+    return;
+  }
+
+  const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0,
+      cleanedData.n_cols - 1, cleanedData.n_cols);
+  arma::Mat<size_t> neighborhood;
+  arma::mat similarities;
+  decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+      users, numUsersForSimilarity, neighborhood, similarities);
+
+  cachedNeighbors = arma::conv_to<arma::Mat<arma::u32>>::from(neighborhood);
+  cachedSimilarities = arma::conv_to<arma::fmat>::from(similarities);
+  cachedSearch = typeid(NeighborSearchPolicy).name();
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+size_t CFType<DecompositionPolicy,
+              NormalizationType>::
+FoldInUser(const arma::mat& ratings, const double lambda)
+{
+  if constexpr (!SupportsFoldIn)
+  {
+    throw std::invalid_argument("CFType::FoldInUser(): the decomposition does "
+        "not support folding in new users!");
+  }
+  else
+  {
+    if (ratings.n_rows != 2 || ratings.n_cols == 0)
+    {
+      throw std::invalid_argument("CFType::FoldInUser(): ratings must have two "
+          "rows (item, rating) and at least one column!");
+    }
+    if ((size_t) max(ratings.row(0)) >= cleanedData.n_rows)
+    {
+      throw std::invalid_argument("CFType::FoldInUser(): ratings contain an "
+          "unknown item!");
+    }
+
+    ClearNeighborhoodCache();
+
+    // Normalize the ratings like the training data.
+    const size_t user = cleanedData.n_cols;
+    arma::mat data(3, ratings.n_cols);
+    data.row(0).fill(user);
+    data.rows(1, 2) = ratings;
+    normalization.FoldIn(data);
+
+    const arma::uvec items = arma::conv_to<arma::uvec>::from(data.row(1));
+    arma::vec itemBias;
+    if constexpr (HasBiases)
+      itemBias = decomposition.P().elem(items);
+
+    arma::vec factor;
+    double bias;
+    FitFactor(decomposition.W().rows(items).t(), itemBias, data.row(2).t(),
+        lambda, factor, bias);
+
+    decomposition.H().insert_cols(user, factor);
+    if constexpr (HasBiases)
+    {
+      decomposition.Q().resize(user + 1);
+      decomposition.Q()(user) = bias;
+    }
+
+    // Add the ratings to the rating matrix.
+    arma::umat locations(2, data.n_cols);
+    locations.row(0) = items.t();
+    locations.row(1).fill(user);
+    cleanedData.resize(cleanedData.n_rows, user + 1);
+    cleanedData += arma::sp_mat(locations, data.row(2).t(), cleanedData.n_rows,
+        cleanedData.n_cols);
+
+    return user;
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+size_t CFType<DecompositionPolicy,
+              NormalizationType>::
+FoldInItem(const arma::mat& ratings, const double lambda)
+{
+  if constexpr (!SupportsFoldIn)
+  {
+    throw std::invalid_argument("CFType::FoldInItem(): the decomposition does "
+        "not support folding in new items!");
+  }
+  else
+  {
+    if (ratings.n_rows != 2 || ratings.n_cols == 0)
+    {
+      throw std::invalid_argument("CFType::FoldInItem(): ratings must have two "
+          "rows (user, rating) and at least one column!");
+    }
+    if ((size_t) max(ratings.row(0)) >= cleanedData.n_cols)
+    {
+      throw std::invalid_argument("CFType::FoldInItem(): ratings contain an "
+          "unknown user!");
+    }
+
+    ClearNeighborhoodCache();
+
+    // Normalize the ratings like the training data.
+    const size_t item = cleanedData.n_rows;
+    arma::mat data(3, ratings.n_cols);
+    data.row(0) = ratings.row(0);
+    data.row(1).fill(item);
+    data.row(2) = ratings.row(1);
+    normalization.FoldIn(data);
+
+    const arma::uvec users = arma::conv_to<arma::uvec>::from(data.row(0));
+    arma::vec userBias;
+    if constexpr (HasBiases)
+      userBias = decomposition.Q().elem(users);
+
+    arma::vec factor;
+    double bias;
+    FitFactor(decomposition.H().cols(users), userBias, data.row(2).t(),
+        lambda, factor, bias);
+
+    decomposition.W().insert_rows(item, factor.t());
+    if constexpr (HasBiases)
+    {
+      decomposition.P().resize(item + 1);
+      decomposition.P()(item) = bias;
+    }
+
+    // Add the ratings to the rating matrix.
+    arma::umat locations(2, data.n_cols);
+    locations.row(0).fill(item);
+    locations.row(1) = users.t();
+    cleanedData.resize(item + 1, cleanedData.n_cols);
+    cleanedData += arma::sp_mat(locations, data.row(2).t(), cleanedData.n_rows,
+        cleanedData.n_cols);
+
+    return item;
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+Refine(const arma::Col<size_t>& users,
+       const arma::Col<size_t>& items,
+       const size_t epochs,
+       const double lambda)
+{
+  if constexpr (!SupportsFoldIn)
+  {
+    throw std::invalid_argument("CFType::Refine(): the decomposition does not "
+        "support refining its factors!");
+  }
+  else
+  {
+    if (users.n_elem > 0 && max(users) >= cleanedData.n_cols)
+      throw std::invalid_argument("CFType::Refine(): unknown user!");
+    if (items.n_elem > 0 && max(items) >= cleanedData.n_rows)
+      throw std::invalid_argument("CFType::Refine(): unknown item!");
+
+    ClearNeighborhoodCache();
+
+    // Each user and each item is only fit once in every epoch.
+    const arma::Col<size_t> uniqueUsers = arma::unique(users);
+    const arma::Col<size_t> uniqueItems = arma::unique(items);
+    // The users of each item are the columns of the transposed rating matrix.
+    const arma::sp_mat itemData = cleanedData.t();
+
+    arma::vec itemBias, userBias;
+    if constexpr (HasBiases)
+    {
+      itemBias = decomposition.P();
+      userBias = decomposition.Q();
+    }
+
+    // The item factors are held as columns while they are fit.
+    arma::mat wt = decomposition.W().t();
+    for (size_t e = 0; e < epochs; ++e)
+    {
+      FitColumns(cleanedData, uniqueUsers, wt, itemBias, lambda,
+          decomposition.H(), userBias);
+      FitColumns(itemData, uniqueItems, decomposition.H(), userBias, lambda,
+          wt, itemBias);
+    }
+
+    decomposition.W() = wt.t();
+    if constexpr (HasBiases)
+    {
+      decomposition.P() = itemBias;
+      decomposition.Q() = userBias;
+    }
+  }
+}
+
 template<typename DecompositionPolicy,
          typename NormalizationType>
 void CFType<DecompositionPolicy,
@@ -416,13 +677,209 @@ CleanData(const arma::mat& data, arma::sp_mat& cleanedData)
   cleanedData = arma::sp_mat(locations, values, maxItemID, maxUserID);
 }
 
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+InterpolateUserVector(const arma::Col<size_t>& neighbors,
+                      const arma::vec& weights,
+                      arma::vec& userVec,
+                      double& weightSum,
+                      double& bias) const
+{
+  userVec.zeros(decomposition.W().n_cols);
+  weightSum = 0.0;
+  bias = 0.0;
+
+  arma::vec neighborVec;
+  for (size_t j = 0; j < neighbors.n_elem; ++j)
+  {
+    if constexpr (HasGetUserVector<DecompositionPolicy,
+        void(DecompositionPolicy::*)(const size_t, arma::vec&) const>::value)
+    {
+      decomposition.GetUserVector(neighbors(j), neighborVec);
+      userVec += weights(j) * neighborVec;
+    }
+    else
+    {
+      userVec += weights(j) * decomposition.H().col(neighbors(j));
+    }
+
+    if constexpr (HasUserBias<DecompositionPolicy,
+        const arma::vec&(DecompositionPolicy::*)() const>::value)
+    {
+      bias += weights(j) * decomposition.Q()(neighbors(j));
+    }
+
+    weightSum += weights(j);
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetBlockRatings(const arma::Mat<size_t>& neighborhood,
+                const arma::mat& weights,
+                const size_t begin,
+                const size_t count,
+                arma::mat& ratings) const
+{
+  if constexpr (HasFactors)
+  {
+    // The interpolated ratings are linear in the user vectors, so interpolate
+    // the user vectors and multiply them all by W() at once.
+    arma::mat userVecs(decomposition.W().n_cols, count);
+    arma::rowvec weightSums(count);
+    arma::rowvec biases(count);
+    arma::vec userVec;
+    for (size_t b = 0; b < count; ++b)
+    {
+      InterpolateUserVector(neighborhood.col(begin + b),
+          weights.col(begin + b), userVec, weightSums[b], biases[b]);
+      userVecs.col(b) = userVec;
+    }
+
+    ratings = decomposition.W() * userVecs;
+    ratings.each_row() += biases;
+    if constexpr (HasItemBias<DecompositionPolicy,
+        const arma::vec&(DecompositionPolicy::*)() const>::value)
+    {
+      ratings += decomposition.P() * weightSums;
+    }
+  }
+  else
+  {
+    ratings.zeros(cleanedData.n_rows, count);
+    arma::vec neighborRatings;
+    for (size_t b = 0; b < count; ++b)
+    {
+      for (size_t j = 0; j < neighborhood.n_rows; ++j)
+      {
+        decomposition.GetRatingOfUser(neighborhood(j, begin + b),
+            neighborRatings);
+        ratings.col(b) += weights(j, begin + b) * neighborRatings;
+      }
+    }
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FitFactor(const arma::mat& fixed,
+          const arma::vec& fixedBias,
+          const arma::vec& ratings,
+          const double lambda,
+          arma::vec& factor,
+          double& bias)
+{
+  arma::vec target = ratings;
+  if constexpr (HasBiases)
+    target -= fixedBias;
+
+  // The bias is fit along with the factor, as the coefficient of an extra
+  // fixed dimension that is always one.
+  const size_t n = fixed.n_rows + (HasBiases ? 1 : 0);
+  arma::mat a(n, fixed.n_cols);
+  a.rows(0, fixed.n_rows - 1) = fixed;
+  if constexpr (HasBiases)
+    a.row(fixed.n_rows).ones();
+
+  arma::mat gram = a * a.t();
+  gram.diag() += lambda;
+  arma::vec x;
+  if (!arma::solve(x, gram, a * target))
+    x.zeros(n);
+
+  factor = x.head(fixed.n_rows);
+  bias = HasBiases ? x[fixed.n_rows] : 0.0;
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+FitColumns(const arma::sp_mat& data,
+           const arma::Col<size_t>& columns,
+           const arma::mat& fixed,
+           const arma::vec& fixedBias,
+           const double lambda,
+           arma::mat& factors,
+           arma::vec& biases)
+{
+  // Make sure that the CSC arrays are up to date before reading them from
+  // several threads.
+  data.sync();
+  const arma::uword* colPtrs = data.col_ptrs;
+  const arma::uword* rowIndices = data.row_indices;
+  const double* values = data.values;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < (size_t) columns.n_elem; ++i)
+  {
+    const size_t j = columns[i];
+    const arma::uword begin = colPtrs[j];
+    const arma::uword count = colPtrs[j + 1] - begin;
+    if (count == 0)
+      continue;
+
+    const arma::uvec rows(rowIndices + begin, count);
+    arma::vec rowBias;
+    if constexpr (HasBiases)
+      rowBias = fixedBias.elem(rows);
+
+    arma::vec factor;
+    double bias;
+    FitFactor(fixed.cols(rows), rowBias, arma::vec(values + begin, count),
+        lambda, factor, bias);
+
+    factors.col(j) = factor;
+    if constexpr (HasBiases)
+      biases[j] = bias;
+  }
+}
+
+template<typename DecompositionPolicy,
+         typename NormalizationType>
+template<typename NeighborSearchPolicy>
+void CFType<DecompositionPolicy,
+            NormalizationType>::
+GetNeighborhood(const arma::Col<size_t>& users,
+                arma::Mat<size_t>& neighborhood,
+                arma::mat& similarities) const
+{
+  if (cachedSearch != typeid(NeighborSearchPolicy).name() ||
+      cachedNeighbors.n_rows < numUsersForSimilarity ||
+      cachedNeighbors.n_cols != cleanedData.n_cols)
+  {
+    decomposition.template GetNeighborhood<NeighborSearchPolicy>(
+        users, numUsersForSimilarity, neighborhood, similarities);
+    return;
+  }
+
+  // The cached neighbors of each user are sorted by similarity, so the first
+  // numUsersForSimilarity of them are its neighborhood.
+  neighborhood.set_size(numUsersForSimilarity, users.n_elem);
+  similarities.set_size(numUsersForSimilarity, users.n_elem);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    for (size_t j = 0; j < numUsersForSimilarity; ++j)
+    {
+      neighborhood(j, i) = cachedNeighbors(j, users[i]);
+      similarities(j, i) = cachedSimilarities(j, users[i]);
+    }
+  }
+}
+
 //! Serialize the model.
 template<typename DecompositionPolicy,
          typename NormalizationType>
 template<typename Archive>
 void CFType<DecompositionPolicy,
             NormalizationType>::
-serialize(Archive& ar, const uint32_t /* version */)
+serialize(Archive& ar, const uint32_t version)
 {
   // This model is simple; just serialize all the members. No special handling
   // required.
@@ -431,6 +888,18 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(decomposition));
   ar(CEREAL_NVP(cleanedData));
   ar(CEREAL_NVP(normalization));
+
+  // Older versions did not cache neighborhoods.
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    ClearNeighborhoodCache();
+  }
+  else
+  {
+    ar(CEREAL_NVP(cachedNeighbors));
+    ar(CEREAL_NVP(cachedSimilarities));
+    ar(CEREAL_NVP(cachedSearch));
+  }
 }
 
 } // namespace mlpack
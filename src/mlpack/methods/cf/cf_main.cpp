@@ -75,6 +75,9 @@ BINDING_LONG_DESC(
     " - 'RandSVD' -- RandomizedSVD learning\n"
     " - 'QSVD' -- QuicSVD learning\n"
     " - 'BKSVD' -- Block Krylov SVD learning\n"
+    " - 'ALS' -- Implicit-feedback alternating least squares, which treats "
+    "ratings as confidence that a user prefers an item and solves for users "
+    "and items in parallel\n"
     "\n\n"
     "The following neighbor search algorithms can be specified via" +
     " the " + PRINT_PARAM_STRING("neighbor_search") + " parameter:\n"
@@ -195,7 +198,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   RequireParamInSet<string>(params, "algorithm", { "NMF", "BatchSVD",
       "SVDIncompleteIncremental", "SVDCompleteIncremental", "RegSVD",
-      "RandSVD", "BiasSVD", "SVDPP", "QSVD", "BKSVD" }, true,
+      "RandSVD", "BiasSVD", "SVDPP", "QSVD", "BKSVD", "ALS" }, true,
       "unknown algorithm");
 
   ReportIgnoredParam(params, {{ "iteration_only_termination", true }},
@@ -294,6 +297,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
           "when max_iterations is reached");
       cf->DecompositionType() = CFModel::BLOCK_KRYLOV_SVD;
     }
+    else if (algo == "ALS")
+    {
+      cf->DecompositionType() = CFModel::ALS;
+    }
 
     // Perform the factorization and do whatever the user wanted.
     const size_t neighborhood = (size_t) params.Get<int>("neighborhood");
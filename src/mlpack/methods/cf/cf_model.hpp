@@ -77,6 +77,21 @@ class CFWrapperBase
       const size_t numRecs,
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users) = 0;
+
+  //! Cache the neighborhoods of all users.
+  virtual void CacheNeighborhoods(const NeighborSearchTypes nsType) = 0;
+
+  //! Add a new user to the model, and return its ID.
+  virtual size_t FoldInUser(const arma::mat& ratings, const double lambda) = 0;
+
+  //! Add a new item to the model, and return its ID.
+  virtual size_t FoldInItem(const arma::mat& ratings, const double lambda) = 0;
+
+  //! Refine the factors of the given users and items.
+  virtual void Refine(const arma::Col<size_t>& users,
+                      const arma::Col<size_t>& items,
+                      const size_t epochs,
+                      const double lambda) = 0;
 };
 
 /**
@@ -143,6 +158,30 @@ class CFWrapper : public CFWrapperBase
       arma::Mat<size_t>& recommendations,
       const arma::Col<size_t>& users);
 
+  //! Cache the neighborhoods of all users.
+  virtual void CacheNeighborhoods(const NeighborSearchTypes nsType);
+
+  //! Add a new user to the model, and return its ID.
+  virtual size_t FoldInUser(const arma::mat& ratings, const double lambda)
+  {
+    return cf.FoldInUser(ratings, lambda);
+  }
+
+  //! Add a new item to the model, and return its ID.
+  virtual size_t FoldInItem(const arma::mat& ratings, const double lambda)
+  {
+    return cf.FoldInItem(ratings, lambda);
+  }
+
+  //! Refine the factors of the given users and items.
+  virtual void Refine(const arma::Col<size_t>& users,
+                      const arma::Col<size_t>& items,
+                      const size_t epochs,
+                      const double lambda)
+  {
+    cf.Refine(users, items, epochs, lambda);
+  }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -172,7 +211,8 @@ class CFModel
     BIAS_SVD,
     SVD_PLUS_PLUS,
     QUIC_SVD,
-    BLOCK_KRYLOV_SVD
+    BLOCK_KRYLOV_SVD,
+    ALS
   };
 
   enum NormalizationTypes
@@ -268,6 +308,49 @@ class CFModel
                           const size_t numRecs,
                           arma::Mat<size_t>& recommendations);
 
+  /**
+   * Compute and store the neighborhoods of all users with the given neighbor
+   * search, so that predictions and recommendations with the same neighbor
+   * search do not have to search for them; see CFType::CacheNeighborhoods().
+   *
+   * @param nsType Neighbor search to cache the neighborhoods of.
+   */
+  void CacheNeighborhoods(const NeighborSearchTypes nsType);
+
+  /**
+   * Add a new user to the trained model without retraining it; see
+   * CFType::FoldInUser().  This is not supported by SVD_PLUS_PLUS.
+   *
+   * @param ratings Ratings of the new user, as (item, rating) columns.
+   * @param lambda Regularization parameter of the least-squares fit.
+   * @return The ID of the new user.
+   */
+  size_t FoldInUser(const arma::mat& ratings, const double lambda = 0.01);
+
+  /**
+   * Add a new item to the trained model without retraining it; see
+   * CFType::FoldInItem().  This is not supported by SVD_PLUS_PLUS.
+   *
+   * @param ratings Ratings of the new item, as (user, rating) columns.
+   * @param lambda Regularization parameter of the least-squares fit.
+   * @return The ID of the new item.
+   */
+  size_t FoldInItem(const arma::mat& ratings, const double lambda = 0.01);
+
+  /**
+   * Refine the factors of the given users and items only; see
+   * CFType::Refine().  This is not supported by SVD_PLUS_PLUS.
+   *
+   * @param users Users whose factors are refined.
+   * @param items Items whose factors are refined.
+   * @param epochs Number of epochs.
+   * @param lambda Regularization parameter of the least-squares fits.
+   */
+  void Refine(const arma::Col<size_t>& users,
+              const arma::Col<size_t>& items,
+              const size_t epochs = 1,
+              const double lambda = 0.01);
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -283,6 +283,27 @@ void CFWrapper<DecompositionPolicy, NormalizationPolicy>::GetRecommendations(
   }
 }
 
+//! Cache the neighborhoods of all users.
+template<typename DecompositionPolicy, typename NormalizationPolicy>
+void CFWrapper<DecompositionPolicy, NormalizationPolicy>::CacheNeighborhoods(
+    const NeighborSearchTypes nsType)
+{
+  switch (nsType)
+  {
+    case COSINE_SEARCH:
+      cf.template CacheNeighborhoods<CosineSearch>();
+      break;
+
+    case EUCLIDEAN_SEARCH:
+      cf.template CacheNeighborhoods<EuclideanSearch>();
+      break;
+
+    case PEARSON_SEARCH:
+      cf.template CacheNeighborhoods<PearsonSearch>();
+      break;
+  }
+}
+
 template<typename DecompositionPolicy>
 CFWrapperBase* InitializeModelHelper(
     CFModel::NormalizationTypes normalizationType)
@@ -344,6 +365,9 @@ inline CFWrapperBase* InitializeModel(
 
     case CFModel::BLOCK_KRYLOV_SVD:
       return InitializeModelHelper<BlockKrylovSVDPolicy>(normalizationType);
+
+    case CFModel::ALS:
+      return InitializeModelHelper<ALSPolicy>(normalizationType);
   }
 
   // This shouldn't ever happen.
@@ -466,6 +490,11 @@ inline void CFModel::Train(
       cf = TrainHelper(BlockKrylovSVDPolicy(), normalizationType, data,
           numUsersForSimilarity, rank, maxIterations, minResidue, mit);
       break;
+
+    case ALS:
+      cf = TrainHelper(ALSPolicy(), normalizationType, data,
+          numUsersForSimilarity, rank, maxIterations, minResidue, mit);
+      break;
   }
 }
 
@@ -501,6 +530,35 @@ inline void CFModel::GetRecommendations(
   cf->GetRecommendations(nsType, interpolationType, numRecs, recommendations);
 }
 
+//! Cache the neighborhoods of all users.
+inline void CFModel::CacheNeighborhoods(const NeighborSearchTypes nsType)
+{
+  cf->CacheNeighborhoods(nsType);
+}
+
+//! Add a new user to the model.
+inline size_t CFModel::FoldInUser(const arma::mat& ratings,
+                                  const double lambda)
+{
+  return cf->FoldInUser(ratings, lambda);
+}
+
+//! Add a new item to the model.
+inline size_t CFModel::FoldInItem(const arma::mat& ratings,
+                                  const double lambda)
+{
+  return cf->FoldInItem(ratings, lambda);
+}
+
+//! Refine the factors of the given users and items.
+inline void CFModel::Refine(const arma::Col<size_t>& users,
+                            const arma::Col<size_t>& items,
+                            const size_t epochs,
+                            const double lambda)
+{
+  cf->Refine(users, items, epochs, lambda);
+}
+
 template<typename Archive>
 void CFModel::serialize(Archive& ar, const uint32_t /* version */)
 {
@@ -556,6 +614,10 @@ void CFModel::serialize(Archive& ar, const uint32_t /* version */)
     case BLOCK_KRYLOV_SVD:
       SerializeHelper<BlockKrylovSVDPolicy>(ar, cf, normalizationType);
       break;
+
+    case ALS:
+      SerializeHelper<ALSPolicy>(ar, cf, normalizationType);
+      break;
   }
 }
 
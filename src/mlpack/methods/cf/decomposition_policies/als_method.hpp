@@ -0,0 +1,283 @@
+/**
+ * @file methods/cf/decomposition_policies/als_method.hpp
+ *
+ * Implementation of implicit-feedback alternating least squares for use in
+ * Collaborative Filtering.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+
+#ifndef MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+#define MLPACK_METHODS_CF_DECOMPOSITION_POLICIES_ALS_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Implementation of the implicit-feedback alternating least squares (ALS)
+ * policy, as described in the following paper:
+ *
+ * @code
+ * @inproceedings{hu2008collaborative,
+ *   title={{Collaborative Filtering for Implicit Feedback Datasets}},
+ *   author={Hu, Y. and Koren, Y. and Volinsky, C.},
+ *   booktitle={Proceedings of the 2008 Eighth IEEE International Conference on
+ *       Data Mining (ICDM '08)},
+ *   pages={263--272},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * Every rating `r` is treated as an observation that the user prefers the item
+ * (if `r > 0`), with confidence `1 + alpha * |r|`; every unobserved rating is
+ * an observation that the user does not prefer the item, with confidence 1.
+ * The item matrix W and the user matrix H are found by minimizing the
+ * confidence-weighted squared error of the preferences plus `lambda` times
+ * the squared norms of the factors, by solving for all users with the items
+ * fixed and then for all items with the users fixed.
+ *
+ * Each user (or item) is an independent least-squares problem, so they are
+ * solved in parallel with OpenMP.  The Gram matrix of the fixed factors is
+ * computed once per half-iteration, so that each problem only takes time
+ * proportional to its number of ratings (times rank^2) plus one rank x rank
+ * solve, read straight from the columns of the sparse rating matrix.  The
+ * predicted ratings are the predicted preferences, which are best used to rank
+ * items.
+ *
+ * An example of how to use ALSPolicy in CF is shown below:
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * // Users for whom recommendations are generated.
+ * extern arma::Col<size_t> users;
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<ALSPolicy> cf(data);
+ *
+ * // Generate 10 recommendations for all users.
+ * cf.GetRecommendations(10, recommendations);
+ * @endcode
+ */
+class ALSPolicy
+{
+ public:
+  /**
+   * Use implicit-feedback ALS to perform collaborative filtering.
+   *
+   * @param lambda Regularization parameter.
+   * @param alpha Rate at which the confidence grows with the rating.
+   */
+  ALSPolicy(const double lambda = 0.1, const double alpha = 40.0) :
+      lambda(lambda),
+      alpha(alpha)
+  {
+    /* Nothing to do here */
+  }
+
+  /**
+   * Apply Collaborative Filtering to the provided dataset using implicit
+   * ALS.
+   *
+   * @param * (data) Data matrix: dense matrix (coordinate lists)
+   *    or sparse matrix (cleaned).
+   * @param cleanedData item user table in form of sparse matrix.
+   * @param rank Rank parameter for matrix factorization.
+   * @param maxIterations Maximum number of iterations.
+   * @param minResidue Residue required to terminate.
+   * @param mit Whether to terminate only when maxIterations is reached.
+   */
+  template<typename MatType>
+  void Apply(const MatType& /* data */,
+             const arma::sp_mat& cleanedData,
+             const size_t rank,
+             const size_t maxIterations,
+             const double minResidue,
+             const bool mit)
+  {
+    // The items of each user are the columns of cleanedData, and the users of
+    // each item are the columns of its transpose.
+    const arma::sp_mat itemData = cleanedData.t();
+
+    // The item factors are held as columns during the iterations.
+    arma::mat wt(rank, cleanedData.n_rows, arma::fill::randu);
+    wt *= 0.01;
+    h.zeros(rank, cleanedData.n_cols);
+
+    double oldNorm = 0.0;
+    for (size_t i = 0; i < maxIterations; ++i)
+    {
+      SolveFactors(cleanedData, wt, h);
+      SolveFactors(itemData, h, wt);
+
+      if (!mit)
+      {
+        // Stop when the norm of W * H changes by less than minResidue, like
+        // SimpleResidueTermination; ||W H||_F^2 = trace(W^T W H H^T).
+        const double norm = std::sqrt(std::max(
+            arma::accu((wt * wt.t()) % (h * h.t())), 0.0));
+        const double residue = std::abs(norm - oldNorm) / oldNorm;
+        oldNorm = norm;
+        if (i > 0 && residue < minResidue)
+          break;
+      }
+    }
+
+    w = wt.t();
+  }
+
+  /**
+   * Return predicted rating given user ID and item ID.
+   *
+   * @param user User ID.
+   * @param item Item ID.
+   */
+  double GetRating(const size_t user, const size_t item) const
+  {
+    double rating = arma::as_scalar(w.row(item) * h.col(user));
+    return rating;
+  }
+
+  /**
+   * Get predicted ratings for a user.
+   *
+   * @param user User ID.
+   * @param rating Resulting rating vector.
+   */
+  void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    rating = w * h.col(user);
+  }
+
+  /**
+   * Get the neighborhood and corresponding similarities for a set of users.
+   *
+   * @tparam NeighborSearchPolicy The policy to perform neighbor search.
+   *
+   * @param users Users whose neighborhood is to be computed.
+   * @param numUsersForSimilarity The number of neighbors returned for
+   *     each user.
+   * @param neighborhood Neighbors represented by user IDs.
+   * @param similarities Similarity between each user and each of its
+   *     neighbors.
+   */
+  template<typename NeighborSearchPolicy>
+  void GetNeighborhood(const arma::Col<size_t>& users,
+                       const size_t numUsersForSimilarity,
+                       arma::Mat<size_t>& neighborhood,
+                       arma::mat& similarities) const
+  {
+    // We want to avoid calculating the full rating matrix, so we will do
+    // nearest neighbor search only on the H matrix, using the observation that
+    // if the rating matrix X = W*H, then d(X.col(i), X.col(j)) = d(W H.col(i),
+    // W H.col(j)).  This can be seen as nearest neighbor search on the H
+    // matrix with the Mahalanobis distance where M^{-1} = W^T W.  So, we'll
+    // decompose M^{-1} = L L^T (the Cholesky decomposition), and then multiply
+    // H by L^T. Then we can perform nearest neighbor search.
+    arma::mat l = arma::chol(w.t() * w);
+    arma::mat stretchedH = l * h; // Due to the Armadillo API, l is L^T.
+
+    // Temporarily store feature vector of queried users.
+    arma::mat query(stretchedH.n_rows, users.n_elem);
+    // Select feature vectors of queried users.
+    for (size_t i = 0; i < users.n_elem; ++i)
+      query.col(i) = stretchedH.col(users(i));
+
+    NeighborSearchPolicy neighborSearch(stretchedH);
+    neighborSearch.Search(
+        query, numUsersForSimilarity, neighborhood, similarities);
+  }
+
+  //! Get the Item Matrix.
+  const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
+  //! Get the User Matrix.
+  const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
+
+  //! Get regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the rate at which the confidence grows with the rating.
+  double Alpha() const { return alpha; }
+  //! Modify the rate at which the confidence grows with the rating.
+  double& Alpha() { return alpha; }
+
+  /**
+   * Serialization.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(lambda));
+    ar(CEREAL_NVP(alpha));
+    ar(CEREAL_NVP(w));
+    ar(CEREAL_NVP(h));
+  }
+
+ private:
+  /**
+   * Solve for the factors of every column of the given rating matrix, with
+   * the factors of its rows fixed.
+   *
+   * @param data Rating matrix; column j holds the ratings of column factor j.
+   * @param fixed Factors of the rows of the rating matrix, one per column.
+   * @param factors Factors to solve for, one per column of the rating matrix.
+   */
+  void SolveFactors(const arma::sp_mat& data,
+                    const arma::mat& fixed,
+                    arma::mat& factors) const
+  {
+    // Unobserved ratings have confidence 1, so their contribution is the Gram
+    // matrix of all fixed factors, minus that of the observed ones.
+    arma::mat gram = fixed * fixed.t();
+    gram.diag() += lambda;
+
+    // Make sure that the CSC arrays are up to date before reading them from
+    // several threads.
+    data.sync();
+    const arma::uword* colPtrs = data.col_ptrs;
+    const arma::uword* rowIndices = data.row_indices;
+    const double* values = data.values;
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t j = 0; j < (size_t) data.n_cols; ++j)
+    {
+      arma::mat a(gram);
+      arma::vec b(fixed.n_rows, arma::fill::zeros);
+      for (arma::uword k = colPtrs[j]; k < colPtrs[j + 1]; ++k)
+      {
+        const double confidence = 1.0 + alpha * std::abs(values[k]);
+        const auto y = fixed.col(rowIndices[k]);
+        a += (confidence - 1.0) * y * y.t();
+        if (values[k] > 0.0)
+          b += confidence * y;
+      }
+
+      arma::vec x;
+      if (!arma::solve(x, a, b))
+        x.zeros(fixed.n_rows);
+      factors.col(j) = x;
+    }
+  }
+
+  //! Regularization parameter.
+  double lambda;
+  //! Rate at which the confidence grows with the rating.
+  double alpha;
+  //! Item matrix.
+  arma::mat w;
+  //! User matrix.
+  arma::mat h;
+};
+
+} // namespace mlpack
+
+#endif
@@ -46,13 +46,16 @@ class BiasSVDPolicy
    * @param maxIterations Number of iterations.
    * @param alpha Learning rate for optimization.
    * @param lambda Regularization parameter for optimization.
+   * @param parallel Whether to train with lock-free parallel SGD.
    */
   BiasSVDPolicy(const size_t maxIterations = 10,
                 const double alpha = 0.02,
-                const double lambda = 0.05) :
+                const double lambda = 0.05,
+                const bool parallel = false) :
       maxIterations(maxIterations),
       alpha(alpha),
-      lambda(lambda)
+      lambda(lambda),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -77,7 +80,7 @@ class BiasSVDPolicy
              const bool /* mit */)
   {
     // Perform decomposition using the bias SVD algorithm.
-    BiasSVD<> biassvd(maxIterations, alpha, lambda);
+    BiasSVD<> biassvd(maxIterations, alpha, lambda, parallel);
     biassvd.Apply(data, rank, w, h, p, q);
   }
 
@@ -137,12 +140,20 @@ class BiasSVDPolicy
 
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
   //! Get the User Bias Vector.
   const arma::vec& Q() const { return q; }
+  //! Modify the User Bias Vector.
+  arma::vec& Q() { return q; }
   //! Get the Item Bias Vector.
   const arma::vec& P() const { return p; }
+  //! Modify the Item Bias Vector.
+  arma::vec& P() { return p; }
 
   //! Get the number of iterations.
   size_t MaxIterations() const { return maxIterations; }
@@ -159,6 +170,11 @@ class BiasSVDPolicy
   //! Modify regularization parameter.
   double& Lambda() { return lambda; }
 
+  //! Get whether to train with lock-free parallel SGD.
+  bool Parallel() const { return parallel; }
+  //! Modify whether to train with lock-free parallel SGD.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -181,6 +197,8 @@ class BiasSVDPolicy
   double alpha;
   //! Regularization parameter for optimization.
   double lambda;
+  //! Whether to train with lock-free parallel SGD.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
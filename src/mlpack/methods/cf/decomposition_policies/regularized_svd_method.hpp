@@ -45,9 +45,12 @@ class RegSVDPolicy
    *
    * @param maxIterations Number of iterations for the power method
    *        (Default: 10).
+   * @param parallel Whether to train with lock-free parallel SGD.
    */
-  RegSVDPolicy(const size_t maxIterations = 10) :
-      maxIterations(maxIterations)
+  RegSVDPolicy(const size_t maxIterations = 10,
+               const bool parallel = false) :
+      maxIterations(maxIterations),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -72,7 +75,7 @@ class RegSVDPolicy
              const bool /* mit */)
   {
     // Do singular value decomposition using the regularized SVD algorithm.
-    RegularizedSVD<> regsvd(maxIterations);
+    RegularizedSVD<> regsvd(maxIterations, 0.01, 0.02, parallel);
     regsvd.Apply(data, rank, w, h);
   }
 
@@ -140,14 +143,23 @@ class RegSVDPolicy
 
   //! Get the Item Matrix.
   const arma::mat& W() const { return w; }
+  //! Modify the Item Matrix.
+  arma::mat& W() { return w; }
   //! Get the User Matrix.
   const arma::mat& H() const { return h; }
+  //! Modify the User Matrix.
+  arma::mat& H() { return h; }
 
   //! Get the number of iterations.
   size_t MaxIterations() const { return maxIterations; }
   //! Modify the number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get whether to train with lock-free parallel SGD.
+  bool Parallel() const { return parallel; }
+  //! Modify whether to train with lock-free parallel SGD.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -161,6 +173,8 @@ class RegSVDPolicy
  private:
   //! Locally stored number of iterations.
   size_t maxIterations;
+  //! Whether to train with lock-free parallel SGD.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
@@ -46,13 +46,16 @@ class SVDPlusPlusPolicy
    * @param maxIterations Number of iterations.
    * @param alpha Learning rate for optimization.
    * @param lambda Regularization parameter for optimization.
+   * @param parallel Whether to train with lock-free parallel SGD.
    */
   SVDPlusPlusPolicy(const size_t maxIterations = 10,
                     const double alpha = 0.001,
-                    const double lambda = 0.1) :
+                    const double lambda = 0.1,
+                    const bool parallel = false) :
       maxIterations(maxIterations),
       alpha(alpha),
-      lambda(lambda)
+      lambda(lambda),
+      parallel(parallel)
   {
     /* Nothing to do here */
   }
@@ -76,7 +79,7 @@ class SVDPlusPlusPolicy
              const double /* minResidue */,
              const bool /* mit */)
   {
-    SVDPlusPlus<> svdpp(maxIterations, alpha, lambda);
+    SVDPlusPlus<> svdpp(maxIterations, alpha, lambda, parallel);
 
     // Save implicit data in the form of sparse matrix.
     arma::mat implicitDenseData = data.submat(0, 0, 1, data.n_cols - 1);
@@ -94,20 +97,8 @@ class SVDPlusPlusPolicy
    */
   double GetRating(const size_t user, const size_t item) const
   {
-    // Iterate through each item which the user interacted with to calculate
-    // user vector.
-    arma::vec userVec(h.n_rows);
-    arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-    arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-    size_t implicitCount = 0;
-    for (; it != it_end; ++it)
-    {
-      userVec += y.col(it.row());
-      implicitCount += 1;
-    }
-    if (implicitCount != 0)
-      userVec /= std::sqrt(implicitCount);
-    userVec += h.col(user);
+    arma::vec userVec;
+    GetUserVector(user, userVec);
 
     double rating =
         arma::as_scalar(w.row(item) * userVec) + p(item) + q(user);
@@ -121,10 +112,27 @@ class SVDPlusPlusPolicy
    * @param rating Resulting rating vector.
    */
   void GetRatingOfUser(const size_t user, arma::vec& rating) const
+  {
+    arma::vec userVec;
+    GetUserVector(user, userVec);
+
+    rating = w * userVec + p + q(user);
+  }
+
+  /**
+   * Get the latent vector of a user, which is the sum of the user's column of
+   * H and the normalized sum of the implicit vectors of the items the user
+   * interacted with.  The predicted rating of item i is then
+   * W.row(i) * userVec + P()(i) + Q()(user).
+   *
+   * @param user User ID.
+   * @param userVec Resulting user vector.
+   */
+  void GetUserVector(const size_t user, arma::vec& userVec) const
   {
     // Iterate through each item which the user interacted with to calculate
     // user vector.
-    arma::vec userVec(h.n_rows);
+    userVec.zeros(h.n_rows);
     arma::sp_mat::const_iterator it = implicitData.begin_col(user);
     arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
     size_t implicitCount = 0;
@@ -136,8 +144,6 @@ class SVDPlusPlusPolicy
     if (implicitCount != 0)
       userVec /= std::sqrt(implicitCount);
     userVec += h.col(user);
-
-    rating = w * userVec + p + q(user);
   }
 
   /**
@@ -198,6 +204,11 @@ class SVDPlusPlusPolicy
   //! Modify regularization parameter.
   double& Lambda() { return lambda; }
 
+  //! Get whether to train with lock-free parallel SGD.
+  bool Parallel() const { return parallel; }
+  //! Modify whether to train with lock-free parallel SGD.
+  bool& Parallel() { return parallel; }
+
   /**
    * Serialization.
    */
@@ -222,6 +233,8 @@ class SVDPlusPlusPolicy
   double alpha;
   //! Regularization parameter for optimization.
   double lambda;
+  //! Whether to train with lock-free parallel SGD.
+  bool parallel;
   //! Item matrix.
   arma::mat w;
   //! User matrix.
@@ -0,0 +1,126 @@
+/**
+ * @file methods/cf/item_factor_index.hpp
+ *
+ * Definition of the ItemFactorIndex class, which recommends items to users by
+ * maximum inner product search over the item factors of a trained CF model.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_ITEM_FACTOR_INDEX_HPP
+#define MLPACK_METHODS_CF_ITEM_FACTOR_INDEX_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/fastmks/fastmks.hpp>
+
+#include "cf.hpp"
+
+namespace mlpack {
+
+/**
+ * The ItemFactorIndex class recommends items to users straight from the
+ * factors of a trained CFType model, instead of by interpolating the ratings
+ * of the neighborhood of each user like CFType::GetRecommendations().  The
+ * predicted rating of an item by a user is an inner product of the item's
+ * factor and the user's factor (plus terms that depend only on the item or
+ * only on the user), so the items with the largest predicted ratings are
+ * found with FastMKS and the linear kernel over the item factors.  The tree
+ * over the items is built once, and each user then takes time sublinear in
+ * the number of items (for well-behaved factors) instead of
+ * O(items * rank).
+ *
+ * The item factors are the rows of the decomposition's W() matrix, with one
+ * extra dimension holding the terms that only depend on the item: the item
+ * bias P() of the decomposition, if it has one, and the item part of the
+ * denormalization (all normalizations are affine in the rating).  The user
+ * factors are the columns of H(), or are given by the decomposition's
+ * GetUserVector() function if it has one, with an extra dimension of 1.
+ *
+ * The results are the items that the user has not rated with the largest
+ * denormalized predicted rating, that is, the largest
+ * `cf.Normalization().Denormalize(user, item, rating)` for
+ * `rating = cf.Decomposition().GetRating(user, item)`.
+ *
+ * @code
+ * extern arma::mat data; // data is a (user, item, rating) table.
+ * arma::Mat<size_t> recommendations; // Resulting recommendations.
+ *
+ * CFType<RegSVDPolicy> cf(data);
+ * ItemFactorIndex<CFType<RegSVDPolicy>> index(cf);
+ *
+ * // Generate 10 recommendations for all users.
+ * index.GetRecommendations(10, recommendations);
+ * @endcode
+ *
+ * @tparam CFModelType Type of the CFType model.
+ */
+template<typename CFModelType>
+class ItemFactorIndex
+{
+ public:
+  /**
+   * Create an empty index.  Call Train() before GetRecommendations().
+   */
+  ItemFactorIndex() : cf(nullptr) { }
+
+  /**
+   * Build the index over the items of the given trained model.  The model
+   * must outlive the index, and the index must be rebuilt if the model is
+   * retrained.
+   *
+   * @param cf Trained CF model.
+   */
+  ItemFactorIndex(const CFModelType& cf);
+
+  /**
+   * Build the index over the items of the given trained model, replacing any
+   * index already held.  The model must outlive the index, and the index
+   * must be rebuilt if the model is retrained.
+   *
+   * @param cf Trained CF model.
+   */
+  void Train(const CFModelType& cf);
+
+  /**
+   * Generate recommendations for every user.
+   *
+   * @param numRecs Number of recommendations for each user.
+   * @param recommendations Matrix to save recommendations into; column i holds
+   *     the recommendations of user i, best first.
+   */
+  void GetRecommendations(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations);
+
+  /**
+   * Generate recommendations for the given users.
+   *
+   * @param numRecs Number of recommendations for each user.
+   * @param recommendations Matrix to save recommendations into; column i holds
+   *     the recommendations of users(i), best first.
+   * @param users Users to generate recommendations for.
+   */
+  void GetRecommendations(const size_t numRecs,
+                          arma::Mat<size_t>& recommendations,
+                          const arma::Col<size_t>& users);
+
+  //! Get the FastMKS object that searches the items.
+  const FastMKS<LinearKernel>& Index() const { return fastmks; }
+
+ private:
+  //! Get the query vector of the given user.
+  void UserVector(const size_t user, arma::vec& userVec) const;
+
+  //! The model whose items are indexed.
+  const CFModelType* cf;
+  //! The search over the item factors.
+  FastMKS<LinearKernel> fastmks;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "item_factor_index_impl.hpp"
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * @file methods/cf/item_factor_index_impl.hpp
+ *
+ * Implementation of the ItemFactorIndex class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_CF_ITEM_FACTOR_INDEX_IMPL_HPP
+#define MLPACK_METHODS_CF_ITEM_FACTOR_INDEX_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "item_factor_index.hpp"
+
+namespace mlpack {
+
+template<typename CFModelType>
+ItemFactorIndex<CFModelType>::ItemFactorIndex(const CFModelType& cf) :
+    cf(nullptr)
+{
+  Train(cf);
+}
+
+template<typename CFModelType>
+void ItemFactorIndex<CFModelType>::Train(const CFModelType& cf)
+{
+  this->cf = &cf;
+
+  using DecompositionType =
+      std::remove_cv_t<std::remove_reference_t<decltype(cf.Decomposition())>>;
+  const arma::mat& w = cf.Decomposition().W();
+  const size_t rank = w.n_cols;
+
+  // Every normalization is affine in the rating, so the item part of the
+  // denormalization, relative to the scale of the rating, is a term that only
+  // depends on the item.
+  const double base = cf.Normalization().Denormalize(0, 0, 0.0);
+  double scale = cf.Normalization().Denormalize(0, 0, 1.0) - base;
+  if (scale <= 0.0)
+    scale = 1.0;
+
+  arma::mat items(rank + 1, w.n_rows);
+  items.rows(0, rank - 1) = w.t();
+  for (size_t i = 0; i < w.n_rows; ++i)
+  {
+    items(rank, i) = (cf.Normalization().Denormalize(0, i, 0.0) - base) /
+        scale;
+  }
+
+  if constexpr (HasItemBias<DecompositionType,
+      const arma::vec&(DecompositionType::*)() const>::value)
+  {
+    items.row(rank) += cf.Decomposition().P().t();
+  }
+
+  fastmks.Train(std::move(items));
+}
+
+template<typename CFModelType>
+void ItemFactorIndex<CFModelType>::GetRecommendations(
+    const size_t numRecs,
+    arma::Mat<size_t>& recommendations)
+{
+  if (!cf)
+  {
+    throw std::invalid_argument("ItemFactorIndex::GetRecommendations(): no "
+        "model given; call Train() first!");
+  }
+
+  const arma::Col<size_t> users = arma::linspace<arma::Col<size_t>>(0,
+      cf->CleanedData().n_cols - 1, cf->CleanedData().n_cols);
+  GetRecommendations(numRecs, recommendations, users);
+}
+
+template<typename CFModelType>
+void ItemFactorIndex<CFModelType>::GetRecommendations(
+    const size_t numRecs,
+    arma::Mat<size_t>& recommendations,
+    const arma::Col<size_t>& users)
+{
+  if (!cf)
+  {
+    throw std::invalid_argument("ItemFactorIndex::GetRecommendations(): no "
+        "model given; call Train() first!");
+  }
+
+  const arma::sp_mat& cleanedData = cf->CleanedData();
+  const size_t numItems = cf->Decomposition().W().n_rows;
+
+  // The items the user already rated are skipped, so search for enough extra
+  // items to skip all of them.
+  arma::mat queries(cf->Decomposition().W().n_cols + 1, users.n_elem);
+  size_t maxRated = 0;
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    maxRated = std::max(maxRated, (size_t) (cleanedData.col_ptrs[users(i) + 1] -
+        cleanedData.col_ptrs[users(i)]));
+
+    arma::vec userVec;
+    UserVector(users(i), userVec);
+    queries.col(i).head(userVec.n_elem) = userVec;
+    queries(userVec.n_elem, i) = 1.0;
+  }
+
+  const size_t k = std::min(numRecs + maxRated, numItems);
+  arma::Mat<size_t> indices;
+  arma::mat products;
+  fastmks.Search(queries, k, indices, products);
+
+  recommendations.set_size(numRecs, users.n_elem);
+  recommendations.fill(cleanedData.n_rows);
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    size_t found = 0;
+    for (size_t j = 0; j < k && found < numRecs; ++j)
+    {
+      const size_t item = indices(j, i);
+      if (item == SIZE_MAX)
+        break;
+
+      // Ensure that the user hasn't already rated the item.
+      if (item < cleanedData.n_rows && cleanedData(item, users(i)) != 0.0)
+        continue;
+
+      recommendations(found++, i) = item;
+    }
+
+    // If we were not able to come up with enough recommendations, issue a
+    // warning.
+    if (found < numRecs)
+      Log::Warn << "Could not provide " << numRecs << " recommendations "
+          << "for user " << users(i) << " (not enough un-rated items)!"
+          << std::endl;
+  }
+}
+
+template<typename CFModelType>
+void ItemFactorIndex<CFModelType>::UserVector(const size_t user,
+                                              arma::vec& userVec) const
+{
+  using DecompositionType =
+      std::remove_cv_t<std::remove_reference_t<decltype(cf->Decomposition())>>;
+  if constexpr (HasGetUserVector<DecompositionType,
+      void(DecompositionType::*)(const size_t, arma::vec&) const>::value)
+  {
+    cf->Decomposition().GetUserVector(user, userVec);
+  }
+  else
+  {
+    userVec = cf->Decomposition().H().col(user);
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -59,6 +59,18 @@ class CombinedNormalization
     SequenceNormalize<0>(data);
   }
 
+  /**
+   * Normalize the ratings of new users or items by calling FoldIn() in each
+   * normalization object, in the same order as Normalize().
+   *
+   * @param data Ratings of new users or items.
+   */
+  template<typename MatType>
+  void FoldIn(MatType& data)
+  {
+    SequenceFoldIn<0>(data);
+  }
+
   /**
    * Denormalize rating by calling Denormalize() in each normalization object.
    * Note that the order of objects calling Denormalize() should be the
@@ -129,6 +141,25 @@ class CombinedNormalization
       typename = void>
   void SequenceNormalize(MatType& /* data */) { }
 
+  //! Unpack normalizations tuple to normalize new ratings.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename MatType,
+      typename = std::enable_if_t<(I < std::tuple_size<TupleType>::value)>>
+  void SequenceFoldIn(MatType& data)
+  {
+    std::get<I>(normalizations).FoldIn(data);
+    SequenceFoldIn<I + 1>(data);
+  }
+
+  //! End of tuple unpacking.
+  template<
+      int I, /* Which normalization in tuple to use */
+      typename MatType,
+      typename = std::enable_if_t<(I >= std::tuple_size<TupleType>::value)>,
+      typename = void>
+  void SequenceFoldIn(MatType& /* data */) { }
+
   //! Unpack normalizations tuple to denormalize.
   template<
       int I, /* Which normalization in tuple to use */
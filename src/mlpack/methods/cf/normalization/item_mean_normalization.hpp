@@ -119,6 +119,51 @@ class ItemMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of new users or items by subtracting item mean
+   * from each of them.  The mean of every item that Normalize() did not
+   * see is computed from its ratings in the given data; the means of the
+   * other items are left unchanged.
+   *
+   * @param data Ratings of new users or items in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldNum = itemMean.n_elem;
+    const size_t itemNum = std::max((size_t) max(data.row(1)) + 1,
+        oldNum);
+    itemMean.resize(itemNum);
+    // Number of ratings for each new item.
+    arma::Row<size_t> ratingNum(itemNum);
+
+    // Sum ratings for each new item.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      if (item >= oldNum)
+      {
+        itemMean(item) += datapoint(2);
+        ratingNum(item) += 1;
+      }
+    });
+
+    for (size_t i = oldNum; i < itemNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        itemMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t item = (size_t) datapoint(1);
+      datapoint(2) -= itemMean(item);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive float value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<float>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding item mean.
    *
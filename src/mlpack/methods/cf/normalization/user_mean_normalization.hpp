@@ -119,6 +119,51 @@ class UserMeanNormalization
     }
   }
 
+  /**
+   * Normalize the ratings of new users or items by subtracting user mean
+   * from each of them.  The mean of every user that Normalize() did not
+   * see is computed from its ratings in the given data; the means of the
+   * other users are left unchanged.
+   *
+   * @param data Ratings of new users or items in the form of coordinate list.
+   */
+  void FoldIn(arma::mat& data)
+  {
+    const size_t oldNum = userMean.n_elem;
+    const size_t userNum = std::max((size_t) max(data.row(0)) + 1,
+        oldNum);
+    userMean.resize(userNum);
+    // Number of ratings for each new user.
+    arma::Row<size_t> ratingNum(userNum);
+
+    // Sum ratings for each new user.
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      if (user >= oldNum)
+      {
+        userMean(user) += datapoint(2);
+        ratingNum(user) += 1;
+      }
+    });
+
+    for (size_t i = oldNum; i < userNum; ++i)
+    {
+      if (ratingNum(i) != 0)
+        userMean(i) /= ratingNum(i);
+    }
+
+    data.each_col([&](arma::vec& datapoint)
+    {
+      const size_t user = (size_t) datapoint(0);
+      datapoint(2) -= userMean(user);
+      // The algorithm omits rating of zero. If normalized rating equals zero,
+      // it is set to the smallest positive double value.
+      if (datapoint(2) == 0)
+        datapoint(2) = std::numeric_limits<double>::min();
+    });
+  }
+
   /**
    * Denormalize computed rating by adding user mean.
    *
@@ -16,11 +16,33 @@
 #include <mlpack/core.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "random_point_selection.hpp"
 #include "ordered_point_selection.hpp"
 
 namespace mlpack {
 
+/**
+ * Whether the given range search type finds the points within the Euclidean
+ * distance of each point, so that DBSCAN can find them with a grid instead.
+ */
+template<typename RangeSearchType>
+struct IsEuclideanRangeSearch
+{
+  static const bool value = false;
+};
+
+//! RangeSearch with the Euclidean distance, for any tree type.
+template<typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+struct IsEuclideanRangeSearch<RangeSearch<EuclideanDistance, MatType,
+                                          TreeType>>
+{
+  static const bool value = true;
+};
+
 /**
  * DBSCAN (Density-Based Spatial Clustering of Applications with Noise) is a
  * clustering technique described in the following paper:
@@ -42,6 +64,22 @@ namespace mlpack {
  * range search technique used and the point selection strategy by means of
  * template parameters.
  *
+ * For data with at most three dimensions and the Euclidean distance, the range
+ * search is not used: the points are instead put in the cells of a grid whose
+ * diagonal is epsilon, as in the grid-based algorithm of the following paper,
+ * which takes practically linear time on such data.  See GridCluster().
+ *
+ * @code
+ * @inproceedings{gan2015dbscan,
+ *   title={DBSCAN revisited: Mis-claim, un-fixability, and approximation},
+ *   author={Gan, J. and Tao, Y.},
+ *   booktitle={Proceedings of the 2015 ACM SIGMOD International Conference on
+ *       Management of Data (SIGMOD '15)},
+ *   pages={519--530},
+ *   year={2015}
+ * }
+ * @endcode
+ *
  * @tparam RangeSearchType Class to use for range searching.
  * @tparam PointSelectionPolicy Strategy for selecting next point to cluster
  *      with.
@@ -62,17 +100,25 @@ class DBSCAN
    * When batchMode is false, each point will be searched iteratively, which
    * could be slower but will use less memory.
    *
+   * If batchMode is true and blockSize is nonzero, the points are searched in
+   * blocks of blockSize points, so that only the neighbors of one block are
+   * held in memory at a time; this sits between batch mode and searching each
+   * point iteratively, in both speed and memory usage.
+   *
    * @param epsilon Size of range query.
    * @param minPoints Minimum number of points for each cluster.
    * @param batchMode If true, all points are searched in batch.
    * @param rangeSearch Optional instantiated RangeSearch object.
    * @param pointSelector OptionL instantiated PointSelectionPolicy object.
+   * @param blockSize If nonzero, number of points searched at once in batch
+   *     mode.
    */
   DBSCAN(const ElemType epsilon,
          const size_t minPoints,
          const bool batchMode = true,
          RangeSearchType rangeSearch = RangeSearchType(),
-         PointSelectionPolicy pointSelector = PointSelectionPolicy());
+         PointSelectionPolicy pointSelector = PointSelectionPolicy(),
+         const size_t blockSize = 0);
 
   /**
    * Performs DBSCAN clustering on the data, returning number of clusters
@@ -111,6 +157,20 @@ class DBSCAN
                  arma::Row<size_t>& assignments,
                  MatType& centroids);
 
+  //! Get the number of points searched at once in batch mode (0 means all).
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points searched at once in batch mode (0 means all).
+  size_t& BlockSize() { return blockSize; }
+
+  //! Get whether a grid is used instead of the range search for data with at
+  //! most three dimensions (when the range search uses the Euclidean
+  //! distance).
+  bool UseGrid() const { return useGrid; }
+  //! Modify whether a grid is used instead of the range search for data with
+  //! at most three dimensions (when the range search uses the Euclidean
+  //! distance).
+  bool& UseGrid() { return useGrid; }
+
  private:
   //! Maximum distance between two points to be part of same cluster.
   ElemType epsilon;
@@ -122,6 +182,12 @@ class DBSCAN
   //! Whether or not to perform the search in batch mode.  If false, single
   bool batchMode;
 
+  //! If nonzero, the number of points searched at once in batch mode.
+  size_t blockSize;
+
+  //! If true, a grid is used instead of the range search when possible.
+  bool useGrid;
+
   //! Instantiated range search policy.
   RangeSearchType rangeSearch;
 
@@ -150,6 +216,60 @@ class DBSCAN
    * @param uf UnionFind structure that will be modified.
    */
   void BatchCluster(const MatType& data, UnionFind& uf);
+
+  /**
+   * Performs DBSCAN clustering on the data, searching blocks of `blockSize`
+   * points at once.  Only the neighbors of the current block are stored, and
+   * the points are then processed exactly as in PointwiseCluster(), so the
+   * result is the same; but the range search of each block can use a
+   * dual-tree algorithm, which is much faster than one search per point.
+   *
+   * @param data Dataset to cluster.
+   * @param uf UnionFind structure that will be modified.
+   */
+  void BlockCluster(const MatType& data, UnionFind& uf);
+
+  /**
+   * Performs DBSCAN clustering on the data like BatchCluster(), but with
+   * several threads: the core points are found and connected in parallel, and
+   * then each non-core point is joined to the cluster of its neighboring core
+   * point with the smallest index.  For OrderedPointSelection, this gives the
+   * same clusters as BatchCluster(); for other point selection policies,
+   * non-core points that are neighbors of several clusters may be assigned
+   * differently (which is also a valid DBSCAN clustering).
+   *
+   * @param data Dataset to cluster.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   */
+  void ParallelBatchCluster(const MatType& data, ConcurrentUnionFind& uf);
+
+  /**
+   * Return whether GridCluster() can be used on the given data: it must have
+   * at most three dimensions, the range search must use the Euclidean
+   * distance, and the coordinates of the cells of the grid must be small
+   * enough to be computed exactly.
+   *
+   * @param data Dataset to cluster.
+   */
+  bool CanGridCluster(const MatType& data) const;
+
+  /**
+   * Performs DBSCAN clustering on low-dimensional data without a range search.
+   * The points are put in the cells of a grid of side epsilon / sqrt(d), so
+   * that all the points of a cell are neighbors, and the neighbors of a point
+   * can only be in the few cells around its own.  A cell with at least
+   * `minPoints` points only has core points, so the neighbors of its points
+   * are not counted; the core points of a cell are all connected, so clusters
+   * are merged cell by cell, by looking for one pair of neighboring core points
+   * in each pair of neighboring cells.  Each non-core point then joins the
+   * cluster of its neighboring core point with the smallest index.  The cells
+   * are processed in parallel, and the clusters are the same as those of
+   * ParallelBatchCluster().
+   *
+   * @param data Dataset to cluster.
+   * @param uf ConcurrentUnionFind structure that will be modified.
+   */
+  void GridCluster(const MatType& data, ConcurrentUnionFind& uf);
 };
 
 } // namespace mlpack
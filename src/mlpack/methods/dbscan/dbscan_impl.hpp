@@ -25,10 +25,13 @@ DBSCAN<RangeSearchType, PointSelectionPolicy>::DBSCAN(
     const size_t minPoints,
     const bool batchMode,
     RangeSearchType rangeSearch,
-    PointSelectionPolicy pointSelector) :
+    PointSelectionPolicy pointSelector,
+    const size_t blockSize) :
     epsilon(epsilon),
     minPoints(minPoints),
     batchMode(batchMode),
+    blockSize(blockSize),
+    useGrid(true),
     rangeSearch(rangeSearch),
     pointSelector(pointSelector)
 {
@@ -96,19 +99,51 @@ size_t DBSCAN<RangeSearchType, PointSelectionPolicy>::Cluster(
     const MatType& data,
     arma::Row<size_t>& assignments)
 {
-  // Initialize the UnionFind object.
-  UnionFind uf(data.n_cols);
-  rangeSearch.Train(data);
+  assignments.set_size(data.n_cols);
+
+  // The range search is not needed (and its tree is not built) if a grid can
+  // be used instead.
+  const bool gridCluster = CanGridCluster(data);
+  if (!gridCluster)
+    rangeSearch.Train(data);
+
+  if (gridCluster)
+  {
+    ConcurrentUnionFind uf(data.n_cols);
+    GridCluster(data, uf);
 
-  if (batchMode)
-    BatchCluster(data, uf);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
+  #ifdef MLPACK_USE_OPENMP
+  else if (batchMode && blockSize == 0 && omp_get_max_threads() > 1)
+  {
+    ConcurrentUnionFind uf(data.n_cols);
+    ParallelBatchCluster(data, uf);
+
+    // Now set assignments.
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
+  #endif
   else
-    PointwiseCluster(data, uf);
+  {
+    // Initialize the UnionFind object.
+    UnionFind uf(data.n_cols);
 
-  // Now set assignments.
-  assignments.set_size(data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
-    assignments[i] = uf.Find(i);
+    if (batchMode && blockSize > 0)
+      BlockCluster(data, uf);
+    else if (batchMode)
+      BatchCluster(data, uf);
+    else
+      PointwiseCluster(data, uf);
+
+    // Now set assignments.
+    for (size_t i = 0; i < data.n_cols; ++i)
+      assignments[i] = uf.Find(i);
+  }
 
   // Get a count of all clusters.
   const size_t numClusters = max(assignments) + 1;
@@ -215,6 +250,73 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::PointwiseCluster(
   }
 }
 
+/**
+ * Performs DBSCAN clustering on the data, searching blocks of points at once.
+ * This gives the same result as PointwiseCluster(), but only the neighbors of
+ * one block are held in memory at a time.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::BlockCluster(
+    const MatType& data,
+    UnionFind& uf)
+{
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<ElemType>> distances;
+  // The memory held by the results of the range search, for MemoryTracker.
+  util::TrackedBytes resultBytes;
+
+  // See the description of the algorithm in `PointwiseCluster()`.  Only the
+  // core point flags and the union-find structure are kept between blocks.
+  std::vector<bool> visited(data.n_cols, false);
+  std::vector<bool> nonCorePoints(data.n_cols, false);
+
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols);
+    Log::Info << "DBSCAN clustering on points " << begin << " to " << end
+        << "..." << std::endl;
+
+    // Get the next indices, in the same order as PointwiseCluster().
+    arma::uvec indices(end - begin);
+    for (size_t i = begin; i < end; ++i)
+      indices[i - begin] = pointSelector.Select(i, data);
+
+    // Search for the whole block at once.  The distances are not needed, so
+    // they are freed immediately.
+    rangeSearch.Search(MatType(data.cols(indices)),
+        RangeType<ElemType>(ElemType(0.0), epsilon), neighbors, distances);
+    resultBytes.Reset(util::NestedVectorBytes(neighbors) +
+        util::NestedVectorBytes(distances));
+    std::vector<std::vector<ElemType>>().swap(distances);
+    resultBytes.Reset(util::NestedVectorBytes(neighbors));
+
+    // Now process the points as if they were searched one at a time, since
+    // the result depends on which points have already been visited.
+    for (size_t k = 0; k < indices.n_elem; ++k)
+    {
+      const size_t index = indices[k];
+      const std::vector<size_t>& pointNeighbors = neighbors[k];
+      visited[index] = true;
+
+      if (pointNeighbors.size() >= minPoints)
+      {
+        for (size_t j = 0; j < pointNeighbors.size(); ++j)
+        {
+          if (uf.Find(pointNeighbors[j]) == pointNeighbors[j] ||
+              (!nonCorePoints[pointNeighbors[j]] && visited[pointNeighbors[j]]))
+          {
+            uf.Union(index, pointNeighbors[j]);
+          }
+        }
+      }
+      else
+      {
+        nonCorePoints[index] = true;
+      }
+    }
+  }
+}
+
 /**
  * Performs DBSCAN clustering on the data, returning number of clusters
  * and also the list of cluster assignments.  This can perform search in batch,
@@ -233,6 +335,8 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   rangeSearch.Train(data);
   rangeSearch.Search(RangeType<ElemType>(ElemType(0.0), epsilon), neighbors,
       distances);
+  util::TrackedBytes resultBytes(util::NestedVectorBytes(neighbors) +
+      util::NestedVectorBytes(distances));
   Log::Info << "Range search complete." << std::endl;
 
   // See the description of the algorithm in `PointwiseCluster()`.  The strategy
@@ -267,6 +371,301 @@ void DBSCAN<RangeSearchType, PointSelectionPolicy>::BatchCluster(
   }
 }
 
+/**
+ * Performs DBSCAN clustering on the data with several threads, using a
+ * lock-free union-find structure to merge the clusters.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::ParallelBatchCluster(
+    const MatType& data,
+    ConcurrentUnionFind& uf)
+{
+  // The range search is itself parallel.
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<ElemType>> distances;
+  Log::Info << "Performing range search." << std::endl;
+  rangeSearch.Train(data);
+  rangeSearch.Search(RangeType<ElemType>(ElemType(0.0), epsilon), neighbors,
+      distances);
+  util::TrackedBytes resultBytes(util::NestedVectorBytes(neighbors) +
+      util::NestedVectorBytes(distances));
+  Log::Info << "Range search complete." << std::endl;
+
+  // Monochromatic range search does not return the point as its own neighbor,
+  // so we are looking for `minPoints - 1` neighbors.
+  std::vector<char> corePoints(data.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+    corePoints[i] = (neighbors[i].size() >= minPoints - 1);
+
+  // Connect all neighboring core points; the order of the unions does not
+  // matter.  Each pair appears twice in the neighbor lists, so only one of them
+  // is used.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+  {
+    if (!corePoints[i])
+      continue;
+
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      const size_t neighbor = neighbors[i][j];
+      if (neighbor < i && corePoints[neighbor])
+        uf.Union(i, neighbor);
+    }
+  }
+
+  // Now the clusters are fixed, and each non-core point joins the cluster of
+  // the first core point that would have reached it in BatchCluster().  Since
+  // each non-core point is only unioned once, this cannot merge clusters.
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+  {
+    if (corePoints[i])
+      continue;
+
+    size_t core = SIZE_MAX;
+    for (size_t j = 0; j < neighbors[i].size(); ++j)
+    {
+      const size_t neighbor = neighbors[i][j];
+      if (corePoints[neighbor] && neighbor < core)
+        core = neighbor;
+    }
+
+    if (core != SIZE_MAX)
+      uf.Union(i, core);
+  }
+}
+
+/**
+ * Return whether the data can be clustered with a grid.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+bool DBSCAN<RangeSearchType, PointSelectionPolicy>::CanGridCluster(
+    const MatType& data) const
+{
+  if (!IsEuclideanRangeSearch<RangeSearchType>::value || !useGrid ||
+      data.n_rows == 0 || data.n_rows > 3 || data.n_cols == 0 ||
+      !(epsilon > 0))
+    return false;
+
+  // The cell coordinates of the points are computed in double precision, and
+  // must be much more precise than a cell (see GridCluster()).
+  const double side = epsilon / std::sqrt((double) data.n_rows);
+  for (size_t k = 0; k < data.n_rows; ++k)
+  {
+    const double x = std::max(std::abs((double) data.row(k).min()),
+        std::abs((double) data.row(k).max()));
+    if (!std::isfinite(x) || x / side > 1e9)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Performs DBSCAN clustering on low-dimensional data with a grid, in parallel.
+ */
+template<typename RangeSearchType, typename PointSelectionPolicy>
+void DBSCAN<RangeSearchType, PointSelectionPolicy>::GridCluster(
+    const MatType& data,
+    ConcurrentUnionFind& uf)
+{
+  using CellKey = std::array<long long, 3>;
+  const size_t dims = data.n_rows;
+  const size_t n = data.n_cols;
+
+  // The side of the cells is slightly smaller than epsilon / sqrt(d), so that
+  // the points of a cell are all neighbors even if their cell coordinates are
+  // rounded; then the neighbors of a point are at most two cells away in each
+  // dimension.
+  const double side = (1.0 - 1e-5) * epsilon / std::sqrt((double) dims);
+  const long long reach = 2;
+  arma::vec minima(dims);
+  for (size_t k = 0; k < dims; ++k)
+    minima[k] = (double) data.row(k).min();
+
+  std::vector<CellKey> keys(n);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < n; ++i)
+  {
+    keys[i].fill(0);
+    for (size_t k = 0; k < dims; ++k)
+    {
+      keys[i][k] = (long long) std::floor(((double) data(k, i) - minima[k]) /
+          side);
+    }
+  }
+
+  // Sort the points by cell; cell c holds the points
+  // order[cellStart[c]] to order[cellStart[c + 1] - 1].
+  std::vector<size_t> order(n);
+  for (size_t i = 0; i < n; ++i)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+      [&](const size_t a, const size_t b) { return keys[a] < keys[b]; });
+
+  std::vector<CellKey> cellKeys;
+  std::vector<size_t> cellStart;
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (i == 0 || keys[order[i]] != cellKeys.back())
+    {
+      cellKeys.push_back(keys[order[i]]);
+      cellStart.push_back(i);
+    }
+  }
+  cellStart.push_back(n);
+  const size_t numCells = cellKeys.size();
+  Log::Info << "DBSCAN grid has " << numCells << " nonempty cells."
+      << std::endl;
+
+  // Find the nonempty cells near each cell (including itself).  The cells whose
+  // coordinates only differ in the last dimension are contiguous in cellKeys,
+  // so each row of nearby cells is found with one binary search.
+  std::vector<std::vector<size_t>> nearCells(numCells);
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t c = 0; c < numCells; ++c)
+  {
+    const long long r1 = (dims > 1) ? reach : 0;
+    const long long r2 = (dims > 2) ? reach : 0;
+    const size_t last = dims - 1;
+    for (long long o1 = -r1; o1 <= r1; ++o1)
+    {
+      for (long long o2 = -r2; o2 <= r2; ++o2)
+      {
+        CellKey first = cellKeys[c];
+        if (dims > 1)
+          first[0] += o1;
+        if (dims > 2)
+          first[1] += o2;
+        CellKey end = first;
+        first[last] -= reach;
+        end[last] += reach;
+
+        size_t nc = std::lower_bound(cellKeys.begin(), cellKeys.end(), first) -
+            cellKeys.begin();
+        for (; nc < numCells && cellKeys[nc] <= end; ++nc)
+          nearCells[c].push_back(nc);
+      }
+    }
+  }
+
+  auto neighbors = [&](const size_t i, const size_t j)
+  {
+    ElemType distance = 0;
+    for (size_t k = 0; k < dims; ++k)
+    {
+      const ElemType diff = data(k, i) - data(k, j);
+      distance += diff * diff;
+    }
+    return std::sqrt(distance) <= epsilon;
+  };
+
+  // As in ParallelBatchCluster(), a point is a core point if it has at least
+  // `minPoints - 1` neighbors other than itself.  Afterwards, the core points
+  // of each cell are moved to its start; coreEnd[c] is the end of those of
+  // cell c.
+  std::vector<char> corePoints(n, 0);
+  std::vector<size_t> coreEnd(numCells);
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t c = 0; c < numCells; ++c)
+  {
+    const size_t begin = cellStart[c];
+    const size_t end = cellStart[c + 1];
+    if (end - begin - 1 >= minPoints - 1)
+    {
+      for (size_t p = begin; p < end; ++p)
+        corePoints[order[p]] = 1;
+    }
+    else
+    {
+      for (size_t p = begin; p < end; ++p)
+      {
+        size_t count = 0;
+        for (size_t j = 0; j < nearCells[c].size() &&
+             count < minPoints - 1; ++j)
+        {
+          const size_t nc = nearCells[c][j];
+          for (size_t q = cellStart[nc]; q < cellStart[nc + 1] &&
+               count < minPoints - 1; ++q)
+          {
+            if (order[q] != order[p] && neighbors(order[p], order[q]))
+              ++count;
+          }
+        }
+
+        corePoints[order[p]] = (count >= minPoints - 1);
+      }
+    }
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (size_t c = 0; c < numCells; ++c)
+  {
+    coreEnd[c] = std::stable_partition(order.begin() + cellStart[c],
+        order.begin() + cellStart[c + 1],
+        [&](const size_t i) { return corePoints[i]; }) - order.begin();
+  }
+
+  // The core points of a cell are all neighbors, so they are in the same
+  // cluster; and two neighboring cells are in the same cluster if any pair of
+  // their core points are neighbors.  Each pair of cells is only checked once.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t c = 0; c < numCells; ++c)
+  {
+    const size_t begin = cellStart[c];
+    for (size_t p = begin + 1; p < coreEnd[c]; ++p)
+      uf.Union(order[begin], order[p]);
+  }
+
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t c = 0; c < numCells; ++c)
+  {
+    if (coreEnd[c] == cellStart[c])
+      continue;
+
+    for (size_t j = 0; j < nearCells[c].size(); ++j)
+    {
+      const size_t nc = nearCells[c][j];
+      if (nc <= c || coreEnd[nc] == cellStart[nc] ||
+          uf.Find(order[cellStart[c]]) == uf.Find(order[cellStart[nc]]))
+        continue;
+
+      bool connected = false;
+      for (size_t p = cellStart[c]; p < coreEnd[c] && !connected; ++p)
+        for (size_t q = cellStart[nc]; q < coreEnd[nc] && !connected; ++q)
+          connected = neighbors(order[p], order[q]);
+
+      if (connected)
+        uf.Union(order[cellStart[c]], order[cellStart[nc]]);
+    }
+  }
+
+  // Now each non-core point joins the cluster of its neighboring core point
+  // with the smallest index, as in ParallelBatchCluster().
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t c = 0; c < numCells; ++c)
+  {
+    for (size_t p = coreEnd[c]; p < cellStart[c + 1]; ++p)
+    {
+      size_t core = SIZE_MAX;
+      for (size_t j = 0; j < nearCells[c].size(); ++j)
+      {
+        const size_t nc = nearCells[c][j];
+        for (size_t q = cellStart[nc]; q < coreEnd[nc]; ++q)
+        {
+          if (order[q] < core && neighbors(order[p], order[q]))
+            core = order[q];
+        }
+      }
+
+      if (core != SIZE_MAX)
+        uf.Union(order[p], core);
+    }
+  }
+}
+
 } // namespace mlpack
 
 #endif
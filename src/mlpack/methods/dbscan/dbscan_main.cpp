@@ -57,7 +57,18 @@ BINDING_LONG_DESC(
     " 'hilbert-r', 'r-plus', 'r-plus-plus', 'cover', 'ball'. The " +
     PRINT_PARAM_STRING("single_mode") + " parameter will force single-tree "
     "search (as opposed to the default dual-tree search), and '" +
-    PRINT_PARAM_STRING("naive") + " will force brute-force range search.");
+    PRINT_PARAM_STRING("naive") + " will force brute-force range search."
+    "\n\n"
+    "By default, the neighbors of all points are found at once, which can use "
+    "a lot of memory when epsilon is large.  If " +
+    PRINT_PARAM_STRING("block_size") + " is set to a positive value, the "
+    "points are instead searched in blocks of that size, and only the "
+    "neighbors of one block are stored at a time."
+    "\n\n"
+    "If the dataset has at most three dimensions, no range search is done: "
+    "the points are instead clustered with a grid whose cells have a "
+    "diagonal of epsilon, which is much faster and uses little memory, and "
+    "the range search parameters are ignored.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -92,6 +103,8 @@ PARAM_FLAG("single_mode", "If set, single-tree range search (not dual-tree) "
     "will be used.", "S");
 PARAM_FLAG("naive", "If set, brute-force range search (not tree-based) "
     "will be used.", "N");
+PARAM_INT_IN("block_size", "If positive, the number of points to search at "
+    "once; this bounds the memory used to store neighbors.", "b", 0);
 
 // Actually run the clustering, and process the output.
 template<typename RangeSearchType, typename PointSelectionPolicy>
@@ -108,8 +121,9 @@ void RunDBSCAN(util::Params& params,
   const size_t minSize = (size_t) params.Get<int>("min_size");
   arma::Row<size_t> assignments;
 
+  const size_t blockSize = (size_t) params.Get<int>("block_size");
   DBSCAN<RangeSearchType, PointSelectionPolicy> d(epsilon, minSize,
-      !params.Has("single_mode"), rs, pointSelector);
+      !params.Has("single_mode"), rs, pointSelector, blockSize);
 
   // If possible, avoid the overhead of calculating centroids.
   if (params.Has("centroids"))
@@ -161,6 +175,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
   RequireParamValue<int>(params, "min_size", [](int y) { return y > 0; },
       true, "invalid value of min_size specified");
 
+  RequireParamValue<int>(params, "block_size", [](int y) { return y >= 0; },
+      true, "block size must be nonnegative");
+  ReportIgnoredParam(params, {{ "single_mode", true }}, "block_size");
+
   // Fire off naive search if needed.
   if (params.Has("naive"))
   {
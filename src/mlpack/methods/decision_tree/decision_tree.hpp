@@ -25,6 +25,15 @@ namespace mlpack {
  * This class implements a generic decision tree learner.  Its behavior can be
  * controlled via its template arguments.
  *
+ * The data may be sparse (e.g. arma::sp_mat).  Then, if the numeric split
+ * supports it (like BestBinaryNumericSplit and RandomBinaryNumericSplit), the
+ * numeric dimensions of a node are searched from the nonzero values of its
+ * points only, with the zeros of each dimension as a single group, and the
+ * dimensions that are zero for every point of the node are skipped; so
+ * training takes time proportional to the number of nonzero values rather
+ * than to the number of dimensions times the number of points.  The trees are
+ * the same as on the equivalent dense data.
+ *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
  */
@@ -45,13 +54,21 @@ class DecisionTree :
   //! Allow access to the dimension selection type.
   using DimensionSelection = DimensionSelectionType;
 
+  //! The minimum number of points times dimensions to search at a node for the
+  //! search to be split across OpenMP threads.
+  static constexpr size_t ParallelSplitMinimum = 16384;
+  //! The minimum number of points in a node for its children to be trained as
+  //! separate OpenMP tasks.
+  static constexpr size_t ParallelBuildMinimum = 4096;
+
   /**
    * Construct the decision tree on the given data and labels, where the data
    * can be both numeric and categorical. Setting minimumLeafSize and
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -63,7 +80,7 @@ class DecisionTree :
    * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -79,7 +96,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -90,7 +108,7 @@ class DecisionTree :
    * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename LabelsType>
-  DecisionTree(MatType data,
+  DecisionTree(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                const size_t minimumLeafSize = 10,
@@ -105,8 +123,8 @@ class DecisionTree :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -120,7 +138,7 @@ class DecisionTree :
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
   DecisionTree(
-      MatType data,
+      const MatType& data,
       const data::DatasetInfo& datasetInfo,
       LabelsType labels,
       const size_t numClasses,
@@ -138,8 +156,8 @@ class DecisionTree :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -152,7 +170,7 @@ class DecisionTree :
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
   DecisionTree(
-      MatType data,
+      const MatType& data,
       LabelsType labels,
       const size_t numClasses,
       WeightsType weights,
@@ -170,8 +188,8 @@ class DecisionTree :
    * cause the tree to overfit, but setting them too large may cause it to
    * underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no
+   * longer needed to avoid copies.
    *
    * @param other Tree to take ownership of.
    * @param data Dataset to train on.
@@ -185,7 +203,7 @@ class DecisionTree :
   template<typename MatType, typename LabelsType, typename WeightsType>
   DecisionTree(
       const DecisionTree& other,
-      MatType data,
+      const MatType& data,
       const data::DatasetInfo& datasetInfo,
       LabelsType labels,
       const size_t numClasses,
@@ -201,8 +219,8 @@ class DecisionTree :
    * Setting minimumLeafSize and minimumGainSplit too small may cause the tree
    * to overfit, but setting them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no
+   * longer needed to avoid copies.
    * @param other Tree to take ownership of.
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -216,7 +234,7 @@ class DecisionTree :
   template<typename MatType, typename LabelsType, typename WeightsType>
   DecisionTree(
       const DecisionTree& other,
-      MatType data,
+      const MatType& data,
       LabelsType labels,
       const size_t numClasses,
       WeightsType weights,
@@ -277,7 +295,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -290,7 +309,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -306,7 +325,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or labels are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if labels are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -318,7 +338,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                const size_t minimumLeafSize = 10,
@@ -334,8 +354,8 @@ class DecisionTree :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -349,7 +369,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                LabelsType labels,
                const size_t numClasses,
@@ -368,8 +388,8 @@ class DecisionTree :
    * minimumLeafSize and minimumGainSplit too small may cause the tree to
    * overfit, but setting them too large may cause it to underfit.
    *
-   * Use std::move if data, labels or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if labels or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param labels Labels for each training point.
@@ -382,7 +402,7 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename LabelsType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                LabelsType labels,
                const size_t numClasses,
                WeightsType weights,
@@ -394,6 +414,151 @@ class DecisionTree :
                const std::enable_if_t<arma::is_arma_type<
                    std::remove_reference_t<WeightsType>>::value>* = 0);
 
+  /**
+   * Train the decision tree on the points of the given data with the given
+   * indices.  This will overwrite the existing model.  The data may have
+   * numeric and categorical types, specified by the datasetInfo parameter.
+   * An index may appear more than once (e.g. for a bootstrap sample); the
+   * tree is then trained exactly as if it had been given the dataset
+   * `data.cols(points)`, but without making a copy of it.
+   *
+   * Use std::move if points or labels are no longer needed to avoid copies.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points of the dataset to train on.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels of each point; labels[i] is the label of the point
+   *      with index points[i].
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename LabelsType>
+  double Train(const MatType& data,
+               arma::uvec points,
+               const data::DatasetInfo& datasetInfo,
+               LabelsType labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the points of the given data with the given
+   * indices, assuming that all dimensions are numeric.  This will overwrite
+   * the existing model.  An index may appear more than once (e.g. for a
+   * bootstrap sample); the tree is then trained exactly as if it had been
+   * given the dataset `data.cols(points)`, but without making a copy of it.
+   *
+   * Use std::move if points or labels are no longer needed to avoid copies.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points of the dataset to train on.
+   * @param labels Labels of each point; labels[i] is the label of the point
+   *      with index points[i].
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename LabelsType>
+  double Train(const MatType& data,
+               arma::uvec points,
+               LabelsType labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               const std::enable_if_t<arma::is_arma_type<
+                   std::remove_reference_t<LabelsType>>::value>* = 0);
+
+  /**
+   * Train the decision tree on the weighted points of the given data with the
+   * given indices.  This will overwrite the existing model.  The data may
+   * have numeric and categorical types, specified by the datasetInfo
+   * parameter.  An index may appear more than once (e.g. for a bootstrap
+   * sample); the tree is then trained exactly as if it had been given the
+   * dataset `data.cols(points)`, but without making a copy of it.
+   *
+   * Use std::move if points, labels or weights are no longer needed to avoid
+   * copies.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points of the dataset to train on.
+   * @param datasetInfo Type information for each dimension.
+   * @param labels Labels of each point; labels[i] is the label of the point
+   *      with index points[i].
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point, in the same order as labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename LabelsType, typename WeightsType>
+  double Train(const MatType& data,
+               arma::uvec points,
+               const data::DatasetInfo& datasetInfo,
+               LabelsType labels,
+               const size_t numClasses,
+               WeightsType weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               const std::enable_if_t<arma::is_arma_type<
+                   std::remove_reference_t<WeightsType>>::value>* = 0);
+
+  /**
+   * Train the decision tree on the weighted points of the given data with the
+   * given indices, assuming that all dimensions are numeric.  This will
+   * overwrite the existing model.  An index may appear more than once (e.g.
+   * for a bootstrap sample); the tree is then trained exactly as if it had
+   * been given the dataset `data.cols(points)`, but without making a copy of
+   * it.
+   *
+   * Use std::move if points, labels or weights are no longer needed to avoid
+   * copies.
+   *
+   * @param data Dataset to train on.
+   * @param points Indices of the points of the dataset to train on.
+   * @param labels Labels of each point; labels[i] is the label of the point
+   *      with index points[i].
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point, in the same order as labels.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename LabelsType, typename WeightsType>
+  double Train(const MatType& data,
+               arma::uvec points,
+               LabelsType labels,
+               const size_t numClasses,
+               WeightsType weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               const std::enable_if_t<arma::is_arma_type<
+                   std::remove_reference_t<LabelsType>>::value &&
+                   arma::is_arma_type<
+                   std::remove_reference_t<WeightsType>>::value>* = 0);
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -460,6 +625,12 @@ class DecisionTree :
   //! Get the split dimension (only meaningful if this is a non-leaf in a
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionType;
+  }
 
   //! Get the class probabilities, if this is a leaf node in the trained tree.
   //! Note that if this is not a leaf, then this may contain arbitrary
@@ -511,6 +682,18 @@ class DecisionTree :
   using CategoricalAuxiliarySplitInfo =
       typename CategoricalSplit::AuxiliarySplitInfo;
 
+  /**
+   * Return whether the numeric dimensions of the given type of data are
+   * searched from their nonzero values only (see SparseDimension); this is the
+   * case for sparse data, if the numeric split supports it.
+   */
+  template<typename MatType>
+  static constexpr bool UseSparseSearch()
+  {
+    return arma::is_arma_sparse_type<MatType>::value &&
+        SplitTraits<NumericSplit>::HasSparseSearch;
+  }
+
   /**
    * Calculate the class probabilities of the given labels.
    */
@@ -519,14 +702,27 @@ class DecisionTree :
                                    const size_t numClasses,
                                    const WeightsRowType& weights);
 
+  /**
+   * Return the indices of all the points of a dataset with the given number
+   * of points, in order.  The tree is built on a permutation of these indices,
+   * so the data itself is never copied or reordered.
+   */
+  static arma::uvec AllPoints(const size_t numPoints)
+  {
+    return (numPoints == 0) ? arma::uvec() :
+        arma::regspace<arma::uvec>(0, numPoints - 1);
+  }
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
    * train children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param points Indices of the points of the dataset, reordered during
+   *      training so that the points of each node are contiguous.
+   * @param begin Index of the starting point in `points` that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
@@ -537,7 +733,8 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename WeightsType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& points,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
@@ -555,8 +752,10 @@ class DecisionTree :
    * training children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param points Indices of the points of the dataset, reordered during
+   *      training so that the points of each node are contiguous.
+   * @param begin Index of the starting point in `points` that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
@@ -566,7 +765,8 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename WeightsType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& points,
                const size_t begin,
                const size_t count,
                arma::Row<size_t>& labels,
@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 
 #include "decision_tree.hpp"
+#include "utils.hpp"
 
 namespace mlpack {
 
@@ -28,7 +29,7 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              NoRecursion>::DecisionTree(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -37,19 +38,19 @@ DecisionTree<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector)
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.
   TrueLabelsType tmpLabels(std::move(labels));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<false>(data, points, 0, data.n_cols, datasetInfo, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -66,7 +67,7 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              NoRecursion>::DecisionTree(
-    MatType data,
+    const MatType& data,
     LabelsType labels,
     const size_t numClasses,
     const size_t minimumLeafSize,
@@ -74,19 +75,19 @@ DecisionTree<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector)
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.
   TrueLabelsType tmpLabels(std::move(labels));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
+  Train<false>(data, points, 0, data.n_cols, tmpLabels, numClasses, weights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -102,7 +103,7 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              NoRecursion>::DecisionTree(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -114,20 +115,20 @@ DecisionTree<FitnessFunction,
     const std::enable_if_t<arma::is_arma_type<
         std::remove_reference_t<WeightsType>>::value>*)
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<true>(data, points, 0, data.n_cols, datasetInfo, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -144,7 +145,7 @@ DecisionTree<FitnessFunction,
              CategoricalSplitType,
              DimensionSelectionType,
              NoRecursion>::DecisionTree(
-    MatType data,
+    const MatType& data,
     LabelsType labels,
     const size_t numClasses,
     WeightsType weights,
@@ -155,20 +156,20 @@ DecisionTree<FitnessFunction,
     const std::enable_if_t<arma::is_arma_type<
         std::remove_reference_t<WeightsType>>::value>*)
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+  Train<true>(data, points, 0, data.n_cols, tmpLabels, numClasses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -185,7 +186,7 @@ DecisionTree<FitnessFunction,
         DimensionSelectionType,
         NoRecursion>::DecisionTree(
     const DecisionTree& other,
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -197,17 +198,17 @@ DecisionTree<FitnessFunction,
         NumericAuxiliarySplitInfo(other),
         CategoricalAuxiliarySplitInfo(other)
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
+  Train<true>(data, points, 0, data.n_cols, datasetInfo, tmpLabels, numClasses,
               tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -224,7 +225,7 @@ DecisionTree<FitnessFunction,
         DimensionSelectionType,
         NoRecursion>::DecisionTree(
     const DecisionTree& other,
-    MatType data,
+    const MatType& data,
     LabelsType labels,
     const size_t numClasses,
     WeightsType weights,
@@ -237,20 +238,20 @@ DecisionTree<FitnessFunction,
         NumericAuxiliarySplitInfo(other),
         CategoricalAuxiliarySplitInfo(other)  // other info does need to copy
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
+  Train<true>(data, points, 0, data.n_cols, tmpLabels, numClasses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -445,7 +446,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -457,19 +458,19 @@ double DecisionTree<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, labels, "DecisionTree::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.
   TrueLabelsType tmpLabels(std::move(labels));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  return Train<false>(data, points, 0, data.n_cols, datasetInfo, tmpLabels,
       numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -486,7 +487,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     LabelsType labels,
     const size_t numClasses,
     const size_t minimumLeafSize,
@@ -497,19 +498,19 @@ double DecisionTree<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, labels, "DecisionTree::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels.
   TrueLabelsType tmpLabels(std::move(labels));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<false>(data, points, 0, data.n_cols, tmpLabels, numClasses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -526,7 +527,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     LabelsType labels,
     const size_t numClasses,
@@ -541,20 +542,20 @@ double DecisionTree<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, labels, "DecisionTree::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+  return Train<true>(data, points, 0, data.n_cols, datasetInfo, tmpLabels,
       numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -571,7 +572,7 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     LabelsType labels,
     const size_t numClasses,
     WeightsType weights,
@@ -585,20 +586,219 @@ double DecisionTree<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, labels, "DecisionTree::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueLabelsType = std::decay_t<LabelsType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move labels and weights.
+  TrueLabelsType tmpLabels(std::move(labels));
+  TrueWeightsType tmpWeights(std::move(weights));
+
+  arma::uvec points = AllPoints(data.n_cols);
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  return Train<true>(data, points, 0, data.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the points of the given data with the given indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename LabelsType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec points,
+    const data::DatasetInfo& datasetInfo,
+    LabelsType labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(labels, (size_t) points.n_elem, "DecisionTree::Train()",
+      "point indices");
+  if (points.n_elem > 0 && points.max() >= data.n_cols)
+  {
+    throw std::invalid_argument("DecisionTree::Train(): point index out of "
+        "bounds of the dataset!");
+  }
+
+  using TrueLabelsType = std::decay_t<LabelsType>;
+
+  // Copy or move labels.
+  TrueLabelsType tmpLabels(std::move(labels));
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return Train<false>(data, points, 0, points.n_elem, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the points of the given data with the given indices, assuming
+//! all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename LabelsType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec points,
+    LabelsType labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    const std::enable_if_t<
+        arma::is_arma_type<std::remove_reference_t<LabelsType>>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(labels, (size_t) points.n_elem, "DecisionTree::Train()",
+      "point indices");
+  if (points.n_elem > 0 && points.max() >= data.n_cols)
+  {
+    throw std::invalid_argument("DecisionTree::Train(): point index out of "
+        "bounds of the dataset!");
+  }
+
+  using TrueLabelsType = std::decay_t<LabelsType>;
+
+  // Copy or move labels.
+  TrueLabelsType tmpLabels(std::move(labels));
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return Train<false>(data, points, 0, points.n_elem, tmpLabels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the weighted points of the given data with the given indices.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename LabelsType, typename WeightsType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec points,
+    const data::DatasetInfo& datasetInfo,
+    LabelsType labels,
+    const size_t numClasses,
+    WeightsType weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    const std::enable_if_t<
+        arma::is_arma_type<std::remove_reference_t<WeightsType>>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(labels, (size_t) points.n_elem, "DecisionTree::Train()",
+      "point indices");
+  util::CheckSameSizes(weights, (size_t) points.n_elem,
+      "DecisionTree::Train()", "point indices");
+  if (points.n_elem > 0 && points.max() >= data.n_cols)
+  {
+    throw std::invalid_argument("DecisionTree::Train(): point index out of "
+        "bounds of the dataset!");
+  }
+
+  using TrueLabelsType = std::decay_t<LabelsType>;
+  using TrueWeightsType = std::decay_t<WeightsType>;
+
+  // Copy or move labels and weights.
+  TrueLabelsType tmpLabels(std::move(labels));
+  TrueWeightsType tmpWeights(std::move(weights));
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  return Train<true>(data, points, 0, points.n_elem, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the weighted points of the given data with the given indices,
+//! assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename LabelsType, typename WeightsType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec points,
+    LabelsType labels,
+    const size_t numClasses,
+    WeightsType weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    const std::enable_if_t<
+        arma::is_arma_type<std::remove_reference_t<LabelsType>>::value &&
+        arma::is_arma_type<std::remove_reference_t<WeightsType>>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(labels, (size_t) points.n_elem, "DecisionTree::Train()",
+      "point indices");
+  util::CheckSameSizes(weights, (size_t) points.n_elem,
+      "DecisionTree::Train()", "point indices");
+  if (points.n_elem > 0 && points.max() >= data.n_cols)
+  {
+    throw std::invalid_argument("DecisionTree::Train(): point index out of "
+        "bounds of the dataset!");
+  }
+
+  using TrueLabelsType = std::decay_t<LabelsType>;
+  using TrueWeightsType = std::decay_t<WeightsType>;
+
+  // Copy or move labels and weights.
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<true>(data, points, 0, points.n_elem, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -615,7 +815,8 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& points,
     const size_t begin,
     const size_t count,
     const data::DatasetInfo& datasetInfo,
@@ -646,49 +847,111 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    // Collect the dimensions to search first, so that the dimension selector
+    // is used in the same order whether or not the search is parallel.
+    std::vector<size_t> dims;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
     {
-      double dimGain = -DBL_MAX;
+      dims.push_back(i);
+    }
+
+    // A projection split may combine any of the numeric dimensions.
+    std::vector<size_t> numericDims;
+    if constexpr (SplitTraits<NumericSplit>::IsProjectionSplit)
+    {
+      for (size_t i = 0; i < dims.size(); ++i)
+        if (datasetInfo.Type(dims[i]) == data::Datatype::numeric)
+          numericDims.push_back(dims[i]);
+    }
+
+    // On sparse data, the numeric dimensions are searched from the nonzero
+    // values of the node, and those that are zero for every point of the node
+    // cannot be split, so they are not searched at all.
+    SparseNode<typename MatType::elem_type> sparseNode;
+    if constexpr (UseSparseSearch<MatType>())
+    {
+      sparseNode.template Build<UseWeights>(data, points, begin, count, labels,
+          numClasses, weights);
+      dims.erase(std::remove_if(dims.begin(), dims.end(),
+          [&](const size_t d)
+          {
+            return datasetInfo.Type(d) == data::Datatype::numeric &&
+                !sparseNode.HasNonzeros(d);
+          }), dims.end());
+    }
+
+    // Each dimension is searched with its own split information, so that the
+    // dimensions can be searched in parallel.
+    auto searchDimension = [&](const size_t i,
+                               const double gain,
+                               arma::vec& dimSplitInfo,
+                               NumericAuxiliarySplitInfo& numericAux,
+                               CategoricalAuxiliarySplitInfo& categoricalAux)
+    {
       if (datasetInfo.Type(i) == data::Datatype::categorical)
       {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
+        return CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
+            GatherDimension(data, i, points, begin, count),
             datasetInfo.NumMappings(i),
             labels.subvec(begin, begin + count - 1),
             numClasses,
             UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
             minimumLeafSize,
             minimumGainSplit,
-            classProbabilities,
-            *this);
+            dimSplitInfo,
+            categoricalAux);
       }
       else if (datasetInfo.Type(i) == data::Datatype::numeric)
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
+        if constexpr (SplitTraits<NumericSplit>::IsProjectionSplit)
+        {
+          return NumericSplit::template SplitIfBetter<UseWeights>(gain, data,
+              points, begin, count, i, numericDims,
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimSplitInfo,
+              numericAux);
+        }
+        else if constexpr (UseSparseSearch<MatType>())
+        {
+          return NumericSplit::template SplitIfBetter<UseWeights>(gain,
+              sparseNode.Dimension(i),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimSplitInfo,
+              numericAux);
+        }
+        else
+        {
+          return NumericSplit::template SplitIfBetter<UseWeights>(gain,
+              GatherDimension(data, i, points, begin, count),
+              labels.subvec(begin, begin + count - 1),
+              numClasses,
+              UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
+              minimumLeafSize,
+              minimumGainSplit,
+              dimSplitInfo,
+              numericAux);
+        }
       }
 
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
+      return DBL_MAX;
+    };
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    const size_t bestIndex = FindBestSplit(dims,
+        count * dims.size() >= ParallelSplitMinimum, minimumGainSplit,
+        bestGain, classProbabilities,
+        static_cast<NumericAuxiliarySplitInfo&>(*this),
+        static_cast<CategoricalAuxiliarySplitInfo&>(*this), searchDimension);
+    if (bestIndex != dims.size())
+      bestDim = dims[bestIndex];
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -710,19 +973,27 @@ double DecisionTree<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+            data(bestDim, points[j]), classProbabilities, *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
-        childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities, *this);
+        if constexpr (SplitTraits<NumericSplit>::IsProjectionSplit)
+        {
+          childAssignments[j - begin] = NumericSplit::CalculateDirection(
+              data.col(points[j]), classProbabilities, *this);
+        }
+        else
+        {
+          childAssignments[j - begin] = NumericSplit::CalculateDirection(
+              data(bestDim, points[j]), classProbabilities, *this);
+        }
       }
     }
 
     // Figure out counts of children.
-    arma::Row<size_t> childCounts(numChildren);
+    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
@@ -732,17 +1003,19 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
-    // Split into children.
+    // Split into children: first move the points of each child together,
+    // then train the children, each of which only touches its own points.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          std::swap(points[currentCol], points[j]);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -750,25 +1023,39 @@ double DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
+      children.push_back(new DecisionTree());
+    }
+
+    // Now build the children recursively, in parallel if this node is large
+    // enough.
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    auto trainChild = [&](const size_t i,
+                          DimensionSelectionType& childDimensionSelector)
+    {
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childCounts[i];
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
+        children[i]->template Train<UseWeights>(data, points, childBegin,
+            childCount, datasetInfo, labels, numClasses, weights, childCount,
+            minimumGainSplit, maximumDepth - 1, childDimensionSelector);
       }
       else
       {
         // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            points, childBegin, childCount, datasetInfo, labels, numClasses,
             weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+            childDimensionSelector);
       }
-      children.push_back(child);
+    };
+    TrainChildren(numChildren, count >= ParallelBuildMinimum,
+        dimensionSelector, trainChild);
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -799,7 +1086,8 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& points,
     const size_t begin,
     const size_t count,
     arma::Row<size_t>& labels,
@@ -831,34 +1119,79 @@ double DecisionTree<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    // Collect the dimensions to search first, so that the dimension selector
+    // is used in the same order whether or not the search is parallel.
+    std::vector<size_t> dims;
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
+      dims.push_back(i);
     }
+
+    // On sparse data, the dimensions are searched from the nonzero values of
+    // the node, and those that are zero for every point of the node cannot be
+    // split, so they are not searched at all.
+    SparseNode<typename MatType::elem_type> sparseNode;
+    if constexpr (UseSparseSearch<MatType>())
+    {
+      sparseNode.template Build<UseWeights>(data, points, begin, count, labels,
+          numClasses, weights);
+      dims.erase(std::remove_if(dims.begin(), dims.end(),
+          [&](const size_t d) { return !sparseNode.HasNonzeros(d); }),
+          dims.end());
+    }
+
+    // Each dimension is searched with its own split information, so that the
+    // dimensions can be searched in parallel.
+    auto searchDimension = [&](const size_t i,
+                               const double gain,
+                               arma::vec& dimSplitInfo,
+                               NumericAuxiliarySplitInfo& numericAux,
+                               CategoricalAuxiliarySplitInfo& /* catAux */)
+    {
+      if constexpr (SplitTraits<NumericSplit>::IsProjectionSplit)
+      {
+        return NumericSplit::template SplitIfBetter<UseWeights>(gain, data,
+            points, begin, count, i, dims,
+            labels.cols(begin, begin + count - 1), numClasses,
+            UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+            minimumLeafSize, minimumGainSplit, dimSplitInfo, numericAux);
+      }
+      else if constexpr (UseSparseSearch<MatType>())
+      {
+        return NumericSplit::template SplitIfBetter<UseWeights>(gain,
+            sparseNode.Dimension(i),
+            labels.cols(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            dimSplitInfo,
+            numericAux);
+      }
+      else
+      {
+        const arma::Row<typename MatType::elem_type> dimData =
+            GatherDimension(data, i, points, begin, count);
+        return NumericSplit::template SplitIfBetter<UseWeights>(gain,
+            dimData,
+            labels.cols(begin, begin + count - 1),
+            numClasses,
+            UseWeights ? weights.cols(begin, begin + count - 1) : weights,
+            minimumLeafSize,
+            minimumGainSplit,
+            dimSplitInfo,
+            numericAux);
+      }
+    };
+
+    const size_t bestIndex = FindBestSplit(dims,
+        count * dims.size() >= ParallelSplitMinimum, minimumGainSplit,
+        bestGain, classProbabilities,
+        static_cast<NumericAuxiliarySplitInfo&>(*this),
+        static_cast<CategoricalAuxiliarySplitInfo&>(*this), searchDimension);
+    if (bestIndex != dims.size())
+      bestDim = dims[bestIndex];
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -875,8 +1208,16 @@ double DecisionTree<FitnessFunction,
 
     for (size_t j = begin; j < begin + count; ++j)
     {
-      childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities, *this);
+      if constexpr (SplitTraits<NumericSplit>::IsProjectionSplit)
+      {
+        childAssignments[j - begin] = NumericSplit::CalculateDirection(
+            data.col(points[j]), classProbabilities, *this);
+      }
+      else
+      {
+        childAssignments[j - begin] = NumericSplit::CalculateDirection(
+            data(bestDim, points[j]), classProbabilities, *this);
+      }
     }
 
     // Calculate counts of children in each node.
@@ -891,16 +1232,19 @@ double DecisionTree<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // Split into children: first move the points of each child together,
+    // then train the children, each of which only touches its own points.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          std::swap(points[currentCol], points[j]);
           labels.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -908,25 +1252,39 @@ double DecisionTree<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
+      children.push_back(new DecisionTree());
+    }
+
+    // Now build the children recursively, in parallel if this node is large
+    // enough.
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    auto trainChild = [&](const size_t i,
+                          DimensionSelectionType& childDimensionSelector)
+    {
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childCounts[i];
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        children[i]->template Train<UseWeights>(data, points, childBegin,
+            childCount, labels, numClasses, weights, childCount,
+            minimumGainSplit, maximumDepth - 1, childDimensionSelector);
       }
       else
       {
         // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            points, childBegin, childCount, labels, numClasses, weights,
             minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+            childDimensionSelector);
       }
-      children.push_back(child);
+    };
+    TrainChildren(numChildren, count >= ParallelBuildMinimum,
+        dimensionSelector, trainChild);
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -1102,6 +1460,8 @@ size_t DecisionTree<FitnessFunction,
   if ((data::Datatype) dimensionType == data::Datatype::categorical)
     return CategoricalSplit::CalculateDirection(point[splitDimension],
         classProbabilities, *this);
+  else if constexpr (SplitTraits<NumericSplit>::IsProjectionSplit)
+    return NumericSplit::CalculateDirection(point, classProbabilities, *this);
   else
     return NumericSplit::CalculateDirection(point[splitDimension],
         classProbabilities, *this);
@@ -45,6 +45,13 @@ class DecisionTreeRegressor :
   //! Allow access to the dimension selection type.
   using DimensionSelection = DimensionSelectionType;
 
+  //! The minimum number of points times dimensions to search at a node for the
+  //! search to be split across OpenMP threads.
+  static constexpr size_t ParallelSplitMinimum = 16384;
+  //! The minimum number of points in a node for its children to be trained as
+  //! separate OpenMP tasks.
+  static constexpr size_t ParallelBuildMinimum = 4096;
+
   /**
    * Construct a decision tree without training it.  It will be a leaf node.
    */
@@ -56,7 +63,8 @@ class DecisionTreeRegressor :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or responses are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if responses are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -67,7 +75,7 @@ class DecisionTreeRegressor :
    * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename ResponsesType>
-  DecisionTreeRegressor(MatType data,
+  DecisionTreeRegressor(const MatType& data,
                         const data::DatasetInfo& datasetInfo,
                         ResponsesType responses,
                         const size_t minimumLeafSize = 10,
@@ -82,7 +90,8 @@ class DecisionTreeRegressor :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or responses are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if responses are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param responses Responses for each training point.
@@ -92,7 +101,7 @@ class DecisionTreeRegressor :
    * @param dimensionSelector Instantiated dimension selection policy.
    */
   template<typename MatType, typename ResponsesType>
-  DecisionTreeRegressor(MatType data,
+  DecisionTreeRegressor(const MatType& data,
                         ResponsesType responses,
                         const size_t minimumLeafSize = 10,
                         const double minimumGainSplit = 1e-7,
@@ -106,8 +115,8 @@ class DecisionTreeRegressor :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, responses or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if responses or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension of the dataset.
@@ -120,7 +129,7 @@ class DecisionTreeRegressor :
    */
   template<typename MatType, typename ResponsesType, typename WeightsType>
   DecisionTreeRegressor(
-      MatType data,
+      const MatType& data,
       const data::DatasetInfo& datasetInfo,
       ResponsesType responses,
       WeightsType weights,
@@ -137,8 +146,8 @@ class DecisionTreeRegressor :
    * and minimumGainSplit too small may cause the tree to overfit, but setting
    * them too large may cause it to underfit.
    *
-   * Use std::move if data, responses or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if responses or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param responses Responses for each training point.
@@ -150,7 +159,7 @@ class DecisionTreeRegressor :
    */
   template<typename MatType, typename ResponsesType, typename WeightsType>
   DecisionTreeRegressor(
-      MatType data,
+      const MatType& data,
       ResponsesType responses,
       WeightsType weights,
       const size_t minimumLeafSize = 10,
@@ -167,8 +176,8 @@ class DecisionTreeRegressor :
    * cause the tree to overfit, but setting them too large may cause it to
    * underfit.
    *
-   * Use std::move if data, responses or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if responses or weights are no
+   * longer needed to avoid copies.
    *
    * @param other Tree to take ownership of.
    * @param data Dataset to train on.
@@ -181,7 +190,7 @@ class DecisionTreeRegressor :
   template<typename MatType, typename ResponsesType, typename WeightsType>
   DecisionTreeRegressor(
       const DecisionTreeRegressor& other,
-      MatType data,
+      const MatType& data,
       const data::DatasetInfo& datasetInfo,
       ResponsesType responses,
       WeightsType weights,
@@ -196,8 +205,8 @@ class DecisionTreeRegressor :
    * Setting minimumLeafSize and minimumGainSplit too small may cause the tree
    * to overfit, but setting them too large may cause it to underfit.
    *
-   * Use std::move if data, responses or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if responses or weights are no
+   * longer needed to avoid copies.
    * @param other Tree to take ownership of.
    * @param data Dataset to train on.
    * @param responses Responses for each training point.
@@ -210,7 +219,7 @@ class DecisionTreeRegressor :
   template<typename MatType, typename ResponsesType, typename WeightsType>
   DecisionTreeRegressor(
       const DecisionTreeRegressor& other,
-      MatType data,
+      const MatType& data,
       ResponsesType responses,
       WeightsType weights,
       const size_t minimumLeafSize = 10,
@@ -262,7 +271,8 @@ class DecisionTreeRegressor :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or responses are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if responses are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -276,7 +286,7 @@ class DecisionTreeRegressor :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename ResponsesType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                ResponsesType responses,
                const size_t minimumLeafSize = 10,
@@ -292,7 +302,8 @@ class DecisionTreeRegressor :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data or responses are no longer needed to avoid copies.
+   * The data is not copied.  Use std::move if responses are no longer needed to
+   * avoid copies.
    *
    * @param data Dataset to train on.
    * @param responses Responses for each training point.
@@ -305,7 +316,7 @@ class DecisionTreeRegressor :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename ResponsesType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                ResponsesType responses,
                const size_t minimumLeafSize = 10,
                const double minimumGainSplit = 1e-7,
@@ -321,8 +332,8 @@ class DecisionTreeRegressor :
    * minimumGainSplit too small may cause the tree to overfit, but setting them
    * too large may cause it to underfit.
    *
-   * Use std::move if data, responses or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if responses or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param datasetInfo Type information for each dimension.
@@ -337,7 +348,7 @@ class DecisionTreeRegressor :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename ResponsesType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                const data::DatasetInfo& datasetInfo,
                ResponsesType responses,
                WeightsType weights,
@@ -356,8 +367,8 @@ class DecisionTreeRegressor :
    * minimumLeafSize and minimumGainSplit too small may cause the tree to
    * overfit, but setting them too large may cause it to underfit.
    *
-   * Use std::move if data, responses or weights are no longer needed to avoid
-   * copies.
+   * The data is not copied.  Use std::move if responses or weights are no
+   * longer needed to avoid copies.
    *
    * @param data Dataset to train on.
    * @param responses Responses for each training point.
@@ -371,7 +382,7 @@ class DecisionTreeRegressor :
    * @return The final entropy of decision tree.
    */
   template<typename MatType, typename ResponsesType, typename WeightsType>
-  double Train(MatType data,
+  double Train(const MatType& data,
                ResponsesType responses,
                WeightsType weights,
                const size_t minimumLeafSize = 10,
@@ -459,14 +470,27 @@ class DecisionTreeRegressor :
   using CategoricalAuxiliarySplitInfo =
       typename CategoricalSplit::AuxiliarySplitInfo;
 
+  /**
+   * Return the indices of all the points of a dataset with the given number
+   * of points, in order.  The tree is built on a permutation of these indices,
+   * so the data itself is never copied or reordered.
+   */
+  static arma::uvec AllPoints(const size_t numPoints)
+  {
+    return (numPoints == 0) ? arma::uvec() :
+        arma::regspace<arma::uvec>(0, numPoints - 1);
+  }
+
   /**
    * Corresponding to the public Train() method, this method is designed for
    * avoiding unnecessary copies during training.  This function is called to
    * train children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param points Indices of the points of the dataset, reordered during
+   *      training so that the points of each node are contiguous.
+   * @param begin Index of the starting point in `points` that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param responses Responses for each training point.
@@ -478,7 +502,8 @@ class DecisionTreeRegressor :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename ResponsesType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& points,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
@@ -496,8 +521,10 @@ class DecisionTreeRegressor :
    * training children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param points Indices of the points of the dataset, reordered during
+   *      training so that the points of each node are contiguous.
+   * @param begin Index of the starting point in `points` that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param responses Responses for each training point.
    * @param minimumLeafSize Minimum number of points in each leaf node.
@@ -508,7 +535,8 @@ class DecisionTreeRegressor :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename ResponsesType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& points,
                const size_t begin,
                const size_t count,
                ResponsesType& responses,
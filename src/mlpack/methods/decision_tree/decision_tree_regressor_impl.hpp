@@ -44,7 +44,7 @@ DecisionTreeRegressor<FitnessFunction,
                       CategoricalSplitType,
                       DimensionSelectionType,
                       NoRecursion>::DecisionTreeRegressor(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     ResponsesType responses,
     const size_t minimumLeafSize,
@@ -52,19 +52,19 @@ DecisionTreeRegressor<FitnessFunction,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector) : splitInfo()
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses.
   TrueResponsesType tmpResponses(std::move(responses));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<false>(data, points, 0, data.n_cols, datasetInfo, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -81,26 +81,26 @@ DecisionTreeRegressor<FitnessFunction,
                       CategoricalSplitType,
                       DimensionSelectionType,
                       NoRecursion>::DecisionTreeRegressor(
-    MatType data,
+    const MatType& data,
     ResponsesType responses,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType dimensionSelector) : splitInfo()
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses.
   TrueResponsesType tmpResponses(std::move(responses));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpResponses, weights,
+  Train<false>(data, points, 0, data.n_cols, tmpResponses, weights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -116,7 +116,7 @@ DecisionTreeRegressor<FitnessFunction,
                       CategoricalSplitType,
                       DimensionSelectionType,
                       NoRecursion>::DecisionTreeRegressor(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     ResponsesType responses,
     WeightsType weights,
@@ -128,19 +128,20 @@ DecisionTreeRegressor<FitnessFunction,
         std::remove_reference_t<WeightsType>>::value>*)
     : splitInfo()
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses and weights.
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<true>(data, points, 0, data.n_cols, datasetInfo, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -157,7 +158,7 @@ DecisionTreeRegressor<FitnessFunction,
                       CategoricalSplitType,
                       DimensionSelectionType,
                       NoRecursion>::DecisionTreeRegressor(
-    MatType data,
+    const MatType& data,
     ResponsesType responses,
     WeightsType weights,
     const size_t minimumLeafSize,
@@ -168,20 +169,20 @@ DecisionTreeRegressor<FitnessFunction,
         arma::is_arma_type<std::remove_reference_t<WeightsType>>::value>*) :
     splitInfo()
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses and weights.
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses, tmpWeights,
+  Train<true>(data, points, 0, data.n_cols, tmpResponses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -198,7 +199,7 @@ DecisionTreeRegressor<FitnessFunction,
                       DimensionSelectionType,
                       NoRecursion>::DecisionTreeRegressor(
     const DecisionTreeRegressor& other,
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     ResponsesType responses,
     WeightsType weights,
@@ -210,17 +211,17 @@ DecisionTreeRegressor<FitnessFunction,
     NumericAuxiliarySplitInfo(other),
     CategoricalAuxiliarySplitInfo(other)
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses and weights.
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<true>(data, points, 0, data.n_cols, datasetInfo, tmpResponses,
               tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
@@ -237,7 +238,7 @@ DecisionTreeRegressor<FitnessFunction,
                       DimensionSelectionType,
                       NoRecursion>::DecisionTreeRegressor(
     const DecisionTreeRegressor& other,
-    MatType data,
+    const MatType& data,
     ResponsesType responses,
     WeightsType weights,
     const size_t minimumLeafSize,
@@ -250,20 +251,20 @@ DecisionTreeRegressor<FitnessFunction,
     NumericAuxiliarySplitInfo(other),
     CategoricalAuxiliarySplitInfo(other)   // other info does need to copy
 {
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses and weights.
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses, tmpWeights,
+  Train<true>(data, points, 0, data.n_cols, tmpResponses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -428,7 +429,7 @@ double DecisionTreeRegressor<FitnessFunction,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     ResponsesType responses,
     const size_t minimumLeafSize,
@@ -440,19 +441,19 @@ double DecisionTreeRegressor<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, responses, "DecisionTreeRegressor::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses.
   TrueResponsesType tmpResponses(std::move(responses));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  return Train<false>(data, points, 0, data.n_cols, datasetInfo, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -469,7 +470,7 @@ double DecisionTreeRegressor<FitnessFunction,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     ResponsesType responses,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
@@ -480,19 +481,19 @@ double DecisionTreeRegressor<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, responses, "DecisionTreeRegressor::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses.
   TrueResponsesType tmpResponses(std::move(responses));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpResponses,
+  return Train<false>(data, points, 0, data.n_cols, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -509,7 +510,7 @@ double DecisionTreeRegressor<FitnessFunction,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     const data::DatasetInfo& datasetInfo,
     ResponsesType responses,
     WeightsType weights,
@@ -524,20 +525,20 @@ double DecisionTreeRegressor<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, responses, "DecisionTreeRegressor::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses and weights.
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  return Train<true>(data, points, 0, data.n_cols, datasetInfo, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -554,7 +555,7 @@ double DecisionTreeRegressor<FitnessFunction,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType data,
+    const MatType& data,
     ResponsesType responses,
     WeightsType weights,
     const size_t minimumLeafSize,
@@ -568,20 +569,20 @@ double DecisionTreeRegressor<FitnessFunction,
   // Sanity check on data.
   util::CheckSameSizes(data, responses, "DecisionTreeRegressor::Train()");
 
-  using TrueMatType = std::decay_t<MatType>;
   using TrueResponsesType = std::decay_t<ResponsesType>;
   using TrueWeightsType = std::decay_t<WeightsType>;
 
-  // Copy or move data.
-  TrueMatType tmpData(std::move(data));
+  // Copy or move responses and weights.
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  arma::uvec points = AllPoints(data.n_cols);
+
   // Set the correct dimensionality for the dimension selector.
-  dimensionSelector.Dimensions() = tmpData.n_rows;
+  dimensionSelector.Dimensions() = data.n_rows;
 
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses,
+  return Train<true>(data, points, 0, data.n_cols, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -598,7 +599,8 @@ double DecisionTreeRegressor<FitnessFunction,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& points,
     const size_t begin,
     const size_t count,
     const data::DatasetInfo& datasetInfo,
@@ -626,49 +628,61 @@ double DecisionTreeRegressor<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    // Collect the dimensions to search first, so that the dimension selector
+    // is used in the same order whether or not the search is parallel.
+    std::vector<size_t> dims;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
     {
-      double dimGain = -DBL_MAX;
+      dims.push_back(i);
+    }
+
+    // Each dimension is searched with its own split information and copy of
+    // the fitness function (which may cache statistics during the search), so
+    // that the dimensions can be searched in parallel.
+    auto searchDimension = [&](const size_t i,
+                               const double gain,
+                               arma::vec& dimSplitInfo,
+                               NumericAuxiliarySplitInfo& numericAux,
+                               CategoricalAuxiliarySplitInfo& categoricalAux)
+    {
+      FitnessFunction dimFitnessFunction(fitnessFunction);
       if (datasetInfo.Type(i) == data::Datatype::categorical)
       {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
+        return CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
+            GatherDimension(data, i, points, begin, count),
             datasetInfo.NumMappings(i),
             responses.cols(begin, begin + count - 1),
             UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
             minimumLeafSize,
             minimumGainSplit,
-            splitInfo,
-            *this,
-            fitnessFunction);
+            dimSplitInfo,
+            categoricalAux,
+            dimFitnessFunction);
       }
       else if (datasetInfo.Type(i) == data::Datatype::numeric)
       {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
+        return NumericSplit::template SplitIfBetter<UseWeights>(gain,
+            GatherDimension(data, i, points, begin, count),
             responses.cols(begin, begin + count - 1),
             UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
             minimumLeafSize,
             minimumGainSplit,
-            splitInfo,
-            *this,
-            fitnessFunction);
+            dimSplitInfo,
+            numericAux,
+            dimFitnessFunction);
       }
 
-      // If the splitter reported that it did not split, move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      // Was there an improvement?  If so mark that it's the new best dimension.
-      bestDim = i;
-      bestGain = dimGain;
+      return DBL_MAX;
+    };
 
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+    const size_t bestIndex = FindBestSplit(dims,
+        count * dims.size() >= ParallelSplitMinimum, minimumGainSplit,
+        bestGain, splitInfo,
+        static_cast<NumericAuxiliarySplitInfo&>(*this),
+        static_cast<CategoricalAuxiliarySplitInfo&>(*this), searchDimension);
+    if (bestIndex != dims.size())
+      bestDim = dims[bestIndex];
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -690,19 +704,19 @@ double DecisionTreeRegressor<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), splitInfo, *this);
+            data(bestDim, points[j]), splitInfo, *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
         childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), splitInfo, *this);
+            data(bestDim, points[j]), splitInfo, *this);
       }
     }
 
     // Figure out counts of children.
-    arma::Row<size_t> childCounts(numChildren);
+    arma::Row<size_t> childCounts(numChildren, arma::fill::zeros);
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
@@ -712,17 +726,19 @@ double DecisionTreeRegressor<FitnessFunction,
       bestGain = 0.0;
     }
 
-    // Split into children.
+    // Split into children: first move the points of each child together,
+    // then train the children, each of which only touches its own points.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          std::swap(points[currentCol], points[j]);
           responses.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -730,25 +746,40 @@ double DecisionTreeRegressor<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTreeRegressor* child = new DecisionTreeRegressor();
+      children.push_back(new DecisionTreeRegressor());
+    }
+
+    // Now build the children recursively, in parallel if this node is large
+    // enough.
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    auto trainChild = [&](const size_t i,
+                          DimensionSelectionType& childDimensionSelector)
+    {
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childCounts[i];
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, responses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
+        children[i]->template Train<UseWeights>(data, points, childBegin,
+            childCount, datasetInfo, responses, weights, childCount,
+            minimumGainSplit, maximumDepth - 1, childDimensionSelector,
+            fitnessFunction);
       }
       else
       {
         // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, responses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            points, childBegin, childCount, datasetInfo, responses, weights,
+            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
+            childDimensionSelector, fitnessFunction);
       }
-      children.push_back(child);
+    };
+    TrainChildren(numChildren, count >= ParallelBuildMinimum,
+        dimensionSelector, trainChild);
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -778,7 +809,8 @@ double DecisionTreeRegressor<FitnessFunction,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& points,
     const size_t begin,
     const size_t count,
     ResponsesType& responses,
@@ -808,34 +840,48 @@ double DecisionTreeRegressor<FitnessFunction,
 
   if (maximumDepth != 1)
   {
+    // Collect the dimensions to search first, so that the dimension selector
+    // is used in the same order whether or not the search is parallel.
+    std::vector<size_t> dims;
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
+      dims.push_back(i);
+    }
+
+    // Each dimension is searched with its own split information and copy of
+    // the fitness function (which may cache statistics during the search), so
+    // that the dimensions can be searched in parallel.
+    auto searchDimension = [&](const size_t i,
+                               const double gain,
+                               arma::vec& dimSplitInfo,
+                               NumericAuxiliarySplitInfo& numericAux,
+                               CategoricalAuxiliarySplitInfo& /* catAux */)
+    {
+      FitnessFunction dimFitnessFunction(fitnessFunction);
+      const arma::Row<typename MatType::elem_type> dimData =
+          GatherDimension(data, i, points, begin, count);
+      return NumericSplitType<FitnessFunction>::template
+          SplitIfBetter<UseWeights>(gain,
+                                    dimData,
                                     responses.cols(begin, begin + count - 1),
                                     UseWeights ?
                                         weights.cols(begin, begin + count - 1) :
                                         weights,
                                     minimumLeafSize,
                                     minimumGainSplit,
-                                    splitInfo,
-                                    *this,
-                                    fitnessFunction);
-
-      // If the splitter did not report that it improved, then move to the next
-      // dimension.
-      if (dimGain == DBL_MAX)
-        continue;
-
-      bestDim = i;
-      bestGain = dimGain;
-
-      // If the gain is the best possible, no need to keep looking.
-      if (bestGain >= 0.0)
-        break;
-    }
+                                    dimSplitInfo,
+                                    numericAux,
+                                    dimFitnessFunction);
+    };
+
+    const size_t bestIndex = FindBestSplit(dims,
+        count * dims.size() >= ParallelSplitMinimum, minimumGainSplit,
+        bestGain, splitInfo,
+        static_cast<NumericAuxiliarySplitInfo&>(*this),
+        static_cast<CategoricalAuxiliarySplitInfo&>(*this), searchDimension);
+    if (bestIndex != dims.size())
+      bestDim = dims[bestIndex];
   }
 
   // Did we split or not?  If so, then split the data and create the children.
@@ -852,7 +898,7 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), splitInfo, *this);
+          data(bestDim, points[j]), splitInfo, *this);
     }
 
     // Calculate counts of children in each node.
@@ -867,16 +913,19 @@ double DecisionTreeRegressor<FitnessFunction,
       bestGain = 0.0;
     }
 
+    // Split into children: first move the points of each child together,
+    // then train the children, each of which only touches its own points.
+    std::vector<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
+          std::swap(points[currentCol], points[j]);
           responses.swap_cols(currentCol, j);
           if (UseWeights)
             weights.swap_cols(currentCol, j);
@@ -884,25 +933,39 @@ double DecisionTreeRegressor<FitnessFunction,
         }
       }
 
-      // Now build the child recursively.
-      DecisionTreeRegressor* child = new DecisionTreeRegressor();
+      children.push_back(new DecisionTreeRegressor());
+    }
+
+    // Now build the children recursively, in parallel if this node is large
+    // enough.
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    auto trainChild = [&](const size_t i,
+                          DimensionSelectionType& childDimensionSelector)
+    {
+      const size_t childBegin = childBegins[i];
+      const size_t childCount = childCounts[i];
       if (NoRecursion)
       {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
+        children[i]->template Train<UseWeights>(data, points, childBegin,
+            childCount, responses, weights, childCount, minimumGainSplit,
+            maximumDepth - 1, childDimensionSelector, fitnessFunction);
       }
       else
       {
         // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        childGains[i] = children[i]->template Train<UseWeights>(data,
+            points, childBegin, childCount, responses, weights, minimumLeafSize,
+            minimumGainSplit, maximumDepth - 1, childDimensionSelector,
+            fitnessFunction);
       }
-      children.push_back(child);
+    };
+    TrainChildren(numChildren, count >= ParallelBuildMinimum,
+        dimensionSelector, trainChild);
+
+    if (!NoRecursion)
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
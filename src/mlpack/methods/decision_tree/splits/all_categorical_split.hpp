@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_DECISION_TREE_SPLITS_ALL_CATEGORICAL_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 
@@ -132,6 +133,18 @@ class AllCategoricalSplit
       const AuxiliarySplitInfo& /* aux */);
 };
 
+//! AllCategoricalSplit sends each category to its own child.
+template<typename FitnessFunction>
+class SplitTraits<AllCategoricalSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsThresholdSplit = false;
+  static const bool IsCategoryChildSplit = true;
+  static const bool IsCategoryTableSplit = false;
+  static const bool IsProjectionSplit = false;
+  static const bool HasSparseSearch = false;
+};
+
 } // namespace mlpack
 
 // Include implementation.
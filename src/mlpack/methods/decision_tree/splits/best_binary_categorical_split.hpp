@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_TREE_SPLITS_BEST_BINARY_CATEGORICAL_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
 
 namespace mlpack {
 
@@ -285,6 +286,18 @@ class BestBinaryCategoricalSplit
       size_t k = 0);
 };
 
+//! BestBinaryCategoricalSplit stores the child of each category in splitInfo.
+template<typename FitnessFunction>
+class SplitTraits<BestBinaryCategoricalSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsThresholdSplit = false;
+  static const bool IsCategoryChildSplit = false;
+  static const bool IsCategoryTableSplit = true;
+  static const bool IsProjectionSplit = false;
+  static const bool HasSparseSearch = false;
+};
+
 } // namespace mlpack
 
 // Include implementation.
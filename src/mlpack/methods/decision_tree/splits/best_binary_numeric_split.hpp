@@ -13,6 +13,8 @@
 #define MLPACK_METHODS_DECISION_TREE_SPLITS_BEST_BINARY_NUMERIC_SPLIT_HPP
 
 #include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
+#include "sparse_dimension.hpp"
 #include <mlpack/methods/decision_tree/fitness_functions/mse_gain.hpp>
 
 #include <mlpack/core/util/sfinae_utility.hpp>
@@ -84,6 +86,38 @@ class BestBinaryNumericSplit
       arma::vec& splitInfo,
       AuxiliarySplitInfo& aux);
 
+  /**
+   * Check if we can split a node, like the overload above, for a dimension of
+   * a node of a classification tree trained on sparse data.  Only the nonzero
+   * values are visited (the zeros are one group of equal values), so this
+   * takes time proportional to the number of nonzero values of the dimension
+   * in the node; the split found is the same as for the dense dimension.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The nonzero values of the dimension to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename ElemType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const SparseDimension<ElemType>& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
   /**
    * Check if we can split a node.  If we can split a node in a way that
    * improves on 'bestGain', then we return the improved gain.  Otherwise we
@@ -185,6 +219,18 @@ class BestBinaryNumericSplit
       const AuxiliarySplitInfo& /* aux */);
 };
 
+//! BestBinaryNumericSplit is a threshold split.
+template<typename FitnessFunction>
+class SplitTraits<BestBinaryNumericSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsThresholdSplit = true;
+  static const bool IsCategoryChildSplit = false;
+  static const bool IsCategoryTableSplit = false;
+  static const bool IsProjectionSplit = false;
+  static const bool HasSparseSearch = true;
+};
+
 } // namespace mlpack
 
 // Include implementation.
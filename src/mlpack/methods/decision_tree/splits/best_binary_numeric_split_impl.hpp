@@ -203,6 +203,186 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   return bestFoundGain;
 }
 
+// Overload used for classification on sparse data.
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType, typename WeightVecType>
+double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const SparseDimension<ElemType>& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t n = data.n_elem;
+  if (n < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // The sorted values of the dimension are the negative values, then the
+  // zeros, then the positive values.
+  const size_t numZeros = n - data.numNonzeros;
+  const size_t numNegative = std::lower_bound(data.values,
+      data.values + data.numNonzeros, ElemType(0)) - data.values;
+  auto sortedValue = [&](const size_t i)
+  {
+    if (i < numNegative)
+      return data.values[i];
+    else if (i < numNegative + numZeros)
+      return ElemType(0);
+    else
+      return data.values[i - numZeros];
+  };
+
+  // Sanity check: if the first element is the same as the last, we can't split
+  // in this dimension.
+  if (sortedValue(0) == sortedValue(n - 1))
+    return DBL_MAX;
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // Start with every point on the right; the counts of the zeros are those of
+  // the node, minus those of the nonzero values.
+  arma::Mat<size_t> classCounts;
+  arma::Col<size_t> zeroCounts;
+  arma::mat classWeightSums;
+  arma::vec zeroWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  double zeroWeight = 0.0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 2);
+    classWeightSums.col(1) = *data.classWeights;
+    zeroWeightSums = *data.classWeights;
+    for (size_t i = 0; i < data.numNonzeros; ++i)
+      zeroWeightSums[labels[data.positions[i]]] -= weights[data.positions[i]];
+
+    totalWeight = accu(*data.classWeights);
+    totalRightWeight = totalWeight;
+    zeroWeight = accu(zeroWeightSums);
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    classCounts.zeros(numClasses, 2);
+    classCounts.col(1) = *data.classCounts;
+    zeroCounts = *data.classCounts;
+    for (size_t i = 0; i < data.numNonzeros; ++i)
+      --zeroCounts[labels[data.positions[i]]];
+
+    bestFoundGain *= n;
+  }
+
+  // Move the points to the left in sorted order, one nonzero value or all the
+  // zeros at a time, and try to split after each move.  `index` is the number
+  // of points on the left.
+  size_t index = 0;
+  size_t next = 0;
+  bool zerosMoved = (numZeros == 0);
+  while (index < n - minimum)
+  {
+    if (next == numNegative && !zerosMoved)
+    {
+      if (UseWeights)
+      {
+        classWeightSums.col(0) += zeroWeightSums;
+        classWeightSums.col(1) -= zeroWeightSums;
+        totalLeftWeight += zeroWeight;
+        totalRightWeight -= zeroWeight;
+      }
+      else
+      {
+        classCounts.col(0) += zeroCounts;
+        classCounts.col(1) -= zeroCounts;
+      }
+
+      index += numZeros;
+      zerosMoved = true;
+    }
+    else
+    {
+      const size_t position = data.positions[next];
+      if (UseWeights)
+      {
+        classWeightSums(labels[position], 0) += weights[position];
+        classWeightSums(labels[position], 1) -= weights[position];
+        totalLeftWeight += weights[position];
+        totalRightWeight -= weights[position];
+      }
+      else
+      {
+        ++classCounts(labels[position], 0);
+        --classCounts(labels[position], 1);
+      }
+
+      ++index;
+      ++next;
+    }
+
+    // Make sure that the split is allowed and that the value has changed.
+    if (index < minimum || index >= n - minimum ||
+        sortedValue(index - 1) == sortedValue(index))
+      continue;
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
+            numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
+            numClasses, index);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
+            numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
+            numClasses, size_t(n - index));
+
+    double gain;
+    if (UseWeights)
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    else
+      gain = double(index) * leftGain + double(n - index) * rightGain;
+
+    if (gain >= 0.0 || gain > bestFoundGain)
+    {
+      // The split value is halfway between the values at index - 1 and index;
+      // as for dense data, make sure that it is below the upper value.
+      splitInfo.set_size(1);
+      splitInfo[0] = (sortedValue(index - 1) + sortedValue(index)) / 2.0;
+      if (splitInfo[0] == sortedValue(index))
+        splitInfo[0] = std::nexttoward(splitInfo[0], sortedValue(index - 1));
+
+      // No split will be better than this one, so take it.
+      if (gain >= 0.0)
+        return gain;
+
+      bestFoundGain = gain;
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= n;
+
+  return bestFoundGain;
+}
+
 // Overload used for regression.
 template<typename FitnessFunction>
 template<bool UseWeights, typename VecType, typename ResponsesType,
@@ -0,0 +1,452 @@
+/**
+ * @file methods/decision_tree/splits/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split between
+ * the bins of a histogram.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLITS_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLITS_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+namespace mlpack {
+
+// Overload used for classification.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::Row<unsigned char> bins;
+  arma::vec binMin, binMax;
+  const size_t numBins = ComputeBins(data, bins, binMin, binMax);
+
+  // Sanity check: if all points are in the same bin, we can't split in this
+  // dimension.
+  if (numBins == 1)
+    return DBL_MAX;
+
+  // Count the number of points (or the weight) of each class in each bin.  The
+  // last two columns hold the counts of the left and right child during the
+  // scan.
+  const size_t left = numBins;
+  const size_t right = numBins + 1;
+  arma::Row<size_t> binCounts(numBins, arma::fill::zeros);
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, numBins + 2);
+    for (size_t i = 0; i < data.n_elem; ++i)
+    {
+      ++binCounts[bins[i]];
+      classWeightSums(labels[i], bins[i]) += weights[i];
+    }
+
+    // All points start on the right.
+    classWeightSums.col(right) = sum(classWeightSums.cols(0, numBins - 1), 1);
+    totalWeight = accu(classWeightSums.col(right));
+    totalRightWeight = totalWeight;
+  }
+  else
+  {
+    classCounts.zeros(numClasses, numBins + 2);
+    for (size_t i = 0; i < data.n_elem; ++i)
+    {
+      ++binCounts[bins[i]];
+      ++classCounts(labels[i], bins[i]);
+    }
+
+    // All points start on the right.
+    classCounts.col(right) = sum(classCounts.cols(0, numBins - 1), 1);
+  }
+
+  // Loop through the boundaries between non-empty bins, choosing the best one.
+  // Also, force a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  bestFoundGain *= UseWeights ? totalWeight : (double) data.n_elem;
+
+  size_t leftCount = 0;
+  size_t bin = 0;
+  while (bin < numBins)
+  {
+    // Move the points of this bin to the left child; the counts of the right
+    // child are those of the whole node minus those of the left child.
+    if (UseWeights)
+    {
+      classWeightSums.col(left) += classWeightSums.col(bin);
+      classWeightSums.col(right) -= classWeightSums.col(bin);
+      const double binWeight = accu(classWeightSums.col(bin));
+      totalLeftWeight += binWeight;
+      totalRightWeight -= binWeight;
+    }
+    else
+    {
+      classCounts.col(left) += classCounts.col(bin);
+      classCounts.col(right) -= classCounts.col(bin);
+    }
+    leftCount += binCounts[bin];
+
+    // The split goes between this bin and the next non-empty bin.
+    size_t next = bin + 1;
+    while (next < numBins && binCounts[next] == 0)
+      ++next;
+    if (next == numBins)
+      break;
+
+    const size_t rightCount = data.n_elem - leftCount;
+    if (rightCount < minimum)
+      break;
+    if (leftCount < minimum)
+    {
+      bin = next;
+      continue;
+    }
+
+    // Calculate the gain for the left and right child.  Only use weights if
+    // needed.
+    const double leftGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(
+            classWeightSums.colptr(left), numClasses, totalLeftWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(left),
+            numClasses, leftCount);
+    const double rightGain = UseWeights ?
+        FitnessFunction::template EvaluatePtr<true>(
+            classWeightSums.colptr(right), numClasses, totalRightWeight) :
+        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(right),
+            numClasses, rightCount);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(leftCount) * leftGain + double(rightCount) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.
+      SetSplitValue(binMax[bin], binMin[next], splitInfo);
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      SetSplitValue(binMax[bin], binMin[next], splitInfo);
+      improved = true;
+    }
+
+    bin = next;
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+// Overload used for regression.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    FitnessFunction& fitnessFunction)
+{
+  using RType = typename ResponsesType::elem_type;
+  using WType = typename WeightVecType::elem_type;
+  constexpr bool optimized =
+      HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::Row<unsigned char> bins;
+  arma::vec binMin, binMax;
+  const size_t numBins = ComputeBins(data, bins, binMin, binMax);
+
+  // Sanity check: if all points are in the same bin, we can't split in this
+  // dimension.
+  if (numBins == 1)
+    return DBL_MAX;
+
+  // Order the responses (and weights) by bin with a counting sort.
+  arma::Row<size_t> binStarts(numBins, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+    ++binStarts[bins[i]];
+  size_t start = 0;
+  for (size_t b = 0; b < numBins; ++b)
+  {
+    const size_t count = binStarts[b];
+    binStarts[b] = start;
+    start += count;
+  }
+
+  arma::Row<RType> sortedResponses(responses.n_elem);
+  arma::Row<WType> sortedWeights;
+  arma::Row<unsigned char> sortedBins(data.n_elem);
+  if (UseWeights)
+    sortedWeights.set_size(sortedResponses.n_elem);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t j = binStarts[bins[i]]++;
+    sortedResponses[j] = responses[i];
+    sortedBins[j] = bins[i];
+    if (UseWeights)
+      sortedWeights[j] = weights[i];
+  }
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  WType totalWeight = 0.0;
+  WType leftChildWeight = 0.0;
+  WType rightChildWeight = 0.0;
+
+  if (UseWeights)
+  {
+    totalWeight = accu(sortedWeights);
+    bestFoundGain *= totalWeight;
+
+    for (size_t i = 0; i < minimum - 1; ++i)
+      leftChildWeight += sortedWeights[i];
+
+    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+      rightChildWeight += sortedWeights[i];
+  }
+  else
+  {
+    bestFoundGain *= data.n_elem;
+  }
+
+  // Initialize and precompute various statistics to efficiently compute gain
+  // values for all possible splits, if the fitness function allows it.
+  if constexpr (optimized)
+  {
+    fitnessFunction.template BinaryScanInitialize<UseWeights>(sortedResponses,
+        sortedWeights, minimum);
+  }
+
+  // Loop through all boundaries between bins, choosing the best one.
+  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  {
+    if (UseWeights)
+    {
+      leftChildWeight += sortedWeights[index - 1];
+      rightChildWeight -= sortedWeights[index - 1];
+    }
+
+    // Steps through the current index and updates the cached data.
+    if constexpr (optimized)
+    {
+      fitnessFunction.template BinaryStep<UseWeights>(sortedResponses,
+          sortedWeights, index - 1);
+    }
+
+    // Make sure that the bin has changed.
+    if (sortedBins[index] == sortedBins[index - 1])
+      continue;
+
+    // Calculate the gain for the left and right child.
+    double leftGain, rightGain;
+    if constexpr (optimized)
+    {
+      std::tuple<double, double> binaryGains = fitnessFunction.BinaryGains();
+      leftGain = std::get<0>(binaryGains);
+      rightGain = std::get<1>(binaryGains);
+    }
+    else
+    {
+      leftGain = fitnessFunction.template Evaluate<UseWeights>(sortedResponses,
+          sortedWeights, 0, index);
+      rightGain = fitnessFunction.template Evaluate<UseWeights>(
+          sortedResponses, sortedWeights, index, responses.n_elem);
+    }
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = leftChildWeight * leftGain + rightChildWeight * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(index) * leftGain +
+          double(sortedResponses.n_elem - index) * rightGain;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.
+      SetSplitValue(binMax[sortedBins[index - 1]], binMin[sortedBins[index]],
+          splitInfo);
+      return gain;
+    }
+    if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      SetSplitValue(binMax[sortedBins[index - 1]], binMin[sortedBins[index]],
+          splitInfo);
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const arma::vec& splitInfo,
+    const AuxiliarySplitInfo& /* aux */)
+{
+  if (splitInfo.n_elem == 0)
+    return SIZE_MAX;
+  else if (point <= splitInfo[0])
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+size_t HistogramNumericSplit<FitnessFunction>::ComputeBins(
+    const VecType& data,
+    arma::Row<unsigned char>& bins,
+    arma::vec& binMin,
+    arma::vec& binMax)
+{
+  using ElemType = typename VecType::elem_type;
+
+  // Without points, there is nothing to split.
+  if (data.n_elem == 0)
+    return 1;
+
+  // Take an evenly strided sample of the points, and sort it.
+  const size_t stride = (data.n_elem + SampleSize - 1) / SampleSize;
+  arma::Col<ElemType> sample((data.n_elem + stride - 1) / stride);
+  for (size_t i = 0; i < sample.n_elem; ++i)
+    sample[i] = data[i * stride];
+  sample = arma::sort(sample);
+
+  // If the sample has few enough distinct values, each of them gets its own
+  // bin.  Otherwise, the bin edges are quantiles of the sample.  The largest
+  // value does not need an edge, since the last bin holds everything above the
+  // last edge.
+  arma::Col<ElemType> edges = arma::unique(sample);
+  if (edges.n_elem > MaxBins)
+  {
+    edges.set_size(MaxBins - 1);
+    for (size_t i = 0; i < MaxBins - 1; ++i)
+      edges[i] = sample[((i + 1) * sample.n_elem) / MaxBins - 1];
+    edges = arma::unique(edges);
+  }
+  else
+  {
+    edges.shed_row(edges.n_elem - 1);
+  }
+
+  // Assign each point to its bin with a binary search.
+  const size_t numBins = edges.n_elem + 1;
+  bins.set_size(data.n_elem);
+  binMin.set_size(numBins);
+  binMin.fill(DBL_MAX);
+  binMax.set_size(numBins);
+  binMax.fill(-DBL_MAX);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const ElemType value = data[i];
+    const size_t bin = std::lower_bound(edges.begin(), edges.end(), value) -
+        edges.begin();
+    bins[i] = (unsigned char) bin;
+    binMin[bin] = std::min(binMin[bin], (double) value);
+    binMax[bin] = std::max(binMax[bin], (double) value);
+  }
+
+  return numBins;
+}
+
+template<typename FitnessFunction>
+void HistogramNumericSplit<FitnessFunction>::SetSplitValue(
+    const double leftMax,
+    const double rightMin,
+    arma::vec& splitInfo)
+{
+  // The split value is halfway between the largest value on the left and the
+  // smallest value on the right.
+  splitInfo.set_size(1);
+  splitInfo[0] = (leftMax + rightMin) / 2.0;
+
+  // In some very extreme cases, floating-point inaccuracies can lead to the
+  // split result being the upper bound, which is problematic for later as all
+  // the child points will be sent to the left child.  If this happens, bump it
+  // down incrementally.
+  if (splitInfo[0] == rightMin)
+    splitInfo[0] = std::nexttoward(splitInfo[0], leftMax);
+}
+
+} // namespace mlpack
+
+#endif
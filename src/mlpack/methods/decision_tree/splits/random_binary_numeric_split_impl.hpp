@@ -136,6 +136,136 @@ double RandomBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   return gain;
 }
 
+// Overload used for classification on sparse data.
+template<typename FitnessFunction>
+template<bool UseWeights, typename ElemType, typename WeightVecType>
+double RandomBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const SparseDimension<ElemType>& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */,
+    const bool splitIfBetterGain)
+{
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  // Forcing a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // First sanity check: if we don't have enough points, we can't split.
+  const size_t n = data.n_elem;
+  if (n < (minimum * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // The nonzero values are sorted; the zeros count if there are any.
+  const size_t numZeros = n - data.numNonzeros;
+  ElemType minValue = (data.numNonzeros > 0) ? data.values[0] : ElemType(0);
+  ElemType maxValue = (data.numNonzeros > 0) ?
+      data.values[data.numNonzeros - 1] : ElemType(0);
+  if (numZeros > 0)
+  {
+    minValue = std::min(minValue, ElemType(0));
+    maxValue = std::max(maxValue, ElemType(0));
+  }
+
+  // Sanity check: if the maximum element is the same as the minimum, we
+  // can't split in this dimension.
+  if (maxValue == minValue)
+    return DBL_MAX;
+
+  // Picking a random pivot to split the dimension.
+  double randomPivot = Random(minValue, maxValue);
+
+  // Only the nonzero values are visited: if the zeros are on the right, count
+  // the nonzero values on the left (below the pivot), and otherwise those on
+  // the right.  The counts of the other side are those of the node minus
+  // these.
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  const bool zerosLeft = (numZeros > 0 && 0 < randomPivot);
+  const size_t side = zerosLeft ? 1 : 0;
+  size_t sideSize = 0;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 2);
+    totalWeight = accu(*data.classWeights);
+    bestFoundGain *= totalWeight;
+
+    for (size_t i = 0; i < data.numNonzeros; ++i)
+    {
+      if ((data.values[i] < randomPivot) == (side == 0))
+      {
+        ++sideSize;
+        classWeightSums(labels[data.positions[i]], side) +=
+            weights[data.positions[i]];
+      }
+    }
+
+    classWeightSums.col(1 - side) = *data.classWeights -
+        classWeightSums.col(side);
+    totalLeftWeight = accu(classWeightSums.col(0));
+    totalRightWeight = accu(classWeightSums.col(1));
+  }
+  else
+  {
+    classCounts.zeros(numClasses, 2);
+    bestFoundGain *= n;
+
+    for (size_t i = 0; i < data.numNonzeros; ++i)
+    {
+      if ((data.values[i] < randomPivot) == (side == 0))
+      {
+        ++sideSize;
+        ++classCounts(labels[data.positions[i]], side);
+      }
+    }
+
+    classCounts.col(1 - side) = *data.classCounts - classCounts.col(side);
+  }
+  const size_t leftLeafSize = (side == 0) ? sideSize : n - sideSize;
+  const size_t rightLeafSize = n - leftLeafSize;
+
+  // Calculate the gain for the left and right child.  Only use weights if
+  // needed.
+  const double leftGain = UseWeights ?
+      FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
+          numClasses, totalLeftWeight) :
+      FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
+          numClasses, leftLeafSize);
+  const double rightGain = UseWeights ?
+      FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
+          numClasses, totalRightWeight) :
+      FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
+          numClasses, rightLeafSize);
+
+  double gain;
+  if (UseWeights)
+    gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+  else
+    gain = double(leftLeafSize) * leftGain + double(rightLeafSize) * rightGain;
+
+  if (gain < bestFoundGain && splitIfBetterGain)
+    return DBL_MAX;
+
+  splitInfo.set_size(1);
+  splitInfo[0] = randomPivot;
+
+  if (UseWeights)
+    gain /= totalWeight;
+  else
+    gain /= n;
+
+  return gain;
+}
+
 // Overload used for regression.
 template<typename FitnessFunction>
 template<bool UseWeights, typename VecType, typename WeightVecType>
@@ -0,0 +1,151 @@
+/**
+ * @file methods/decision_tree/splits/random_projection_split.hpp
+ *
+ * A tree splitter that finds the best binary split of the data projected onto
+ * a sparse random direction.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLITS_RANDOM_PROJECTION_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLITS_RANDOM_PROJECTION_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "split_traits.hpp"
+#include "best_binary_numeric_split.hpp"
+
+namespace mlpack {
+
+/**
+ * The RandomProjectionSplit is a splitting function for decision trees that
+ * splits the points of a node with an oblique hyperplane instead of a
+ * threshold on a single dimension, in the spirit of the random projections of
+ * RPTreeMaxSplit and of sparse projection oblique forests:
+ *
+ * @code
+ * @article{tomita2020sparse,
+ *   title={{Sparse Projection Oblique Randomer Forests}},
+ *   author={Tomita, T.M. and Browne, J. and Shen, C. and Chung, J. and
+ *       Patsolic, J.L. and Falk, B. and Priebe, C.E. and Yim, J. and Burns, R.
+ *       and Maggioni, M. and Vogelstein, J.T.},
+ *   journal={Journal of Machine Learning Research},
+ *   volume={21},
+ *   number={104},
+ *   pages={1--39},
+ *   year={2020}
+ * }
+ * @endcode
+ *
+ * Each dimension that the tree searches is the anchor of one sparse random
+ * direction: the anchor dimension is combined with about sqrt(d) - 1 other
+ * dimensions chosen at random among the `d` searched dimensions, each with a
+ * random sign and scaled by the inverse of its range over the points of the
+ * node, so that the direction does not depend on the units of the dimensions.
+ * The best threshold on the projected values is then found like
+ * BestBinaryNumericSplit does.  The axis-aligned split on the anchor dimension
+ * is searched too, and the oblique split is only used if it improves on it by
+ * at least the minimum gain, so the split of a node is never worse than the
+ * one BestBinaryNumericSplit would find.
+ *
+ * The direction is stored in the split information, as the threshold followed
+ * by (dimension, coefficient) pairs; so a tree that uses this split has to
+ * compute the direction of a point from the whole point.  This is described
+ * by SplitTraits::IsProjectionSplit.  Only classification is supported.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class RandomProjectionSplit
+{
+ public:
+  // No extra info needed for split.
+  class AuxiliarySplitInfo { };
+
+  /**
+   * Check if we can split a node with the projection anchored at the given
+   * dimension.  If we can split a node in a way that improves on 'bestGain',
+   * then we return the improved gain.  Otherwise we return DBL_MAX.  If a
+   * split is made, then splitInfo and aux may be modified.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dataset.
+   * @param points Indices in the dataset of the points of the node.
+   * @param begin Index in `points` of the first point of the node.
+   * @param count Number of points of the node.
+   * @param dimension The anchor dimension of the projection.
+   * @param dims The numeric dimensions that may be combined with the anchor
+   *      dimension.
+   * @param labels Labels for each point of the node.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename MatType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const MatType& data,
+      const arma::uvec& points,
+      const size_t begin,
+      const size_t count,
+      const size_t dimension,
+      const std::vector<size_t>& dims,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
+  /**
+   * If a split was found, returns the number of children of the split.
+   * Otherwise returns zero. A binary split always has two children.
+   */
+  static size_t NumChildren(const arma::vec& splitInfo,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return splitInfo.n_elem == 0 ? 0 : 2;
+  }
+
+  /**
+   * In the case that a split was found, given a point, calculate
+   * which child it should go to (left or right). Otherwise if
+   * there was no split, returns SIZE_MAX.
+   *
+   * @param point Point to calculate direction of (all of its dimensions).
+   * @param splitInfo Auxiliary information for the split.
+   * @param * (aux) Auxiliary information for the split (Unused).
+   */
+  template<typename VecType>
+  static size_t CalculateDirection(
+      const VecType& point,
+      const arma::vec& splitInfo,
+      const AuxiliarySplitInfo& /* aux */);
+};
+
+//! RandomProjectionSplit needs the whole point to compute a direction.
+template<typename FitnessFunction>
+class SplitTraits<RandomProjectionSplit<FitnessFunction>>
+{
+ public:
+  static const bool IsThresholdSplit = false;
+  static const bool IsCategoryChildSplit = false;
+  static const bool IsCategoryTableSplit = false;
+  static const bool IsProjectionSplit = true;
+  static const bool HasSparseSearch = false;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "random_projection_split_impl.hpp"
+
+#endif
@@ -0,0 +1,147 @@
+/**
+ * @file methods/decision_tree/splits/random_projection_split_impl.hpp
+ *
+ * Implementation of the RandomProjectionSplit splitter.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLITS_RANDOM_PROJECTION_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLITS_RANDOM_PROJECTION_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "random_projection_split.hpp"
+
+namespace mlpack {
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename MatType, typename WeightVecType>
+double RandomProjectionSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const MatType& data,
+    const arma::uvec& points,
+    const size_t begin,
+    const size_t count,
+    const size_t dimension,
+    const std::vector<size_t>& dims,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& /* aux */)
+{
+  using ThresholdSplit = BestBinaryNumericSplit<FitnessFunction>;
+  typename ThresholdSplit::AuxiliarySplitInfo thresholdAux;
+
+  // First search the axis-aligned split on the anchor dimension.
+  arma::rowvec values(count);
+  for (size_t j = 0; j < count; ++j)
+    values[j] = data(dimension, points[begin + j]);
+
+  arma::vec axisInfo;
+  const double axisGain = ThresholdSplit::template SplitIfBetter<UseWeights>(
+      bestGain, values, labels, numClasses, weights, minimumLeafSize,
+      minimumGainSplit, axisInfo, thresholdAux);
+
+  // Choose the other dimensions of the direction.
+  const size_t numNonzeros =
+      (size_t) std::ceil(std::sqrt((double) dims.size()));
+  std::vector<size_t> directionDims(1, dimension);
+  while (directionDims.size() < std::min(numNonzeros, dims.size()))
+  {
+    const size_t d = dims[RandInt(dims.size())];
+    if (std::find(directionDims.begin(), directionDims.end(), d) ==
+        directionDims.end())
+      directionDims.push_back(d);
+  }
+
+  // Scale each dimension by the inverse of its range over the node, dropping
+  // the dimensions that are constant.
+  std::vector<std::pair<size_t, double>> direction;
+  for (size_t t = 0; t < directionDims.size(); ++t)
+  {
+    const size_t d = directionDims[t];
+    double minValue = DBL_MAX;
+    double maxValue = -DBL_MAX;
+    for (size_t j = 0; j < count; ++j)
+    {
+      const double value = data(d, points[begin + j]);
+      minValue = std::min(minValue, value);
+      maxValue = std::max(maxValue, value);
+    }
+
+    if (maxValue > minValue)
+    {
+      // The anchor dimension always has a positive coefficient.
+      const double sign = (t == 0 || RandInt(2) == 0) ? 1.0 : -1.0;
+      direction.emplace_back(d, sign / (maxValue - minValue));
+    }
+  }
+
+  // Now search the split on the projected values, which has to improve on the
+  // axis-aligned split.
+  double obliqueGain = DBL_MAX;
+  arma::vec obliqueInfo;
+  if (direction.size() > 1)
+  {
+    values.zeros();
+    for (size_t j = 0; j < count; ++j)
+    {
+      for (size_t t = 0; t < direction.size(); ++t)
+      {
+        values[j] += direction[t].second *
+            data(direction[t].first, points[begin + j]);
+      }
+    }
+
+    obliqueGain = ThresholdSplit::template SplitIfBetter<UseWeights>(
+        (axisGain == DBL_MAX) ? bestGain : axisGain, values, labels,
+        numClasses, weights, minimumLeafSize, minimumGainSplit, obliqueInfo,
+        thresholdAux);
+  }
+
+  if (obliqueGain != DBL_MAX)
+  {
+    splitInfo.set_size(1 + 2 * direction.size());
+    splitInfo[0] = obliqueInfo[0];
+    for (size_t t = 0; t < direction.size(); ++t)
+    {
+      splitInfo[1 + 2 * t] = (double) direction[t].first;
+      splitInfo[2 + 2 * t] = direction[t].second;
+    }
+
+    return obliqueGain;
+  }
+  else if (axisGain != DBL_MAX)
+  {
+    splitInfo = { axisInfo[0], (double) dimension, 1.0 };
+    return axisGain;
+  }
+
+  return DBL_MAX;
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+size_t RandomProjectionSplit<FitnessFunction>::CalculateDirection(
+    const VecType& point,
+    const arma::vec& splitInfo,
+    const AuxiliarySplitInfo& /* aux */)
+{
+  if (splitInfo.n_elem == 0)
+    return SIZE_MAX;
+
+  double value = 0.0;
+  for (size_t t = 1; t < splitInfo.n_elem; t += 2)
+    value += splitInfo[t + 1] * point[(size_t) splitInfo[t]];
+
+  return (value <= splitInfo[0]) ? 0 : 1;
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,161 @@
+/**
+ * @file methods/decision_tree/splits/sparse_dimension.hpp
+ *
+ * Definition of SparseDimension, the nonzero values of one dimension of the
+ * points of a node, which numeric splits search when a classification tree is
+ * trained on sparse data; and SparseNode, which collects them for all
+ * dimensions of a node.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLITS_SPARSE_DIMENSION_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLITS_SPARSE_DIMENSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * One dimension of the points of a node of a classification tree trained on
+ * sparse data.  Only the nonzero values are held, in ascending order, with the
+ * position of the point of each value among the points of the node; every
+ * other point of the node has the value zero.  The zeros are treated as a
+ * single group of equal values, so a numeric split that supports this (see
+ * SplitTraits::HasSparseSearch) searches a dimension in time proportional to
+ * its number of nonzero values, and counts the zeros of each class from the
+ * class counts of the whole node.
+ *
+ * @tparam ElemType Type of the values.
+ */
+template<typename ElemType>
+struct SparseDimension
+{
+  //! The number of points of the node.
+  size_t n_elem;
+  //! The number of nonzero values.
+  size_t numNonzeros;
+  //! The nonzero values, in ascending order.
+  const ElemType* values;
+  //! The position among the points of the node of the point of each value.
+  const size_t* positions;
+  //! The number of points of each class among all the points of the node.
+  const arma::Col<size_t>* classCounts;
+  //! The sum of the weights of the points of each class among all the points
+  //! of the node (only set if the tree is trained with weights).
+  const arma::vec* classWeights;
+};
+
+/**
+ * The nonzero values of all dimensions of the points of a node of a
+ * classification tree trained on sparse data, collected once per node by
+ * visiting only the nonzero elements of the points, and sorted by dimension
+ * and then by value.
+ *
+ * @tparam ElemType Type of the values.
+ */
+template<typename ElemType>
+class SparseNode
+{
+ public:
+  /**
+   * Collect the nonzero values of the points `points[begin]` to
+   * `points[begin + count - 1]` of the given sparse dataset, and the class
+   * counts (and weight sums) of the points.
+   *
+   * @param data Sparse dataset.
+   * @param points Indices of the points of the dataset.
+   * @param begin Index in `points` of the first point of the node.
+   * @param count Number of points of the node.
+   * @param labels Labels of the points, in the order of `points`.
+   * @param numClasses Number of classes.
+   * @param weights Weights of the points, in the order of `points` (only used
+   *     if UseWeights is true).
+   */
+  template<bool UseWeights, typename MatType, typename WeightsType>
+  void Build(const MatType& data,
+             const arma::uvec& points,
+             const size_t begin,
+             const size_t count,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             const WeightsType& weights)
+  {
+    numPoints = count;
+    data.sync();
+
+    std::vector<std::tuple<size_t, ElemType, size_t>> entries;
+    for (size_t j = 0; j < count; ++j)
+    {
+      const size_t col = points[begin + j];
+      for (size_t k = data.col_ptrs[col]; k < data.col_ptrs[col + 1]; ++k)
+        entries.emplace_back(data.row_indices[k], data.values[k], j);
+    }
+    std::sort(entries.begin(), entries.end());
+
+    dimensions.resize(entries.size());
+    values.resize(entries.size());
+    positions.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+      dimensions[i] = std::get<0>(entries[i]);
+      values[i] = std::get<1>(entries[i]);
+      positions[i] = std::get<2>(entries[i]);
+    }
+
+    classCounts.zeros(numClasses);
+    if (UseWeights)
+      classWeights.zeros(numClasses);
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      ++classCounts[labels[j]];
+      if (UseWeights)
+        classWeights[labels[j]] += weights[j];
+    }
+  }
+
+  //! Return whether the given dimension has any nonzero value in the node.
+  bool HasNonzeros(const size_t dimension) const
+  {
+    return std::binary_search(dimensions.begin(), dimensions.end(),
+        dimension);
+  }
+
+  //! Get the given dimension of the points of the node.
+  SparseDimension<ElemType> Dimension(const size_t dimension) const
+  {
+    const size_t first = std::lower_bound(dimensions.begin(), dimensions.end(),
+        dimension) - dimensions.begin();
+    const size_t last = std::upper_bound(dimensions.begin() + first,
+        dimensions.end(), dimension) - dimensions.begin();
+
+    SparseDimension<ElemType> result;
+    result.n_elem = numPoints;
+    result.numNonzeros = last - first;
+    result.values = values.data() + first;
+    result.positions = positions.data() + first;
+    result.classCounts = &classCounts;
+    result.classWeights = &classWeights;
+    return result;
+  }
+
+ private:
+  //! The number of points of the node.
+  size_t numPoints = 0;
+  //! The dimension of each nonzero value, in ascending order.
+  std::vector<size_t> dimensions;
+  //! The nonzero values, in ascending order within each dimension.
+  std::vector<ElemType> values;
+  //! The position among the points of the node of each nonzero value.
+  std::vector<size_t> positions;
+  //! The number of points of each class.
+  arma::Col<size_t> classCounts;
+  //! The sum of the weights of the points of each class.
+  arma::vec classWeights;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file methods/decision_tree/splits/split_traits.hpp
+ *
+ * This file defines the SplitTraits class, which describes how a split type
+ * sends points to the children of a node, so that trained trees can be
+ * evaluated without calling the split type.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_SPLITS_SPLIT_TRAITS_HPP
+#define MLPACK_METHODS_DECISION_TREE_SPLITS_SPLIT_TRAITS_HPP
+
+namespace mlpack {
+
+/**
+ * The SplitTraits class describes the CalculateDirection() function of a
+ * decision tree split type.  A split type that does not specialize SplitTraits
+ * is assumed to have none of these properties, and trees that use it are
+ * always evaluated by calling CalculateDirection().
+ *
+ * @tparam SplitType The split type (e.g. BestBinaryNumericSplit<GiniGain>).
+ */
+template<typename SplitType>
+class SplitTraits
+{
+ public:
+  /**
+   * This is true if the split is binary, and sends a point to the first child
+   * if its value is at most splitInfo[0] and to the second child otherwise.
+   */
+  static const bool IsThresholdSplit = false;
+
+  /**
+   * This is true if the split sends a point with category `c` to child `c`.
+   */
+  static const bool IsCategoryChildSplit = false;
+
+  /**
+   * This is true if the split sends a point with category `c` to child
+   * splitInfo[c].
+   */
+  static const bool IsCategoryTableSplit = false;
+
+  /**
+   * This is true if the split needs the whole point to calculate its
+   * direction, instead of only the value of the split dimension.  Such a split
+   * is searched with the dataset and the points of the node, and is only
+   * supported for numeric splits of classification trees; see
+   * RandomProjectionSplit.
+   */
+  static const bool IsProjectionSplit = false;
+
+  /**
+   * This is true if the split can search a numeric dimension of a
+   * classification tree trained on sparse data given only its nonzero values,
+   * with a SplitIfBetter() overload that takes a SparseDimension instead of the
+   * values of the dimension.  Otherwise, the values of the dimension are
+   * collected into a dense vector.
+   */
+  static const bool HasSparseSearch = false;
+};
+
+} // namespace mlpack
+
+#endif
@@ -12,6 +12,10 @@
 #ifndef MLPACK_METHODS_DECISION_TREE_UTILS_HPP
 #define MLPACK_METHODS_DECISION_TREE_UTILS_HPP
 
+#ifdef MLPACK_USE_OPENMP
+  #include <omp.h>
+#endif
+
 namespace mlpack {
 
 /**
@@ -134,6 +138,171 @@ inline void Sum(const VecType& values,
   mean = total[0];
 }
 
+/**
+ * Collect the values in one dimension of the points `points[begin]` to
+ * `points[begin + count - 1]` of the dataset, so that the splits of a node can
+ * be searched on contiguous memory without reordering the dataset itself.
+ *
+ * @param data Dataset to collect the values from.
+ * @param dimension Dimension to collect.
+ * @param points Indices of the points of the dataset.
+ * @param begin Index in `points` of the first point to collect.
+ * @param count Number of points to collect.
+ */
+template<typename MatType>
+inline arma::Row<typename MatType::elem_type> GatherDimension(
+    const MatType& data,
+    const size_t dimension,
+    const arma::uvec& points,
+    const size_t begin,
+    const size_t count)
+{
+  arma::Row<typename MatType::elem_type> values(count);
+  for (size_t j = 0; j < count; ++j)
+    values[j] = data(dimension, points[begin + j]);
+
+  return values;
+}
+
+/**
+ * Search the given dimensions for the best split of a node, in parallel with
+ * OpenMP if requested.  Each dimension is searched against the gain of the
+ * node with its own split information, by calling
+ * `splitFunction(dimension, gain, splitInfo, numericAux, categoricalAux)`
+ * (which returns the gain of the split, or DBL_MAX if it found no split better
+ * than `gain`).  The best dimension is then chosen in the given order, so the
+ * result is the same as that of a sequential search that only keeps a split
+ * if it improves on the best split found so far.
+ *
+ * @param dims Dimensions to search, in order.
+ * @param parallel Whether to search the dimensions in parallel.
+ * @param minimumGainSplit Minimum gain for the node to split.
+ * @param bestGain Gain of the node; set to the gain of the best split.
+ * @param splitInfo Set to the split information of the best split.
+ * @param numericAux Set to the numeric auxiliary split information of the best
+ *     split.
+ * @param categoricalAux Set to the categorical auxiliary split information of
+ *     the best split.
+ * @param splitFunction Function that searches one dimension.
+ * @return The index in `dims` of the best dimension, or `dims.size()` if no
+ *     split is better than the node.
+ */
+template<typename NumericAuxType,
+         typename CategoricalAuxType,
+         typename SplitFunction>
+inline size_t FindBestSplit(const std::vector<size_t>& dims,
+                            const bool parallel,
+                            const double minimumGainSplit,
+                            double& bestGain,
+                            arma::vec& splitInfo,
+                            NumericAuxType& numericAux,
+                            CategoricalAuxType& categoricalAux,
+                            SplitFunction& splitFunction)
+{
+  std::vector<double> dimGains(dims.size(), DBL_MAX);
+  std::vector<arma::vec> dimSplitInfos(dims.size());
+  std::vector<NumericAuxType> dimNumericAuxs(dims.size(), numericAux);
+  std::vector<CategoricalAuxType> dimCategoricalAuxs(dims.size(),
+      categoricalAux);
+  const double nodeGain = bestGain;
+
+  #pragma omp parallel for schedule(dynamic) if (parallel)
+  for (size_t d = 0; d < dims.size(); ++d)
+  {
+    dimGains[d] = splitFunction(dims[d], nodeGain, dimSplitInfos[d],
+        dimNumericAuxs[d], dimCategoricalAuxs[d]);
+  }
+
+  size_t bestIndex = dims.size();
+  for (size_t d = 0; d < dims.size(); ++d)
+  {
+    // If the splitter did not report that it improved, or if it did not
+    // improve enough on the best dimension before it, move to the next
+    // dimension.
+    const double dimGain = dimGains[d];
+    if (dimGain == DBL_MAX || (dimGain < 0.0 &&
+        dimGain <= std::min(bestGain + minimumGainSplit, 0.0)))
+      continue;
+
+    bestIndex = d;
+    bestGain = dimGain;
+
+    // If the gain is the best possible, no need to keep looking.
+    if (bestGain >= 0.0)
+      break;
+  }
+
+  if (bestIndex != dims.size())
+  {
+    splitInfo = std::move(dimSplitInfos[bestIndex]);
+    numericAux = std::move(dimNumericAuxs[bestIndex]);
+    categoricalAux = std::move(dimCategoricalAuxs[bestIndex]);
+  }
+
+  return bestIndex;
+}
+
+/**
+ * Train the children of a node by calling `trainChild(i, dimensionSelector)`
+ * for each child `i`.  If `parallel` is true, the children are trained as
+ * OpenMP tasks (starting a team of threads if there is none yet), each with
+ * its own copy of the dimension selector, since dimension selectors have
+ * state; otherwise they are trained one after the other with the given
+ * dimension selector.
+ *
+ * @param numChildren Number of children to train.
+ * @param parallel Whether to train the children in parallel.
+ * @param dimensionSelector Dimension selector of the node.
+ * @param trainChild Function that trains one child.
+ */
+template<typename DimensionSelectionType, typename ChildFunction>
+inline void TrainChildren(const size_t numChildren,
+                          const bool parallel,
+                          DimensionSelectionType& dimensionSelector,
+                          ChildFunction& trainChild)
+{
+  #ifdef MLPACK_USE_OPENMP
+  if (parallel && numChildren > 1 && omp_get_max_threads() > 1)
+  {
+    auto trainTasks = [&]()
+    {
+      for (size_t i = 0; i < numChildren; ++i)
+      {
+        #pragma omp task firstprivate(i)
+        {
+          DimensionSelectionType childDimensionSelector(dimensionSelector);
+          trainChild(i, childDimensionSelector);
+        }
+      }
+
+      #pragma omp taskwait
+    };
+
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is large enough; start a team of threads
+      // that will run the tasks created below this node.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        trainTasks();
+      }
+    }
+    else
+    {
+      trainTasks();
+    }
+
+    return;
+  }
+  #else
+  (void) parallel;
+  #endif
+
+  for (size_t i = 0; i < numChildren; ++i)
+    trainChild(i, dimensionSelector);
+}
+
 } // namespace mlpack
 
 #endif
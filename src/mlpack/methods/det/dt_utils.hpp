@@ -48,6 +48,18 @@ template <typename MatType, typename TagType>
 void PrintVariableImportance(const DTree<MatType, TagType>* dtree,
                              const std::string viFile = "");
 
+/**
+ * Compute the sum of the density estimates of the given points, which is used
+ * to evaluate the pruned trees during cross-validation in Trainer().  The
+ * points are split into chunks that are evaluated as OpenMP tasks (when called
+ * from a parallel region); the result does not depend on the number of threads.
+ *
+ * @param dtree Density estimation tree to use.
+ * @param points Points to estimate the density of.
+ */
+template <typename MatType, typename TagType>
+double CVTestValue(const DTree<MatType, TagType>& dtree, const MatType& points);
+
 /**
  * Train the optimal decision tree using cross-validation with the given number
  * of folds.  Optionally, give a filename to print the unpruned tree to.  This
@@ -103,6 +103,37 @@ void PrintVariableImportance(const DTree<MatType, TagType>* dtree,
 }
 
 
+// Sum the density estimates of the given points, splitting them into tasks.
+template <typename MatType, typename TagType>
+double CVTestValue(const DTree<MatType, TagType>& dtree, const MatType& points)
+{
+  // The sums of the chunks are added in order, so that the result does not
+  // depend on the number of threads.
+  const size_t chunkSize = 1024;
+  const size_t numChunks = (points.n_cols + chunkSize - 1) / chunkSize;
+  std::vector<double> chunkValues(numChunks, 0.0);
+
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    #pragma omp task shared(dtree, points, chunkValues) firstprivate(c)
+    {
+      const size_t end = std::min((c + 1) * chunkSize, (size_t) points.n_cols);
+      double value = 0.0;
+      for (size_t i = c * chunkSize; i < end; ++i)
+      {
+        typename GetColType<MatType>::type point = points.unsafe_col(i);
+        value += dtree.ComputeValue(point);
+      }
+
+      chunkValues[c] = value;
+    }
+  }
+
+  #pragma omp taskwait
+
+  return std::accumulate(chunkValues.begin(), chunkValues.end(), 0.0);
+}
+
 // This function trains the optimal decision tree using the given number of
 // folds.
 template <typename MatType, typename TagType>
@@ -146,6 +177,11 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
   timers.Start("pruning_sequence");
 
+  // Keep the unpruned tree, which is pruned again with the optimal alpha once
+  // it has been found.  (This is cheaper than growing the tree again.)
+  DTree<MatType, TagType>* unprunedTree = new DTree<MatType, TagType>(*dtree);
+  const double unprunedAlpha = alpha;
+
   // Sequentially prune and save the alpha values and the values of c_t^2 * r_t.
   std::vector<std::pair<double, double> > prunedSequence;
   while (dtree->SubtreeLeaves() > 1)
@@ -180,9 +216,10 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
   regularizationConstants.fill(0.0);
 
   timers.Start("cross_validation");
-  // Go through each fold.
-  #pragma omp parallel for shared(prunedSequence, regularizationConstants)
-  for (size_t fold = 0; fold < (size_t) folds; fold++)
+  // Go through each fold.  The folds are run as tasks, so that threads that
+  // are done with their folds help grow the trees of the other folds and
+  // evaluate their test points (see CVTestValue()).
+  auto runFold = [&](const size_t fold)
   {
     // Break up data into train and test sets.
     const size_t start = fold * testSize;
@@ -227,12 +264,7 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
          i < ((prunedSequence.size() < 2) ? 0 : prunedSequence.size() - 2); ++i)
     {
       // Compute test values for this state of the tree.
-      double cvVal = 0.0;
-      for (size_t j = 0; j < test.n_cols; ++j)
-      {
-        arma::vec testPoint = test.unsafe_col(j);
-        cvVal += cvDTree.ComputeValue(testPoint);
-      }
+      const double cvVal = CVTestValue(cvDTree, test);
 
       // Update the cv regularization constant.
       cvRegularizationConstants[i] = 2.0 * cvVal / (double) cvData.n_cols;
@@ -244,12 +276,7 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
     }
 
     // Compute test values for this state of the tree.
-    double cvVal = 0.0;
-    for (size_t i = 0; i < test.n_cols; ++i)
-    {
-      typename GetColType<MatType>::type testPoint = test.unsafe_col(i);
-      cvVal += cvDTree.ComputeValue(testPoint);
-    }
+    const double cvVal = CVTestValue(cvDTree, test);
 
     if (prunedSequence.size() > 2)
     {
@@ -259,6 +286,20 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
     #pragma omp critical(DTreeCVUpdate)
     regularizationConstants += cvRegularizationConstants;
+  };
+
+  #pragma omp parallel
+  {
+    #pragma omp single
+    {
+      for (size_t fold = 0; fold < (size_t) folds; fold++)
+      {
+        #pragma omp task firstprivate(fold)
+        runFold(fold);
+      }
+
+      #pragma omp taskwait
+    }
   }
   timers.Stop("cross_validation");
 
@@ -281,24 +322,11 @@ DTree<MatType, TagType>* Trainer(MatType& dataset,
 
   Log::Info << "Optimal alpha: " << optimalAlpha << "." << std::endl;
 
-  // Re-Initialize the tree.
+  // Go back to the unpruned tree.
   delete dtree;
-  dtree = new DTree<MatType, TagType>(dataset);
-
-  // Getting ready to grow the tree...
-  for (size_t i = 0; i < oldFromNew.n_elem; ++i)
-    oldFromNew[i] = i;
-
-  // Save the dataset since it would be modified while growing the tree.
-  newDataset = dataset;
-
-  // Grow the tree.
+  dtree = unprunedTree;
   oldAlpha = -DBL_MAX;
-  alpha = dtree->Grow(newDataset,
-                         oldFromNew,
-                         useVolumeReg,
-                         maxLeafSize,
-                         minLeafSize);
+  alpha = unprunedAlpha;
 
   // Prune with optimal alpha.
   while ((oldAlpha < optimalAlpha) && (dtree->SubtreeLeaves() > 1))
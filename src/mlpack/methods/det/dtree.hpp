@@ -148,7 +148,9 @@ class DTree
 
   /**
    * Greedily expand the tree.  The points in the dataset will be reordered
-   * during tree growth.
+   * during tree growth.  For dense data, the points are sorted once in each
+   * dimension (using memory for one index per element of the dataset), and
+   * large subtrees are grown in parallel when OpenMP is enabled.
    *
    * @param data Dataset to build tree on.
    * @param oldFromNew Mappings from old points to new points.
@@ -335,14 +337,18 @@ class DTree
   // Utility methods.
 
   /**
-   * Find the dimension to split on.
+   * Find the dimension to split on.  If sortedIds is given, it holds the
+   * points of the node sorted in each dimension (see Grow()), and positions
+   * holds the column of each point.
    */
   bool FindSplit(const MatType& data,
                  size_t& splitDim,
                  ElemType& splitValue,
                  double& leftError,
                  double& rightError,
-                 const size_t minLeafSize = 5) const;
+                 const size_t minLeafSize = 5,
+                 const arma::Mat<size_t>* sortedIds = NULL,
+                 const arma::Col<size_t>* positions = NULL) const;
 
   /**
    * Split the data, returning the number of points left of the split.
@@ -354,6 +360,48 @@ class DTree
 
   void  FillMinMax(const StatType& mins,
                    const StatType& maxs);
+
+ private:
+  //! Nodes with at least this many points grow their children in parallel.
+  static constexpr size_t minParallelGrowSize = 4096;
+
+  /**
+   * Sort the points of the node in each dimension: column d of sortedIds holds
+   * the indices (from oldFromNew) of the points sorted by dimension d, and
+   * positions holds the column of each point.  Returns false (and the points
+   * are not sorted) if the indices in oldFromNew are not distinct.
+   */
+  bool Presort(const MatType& data,
+               const arma::Col<size_t>& oldFromNew,
+               arma::Mat<size_t>& sortedIds,
+               arma::Col<size_t>& positions) const;
+
+  /**
+   * After the points of the node were split at splitIndex by SplitData(),
+   * update their positions and split the sorted lists of the node into those
+   * of its children.
+   */
+  void SplitSortedIds(const arma::Col<size_t>& oldFromNew,
+                      const size_t splitIndex,
+                      arma::Mat<size_t>& sortedIds,
+                      arma::Col<size_t>& positions) const;
+
+  /**
+   * Greedily expand the tree from this node, using (and splitting) the sorted
+   * lists of the points if they are given.
+   */
+  double GrowNode(MatType& data,
+                  arma::Col<size_t>& oldFromNew,
+                  const bool useVolReg,
+                  const size_t maxLeafSize,
+                  const size_t minLeafSize,
+                  arma::Mat<size_t>* sortedIds,
+                  arma::Col<size_t>* positions);
+
+  //! Grow the children of this node with the given functions, in parallel if
+  //! the node is large enough.
+  template<typename LeftFunction, typename RightFunction>
+  void GrowChildren(LeftFunction& growLeft, RightFunction& growRight) const;
 };
 
 } // namespace mlpack
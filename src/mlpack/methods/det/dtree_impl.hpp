@@ -142,6 +142,35 @@ void ExtractSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
   }
 }
 
+// This version takes the points of the node in the given dimension already in
+// sorted order (as kept by Grow() for dense matrices), so no sort is needed.
+template<typename ElemType, typename MatType>
+void ExtractSortedSplits(std::vector<std::pair<ElemType, size_t>>& splitVec,
+                         const MatType& data,
+                         const arma::Mat<size_t>& sortedIds,
+                         const arma::Col<size_t>& positions,
+                         size_t dim,
+                         const size_t start,
+                         const size_t end,
+                         const size_t minLeafSize)
+{
+  using SplitItem = std::pair<ElemType, size_t>;
+  const size_t* ids = sortedIds.colptr(dim) + start;
+  const size_t n = end - start;
+
+  for (size_t i = minLeafSize - 1; i < n - minLeafSize; ++i)
+  {
+    // See the comments of ExtractSplits() above.  The midpoint is computed in
+    // double precision, as for arma::Mat.
+    const ElemType value = data(dim, positions[ids[i]]);
+    const ElemType split = ((double) value +
+        (double) data(dim, positions[ids[i + 1]])) / 2.0;
+
+    if (split != value)
+      splitVec.push_back(SplitItem(split, i + 1));
+  }
+}
+
 template<typename MatType, typename TagType>
 DTree<MatType, TagType>::DTree() :
     start(0),
@@ -403,6 +432,48 @@ DTree<MatType, TagType>::~DTree()
     delete right;
 }
 
+// Grow the children of this node, in parallel if the node is large enough.
+template<typename MatType, typename TagType>
+template<typename LeftFunction, typename RightFunction>
+void DTree<MatType, TagType>::GrowChildren(LeftFunction& growLeft,
+                                           RightFunction& growRight) const
+{
+  #ifdef MLPACK_USE_OPENMP
+  if (end - start >= minParallelGrowSize && omp_get_max_threads() > 1)
+  {
+    if (!omp_in_parallel())
+    {
+      // This is the first node that is large enough; start a team of threads
+      // that will run the tasks created below this node.
+      #pragma omp parallel
+      {
+        #pragma omp single
+        {
+          #pragma omp task
+          growLeft();
+
+          growRight();
+          #pragma omp taskwait
+        }
+      }
+    }
+    else
+    {
+      #pragma omp task
+      growLeft();
+
+      growRight();
+      #pragma omp taskwait
+    }
+
+    return;
+  }
+  #endif
+
+  growLeft();
+  growRight();
+}
+
 // This function computes the log-l2-negative-error of a given node from the
 // formula R(t) = log(|t|^2 / (N^2 V_t)).
 template<typename MatType, typename TagType>
@@ -432,7 +503,10 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
                                         ElemType& splitValue,
                                         double& leftError,
                                         double& rightError,
-                                        const size_t minLeafSize) const
+                                        const size_t minLeafSize,
+                                        const arma::Mat<size_t>* sortedIds,
+                                        const arma::Col<size_t>* positions)
+    const
 {
   using SplitItem = std::pair<ElemType, size_t>;
 
@@ -478,10 +552,19 @@ bool DTree<MatType, TagType>::FindSplit(const MatType& data,
     //   dimVec = arma::sort(dimVec);
     // could be quite inefficient for sparse matrices, due to
     // copy operations (3). This one has custom implementation for dense and
-    // sparse matrices.
+    // sparse matrices.  When Grow() keeps the points sorted in each
+    // dimension, the values are taken in that order instead.
 
     std::vector<SplitItem> splitVec;
-    ExtractSplits<ElemType>(splitVec, data, dim, start, end, minLeafSize);
+    if (sortedIds != NULL)
+    {
+      ExtractSortedSplits<ElemType>(splitVec, data, *sortedIds, *positions,
+          dim, start, end, minLeafSize);
+    }
+    else
+    {
+      ExtractSplits<ElemType>(splitVec, data, dim, start, end, minLeafSize);
+    }
 
     // Iterate on all the splits for this dimension
     for (typename std::vector<SplitItem>::iterator i = splitVec.begin();
@@ -578,6 +661,80 @@ size_t DTree<MatType, TagType>::SplitData(
   return left;
 }
 
+// Sort the points of the node in each dimension, by their index in
+// oldFromNew.
+template<typename MatType, typename TagType>
+bool DTree<MatType, TagType>::Presort(const MatType& data,
+                                      const arma::Col<size_t>& oldFromNew,
+                                      arma::Mat<size_t>& sortedIds,
+                                      arma::Col<size_t>& positions) const
+{
+  // The indices in oldFromNew identify the points while they are moved around,
+  // so they must be distinct.
+  positions.set_size(oldFromNew.n_elem);
+  std::vector<bool> seen(oldFromNew.n_elem, false);
+  for (size_t i = start; i < end; ++i)
+  {
+    const size_t id = oldFromNew[i];
+    if (id >= oldFromNew.n_elem || seen[id])
+      return false;
+
+    seen[id] = true;
+    positions[id] = i;
+  }
+
+  sortedIds.set_size(data.n_cols, data.n_rows);
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t dim = 0; dim < (size_t) data.n_rows; ++dim)
+  {
+    std::vector<std::pair<ElemType, size_t>> values(end - start);
+    for (size_t i = start; i < end; ++i)
+      values[i - start] = std::make_pair(data(dim, i), oldFromNew[i]);
+
+    std::sort(values.begin(), values.end());
+
+    size_t* ids = sortedIds.colptr(dim);
+    for (size_t i = start; i < end; ++i)
+      ids[i] = values[i - start].second;
+  }
+
+  return true;
+}
+
+// After SplitData(), split the sorted lists of the node into the sorted lists
+// of its children, keeping the order.
+template<typename MatType, typename TagType>
+void DTree<MatType, TagType>::SplitSortedIds(
+    const arma::Col<size_t>& oldFromNew,
+    const size_t splitIndex,
+    arma::Mat<size_t>& sortedIds,
+    arma::Col<size_t>& positions) const
+{
+  // Points were moved by SplitData(), so update their positions first.
+  for (size_t i = start; i < end; ++i)
+    positions[oldFromNew[i]] = i;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t dim = 0; dim < (size_t) sortedIds.n_cols; ++dim)
+  {
+    size_t* ids = sortedIds.colptr(dim);
+    std::vector<size_t> rightIds;
+    rightIds.reserve(end - splitIndex);
+
+    size_t leftCount = start;
+    for (size_t i = start; i < end; ++i)
+    {
+      if (positions[ids[i]] < splitIndex)
+        ids[leftCount++] = ids[i];
+      else
+        rightIds.push_back(ids[i]);
+    }
+
+    std::copy(rightIds.begin(), rightIds.end(), ids + splitIndex);
+  }
+}
+
 // Greedily expand the tree.
 template<typename MatType, typename TagType>
 double DTree<MatType, TagType>::Grow(MatType& data,
@@ -585,6 +742,34 @@ double DTree<MatType, TagType>::Grow(MatType& data,
                                      const bool useVolReg,
                                      const size_t maxLeafSize,
                                      const size_t minLeafSize)
+{
+  // For dense data, the points are sorted once in each dimension; the sorted
+  // lists are then split along with the nodes, instead of sorting the points
+  // again in every node.
+  if constexpr (!arma::is_arma_sparse_type<MatType>::value)
+  {
+    arma::Mat<size_t> sortedIds;
+    arma::Col<size_t> positions;
+    if (Presort(data, oldFromNew, sortedIds, positions))
+    {
+      return GrowNode(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize,
+          &sortedIds, &positions);
+    }
+  }
+
+  return GrowNode(data, oldFromNew, useVolReg, maxLeafSize, minLeafSize, NULL,
+      NULL);
+}
+
+// Greedily expand the tree, from this node.
+template<typename MatType, typename TagType>
+double DTree<MatType, TagType>::GrowNode(MatType& data,
+                                         arma::Col<size_t>& oldFromNew,
+                                         const bool useVolReg,
+                                         const size_t maxLeafSize,
+                                         const size_t minLeafSize,
+                                         arma::Mat<size_t>* sortedIds,
+                                         arma::Col<size_t>* positions)
 {
   Log::Assert(data.n_rows == maxVals.n_elem);
   Log::Assert(data.n_rows == minVals.n_elem);
@@ -605,13 +790,16 @@ double DTree<MatType, TagType>::Grow(MatType& data,
   {
     // Find the split.
     size_t dim;
-    double splitValueTmp;
+    ElemType splitValueTmp;
     double leftError, rightError;
-    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize))
+    if (FindSplit(data, dim, splitValueTmp, leftError, rightError, minLeafSize,
+        sortedIds, positions))
     {
       // Move the data around for the children to have points in a node lie
       // contiguously (to increase efficiency during the training).
       const size_t splitIndex = SplitData(data, dim, splitValueTmp, oldFromNew);
+      if (sortedIds != NULL)
+        SplitSortedIds(oldFromNew, splitIndex, *sortedIds, *positions);
 
       // Make max and min vals for the children.
       StatType maxValsL(maxVals);
@@ -630,10 +818,19 @@ double DTree<MatType, TagType>::Grow(MatType& data,
       left = new DTree(maxValsL, minValsL, start, splitIndex, leftError);
       right = new DTree(maxValsR, minValsR, splitIndex, end, rightError);
 
-      leftG = left->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                         minLeafSize);
-      rightG = right->Grow(data, oldFromNew, useVolReg, maxLeafSize,
-                           minLeafSize);
+      // The children hold disjoint ranges of points, so they can be grown in
+      // parallel.
+      auto growLeft = [&]()
+      {
+        leftG = left->GrowNode(data, oldFromNew, useVolReg, maxLeafSize,
+            minLeafSize, sortedIds, positions);
+      };
+      auto growRight = [&]()
+      {
+        rightG = right->GrowNode(data, oldFromNew, useVolReg, maxLeafSize,
+            minLeafSize, sortedIds, positions);
+      };
+      GrowChildren(growLeft, growRight);
 
       // Store values of R(T~) and |T~|.
       subtreeLeaves = left->SubtreeLeaves() + right->SubtreeLeaves();
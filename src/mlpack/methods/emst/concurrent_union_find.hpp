@@ -0,0 +1,105 @@
+/**
+ * @file methods/emst/concurrent_union_find.hpp
+ *
+ * Implements a lock-free union-find data structure that can be used by many
+ * threads at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+#define MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+
+/**
+ * A lock-free Union-Find data structure, with the same interface as UnionFind,
+ * that allows Find() and Union() to be called concurrently from different
+ * threads.  Roots are linked with an atomic compare-and-swap, always making the
+ * root with the larger index a child of the root with the smaller index (so no
+ * cycles can be created), and Find() compresses paths with path halving.  The
+ * root of each component is therefore its smallest element.
+ */
+class ConcurrentUnionFind
+{
+ private:
+  std::vector<std::atomic<size_t>> parent;
+
+ public:
+  //! Construct the object with the given size.
+  ConcurrentUnionFind(const size_t size) : parent(size)
+  {
+    for (size_t i = 0; i < size; ++i)
+      parent[i].store(i, std::memory_order_relaxed);
+  }
+
+  /**
+   * Returns the component containing an element.  If other threads are calling
+   * Union() at the same time, the result may already be out of date when this
+   * returns.
+   *
+   * @param x the component to be found
+   * @return The index of the component containing x
+   */
+  size_t Find(size_t x)
+  {
+    while (true)
+    {
+      size_t p = parent[x].load(std::memory_order_acquire);
+      if (p == x)
+        return x;
+
+      // Point x at its grandparent.  If that fails, another thread has already
+      // moved x closer to the root, which is just as good.
+      const size_t gp = parent[p].load(std::memory_order_acquire);
+      if (gp != p)
+      {
+        parent[x].compare_exchange_weak(p, gp, std::memory_order_release,
+            std::memory_order_relaxed);
+      }
+      x = gp;
+    }
+  }
+
+  /**
+   * Union the components containing x and y.  If several threads try to union
+   * the same two components at once, only one of them returns true.
+   *
+   * @param x one component
+   * @param y the other component
+   * @return true if the components were different and have been merged by this
+   *     call.
+   */
+  bool Union(const size_t x, const size_t y)
+  {
+    size_t xRoot = x;
+    size_t yRoot = y;
+    while (true)
+    {
+      xRoot = Find(xRoot);
+      yRoot = Find(yRoot);
+      if (xRoot == yRoot)
+        return false;
+
+      if (xRoot < yRoot)
+        std::swap(xRoot, yRoot);
+
+      // Link the larger root to the smaller one; if xRoot is not a root anymore
+      // because of another thread, try again.
+      size_t expected = xRoot;
+      if (parent[xRoot].compare_exchange_strong(expected, yRoot,
+          std::memory_order_acq_rel, std::memory_order_acquire))
+        return true;
+    }
+  }
+}; // class ConcurrentUnionFind
+
+} // namespace mlpack
+
+#endif // MLPACK_METHODS_EMST_CONCURRENT_UNION_FIND_HPP
@@ -29,6 +29,7 @@
 
 #include "dtb_stat.hpp"
 #include "edge_pair.hpp"
+#include "concurrent_union_find.hpp"
 
 namespace mlpack {
 
@@ -98,8 +99,9 @@ class DualTreeBoruvka
   //! Edges.
   std::vector<EdgePair> edges; // We must use vector with non-numerical types.
 
-  //! Connections.
-  UnionFind connections;
+  //! Connections.  These are only modified between the traversals of each
+  //! round, but may be read and modified by several threads at once.
+  ConcurrentUnionFind connections;
 
   //! List of edge nodes.
   arma::Col<size_t> neighborsInComponent;
@@ -171,7 +173,31 @@ class DualTreeBoruvka
    */
   void ComputeMST(arma::mat& results);
 
+  /**
+   * Compute the minimum spanning tree of the mutual reachability distance
+   * max(d(a, b), core(a), core(b)) between points a and b, given the core
+   * distance of each point (for instance, the distance to its k-th nearest
+   * neighbor).  This is the spanning tree used by HDBSCAN.  The results have
+   * the same format as with ComputeMST(results), and the third row holds the
+   * mutual reachability distances.
+   *
+   * The core distances are in the order of the points of the dataset given to
+   * the constructor; if the object was constructed with a tree, they are in
+   * the order of the points of the tree.  Only one MST can be computed with
+   * each DualTreeBoruvka object.
+   *
+   * @param results Matrix which results will be stored in.
+   * @param coreDistances Core distance of each point.
+   */
+  void ComputeMST(arma::mat& results, const arma::vec& coreDistances);
+
  private:
+  /**
+   * Compute the MST with the given rules, and store it in results.
+   */
+  template<typename RuleType>
+  void FindMST(arma::mat& results, RuleType& rules);
+
   /**
    * Adds a single edge to the edge list
    */
@@ -182,6 +208,17 @@ class DualTreeBoruvka
    */
   void AddAllEdges();
 
+  /**
+   * Find the candidate edge of each component with a dual-tree traversal.  If
+   * OpenMP is available, the query tree is split into disjoint subtrees that
+   * are traversed by different threads; each thread keeps its own candidate
+   * edges, and these are reduced at the end.
+   *
+   * @param rules Rules for the traversal.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(RuleType& rules);
+
   /**
    * Unpermute the edge list and output it to results.
    */
@@ -96,11 +96,68 @@ template<
 void DualTreeBoruvka<DistanceType, MatType, TreeType>::ComputeMST(
     arma::mat& results)
 {
-  totalDist = 0; // Reset distance.
+  using RuleType = DTBRules<DistanceType, Tree>;
+  RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
+                 neighborsOutComponent, distance);
+  FindMST(results, rules);
+}
+
+/**
+ * Find the MST of the mutual reachability distance.
+ */
+template<
+    typename DistanceType,
+    typename MatType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void DualTreeBoruvka<DistanceType, MatType, TreeType>::ComputeMST(
+    arma::mat& results,
+    const arma::vec& coreDistances)
+{
+  if (coreDistances.n_elem != data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "DualTreeBoruvka::ComputeMST(): number of core distances ("
+        << coreDistances.n_elem << ") does not match the number of points ("
+        << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The rules index the points of the tree, which may have been reordered.
+  arma::vec treeCoreDistances;
+  if (!naive && ownTree && TreeTraits<Tree>::RearrangesDataset)
+  {
+    treeCoreDistances.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      treeCoreDistances[i] = coreDistances[oldFromNew[i]];
+  }
 
   using RuleType = DTBRules<DistanceType, Tree>;
   RuleType rules(data, connections, neighborsDistances, neighborsInComponent,
                  neighborsOutComponent, distance);
+  rules.CoreDistances() = (treeCoreDistances.n_elem > 0) ?
+      &treeCoreDistances : &coreDistances;
+  FindMST(results, rules);
+}
+
+/**
+ * Iteratively find the nearest neighbor of each component with the given
+ * rules until the MST is complete.
+ */
+template<
+    typename DistanceType,
+    typename MatType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+template<typename RuleType>
+void DualTreeBoruvka<DistanceType, MatType, TreeType>::FindMST(
+    arma::mat& results,
+    RuleType& rules)
+{
+  totalDist = 0; // Reset distance.
+
   while (edges.size() < (data.n_cols - 1))
   {
     if (naive)
@@ -112,8 +169,7 @@ void DualTreeBoruvka<DistanceType, MatType, TreeType>::ComputeMST(
     }
     else
     {
-      typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-      traverser.Traverse(*tree, *tree);
+      DualTreeTraversal(rules);
     }
 
     AddAllEdges();
@@ -168,22 +224,135 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<DistanceType, MatType, TreeType>::AddAllEdges()
 {
+  // Collect the components of this round, which are the only entries of the
+  // candidate edge lists that were filled.
+  std::vector<size_t> components;
   for (size_t i = 0; i < data.n_cols; ++i)
+    if (connections.Find(i) == i)
+      components.push_back(i);
+
+  // Merge the components along their candidate edges.  When two components
+  // chose the same edge, only one of the unions succeeds, so every edge is
+  // added once.
+  std::vector<char> added(components.size());
+  #pragma omp parallel for schedule(static)
+  for (size_t c = 0; c < components.size(); ++c)
   {
-    size_t component = connections.Find(i);
-    size_t inEdge = neighborsInComponent[component];
-    size_t outEdge = neighborsOutComponent[component];
-    if (connections.Find(inEdge) != connections.Find(outEdge))
+    added[c] = connections.Union(neighborsInComponent[components[c]],
+        neighborsOutComponent[components[c]]);
+  }
+
+  for (size_t c = 0; c < components.size(); ++c)
+  {
+    if (added[c])
     {
+      const size_t component = components[c];
       // totalDist = totalDist + dist;
       // changed to make this agree with the cover tree code
       totalDist += neighborsDistances[component];
-      AddEdge(inEdge, outEdge, neighborsDistances[component]);
-      connections.Union(inEdge, outEdge);
+      AddEdge(neighborsInComponent[component],
+          neighborsOutComponent[component], neighborsDistances[component]);
     }
   }
 }
 
+/**
+ * Find the candidate edge of each component with a (possibly parallel)
+ * dual-tree traversal.
+ */
+template<
+    typename DistanceType,
+    typename MatType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+template<typename RuleType>
+void DualTreeBoruvka<DistanceType, MatType, TreeType>::DualTreeTraversal(
+    RuleType& rules)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Collect a few more subtrees than threads, so that the work can be
+    // balanced dynamically.
+    std::vector<Tree*> frontier;
+    QueryFrontier(*tree, 4 * numThreads, frontier);
+
+    // The points of a component may be in the subtrees of different threads,
+    // so every thread but the first finds candidate edges on its own copy.
+    // Pruning with these is still correct, because the candidate of each
+    // thread is only an upper bound of the final candidate.
+    std::vector<arma::vec> localDistances(numThreads - 1);
+    std::vector<arma::Col<size_t>> localInComponent(numThreads - 1);
+    std::vector<arma::Col<size_t>> localOutComponent(numThreads - 1);
+
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      const size_t thread = omp_get_thread_num();
+      if (thread > 0)
+      {
+        localDistances[thread - 1].set_size(data.n_cols);
+        localDistances[thread - 1].fill(DBL_MAX);
+        localInComponent[thread - 1].set_size(data.n_cols);
+        localOutComponent[thread - 1].set_size(data.n_cols);
+      }
+
+      RuleType localRules(data, connections,
+          (thread == 0) ? neighborsDistances : localDistances[thread - 1],
+          (thread == 0) ? neighborsInComponent : localInComponent[thread - 1],
+          (thread == 0) ? neighborsOutComponent :
+              localOutComponent[thread - 1],
+          distance);
+      localRules.CoreDistances() = rules.CoreDistances();
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(localRules);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+        traverser.Traverse(*frontier[i], *tree);
+
+      threadBaseCases += localRules.BaseCases();
+      threadScores += localRules.Scores();
+
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
+
+    // Reduce the candidate edges of all threads.
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+    {
+      for (size_t t = 0; t < localDistances.size(); ++t)
+      {
+        if (localDistances[t].n_elem > 0 &&
+            localDistances[t][i] < neighborsDistances[i])
+        {
+          neighborsDistances[i] = localDistances[t][i];
+          neighborsInComponent[i] = localInComponent[t][i];
+          neighborsOutComponent[i] = localOutComponent[t][i];
+        }
+      }
+    }
+
+    rules.BaseCases() += threadBaseCases;
+    rules.Scores() += threadScores;
+    return;
+  }
+  #endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(*tree, *tree);
+}
+
 /**
  * Unpermute the edge list (if necessary) and output it to results.
  */
@@ -291,8 +460,7 @@ template<
              typename TreeMatType> class TreeType>
 void DualTreeBoruvka<DistanceType, MatType, TreeType>::Cleanup()
 {
-  for (size_t i = 0; i < data.n_cols; ++i)
-    neighborsDistances[i] = DBL_MAX;
+  neighborsDistances.fill(DBL_MAX);
 
   if (!naive)
     CleanupHelper(tree);
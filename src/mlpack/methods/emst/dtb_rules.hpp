@@ -15,6 +15,7 @@
 #include <mlpack/prereqs.hpp>
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 
@@ -23,7 +24,7 @@ class DTBRules
 {
  public:
   DTBRules(const arma::mat& dataSet,
-           UnionFind& connections,
+           ConcurrentUnionFind& connections,
            arma::vec& neighborsDistances,
            arma::Col<size_t>& neighborsInComponent,
            arma::Col<size_t>& neighborsOutComponent,
@@ -96,12 +97,26 @@ class DTBRules
   //! Modify the number of node combinations that have been scored.
   size_t& Scores() { return scores; }
 
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
+  //! Get the core distances of the points (NULL if they are not used).
+  const arma::vec* CoreDistances() const { return coreDistances; }
+  /**
+   * Modify the core distances of the points.  If they are set, the distance
+   * between two points a and b is the mutual reachability distance
+   * max(d(a, b), core(a), core(b)).  They are not owned by the rules.
+   */
+  const arma::vec*& CoreDistances() { return coreDistances; }
+
  private:
   //! The data points.
   const arma::mat& dataSet;
 
   //! Stores the tree structure so far
-  UnionFind& connections;
+  ConcurrentUnionFind& connections;
 
   //! The distance to the candidate nearest neighbor for each component.
   arma::vec& neighborsDistances;
@@ -128,6 +143,10 @@ class DTBRules
   size_t baseCases;
   //! The number of node combinations that have been scored.
   size_t scores;
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
+  //! Optional core distances of the points (may be NULL).
+  const arma::vec* coreDistances;
 }; // class DTBRules
 
 } // namespace mlpack
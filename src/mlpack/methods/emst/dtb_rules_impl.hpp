@@ -19,7 +19,7 @@ namespace mlpack {
 template<typename DistanceType, typename TreeType>
 DTBRules<DistanceType, TreeType>::
 DTBRules(const arma::mat& dataSet,
-         UnionFind& connections,
+         ConcurrentUnionFind& connections,
          arma::vec& neighborsDistances,
          arma::Col<size_t>& neighborsInComponent,
          arma::Col<size_t>& neighborsOutComponent,
@@ -32,7 +32,9 @@ DTBRules(const arma::mat& dataSet,
   neighborsOutComponent(neighborsOutComponent),
   distance(distance),
   baseCases(0),
-  scores(0)
+  scores(0),
+  statistics(NULL),
+  coreDistances(NULL)
 {
   // Nothing else to do.
 }
@@ -55,8 +57,15 @@ double DTBRules<DistanceType, TreeType>::BaseCase(const size_t queryIndex,
   if (queryComponentIndex != referenceComponentIndex)
   {
     ++baseCases;
+    if (statistics)
+      statistics->RecordBaseCases();
     double dist = distance.Evaluate(dataSet.col(queryIndex),
                                     dataSet.col(referenceIndex));
+    if (coreDistances)
+    {
+      dist = std::max(dist, std::max((*coreDistances)[queryIndex],
+          (*coreDistances)[referenceIndex]));
+    }
 
     if (dist < neighborsDistances[queryComponentIndex])
     {
@@ -87,15 +96,22 @@ double DTBRules<DistanceType, TreeType>::Score(const size_t queryIndex,
   // signed values.
   if (queryComponentIndex ==
       (size_t) referenceNode.Stat().ComponentMembership())
+  {
+    if (statistics)
+      statistics->RecordScore(referenceNode, DBL_MAX);
     return DBL_MAX;
+  }
 
   const arma::vec queryPoint = dataSet.unsafe_col(queryIndex);
   const double distance = referenceNode.MinDistance(queryPoint);
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for the query's component, we prune.
-  return neighborsDistances[queryComponentIndex] < distance
+  const double score = neighborsDistances[queryComponentIndex] < distance
       ? DBL_MAX : distance;
+  if (statistics)
+    statistics->RecordScore(referenceNode, score);
+  return score;
 }
 
 template<typename DistanceType, typename TreeType>
@@ -105,8 +121,12 @@ double DTBRules<DistanceType, TreeType>::Rescore(const size_t queryIndex,
 {
   // We don't need to check component membership again, because it can't
   // change inside a single iteration.
-  return (oldScore > neighborsDistances[connections.Find(queryIndex)])
+  const double score =
+      (oldScore > neighborsDistances[connections.Find(queryIndex)])
       ? DBL_MAX : oldScore;
+  if (statistics)
+    statistics->RecordRescore(score);
+  return score;
 }
 
 template<typename DistanceType, typename TreeType>
@@ -118,7 +138,11 @@ double DTBRules<DistanceType, TreeType>::Score(TreeType& queryNode,
   if ((queryNode.Stat().ComponentMembership() >= 0) &&
       (queryNode.Stat().ComponentMembership() ==
            referenceNode.Stat().ComponentMembership()))
+  {
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, DBL_MAX);
     return DBL_MAX;
+  }
 
   ++scores;
   const double distance = queryNode.MinDistance(referenceNode);
@@ -126,7 +150,10 @@ double DTBRules<DistanceType, TreeType>::Score(TreeType& queryNode,
 
   // If all the points in the reference node are farther than the candidate
   // nearest neighbor for all queries in the node, we prune.
-  return (bound < distance) ? DBL_MAX : distance;
+  const double score = (bound < distance) ? DBL_MAX : distance;
+  if (statistics)
+    statistics->RecordScore(queryNode, referenceNode, score);
+  return score;
 }
 
 template<typename DistanceType, typename TreeType>
@@ -135,7 +162,10 @@ double DTBRules<DistanceType, TreeType>::Rescore(TreeType& queryNode,
                                                  const double oldScore) const
 {
   const double bound = CalculateBound(queryNode);
-  return (oldScore > bound) ? DBL_MAX : oldScore;
+  const double score = (oldScore > bound) ? DBL_MAX : oldScore;
+  if (statistics)
+    statistics->RecordRescore(score);
+  return score;
 }
 
 // Calculate the bound for a given query node in its current state and update
@@ -177,9 +207,14 @@ inline double DTBRules<DistanceType, TreeType>::CalculateBound(
   // Now calculate the actual bounds.
   const double worstBound = std::max(worstPointBound, worstChildBound);
   const double bestBound = std::min(bestPointBound, bestChildBound);
-  // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.
-  const double bestAdjustedBound = (bestBound == DBL_MAX) ? DBL_MAX :
-      bestBound + 2 * queryNode.FurthestDescendantDistance();
+  // We must check that bestBound != DBL_MAX; otherwise, we risk overflow.  The
+  // adjusted bound relies on the triangle inequality, which does not hold for
+  // the mutual reachability distance (a point with a large core distance is
+  // far from every other point), so it is not used with core distances.  The
+  // tree distances are still lower bounds, because the mutual reachability
+  // distance is never less than the distance.
+  const double bestAdjustedBound = (bestBound == DBL_MAX || coreDistances) ?
+      DBL_MAX : bestBound + 2 * queryNode.FurthestDescendantDistance();
 
   // Update the relevant quantities in the node.
   queryNode.Stat().MaxNeighborDistance() = worstBound;
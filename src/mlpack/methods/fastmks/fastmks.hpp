@@ -345,6 +345,44 @@ class FastMKS
   //! Use a priority queue to represent the list of candidate points.
   using CandidateList = std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp>;
+
+  /**
+   * Brute-force search of the k maximum kernels of each point in the query
+   * set.  Query points are handled in parallel if OpenMP is available, and for
+   * LinearKernel and PolynomialKernel with dense data the kernels are computed
+   * in blocks with matrix products.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of maximum kernels to find.
+   * @param indices Matrix to store resulting indices of max-kernel search in.
+   * @param kernels Matrix to store resulting max-kernel values in.
+   * @param sameSet If true, the query set is the reference set, and points are
+   *     not returned as their own candidates.
+   */
+  void NaiveSearch(const MatType& querySet,
+                   const size_t k,
+                   arma::Mat<size_t>& indices,
+                   arma::mat& kernels,
+                   const bool sameSet);
+
+  /**
+   * Run a single-tree traversal of the reference tree for each of the given
+   * number of query points, in parallel if OpenMP is available.  The number
+   * of pruned nodes is returned.
+   */
+  template<typename RuleType>
+  size_t SingleTreeTraversal(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Run a dual-tree traversal of the given query tree and the reference tree.
+   * If OpenMP is available, disjoint subtrees of the query tree are traversed
+   * in parallel.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(RuleType& rules, Tree& queryTree);
+
+  //! Reset the bound of every node in the given query tree.
+  static void ResetBounds(Tree& node);
 };
 
 } // namespace mlpack
@@ -16,6 +16,7 @@
 #include "fastmks.hpp"
 
 #include "fastmks_rules.hpp"
+#include <mlpack/core/tree/query_frontier.hpp>
 
 namespace mlpack {
 
@@ -436,34 +437,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < querySet.n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
-
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        const double eval = distance.Kernel().Evaluate(querySet.col(q),
-                                                       referenceSet->col(r));
-
-        if (eval > pqueue.top().first)
-        {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
-        }
-      }
-
-      for (size_t j = 1; j <= k; ++j)
-      {
-        indices(k - j, q) = pqueue.top().second;
-        kernels(k - j, q) = pqueue.top().first;
-        pqueue.pop();
-      }
-    }
-
+    NaiveSearch(querySet, k, indices, kernels, false);
     return;
   }
 
@@ -475,10 +449,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
     using RuleType = FastMKSRules<KernelType, Tree>;
     RuleType rules(*referenceSet, querySet, k, distance.Kernel());
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(rules, querySet.n_cols);
 
     Log::Info << rules.BaseCases() << " base cases." << std::endl;
     Log::Info << rules.Scores() << " scores." << std::endl;
@@ -536,9 +507,7 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   using RuleType = FastMKSRules<KernelType, Tree>;
   RuleType rules(*referenceSet, queryTree->Dataset(), k, distance.Kernel());
 
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(rules, *queryTree);
 
   Log::Info << rules.BaseCases() << " base cases." << std::endl;
   Log::Info << rules.Scores() << " scores." << std::endl;
@@ -563,29 +532,100 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
   // Naive implementation.
   if (naive)
   {
-    // Simple double loop.  Stupid, slow, but a good benchmark.
-    for (size_t q = 0; q < referenceSet->n_cols; ++q)
-    {
-      const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
-      std::vector<Candidate> cList(k, def);
-      CandidateList pqueue(CandidateCmp(), std::move(cList));
+    NaiveSearch(*referenceSet, k, indices, kernels, true);
+    return;
+  }
 
-      for (size_t r = 0; r < referenceSet->n_cols; ++r)
-      {
-        if (q == r)
-          continue; // Don't return the point as its own candidate.
+  // Single-tree implementation.
+  if (singleMode)
+  {
+    // Create rules object (this will store the results).  This constructor
+    // precalculates each self-kernel value.
+    using RuleType = FastMKSRules<KernelType, Tree>;
+    RuleType rules(*referenceSet, *referenceSet, k, distance.Kernel());
+
+    // Save the number of pruned nodes.
+    const size_t numPrunes = SingleTreeTraversal(rules, referenceSet->n_cols);
+
+    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+
+    Log::Info << rules.BaseCases() << " base cases." << std::endl;
+    Log::Info << rules.Scores() << " scores." << std::endl;
+
+    rules.GetResults(indices, kernels);
+
+    return;
+  }
 
-        const double eval = distance.Kernel().Evaluate(referenceSet->col(q),
-                                                       referenceSet->col(r));
+  // Dual-tree implementation.
+  Search(referenceTree, k, indices, kernels);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::NaiveSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& indices,
+    arma::mat& kernels,
+    const bool sameSet)
+{
+  // The kernels are computed for blocks of query and reference points; this
+  // turns the computation into matrix products for kernels with
+  // EvaluateBlock(), and the blocks are small enough to stay in cache.
+  const size_t queryBlockSize = 256;
+  const size_t referenceBlockSize = 4096;
+  const size_t numBlocks = (querySet.n_cols + queryBlockSize - 1) /
+      queryBlockSize;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * queryBlockSize;
+    const size_t end = std::min(begin + queryBlockSize,
+        (size_t) querySet.n_cols);
+    const MatType queryBlock = querySet.cols(begin, end - 1);
+
+    const Candidate def = std::make_pair(-DBL_MAX, size_t() - 1);
+    std::vector<CandidateList> pqueues;
+    pqueues.reserve(end - begin);
+    for (size_t q = begin; q < end; ++q)
+      pqueues.emplace_back(CandidateCmp(), std::vector<Candidate>(k, def));
+
+    // Kernel evaluations between the reference block and the query block.
+    arma::mat products;
+    for (size_t r = 0; r < referenceSet->n_cols; r += referenceBlockSize)
+    {
+      const size_t rEnd = std::min(r + referenceBlockSize,
+          (size_t) referenceSet->n_cols);
+      FastMKSKernelProducts(MatType(referenceSet->cols(r, rEnd - 1)),
+          queryBlock, distance.Kernel(), products);
 
-        if (eval > pqueue.top().first)
+      for (size_t q = begin; q < end; ++q)
+      {
+        CandidateList& pqueue = pqueues[q - begin];
+        for (size_t i = r; i < rEnd; ++i)
         {
-          Candidate c = std::make_pair(eval, r);
-          pqueue.pop();
-          pqueue.push(c);
+          // Don't return the point as its own candidate.
+          if (sameSet && q == i)
+            continue;
+
+          const double eval = products(i - r, q - begin);
+          if (eval > pqueue.top().first)
+          {
+            pqueue.pop();
+            pqueue.push(std::make_pair(eval, i));
+          }
         }
       }
+    }
 
+    for (size_t q = begin; q < end; ++q)
+    {
+      CandidateList& pqueue = pqueues[q - begin];
       for (size_t j = 1; j <= k; ++j)
       {
         indices(k - j, q) = pqueue.top().second;
@@ -593,38 +633,129 @@ void FastMKS<KernelType, MatType, TreeType>::Search(
         pqueue.pop();
       }
     }
-
-    return;
   }
+}
 
-  // Single-tree implementation.
-  if (singleMode)
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+size_t FastMKS<KernelType, MatType, TreeType>::SingleTreeTraversal(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  #ifdef MLPACK_USE_OPENMP
+  if (omp_get_max_threads() > 1)
   {
-    // Create rules object (this will store the results).  This constructor
-    // precalculates each self-kernel value.
-    using RuleType = FastMKSRules<KernelType, Tree>;
-    RuleType rules(*referenceSet, *referenceSet, k, distance.Kernel());
+    // Each thread handles its own query points with its own copy of the rules,
+    // which shares the candidate lists but keeps the last kernel evaluations of
+    // the reference nodes for itself.
+    size_t numPrunes = 0, threadScores = 0, threadBaseCases = 0;
+    #pragma omp parallel reduction(+:numPrunes, threadScores, threadBaseCases)
+    {
+      RuleType localRules(rules);
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(localRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      numPrunes += traverser.NumPrunes();
+      threadScores += localRules.Scores();
+      threadBaseCases += localRules.BaseCases();
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
 
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return numPrunes;
+  }
+  #endif
 
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
 
-    // Save the number of pruned nodes.
-    const size_t numPrunes = traverser.NumPrunes();
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
 
-    Log::Info << "Pruned " << numPrunes << " nodes." << std::endl;
+  return traverser.NumPrunes();
+}
 
-    Log::Info << rules.BaseCases() << " base cases." << std::endl;
-    Log::Info << rules.Scores() << " scores." << std::endl;
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void FastMKS<KernelType, MatType, TreeType>::DualTreeTraversal(
+    RuleType& rules,
+    Tree& queryTree)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1 && !queryTree.IsLeaf())
+  {
+    // The bounds of the query nodes above the frontier are not updated during
+    // the traversal, so they must not be left over from an earlier search.
+    ResetBounds(queryTree);
 
-    rules.GetResults(indices, kernels);
+    // Each query subtree in the frontier is traversed by one thread, so no
+    // query point or query node is touched by two threads.
+    std::vector<Tree*> frontier;
+    QueryFrontier(queryTree, 4 * numThreads, frontier);
 
+    size_t threadScores = 0, threadBaseCases = 0;
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      RuleType localRules(rules);
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      typename Tree::template DualTreeTraverser<RuleType> traverser(localRules);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+        traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadScores += localRules.Scores();
+      threadBaseCases += localRules.BaseCases();
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
     return;
   }
+  #endif
 
-  // Dual-tree implementation.
-  Search(referenceTree, k, indices, kernels);
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
+template<typename KernelType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void FastMKS<KernelType, MatType, TreeType>::ResetBounds(Tree& node)
+{
+  node.Stat().Bound() = -DBL_MAX;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    ResetBounds(node.Child(i));
 }
 
 //! Serialize the model.
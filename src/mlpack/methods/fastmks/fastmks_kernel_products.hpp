@@ -0,0 +1,76 @@
+/**
+ * @file methods/fastmks/fastmks_kernel_products.hpp
+ *
+ * Helper functions to evaluate many kernels at once for FastMKS.  Kernels
+ * between sets of points are computed with KernelBlock() (a matrix product for
+ * kernels with EvaluateBlock(), and dense data); for self-kernels of
+ * LinearKernel and PolynomialKernel, the squared norms are used.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_FASTMKS_FASTMKS_KERNEL_PRODUCTS_HPP
+#define MLPACK_METHODS_FASTMKS_FASTMKS_KERNEL_PRODUCTS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
+#include <mlpack/core/kernels/linear_kernel.hpp>
+#include <mlpack/core/kernels/polynomial_kernel.hpp>
+
+namespace mlpack {
+
+/**
+ * This is true if KernelType is a function of the inner product of its
+ * arguments, and so many kernels can be evaluated with a matrix product when
+ * the data in MatType is dense.
+ */
+template<typename KernelType, typename MatType>
+struct FastMKSBatchKernel
+{
+  static const bool value = !arma::is_SpMat<MatType>::value &&
+      (std::is_same_v<KernelType, LinearKernel> ||
+       std::is_same_v<KernelType, PolynomialKernel>);
+};
+
+/**
+ * Compute kernels(i, j) = K(a_i, b_j) for every column a_i of a and b_j of b.
+ */
+template<typename KernelType, typename MatType>
+void FastMKSKernelProducts(const MatType& a,
+                           const MatType& b,
+                           KernelType& kernel,
+                           arma::mat& kernels)
+{
+  KernelBlock(kernel, a, b, kernels);
+}
+
+/**
+ * Compute the square root of the self-kernel K(x, x) of each point x in the
+ * dataset (its norm in the kernel space).
+ */
+template<typename KernelType, typename MatType>
+void FastMKSSelfKernels(const MatType& data,
+                        KernelType& kernel,
+                        arma::vec& selfKernels)
+{
+  if constexpr (FastMKSBatchKernel<KernelType, MatType>::value)
+  {
+    selfKernels = arma::conv_to<arma::vec>::from(
+        arma::sum(arma::square(data), 0).t());
+    if constexpr (std::is_same_v<KernelType, PolynomialKernel>)
+      selfKernels = arma::pow(selfKernels + kernel.Offset(), kernel.Degree());
+    selfKernels = arma::sqrt(selfKernels);
+  }
+  else
+  {
+    selfKernels.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      selfKernels[i] = std::sqrt(kernel.Evaluate(data.col(i), data.col(i)));
+  }
+}
+
+} // namespace mlpack
+
+#endif
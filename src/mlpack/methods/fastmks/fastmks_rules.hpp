@@ -16,7 +16,11 @@
 #include <mlpack/core/kernels/kernel_traits.hpp>
 #include <mlpack/core/tree/cover_tree/cover_tree.hpp>
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 #include <algorithm>
+#include <unordered_map>
+
+#include "fastmks_kernel_products.hpp"
 
 namespace mlpack {
 
@@ -47,6 +51,20 @@ class FastMKSRules
                const size_t k,
                KernelType& kernel);
 
+  /**
+   * Construct a FastMKSRules object that shares the candidate lists of the
+   * given rules object, but holds its own base case cache, traversal info, and
+   * score and base case counters.  This is used for parallel traversals, where
+   * each thread handles a disjoint set of query points and thus never modifies
+   * the candidate list of a query point that is owned by another thread.  The
+   * new object also keeps the last kernel evaluation of each reference node
+   * for itself instead of in the statistic of the node, so that several
+   * threads can run single-tree searches on the same reference tree.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  FastMKSRules(FastMKSRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -118,6 +136,11 @@ class FastMKSRules
   //! Modify the number of times Score() was called.
   size_t& Scores() { return scores; }
 
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
   using TraversalInfoType = mlpack::TraversalInfo<TreeType>;
 
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
@@ -144,10 +167,12 @@ class FastMKSRules
     };
   };
 
-  //! Set of candidates for each point.  We use a min-heap built on a
-  //! std::vector to represent the list of candidate points for each query
-  //! point.
-  std::vector<std::vector<Candidate>> candidates;
+  //! Storage for the candidates of each point, if this object owns them.
+  std::vector<std::vector<Candidate>> localCandidates;
+  //! Set of candidates for each point (possibly shared with another
+  //! FastMKSRules object).  We use a min-heap built on a std::vector to
+  //! represent the list of candidate points for each query point.
+  std::vector<std::vector<Candidate>>& candidates;
 
   //! Number of points to search for.
   const size_t k;
@@ -167,6 +192,26 @@ class FastMKSRules
   //! The last kernel evaluation resulting from BaseCase().
   double lastKernel;
 
+  //! If true, the last kernel evaluations of reference nodes in single-tree
+  //! search are stored in lastKernels instead of in the node statistics.
+  bool localLastKernels;
+  //! The last kernel evaluation of each reference node scored for the query
+  //! point lastKernelsQuery, if localLastKernels is true.
+  std::unordered_map<const TreeType*, double> lastKernels;
+  //! The query point that lastKernels holds kernel evaluations for.
+  size_t lastKernelsQuery;
+
+  /**
+   * Return a pointer to the last kernel evaluation between the current query
+   * point and the given reference node in single-tree search, or NULL if it is
+   * not known.
+   */
+  const double* LastKernel(const TreeType& referenceNode) const;
+
+  //! Store the last kernel evaluation of the given reference node in
+  //! single-tree search.
+  void StoreLastKernel(TreeType& referenceNode, const double kernelEval);
+
   //! Calculate the bound for a given query node.
   double CalculateBound(TreeType& queryNode) const;
 
@@ -185,6 +230,8 @@ class FastMKSRules
   size_t baseCases;
   //! For benchmarking.
   size_t scores;
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
 
   TraversalInfoType traversalInfo;
 };
@@ -25,24 +25,24 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
     KernelType& kernel) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(localCandidates),
     k(k),
     kernel(kernel),
     lastQueryIndex(-1),
     lastReferenceIndex(-1),
     lastKernel(0.0),
+    localLastKernels(false),
+    lastKernelsQuery(-1),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL)
 {
   // Precompute each self-kernel.
-  queryKernels.set_size(querySet.n_cols);
-  for (size_t i = 0; i < querySet.n_cols; ++i)
-    queryKernels[i] = std::sqrt(kernel.Evaluate(querySet.col(i),
-                                                querySet.col(i)));
-
-  referenceKernels.set_size(referenceSet.n_cols);
-  for (size_t i = 0; i < referenceSet.n_cols; ++i)
-    referenceKernels[i] = std::sqrt(kernel.Evaluate(referenceSet.col(i),
-                                                    referenceSet.col(i)));
+  FastMKSSelfKernels(querySet, kernel, queryKernels);
+  if (&querySet == &referenceSet)
+    referenceKernels = queryKernels;
+  else
+    FastMKSSelfKernels(referenceSet, kernel, referenceKernels);
 
   // Set to invalid memory, so that the first node combination does not try to
   // dereference null pointers.
@@ -60,6 +60,29 @@ FastMKSRules<KernelType, TreeType>::FastMKSRules(
   candidates = std::vector<std::vector<Candidate>>(querySet.n_cols, pqueue);
 }
 
+template<typename KernelType, typename TreeType>
+FastMKSRules<KernelType, TreeType>::FastMKSRules(FastMKSRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    queryKernels(other.queryKernels),
+    referenceKernels(other.referenceKernels),
+    kernel(other.kernel),
+    lastQueryIndex(-1),
+    lastReferenceIndex(-1),
+    lastKernel(0.0),
+    localLastKernels(true),
+    lastKernelsQuery(-1),
+    baseCases(0),
+    scores(0),
+    statistics(other.statistics)
+{
+  // See the other constructor for why we use the this pointer.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename KernelType, typename TreeType>
 void FastMKSRules<KernelType, TreeType>::GetResults(
     arma::Mat<size_t>& indices,
@@ -102,6 +125,8 @@ double FastMKSRules<KernelType, TreeType>::BaseCase(
   }
 
   ++baseCases;
+  if (statistics)
+    statistics->RecordBaseCases();
   double kernelEval = kernel.Evaluate(querySet.col(queryIndex),
                                       referenceSet.col(referenceIndex));
 
@@ -124,17 +149,27 @@ template<typename KernelType, typename TreeType>
 double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
                                                  TreeType& referenceNode)
 {
+  // The kernel evaluations stored by this object are only valid for one query
+  // point.
+  if (localLastKernels && queryIndex != lastKernelsQuery)
+  {
+    lastKernels.clear();
+    lastKernelsQuery = queryIndex;
+  }
+
   // Compare with the current best.
   const double bestKernel = candidates[queryIndex].front().first;
 
   // See if we can perform a parent-child prune.
   const double furthestDist = referenceNode.FurthestDescendantDistance();
-  if (referenceNode.Parent() != NULL)
+  const double* parentKernel = (referenceNode.Parent() == NULL) ? NULL :
+      LastKernel(*referenceNode.Parent());
+  if (parentKernel != NULL)
   {
     double maxKernelBound;
     const double parentDist = referenceNode.ParentDistance();
     const double combinedDistBound = parentDist + furthestDist;
-    const double lastKernel = referenceNode.Parent()->Stat().LastKernel();
+    const double lastKernel = *parentKernel;
     if (KernelTraits<KernelType>::IsNormalized)
     {
       const double squaredDist = std::pow(combinedDistBound, 2.0);
@@ -158,7 +193,11 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     }
 
     if (maxKernelBound < bestKernel)
+    {
+      if (statistics)
+        statistics->RecordScore(referenceNode, DBL_MAX);
       return DBL_MAX;
+    }
   }
 
   // Calculate the maximum possible kernel value, either by calculating the
@@ -169,10 +208,10 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
   {
     // Could it be that this kernel evaluation has already been calculated?
     if (TreeTraits<TreeType>::HasSelfChildren &&
-        referenceNode.Parent() != NULL &&
+        parentKernel != NULL &&
         referenceNode.Point(0) == referenceNode.Parent()->Point(0))
     {
-      kernelEval = referenceNode.Parent()->Stat().LastKernel();
+      kernelEval = *parentKernel;
     }
     else
     {
@@ -187,7 +226,7 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
     kernelEval = kernel.Evaluate(querySet.col(queryIndex), refCenter);
   }
 
-  referenceNode.Stat().LastKernel() = kernelEval;
+  StoreLastKernel(referenceNode, kernelEval);
 
   double maxKernel;
   if (KernelTraits<KernelType>::IsNormalized)
@@ -212,7 +251,11 @@ double FastMKSRules<KernelType, TreeType>::Score(const size_t queryIndex,
 
   // We return the inverse of the maximum kernel so that larger kernels are
   // recursed into first.
-  return (maxKernel >= bestKernel) ? (1.0 / maxKernel) : DBL_MAX;
+  const double score = (maxKernel >= bestKernel) ? (1.0 / maxKernel) :
+      DBL_MAX;
+  if (statistics)
+    statistics->RecordScore(referenceNode, score);
+  return score;
 }
 
 template<typename KernelType, typename TreeType>
@@ -313,6 +356,8 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
     // It is not possible that this node combination can contain a point
     // combination with kernel value better than the minimum kernel value to
     // improve any of the results, so we can prune it.
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, DBL_MAX);
     return DBL_MAX;
   }
 
@@ -402,7 +447,11 @@ double FastMKSRules<KernelType, TreeType>::Score(TreeType& queryNode,
 
   // We return the inverse of the maximum kernel so that larger kernels are
   // recursed into first.
-  return (maxKernel >= bestKernel) ? (1.0 / maxKernel) : DBL_MAX;
+  const double score = (maxKernel >= bestKernel) ? (1.0 / maxKernel) :
+      DBL_MAX;
+  if (statistics)
+    statistics->RecordScore(queryNode, referenceNode, score);
+  return score;
 }
 
 template<typename KernelType, typename TreeType>
@@ -412,7 +461,10 @@ double FastMKSRules<KernelType, TreeType>::Rescore(const size_t queryIndex,
 {
   const double bestKernel = candidates[queryIndex].front().first;
 
-  return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
+  const double score = ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
+  if (statistics)
+    statistics->RecordRescore(score);
+  return score;
 }
 
 template<typename KernelType, typename TreeType>
@@ -423,7 +475,10 @@ double FastMKSRules<KernelType, TreeType>::Rescore(TreeType& queryNode,
   queryNode.Stat().Bound() = CalculateBound(queryNode);
   const double bestKernel = queryNode.Stat().Bound();
 
-  return ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
+  const double score = ((1.0 / oldScore) >= bestKernel) ? oldScore : DBL_MAX;
+  if (statistics)
+    statistics->RecordRescore(score);
+  return score;
 }
 
 /**
@@ -514,6 +569,28 @@ double FastMKSRules<KernelType, TreeType>::CalculateBound(TreeType& queryNode)
   return (interA > interB) ? interA : interB;
 }
 
+template<typename KernelType, typename TreeType>
+inline const double* FastMKSRules<KernelType, TreeType>::LastKernel(
+    const TreeType& referenceNode) const
+{
+  if (!localLastKernels)
+    return &referenceNode.Stat().LastKernel();
+
+  const auto it = lastKernels.find(&referenceNode);
+  return (it == lastKernels.end()) ? NULL : &it->second;
+}
+
+template<typename KernelType, typename TreeType>
+inline void FastMKSRules<KernelType, TreeType>::StoreLastKernel(
+    TreeType& referenceNode,
+    const double kernelEval)
+{
+  if (localLastKernels)
+    lastKernels[&referenceNode] = kernelEval;
+  else
+    referenceNode.Stat().LastKernel() = kernelEval;
+}
+
 /**
  * Helper function to insert a point into the list of candidate points.
  *
@@ -19,6 +19,7 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+#include "online_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -278,6 +279,25 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with one chunk of a stream of observations, using online
+   * (stepwise) EM; see OnlineEMFit.  The fitter holds the running statistics
+   * of the stream, so the same fitter must be passed for every chunk.  On the
+   * first chunk, the model is fitted with batch EM, unless useExistingModel is
+   * true.
+   *
+   * @param observations Chunk of observations.
+   * @param fitter Online fitter holding the statistics of the stream.
+   * @param useExistingModel If true, the existing model is used as the initial
+   *     estimate on the first chunk.
+   * @return The log-likelihood of the chunk under the model before the update.
+   */
+  template<typename FittingType = OnlineEMFit<KMeans<>, DiagonalConstraint,
+      DiagonalGaussianDistribution<>>>
+  double TrainOnline(const arma::mat& observations,
+                     FittingType& fitter,
+                     const bool useExistingModel = false);
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
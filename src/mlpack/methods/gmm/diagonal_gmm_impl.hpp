@@ -400,6 +400,24 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+//! Update the DiagonalGMM with one chunk of a stream of observations.
+template<typename FittingType>
+double DiagonalGMM::TrainOnline(const arma::mat& observations,
+                                FittingType& fitter,
+                                const bool useExistingModel)
+{
+  util::CheckSameDimensionality(observations, dimensionality,
+      "DiagonalGMM::TrainOnline()");
+
+  const double logLikelihood = fitter.Update(observations, dists, weights,
+      useExistingModel);
+
+  Log::Info << "DiagonalGMM::TrainOnline(): log-likelihood of the chunk is "
+      << logLikelihood << " (after " << fitter.Steps() << " chunks)."
+      << std::endl;
+  return logLikelihood;
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const uint32_t /* version */)
@@ -36,6 +36,16 @@ namespace mlpack {
  *
  * This method should create 'clusters' clusters, and return the assignment of
  * each point to a cluster.
+ *
+ * The E-step is computed in parallel over blocks of observations with OpenMP.
+ * Each thread accumulates the sufficient statistics of the M-step (the sum of
+ * the responsibilities, and the weighted sums and scatter matrices of the
+ * observations) of its blocks, so the responsibilities of all observations are
+ * never held in memory at once; the statistics of the threads are then merged
+ * for the M-step.  For GaussianDistribution, the Mahalanobis distances of each
+ * block are computed with one triangular solve against the Cholesky factor of
+ * each covariance.  The same pass also computes the log-likelihood of the
+ * current model, which is used to check for convergence.
  */
 template<typename InitialClusteringType = KMeans<>,
          typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
@@ -130,6 +140,10 @@ class EMFit
   void serialize(Archive& ar, const uint32_t version);
 
  private:
+  //! OnlineEMFit uses the E-step of the batch fitter.
+  template<typename, typename, typename>
+  friend class OnlineEMFit;
+
   /**
    * Run the clusterer, and then turn the cluster assignments into Gaussians.
    * This is a helper function for both overloads of Estimate().  The vectors
@@ -145,20 +159,56 @@ class EMFit
       std::vector<Distribution>& dists,
       arma::vec& weights);
 
+  //! The type of the covariance of each distribution: a vector of the
+  //! diagonal for DiagonalGaussianDistribution, a matrix otherwise.
+  using CovType = std::conditional_t<std::is_same_v<Distribution,
+      DiagonalGaussianDistribution<>>, arma::vec, arma::mat>;
+
   /**
-   * Calculate the log-likelihood of a model.  Yes, this is reimplemented in the
-   * GMM code.  Intuition suggests that the log-likelihood is not the best way
+   * Compute the log-likelihood of the observations under the given model, and
+   * accumulate the sufficient statistics of the M-step.  The statistics of
+   * each distribution are taken relative to its current mean, for numerical
+   * stability.  Intuition suggests that the log-likelihood is not the best way
    * to determine if the EM algorithm has converged.
    *
-   * @param data Data matrix.
-   * @param means Vector of means.
-   * @param dists Distributions to store model in.
+   * @param observations List of observations.
+   * @param probabilities Probability of each point being from this model, or
+   *     NULL if all points have probability 1.
+   * @param dists Distributions of the model.
    * @param weights Vector of a priori weights.
+   * @param respSums Sum of the responsibilities of each distribution.
+   * @param sums Weighted sum of the observations (minus the mean) of each
+   *     distribution.
+   * @param scatters Weighted scatter of the observations (minus the mean) of
+   *     each distribution.
    */
-  double LogLikelihood(
-      const arma::mat& data,
-      const std::vector<Distribution>& dists,
-      const arma::vec& weights) const;
+  double EStep(const arma::mat& observations,
+               const arma::vec* probabilities,
+               const std::vector<Distribution>& dists,
+               const arma::vec& weights,
+               arma::vec& respSums,
+               std::vector<arma::vec>& sums,
+               std::vector<CovType>& scatters) const;
+
+  /**
+   * Update the model from the sufficient statistics computed by EStep().
+   * Distributions with no responsibility at all are left unchanged.
+   *
+   * @param respSums Sum of the responsibilities of each distribution.
+   * @param sums Weighted sum of the observations (minus the mean) of each
+   *     distribution.
+   * @param scatters Weighted scatter of the observations (minus the mean) of
+   *     each distribution.
+   * @param totalWeight Sum of the probabilities of all observations.
+   * @param dists Distributions to update.
+   * @param weights Vector of a priori weights to update.
+   */
+  void MStep(const arma::vec& respSums,
+             const std::vector<arma::vec>& sums,
+             std::vector<CovType>& scatters,
+             const double totalWeight,
+             std::vector<Distribution>& dists,
+             arma::vec& weights);
 
   /**
    * Use the Armadillo gmm_diag clusterer to train a GMM with diagonal
@@ -176,6 +226,9 @@ class EMFit
       arma::vec& weights,
       const bool useInitialModel);
 
+  //! Number of observations in each block of the E-step.
+  static constexpr size_t BlockSize = 1024;
+
   //! Maximum iterations of EM algorithm.
   size_t maxIterations;
   //! Tolerance for convergence of EM.
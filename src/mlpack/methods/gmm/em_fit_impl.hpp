@@ -69,13 +69,18 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The sufficient statistics of the M-step, which are computed along with the
+  // log-likelihood of the current model.
+  arma::vec respSums;
+  std::vector<arma::vec> sums;
+  std::vector<CovType> scatters;
+  double l = EStep(observations, NULL, dists, weights, respSums, sums,
+      scatters);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
@@ -84,80 +89,14 @@ Estimate(const arma::mat& observations,
     Log::Info << "EMFit::Estimate(): iteration " << iteration << ", "
         << "log-likelihood " << l << "." << std::endl;
 
-    // Calculate the conditional probabilities of choosing a particular
+    // Update the model from the conditional probabilities of choosing each
     // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += std::log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // Store the sum of the probability of each state over all the observations.
-    arma::vec probRowSums(dists.size());
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      probRowSums(i) = AccuLog(condLogProb.col(i));
-    }
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-        dists[i].Mean() = observations * exp(condLogProb.col(i) -
-                                                   probRowSums[i]);
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same_v<Distribution, DiagonalGaussianDistribution<>>)
-      {
-        arma::vec covariance = sum((tmp % tmp) %
-            (ones<arma::vec>(observations.n_rows) *
-            trans(exp(condLogProb.col(i) - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(exp(condLogProb.col(i) -
-                                                          probRowSums[i]));
-        arma::mat covariance = tmp * trans(tmpB);
+    MStep(respSums, sums, scatters, observations.n_cols, dists, weights);
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(covariance);
-        dists[i].Covariance(std::move(covariance));
-      }
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = exp(probRowSums - std::log(observations.n_cols));
-
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the statistics for
+    // the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = EStep(observations, NULL, dists, weights, respSums, sums, scatters);
 
     iteration++;
   }
@@ -176,100 +115,34 @@ Estimate(const arma::mat& observations,
   if (!useInitialModel)
     InitialClustering(observations, dists, weights);
 
-  double l = LogLikelihood(observations, dists, weights);
+  // The sufficient statistics of the M-step, which are computed along with the
+  // log-likelihood of the current model.
+  arma::vec respSums;
+  std::vector<arma::vec> sums;
+  std::vector<CovType> scatters;
+  double l = EStep(observations, &probabilities, dists, weights, respSums,
+      sums, scatters);
 
   Log::Debug << "EMFit::Estimate(): initial clustering log-likelihood: "
       << l << std::endl;
 
   double lOld = -DBL_MAX;
-  arma::mat condLogProb(observations.n_cols, dists.size());
+  const double totalWeight = accu(probabilities);
 
   // Iterate to update the model until no more improvement is found.
   size_t iteration = 1;
   while (std::abs(l - lOld) > tolerance && iteration != maxIterations)
   {
-    // Calculate the conditional probabilities of choosing a particular
-    // Gaussian given the observations and the present theta value.
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Store conditional log probabilities into condLogProb vector for each
-      // Gaussian.  First we make an alias of the condLogProb vector.
-      arma::vec condLogProbAlias = condLogProb.unsafe_col(i);
-      dists[i].LogProbability(observations, condLogProbAlias);
-      condLogProbAlias += std::log(weights[i]);
-    }
-
-    // Normalize row-wise.
-    for (size_t i = 0; i < condLogProb.n_rows; ++i)
-    {
-      // Avoid dividing by zero; if the probability for everything is 0, we
-      // don't want to make it NaN.
-      const double probSum = AccuLog(condLogProb.row(i));
-      if (probSum != -std::numeric_limits<double>::infinity())
-        condLogProb.row(i) -= probSum;
-    }
-
-    // This will store the sum of probabilities of each state over all the
-    // observations.
-    arma::vec probRowSums(dists.size());
-
-    // Calculate the new value of the means using the updated conditional
-    // probabilities.
-    arma::vec logProbabilities = log(probabilities);
-    for (size_t i = 0; i < dists.size(); ++i)
-    {
-      // Calculate the sum of probabilities of points, which is the
-      // conditional probability of each point being from Gaussian i
-      // multiplied by the probability of the point being from this mixture
-      // model.
-      arma::vec tmpProb = condLogProb.col(i) + logProbabilities;
-      probRowSums[i] = AccuLog(tmpProb);
-
-      // Don't update if there's no probability of the Gaussian having points.
-      if (probRowSums[i] != -std::numeric_limits<double>::infinity())
-      {
-        dists[i].Mean() = observations *
-              exp(condLogProb.col(i) + logProbabilities - probRowSums[i]);
-      }
-      else
-        continue;
-
-      // Calculate the new value of the covariances using the updated
-      // conditional probabilities and the updated means.
-      arma::mat tmp = observations.each_col() - dists[i].Mean();
-
-      // If the distribution is DiagonalGaussianDistribution, calculate the
-      // covariance only with diagonal components.
-      if (std::is_same_v<Distribution, DiagonalGaussianDistribution<>>)
-      {
-        arma::vec cov = sum((tmp % tmp) %
-            (ones<arma::vec>(observations.n_rows) *
-            trans(exp(condLogProb.col(i) +
-                            logProbabilities - probRowSums[i]))), 1);
-
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-      else
-      {
-        arma::mat tmpB = tmp.each_row() % trans(exp(condLogProb.col(i) +
-            logProbabilities - probRowSums[i]));
-        arma::mat cov = (tmp * trans(tmpB));
+    // Update the model from the conditional probabilities of choosing each
+    // Gaussian given the observations and the present theta value, multiplied
+    // by the probability of each point being from this mixture model.
+    MStep(respSums, sums, scatters, totalWeight, dists, weights);
 
-        // Apply covariance constraint.
-        constraint.ApplyConstraint(cov);
-        dists[i].Covariance(std::move(cov));
-      }
-    }
-
-    // Calculate the new values for omega using the updated conditional
-    // probabilities.
-    weights = exp(probRowSums - AccuLog(logProbabilities));
-
-    // Update values of l; calculate new log-likelihood.
+    // Update values of l; calculate new log-likelihood and the statistics for
+    // the next iteration.
     lOld = l;
-    l = LogLikelihood(observations, dists, weights);
+    l = EStep(observations, &probabilities, dists, weights, respSums, sums,
+        scatters);
 
     iteration++;
   }
@@ -373,36 +246,192 @@ template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
 double EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
-LogLikelihood(const arma::mat& observations,
-              const std::vector<Distribution>& dists,
-              const arma::vec& weights) const
+EStep(const arma::mat& observations,
+      const arma::vec* probabilities,
+      const std::vector<Distribution>& dists,
+      const arma::vec& weights,
+      arma::vec& respSums,
+      std::vector<arma::vec>& sums,
+      std::vector<CovType>& scatters) const
 {
-  double logLikelihood = 0;
+  constexpr bool isGaussian = std::is_same_v<Distribution,
+      GaussianDistribution<>>;
+  constexpr bool isDiagGaussDist = std::is_same_v<Distribution,
+      DiagonalGaussianDistribution<>>;
 
-  arma::vec logPhis;
-  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+  const size_t k = dists.size();
+  const size_t d = observations.n_rows;
+  const arma::vec logWeights = log(weights);
+  const double log2pi = std::log(2.0 * arma::datum::pi);
 
-  // It has to be LogProbability() otherwise Probability() would overflow easily
-  for (size_t i = 0; i < dists.size(); ++i)
+  // For Gaussians, the Mahalanobis distance of x is ||L^{-1} (x - mu)||^2,
+  // where L is the lower Cholesky factor of the covariance.
+  std::vector<arma::mat> covLower(isGaussian ? k : 0);
+  arma::vec logNormalizers(k);
+  if constexpr (isGaussian)
   {
-    dists[i].LogProbability(observations, logPhis);
-    logLikelihoods.row(i) = std::log(weights(i)) + trans(logPhis);
+    for (size_t i = 0; i < k; ++i)
+    {
+      if (!arma::chol(covLower[i], dists[i].Covariance(), "lower"))
+      {
+        Log::Fatal << "EMFit::Estimate(): Cholesky decomposition failed."
+            << std::endl;
+      }
+      logNormalizers[i] = logWeights[i] - 0.5 * d * log2pi -
+          0.5 * dists[i].LogDetCov();
+    }
   }
-  // Now sum over every point.
-  for (size_t j = 0; j < observations.n_cols; ++j)
+
+  respSums.zeros(k);
+  sums.resize(k);
+  scatters.resize(k);
+  for (size_t i = 0; i < k; ++i)
+  {
+    sums[i].zeros(d);
+    if constexpr (isDiagGaussDist)
+      scatters[i].zeros(d);
+    else
+      scatters[i].zeros(d, d);
+  }
+
+  const size_t numBlocks = (observations.n_cols + BlockSize - 1) / BlockSize;
+  double logLikelihood = 0.0;
+  size_t outliers = 0;
+
+  #pragma omp parallel reduction(+:logLikelihood, outliers)
   {
-    if (AccuLog(logLikelihoods.col(j)) ==
-        -std::numeric_limits<double>::infinity())
+    // The statistics of the blocks of this thread.
+    arma::vec threadRespSums(k, arma::fill::zeros);
+    std::vector<arma::vec> threadSums(sums);
+    std::vector<CovType> threadScatters(scatters);
+
+    arma::mat block, diffs, logProbs, resp;
+    arma::vec logPhis;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t b = 0; b < numBlocks; ++b)
     {
-      Log::Info << "Likelihood of point " << j << " is 0!  It is probably an "
-          << "outlier." << std::endl;
+      const size_t begin = b * BlockSize;
+      const size_t count = std::min(BlockSize,
+          (size_t) observations.n_cols - begin);
+      MakeAlias(block, observations, d, count, begin * d, false);
+
+      // Compute the log-probability of each point for each distribution.
+      logProbs.set_size(k, count);
+      for (size_t i = 0; i < k; ++i)
+      {
+        if constexpr (isGaussian)
+        {
+          diffs = block.each_col() - dists[i].Mean();
+          const arma::mat z = arma::solve(arma::trimatl(covLower[i]), diffs);
+          logProbs.row(i) = logNormalizers[i] - 0.5 * sum(square(z), 0);
+        }
+        else
+        {
+          dists[i].LogProbability(block, logPhis);
+          logProbs.row(i) = logWeights[i] + logPhis.t();
+        }
+      }
+
+      // Normalize the probabilities of each point to get its responsibilities.
+      resp.set_size(k, count);
+      for (size_t j = 0; j < count; ++j)
+      {
+        const double probSum = AccuLog(logProbs.col(j));
+        logLikelihood += probSum;
+
+        // Avoid dividing by zero; if the probability for everything is 0, we
+        // don't want to make it NaN.
+        if (probSum == -std::numeric_limits<double>::infinity())
+        {
+          ++outliers;
+          resp.col(j).zeros();
+          continue;
+        }
+
+        resp.col(j) = exp(logProbs.col(j) - probSum);
+        if (probabilities)
+          resp.col(j) *= (*probabilities)[begin + j];
+      }
+
+      // Accumulate the weighted sums and scatters of the points.
+      for (size_t i = 0; i < k; ++i)
+      {
+        const arma::rowvec r = resp.row(i);
+        const double rSum = accu(r);
+        if (rSum == 0.0)
+          continue;
+
+        diffs = block.each_col() - dists[i].Mean();
+        threadRespSums[i] += rSum;
+        threadSums[i] += diffs * r.t();
+        if constexpr (isDiagGaussDist)
+          threadScatters[i] += square(diffs) * r.t();
+        else
+          threadScatters[i] += (diffs.each_row() % r) * diffs.t();
+      }
+    }
+
+    #pragma omp critical
+    {
+      respSums += threadRespSums;
+      for (size_t i = 0; i < k; ++i)
+      {
+        sums[i] += threadSums[i];
+        scatters[i] += threadScatters[i];
+      }
     }
-    logLikelihood += AccuLog(logLikelihoods.col(j));
+  }
+
+  if (outliers > 0)
+  {
+    Log::Info << "EMFit::Estimate(): the likelihood of " << outliers
+        << " points is 0!  They are probably outliers." << std::endl;
   }
 
   return logLikelihood;
 }
 
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void EMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+MStep(const arma::vec& respSums,
+      const std::vector<arma::vec>& sums,
+      std::vector<CovType>& scatters,
+      const double totalWeight,
+      std::vector<Distribution>& dists,
+      arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (respSums[i] == 0.0)
+      continue;
+
+    // The statistics are relative to the old mean, so the new mean is the old
+    // mean plus the average offset, and the new covariance is the scatter
+    // around the old mean minus the outer product of that offset.
+    const arma::vec offset = sums[i] / respSums[i];
+    dists[i].Mean() += offset;
+
+    CovType covariance = std::move(scatters[i]);
+    covariance /= respSums[i];
+    if constexpr (std::is_same_v<CovType, arma::vec>)
+      covariance -= square(offset);
+    else
+      covariance -= offset * offset.t();
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  // Calculate the new values for omega using the updated conditional
+  // probabilities.
+  weights = respSums / totalWeight;
+}
+
 template<typename InitialClusteringType,
          typename CovarianceConstraintPolicy,
          typename Distribution>
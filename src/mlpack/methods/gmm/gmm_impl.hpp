@@ -86,11 +86,12 @@ inline void GMM::LogProbability(const arma::mat& observation,
   // Store log-probability value in a matrix.
   arma::mat logProb(observation.n_cols, gaussians);
 
-  // Assign value to the matrix.
+  // Assign value to the matrix.  The workspace is shared by all components.
+  arma::mat workspace;
   for (size_t i = 0; i < gaussians; i++)
   {
     arma::vec temp(logProb.colptr(i), observation.n_cols, false, true);
-    dists[i].LogProbability(observation, temp);
+    dists[i].LogProbability(observation, temp, workspace);
   }
 
   // Save log(weights) as a vector.
@@ -230,18 +231,20 @@ inline double GMM::LogLikelihood(
     const arma::vec& weightsL) const
 {
   double loglikelihood = 0;
-  arma::vec logPhis;
   arma::mat logLikelihoods(gaussians, data.n_cols);
 
   // It has to be LogProbability() otherwise Probability() would overflow easily
+  #pragma omp parallel for schedule(dynamic)
   for (size_t i = 0; i < gaussians; ++i)
   {
+    arma::vec logPhis;
     distsL[i].LogProbability(data, logPhis);
     logLikelihoods.row(i) = std::log(weightsL(i)) + trans(logPhis);
   }
 
   // Now sum over every point.
-  for (size_t j = 0; j < data.n_cols; ++j)
+  #pragma omp parallel for reduction(+:loglikelihood) schedule(static)
+  for (size_t j = 0; j < (size_t) data.n_cols; ++j)
     loglikelihood += AccuLog(logLikelihoods.col(j));
   return loglikelihood;
 }
@@ -413,6 +416,26 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the GMM with one chunk of a stream of observations.
+ */
+template<typename FittingType>
+double GMM::TrainOnline(const arma::mat& observations,
+                        FittingType& fitter,
+                        const bool useExistingModel)
+{
+  util::CheckSameDimensionality(observations, dimensionality,
+      "GMM::TrainOnline()");
+
+  const double logLikelihood = fitter.Update(observations, dists, weights,
+      useExistingModel);
+
+  Log::Info << "GMM::TrainOnline(): log-likelihood of the chunk is "
+      << logLikelihood << " (after " << fitter.Steps() << " chunks)."
+      << std::endl;
+  return logLikelihood;
+}
+
 /**
  * Serialize the object.
  */
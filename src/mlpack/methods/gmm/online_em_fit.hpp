@@ -0,0 +1,163 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Online (stepwise) EM for fitting GMMs to a stream of chunks of observations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "em_fit.hpp"
+
+namespace mlpack {
+
+/**
+ * This class fits a GMM to observations that arrive in chunks, with the
+ * stepwise (online) EM algorithm of
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={{On-line Expectation-Maximization Algorithm for Latent Data
+ *       Models}},
+ *   author={Capp{\'e}, O. and Moulines, E.},
+ *   journal={Journal of the Royal Statistical Society: Series B},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * The fitter keeps running averages of the sufficient statistics of each
+ * component (its weight, and the weighted first and second moments of the
+ * observations).  Each call to Update() computes the statistics of one chunk
+ * under the current model (with the parallel, blocked E-step of EMFit), mixes
+ * them into the running averages with the step size
+ * `(t + 1)^(-stepExponent)` for the t-th chunk, and sets the model from the
+ * running averages.  Only the current chunk has to be held in memory.  With
+ * `stepExponent = 1` every chunk has the same weight; smaller exponents (the
+ * exponent must be in (0.5, 1]) forget old chunks faster, which lets the model
+ * follow a slowly drifting stream.
+ *
+ * Unless the existing model is used, the first chunk is fitted with batch EM
+ * (an EMFit with the given initial clustering), so it should be large enough
+ * for that.
+ *
+ * @code
+ * GMM gmm(5, 10);
+ * OnlineEMFit<> fitter;
+ * arma::mat chunk;
+ * while (ReadNextChunk(chunk)) // Some function that reads the stream.
+ *   gmm.TrainOnline(chunk, fitter);
+ * @endcode
+ *
+ * @tparam InitialClusteringType Clustering used by batch EM on the first chunk.
+ * @tparam CovarianceConstraintPolicy Constraint applied to the covariances.
+ * @tparam Distribution Type of the components of the mixture.
+ */
+template<typename InitialClusteringType = KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = GaussianDistribution<>>
+class OnlineEMFit
+{
+ public:
+  //! The batch EM fitter used for the first chunk and for the E-steps.
+  using BatchFitType = EMFit<InitialClusteringType, CovarianceConstraintPolicy,
+      Distribution>;
+
+  /**
+   * Construct the OnlineEMFit object.  std::invalid_argument is thrown if the
+   * step exponent is not in (0.5, 1].
+   *
+   * @param stepExponent Exponent of the decay of the step size.
+   * @param maxIterations Maximum number of iterations of batch EM on the first
+   *     chunk.
+   * @param tolerance Log-likelihood tolerance of batch EM on the first chunk.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const double stepExponent = 0.6,
+              const size_t maxIterations = 300,
+              const double tolerance = 1e-10,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Update the model with one chunk of observations.  The size of the vectors
+   * (indicating the number of components) must already be set.  On the first
+   * call (or the first call after Reset()), if useInitialModel is true, the
+   * given model is taken as the running estimate, counting as one chunk;
+   * otherwise, the model is fitted to the chunk with batch EM.
+   *
+   * @param observations Chunk of observations.
+   * @param dists Distributions of the model, which are updated.
+   * @param weights A priori weights of the model, which are updated.
+   * @param useInitialModel If true, the given model is used as the initial
+   *     estimate.
+   * @return The log-likelihood of the chunk under the model before the update
+   *     (or under the fitted model, for a first chunk fitted with batch EM).
+   */
+  double Update(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  //! Forget the running statistics, so the next Update() starts over.
+  void Reset();
+
+  //! Get the exponent of the decay of the step size.
+  double StepExponent() const { return stepExponent; }
+  //! Modify the exponent of the decay of the step size.
+  double& StepExponent() { return stepExponent; }
+
+  //! Get the number of chunks seen since the last reset.
+  size_t Steps() const { return steps; }
+
+  //! Get the batch EM fitter.
+  const BatchFitType& BatchFit() const { return batchFit; }
+  //! Modify the batch EM fitter.
+  BatchFitType& BatchFit() { return batchFit; }
+
+  //! Serialize the fitter, including the running statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! The type of the second moments of each component.
+  using CovType = typename BatchFitType::CovType;
+
+  //! Set the running statistics from the given model.
+  void InitializeStatistics(const std::vector<Distribution>& dists,
+                            const arma::vec& weights);
+
+  //! Set the model from the running statistics.
+  void UpdateModel(std::vector<Distribution>& dists, arma::vec& weights);
+
+  //! Exponent of the decay of the step size.
+  double stepExponent;
+  //! Number of chunks seen since the last reset.
+  size_t steps;
+  //! The batch EM fitter.
+  BatchFitType batchFit;
+
+  //! Running average of the responsibility of each component.
+  arma::vec counts;
+  //! Running average of the weighted observations of each component.
+  std::vector<arma::vec> sums;
+  //! Running average of the weighted second moments of each component.
+  std::vector<CovType> moments;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of online (stepwise) EM for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+
+namespace mlpack {
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const double stepExponent,
+            const size_t maxIterations,
+            const double tolerance,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    stepExponent(stepExponent),
+    steps(0),
+    batchFit(maxIterations, tolerance, clusterer, constraint)
+{
+  if (stepExponent <= 0.5 || stepExponent > 1.0)
+  {
+    throw std::invalid_argument("OnlineEMFit::OnlineEMFit(): the step "
+        "exponent must be in (0.5, 1]!");
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& observations,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights,
+                          const bool useInitialModel)
+{
+  arma::vec respSums;
+  std::vector<arma::vec> chunkSums;
+  std::vector<CovType> chunkScatters;
+
+  // Start from batch EM on the first chunk, unless we were given a model.
+  if (steps == 0)
+  {
+    if (!useInitialModel)
+    {
+      batchFit.Estimate(observations, dists, weights, false);
+      InitializeStatistics(dists, weights);
+      steps = 1;
+      return batchFit.EStep(observations, NULL, dists, weights, respSums,
+          chunkSums, chunkScatters);
+    }
+
+    InitializeStatistics(dists, weights);
+    steps = 1;
+  }
+
+  // The statistics of the chunk are relative to the current means.
+  const double logLikelihood = batchFit.EStep(observations, NULL, dists,
+      weights, respSums, chunkSums, chunkScatters);
+
+  const double n = observations.n_cols;
+  const double stepSize = std::pow(steps + 1.0, -stepExponent);
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec& mean = dists[i].Mean();
+    const double count = respSums[i] / n;
+    const arma::vec sum = chunkSums[i] / n;
+
+    // Turn the statistics around the mean into raw moments.
+    CovType moment = chunkScatters[i] / n;
+    if constexpr (std::is_same_v<CovType, arma::vec>)
+      moment += 2.0 * (sum % mean) + count * (mean % mean);
+    else
+      moment += sum * mean.t() + mean * sum.t() + count * (mean * mean.t());
+
+    counts[i] = (1.0 - stepSize) * counts[i] + stepSize * count;
+    sums[i] = (1.0 - stepSize) * sums[i] + stepSize * (sum + count * mean);
+    moments[i] = (1.0 - stepSize) * moments[i] + stepSize * moment;
+  }
+  ++steps;
+
+  UpdateModel(dists, weights);
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Reset()
+{
+  steps = 0;
+  counts.clear();
+  sums.clear();
+  moments.clear();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitializeStatistics(const std::vector<Distribution>& dists,
+                                        const arma::vec& weights)
+{
+  counts = weights / accu(weights);
+  sums.resize(dists.size());
+  moments.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    const arma::vec& mean = dists[i].Mean();
+    sums[i] = counts[i] * mean;
+    if constexpr (std::is_same_v<CovType, arma::vec>)
+      moments[i] = counts[i] * (dists[i].Covariance() + mean % mean);
+    else
+      moments[i] = counts[i] * (dists[i].Covariance() + mean * mean.t());
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::UpdateModel(std::vector<Distribution>& dists,
+                               arma::vec& weights)
+{
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (counts[i] == 0.0)
+      continue;
+
+    dists[i].Mean() = sums[i] / counts[i];
+    const arma::vec& mean = dists[i].Mean();
+
+    CovType covariance = moments[i] / counts[i];
+    if constexpr (std::is_same_v<CovType, arma::vec>)
+      covariance -= mean % mean;
+    else
+      covariance -= mean * mean.t();
+
+    // Apply covariance constraint.
+    batchFit.Constraint().ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+
+  weights = counts / accu(counts);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(stepExponent));
+  ar(CEREAL_NVP(steps));
+  ar(CEREAL_NVP(batchFit));
+  ar(CEREAL_NVP(counts));
+  ar(CEREAL_NVP(sums));
+  ar(CEREAL_NVP(moments));
+}
+
+} // namespace mlpack
+
+#endif
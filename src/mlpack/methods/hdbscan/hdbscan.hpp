@@ -0,0 +1,162 @@
+/**
+ * @file methods/hdbscan/hdbscan.hpp
+ *
+ * An implementation of the HDBSCAN clustering method, built on the dual-tree
+ * Boruvka minimum spanning tree algorithm.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/neighbor_search/neighbor_search.hpp>
+#include <mlpack/methods/emst/dtb.hpp>
+#include <mlpack/methods/emst/union_find.hpp>
+
+namespace mlpack {
+
+/**
+ * HDBSCAN (Hierarchical DBSCAN) is a clustering technique described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{campello2013density,
+ *   title={Density-based clustering based on hierarchical density estimates},
+ *   author={Campello, R.J.G.B. and Moulavi, D. and Sander, J.},
+ *   booktitle={Pacific-Asia Conference on Knowledge Discovery and Data Mining
+ *       (PAKDD 2013)},
+ *   pages={160--172},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * HDBSCAN finds the DBSCAN clusterings for all values of epsilon at once, and
+ * keeps the clusters that persist over the widest range of densities, so that
+ * clusters of different densities can be found in one run.
+ *
+ * The core distance of each point (the distance to its (minPoints - 1)-th
+ * nearest neighbor) is computed with one k-nearest-neighbor search, and the
+ * minimum spanning tree of the mutual reachability distance
+ * max(d(a, b), core(a), core(b)) is computed with DualTreeBoruvka.  The
+ * hierarchy of that tree is condensed into the clusters that have at least
+ * minClusterSize points, and the most stable of these are selected ("excess of
+ * mass").
+ *
+ * @tparam DistanceType The distance metric to use.
+ * @tparam TreeType The type of tree to use for the nearest neighbor search and
+ *      the minimum spanning tree.
+ */
+template<
+    typename DistanceType = EuclideanDistance,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType = KDTree
+>
+class HDBSCAN
+{
+ public:
+  /**
+   * Construct the HDBSCAN object with the given parameters.
+   *
+   * @param minClusterSize Minimum number of points of a cluster.
+   * @param minPoints Number of points (including itself) in the neighborhood
+   *     of a point that defines its core distance; 0 means minClusterSize.
+   * @param allowSingleCluster If true, all the points may be returned as one
+   *     cluster.
+   * @param distance Optional instantiated distance metric.
+   */
+  HDBSCAN(const size_t minClusterSize = 5,
+          const size_t minPoints = 0,
+          const bool allowSingleCluster = false,
+          const DistanceType distance = DistanceType());
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters
+   * and also the list of cluster assignments.  If assignments[i] == SIZE_MAX,
+   * then the point is considered "noise".
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   */
+  size_t Cluster(const arma::mat& data,
+                 arma::Row<size_t>& assignments);
+
+  /**
+   * Performs HDBSCAN clustering on the data, returning the number of clusters,
+   * the list of cluster assignments, and the strength of the membership of
+   * each point to its cluster, between 0 and 1 (1 for the points that stay in
+   * the cluster until its densest level; 0 for noise).
+   *
+   * @param data Dataset to cluster.
+   * @param assignments Vector to store cluster assignments.
+   * @param probabilities Vector to store the membership strengths.
+   */
+  size_t Cluster(const arma::mat& data,
+                 arma::Row<size_t>& assignments,
+                 arma::rowvec& probabilities);
+
+  //! Get the minimum number of points of a cluster.
+  size_t MinClusterSize() const { return minClusterSize; }
+  //! Modify the minimum number of points of a cluster.
+  size_t& MinClusterSize() { return minClusterSize; }
+
+  //! Get the number of points that defines the core distance (0 means
+  //! MinClusterSize()).
+  size_t MinPoints() const { return minPoints; }
+  //! Modify the number of points that defines the core distance (0 means
+  //! MinClusterSize()).
+  size_t& MinPoints() { return minPoints; }
+
+  //! Get whether all the points may be returned as one cluster.
+  bool AllowSingleCluster() const { return allowSingleCluster; }
+  //! Modify whether all the points may be returned as one cluster.
+  bool& AllowSingleCluster() { return allowSingleCluster; }
+
+ private:
+  //! Minimum number of points of a cluster.
+  size_t minClusterSize;
+
+  //! Number of points in the neighborhood of a point (including itself) that
+  //! defines its core distance; 0 means minClusterSize.
+  size_t minPoints;
+
+  //! Whether all the points may be returned as one cluster.
+  bool allowSingleCluster;
+
+  //! The instantiated distance metric.
+  DistanceType distance;
+
+  /**
+   * Compute the core distance of each point: the distance to its
+   * (minPoints - 1)-th nearest neighbor, or 0 if minPoints is 1.
+   *
+   * @param data Dataset to cluster.
+   * @param coreDistances Vector to store the core distances.
+   */
+  void CoreDistances(const arma::mat& data, arma::vec& coreDistances);
+
+  /**
+   * Build the single-linkage hierarchy of the minimum spanning tree, condense
+   * it, and assign each point to the selected cluster that contains it.
+   *
+   * @param mst Sorted edges of the minimum spanning tree, from
+   *     DualTreeBoruvka::ComputeMST().
+   * @param assignments Vector to store cluster assignments.
+   * @param probabilities Vector to store the membership strengths.
+   * @return The number of clusters.
+   */
+  size_t ExtractClusters(const arma::mat& mst,
+                         arma::Row<size_t>& assignments,
+                         arma::rowvec& probabilities) const;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "hdbscan_impl.hpp"
+
+#endif
@@ -0,0 +1,312 @@
+/**
+ * @file methods/hdbscan/hdbscan_impl.hpp
+ *
+ * Implementation of HDBSCAN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+#define MLPACK_METHODS_HDBSCAN_HDBSCAN_IMPL_HPP
+
+#include "hdbscan.hpp"
+
+namespace mlpack {
+
+/**
+ * Construct the HDBSCAN object with the given parameters.
+ */
+template<
+    typename DistanceType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+HDBSCAN<DistanceType, TreeType>::HDBSCAN(const size_t minClusterSize,
+                                         const size_t minPoints,
+                                         const bool allowSingleCluster,
+                                         const DistanceType distance) :
+    minClusterSize(minClusterSize),
+    minPoints(minPoints),
+    allowSingleCluster(allowSingleCluster),
+    distance(distance)
+{
+  // Nothing to do.
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters
+ * and also the list of cluster assignments.
+ */
+template<
+    typename DistanceType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<DistanceType, TreeType>::Cluster(
+    const arma::mat& data,
+    arma::Row<size_t>& assignments)
+{
+  // The membership strengths are thrown away.
+  arma::rowvec probabilities;
+  return Cluster(data, assignments, probabilities);
+}
+
+/**
+ * Performs HDBSCAN clustering on the data, returning the number of clusters,
+ * the list of cluster assignments and the membership strengths.
+ */
+template<
+    typename DistanceType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<DistanceType, TreeType>::Cluster(
+    const arma::mat& data,
+    arma::Row<size_t>& assignments,
+    arma::rowvec& probabilities)
+{
+  if (minClusterSize < 2)
+  {
+    throw std::invalid_argument("HDBSCAN::Cluster(): minClusterSize must be "
+        "at least 2!");
+  }
+
+  // There are not enough points for a cluster, so all of them are noise.
+  if (data.n_cols < minClusterSize)
+  {
+    assignments.set_size(data.n_cols);
+    assignments.fill(SIZE_MAX);
+    probabilities.zeros(data.n_cols);
+    return 0;
+  }
+
+  arma::vec coreDistances;
+  CoreDistances(data, coreDistances);
+
+  // Each column of the results holds one edge, sorted by increasing distance.
+  arma::mat mst;
+  DualTreeBoruvka<DistanceType, arma::mat, TreeType> dtb(data, false,
+      distance);
+  dtb.ComputeMST(mst, coreDistances);
+
+  return ExtractClusters(mst, assignments, probabilities);
+}
+
+/**
+ * Compute the core distance of each point with a k-nearest-neighbor search.
+ */
+template<
+    typename DistanceType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+void HDBSCAN<DistanceType, TreeType>::CoreDistances(
+    const arma::mat& data,
+    arma::vec& coreDistances)
+{
+  const size_t neighborhood = (minPoints == 0) ? minClusterSize : minPoints;
+  if (neighborhood <= 1)
+  {
+    // The neighborhood is only the point itself.
+    coreDistances.zeros(data.n_cols);
+    return;
+  }
+
+  if (neighborhood > data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "HDBSCAN::Cluster(): minPoints (" << neighborhood << ") is greater "
+        << "than the number of points (" << data.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // The neighborhood of a point includes the point itself, which is not
+  // returned by the monochromatic search.
+  NeighborSearch<NearestNeighborSort, DistanceType, arma::mat, TreeType>
+      knn(data, DUAL_TREE_MODE, 0.0, distance);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  knn.Search(neighborhood - 1, neighbors, distances);
+
+  coreDistances = distances.row(neighborhood - 2).t();
+}
+
+/**
+ * Build the single-linkage hierarchy of the minimum spanning tree, condense it
+ * and select the most stable clusters.
+ */
+template<
+    typename DistanceType,
+    template<typename TreeDistanceType,
+             typename TreeStatType,
+             typename TreeMatType> class TreeType>
+size_t HDBSCAN<DistanceType, TreeType>::ExtractClusters(
+    const arma::mat& mst,
+    arma::Row<size_t>& assignments,
+    arma::rowvec& probabilities) const
+{
+  const size_t n = mst.n_cols + 1;
+
+  // In the single-linkage hierarchy, node i < n is point i, and node n + e
+  // joins the two components that the e-th shortest edge connects.
+  std::vector<size_t> left(n - 1), right(n - 1), sizes(2 * n - 1, 1);
+  std::vector<size_t> componentNode(n);
+  for (size_t i = 0; i < n; ++i)
+    componentNode[i] = i;
+
+  UnionFind uf(n);
+  for (size_t e = 0; e < n - 1; ++e)
+  {
+    const size_t a = uf.Find((size_t) mst(0, e));
+    const size_t b = uf.Find((size_t) mst(1, e));
+    left[e] = componentNode[a];
+    right[e] = componentNode[b];
+    sizes[n + e] = sizes[left[e]] + sizes[right[e]];
+
+    uf.Union(a, b);
+    componentNode[uf.Find(a)] = n + e;
+  }
+
+  // Clusters are compared by the density lambda = 1 / distance at which they
+  // appear and lose their points.  Duplicate points have a large (but finite)
+  // density, so that differences of densities are always defined.
+  auto lambdaOf = [&](const size_t e)
+  {
+    return 1.0 / std::max(mst(2, e), DBL_MIN);
+  };
+
+  // Condense the hierarchy, from the root.  A split where both sides have at
+  // least minClusterSize points creates two clusters; otherwise, the current
+  // cluster goes on in the large side (if there is one), and the points of the
+  // small sides fall out of it.  The stability of a cluster is the sum, over
+  // its points, of the difference between the density at which the point
+  // leaves the cluster and the density at which the cluster appears.  Cluster
+  // 0 is the root, and each cluster has a larger index than its parent.
+  std::vector<size_t> clusterParent(1, 0);
+  std::vector<double> birth(1, 0.0);
+  std::vector<double> stability(1, 0.0);
+  std::vector<size_t> pointCluster(n);
+  std::vector<double> pointLambda(n);
+
+  std::vector<size_t> subtree;
+  auto fallOut = [&](const size_t node, const size_t cluster,
+                     const double lambda)
+  {
+    subtree.push_back(node);
+    while (!subtree.empty())
+    {
+      const size_t x = subtree.back();
+      subtree.pop_back();
+      if (x < n)
+      {
+        pointCluster[x] = cluster;
+        pointLambda[x] = lambda;
+      }
+      else
+      {
+        subtree.push_back(left[x - n]);
+        subtree.push_back(right[x - n]);
+      }
+    }
+
+    stability[cluster] += (lambda - birth[cluster]) * sizes[node];
+  };
+
+  // Each element holds a node of the hierarchy and the cluster it belongs to.
+  std::vector<std::pair<size_t, size_t>> stack;
+  stack.emplace_back(2 * n - 2, 0);
+  while (!stack.empty())
+  {
+    const size_t e = stack.back().first - n;
+    const size_t cluster = stack.back().second;
+    stack.pop_back();
+
+    const double lambda = lambdaOf(e);
+    const bool largeLeft = (sizes[left[e]] >= minClusterSize);
+    const bool largeRight = (sizes[right[e]] >= minClusterSize);
+    if (largeLeft && largeRight)
+    {
+      for (const size_t child : { left[e], right[e] })
+      {
+        stability[cluster] += (lambda - birth[cluster]) * sizes[child];
+
+        clusterParent.push_back(cluster);
+        birth.push_back(lambda);
+        stability.push_back(0.0);
+        stack.emplace_back(child, clusterParent.size() - 1);
+      }
+    }
+    else
+    {
+      if (largeLeft)
+        stack.emplace_back(left[e], cluster);
+      else
+        fallOut(left[e], cluster, lambda);
+
+      if (largeRight)
+        stack.emplace_back(right[e], cluster);
+      else
+        fallOut(right[e], cluster, lambda);
+    }
+  }
+
+  // Select the clusters from the leaves up: a cluster is selected if it is
+  // at least as stable as its selected descendants together, and otherwise it
+  // is replaced by them.
+  const size_t numClusters = clusterParent.size();
+  std::vector<char> selected(numClusters, 0);
+  std::vector<char> hasChildren(numClusters, 0);
+  std::vector<double> childStability(numClusters, 0.0);
+  for (size_t c = numClusters - 1; c > 0; --c)
+  {
+    if (hasChildren[c] && childStability[c] > stability[c])
+      stability[c] = childStability[c];
+    else
+      selected[c] = 1;
+
+    childStability[clusterParent[c]] += stability[c];
+    hasChildren[clusterParent[c]] = 1;
+  }
+
+  if (allowSingleCluster &&
+      !(hasChildren[0] && childStability[0] > stability[0]))
+    selected[0] = 1;
+
+  // Number the selected clusters that have no selected ancestor; the other
+  // clusters take the number of their selected ancestor, if they have one.
+  std::vector<size_t> labels(numClusters, SIZE_MAX);
+  size_t numLabels = 0;
+  for (size_t c = 0; c < numClusters; ++c)
+  {
+    const size_t parentLabel = (c == 0) ? SIZE_MAX : labels[clusterParent[c]];
+    if (parentLabel != SIZE_MAX)
+      labels[c] = parentLabel;
+    else if (selected[c])
+      labels[c] = numLabels++;
+  }
+
+  // The membership strength of a point is the density at which it leaves its
+  // cluster, relative to the largest such density in the cluster.
+  assignments.set_size(n);
+  probabilities.zeros(n);
+  std::vector<double> maxLambda(numLabels, 0.0);
+  for (size_t i = 0; i < n; ++i)
+  {
+    assignments[i] = labels[pointCluster[i]];
+    if (assignments[i] != SIZE_MAX)
+      maxLambda[assignments[i]] = std::max(maxLambda[assignments[i]],
+          pointLambda[i]);
+  }
+
+  for (size_t i = 0; i < n; ++i)
+    if (assignments[i] != SIZE_MAX)
+      probabilities[i] = pointLambda[i] / maxLambda[assignments[i]];
+
+  return numLabels;
+}
+
+} // namespace mlpack
+
+#endif
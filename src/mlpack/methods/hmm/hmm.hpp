@@ -78,6 +78,12 @@ namespace mlpack {
  * (with Predict()), generate a sequence (with Generate()), or estimate the
  * probabilities of each state for a sequence of observations (with Train()).
  *
+ * If at most 10% of the entries of the transition matrix are nonzero (as for
+ * left-to-right HMMs with many states), the forward, backward and Viterbi
+ * recursions and the training only visit the nonzero transitions, so that each
+ * time step costs O(nnz) instead of O(states^2).  This is detected
+ * automatically whenever the transition matrix changes.
+ *
  * @tparam Distribution Type of emission distribution for this HMM.
  */
 template<typename Distribution = DiscreteDistribution<>>
@@ -160,6 +166,10 @@ class HMM
    * log-likelihood of the model between iterations is less than the tolerance,
    * the Baum-Welch algorithm terminates.
    *
+   * The E-step of each iteration is computed in parallel over the sequences
+   * with OpenMP, so training on many sequences scales with the number of
+   * cores.
+   *
    * @note
    * Train() can be called multiple times with different sequences; each time it
    * is called, it uses the current parameters of the HMM as a starting point
@@ -292,6 +302,31 @@ class HMM
    */
   double LogLikelihood(const arma::mat& dataSeq) const;
 
+  /**
+   * Compute the most probable hidden state sequence of each of the given data
+   * sequences, using the Viterbi algorithm.  The sequences are decoded in
+   * parallel with OpenMP, and each thread reuses its scratch matrices for all
+   * of the sequences it decodes.
+   *
+   * @param dataSeq Vector of sequences of observations.
+   * @param stateSeq Vector in which the most probable state sequence of each
+   *    data sequence will be stored.
+   * @return Log-likelihood of the most probable state sequence of each data
+   *    sequence.
+   */
+  arma::vec Predict(const std::vector<arma::mat>& dataSeq,
+                    std::vector<arma::Row<size_t>>& stateSeq) const;
+
+  /**
+   * Compute the log-likelihood of each of the given data sequences.  The
+   * sequences are evaluated in parallel with OpenMP, and each thread reuses its
+   * scratch matrices for all of the sequences it evaluates.
+   *
+   * @param dataSeq Vector of data sequences to evaluate the likelihood of.
+   * @return Log-likelihood of each of the given sequences.
+   */
+  arma::vec LogLikelihood(const std::vector<arma::mat>& dataSeq) const;
+
   /**
    * Compute the log of the scaling factor of the given emission probability
    * at time t. To calculate the log-likelihood for the whole sequence,
@@ -464,6 +499,101 @@ class HMM
                         const arma::vec& prevForwardLogProb) const;
 
   // Helper functions.
+  /**
+   * Compute the log-probability of each observation in the given data sequence
+   * under the emission distribution of each state.  The returned matrix has
+   * rows equal to the number of observations and columns equal to the number
+   * of hidden states.  For long sequences, the states are computed in
+   * parallel.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logProbs Matrix in which the log-probabilities will be saved.
+   */
+  void EmissionLogProbabilities(const arma::mat& dataSeq,
+                                arma::mat& logProbs) const;
+
+  /**
+   * Compute the emission log-probabilities of a one-dimensional sequence with
+   * discrete emissions, by looking them up in a table of the log-probability of
+   * each symbol under each state.  This is only used when Distribution is
+   * DiscreteDistribution<>; false is returned (and nothing is computed) if the
+   * states do not all have the same number of symbols.
+   *
+   * @param dataSeq Data sequence to compute probabilities for.
+   * @param logProbs Matrix in which the log-probabilities will be saved; it
+   *    must already have the right size.
+   * @return Whether the log-probabilities were computed.
+   */
+  bool DiscreteEmissionLogProbabilities(const arma::mat& dataSeq,
+                                        arma::mat& logProbs) const;
+
+  /**
+   * The Viterbi algorithm, given the emission log-probabilities of a sequence
+   * (as computed by EmissionLogProbabilities()).  Each step takes the maximum
+   * over the previous states for all of the states at once.  The scratch
+   * matrices are resized as needed, so they can be reused between calls.
+   *
+   * @param logProbs Emission log-probabilities of the sequence.
+   * @param stateSeq Vector in which the most probable state sequence will be
+   *    stored.
+   * @param logStateProb Scratch matrix for the log-probabilities of the best
+   *    paths.
+   * @param stateSeqBack Scratch matrix for the back pointers of the best paths.
+   * @param scores Scratch matrix for the scores of each step.
+   * @return Log-likelihood of most probable state sequence.
+   */
+  double Viterbi(const arma::mat& logProbs,
+                 arma::Row<size_t>& stateSeq,
+                 arma::mat& logStateProb,
+                 arma::umat& stateSeqBack,
+                 arma::mat& scores) const;
+
+  /**
+   * Compute `out[i] = log(sum_j exp(logTransition(i, j) + logProb[j]))`, the
+   * log-probability of moving into each state given the log-probabilities of
+   * the previous state, with the sparse representation of the transition
+   * matrix if it is used.  logProb and out may be the same vector.
+   *
+   * @param logProb Log-probabilities of the previous state.
+   * @param out Vector in which the log-probabilities will be saved.
+   * @param scores Scratch matrix for the dense computation.
+   */
+  void TransitionLogSumExp(const arma::vec& logProb,
+                           arma::vec& out,
+                           arma::mat& scores) const;
+
+  /**
+   * Compute the log-sum of the exponentials of the log-values of one
+   * compressed sparse row (or column) of the transition matrix, plus the
+   * log-probabilities of the states they come from (or go to).
+   *
+   * @param ptrs Row (or column) pointers of the compressed matrix.
+   * @param indices Column (or row) indices of the compressed matrix.
+   * @param logValues Log-values of the compressed matrix.
+   * @param logProb Log-probabilities indexed by `indices`.
+   * @param index Row (or column) to sum.
+   */
+  static double SparseLogSumExp(const arma::uvec& ptrs,
+                                const arma::uvec& indices,
+                                const arma::vec& logValues,
+                                const arma::vec& logProb,
+                                const size_t index);
+
+  /**
+   * Compute the log-likelihood of a sequence with the Forward algorithm, given
+   * its emission log-probabilities, keeping only the forward probabilities of
+   * the current time step.  The scratch matrices are resized as needed, so they
+   * can be reused between calls.
+   *
+   * @param logProbs Emission log-probabilities of the sequence.
+   * @param forwardLogProb Scratch vector for the forward probabilities.
+   * @param scores Scratch matrix for the scores of each step.
+   * @return Log-likelihood of the sequence.
+   */
+  double ForwardLogLikelihood(const arma::mat& logProbs,
+                              arma::vec& forwardLogProb,
+                              arma::mat& scores) const;
+
   /**
    * The Forward algorithm (part of the Forward-Backward algorithm).  Computes
    * forward probabilities for each state for each observation in the given data
@@ -515,6 +645,13 @@ class HMM
    */
   void ConvertToLogSpace() const;
 
+  /**
+   * Update the compressed sparse representations of logTransition, and
+   * whether they are used.  This must be called whenever logTransition
+   * changes.
+   */
+  void UpdateSparseTransition() const;
+
   /**
    * A proxy vriable in linear space for logInitial.
    * Should be removed in mlpack 4.0.
@@ -541,6 +678,33 @@ class HMM
    * Should be removed in mlpack 4.0.
    */
   mutable bool recalculateTransition;
+
+  /**
+   * The largest fraction of nonzero transitions for which the sparse
+   * representation of the transition matrix is used.
+   */
+  static constexpr double SparseTransitionDensity = 0.1;
+
+  //! Whether the sparse representation of the transition matrix is used.
+  mutable bool sparseTransition;
+
+  //! Column pointers of the nonzero transitions, in compressed sparse column
+  //! form (for the Backward algorithm and training).
+  mutable arma::uvec transitionColPtrs;
+  //! Row indices of the nonzero transitions, in compressed sparse column form.
+  mutable arma::uvec transitionRowIndices;
+  //! Log-probabilities of the nonzero transitions, in compressed sparse column
+  //! form.
+  mutable arma::vec logTransitionByCol;
+
+  //! Row pointers of the nonzero transitions, in compressed sparse row form
+  //! (for the Forward and Viterbi algorithms).
+  mutable arma::uvec transitionRowPtrs;
+  //! Column indices of the nonzero transitions, in compressed sparse row form.
+  mutable arma::uvec transitionColIndices;
+  //! Log-probabilities of the nonzero transitions, in compressed sparse row
+  //! form.
+  mutable arma::vec logTransitionByRow;
 };
 
 } // namespace mlpack
@@ -43,6 +43,7 @@ HMM<Distribution>::HMM(const size_t states,
 
   logTransition = log(transitionProxy);
   logInitial = log(initialProxy);
+  UpdateSparseTransition();
 }
 
 /**
@@ -73,6 +74,8 @@ HMM<Distribution>::HMM(const arma::vec& initial,
         << std::endl;
     dimensionality = 0;
   }
+
+  UpdateSparseTransition();
 }
 
 /**
@@ -112,11 +115,29 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
           << dimensionality << " dimensions)." << std::endl;
   }
 
+  // Make sure that the log-space parameters are up to date before the
+  // sequences are processed in parallel.
+  ConvertToLogSpace();
+
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  The observations
+  // themselves do not change between iterations, so they are only copied once;
+  // offsets[seq] is the position of the first observation of sequence seq.
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> offsets(dataSeq.size() + 1, 0);
+  for (size_t seq = 0; seq < dataSeq.size(); ++seq)
+    offsets[seq + 1] = offsets[seq] + dataSeq[seq].n_cols;
+
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t seq = 0; seq < dataSeq.size(); ++seq)
+  {
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(offsets[seq], offsets[seq + 1] - 1) = dataSeq[seq];
+    }
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -132,70 +153,132 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
+    // The sequences are independent, so the E-step is computed in parallel
+    // over them.  Each thread accumulates its own estimates of the initial and
+    // transition probabilities, which are merged at the end; the emission
+    // probabilities of each sequence have their own place in emissionProb.
+    // With sparse transitions, only the estimates of the nonzero transitions
+    // are accumulated (in the order of transitionRowIndices), since the others
+    // stay zero.
+    arma::vec newSparseLogTransition;
+    if (sparseTransition)
+    {
+      newSparseLogTransition.set_size(transitionRowIndices.n_elem);
+      newSparseLogTransition.fill(-std::numeric_limits<double>::infinity());
+    }
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    #pragma omp parallel reduction(+:loglik)
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
-          newLogInitial);
-
-      // Define a variable to store the value of log-probability for data.
-      arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
-      // Save the values of log-probability to logProbs.
-      for (size_t i = 0; i < logTransition.n_rows; i++)
+      arma::vec threadLogInitial(newLogInitial);
+      arma::mat threadLogTransition;
+      arma::vec threadSparseLogTransition;
+      if (sparseTransition)
+        threadSparseLogTransition = newSparseLogTransition;
+      else
+        threadLogTransition = newLogTransition;
+
+      #pragma omp for schedule(dynamic)
+      for (size_t seq = 0; seq < dataSeq.size(); seq++)
       {
-        // Define alias of desired column.
-        arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-        // Use advanced constructor for using logProbs directly.
-        emission[i].LogProbability(dataSeq[seq], alias);
+        if (dataSeq[seq].n_cols == 0)
+          continue;
+
+        arma::mat logProbs;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // Compute the log-probability of the data for each state, and run the
+        // forward-backward algorithm.  This is the E-step.
+        EmissionLogProbabilities(dataSeq[seq], logProbs);
+        Forward(dataSeq[seq], logScales, forwardLog, logProbs);
+        Backward(dataSeq[seq], logScales, backwardLog, logProbs);
+        arma::mat stateLogProb = forwardLog + backwardLog;
+
+        // Add the log-likelihood of this sequence.
+        loglik += accu(logScales);
+
+        // Add to estimate of initial probability for state j.
+        LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
+            threadLogInitial);
+
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+        {
+          // Assemble temporary vector that's used in log-sum computation.
+          if (t < dataSeq[seq].n_cols - 1)
+          {
+            // This term is the same across all states, so compute it once and
+            // cache it.
+            const arma::vec tmp = backwardLog.col(t + 1) +
+                logProbs.row(t + 1).t() - logScales[t + 1];
+            arma::vec output;
+            LogSumExp(tmp, output);
+
+            for (size_t j = 0; j < logTransition.n_cols; ++j)
+            {
+              // Compute the estimate of T_ij (probability of transition from
+              // state j to state i).  We postpone multiplication of the old
+              // T_ij until later.
+              if (sparseTransition)
+              {
+                for (size_t k = transitionColPtrs[j];
+                     k < transitionColPtrs[j + 1]; ++k)
+                {
+                  threadSparseLogTransition[k] = LogAdd(
+                      threadSparseLogTransition[k],
+                      output[transitionRowIndices[k]] + forwardLog(j, t));
+                }
+              }
+              else
+              {
+                arma::vec tmp2 = output + forwardLog(j, t);
+                arma::vec alias = threadLogTransition.unsafe_col(j);
+                LogSumExp<arma::vec, true>(tmp2, alias);
+              }
+            }
+          }
+
+          // Add to list of emission probabilities, for Distribution::Train().
+          for (size_t j = 0; j < logTransition.n_cols; ++j)
+            emissionProb[j][offsets[seq] + t] = std::exp(stateLogProb(j, t));
+        }
       }
 
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
+      // Merge the estimates of this thread.
+      #pragma omp critical
       {
-        // Assemble temporary vector that's used in log-sum computation.
-        if (t < dataSeq[seq].n_cols - 1)
+        LogSumExp<arma::vec, true>(threadLogInitial, newLogInitial);
+        if (sparseTransition)
+        {
+          LogSumExp<arma::vec, true>(threadSparseLogTransition,
+              newSparseLogTransition);
+        }
+        else
         {
-          // This term is the same across all states, so compute it once and
-          // cache it.
-          const arma::vec tmp = backwardLog.col(t + 1) +
-              logProbs.row(t + 1).t() - logScales[t + 1];
-          arma::vec output;
-          LogSumExp(tmp, output);
-
           for (size_t j = 0; j < logTransition.n_cols; ++j)
           {
-            // Compute the estimate of T_ij (probability of transition from
-            // state j to state i).  We postpone multiplication of the old T_ij
-            // until later.
-            arma::vec tmp2 = output + forwardLog(j, t);
             arma::vec alias = newLogTransition.unsafe_col(j);
-            LogSumExp<arma::vec, true>(tmp2, alias);
+            LogSumExp<arma::vec, true>(threadLogTransition.unsafe_col(j),
+                alias);
           }
         }
+      }
+    }
 
-        // Add to list of emission observations, for Distribution::Train().
-        for (size_t j = 0; j < logTransition.n_cols; ++j)
-          emissionProb[j][sumTime] = std::exp(stateLogProb(j, t));
-        emissionList.col(sumTime) = dataSeq[seq].col(t);
-        sumTime++;
+    if (sparseTransition)
+    {
+      for (size_t j = 0; j < logTransition.n_cols; ++j)
+      {
+        for (size_t k = transitionColPtrs[j]; k < transitionColPtrs[j + 1]; ++k)
+          newLogTransition(transitionRowIndices[k], j) =
+              newSparseLogTransition[k];
       }
     }
 
@@ -231,6 +314,7 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
 
     initialProxy = exp(logInitial);
     transitionProxy = exp(logTransition);
+    UpdateSparseTransition();
     // Now estimate emission probabilities.
     for (size_t state = 0; state < logTransition.n_cols; state++)
       emission[state].Train(emissionList, emissionProb[state]);
@@ -315,6 +399,7 @@ void HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq,
   transitionProxy = transition;
   logTransition = log(transition);
   logInitial = log(initial);
+  UpdateSparseTransition();
 
   // Estimate emission matrix.
   for (size_t state = 0; state < transition.n_cols; state++)
@@ -352,16 +437,8 @@ double HMM<Distribution>::LogEstimate(const arma::mat& dataSeq,
                                       arma::mat& backwardLogProb,
                                       arma::vec& logScales) const
 {
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   // First run the forward-backward algorithm.
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
@@ -485,65 +562,48 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
                                   arma::Row<size_t>& stateSeq) const
 {
   // This is an implementation of the Viterbi algorithm for finding the most
-  // probable sequence of states to produce the observed data sequence.  We
-  // don't use log-likelihoods to save that little bit of time, but we'll
-  // calculate the log-likelihood at the end of it all.
-  stateSeq.set_size(dataSeq.n_cols);
-  arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
-
+  // probable sequence of states to produce the observed data sequence.
   ConvertToLogSpace();
 
-  // The calculation of the first state is slightly different; the probability
-  // of the first state being state j is the maximum probability that the state
-  // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-    stateSeqBack(state, 0) = state;
-  }
+  arma::mat logProbs, logStateProb, scores;
+  arma::umat stateSeqBack;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
-  // Store the best first state.
-  arma::uword index;
+  return Viterbi(logProbs, stateSeq, logStateProb, stateSeqBack, scores);
+}
 
-  // Define a variable to store the value of log-probability for dataSeq.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
+/**
+ * Compute the most probable hidden state sequence of each of the given data
+ * sequences.
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::Predict(
+    const std::vector<arma::mat>& dataSeq,
+    std::vector<arma::Row<size_t>>& stateSeq) const
+{
+  // The parameters in log space must be up to date before the threads use
+  // them.
+  ConvertToLogSpace();
 
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  stateSeq.resize(dataSeq.size());
+  arma::vec logLikelihoods(dataSeq.size());
 
-  for (size_t t = 1; t < dataSeq.n_cols; t++)
+  #pragma omp parallel
   {
-    // Assemble the state probability for this element.
-    // Given that we are in state j, we use state with the highest probability
-    // of being the previous state.
-    for (size_t j = 0; j < logTransition.n_rows; j++)
+    // Scratch matrices, reused for all of the sequences of this thread.
+    arma::mat logProbs, logStateProb, scores;
+    arma::umat stateSeqBack;
+
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < dataSeq.size(); ++i)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      index = prob.index_max();
-      logStateProb(j, t) = prob[index] + logProbs(t, j);
-      stateSeqBack(j, t) = index;
+      EmissionLogProbabilities(dataSeq[i], logProbs);
+      logLikelihoods[i] = Viterbi(logProbs, stateSeq[i], logStateProb,
+          stateSeqBack, scores);
     }
   }
 
-  // Backtrack to find the most probable state sequence.
-  index = logStateProb.unsafe_col(dataSeq.n_cols - 1).index_max();
-  stateSeq[dataSeq.n_cols - 1] = index;
-  for (size_t t = 2; t <= dataSeq.n_cols; t++)
-  {
-    stateSeq[dataSeq.n_cols - t] =
-        stateSeqBack(stateSeq[dataSeq.n_cols - t + 1], dataSeq.n_cols - t + 1);
-  }
-
-  return logStateProb(stateSeq(dataSeq.n_cols - 1), dataSeq.n_cols - 1);
+  return logLikelihoods;
 }
 
 /**
@@ -552,25 +612,44 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
 template<typename Distribution>
 double HMM<Distribution>::LogLikelihood(const arma::mat& dataSeq) const
 {
-  arma::mat forwardLog;
-  arma::vec logScales;
+  ConvertToLogSpace();
 
-  // This is needed here.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
+  arma::mat logProbs, scores;
+  arma::vec forwardLogProb;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
+  return ForwardLogLikelihood(logProbs, forwardLogProb, scores);
+}
+
+/**
+ * Compute the log-likelihood of each of the given data sequences.
+ */
+template<typename Distribution>
+arma::vec HMM<Distribution>::LogLikelihood(
+    const std::vector<arma::mat>& dataSeq) const
+{
+  // The parameters in log space must be up to date before the threads use
+  // them.
+  ConvertToLogSpace();
+
+  arma::vec logLikelihoods(dataSeq.size());
+
+  #pragma omp parallel
   {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+    // Scratch matrices, reused for all of the sequences of this thread.
+    arma::mat logProbs, scores;
+    arma::vec forwardLogProb;
 
-  Forward(dataSeq, logScales, forwardLog, logProbs);
+    #pragma omp for schedule(dynamic)
+    for (size_t i = 0; i < dataSeq.size(); ++i)
+    {
+      EmissionLogProbabilities(dataSeq[i], logProbs);
+      logLikelihoods[i] = ForwardLogLikelihood(logProbs, forwardLogProb,
+          scores);
+    }
+  }
 
-  // The log-likelihood is the log of the scales for each time step.
-  return accu(logScales);
+  return logLikelihoods;
 }
 
 /**
@@ -658,16 +737,8 @@ void HMM<Distribution>::Filter(const arma::mat& dataSeq,
   arma::mat forwardLogProb;
   arma::vec logScales;
   // This is needed here.
-  arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
-
-  // Save the values of log-probability to logProbs.
-  for (size_t i = 0; i < logTransition.n_rows; i++)
-  {
-    // Define alias of desired column.
-    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-    // Use advanced constructor for using logProbs directly.
-    emission[i].LogProbability(dataSeq, alias);
-  }
+  arma::mat logProbs;
+  EmissionLogProbabilities(dataSeq, logProbs);
 
   Forward(dataSeq, logScales, forwardLogProb, logProbs);
 
@@ -706,6 +777,176 @@ void HMM<Distribution>::Smooth(const arma::mat& dataSeq,
     smoothSeq += emission[i].Mean() * exp(stateLogProb.row(i));
 }
 
+/**
+ * Compute the emission log-probabilities of each observation for each state.
+ */
+template<typename Distribution>
+void HMM<Distribution>::EmissionLogProbabilities(const arma::mat& dataSeq,
+                                                 arma::mat& logProbs) const
+{
+  logProbs.set_size(dataSeq.n_cols, logTransition.n_rows);
+
+  // For one-dimensional discrete emissions, look up the log-probabilities in a
+  // table of the log-probability of each symbol under each state, instead of
+  // taking the log of every observation's probability.
+  if constexpr (std::is_same_v<Distribution, DiscreteDistribution<>>)
+  {
+    if (dataSeq.n_rows == 1 && DiscreteEmissionLogProbabilities(dataSeq,
+        logProbs))
+      return;
+  }
+
+  // Save the values of log-probability to logProbs.  The states are
+  // independent, so they are computed in parallel.
+  #pragma omp parallel for schedule(dynamic) if (dataSeq.n_cols > 1000)
+  for (size_t i = 0; i < (size_t) logTransition.n_rows; i++)
+  {
+    // Define alias of desired column.
+    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+    // Use advanced constructor for using logProbs directly.
+    emission[i].LogProbability(dataSeq, alias);
+  }
+}
+
+template<typename Distribution>
+bool HMM<Distribution>::DiscreteEmissionLogProbabilities(
+    const arma::mat& dataSeq,
+    arma::mat& logProbs) const
+{
+  // All of the states must have the same number of symbols.
+  const size_t numSymbols = emission[0].Probabilities().n_elem;
+  for (size_t i = 1; i < emission.size(); i++)
+    if (emission[i].Probabilities().n_elem != numSymbols)
+      return false;
+
+  arma::uvec symbols(dataSeq.n_cols);
+  for (size_t t = 0; t < dataSeq.n_cols; t++)
+  {
+    // Adding 0.5 helps ensure that we cast the floating point to a size_t
+    // correctly.
+    symbols[t] = size_t(dataSeq(0, t) + 0.5);
+    if (symbols[t] >= numSymbols)
+    {
+      Log::Fatal << "HMM::EmissionLogProbabilities(): received observation "
+          << symbols[t] << "; observation must be in [0, " << numSymbols
+          << "] for this distribution." << std::endl;
+    }
+  }
+
+  for (size_t i = 0; i < emission.size(); i++)
+  {
+    const arma::vec logTable = arma::log(emission[i].Probabilities());
+    for (size_t t = 0; t < dataSeq.n_cols; t++)
+      logProbs(t, i) = logTable[symbols[t]];
+  }
+
+  return true;
+}
+
+/**
+ * The Viterbi algorithm, given the emission log-probabilities.
+ */
+template<typename Distribution>
+double HMM<Distribution>::Viterbi(const arma::mat& logProbs,
+                                  arma::Row<size_t>& stateSeq,
+                                  arma::mat& logStateProb,
+                                  arma::umat& stateSeqBack,
+                                  arma::mat& scores) const
+{
+  const size_t length = logProbs.n_rows;
+  stateSeq.set_size(length);
+  if (length == 0)
+    return 0.0;
+
+  logStateProb.set_size(logTransition.n_rows, length);
+  stateSeqBack.set_size(logTransition.n_rows, length);
+
+  // The probability of the first state being state j is given by the initial
+  // state probabilities.
+  logStateProb.col(0) = logInitial + logProbs.row(0).t();
+
+  for (size_t t = 1; t < length; t++)
+  {
+    // scores(j, i) is the log-probability of the best path that is in state i
+    // at time t - 1 and moves to state j.  Given that we are in state j, we use
+    // the previous state with the highest score, for all j at once.
+    if (sparseTransition)
+    {
+      // Only the nonzero transitions into state j can be on the best path.
+      for (size_t j = 0; j < logTransition.n_rows; j++)
+      {
+        double best = -std::numeric_limits<double>::infinity();
+        size_t bestState = 0;
+        for (size_t k = transitionRowPtrs[j]; k < transitionRowPtrs[j + 1];
+             ++k)
+        {
+          const size_t i = transitionColIndices[k];
+          const double score = logTransitionByRow[k] + logStateProb(i, t - 1);
+          if (score > best)
+          {
+            best = score;
+            bestState = i;
+          }
+        }
+
+        logStateProb(j, t) = best + logProbs(t, j);
+        stateSeqBack(j, t) = bestState;
+      }
+    }
+    else
+    {
+      scores = logTransition.each_row() + logStateProb.col(t - 1).t();
+      stateSeqBack.col(t) = arma::index_max(scores, 1);
+      for (size_t j = 0; j < logTransition.n_rows; j++)
+        logStateProb(j, t) = scores(j, stateSeqBack(j, t)) + logProbs(t, j);
+    }
+  }
+
+  // Backtrack to find the most probable state sequence.
+  stateSeq[length - 1] = logStateProb.unsafe_col(length - 1).index_max();
+  for (size_t t = 2; t <= length; t++)
+  {
+    stateSeq[length - t] =
+        stateSeqBack(stateSeq[length - t + 1], length - t + 1);
+  }
+
+  return logStateProb(stateSeq[length - 1], length - 1);
+}
+
+/**
+ * Compute the log-likelihood of a sequence with the Forward algorithm.
+ */
+template<typename Distribution>
+double HMM<Distribution>::ForwardLogLikelihood(const arma::mat& logProbs,
+                                               arma::vec& forwardLogProb,
+                                               arma::mat& scores) const
+{
+  if (logProbs.n_rows == 0)
+    return 0.0;
+
+  // This is the same recursion as ForwardAtT0() and ForwardAtTn(), but only
+  // the scaled forward probabilities of the current time step are kept.  The
+  // log-likelihood is the sum of the log of the scales of each time step.
+  forwardLogProb = logInitial + logProbs.row(0).t();
+  double logScale = AccuLog(forwardLogProb);
+  if (std::isfinite(logScale))
+    forwardLogProb -= logScale;
+  double logLikelihood = logScale;
+
+  for (size_t t = 1; t < logProbs.n_rows; t++)
+  {
+    TransitionLogSumExp(forwardLogProb, forwardLogProb, scores);
+    forwardLogProb += logProbs.row(t).t();
+
+    logScale = AccuLog(forwardLogProb);
+    if (std::isfinite(logScale))
+      forwardLogProb -= logScale;
+    logLikelihood += logScale;
+  }
+
+  return logLikelihood;
+}
+
 /**
  * The Forward procedure (part of the Forward-Backward algorithm).
  */
@@ -749,9 +990,8 @@ arma::vec HMM<Distribution>::ForwardAtTn(const arma::vec& emissionLogProb,
   // and emitting the given observation.  To do this computation in log-space,
   // we can use LogSumExp().
   arma::vec forwardLogProb;
-  arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
-      logTransition.n_rows, 1);
-  LogSumExp(tmp, forwardLogProb);
+  arma::mat tmp;
+  TransitionLogSumExp(prevForwardLogProb, forwardLogProb, tmp);
   forwardLogProb += emissionLogProb;
 
   // Normalize probability.
@@ -815,12 +1055,26 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
     // states of the probability of the next state having been a transition
     // from the current state multiplied by the probability of each of those
     // states emitting the given observation.  To compute this in log-space, we
-    // can use LogSumExpT().
-    const arma::mat tmp = logTransition +
-        repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
-        repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
-    arma::vec alias = backwardLogProb.unsafe_col(t);
-    LogSumExpT<arma::mat, true>(tmp, alias);
+    // can use LogSumExpT().  With sparse transitions, only the nonzero
+    // transitions out of each state are summed.
+    if (sparseTransition)
+    {
+      const arma::vec nextLogProb = backwardLogProb.col(t + 1) +
+          logProbs.row(t + 1).t();
+      for (size_t j = 0; j < logTransition.n_cols; ++j)
+      {
+        backwardLogProb(j, t) = SparseLogSumExp(transitionColPtrs,
+            transitionRowIndices, logTransitionByCol, nextLogProb, j);
+      }
+    }
+    else
+    {
+      const arma::mat tmp = logTransition +
+          repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
+          repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
+      arma::vec alias = backwardLogProb.unsafe_col(t);
+      LogSumExpT<arma::mat, true>(tmp, alias);
+    }
 
     // Normalize by the weights from the forward algorithm.
     if (std::isfinite(logScales[t + 1]))
@@ -828,6 +1082,121 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
   }
 }
 
+/**
+ * Compute the log-sum of the transitions into each state from the given
+ * log-probabilities of the previous states.
+ */
+template<typename Distribution>
+void HMM<Distribution>::TransitionLogSumExp(const arma::vec& logProb,
+                                            arma::vec& out,
+                                            arma::mat& scores) const
+{
+  if (sparseTransition)
+  {
+    // logProb may be the same vector as out.
+    arma::vec result(logTransition.n_rows);
+    for (size_t i = 0; i < logTransition.n_rows; ++i)
+    {
+      result[i] = SparseLogSumExp(transitionRowPtrs, transitionColIndices,
+          logTransitionByRow, logProb, i);
+    }
+    out = std::move(result);
+  }
+  else
+  {
+    scores = logTransition.each_row() + logProb.t();
+    LogSumExp(scores, out);
+  }
+}
+
+/**
+ * Compute the log-sum of the compressed sparse row or column `index` of the
+ * transition matrix plus the given log-probabilities.
+ */
+template<typename Distribution>
+double HMM<Distribution>::SparseLogSumExp(const arma::uvec& ptrs,
+                                          const arma::uvec& indices,
+                                          const arma::vec& logValues,
+                                          const arma::vec& logProb,
+                                          const size_t index)
+{
+  double maxVal = -std::numeric_limits<double>::infinity();
+  for (size_t k = ptrs[index]; k < ptrs[index + 1]; ++k)
+    maxVal = std::max(maxVal, logValues[k] + logProb[indices[k]]);
+
+  if (!std::isfinite(maxVal))
+    return maxVal;
+
+  double sum = 0.0;
+  for (size_t k = ptrs[index]; k < ptrs[index + 1]; ++k)
+    sum += std::exp(logValues[k] + logProb[indices[k]] - maxVal);
+
+  return maxVal + std::log(sum);
+}
+
+/**
+ * Build the compressed sparse representations of the transition matrix, if it
+ * is sparse enough.
+ */
+template<typename Distribution>
+void HMM<Distribution>::UpdateSparseTransition() const
+{
+  const size_t states = logTransition.n_rows;
+  const double negInf = -std::numeric_limits<double>::infinity();
+  const size_t nonzeros = arma::accu(logTransition > negInf);
+
+  sparseTransition = (states > 0 &&
+      nonzeros <= SparseTransitionDensity * states * states);
+  if (!sparseTransition)
+  {
+    transitionColPtrs.reset();
+    transitionRowIndices.reset();
+    logTransitionByCol.reset();
+    transitionRowPtrs.reset();
+    transitionColIndices.reset();
+    logTransitionByRow.reset();
+    return;
+  }
+
+  // First collect the nonzero transitions in compressed sparse column form,
+  // counting the number of nonzero transitions in each row.
+  transitionColPtrs.zeros(states + 1);
+  transitionRowIndices.set_size(nonzeros);
+  logTransitionByCol.set_size(nonzeros);
+  transitionRowPtrs.zeros(states + 1);
+  size_t k = 0;
+  for (size_t j = 0; j < states; ++j)
+  {
+    for (size_t i = 0; i < states; ++i)
+    {
+      if (logTransition(i, j) > negInf)
+      {
+        transitionRowIndices[k] = i;
+        logTransitionByCol[k] = logTransition(i, j);
+        ++transitionRowPtrs[i + 1];
+        ++k;
+      }
+    }
+    transitionColPtrs[j + 1] = k;
+  }
+  transitionRowPtrs = arma::cumsum(transitionRowPtrs);
+
+  // Now scatter them into compressed sparse row form.  The columns are visited
+  // in order, so the column indices of each row are sorted.
+  transitionColIndices.set_size(nonzeros);
+  logTransitionByRow.set_size(nonzeros);
+  arma::uvec next = transitionRowPtrs.head(states);
+  for (size_t j = 0; j < states; ++j)
+  {
+    for (size_t c = transitionColPtrs[j]; c < transitionColPtrs[j + 1]; ++c)
+    {
+      const size_t pos = next[transitionRowIndices[c]]++;
+      transitionColIndices[pos] = j;
+      logTransitionByRow[pos] = logTransitionByCol[c];
+    }
+  }
+}
+
 /**
  * Make sure the variables in log space are in sync with the linear
  * counterparts.
@@ -844,6 +1213,7 @@ void HMM<Distribution>::ConvertToLogSpace() const
   if (recalculateTransition)
   {
     logTransition = log(transitionProxy);
+    UpdateSparseTransition();
     recalculateTransition = false;
   }
 }
@@ -870,6 +1240,7 @@ void HMM<Distribution>::load(Archive& ar, const uint32_t /* version */)
   logInitial = log(initial);
   initialProxy = std::move(initial);
   transitionProxy = std::move(transition);
+  UpdateSparseTransition();
 }
 
 //! Serialize the HMM.
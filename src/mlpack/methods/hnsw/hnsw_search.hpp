@@ -0,0 +1,302 @@
+/**
+ * @file methods/hnsw/hnsw_search.hpp
+ *
+ * Defines the HNSWSearch class, which performs approximate nearest neighbor
+ * search with a hierarchical navigable small world graph, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{malkov2018efficient,
+ *   title={Efficient and robust approximate nearest neighbor search using
+ *       hierarchical navigable small world graphs},
+ *   author={Malkov, Yu A. and Yashunin, Dmitry A.},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={42},
+ *   number={4},
+ *   pages={824--836},
+ *   year={2018}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * The HNSWSearch class builds a hierarchical navigable small world (HNSW)
+ * graph on the reference set, and uses it to find the approximate nearest
+ * neighbors of query points.  Each point is a node of the graph on a random
+ * number of levels (the number of points on each level decreases
+ * exponentially); a search descends greedily from the top level, and on the
+ * bottom level keeps the `EfSearch()` best candidates of a best-first search.
+ * This is typically much faster than LSHSearch or spill trees for the same
+ * recall on high-dimensional data, such as embeddings.
+ *
+ * The points are inserted in batches, in parallel with OpenMP: the points of
+ * a batch search the graph of the earlier points (and are compared with the
+ * earlier points of the batch) at the same time, and are then linked into the
+ * graph in order.  So, the graph does not depend on the number of threads.
+ *
+ * The results of Search() have the same form as those of
+ * NeighborSearch::Search(), so NeighborSearch::Recall() can be used to
+ * compare them with exact results.
+ *
+ * @code
+ * arma::fmat embeddings, queries;
+ * // ...
+ * HNSWSearch<> hnsw(embeddings);
+ * hnsw.EfSearch() = 100;
+ *
+ * arma::Mat<size_t> neighbors;
+ * arma::fmat distances;
+ * hnsw.Search(queries, 10, neighbors, distances);
+ * @endcode
+ *
+ * @tparam DistanceType Distance metric to use; the graph is only a good index
+ *     for metrics, like EuclideanDistance.
+ * @tparam MatType Type of matrix to store the reference set in (by default,
+ *     single precision).
+ */
+template<typename DistanceType = EuclideanDistance,
+         typename MatType = arma::fmat>
+class HNSWSearch
+{
+ public:
+  //! The element type of the data.
+  using ElemType = typename MatType::elem_type;
+
+  /**
+   * Create an HNSW model without a reference set.  Call Train() before
+   * Search().
+   *
+   * @param m Number of neighbors of each point on the levels above the bottom
+   *     level (twice as many are kept on the bottom level).
+   * @param efConstruction Number of candidates kept when the neighbors of a
+   *     new point are searched.
+   * @param efSearch Number of candidates kept by Search() (at least k are
+   *     always kept).
+   * @param distance Instantiated distance metric.
+   */
+  HNSWSearch(const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             DistanceType distance = DistanceType());
+
+  /**
+   * Build the HNSW graph on the given reference set.  To avoid copying the
+   * reference set, pass it with std::move().
+   *
+   * @param referenceSet Set of reference points.
+   * @param m Number of neighbors of each point on the levels above the bottom
+   *     level (twice as many are kept on the bottom level).
+   * @param efConstruction Number of candidates kept when the neighbors of a
+   *     new point are searched.
+   * @param efSearch Number of candidates kept by Search() (at least k are
+   *     always kept).
+   * @param distance Instantiated distance metric.
+   */
+  HNSWSearch(MatType referenceSet,
+             const size_t m = 16,
+             const size_t efConstruction = 200,
+             const size_t efSearch = 50,
+             DistanceType distance = DistanceType());
+
+  /**
+   * Build the HNSW graph on the given reference set, with the current
+   * parameters.  Any existing graph is discarded.
+   *
+   * @param referenceSet Set of reference points.
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Add new points to the reference set and to the graph.  The points already
+   * in the graph are not inserted again.  The new points get the indices
+   * following the points already in the reference set.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const MatType& newPoints);
+
+  /**
+   * Find the approximate k nearest neighbors in the reference set of each
+   * point in the query set.  The matrices are set to k rows and one column
+   * for each query point, sorted by distance, like with
+   * NeighborSearch::Search().  If fewer than k neighbors are found for a
+   * query point, the remaining neighbors are SIZE_MAX and their distances are
+   * the largest ElemType.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  /**
+   * Find the approximate k nearest neighbors of each point in the reference
+   * set (excluding the point itself).
+   *
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of neighbors of each point on the upper levels.
+  size_t M() const { return m; }
+  //! Get the number of candidates kept when points are inserted.
+  size_t EfConstruction() const { return efConstruction; }
+  //! Get the number of candidates kept by Search().
+  size_t EfSearch() const { return efSearch; }
+  //! Modify the number of candidates kept by Search().
+  size_t& EfSearch() { return efSearch; }
+
+  //! Get the top level of the graph.
+  size_t MaxLevel() const { return maxLevel; }
+  //! Get the top level of the given point.
+  size_t Level(const size_t point) const { return levels[point]; }
+  //! Get the neighbors of the given point on the given level.
+  const std::vector<size_t>& Neighbors(const size_t point,
+                                       const size_t level) const
+  {
+    return graph[point][level];
+  }
+
+  //! Get the number of distance evaluations of the last call to Search().
+  size_t DistanceEvaluations() const { return distanceEvaluations; }
+
+  //! Get the distance metric.
+  const DistanceType& Distance() const { return distance; }
+  //! Modify the distance metric.
+  DistanceType& Distance() { return distance; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A candidate: its distance to the query point, and its index.
+  using Candidate = std::pair<ElemType, size_t>;
+
+  /**
+   * The visited points of a search on one level, marked with the number of
+   * the search, so that the marks do not have to be cleared between
+   * searches.
+   */
+  struct VisitedList
+  {
+    //! The number of the search that last visited each point.
+    std::vector<size_t> marks;
+    //! The number of the current search.
+    size_t epoch = 0;
+
+    //! Start a new search on a graph of the given number of points.
+    void Reset(const size_t n)
+    {
+      if (marks.size() < n)
+        marks.resize(n, 0);
+      ++epoch;
+    }
+  };
+
+  /**
+   * Move greedily from the given point to its closest neighbor on the given
+   * level, until no neighbor is closer to the query point.
+   */
+  template<typename VecType>
+  void GreedySearch(const VecType& query,
+                    Candidate& current,
+                    const size_t level,
+                    size_t& evaluations) const;
+
+  /**
+   * Best-first search on the given level, from the given entry point, for
+   * the ef closest points to the query point.  The result is sorted by
+   * distance.
+   */
+  template<typename VecType>
+  std::vector<Candidate> SearchLevel(const VecType& query,
+                                     const Candidate& entry,
+                                     const size_t ef,
+                                     const size_t level,
+                                     VisitedList& visited,
+                                     size_t& evaluations) const;
+
+  /**
+   * Search the k nearest neighbors of the given query point; the closest
+   * max(ef, k) candidates are returned, sorted by distance.
+   */
+  template<typename VecType>
+  std::vector<Candidate> SearchPoint(const VecType& query,
+                                     const size_t k,
+                                     VisitedList& visited,
+                                     size_t& evaluations) const;
+
+  /**
+   * Select at most maxNeighbors neighbors from the given candidates (sorted by
+   * distance), with the heuristic of Malkov and Yashunin: a candidate is kept
+   * only if it is closer to the point than to all kept candidates, so that
+   * the neighbors point in diverse directions.
+   */
+  std::vector<size_t> SelectNeighbors(const std::vector<Candidate>& candidates,
+                                      const size_t maxNeighbors) const;
+
+  //! Get the maximum number of neighbors of a point on the given level.
+  size_t MaxNeighbors(const size_t level) const
+  {
+    return (level == 0) ? 2 * m : m;
+  }
+
+  //! Insert the points from the given index to the end of the reference set.
+  void InsertPoints(const size_t begin);
+
+  //! The largest number of points inserted in parallel.
+  static constexpr size_t MaxBatchSize = 1024;
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The number of neighbors of each point on the upper levels.
+  size_t m;
+  //! The number of candidates kept when points are inserted.
+  size_t efConstruction;
+  //! The number of candidates kept by Search().
+  size_t efSearch;
+  //! The distance metric.
+  DistanceType distance;
+
+  //! The top level of each point.
+  std::vector<size_t> levels;
+  //! The neighbors of each point on each of its levels.
+  std::vector<std::vector<std::vector<size_t>>> graph;
+  //! The entry point of searches (a point on the top level).
+  size_t entryPoint;
+  //! The top level of the graph.
+  size_t maxLevel;
+
+  //! The number of distance evaluations of the last call to Search().
+  mutable size_t distanceEvaluations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "hnsw_search_impl.hpp"
+
+#endif
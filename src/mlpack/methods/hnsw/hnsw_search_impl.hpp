@@ -0,0 +1,471 @@
+/**
+ * @file methods/hnsw/hnsw_search_impl.hpp
+ *
+ * Implementation of the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_HNSW_HNSW_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "hnsw_search.hpp"
+
+#include <queue>
+
+namespace mlpack {
+
+template<typename DistanceType, typename MatType>
+HNSWSearch<DistanceType, MatType>::HNSWSearch(const size_t m,
+                                              const size_t efConstruction,
+                                              const size_t efSearch,
+                                              DistanceType distance) :
+    m(m),
+    efConstruction(efConstruction),
+    efSearch(efSearch),
+    distance(std::move(distance)),
+    entryPoint(0),
+    maxLevel(0),
+    distanceEvaluations(0)
+{
+  if (m < 2)
+  {
+    throw std::invalid_argument("HNSWSearch::HNSWSearch(): m must be at "
+        "least 2!");
+  }
+}
+
+template<typename DistanceType, typename MatType>
+HNSWSearch<DistanceType, MatType>::HNSWSearch(MatType referenceSet,
+                                              const size_t m,
+                                              const size_t efConstruction,
+                                              const size_t efSearch,
+                                              DistanceType distance) :
+    HNSWSearch(m, efConstruction, efSearch, std::move(distance))
+{
+  Train(std::move(referenceSet));
+}
+
+template<typename DistanceType, typename MatType>
+void HNSWSearch<DistanceType, MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  levels.clear();
+  graph.clear();
+  entryPoint = 0;
+  maxLevel = 0;
+
+  InsertPoints(0);
+}
+
+template<typename DistanceType, typename MatType>
+void HNSWSearch<DistanceType, MatType>::Insert(const MatType& newPoints)
+{
+  if (newPoints.n_cols == 0)
+    return;
+
+  if (referenceSet.n_cols > 0 && newPoints.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("HNSWSearch::Insert(): the new points have " +
+        std::to_string(newPoints.n_rows) + " dimensions, but the reference "
+        "set has " + std::to_string(referenceSet.n_rows) + "!");
+  }
+
+  const size_t begin = referenceSet.n_cols;
+  if (begin == 0)
+    referenceSet = newPoints;
+  else
+    referenceSet = arma::join_rows(referenceSet, newPoints);
+
+  InsertPoints(begin);
+}
+
+template<typename DistanceType, typename MatType>
+void HNSWSearch<DistanceType, MatType>::InsertPoints(const size_t begin)
+{
+  const size_t n = referenceSet.n_cols;
+  if (begin == n)
+    return;
+
+  // Draw the levels of the new points from an exponential distribution, so
+  // that each level has about 1 / m as many points as the level below.
+  const double levelScale = 1.0 / std::log((double) m);
+  levels.resize(n);
+  graph.resize(n);
+  for (size_t i = begin; i < n; ++i)
+  {
+    levels[i] = (size_t) std::floor(-std::log(1.0 - Random()) * levelScale);
+    graph[i].resize(levels[i] + 1);
+  }
+
+  size_t start = begin;
+  if (start == 0)
+  {
+    // The first point has no neighbors.
+    entryPoint = 0;
+    maxLevel = levels[0];
+    start = 1;
+  }
+
+  std::vector<std::vector<std::vector<size_t>>> newNeighbors;
+  size_t evaluations = 0;
+  while (start < n)
+  {
+    // The points of a batch do not see each other in the graph, so the batch
+    // is kept small relative to the graph.
+    const size_t batchSize = std::min(std::min(MaxBatchSize,
+        std::max((size_t) 1, start / 8)), n - start);
+    const size_t end = start + batchSize;
+
+    newNeighbors.clear();
+    newNeighbors.resize(batchSize);
+
+    // Find the neighbors of each new point in parallel; the graph is not
+    // modified.
+    #pragma omp parallel reduction(+:evaluations)
+    {
+      VisitedList visited;
+
+      #pragma omp for schedule(dynamic)
+      for (size_t j = 0; j < batchSize; ++j)
+      {
+        const size_t point = start + j;
+        const size_t level = levels[point];
+        const auto query = referenceSet.col(point);
+
+        // The earlier points of the batch are compared directly.
+        std::vector<Candidate> batchCandidates(j);
+        for (size_t b = 0; b < j; ++b)
+        {
+          batchCandidates[b] = Candidate(distance.Evaluate(query,
+              referenceSet.col(start + b)), start + b);
+        }
+        evaluations += j;
+
+        Candidate current(distance.Evaluate(query,
+            referenceSet.col(entryPoint)), entryPoint);
+        ++evaluations;
+        for (size_t l = maxLevel; l > level; --l)
+          GreedySearch(query, current, l, evaluations);
+
+        newNeighbors[j].resize(level + 1);
+        for (size_t l = level + 1; l-- > 0; )
+        {
+          std::vector<Candidate> candidates;
+          if (l <= maxLevel)
+          {
+            candidates = SearchLevel(query, current, efConstruction, l,
+                visited, evaluations);
+            current = candidates[0];
+          }
+
+          for (size_t b = 0; b < j; ++b)
+            if (levels[start + b] >= l)
+              candidates.push_back(batchCandidates[b]);
+          std::sort(candidates.begin(), candidates.end());
+
+          newNeighbors[j][l] = SelectNeighbors(candidates, MaxNeighbors(l));
+        }
+      }
+    }
+
+    // Link the new points into the graph, in order.
+    std::vector<Candidate> candidates;
+    for (size_t j = 0; j < batchSize; ++j)
+    {
+      const size_t point = start + j;
+      for (size_t l = 0; l < newNeighbors[j].size(); ++l)
+      {
+        graph[point][l] = newNeighbors[j][l];
+        for (const size_t neighbor : graph[point][l])
+        {
+          std::vector<size_t>& links = graph[neighbor][l];
+          links.push_back(point);
+          if (links.size() <= MaxNeighbors(l))
+            continue;
+
+          // Too many links: select the neighbors of this point again.
+          candidates.resize(links.size());
+          for (size_t c = 0; c < links.size(); ++c)
+          {
+            candidates[c] = Candidate(distance.Evaluate(
+                referenceSet.col(neighbor), referenceSet.col(links[c])),
+                links[c]);
+          }
+          evaluations += links.size();
+          std::sort(candidates.begin(), candidates.end());
+          links = SelectNeighbors(candidates, MaxNeighbors(l));
+        }
+      }
+
+      if (levels[point] > maxLevel)
+      {
+        maxLevel = levels[point];
+        entryPoint = point;
+      }
+    }
+
+    start = end;
+  }
+
+  Log::Info << "Built an HNSW graph of " << n << " points with " << evaluations
+      << " distance evaluations; the top level is " << maxLevel << "."
+      << std::endl;
+}
+
+template<typename DistanceType, typename MatType>
+template<typename VecType>
+void HNSWSearch<DistanceType, MatType>::GreedySearch(
+    const VecType& query,
+    Candidate& current,
+    const size_t level,
+    size_t& evaluations) const
+{
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    for (const size_t neighbor : graph[current.second][level])
+    {
+      const ElemType d = distance.Evaluate(query,
+          referenceSet.col(neighbor));
+      ++evaluations;
+      if (d < current.first)
+      {
+        current = Candidate(d, neighbor);
+        changed = true;
+      }
+    }
+  }
+}
+
+template<typename DistanceType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSWSearch<DistanceType, MatType>::Candidate>
+HNSWSearch<DistanceType, MatType>::SearchLevel(
+    const VecType& query,
+    const Candidate& entry,
+    const size_t ef,
+    const size_t level,
+    VisitedList& visited,
+    size_t& evaluations) const
+{
+  visited.Reset(referenceSet.n_cols);
+  visited.marks[entry.second] = visited.epoch;
+
+  // The candidates to expand (closest first), and the best points found
+  // (farthest first).
+  std::priority_queue<Candidate, std::vector<Candidate>,
+      std::greater<Candidate>> toExpand;
+  std::priority_queue<Candidate> best;
+  toExpand.push(entry);
+  best.push(entry);
+
+  while (!toExpand.empty())
+  {
+    const Candidate c = toExpand.top();
+    if (c.first > best.top().first && best.size() >= ef)
+      break;
+    toExpand.pop();
+
+    for (const size_t neighbor : graph[c.second][level])
+    {
+      if (visited.marks[neighbor] == visited.epoch)
+        continue;
+      visited.marks[neighbor] = visited.epoch;
+
+      const ElemType d = distance.Evaluate(query,
+          referenceSet.col(neighbor));
+      ++evaluations;
+      if (best.size() < ef || d < best.top().first)
+      {
+        toExpand.push(Candidate(d, neighbor));
+        best.push(Candidate(d, neighbor));
+        if (best.size() > ef)
+          best.pop();
+      }
+    }
+  }
+
+  std::vector<Candidate> result(best.size());
+  for (size_t i = result.size(); i-- > 0; )
+  {
+    result[i] = best.top();
+    best.pop();
+  }
+  return result;
+}
+
+template<typename DistanceType, typename MatType>
+template<typename VecType>
+std::vector<typename HNSWSearch<DistanceType, MatType>::Candidate>
+HNSWSearch<DistanceType, MatType>::SearchPoint(
+    const VecType& query,
+    const size_t k,
+    VisitedList& visited,
+    size_t& evaluations) const
+{
+  Candidate current(distance.Evaluate(query, referenceSet.col(entryPoint)),
+      entryPoint);
+  ++evaluations;
+  for (size_t l = maxLevel; l > 0; --l)
+    GreedySearch(query, current, l, evaluations);
+
+  return SearchLevel(query, current, std::max(efSearch, k), 0, visited,
+      evaluations);
+}
+
+template<typename DistanceType, typename MatType>
+std::vector<size_t> HNSWSearch<DistanceType, MatType>::SelectNeighbors(
+    const std::vector<Candidate>& candidates,
+    const size_t maxNeighbors) const
+{
+  std::vector<size_t> selected;
+  selected.reserve(maxNeighbors);
+  for (const Candidate& c : candidates)
+  {
+    if (selected.size() == maxNeighbors)
+      break;
+
+    bool keep = true;
+    for (const size_t s : selected)
+    {
+      if (distance.Evaluate(referenceSet.col(c.second),
+          referenceSet.col(s)) < c.first)
+      {
+        keep = false;
+        break;
+      }
+    }
+
+    if (keep)
+      selected.push_back(c.second);
+  }
+
+  return selected;
+}
+
+template<typename DistanceType, typename MatType>
+void HNSWSearch<DistanceType, MatType>::Search(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances) const
+{
+  if (k > referenceSet.n_cols)
+  {
+    throw std::invalid_argument("HNSWSearch::Search(): requested value of k (" +
+        std::to_string(k) + ") is greater than the number of points in the "
+        "reference set (" + std::to_string(referenceSet.n_cols) + ")!");
+  }
+
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("HNSWSearch::Search(): the query set has " +
+        std::to_string(querySet.n_rows) + " dimensions, but the reference set "
+        "has " + std::to_string(referenceSet.n_rows) + "!");
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.fill(std::numeric_limits<ElemType>::max());
+
+  size_t evaluations = 0;
+  if (k > 0)
+  {
+    #pragma omp parallel reduction(+:evaluations)
+    {
+      VisitedList visited;
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+      {
+        const std::vector<Candidate> result = SearchPoint(querySet.col(i), k,
+            visited, evaluations);
+        for (size_t j = 0; j < std::min(k, result.size()); ++j)
+        {
+          distances(j, i) = result[j].first;
+          neighbors(j, i) = result[j].second;
+        }
+      }
+    }
+  }
+
+  distanceEvaluations = evaluations;
+}
+
+template<typename DistanceType, typename MatType>
+void HNSWSearch<DistanceType, MatType>::Search(
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances) const
+{
+  if (k >= referenceSet.n_cols && k > 0)
+  {
+    throw std::invalid_argument("HNSWSearch::Search(): requested value of k (" +
+        std::to_string(k) + ") must be less than the number of points in the "
+        "reference set (" + std::to_string(referenceSet.n_cols) + ")!");
+  }
+
+  neighbors.set_size(k, referenceSet.n_cols);
+  distances.set_size(k, referenceSet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.fill(std::numeric_limits<ElemType>::max());
+
+  size_t evaluations = 0;
+  if (k > 0)
+  {
+    #pragma omp parallel reduction(+:evaluations)
+    {
+      VisitedList visited;
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < referenceSet.n_cols; ++i)
+      {
+        // Search one more neighbor, because the point itself is found too.
+        const std::vector<Candidate> result = SearchPoint(
+            referenceSet.col(i), k + 1, visited, evaluations);
+        size_t j = 0;
+        for (size_t r = 0; r < result.size() && j < k; ++r)
+        {
+          if (result[r].second == i)
+            continue;
+
+          distances(j, i) = result[r].first;
+          neighbors(j, i) = result[r].second;
+          ++j;
+        }
+      }
+    }
+  }
+
+  distanceEvaluations = evaluations;
+}
+
+template<typename DistanceType, typename MatType>
+template<typename Archive>
+void HNSWSearch<DistanceType, MatType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(m));
+  ar(CEREAL_NVP(efConstruction));
+  ar(CEREAL_NVP(efSearch));
+  ar(CEREAL_NVP(distance));
+  ar(CEREAL_NVP(levels));
+  ar(CEREAL_NVP(graph));
+  ar(CEREAL_NVP(entryPoint));
+  ar(CEREAL_NVP(maxLevel));
+
+  if (cereal::is_loading<Archive>())
+    distanceEvaluations = 0;
+}
+
+} // namespace mlpack
+
+#endif
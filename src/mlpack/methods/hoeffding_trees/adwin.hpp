@@ -0,0 +1,130 @@
+/**
+ * @file methods/hoeffding_trees/adwin.hpp
+ *
+ * Definition of the ADWIN class, an adaptive sliding window that detects
+ * changes in the mean of a stream of values.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_ADWIN_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_ADWIN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * ADWIN (ADaptive WINdowing) keeps a window of the most recent values of a
+ * stream, and drops the oldest part of the window whenever its mean differs
+ * significantly from the mean of the rest of the window.  The mean of the
+ * window is then an estimate of the current mean of the stream, and a drop
+ * signals a change (concept drift) in the stream.  ADWIN is described in the
+ * following paper:
+ *
+ * @code
+ * @inproceedings{bifet2007learning,
+ *   title={{Learning from Time-Changing Data with Adaptive Windowing}},
+ *   author={Bifet, A. and Gavald{\`a}, R.},
+ *   booktitle={Proceedings of the 2007 SIAM International Conference on Data
+ *       Mining (SDM '07)},
+ *   pages={443--448},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * The window is stored as an exponential histogram: row `i` holds at most
+ * `maxBuckets` buckets that each summarize 2^i consecutive values.  So a window
+ * of `W` values takes O(maxBuckets * log(W)) memory and each update takes
+ * amortized constant time, apart from the check for a change, which is done
+ * every `clock` updates and takes O(maxBuckets * log(W)) time.
+ */
+class ADWIN
+{
+ public:
+  /**
+   * Create an empty window.
+   *
+   * @param delta Confidence of the test for a change; smaller values detect
+   *     fewer (false) changes.
+   * @param maxBuckets Maximum number of buckets of each size.
+   * @param clock Number of updates between checks for a change.
+   */
+  ADWIN(const double delta = 0.002,
+        const size_t maxBuckets = 5,
+        const size_t clock = 32);
+
+  /**
+   * Add a value to the window, and check for a change if it is time to.
+   *
+   * @param value Value to add.
+   * @return Whether a change was detected (and the oldest part of the window
+   *     was dropped).
+   */
+  bool Update(const double value);
+
+  //! Remove all values from the window.
+  void Reset();
+
+  //! Get the mean of the values in the window (0 if the window is empty).
+  double Estimation() const { return (width == 0) ? 0.0 : total / width; }
+  //! Get the number of values in the window.
+  size_t Width() const { return width; }
+  //! Get the confidence of the test for a change.
+  double Delta() const { return delta; }
+
+  //! Serialize the window.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A bucket summarizes a number of consecutive values by their sum and the
+  //! sum of squared differences from their mean.
+  struct Bucket
+  {
+    double total;
+    double variance;
+
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(total));
+      ar(CEREAL_NVP(variance));
+    }
+  };
+
+  //! Merge the oldest buckets of each row that has too many buckets.
+  void Compress();
+
+  //! Check whether the oldest part of the window should be dropped.
+  bool DetectChange();
+
+  //! Drop the oldest bucket of the window.
+  void DropOldestBucket();
+
+  //! The buckets; rows[i] holds buckets of 2^i values, oldest first.
+  std::vector<std::vector<Bucket>> rows;
+  //! The confidence of the test for a change.
+  double delta;
+  //! The maximum number of buckets in each row.
+  size_t maxBuckets;
+  //! The number of updates between checks for a change.
+  size_t clock;
+  //! The number of updates since the last check for a change.
+  size_t time;
+  //! The number of values in the window.
+  size_t width;
+  //! The sum of the values in the window.
+  double total;
+  //! The sum of squared differences of the values from their mean.
+  double variance;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "adwin_impl.hpp"
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file methods/hoeffding_trees/adwin_impl.hpp
+ *
+ * Implementation of the ADWIN class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HOEFFDING_TREES_ADWIN_IMPL_HPP
+#define MLPACK_METHODS_HOEFFDING_TREES_ADWIN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "adwin.hpp"
+
+namespace mlpack {
+
+inline ADWIN::ADWIN(const double delta,
+                    const size_t maxBuckets,
+                    const size_t clock) :
+    delta(delta),
+    maxBuckets(maxBuckets),
+    clock(clock),
+    time(0),
+    width(0),
+    total(0.0),
+    variance(0.0)
+{
+  if (delta <= 0.0 || delta >= 1.0)
+    throw std::invalid_argument("ADWIN::ADWIN(): delta must be in (0, 1)!");
+  if (maxBuckets == 0)
+    throw std::invalid_argument("ADWIN::ADWIN(): maxBuckets must be positive!");
+  if (clock == 0)
+    throw std::invalid_argument("ADWIN::ADWIN(): clock must be positive!");
+}
+
+inline bool ADWIN::Update(const double value)
+{
+  // Add the value as a new bucket of one value.
+  if (rows.empty())
+    rows.emplace_back();
+  rows[0].push_back({ value, 0.0 });
+
+  if (width > 0)
+  {
+    const double diff = value - total / width;
+    variance += width * diff * diff / (width + 1);
+  }
+  total += value;
+  ++width;
+
+  Compress();
+
+  if (++time < clock)
+    return false;
+
+  time = 0;
+  return DetectChange();
+}
+
+inline void ADWIN::Reset()
+{
+  rows.clear();
+  time = 0;
+  width = 0;
+  total = 0.0;
+  variance = 0.0;
+}
+
+inline void ADWIN::Compress()
+{
+  // New buckets only enter the first row, so merging can stop at the first row
+  // that is not too full.
+  for (size_t i = 0; i < rows.size() && rows[i].size() > maxBuckets; ++i)
+  {
+    // Merge the two oldest buckets of the row into one bucket of the next row;
+    // it is newer than every bucket already there.
+    const double size = (double) (size_t(1) << i);
+    const Bucket first = rows[i][0];
+    const Bucket second = rows[i][1];
+    const double diff = (first.total - second.total) / size;
+    const Bucket merged = { first.total + second.total,
+        first.variance + second.variance + size * diff * diff / 2.0 };
+
+    rows[i].erase(rows[i].begin(), rows[i].begin() + 2);
+    if (i + 1 == rows.size())
+      rows.emplace_back();
+    rows[i + 1].push_back(merged);
+  }
+}
+
+inline bool ADWIN::DetectChange()
+{
+  // Both parts of the window must hold at least this many values.
+  const double minLength = 5.0;
+
+  bool change = false;
+  bool dropped = true;
+  while (dropped && width >= 2 * minLength)
+  {
+    dropped = false;
+
+    // The confidence is divided by the number of cut points that are tested,
+    // which is O(log(width)).
+    const double logTerm = std::log(2.0 * std::log((double) width) / delta);
+    const double windowVariance = variance / width;
+
+    // Test each cut point between buckets, from the oldest to the newest.
+    double oldLength = 0.0;
+    double oldTotal = 0.0;
+    bool done = false;
+    for (size_t i = rows.size(); i > 0 && !done; --i)
+    {
+      const double size = (double) (size_t(1) << (i - 1));
+      for (size_t j = 0; j < rows[i - 1].size(); ++j)
+      {
+        oldLength += size;
+        oldTotal += rows[i - 1][j].total;
+        const double newLength = width - oldLength;
+        if (newLength < minLength)
+        {
+          done = true;
+          break;
+        }
+        if (oldLength < minLength)
+          continue;
+
+        const double oldMean = oldTotal / oldLength;
+        const double newMean = (total - oldTotal) / newLength;
+        const double m = 1.0 / (1.0 / oldLength + 1.0 / newLength);
+        const double epsilon = std::sqrt(2.0 / m * windowVariance * logTerm) +
+            2.0 / (3.0 * m) * logTerm;
+        if (std::abs(oldMean - newMean) > epsilon)
+        {
+          // The means differ, so the oldest values are out of date.  Drop
+          // them one bucket at a time, and test the remaining window again.
+          DropOldestBucket();
+          change = true;
+          dropped = true;
+          done = true;
+          break;
+        }
+      }
+    }
+  }
+
+  return change;
+}
+
+inline void ADWIN::DropOldestBucket()
+{
+  const size_t row = rows.size() - 1;
+  const size_t size = size_t(1) << row;
+  const Bucket oldest = rows[row][0];
+  rows[row].erase(rows[row].begin());
+  while (!rows.empty() && rows.back().empty())
+    rows.pop_back();
+
+  width -= size;
+  total -= oldest.total;
+  if (width == 0)
+  {
+    total = 0.0;
+    variance = 0.0;
+    return;
+  }
+
+  const double diff = oldest.total / size - total / width;
+  variance -= oldest.variance +
+      (double) size * width / (size + width) * diff * diff;
+  variance = std::max(variance, 0.0);
+}
+
+template<typename Archive>
+void ADWIN::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(rows));
+  ar(CEREAL_NVP(delta));
+  ar(CEREAL_NVP(maxBuckets));
+  ar(CEREAL_NVP(clock));
+  ar(CEREAL_NVP(time));
+  ar(CEREAL_NVP(width));
+  ar(CEREAL_NVP(total));
+  ar(CEREAL_NVP(variance));
+}
+
+} // namespace mlpack
+
+#endif
@@ -26,6 +26,8 @@
 
 #include "hoeffding_categorical_split.hpp"
 
+#include "adwin.hpp"
+
 namespace mlpack {
 
 /**
@@ -54,6 +56,27 @@ namespace mlpack {
  * categorical attributes are handled.  As far as the actual splitting goes,
  * the meat of the splitting procedure will be contained in those two classes.
  *
+ * For unbounded streams, two options keep the size of the tree and the cost of
+ * each update bounded.  MaxActiveLeaves() limits the number of leaves that
+ * collect split statistics: as in VFDT, the least promising leaves (those that
+ * see the fewest misclassified points) are periodically deactivated, and
+ * reactivated if they become more promising.  DriftDetection() enables concept
+ * drift handling as in the Hoeffding Adaptive Tree: each node monitors the
+ * error of its subtree with ADWIN, grows an alternate subtree when the error
+ * increases, and is replaced by the alternate subtree once it is significantly
+ * more accurate.
+ *
+ * @code
+ * @inproceedings{bifet2009adaptive,
+ *     title={{Adaptive Learning from Evolving Data Streams}},
+ *     author={Bifet, A. and Gavald{\`a}, R.},
+ *     booktitle={Proceedings of the 8th International Symposium on Intelligent
+ *         Data Analysis (IDA '09)},
+ *     pages={249--260},
+ *     year={2009}
+ * }
+ * @endcode
+ *
  * @tparam FitnessFunction Fitness function to use.
  * @tparam NumericSplitType Technique for splitting numeric features.
  * @tparam CategoricalSplitType Technique for splitting categorical features.
@@ -72,6 +95,14 @@ class HoeffdingTree
   //! Allow access to the categorical split type.
   using CategoricalSplit = CategoricalSplitType<FitnessFunction>;
 
+  //! The number of points that streaming training routes to the leaves of the
+  //! tree at once, before the leaves are trained on their points in parallel.
+  static constexpr size_t StreamingBatchSize = 8192;
+
+  //! The number of points that both a node and its alternate subtree must have
+  //! monitored before they are compared, when drift detection is enabled.
+  static constexpr size_t AlternateMinSamples = 300;
+
   /**
    * Construct a Hoeffding tree with no data and no information.  Be sure to
    * call Train() before trying to use the tree.
@@ -407,6 +438,32 @@ class HoeffdingTree
   //! Modify the number of samples before a split check is performed.
   void CheckInterval(const size_t checkInterval);
 
+  //! Get the maximum number of leaves that collect split statistics (0 means
+  //! no limit).
+  size_t MaxActiveLeaves() const { return maxActiveLeaves; }
+  /**
+   * Modify the maximum number of leaves below this node that collect split
+   * statistics (0 means no limit); this should be set on the root of the
+   * tree.  Every CheckInterval() points, the leaves are ranked by the number
+   * of training points they misclassified since they were last (re)activated,
+   * and only the highest ranked leaves stay active.  Inactive leaves do not
+   * keep any split statistics and cannot split, but still classify points.
+   */
+  void MaxActiveLeaves(const size_t maxActiveLeaves);
+
+  //! Get whether concept drift detection is enabled.
+  bool DriftDetection() const { return driftDetection; }
+  //! Enable or disable concept drift detection for this node and all nodes
+  //! below it.  Streaming training is then done one point at a time.
+  void DriftDetection(const bool driftDetection);
+
+  //! Get whether this node is an active leaf, or an internal node.
+  bool IsActive() const { return active; }
+
+  //! Get the alternate subtree grown at this node after a drift was detected
+  //! (nullptr if there is none).
+  const HoeffdingTree* AlternateTree() const { return alternateTree; }
+
   //! Get the number of points seen so far.
   size_t NumSamples() const { return numSamples; }
 
@@ -549,9 +606,77 @@ class HoeffdingTree
   //! If the split has occurred, these are the children.
   std::vector<HoeffdingTree*> children;
 
+  //! The maximum number of active leaves below this node (0 means no limit).
+  size_t maxActiveLeaves;
+  //! The number of points trained on since the last memory budget check.
+  size_t budgetSamples;
+  //! Whether this node is an active leaf or an internal node.
+  bool active;
+  //! Whether concept drift detection is enabled.
+  bool driftDetection;
+  //! The error of this subtree on the points it was trained on, if drift
+  //! detection is enabled.
+  ADWIN errorMonitor;
+  //! The alternate subtree grown after a drift, or nullptr.
+  HoeffdingTree* alternateTree;
+
+  /**
+   * Train on a single point, given the class that this subtree predicted for
+   * it (which is only used if drift detection is enabled).
+   */
+  template<typename VecType>
+  void TrainPoint(const VecType& point,
+                  const size_t label,
+                  const size_t prediction);
+
+  /**
+   * Compare the error of this node with the error of its alternate subtree,
+   * and replace this node with the alternate subtree if it is significantly
+   * better, or delete the alternate subtree if it is significantly worse.
+   *
+   * @return Whether this node was replaced.
+   */
+  bool CheckAlternate();
+
+  //! Replace the contents of this node with those of its alternate subtree.
+  void ReplaceWithAlternate();
+
+  //! Collect all leaves below this node, including those of alternate
+  //! subtrees.
+  void CollectLeaves(std::vector<HoeffdingTree*>& leaves);
+
+  //! Find an active leaf below this node (nullptr if there is none).
+  const HoeffdingTree* FindActiveLeaf() const;
+
+  //! Deactivate and reactivate leaves so that at most maxActiveLeaves leaves
+  //! are active.
+  void EnforceMemoryBudget();
+
+  /**
+   * Allocate new split statistics for this leaf, using the parameters of the
+   * splits of the given leaf (or default parameters if it is nullptr).
+   */
+  void InitializeSplits(const HoeffdingTree* prototype);
+
+  /**
+   * Find the leaf of the tree below this node that the given point falls
+   * into.
+   *
+   * @param point Point to find the leaf of.
+   */
+  template<typename VecType>
+  HoeffdingTree* FindLeaf(const VecType& point);
+
   /**
    * Perform training (typically after a reset, but not necessarily).  This
    * assumes datasetInfo and dimensionMappings are set correctly.
+   *
+   * In streaming mode, the points are processed in batches of
+   * StreamingBatchSize points: all points of a batch are first routed to the
+   * leaves they fall into, and then each leaf is trained on its points, in
+   * order, with the leaves trained in parallel with OpenMP.  Because a point
+   * only affects the leaf it falls into (and the children that leaf creates),
+   * the result is the same as training on one point at a time.
    */
   template<typename MatType>
   void TrainInternal(const MatType& data,
@@ -570,6 +695,12 @@ class HoeffdingTree
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType),
+    (mlpack::HoeffdingTree<FitnessFunction, NumericSplitType,
+    CategoricalSplitType>), (1));
+
 #include "hoeffding_tree_impl.hpp"
 
 #endif
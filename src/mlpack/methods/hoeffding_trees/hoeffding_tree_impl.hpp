@@ -40,7 +40,12 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    maxActiveLeaves(0),
+    budgetSamples(0),
+    active(true),
+    driftDetection(false),
+    alternateTree(nullptr)
 {
   // Nothing to do.
 }
@@ -78,7 +83,12 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    maxActiveLeaves(0),
+    budgetSamples(0),
+    active(true),
+    driftDetection(false),
+    alternateTree(nullptr)
 {
   // Do we need to generate the mappings too?
   if (ownsMappings)
@@ -131,7 +141,12 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    maxActiveLeaves(0),
+    budgetSamples(0),
+    active(true),
+    driftDetection(false),
+    alternateTree(nullptr)
 {
   // Do we need to generate the mappings too?
   if (ownsMappings)
@@ -189,7 +204,12 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    maxActiveLeaves(0),
+    budgetSamples(0),
+    active(true),
+    driftDetection(false),
+    alternateTree(nullptr)
 {
   // Reset the tree.
   ResetTree(categoricalSplitIn, numericSplitIn);
@@ -232,7 +252,12 @@ HoeffdingTree<
     majorityClass(0),
     majorityProbability(0.0),
     categoricalSplit(0),
-    numericSplit()
+    numericSplit(),
+    maxActiveLeaves(0),
+    budgetSamples(0),
+    active(true),
+    driftDetection(false),
+    alternateTree(nullptr)
 {
   // Reset the tree.
   ResetTree(categoricalSplitIn, numericSplitIn);
@@ -264,7 +289,13 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(other.categoricalSplit),
-    numericSplit(other.numericSplit)
+    numericSplit(other.numericSplit),
+    maxActiveLeaves(other.maxActiveLeaves),
+    budgetSamples(other.budgetSamples),
+    active(other.active),
+    driftDetection(other.driftDetection),
+    errorMonitor(other.errorMonitor),
+    alternateTree(nullptr)
 {
   // Copy each of the children.
   for (size_t i = 0; i < other.children.size(); ++i)
@@ -280,6 +311,20 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     children[i]->dimensionMappings = this->dimensionMappings;
     children[i]->ownsMappings = false;
   }
+
+  // Copy the alternate subtree in the same way.
+  if (other.alternateTree)
+  {
+    alternateTree = new HoeffdingTree(*other.alternateTree);
+
+    delete alternateTree->datasetInfo;
+    alternateTree->datasetInfo = this->datasetInfo;
+    alternateTree->ownsInfo = false;
+
+    delete alternateTree->dimensionMappings;
+    alternateTree->dimensionMappings = this->dimensionMappings;
+    alternateTree->ownsMappings = false;
+  }
 }
 
 // Move constructor.
@@ -304,11 +349,18 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     majorityClass(other.majorityClass),
     majorityProbability(other.majorityProbability),
     categoricalSplit(std::move(other.categoricalSplit)),
-    numericSplit(std::move(other.numericSplit))
+    numericSplit(std::move(other.numericSplit)),
+    maxActiveLeaves(other.maxActiveLeaves),
+    budgetSamples(other.budgetSamples),
+    active(other.active),
+    driftDetection(other.driftDetection),
+    errorMonitor(std::move(other.errorMonitor)),
+    alternateTree(other.alternateTree)
 {
   // Remove pointers.
   other.dimensionMappings = nullptr;
   other.datasetInfo = nullptr;
+  other.alternateTree = nullptr;
 
   // Reset primary type variables.
   other.numSamples = 0;
@@ -349,6 +401,11 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
     majorityProbability = other.majorityProbability;
     categoricalSplit = other.categoricalSplit;
     numericSplit = other.numericSplit;
+    maxActiveLeaves = other.maxActiveLeaves;
+    budgetSamples = other.budgetSamples;
+    active = other.active;
+    driftDetection = other.driftDetection;
+    errorMonitor = other.errorMonitor;
 
     // Copy each of the children.
     for (size_t i = 0; i < other.children.size(); ++i)
@@ -364,6 +421,22 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
       children[i]->dimensionMappings = this->dimensionMappings;
       children[i]->ownsMappings = false;
     }
+
+    // Copy the alternate subtree in the same way.
+    delete alternateTree;
+    alternateTree = nullptr;
+    if (other.alternateTree)
+    {
+      alternateTree = new HoeffdingTree(*other.alternateTree);
+
+      delete alternateTree->datasetInfo;
+      alternateTree->datasetInfo = this->datasetInfo;
+      alternateTree->ownsInfo = false;
+
+      delete alternateTree->dimensionMappings;
+      alternateTree->dimensionMappings = this->dimensionMappings;
+      alternateTree->ownsMappings = false;
+    }
   }
   return *this;
 }
@@ -395,10 +468,18 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>&
     majorityProbability = other.majorityProbability;
     categoricalSplit = std::move(other.categoricalSplit);
     numericSplit = std::move(other.numericSplit);
+    maxActiveLeaves = other.maxActiveLeaves;
+    budgetSamples = other.budgetSamples;
+    active = other.active;
+    driftDetection = other.driftDetection;
+    errorMonitor = std::move(other.errorMonitor);
+    delete alternateTree;
+    alternateTree = other.alternateTree;
 
     // Remove pointers.
     other.dimensionMappings = nullptr;
     other.datasetInfo = nullptr;
+    other.alternateTree = nullptr;
 
     // Reset primary type variables.
     other.numSamples = 0;
@@ -426,6 +507,7 @@ HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>::
     delete datasetInfo;
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
+  delete alternateTree;
 }
 
 template<typename FitnessFunction,
@@ -589,9 +671,75 @@ void HoeffdingTree<
     CategoricalSplitType
 >::Train(const VecType& point, const size_t label)
 {
+  TrainPoint(point, label, driftDetection ? Classify(point) : 0);
+
+  // Enforce the memory budget every checkInterval points.
+  if (maxActiveLeaves > 0 && ++budgetSamples >= checkInterval)
+  {
+    budgetSamples = 0;
+    EnforceMemoryBudget();
+  }
+}
+
+//! Train on one point, given the prediction of this subtree.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+template<typename VecType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainPoint(const VecType& point,
+              const size_t label,
+              const size_t prediction)
+{
+  if (driftDetection)
+  {
+    // Monitor the error of this subtree.
+    const double oldError = errorMonitor.Estimation();
+    const bool change = errorMonitor.Update((prediction == label) ? 0.0 : 1.0);
+
+    // Only internal nodes can be replaced by an alternate subtree.
+    if (children.size() > 0)
+    {
+      if (alternateTree == nullptr)
+      {
+        // Start an alternate subtree if the error has increased.
+        if (change && errorMonitor.Estimation() > oldError)
+        {
+          alternateTree = new HoeffdingTree(*datasetInfo, numClasses,
+              successProbability, maxSamples, checkInterval, minSamples,
+              CategoricalSplitType<FitnessFunction>(0, numClasses),
+              NumericSplitType<FitnessFunction>(numClasses),
+              dimensionMappings, false);
+          alternateTree->InitializeSplits(FindActiveLeaf());
+          alternateTree->driftDetection = true;
+        }
+      }
+      else if (CheckAlternate())
+      {
+        // This node is now what was the alternate subtree, so train that.
+        TrainPoint(point, label, Classify(point));
+        return;
+      }
+
+      if (alternateTree != nullptr)
+      {
+        alternateTree->TrainPoint(point, label,
+            alternateTree->Classify(point));
+      }
+    }
+  }
+
   if (splitDimension == size_t(-1))
   {
     ++numSamples;
+
+    // An inactive leaf only counts its points, which measures its promise.
+    if (!active)
+      return;
+
     size_t numericIndex = 0;
     size_t categoricalIndex = 0;
     for (size_t i = 0; i < point.n_rows; ++i)
@@ -631,7 +779,210 @@ void HoeffdingTree<
   {
     // Already split.  Pass the training point to the relevant child.
     size_t direction = CalculateDirection(point);
-    children[direction]->Train(point, label);
+    children[direction]->TrainPoint(point, label, prediction);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+bool HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::CheckAlternate()
+{
+  const size_t width = errorMonitor.Width();
+  const size_t alternateWidth = alternateTree->errorMonitor.Width();
+  if (width <= AlternateMinSamples || alternateWidth <= AlternateMinSamples)
+    return false;
+
+  // Compare the error rates with a Hoeffding bound with 95% confidence.
+  const double error = errorMonitor.Estimation();
+  const double alternateError = alternateTree->errorMonitor.Estimation();
+  const double bound = std::sqrt(2.0 * error * (1.0 - error) *
+      std::log(2.0 / 0.05) * (1.0 / width + 1.0 / alternateWidth));
+  if (bound < error - alternateError)
+  {
+    ReplaceWithAlternate();
+    return true;
+  }
+  else if (bound < alternateError - error)
+  {
+    // The alternate subtree is worse, so give up on it.
+    delete alternateTree;
+    alternateTree = nullptr;
+  }
+
+  return false;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::ReplaceWithAlternate()
+{
+  // Swap the contents of the two nodes (but not the shared dataset
+  // information), and then delete the old subtree with the alternate node.
+  HoeffdingTree* old = alternateTree;
+  alternateTree = nullptr;
+
+  std::swap(numericSplits, old->numericSplits);
+  std::swap(categoricalSplits, old->categoricalSplits);
+  std::swap(numSamples, old->numSamples);
+  std::swap(splitDimension, old->splitDimension);
+  std::swap(majorityClass, old->majorityClass);
+  std::swap(majorityProbability, old->majorityProbability);
+  std::swap(categoricalSplit, old->categoricalSplit);
+  std::swap(numericSplit, old->numericSplit);
+  std::swap(children, old->children);
+  std::swap(active, old->active);
+  std::swap(errorMonitor, old->errorMonitor);
+  std::swap(alternateTree, old->alternateTree);
+
+  delete old;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::CollectLeaves(std::vector<HoeffdingTree*>& leaves)
+{
+  std::stack<HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    HoeffdingTree* node = stack.top();
+    stack.pop();
+    if (node->children.size() == 0)
+      leaves.push_back(node);
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+    if (node->alternateTree != nullptr)
+      stack.push(node->alternateTree);
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+const HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>*
+HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::FindActiveLeaf() const
+{
+  std::stack<const HoeffdingTree*> stack;
+  stack.push(this);
+  while (!stack.empty())
+  {
+    const HoeffdingTree* node = stack.top();
+    stack.pop();
+    if (node->children.size() == 0 && node->active)
+      return node;
+    for (size_t i = 0; i < node->children.size(); ++i)
+      stack.push(node->children[i]);
+  }
+
+  return nullptr;
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::EnforceMemoryBudget()
+{
+  std::vector<HoeffdingTree*> leaves;
+  CollectLeaves(leaves);
+
+  // The promise of a leaf is the number of points it has misclassified since
+  // it was (re)activated, which estimates how much its error could be
+  // reduced by splitting it.
+  arma::vec promise(leaves.size());
+  for (size_t i = 0; i < leaves.size(); ++i)
+  {
+    promise[i] = leaves[i]->numSamples *
+        (1.0 - leaves[i]->majorityProbability);
+  }
+  const arma::uvec order = arma::stable_sort_index(promise, "descend");
+  const size_t numActive = (maxActiveLeaves == 0) ? leaves.size() :
+      std::min(maxActiveLeaves, leaves.size());
+
+  // Reactivate the most promising leaves before deactivating any, so that
+  // there is an active leaf to take split parameters from.
+  const HoeffdingTree* prototype = FindActiveLeaf();
+  for (size_t i = 0; i < numActive; ++i)
+  {
+    HoeffdingTree* leaf = leaves[order[i]];
+    if (!leaf->active)
+    {
+      leaf->InitializeSplits(prototype);
+      leaf->numSamples = 0;
+      leaf->active = true;
+    }
+  }
+
+  for (size_t i = numActive; i < leaves.size(); ++i)
+  {
+    HoeffdingTree* leaf = leaves[order[i]];
+    if (leaf->active)
+    {
+      // Free the memory of the split statistics.
+      std::vector<NumericSplitType<FitnessFunction>>().swap(
+          leaf->numericSplits);
+      std::vector<CategoricalSplitType<FitnessFunction>>().swap(
+          leaf->categoricalSplits);
+      leaf->active = false;
+    }
+  }
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::InitializeSplits(const HoeffdingTree* prototype)
+{
+  const NumericSplitType<FitnessFunction> defaultNumericSplit(numClasses);
+  const CategoricalSplitType<FitnessFunction> defaultCategoricalSplit(0,
+      numClasses);
+  const NumericSplitType<FitnessFunction>& numericSplitIn =
+      (prototype != nullptr && prototype->numericSplits.size() > 0) ?
+      prototype->numericSplits[0] : defaultNumericSplit;
+  const CategoricalSplitType<FitnessFunction>& categoricalSplitIn =
+      (prototype != nullptr && prototype->categoricalSplits.size() > 0) ?
+      prototype->categoricalSplits[0] : defaultCategoricalSplit;
+
+  numericSplits.clear();
+  categoricalSplits.clear();
+  for (size_t i = 0; i < datasetInfo->Dimensionality(); ++i)
+  {
+    if (datasetInfo->Type(i) == data::Datatype::categorical)
+    {
+      categoricalSplits.push_back(CategoricalSplitType<FitnessFunction>(
+          datasetInfo->NumMappings(i), numClasses, categoricalSplitIn));
+    }
+    else
+    {
+      numericSplits.push_back(NumericSplitType<FitnessFunction>(numClasses,
+          numericSplitIn));
+    }
   }
 }
 
@@ -788,6 +1139,45 @@ void HoeffdingTree<
     children[i]->CheckInterval(checkInterval);
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::MaxActiveLeaves(const size_t maxActiveLeaves)
+{
+  this->maxActiveLeaves = maxActiveLeaves;
+  budgetSamples = 0;
+  EnforceMemoryBudget();
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::DriftDetection(const bool driftDetection)
+{
+  this->driftDetection = driftDetection;
+  if (!driftDetection)
+  {
+    errorMonitor.Reset();
+    delete alternateTree;
+    alternateTree = nullptr;
+  }
+
+  for (size_t i = 0; i < children.size(); ++i)
+    children[i]->DriftDetection(driftDetection);
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -899,6 +1289,8 @@ void HoeffdingTree<
 >::Classify(const MatType& data, arma::Row<size_t>& predictions) const
 {
   predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
   for (size_t i = 0; i < data.n_cols; ++i)
     predictions[i] = Classify(data.col(i));
 }
@@ -920,6 +1312,8 @@ void HoeffdingTree<
 {
   predictions.set_size(data.n_cols);
   probabilities.set_size(data.n_cols);
+
+  #pragma omp parallel for
   for (size_t i = 0; i < data.n_cols; ++i)
     Classify(data.col(i), predictions[i], probabilities[i]);
 }
@@ -982,6 +1376,7 @@ void HoeffdingTree<
     }
 
     children[i]->MajorityClass() = childMajorities[i];
+    children[i]->driftDetection = driftDetection;
   }
 
   // Eliminate now-unnecessary split information.
@@ -1055,7 +1450,7 @@ void HoeffdingTree<
     FitnessFunction,
     NumericSplitType,
     CategoricalSplitType
->::serialize(Archive& ar, const uint32_t /* version */)
+>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(splitDimension));
 
@@ -1084,11 +1479,32 @@ void HoeffdingTree<
     for (size_t i = 0; i < children.size(); ++i)
       delete children[i];
     children.clear();
+
+    delete alternateTree;
+    alternateTree = nullptr;
   }
 
   ar(CEREAL_NVP(majorityClass));
   ar(CEREAL_NVP(majorityProbability));
 
+  // Older versions did not have memory budgets or drift detection.
+  if (version > 0)
+  {
+    ar(CEREAL_NVP(maxActiveLeaves));
+    ar(CEREAL_NVP(budgetSamples));
+    ar(CEREAL_NVP(active));
+    ar(CEREAL_NVP(driftDetection));
+    ar(CEREAL_NVP(errorMonitor));
+  }
+  else if (cereal::is_loading<Archive>())
+  {
+    maxActiveLeaves = 0;
+    budgetSamples = 0;
+    active = true;
+    driftDetection = false;
+    errorMonitor.Reset();
+  }
+
   // Depending on whether or not we have split yet, we may need to save
   // different things.
   if (splitDimension == size_t(-1))
@@ -1120,6 +1536,13 @@ void HoeffdingTree<
       categoricalSplit = typename CategoricalSplitType<FitnessFunction>::
           SplitInfo(numClasses);
       numericSplit = typename NumericSplitType<FitnessFunction>::SplitInfo();
+
+      // An inactive leaf holds no split statistics.
+      if (!active)
+      {
+        numericSplits.clear();
+        categoricalSplits.clear();
+      }
     }
 
     // There's no need to serialize if there's no information contained in the
@@ -1144,6 +1567,10 @@ void HoeffdingTree<
     // Serialize the children, because we have split.
       ar(CEREAL_VECTOR_POINTER(children));
 
+    // Serialize the alternate subtree, if there is one.
+    if (version > 0)
+      ar(CEREAL_POINTER(alternateTree));
+
     if (cereal::is_loading<Archive>())
     {
       for (size_t i = 0; i < children.size(); ++i)
@@ -1155,6 +1582,13 @@ void HoeffdingTree<
         children[i]->ownsMappings = false;
       }
 
+      if (alternateTree != nullptr)
+      {
+        if (alternateTree->datasetInfo == datasetInfo)
+          alternateTree->ownsInfo = false;
+        alternateTree->ownsMappings = false;
+      }
+
       numericSplits.clear();
       categoricalSplits.clear();
 
@@ -1166,6 +1600,26 @@ void HoeffdingTree<
   }
 }
 
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+template<typename VecType>
+HoeffdingTree<FitnessFunction, NumericSplitType, CategoricalSplitType>*
+HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::FindLeaf(const VecType& point)
+{
+  HoeffdingTree* node = this;
+  while (node->children.size() > 0)
+    node = node->children[node->CalculateDirection(point)];
+
+  return node;
+}
+
 template<
     typename FitnessFunction,
     template<typename> class NumericSplitType,
@@ -1247,13 +1701,64 @@ void HoeffdingTree<
         children[i]->Train(childData, childLabels, numClasses, true);
       }
     }
+
+    if (maxActiveLeaves > 0)
+      EnforceMemoryBudget();
   }
-  else
+  else if (driftDetection)
   {
-    // We aren't training in batch mode; loop through the points.
+    // Drift detection monitors the error of every node on the path of each
+    // point, so the points must be streamed through the tree one at a time.
     for (size_t i = 0; i < data.n_cols; ++i)
       Train(data.col(i), labels[i]);
   }
+  else
+  {
+    // We aren't training in batch mode; stream the points through the tree, a
+    // batch at a time.
+    std::vector<HoeffdingTree*> leaves;
+    std::unordered_map<HoeffdingTree*, size_t> leafIndices;
+    std::vector<std::vector<size_t>> leafPoints;
+    for (size_t begin = 0; begin < data.n_cols; begin += StreamingBatchSize)
+    {
+      const size_t end = std::min(begin + StreamingBatchSize,
+          (size_t) data.n_cols);
+
+      // Find the leaf that each point of the batch falls into.  No leaf is
+      // split yet, so this is the leaf that would receive the point in
+      // one-at-a-time training.
+      leaves.clear();
+      leafIndices.clear();
+      leafPoints.clear();
+      for (size_t i = begin; i < end; ++i)
+      {
+        HoeffdingTree* leaf = FindLeaf(data.col(i));
+        const auto it = leafIndices.emplace(leaf, leaves.size()).first;
+        if (it->second == leaves.size())
+        {
+          leaves.push_back(leaf);
+          leafPoints.emplace_back();
+        }
+
+        leafPoints[it->second].push_back(i);
+      }
+
+      // Each leaf only modifies itself and the children it creates, so the
+      // leaves can be trained independently.
+      #pragma omp parallel for schedule(dynamic)
+      for (size_t l = 0; l < leaves.size(); ++l)
+      {
+        for (size_t j = 0; j < leafPoints[l].size(); ++j)
+        {
+          const size_t i = leafPoints[l][j];
+          leaves[l]->TrainPoint(data.col(i), labels[i], 0);
+        }
+      }
+
+      if (maxActiveLeaves > 0)
+        EnforceMemoryBudget();
+    }
+  }
 }
 
 template<
@@ -1306,6 +1811,11 @@ void HoeffdingTree<
   splitDimension = size_t(-1);
   majorityClass = 0;
   majorityProbability = 0.0;
+  budgetSamples = 0;
+  active = true;
+  errorMonitor.Reset();
+  delete alternateTree;
+  alternateTree = nullptr;
   categoricalSplit =
       typename CategoricalSplitType<FitnessFunction>::SplitInfo(0);
   numericSplit = typename NumericSplitType<FitnessFunction>::SplitInfo();
@@ -0,0 +1,254 @@
+/**
+ * @file methods/kde/hermite_expansion.hpp
+ *
+ * A truncated Hermite (far-field) series expansion of a sum of Gaussian
+ * kernels, used to approximate the contribution of a whole reference node to
+ * the density of a query point.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_HERMITE_EXPANSION_HPP
+#define MLPACK_METHODS_KDE_HERMITE_EXPANSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The far-field expansion of the sum of the Gaussian kernels
+ * exp(-|x - r|^2 / (2 h^2)) of the descendant points r of a tree node.  With
+ * the scaled coordinates t = (x - c) / (sqrt(2) h) and s = (r - c) /
+ * (sqrt(2) h) around the center c of the node,
+ *
+ *   sum_r exp(-|t - s|^2) = sum_alpha A_alpha h_alpha(t),
+ *   A_alpha = (1 / alpha!) sum_r s^alpha,
+ *
+ * where alpha is a multi-index and h_alpha is a product of Hermite functions.
+ * The coefficients A_alpha depend only on the node, so once they are computed
+ * the sum can be evaluated at any query point in time independent of the
+ * number of points in the node.  The expansion is truncated to the
+ * multi-indices whose components are all smaller than the order p.  This is
+ * the far-field expansion of the dual-tree fast Gauss transform:
+ *
+ * @code
+ * @inproceedings{lee2006dual,
+ *   title={Dual-Tree Fast Gauss Transforms},
+ *   author={Lee, Dongryeol and Gray, Alexander G. and Moore, Andrew W.},
+ *   booktitle={Advances in Neural Information Processing Systems 18
+ *       (NIPS 2005)},
+ * *   year={2006}
+ * }
+ * @endcode
+ *
+ * The truncation error for any query point is bounded with Cramer's inequality
+ * for Hermite functions; see ErrorBound().
+ */
+class HermiteExpansion
+{
+ public:
+  //! Create an empty expansion, which can't be used.
+  HermiteExpansion() : numPoints(0), scale(0.0), radius(0.0), order(0) { }
+
+  /**
+   * Compute the expansion of the descendant points of the given node.  The
+   * expansion is only computed if the bound on its truncation error is finite
+   * (that is, if the points of the node fit in a box of side 2 h); its order is
+   * the largest one up to maxOrder for which evaluating it is cheaper than
+   * computing all the kernels of the node.  If no expansion is computed,
+   * Order() is 0.
+   *
+   * @param node Node whose descendants are expanded.
+   * @param bandwidth Bandwidth of the Gaussian kernel.
+   * @param maxOrder Maximum order of the expansion.
+   */
+  template<typename TreeType>
+  void Compute(const TreeType& node,
+               const double bandwidth,
+               const size_t maxOrder)
+  {
+    const auto& dataset = node.Dataset();
+    const size_t dims = dataset.n_rows;
+    numPoints = node.NumDescendants();
+    order = 0;
+    if (numPoints < 2 || maxOrder == 0 || dims == 0)
+      return;
+
+    // The center of the bounding box of the points minimizes the L-infinity
+    // radius of the node, which controls the truncation error.
+    arma::vec lo(dims), hi(dims);
+    lo.fill(DBL_MAX);
+    hi.fill(-DBL_MAX);
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      const size_t point = node.Descendant(i);
+      for (size_t d = 0; d < dims; ++d)
+      {
+        lo[d] = std::min(lo[d], (double) dataset(d, point));
+        hi[d] = std::max(hi[d], (double) dataset(d, point));
+      }
+    }
+
+    center = (lo + hi) / 2.0;
+    scale = 1.0 / (std::sqrt(2.0) * bandwidth);
+    radius = arma::max(hi - lo) / (2.0 * bandwidth);
+    if (radius >= 1.0)
+      return;
+
+    // An expansion of order p has p^dims terms.
+    order = 1;
+    while (order < maxOrder && std::pow(order + 1.0, (double) dims) < numPoints)
+      ++order;
+
+    coefficients.zeros((size_t) std::pow(order, dims));
+    arma::mat powers(order, dims);
+    const size_t topStride = coefficients.n_elem / order;
+    for (size_t i = 0; i < numPoints; ++i)
+    {
+      const size_t point = node.Descendant(i);
+      // powers(k, d) = s_d^k / k!.
+      for (size_t d = 0; d < dims; ++d)
+      {
+        const double s = (dataset(d, point) - center[d]) * scale;
+        powers(0, d) = 1.0;
+        for (size_t k = 1; k < order; ++k)
+          powers(k, d) = powers(k - 1, d) * s / k;
+      }
+
+      AddTerms(powers, dims - 1, 0, topStride, 1.0);
+    }
+  }
+
+  /**
+   * Evaluate the expansion, truncated at the given order, at the given point.
+   *
+   * @param point Query point.
+   * @param p Order of the truncation (1 <= p <= Order()).
+   * @param hermite Workspace for the Hermite function values.
+   */
+  template<typename VecType>
+  double Evaluate(const VecType& point, const size_t p, arma::mat& hermite)
+      const
+  {
+    const size_t dims = center.n_elem;
+    hermite.set_size(p, dims);
+    for (size_t d = 0; d < dims; ++d)
+    {
+      // h_0(t) = exp(-t^2), h_1(t) = 2 t h_0(t), and
+      // h_{n + 1}(t) = 2 t h_n(t) - 2 n h_{n - 1}(t).
+      const double t = (point[d] - center[d]) * scale;
+      hermite(0, d) = std::exp(-t * t);
+      if (p > 1)
+        hermite(1, d) = 2.0 * t * hermite(0, d);
+      for (size_t n = 1; n + 1 < p; ++n)
+      {
+        hermite(n + 1, d) = 2.0 * t * hermite(n, d) -
+            2.0 * n * hermite(n - 1, d);
+      }
+    }
+
+    return EvaluateTerms(hermite, p, dims - 1, 0, coefficients.n_elem / order);
+  }
+
+  /**
+   * Return an upper bound on the absolute error of the expansion truncated at
+   * the given order, for any query point.
+   */
+  double ErrorBound(const size_t p) const
+  {
+    if (order == 0)
+      return DBL_MAX;
+
+    // Cramer's inequality bounds the n'th Hermite function by
+    // K 2^(n / 2) sqrt(n!), with K < 1.0865, so in one dimension the error of
+    // the truncated expansion of exp(-(t - s)^2) is at most
+    // eps = K a^p / (sqrt(p!) (1 - a)), where a = sqrt(2) |s| <= radius.  Each
+    // one-dimensional factor is at most 1 and its expansion at most 1 + eps,
+    // so the error of the product of the d factors is at most (1 + eps)^d - 1.
+    const double eps = 1.0865 * std::pow(radius, (double) p) /
+        (std::sqrt(std::tgamma(p + 1.0)) * (1.0 - radius));
+    return numPoints * std::expm1(center.n_elem * std::log1p(eps));
+  }
+
+  //! Get the order of the expansion (0 if it was not computed).
+  size_t Order() const { return order; }
+
+  //! Get the number of points in the expansion.
+  size_t NumPoints() const { return numPoints; }
+
+  //! Get the center of the expansion.
+  const arma::vec& Center() const { return center; }
+
+  //! Get the coefficients of the expansion.
+  const arma::vec& Coefficients() const { return coefficients; }
+
+ private:
+  /**
+   * Add the products of the powers of the point to the coefficients, for the
+   * dimensions up to d.  The coefficient of the multi-index alpha is stored at
+   * index sum_d alpha_d order^d.
+   */
+  void AddTerms(const arma::mat& powers,
+                const size_t d,
+                const size_t offset,
+                const size_t stride,
+                const double product)
+  {
+    if (d == 0)
+    {
+      for (size_t k = 0; k < order; ++k)
+        coefficients[offset + k] += product * powers(k, 0);
+      return;
+    }
+
+    for (size_t k = 0; k < order; ++k)
+    {
+      AddTerms(powers, d - 1, offset + k * stride, stride / order,
+          product * powers(k, d));
+    }
+  }
+
+  //! Evaluate the terms of the truncated expansion for the dimensions up to d.
+  double EvaluateTerms(const arma::mat& hermite,
+                       const size_t p,
+                       const size_t d,
+                       const size_t offset,
+                       const size_t stride) const
+  {
+    double sum = 0.0;
+    if (d == 0)
+    {
+      for (size_t k = 0; k < p; ++k)
+        sum += coefficients[offset + k] * hermite(k, 0);
+      return sum;
+    }
+
+    for (size_t k = 0; k < p; ++k)
+    {
+      sum += hermite(k, d) * EvaluateTerms(hermite, p, d - 1,
+          offset + k * stride, stride / order);
+    }
+
+    return sum;
+  }
+
+  //! The number of points in the expansion.
+  size_t numPoints;
+  //! The center of the expansion.
+  arma::vec center;
+  //! The scaling factor 1 / (sqrt(2) h) of the coordinates.
+  double scale;
+  //! The L-infinity radius of the points around the center, divided by the
+  //! bandwidth.
+  double radius;
+  //! The order of the expansion.
+  size_t order;
+  //! The coefficients of the expansion.
+  arma::vec coefficients;
+};
+
+} // namespace mlpack
+
+#endif
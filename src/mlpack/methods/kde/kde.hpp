@@ -16,6 +16,7 @@
 #include <mlpack/core.hpp>
 
 #include "kde_stat.hpp"
+#include "hermite_expansion.hpp"
 
 namespace mlpack {
 
@@ -221,6 +222,43 @@ class KDE
    */
   void Evaluate(arma::vec& estimations);
 
+  /**
+   * Estimate density of each point in the query set for each of the given
+   * bandwidths, in a single traversal.  This is much faster than calling
+   * Evaluate() once for each bandwidth (for instance, to select the bandwidth
+   * by cross-validation), since all distance computations are shared.  For
+   * each bandwidth, the kernel `KernelType(bandwidth)` is used, and the kernel
+   * of the model is ignored.  The error tolerances hold for every bandwidth
+   * separately; Monte Carlo estimations are not used.  Estimations might not be
+   * normalized.
+   *
+   * - Dimension of each point in the query set must match the dimension of each
+   *   point in the reference set.
+   *
+   * @pre The model has to be previously trained.
+   * @param querySet Set of query points to get the density of.
+   * @param bandwidths Bandwidths to evaluate the density with.
+   * @param estimations Object which will hold the density of each query point
+   *     (in its column) for each bandwidth (in its row).
+   */
+  void Evaluate(MatType querySet,
+                const arma::vec& bandwidths,
+                arma::mat& estimations);
+
+  /**
+   * Estimate density of each point in the reference set for each of the given
+   * bandwidths, in a single traversal, without computing the estimation of a
+   * point with itself (i.e. leave-one-out estimations).  For each bandwidth,
+   * the kernel `KernelType(bandwidth)` is used.  Estimations might not be
+   * normalized.
+   *
+   * @pre The model has to be previously trained.
+   * @param bandwidths Bandwidths to evaluate the density with.
+   * @param estimations Object which will hold the density of each reference
+   *     point (in its column) for each bandwidth (in its row).
+   */
+  void Evaluate(const arma::vec& bandwidths, arma::mat& estimations);
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
 
@@ -239,6 +277,8 @@ class KDE
   //! Modify the metric.
   DistanceType& Distance() { return distance; }
 
+  //! Get the reference tree.
+  const Tree* ReferenceTree() const { return referenceTree; }
   //! Get the reference tree.
   Tree* ReferenceTree() { return referenceTree; }
 
@@ -297,6 +337,26 @@ class KDE
   //! Modify Monte Carlo break coefficient. (0 < newCoef <= 1).
   void MCBreakCoef(const double newCoef);
 
+  /**
+   * Get the maximum order of the Hermite series expansions used to approximate
+   * the Gaussian kernel (0 means that series expansions are not used).
+   */
+  size_t SeriesOrder() const { return seriesOrder; }
+
+  /**
+   * Modify the maximum order of the Hermite series expansions used to
+   * approximate the Gaussian kernel (0 means that series expansions are not
+   * used).  If it is not 0, every reference node whose points are close enough
+   * together (relative to the bandwidth) gets a far-field series expansion at
+   * evaluation time, and combinations of nodes that can't be pruned otherwise
+   * are approximated with that expansion when its error bound is within the
+   * error tolerances; see KDESeriesRules.  This only helps in low and moderate
+   * dimensions, since an expansion of order p has p^d terms.  It is only
+   * available with GaussianKernel and EuclideanDistance, and Monte Carlo
+   * estimations are not used together with series expansions.
+   */
+  size_t& SeriesOrder() { return seriesOrder; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -348,16 +408,85 @@ class KDE
   //! is the limit before Monte Carlo estimation recurses.
   double mcBreakCoef;
 
+  //! Maximum order of the series expansions (0 if they are not used).
+  size_t seriesOrder;
+
   //! Check whether absolute and relative error values are compatible.
   static void CheckErrorValues(const double relError, const double absError);
 
   //! Rearrange estimations vector if required.
   static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
                                    arma::vec& estimations);
+
+  //! Rearrange the columns of an estimations matrix if required.
+  static void RearrangeEstimations(const std::vector<size_t>& oldFromNew,
+                                   arma::mat& estimations);
+
+  //! Build the kernels for the given bandwidths, checking that they are valid.
+  static std::vector<KernelType> BuildKernels(const arma::vec& bandwidths);
+
+  /**
+   * Traverse the given query tree and the reference tree with the given rules.
+   * If OpenMP is available, the query tree is split into disjoint subtrees,
+   * which are traversed by different threads.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(RuleType& rules,
+                         Tree& queryTree,
+                         size_t& baseCases,
+                         size_t& scores);
+
+  /**
+   * Traverse the reference tree for each of the query points with the given
+   * rules, with several threads if OpenMP is available.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(RuleType& rules,
+                           const size_t numQueries,
+                           size_t& baseCases,
+                           size_t& scores);
+
+  /**
+   * If series expansions are enabled and available for the kernel and the
+   * distance metric, evaluate the densities of the given query set (with the
+   * given query tree in dual-tree mode, or NULL in single-tree mode) with
+   * KDESeriesRules and return true.  Otherwise, return false without doing
+   * anything.
+   */
+  bool SeriesEvaluate(const MatType& querySet,
+                      Tree* queryTree,
+                      arma::vec& estimations,
+                      const bool sameSet,
+                      size_t& baseCases,
+                      size_t& scores);
+
+  /**
+   * Compute the series expansions of the nodes of the reference tree, and set
+   * the expansion index of each node.
+   */
+  void BuildExpansions(std::vector<HermiteExpansion>& expansions);
+
+  /**
+   * Compute the Monte Carlo alpha of every node of the given tree in advance,
+   * so that the reference tree is not modified during parallel traversals.
+   */
+  void InitializeMCAlpha(Tree& node);
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename KernelType,
+                               typename DistanceType,
+                               typename MatType,
+                               template<typename TreeDistanceType,
+                                        typename TreeStatType,
+                                        typename TreeMatType> class TreeType,
+                               template<typename> class DualTreeTraversalType,
+                               template<typename> class
+                                   SingleTreeTraversalType),
+    (mlpack::KDE<KernelType, DistanceType, MatType, TreeType,
+        DualTreeTraversalType, SingleTreeTraversalType>), (1));
+
 // Include implementation.
 #include "kde_impl.hpp"
 
@@ -12,6 +12,8 @@
 
 #include "kde.hpp"
 #include "kde_rules.hpp"
+#include "kde_multi_rules.hpp"
+#include "kde_series_rules.hpp"
 
 namespace mlpack {
 
@@ -49,7 +51,8 @@ KDE(const double relError,
     trained(false),
     mode(mode),
     monteCarlo(monteCarlo),
-    initialSampleSize(initialSampleSize)
+    initialSampleSize(initialSampleSize),
+    seriesOrder(0)
 {
   CheckErrorValues(relError, absError);
   MCProb(mcProb);
@@ -83,7 +86,8 @@ KDE(const KDE& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    seriesOrder(other.seriesOrder)
 {
   if (trained)
   {
@@ -129,7 +133,8 @@ KDE(KDE&& other) :
     mcProb(other.mcProb),
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
-    mcBreakCoef(other.mcBreakCoef)
+    mcBreakCoef(other.mcBreakCoef),
+    seriesOrder(other.seriesOrder)
 {
   other.kernel = std::move(KernelType());
   other.distance = std::move(DistanceType());
@@ -145,6 +150,7 @@ KDE(KDE&& other) :
   other.initialSampleSize = KDEDefaultParams::initialSampleSize;
   other.mcEntryCoef = KDEDefaultParams::mcEntryCoef;
   other.mcBreakCoef = KDEDefaultParams::mcBreakCoef;
+  other.seriesOrder = 0;
 }
 
 template<typename KernelType,
@@ -189,6 +195,7 @@ operator=(const KDE& other)
     initialSampleSize = other.initialSampleSize;
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
+    seriesOrder = other.seriesOrder;
     if (trained)
     {
       if (ownsReferenceTree)
@@ -253,6 +260,7 @@ operator=(KDE&& other)
     this->initialSampleSize = other.initialSampleSize;
     this->mcEntryCoef = other.mcEntryCoef;
     this->mcBreakCoef = other.mcBreakCoef;
+    this->seriesOrder = other.seriesOrder;
   }
   return *this;
 }
@@ -413,34 +421,32 @@ Evaluate(MatType querySet, arma::vec& estimations)
     }
 
     // Evaluate.
-    using RuleType = KDERules<DistanceType, KernelType, Tree>;
-    RuleType rules = RuleType(referenceTree->Dataset(),
-                              querySet,
-                              estimations,
-                              relError,
-                              absError,
-                              mcProb,
-                              initialSampleSize,
-                              mcEntryCoef,
-                              mcBreakCoef,
-                              distance,
-                              kernel,
-                              monteCarlo,
-                              false);
-
-    // Create traverser.
-    SingleTreeTraversalType<RuleType> traverser(rules);
+    size_t baseCases, scores;
+    if (!SeriesEvaluate(querySet, NULL, estimations, false, baseCases, scores))
+    {
+      using RuleType = KDERules<DistanceType, KernelType, Tree>;
+      RuleType rules = RuleType(referenceTree->Dataset(),
+                                querySet,
+                                estimations,
+                                relError,
+                                absError,
+                                mcProb,
+                                initialSampleSize,
+                                mcEntryCoef,
+                                mcBreakCoef,
+                                distance,
+                                kernel,
+                                monteCarlo,
+                                false);
 
-    // Traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      SingleTreeTraversal(rules, querySet.n_cols, baseCases, scores);
+    }
 
     estimations /= referenceTree->Dataset().n_cols;
 
-    Log::Info << rules.Scores() << " node combinations were scored."
-              << std::endl;
-    Log::Info << rules.BaseCases() << " base cases were calculated."
-              << std::endl;
+    Log::Info << scores << " node combinations were scored." << std::endl;
+    Log::Info << baseCases << " base cases were calculated." << std::endl;
   }
 }
 
@@ -506,31 +512,34 @@ Evaluate(Tree* queryTree,
   }
 
   // Evaluate.
-  using RuleType = KDERules<DistanceType, KernelType, Tree>;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            queryTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            distance,
-                            kernel,
-                            monteCarlo,
-                            false);
-
-  // Create traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  size_t baseCases, scores;
+  if (!SeriesEvaluate(queryTree->Dataset(), queryTree, estimations, false,
+      baseCases, scores))
+  {
+    using RuleType = KDERules<DistanceType, KernelType, Tree>;
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              queryTree->Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef,
+                              distance,
+                              kernel,
+                              monteCarlo,
+                              false);
+
+    DualTreeTraversal(rules, *queryTree, baseCases, scores);
+  }
   estimations /= referenceTree->Dataset().n_cols;
 
   // Rearrange if necessary.
   RearrangeEstimations(oldFromNewQueries, estimations);
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -570,40 +579,162 @@ Evaluate(arma::vec& estimations)
   }
 
   // Evaluate.
-  using RuleType = KDERules<DistanceType, KernelType, Tree>;
-  RuleType rules = RuleType(referenceTree->Dataset(),
-                            referenceTree->Dataset(),
-                            estimations,
-                            relError,
-                            absError,
-                            mcProb,
-                            initialSampleSize,
-                            mcEntryCoef,
-                            mcBreakCoef,
-                            distance,
-                            kernel,
-                            monteCarlo,
-                            true);
+  size_t baseCases = 0, scores = 0;
+  if (!SeriesEvaluate(referenceTree->Dataset(),
+      (mode == KDE_DUAL_TREE_MODE) ? referenceTree : NULL, estimations, true,
+      baseCases, scores))
+  {
+    using RuleType = KDERules<DistanceType, KernelType, Tree>;
+    RuleType rules = RuleType(referenceTree->Dataset(),
+                              referenceTree->Dataset(),
+                              estimations,
+                              relError,
+                              absError,
+                              mcProb,
+                              initialSampleSize,
+                              mcEntryCoef,
+                              mcBreakCoef,
+                              distance,
+                              kernel,
+                              monteCarlo,
+                              true);
+
+    if (mode == KDE_DUAL_TREE_MODE)
+    {
+      DualTreeTraversal(rules, *referenceTree, baseCases, scores);
+    }
+    else if (mode == KDE_SINGLE_TREE_MODE)
+    {
+      SingleTreeTraversal(rules, referenceTree->Dataset().n_cols, baseCases,
+          scores);
+    }
+  }
+
+  estimations /= referenceTree->Dataset().n_cols;
+  // Rearrange if necessary.
+  RearrangeEstimations(*oldFromNewReferences, estimations);
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+}
 
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Evaluate(MatType querySet,
+         const arma::vec& bandwidths,
+         arma::mat& estimations)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  const std::vector<KernelType> kernels = BuildKernels(bandwidths);
+  estimations.zeros(bandwidths.n_elem, querySet.n_cols);
+
+  // Check querySet has at least 1 element to evaluate.
+  if (querySet.n_cols == 0)
+  {
+    Log::Warn << "KDE::Evaluate(): querySet is empty, no predictions will "
+              << "be returned" << std::endl;
+    return;
+  }
+
+  // Check whether dimensions match.
+  if (querySet.n_rows != referenceTree->Dataset().n_rows)
+  {
+    throw std::invalid_argument("cannot evaluate KDE model: querySet and "
+                                "referenceSet dimensions don't match");
+  }
+
+  using RuleType = KDEMultiRules<DistanceType, KernelType, Tree>;
+  size_t baseCases, scores;
   if (mode == KDE_DUAL_TREE_MODE)
   {
-    // Create traverser.
-    DualTreeTraversalType<RuleType> traverser(rules);
-    traverser.Traverse(*referenceTree, *referenceTree);
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(std::move(querySet), oldFromNewQueries);
+
+    RuleType rules(referenceTree->Dataset(), queryTree->Dataset(), estimations,
+        relError, absError, distance, kernels, false);
+    DualTreeTraversal(rules, *queryTree, baseCases, scores);
+    delete queryTree;
+
+    RearrangeEstimations(oldFromNewQueries, estimations);
   }
-  else if (mode == KDE_SINGLE_TREE_MODE)
+  else
+  {
+    RuleType rules(referenceTree->Dataset(), querySet, estimations, relError,
+        absError, distance, kernels, false);
+    SingleTreeTraversal(rules, querySet.n_cols, baseCases, scores);
+  }
+
+  estimations /= referenceTree->Dataset().n_cols;
+
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+Evaluate(const arma::vec& bandwidths, arma::mat& estimations)
+{
+  // Check whether has already been trained.
+  if (!trained)
+  {
+    throw std::runtime_error("cannot evaluate KDE model: model needs to be "
+                             "trained before evaluation");
+  }
+
+  const std::vector<KernelType> kernels = BuildKernels(bandwidths);
+  estimations.zeros(bandwidths.n_elem, referenceTree->Dataset().n_cols);
+
+  using RuleType = KDEMultiRules<DistanceType, KernelType, Tree>;
+  RuleType rules(referenceTree->Dataset(), referenceTree->Dataset(),
+      estimations, relError, absError, distance, kernels, true);
+
+  size_t baseCases, scores;
+  if (mode == KDE_DUAL_TREE_MODE)
+  {
+    DualTreeTraversal(rules, *referenceTree, baseCases, scores);
+  }
+  else
   {
-    SingleTreeTraversalType<RuleType> traverser(rules);
-    for (size_t i = 0; i < referenceTree->Dataset().n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    SingleTreeTraversal(rules, referenceTree->Dataset().n_cols, baseCases,
+        scores);
   }
 
   estimations /= referenceTree->Dataset().n_cols;
   // Rearrange if necessary.
   RearrangeEstimations(*oldFromNewReferences, estimations);
 
-  Log::Info << rules.Scores() << " node combinations were scored." << std::endl;
-  Log::Info << rules.BaseCases() << " base cases were calculated." << std::endl;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
 }
 
 template<typename KernelType,
@@ -734,7 +865,7 @@ void KDE<KernelType,
          TreeType,
          DualTreeTraversalType,
          SingleTreeTraversalType>::
-serialize(Archive& ar, const uint32_t /* version */)
+serialize(Archive& ar, const uint32_t version)
 {
   // Serialize preferences.
   ar(CEREAL_NVP(relError));
@@ -747,6 +878,12 @@ serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(mcEntryCoef));
   ar(CEREAL_NVP(mcBreakCoef));
 
+  // Older versions did not have series expansions.
+  if (cereal::is_loading<Archive>() && version == 0)
+    seriesOrder = 0;
+  else
+    ar(CEREAL_NVP(seriesOrder));
+
   // If we are loading, clean up memory if necessary.
   if (cereal::is_loading<Archive>())
   {
@@ -824,4 +961,322 @@ RearrangeEstimations(const std::vector<size_t>& oldFromNew,
   }
 }
 
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+RearrangeEstimations(const std::vector<size_t>& oldFromNew,
+                     arma::mat& estimations)
+{
+  if (TreeTraits<Tree>::RearrangesDataset)
+  {
+    const size_t nQueries = oldFromNew.size();
+    arma::mat rearrangedEstimations(estimations.n_rows, nQueries);
+
+    // Remap columns.
+    for (size_t i = 0; i < nQueries; ++i)
+      rearrangedEstimations.col(oldFromNew.at(i)) = estimations.col(i);
+
+    estimations = std::move(rearrangedEstimations);
+  }
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+std::vector<KernelType> KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+BuildKernels(const arma::vec& bandwidths)
+{
+  if (bandwidths.n_elem == 0)
+  {
+    throw std::invalid_argument("cannot evaluate KDE model: no bandwidths "
+                                "given");
+  }
+
+  std::vector<KernelType> kernels;
+  kernels.reserve(bandwidths.n_elem);
+  for (size_t i = 0; i < bandwidths.n_elem; ++i)
+  {
+    if (bandwidths[i] <= 0.0)
+    {
+      throw std::invalid_argument("cannot evaluate KDE model: bandwidths must "
+                                  "be positive");
+    }
+
+    kernels.push_back(KernelType(bandwidths[i]));
+  }
+
+  return kernels;
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+DualTreeTraversal(RuleType& rules,
+                  Tree& queryTree,
+                  size_t& baseCases,
+                  size_t& scores)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // The reference nodes must not be modified while they are shared.
+    if (monteCarlo && std::is_same_v<KernelType, GaussianKernel>)
+      InitializeMCAlpha(*referenceTree);
+
+    // Collect a few more subtrees than threads, so that the work can be
+    // balanced dynamically.
+    std::vector<Tree*> frontier;
+    QueryFrontier(queryTree, 4 * numThreads, frontier);
+
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      // The query subtrees are disjoint, so every thread writes to different
+      // estimations and query statistics.
+      RuleType localRules(rules);
+      DualTreeTraversalType<RuleType> traverser(localRules);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+        traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadBaseCases += localRules.BaseCases();
+      threadScores += localRules.Scores();
+    }
+
+    baseCases = threadBaseCases;
+    scores = threadScores;
+    return;
+  }
+  #endif
+
+  DualTreeTraversalType<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+  baseCases = rules.BaseCases();
+  scores = rules.Scores();
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SingleTreeTraversal(RuleType& rules,
+                    const size_t numQueries,
+                    size_t& baseCases,
+                    size_t& scores)
+{
+  #ifdef MLPACK_USE_OPENMP
+  if (omp_get_max_threads() > 1)
+  {
+    // The reference nodes must not be modified while they are shared.
+    if (monteCarlo && std::is_same_v<KernelType, GaussianKernel>)
+      InitializeMCAlpha(*referenceTree);
+
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      // Every query point is handled by only one thread.
+      RuleType localRules(rules);
+      SingleTreeTraversalType<RuleType> traverser(localRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += localRules.BaseCases();
+      threadScores += localRules.Scores();
+    }
+
+    baseCases = threadBaseCases;
+    scores = threadScores;
+    return;
+  }
+  #endif
+
+  SingleTreeTraversalType<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+  baseCases = rules.BaseCases();
+  scores = rules.Scores();
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+InitializeMCAlpha(Tree& node)
+{
+  // This gives the same values as KDERules::CalculateAlpha().
+  const double mcBeta = 1 - mcProb;
+  KDEStat& stat = node.Stat();
+  if (node.Parent() == NULL)
+    stat.MCAlpha() = mcBeta;
+  else
+    stat.MCAlpha() = node.Parent()->Stat().MCAlpha() /
+        node.Parent()->NumChildren();
+  stat.MCBeta() = mcBeta;
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    InitializeMCAlpha(node.Child(i));
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+bool KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+SeriesEvaluate(const MatType& querySet,
+               Tree* queryTree,
+               arma::vec& estimations,
+               const bool sameSet,
+               size_t& baseCases,
+               size_t& scores)
+{
+  if (seriesOrder == 0)
+    return false;
+
+  if constexpr (std::is_same_v<KernelType, GaussianKernel> &&
+                std::is_same_v<DistanceType, EuclideanDistance>)
+  {
+    std::vector<HermiteExpansion> expansions;
+    BuildExpansions(expansions);
+
+    using RuleType = KDESeriesRules<Tree>;
+    RuleType rules(referenceTree->Dataset(), querySet, estimations, relError,
+        absError, kernel, expansions, sameSet);
+    if (queryTree != NULL)
+      DualTreeTraversal(rules, *queryTree, baseCases, scores);
+    else
+      SingleTreeTraversal(rules, querySet.n_cols, baseCases, scores);
+
+    return true;
+  }
+  else
+  {
+    Log::Warn << "KDE::Evaluate(): series expansions are only available with "
+        << "the Gaussian kernel and the Euclidean distance; ignoring "
+        << "SeriesOrder()." << std::endl;
+    return false;
+  }
+}
+
+template<typename KernelType,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void KDE<KernelType,
+         DistanceType,
+         MatType,
+         TreeType,
+         DualTreeTraversalType,
+         SingleTreeTraversalType>::
+BuildExpansions(std::vector<HermiteExpansion>& expansions)
+{
+  // Collect all the nodes of the reference tree.
+  std::vector<Tree*> nodes;
+  std::vector<Tree*> stack(1, referenceTree);
+  while (!stack.empty())
+  {
+    Tree* node = stack.back();
+    stack.pop_back();
+    nodes.push_back(node);
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push_back(&node->Child(i));
+  }
+
+  // The expansions of different nodes are independent.
+  expansions.clear();
+  expansions.resize(nodes.size());
+  #pragma omp parallel for schedule(dynamic)
+  for (size_t i = 0; i < (size_t) nodes.size(); ++i)
+    expansions[i].Compute(*nodes[i], kernel.Bandwidth(), seriesOrder);
+
+  size_t numExpansions = 0;
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    if (expansions[i].Order() > 0)
+    {
+      nodes[i]->Stat().ExpansionIndex() = i;
+      ++numExpansions;
+    }
+    else
+    {
+      nodes[i]->Stat().ExpansionIndex() = SIZE_MAX;
+    }
+  }
+
+  Log::Info << "Computed series expansions for " << numExpansions << " of "
+      << nodes.size() << " reference nodes." << std::endl;
+}
+
 } // namespace mlpack
@@ -81,6 +81,9 @@ class KDEWrapperBase
   //! Destruct the KDEWrapperBase (nothing to do).
   virtual ~KDEWrapperBase() { }
 
+  //! Return a reference to the reference set.
+  virtual const arma::mat& Dataset() const = 0;
+
   //! Modify the bandwidth of the kernel.
   virtual void Bandwidth(const double bw) = 0;
 
@@ -154,6 +157,12 @@ class KDEWrapper : public KDEWrapperBase
   //! Destruct the KDEWrapper (nothing to do).
   virtual ~KDEWrapper() { }
 
+  //! Get a reference to the reference set.
+  virtual const arma::mat& Dataset() const
+  {
+    return kde.ReferenceTree()->Dataset();
+  }
+
   //! Modify the bandwidth of the kernel.
   virtual void Bandwidth(const double bw) { kde.Kernel() = KernelType(bw); }
 
@@ -283,6 +292,10 @@ class KDEModel
    */
   KDEWrapperBase* kdeModel;
 
+  //! If the model was loaded with data::LoadMapped(), this holds the mapped
+  //! file that the reference set lives in.
+  std::shared_ptr<data::MappedFile> mapping;
+
  public:
   /**
    * Initialize KDEModel.
@@ -406,6 +419,15 @@ class KDEModel
   //! Modify Monte Carlo break coefficient.
   void MCBreakCoefficient(const double newBreakCoef);
 
+  //! Get the reference set of the model.
+  const arma::mat& Dataset() const { return kdeModel->Dataset(); }
+
+  //! Get the mapped file holding the reference set, if any (see
+  //! data::LoadMapped()).
+  const std::shared_ptr<data::MappedFile>& Mapping() const { return mapping; }
+  //! Modify the mapped file holding the reference set.
+  std::shared_ptr<data::MappedFile>& Mapping() { return mapping; }
+
   //! Get the mode of the model.
   KDEMode Mode() const { return kdeModel->Mode(); }
 
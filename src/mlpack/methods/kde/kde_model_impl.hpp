@@ -56,7 +56,8 @@ inline KDEModel::KDEModel(const KDEModel& other) :
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
     mcBreakCoef(other.mcBreakCoef),
-    kdeModel(other.kdeModel->Clone())
+    kdeModel(other.kdeModel->Clone()),
+    mapping(other.mapping)
 {
   // Nothing to do.
 }
@@ -73,7 +74,8 @@ inline KDEModel::KDEModel(KDEModel&& other) :
     initialSampleSize(other.initialSampleSize),
     mcEntryCoef(other.mcEntryCoef),
     mcBreakCoef(other.mcBreakCoef),
-    kdeModel(std::move(other.kdeModel))
+    kdeModel(std::move(other.kdeModel)),
+    mapping(std::move(other.mapping))
 {
   // Reset other model.
   other.bandwidth = 1.0;
@@ -105,6 +107,7 @@ inline KDEModel& KDEModel::operator=(const KDEModel& other)
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
     kdeModel = other.kdeModel->Clone();
+    mapping = other.mapping;
   }
 
   return *this;
@@ -127,6 +130,7 @@ inline KDEModel& KDEModel::operator=(KDEModel&& other)
     mcEntryCoef = other.mcEntryCoef;
     mcBreakCoef = other.mcBreakCoef;
     kdeModel = std::move(other.kdeModel);
+    mapping = std::move(other.mapping);
 
     // Reset other model.
     other.bandwidth = 1.0;
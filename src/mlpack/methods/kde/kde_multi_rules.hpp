@@ -0,0 +1,173 @@
+/**
+ * @file methods/kde/kde_multi_rules.hpp
+ *
+ * Rules for Kernel Density Estimation with several bandwidths at once, so that
+ * it can be done with arbitrary tree types.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_MULTI_RULES_HPP
+#define MLPACK_METHODS_KDE_MULTI_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
+namespace mlpack {
+
+/**
+ * A tree traversal Rules class for kernel density estimation with several
+ * kernels (usually the same kernel with different bandwidths) in a single
+ * traversal.  Each distance and each distance bound is computed once and shared
+ * by all kernels.  A combination of nodes is only pruned if the approximation
+ * is within the error tolerance for every kernel, so the results for each
+ * kernel are as accurate as with KDERules.  Unlike KDERules, unused error
+ * tolerance is not accumulated and Monte Carlo estimations are not available.
+ *
+ * The density for the i'th kernel and the j'th query point is stored in
+ * densities(i, j).
+ */
+template<typename DistanceType, typename KernelType, typename TreeType>
+class KDEMultiRules
+{
+ public:
+  /**
+   * Construct KDEMultiRules.
+   *
+   * @param referenceSet Reference set data.
+   * @param querySet Query set data.
+   * @param densities Matrix where estimations will be written (one row for
+   *     each kernel, and one column for each query point).
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param distance Instantiated distance metric.
+   * @param kernels Instantiated kernels.
+   * @param sameSet True if query and reference sets are the same
+   *                (monochromatic evaluation).
+   */
+  KDEMultiRules(const arma::mat& referenceSet,
+                const arma::mat& querySet,
+                arma::mat& densities,
+                const double relError,
+                const double absError,
+                DistanceType& distance,
+                const std::vector<KernelType>& kernels,
+                const bool sameSet);
+
+  //! Base Case.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  //! SingleTree Score.
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  //! SingleTree Rescore.
+  double Rescore(const size_t /* queryIndex */,
+                 TreeType& /* referenceNode */,
+                 const double oldScore) const
+  {
+    // If a branch is pruned then it continues to be pruned.
+    if (statistics)
+      statistics->RecordRescore(oldScore);
+    return oldScore;
+  }
+
+  //! Dual-Tree Score.
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Dual-Tree Rescore.
+  double Rescore(TreeType& /* queryNode */,
+                 TreeType& /* referenceNode */,
+                 const double oldScore) const
+  {
+    // If a branch is pruned then it continues to be pruned.
+    if (statistics)
+      statistics->RecordRescore(oldScore);
+    return oldScore;
+  }
+
+  using TraversalInfoType = mlpack::TraversalInfo<TreeType>;
+
+  //! Get traversal information.
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+
+  //! Modify traversal information.
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
+  //! Get the minimum number of base cases we need to perform to have acceptable
+  //! results.
+  size_t MinimumBaseCases() const { return 0; }
+
+ private:
+  /**
+   * Check whether the kernel values of points at a distance between
+   * minDistance and maxDistance can be approximated within the error tolerance
+   * for every kernel.  If so, the approximated kernel values are stored in
+   * kernelValues.
+   */
+  bool CanPrune(const double minDistance, const double maxDistance);
+
+  //! The reference set.
+  const arma::mat& referenceSet;
+
+  //! The query set.
+  const arma::mat& querySet;
+
+  //! Density values.
+  arma::mat& densities;
+
+  //! Relatve error tolerance.
+  const double relError;
+
+  //! Instantiated distance metric.
+  DistanceType& distance;
+
+  //! Instantiated kernels.
+  const std::vector<KernelType>& kernels;
+
+  //! Whether reference and query sets are the same.
+  const bool sameSet;
+
+  //! Absolute error tolerance available for each reference point.
+  const double absErrorTol;
+
+  //! The approximated kernel values of the last successful CanPrune() call.
+  arma::vec kernelValues;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  //! Traversal information.
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+
+  //! The number of scores.
+  size_t scores;
+
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_multi_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,225 @@
+/**
+ * @file methods/kde/kde_multi_rules_impl.hpp
+ *
+ * Implementation of rules for Kernel Density Estimation with several
+ * bandwidths at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_MULTI_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_MULTI_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_multi_rules.hpp"
+
+namespace mlpack {
+
+template<typename DistanceType, typename KernelType, typename TreeType>
+KDEMultiRules<DistanceType, KernelType, TreeType>::KDEMultiRules(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    arma::mat& densities,
+    const double relError,
+    const double absError,
+    DistanceType& distance,
+    const std::vector<KernelType>& kernels,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    relError(relError),
+    distance(distance),
+    kernels(kernels),
+    sameSet(sameSet),
+    absErrorTol(absError / referenceSet.n_cols),
+    kernelValues(kernels.size()),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0),
+    statistics(NULL)
+{
+  // Nothing else to do.
+}
+
+//! The base case.
+template<typename DistanceType, typename KernelType, typename TreeType>
+inline mlpack_force_inline
+double KDEMultiRules<DistanceType, KernelType, TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If reference and query sets are the same we don't want to compute the
+  // estimation of a point with itself.
+  if (sameSet && (queryIndex == referenceIndex))
+    return 0.0;
+
+  // Avoid duplicated calculations.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  // The distance is shared by all kernels.
+  const double d = distance.Evaluate(querySet.col(queryIndex),
+                                     referenceSet.col(referenceIndex));
+  for (size_t i = 0; i < kernels.size(); ++i)
+    densities(i, queryIndex) += kernels[i].Evaluate(d);
+
+  ++baseCases;
+  if (statistics)
+    statistics->RecordBaseCases();
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+  traversalInfo.LastBaseCase() = d;
+  return d;
+}
+
+//! Single-tree scoring function.
+template<typename DistanceType, typename KernelType, typename TreeType>
+inline double KDEMultiRules<DistanceType, KernelType, TreeType>::
+Score(const size_t queryIndex, TreeType& referenceNode)
+{
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  double score, minDistance, maxDistance;
+  // Calculations are not duplicated.
+  bool alreadyDidRefPoint0 = false;
+
+  if (TreeTraits<TreeType>::FirstPointIsCentroid &&
+      lastQueryIndex == queryIndex &&
+      traversalInfo.LastReferenceNode() != NULL &&
+      lastReferenceIndex == referenceNode.Point(0))
+  {
+    // Don't duplicate calculations.
+    alreadyDidRefPoint0 = true;
+    const double furthestDescDist = referenceNode.FurthestDescendantDistance();
+    minDistance = std::max(traversalInfo.LastBaseCase() - furthestDescDist,
+        0.0);
+    maxDistance = traversalInfo.LastBaseCase() + furthestDescDist;
+  }
+  else
+  {
+    // All Calculations are new.
+    const Range r = referenceNode.RangeDistance(querySet.unsafe_col(
+        queryIndex));
+    minDistance = r.Lo();
+    maxDistance = r.Hi();
+
+    // Check if we are a self-child.
+    if (TreeTraits<TreeType>::HasSelfChildren &&
+        referenceNode.Parent() != NULL &&
+        referenceNode.Parent()->Point(0) == referenceNode.Point(0))
+    {
+      alreadyDidRefPoint0 = true;
+    }
+  }
+
+  if (CanPrune(minDistance, maxDistance))
+  {
+    const size_t numPoints = alreadyDidRefPoint0 ? (refNumDesc - 1) :
+        refNumDesc;
+    densities.col(queryIndex) += numPoints * kernelValues;
+
+    // Don't explore this tree branch.
+    score = DBL_MAX;
+  }
+  else
+  {
+    score = minDistance;
+  }
+
+  ++scores;
+  if (statistics)
+    statistics->RecordScore(referenceNode, score);
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  traversalInfo.LastScore() = score;
+  return score;
+}
+
+//! Dual-tree scoring function.
+template<typename DistanceType, typename KernelType, typename TreeType>
+inline double KDEMultiRules<DistanceType, KernelType, TreeType>::
+Score(TreeType& queryNode, TreeType& referenceNode)
+{
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  double score, minDistance, maxDistance;
+  // Calculations are not duplicated.
+  bool alreadyDidRefPoint0 = false;
+
+  if (TreeTraits<TreeType>::FirstPointIsCentroid &&
+      (traversalInfo.LastQueryNode() != NULL) &&
+      (traversalInfo.LastReferenceNode() != NULL) &&
+      (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+      (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+  {
+    // Don't duplicate calculations.
+    alreadyDidRefPoint0 = true;
+    lastQueryIndex = queryNode.Point(0);
+    lastReferenceIndex = referenceNode.Point(0);
+
+    // Calculate min and max distance.
+    const double sumFurtDescDist = referenceNode.FurthestDescendantDistance() +
+        queryNode.FurthestDescendantDistance();
+    minDistance = std::max(traversalInfo.LastBaseCase() - sumFurtDescDist, 0.0);
+    maxDistance = traversalInfo.LastBaseCase() + sumFurtDescDist;
+  }
+  else
+  {
+    // All calculations are new.
+    const Range r = queryNode.RangeDistance(referenceNode);
+    minDistance = r.Lo();
+    maxDistance = r.Hi();
+  }
+
+  if (CanPrune(minDistance, maxDistance))
+  {
+    // Sum up estimations.
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    {
+      const size_t numPoints = (alreadyDidRefPoint0 && i == 0) ?
+          (refNumDesc - 1) : refNumDesc;
+      densities.col(queryNode.Descendant(i)) += numPoints * kernelValues;
+    }
+
+    // Prune.
+    score = DBL_MAX;
+  }
+  else
+  {
+    score = minDistance;
+  }
+
+  ++scores;
+  if (statistics)
+    statistics->RecordScore(queryNode, referenceNode, score);
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  traversalInfo.LastScore() = score;
+  return score;
+}
+
+template<typename DistanceType, typename KernelType, typename TreeType>
+inline bool KDEMultiRules<DistanceType, KernelType, TreeType>::CanPrune(
+    const double minDistance,
+    const double maxDistance)
+{
+  for (size_t i = 0; i < kernels.size(); ++i)
+  {
+    const double maxKernel = kernels[i].Evaluate(minDistance);
+    const double minKernel = kernels[i].Evaluate(maxDistance);
+
+    // This is the same condition as in KDERules, without any accumulated error
+    // tolerance.
+    if (maxKernel - minKernel > 2 * (absErrorTol + relError * minKernel))
+      return false;
+
+    kernelValues[i] = (maxKernel + minKernel) / 2.0;
+  }
+
+  return true;
+}
+
+} // namespace mlpack
+
+#endif
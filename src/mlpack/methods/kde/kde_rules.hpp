@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_KDE_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 namespace mlpack {
 
@@ -92,6 +93,11 @@ class KDERules
   //! Get the number of scores.
   size_t Scores() const { return scores; }
 
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
   //! Get the minimum number of base cases we need to perform to have acceptable
   //! results.
   size_t MinimumBaseCases() const { return 0; }
@@ -178,6 +184,9 @@ class KDERules
 
   //! The number of scores.
   size_t scores;
+
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
 };
 
 /**
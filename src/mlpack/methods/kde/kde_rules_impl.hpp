@@ -53,7 +53,8 @@ KDERules<DistanceType, KernelType, TreeType>::KDERules(
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL)
 {
   // Initialize accumError.
   accumError = arma::vec(querySet.n_cols);
@@ -89,6 +90,8 @@ double KDERules<DistanceType, KernelType, TreeType>::BaseCase(
   accumError(queryIndex) += 2 * relError * kernelValue;
 
   ++baseCases;
+  if (statistics)
+    statistics->RecordBaseCases();
   lastQueryIndex = queryIndex;
   lastReferenceIndex = referenceIndex;
   traversalInfo.LastBaseCase() = d;
@@ -285,6 +288,8 @@ Score(const size_t queryIndex, TreeType& referenceNode)
   }
 
   ++scores;
+  if (statistics)
+    statistics->RecordScore(referenceNode, score);
   traversalInfo.LastReferenceNode() = &referenceNode;
   traversalInfo.LastScore() = score;
   return score;
@@ -297,6 +302,8 @@ Rescore(const size_t /* queryIndex */,
         const double oldScore) const
 {
   // If it's pruned it continues to be pruned.
+  if (statistics)
+    statistics->RecordRescore(oldScore);
   return oldScore;
 }
 
@@ -506,6 +513,8 @@ Score(TreeType& queryNode, TreeType& referenceNode)
   }
 
   ++scores;
+  if (statistics)
+    statistics->RecordScore(queryNode, referenceNode, score);
   traversalInfo.LastQueryNode() = &queryNode;
   traversalInfo.LastReferenceNode() = &referenceNode;
   traversalInfo.LastScore() = score;
@@ -520,6 +529,8 @@ Rescore(TreeType& /*queryNode*/,
         const double oldScore) const
 {
   // If a branch is pruned then it continues to be pruned.
+  if (statistics)
+    statistics->RecordRescore(oldScore);
   return oldScore;
 }
 
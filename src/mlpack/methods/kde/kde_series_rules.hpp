@@ -0,0 +1,177 @@
+/**
+ * @file methods/kde/kde_series_rules.hpp
+ *
+ * Rules for Kernel Density Estimation with the Gaussian kernel that can also
+ * approximate node combinations with Hermite series expansions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_SERIES_RULES_HPP
+#define MLPACK_METHODS_KDE_SERIES_RULES_HPP
+
+#include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
+#include "hermite_expansion.hpp"
+
+namespace mlpack {
+
+/**
+ * A tree traversal Rules class for kernel density estimation with the Gaussian
+ * kernel and the Euclidean distance, in the spirit of the dual-tree fast Gauss
+ * transform.  Like KDERules, a combination of nodes is pruned if the kernel
+ * values can be approximated by the midpoint of their bounds.  When that is not
+ * accurate enough, the reference node can still be pruned if it has a
+ * HermiteExpansion (see KDEStat::ExpansionIndex()) whose truncation error bound
+ * is within the error tolerance of the reference points; the expansion is then
+ * evaluated at each query point, with the lowest order that is accurate enough.
+ * The error guarantees are therefore the same as for KDERules.  Unused error
+ * tolerance is not accumulated and Monte Carlo estimations are not available.
+ */
+template<typename TreeType>
+class KDESeriesRules
+{
+ public:
+  /**
+   * Construct KDESeriesRules.
+   *
+   * @param referenceSet Reference set data.
+   * @param querySet Query set data.
+   * @param densities Vector where estimations will be written.
+   * @param relError Relative error tolerance.
+   * @param absError Absolute error tolerance.
+   * @param kernel Instantiated kernel.
+   * @param expansions Series expansions of the reference nodes.
+   * @param sameSet True if query and reference sets are the same
+   *                (monochromatic evaluation).
+   */
+  KDESeriesRules(const arma::mat& referenceSet,
+                 const arma::mat& querySet,
+                 arma::vec& densities,
+                 const double relError,
+                 const double absError,
+                 const GaussianKernel& kernel,
+                 const std::vector<HermiteExpansion>& expansions,
+                 const bool sameSet);
+
+  //! Base Case.
+  double BaseCase(const size_t queryIndex, const size_t referenceIndex);
+
+  //! SingleTree Score.
+  double Score(const size_t queryIndex, TreeType& referenceNode);
+
+  //! SingleTree Rescore.
+  double Rescore(const size_t /* queryIndex */,
+                 TreeType& /* referenceNode */,
+                 const double oldScore) const
+  {
+    // If a branch is pruned then it continues to be pruned.
+    if (statistics)
+      statistics->RecordRescore(oldScore);
+    return oldScore;
+  }
+
+  //! Dual-Tree Score.
+  double Score(TreeType& queryNode, TreeType& referenceNode);
+
+  //! Dual-Tree Rescore.
+  double Rescore(TreeType& /* queryNode */,
+                 TreeType& /* referenceNode */,
+                 const double oldScore) const
+  {
+    // If a branch is pruned then it continues to be pruned.
+    if (statistics)
+      statistics->RecordRescore(oldScore);
+    return oldScore;
+  }
+
+  using TraversalInfoType = mlpack::TraversalInfo<TreeType>;
+
+  //! Get traversal information.
+  const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
+
+  //! Modify traversal information.
+  TraversalInfoType& TraversalInfo() { return traversalInfo; }
+
+  //! Get the number of base cases.
+  size_t BaseCases() const { return baseCases; }
+
+  //! Get the number of scores.
+  size_t Scores() const { return scores; }
+
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
+  //! Get the minimum number of base cases we need to perform to have acceptable
+  //! results.
+  size_t MinimumBaseCases() const { return 0; }
+
+ private:
+  /**
+   * Return the series expansion of the reference node if it exists and can
+   * approximate the kernels of its points within the given error tolerance for
+   * each reference point, and set order to the lowest order that can; return
+   * NULL otherwise.
+   */
+  const HermiteExpansion* ExpansionFor(const TreeType& referenceNode,
+                                       const double minDistance,
+                                       const double tolerance,
+                                       size_t& order) const;
+
+  //! The reference set.
+  const arma::mat& referenceSet;
+
+  //! The query set.
+  const arma::mat& querySet;
+
+  //! Density values.
+  arma::vec& densities;
+
+  //! Relatve error tolerance.
+  const double relError;
+
+  //! Instantiated kernel.
+  const GaussianKernel& kernel;
+
+  //! Series expansions of the reference nodes.
+  const std::vector<HermiteExpansion>& expansions;
+
+  //! Whether reference and query sets are the same.
+  const bool sameSet;
+
+  //! Absolute error tolerance available for each reference point.
+  const double absErrorTol;
+
+  //! Workspace for the evaluation of series expansions.
+  arma::mat hermiteValues;
+
+  //! The last query index.
+  size_t lastQueryIndex;
+
+  //! The last reference index.
+  size_t lastReferenceIndex;
+
+  //! Traversal information.
+  TraversalInfoType traversalInfo;
+
+  //! The number of base cases.
+  size_t baseCases;
+
+  //! The number of scores.
+  size_t scores;
+
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "kde_series_rules_impl.hpp"
+
+#endif
@@ -0,0 +1,278 @@
+/**
+ * @file methods/kde/kde_series_rules_impl.hpp
+ *
+ * Implementation of rules for Kernel Density Estimation with series
+ * expansions.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KDE_SERIES_RULES_IMPL_HPP
+#define MLPACK_METHODS_KDE_SERIES_RULES_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kde_series_rules.hpp"
+
+namespace mlpack {
+
+template<typename TreeType>
+KDESeriesRules<TreeType>::KDESeriesRules(
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    arma::vec& densities,
+    const double relError,
+    const double absError,
+    const GaussianKernel& kernel,
+    const std::vector<HermiteExpansion>& expansions,
+    const bool sameSet) :
+    referenceSet(referenceSet),
+    querySet(querySet),
+    densities(densities),
+    relError(relError),
+    kernel(kernel),
+    expansions(expansions),
+    sameSet(sameSet),
+    absErrorTol(absError / referenceSet.n_cols),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0),
+    statistics(NULL)
+{
+  // Nothing else to do.
+}
+
+//! The base case.
+template<typename TreeType>
+inline mlpack_force_inline
+double KDESeriesRules<TreeType>::BaseCase(
+    const size_t queryIndex,
+    const size_t referenceIndex)
+{
+  // If reference and query sets are the same we don't want to compute the
+  // estimation of a point with itself.
+  if (sameSet && (queryIndex == referenceIndex))
+    return 0.0;
+
+  // Avoid duplicated calculations.
+  if ((lastQueryIndex == queryIndex) && (lastReferenceIndex == referenceIndex))
+    return 0.0;
+
+  const double d = EuclideanDistance::Evaluate(querySet.col(queryIndex),
+      referenceSet.col(referenceIndex));
+  densities(queryIndex) += kernel.Evaluate(d);
+
+  ++baseCases;
+  if (statistics)
+    statistics->RecordBaseCases();
+  lastQueryIndex = queryIndex;
+  lastReferenceIndex = referenceIndex;
+  traversalInfo.LastBaseCase() = d;
+  return d;
+}
+
+//! Single-tree scoring function.
+template<typename TreeType>
+inline double KDESeriesRules<TreeType>::
+Score(const size_t queryIndex, TreeType& referenceNode)
+{
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  double score, minDistance, maxDistance;
+  // Calculations are not duplicated.
+  bool alreadyDidRefPoint0 = false;
+
+  if (TreeTraits<TreeType>::FirstPointIsCentroid &&
+      lastQueryIndex == queryIndex &&
+      traversalInfo.LastReferenceNode() != NULL &&
+      lastReferenceIndex == referenceNode.Point(0))
+  {
+    // Don't duplicate calculations.
+    alreadyDidRefPoint0 = true;
+    const double furthestDescDist = referenceNode.FurthestDescendantDistance();
+    minDistance = std::max(traversalInfo.LastBaseCase() - furthestDescDist,
+        0.0);
+    maxDistance = traversalInfo.LastBaseCase() + furthestDescDist;
+  }
+  else
+  {
+    // All Calculations are new.
+    const Range r = referenceNode.RangeDistance(querySet.unsafe_col(
+        queryIndex));
+    minDistance = r.Lo();
+    maxDistance = r.Hi();
+
+    // Check if we are a self-child.
+    if (TreeTraits<TreeType>::HasSelfChildren &&
+        referenceNode.Parent() != NULL &&
+        referenceNode.Parent()->Point(0) == referenceNode.Point(0))
+    {
+      alreadyDidRefPoint0 = true;
+    }
+  }
+
+  const double maxKernel = kernel.Evaluate(minDistance);
+  const double minKernel = kernel.Evaluate(maxDistance);
+  const double tolerance = absErrorTol + relError * minKernel;
+  size_t order;
+  const HermiteExpansion* expansion;
+
+  if (maxKernel - minKernel <= 2 * tolerance)
+  {
+    const size_t numPoints = alreadyDidRefPoint0 ? (refNumDesc - 1) :
+        refNumDesc;
+    densities(queryIndex) += numPoints * (maxKernel + minKernel) / 2.0;
+
+    // Don't explore this tree branch.
+    score = DBL_MAX;
+  }
+  else if ((expansion = ExpansionFor(referenceNode, minDistance, tolerance,
+      order)) != NULL)
+  {
+    densities(queryIndex) += expansion->Evaluate(querySet.unsafe_col(
+        queryIndex), order, hermiteValues);
+
+    // The expansion includes the first point, which was already computed.
+    if (alreadyDidRefPoint0)
+    {
+      densities(queryIndex) -= kernel.Evaluate(EuclideanDistance::Evaluate(
+          querySet.col(queryIndex), referenceSet.col(referenceNode.Point(0))));
+    }
+
+    score = DBL_MAX;
+  }
+  else
+  {
+    score = minDistance;
+  }
+
+  ++scores;
+  if (statistics)
+    statistics->RecordScore(referenceNode, score);
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  traversalInfo.LastScore() = score;
+  return score;
+}
+
+//! Dual-tree scoring function.
+template<typename TreeType>
+inline double KDESeriesRules<TreeType>::
+Score(TreeType& queryNode, TreeType& referenceNode)
+{
+  const size_t refNumDesc = referenceNode.NumDescendants();
+  double score, minDistance, maxDistance;
+  // Calculations are not duplicated.
+  bool alreadyDidRefPoint0 = false;
+
+  if (TreeTraits<TreeType>::FirstPointIsCentroid &&
+      (traversalInfo.LastQueryNode() != NULL) &&
+      (traversalInfo.LastReferenceNode() != NULL) &&
+      (traversalInfo.LastQueryNode()->Point(0) == queryNode.Point(0)) &&
+      (traversalInfo.LastReferenceNode()->Point(0) == referenceNode.Point(0)))
+  {
+    // Don't duplicate calculations.
+    alreadyDidRefPoint0 = true;
+    lastQueryIndex = queryNode.Point(0);
+    lastReferenceIndex = referenceNode.Point(0);
+
+    // Calculate min and max distance.
+    const double sumFurtDescDist = referenceNode.FurthestDescendantDistance() +
+        queryNode.FurthestDescendantDistance();
+    minDistance = std::max(traversalInfo.LastBaseCase() - sumFurtDescDist, 0.0);
+    maxDistance = traversalInfo.LastBaseCase() + sumFurtDescDist;
+  }
+  else
+  {
+    // All calculations are new.
+    const Range r = queryNode.RangeDistance(referenceNode);
+    minDistance = r.Lo();
+    maxDistance = r.Hi();
+  }
+
+  const double maxKernel = kernel.Evaluate(minDistance);
+  const double minKernel = kernel.Evaluate(maxDistance);
+  const double tolerance = absErrorTol + relError * minKernel;
+  size_t order;
+  const HermiteExpansion* expansion;
+
+  if (maxKernel - minKernel <= 2 * tolerance)
+  {
+    // Sum up estimations.
+    const double kernelValue = (maxKernel + minKernel) / 2.0;
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    {
+      const size_t numPoints = (alreadyDidRefPoint0 && i == 0) ?
+          (refNumDesc - 1) : refNumDesc;
+      densities(queryNode.Descendant(i)) += numPoints * kernelValue;
+    }
+
+    // Prune.
+    score = DBL_MAX;
+  }
+  else if ((expansion = ExpansionFor(referenceNode, minDistance, tolerance,
+      order)) != NULL)
+  {
+    for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+    {
+      const size_t queryIndex = queryNode.Descendant(i);
+      densities(queryIndex) += expansion->Evaluate(querySet.unsafe_col(
+          queryIndex), order, hermiteValues);
+    }
+
+    // The expansion includes the first reference point for the first query
+    // point, which was already computed.
+    if (alreadyDidRefPoint0)
+    {
+      densities(queryNode.Descendant(0)) -=
+          kernel.Evaluate(traversalInfo.LastBaseCase());
+    }
+
+    score = DBL_MAX;
+  }
+  else
+  {
+    score = minDistance;
+  }
+
+  ++scores;
+  if (statistics)
+    statistics->RecordScore(queryNode, referenceNode, score);
+  traversalInfo.LastQueryNode() = &queryNode;
+  traversalInfo.LastReferenceNode() = &referenceNode;
+  traversalInfo.LastScore() = score;
+  return score;
+}
+
+template<typename TreeType>
+inline const HermiteExpansion* KDESeriesRules<TreeType>::ExpansionFor(
+    const TreeType& referenceNode,
+    const double minDistance,
+    const double tolerance,
+    size_t& order) const
+{
+  const size_t index = referenceNode.Stat().ExpansionIndex();
+  if (index == SIZE_MAX)
+    return NULL;
+
+  // In the monochromatic case, a query point may be a descendant of the
+  // reference node, and the expansion would include the point itself.
+  if (sameSet && minDistance == 0.0)
+    return NULL;
+
+  // The truncation error bound holds for every query point, and it must not be
+  // larger than the error tolerance of all the reference points.
+  const HermiteExpansion& expansion = expansions[index];
+  const double maxError = referenceNode.NumDescendants() * tolerance;
+  for (order = 1; order <= expansion.Order(); ++order)
+  {
+    if (expansion.ErrorBound(order) <= maxError)
+      return &expansion;
+  }
+
+  return NULL;
+}
+
+} // namespace mlpack
+
+#endif
@@ -28,7 +28,8 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      expansionIndex(SIZE_MAX)
   { /* Nothing to do.*/ }
 
   //! Initialization for a fully initialized node.
@@ -37,7 +38,8 @@ class KDEStat
       mcBeta(0),
       mcAlpha(0),
       accumAlpha(0),
-      accumError(0)
+      accumError(0),
+      expansionIndex(SIZE_MAX)
   { /* Nothing to do. */ }
 
   //! Get accumulated Monte Carlo alpha of the node.
@@ -64,6 +66,13 @@ class KDEStat
   //! Modify Monte Carlo alpha of the node.
   inline double& MCAlpha() { return mcAlpha; }
 
+  //! Get the index of the series expansion of the node (SIZE_MAX if the node
+  //! has no series expansion).
+  inline size_t ExpansionIndex() const { return expansionIndex; }
+
+  //! Modify the index of the series expansion of the node.
+  inline size_t& ExpansionIndex() { return expansionIndex; }
+
   //! Serialize the statistic to/from an archive.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */)
@@ -86,6 +95,10 @@ class KDEStat
 
   //! Accumulated not used error tolerance in the current node.
   double accumError;
+
+  //! Index of the series expansion of the node, if it has one.  Series
+  //! expansions are computed for each evaluation, so this is not serialized.
+  size_t expansionIndex;
 };
 
 } // namespace mlpack
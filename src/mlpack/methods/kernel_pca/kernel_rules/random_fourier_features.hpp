@@ -0,0 +1,126 @@
+/**
+ * @file methods/kernel_pca/kernel_rules/random_fourier_features.hpp
+ *
+ * Use random Fourier features to approximate a shift-invariant kernel.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_FEATURES_HPP
+#define MLPACK_METHODS_KERNEL_PCA_RANDOM_FOURIER_FEATURES_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/gaussian_kernel.hpp>
+#include <mlpack/core/kernels/laplacian_kernel.hpp>
+
+namespace mlpack {
+
+/**
+ * Approximate kernel PCA with random Fourier features (Rahimi and Recht,
+ * "Random features for large-scale kernel machines", NIPS 2007).  Each point x
+ * is mapped to the features
+ *
+ * @f[
+ * z(x) = \sqrt{2 / D} \cos(W x + b),
+ * @f]
+ *
+ * where the D rows of W are drawn from the Fourier transform of the kernel and
+ * b is uniform on [0, 2 pi), so that z(x)^T z(y) approximates k(x, y).  PCA is
+ * then done on the (centered) features, with a D x D covariance matrix, so the
+ * time and memory are linear in the number of points, and no kernel matrix is
+ * ever built.
+ *
+ * Only shift-invariant kernels can be used: GaussianKernel (W is Gaussian)
+ * and LaplacianKernel (the rows of W are multivariate Cauchy).
+ *
+ * @tparam KernelType GaussianKernel or LaplacianKernel.
+ * @tparam NumFeatures Number of random features D; this is also the maximum
+ *     number of components that are found.
+ */
+template<typename KernelType, size_t NumFeatures = 500>
+class RandomFourierFeaturesKernelRule
+{
+ public:
+  /**
+   * Approximate the kernel matrix with random Fourier features, and find its
+   * eigenvectors.
+   *
+   * @param data Input data points.
+   * @param transformedData Matrix to output results into.
+   * @param eigval KPCA eigenvalues will be written to this vector.
+   * @param eigvec KPCA eigenvectors will be written to this matrix.
+   * @param * (rank) Rank to be used for matrix approximation (unused; the
+   *     rank is NumFeatures).
+   * @param kernel Kernel to be used for computation.
+   */
+  static void ApplyKernelMatrix(const arma::mat& data,
+                                arma::mat& transformedData,
+                                arma::vec& eigval,
+                                arma::mat& eigvec,
+                                const size_t /* rank */,
+                                KernelType kernel = KernelType())
+  {
+    arma::mat frequencies;
+    Frequencies(kernel, data.n_rows, frequencies);
+    const arma::vec phases = 2.0 * M_PI * arma::randu<arma::vec>(NumFeatures);
+
+    // The projections are a single matrix product; the cosines are then taken
+    // in parallel.
+    arma::mat features = frequencies * data;
+    const double scale = std::sqrt(2.0 / NumFeatures);
+    #pragma omp parallel for
+    for (size_t i = 0; i < features.n_cols; ++i)
+      features.col(i) = scale * arma::cos(features.col(i) + phases);
+
+    // Centering the features is the same as centering the approximate kernel
+    // matrix.
+    features.each_col() -= arma::mean(features, 1);
+
+    // Eigendecompose the covariance of the features, whose nonzero eigenvalues
+    // are those of the approximate kernel matrix.
+    const arma::mat covariance = arma::symmatu(features * features.t());
+    if (!arma::eig_sym(eigval, eigvec, covariance))
+    {
+      Log::Fatal << "Failed to construct the kernel matrix." << std::endl;
+    }
+
+    // Swap the eigenvalues since they are ordered backwards (we need largest
+    // to smallest).
+    for (size_t i = 0; i < floor(eigval.n_elem / 2.0); ++i)
+      eigval.swap_rows(i, (eigval.n_elem - 1) - i);
+
+    // Flip the coefficients to produce the same effect.
+    eigvec = arma::fliplr(eigvec);
+
+    transformedData = eigvec.t() * features;
+  }
+
+ private:
+  //! Draw the frequencies for the Gaussian kernel exp(-|x - y|^2 / (2 s^2)),
+  //! whose Fourier transform is a Gaussian with standard deviation 1 / s.
+  static void Frequencies(const GaussianKernel& kernel,
+                          const size_t dimensionality,
+                          arma::mat& frequencies)
+  {
+    frequencies = arma::randn<arma::mat>(NumFeatures, dimensionality) /
+        kernel.Bandwidth();
+  }
+
+  //! Draw the frequencies for the Laplacian kernel exp(-|x - y| / s), whose
+  //! Fourier transform is a multivariate Cauchy distribution: a Gaussian
+  //! vector divided by the absolute value of an independent standard normal.
+  static void Frequencies(const LaplacianKernel& kernel,
+                          const size_t dimensionality,
+                          arma::mat& frequencies)
+  {
+    frequencies = arma::randn<arma::mat>(NumFeatures, dimensionality) /
+        kernel.Bandwidth();
+    frequencies.each_col() /= arma::abs(arma::randn<arma::vec>(NumFeatures));
+  }
+};
+
+} // namespace mlpack
+
+#endif
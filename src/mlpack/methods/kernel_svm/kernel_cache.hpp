@@ -0,0 +1,137 @@
+/**
+ * @file methods/kernel_svm/kernel_cache.hpp
+ *
+ * A bounded-memory least-recently-used cache of the columns of a kernel
+ * matrix, for the SMO solver of KernelSVM.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_CACHE_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_CACHE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/kernels/kernel_block.hpp>
+
+#include <list>
+#include <unordered_map>
+
+namespace mlpack {
+
+/**
+ * KernelCache holds the most recently used columns K(., x_i) of the kernel
+ * matrix of a dataset, up to the given amount of memory; the least recently
+ * used column is discarded when a new one is needed.  A column is computed
+ * with the EvaluateBlock() method of the kernel (one matrix product) when the
+ * kernel has one and the data is dense, and otherwise by evaluating the kernel
+ * on each point in parallel.
+ *
+ * The diagonal of the kernel matrix is computed once, at construction.
+ *
+ * @tparam KernelType Type of kernel.
+ * @tparam MatType Type of data matrix.
+ */
+template<typename KernelType, typename MatType>
+class KernelCache
+{
+ public:
+  /**
+   * Create the cache for the given data and kernel; both must stay valid
+   * while the cache is used.  At least two columns are always cached.
+   *
+   * @param data Dataset (one point per column).
+   * @param kernel Kernel to evaluate.
+   * @param cacheSize Maximum size of the cached columns, in megabytes.
+   */
+  KernelCache(const MatType& data, KernelType& kernel, const double cacheSize) :
+      data(data),
+      kernel(kernel),
+      capacity(std::max(size_t(2), (size_t) (cacheSize * 1024 * 1024 /
+          (sizeof(double) * std::max(size_t(1), (size_t) data.n_cols))))),
+      evaluations(0)
+  {
+    diagonal.set_size(data.n_cols);
+    #pragma omp parallel for
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+      diagonal[i] = kernel.Evaluate(data.col(i), data.col(i));
+  }
+
+  /**
+   * Get column i of the kernel matrix, computing it if it isn't cached.  The
+   * returned reference stays valid until another column that isn't cached is
+   * requested after the next one.
+   */
+  const arma::vec& Column(const size_t i)
+  {
+    auto it = lookup.find(i);
+    if (it != lookup.end())
+    {
+      // Move the column to the front of the list: it is the most recently
+      // used.
+      columns.splice(columns.begin(), columns, it->second);
+      return it->second->second;
+    }
+
+    if (columns.size() == capacity)
+    {
+      // Reuse the memory of the least recently used column.
+      lookup.erase(columns.back().first);
+      columns.splice(columns.begin(), columns, std::prev(columns.end()));
+      columns.front().first = i;
+    }
+    else
+    {
+      columns.emplace_front(i, arma::vec());
+    }
+    lookup[i] = columns.begin();
+
+    arma::vec& column = columns.front().second;
+    if constexpr (HasEvaluateBlock<KernelType>::value &&
+        !arma::is_arma_sparse_type<MatType>::value)
+    {
+      KernelBlock(kernel, data, data.col(i), column);
+    }
+    else
+    {
+      column.set_size(data.n_cols);
+      #pragma omp parallel for
+      for (size_t j = 0; j < (size_t) data.n_cols; ++j)
+        column[j] = kernel.Evaluate(data.col(j), data.col(i));
+    }
+
+    ++evaluations;
+    return column;
+  }
+
+  //! Get the diagonal of the kernel matrix.
+  const arma::vec& Diagonal() const { return diagonal; }
+
+  //! Get the maximum number of cached columns.
+  size_t Capacity() const { return capacity; }
+
+  //! Get the number of columns that have been computed.
+  size_t Evaluations() const { return evaluations; }
+
+ private:
+  //! The dataset.
+  const MatType& data;
+  //! The kernel.
+  KernelType& kernel;
+  //! Maximum number of cached columns.
+  size_t capacity;
+  //! Cached columns, from the most recently used to the least recently used.
+  std::list<std::pair<size_t, arma::vec>> columns;
+  //! The position of each cached column in `columns`.
+  std::unordered_map<size_t,
+      typename std::list<std::pair<size_t, arma::vec>>::iterator> lookup;
+  //! The diagonal of the kernel matrix.
+  arma::vec diagonal;
+  //! Number of computed columns.
+  size_t evaluations;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,223 @@
+/**
+ * @file methods/kernel_svm/kernel_svm.hpp
+ *
+ * Definition of the KernelSVM class, a support vector machine with any mlpack
+ * kernel, trained with SMO.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_HPP
+
+#include <mlpack/core.hpp>
+
+#include "kernel_cache.hpp"
+#include "smo.hpp"
+
+namespace mlpack {
+
+/**
+ * The KernelSVM class implements a soft-margin support vector machine with any
+ * mlpack kernel (such as GaussianKernel or PolynomialKernel).  The dual problem
+ * is solved with SMO (see the SMO class), with an LRU cache of the columns of
+ * the kernel matrix whose size is bounded by `cacheSize` megabytes.  Kernel
+ * columns are computed in parallel (or with one matrix product, for kernels
+ * that have an EvaluateBlock() method).
+ *
+ * With more than two classes, one binary SVM is trained for each class against
+ * all the others, and a point is assigned to the class with the largest
+ * decision value.  All the binary SVMs share the same kernel cache, and the
+ * model stores the union of their support vectors.
+ *
+ * @code
+ * @article{cortes1995support,
+ *   title={Support-vector networks},
+ *   author={Cortes, C. and Vapnik, V.},
+ *   journal={Machine Learning},
+ *   volume={20},
+ *   number={3},
+ *   pages={273--297},
+ *   year={1995}
+ * }
+ * @endcode
+ *
+ * @tparam KernelType Type of kernel.
+ * @tparam MatType Type of data matrix.
+ */
+template<typename KernelType = GaussianKernel,
+         typename MatType = arma::mat>
+class KernelSVM
+{
+ public:
+  /**
+   * Create the SVM without training it.  Be sure to call Train() before
+   * Classify().
+   *
+   * @param c Soft-margin penalty of the points that violate the margin.
+   * @param kernel Instantiated kernel.
+   * @param tolerance Tolerance of the optimality conditions for convergence.
+   * @param cacheSize Maximum size of the kernel cache, in megabytes.
+   * @param shrinking If true, use the shrinking heuristic of SMO.
+   * @param maxIterations Maximum number of SMO iterations for each binary
+   *     SVM (0 means no limit).
+   */
+  KernelSVM(const double c = 1.0,
+            const KernelType& kernel = KernelType(),
+            const double tolerance = 1e-3,
+            const double cacheSize = 200.0,
+            const bool shrinking = true,
+            const size_t maxIterations = 0);
+
+  /**
+   * Train the SVM on the given data.
+   *
+   * @param data Training data (one point per column).
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   * @param c Soft-margin penalty of the points that violate the margin.
+   * @param kernel Instantiated kernel.
+   * @param tolerance Tolerance of the optimality conditions for convergence.
+   * @param cacheSize Maximum size of the kernel cache, in megabytes.
+   * @param shrinking If true, use the shrinking heuristic of SMO.
+   * @param maxIterations Maximum number of SMO iterations for each binary
+   *     SVM (0 means no limit).
+   */
+  KernelSVM(const MatType& data,
+            const arma::Row<size_t>& labels,
+            const size_t numClasses,
+            const double c = 1.0,
+            const KernelType& kernel = KernelType(),
+            const double tolerance = 1e-3,
+            const double cacheSize = 200.0,
+            const bool shrinking = true,
+            const size_t maxIterations = 0);
+
+  /**
+   * Train the SVM on the given data with the current parameters.  Training is
+   * not incremental: the previous model is discarded.
+   *
+   * @param data Training data (one point per column).
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes (at least 2).
+   */
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses);
+
+  /**
+   * Classify the given point.
+   *
+   * @param point Point to classify.
+   * @return Predicted class of the point.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Classify the given points.
+   *
+   * @param data Points to classify.
+   * @param predictions Vector to store the predicted classes in.
+   */
+  void Classify(const MatType& data, arma::Row<size_t>& predictions) const;
+
+  /**
+   * Classify the given points, and store the decision values of the binary
+   * SVMs: one row for two classes (positive for class 1), and one row per
+   * class otherwise.
+   *
+   * @param data Points to classify.
+   * @param predictions Vector to store the predicted classes in.
+   * @param scores Matrix to store the decision values in.
+   */
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& scores) const;
+
+  /**
+   * Compute the accuracy (in percent) of the model on the given points.
+   *
+   * @param data Points to classify.
+   * @param labels True labels of the points.
+   */
+  double ComputeAccuracy(const MatType& data,
+                         const arma::Row<size_t>& labels) const;
+
+  //! Get the soft-margin penalty.
+  double C() const { return c; }
+  //! Modify the soft-margin penalty.
+  double& C() { return c; }
+
+  //! Get the kernel.
+  const KernelType& Kernel() const { return kernel; }
+  //! Modify the kernel.
+  KernelType& Kernel() { return kernel; }
+
+  //! Get the tolerance for convergence.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for convergence.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the maximum size of the kernel cache, in megabytes.
+  double CacheSize() const { return cacheSize; }
+  //! Modify the maximum size of the kernel cache, in megabytes.
+  double& CacheSize() { return cacheSize; }
+
+  //! Get whether shrinking is used.
+  bool Shrinking() const { return shrinking; }
+  //! Modify whether shrinking is used.
+  bool& Shrinking() { return shrinking; }
+
+  //! Get the maximum number of SMO iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of SMO iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of classes of the trained model.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the support vectors (one per column).
+  const MatType& SupportVectors() const { return supportVectors; }
+  //! Get the coefficients y_i alpha_i of the support vectors (one column per
+  //! binary SVM).
+  const arma::mat& Coefficients() const { return coefficients; }
+  //! Get the biases of the binary SVMs.
+  const arma::vec& Biases() const { return biases; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Soft-margin penalty.
+  double c;
+  //! The kernel.
+  KernelType kernel;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Maximum size of the kernel cache, in megabytes.
+  double cacheSize;
+  //! Whether shrinking is used.
+  bool shrinking;
+  //! Maximum number of SMO iterations.
+  size_t maxIterations;
+
+  //! Number of classes of the trained model.
+  size_t numClasses;
+  //! Support vectors.
+  MatType supportVectors;
+  //! Coefficients of the support vectors, one column per binary SVM.
+  arma::mat coefficients;
+  //! Biases of the binary SVMs.
+  arma::vec biases;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "kernel_svm_impl.hpp"
+
+#endif
@@ -0,0 +1,205 @@
+/**
+ * @file methods/kernel_svm/kernel_svm_impl.hpp
+ *
+ * Implementation of the KernelSVM class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_KERNEL_SVM_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "kernel_svm.hpp"
+
+namespace mlpack {
+
+template<typename KernelType, typename MatType>
+KernelSVM<KernelType, MatType>::KernelSVM(const double c,
+                                          const KernelType& kernel,
+                                          const double tolerance,
+                                          const double cacheSize,
+                                          const bool shrinking,
+                                          const size_t maxIterations) :
+    c(c),
+    kernel(kernel),
+    tolerance(tolerance),
+    cacheSize(cacheSize),
+    shrinking(shrinking),
+    maxIterations(maxIterations),
+    numClasses(0)
+{
+  // Nothing to do.
+}
+
+template<typename KernelType, typename MatType>
+KernelSVM<KernelType, MatType>::KernelSVM(const MatType& data,
+                                          const arma::Row<size_t>& labels,
+                                          const size_t numClasses,
+                                          const double c,
+                                          const KernelType& kernel,
+                                          const double tolerance,
+                                          const double cacheSize,
+                                          const bool shrinking,
+                                          const size_t maxIterations) :
+    c(c),
+    kernel(kernel),
+    tolerance(tolerance),
+    cacheSize(cacheSize),
+    shrinking(shrinking),
+    maxIterations(maxIterations),
+    numClasses(0)
+{
+  Train(data, labels, numClasses);
+}
+
+template<typename KernelType, typename MatType>
+void KernelSVM<KernelType, MatType>::Train(const MatType& data,
+                                           const arma::Row<size_t>& labels,
+                                           const size_t numClasses)
+{
+  util::CheckSameSizes(data, labels, "KernelSVM::Train()");
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("KernelSVM::Train(): numClasses must be at "
+        "least 2!");
+  }
+  if (labels.n_elem > 0 && arma::max(labels) >= numClasses)
+  {
+    throw std::invalid_argument("KernelSVM::Train(): labels must be less "
+        "than numClasses!");
+  }
+  if (c <= 0.0)
+    throw std::invalid_argument("KernelSVM::Train(): C must be positive!");
+
+  this->numClasses = numClasses;
+
+  // The kernel matrix doesn't depend on the labels, so all the binary SVMs
+  // share the same cache.
+  KernelCache<KernelType, MatType> cache(data, kernel, cacheSize);
+  SMO<KernelCache<KernelType, MatType>> smo(cache, c, tolerance, shrinking,
+      maxIterations);
+
+  // With two classes, one SVM separates class 1 from class 0; otherwise, each
+  // class is separated from all the others.
+  const size_t numModels = (numClasses == 2) ? 1 : numClasses;
+  arma::mat allCoefficients(data.n_cols, numModels);
+  biases.set_size(numModels);
+  arma::vec y(data.n_cols);
+  arma::vec alpha;
+  for (size_t m = 0; m < numModels; ++m)
+  {
+    const size_t positiveClass = (numClasses == 2) ? 1 : m;
+    for (size_t i = 0; i < data.n_cols; ++i)
+      y[i] = (labels[i] == positiveClass) ? 1.0 : -1.0;
+
+    biases[m] = smo.Solve(y, alpha);
+    allCoefficients.col(m) = y % alpha;
+
+    Log::Info << "KernelSVM::Train(): binary SVM " << m << " converged after "
+        << smo.Iterations() << " iterations, with "
+        << arma::accu(alpha > 0.0) << " support vectors." << std::endl;
+  }
+
+  // Keep the points that are a support vector of any of the binary SVMs.
+  const arma::uvec supportIndices = arma::find(arma::any(
+      allCoefficients != 0.0, 1));
+  supportVectors = data.cols(supportIndices);
+  coefficients = allCoefficients.rows(supportIndices);
+
+  Log::Info << "KernelSVM::Train(): " << supportIndices.n_elem << " support "
+      << "vectors; " << cache.Evaluations() << " kernel columns computed."
+      << std::endl;
+}
+
+template<typename KernelType, typename MatType>
+template<typename VecType>
+size_t KernelSVM<KernelType, MatType>::Classify(const VecType& point) const
+{
+  arma::Row<size_t> predictions;
+  Classify(MatType(point), predictions);
+  return predictions[0];
+}
+
+template<typename KernelType, typename MatType>
+void KernelSVM<KernelType, MatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions) const
+{
+  arma::mat scores;
+  Classify(data, predictions, scores);
+}
+
+template<typename KernelType, typename MatType>
+void KernelSVM<KernelType, MatType>::Classify(
+    const MatType& data,
+    arma::Row<size_t>& predictions,
+    arma::mat& scores) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("KernelSVM::Classify(): the model has not "
+        "been trained!");
+  }
+  util::CheckSameDimensionality(data, supportVectors.n_rows,
+      "KernelSVM::Classify()");
+
+  // Compute the kernel between the support vectors and blocks of points, to
+  // bound the memory used.
+  const size_t blockSize = 1024;
+  scores.set_size(coefficients.n_cols, data.n_cols);
+  arma::mat kernels;
+  for (size_t begin = 0; begin < data.n_cols; begin += blockSize)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+    KernelBlock(kernel, supportVectors, data.cols(begin, end), kernels);
+    scores.cols(begin, end) = coefficients.t() * kernels;
+  }
+  scores.each_col() += biases;
+
+  if (numClasses == 2)
+  {
+    predictions = arma::conv_to<arma::Row<size_t>>::from(scores.row(0) > 0.0);
+  }
+  else
+  {
+    predictions = arma::conv_to<arma::Row<size_t>>::from(
+        arma::index_max(scores, 0));
+  }
+}
+
+template<typename KernelType, typename MatType>
+double KernelSVM<KernelType, MatType>::ComputeAccuracy(
+    const MatType& data,
+    const arma::Row<size_t>& labels) const
+{
+  util::CheckSameSizes(data, labels, "KernelSVM::ComputeAccuracy()");
+
+  arma::Row<size_t> predictions;
+  Classify(data, predictions);
+  return 100.0 * arma::accu(predictions == labels) / labels.n_elem;
+}
+
+template<typename KernelType, typename MatType>
+template<typename Archive>
+void KernelSVM<KernelType, MatType>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(c));
+  ar(CEREAL_NVP(kernel));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(cacheSize));
+  ar(CEREAL_NVP(shrinking));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(supportVectors));
+  ar(CEREAL_NVP(coefficients));
+  ar(CEREAL_NVP(biases));
+}
+
+} // namespace mlpack
+
+#endif
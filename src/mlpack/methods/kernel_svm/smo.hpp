@@ -0,0 +1,145 @@
+/**
+ * @file methods/kernel_svm/smo.hpp
+ *
+ * Definition of the SMO class, which solves the dual problem of a binary
+ * kernel support vector machine with sequential minimal optimization.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_SMO_HPP
+#define MLPACK_METHODS_KERNEL_SVM_SMO_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * SMO solves the dual of the binary soft-margin SVM,
+ *
+ * \f[
+ * \min_\alpha \frac{1}{2} \sum_{i,j} \alpha_i \alpha_j y_i y_j K(x_i, x_j) -
+ *     \sum_i \alpha_i \quad \textrm{s.t.} \quad 0 \le \alpha_i \le C,
+ *     \sum_i y_i \alpha_i = 0,
+ * \f]
+ *
+ * with labels y_i in {-1, +1}, as LIBSVM does: each iteration optimizes the
+ * pair of variables chosen by the second-order working set selection of Fan,
+ * Chen and Lin, and the gradient is updated with the two kernel columns of
+ * the pair.
+ *
+ * @code
+ * @article{fan2005working,
+ *   title={Working Set Selection Using Second Order Information for Training
+ *       Support Vector Machines},
+ *   author={Fan, R.-E. and Chen, P.-H. and Lin, C.-J.},
+ *   journal={Journal of Machine Learning Research},
+ *   volume={6},
+ *   pages={1889--1918},
+ *   year={2005}
+ * }
+ * @endcode
+ *
+ * With shrinking, the variables at a bound that are not expected to move are
+ * removed from the working set selection and the gradient updates every
+ * min(n, 1000) iterations; their gradient is reconstructed before the
+ * optimality of the whole problem is checked.
+ *
+ * @tparam CacheType Type of kernel column cache (see KernelCache).
+ */
+template<typename CacheType>
+class SMO
+{
+ public:
+  /**
+   * Create the solver.
+   *
+   * @param cache Cache of the kernel matrix columns of the dataset.
+   * @param c Upper bound of the dual variables (the soft-margin penalty).
+   * @param tolerance Tolerance of the maximal violating pair for convergence.
+   * @param shrinking If true, use the shrinking heuristic.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   */
+  SMO(CacheType& cache,
+      const double c,
+      const double tolerance,
+      const bool shrinking,
+      const size_t maxIterations);
+
+  /**
+   * Solve the dual problem for the given labels, and return the bias b of the
+   * decision function f(x) = sum_i y_i alpha_i K(x_i, x) + b.
+   *
+   * @param y Labels (-1 or +1) of the points.
+   * @param alpha Vector to store the dual variables in.
+   */
+  double Solve(const arma::vec& y, arma::vec& alpha);
+
+  //! Get the number of iterations of the last call to Solve().
+  size_t Iterations() const { return iterations; }
+
+ private:
+  /**
+   * Select the working set (i, j) among the active variables.  Returns false
+   * if the active variables are optimal.
+   */
+  bool SelectWorkingSet(size_t& i, size_t& j);
+
+  //! Optimize the pair (i, j), and update the gradient.
+  void Update(const size_t i, const size_t j);
+
+  //! Remove the variables that will stay at a bound from the active set.
+  void Shrink();
+
+  //! Compute the gradient of the inactive variables, and activate them all.
+  void ReconstructGradient();
+
+  //! Compute the bias of the decision function from the gradient.
+  double Bias() const;
+
+  //! Whether variable t is in I_up (it can move up in the direction y_t).
+  bool IsUp(const size_t t) const
+  { return ((*y)[t] > 0) ? (alpha[t] < c) : (alpha[t] > 0); }
+
+  //! Whether variable t is in I_low (it can move down in the direction y_t).
+  bool IsLow(const size_t t) const
+  { return ((*y)[t] > 0) ? (alpha[t] > 0) : (alpha[t] < c); }
+
+  //! Cache of the kernel columns.
+  CacheType& cache;
+  //! Upper bound of the dual variables.
+  double c;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Whether shrinking is used.
+  bool shrinking;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+
+  //! Labels of the current problem.
+  const arma::vec* y;
+  //! Dual variables.
+  arma::vec alpha;
+  //! Gradient of the dual objective (valid for the active variables).
+  arma::vec gradient;
+  //! Part of the gradient from the variables at the upper bound, C times
+  //! sum_{j : alpha_j = C} y_i y_j K(x_i, x_j).
+  arma::vec gradientBar;
+  //! Active variables first, then the shrunk ones.
+  std::vector<size_t> active;
+  //! Number of active variables.
+  size_t activeSize;
+  //! Whether the active set has been reset after shrinking began.
+  bool unshrunk;
+  //! Number of iterations of the last call to Solve().
+  size_t iterations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "smo_impl.hpp"
+
+#endif
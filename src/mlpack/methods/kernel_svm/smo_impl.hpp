@@ -0,0 +1,373 @@
+/**
+ * @file methods/kernel_svm/smo_impl.hpp
+ *
+ * Implementation of the SMO solver for binary kernel SVMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KERNEL_SVM_SMO_IMPL_HPP
+#define MLPACK_METHODS_KERNEL_SVM_SMO_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "smo.hpp"
+
+namespace mlpack {
+
+template<typename CacheType>
+SMO<CacheType>::SMO(CacheType& cache,
+                    const double c,
+                    const double tolerance,
+                    const bool shrinking,
+                    const size_t maxIterations) :
+    cache(cache),
+    c(c),
+    tolerance(tolerance),
+    shrinking(shrinking),
+    maxIterations(maxIterations),
+    y(NULL),
+    activeSize(0),
+    unshrunk(false),
+    iterations(0)
+{
+  // Nothing to do.
+}
+
+template<typename CacheType>
+double SMO<CacheType>::Solve(const arma::vec& yIn, arma::vec& alphaOut)
+{
+  const size_t n = yIn.n_elem;
+  y = &yIn;
+
+  // Start from alpha = 0, where the gradient is -1.
+  alpha.zeros(n);
+  gradient.set_size(n);
+  gradient.fill(-1.0);
+  gradientBar.zeros(n);
+  active.resize(n);
+  std::iota(active.begin(), active.end(), 0);
+  activeSize = n;
+  unshrunk = false;
+
+  size_t counter = std::min(n, size_t(1000));
+  for (iterations = 0; iterations != maxIterations; ++iterations)
+  {
+    if (shrinking && --counter == 0)
+    {
+      counter = std::min(n, size_t(1000));
+      Shrink();
+    }
+
+    size_t i, j;
+    if (!SelectWorkingSet(i, j))
+    {
+      // The active variables are optimal; check all of them.
+      if (activeSize == n)
+        break;
+
+      ReconstructGradient();
+      if (!SelectWorkingSet(i, j))
+        break;
+
+      counter = 1;
+    }
+
+    Update(i, j);
+  }
+
+  if (maxIterations != 0 && iterations == maxIterations)
+  {
+    Log::Warning << "SMO::Solve(): maximum number of iterations ("
+        << maxIterations << ") reached; the solution may not be optimal."
+        << std::endl;
+  }
+
+  ReconstructGradient();
+  alphaOut = alpha;
+  return Bias();
+}
+
+template<typename CacheType>
+bool SMO<CacheType>::SelectWorkingSet(size_t& i, size_t& j)
+{
+  // Choose i, the variable of I_up with the largest -y_i G_i.
+  double maxUp = -std::numeric_limits<double>::infinity();
+  i = SIZE_MAX;
+  for (size_t s = 0; s < activeSize; ++s)
+  {
+    const size_t t = active[s];
+    if (IsUp(t) && -(*y)[t] * gradient[t] >= maxUp)
+    {
+      maxUp = -(*y)[t] * gradient[t];
+      i = t;
+    }
+  }
+
+  if (i == SIZE_MAX)
+    return false;
+
+  // Choose j, the variable of I_low that decreases the objective the most
+  // when optimized with i, using second-order information.
+  const arma::vec& ki = cache.Column(i);
+  const arma::vec& diagonal = cache.Diagonal();
+  double maxLow = -std::numeric_limits<double>::infinity();
+  double minObjective = std::numeric_limits<double>::infinity();
+  j = SIZE_MAX;
+  for (size_t s = 0; s < activeSize; ++s)
+  {
+    const size_t t = active[s];
+    if (!IsLow(t))
+      continue;
+
+    const double yg = (*y)[t] * gradient[t];
+    maxLow = std::max(maxLow, yg);
+    const double gradientDiff = maxUp + yg;
+    if (gradientDiff > 0)
+    {
+      double quadratic = diagonal[i] + diagonal[t] - 2 * ki[t];
+      if (quadratic <= 0)
+        quadratic = 1e-12;
+
+      const double objective = -gradientDiff * gradientDiff / quadratic;
+      if (objective <= minObjective)
+      {
+        minObjective = objective;
+        j = t;
+      }
+    }
+  }
+
+  return (maxUp + maxLow >= tolerance && j != SIZE_MAX);
+}
+
+template<typename CacheType>
+void SMO<CacheType>::Update(const size_t i, const size_t j)
+{
+  const arma::vec& ki = cache.Column(i);
+  const arma::vec& kj = cache.Column(j);
+  const arma::vec& diagonal = cache.Diagonal();
+  const arma::vec& labels = *y;
+
+  const double oldAlphaI = alpha[i];
+  const double oldAlphaJ = alpha[j];
+  double quadratic = diagonal[i] + diagonal[j] - 2 * ki[j];
+  if (quadratic <= 0)
+    quadratic = 1e-12;
+
+  // Minimize along the line that keeps sum_i y_i alpha_i constant, and clip
+  // the pair to the box [0, C]^2.
+  if (labels[i] != labels[j])
+  {
+    const double delta = (-gradient[i] - gradient[j]) / quadratic;
+    const double diff = alpha[i] - alpha[j];
+    alpha[i] += delta;
+    alpha[j] += delta;
+
+    if (diff > 0)
+    {
+      if (alpha[j] < 0)
+      {
+        alpha[j] = 0;
+        alpha[i] = diff;
+      }
+      if (alpha[i] > c)
+      {
+        alpha[i] = c;
+        alpha[j] = c - diff;
+      }
+    }
+    else
+    {
+      if (alpha[i] < 0)
+      {
+        alpha[i] = 0;
+        alpha[j] = -diff;
+      }
+      if (alpha[j] > c)
+      {
+        alpha[j] = c;
+        alpha[i] = c + diff;
+      }
+    }
+  }
+  else
+  {
+    const double delta = (gradient[i] - gradient[j]) / quadratic;
+    const double sum = alpha[i] + alpha[j];
+    alpha[i] -= delta;
+    alpha[j] += delta;
+
+    if (sum > c)
+    {
+      if (alpha[i] > c)
+      {
+        alpha[i] = c;
+        alpha[j] = sum - c;
+      }
+      if (alpha[j] > c)
+      {
+        alpha[j] = c;
+        alpha[i] = sum - c;
+      }
+    }
+    else
+    {
+      if (alpha[j] < 0)
+      {
+        alpha[j] = 0;
+        alpha[i] = sum;
+      }
+      if (alpha[i] < 0)
+      {
+        alpha[i] = 0;
+        alpha[j] = sum;
+      }
+    }
+  }
+
+  // Update the gradient of the active variables, with
+  // Q_ti = y_t y_i K(x_t, x_i).
+  const double stepI = labels[i] * (alpha[i] - oldAlphaI);
+  const double stepJ = labels[j] * (alpha[j] - oldAlphaJ);
+  for (size_t s = 0; s < activeSize; ++s)
+  {
+    const size_t t = active[s];
+    gradient[t] += labels[t] * (stepI * ki[t] + stepJ * kj[t]);
+  }
+
+  // Keep the contribution of the variables at the upper bound up to date for
+  // all the variables, so that the gradient can be reconstructed.
+  if ((oldAlphaI >= c) != (alpha[i] >= c))
+  {
+    const double sign = (oldAlphaI >= c) ? -c : c;
+    gradientBar += (sign * labels[i]) * (labels % ki);
+  }
+  if ((oldAlphaJ >= c) != (alpha[j] >= c))
+  {
+    const double sign = (oldAlphaJ >= c) ? -c : c;
+    gradientBar += (sign * labels[j]) * (labels % kj);
+  }
+}
+
+template<typename CacheType>
+void SMO<CacheType>::Shrink()
+{
+  // The largest violations among the active variables.
+  double maxUp = -std::numeric_limits<double>::infinity();
+  double maxLow = -std::numeric_limits<double>::infinity();
+  for (size_t s = 0; s < activeSize; ++s)
+  {
+    const size_t t = active[s];
+    const double yg = (*y)[t] * gradient[t];
+    if (IsUp(t))
+      maxUp = std::max(maxUp, -yg);
+    if (IsLow(t))
+      maxLow = std::max(maxLow, yg);
+  }
+
+  // When the active variables are close to optimal, check all the variables
+  // once, in case some were shrunk too early.
+  if (!unshrunk && maxUp + maxLow <= 10 * tolerance)
+  {
+    unshrunk = true;
+    ReconstructGradient();
+  }
+
+  // A variable at a bound can be removed when it can't be part of a violating
+  // pair: it can only move in one direction, and no variable that can move in
+  // the other direction violates the optimality conditions with it.
+  size_t s = 0;
+  while (s < activeSize)
+  {
+    const size_t t = active[s];
+    const double yg = (*y)[t] * gradient[t];
+    bool shrink = false;
+    if (alpha[t] >= c || alpha[t] <= 0)
+    {
+      if (IsUp(t))
+        shrink = (yg > maxLow);
+      else
+        shrink = (-yg > maxUp);
+    }
+
+    if (shrink)
+      std::swap(active[s], active[--activeSize]);
+    else
+      ++s;
+  }
+}
+
+template<typename CacheType>
+void SMO<CacheType>::ReconstructGradient()
+{
+  const size_t n = active.size();
+  if (activeSize == n)
+    return;
+
+  // G_t = Gbar_t - 1 + sum_{j free} alpha_j y_t y_j K(x_t, x_j).
+  const arma::vec& labels = *y;
+  for (size_t s = activeSize; s < n; ++s)
+    gradient[active[s]] = gradientBar[active[s]] - 1;
+
+  for (size_t j = 0; j < n; ++j)
+  {
+    if (alpha[j] <= 0 || alpha[j] >= c)
+      continue;
+
+    const arma::vec& kj = cache.Column(j);
+    const double step = alpha[j] * labels[j];
+    for (size_t s = activeSize; s < n; ++s)
+    {
+      const size_t t = active[s];
+      gradient[t] += labels[t] * step * kj[t];
+    }
+  }
+
+  activeSize = n;
+}
+
+template<typename CacheType>
+double SMO<CacheType>::Bias() const
+{
+  // The bias is the average of -y_i G_i over the free variables; if there is
+  // none, it is the middle of the feasible interval.
+  double upper = std::numeric_limits<double>::infinity();
+  double lower = -std::numeric_limits<double>::infinity();
+  double sum = 0;
+  size_t numFree = 0;
+  for (size_t t = 0; t < alpha.n_elem; ++t)
+  {
+    const double yg = (*y)[t] * gradient[t];
+    if (alpha[t] > 0 && alpha[t] < c)
+    {
+      sum += yg;
+      ++numFree;
+    }
+    else if (IsUp(t))
+    {
+      upper = std::min(upper, yg);
+    }
+    else
+    {
+      lower = std::max(lower, yg);
+    }
+  }
+
+  double rho;
+  if (numFree > 0)
+    rho = sum / numFree;
+  else if (std::isinf(upper))
+    rho = lower;
+  else if (std::isinf(lower))
+    rho = upper;
+  else
+    rho = (upper + lower) / 2;
+
+  return -rho;
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,101 @@
+/**
+ * @file methods/kmeans/blas_kmeans.hpp
+ *
+ * An implementation of a step of the Lloyd algorithm for k-means that
+ * computes the distances between blocks of points and all centroids with
+ * matrix multiplications.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_BLAS_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_BLAS_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/threads.hpp>
+
+namespace mlpack {
+
+/**
+ * BlasKMeans is an implementation of a single iteration of Lloyd's algorithm,
+ * like NaiveKMeans, that finds the closest centroid of a whole block of points
+ * at once.  The squared distances between the points of a block and the
+ * centroids are computed with the expansion
+ *
+ *   ||x - c||^2 = ||x||^2 - 2 x^T c + ||c||^2,
+ *
+ * where the products x^T c for the whole block are given by one matrix
+ * multiplication (BLAS-3 GEMM), and ||x||^2 is not needed because it is the
+ * same for every centroid.  The blocks are sized so that a block and its
+ * distances fit in the L2 cache.  This is much faster than NaiveKMeans for
+ * high-dimensional data and many clusters; the results are the same, except
+ * that points almost equally close to two centroids may be assigned
+ * differently because of rounding.
+ *
+ * The blocked computation is only used for the Euclidean (or squared
+ * Euclidean) distance on dense data (arma::mat); otherwise, the distances are
+ * computed one at a time, as in NaiveKMeans.
+ *
+ * @tparam DistanceType Type of distance metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename DistanceType, typename MatType>
+class BlasKMeans
+{
+ public:
+  //! The size (in bytes) of the cache that the blocks are sized for.
+  static constexpr size_t CacheSize = 256 * 1024;
+
+  /**
+   * Construct the BlasKMeans object with the given dataset and distance
+   * metric.
+   *
+   * @param dataset Dataset.
+   * @param distance Instantiated distance metric.
+   */
+  BlasKMeans(const MatType& dataset, DistanceType& distance);
+
+  /**
+   * Run a single iteration of the Lloyd algorithm, updating the given centroids
+   * into the newCentroids matrix.  If any cluster is empty (that is, if any
+   * cluster has no points assigned to it), then the centroid associated with
+   * that cluster may be filled with invalid data (it will be corrected later).
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points in each cluster at the end of the iteration.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! Whether the blocked computation can be used for these types.
+  static constexpr bool UseBlocks = std::is_same_v<MatType, arma::mat> &&
+      (std::is_same_v<DistanceType, LMetric<2, true>> ||
+       std::is_same_v<DistanceType, LMetric<2, false>>);
+
+  //! Return the index of the closest centroid to the given point, computing
+  //! each distance separately.
+  template<typename VecType>
+  size_t ClosestCentroid(const VecType& point, const arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated distance metric.
+  DistanceType& distance;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "blas_kmeans_impl.hpp"
+
+#endif
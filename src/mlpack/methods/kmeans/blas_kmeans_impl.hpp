@@ -0,0 +1,148 @@
+/**
+ * @file methods/kmeans/blas_kmeans_impl.hpp
+ *
+ * Implementation of the blocked Lloyd iteration for k-means, which finds the
+ * closest centroids of a block of points with one matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_BLAS_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_BLAS_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "blas_kmeans.hpp"
+
+#include <mlpack/core/util/log.hpp>
+
+namespace mlpack {
+
+template<typename DistanceType, typename MatType>
+BlasKMeans<DistanceType, MatType>::BlasKMeans(const MatType& dataset,
+                                              DistanceType& distance) :
+    dataset(dataset),
+    distance(distance),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename DistanceType, typename MatType>
+double BlasKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
+                                                  arma::mat& newCentroids,
+                                                  arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // Each block holds its points and their products with every centroid, so
+  // that both fit in the cache together.
+  const size_t blockSize = std::max((size_t) 64, CacheSize /
+      (sizeof(double) * (centroids.n_rows + centroids.n_cols)));
+  const size_t numBlocks = (dataset.n_cols + blockSize - 1) / blockSize;
+
+  arma::rowvec centroidNorms;
+  if constexpr (UseBlocks)
+    centroidNorms = arma::sum(arma::square(centroids), 0);
+
+  // Each thread multiplies its blocks with BLAS, which must be
+  // single-threaded meanwhile.
+  ThreadBudget budget;
+  #pragma omp parallel
+  {
+    // The current state of the K-means is private for each thread.
+    arma::mat localCentroids(centroids.n_rows, centroids.n_cols);
+    arma::Col<size_t> localCounts(centroids.n_cols);
+    arma::mat products;
+
+    #pragma omp for schedule(static) nowait
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * blockSize;
+      const size_t end = std::min(begin + blockSize, (size_t) dataset.n_cols);
+
+      if constexpr (UseBlocks)
+      {
+        // The squared distance between point i and centroid j is
+        // ||x_i||^2 - 2 x_i^T c_j + ||c_j||^2; ||x_i||^2 is the same for every
+        // centroid, so it is not needed to find the closest one.
+        const arma::mat block(const_cast<double*>(dataset.colptr(begin)),
+            dataset.n_rows, end - begin, false, true);
+        products = centroids.t() * block;
+        products.each_col() -= 0.5 * centroidNorms.t();
+
+        for (size_t i = 0; i < block.n_cols; ++i)
+        {
+          const size_t closestCluster = products.col(i).index_max();
+          localCentroids.col(closestCluster) += block.col(i);
+          localCounts(closestCluster)++;
+        }
+      }
+      else
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          const size_t closestCluster = ClosestCentroid(dataset.col(i),
+              centroids);
+          localCentroids.col(closestCluster) += dataset.col(i);
+          localCounts(closestCluster)++;
+        }
+      }
+    }
+
+    // Combine calculated state from each thread.
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
+  }
+
+  // Now normalize the centroid.
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (counts(i) != 0)
+      newCentroids.col(i) /= counts(i);
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  #pragma omp parallel for reduction(+:cNorm) schedule(static)
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(distance.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+template<typename DistanceType, typename MatType>
+template<typename VecType>
+size_t BlasKMeans<DistanceType, MatType>::ClosestCentroid(
+    const VecType& point,
+    const arma::mat& centroids)
+{
+  double minDistance = std::numeric_limits<double>::infinity();
+  size_t closestCluster = centroids.n_cols; // Invalid value.
+
+  for (size_t j = 0; j < centroids.n_cols; ++j)
+  {
+    const double dist = distance.Evaluate(point, centroids.col(j));
+    if (dist < minDistance)
+    {
+      minDistance = dist;
+      closestCluster = j;
+    }
+  }
+
+  Log::Assert(closestCluster != centroids.n_cols);
+  return closestCluster;
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file methods/kmeans/brute_force_kmeans.hpp
+ *
+ * An implementation of a step of the Lloyd algorithm for k-means clustering
+ * with the Euclidean distance that computes the assignments and the new
+ * centroids with matrix products, so that the dataset may be held in any
+ * dense matrix type, including a Bandicoot matrix on a GPU.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_BRUTE_FORCE_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_BRUTE_FORCE_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/distances/lmetric.hpp>
+
+namespace mlpack {
+
+/**
+ * An implementation of a single iteration of Lloyd's algorithm for k-means
+ * with the Euclidean distance, in which all of the work on the dataset is
+ * done with two matrix products per block of points: one between the
+ * centroids and the points (to find the closest centroid of each point), and
+ * one between the points and a one-hot assignment matrix (to sum the points of
+ * each cluster).  Only these products use `MatType`; the assignments are
+ * found on the CPU, from one block of products at a time.
+ *
+ * So, with a Bandicoot matrix type (like `coot::fmat`), the dataset stays in
+ * GPU memory and only the centroids, the products of one block and the sums
+ * are copied between the host and the GPU.  Because KMeans itself (for
+ * initialization and empty cluster handling) needs an Armadillo matrix, with
+ * a Bandicoot matrix type this class is used directly:
+ *
+ * @code
+ * coot::fmat data(...);
+ * EuclideanDistance distance;
+ * BruteForceKMeans<EuclideanDistance, coot::fmat> step(data, distance);
+ * arma::mat centroids = ..., newCentroids;
+ * arma::Col<size_t> counts;
+ * for (size_t i = 0; i < 10; ++i)
+ * {
+ *   step.Iterate(centroids, newCentroids, counts);
+ *   centroids = newCentroids;
+ * }
+ * @endcode
+ *
+ * With Armadillo matrices it may also be used with KMeans as a drop-in
+ * replacement for NaiveKMeans or BlasKMeans.  Like NaiveKMeans, the centroid
+ * of an empty cluster is not normalized (it is handled later by KMeans).
+ *
+ * @tparam DistanceType Type of distance metric; it must be EuclideanDistance
+ *     or SquaredEuclideanDistance.
+ * @tparam MatType Type of dense matrix holding the dataset (e.g. arma::mat,
+ *     arma::fmat or coot::fmat).
+ */
+template<typename DistanceType, typename MatType>
+class BruteForceKMeans
+{
+ public:
+  static_assert(std::is_same_v<DistanceType, LMetric<2, true>> ||
+      std::is_same_v<DistanceType, LMetric<2, false>>,
+      "BruteForceKMeans can only be used with the Euclidean distance!");
+
+  //! The element type of the dataset.
+  using ElemType = typename MatType::elem_type;
+
+  //! Number of points of each block of the computation.
+  static constexpr size_t BlockSize = 4096;
+
+  /**
+   * Construct the BruteForceKMeans object with the given dataset and distance
+   * metric.
+   *
+   * @param dataset Dataset.
+   * @param distance Instantiated distance metric.
+   */
+  BruteForceKMeans(const MatType& dataset, DistanceType& distance);
+
+  /**
+   * Run a single iteration of the Lloyd algorithm, updating the given centroids
+   * into the newCentroids matrix.  If any cluster is empty (that is, if any
+   * cluster has no points assigned to it), then the centroid associated with
+   * that cluster may be filled with invalid data (it will be corrected later).
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points in each cluster at the end of the iteration.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated distance metric.
+  DistanceType& distance;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "brute_force_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * @file methods/kmeans/brute_force_kmeans_impl.hpp
+ *
+ * Implementation of BruteForceKMeans, a step of the Lloyd algorithm with
+ * matrix products.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_BRUTE_FORCE_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_BRUTE_FORCE_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "brute_force_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename DistanceType, typename MatType>
+BruteForceKMeans<DistanceType, MatType>::BruteForceKMeans(
+    const MatType& dataset,
+    DistanceType& distance) :
+    dataset(dataset),
+    distance(distance),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename DistanceType, typename MatType>
+double BruteForceKMeans<DistanceType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // Copy the centroids to the matrix type of the dataset (that is, to the GPU
+  // for a Bandicoot matrix).
+  const arma::Mat<ElemType> hostCentroids =
+      arma::conv_to<arma::Mat<ElemType>>::from(centroids);
+  const MatType deviceCentroids(hostCentroids);
+  const arma::Row<ElemType> centroidNorms =
+      arma::sum(arma::square(hostCentroids), 0);
+
+  arma::Mat<ElemType> productsBuffer, sumsBuffer;
+  arma::Col<size_t> assignments;
+  arma::Mat<ElemType> oneHot;
+  for (size_t begin = 0; begin < dataset.n_cols; begin += BlockSize)
+  {
+    const size_t end = std::min(begin + BlockSize, (size_t) dataset.n_cols);
+
+    // The squared distance between point i and centroid j is
+    // ||x_i||^2 - 2 x_i^T c_j + ||c_j||^2; ||x_i||^2 is the same for every
+    // centroid, so it is not needed to find the closest one.
+    const MatType deviceProducts = deviceCentroids.t() *
+        dataset.cols(begin, end - 1);
+    const arma::Mat<ElemType>& products = HostMatrix(deviceProducts,
+        productsBuffer);
+
+    assignments.set_size(end - begin);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < end - begin; ++i)
+    {
+      size_t closestCluster = 0;
+      ElemType minDistance = std::numeric_limits<ElemType>::infinity();
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const ElemType d = centroidNorms[j] - 2 * products(j, i);
+        if (d < minDistance)
+        {
+          minDistance = d;
+          closestCluster = j;
+        }
+      }
+      assignments[i] = closestCluster;
+    }
+
+    // The sum of the points of each cluster is the product of the points with
+    // the one-hot assignment matrix.
+    oneHot.zeros(end - begin, centroids.n_cols);
+    for (size_t i = 0; i < end - begin; ++i)
+    {
+      oneHot(i, assignments[i]) = 1;
+      counts[assignments[i]]++;
+    }
+
+    const MatType deviceSums = dataset.cols(begin, end - 1) *
+        MatType(oneHot);
+    newCentroids += arma::conv_to<arma::mat>::from(HostMatrix(deviceSums,
+        sumsBuffer));
+  }
+
+  // Now normalize the centroid.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+    if (counts(i) != 0)
+      newCentroids.col(i) /= counts(i);
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // Calculate cluster distortion for this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(distance.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,146 @@
+/**
+ * @file methods/kmeans/distributed_kmeans.hpp
+ *
+ * Definition of DistributedKMeans, which runs Lloyd's algorithm for k-means
+ * clustering on a dataset that is split across the ranks of a communicator
+ * (for instance, the processes of an MPI job).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/util/communicator.hpp>
+
+#include "naive_kmeans.hpp"
+
+#include <random>
+#include <set>
+
+namespace mlpack {
+
+/**
+ * DistributedKMeans clusters a dataset of which each rank of a communicator
+ * holds a part.  In each iteration, every rank runs one step of the given
+ * Lloyd step type on its points, and the sums of the points of each cluster
+ * and the number of points of each cluster are summed over all ranks with one
+ * AllReduceSum(); so, every rank has the same centroids after each iteration,
+ * and only O(k * d) values per rank are communicated.  The new centroids are
+ * the same as those of KMeans on the whole dataset, up to rounding.
+ *
+ * The centroid of a cluster that has no points is not moved (like with
+ * AllowEmptyClusters).  If no initial guess is given, the initial centroids
+ * are chosen at random among the points of all ranks.
+ *
+ * All ranks must call Cluster() with the same parameters.
+ *
+ * @code
+ * // With MPI (include <mpi.h> and define MLPACK_HAS_MPI before mlpack):
+ * MPICommunicator comm;
+ * arma::mat localData; // The points of this rank.
+ * DistributedKMeans<MPICommunicator> kmeans(comm);
+ * arma::mat centroids;
+ * arma::Row<size_t> assignments; // Of the points of this rank.
+ * kmeans.Cluster(localData, 10, assignments, centroids);
+ * @endcode
+ *
+ * @tparam CommunicatorType Type of communicator (e.g. LocalCommunicator or
+ *     MPICommunicator).
+ * @tparam DistanceType Type of distance metric.
+ * @tparam LloydStepType Lloyd step run on the points of each rank.  It must not
+ *     keep state between iterations (like NaiveKMeans, BlasKMeans and
+ *     BruteForceKMeans), because the centroids of the next iteration are the
+ *     global ones, not those it computed.
+ * @tparam MatType Type of matrix of the points.
+ */
+template<typename CommunicatorType,
+         typename DistanceType = EuclideanDistance,
+         template<class, class> class LloydStepType = NaiveKMeans,
+         typename MatType = arma::mat>
+class DistributedKMeans
+{
+ public:
+  /**
+   * Create the object.
+   *
+   * @param comm Communicator of the ranks.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param distance Distance metric.
+   */
+  DistributedKMeans(CommunicatorType& comm,
+                    const size_t maxIterations = 1000,
+                    const DistanceType distance = DistanceType());
+
+  /**
+   * Cluster the points of all ranks into k clusters, and get the centroids
+   * (the same on every rank).  This is a collective operation.
+   *
+   * @param data Points of this rank.
+   * @param k Number of clusters.
+   * @param centroids Matrix to store the centroids in.
+   * @param initialGuess If true, `centroids` holds the initial centroids (the
+   *     same on every rank).
+   */
+  void Cluster(const MatType& data,
+               const size_t k,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  /**
+   * Cluster the points of all ranks into k clusters, and get the centroids
+   * and the cluster of each point of this rank.  This is a collective
+   * operation.
+   *
+   * @param data Points of this rank.
+   * @param k Number of clusters.
+   * @param assignments Vector to store the cluster of each point of this rank
+   *     in.
+   * @param centroids Matrix to store the centroids in.
+   * @param initialGuess If true, `centroids` holds the initial centroids (the
+   *     same on every rank).
+   */
+  void Cluster(const MatType& data,
+               const size_t k,
+               arma::Row<size_t>& assignments,
+               arma::mat& centroids,
+               const bool initialGuess = false);
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the number of iterations of the last call to Cluster().
+  size_t Iterations() const { return iterations; }
+
+  //! Get the distance metric.
+  const DistanceType& Distance() const { return distance; }
+  //! Modify the distance metric.
+  DistanceType& Distance() { return distance; }
+
+ private:
+  //! Choose k random points among the points of all ranks.
+  void InitialCentroids(const MatType& data,
+                        const size_t k,
+                        arma::mat& centroids);
+
+  //! Communicator of the ranks.
+  CommunicatorType& comm;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Number of iterations of the last call to Cluster().
+  size_t iterations;
+  //! Distance metric.
+  DistanceType distance;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,229 @@
+/**
+ * @file methods/kmeans/distributed_kmeans_impl.hpp
+ *
+ * Implementation of DistributedKMeans.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_DISTRIBUTED_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename CommunicatorType,
+         typename DistanceType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+DistributedKMeans<CommunicatorType, DistanceType, LloydStepType, MatType>::
+DistributedKMeans(CommunicatorType& comm,
+                  const size_t maxIterations,
+                  const DistanceType distance) :
+    comm(comm),
+    maxIterations(maxIterations),
+    iterations(0),
+    distance(distance)
+{
+  // Nothing to do.
+}
+
+template<typename CommunicatorType,
+         typename DistanceType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<CommunicatorType, DistanceType, LloydStepType,
+    MatType>::Cluster(const MatType& data,
+                      const size_t k,
+                      arma::mat& centroids,
+                      const bool initialGuess)
+{
+  // Check that the ranks agree on the dimensionality.
+  std::vector<std::vector<size_t>> shapes;
+  comm.AllGather(std::vector<size_t>({ (size_t) data.n_cols,
+      (size_t) data.n_rows }), shapes);
+
+  size_t numPoints = 0, dimensionality = 0;
+  for (size_t r = 0; r < comm.Size(); ++r)
+  {
+    numPoints += shapes[r][0];
+    if (shapes[r][0] == 0)
+      continue;
+    if (dimensionality != 0 && shapes[r][1] != dimensionality)
+    {
+      throw std::invalid_argument("DistributedKMeans::Cluster(): the data of "
+          "the ranks have different dimensionalities (" +
+          std::to_string(dimensionality) + " and " +
+          std::to_string(shapes[r][1]) + ")!");
+    }
+    dimensionality = shapes[r][1];
+  }
+
+  if (k == 0 || k > numPoints)
+  {
+    throw std::invalid_argument("DistributedKMeans::Cluster(): the number "
+        "of clusters (" + std::to_string(k) + ") must be between 1 and the "
+        "number of points (" + std::to_string(numPoints) + ")!");
+  }
+
+  if (initialGuess)
+  {
+    if (centroids.n_cols != k || centroids.n_rows != dimensionality)
+    {
+      throw std::invalid_argument("DistributedKMeans::Cluster(): the initial "
+          "centroids must be a " + std::to_string(dimensionality) + "x" +
+          std::to_string(k) + " matrix!");
+    }
+  }
+  else
+  {
+    InitialCentroids(data, k, centroids);
+  }
+
+  LloydStepType<DistanceType, MatType> step(data, distance);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  arma::mat sums(dimensionality, k);
+  arma::Col<size_t> globalCounts(k);
+
+  iterations = 0;
+  double cNorm;
+  do
+  {
+    // Run the step on the points of this rank, and sum the clusters over all
+    // ranks.  Empty clusters may hold invalid data, so they are skipped.
+    if (data.n_cols > 0)
+    {
+      step.Iterate(centroids, newCentroids, counts);
+    }
+    else
+    {
+      newCentroids.zeros(dimensionality, k);
+      counts.zeros(k);
+    }
+
+    for (size_t i = 0; i < k; ++i)
+    {
+      if (counts[i] == 0)
+        sums.col(i).zeros();
+      else
+        sums.col(i) = newCentroids.col(i) * double(counts[i]);
+    }
+    globalCounts = counts;
+
+    comm.AllReduceSum(sums.memptr(), sums.n_elem);
+    comm.AllReduceSum(globalCounts.memptr(), globalCounts.n_elem);
+
+    // Every rank now has the same sums, so the same centroids.
+    cNorm = 0.0;
+    for (size_t i = 0; i < k; ++i)
+    {
+      if (globalCounts[i] == 0)
+        continue;
+
+      newCentroids.col(i) = sums.col(i) / double(globalCounts[i]);
+      cNorm += std::pow(distance.Evaluate(centroids.col(i),
+          newCentroids.col(i)), 2.0);
+      centroids.col(i) = newCentroids.col(i);
+    }
+    cNorm = std::sqrt(cNorm);
+
+    ++iterations;
+    Log::Info << "DistributedKMeans::Cluster(): iteration " << iterations
+        << ", residual " << cNorm << "." << std::endl;
+  } while (cNorm > 1e-5 && iterations != maxIterations);
+}
+
+template<typename CommunicatorType,
+         typename DistanceType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<CommunicatorType, DistanceType, LloydStepType,
+    MatType>::Cluster(const MatType& data,
+                      const size_t k,
+                      arma::Row<size_t>& assignments,
+                      arma::mat& centroids,
+                      const bool initialGuess)
+{
+  Cluster(data, k, centroids, initialGuess);
+
+  const MatType localCentroids = arma::conv_to<MatType>::from(centroids);
+  assignments.set_size(data.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = 0;
+    for (size_t j = 0; j < k; ++j)
+    {
+      const double d = distance.Evaluate(data.col(i), localCentroids.col(j));
+      if (d < minDistance)
+      {
+        minDistance = d;
+        closestCluster = j;
+      }
+    }
+
+    assignments[i] = closestCluster;
+  }
+}
+
+template<typename CommunicatorType,
+         typename DistanceType,
+         template<class, class> class LloydStepType,
+         typename MatType>
+void DistributedKMeans<CommunicatorType, DistanceType, LloydStepType,
+    MatType>::InitialCentroids(const MatType& data,
+                               const size_t k,
+                               arma::mat& centroids)
+{
+  // Rank 0 draws a seed, so that every rank chooses the same points.
+  std::vector<size_t> seed = { (comm.Rank() == 0) ?
+      (size_t) RandInt(std::numeric_limits<int>::max()) : (size_t) 0 };
+  comm.AllReduceSum(seed.data(), 1);
+
+  std::vector<std::vector<size_t>> sizes;
+  comm.AllGather(std::vector<size_t>({ (size_t) data.n_cols }), sizes);
+  size_t numPoints = 0, offset = 0;
+  for (size_t r = 0; r < comm.Size(); ++r)
+  {
+    if (r < comm.Rank())
+      offset += sizes[r][0];
+    numPoints += sizes[r][0];
+  }
+
+  // Choose k distinct points, by their global index.
+  std::mt19937_64 rng(seed[0]);
+  std::uniform_int_distribution<size_t> dist(0, numPoints - 1);
+  std::set<size_t> chosen;
+  while (chosen.size() < k)
+    chosen.insert(dist(rng));
+
+  // Each rank sends the chosen points it holds; they arrive sorted by global
+  // index.
+  std::vector<double> localPoints;
+  for (const size_t index : chosen)
+  {
+    if (index < offset || index >= offset + data.n_cols)
+      continue;
+
+    for (size_t d = 0; d < data.n_rows; ++d)
+      localPoints.push_back(data(d, index - offset));
+  }
+
+  std::vector<std::vector<double>> points;
+  comm.AllGather(localPoints, points);
+  std::vector<double> allPoints;
+  for (size_t r = 0; r < comm.Size(); ++r)
+    allPoints.insert(allPoints.end(), points[r].begin(), points[r].end());
+
+  centroids = arma::mat(allPoints.data(), allPoints.size() / k, k);
+}
+
+} // namespace mlpack
+
+#endif
@@ -18,6 +18,7 @@
 #include <mlpack/core/tree/binary_space_tree.hpp>
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/core/tree/cover_tree.hpp>
+#include <mlpack/core/tree/query_frontier.hpp>
 
 #include "dual_tree_kmeans_statistic.hpp"
 
@@ -101,7 +102,9 @@ class DualTreeKMeans
 
   arma::Row<size_t> assignments;
 
-  std::vector<bool> visited; // Was the point visited this iteration?
+  // Was the point visited this iteration?  This is not a std::vector<bool>,
+  // because different threads may set the flags of neighboring points.
+  std::vector<char> visited;
 
   arma::mat lastIterationCentroids; // For sanity checks.
 
@@ -118,6 +121,17 @@ class DualTreeKMeans
                   const double parentLowerBound = DBL_MAX,
                   const double adjustedParentLowerBound = 0.0);
 
+  //! Traverse the (coalesced) tree with the given rules.  If OpenMP is
+  //! available, disjoint subtrees of the tree are traversed in parallel.
+  template<typename RuleType>
+  void DualTreeTraversal(RuleType& rules, Tree& referenceTree);
+
+  //! Extract the centroids of the clusters from the whole tree.  If OpenMP is
+  //! available, disjoint subtrees of the tree are handled in parallel.
+  void ExtractCentroids(arma::mat& newCentroids,
+                        arma::Col<size_t>& newCounts,
+                        const arma::mat& centroids);
+
   //! Extract the centroids of the clusters.
   void ExtractCentroids(Tree& node,
                         arma::mat& newCentroids,
@@ -148,14 +148,11 @@ double DualTreeKMeans<DistanceType, MatType, TreeType>::Iterate(
       upperBounds, lowerBounds, distance, prunedPoints, oldFromNewCentroids,
       visited);
 
-  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
-      traverser(rules);
-
   CoalesceTree(*tree);
 
   // Set the number of pruned centroids in the root to 0.
   tree->Stat().Pruned() = 0;
-  traverser.Traverse(*tree, nns.ReferenceTree());
+  DualTreeTraversal(rules, nns.ReferenceTree());
   distanceCalculations += rules.BaseCases() + rules.Scores();
 
   DecoalesceTree(*tree);
@@ -163,7 +160,7 @@ double DualTreeKMeans<DistanceType, MatType, TreeType>::Iterate(
   // Now we need to extract the clusters.
   newCentroids.zeros(centroids.n_rows, centroids.n_cols);
   counts.zeros(centroids.n_cols);
-  ExtractCentroids(*tree, newCentroids, counts, centroids);
+  ExtractCentroids(newCentroids, counts, centroids);
 
   // Now, calculate how far the clusters moved, after normalizing them.
   double residual = 0.0;
@@ -195,6 +192,61 @@ double DualTreeKMeans<DistanceType, MatType, TreeType>::Iterate(
   return std::sqrt(residual);
 }
 
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void DualTreeKMeans<DistanceType, MatType, TreeType>::DualTreeTraversal(
+    RuleType& rules,
+    Tree& referenceTree)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Collect a few more subtrees than threads, so that the work can be
+    // balanced dynamically.
+    std::vector<Tree*> frontier;
+    QueryFrontier(*tree, 4 * numThreads, frontier);
+
+    // Each subtree is traversed as if it were the root of the tree, so no
+    // clusters are pruned for it yet.  Statically pruned subtrees are skipped
+    // by the traversal and keep their owner.
+    for (size_t i = 0; i < frontier.size(); ++i)
+      if (!frontier[i]->Stat().StaticPruned())
+        frontier[i]->Stat().Pruned() = 0;
+
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      // The subtrees hold disjoint sets of points, so the bounds and
+      // assignments of the points can be shared.
+      RuleType localRules(rules);
+      typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+          traverser(localRules);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+        traverser.Traverse(*frontier[i], referenceTree);
+
+      threadScores += localRules.Scores();
+      threadBaseCases += localRules.BaseCases();
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return;
+  }
+  #endif
+
+  typename Tree::template BreadthFirstDualTreeTraverser<RuleType>
+      traverser(rules);
+  traverser.Traverse(*tree, referenceTree);
+}
+
 template<typename DistanceType,
          typename MatType,
          template<typename TreeDistanceType,
@@ -408,6 +460,77 @@ void DualTreeKMeans<DistanceType, MatType, TreeType>::UpdateTree(
   }
 }
 
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void DualTreeKMeans<DistanceType, MatType, TreeType>::ExtractCentroids(
+    arma::mat& newCentroids,
+    arma::Col<size_t>& newCounts,
+    const arma::mat& centroids)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Split the tree into subtrees whose centroids can be extracted
+    // independently.  Nodes owned by a cluster are not split, and an internal
+    // node that is not owned holds no points of its own, so the subtrees give
+    // the same sums as the recursion from the root.
+    std::vector<Tree*> frontier(1, tree);
+    bool expanded = true;
+    while (expanded && frontier.size() < 4 * numThreads)
+    {
+      expanded = false;
+      std::vector<Tree*> nextLevel;
+      for (size_t i = 0; i < frontier.size(); ++i)
+      {
+        Tree* node = frontier[i];
+        const bool owned = (node->Stat().Pruned() == newCentroids.n_cols) ||
+            (node->Stat().StaticPruned() &&
+             node->Stat().Owner() < newCentroids.n_cols);
+        if (owned || node->NumChildren() == 0)
+        {
+          nextLevel.push_back(node);
+        }
+        else
+        {
+          for (size_t j = 0; j < node->NumChildren(); ++j)
+            nextLevel.push_back(&node->Child(j));
+          expanded = true;
+        }
+      }
+
+      frontier.swap(nextLevel);
+    }
+
+    #pragma omp parallel
+    {
+      // The sums are private for each thread.
+      arma::mat localCentroids(newCentroids.n_rows, newCentroids.n_cols,
+          arma::fill::zeros);
+      arma::Col<size_t> localCounts(newCentroids.n_cols, arma::fill::zeros);
+
+      #pragma omp for schedule(dynamic) nowait
+      for (size_t i = 0; i < frontier.size(); ++i)
+        ExtractCentroids(*frontier[i], localCentroids, localCounts, centroids);
+
+      // Combine calculated state from each thread.
+      #pragma omp critical
+      {
+        newCentroids += localCentroids;
+        newCounts += localCounts;
+      }
+    }
+
+    return;
+  }
+  #endif
+
+  ExtractCentroids(*tree, newCentroids, newCounts, centroids);
+}
+
 template<typename DistanceType,
          typename MatType,
          template<typename TreeDistanceType,
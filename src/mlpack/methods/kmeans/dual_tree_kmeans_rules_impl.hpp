@@ -26,7 +26,7 @@ DualTreeKMeansRules<DistanceType, TreeType>::DualTreeKMeansRules(
     DistanceType& distance,
     const std::vector<bool>& prunedPoints,
     const std::vector<size_t>& oldFromNewCentroids,
-    std::vector<bool>& visited) :
+    std::vector<char>& visited) :
     centroids(centroids),
     dataset(dataset),
     assignments(assignments),
@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_ELKAN_KMEANS_HPP
 
+#include "kmeans_point_distance.hpp"
+
 namespace mlpack {
 
 template<typename DistanceType, typename MatType>
@@ -42,6 +44,8 @@ class ElkanKMeans
   const MatType& dataset;
   //! The instantiated distance metric.
   DistanceType& distance;
+  //! Distances between the points and the current centroids.
+  KMeansPointDistance<DistanceType, MatType> pointDistance;
 
   //! Holds intra-cluster distances.
   arma::mat clusterDistances;
@@ -22,6 +22,7 @@ ElkanKMeans<DistanceType, MatType>::ElkanKMeans(const MatType& dataset,
                                                 DistanceType& distance) :
     dataset(dataset),
     distance(distance),
+    pointDistance(dataset, distance),
     distanceCalculations(0)
 {
   // Nothing to do here.
@@ -45,19 +46,29 @@ double ElkanKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
   // being the closest cluster centroid.
   clusterDistances.diag().fill(DBL_MAX);
 
+  // For sparse data, the distances between the points and the centroids only
+  // visit the nonzero elements of the points.
+  pointDistance.Centroids(centroids);
+
   // Initially set r(x) to true.
   std::vector<bool> mustRecalculate(dataset.n_cols, true);
 
-  // If this is the first iteration, we must reset all the bounds.
+  // If this is the first iteration, we must reset all the bounds.  They are
+  // filled in parallel with the same schedule as the bound updates below, so
+  // that on NUMA machines each thread's bounds are in its local memory.
   if (lowerBounds.n_rows != centroids.n_cols)
   {
     lowerBounds.set_size(centroids.n_cols, dataset.n_cols);
     assignments.set_size(dataset.n_cols);
     upperBounds.set_size(dataset.n_cols);
 
-    lowerBounds.fill(0);
-    upperBounds.fill(DBL_MAX);
-    assignments.fill(0);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      lowerBounds.col(i).zeros();
+      upperBounds(i) = DBL_MAX;
+      assignments(i) = 0;
+    }
   }
 
   // Step 1: for all centers, compute between-cluster distances.  For all
@@ -89,7 +100,7 @@ double ElkanKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
     {
       // No change needed.  This point must still belong to that cluster.
       counts(assignments[i])++;
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      AddPointToColumn(dataset, i, newCentroids, assignments[i]);
     }
     else
     {
@@ -112,8 +123,7 @@ double ElkanKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
         if (mustRecalculate[i])
         {
           mustRecalculate[i] = false;
-          dist = distance.Evaluate(dataset.col(i),
-                                   centroids.col(assignments[i]));
+          dist = pointDistance.Evaluate(i, assignments[i]);
           lowerBounds(assignments[i], i) = dist;
           upperBounds(i) = dist;
           distanceCalculations++;
@@ -135,8 +145,7 @@ double ElkanKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
             dist > 0.5 * clusterDistances(assignments[i], c))
         {
           // Compute d(x, c).  If d(x, c) < d(x, c(x)) then assign c(x) = c.
-          const double pointDist = distance.Evaluate(dataset.col(i),
-                                                     centroids.col(c));
+          const double pointDist = pointDistance.Evaluate(i, c);
           lowerBounds(c, i) = pointDist;
           distanceCalculations++;
           if (pointDist < dist)
@@ -150,7 +159,7 @@ double ElkanKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
       // At this point, we know the new cluster assignment.
       // Step 4: for each center c, let m(c) be the mean of the points
       // assigned to c.
-      newCentroids.col(assignments[i]) += arma::vec(dataset.col(i));
+      AddPointToColumn(dataset, i, newCentroids, assignments[i]);
       counts[assignments[i]]++;
     }
   }
@@ -169,7 +178,7 @@ double ElkanKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations++;
   }
 
-  #pragma omp parallel for
+  #pragma omp parallel for schedule(static)
   for (size_t i = 0; i < dataset.n_cols; ++i)
   {
     // Step 5: for each point x and center c, assign
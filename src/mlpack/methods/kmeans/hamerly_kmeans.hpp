@@ -12,6 +12,8 @@
 #ifndef MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 #define MLPACK_METHODS_KMEANS_HAMERLY_KMEANS_HPP
 
+#include "kmeans_point_distance.hpp"
+
 namespace mlpack {
 
 template<typename DistanceType, typename MatType>
@@ -43,6 +45,8 @@ class HamerlyKMeans
   const MatType& dataset;
   //! The instantiated distance metric.
   DistanceType& distance;
+  //! Distances between the points and the current centroids.
+  KMeansPointDistance<DistanceType, MatType> pointDistance;
 
   //! Minimum cluster distances from each cluster.
   arma::vec minClusterDistances;
@@ -22,6 +22,7 @@ HamerlyKMeans<DistanceType, MatType>::HamerlyKMeans(const MatType& dataset,
                                                     DistanceType& distance) :
     dataset(dataset),
     distance(distance),
+    pointDistance(dataset, distance),
     distanceCalculations(0)
 {
   // Nothing to do.
@@ -34,13 +35,21 @@ double HamerlyKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
 {
   size_t hamerlyPruned = 0;
 
-  // If this is the first iteration, we need to set all the bounds.
+  // If this is the first iteration, we need to set all the bounds.  They are
+  // filled in parallel with the same schedule as the loops over the points, so
+  // that on NUMA machines each thread's bounds are in its local memory.
   if (minClusterDistances.n_elem != centroids.n_cols)
   {
     upperBounds.set_size(dataset.n_cols);
-    upperBounds.fill(DBL_MAX);
-    lowerBounds.zeros(dataset.n_cols);
-    assignments.zeros(dataset.n_cols);
+    lowerBounds.set_size(dataset.n_cols);
+    assignments.set_size(dataset.n_cols);
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      upperBounds(i) = DBL_MAX;
+      lowerBounds(i) = 0;
+      assignments(i) = 0;
+    }
     minClusterDistances.set_size(centroids.n_cols);
   }
 
@@ -65,6 +74,10 @@ double HamerlyKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
     }
   }
 
+  // For sparse data, the distances between the points and the centroids only
+  // visit the nonzero elements of the points.
+  pointDistance.Centroids(centroids);
+
   #pragma omp parallel for reduction(+:hamerlyPruned, distanceCalculations) \
       reduction(matAdd:newCentroids) reduction(colAdd:counts) schedule(static)
   for (size_t i = 0; i < dataset.n_cols; ++i)
@@ -76,20 +89,19 @@ double HamerlyKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
     if (upperBounds(i) <= m)
     {
       ++hamerlyPruned;
-      newCentroids.col(assignments[i]) += dataset.col(i);
+      AddPointToColumn(dataset, i, newCentroids, assignments[i]);
       ++counts(assignments[i]);
       continue;
     }
 
     // Tighten upper bound.
-    upperBounds(i) = distance.Evaluate(dataset.col(i),
-                                       centroids.col(assignments[i]));
+    upperBounds(i) = pointDistance.Evaluate(i, assignments[i]);
     ++distanceCalculations;
 
     // Second bound test.
     if (upperBounds(i) <= m)
     {
-      newCentroids.col(assignments[i]) += dataset.col(i);
+      AddPointToColumn(dataset, i, newCentroids, assignments[i]);
       ++counts(assignments[i]);
       continue;
     }
@@ -103,7 +115,7 @@ double HamerlyKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
       if (c == assignments[i])
         continue;
 
-      const double dist = distance.Evaluate(dataset.col(i), centroids.col(c));
+      const double dist = pointDistance.Evaluate(i, c);
 
       // Is this a better cluster?  At this point, upperBounds[i] = d(i, c(i)).
       if (dist < upperBounds(i))
@@ -122,7 +134,7 @@ double HamerlyKMeans<DistanceType, MatType>::Iterate(const arma::mat& centroids,
     distanceCalculations += centroids.n_cols - 1;
 
     // Update new centroids.
-    newCentroids.col(assignments[i]) += dataset.col(i);
+    AddPointToColumn(dataset, i, newCentroids, assignments[i]);
     ++counts(assignments[i]);
   }
 
@@ -17,6 +17,7 @@
 // Include initialization strategies.
 #include "sample_initialization.hpp"
 #include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "random_partition.hpp"
 
 // Include empty cluster policies.
@@ -26,10 +27,15 @@
 
 // Include Lloyd step types.
 #include "naive_kmeans.hpp"
+#include "blas_kmeans.hpp"
+#include "brute_force_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
+#include "spherical_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 
 namespace mlpack {
 
@@ -216,4 +222,10 @@ class KMeans
 // afterwards.
 #include "refined_start.hpp"
 
+// StreamingKMeans clusters data that does not fit in memory.
+#include "streaming_kmeans.hpp"
+
+// DistributedKMeans clusters data that is split across processes.
+#include "distributed_kmeans.hpp"
+
 #endif // MLPACK_METHODS_KMEANS_KMEANS_HPP
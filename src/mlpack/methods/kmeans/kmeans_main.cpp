@@ -21,10 +21,15 @@
 #include "kill_empty_clusters.hpp"
 #include "refined_start.hpp"
 #include "kmeans_plus_plus_initialization.hpp"
+#include "kmeans_parallel_initialization.hpp"
 #include "elkan_kmeans.hpp"
 #include "hamerly_kmeans.hpp"
 #include "pelleg_moore_kmeans.hpp"
 #include "dual_tree_kmeans.hpp"
+#include "mini_batch_kmeans.hpp"
+#include "blas_kmeans.hpp"
+#include "spherical_kmeans.hpp"
+#include "yinyang_kmeans.hpp"
 
 using namespace mlpack;
 using namespace mlpack::util;
@@ -49,7 +54,10 @@ BINDING_LONG_DESC(
     "\n\n"
     "Optionally, the strategy to choose initial centroids can be specified.  "
     "The k-means++ algorithm can be used to choose initial centroids with "
-    "the " + PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter.  The "
+    "the " + PRINT_PARAM_STRING("kmeans_plus_plus") + " parameter, and the "
+    "scalable k-means|| algorithm, which needs far fewer passes over the data "
+    "when the number of clusters is large, can be used with the " +
+    PRINT_PARAM_STRING("kmeans_parallel") + " parameter.  The "
     "Bradley and Fayyad approach (\"Refining initial points for k-means "
     "clustering\", 1998) can be used to select initial points by specifying "
     "the " + PRINT_PARAM_STRING("refined_start") + " parameter.  This approach "
@@ -61,12 +69,22 @@ BINDING_LONG_DESC(
     "\n\n"
     "There are several options available for the algorithm used for each Lloyd "
     "iteration, specified with the " + PRINT_PARAM_STRING("algorithm") + " "
-    " option.  The standard O(kN) approach can be used ('naive').  Other "
+    " option.  The standard O(kN) approach can be used ('naive'), or the same "
+    "approach computing the distances for blocks of points with matrix "
+    "multiplications ('blas'), which is faster for high-dimensional data or "
+    "many clusters.  Other "
     "options include the Pelleg-Moore tree-based algorithm ('pelleg-moore'), "
     "Elkan's triangle-inequality based algorithm ('elkan'), Hamerly's "
-    "modification to Elkan's algorithm ('hamerly'), the dual-tree k-means "
-    "algorithm ('dualtree'), and the dual-tree k-means algorithm using the "
-    "cover tree ('dualtree-covertree')."
+    "modification to Elkan's algorithm ('hamerly'), Yinyang k-means "
+    "('yinyang'), which keeps one lower bound per group of centroids and uses "
+    "much less memory than Elkan's algorithm, the dual-tree k-means "
+    "algorithm ('dualtree'), the dual-tree k-means algorithm using the "
+    "cover tree ('dualtree-covertree'), and mini-batch k-means ('minibatch'), "
+    "which updates the centroids with a random sample of 1024 points in each "
+    "iteration; mini-batch k-means is much faster on large datasets, but the "
+    "centroids it finds are approximate.  Spherical k-means ('spherical') "
+    "instead clusters the points by their cosine similarity to unit-length "
+    "centroids, which is suited to text data."
     "\n\n"
     "The behavior for when an empty cluster is encountered can be modified with"
     " the " + PRINT_PARAM_STRING("allow_empty_clusters") + " option.  When "
@@ -155,10 +173,13 @@ PARAM_DOUBLE_IN("percentage", "Percentage of dataset to use for each refined "
     "start sampling (use when --refined_start is specified).", "p", 0.02);
 PARAM_FLAG("kmeans_plus_plus", "Use the k-means++ initialization strategy to "
     "choose initial points.", "K");
+PARAM_FLAG("kmeans_parallel", "Use the k-means|| (scalable k-means++) "
+    "initialization strategy to choose initial points.", "");
 
 PARAM_STRING_IN("algorithm", "Algorithm to use for the Lloyd iteration "
-    "('naive', 'pelleg-moore', 'elkan', 'hamerly', 'dualtree', or "
-    "'dualtree-covertree').", "a", "naive");
+    "('naive', 'blas', 'pelleg-moore', 'elkan', 'hamerly', 'yinyang', "
+    "'dualtree', "
+    "'dualtree-covertree', 'minibatch', or 'spherical').", "a", "naive");
 
 // Given the type of initial partition policy, figure out the empty cluster
 // policy and run k-means.
@@ -190,7 +211,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   else
     RandomSeed((size_t) std::time(NULL));
 
-  RequireOnlyOnePassed(params, { "refined_start", "kmeans_plus_plus" }, true,
+  RequireOnlyOnePassed(params, { "refined_start", "kmeans_plus_plus",
+      "kmeans_parallel" }, true,
       "Only one initialization strategy can be specified!", true);
 
   // Now, start building the KMeans type that we'll be using.  Start with the
@@ -214,6 +236,11 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     FindEmptyClusterPolicy<KMeansPlusPlusInitialization>(params, timers,
         KMeansPlusPlusInitialization());
   }
+  else if (params.Has("kmeans_parallel"))
+  {
+    FindEmptyClusterPolicy<KMeansParallelInitialization>(params, timers,
+        KMeansParallelInitialization());
+  }
   else
   {
     FindEmptyClusterPolicy<SampleInitialization>(params, timers,
@@ -260,7 +287,9 @@ void FindLloydStepType(util::Params& params,
                        const InitialPartitionPolicy& ipp)
 {
   RequireParamInSet<string>(params, "algorithm", { "elkan", "hamerly",
-      "pelleg-moore", "dualtree", "dualtree-covertree", "naive" }, true,
+      "yinyang", "pelleg-moore", "dualtree", "dualtree-covertree", "naive",
+      "blas", "minibatch", "spherical" },
+      true,
       "unknown k-means algorithm");
 
   const string algorithm = params.Get<string>("algorithm");
@@ -274,6 +303,11 @@ void FindLloydStepType(util::Params& params,
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, HamerlyKMeans>(
         params, timers, ipp);
   }
+  else if (algorithm == "yinyang")
+  {
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, YinyangKMeans>(
+        params, timers, ipp);
+  }
   else if (algorithm == "pelleg-moore")
   {
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy,
@@ -294,6 +328,21 @@ void FindLloydStepType(util::Params& params,
     RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, NaiveKMeans>(params,
         timers, ipp);
   }
+  else if (algorithm == "blas")
+  {
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, BlasKMeans>(params,
+        timers, ipp);
+  }
+  else if (algorithm == "minibatch")
+  {
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, MiniBatchKMeans>(
+        params, timers, ipp);
+  }
+  else if (algorithm == "spherical")
+  {
+    RunKMeans<InitialPartitionPolicy, EmptyClusterPolicy, SphericalKMeans>(
+        params, timers, ipp);
+  }
 }
 
 // Given the template parameters, sanitize/load input and run k-means.
@@ -0,0 +1,279 @@
+/**
+ * @file methods/kmeans/kmeans_parallel_initialization.hpp
+ *
+ * This file implements the k-means|| (scalable k-means++) initialization
+ * strategy.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_PARALLEL_INITIALIZATION_HPP
+
+#include <mlpack/core.hpp>
+
+#include "kmeans_plus_plus_initialization.hpp"
+
+namespace mlpack {
+
+/**
+ * This class implements the k-means|| initialization, as described in the
+ * following paper:
+ *
+ * @code
+ * @article{bahmani2012scalable,
+ *   title={Scalable k-means++},
+ *   author={Bahmani, Bahman and Moseley, Benjamin and Vattani, Andrea and
+ *       Kumar, Ravi and Vassilvitskii, Sergei},
+ *   journal={Proceedings of the VLDB Endowment},
+ *   volume={5},
+ *   number={7},
+ *   pages={622--633},
+ *   year={2012}
+ * }
+ * @endcode
+ *
+ * k-means++ needs k passes over the data, one for each centroid, which is slow
+ * when k is large.  Instead, k-means|| starts with one random point and runs a
+ * small number of rounds; in each round, every point is sampled independently
+ * with probability proportional to its squared distance to the closest point
+ * sampled so far, so that about `oversampling * k` points are sampled per
+ * round.  The sampled points are then weighted by the number of points closest
+ * to them, and are clustered into k centroids with weighted k-means++ and a few
+ * weighted Lloyd iterations.  Each pass over the data is done in parallel.
+ *
+ * In accordance with mlpack's InitialPartitionPolicy template type, we only
+ * need to implement a constructor and a method to compute the initial
+ * centroids.
+ */
+class KMeansParallelInitialization
+{
+ public:
+  /**
+   * Create the KMeansParallelInitialization object.
+   *
+   * @param oversampling Expected number of points sampled in each round, as a
+   *     multiple of the number of clusters.
+   * @param rounds Number of sampling rounds; if 0, ceil(log(N)) rounds are
+   *     used for a dataset with N points.
+   * @param lloydIterations Maximum number of weighted Lloyd iterations used to
+   *     recluster the sampled points.
+   */
+  KMeansParallelInitialization(const double oversampling = 2.0,
+                               const size_t rounds = 0,
+                               const size_t lloydIterations = 10) :
+      oversampling(oversampling),
+      rounds(rounds),
+      lloydIterations(lloydIterations)
+  { }
+
+  /**
+   * Initialize the centroids matrix with the k-means|| algorithm.
+   *
+   * @param data Dataset.
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  void Cluster(const MatType& data,
+               const size_t clusters,
+               arma::mat& centroids)
+  {
+    if (data.n_cols == 0)
+      throw std::invalid_argument("KMeansParallelInitialization::Cluster(): "
+          "dataset is empty");
+
+    // The first candidate is sampled uniformly.
+    std::vector<size_t> candidates(1, RandInt(0, data.n_cols));
+
+    // The squared distance between each point and its closest candidate, and
+    // the index of that candidate.
+    arma::vec minDistances(data.n_cols);
+    minDistances.fill(std::numeric_limits<double>::max());
+    arma::Col<size_t> closest(data.n_cols);
+    double cost = UpdateDistances(data, candidates, 0, minDistances, closest);
+
+    const size_t numRounds = (rounds > 0) ? rounds :
+        std::max((size_t) 1, (size_t) std::ceil(std::log(data.n_cols)));
+    const double expectedSamples = oversampling * clusters;
+    for (size_t r = 0; r < numRounds && cost > 0.0; ++r)
+    {
+      // Sample each point independently, with probability proportional to its
+      // squared distance to the closest candidate.
+      std::vector<size_t> sampled;
+      #pragma omp parallel
+      {
+        std::vector<size_t> localSampled;
+
+        #pragma omp for schedule(static) nowait
+        for (size_t p = 0; p < (size_t) data.n_cols; ++p)
+        {
+          if (Random() < expectedSamples * minDistances[p] / cost)
+            localSampled.push_back(p);
+        }
+
+        #pragma omp critical
+        sampled.insert(sampled.end(), localSampled.begin(),
+            localSampled.end());
+      }
+
+      // The order of the candidates should not depend on the threads.
+      std::sort(sampled.begin(), sampled.end());
+      const size_t oldCandidates = candidates.size();
+      candidates.insert(candidates.end(), sampled.begin(), sampled.end());
+      cost = UpdateDistances(data, candidates, oldCandidates, minDistances,
+          closest);
+
+      Log::Info << "KMeansParallelInitialization::Cluster(): round " << (r + 1)
+          << " sampled " << sampled.size() << " points." << std::endl;
+    }
+
+    // If too few points were sampled (which only happens if the dataset has
+    // fewer than k distinct points), add random points.
+    while (candidates.size() < clusters)
+      candidates.push_back(RandInt(0, data.n_cols));
+
+    // Weight each candidate by the number of points closest to it.
+    arma::vec weights(candidates.size(), arma::fill::zeros);
+    for (size_t p = 0; p < data.n_cols; ++p)
+      weights[closest[p]] += 1.0;
+
+    arma::mat candidatePoints(data.n_rows, candidates.size());
+    for (size_t i = 0; i < candidates.size(); ++i)
+      candidatePoints.col(i) = arma::vec(data.col(candidates[i]));
+    Recluster(candidatePoints, weights, clusters, centroids);
+  }
+
+  //! Get the expected number of points sampled per round, as a multiple of the
+  //! number of clusters.
+  double Oversampling() const { return oversampling; }
+  //! Modify the expected number of points sampled per round, as a multiple of
+  //! the number of clusters.
+  double& Oversampling() { return oversampling; }
+
+  //! Get the number of sampling rounds (0 means ceil(log(N))).
+  size_t Rounds() const { return rounds; }
+  //! Modify the number of sampling rounds (0 means ceil(log(N))).
+  size_t& Rounds() { return rounds; }
+
+  //! Get the maximum number of Lloyd iterations used for reclustering.
+  size_t LloydIterations() const { return lloydIterations; }
+  //! Modify the maximum number of Lloyd iterations used for reclustering.
+  size_t& LloydIterations() { return lloydIterations; }
+
+  //! Serialize the object.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(oversampling));
+    ar(CEREAL_NVP(rounds));
+    ar(CEREAL_NVP(lloydIterations));
+  }
+
+ private:
+  /**
+   * Update the squared distance between each point and its closest candidate
+   * with the candidates from index `begin` on, and return the sum of the
+   * squared distances.
+   */
+  template<typename MatType>
+  static double UpdateDistances(const MatType& data,
+                                const std::vector<size_t>& candidates,
+                                const size_t begin,
+                                arma::vec& minDistances,
+                                arma::Col<size_t>& closest)
+  {
+    double cost = 0.0;
+    #pragma omp parallel for schedule(static) reduction(+:cost)
+    for (size_t p = 0; p < (size_t) data.n_cols; ++p)
+    {
+      for (size_t c = begin; c < candidates.size(); ++c)
+      {
+        const double distance = SquaredEuclideanDistance::Evaluate(
+            data.col(p), data.col(candidates[c]));
+        if (distance < minDistances[p])
+        {
+          minDistances[p] = distance;
+          closest[p] = c;
+        }
+      }
+
+      cost += minDistances[p];
+    }
+
+    return cost;
+  }
+
+  /**
+   * Cluster the weighted candidates into the given number of centroids, with
+   * weighted k-means++ followed by weighted Lloyd iterations.
+   */
+  void Recluster(const arma::mat& candidates,
+                 const arma::vec& weights,
+                 const size_t clusters,
+                 arma::mat& centroids) const
+  {
+    KMeansPlusPlusInitialization::Cluster(candidates, weights, clusters,
+        centroids);
+
+    arma::Row<size_t> assignments(candidates.n_cols);
+    assignments.fill(clusters); // Invalid value.
+    for (size_t iteration = 0; iteration < lloydIterations; ++iteration)
+    {
+      size_t changed = 0;
+      #pragma omp parallel for schedule(static) reduction(+:changed)
+      for (size_t i = 0; i < (size_t) candidates.n_cols; ++i)
+      {
+        double minDistance = std::numeric_limits<double>::infinity();
+        size_t closestCluster = clusters;
+        for (size_t j = 0; j < clusters; ++j)
+        {
+          const double distance = SquaredEuclideanDistance::Evaluate(
+              candidates.col(i), centroids.col(j));
+          if (distance < minDistance)
+          {
+            minDistance = distance;
+            closestCluster = j;
+          }
+        }
+
+        if (assignments[i] != closestCluster)
+        {
+          assignments[i] = closestCluster;
+          ++changed;
+        }
+      }
+
+      if (changed == 0)
+        break;
+
+      // Move each centroid to the weighted mean of its candidates; a centroid
+      // with no candidates stays where it is.
+      arma::mat sums(centroids.n_rows, clusters, arma::fill::zeros);
+      arma::vec totalWeights(clusters, arma::fill::zeros);
+      for (size_t i = 0; i < candidates.n_cols; ++i)
+      {
+        sums.col(assignments[i]) += weights[i] * candidates.col(i);
+        totalWeights[assignments[i]] += weights[i];
+      }
+
+      for (size_t j = 0; j < clusters; ++j)
+        if (totalWeights[j] > 0.0)
+          centroids.col(j) = sums.col(j) / totalWeights[j];
+    }
+  }
+
+  //! The expected number of points sampled per round, as a multiple of the
+  //! number of clusters.
+  double oversampling;
+  //! The number of sampling rounds (0 means ceil(log(N))).
+  size_t rounds;
+  //! The maximum number of Lloyd iterations used for reclustering.
+  size_t lloydIterations;
+};
+
+} // namespace mlpack
+
+#endif
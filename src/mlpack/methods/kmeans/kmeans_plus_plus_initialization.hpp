@@ -54,56 +54,75 @@ class KMeansPlusPlusInitialization
   inline static void Cluster(const MatType& data,
                              const size_t clusters,
                              arma::mat& centroids)
+  {
+    Cluster(data, arma::vec(), clusters, centroids);
+  }
+
+  /**
+   * Initialize the centroids matrix by randomly sampling points from the data
+   * matrix, where each point has the given weight: the probability of sampling
+   * a point is proportional to its weight times its squared distance to the
+   * closest centroid chosen so far.  If the weights are empty, every point has
+   * weight 1.
+   *
+   * @param data Dataset.
+   * @param weights Weight of each point (or an empty vector).
+   * @param clusters Number of clusters.
+   * @param centroids Matrix to put initial centroids into.
+   */
+  template<typename MatType>
+  inline static void Cluster(const MatType& data,
+                             const arma::vec& weights,
+                             const size_t clusters,
+                             arma::mat& centroids)
   {
     centroids.set_size(data.n_rows, clusters);
 
-    // We'll sample our first point fully randomly.
-    size_t firstPoint = RandInt(0, data.n_cols);
+    // We'll sample our first point fully randomly (or according to the
+    // weights).
+    const size_t firstPoint = weights.is_empty() ? RandInt(0, data.n_cols) :
+        Sample(weights);
     centroids.col(0) = data.col(firstPoint);
 
-    // Utility variable.
-    arma::vec distribution(data.n_cols);
+    // The squared distance between each point and its closest already-chosen
+    // centroid.  Only the newest centroid can change it, so each iteration
+    // takes O(N) distance computations, which are done in parallel.
+    arma::vec minDistances(data.n_cols);
+    minDistances.fill(std::numeric_limits<double>::max());
 
     // Now, sample other points...
     for (size_t i = 1; i < clusters; ++i)
     {
-      // We must compute the CDF for sampling... this depends on the computation
-      // of the minimum distance between each point and its closest
-      // already-chosen centroid.
-      //
-      // This computation is ripe for speedup with trees!  I am not sure exactly
-      // how much we would need to approximate, but I think it could be done
-      // without breaking the O(log k)-competitive guarantee (I think).
-      for (size_t p = 0; p < data.n_cols; ++p)
+      #pragma omp parallel for schedule(static)
+      for (size_t p = 0; p < (size_t) data.n_cols; ++p)
       {
-        double minDistance = std::numeric_limits<double>::max();
-        for (size_t j = 0; j < i; ++j)
-        {
-          const double distance = SquaredEuclideanDistance::Evaluate(
-              data.col(p), centroids.col(j));
-          minDistance = std::min(distance, minDistance);
-        }
-
-        distribution[p] = minDistance;
+        const double distance = SquaredEuclideanDistance::Evaluate(
+            data.col(p), centroids.col(i - 1));
+        minDistances[p] = std::min(distance, minDistances[p]);
       }
 
-      // Next normalize the distribution (actually technically we could avoid
-      // this).
-      distribution /= accu(distribution);
-
-      // Turn it into a CDF for convenience...
-      for (size_t j = 1; j < distribution.n_elem; ++j)
-        distribution[j] += distribution[j - 1];
-
-      // Sample a point...
-      const double sampleValue = Random();
-      const double* elem = std::lower_bound(distribution.begin(),
-          distribution.end(), sampleValue);
-      const size_t position = (size_t)
-          (elem - distribution.begin()) / sizeof(double);
+      const size_t position = weights.is_empty() ? Sample(minDistances) :
+          Sample(minDistances % weights);
       centroids.col(i) = data.col(position);
     }
   }
+
+ private:
+  /**
+   * Sample an index with probability proportional to the given (non-negative)
+   * value.  If all values are zero, the index is sampled uniformly.
+   */
+  inline static size_t Sample(const arma::vec& distribution)
+  {
+    // Turn the distribution into a CDF for sampling.
+    const arma::vec cdf = arma::cumsum(distribution);
+    if (cdf[cdf.n_elem - 1] <= 0.0)
+      return RandInt(0, distribution.n_elem);
+
+    const double sampleValue = Random() * cdf[cdf.n_elem - 1];
+    const double* elem = std::lower_bound(cdf.begin(), cdf.end(), sampleValue);
+    return std::min((size_t) (elem - cdf.begin()), (size_t) cdf.n_elem - 1);
+  }
 };
 
 } // namespace mlpack
@@ -0,0 +1,205 @@
+/**
+ * @file methods/kmeans/kmeans_point_distance.hpp
+ *
+ * Distances between the points of a dataset and dense centroids, and sums of
+ * points, that only touch the nonzero elements of sparse points.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_KMEANS_POINT_DISTANCE_HPP
+#define MLPACK_METHODS_KMEANS_KMEANS_POINT_DISTANCE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/distances/lmetric.hpp>
+
+namespace mlpack {
+
+/**
+ * Add scale times point i of the dataset to column c of sums.  For a sparse
+ * dataset, only the nonzero elements of the point are visited, instead of
+ * converting it to a dense vector.
+ *
+ * @param dataset Dataset holding the point.
+ * @param i Index of the point.
+ * @param sums Matrix to add the point to.
+ * @param c Column of sums to add the point to.
+ * @param scale Factor to multiply the point by.
+ */
+template<typename MatType>
+inline void AddPointToColumn(const MatType& dataset,
+                             const size_t i,
+                             arma::mat& sums,
+                             const size_t c,
+                             const double scale = 1.0)
+{
+  if constexpr (arma::is_SpMat<MatType>::value)
+  {
+    double* sum = sums.colptr(c);
+    for (size_t j = dataset.col_ptrs[i]; j < dataset.col_ptrs[i + 1]; ++j)
+      sum[dataset.row_indices[j]] += scale * dataset.values[j];
+  }
+  else
+  {
+    if (scale == 1.0)
+      sums.col(c) += dataset.col(i);
+    else
+      sums.col(c) += scale * dataset.col(i);
+  }
+}
+
+/**
+ * Compute the dot product of point i of the dataset with column c of the
+ * dense matrix m.  For a sparse dataset, this takes time proportional to the
+ * number of nonzero elements of the point.
+ */
+template<typename MatType>
+inline double PointDot(const MatType& dataset,
+                       const size_t i,
+                       const arma::mat& m,
+                       const size_t c)
+{
+  if constexpr (arma::is_SpMat<MatType>::value)
+  {
+    const double* col = m.colptr(c);
+    double dot = 0.0;
+    for (size_t j = dataset.col_ptrs[i]; j < dataset.col_ptrs[i + 1]; ++j)
+      dot += dataset.values[j] * col[dataset.row_indices[j]];
+    return dot;
+  }
+  else
+  {
+    return arma::dot(dataset.col(i), m.col(c));
+  }
+}
+
+/**
+ * Compute the squared norm of every point of the dataset.
+ */
+template<typename MatType>
+inline arma::vec SquaredPointNorms(const MatType& dataset)
+{
+  arma::vec norms(dataset.n_cols);
+  if constexpr (arma::is_SpMat<MatType>::value)
+  {
+    // The arrays of a sparse dataset are read directly.
+    dataset.sync();
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      double norm = 0.0;
+      for (size_t j = dataset.col_ptrs[i]; j < dataset.col_ptrs[i + 1]; ++j)
+        norm += dataset.values[j] * dataset.values[j];
+      norms[i] = norm;
+    }
+  }
+  else
+  {
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      norms[i] = arma::dot(dataset.col(i), dataset.col(i));
+  }
+
+  return norms;
+}
+
+/**
+ * KMeansPointDistance computes the distances between the points of a dataset
+ * and a set of dense centroids, for the Lloyd step types that compute the
+ * distances one at a time (like ElkanKMeans and HamerlyKMeans).
+ *
+ * For dense data, or for metrics other than the Euclidean distance, this is
+ * just the distance metric.  But subtracting a dense centroid from a sparse
+ * point takes time proportional to the dimensionality, which for text data
+ * can be many times the number of nonzero elements of the point.  So, for
+ * sparse data (arma::sp_mat) and the (squared) Euclidean distance, the
+ * squared distance is computed as
+ *
+ *   ||x - c||^2 = ||x||^2 - 2 x^T c + ||c||^2,
+ *
+ * with the squared norms of the points computed once, when the object is
+ * created, and those of the centroids computed by Centroids() at each
+ * iteration; then each distance only takes time proportional to the number
+ * of nonzero elements of the point.  Because of rounding, these distances may
+ * differ slightly from the distance metric for points very close to a
+ * centroid.
+ *
+ * @tparam DistanceType Type of distance metric.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename DistanceType, typename MatType>
+class KMeansPointDistance
+{
+ public:
+  //! Whether the distances are computed from the squared norms.
+  static constexpr bool UseNorms = arma::is_SpMat<MatType>::value &&
+      (std::is_same_v<DistanceType, LMetric<2, true>> ||
+       std::is_same_v<DistanceType, LMetric<2, false>>);
+
+  /**
+   * Create the object for the given dataset and distance metric.
+   *
+   * @param dataset Dataset.
+   * @param distance Instantiated distance metric.
+   */
+  KMeansPointDistance(const MatType& dataset, DistanceType& distance) :
+      dataset(dataset),
+      distance(distance)
+  {
+    // The arrays of a sparse dataset are read directly.
+    if constexpr (arma::is_SpMat<MatType>::value)
+      dataset.sync();
+
+    if constexpr (UseNorms)
+      pointNorms = SquaredPointNorms(dataset);
+  }
+
+  /**
+   * Set the centroids that the distances are computed to.  This must be
+   * called at each iteration, before Evaluate(); the centroids are not copied,
+   * so they must not be modified until the last call to Evaluate().
+   */
+  void Centroids(const arma::mat& centroidsIn)
+  {
+    centroids = &centroidsIn;
+    if constexpr (UseNorms)
+      centroidNorms = arma::sum(arma::square(centroidsIn), 0).t();
+  }
+
+  //! Compute the distance between point i and centroid c.
+  double Evaluate(const size_t i, const size_t c) const
+  {
+    if constexpr (UseNorms)
+    {
+      const double squared = std::max(pointNorms[i] - 2.0 *
+          PointDot(dataset, i, *centroids, c) + centroidNorms[c], 0.0);
+      if constexpr (DistanceType::TakeRoot)
+        return std::sqrt(squared);
+      else
+        return squared;
+    }
+    else
+    {
+      return distance.Evaluate(dataset.col(i), centroids->col(c));
+    }
+  }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated distance metric.
+  DistanceType& distance;
+  //! The current centroids.
+  const arma::mat* centroids = nullptr;
+
+  //! The squared norms of the points (only for UseNorms).
+  arma::vec pointNorms;
+  //! The squared norms of the centroids (only for UseNorms).
+  arma::vec centroidNorms;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans.hpp
+ *
+ * An implementation of mini-batch k-means, which updates the centroids with a
+ * small random sample of the dataset in each iteration.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * An implementation of mini-batch k-means, as described in the paper below.
+ * Instead of assigning every point of the dataset to its closest centroid in
+ * each iteration, a random batch of points is assigned, and each centroid is
+ * moved towards the points of the batch assigned to it.  Each centroid has its
+ * own learning rate, which is the inverse of the number of points that have
+ * been assigned to it so far; so, the centroids move less and less as the
+ * iterations continue.  Each iteration takes time proportional to the batch
+ * size instead of the dataset size, at the cost of centroids that are slightly
+ * worse than those found by Lloyd iterations.
+ *
+ * For datasets that do not fit in memory, see StreamingKMeans, which uses the
+ * same updates on chunks of data read one at a time.
+ *
+ * @code
+ * @inproceedings{sculley2010web,
+ *   title={Web-scale k-means clustering},
+ *   author={Sculley, D.},
+ *   booktitle={Proceedings of the 19th International Conference on World Wide
+ *       Web (WWW '10)},
+ *   pages={1177--1178},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * @tparam DistanceType Type of distance metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename DistanceType, typename MatType>
+class MiniBatchKMeans
+{
+ public:
+  //! The batch size used by KMeans, which does not pass one.
+  static constexpr size_t DefaultBatchSize = 1024;
+
+  /**
+   * Construct the MiniBatchKMeans object with the given dataset and distance
+   * metric.
+   *
+   * @param dataset Dataset.
+   * @param distance Instantiated distance metric.
+   * @param batchSize Number of points sampled in each iteration; if this is at
+   *     least the number of points in the dataset, every point is used in each
+   *     iteration.
+   */
+  MiniBatchKMeans(const MatType& dataset,
+                  DistanceType& distance,
+                  const size_t batchSize = DefaultBatchSize);
+
+  /**
+   * Run a single iteration of mini-batch k-means, updating the given centroids
+   * into the newCentroids matrix.
+   *
+   * Unlike other Lloyd step types, `counts` holds the number of points that
+   * were assigned to each cluster in all iterations so far (and not only in
+   * this one), because it gives the learning rate of each centroid.  So, the
+   * same `counts` object must be passed to every iteration; its contents are
+   * ignored in the first iteration.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points assigned to each cluster so far.
+   * @return Norm of the change of the centroids.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  /**
+   * Move the given centroids towards the given batch of points: each point is
+   * assigned to its closest centroid, and then each centroid is moved towards
+   * each of its points with a learning rate that is the inverse of its count.
+   * The counts are updated.  This is used by Iterate() and by StreamingKMeans.
+   *
+   * @param batch Points to update the centroids with.
+   * @param centroids Centroids to update.
+   * @param counts Number of points assigned to each centroid so far.
+   * @param distance Distance metric to use.
+   * @return The number of distance calculations performed.
+   */
+  template<typename BatchType>
+  static size_t Update(const BatchType& batch,
+                       arma::mat& centroids,
+                       arma::Col<size_t>& counts,
+                       DistanceType& distance);
+
+  //! Get the number of points sampled in each iteration.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points sampled in each iteration.
+  size_t& BatchSize() { return batchSize; }
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  /**
+   * Update the centroids with the points of the given data that have the given
+   * indices, as described in Update().
+   */
+  template<typename DataType>
+  static size_t UpdatePoints(const DataType& data,
+                             const arma::uvec& indices,
+                             arma::mat& centroids,
+                             arma::Col<size_t>& counts,
+                             DistanceType& distance);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated distance metric.
+  DistanceType& distance;
+  //! The number of points sampled in each iteration.
+  size_t batchSize;
+
+  //! The number of iterations performed so far.
+  size_t iteration;
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "mini_batch_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,142 @@
+/**
+ * @file methods/kmeans/mini_batch_kmeans_impl.hpp
+ *
+ * Implementation of mini-batch k-means.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_MINI_BATCH_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "mini_batch_kmeans.hpp"
+
+#include <mlpack/core/math/random.hpp>
+#include <mlpack/core/util/log.hpp>
+
+namespace mlpack {
+
+template<typename DistanceType, typename MatType>
+MiniBatchKMeans<DistanceType, MatType>::MiniBatchKMeans(
+    const MatType& dataset,
+    DistanceType& distance,
+    const size_t batchSize) :
+    dataset(dataset),
+    distance(distance),
+    batchSize(batchSize),
+    iteration(0),
+    distanceCalculations(0)
+{ /* Nothing to do. */ }
+
+// Run a single iteration.
+template<typename DistanceType, typename MatType>
+double MiniBatchKMeans<DistanceType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  // The counts carry over between iterations, unless the number of clusters
+  // was changed (for instance by KillEmptyClusters).
+  if (iteration == 0 || counts.n_elem != centroids.n_cols)
+    counts.zeros(centroids.n_cols);
+  ++iteration;
+
+  // Sample the batch (with replacement), or use the whole dataset if it is
+  // small enough.
+  arma::uvec indices;
+  if (batchSize >= dataset.n_cols)
+  {
+    indices = arma::regspace<arma::uvec>(0, dataset.n_cols - 1);
+  }
+  else
+  {
+    indices.set_size(batchSize);
+    for (size_t i = 0; i < batchSize; ++i)
+      indices[i] = RandInt(0, dataset.n_cols);
+  }
+
+  newCentroids = centroids;
+  distanceCalculations += UpdatePoints(dataset, indices, newCentroids, counts,
+      distance);
+
+  // Calculate the change of the centroids in this iteration.
+  double cNorm = 0.0;
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    cNorm += std::pow(distance.Evaluate(centroids.col(i), newCentroids.col(i)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+template<typename DistanceType, typename MatType>
+template<typename BatchType>
+size_t MiniBatchKMeans<DistanceType, MatType>::Update(
+    const BatchType& batch,
+    arma::mat& centroids,
+    arma::Col<size_t>& counts,
+    DistanceType& distance)
+{
+  if (batch.n_cols == 0)
+    return 0;
+
+  const arma::uvec indices = arma::regspace<arma::uvec>(0, batch.n_cols - 1);
+  return UpdatePoints(batch, indices, centroids, counts, distance);
+}
+
+template<typename DistanceType, typename MatType>
+template<typename DataType>
+size_t MiniBatchKMeans<DistanceType, MatType>::UpdatePoints(
+    const DataType& data,
+    const arma::uvec& indices,
+    arma::mat& centroids,
+    arma::Col<size_t>& counts,
+    DistanceType& distance)
+{
+  // First assign every point of the batch to its closest centroid, with the
+  // centroids as they are at the start of the batch.
+  arma::Col<size_t> assignments(indices.n_elem);
+
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < (size_t) indices.n_elem; ++i)
+  {
+    double minDistance = std::numeric_limits<double>::infinity();
+    size_t closestCluster = centroids.n_cols; // Invalid value.
+
+    for (size_t j = 0; j < centroids.n_cols; ++j)
+    {
+      const double dist = distance.Evaluate(data.col(indices[i]),
+          centroids.col(j));
+      if (dist < minDistance)
+      {
+        minDistance = dist;
+        closestCluster = j;
+      }
+    }
+
+    Log::Assert(closestCluster != centroids.n_cols);
+    assignments[i] = closestCluster;
+  }
+
+  // Now take a gradient step for each point, with the learning rate of its
+  // centroid.  The order of the points matters, so this is not parallelized.
+  for (size_t i = 0; i < indices.n_elem; ++i)
+  {
+    const size_t cluster = assignments[i];
+    ++counts[cluster];
+    const double eta = 1.0 / counts[cluster];
+    centroids.col(cluster) = (1.0 - eta) * centroids.col(cluster) +
+        eta * arma::vec(data.col(indices[i]));
+  }
+
+  return indices.n_elem * centroids.n_cols;
+}
+
+} // namespace mlpack
+
+#endif
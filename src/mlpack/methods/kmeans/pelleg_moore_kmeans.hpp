@@ -83,6 +83,18 @@ class PellegMooreKMeans
 
   //! Track distance calculations.
   size_t distanceCalculations;
+
+  /**
+   * Traverse the tree with the given rules, which accumulate the new centroids
+   * and counts.  The top levels of the tree are scored first, and the
+   * remaining subtrees are traversed in parallel (if OpenMP is available), with
+   * a copy of the rules, the new centroids and the counts for each thread.
+   */
+  template<typename RulesType>
+  void Traverse(RulesType& rules,
+                const arma::mat& centroids,
+                arma::mat& newCentroids,
+                arma::Col<size_t>& counts);
 };
 
 } // namespace mlpack
@@ -52,12 +52,7 @@ double PellegMooreKMeans<DistanceType, MatType>::Iterate(
   using RulesType = PellegMooreKMeansRules<DistanceType, TreeType>;
   RulesType rules(dataset, centroids, newCentroids, counts, distance);
 
-  // Use single-tree traverser.
-  typename TreeType::template SingleTreeTraverser<RulesType> traverser(rules);
-
-  // Now, do a traversal with a fake query index (since the query index is
-  // irrelevant; we are checking each node with all clusters.
-  traverser.Traverse(0, *tree);
+  Traverse(rules, centroids, newCentroids, counts);
 
   distanceCalculations += rules.DistanceCalculations();
 
@@ -77,6 +72,77 @@ double PellegMooreKMeans<DistanceType, MatType>::Iterate(
   return std::sqrt(residual);
 }
 
+template<typename DistanceType, typename MatType>
+template<typename RulesType>
+void PellegMooreKMeans<DistanceType, MatType>::Traverse(
+    RulesType& rules,
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+
+  // Score the top levels of the tree until there are a few more unpruned
+  // subtrees than threads.  Score() handles the points of leaves and of the
+  // nodes owned by a single cluster itself, so only unpruned internal nodes are
+  // kept.  Each node's blacklist is computed from its parent's, so the parents
+  // must always be scored first.
+  std::vector<TreeType*> frontier;
+  if (rules.Score(0, *tree) != DBL_MAX && !tree->IsLeaf())
+    frontier.push_back(tree);
+
+  while (!frontier.empty() && frontier.size() < 4 * numThreads)
+  {
+    std::vector<TreeType*> nextLevel;
+    for (size_t i = 0; i < frontier.size(); ++i)
+    {
+      for (size_t j = 0; j < frontier[i]->NumChildren(); ++j)
+      {
+        TreeType& child = frontier[i]->Child(j);
+        if (rules.Score(0, child) != DBL_MAX && !child.IsLeaf())
+          nextLevel.push_back(&child);
+      }
+    }
+
+    frontier.swap(nextLevel);
+  }
+
+  size_t threadDistanceCalculations = 0;
+  #pragma omp parallel reduction(+:threadDistanceCalculations)
+  {
+    // The subtrees are disjoint, so they only share the new centroids and the
+    // counts; those are accumulated separately by each thread.
+    arma::mat localCentroids(newCentroids.n_rows, newCentroids.n_cols,
+        arma::fill::zeros);
+    arma::Col<size_t> localCounts(newCentroids.n_cols, arma::fill::zeros);
+    RulesType localRules(dataset, centroids, localCentroids, localCounts,
+        distance);
+    typename TreeType::template SingleTreeTraverser<RulesType>
+        traverser(localRules);
+
+    // Score() has already been called for each node of the frontier, so the
+    // traversal starts with its children.  The query index is irrelevant,
+    // since each node is checked with all clusters.
+    #pragma omp for schedule(dynamic) nowait
+    for (size_t i = 0; i < frontier.size(); ++i)
+      traverser.Traverse(0, *frontier[i]);
+
+    threadDistanceCalculations += localRules.DistanceCalculations();
+
+    #pragma omp critical
+    {
+      newCentroids += localCentroids;
+      counts += localCounts;
+    }
+  }
+
+  rules.DistanceCalculations() += threadDistanceCalculations;
+}
+
 } // namespace mlpack
 
 #endif
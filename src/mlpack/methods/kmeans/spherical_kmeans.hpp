@@ -0,0 +1,106 @@
+/**
+ * @file methods/kmeans/spherical_kmeans.hpp
+ *
+ * An implementation of a step of spherical k-means, which clusters points by
+ * their cosine similarity to unit-length centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/distances/lmetric.hpp>
+#include <mlpack/core/util/threads.hpp>
+
+#include "kmeans_point_distance.hpp"
+
+namespace mlpack {
+
+/**
+ * SphericalKMeans is a Lloyd step type for spherical k-means, which is the
+ * usual way to cluster text data (for instance TF-IDF vectors): each point is
+ * assigned to the centroid with the largest cosine similarity, and each new
+ * centroid is the sum of the points of its cluster, normalized to unit length
+ * (which maximizes the total cosine similarity of the cluster).  Since the
+ * centroids have unit length, the cosine similarity of a point x and a
+ * centroid c is proportional to x^T c, and the closest centroid by cosine
+ * similarity is also the closest centroid by Euclidean distance:
+ *
+ *   ||x - c||^2 = ||x||^2 - 2 x^T c + 1.
+ *
+ * So, at the end of the clustering, KMeans assigns the points to the same
+ * centroids with the Euclidean distance, which must be the distance metric.
+ *
+ * The products of the centroids and the points are computed for blocks of
+ * points with one matrix multiplication per block.  For sparse data
+ * (arma::sp_mat), this is a sparse-dense product, so each iteration takes
+ * time proportional to the number of nonzero elements of the dataset times
+ * the number of clusters, and the dataset is never converted to a dense
+ * matrix.  The points are normalized before they are added to the centroids,
+ * without modifying the dataset; the centroids given to the first iteration
+ * (e.g. points sampled by the initial partition policy) are normalized too.
+ *
+ * @tparam DistanceType Type of distance metric; it must be EuclideanDistance
+ *     or SquaredEuclideanDistance.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename DistanceType, typename MatType>
+class SphericalKMeans
+{
+ public:
+  static_assert(std::is_same_v<DistanceType, LMetric<2, true>> ||
+      std::is_same_v<DistanceType, LMetric<2, false>>,
+      "SphericalKMeans can only be used with the Euclidean distance!");
+
+  //! Number of points of each block of the computation.
+  static constexpr size_t BlockSize = 1024;
+
+  /**
+   * Construct the SphericalKMeans object with the given dataset and distance
+   * metric.  This computes the norms of the points.
+   *
+   * @param dataset Dataset.
+   * @param distance Instantiated distance metric.
+   */
+  SphericalKMeans(const MatType& dataset, DistanceType& distance);
+
+  /**
+   * Run a single iteration of spherical k-means, updating the given centroids
+   * into the newCentroids matrix; the new centroids have unit length.  If any
+   * cluster is empty (that is, if any cluster has no points assigned to it),
+   * then the centroid associated with that cluster is filled with zeros (it
+   * will be corrected later).
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Number of points in each cluster at the end of the iteration.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+ private:
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated distance metric.
+  DistanceType& distance;
+
+  //! The norms of the points.
+  arma::vec pointNorms;
+
+  //! Number of distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "spherical_kmeans_impl.hpp"
+
+#endif
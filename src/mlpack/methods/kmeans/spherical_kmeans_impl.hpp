@@ -0,0 +1,102 @@
+/**
+ * @file methods/kmeans/spherical_kmeans_impl.hpp
+ *
+ * Implementation of a step of spherical k-means, which assigns each point to
+ * the unit-length centroid with the largest cosine similarity.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_SPHERICAL_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "spherical_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename DistanceType, typename MatType>
+SphericalKMeans<DistanceType, MatType>::SphericalKMeans(
+    const MatType& dataset,
+    DistanceType& distance) :
+    dataset(dataset),
+    distance(distance),
+    pointNorms(arma::sqrt(SquaredPointNorms(dataset))),
+    distanceCalculations(0)
+{
+  // Nothing to do here.
+}
+
+// Run a single iteration.
+template<typename DistanceType, typename MatType>
+double SphericalKMeans<DistanceType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // Normalize the centroids; the centroid of an empty cluster may be zero.
+  // They are transposed so that the products are given by one multiplication.
+  arma::mat normalizedT = centroids.t();
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    const double norm = arma::norm(centroids.col(c), 2);
+    if (norm > 0.0)
+      normalizedT.row(c) /= norm;
+  }
+
+  const size_t numBlocks = (dataset.n_cols + BlockSize - 1) / BlockSize;
+
+  // Each thread multiplies its blocks, and BLAS must be single-threaded
+  // meanwhile.
+  ThreadBudget budget;
+  #pragma omp parallel for schedule(static) reduction(matAdd: newCentroids) \
+      reduction(colAdd: counts)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) dataset.n_cols);
+
+    // For sparse data, this is a dense-sparse product, which only visits the
+    // nonzero elements of the block.
+    const arma::mat products = normalizedT * dataset.cols(begin, end - 1);
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      const size_t closestCluster = products.col(i - begin).index_max();
+      if (pointNorms[i] > 0.0)
+      {
+        AddPointToColumn(dataset, i, newCentroids, closestCluster,
+            1.0 / pointNorms[i]);
+      }
+      counts(closestCluster)++;
+    }
+  }
+
+  distanceCalculations += centroids.n_cols * dataset.n_cols;
+
+  // Normalize the new centroids, and calculate the distance each of them has
+  // moved.
+  double cNorm = 0.0;
+  #pragma omp parallel for reduction(+:cNorm) schedule(static)
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    const double norm = arma::norm(newCentroids.col(c), 2);
+    if (norm > 0.0)
+      newCentroids.col(c) /= norm;
+
+    cNorm += std::pow(distance.Evaluate(centroids.col(c), newCentroids.col(c)),
+        2.0);
+  }
+  distanceCalculations += centroids.n_cols;
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,244 @@
+/**
+ * @file methods/kmeans/streaming_kmeans.hpp
+ *
+ * Definition of StreamingKMeans, which runs mini-batch k-means on a dataset
+ * that is given one chunk at a time, so that datasets that do not fit in
+ * memory can be clustered.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_STREAMING_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_STREAMING_KMEANS_HPP
+
+#include <mlpack/core.hpp>
+
+#include "mini_batch_kmeans.hpp"
+
+namespace mlpack {
+
+/**
+ * StreamingKMeans clusters a dataset that is given one chunk at a time, with
+ * the mini-batch k-means updates of MiniBatchKMeans.  Only the centroids and
+ * the number of points assigned to each of them are kept between chunks, so
+ * the memory used does not depend on the size of the dataset.  The centroids
+ * are initialized with a random sample of the first chunk.  Each chunk is
+ * shuffled and split into batches, and each batch moves the centroids; every
+ * point of the dataset is thus used once per pass.
+ *
+ * A dataset stored in a CSV file can be clustered without loading it into
+ * memory with data::CSVChunkReader:
+ *
+ * @code
+ * data::CSVChunkReader reader("click_logs.csv", 1000000);
+ * StreamingKMeans<> kmeans(100);
+ * kmeans.Cluster(reader, 2); // Two passes over the dataset.
+ *
+ * // Now assign the points of some chunk to their clusters.
+ * arma::mat chunk;
+ * arma::Row<size_t> assignments;
+ * reader.Reset();
+ * reader.Next(chunk);
+ * kmeans.Assign(chunk, assignments);
+ * @endcode
+ *
+ * @tparam DistanceType The distance metric to use.
+ * @tparam MatType Type of each chunk of data.
+ */
+template<typename DistanceType = EuclideanDistance,
+         typename MatType = arma::mat>
+class StreamingKMeans
+{
+ public:
+  /**
+   * Create the StreamingKMeans object.
+   *
+   * @param clusters Number of clusters to find.
+   * @param batchSize Number of points in each mini-batch update.
+   * @param distance Optional instantiated distance metric.
+   */
+  StreamingKMeans(const size_t clusters = 1,
+                  const size_t batchSize =
+                      MiniBatchKMeans<DistanceType, MatType>::DefaultBatchSize,
+                  const DistanceType distance = DistanceType()) :
+      clusters(clusters),
+      batchSize(batchSize),
+      distance(distance)
+  {
+    if (batchSize == 0)
+      throw std::invalid_argument("StreamingKMeans: batch size must be "
+          "positive");
+  }
+
+  /**
+   * Update the centroids with the points of the given chunk.  If no chunk has
+   * been seen yet, the centroids are first initialized with a random sample of
+   * the chunk, so the first chunk must contain at least Clusters() points.
+   *
+   * @param chunk Points to update the centroids with.
+   */
+  void Update(const MatType& chunk)
+  {
+    if (chunk.n_cols == 0)
+      return;
+
+    if (centroids.n_cols == 0)
+    {
+      if (chunk.n_cols < clusters)
+      {
+        throw std::invalid_argument("StreamingKMeans::Update(): the first "
+            "chunk has " + std::to_string(chunk.n_cols) + " points, but " +
+            std::to_string(clusters) + " clusters were requested");
+      }
+
+      centroids = arma::conv_to<arma::mat>::from(
+          chunk.cols(arma::randperm(chunk.n_cols, clusters)));
+      counts.zeros(clusters);
+    }
+    else
+    {
+      util::CheckSameDimensionality(chunk, centroids,
+          "StreamingKMeans::Update()");
+    }
+
+    // Process the chunk in a random order, one batch at a time.
+    const arma::uvec order = arma::randperm(chunk.n_cols);
+    for (size_t i = 0; i < chunk.n_cols; i += batchSize)
+    {
+      const size_t end = std::min((size_t) chunk.n_cols, i + batchSize) - 1;
+      const MatType batch = chunk.cols(order.subvec(i, end));
+      MiniBatchKMeans<DistanceType, MatType>::Update(batch, centroids, counts,
+          distance);
+    }
+  }
+
+  /**
+   * Cluster all of the data given by the reader, by passing every chunk it
+   * returns to Update().  The reader must have a method `bool Next(MatType&)`
+   * that returns false when there is no more data, and, if more than one pass
+   * is requested, a method `void Reset()` that goes back to the first chunk;
+   * data::CSVChunkReader is an example.
+   *
+   * @param reader Source of the chunks of data.
+   * @param passes Number of passes over the data.
+   */
+  template<typename ReaderType>
+  void Cluster(ReaderType& reader, const size_t passes = 1)
+  {
+    MatType chunk;
+    for (size_t pass = 0; pass < passes; ++pass)
+    {
+      if (pass > 0)
+        reader.Reset();
+
+      size_t points = 0;
+      while (reader.Next(chunk))
+      {
+        Update(chunk);
+        points += chunk.n_cols;
+      }
+
+      Log::Info << "StreamingKMeans::Cluster(): pass " << (pass + 1) << " used "
+          << points << " points." << std::endl;
+    }
+  }
+
+  /**
+   * Assign each of the given points to the cluster with the closest centroid.
+   *
+   * @param points Points to assign.
+   * @param assignments Vector to store the cluster of each point in.
+   */
+  void Assign(const MatType& points, arma::Row<size_t>& assignments)
+  {
+    if (centroids.n_cols == 0)
+      throw std::invalid_argument("StreamingKMeans::Assign(): no data has been "
+          "clustered yet");
+    util::CheckSameDimensionality(points, centroids,
+        "StreamingKMeans::Assign()");
+
+    assignments.set_size(points.n_cols);
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < (size_t) points.n_cols; ++i)
+    {
+      double minDistance = std::numeric_limits<double>::infinity();
+      size_t closestCluster = centroids.n_cols; // Invalid value.
+
+      for (size_t j = 0; j < centroids.n_cols; ++j)
+      {
+        const double dist = distance.Evaluate(points.col(i), centroids.col(j));
+        if (dist < minDistance)
+        {
+          minDistance = dist;
+          closestCluster = j;
+        }
+      }
+
+      Log::Assert(closestCluster != centroids.n_cols);
+      assignments[i] = closestCluster;
+    }
+  }
+
+  //! Forget the centroids, so that the next chunk initializes them again.
+  void Reset()
+  {
+    centroids.reset();
+    counts.reset();
+  }
+
+  //! Get the number of clusters.
+  size_t Clusters() const { return clusters; }
+  //! Modify the number of clusters.  Call Reset() for this to take effect.
+  size_t& Clusters() { return clusters; }
+
+  //! Get the number of points in each mini-batch update.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points in each mini-batch update.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the centroids (empty if no data has been seen yet).
+  const arma::mat& Centroids() const { return centroids; }
+  //! Modify the centroids.
+  arma::mat& Centroids() { return centroids; }
+
+  //! Get the number of points assigned to each centroid so far.
+  const arma::Col<size_t>& Counts() const { return counts; }
+  //! Modify the number of points assigned to each centroid so far.  These
+  //! give the learning rates of the centroids.
+  arma::Col<size_t>& Counts() { return counts; }
+
+  //! Get the distance metric.
+  const DistanceType& Distance() const { return distance; }
+  //! Modify the distance metric.
+  DistanceType& Distance() { return distance; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(clusters));
+    ar(CEREAL_NVP(batchSize));
+    ar(CEREAL_NVP(distance));
+    ar(CEREAL_NVP(centroids));
+    ar(CEREAL_NVP(counts));
+  }
+
+ private:
+  //! The number of clusters.
+  size_t clusters;
+  //! The number of points in each mini-batch update.
+  size_t batchSize;
+  //! The distance metric.
+  DistanceType distance;
+  //! The current centroids.
+  arma::mat centroids;
+  //! The number of points assigned to each centroid so far.
+  arma::Col<size_t> counts;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,135 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans.hpp
+ *
+ * An implementation of Yinyang k-means, which prunes distance calculations
+ * with one lower bound per group of centroids.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "kmeans_point_distance.hpp"
+
+namespace mlpack {
+
+/**
+ * YinyangKMeans is an implementation of a single iteration of Lloyd's
+ * algorithm with the bounds of Yinyang k-means:
+ *
+ * @code
+ * @inproceedings{ding2015yinyang,
+ *   title={Yinyang K-Means: A Drop-In Replacement of the Classic K-Means with
+ *       Consistent Speedup},
+ *   author={Ding, Yufei and Zhao, Yue and Shen, Xipeng and Musuvathi, Madanlal
+ *       and Mytkowicz, Todd},
+ *   booktitle={Proceedings of the 32nd International Conference on Machine
+ *       Learning (ICML 2015)},
+ *   pages={579--587},
+ *   year={2015}
+ * }
+ * @endcode
+ *
+ * Like ElkanKMeans, each point has an upper bound on the distance to its
+ * centroid; but instead of one lower bound per centroid, which takes O(nk)
+ * memory, the centroids are split into groups of about CentroidsPerGroup
+ * centroids by a k-means of the initial centroids, and each point has one
+ * lower bound on the distance to the centroids of each group.  A point is only
+ * compared to the centroids of the groups whose lower bound is smaller than
+ * its upper bound (the group filter), and, in those groups, only to the
+ * centroids whose own movement does not prove that they are too far (the
+ * local filter).  The memory used is O(nk / CentroidsPerGroup), and the
+ * results are the same as NaiveKMeans.
+ *
+ * The distance metric must satisfy the triangle inequality.  For sparse data
+ * and the Euclidean distance, the distances are computed in time proportional
+ * to the number of nonzero elements of the points (see KMeansPointDistance).
+ *
+ * @tparam DistanceType Type of distance metric used with this implementation.
+ * @tparam MatType Matrix type (arma::mat or arma::sp_mat).
+ */
+template<typename DistanceType, typename MatType>
+class YinyangKMeans
+{
+ public:
+  //! The average number of centroids in each group.
+  static constexpr size_t CentroidsPerGroup = 10;
+
+  //! The number of Lloyd iterations used to group the centroids.
+  static constexpr size_t GroupingIterations = 5;
+
+  /**
+   * Construct the YinyangKMeans object, which must store several sets of
+   * bounds.
+   *
+   * @param dataset Dataset.
+   * @param distance Instantiated distance metric.
+   */
+  YinyangKMeans(const MatType& dataset, DistanceType& distance);
+
+  /**
+   * Run a single iteration of Yinyang k-means, updating the given centroids
+   * into the newCentroids matrix.  The centroids are grouped at the first
+   * iteration.
+   *
+   * @param centroids Current cluster centroids.
+   * @param newCentroids New cluster centroids.
+   * @param counts Current counts, to be overwritten with new counts.
+   */
+  double Iterate(const arma::mat& centroids,
+                 arma::mat& newCentroids,
+                 arma::Col<size_t>& counts);
+
+  size_t DistanceCalculations() const { return distanceCalculations; }
+
+  //! Get the group of each centroid.
+  const arma::Col<size_t>& CentroidGroups() const { return centroidGroups; }
+
+ private:
+  //! Split the centroids into groups with a k-means of the centroids.
+  void GroupCentroids(const arma::mat& centroids);
+
+  //! The dataset.
+  const MatType& dataset;
+  //! The instantiated distance metric.
+  DistanceType& distance;
+  //! Distances between the points and the current centroids.
+  KMeansPointDistance<DistanceType, MatType> pointDistance;
+
+  //! The group of each centroid.
+  arma::Col<size_t> centroidGroups;
+  //! The centroids, ordered by group.
+  arma::Col<size_t> groupCentroids;
+  //! The index in groupCentroids of the first centroid of each group (and the
+  //! number of centroids, at the end).
+  arma::Col<size_t> groupStarts;
+
+  //! Holds the index of the cluster that owns each point.
+  arma::Col<size_t> assignments;
+  //! Upper bounds on the distance between each point and its closest cluster.
+  arma::vec upperBounds;
+  //! Lower bounds on the distance between each point and the clusters of each
+  //! group, other than the cluster of the point.
+  arma::mat lowerBounds;
+
+  //! The distance each centroid moved during the last iteration.
+  arma::vec centroidMovements;
+  //! The largest distance a centroid of each group moved during the last
+  //! iteration.
+  arma::vec groupMovements;
+
+  //! Track distance calculations.
+  size_t distanceCalculations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "yinyang_kmeans_impl.hpp"
+
+#endif
@@ -0,0 +1,276 @@
+/**
+ * @file methods/kmeans/yinyang_kmeans_impl.hpp
+ *
+ * An implementation of Yinyang k-means for exact Lloyd iterations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+#define MLPACK_METHODS_KMEANS_YINYANG_KMEANS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "yinyang_kmeans.hpp"
+
+namespace mlpack {
+
+template<typename DistanceType, typename MatType>
+YinyangKMeans<DistanceType, MatType>::YinyangKMeans(const MatType& dataset,
+                                                    DistanceType& distance) :
+    dataset(dataset),
+    distance(distance),
+    pointDistance(dataset, distance),
+    distanceCalculations(0)
+{
+  // Nothing to do here.
+}
+
+template<typename DistanceType, typename MatType>
+void YinyangKMeans<DistanceType, MatType>::GroupCentroids(
+    const arma::mat& centroids)
+{
+  const size_t k = centroids.n_cols;
+  const size_t numGroups = std::max((size_t) 1, k / CentroidsPerGroup);
+
+  // Run a few Lloyd iterations on the centroids, starting from centroids that
+  // are evenly spaced in the order they were given.
+  arma::mat groupCenters(centroids.n_rows, numGroups);
+  for (size_t g = 0; g < numGroups; ++g)
+    groupCenters.col(g) = centroids.col(g * k / numGroups);
+
+  centroidGroups.set_size(k);
+  for (size_t iteration = 0; iteration < GroupingIterations; ++iteration)
+  {
+    for (size_t c = 0; c < k; ++c)
+    {
+      double minDistance = DBL_MAX;
+      for (size_t g = 0; g < numGroups; ++g)
+      {
+        const double dist = distance.Evaluate(centroids.col(c),
+            groupCenters.col(g));
+        if (dist < minDistance)
+        {
+          minDistance = dist;
+          centroidGroups[c] = g;
+        }
+      }
+    }
+    distanceCalculations += k * numGroups;
+
+    // An empty group keeps its center.
+    arma::mat sums(centroids.n_rows, numGroups, arma::fill::zeros);
+    arma::Col<size_t> groupCounts(numGroups, arma::fill::zeros);
+    for (size_t c = 0; c < k; ++c)
+    {
+      sums.col(centroidGroups[c]) += centroids.col(c);
+      ++groupCounts[centroidGroups[c]];
+    }
+
+    for (size_t g = 0; g < numGroups; ++g)
+      if (groupCounts[g] > 0)
+        groupCenters.col(g) = sums.col(g) / groupCounts[g];
+  }
+
+  // Store the centroids of each group contiguously.
+  groupStarts.zeros(numGroups + 1);
+  for (size_t c = 0; c < k; ++c)
+    ++groupStarts[centroidGroups[c] + 1];
+  for (size_t g = 0; g < numGroups; ++g)
+    groupStarts[g + 1] += groupStarts[g];
+
+  groupCentroids.set_size(k);
+  arma::Col<size_t> next = groupStarts.head(numGroups);
+  for (size_t c = 0; c < k; ++c)
+    groupCentroids[next[centroidGroups[c]]++] = c;
+}
+
+// Run a single iteration of Yinyang k-means.
+template<typename DistanceType, typename MatType>
+double YinyangKMeans<DistanceType, MatType>::Iterate(
+    const arma::mat& centroids,
+    arma::mat& newCentroids,
+    arma::Col<size_t>& counts)
+{
+  newCentroids.zeros(centroids.n_rows, centroids.n_cols);
+  counts.zeros(centroids.n_cols);
+
+  // If this is the first iteration, we must group the centroids and reset all
+  // the bounds.  The bounds are filled in parallel with the same schedule as
+  // the loop over the points below, so that on NUMA machines each thread's
+  // bounds are in its local memory.
+  if (centroidGroups.n_elem != centroids.n_cols)
+  {
+    GroupCentroids(centroids);
+
+    lowerBounds.set_size(groupStarts.n_elem - 1, dataset.n_cols);
+    upperBounds.set_size(dataset.n_cols);
+    assignments.set_size(dataset.n_cols);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      lowerBounds.col(i).zeros();
+      upperBounds(i) = DBL_MAX;
+      assignments(i) = 0;
+    }
+
+    centroidMovements.zeros(centroids.n_cols);
+    groupMovements.zeros(groupStarts.n_elem - 1);
+  }
+
+  const size_t numGroups = groupStarts.n_elem - 1;
+  pointDistance.Centroids(centroids);
+
+  #pragma omp parallel
+  {
+    // For each group that a point is compared to, the smallest and second
+    // smallest distance (or lower bound) to its centroids, and the centroid
+    // with the smallest one.
+    arma::vec groupFirst(numGroups), groupSecond(numGroups);
+    arma::Col<size_t> groupFirstCentroid(numGroups);
+    std::vector<size_t> visitedGroups;
+    visitedGroups.reserve(numGroups);
+
+    #pragma omp for schedule(static) reduction(matAdd: newCentroids) \
+        reduction(colAdd: counts) reduction(+: distanceCalculations)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      double* bounds = lowerBounds.colptr(i);
+      const double globalLowerBound = arma::min(lowerBounds.col(i));
+      const size_t oldAssignment = assignments[i];
+
+      // The global filter: if the upper bound is smaller than every lower
+      // bound, the point keeps its cluster.  Otherwise, tighten the upper bound
+      // and try again.
+      if (upperBounds(i) > globalLowerBound)
+      {
+        upperBounds(i) = pointDistance.Evaluate(i, oldAssignment);
+        ++distanceCalculations;
+      }
+
+      if (upperBounds(i) > globalLowerBound)
+      {
+        size_t best = oldAssignment;
+        double bestDistance = upperBounds(i);
+        visitedGroups.clear();
+
+        for (size_t g = 0; g < numGroups; ++g)
+        {
+          // The group filter: no centroid of this group can be closer.
+          if (bounds[g] >= bestDistance)
+            continue;
+
+          visitedGroups.push_back(g);
+          groupFirst[g] = DBL_MAX;
+          groupSecond[g] = DBL_MAX;
+          groupFirstCentroid[g] = centroids.n_cols;
+
+          // Before the centroids moved at the end of the last iteration, the
+          // bound (increased back by the largest movement in the group) held
+          // for every centroid of the group; so each centroid can be at most
+          // its own movement closer than that.
+          const double oldBound = bounds[g] + groupMovements[g];
+          for (size_t j = groupStarts[g]; j < groupStarts[g + 1]; ++j)
+          {
+            const size_t c = groupCentroids[j];
+            double dist;
+            if (c == oldAssignment)
+            {
+              dist = upperBounds(i);
+            }
+            else
+            {
+              dist = oldBound - centroidMovements[c];
+              // The local filter.
+              if (dist < bestDistance)
+              {
+                dist = pointDistance.Evaluate(i, c);
+                ++distanceCalculations;
+                if (dist < bestDistance)
+                {
+                  bestDistance = dist;
+                  best = c;
+                }
+              }
+            }
+
+            if (dist < groupFirst[g])
+            {
+              groupSecond[g] = groupFirst[g];
+              groupFirst[g] = dist;
+              groupFirstCentroid[g] = c;
+            }
+            else if (dist < groupSecond[g])
+            {
+              groupSecond[g] = dist;
+            }
+          }
+        }
+
+        // Now the bound of each visited group is the smallest distance (or
+        // bound) to a centroid of the group other than the new assignment.
+        bool visitedOldGroup = false;
+        for (const size_t g : visitedGroups)
+        {
+          bounds[g] = (groupFirstCentroid[g] == best) ? groupSecond[g] :
+              groupFirst[g];
+          if (g == centroidGroups[oldAssignment])
+            visitedOldGroup = true;
+        }
+
+        // If the point left a group that was not visited, the old assignment
+        // is a centroid of that group too.
+        if (!visitedOldGroup && best != oldAssignment)
+        {
+          bounds[centroidGroups[oldAssignment]] = std::min(
+              bounds[centroidGroups[oldAssignment]], upperBounds(i));
+        }
+
+        upperBounds(i) = bestDistance;
+        assignments[i] = best;
+      }
+
+      AddPointToColumn(dataset, i, newCentroids, assignments[i]);
+      ++counts[assignments[i]];
+    }
+  }
+
+  // Now, normalize and calculate the distance each cluster has moved.
+  double cNorm = 0.0; // Cluster movement for residual.
+  #pragma omp parallel for reduction(+: cNorm, distanceCalculations)
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    if (counts[c] > 0)
+      newCentroids.col(c) /= counts[c];
+
+    centroidMovements(c) = distance.Evaluate(newCentroids.col(c),
+        centroids.col(c));
+    cNorm += std::pow(centroidMovements(c), 2.0);
+    distanceCalculations++;
+  }
+
+  groupMovements.zeros();
+  for (size_t c = 0; c < centroids.n_cols; ++c)
+  {
+    groupMovements[centroidGroups[c]] = std::max(
+        groupMovements[centroidGroups[c]], centroidMovements[c]);
+  }
+
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    // Each lower bound decreases by the largest movement of the centroids of
+    // its group, and the upper bound increases by the movement of the
+    // centroid of the point.
+    lowerBounds.col(i) -= groupMovements;
+    upperBounds(i) += centroidMovements(assignments[i]);
+  }
+
+  return std::sqrt(cNorm);
+}
+
+} // namespace mlpack
+
+#endif
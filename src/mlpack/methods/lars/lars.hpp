@@ -54,6 +54,14 @@ namespace mlpack {
  * Note: This algorithm is not recommended for use (in terms of efficiency)
  * when \f$ \lambda_1 \f$ = 0.
  *
+ * By default, each step of the path computes the correlations of the data with
+ * the current residual, which takes O(n d) time for n points in d dimensions.
+ * When n is much larger than d, set CovarianceForm() to true before training:
+ * the means, \f$ X^T X \f$ and \f$ X^T y \f$ are then computed once, in one
+ * parallel pass over blocks of the data (which is not copied, centered or
+ * transposed), and every step of the path only uses these d x d quantities.
+ * Only the error returned by Train() takes another pass over the data.
+ *
  * For more details, see the following papers:
  *
  * @code
@@ -513,6 +521,11 @@ class LARS
   //! Modify whether to use the Cholesky decomposition.
   bool& UseCholesky() { return useCholesky; }
 
+  //! Get whether to train in covariance form (on X^T X and X^T y only).
+  bool CovarianceForm() const { return covarianceForm; }
+  //! Modify whether to train in covariance form (on X^T X and X^T y only).
+  bool& CovarianceForm() { return covarianceForm; }
+
   //! Get the tolerance for maximum correlation during training.
   ElemType Tolerance() const { return tolerance; }
   //! Modify the tolerance for maximum correlation during training.
@@ -593,6 +606,9 @@ class LARS
   //! Whether or not to use Cholesky decomposition when solving linear system.
   bool useCholesky;
 
+  //! Whether or not to train on X^T X and X^T y only.
+  bool covarianceForm;
+
   //! True if this is the LASSO problem.
   bool lasso;
   //! Regularization parameter for l1 penalty.
@@ -697,12 +713,46 @@ class LARS
                     MatType& G);
 
   void CholeskyDelete(const size_t colToKill);
+
+  /**
+   * Compute the means of the dimensions and of the responses, the scatter
+   * matrix (X - mu)^T (X - mu) (or only its diagonal, if computeGram is
+   * false), and the cross-products (X - mu)^T (y - mean(y)), in one parallel
+   * pass over blocks of the data.
+   */
+  template<typename MatType, typename ResponsesType>
+  static void ComputeMoments(const MatType& matX,
+                             const ResponsesType& y,
+                             const bool colMajor,
+                             const bool computeGram,
+                             arma::Col<ElemType>& means,
+                             ElemType& yMean,
+                             DenseMatType& scatter,
+                             arma::Col<ElemType>& cross);
+
+  /**
+   * Merge the centered moments of a set of points (as computed by
+   * ComputeMoments()) into the moments of another set of points.
+   */
+  static void MergeMoments(const size_t otherCount,
+                           const arma::Col<ElemType>& otherMeans,
+                           const ElemType otherYMean,
+                           const DenseMatType& otherScatter,
+                           const arma::Col<ElemType>& otherCross,
+                           size_t& count,
+                           arma::Col<ElemType>& means,
+                           ElemType& yMean,
+                           DenseMatType& scatter,
+                           arma::Col<ElemType>& cross);
+
+  //! Number of points in each block of ComputeMoments().
+  static constexpr size_t BlockSize = 1024;
 };
 
 } // namespace mlpack
 
 CEREAL_TEMPLATE_CLASS_VERSION((typename ModelMatType),
-    (mlpack::LARS<ModelMatType>), (1));
+    (mlpack::LARS<ModelMatType>), (2));
 
 // Include implementation of serialize().
 #include "lars_impl.hpp"
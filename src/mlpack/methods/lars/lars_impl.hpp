@@ -27,6 +27,7 @@ inline LARS<ModelMatType>::LARS(
     const bool normalizeData) :
     matGram(&matGramInternal),
     useCholesky(useCholesky),
+    covarianceForm(false),
     lasso((lambda1 != 0)),
     lambda1(lambda1),
     elasticNet((lambda1 != 0) && (lambda2 != 0)),
@@ -51,6 +52,7 @@ inline LARS<ModelMatType>::LARS(
     const bool normalizeData) :
     matGram(&gramMatrix),
     useCholesky(useCholesky),
+    covarianceForm(false),
     lasso((lambda1 != 0)),
     lambda1(lambda1),
     elasticNet((lambda1 != 0) && (lambda2 != 0)),
@@ -96,6 +98,7 @@ inline LARS<ModelMatType>::LARS(
     const bool normalizeData) :
     matGram(&gramMatrix),
     useCholesky(useCholesky),
+    covarianceForm(false),
     lasso((lambda1 != 0)),
     lambda1(lambda1),
     elasticNet((lambda1 != 0) && (lambda2 != 0)),
@@ -119,6 +122,7 @@ inline LARS<ModelMatType>::LARS(const LARS<ModelMatType>& other) :
         other.matGram : &matGramInternal),
     matUtriCholFactor(other.matUtriCholFactor),
     useCholesky(other.useCholesky),
+    covarianceForm(other.covarianceForm),
     lasso(other.lasso),
     lambda1(other.lambda1),
     elasticNet(other.elasticNet),
@@ -151,6 +155,7 @@ inline LARS<ModelMatType>::LARS(LARS<ModelMatType>&& other) :
         other.matGram : &matGramInternal),
     matUtriCholFactor(std::move(other.matUtriCholFactor)),
     useCholesky(other.useCholesky),
+    covarianceForm(other.covarianceForm),
     lasso(other.lasso),
     lambda1(other.lambda1),
     elasticNet(other.elasticNet),
@@ -188,6 +193,7 @@ inline LARS<ModelMatType>& LARS<ModelMatType>::operator=(
       other.matGram : &matGramInternal;
   matUtriCholFactor = other.matUtriCholFactor;
   useCholesky = other.useCholesky;
+  covarianceForm = other.covarianceForm;
   lasso = other.lasso;
   lambda1 = other.lambda1;
   elasticNet = other.elasticNet;
@@ -224,6 +230,7 @@ inline LARS<ModelMatType>& LARS<ModelMatType>::operator=(
       other.matGram : &matGramInternal;
   matUtriCholFactor = std::move(other.matUtriCholFactor);
   useCholesky = other.useCholesky;
+  covarianceForm = other.covarianceForm;
   lasso = other.lasso;
   lambda1 = other.lambda1;
   elasticNet = other.elasticNet;
@@ -496,17 +503,79 @@ LARS<ModelMatType>::Train(const MatType& matX,
   ResponsesType yCentered;
 
   // dataRef is row-major.  We can reuse the given matX, but only if we don't
-  // need to do any transformations to it.
-  const MatType& dataRef =
-      (colMajor || fitIntercept || normalizeData) ? dataTrans : matX;
+  // need to do any transformations to it.  In covariance form, the data is
+  // never transformed and dataRef is empty.
+  const MatType& dataRef = (covarianceForm || colMajor || fitIntercept ||
+      normalizeData) ? dataTrans : matX;
   const ResponsesType& yRef =
       (fitIntercept) ? yCentered : y;
+  const size_t dims = (colMajor) ? matX.n_rows : matX.n_cols;
 
   arma::Col<ElemType> offsetX; // used only if fitting an intercept
   this->offsetY = 0.0; // used only if fitting an intercept
   arma::Col<ElemType> stdX; // used only if normalizing
 
-  if (colMajor)
+  // The correlations of the dimensions with the responses, X' * y.
+  arma::Col<ElemType> vecXTy;
+
+  if (covarianceForm)
+  {
+    // Compute the moments of the data in one pass; the transformations of the
+    // data are applied to the moments instead.  If a Gram matrix was given,
+    // only the variances of the dimensions are needed.
+    const bool computeGram = (matGram == &matGramInternal);
+    const size_t n = (colMajor) ? matX.n_cols : matX.n_rows;
+    const ElemType count = (ElemType) n;
+    DenseMatType scatter;
+    ElemType yMean;
+    ComputeMoments(matX, y, colMajor, computeGram, offsetX, yMean, scatter,
+        vecXTy);
+
+    if (normalizeData)
+    {
+      stdX = (computeGram) ? arma::Col<ElemType>(scatter.diag()) :
+          arma::Col<ElemType>(vectorise(scatter));
+      stdX = sqrt(stdX / (ElemType) (std::max(n, (size_t) 2) - 1));
+      stdX.replace(0.0, 1.0); // Make sure we don't divide by 0!
+    }
+
+    if (fitIntercept)
+    {
+      this->offsetY = yMean;
+    }
+    else
+    {
+      // Undo the centering.
+      vecXTy += (count * yMean) * offsetX;
+      if (computeGram)
+        scatter += count * (offsetX * offsetX.t());
+    }
+
+    if (normalizeData)
+    {
+      vecXTy /= stdX;
+      if (computeGram)
+      {
+        scatter.each_col() /= stdX;
+        scatter.each_row() /= stdX.t();
+      }
+    }
+
+    if (computeGram)
+    {
+      // If this is the elastic net problem, we will add lambda2 * I_n to the
+      // matrix.
+      matGramInternal = std::move(scatter);
+      if (elasticNet && !useCholesky)
+        matGramInternal.diag() += lambda2;
+    }
+    else if (matGram->n_rows != dims || matGram->n_cols != dims)
+    {
+      throw std::invalid_argument("LARS::Train(): the given Gram matrix does "
+          "not match the dimensionality of the data!");
+    }
+  }
+  else if (colMajor)
   {
     if (fitIntercept)
     {
@@ -556,24 +625,25 @@ LARS<ModelMatType>::Train(const MatType& matX,
     // dataTrans already points to matX so we don't need to do anything.
   }
 
-  if (fitIntercept)
+  if (fitIntercept && !covarianceForm)
   {
     this->offsetY = arma::mean(y);
     yCentered = y - this->offsetY;
   }
 
   // Compute X' * y.
-  arma::Col<ElemType> vecXTy = trans(yRef * dataRef);
+  if (!covarianceForm)
+    vecXTy = trans(yRef * dataRef);
 
   // Set up active set variables.  In the beginning, the active set has size 0
   // (all dimensions are inactive).
-  isActive.resize(dataRef.n_cols, false);
+  isActive.resize(dims, false);
 
   // Set up ignores set variables. Initialized empty.
-  isIgnored.resize(dataRef.n_cols, false);
+  isIgnored.resize(dims, false);
 
   // Initialize yHat and beta.
-  arma::Col<ElemType> beta(dataRef.n_cols);
+  arma::Col<ElemType> beta(dims);
   arma::Col<ElemType> yHat(dataRef.n_rows);
   arma::Col<ElemType> yHatDirection(dataRef.n_rows, arma::fill::none);
 
@@ -583,7 +653,7 @@ LARS<ModelMatType>::Train(const MatType& matX,
   arma::Col<ElemType> corr = vecXTy;
   ElemType maxCorr = 0;
   size_t changeInd = 0;
-  size_t lassocondInd = dataRef.n_cols;
+  size_t lassocondInd = dims;
   for (size_t i = 0; i < vecXTy.n_elem; ++i)
   {
     if (fabs(corr(i)) > maxCorr)
@@ -611,27 +681,24 @@ LARS<ModelMatType>::Train(const MatType& matX,
 
   // Compute the Gram matrix.  If this is the elastic net problem, we will add
   // lambda2 * I_n to the matrix.
-  if (matGram->n_elem != dataRef.n_cols * dataRef.n_cols)
+  if (!covarianceForm && matGram->n_elem != dims * dims)
   {
     // In this case, matGram should reference matGramInternal.
     matGramInternal = trans(dataRef) * dataRef;
 
     if (elasticNet && !useCholesky)
-    {
-      matGramInternal += lambda2 *
-          arma::eye<ModelMatType>(dataRef.n_cols, dataRef.n_cols);
-    }
+      matGramInternal += lambda2 * arma::eye<ModelMatType>(dims, dims);
   }
 
   // Main loop.
-  while (((activeSet.size() + ignoreSet.size()) < dataRef.n_cols) &&
+  while (((activeSet.size() + ignoreSet.size()) < dims) &&
          (maxCorr > tolerance))
   {
     // Compute the maximum correlation among inactive dimensions.
     maxCorr = 0;
     ElemType maxActiveCorr = 0;
     ElemType minActiveCorr = DBL_MAX;
-    for (size_t i = 0; i < dataRef.n_cols; ++i)
+    for (size_t i = 0; i < dims; ++i)
     {
       if ((!isActive[i]) && (!isIgnored[i]) && (fabs(corr(i)) > maxCorr))
       {
@@ -669,7 +736,7 @@ LARS<ModelMatType>::Train(const MatType& matX,
         // }
         // This is equivalent to the above 5 lines.
         arma::Col<ElemType> newGramCol = matGram->elem(
-            changeInd * dataRef.n_cols +
+            changeInd * dims +
             ConvTo<arma::uvec>::From(activeSet));
 
         CholeskyInsert((*matGram)(changeInd, changeInd), newGramCol);
@@ -783,20 +850,31 @@ LARS<ModelMatType>::Train(const MatType& matX,
     }
 
     // compute "equiangular" direction in output space
-    ComputeYHatDirection(dataRef, betaDirection, yHatDirection);
+    if (!covarianceForm)
+      ComputeYHatDirection(dataRef, betaDirection, yHatDirection);
 
     ElemType gamma = maxCorr / normalization;
 
     // If not all variables are active.
-    if ((activeSet.size() + ignoreSet.size()) < dataRef.n_cols)
+    if ((activeSet.size() + ignoreSet.size()) < dims)
     {
+      // In covariance form, the correlations of the dimensions with the
+      // direction are given by X' * X * betaDirection.
+      arma::Col<ElemType> dirCorrs;
+      if (covarianceForm)
+      {
+        dirCorrs = matGram->cols(ConvTo<arma::uvec>::From(activeSet)) *
+            betaDirection;
+      }
+
       // Compute correlations with direction.
-      for (size_t ind = 0; ind < dataRef.n_cols; ind++)
+      for (size_t ind = 0; ind < dims; ind++)
       {
         if (isActive[ind] || isIgnored[ind])
           continue;
 
-        const ElemType dirCorr = dot(dataRef.col(ind), yHatDirection);
+        const ElemType dirCorr = (covarianceForm) ? dirCorrs[ind] :
+            dot(dataRef.col(ind), yHatDirection);
         const ElemType val1 = (maxCorr - corr(ind)) / (normalization - dirCorr);
         const ElemType val2 = (maxCorr + corr(ind)) / (normalization + dirCorr);
 
@@ -824,7 +902,7 @@ LARS<ModelMatType>::Train(const MatType& matX,
     if (lasso)
     {
       lassocond = false;
-      lassocondInd = dataRef.n_cols;
+      lassocondInd = dims;
       ElemType lassoboundOnGamma = DBL_MAX;
       size_t activeIndToKickOut = -1;
 
@@ -848,7 +926,8 @@ LARS<ModelMatType>::Train(const MatType& matX,
     }
 
     // Update the prediction.
-    yHat += gamma * yHatDirection;
+    if (!covarianceForm)
+      yHat += gamma * yHatDirection;
 
     // Update the estimator.
     for (size_t i = 0; i < activeSet.size(); ++i)
@@ -876,9 +955,21 @@ LARS<ModelMatType>::Train(const MatType& matX,
       Deactivate(changeInd);
     }
 
-    corr = vecXTy - trans(dataRef) * yHat;
-    if (elasticNet)
-      corr -= lambda2 * beta;
+    if (covarianceForm)
+    {
+      // X' * yHat = X' * X * beta, and beta is zero outside of the active set.
+      // The internal Gram matrix may already include lambda2 * I_n.
+      const arma::uvec active = ConvTo<arma::uvec>::From(activeSet);
+      corr = vecXTy - matGram->cols(active) * beta.elem(active);
+      if (elasticNet && (useCholesky || matGram != &matGramInternal))
+        corr -= lambda2 * beta;
+    }
+    else
+    {
+      corr = vecXTy - trans(dataRef) * yHat;
+      if (elasticNet)
+        corr -= lambda2 * beta;
+    }
 
     ElemType curLambda = 0;
     for (size_t i = 0; i < activeSet.size(); ++i)
@@ -1308,6 +1399,119 @@ LARS<ModelMatType>::ComputeError(const MatType& matX,
     return accu(pow(y - Beta().t() * matX - Intercept(), 2.0));
 }
 
+template<typename ModelMatType>
+template<typename MatType, typename ResponsesType>
+inline void LARS<ModelMatType>::ComputeMoments(
+    const MatType& matX,
+    const ResponsesType& y,
+    const bool colMajor,
+    const bool computeGram,
+    arma::Col<ElemType>& means,
+    ElemType& yMean,
+    DenseMatType& scatter,
+    arma::Col<ElemType>& cross)
+{
+  const size_t n = (colMajor) ? matX.n_cols : matX.n_rows;
+  const size_t numBlocks = (n + BlockSize - 1) / BlockSize;
+
+  size_t count = 0;
+  means.clear();
+  yMean = 0;
+  scatter.clear();
+  cross.clear();
+
+  #pragma omp parallel
+  {
+    // The moments of the blocks of this thread.
+    size_t threadCount = 0;
+    arma::Col<ElemType> threadMeans, threadCross;
+    ElemType threadYMean = 0;
+    DenseMatType threadScatter;
+
+    DenseMatType block, blockScatter;
+    arma::Col<ElemType> blockMeans, blockCross;
+    arma::Row<ElemType> yBlock;
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min(begin + BlockSize, n) - 1;
+
+      // Center the block around its own means.
+      if (colMajor)
+        block = matX.cols(begin, end);
+      else
+        block = trans(matX.rows(begin, end));
+      blockMeans = arma::mean(block, 1);
+      block.each_col() -= blockMeans;
+
+      yBlock = y.subvec(begin, end);
+      const ElemType blockYMean = arma::mean(yBlock);
+      yBlock -= blockYMean;
+
+      if (computeGram)
+        blockScatter = block * block.t();
+      else
+        blockScatter = sum(square(block), 1);
+      blockCross = block * yBlock.t();
+
+      MergeMoments(end - begin + 1, blockMeans, blockYMean, blockScatter,
+          blockCross, threadCount, threadMeans, threadYMean, threadScatter,
+          threadCross);
+    }
+
+    #pragma omp critical
+    MergeMoments(threadCount, threadMeans, threadYMean, threadScatter,
+        threadCross, count, means, yMean, scatter, cross);
+  }
+}
+
+template<typename ModelMatType>
+inline void LARS<ModelMatType>::MergeMoments(
+    const size_t otherCount,
+    const arma::Col<ElemType>& otherMeans,
+    const ElemType otherYMean,
+    const DenseMatType& otherScatter,
+    const arma::Col<ElemType>& otherCross,
+    size_t& count,
+    arma::Col<ElemType>& means,
+    ElemType& yMean,
+    DenseMatType& scatter,
+    arma::Col<ElemType>& cross)
+{
+  if (otherCount == 0)
+    return;
+
+  if (count == 0)
+  {
+    count = otherCount;
+    means = otherMeans;
+    yMean = otherYMean;
+    scatter = otherScatter;
+    cross = otherCross;
+    return;
+  }
+
+  // This is the pairwise update of Chan, Golub and LeVeque, which is stable
+  // even when the means are large.
+  const size_t total = count + otherCount;
+  const ElemType weight = (ElemType) ((double) count * otherCount / total);
+  const ElemType ratio = (ElemType) ((double) otherCount / total);
+  const arma::Col<ElemType> delta = otherMeans - means;
+  const ElemType yDelta = otherYMean - yMean;
+
+  // The scatter is either a full matrix or only its diagonal.
+  if (scatter.n_rows == scatter.n_cols)
+    scatter += otherScatter + weight * (delta * delta.t());
+  else
+    scatter += otherScatter + weight * square(delta);
+  cross += otherCross + (weight * yDelta) * delta;
+  means += ratio * delta;
+  yMean += ratio * yDelta;
+  count = total;
+}
+
 /**
  * Serialize the LARS model.
  */
@@ -1425,6 +1629,11 @@ void LARS<ModelMatType>::serialize(Archive& ar, const uint32_t version)
     selectedActiveSet.clear();
     offsetY = 0.0;
   }
+
+  if (version > 1)
+    ar(CEREAL_NVP(covarianceForm));
+  else if (cereal::is_loading<Archive>())
+    covarianceForm = false;
 }
 
 } // namespace mlpack
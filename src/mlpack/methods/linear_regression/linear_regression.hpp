@@ -19,6 +19,8 @@
 // include the core later.
 #include <mlpack/prereqs.hpp>
 
+#include "normal_equations.hpp"
+
 namespace mlpack {
 
 /**
@@ -196,6 +198,22 @@ class LinearRegression
                  const std::optional<double> lambda = std::nullopt,
                  const std::optional<bool> intercept = std::nullopt);
 
+  /**
+   * Train the LinearRegression model on the statistics of a dataset, which
+   * were accumulated one chunk at a time (see NormalEquations), instead of on
+   * the dataset itself.  This gives the same model as training on all of the
+   * points at once, but the points never have to be held in memory together.
+   * Careful!  This will completely ignore and overwrite the existing model.
+   *
+   * @param stats Statistics of the points and responses to train on.
+   * @param lambda L2 regularization penalty parameter to use.
+   * @param intercept Whether or not to fit an intercept term.
+   * @return The least squares error on the accumulated points after training.
+   */
+  ElemType Train(const NormalEquations<ModelMatType>& stats,
+                 const std::optional<double> lambda = std::nullopt,
+                 const std::optional<bool> intercept = std::nullopt);
+
   /**
    * Calculate y_i for a single data point.
    *
@@ -170,6 +170,68 @@ LinearRegression<ModelMatType>::Train(const MatType& predictors,
   return ComputeError(predictors, responses);
 }
 
+template<typename ModelMatType>
+inline
+typename LinearRegression<ModelMatType>::ElemType
+LinearRegression<ModelMatType>::Train(
+    const NormalEquations<ModelMatType>& stats,
+    const std::optional<double> lambda,
+    const std::optional<bool> intercept)
+{
+  if (lambda.has_value())
+    this->lambda = lambda.value();
+
+  if (intercept.has_value())
+    this->intercept = intercept.value();
+
+  if (stats.Count() == 0)
+  {
+    throw std::invalid_argument("LinearRegression::Train(): no points have "
+        "been accumulated!");
+  }
+
+  using DenseMatType = typename NormalEquations<ModelMatType>::DenseMatType;
+  using DenseColType = typename NormalEquations<ModelMatType>::DenseColType;
+
+  const size_t d = stats.Dimensionality();
+  const ElemType n = (ElemType) stats.Count();
+  const ElemType l = (ElemType) this->lambda;
+  const DenseColType& means = stats.Means();
+  const ElemType responsesMean = stats.ResponsesMean();
+
+  DenseColType b;
+  if (this->intercept)
+  {
+    // The intercept is penalized like the other parameters, as in the batch
+    // version.  Eliminating it from the normal equations leaves a system in
+    // terms of the centered statistics only:
+    //
+    //   (S + lambda I + k mu mu^T) b = S_xy + k y_mean mu,
+    //
+    // with k = n lambda / (n + lambda); the intercept is then
+    // n (y_mean - mu^T b) / (n + lambda).
+    const ElemType k = n * l / (n + l);
+    DenseMatType cov = stats.Scatter() + k * (means * means.t());
+    cov.diag() += l;
+
+    b = arma::solve(cov, stats.Cross() + (k * responsesMean) * means);
+    parameters.set_size(d + 1);
+    parameters[0] = n * (responsesMean - arma::dot(means, b)) / (n + l);
+    parameters.subvec(1, d) = b;
+    return stats.MeanSquaredError(b, parameters[0]);
+  }
+  else
+  {
+    // Without an intercept, the uncentered statistics are needed.
+    DenseMatType cov = stats.Scatter() + n * (means * means.t());
+    cov.diag() += l;
+
+    b = arma::solve(cov, stats.Cross() + (n * responsesMean) * means);
+    parameters = b;
+    return stats.MeanSquaredError(b, 0);
+  }
+}
+
 template<typename ModelMatType>
 template<typename VecType>
 inline
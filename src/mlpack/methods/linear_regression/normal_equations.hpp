@@ -0,0 +1,174 @@
+/**
+ * @file methods/linear_regression/normal_equations.hpp
+ *
+ * Definition of NormalEquations, which accumulates the sufficient statistics
+ * of a least-squares problem over chunks of data, so that linear models can be
+ * trained on datasets that do not fit in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * NormalEquations holds the statistics of a set of points and responses that
+ * are needed to solve a (ridge) least-squares problem on them: the number of
+ * points, the means of the predictors and of the responses, and the centered
+ * scatter matrix X X^T, cross products X y^T, and sum of squares y y^T.  The
+ * statistics take O(d^2) memory, independent of the number of points, and are
+ * updated one chunk of points at a time, so they can be computed for datasets
+ * that do not fit in memory.  LinearRegression and BayesianLinearRegression
+ * can then be trained from them with no further pass over the data.
+ *
+ * Each chunk is split into blocks that are processed in parallel; every block
+ * is centered around its own means, and the moments of the blocks and of the
+ * chunks are merged with the pairwise update of Chan, Golub and LeVeque.  So,
+ * unlike sums of raw products, the statistics stay accurate when the means of
+ * the data are large compared to its spread, and accumulating the chunks one
+ * by one gives the same statistics (up to rounding) as one large chunk.
+ *
+ * @code
+ * // The dataset is split over several files; the last dimension of each file
+ * // holds the responses.
+ * std::vector<std::string> files = { "part0.csv", "part1.csv", "part2.csv" };
+ * size_t file = 0;
+ *
+ * NormalEquations<> stats;
+ * stats.Accumulate([&](arma::mat& predictors, arma::rowvec& responses)
+ * {
+ *   if (file == files.size())
+ *     return false;
+ *
+ *   data::Load(files[file++], predictors, true);
+ *   responses = predictors.row(predictors.n_rows - 1);
+ *   predictors.shed_row(predictors.n_rows - 1);
+ *   return true;
+ * });
+ *
+ * LinearRegression<> lr;
+ * lr.Train(stats, 0.1); // With lambda = 0.1.
+ * @endcode
+ *
+ * @tparam MatType Type of the model matrices (the statistics are dense).
+ */
+template<typename MatType = arma::mat>
+class NormalEquations
+{
+ public:
+  //! The element type of the statistics.
+  using ElemType = typename MatType::elem_type;
+  //! The dense matrix type of the scatter matrix.
+  using DenseMatType = typename GetDenseMatType<MatType>::type;
+  //! The dense vector type of the means and cross products.
+  using DenseColType = typename GetDenseColType<MatType>::type;
+  //! The dense row type of the responses of a chunk.
+  using DenseRowType = typename GetDenseRowType<MatType>::type;
+
+  /**
+   * Create empty statistics.  The dimensionality is set by the first chunk.
+   */
+  NormalEquations();
+
+  /**
+   * Add the given chunk of points (one per column) and their responses to the
+   * statistics.  The chunk must have the dimensionality of the earlier chunks.
+   *
+   * @param predictors Points of the chunk.
+   * @param responses Responses of the points of the chunk.
+   */
+  template<typename PredictorsType, typename ResponsesType>
+  void Update(const PredictorsType& predictors,
+              const ResponsesType& responses);
+
+  /**
+   * Add every chunk returned by the given function to the statistics.  The
+   * function is called as `nextChunk(predictors, responses)`, with a
+   * `DenseMatType` and a `DenseRowType` to store the next chunk in, and must
+   * return false when there are no more chunks.
+   *
+   * @param nextChunk Function that gives the chunks of data.
+   * @return Number of points that were added.
+   */
+  template<typename ChunkFunctionType>
+  size_t Accumulate(ChunkFunctionType&& nextChunk);
+
+  /**
+   * Add the statistics of another (disjoint) set of points to these, for
+   * instance ones that were computed on another machine.
+   *
+   * @param other Statistics to add.
+   */
+  void Merge(const NormalEquations& other);
+
+  //! Forget all points, so the next chunk may have any dimensionality.
+  void Reset();
+
+  /**
+   * Compute the mean squared error of the affine model `w^T x + offset` on the
+   * accumulated points, without another pass over them.
+   *
+   * @param w Weights of the model.
+   * @param offset Offset of the model.
+   */
+  ElemType MeanSquaredError(const DenseColType& w, const ElemType offset) const;
+
+  //! Get the number of accumulated points.
+  size_t Count() const { return count; }
+  //! Get the dimensionality of the points (0 if there are none).
+  size_t Dimensionality() const { return means.n_elem; }
+
+  //! Get the means of the predictors.
+  const DenseColType& Means() const { return means; }
+  //! Get the mean of the responses.
+  ElemType ResponsesMean() const { return responsesMean; }
+
+  //! Get the centered scatter matrix of the predictors.
+  const DenseMatType& Scatter() const { return scatter; }
+  //! Get the centered cross products of the predictors and the responses.
+  const DenseColType& Cross() const { return cross; }
+  //! Get the centered sum of squares of the responses.
+  ElemType ResponsesScatter() const { return responsesScatter; }
+
+  //! Serialize the statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  //! Merge the given moments into these.
+  void Merge(const size_t otherCount,
+             const DenseColType& otherMeans,
+             const ElemType otherResponsesMean,
+             const DenseMatType& otherScatter,
+             const DenseColType& otherCross,
+             const ElemType otherResponsesScatter);
+
+  //! Number of points in each block that is processed by one thread.
+  static constexpr size_t BlockSize = 1024;
+
+  //! Number of accumulated points.
+  size_t count;
+  //! Means of the predictors.
+  DenseColType means;
+  //! Mean of the responses.
+  ElemType responsesMean;
+  //! Centered scatter matrix of the predictors.
+  DenseMatType scatter;
+  //! Centered cross products of the predictors and the responses.
+  DenseColType cross;
+  //! Centered sum of squares of the responses.
+  ElemType responsesScatter;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "normal_equations_impl.hpp"
+
+#endif
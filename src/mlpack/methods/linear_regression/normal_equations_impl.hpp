@@ -0,0 +1,200 @@
+/**
+ * @file methods/linear_regression/normal_equations_impl.hpp
+ *
+ * Implementation of NormalEquations.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_REGRESSION_NORMAL_EQUATIONS_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "normal_equations.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+inline NormalEquations<MatType>::NormalEquations() :
+    count(0),
+    responsesMean(0),
+    responsesScatter(0)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+template<typename PredictorsType, typename ResponsesType>
+inline void NormalEquations<MatType>::Update(const PredictorsType& predictors,
+                                             const ResponsesType& responses)
+{
+  util::CheckSameSizes(predictors, responses, "NormalEquations::Update()");
+  if (predictors.n_cols == 0)
+    return;
+
+  if (count > 0 && predictors.n_rows != means.n_elem)
+  {
+    throw std::invalid_argument("NormalEquations::Update(): the chunk has " +
+        std::to_string(predictors.n_rows) + " dimensions, but the earlier "
+        "chunks have " + std::to_string(means.n_elem) + "!");
+  }
+
+  const size_t n = predictors.n_cols;
+  const size_t numBlocks = (n + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel
+  {
+    // The statistics of the blocks of this thread.
+    NormalEquations threadStats;
+
+    DenseMatType block;
+    DenseColType blockMeans;
+    DenseRowType blockResponses;
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = b * BlockSize;
+      const size_t end = std::min(begin + BlockSize, n) - 1;
+
+      // Center the block around its own means.
+      block = predictors.cols(begin, end);
+      blockMeans = arma::mean(block, 1);
+      block.each_col() -= blockMeans;
+
+      blockResponses = responses.cols(begin, end);
+      const ElemType blockResponsesMean = arma::mean(blockResponses);
+      blockResponses -= blockResponsesMean;
+
+      threadStats.Merge(end - begin + 1, blockMeans, blockResponsesMean,
+          block * block.t(), block * blockResponses.t(),
+          arma::dot(blockResponses, blockResponses));
+    }
+
+    #pragma omp critical
+    Merge(threadStats);
+  }
+}
+
+template<typename MatType>
+template<typename ChunkFunctionType>
+inline size_t NormalEquations<MatType>::Accumulate(
+    ChunkFunctionType&& nextChunk)
+{
+  DenseMatType predictors;
+  DenseRowType responses;
+  size_t points = 0;
+  while (nextChunk(predictors, responses))
+  {
+    Update(predictors, responses);
+    points += predictors.n_cols;
+  }
+
+  Log::Info << "NormalEquations::Accumulate(): added " << points << " points; "
+      << count << " points in total." << std::endl;
+  return points;
+}
+
+template<typename MatType>
+inline void NormalEquations<MatType>::Merge(const NormalEquations& other)
+{
+  if (count > 0 && other.count > 0 && other.means.n_elem != means.n_elem)
+  {
+    throw std::invalid_argument("NormalEquations::Merge(): the statistics "
+        "have " + std::to_string(other.means.n_elem) + " dimensions, but "
+        "these have " + std::to_string(means.n_elem) + "!");
+  }
+
+  Merge(other.count, other.means, other.responsesMean, other.scatter,
+      other.cross, other.responsesScatter);
+}
+
+template<typename MatType>
+inline void NormalEquations<MatType>::Reset()
+{
+  count = 0;
+  means.clear();
+  responsesMean = 0;
+  scatter.clear();
+  cross.clear();
+  responsesScatter = 0;
+}
+
+template<typename MatType>
+inline typename NormalEquations<MatType>::ElemType
+NormalEquations<MatType>::MeanSquaredError(const DenseColType& w,
+                                           const ElemType offset) const
+{
+  if (count == 0)
+    return 0;
+
+  util::CheckSameDimensionality(w, means.n_elem,
+      "NormalEquations::MeanSquaredError()", "weights");
+
+  // The squared residuals are the centered sum of squares of the residuals,
+  // plus the squared mean of the residuals for each point.
+  const ElemType residualsMean = responsesMean - offset - arma::dot(w, means);
+  const ElemType residualsScatter = responsesScatter -
+      2 * arma::dot(w, cross) + arma::dot(w, scatter * w);
+  return std::max(residualsScatter / (ElemType) count +
+      residualsMean * residualsMean, (ElemType) 0);
+}
+
+template<typename MatType>
+inline void NormalEquations<MatType>::Merge(
+    const size_t otherCount,
+    const DenseColType& otherMeans,
+    const ElemType otherResponsesMean,
+    const DenseMatType& otherScatter,
+    const DenseColType& otherCross,
+    const ElemType otherResponsesScatter)
+{
+  if (otherCount == 0)
+    return;
+
+  if (count == 0)
+  {
+    count = otherCount;
+    means = otherMeans;
+    responsesMean = otherResponsesMean;
+    scatter = otherScatter;
+    cross = otherCross;
+    responsesScatter = otherResponsesScatter;
+    return;
+  }
+
+  // This is the pairwise update of Chan, Golub and LeVeque, which is stable
+  // even when the means are large.
+  const size_t total = count + otherCount;
+  const ElemType weight = (ElemType) ((double) count * otherCount / total);
+  const ElemType ratio = (ElemType) ((double) otherCount / total);
+  const DenseColType delta = otherMeans - means;
+  const ElemType responsesDelta = otherResponsesMean - responsesMean;
+
+  scatter += otherScatter + weight * (delta * delta.t());
+  cross += otherCross + (weight * responsesDelta) * delta;
+  responsesScatter += otherResponsesScatter +
+      weight * responsesDelta * responsesDelta;
+  means += ratio * delta;
+  responsesMean += ratio * responsesDelta;
+  count = total;
+}
+
+template<typename MatType>
+template<typename Archive>
+void NormalEquations<MatType>::serialize(Archive& ar,
+                                         const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(count));
+  ar(CEREAL_NVP(means));
+  ar(CEREAL_NVP(responsesMean));
+  ar(CEREAL_NVP(scatter));
+  ar(CEREAL_NVP(cross));
+  ar(CEREAL_NVP(responsesScatter));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * @file methods/linear_svm/dual_coordinate_descent.hpp
+ *
+ * Definition of the DualCoordinateDescent optimizer, which trains a linear SVM
+ * by coordinate descent on the dual of its objective.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_HPP
+#define MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "linear_svm_function.hpp"
+
+namespace mlpack {
+
+/**
+ * DualCoordinateDescent minimizes the objective of a LinearSVMFunction by
+ * coordinate descent on its dual, as in LIBLINEAR:
+ *
+ * @code
+ * @inproceedings{hsieh2008dual,
+ *   title={A Dual Coordinate Descent Method for Large-scale Linear SVM},
+ *   author={Hsieh, C.-J. and Chang, K.-W. and Lin, C.-J. and Keerthi, S.S. and
+ *       Sundararajan, S.},
+ *   booktitle={Proceedings of the 25th International Conference on Machine
+ *       Learning (ICML '08)},
+ *   pages={408--415},
+ *   year={2008}
+ * }
+ * @endcode
+ *
+ * The dual of the multiclass hinge loss has one variable alpha_{i,m} in
+ * [0, 1 / (lambda n)] for each point i and each class m other than its label
+ * y_i, and the weights are w_k = sum_i (1[k = y_i] sum_m alpha_{i,m} -
+ * alpha_{i,k}) x_i.  Each dual variable is minimized exactly in turn, which
+ * only needs the column of its point, so each step costs O(nnz(x_i)); this is
+ * much faster than primal optimizers on sparse high-dimensional data.
+ *
+ * The variables are visited in random order.  With shrinking, the variables
+ * at a bound whose gradient shows that they will stay there are skipped; when
+ * the remaining ones have converged, all the variables are checked again.
+ *
+ * This can be used as the optimizer of LinearSVM::Train(), but it can't be
+ * used with other functions or with callbacks.  The optimization always starts
+ * from zero weights, and the intercept (if fitted) is regularized like the
+ * other weights, as in LinearSVMFunction.
+ */
+class DualCoordinateDescent
+{
+ public:
+  /**
+   * Construct the optimizer with the given parameters.
+   *
+   * @param maxIterations Maximum number of passes over the dual variables
+   *     (0 means no limit).
+   * @param tolerance The optimization stops when the difference between the
+   *     largest and smallest projected gradient of the dual is at most this.
+   * @param shrinking If true, skip the dual variables that will stay at a
+   *     bound.
+   */
+  DualCoordinateDescent(const size_t maxIterations = 1000,
+                        const double tolerance = 1e-3,
+                        const bool shrinking = true) :
+      maxIterations(maxIterations),
+      tolerance(tolerance),
+      shrinking(shrinking)
+  { /* Nothing to do. */ }
+
+  /**
+   * Minimize the objective of the given LinearSVMFunction, and store the
+   * weights in `parameters`.  Returns the final (primal) objective.
+   *
+   * @param function LinearSVMFunction to optimize.
+   * @param parameters Matrix to store the weights of the SVM in.
+   */
+  template<typename MatType, typename ModelMatType>
+  typename ModelMatType::elem_type Optimize(
+      LinearSVMFunction<MatType, ModelMatType>& function,
+      ModelMatType& parameters);
+
+  //! Get the maximum number of passes.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for convergence.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for convergence.
+  double& Tolerance() { return tolerance; }
+
+  //! Get whether shrinking is used.
+  bool Shrinking() const { return shrinking; }
+  //! Modify whether shrinking is used.
+  bool& Shrinking() { return shrinking; }
+
+ private:
+  //! Compute the dot product of point i and the given weights.
+  template<typename MatType, typename ElemType>
+  static ElemType Dot(const MatType& data, const size_t i, const ElemType* w);
+
+  //! Add step times point i to the given weights.
+  template<typename MatType, typename ElemType>
+  static void Add(const MatType& data,
+                  const size_t i,
+                  const ElemType step,
+                  ElemType* w);
+
+  //! Maximum number of passes.
+  size_t maxIterations;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Whether shrinking is used.
+  bool shrinking;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "dual_coordinate_descent_impl.hpp"
+
+#endif
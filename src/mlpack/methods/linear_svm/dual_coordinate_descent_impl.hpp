@@ -0,0 +1,235 @@
+/**
+ * @file methods/linear_svm/dual_coordinate_descent_impl.hpp
+ *
+ * Implementation of the DualCoordinateDescent optimizer for linear SVMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_IMPL_HPP
+#define MLPACK_METHODS_LINEAR_SVM_DUAL_COORDINATE_DESCENT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "dual_coordinate_descent.hpp"
+
+namespace mlpack {
+
+template<typename MatType, typename ModelMatType>
+typename ModelMatType::elem_type DualCoordinateDescent::Optimize(
+    LinearSVMFunction<MatType, ModelMatType>& function,
+    ModelMatType& parameters)
+{
+  using ElemType = typename ModelMatType::elem_type;
+
+  const MatType& data = function.Dataset();
+  const size_t dims = data.n_rows;
+  const size_t n = data.n_cols;
+  const size_t numClasses = function.NumClasses();
+  const bool fitIntercept = function.FitIntercept();
+  const ElemType delta = function.Delta();
+
+  if (function.Lambda() <= 0.0)
+  {
+    throw std::invalid_argument("DualCoordinateDescent::Optimize(): lambda "
+        "must be positive!");
+  }
+
+  // The dual variables are bounded by C = 1 / (lambda n), the weight of the
+  // hinge loss when the objective is scaled so that the regularization is
+  // ||W||^2 / 2.
+  const ElemType c = 1 / (function.Lambda() * n);
+
+  // The ground truth matrix has one nonzero per point, in the row of its label.
+  arma::Row<size_t> labels(n);
+  const auto& groundTruth = function.GroundTruth();
+  for (auto it = groundTruth.begin(); it != groundTruth.end(); ++it)
+    labels[it.col()] = it.row();
+
+  // Compute the squared norms of the points (with the constant feature of the
+  // intercept); each dual variable of point i has curvature 2 ||x_i||^2.
+  arma::Col<ElemType> squaredNorms(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    squaredNorms[i] = (fitIntercept ? 1 : 0);
+    if constexpr (arma::is_SpMat<MatType>::value)
+    {
+      for (auto it = data.begin_col(i); it != data.end_col(i); ++it)
+        squaredNorms[i] += (*it) * (*it);
+    }
+    else
+    {
+      squaredNorms[i] += arma::dot(data.col(i), data.col(i));
+    }
+  }
+
+  // With all dual variables at zero, the weights are zero.
+  parameters.zeros(fitIntercept ? dims + 1 : dims, numClasses);
+
+  // Dual variable (j, i) is the one of point i and the j'th class other than
+  // its label.  The first `active` elements of `index` are the variables that
+  // have not been shrunk.
+  arma::Mat<ElemType> alpha(numClasses - 1, n, arma::fill::zeros);
+  std::vector<size_t> index(alpha.n_elem);
+  std::iota(index.begin(), index.end(), 0);
+  size_t active = index.size();
+
+  // The largest and smallest projected gradients of the last pass, used for
+  // shrinking.
+  constexpr ElemType inf = std::numeric_limits<ElemType>::infinity();
+  ElemType lastMaxGradient = inf;
+  ElemType lastMinGradient = -inf;
+
+  size_t iteration = 0;
+  for (; iteration != maxIterations; ++iteration)
+  {
+    ElemType maxGradient = -inf;
+    ElemType minGradient = inf;
+    std::shuffle(index.begin(), index.begin() + active, RandGen());
+
+    size_t s = 0;
+    while (s < active)
+    {
+      const size_t i = index[s] / (numClasses - 1);
+      const size_t j = index[s] % (numClasses - 1);
+      const size_t y = labels[i];
+      const size_t m = (j < y) ? j : j + 1;
+      ElemType& a = alpha(j, i);
+
+      // The gradient of the dual with respect to alpha_{i,m} is minus the
+      // margin violation of class m.
+      ElemType* wy = parameters.colptr(y);
+      ElemType* wm = parameters.colptr(m);
+      ElemType gradient = Dot(data, i, wy) - Dot(data, i, wm) - delta;
+      if (fitIntercept)
+        gradient += wy[dims] - wm[dims];
+
+      ElemType projectedGradient = 0;
+      if (a == 0)
+      {
+        if (shrinking && gradient > lastMaxGradient)
+        {
+          std::swap(index[s], index[--active]);
+          continue;
+        }
+        else if (gradient < 0)
+        {
+          projectedGradient = gradient;
+        }
+      }
+      else if (a == c)
+      {
+        if (shrinking && gradient < lastMinGradient)
+        {
+          std::swap(index[s], index[--active]);
+          continue;
+        }
+        else if (gradient > 0)
+        {
+          projectedGradient = gradient;
+        }
+      }
+      else
+      {
+        projectedGradient = gradient;
+      }
+
+      maxGradient = std::max(maxGradient, projectedGradient);
+      minGradient = std::min(minGradient, projectedGradient);
+      ++s;
+
+      if (projectedGradient == 0)
+        continue;
+
+      // Minimize the dual along alpha_{i,m}, and update the weights of the
+      // label and of class m.
+      const ElemType newA = (squaredNorms[i] > 0) ?
+          std::min(std::max(a - gradient / (2 * squaredNorms[i]),
+              ElemType(0)), c) : c;
+      const ElemType step = newA - a;
+      a = newA;
+      Add(data, i, step, wy);
+      Add(data, i, -step, wm);
+      if (fitIntercept)
+      {
+        wy[dims] += step;
+        wm[dims] -= step;
+      }
+    }
+
+    if (maxGradient - minGradient <= tolerance)
+    {
+      // If some variables were shrunk, check all of them again before
+      // stopping.
+      if (active == index.size())
+        break;
+
+      active = index.size();
+      lastMaxGradient = inf;
+      lastMinGradient = -inf;
+      continue;
+    }
+
+    lastMaxGradient = (maxGradient <= 0) ? inf : maxGradient;
+    lastMinGradient = (minGradient >= 0) ? -inf : minGradient;
+  }
+
+  if (iteration == maxIterations)
+  {
+    Log::Info << "DualCoordinateDescent::Optimize(): maximum number of "
+        << "iterations (" << maxIterations << ") reached; terminating "
+        << "optimization." << std::endl;
+  }
+  else
+  {
+    Log::Info << "DualCoordinateDescent::Optimize(): converged after "
+        << iteration + 1 << " passes." << std::endl;
+  }
+
+  return function.Evaluate(parameters);
+}
+
+template<typename MatType, typename ElemType>
+ElemType DualCoordinateDescent::Dot(const MatType& data,
+                                    const size_t i,
+                                    const ElemType* w)
+{
+  ElemType result = 0;
+  if constexpr (arma::is_SpMat<MatType>::value)
+  {
+    for (auto it = data.begin_col(i); it != data.end_col(i); ++it)
+      result += (*it) * w[it.row()];
+  }
+  else
+  {
+    const typename MatType::elem_type* x = data.colptr(i);
+    for (size_t d = 0; d < data.n_rows; ++d)
+      result += x[d] * w[d];
+  }
+
+  return result;
+}
+
+template<typename MatType, typename ElemType>
+void DualCoordinateDescent::Add(const MatType& data,
+                                const size_t i,
+                                const ElemType step,
+                                ElemType* w)
+{
+  if constexpr (arma::is_SpMat<MatType>::value)
+  {
+    for (auto it = data.begin_col(i); it != data.end_col(i); ++it)
+      w[it.row()] += step * (*it);
+  }
+  else
+  {
+    const typename MatType::elem_type* x = data.colptr(i);
+    for (size_t d = 0; d < data.n_rows; ++d)
+      w[d] += step * x[d];
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -16,6 +16,7 @@
 #include <ensmallen.hpp>
 
 #include "linear_svm_function.hpp"
+#include "dual_coordinate_descent.hpp"
 
 namespace mlpack {
 
@@ -168,15 +168,24 @@ class LinearSVMFunction
   ParametersType& InitialPoint() { return initialPoint; }
 
   //! Get the dataset.
-  const SparseMatType& Dataset() const { return dataset; }
+  const MatType& Dataset() const { return dataset; }
   //! Modify the dataset.
-  SparseMatType& Dataset() { return dataset; }
+  MatType& Dataset() { return dataset; }
+
+  //! Get the label matrix (one nonzero per point, in the row of its label).
+  const SparseMatType& GroundTruth() const { return groundTruth; }
+
+  //! Gets the number of classes.
+  size_t NumClasses() const { return numClasses; }
 
   //! Sets the regularization parameter.
   double& Lambda() { return lambda; }
   //! Gets the regularization parameter.
   double Lambda() const { return lambda; }
 
+  //! Gets the margin between the correct class and all other classes.
+  double Delta() const { return delta; }
+
   //! Gets the intercept flag.
   bool FitIntercept() const { return fitIntercept; }
 
@@ -184,6 +193,25 @@ class LinearSVMFunction
   size_t NumFunctions() const;
 
  private:
+  /**
+   * Compute the objective (the hinge loss plus the regularization) on the
+   * given datapoints, and its gradient if `gradient` is not NULL.  The points
+   * are processed in blocks, in parallel with OpenMP.
+   *
+   * @param parameters The parameters of the SVM.
+   * @param firstId Index of the first datapoint to use.
+   * @param batchSize Number of datapoints to use.
+   * @param gradient If not NULL, the gradient is stored here.
+   */
+  template<typename GradType>
+  ElemType BatchObjective(const ParametersType& parameters,
+                          const size_t firstId,
+                          const size_t batchSize,
+                          GradType* gradient) const;
+
+  //! Number of datapoints in each block of BatchObjective().
+  static constexpr size_t BlockSize = 1024;
+
   //! The initial point, from which to start the optimization.
   ParametersType initialPoint;
 
@@ -148,50 +148,7 @@ typename LinearSVMFunction<MatType, ParametersType>::ElemType
 LinearSVMFunction<MatType, ParametersType>::Evaluate(
     const ParametersType& parameters) const
 {
-  // The objective function is the hinge loss function and it is
-  // calculated over all the training examples.
-
-  // Calculate the loss and regularization terms.
-  // L_i = Σ_i Σ_m max(0, Δ + (w_m x_i + b_m) - (w_{y_i} x_i + b_{y_i}))
-  // where (m != y_i)
-  ElemType loss, regularization;
-
-  // Scores for each class are evaluated.
-  DenseMatType scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    // When using `fitIntercept` we need to add the `b_i` term explicitly.
-    // The first `parameters.n_rows - 1` rows of parameters holds the value
-    // of Weights `w_i`, and the last row holds `b_i`.
-    // On calculating the score, we add `b_i` term to each element of
-    // `i_th` row of `scores`.
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
-  }
-
-  // Evaluate the margin by the following steps:
-  //  - Subtracting the score of correct class from all the class scores.
-  //  - Adding the margin parameter `delta`.
-  //  - Removing the `delta` parameter from correct class label in each
-  //    column.
-  DenseMatType margin = scores - (repmat(ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // The Hinge Loss Function
-  loss = accu(arma::clamp(margin, 0.0, DBL_MAX)) / dataset.n_cols;
-
-  // Adding the regularization term.
-  constexpr ElemType half = ((ElemType) 0.5);
-  regularization = half * lambda * dot(parameters, parameters);
-
-  return loss + regularization;
+  return BatchObjective<DenseMatType>(parameters, 0, dataset.n_cols, NULL);
 }
 
 template<typename MatType, typename ParametersType>
@@ -201,41 +158,7 @@ LinearSVMFunction<MatType, ParametersType>::Evaluate(
     const size_t firstId,
     const size_t batchSize) const
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  ElemType loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  DenseMatType scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  DenseMatType margin = scores - (repmat(ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // The Hinge Loss Function
-  loss = accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= batchSize;
-
-  // Adding the regularization term.
-  constexpr ElemType half = ((ElemType) 0.5);
-  regularization = half * lambda * dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return BatchObjective<DenseMatType>(parameters, firstId, batchSize, NULL);
 }
 
 template<typename MatType, typename ParametersType>
@@ -244,61 +167,7 @@ void LinearSVMFunction<MatType, ParametersType>::Gradient(
     const ParametersType& parameters,
     GradType& gradient) const
 {
-  // The objective is to minimize the loss, which is evaluated as the sum
-  // of all the positive elements of `margin` matrix.
-  // So, we focus of these positive elements and reduce them.
-  // Also, we need to increase the score of the correct class.
-
-  // Scores for each class are evaluated.
-  DenseMatType scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + repmat(parameters.row(dataset.n_rows).t(), 1, dataset.n_cols);
-  }
-
-  DenseMatType margin = scores - (repmat(ones(numClasses).t()
-      * (scores % groundTruth), numClasses, 1)) + delta
-      - (delta * groundTruth);
-
-  // An element of `mask` matrix holds `1` corresponding to
-  // each positive element of `margin` matrix.
-  DenseMatType mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  DenseMatType difference = groundTruth
-      % (-repmat(sum(mask), numClasses, 1)) + mask;
-
-  // The gradient is evaluated as follows:
-  //  - Add `x_i` to `w_j` if `margin_i_m`is positive.
-  //  - Subtract `x_i` from `w_y_i` for each positive
-  //    `margin_i_j`.
-  //  - Take the average over the size of dataset.
-  //  - Add the regularization parameter.
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        ones<DenseRowType>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  BatchObjective(parameters, 0, dataset.n_cols, &gradient);
 }
 
 template<typename MatType, typename ParametersType>
@@ -309,53 +178,7 @@ void LinearSVMFunction<MatType, ParametersType>::Gradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Scores for each class are evaluated.
-  DenseMatType scores;
-
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + repmat(parameters.row(dataset.n_rows).t(), 1, batchSize);
-  }
-
-  DenseMatType margin = scores - (repmat(ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  DenseMatType mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  DenseMatType difference = groundTruth.cols(firstId, lastId)
-      % (-repmat(sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        ones<DenseRowType>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
+  BatchObjective(parameters, firstId, batchSize, &gradient);
 }
 
 template<typename MatType, typename ParametersType>
@@ -365,63 +188,7 @@ LinearSVMFunction<MatType, ParametersType>::EvaluateWithGradient(
     const ParametersType& parameters,
     GradType& gradient) const
 {
-  ElemType loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  DenseMatType scores;
-
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset;
-  }
-  else
-  {
-    scores = parameters.rows(0, dataset.n_rows - 1).t() * dataset
-        + repmat(parameters.row(dataset.n_rows).t(), 1,
-        dataset.n_cols);
-  }
-
-  DenseMatType margin = scores - (repmat(
-      ones<DenseColType>(numClasses).t() * (scores % groundTruth),
-      numClasses, 1)) + delta - (delta * groundTruth);
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  DenseMatType mask = margin.for_each([](ElemType& val)
-      { val = (val > 0) ? 1: 0; });
-
-  DenseMatType difference = groundTruth
-      % (-repmat(sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset * difference.t();
-  }
-  else
-  {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-            dataset * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-            ones<DenseRowType>(dataset.n_cols) * difference.t();
-  }
-
-  gradient /= dataset.n_cols;
-
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= dataset.n_cols;
-
-  // Adding the regularization term.
-  constexpr ElemType half = ((ElemType) 0.5);
-  regularization = half * lambda * dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return BatchObjective(parameters, 0, dataset.n_cols, &gradient);
 }
 
 template<typename MatType, typename ParametersType>
@@ -433,68 +200,119 @@ LinearSVMFunction<MatType, ParametersType>::EvaluateWithGradient(
     GradType& gradient,
     const size_t batchSize) const
 {
-  const size_t lastId = firstId + batchSize - 1;
-
-  // Calculate the loss and regularization terms.
-  ElemType loss, regularization, cost;
-
-  // Scores for each class are evaluated.
-  DenseMatType scores;
+  return BatchObjective(parameters, firstId, batchSize, &gradient);
+}
 
-  // Check intercept condition.
-  if (!fitIntercept)
-  {
-    scores = parameters.t() * dataset.cols(firstId, lastId);
-  }
-  else
+template<typename MatType, typename ParametersType>
+template<typename GradType>
+typename LinearSVMFunction<MatType, ParametersType>::ElemType
+LinearSVMFunction<MatType, ParametersType>::BatchObjective(
+    const ParametersType& parameters,
+    const size_t firstId,
+    const size_t batchSize,
+    GradType* gradient) const
+{
+  // The objective function is the hinge loss function
+  //   L_i = sum_{m != y_i} max(0, delta + s_m(x_i) - s_y_i(x_i)),
+  // with the scores s_m(x) = w_m x + b_m, averaged over the datapoints, plus
+  // the regularization.  Each positive term adds x_i to the gradient of w_m,
+  // and subtracts x_i from the gradient of w_y_i.
+  const size_t dims = dataset.n_rows;
+  const size_t numBlocks = (batchSize + BlockSize - 1) / BlockSize;
+
+  // The ground truth matrix has one nonzero in each column, so the label of
+  // point i is the row index of nonzero i.
+  groundTruth.sync();
+  const arma::uword* labels = groundTruth.row_indices;
+
+  if (gradient)
+    gradient->zeros(arma::size(parameters));
+
+  ElemType loss = 0;
+  #pragma omp parallel reduction(+:loss)
   {
-    scores = parameters.rows(0, dataset.n_rows - 1).t()
-        * dataset.cols(firstId, lastId)
-        + repmat(parameters.row(dataset.n_rows).t(), 1, (lastId - firstId + 1));
+    // The gradient of the blocks of this thread.
+    DenseMatType threadGradient;
+    if (gradient)
+      threadGradient.zeros(arma::size(parameters));
+
+    DenseMatType scores;
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t begin = firstId + b * BlockSize;
+      const size_t end = std::min(begin + BlockSize, firstId + batchSize) - 1;
+
+      // Scores for each class are evaluated.  When using `fitIntercept`, the
+      // last row of the parameters holds the intercepts `b_m`.
+      if (!fitIntercept)
+      {
+        scores = parameters.t() * dataset.cols(begin, end);
+      }
+      else
+      {
+        scores = parameters.rows(0, dims - 1).t() * dataset.cols(begin, end);
+        scores.each_col() += parameters.row(dims).t();
+      }
+
+      // Overwrite the scores with the coefficient of each point in the
+      // gradient of each class.
+      for (size_t i = 0; i < scores.n_cols; ++i)
+      {
+        const size_t label = labels[begin + i];
+        const ElemType correct = scores(label, i);
+        ElemType positive = 0;
+        for (size_t m = 0; m < numClasses; ++m)
+        {
+          const ElemType margin = scores(m, i) - correct + delta;
+          if (m != label && margin > 0)
+          {
+            loss += margin;
+            scores(m, i) = 1;
+            ++positive;
+          }
+          else
+          {
+            scores(m, i) = 0;
+          }
+        }
+        scores(label, i) = -positive;
+      }
+
+      if (gradient)
+      {
+        if (!fitIntercept)
+        {
+          threadGradient += dataset.cols(begin, end) * scores.t();
+        }
+        else
+        {
+          threadGradient.rows(0, dims - 1) +=
+              dataset.cols(begin, end) * scores.t();
+          threadGradient.row(dims) += sum(scores, 1).t();
+        }
+      }
+    }
+
+    if (gradient)
+    {
+      #pragma omp critical
+      *gradient += threadGradient;
+    }
   }
 
-  DenseMatType margin = scores - (repmat(ones(numClasses).t()
-      * (scores % groundTruth.cols(firstId, lastId)), numClasses, 1))
-      + delta - (delta * groundTruth.cols(firstId, lastId));
-
-  // For each sample, find the total number of classes where
-  // ( margin > 0 ).
-  DenseMatType mask = margin.for_each([](arma::mat::elem_type& val)
-      { val = (val > 0) ? 1: 0; });
-
-  DenseMatType difference = groundTruth.cols(firstId, lastId)
-      % (-repmat(sum(mask), numClasses, 1)) + mask;
-
-  // Check intercept condition
-  if (!fitIntercept)
-  {
-    gradient = dataset.cols(firstId, lastId) * difference.t();
-  }
-  else
+  if (gradient)
   {
-    gradient.set_size(arma::size(parameters));
-    gradient.submat(0, 0, parameters.n_rows - 2, parameters.n_cols - 1) =
-        dataset.cols(firstId, lastId) * difference.t();
-    gradient.row(parameters.n_rows - 1) =
-        ones<DenseRowType>(batchSize) * difference.t();
-  }
-
-  gradient /= batchSize;
-
+    *gradient /= batchSize;
 
-  // Adding the regularization contribution to the gradient.
-  gradient += lambda * parameters;
-
-  // The Hinge Loss Function
-  loss = accu(arma::clamp(margin, 0.0, DBL_MAX));
-  loss /= batchSize;
+    // Adding the regularization contribution to the gradient.
+    *gradient += lambda * parameters;
+  }
 
   // Adding the regularization term.
   constexpr ElemType half = ((ElemType) 0.5);
-  regularization = half * lambda * dot(parameters, parameters);
-
-  cost = loss + regularization;
-  return cost;
+  return loss / batchSize + half * lambda * dot(parameters, parameters);
 }
 
 template<typename MatType, typename ParametersType>
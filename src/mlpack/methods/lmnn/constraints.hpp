@@ -161,7 +161,9 @@ class Constraints
   /**
    * Calculates k differently labeled nearest neighbors & distances to
    * impostors for some points of dataset and writes them back to passed
-   * matrices.
+   * matrices.  Only the classes of the given points are searched, and a
+   * brute-force search is used instead of a tree when a class has only a few
+   * points to query.
    *
    * @param outputNeighbors Coordinates matrix to store impostors.
    * @param outputDistance matrix to store distance.
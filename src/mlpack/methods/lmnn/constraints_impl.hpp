@@ -139,6 +139,8 @@ void Constraints<MatType, LabelsType, DistanceType>::TargetNeighbors(
   {
     // Calculate Target Neighbors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with same class points as both reference
     // set and query set.
@@ -265,6 +267,8 @@ void Constraints<MatType, LabelsType, DistanceType>::Impostors(
   {
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
@@ -315,6 +319,8 @@ void Constraints<MatType, LabelsType, DistanceType>::Impostors(
   {
     // Calculate impostors.
     subIndexSame = arma::find(sublabels == uniqueLabels[i]);
+    if (subIndexSame.n_elem == 0)
+      continue;
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
@@ -350,26 +356,37 @@ void Constraints<MatType, LabelsType, DistanceType>::Impostors(
   // Perform pre-calculation. If neccesary.
   Precalculate(labels);
 
-  // KNN instance.
-  KNN knn;
+  // Nothing to do if no point needs new impostors.
+  if (numPoints == 0)
+    return;
 
   UMatType neighbors;
   MatType distances;
 
   // Vectors to store indices.
   UVecType subIndexSame;
+  const UVecType queryPoints = points.head(numPoints);
 
   for (size_t i = 0; i < uniqueLabels.n_cols; ++i)
   {
     // Calculate impostors.
-    subIndexSame = arma::find(labels.cols(points.head(numPoints)) ==
-        uniqueLabels[i]);
+    subIndexSame = queryPoints.elem(arma::find(labels.cols(queryPoints) ==
+        uniqueLabels[i]));
+
+    // Don't build a tree for a class without any point to query.
+    if (subIndexSame.n_elem == 0)
+      continue;
+
+    // When only a few points have to be re-queried, a brute-force search is
+    // cheaper than building a tree on the reference set.
+    const bool naive = (subIndexSame.n_elem <=
+        std::log2((double) indexDiff[i].n_elem));
+    KNN knn(naive ? NAIVE_MODE : DUAL_TREE_MODE);
 
     // Perform KNN search with differently labeled points as reference
     // set and same class points as query set.
     knn.Train(dataset.cols(indexDiff[i]));
-    knn.Search(dataset.cols(points.elem(subIndexSame)),
-        k, neighbors, distances);
+    knn.Search(dataset.cols(subIndexSame), k, neighbors, distances);
 
     // Re-order neighbors on the basis of increasing norm in case
     // of ties among distances.
@@ -380,8 +397,8 @@ void Constraints<MatType, LabelsType, DistanceType>::Impostors(
       neighbors(j) = indexDiff[i].at(neighbors(j));
 
     // Store impostors.
-    outputNeighbors.cols(points.elem(subIndexSame)) = neighbors;
-    outputDistance.cols(points.elem(subIndexSame)) = distances;
+    outputNeighbors.cols(subIndexSame) = neighbors;
+    outputDistance.cols(subIndexSame) = distances;
   }
 }
 
@@ -505,76 +505,88 @@ void LMNNFunction<MatType, LabelsType, DistanceType>::Gradient(
   // Calculate gradient due to target neighbors.
   MatType cij = pCij;
 
-  // Calculate gradient due to impostors.
+  // Calculate gradient due to impostors.  Each thread accumulates the outer
+  // products of its points into its own matrix; the caches are only written
+  // for the point being processed.
   MatType cil = zeros<MatType>(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel
   {
-    for (int j = k - 1; j >= 0; j--)
+    MatType threadCil = zeros<MatType>(dataset.n_rows, dataset.n_rows);
+
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (int j = k - 1; j >= 0; j--)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        ElemType eval = 0;
-
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          ElemType eval = 0;
 
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % updateInterval == 0)
+          // Bounds for eval.
+          if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
           {
-            eval = distance.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distanceMat(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = distance.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   distance.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % updateInterval == 0)
+            {
+              eval = distance.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distanceMat(l, i);
+            }
+            else
+            {
+              eval = distance.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     distance.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        // Reset cache.
-        if (eval > -1)
-        {
-          // update bound.
-          evalOld(l, j, i) = 0;
-          maxImpNorm(l, i) = 0;
-        }
+          // Reset cache.
+          if (eval > -1)
+          {
+            // update bound.
+            evalOld(l, j, i) = 0;
+            maxImpNorm(l, i) = 0;
+          }
 
-        // Caculate gradient due to impostors.
-        VecType diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * trans(diff);
+          // Caculate gradient due to impostors.
+          VecType diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+          threadCil += diff * trans(diff);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * trans(diff);
+          diff = dataset.col(i) - dataset.col(impostors(l, i));
+          threadCil -= diff * trans(diff);
+        }
       }
     }
+
+    #pragma omp critical(LMNNGradientReduce)
+    cil += threadCil;
   }
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
@@ -782,78 +794,94 @@ LMNNFunction<MatType, LabelsType, DistanceType>::EvaluateWithGradient(
   // Calculate gradient due to target neighbors.
   MatType cij = pCij;
 
-  // Calculate gradient due to impostors.
+  // Calculate gradient due to impostors.  Each thread accumulates the cost and
+  // the outer products of its points separately; the caches are only written
+  // for the point being processed.
   MatType cil = zeros<MatType>(dataset.n_rows, dataset.n_rows);
 
-  for (size_t i = 0; i < dataset.n_cols; ++i)
+  #pragma omp parallel
   {
-    for (size_t j = 0; j < k ; ++j)
-    {
-      // Calculate cost due to distance between target neighbors & data point.
-      ElemType eval = distance.Evaluate(transformedDataset.col(i),
-                        transformedDataset.col(targetNeighbors(j, i)));
-      cost += (1 - regularization) * eval;
-    }
+    MatType threadCil = zeros<MatType>(dataset.n_rows, dataset.n_rows);
+    ElemType threadCost = 0;
 
-    for (int j = k - 1; j >= 0; j--)
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < dataset.n_cols; ++i)
     {
-      // Bound constraints to avoid uneccesary computation.
-      for (size_t l = 0, bp = k; l < bp ; l++)
+      for (size_t j = 0; j < k ; ++j)
       {
-        // Calculate cost due to {data point, target neighbors, impostors}
-        // triplets.
-        ElemType eval = 0;
+        // Calculate cost due to distance between target neighbors & data point.
+        ElemType eval = distance.Evaluate(transformedDataset.col(i),
+                          transformedDataset.col(targetNeighbors(j, i)));
+        threadCost += (1 - regularization) * eval;
+      }
 
-        // Bounds for eval.
-        if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
+      for (int j = k - 1; j >= 0; j--)
+      {
+        // Bound constraints to avoid uneccesary computation.
+        for (size_t l = 0, bp = k; l < bp ; l++)
         {
-          // Update cache max impostor norm.
-          maxImpNorm(l, i) = std::max(maxImpNorm(l, i), norm(impostors(l, i)));
+          // Calculate cost due to {data point, target neighbors, impostors}
+          // triplets.
+          ElemType eval = 0;
 
-          eval = evalOld(l, j, i) + transformationDiff *
-              (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
-              2 * norm(i));
-        }
-
-        // Calculate exact eval value.
-        if (eval > -1)
-        {
-          if (iteration - 1 % updateInterval == 0)
+          // Bounds for eval.
+          if (!transformationOld.is_empty() && evalOld(l, j, i) < -1)
           {
-            eval = distance.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                 distanceMat(l, i);
+            // Update cache max impostor norm.
+            maxImpNorm(l, i) = std::max(maxImpNorm(l, i),
+                norm(impostors(l, i)));
+
+            eval = evalOld(l, j, i) + transformationDiff *
+                (norm(targetNeighbors(j, i)) + maxImpNorm(l, i) +
+                2 * norm(i));
           }
-          else
+
+          // Calculate exact eval value.
+          if (eval > -1)
           {
-            eval = distance.Evaluate(transformedDataset.col(i),
-                     transformedDataset.col(targetNeighbors(j, i))) -
-                   distance.Evaluate(transformedDataset.col(i),
-                       transformedDataset.col(impostors(l, i)));
+            if (iteration - 1 % updateInterval == 0)
+            {
+              eval = distance.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                   distanceMat(l, i);
+            }
+            else
+            {
+              eval = distance.Evaluate(transformedDataset.col(i),
+                       transformedDataset.col(targetNeighbors(j, i))) -
+                     distance.Evaluate(transformedDataset.col(i),
+                         transformedDataset.col(impostors(l, i)));
+            }
           }
-        }
 
-        // Update cache eval value.
-        evalOld(l, j, i) = eval;
+          // Update cache eval value.
+          evalOld(l, j, i) = eval;
 
-        // Check bounding condition.
-        if (eval <= -1)
-        {
-          // update bound.
-          bp = l;
-          break;
-        }
+          // Check bounding condition.
+          if (eval <= -1)
+          {
+            // update bound.
+            bp = l;
+            break;
+          }
 
-        cost += regularization * (1 + eval);
+          threadCost += regularization * (1 + eval);
 
-        // Caculate gradient due to impostors.
-        VecType diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
-        cil += diff * trans(diff);
+          // Caculate gradient due to impostors.
+          VecType diff = dataset.col(i) - dataset.col(targetNeighbors(j, i));
+          threadCil += diff * trans(diff);
 
-        diff = dataset.col(i) - dataset.col(impostors(l, i));
-        cil -= diff * trans(diff);
+          diff = dataset.col(i) - dataset.col(impostors(l, i));
+          threadCil -= diff * trans(diff);
+        }
       }
     }
+
+    #pragma omp critical(LMNNEvaluateWithGradientReduce)
+    {
+      cil += threadCil;
+      cost += threadCost;
+    }
   }
 
   gradient = 2 * transformation * ((1 - regularization) * cij +
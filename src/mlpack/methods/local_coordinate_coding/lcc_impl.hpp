@@ -126,36 +126,40 @@ inline void LocalCoordinateCoding<MatType>::Encode(const MatType& data,
       data.n_cols) + repmat(sum(square(data)), atoms, 1) - 2 * trans(dictionary)
       * data);
 
-  MatType dictGram = trans(dictionary) * dictionary;
-  MatType dictGramTD(dictGram.n_rows, dictGram.n_cols);
+  // The Gram matrix is computed only once, and shared by all points.
+  const MatType dictGram = trans(dictionary) * dictionary;
 
+  Log::Debug << "Encoding " << data.n_cols << " points." << std::endl;
+
+  // Each point is an independent LARS problem, so the points are encoded in
+  // parallel, with one LARS object (and workspace) for each thread.
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
-    {
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-    }
-
-    ColType invW = invSqDists.unsafe_col(i);
-    MatType dictPrime = dictionary * diagmat(invW);
-
-    MatType dictGramTD = diagmat(invW) * dictGram * diagmat(invW);
-
-    bool useCholesky = false;
+    const bool useCholesky = false;
     // Normalization and fitting and intercept are disabled.
     const double tol = std::is_same_v<typename MatType::elem_type, float> ?
         1e-8 : 1e-16;
     LARS<MatType> lars(useCholesky, 0.5 * lambda, 0, tol, false, false);
+    MatType dictPrime(dictionary.n_rows, dictionary.n_cols);
+    MatType dictGramTD(dictGram.n_rows, dictGram.n_cols);
 
-    // Run LARS for this point, by making an alias of the point and passing
-    // that.
-    ColType beta = codes.unsafe_col(i);
-    RowType responses = data.unsafe_col(i).t();
-    lars.Train(dictPrime, responses, false, useCholesky, dictGramTD);
-    beta = lars.Beta();
-    beta %= invW; // Remember, beta is an alias of codes.col(i).
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+    {
+      ColType invW = invSqDists.unsafe_col(i);
+      dictPrime = dictionary.each_row() % invW.t();
+      dictGramTD = dictGram.each_col() % invW;
+      dictGramTD.each_row() %= invW.t();
+
+      // Run LARS for this point, by making an alias of the point and passing
+      // that.
+      ColType beta = codes.unsafe_col(i);
+      RowType responses = data.unsafe_col(i).t();
+      lars.Train(dictPrime, responses, false, useCholesky, dictGramTD);
+      beta = lars.Beta();
+      beta %= invW; // Remember, beta is an alias of codes.col(i).
+    }
   }
 }
 
@@ -163,49 +167,8 @@ template<typename MatType>
 inline void LocalCoordinateCoding<MatType>::OptimizeDictionary(
     const MatType& data,
     const MatType& codes,
-    const arma::uvec& adjacencies)
+    const arma::uvec& /* adjacencies */)
 {
-  // Count number of atomic neighbors for each point x^i.
-  arma::uvec neighborCounts = zeros<arma::uvec>(data.n_cols, 1);
-  if (adjacencies.n_elem > 0)
-  {
-    // This gets the column index.  Intentional integer division.
-    size_t curPointInd = (size_t) (adjacencies(0) / atoms);
-    ++neighborCounts(curPointInd);
-
-    size_t nextColIndex = (curPointInd + 1) * atoms;
-    for (size_t l = 1; l < adjacencies.n_elem; l++)
-    {
-      // If l no longer refers to an element in this column, advance the column
-      // number accordingly.
-      if (adjacencies(l) >= nextColIndex)
-      {
-        curPointInd = (size_t) (adjacencies(l) / atoms);
-        nextColIndex = (curPointInd + 1) * atoms;
-      }
-
-      ++neighborCounts(curPointInd);
-    }
-  }
-
-  // Build dataPrime := [X x^1 ... x^1 ... x^n ... x^n]
-  // where each x^i is repeated for the number of neighbors x^i has.
-  MatType dataPrime = zeros<MatType>(data.n_rows,
-      data.n_cols + adjacencies.n_elem);
-
-  dataPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = data;
-
-  size_t curCol = data.n_cols;
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    if (neighborCounts(i) > 0)
-    {
-      dataPrime(arma::span::all, arma::span(curCol, curCol + neighborCounts(i)
-          - 1)) = repmat(data.col(i), 1, neighborCounts(i));
-    }
-    curCol += neighborCounts(i);
-  }
-
   // Handle the case of inactive atoms (atoms not used in the given coding).
   std::vector<arma::uword> activeAtoms;
   for (size_t j = 0; j < atoms; ++j)
@@ -215,83 +178,43 @@ inline void LocalCoordinateCoding<MatType>::OptimizeDictionary(
   const size_t nActiveAtoms = activeAtoms.size();
   const size_t nInactiveAtoms = atoms - nActiveAtoms;
 
-  // Efficient construction of codes restricted to active atoms.
-  MatType codesPrime = zeros<MatType>(nActiveAtoms, data.n_cols +
-      adjacencies.n_elem);
-  ColType wSquared = ones<ColType>(data.n_cols + adjacencies.n_elem, 1);
-
   if (nInactiveAtoms > 0)
   {
     Log::Warn << "There are " << nInactiveAtoms
         << " inactive atoms.  They will be re-initialized randomly.\n";
-
-    // Create matrix holding only active codes.
-    MatType activeCodes = codes.rows(arma::uvec(activeAtoms));
-
-    // Create reverse atom lookup for active atoms.
-    arma::uvec atomReverseLookup(atoms);
-    for (size_t i = 0; i < activeAtoms.size(); ++i)
-    {
-      atomReverseLookup[activeAtoms[i]] = i;
-    }
-
-    codesPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = activeCodes;
-
-    // Fill the rest of codesPrime.
-    for (size_t l = 0; l < adjacencies.n_elem; ++l)
-    {
-      // Recover the location in the codes matrix that this adjacency refers to.
-      size_t atomInd = adjacencies(l) % atoms;
-      size_t pointInd = (size_t) (adjacencies(l) / atoms);
-
-      // Fill matrix.
-      codesPrime(atomReverseLookup(atomInd), data.n_cols + l) = 1.0;
-      wSquared(data.n_cols + l) = codes(atomInd, pointInd);
-    }
   }
-  else
-  {
-    // All atoms are active.
-    codesPrime(arma::span::all, arma::span(0, data.n_cols - 1)) = codes;
 
-    for (size_t l = 0; l < adjacencies.n_elem; ++l)
-    {
-      // Recover the location in the codes matrix that this adjacency refers to.
-      size_t atomInd = adjacencies(l) % atoms;
-      size_t pointInd = (size_t) (adjacencies(l) / atoms);
-
-      // Fill matrix.
-      codesPrime(atomInd, data.n_cols + l) = 1.0;
-      wSquared(data.n_cols + l) = codes(atomInd, pointInd);
-    }
-  }
-
-  if (adjacencies.n_elem > 0)
-  {
-    wSquared.subvec(data.n_cols, wSquared.n_elem - 1) = lambda *
-        abs(wSquared.subvec(data.n_cols, wSquared.n_elem - 1));
-  }
+  // The dictionary minimizes
+  //
+  //   ||X - D Z||_F^2 + lambda sum_{i, j} |z_ij| ||x_i - d_j||^2,
+  //
+  // so it is the solution of D A = B, with
+  //
+  //   A = Z Z' + lambda diag(sum_i |z_ij|),
+  //   B = (Z + lambda |Z|) X'
+  //
+  // (restricted to the active atoms).  Both are computed with matrix-matrix
+  // products over all points at once, instead of building an expanded copy of
+  // the data with one column per nonzero code.
+  const MatType activeCodes = (nInactiveAtoms > 0) ?
+      MatType(codes.rows(arma::uvec(activeAtoms))) : codes;
+  const MatType absCodes = abs(activeCodes);
+
+  MatType A = activeCodes * trans(activeCodes);
+  A.diag() += lambda * sum(absCodes, 1);
+  const MatType B = (activeCodes + lambda * absCodes) * trans(data);
 
   // Solve system.
   if (nInactiveAtoms == 0)
   {
     // No inactive atoms.  We can solve directly.
-    MatType A = codesPrime * diagmat(wSquared) * trans(codesPrime);
-    MatType B = codesPrime * diagmat(wSquared) * trans(dataPrime);
-
     dictionary = trans(solve(A, B));
-    /*
-    dictionary = trans(solve(codesPrime * diagmat(wSquared) * trans(codesPrime),
-        codesPrime * diagmat(wSquared) * trans(dataPrime)));
-    */
   }
   else
   {
     // Inactive atoms must be reinitialized randomly, so we cannot solve
     // directly for the entire dictionary estimate.
-    MatType dictionaryActive =
-        trans(solve(codesPrime * diagmat(wSquared) * trans(codesPrime),
-                    codesPrime * diagmat(wSquared) * trans(dataPrime)));
+    MatType dictionaryActive = trans(solve(A, B));
 
     // Update all atoms.
     size_t currentActiveIndex = 0;
@@ -167,6 +167,26 @@ class LogisticRegressionFunction
   size_t NumFeatures() const { return predictors.n_rows + 1; }
 
  private:
+  /**
+   * Compute the negative log-likelihood of the given points (without the
+   * regularization), and its gradient if `gradient` is not NULL.  The points
+   * are processed in blocks, in parallel with OpenMP.
+   *
+   * @param parameters Vector of logistic regression parameters.
+   * @param begin Index of the first point to use.
+   * @param batchSize Number of points to use.
+   * @param gradient If not NULL, the gradient is stored here.
+   */
+  template<typename CoordinatesType, typename GradType>
+  typename CoordinatesType::elem_type BatchObjective(
+      const CoordinatesType& parameters,
+      const size_t begin,
+      const size_t batchSize,
+      GradType* gradient) const;
+
+  //! Number of points in each block of BatchObjective().
+  static constexpr size_t BlockSize = 1024;
+
   //! The matrix of data points (predictors).  This is an alias until shuffling
   //! is done.
   MatType predictors;
@@ -79,12 +79,9 @@ LogisticRegressionFunction<MatType>::Evaluate(
   // multiplied by the squared l2-norm of the parameters then divided by two.
   using ElemType = typename CoordinatesType::elem_type;
 
-  // Specifying these here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
+  // Specifying this here avoids accidentally casting an entire expression to
+  // `double`, e.g., by the use of `0.5` or similar.
   constexpr ElemType half = ((ElemType) 0.5);
-  constexpr ElemType one = ((ElemType) 1);
-  constexpr ElemType two = ((ElemType) 2);
 
   // For the regularization, we ignore the first term, which is the intercept
   // term and take every term except the last one in the decision variable.
@@ -92,23 +89,12 @@ LogisticRegressionFunction<MatType>::Evaluate(
       dot(parameters.tail_cols(parameters.n_elem - 1),
       parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate vectors of sigmoids.  The intercept term is parameters(0, 0) and
-  // does not need to be multiplied by any of the predictors.
-  const CoordinatesType sigmoid = one / (one + exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
   // Assemble full objective function.  Often the objective function and the
   // regularization as given are divided by the number of features, but this
   // doesn't actually affect the optimization result, so we'll just ignore those
-  // terms for computational efficiency.  Note that the conversion causes some
-  // copy and slowdown, but this is so negligible compared to the rest of the
-  // calculation it is not worth optimizing for.
-  const ElemType result = accu(log(one -
-      ConvTo<CoordinatesType>::From(responses) + sigmoid %
-      (two * ConvTo<CoordinatesType>::From(responses) - one)));
-
-  // Invert the result, because it's a minimization.
-  return regularization - result;
+  // terms for computational efficiency.
+  return regularization + BatchObjective<CoordinatesType, CoordinatesType>(
+      parameters, 0, predictors.n_cols, NULL);
 }
 
 /**
@@ -125,10 +111,8 @@ LogisticRegressionFunction<MatType>::Evaluate(
 {
   using ElemType = typename CoordinatesType::elem_type;
 
-  // Specifying these here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
+  // Specifying this here avoids accidentally casting an entire expression to
+  // `double`, e.g., by the use of `2.0` or similar.
   constexpr ElemType two = ((ElemType) 2);
 
   // Calculate the regularization term.
@@ -137,19 +121,9 @@ LogisticRegressionFunction<MatType>::Evaluate(
       dot(parameters.tail_cols(parameters.n_elem - 1),
           parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const CoordinatesType sigmoid = one / (one + exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
-
   // Compute the objective for the given batch size from a given point.
-  CoordinatesType respD = ConvTo<CoordinatesType>::From(
-      responses.subvec(begin, begin + batchSize - 1));
-  const ElemType result = accu(log(one - respD + sigmoid %
-      (two * respD - one)));
-
-  // Invert the result, because it's a minimization.
-  return regularization - result;
+  return regularization + BatchObjective<CoordinatesType, CoordinatesType>(
+      parameters, begin, batchSize, NULL);
 }
 
 //! Evaluate the gradient of the logistic regression objective function.
@@ -159,24 +133,11 @@ void LogisticRegressionFunction<MatType>::Gradient(
     const CoordinatesType& parameters,
     GradType& gradient) const
 {
-  using ElemType = typename CoordinatesType::elem_type;
+  BatchObjective(parameters, 0, predictors.n_cols, &gradient);
 
   // Regularization term.
-  GradType regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1);
-
-  // Specifying this here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
-
-  const CoordinatesType sigmoids = (one / (one + exp(-parameters(0, 0)
-      - parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(size(parameters));
-  gradient[0] = -accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1);
 }
 
 //! Evaluate the gradient of the logistic regression objective function for a
@@ -189,30 +150,12 @@ void LogisticRegressionFunction<MatType>::Gradient(
                 GradType& gradient,
                 const size_t batchSize) const
 {
-  using ElemType = typename CoordinatesType::elem_type;
+  BatchObjective(parameters, begin, batchSize, &gradient);
 
   // Regularization term.
-  GradType regularization;
-  regularization = lambda * parameters.tail_cols(parameters.n_elem - 1)
-      / predictors.n_cols * batchSize;
-
-  // Specifying this here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
-
-  const CoordinatesType exponents = parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1);
-  // Calculating the sigmoid function values.
-  const CoordinatesType sigmoids = one / (one + exp(-exponents));
-
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+      batchSize;
 }
 
 /**
@@ -258,36 +201,22 @@ LogisticRegressionFunction<MatType>::EvaluateWithGradient(
 {
   using ElemType = typename CoordinatesType::elem_type;
 
-  // Specifying these here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
+  // Specifying this here avoids accidentally casting an entire expression to
+  // `double`, e.g., by the use of `2.0` or similar.
   constexpr ElemType two = ((ElemType) 2);
 
+  const ElemType objective = BatchObjective(parameters, 0, predictors.n_cols,
+      &gradient);
+
   // Regularization term.
-  GradType regularization = lambda *
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
       parameters.tail_cols(parameters.n_elem - 1);
 
   const ElemType objectiveRegularization = lambda / two *
       dot(parameters.tail_cols(parameters.n_elem - 1),
           parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const CoordinatesType sigmoids = one / (one + exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) * predictors)));
-
-  gradient.set_size(size(parameters));
-  gradient[0] = -accu(responses - sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids - responses) *
-      predictors.t() + regularization;
-
-  // Now compute the objective function using the sigmoids.
-  ElemType result = accu(log(one -
-      ConvTo<CoordinatesType>::From(responses) + sigmoids %
-      (two * ConvTo<CoordinatesType>::From(responses) - one)));
-
-  // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  return objectiveRegularization + objective;
 }
 
 template<typename MatType>
@@ -301,15 +230,16 @@ LogisticRegressionFunction<MatType>::EvaluateWithGradient(
 {
   using ElemType = typename CoordinatesType::elem_type;
 
-  // Specifying these here makes the code below a little bit cleaner, and avoids
-  // accidentally casting an entire expression to `double`, e.g., by the use of
-  // `1.0` or similar.
-  constexpr ElemType one = ((ElemType) 1);
+  // Specifying this here avoids accidentally casting an entire expression to
+  // `double`, e.g., by the use of `2.0` or similar.
   constexpr ElemType two = ((ElemType) 2);
 
+  const ElemType objective = BatchObjective(parameters, begin, batchSize,
+      &gradient);
+
   // Regularization term.
-  GradType regularization =
-      lambda * parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
+  gradient.tail_cols(parameters.n_elem - 1) += lambda *
+      parameters.tail_cols(parameters.n_elem - 1) / predictors.n_cols *
       batchSize;
 
   const ElemType objectiveRegularization = lambda *
@@ -317,26 +247,78 @@ LogisticRegressionFunction<MatType>::EvaluateWithGradient(
       dot(parameters.tail_cols(parameters.n_elem - 1),
           parameters.tail_cols(parameters.n_elem - 1));
 
-  // Calculate the sigmoid function values.
-  const CoordinatesType sigmoids = one / (one + exp(-(parameters(0, 0) +
-      parameters.tail_cols(parameters.n_elem - 1) *
-      predictors.cols(begin, begin + batchSize - 1))));
+  return objectiveRegularization + objective;
+}
 
-  gradient.set_size(parameters.n_rows, parameters.n_cols);
-  gradient[0] = -accu(responses.subvec(begin, begin + batchSize - 1) -
-      sigmoids);
-  gradient.tail_cols(parameters.n_elem - 1) = (sigmoids -
-      responses.subvec(begin, begin + batchSize - 1)) *
-      predictors.cols(begin, begin + batchSize - 1).t() + regularization;
+template<typename MatType>
+template<typename CoordinatesType, typename GradType>
+typename CoordinatesType::elem_type
+LogisticRegressionFunction<MatType>::BatchObjective(
+    const CoordinatesType& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    GradType* gradient) const
+{
+  using ElemType = typename CoordinatesType::elem_type;
+
+  // Specifying these here makes the code below a little bit cleaner, and avoids
+  // accidentally casting an entire expression to `double`, e.g., by the use of
+  // `1.0` or similar.
+  constexpr ElemType one = ((ElemType) 1);
+  constexpr ElemType two = ((ElemType) 2);
+
+  const size_t numBlocks = (batchSize + BlockSize - 1) / BlockSize;
+  if (gradient)
+    gradient->zeros(parameters.n_rows, parameters.n_cols);
 
-  // Now compute the objective function using the sigmoids.
-  CoordinatesType respD = ConvTo<CoordinatesType>::From(
-      responses.subvec(begin, begin + batchSize - 1));
-  const ElemType result = accu(log(one - respD + sigmoids %
-      (two * respD - one)));
+  ElemType result = 0;
+  #pragma omp parallel reduction(+:result)
+  {
+    // The gradient of the blocks of this thread.
+    CoordinatesType threadGradient;
+    if (gradient)
+      threadGradient.zeros(parameters.n_rows, parameters.n_cols);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t first = begin + b * BlockSize;
+      const size_t last = std::min(first + BlockSize, begin + batchSize) - 1;
+
+      // Calculate the sigmoid function values.  The intercept term is
+      // parameters(0, 0) and does not need to be multiplied by any of the
+      // predictors.
+      const CoordinatesType sigmoids = one / (one + exp(-(parameters(0, 0) +
+          parameters.tail_cols(parameters.n_elem - 1) *
+          predictors.cols(first, last))));
+
+      // Compute the log-likelihood using the sigmoids.  Note that the
+      // conversion causes some copy and slowdown, but this is so negligible
+      // compared to the rest of the calculation it is not worth optimizing for.
+      const CoordinatesType respD = ConvTo<CoordinatesType>::From(
+          responses.subvec(first, last));
+      result += accu(log(one - respD + sigmoids % (two * respD - one)));
+
+      if (gradient)
+      {
+        // The predictors are multiplied on the left, so that sparse data is
+        // never transposed.
+        const CoordinatesType errors = sigmoids - respD;
+        threadGradient[0] += accu(errors);
+        threadGradient.tail_cols(parameters.n_elem - 1) +=
+            (predictors.cols(first, last) * errors.t()).t();
+      }
+    }
+
+    if (gradient)
+    {
+      #pragma omp critical
+      *gradient += threadGradient;
+    }
+  }
 
   // Invert the result, because it's a minimization.
-  return objectiveRegularization - result;
+  return -result;
 }
 
 } // namespace mlpack
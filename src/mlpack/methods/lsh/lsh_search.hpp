@@ -192,6 +192,17 @@ class LSHSearch
              const size_t bucketSize = 500,
              const arma::cube& projection = arma::cube());
 
+  /**
+   * Add new points to the reference set of a trained model.  The new points
+   * are hashed with the existing projections and appended to the buckets of
+   * the second hash table (if they are not full); the points already in the
+   * model are not hashed again.  The new points get the indices following the
+   * points already in the reference set.
+   *
+   * @param newPoints Points to add to the reference set.
+   */
+  void Insert(const MatType& newPoints);
+
   /**
    * Compute the nearest neighbors of the points in the given query set and
    * store the output in the given matrices.  The matrices will be set to the
@@ -286,9 +297,19 @@ class LSHSearch
   //! Get the bucket size of the second hash.
   size_t BucketSize() const { return bucketSize; }
 
-  //! Get the second hash table.
-  const std::vector<arma::Col<size_t>>& SecondHashTable() const
-      { return secondHashTable; }
+  /**
+   * Get the second hash table, as one vector of point indices for each
+   * non-empty bucket.  The table is stored compactly (see BucketOffsets()), so
+   * this builds a copy of it.
+   */
+  std::vector<arma::Col<size_t>> SecondHashTable() const;
+
+  /**
+   * Get the offsets of the non-empty buckets of the second hash table in the
+   * contiguous storage of their point indices: the points of the i'th bucket
+   * are stored at positions BucketOffsets()[i] to BucketOffsets()[i + 1] - 1.
+   */
+  const arma::Col<size_t>& BucketOffsets() const { return bucketOffsets; }
 
   //! Get the projection tables.
   const arma::cube& Projections() { return projections; }
@@ -420,6 +441,66 @@ class LSHSearch
    */
   bool PerturbationValid(const std::vector<bool>& A) const;
 
+  /**
+   * Map the weighted sum of the first-level hash code of a point to a bucket
+   * of the second hash table, in [0, secondHashSize).  Reference points,
+   * queries, and additional probing bins must all be hashed with this
+   * function, so that queries find the buckets of their reference points.
+   *
+   * @param code Weighted sum of the first-level hash code.
+   */
+  size_t SecondHash(const double code) const;
+
+  //! Return the maximum number of additional probing bins, and warn if T is
+  //! larger than that.
+  size_t EffectiveProbes(const size_t T) const;
+
+  /**
+   * Call f(index) for the index of each reference point in the given row of
+   * the second hash table.
+   */
+  template<typename FunctionType>
+  void ForEachInBucket(const size_t row, FunctionType&& f) const;
+
+  /**
+   * Compute the bucket of the second hash table of each of the given points in
+   * each table.
+   *
+   * @param points Points to hash.
+   * @param secondHashVectors Matrix to store the bucket of each point (columns)
+   *     in each table (rows) in.
+   */
+  void HashPoints(const MatType& points,
+                  arma::Mat<size_t>& secondHashVectors) const;
+
+  /**
+   * Add points to the second hash table, appending them to the rows of their
+   * buckets (unless the rows are full) and creating rows for new buckets.
+   *
+   * @param secondHashVectors Bucket of each point (columns) in each table
+   *     (rows).
+   * @param firstIndex Index of the first of the points in the reference set.
+   */
+  void AddToBuckets(const arma::Mat<size_t>& secondHashVectors,
+                    const size_t firstIndex);
+
+  /**
+   * Store the point indices of the rows with the given new offsets in the
+   * given contents vector: first the points already in the table, and then
+   * the new points.
+   *
+   * @param secondHashVectors Bucket of each new point (columns) in each table
+   *     (rows).
+   * @param firstIndex Index of the first new point in the reference set.
+   * @param newOffsets Offsets of the rows after the new points are added.
+   * @param contents Vector to store the point indices in.
+   */
+  template<typename eT>
+  void FillBuckets(const arma::Mat<size_t>& secondHashVectors,
+                   const size_t firstIndex,
+                   const arma::Col<size_t>& newOffsets,
+                   arma::Col<eT>& contents) const;
+
   //! Reference dataset.
   MatType referenceSet;
 
@@ -446,13 +527,18 @@ class LSHSearch
   //! The bucket size of the second hash.
   size_t bucketSize;
 
-  //! The final hash table; should be (< secondHashSize) vectors each with
-  //! (<= bucketSize) elements.
-  std::vector<arma::Col<size_t>> secondHashTable;
+  //! The final hash table is stored in compressed sparse row form: the point
+  //! indices of row i (with at most bucketSize elements) are
+  //! bucketContents[bucketOffsets[i]] to bucketContents[bucketOffsets[i + 1] -
+  //! 1].  There are (< secondHashSize) rows.
+  arma::Col<size_t> bucketOffsets;
+
+  //! The point indices of all rows of the hash table, if they fit in 32 bits.
+  arma::Col<uint32_t> bucketContents;
 
-  //! The number of elements present in each hash bucket; should be
-  //! secondHashSize.
-  arma::Col<size_t> bucketContentSize;
+  //! The point indices of all rows of the hash table, if the reference set is
+  //! too large for 32-bit indices (in which case bucketContents is empty).
+  arma::Col<size_t> wideBucketContents;
 
   //! For a particular hash value, points to the row in secondHashTable
   //! corresponding to this value. Length secondHashSize.
@@ -479,6 +565,9 @@ class LSHSearch
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename SortPolicy, typename MatType),
+    (mlpack::LSHSearch<SortPolicy, MatType>), (1));
+
 // Include implementation.
 #include "lsh_search_impl.hpp"
 
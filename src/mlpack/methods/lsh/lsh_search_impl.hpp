@@ -82,8 +82,9 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(const LSHSearch& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(other.secondHashWeights),
     bucketSize(other.bucketSize),
-    secondHashTable(other.secondHashTable),
-    bucketContentSize(other.bucketContentSize),
+    bucketOffsets(other.bucketOffsets),
+    bucketContents(other.bucketContents),
+    wideBucketContents(other.wideBucketContents),
     bucketRowInHashTable(other.bucketRowInHashTable),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -102,8 +103,9 @@ LSHSearch<SortPolicy, MatType>::LSHSearch(LSHSearch&& other) :
     secondHashSize(other.secondHashSize),
     secondHashWeights(std::move(other.secondHashWeights)),
     bucketSize(other.bucketSize),
-    secondHashTable(std::move(other.secondHashTable)),
-    bucketContentSize(std::move(other.bucketContentSize)),
+    bucketOffsets(std::move(other.bucketOffsets)),
+    bucketContents(std::move(other.bucketContents)),
+    wideBucketContents(std::move(other.wideBucketContents)),
     bucketRowInHashTable(std::move(other.bucketRowInHashTable)),
     distanceEvaluations(other.distanceEvaluations)
 {
@@ -130,8 +132,9 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = other.secondHashWeights;
   bucketSize = other.bucketSize;
-  secondHashTable = other.secondHashTable;
-  bucketContentSize = other.bucketContentSize;
+  bucketOffsets = other.bucketOffsets;
+  bucketContents = other.bucketContents;
+  wideBucketContents = other.wideBucketContents;
   bucketRowInHashTable = other.bucketRowInHashTable;
   distanceEvaluations = other.distanceEvaluations;
 
@@ -152,8 +155,9 @@ LSHSearch<SortPolicy, MatType>& LSHSearch<SortPolicy, MatType>::operator=(
   secondHashSize = other.secondHashSize;
   secondHashWeights = std::move(other.secondHashWeights);
   bucketSize = other.bucketSize;
-  secondHashTable = std::move(other.secondHashTable);
-  bucketContentSize = std::move(other.bucketContentSize);
+  bucketOffsets = std::move(other.bucketOffsets);
+  bucketContents = std::move(other.bucketContents);
+  wideBucketContents = std::move(other.wideBucketContents);
   bucketRowInHashTable = std::move(other.bucketRowInHashTable);
   distanceEvaluations = other.distanceEvaluations;
 
@@ -253,9 +257,60 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
   }
 
   // We will store the second hash vectors in this matrix; the second hash
-  // vector for table i will be held in row i.  We have to use int and not
-  // size_t, otherwise negative numbers are cast to 0.
-  arma::Mat<size_t> secondHashVectors(numTables, this->referenceSet.n_cols);
+  // vector for table i will be held in row i.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(this->referenceSet, secondHashVectors);
+
+  // Now put each point in each table in the second hash table, which starts
+  // out empty.
+  bucketOffsets.zeros(1);
+  bucketContents.clear();
+  wideBucketContents.clear();
+  AddToBuckets(secondHashVectors, 0);
+
+  const size_t numRowsInTable = bucketOffsets.n_elem - 1;
+  const size_t maxRowSize = (numRowsInTable == 0) ? 0 :
+      (size_t) max(arma::diff(bucketOffsets));
+  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
+            << "maximum length of " << maxRowSize << ", "
+            << "totaling " << bucketOffsets[numRowsInTable] << " elements."
+            << std::endl;
+}
+
+// Add new points to the model.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::Insert(const MatType& newPoints)
+{
+  if (projections.n_slices == 0)
+  {
+    throw std::invalid_argument("LSHSearch::Insert(): the model must be "
+        "trained before points can be inserted");
+  }
+
+  util::CheckSameDimensionality(newPoints, referenceSet, "LSHSearch::Insert()",
+      "new points");
+
+  // Only the new points have to be hashed; they take the next indices in the
+  // reference set.
+  arma::Mat<size_t> secondHashVectors;
+  HashPoints(newPoints, secondHashVectors);
+
+  const size_t firstIndex = referenceSet.n_cols;
+  referenceSet = arma::join_rows(referenceSet, newPoints);
+  AddToBuckets(secondHashVectors, firstIndex);
+
+  Log::Info << "Inserted " << newPoints.n_cols << " points; the hash table "
+      << "now has " << bucketOffsets.n_elem - 1 << " rows, totaling "
+      << bucketOffsets[bucketOffsets.n_elem - 1] << " elements." << std::endl;
+}
+
+// Hash points into buckets of the second hash table.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::HashPoints(
+    const MatType& points,
+    arma::Mat<size_t>& secondHashVectors) const
+{
+  secondHashVectors.set_size(numTables, points.n_cols);
 
   for (size_t i = 0; i < numTables; ++i)
   {
@@ -264,15 +319,14 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
 
     // The following code performs the task of hashing each point to a
     // 'numProj'-dimensional integer key.  Hence you get a ('numProj' x
-    // 'referenceSet.n_cols') key matrix.
+    // 'points.n_cols') key matrix.
     //
     // For a single table, let the 'numProj' projections be denoted by 'proj_i'
     // and the corresponding offset be 'offset_i'.  Then the key of a single
     // point is obtained as:
     // key = { floor((<proj_i, point> + offset_i) / 'hashWidth') forall i }
-    arma::mat offsetMat = repmat(offsets.unsafe_col(i), 1,
-                                 this->referenceSet.n_cols);
-    arma::mat hashMat = projections.slice(i).t() * (this->referenceSet);
+    arma::mat offsetMat = repmat(offsets.unsafe_col(i), 1, points.n_cols);
+    arma::mat hashMat = projections.slice(i).t() * points;
     hashMat += offsetMat;
     hashMat /= hashWidth;
 
@@ -281,71 +335,67 @@ void LSHSearch<SortPolicy, MatType>::Train(MatType referenceSet,
     // also normalize the hashes to the range [0, secondHashSize).
     arma::rowvec unmodVector = secondHashWeights.t() * arma::floor(hashMat);
     for (size_t j = 0; j < unmodVector.n_elem; ++j)
-    {
-      double shs = (double) secondHashSize; // Convenience cast.
-      if (unmodVector[j] >= 0.0)
-      {
-        const size_t key = size_t(fmod(unmodVector[j], shs));
-        secondHashVectors(i, j) = key;
-      }
-      else
-      {
-        const double mod = fmod(-unmodVector[j], shs);
-        const size_t key = (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
-        secondHashVectors(i, j) = key;
-      }
-    }
+      secondHashVectors(i, j) = SecondHash(unmodVector[j]);
   }
+}
 
-  // Now, using the hash vectors for each table, count the number of rows we
-  // have in the second hash table.
-  arma::Row<size_t> secondHashBinCounts(secondHashSize);
-  for (size_t i = 0; i < secondHashVectors.n_elem; ++i)
-    secondHashBinCounts[secondHashVectors[i]]++;
-
-  // Enforce the maximum bucket size.
+// Add points to the second hash table.
+template<typename SortPolicy, typename MatType>
+void LSHSearch<SortPolicy, MatType>::AddToBuckets(
+    const arma::Mat<size_t>& secondHashVectors,
+    const size_t firstIndex)
+{
+  // Compute the size of each row after the points are added, enforcing the
+  // maximum bucket size.  Instead of putting the points in the row
+  // corresponding to the bucket, we chose the next empty row and keep track of
+  // the row in which the bucket lies.  This allows us to skip the empty
+  // buckets.
   const size_t effectiveBucketSize = (bucketSize == 0) ? SIZE_MAX : bucketSize;
-  secondHashBinCounts.transform([effectiveBucketSize](size_t val)
-      { return std::min(val, effectiveBucketSize); });
+  const size_t oldNumRows = bucketOffsets.n_elem - 1;
+  std::vector<size_t> rowSizes(oldNumRows);
+  for (size_t r = 0; r < oldNumRows; ++r)
+    rowSizes[r] = bucketOffsets[r + 1] - bucketOffsets[r];
 
-  const size_t numRowsInTable = accu(secondHashBinCounts > 0);
-  bucketContentSize.zeros(numRowsInTable);
-  secondHashTable.resize(numRowsInTable);
-
-  // Next we must assign each point in each table to the right second hash
-  // table.
-  size_t currentRow = 0;
-  for (size_t i = 0; i < numTables; ++i)
+  for (size_t i = 0; i < secondHashVectors.n_rows; ++i)
   {
-    // Insert the point in the corresponding row to its bucket in the
-    // 'secondHashTable'.
     for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
     {
-      // This is the bucket number.
-      size_t hashInd = (size_t) secondHashVectors(i, j);
-      // The point ID is 'j'.
-
-      // If this is currently an empty bucket, start a new row keep track of
-      // which row corresponds to the bucket.
-      const size_t maxSize = secondHashBinCounts[hashInd];
-      if (bucketRowInHashTable[hashInd] == secondHashSize)
+      size_t& row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (row == secondHashSize)
       {
-        bucketRowInHashTable[hashInd] = currentRow;
-        secondHashTable[currentRow].set_size(maxSize);
-        currentRow++;
+        row = rowSizes.size();
+        rowSizes.push_back(0);
       }
 
-      // If this vector in the hash table is not full, add the point.
-      const size_t index = bucketRowInHashTable[hashInd];
-      if (bucketContentSize[index] < maxSize)
-        secondHashTable[index](bucketContentSize[index]++) = j;
-    } // Loop over all points in the reference set.
-  } // Loop over tables.
+      if (rowSizes[row] < effectiveBucketSize)
+        ++rowSizes[row];
+    }
+  }
 
-  Log::Info << "Final hash table size: " << numRowsInTable << " rows, with a "
-            << "maximum length of " << max(secondHashBinCounts) << ", "
-            << "totaling " << accu(secondHashBinCounts) << " elements."
-            << std::endl;
+  arma::Col<size_t> newOffsets(rowSizes.size() + 1);
+  newOffsets[0] = 0;
+  for (size_t r = 0; r < rowSizes.size(); ++r)
+    newOffsets[r + 1] = newOffsets[r] + rowSizes[r];
+
+  // 32-bit indices halve the size of the table, unless the reference set is
+  // too large.
+  if (firstIndex + secondHashVectors.n_cols <=
+      std::numeric_limits<uint32_t>::max())
+  {
+    arma::Col<uint32_t> contents;
+    FillBuckets(secondHashVectors, firstIndex, newOffsets, contents);
+    bucketContents = std::move(contents);
+    wideBucketContents.clear();
+  }
+  else
+  {
+    arma::Col<size_t> contents;
+    FillBuckets(secondHashVectors, firstIndex, newOffsets, contents);
+    wideBucketContents = std::move(contents);
+    bucketContents.clear();
+  }
+
+  bucketOffsets = std::move(newOffsets);
 }
 
 // Base case where the query set is the reference set.  (So, we can't return
@@ -738,11 +788,9 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
 
   // Compute the primary hash value of each key of the query into a bucket of
   // the secondHashTable using the secondHashWeights.
-  hashMat.row(0) = ConvTo<arma::Row<size_t>> // Floor by typecasting
-      ::From(secondHashWeights.t() * allProjInTables);
-  // Mod to compute 2nd-level codes.
+  const arma::rowvec primaryCodes = secondHashWeights.t() * allProjInTables;
   for (size_t i = 0; i < numTablesToSearch; ++i)
-    hashMat(0, i) = (hashMat(0, i) % secondHashSize);
+    hashMat(0, i) = SecondHash(primaryCodes[i]);
 
   // Compute hash codes of additional probing bins.
   if (T > 0)
@@ -758,11 +806,10 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
 
       // Map each probing bin to a bin in secondHashTable (just like we did for
       // the primary hash table).
-      hashMat(arma::span(1, T), i) = // Compute code of rows 1:end of column i
-        ConvTo<arma::Col<size_t>>:: // floor by typecasting to size_t
-        From(secondHashWeights.t() * additionalProbingBins);
+      const arma::rowvec probingCodes = secondHashWeights.t() *
+          additionalProbingBins;
       for (size_t p = 1; p < T + 1; ++p)
-        hashMat(p, i) = (hashMat(p, i) % secondHashSize);
+        hashMat(p, i) = SecondHash(probingCodes[p - 1]);
     }
   }
 
@@ -774,8 +821,8 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
     {
       const size_t hashInd = hashMat(p, i); // find query's bucket
       const size_t tableRow = bucketRowInHashTable[hashInd];
-      if (tableRow < secondHashSize)
-        maxNumPoints += bucketContentSize[tableRow]; // count bucket contents
+      if (tableRow < secondHashSize) // Count bucket contents.
+        maxNumPoints += bucketOffsets[tableRow + 1] - bucketOffsets[tableRow];
     }
   }
 
@@ -806,11 +853,11 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
         size_t hashInd = hashMat(p, i);
         size_t tableRow = bucketRowInHashTable[hashInd];
 
-        if (tableRow < secondHashSize && bucketContentSize[tableRow] > 0)
+        if (tableRow < secondHashSize)
         {
           // Pick the indices in the bucket corresponding to hashInd.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsidered[ secondHashTable[tableRow](j) ]++;
+          ForEachInBucket(tableRow, [&](const size_t index)
+              { refPointsConsidered[index]++; });
         }
       }
     }
@@ -840,8 +887,8 @@ void LSHSearch<SortPolicy, MatType>::ReturnIndicesFromTable(
         if (tableRow < secondHashSize)
         {
           // Store all secondHashTable points in the candidates set.
-          for (size_t j = 0; j < bucketContentSize[tableRow]; ++j)
-            refPointsConsideredSmall(start++) = secondHashTable[tableRow](j);
+          ForEachInBucket(tableRow, [&](const size_t index)
+              { refPointsConsideredSmall(start++) = index; });
        }
       }
     }
@@ -884,15 +931,8 @@ void LSHSearch<SortPolicy, MatType>::Search(
     return;
 
   // If the user requested more than the available number of additional probing
-  // bins, set Teffective to maximum T. Maximum T is 2^numProj - 1
-  size_t Teffective = T;
-  if (T > ((size_t) ((1 << numProj) - 1)))
-  {
-    Teffective = (1 << numProj) - 1;
-    Log::Warn << "Requested " << T << " additional bins are more than "
-        << "theoretical maximum. Using " << Teffective << " instead."
-        << std::endl;
-  }
+  // bins, use the maximum instead.
+  const size_t Teffective = EffectiveProbes(T);
 
   // If the user set multiprobe, log it
   if (Teffective > 0)
@@ -946,18 +986,11 @@ Search(const size_t k,
   distances.set_size(k, referenceSet.n_cols);
 
   // If the user requested more than the available number of additional probing
-  // bins, set Teffective to maximum T. Maximum T is 2^numProj - 1
-  size_t Teffective = T;
-  if (T > ((size_t) ((1 << numProj) - 1)))
-  {
-    Teffective = (1 << numProj) - 1;
-    Log::Warn << "Requested " << T << " additional bins are more than "
-        << "theoretical maximum. Using " << Teffective << " instead."
-        << std::endl;
-  }
+  // bins, use the maximum instead.
+  const size_t Teffective = EffectiveProbes(T);
 
   // If the user set multiprobe, log it
-  if (T > 0)
+  if (Teffective > 0)
     Log::Info << "Running multiprobe LSH with " << Teffective <<
       " additional probing bins per table per query."<< std::endl;
 
@@ -994,6 +1027,100 @@ Search(const size_t k,
       std::endl;
 }
 
+template<typename SortPolicy, typename MatType>
+std::vector<arma::Col<size_t>>
+LSHSearch<SortPolicy, MatType>::SecondHashTable() const
+{
+  std::vector<arma::Col<size_t>> table(bucketOffsets.is_empty() ? 0 :
+      bucketOffsets.n_elem - 1);
+  for (size_t i = 0; i < table.size(); ++i)
+  {
+    table[i].set_size(bucketOffsets[i + 1] - bucketOffsets[i]);
+    size_t j = 0;
+    ForEachInBucket(i, [&](const size_t index) { table[i][j++] = index; });
+  }
+
+  return table;
+}
+
+template<typename SortPolicy, typename MatType>
+inline size_t LSHSearch<SortPolicy, MatType>::SecondHash(const double code)
+    const
+{
+  const double shs = (double) secondHashSize; // Convenience cast.
+  if (code >= 0.0)
+    return size_t(fmod(code, shs));
+
+  const double mod = fmod(-code, shs);
+  return (mod < 1.0) ? 0 : secondHashSize - size_t(mod);
+}
+
+template<typename SortPolicy, typename MatType>
+size_t LSHSearch<SortPolicy, MatType>::EffectiveProbes(const size_t T) const
+{
+  // Maximum T is 2^numProj - 1.
+  if (numProj >= 8 * sizeof(size_t) || T <= (size_t(1) << numProj) - 1)
+    return T;
+
+  const size_t Teffective = (size_t(1) << numProj) - 1;
+  Log::Warn << "Requested " << T << " additional bins are more than "
+      << "theoretical maximum. Using " << Teffective << " instead."
+      << std::endl;
+  return Teffective;
+}
+
+template<typename SortPolicy, typename MatType>
+template<typename FunctionType>
+inline void LSHSearch<SortPolicy, MatType>::ForEachInBucket(
+    const size_t row,
+    FunctionType&& f) const
+{
+  const size_t begin = bucketOffsets[row];
+  const size_t end = bucketOffsets[row + 1];
+  if (wideBucketContents.is_empty())
+  {
+    for (size_t j = begin; j < end; ++j)
+      f((size_t) bucketContents[j]);
+  }
+  else
+  {
+    for (size_t j = begin; j < end; ++j)
+      f(wideBucketContents[j]);
+  }
+}
+
+template<typename SortPolicy, typename MatType>
+template<typename eT>
+void LSHSearch<SortPolicy, MatType>::FillBuckets(
+    const arma::Mat<size_t>& secondHashVectors,
+    const size_t firstIndex,
+    const arma::Col<size_t>& newOffsets,
+    arma::Col<eT>& contents) const
+{
+  const size_t numRows = newOffsets.n_elem - 1;
+  contents.set_size(newOffsets[numRows]);
+  arma::Col<size_t> rowEnd = newOffsets.head(numRows);
+
+  // The points that are already in the table come first in each row.
+  for (size_t r = 0; r + 1 < bucketOffsets.n_elem; ++r)
+  {
+    ForEachInBucket(r, [&](const size_t index)
+        { contents[rowEnd[r]++] = (eT) index; });
+  }
+
+  // Rows that are already full are at the maximum bucket size, so the point is
+  // not added.
+  for (size_t i = 0; i < secondHashVectors.n_rows; ++i)
+  {
+    for (size_t j = 0; j < secondHashVectors.n_cols; ++j)
+    {
+      const size_t row = bucketRowInHashTable[secondHashVectors(i, j)];
+      if (rowEnd[row] < newOffsets[row + 1])
+        contents[rowEnd[row]++] = (eT) (firstIndex + j);
+    }
+  }
+}
+
 template<typename SortPolicy, typename MatType>
 double LSHSearch<SortPolicy, MatType>::ComputeRecall(
     const arma::Mat<size_t>& foundNeighbors,
@@ -1024,7 +1151,7 @@ double LSHSearch<SortPolicy, MatType>::ComputeRecall(
 template<typename SortPolicy, typename MatType>
 template<typename Archive>
 void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
-                                               const uint32_t /* version */)
+                                               const uint32_t version)
 {
   ar(CEREAL_NVP(referenceSet));
   ar(CEREAL_NVP(numProj));
@@ -1040,8 +1167,44 @@ void LSHSearch<SortPolicy, MatType>::serialize(Archive& ar,
   ar(CEREAL_NVP(secondHashSize));
   ar(CEREAL_NVP(secondHashWeights));
   ar(CEREAL_NVP(bucketSize));
-  ar(CEREAL_NVP(secondHashTable));
-  ar(CEREAL_NVP(bucketContentSize));
+
+  // Older versions stored each row of the hash table in its own vector.
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    std::vector<arma::Col<size_t>> secondHashTable;
+    arma::Col<size_t> bucketContentSize;
+    ar(CEREAL_NVP(secondHashTable));
+    ar(CEREAL_NVP(bucketContentSize));
+
+    bucketOffsets.zeros(secondHashTable.size() + 1);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+      bucketOffsets[i + 1] = bucketOffsets[i] + bucketContentSize[i];
+
+    wideBucketContents.set_size(bucketOffsets[secondHashTable.size()]);
+    for (size_t i = 0; i < secondHashTable.size(); ++i)
+    {
+      for (size_t j = 0; j < bucketContentSize[i]; ++j)
+        wideBucketContents[bucketOffsets[i] + j] = secondHashTable[i][j];
+    }
+
+    if (referenceSet.n_cols <= std::numeric_limits<uint32_t>::max())
+    {
+      bucketContents = arma::conv_to<arma::Col<uint32_t>>::from(
+          wideBucketContents);
+      wideBucketContents.clear();
+    }
+    else
+    {
+      bucketContents.clear();
+    }
+  }
+  else
+  {
+    ar(CEREAL_NVP(bucketOffsets));
+    ar(CEREAL_NVP(bucketContents));
+    ar(CEREAL_NVP(wideBucketContents));
+  }
+
   ar(CEREAL_NVP(bucketRowInHashTable));
   ar(CEREAL_NVP(distanceEvaluations));
 }
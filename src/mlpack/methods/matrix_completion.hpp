@@ -2,7 +2,8 @@
  * @file matrix_completion.hpp
  *
  * Convenience include for
- * mlpack/methods/matrix_completion/matrix_completion.hpp.
+ * mlpack/methods/matrix_completion/matrix_completion.hpp and
+ * mlpack/methods/matrix_completion/soft_impute.hpp.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -13,5 +14,6 @@
 #define MLPACK_MATRIX_COMPLETION_HPP
 
 #include "matrix_completion/matrix_completion.hpp"
+#include "matrix_completion/soft_impute.hpp"
 
 #endif
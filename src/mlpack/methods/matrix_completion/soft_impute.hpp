@@ -0,0 +1,247 @@
+/**
+ * @file methods/matrix_completion/soft_impute.hpp
+ *
+ * Definition of the SoftImpute class, which completes large sparsely observed
+ * matrices by iterative soft-thresholding of randomized partial SVDs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * This class solves the nuclear-norm regularized matrix completion problem
+ *
+ *   min_X 1/2 sum_{(i, j) observed} (X_ij - M_ij)^2 + lambda ||X||_*
+ *
+ * with the Soft-Impute algorithm:
+ *
+ * @code
+ * @article{mazumder2010spectral,
+ *   title={{Spectral Regularization Algorithms for Learning Large Incomplete
+ *       Matrices}},
+ *   author={Mazumder, R. and Hastie, T. and Tibshirani, R.},
+ *   journal={Journal of Machine Learning Research},
+ *   volume={11},
+ *   pages={2287--2322},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * Each iteration fills in the unobserved entries with the current estimate and
+ * soft-thresholds the singular values of the result.  The filled-in matrix is
+ * never formed: it is the sum of a sparse matrix (the residuals at the
+ * observed entries) and the current low-rank estimate, so its products with
+ * dense matrices take O(p * k + (m + n) * k^2) time for p observed entries and
+ * rank k, and its partial SVD is computed with a randomized subspace iteration
+ * (warm-started from the previous singular vectors).  The products with the
+ * sparse matrix are parallelized with OpenMP.  Unlike MatrixCompletion, which
+ * solves an SDP whose size grows with the number of observed entries, this
+ * scales to millions of observed entries.
+ *
+ * The solution is returned as the factors of its thin SVD, since the completed
+ * matrix of a large problem usually does not fit in memory; an overload that
+ * returns the dense matrix is also available.
+ *
+ * @code
+ * arma::sp_mat observations; // The observed entries of the matrix.
+ * arma::mat u, v;
+ * arma::vec s;
+ *
+ * SoftImpute si(0.05, 20); // At most rank 20.
+ * si.Recover(observations, u, s, v);
+ * // X(i, j) is approximated by
+ * // arma::dot(u.row(i).t() % s, v.row(j).t()).
+ * @endcode
+ *
+ * Note that entries of an arma::sp_mat that are zero are not stored, so they
+ * count as unobserved; use the overloads that take indices and values if
+ * observed entries can be zero.
+ *
+ * @see MatrixCompletion
+ */
+class SoftImpute
+{
+ public:
+  /**
+   * Set the parameters of the solver.
+   *
+   * @param lambda Regularization parameter, as a fraction of the largest
+   *     singular value of the matrix of observed entries (with zeros at the
+   *     unobserved entries); every singular value is shrunk by this much.
+   * @param maxRank Maximum rank of the solution.
+   * @param maxIterations Maximum number of iterations (0 means no limit).
+   * @param tolerance Convergence tolerance on the relative change of the
+   *     solution between iterations.
+   * @param powerIterations Number of power iterations of each randomized SVD.
+   * @param oversampling Number of extra columns of each randomized SVD.
+   */
+  SoftImpute(const double lambda = 0.05,
+             const size_t maxRank = 50,
+             const size_t maxIterations = 100,
+             const double tolerance = 1e-5,
+             const size_t powerIterations = 1,
+             const size_t oversampling = 10);
+
+  /**
+   * Complete the m x n matrix with the given observed entries, returning the
+   * factors of the thin SVD of the solution, `X = u * diagmat(s) * v.t()`.
+   *
+   * @param m Number of rows of the matrix.
+   * @param n Number of columns of the matrix.
+   * @param indices Indices of the observed entries (must be [2 x p]).
+   * @param values Values of the observed entries (must be length p).
+   * @param u Left singular vectors of the solution (m x rank).
+   * @param s Singular values of the solution.
+   * @param v Right singular vectors of the solution (n x rank).
+   */
+  void Recover(const size_t m,
+               const size_t n,
+               const arma::umat& indices,
+               const arma::vec& values,
+               arma::mat& u,
+               arma::vec& s,
+               arma::mat& v);
+
+  /**
+   * Complete the matrix given by its observed (nonzero) entries, returning the
+   * factors of the thin SVD of the solution, `X = u * diagmat(s) * v.t()`.
+   *
+   * @param observations Sparse matrix of the observed entries.
+   * @param u Left singular vectors of the solution (m x rank).
+   * @param s Singular values of the solution.
+   * @param v Right singular vectors of the solution (n x rank).
+   */
+  void Recover(const arma::sp_mat& observations,
+               arma::mat& u,
+               arma::vec& s,
+               arma::mat& v);
+
+  /**
+   * Complete the m x n matrix with the given observed entries, returning the
+   * dense completed matrix.
+   *
+   * @param m Number of rows of the matrix.
+   * @param n Number of columns of the matrix.
+   * @param indices Indices of the observed entries (must be [2 x p]).
+   * @param values Values of the observed entries (must be length p).
+   * @param recovered Will contain the completed matrix.
+   */
+  void Recover(const size_t m,
+               const size_t n,
+               const arma::umat& indices,
+               const arma::vec& values,
+               arma::mat& recovered);
+
+  /**
+   * Complete the matrix given by its observed (nonzero) entries, returning the
+   * dense completed matrix.
+   *
+   * @param observations Sparse matrix of the observed entries.
+   * @param recovered Will contain the completed matrix.
+   */
+  void Recover(const arma::sp_mat& observations, arma::mat& recovered);
+
+  //! Get the regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Get the maximum rank of the solution.
+  size_t MaxRank() const { return maxRank; }
+  //! Modify the maximum rank of the solution.
+  size_t& MaxRank() { return maxRank; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the convergence tolerance.
+  double Tolerance() const { return tolerance; }
+  //! Modify the convergence tolerance.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the number of power iterations of each randomized SVD.
+  size_t PowerIterations() const { return powerIterations; }
+  //! Modify the number of power iterations of each randomized SVD.
+  size_t& PowerIterations() { return powerIterations; }
+
+  //! Get the number of extra columns of each randomized SVD.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the number of extra columns of each randomized SVD.
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get the number of iterations of the last call to Recover().
+  size_t Iterations() const { return iterations; }
+
+ private:
+  /**
+   * Run Soft-Impute on the observed entries, given in compressed sparse
+   * column form.
+   */
+  void Solve(const size_t m,
+             const size_t n,
+             const arma::uvec& colPtrs,
+             const arma::uvec& rowIndices,
+             const arma::vec& values,
+             arma::mat& u,
+             arma::vec& s,
+             arma::mat& v);
+
+  /**
+   * Compute `Z * x`, where Z is the sparse matrix of residuals `res` (in
+   * compressed sparse row form) plus `u * diagmat(s) * v.t()`.
+   */
+  static void Multiply(const arma::uvec& rowPtrs,
+                       const arma::uvec& colIndices,
+                       const arma::uvec& cscOrder,
+                       const arma::vec& res,
+                       const arma::mat& u,
+                       const arma::vec& s,
+                       const arma::mat& v,
+                       const arma::mat& x,
+                       arma::mat& out);
+
+  /**
+   * Compute `Z^T * y`, where Z is the sparse matrix of residuals `res` (in
+   * compressed sparse column form) plus `u * diagmat(s) * v.t()`.
+   */
+  static void MultiplyTranspose(const arma::uvec& colPtrs,
+                                const arma::uvec& rowIndices,
+                                const arma::vec& res,
+                                const arma::mat& u,
+                                const arma::vec& s,
+                                const arma::mat& v,
+                                const arma::mat& y,
+                                arma::mat& out);
+
+  //! Regularization parameter, relative to the largest singular value.
+  double lambda;
+  //! Maximum rank of the solution.
+  size_t maxRank;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Convergence tolerance.
+  double tolerance;
+  //! Number of power iterations of each randomized SVD.
+  size_t powerIterations;
+  //! Number of extra columns of each randomized SVD.
+  size_t oversampling;
+  //! Number of iterations of the last call to Recover().
+  size_t iterations;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "soft_impute_impl.hpp"
+
+#endif
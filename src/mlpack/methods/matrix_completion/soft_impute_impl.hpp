@@ -0,0 +1,309 @@
+/**
+ * @file methods/matrix_completion/soft_impute_impl.hpp
+ *
+ * Implementation of the SoftImpute class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_IMPL_HPP
+#define MLPACK_METHODS_MATRIX_COMPLETION_SOFT_IMPUTE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "soft_impute.hpp"
+#include <mlpack/core/util/size_checks.hpp>
+
+namespace mlpack {
+
+inline SoftImpute::SoftImpute(const double lambda,
+                              const size_t maxRank,
+                              const size_t maxIterations,
+                              const double tolerance,
+                              const size_t powerIterations,
+                              const size_t oversampling) :
+    lambda(lambda),
+    maxRank(maxRank),
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    powerIterations(powerIterations),
+    oversampling(oversampling),
+    iterations(0)
+{
+  /* Nothing to do here */
+}
+
+inline void SoftImpute::Recover(const size_t m,
+                                const size_t n,
+                                const arma::umat& indices,
+                                const arma::vec& values,
+                                arma::mat& u,
+                                arma::vec& s,
+                                arma::mat& v)
+{
+  if (indices.n_rows != 2)
+  {
+    Log::Fatal << "SoftImpute::Recover(): matrix of indices does not have 2 "
+        << "rows!" << std::endl;
+  }
+
+  util::CheckSameSizes(indices, values, "SoftImpute::Recover()", "values",
+      false, true);
+
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    if (indices(0, i) >= m || indices(1, i) >= n)
+    {
+      Log::Fatal << "SoftImpute::Recover(): indices (" << indices(0, i) << ", "
+          << indices(1, i) << ") are out of bounds for matrix of size " << m
+          << " x " << n << "!" << std::endl;
+    }
+  }
+
+  // Sort the entries by column, and then by row.
+  const arma::uvec keys = indices.row(1).t() * m + indices.row(0).t();
+  const arma::uvec order = arma::sort_index(keys);
+
+  arma::uvec colPtrs(n + 1, arma::fill::zeros);
+  arma::uvec rowIndices(values.n_elem);
+  arma::vec sortedValues(values.n_elem);
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    rowIndices[i] = indices(0, order[i]);
+    sortedValues[i] = values[order[i]];
+    ++colPtrs[indices(1, order[i]) + 1];
+  }
+  colPtrs = arma::cumsum(colPtrs);
+
+  Solve(m, n, colPtrs, rowIndices, sortedValues, u, s, v);
+}
+
+inline void SoftImpute::Recover(const arma::sp_mat& observations,
+                                arma::mat& u,
+                                arma::vec& s,
+                                arma::mat& v)
+{
+  observations.sync();
+  const arma::uvec colPtrs(observations.col_ptrs, observations.n_cols + 1);
+  const arma::uvec rowIndices(observations.row_indices,
+      observations.n_nonzero);
+  const arma::vec values(observations.values, observations.n_nonzero);
+
+  Solve(observations.n_rows, observations.n_cols, colPtrs, rowIndices, values,
+      u, s, v);
+}
+
+inline void SoftImpute::Recover(const size_t m,
+                                const size_t n,
+                                const arma::umat& indices,
+                                const arma::vec& values,
+                                arma::mat& recovered)
+{
+  arma::mat u, v;
+  arma::vec s;
+  Recover(m, n, indices, values, u, s, v);
+  recovered = u * arma::diagmat(s) * v.t();
+}
+
+inline void SoftImpute::Recover(const arma::sp_mat& observations,
+                                arma::mat& recovered)
+{
+  arma::mat u, v;
+  arma::vec s;
+  Recover(observations, u, s, v);
+  recovered = u * arma::diagmat(s) * v.t();
+}
+
+inline void SoftImpute::Solve(const size_t m,
+                              const size_t n,
+                              const arma::uvec& colPtrs,
+                              const arma::uvec& rowIndices,
+                              const arma::vec& values,
+                              arma::mat& u,
+                              arma::vec& s,
+                              arma::mat& v)
+{
+  u.zeros(m, 0);
+  s.zeros(0);
+  v.zeros(n, 0);
+  iterations = 0;
+  if (values.n_elem == 0 || maxRank == 0)
+    return;
+
+  // The products with the transpose of the sparse matrix are parallelized over
+  // its columns, and the products with the sparse matrix over its rows, so we
+  // also need the entries in compressed sparse row form; cscOrder maps them
+  // back to the compressed sparse column order of the residuals.
+  arma::uvec rowPtrs(m + 1, arma::fill::zeros);
+  for (size_t i = 0; i < rowIndices.n_elem; ++i)
+    ++rowPtrs[rowIndices[i] + 1];
+  rowPtrs = arma::cumsum(rowPtrs);
+
+  arma::uvec colIndices(values.n_elem), cscOrder(values.n_elem);
+  arma::uvec next = rowPtrs.head(m);
+  for (size_t j = 0; j < n; ++j)
+  {
+    for (size_t i = colPtrs[j]; i < colPtrs[j + 1]; ++i)
+    {
+      const size_t pos = next[rowIndices[i]]++;
+      colIndices[pos] = j;
+      cscOrder[pos] = i;
+    }
+  }
+
+  // The threshold is relative to the largest singular value of the observed
+  // matrix, which we estimate with the power method.
+  arma::mat x = arma::randn<arma::mat>(n, 1), y;
+  x /= arma::norm(x, 2);
+  for (size_t i = 0; i < 20; ++i)
+  {
+    Multiply(rowPtrs, colIndices, cscOrder, values, u, s, v, x, y);
+    MultiplyTranspose(colPtrs, rowIndices, values, u, s, v, y, x);
+    const double norm = arma::norm(x, 2);
+    if (norm == 0.0)
+      break;
+    x /= norm;
+  }
+  Multiply(rowPtrs, colIndices, cscOrder, values, u, s, v, x, y);
+  const double threshold = lambda * arma::norm(y, 2);
+
+  const size_t k = std::min(maxRank + oversampling, std::min(m, n));
+  arma::vec residuals(values.n_elem);
+  arma::mat omega, q, r, z, bt, pu, pv;
+  arma::vec sb;
+  while (maxIterations == 0 || iterations < maxIterations)
+  {
+    ++iterations;
+
+    // Compute the residuals of the current solution at the observed entries.
+    const arma::mat usT = (u * arma::diagmat(s)).t();
+    const arma::mat vT = v.t();
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t j = 0; j < n; ++j)
+    {
+      for (size_t i = colPtrs[j]; i < colPtrs[j + 1]; ++i)
+      {
+        residuals[i] = values[i];
+        if (s.n_elem > 0)
+          residuals[i] -= arma::dot(usT.col(rowIndices[i]), vT.col(j));
+      }
+    }
+
+    // Compute a partial SVD of the residuals plus the current solution, with a
+    // randomized subspace iteration starting from the current right singular
+    // vectors.
+    omega = arma::join_rows(v, arma::randn<arma::mat>(n, k - v.n_cols));
+    Multiply(rowPtrs, colIndices, cscOrder, residuals, u, s, v, omega, y);
+    arma::qr_econ(q, r, y);
+    for (size_t i = 0; i < powerIterations; ++i)
+    {
+      MultiplyTranspose(colPtrs, rowIndices, residuals, u, s, v, q, z);
+      arma::qr_econ(q, r, z);
+      Multiply(rowPtrs, colIndices, cscOrder, residuals, u, s, v, q, y);
+      arma::qr_econ(q, r, y);
+    }
+
+    // Z ~= Q * B, and B^T = pv * diagmat(sb) * pu^T.
+    MultiplyTranspose(colPtrs, rowIndices, residuals, u, s, v, q, bt);
+    arma::svd_econ(pv, sb, pu, bt);
+
+    // Soft-threshold the singular values.
+    size_t rank = 0;
+    while (rank < std::min(maxRank, (size_t) sb.n_elem) &&
+        sb[rank] > threshold)
+      ++rank;
+
+    if (rank == 0)
+    {
+      Log::Warn << "SoftImpute::Recover(): all singular values are below the "
+          << "threshold; the solution is zero.  Try a smaller lambda."
+          << std::endl;
+      u.zeros(m, 0);
+      s.zeros(0);
+      v.zeros(n, 0);
+      return;
+    }
+
+    arma::mat newU = q * pu.head_cols(rank);
+    arma::vec newS = sb.head(rank) - threshold;
+    arma::mat newV = pv.head_cols(rank);
+
+    // The relative change of the solution is computed from the factors:
+    // ||X - X'||^2 = ||X||^2 + ||X'||^2 - 2 tr(X^T X').
+    const double oldNorm = arma::accu(arma::square(s));
+    const double newNorm = arma::accu(arma::square(newS));
+    const double cross = (s.n_elem == 0) ? 0.0 : arma::accu((s * newS.t()) %
+        (u.t() * newU) % (v.t() * newV));
+    const double change = (oldNorm + newNorm - 2.0 * cross) /
+        std::max(oldNorm, 1e-300);
+
+    u = std::move(newU);
+    s = std::move(newS);
+    v = std::move(newV);
+
+    Log::Info << "SoftImpute::Recover(): iteration " << iterations << ", rank "
+        << rank << ", relative change " << change << "." << std::endl;
+
+    if (oldNorm > 0.0 && change < tolerance)
+      break;
+  }
+
+  Log::Info << "SoftImpute::Recover(): finished after " << iterations
+      << " iterations, with rank " << s.n_elem << "." << std::endl;
+}
+
+inline void SoftImpute::Multiply(const arma::uvec& rowPtrs,
+                                 const arma::uvec& colIndices,
+                                 const arma::uvec& cscOrder,
+                                 const arma::vec& res,
+                                 const arma::mat& u,
+                                 const arma::vec& s,
+                                 const arma::mat& v,
+                                 const arma::mat& x,
+                                 arma::mat& out)
+{
+  // Hold the rows of x and of the result as columns, so that they are
+  // contiguous.
+  const arma::mat xT = x.t();
+  arma::mat outT(x.n_cols, rowPtrs.n_elem - 1, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t i = 0; i < (size_t) outT.n_cols; ++i)
+  {
+    for (size_t k = rowPtrs[i]; k < rowPtrs[i + 1]; ++k)
+      outT.col(i) += res[cscOrder[k]] * xT.col(colIndices[k]);
+  }
+
+  out = outT.t();
+  if (s.n_elem > 0)
+    out += u * arma::diagmat(s) * (v.t() * x);
+}
+
+inline void SoftImpute::MultiplyTranspose(const arma::uvec& colPtrs,
+                                          const arma::uvec& rowIndices,
+                                          const arma::vec& res,
+                                          const arma::mat& u,
+                                          const arma::vec& s,
+                                          const arma::mat& v,
+                                          const arma::mat& y,
+                                          arma::mat& out)
+{
+  const arma::mat yT = y.t();
+  arma::mat outT(y.n_cols, colPtrs.n_elem - 1, arma::fill::zeros);
+
+  #pragma omp parallel for schedule(dynamic, 64)
+  for (size_t j = 0; j < (size_t) outT.n_cols; ++j)
+  {
+    for (size_t k = colPtrs[j]; k < colPtrs[j + 1]; ++k)
+      outT.col(j) += res[k] * yT.col(rowIndices[k]);
+  }
+
+  out = outT.t();
+  if (s.n_elem > 0)
+    out += v * arma::diagmat(s) * (u.t() * y);
+}
+
+} // namespace mlpack
+
+#endif
@@ -82,6 +82,16 @@ class MeanShift
    * @param forceConvergence Flag whether to force each centroid seed to
    *     converge regardless of maxIterations.
    * @param useSeeds Set true to use seeds.
+   *
+   * The seeds are shifted in parallel if OpenMP is available.  If EarlyMerge()
+   * is true, all seeds are shifted one iteration at a time, and after each
+   * iteration a seed is removed if it has come within the radius of an
+   * already-converged centroid (where it would be removed as a duplicate if it
+   * converged), or if it is in the same hypercube bin as another seed, where
+   * the side of the bins is the convergence tolerance of the centroids.  This
+   * can save many iterations when there are many seeds, but
+   * seeds that pass close to a centroid before converging to a different mode
+   * are lost.  The results do not depend on the number of threads.
    */
   template<typename MatType, typename CentroidsType>
   void Cluster(const MatType& data,
@@ -121,6 +131,12 @@ class MeanShift
   //! Set the radius.
   void Radius(double radius);
 
+  //! Get whether seeds are merged with converged centroids during clustering.
+  bool EarlyMerge() const { return earlyMerge; }
+  //! Modify whether seeds are merged with converged centroids during
+  //! clustering.
+  bool& EarlyMerge() { return earlyMerge; }
+
   //! Get the kernel.
   const KernelType& Kernel() const { return kernel; }
   //! Modify the kernel.
@@ -176,6 +192,25 @@ class MeanShift
                     const std::vector<typename MatType::elem_type>&, /*unused*/
                     VecType& centroid);
 
+  /**
+   * Perform one mean shift iteration on the i'th centroid.  Returns true if the
+   * iterations for this centroid must stop, either because it has converged
+   * (then converged is set to true and the centroid is not changed) or because
+   * there are no points within the radius of the centroid.
+   *
+   * @param data The whole dataset (in the order of the reference tree).
+   * @param searcher Range searcher on the reference tree.
+   * @param centroids Matrix of centroids.
+   * @param i Index of the centroid to shift.
+   * @param converged Set to true if the centroid has converged.
+   */
+  template<typename MatType, typename SearcherType, typename CentroidsType>
+  bool ShiftCentroid(const MatType& data,
+                     SearcherType& searcher,
+                     CentroidsType& centroids,
+                     const size_t i,
+                     bool& converged);
+
   /**
    * If distance of two centroids is less than radius, one will be removed.
    * Points with distance to current centroid less than radius will be used
@@ -186,6 +221,9 @@ class MeanShift
   //! Maximum number of iterations before giving up.
   size_t maxIterations;
 
+  //! Whether seeds are merged with converged centroids during clustering.
+  bool earlyMerge;
+
   //! Instantiated kernel.
   KernelType kernel;
 };
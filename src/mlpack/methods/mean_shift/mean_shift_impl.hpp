@@ -19,6 +19,7 @@
 #include <mlpack/methods/range_search/range_search.hpp>
 
 #include "map"
+#include <set>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -34,6 +35,7 @@ MeanShift<UseKernel, KernelType>::MeanShift(const double radius,
                                             const KernelType kernel) :
     radius(radius),
     maxIterations(maxIterations),
+    earlyMerge(false),
     kernel(kernel)
 {
   // Nothing to do.
@@ -177,6 +179,47 @@ MeanShift<UseKernel, KernelType>::CalculateCentroid(
   return true;
 }
 
+// Perform one mean shift iteration on a centroid.
+template<bool UseKernel, typename KernelType>
+template<typename MatType, typename SearcherType, typename CentroidsType>
+inline bool MeanShift<UseKernel, KernelType>::ShiftCentroid(
+    const MatType& data,
+    SearcherType& searcher,
+    CentroidsType& centroids,
+    const size_t i,
+    bool& converged)
+{
+  using ElemType = typename MatType::elem_type;
+  using VecType = typename GetColType<MatType>::type;
+
+  RangeType<ElemType> validRadius((ElemType) 0, (ElemType) radius);
+  std::vector<std::vector<size_t>> neighbors;
+  std::vector<std::vector<ElemType>> distances;
+
+  // Store new centroid in this.
+  VecType newCentroid = zeros<VecType>(centroids.n_rows);
+
+  searcher.Search(centroids.unsafe_col(i), validRadius, neighbors, distances);
+  if (neighbors[0].size() == 0) // There are no points in the cluster.
+    return true;
+
+  // Calculate new centroid.
+  if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
+    newCentroid = centroids.unsafe_col(i);
+
+  // If the mean shift vector is small enough, it has converged.
+  if (EuclideanDistance::Evaluate(newCentroid, centroids.unsafe_col(i)) <
+      1e-3 * radius)
+  {
+    converged = true;
+    return true;
+  }
+
+  // Update the centroid.
+  centroids.col(i) = newCentroid;
+  return false;
+}
+
 /**
  * Perform Mean Shift clustering on the data set, returning a list of centroids.
  */
@@ -190,7 +233,6 @@ inline void MeanShift<UseKernel, KernelType>::Cluster(
 {
   // Convenience typedefs.
   using ElemType = typename MatType::elem_type;
-  using VecType = typename GetColType<MatType>::type;
 
   if (radius <= 0)
   {
@@ -207,59 +249,114 @@ inline void MeanShift<UseKernel, KernelType>::Cluster(
   }
 
   // Holds all centroids before removing duplicate ones.
-  CentroidsType allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  CentroidsType allCentroids(*pSeeds);
+
+  // The reference tree is built once, and each thread runs single-tree range
+  // searches on it.  The points of the tree are rearranged, but the shifted
+  // centroids only depend on the set of points found by each range search.
+  using SearcherType = RangeSearch<EuclideanDistance, MatType>;
+  typename SearcherType::Tree tree(data);
+  const MatType& treeData = tree.Dataset();
+
+  // Return whether the i'th centroid is a duplicate of one of the centroids
+  // found so far.
+  auto isDuplicate = [&](const size_t i)
+  {
+    for (size_t k = 0; k < centroids.n_cols; ++k)
+    {
+      const ElemType distance = EuclideanDistance::Evaluate(
+          allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+      if (distance < radius)
+        return true;
+    }
 
-  RangeSearch<EuclideanDistance, MatType> rangeSearcher(data);
-  RangeType<ElemType> validRadius((ElemType) 0, (ElemType) radius);
-  std::vector<std::vector<size_t>> neighbors;
-  std::vector<std::vector<ElemType>> distances;
+    return false;
+  };
 
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  if (!earlyMerge)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
+    // For each seed, perform mean shift algorithm.  The seeds are independent,
+    // so they can be shifted in parallel.
+    std::vector<char> converged(pSeeds->n_cols, 0);
+    #pragma omp parallel
     {
-      // Store new centroid in this.
-      VecType newCentroid = zeros<VecType>(pSeeds->n_rows);
+      SearcherType searcher(&tree, true);
 
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < pSeeds->n_cols; ++i)
+      {
+        bool seedConverged = false;
+        for (size_t completedIterations = 0; completedIterations < maxIterations
+            || forceConvergence; completedIterations++)
+        {
+          if (ShiftCentroid(treeData, searcher, allCentroids, i,
+              seedConverged))
+            break;
+        }
 
-      // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
-        newCentroid = allCentroids.unsafe_col(i);
+        converged[i] = seedConverged;
+      }
+    }
 
-      // If the mean shift vector is small enough, it has converged.
-      if (EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+    // Remove duplicate centroids, in the order of the seeds.
+    for (size_t i = 0; i < pSeeds->n_cols; ++i)
+      if (converged[i] && !isDuplicate(i))
+        centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+  }
+  else
+  {
+    // Shift all remaining seeds one iteration at a time, and merge them after
+    // each iteration.
+    using CentroidVecType = typename GetColType<CentroidsType>::type;
+    const ElemType binSize = (ElemType) (1e-3 * radius);
+    std::vector<size_t> active(pSeeds->n_cols), nextActive;
+    for (size_t i = 0; i < active.size(); ++i)
+      active[i] = i;
+
+    for (size_t completedIterations = 0; !active.empty() &&
+        (completedIterations < maxIterations || forceConvergence);
+        completedIterations++)
+    {
+      std::vector<char> stopped(active.size(), 0);
+      std::vector<char> converged(active.size(), 0);
+      #pragma omp parallel
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
+        SearcherType searcher(&tree, true);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (size_t a = 0; a < active.size(); ++a)
         {
-          const ElemType distance = EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
+          bool seedConverged = false;
+          stopped[a] = ShiftCentroid(treeData, searcher, allCentroids,
+              active[a], seedConverged);
+          converged[a] = seedConverged;
         }
+      }
+
+      // Merge the seeds in order, so that the results do not depend on the
+      // number of threads.
+      std::set<CentroidVecType, less<CentroidVecType>> bins;
+      nextActive.clear();
+      for (size_t a = 0; a < active.size(); ++a)
+      {
+        const size_t i = active[a];
+        if (isDuplicate(i))
+          continue;
 
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+        if (stopped[a])
+        {
+          if (converged[a])
+            centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
+          continue;
+        }
 
-        // Get out of the loop.
-        break;
+        const CentroidVecType bin = arma::floor(allCentroids.unsafe_col(i) /
+            binSize);
+        if (bins.insert(bin).second)
+          nextActive.push_back(i);
       }
 
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
+      active.swap(nextActive);
     }
   }
 
@@ -108,6 +108,13 @@ class NaiveBayesClassifier
    * classes, either re-initialize or call Means(), Variances(), and
    * Probabilities() individually to set them to the right size.
    *
+   * With the incremental algorithm, a stream of data can be trained on one
+   * chunk at a time: the per-class counts, means, and sums of squared
+   * deviations of the chunk are computed in parallel (each thread takes a
+   * contiguous range of points), and are merged into the model with the
+   * pairwise update of Chan, Golub and LeVeque, so that training on several
+   * chunks gives the same model as training on all of them at once.
+   *
    * @param data The dataset to train on.
    * @param labels The labels for the dataset.
    * @param numClasses The number of classes in the dataset.
@@ -183,7 +190,8 @@ class NaiveBayesClassifier
 
   /**
    * Classify the given points using the trained NaiveBayesClassifier model.
-   * The predicted labels for each point are stored in the given vector.
+   * The predicted labels for each point are stored in the given vector.  The
+   * points are classified in parallel.
    *
    * @code
    * arma::mat test_data; // each column is a test point
@@ -285,6 +293,44 @@ class NaiveBayesClassifier
   template<typename MatType>
   void LogLikelihood(const MatType& data,
                      ModelMatType& logLikelihoods) const;
+
+  /**
+   * Compute the number of points, the mean, and the sum of squared deviations
+   * from the mean of each feature for each class in the given chunk of data,
+   * in parallel.
+   *
+   * @param data Chunk of points.
+   * @param labels Labels of the points.
+   * @param numClasses Number of classes.
+   * @param counts Will be set to the number of points of each class.
+   * @param chunkMeans Will be set to the mean of each class.
+   * @param m2 Will be set to the sum of squared deviations of each class.
+   */
+  template<typename MatType>
+  static void ChunkStatistics(const MatType& data,
+                              const arma::Row<size_t>& labels,
+                              const size_t numClasses,
+                              arma::Col<ElemType>& counts,
+                              ModelMatType& chunkMeans,
+                              ModelMatType& m2);
+
+  /**
+   * Merge the per-class statistics of a set of points into the statistics of
+   * another, disjoint set of points.
+   *
+   * @param otherCounts Number of points of each class to merge.
+   * @param otherMeans Mean of each class to merge.
+   * @param otherM2 Sum of squared deviations of each class to merge.
+   * @param counts Number of points of each class, which will be updated.
+   * @param totalMeans Mean of each class, which will be updated.
+   * @param m2 Sum of squared deviations of each class, which will be updated.
+   */
+  static void MergeStatistics(const arma::Col<ElemType>& otherCounts,
+                              const ModelMatType& otherMeans,
+                              const ModelMatType& otherM2,
+                              arma::Col<ElemType>& counts,
+                              ModelMatType& totalMeans,
+                              ModelMatType& m2);
 };
 
 } // namespace mlpack
@@ -94,25 +94,45 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     if (probabilities.n_elem != numClasses || data.n_rows != means.n_rows)
       Reset(data.n_rows, numClasses);
 
-    // Use incremental algorithm.
-    // Fist, de-normalize probabilities.
-    probabilities *= trainingPoints;
-
-    for (size_t j = 0; j < data.n_cols; ++j)
+    // Use incremental algorithm.  The statistics of the chunk are computed in
+    // parallel and then merged into the model.
+    arma::Col<ElemType> counts = arma::round(vectorise(probabilities) *
+        (ElemType) trainingPoints);
+    ModelMatType m2(variances.n_rows, variances.n_cols);
+    for (size_t i = 0; i < counts.n_elem; ++i)
     {
-      const size_t label = labels[j];
-      ++probabilities[label];
-
-      arma::Col<ElemType> delta = data.col(j) - means.col(label);
-      means.col(label) += delta / probabilities[label];
-      variances.col(label) += delta % (data.col(j) - means.col(label));
+      // De-normalize the variances, without the epsilon we added.
+      if (counts[i] > 1)
+      {
+        m2.col(i) = clamp(variances.col(i) - epsilon, 0,
+            std::numeric_limits<ElemType>::max()) * (counts[i] - 1);
+      }
+      else
+      {
+        m2.col(i).zeros();
+      }
     }
 
-    for (size_t i = 0; i < probabilities.n_elem; ++i)
+    arma::Col<ElemType> chunkCounts;
+    ModelMatType chunkMeans, chunkM2;
+    ChunkStatistics(data, labels, numClasses, chunkCounts, chunkMeans,
+        chunkM2);
+    MergeStatistics(chunkCounts, chunkMeans, chunkM2, counts, means, m2);
+
+    for (size_t i = 0; i < counts.n_elem; ++i)
     {
-      if (probabilities[i] > 2)
-        variances.col(i) /= (probabilities[i] - 1);
+      variances.col(i) = m2.col(i);
+      if (counts[i] > 1)
+        variances.col(i) /= (counts[i] - 1);
     }
+
+    // Add epsilon to prevent log of zero.
+    variances += epsilon;
+
+    trainingPoints += data.n_cols;
+    probabilities = counts;
+    if (trainingPoints > 0)
+      probabilities /= trainingPoints;
   }
   else
   {
@@ -151,13 +171,13 @@ void NaiveBayesClassifier<ModelMatType>::Train(
     for (size_t i = 0; i < probabilities.n_elem; ++i)
       if (probabilities[i] > 1)
         variances.col(i) /= (probabilities[i] - 1);
-  }
 
-  // Add epsilon to prevent log of zero.
-  variances += epsilon;
+    // Add epsilon to prevent log of zero.
+    variances += epsilon;
 
-  probabilities /= data.n_cols;
-  trainingPoints += data.n_cols;
+    probabilities /= data.n_cols;
+    trainingPoints += data.n_cols;
+  }
 }
 
 template<typename ModelMatType>
@@ -207,6 +227,69 @@ void NaiveBayesClassifier<ModelMatType>::Train(const VecType& point,
   probabilities /= trainingPoints;
 }
 
+template<typename ModelMatType>
+template<typename MatType>
+void NaiveBayesClassifier<ModelMatType>::ChunkStatistics(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    arma::Col<ElemType>& counts,
+    ModelMatType& chunkMeans,
+    ModelMatType& m2)
+{
+  counts.zeros(numClasses);
+  chunkMeans.zeros(data.n_rows, numClasses);
+  m2.zeros(data.n_rows, numClasses);
+
+  #pragma omp parallel
+  {
+    // Each thread takes a contiguous range of points, and computes their
+    // statistics with Welford's algorithm.
+    arma::Col<ElemType> threadCounts(numClasses, arma::fill::zeros);
+    ModelMatType threadMeans(data.n_rows, numClasses, arma::fill::zeros);
+    ModelMatType threadM2(data.n_rows, numClasses, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (size_t j = 0; j < (size_t) data.n_cols; ++j)
+    {
+      const size_t label = labels[j];
+      ++threadCounts[label];
+
+      arma::Col<ElemType> delta = data.col(j) - threadMeans.col(label);
+      threadMeans.col(label) += delta / threadCounts[label];
+      threadM2.col(label) += delta % (data.col(j) - threadMeans.col(label));
+    }
+
+    #pragma omp critical
+    MergeStatistics(threadCounts, threadMeans, threadM2, counts, chunkMeans,
+        m2);
+  }
+}
+
+template<typename ModelMatType>
+void NaiveBayesClassifier<ModelMatType>::MergeStatistics(
+    const arma::Col<ElemType>& otherCounts,
+    const ModelMatType& otherMeans,
+    const ModelMatType& otherM2,
+    arma::Col<ElemType>& counts,
+    ModelMatType& totalMeans,
+    ModelMatType& m2)
+{
+  for (size_t i = 0; i < counts.n_elem; ++i)
+  {
+    if (otherCounts[i] == 0)
+      continue;
+
+    // This is the pairwise update of Chan, Golub and LeVeque.
+    const ElemType total = counts[i] + otherCounts[i];
+    const arma::Col<ElemType> delta = otherMeans.col(i) - totalMeans.col(i);
+    totalMeans.col(i) += delta * (otherCounts[i] / total);
+    m2.col(i) += otherM2.col(i) +
+        square(delta) * (counts[i] * otherCounts[i] / total);
+    counts[i] = total;
+  }
+}
+
 template<typename ModelMatType>
 template<typename MatType>
 void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
@@ -217,23 +300,38 @@ void NaiveBayesClassifier<ModelMatType>::LogLikelihood(
       "NaiveBayesClassifier: element type of given data must match the element "
       "type of the model!");
 
-  logLikelihoods = log(repmat(probabilities, 1, data.n_cols));
-  ModelMatType invVar = 1.0 / variances;
+  logLikelihoods.set_size(means.n_cols, data.n_cols);
+  const ModelMatType invVar = 1.0 / variances;
 
-  // Calculate the joint log likelihood of point for each of the
-  // means.n_cols.
-
-  // Loop over every class.
+  // The log of the prior and of the normalizing constant of each class.
+  arma::Col<ElemType> logNorms(means.n_cols);
   for (size_t i = 0; i < means.n_cols; ++i)
   {
-    // This is an adaptation of phi() for the case where the covariance is a
-    // diagonal matrix.
-    ModelMatType diffs = data - repmat(means.col(i), 1, data.n_cols);
-    ModelMatType rhs = -0.5 * arma::diagmat(invVar.col(i)) * diffs;
-    arma::Mat<ElemType> exponents = sum(diffs % rhs, 0);
-
-    logLikelihoods.row(i) += (data.n_rows / -2.0 * std::log(2 * M_PI) - 0.5 *
-        accu(log(variances.col(i))) + exponents);
+    logNorms[i] = std::log(probabilities[i]) + data.n_rows / -2.0 *
+        std::log(2 * M_PI) - 0.5 * accu(log(variances.col(i)));
+  }
+
+  // Calculate the joint log likelihood of each point for each of the
+  // means.n_cols classes.  The points are independent, so blocks of them are
+  // handled in parallel.
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (data.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) data.n_cols) - 1;
+    const ModelMatType block(data.cols(begin, end));
+
+    // Loop over every class.
+    for (size_t i = 0; i < means.n_cols; ++i)
+    {
+      // This is an adaptation of phi() for the case where the covariance is a
+      // diagonal matrix.
+      ModelMatType diffs = block.each_col() - means.col(i);
+      logLikelihoods.submat(i, begin, i, end) = logNorms[i] - 0.5 *
+          (invVar.col(i).t() * square(diffs));
+    }
   }
 }
 
@@ -328,7 +426,8 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   ModelMatType logLikelihoods;
   LogLikelihood(data, logLikelihoods);
 
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < (size_t) data.n_cols; ++i)
   {
     arma::uword maxIndex = logLikelihoods.unsafe_col(i).index_max();
     predictions[i] = maxIndex;
@@ -365,24 +464,21 @@ void NaiveBayesClassifier<ModelMatType>::Classify(
   LogLikelihood(data, logLikelihoods);
 
   predictionProbs.set_size(arma::size(logLikelihoods));
-  double maxValue, logProbX;
-  for (size_t j = 0; j < data.n_cols; ++j)
+  #pragma omp parallel for schedule(static)
+  for (size_t j = 0; j < (size_t) data.n_cols; ++j)
   {
     // The LogLikelihood() gives us the unnormalized log likelihood which is
     // Log(Prob(X|Y)) + Log(Prob(Y)), so we subtract the normalization term.
     // Besides, to prevent underflow in log of sum of exp of x operation (where
     // x is a small negative value), we use logsumexp(x - max(x)) + max(x).
-    maxValue = max(logLikelihoods.col(j));
-    logProbX = std::log(accu(exp(logLikelihoods.col(j) -
+    const double maxValue = max(logLikelihoods.col(j));
+    const double logProbX = std::log(accu(exp(logLikelihoods.col(j) -
         maxValue))) + maxValue;
     predictionProbs.col(j) = exp(logLikelihoods.col(j) - logProbX);
-  }
 
-  // Now calculate maximum probabilities for each point.
-  for (size_t i = 0; i < data.n_cols; ++i)
-  {
-    arma::uword maxIndex = logLikelihoods.unsafe_col(i).index_max();
-    predictions[i] = maxIndex;
+    // Now calculate the maximum probability for the point.
+    arma::uword maxIndex = logLikelihoods.unsafe_col(j).index_max();
+    predictions[j] = maxIndex;
   }
 }
 
@@ -63,9 +63,20 @@ class NCA
 
   /**
    * Construct the Neighborhood Components Analysis object, optionally with an
-   * instantiated distance metric.
+   * instantiated distance metric.  If neighbors is greater than 0, the
+   * objective is truncated to the given number of nearest neighbors of each
+   * point (see SoftmaxErrorFunction), which makes each iteration roughly
+   * linear-time instead of quadratic.
+   *
+   * @param distance Instantiated distance metric to use.
+   * @param neighbors Number of nearest neighbors to consider for each point; 0
+   *     considers all points.
+   * @param refreshInterval Number of passes over the dataset after which the
+   *     neighbor lists are recomputed (if neighbors > 0).
    */
-  NCA(DistanceType distance = DistanceType());
+  NCA(DistanceType distance = DistanceType(),
+      const size_t neighbors = 0,
+      const size_t refreshInterval = 10);
 
   /**
    * Perform Neighborhood Components Analysis.  The output distance learning
@@ -166,6 +177,16 @@ class NCA
   //! Modify the distance.
   DistanceType& Distance() { return distance; }
 
+  //! Get the number of neighbors considered for each point (0 means all).
+  size_t Neighbors() const { return neighbors; }
+  //! Modify the number of neighbors considered for each point (0 means all).
+  size_t& Neighbors() { return neighbors; }
+
+  //! Get the number of passes over the dataset between neighbor refreshes.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of passes over the dataset between neighbor refreshes.
+  size_t& RefreshInterval() { return refreshInterval; }
+
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
 
@@ -179,10 +200,19 @@ class NCA
 
   //! Distance to be used.
   DistanceType distance;
+
+  //! Number of nearest neighbors considered for each point (0 means all).
+  size_t neighbors;
+  //! Number of passes over the dataset between neighbor refreshes.
+  size_t refreshInterval;
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename DistanceType,
+    typename DeprecatedOptimizerType),
+    (mlpack::NCA<DistanceType, DeprecatedOptimizerType>), (1));
+
 // Include the implementation.
 #include "nca_impl.hpp"
 
@@ -25,12 +25,19 @@ NCA<DistanceType, DeprecatedOptimizerType>::NCA(
     DistanceType distance) :
     dataset(&dataset),
     labels(&labels),
-    distance(std::move(distance))
+    distance(std::move(distance)),
+    neighbors(0),
+    refreshInterval(10)
 { /* Nothing to do. */ }
 
 template<typename DistanceType, typename DeprecatedOptimizerType>
-NCA<DistanceType, DeprecatedOptimizerType>::NCA(DistanceType distance) :
-    distance(std::move(distance))
+NCA<DistanceType, DeprecatedOptimizerType>::NCA(
+    DistanceType distance,
+    const size_t neighbors,
+    const size_t refreshInterval) :
+    distance(std::move(distance)),
+    neighbors(neighbors),
+    refreshInterval(refreshInterval)
 { /* Nothing to do. */ }
 
 template<typename DistanceType, typename DeprecatedOptimizerType>
@@ -84,7 +91,7 @@ void NCA<DistanceType, DeprecatedOptimizerType>::LearnDistance(
     CallbackTypes&&... callbacks) const
 {
   SoftmaxErrorFunction<MatType, LabelsType, DistanceType> errorFunction(
-      dataset, labels, distance);
+      dataset, labels, distance, neighbors, refreshInterval);
 
   // See if we were passed an initialized matrix.
   if ((outputMatrix.n_rows != dataset.n_rows) ||
@@ -98,9 +105,21 @@ void NCA<DistanceType, DeprecatedOptimizerType>::LearnDistance(
 template<typename DistanceType, typename DeprecatedOptimizerType>
 template<typename Archive>
 void NCA<DistanceType, DeprecatedOptimizerType>::serialize(
-    Archive& ar, const uint32_t /* version */)
+    Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(distance));
+
+  // Older versions did not support the truncated objective.
+  if (version > 0)
+  {
+    ar(CEREAL_NVP(neighbors));
+    ar(CEREAL_NVP(refreshInterval));
+  }
+  else if (cereal::is_loading<Archive>())
+  {
+    neighbors = 0;
+    refreshInterval = 10;
+  }
 }
 
 } // namespace mlpack
@@ -90,7 +90,14 @@ BINDING_LONG_DESC(
     "mlpack L-BFGS documentation (in lbfgs.hpp) or the vast set of published "
     "literature on L-BFGS."
     "\n\n"
-    "By default, the SGD optimizer is used.");
+    "By default, the SGD optimizer is used."
+    "\n\n"
+    "Each evaluation of the objective considers all pairs of points, which "
+    "takes quadratic time.  For large datasets, the " +
+    PRINT_PARAM_STRING("neighbors") + " parameter can be used to only consider "
+    "the given number of nearest neighbors of each point (in the transformed "
+    "space); the neighbors are recomputed after every " +
+    PRINT_PARAM_STRING("refresh_interval") + " passes over the dataset.");
 
 // See also...
 BINDING_SEE_ALSO("@lmnn", "#lmnn");
@@ -132,6 +139,12 @@ PARAM_DOUBLE_IN("min_step", "Minimum step of line search for L-BFGS.", "m",
 PARAM_DOUBLE_IN("max_step", "Maximum step of line search for L-BFGS.", "M",
     1e20);
 
+PARAM_INT_IN("neighbors", "Number of nearest neighbors to consider for each "
+    "point (0 considers all points).", "k", 0);
+PARAM_INT_IN("refresh_interval", "Number of passes over the dataset after "
+    "which the nearest neighbors are recomputed (if --neighbors is given).",
+    "R", 10);
+
 PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
 
 using namespace mlpack;
@@ -177,6 +190,17 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     ReportIgnoredParam(params, "batch_size", "SGD optimizer is not being used");
   }
 
+  RequireParamValue<int>(params, "neighbors", [](int x) { return x >= 0; },
+      true, "number of neighbors must be non-negative");
+  RequireParamValue<int>(params, "refresh_interval",
+      [](int x) { return x >= 0; }, true,
+      "refresh interval must be non-negative");
+  if (!params.Has("neighbors"))
+  {
+    ReportIgnoredParam(params, "refresh_interval",
+        "the objective is not truncated (--neighbors is not given)");
+  }
+
   const double stepSize = params.Get<double>("step_size");
   const size_t maxIterations = (size_t) params.Get<int>("max_iterations");
   const double tolerance = params.Get<double>("tolerance");
@@ -241,7 +265,9 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   // Now create the NCA object and run the optimization.
   timers.Start("nca_optimization");
-  NCA nca;
+  NCA nca(SquaredEuclideanDistance(),
+      (size_t) params.Get<int>("neighbors"),
+      (size_t) params.Get<int>("refresh_interval"));
   if (optimizerType == "sgd")
   {
     ens::StandardSGD opt;
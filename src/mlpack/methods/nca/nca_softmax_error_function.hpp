@@ -17,6 +17,7 @@
 #include <mlpack/core/distances/lmetric.hpp>
 #include <mlpack/core/math/make_alias.hpp>
 #include <mlpack/core/math/shuffle_data.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
 
 namespace mlpack {
 
@@ -39,6 +40,16 @@ namespace mlpack {
  * optimizers use, overloads of Evaluate() and Gradient() are given which only
  * operate on one point in the dataset.  This is useful for optimizers like
  * stochastic gradient descent (see mlpack::optimization::SGD).
+ *
+ * By default, each evaluation considers all O(n^2) pairs of points.  If a
+ * number of neighbors is given, the function is instead truncated: the sums
+ * for each point x_i run only over its nearest neighbors (in the stretched
+ * space A x), which carry nearly all of the softmax mass, so that each
+ * evaluation takes O(n * neighbors) time.  The neighbor lists are found with a
+ * NeighborSearch (using the Euclidean distance) on the stretched points, and
+ * are refreshed after every refreshInterval passes over the dataset (that is,
+ * every refreshInterval iterations of a full-batch optimizer such as L-BFGS,
+ * or every refreshInterval epochs of SGD).
  */
 template<typename MatType = arma::mat,
          typename LabelsType = arma::Row<size_t>,
@@ -60,10 +71,16 @@ class SoftmaxErrorFunction
    * @param dataset Matrix containing the dataset.
    * @param labels Vector of class labels for each point in the dataset.
    * @param metric Instantiated metric (optional).
+   * @param neighbors Number of nearest neighbors to consider for each point;
+   *     0 considers all points.
+   * @param refreshInterval Number of passes over the dataset after which the
+   *     neighbor lists are recomputed (if neighbors > 0).
    */
   SoftmaxErrorFunction(const MatType& dataset,
                        const LabelsType& labels,
-                       DistanceType metric = DistanceType());
+                       DistanceType metric = DistanceType(),
+                       const size_t neighbors = 0,
+                       const size_t refreshInterval = 10);
 
   /**
    * Shuffle the dataset.
@@ -137,6 +154,20 @@ class SoftmaxErrorFunction
    */
   size_t NumFunctions() const { return dataset.n_cols; }
 
+  //! Get the number of neighbors considered for each point (0 means all).
+  size_t Neighbors() const { return neighbors; }
+  //! Modify the number of neighbors considered for each point (0 means all).
+  size_t& Neighbors() { return neighbors; }
+
+  //! Get the number of passes over the dataset between neighbor refreshes.
+  size_t RefreshInterval() const { return refreshInterval; }
+  //! Modify the number of passes over the dataset between neighbor refreshes.
+  size_t& RefreshInterval() { return refreshInterval; }
+
+  //! Get the current neighbor lists (one column per point; empty if
+  //! neighbors is 0 or nothing was evaluated yet).
+  const arma::umat& NeighborLists() const { return neighborLists; }
+
  private:
   //! The dataset.  This is an alias until Shuffle() is called.
   MatType dataset;
@@ -160,6 +191,19 @@ class SoftmaxErrorFunction
   //! False if nothing has ever been precalculated (only at construction time).
   bool precalculated;
 
+  //! Number of nearest neighbors considered for each point (0 means all).
+  size_t neighbors;
+  //! Number of passes over the dataset between neighbor refreshes.
+  size_t refreshInterval;
+  //! Nearest neighbors of each point in the stretched space (one column per
+  //! point), if neighbors > 0.
+  arma::umat neighborLists;
+  //! exp(-D(A x_i, A x_j)) for each neighbor j of each point i, for the
+  //! non-separable Evaluate() and Gradient().
+  MatType neighborEvals;
+  //! Number of points evaluated since the neighbor lists were refreshed.
+  size_t pointsSinceRefresh;
+
   /**
    * Precalculate the denominators and numerators that will make up the p_ij,
    * but only if the coordinates matrix is different than the last coordinates
@@ -174,6 +218,30 @@ class SoftmaxErrorFunction
    * @param coordinates Coordinates matrix to use for precalculation.
    */
   void Precalculate(const MatType& coordinates);
+
+  /**
+   * Recompute the neighbor lists, if there are none yet, or if
+   * refreshInterval passes over the dataset were made since the last refresh,
+   * and count the given number of evaluated points.  If stretched is true,
+   * stretchedDataset already holds the stretched dataset for the given
+   * coordinates.
+   */
+  void UpdateNeighbors(const MatType& coordinates,
+                       const size_t points,
+                       const bool stretched);
+
+  /**
+   * Compute exp(-D(A x_i, A x_j)) for each neighbor j of point i, and return
+   * the denominator and numerator of p_i (the sum over all neighbors and over
+   * those in the class of x_i).  If stretched is true, the stretched points
+   * are taken from stretchedDataset.
+   */
+  void NeighborTerms(const MatType& coordinates,
+                     const size_t i,
+                     const bool stretched,
+                     VecType& evals,
+                     ElemType& denominator,
+                     ElemType& numerator);
 };
 
 } // namespace mlpack
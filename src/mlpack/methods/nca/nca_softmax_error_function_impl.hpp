@@ -24,9 +24,14 @@ template<typename MatType, typename LabelsType, typename DistanceType>
 SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::SoftmaxErrorFunction(
     const MatType& datasetIn,
     const LabelsType& labelsIn,
-    DistanceType distance) :
+    DistanceType distance,
+    const size_t neighbors,
+    const size_t refreshInterval) :
     distance(distance),
-    precalculated(false)
+    precalculated(false),
+    neighbors(neighbors),
+    refreshInterval(refreshInterval),
+    pointsSinceRefresh(0)
 {
   MakeAlias(dataset, datasetIn, datasetIn.n_rows, datasetIn.n_cols, 0, false);
   MakeAlias(labels, labelsIn, labelsIn.n_elem, 0, false);
@@ -46,6 +51,11 @@ void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::Shuffle()
 
   dataset = std::move(newDataset);
   labels = std::move(newLabels);
+
+  // The order of the points changed, so nothing precalculated is valid
+  // anymore.
+  precalculated = false;
+  neighborLists.reset();
 }
 
 //! The non-separable implementation, which uses Precalculate() to save time.
@@ -70,18 +80,39 @@ SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::Evaluate(
     const size_t begin,
     const size_t batchSize)
 {
-  // Unfortunately each evaluation will take O(N) time because it requires a
-  // scan over all points in the dataset.  Our objective is to compute p_i.
-  ElemType denominator = 0;
-  ElemType numerator = 0;
   ElemType result = 0;
 
+  // In the truncated mode, only the neighbors of each point are considered,
+  // so only they have to be stretched.
+  if (neighbors > 0)
+  {
+    UpdateNeighbors(coordinates, batchSize, false);
+
+    #pragma omp parallel for reduction(+:result)
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      VecType evals;
+      ElemType denominator, numerator;
+      NeighborTerms(coordinates, i, false, evals, denominator, numerator);
+
+      // A zero denominator means that there is no contribution.
+      if (denominator != 0)
+        result += -(numerator / denominator);
+    }
+
+    return result;
+  }
+
+  // Unfortunately each evaluation will take O(N) time because it requires a
+  // scan over all points in the dataset.  Our objective is to compute p_i.
   // It's quicker to do this now than one point at a time later.
   stretchedDataset = coordinates * dataset;
 
   #pragma omp parallel for reduction(+:result)
   for (size_t i = begin; i < begin + batchSize; ++i)
   {
+    ElemType denominator = 0;
+    ElemType numerator = 0;
     for (size_t k = 0; k < dataset.n_cols; ++k)
     {
       // Don't consider the case where the points are the same.
@@ -133,28 +164,67 @@ void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::Gradient(
   //     (((p_i - (1 / p_i)) p_ik) + ((p_k - (1 / p_k)) p_ki)) x_ik x_ik^T
   //   otherwise, add
   //     (p_i p_ik + p_k p_ki) x_ik x_ik^T
+  //
+  // In the truncated mode, the sum for each i only runs over its neighbors k,
+  // and we add p_ik (p_i - 1) x_ik x_ik^T if they are in the same class, and
+  // p_ik p_i x_ik x_ik^T otherwise.
+  //
+  // Each thread accumulates its own sum, and the sums are added at the end.
   MatType sum;
-  sum.zeros(stretchedDataset.n_rows, stretchedDataset.n_rows);
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  sum.zeros(dataset.n_rows, dataset.n_rows);
+  #pragma omp parallel
   {
-    for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
-    {
-      // Calculate p_ik and p_ki first.
-      ElemType eval = std::exp(-distance.Evaluate(
-          stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
-      ElemType p_ik = 0, p_ki = 0;
-      p_ik = eval / denominators(i);
-      p_ki = eval / denominators(k);
+    MatType threadSum;
+    threadSum.zeros(dataset.n_rows, dataset.n_rows);
 
-      // Subtract x_i from x_k.  We are not using stretched points here.
-      VecType x_ik = dataset.col(i) - dataset.col(k);
-      MatType secondTerm = (x_ik * trans(x_ik));
-
-      if (labels[i] == labels[k])
-        sum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
-      else
-        sum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+    if (neighbors > 0)
+    {
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < (size_t) stretchedDataset.n_cols; ++i)
+      {
+        // Subtract x_i from each x_k.  We are not using stretched points here.
+        MatType differences = dataset.cols(neighborLists.col(i));
+        differences.each_col() -= dataset.col(i);
+
+        VecType weights = neighborEvals.col(i) / denominators[i];
+        for (size_t j = 0; j < weights.n_elem; ++j)
+        {
+          weights[j] *= (labels[i] == labels[neighborLists(j, i)]) ?
+              (p[i] - 1) : p[i];
+        }
+
+        threadSum += (differences.each_row() % weights.t()) *
+            trans(differences);
+      }
+    }
+    else
+    {
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < (size_t) stretchedDataset.n_cols; ++i)
+      {
+        for (size_t k = (i + 1); k < stretchedDataset.n_cols; ++k)
+        {
+          // Calculate p_ik and p_ki first.
+          ElemType eval = std::exp(-distance.Evaluate(
+              stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(k)));
+          ElemType p_ik = 0, p_ki = 0;
+          p_ik = eval / denominators(i);
+          p_ki = eval / denominators(k);
+
+          // Subtract x_i from x_k.  We are not using stretched points here.
+          VecType x_ik = dataset.col(i) - dataset.col(k);
+          MatType secondTerm = (x_ik * trans(x_ik));
+
+          if (labels[i] == labels[k])
+            threadSum += ((p[i] - 1) * p_ik + (p[k] - 1) * p_ki) * secondTerm;
+          else
+            threadSum += (p[i] * p_ik + p[k] * p_ki) * secondTerm;
+        }
+      }
     }
+
+    #pragma omp critical(SoftmaxErrorFunctionGradient)
+    sum += threadSum;
   }
 
   // Assemble the final gradient.
@@ -170,6 +240,44 @@ void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::Gradient(
     GradType& gradient,
     const size_t batchSize)
 {
+  // In the truncated mode, only the neighbors of each point are considered.
+  // The contribution of x_i is -2 A sum_k p_ik (p_i - [k in class of i])
+  // x_ik x_ik^T.
+  if (neighbors > 0)
+  {
+    UpdateNeighbors(coordinates, batchSize, false);
+
+    MatType sum;
+    sum.zeros(dataset.n_rows, dataset.n_rows);
+    for (size_t i = begin; i < begin + batchSize; ++i)
+    {
+      VecType evals;
+      ElemType denominator, numerator;
+      NeighborTerms(coordinates, i, false, evals, denominator, numerator);
+
+      // If the denominator is zero, then all p_ik should be zero and there is
+      // no gradient contribution from this point.
+      if (denominator == 0)
+        continue;
+
+      const ElemType p = numerator / denominator;
+      VecType weights = evals / denominator;
+      for (size_t j = 0; j < weights.n_elem; ++j)
+      {
+        weights[j] *= (labels[i] == labels[neighborLists(j, i)]) ?
+            (p - 1) : p;
+      }
+
+      // For x_ik we are not using stretched points.
+      MatType differences = dataset.cols(neighborLists.col(i));
+      differences.each_col() -= dataset.col(i);
+      sum += (differences.each_row() % weights.t()) * trans(differences);
+    }
+
+    gradient = -2 * coordinates * sum;
+    return;
+  }
+
   // The gradient involves two matrix terms which are eventually combined into
   // one.
   GradType firstTerm, secondTerm;
@@ -274,30 +382,48 @@ void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::Precalculate(
   p.zeros(stretchedDataset.n_cols);
   denominators.zeros(stretchedDataset.n_cols);
 
-  // A collapse(2) would be helpful here, but appears to not be supported fully
-  // until OpenMP 5.0.
-  #pragma omp parallel for
-  for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+  if (neighbors > 0)
   {
-    for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
-    {
-      // Evaluate exp(-d(x_i, x_j)).
-      ElemType eval = std::exp(-distance.Evaluate(
-          stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(j)));
+    // In the truncated mode, the sums only run over the neighbors of each
+    // point, so each point can be handled independently.
+    UpdateNeighbors(coordinates, stretchedDataset.n_cols, true);
+    neighborEvals.set_size(neighborLists.n_rows, neighborLists.n_cols);
 
-      // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
-      #pragma omp atomic
-      denominators[i] += eval;
-      #pragma omp atomic
-      denominators[j] += eval;
-
-      // If i and j are the same class, add to numerator of both.
-      if (labels[i] == labels[j])
+    #pragma omp parallel for
+    for (size_t i = 0; i < (size_t) stretchedDataset.n_cols; ++i)
+    {
+      VecType evals;
+      NeighborTerms(coordinates, i, true, evals, denominators[i], p[i]);
+      neighborEvals.col(i) = evals;
+    }
+  }
+  else
+  {
+    // A collapse(2) would be helpful here, but appears to not be supported
+    // fully until OpenMP 5.0.
+    #pragma omp parallel for
+    for (size_t i = 0; i < stretchedDataset.n_cols; ++i)
+    {
+      for (size_t j = (i + 1); j < stretchedDataset.n_cols; ++j)
       {
+        // Evaluate exp(-d(x_i, x_j)).
+        ElemType eval = std::exp(-distance.Evaluate(
+            stretchedDataset.unsafe_col(i), stretchedDataset.unsafe_col(j)));
+
+        // Add this to the denominators of both p_i and p_j: K(i, j) = K(j, i).
         #pragma omp atomic
-        p[i] += eval;
+        denominators[i] += eval;
         #pragma omp atomic
-        p[j] += eval;
+        denominators[j] += eval;
+
+        // If i and j are the same class, add to numerator of both.
+        if (labels[i] == labels[j])
+        {
+          #pragma omp atomic
+          p[i] += eval;
+          #pragma omp atomic
+          p[j] += eval;
+        }
       }
     }
   }
@@ -323,6 +449,78 @@ void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::Precalculate(
   precalculated = true;
 }
 
+template<typename MatType, typename LabelsType, typename DistanceType>
+void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::UpdateNeighbors(
+    const MatType& coordinates,
+    const size_t points,
+    const bool stretched)
+{
+  if (neighborLists.n_cols != dataset.n_cols ||
+      pointsSinceRefresh >= refreshInterval * dataset.n_cols)
+  {
+    if (dataset.n_cols < 2)
+    {
+      throw std::invalid_argument("SoftmaxErrorFunction: the truncated mode "
+          "needs at least two points!");
+    }
+
+    // The nearest neighbors for the squared Euclidean distance are the same as
+    // for the Euclidean distance.  (The separable functions do not keep the
+    // stretched dataset, so it is only computed here for the search.)
+    const size_t k = std::min(neighbors, (size_t) dataset.n_cols - 1);
+    NeighborSearch<NearestNeighborSort, EuclideanDistance, MatType> knn(
+        stretched ? stretchedDataset : MatType(coordinates * dataset));
+    arma::Mat<ElemType> distances;
+    knn.Search(k, neighborLists, distances);
+
+    pointsSinceRefresh = 0;
+  }
+
+  pointsSinceRefresh += points;
+}
+
+template<typename MatType, typename LabelsType, typename DistanceType>
+void SoftmaxErrorFunction<MatType, LabelsType, DistanceType>::NeighborTerms(
+    const MatType& coordinates,
+    const size_t i,
+    const bool stretched,
+    VecType& evals,
+    ElemType& denominator,
+    ElemType& numerator)
+{
+  evals.set_size(neighborLists.n_rows);
+  denominator = 0;
+  numerator = 0;
+
+  // Only stretch the point and its neighbors, if the stretched dataset is not
+  // available.
+  MatType stretchedNeighbors;
+  VecType stretchedPoint;
+  if (!stretched)
+  {
+    stretchedPoint = coordinates * dataset.col(i);
+    stretchedNeighbors = coordinates * dataset.cols(neighborLists.col(i));
+  }
+
+  for (size_t j = 0; j < neighborLists.n_rows; ++j)
+  {
+    const size_t k = neighborLists(j, i);
+
+    // We want to evaluate exp(-D(A x_i, A x_k)).
+    evals[j] = (stretched) ?
+        std::exp(-distance.Evaluate(stretchedDataset.unsafe_col(i),
+            stretchedDataset.unsafe_col(k))) :
+        std::exp(-distance.Evaluate(stretchedPoint,
+            stretchedNeighbors.unsafe_col(j)));
+
+    // If they are in the same class, update the numerator.
+    if (labels[i] == labels[k])
+      numerator += evals[j];
+
+    denominator += evals[j];
+  }
+}
+
 } // namespace mlpack
 
 #endif
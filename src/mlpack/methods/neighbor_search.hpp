@@ -1,7 +1,10 @@
 /**
  * @file neighbor_search.hpp
  *
- * Convenience include for mlpack/methods/neighbor_search/neighbor_search.hpp.
+ * Convenience include for mlpack/methods/neighbor_search/neighbor_search.hpp,
+ * mlpack/methods/neighbor_search/brute_force_knn.hpp,
+ * mlpack/methods/neighbor_search/sparse_knn.hpp and
+ * mlpack/methods/neighbor_search/distributed_neighbor_search.hpp.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -12,5 +15,8 @@
 #define MLPACK_NEIGHBOR_SEARCH_HPP
 
 #include "neighbor_search/neighbor_search.hpp"
+#include "neighbor_search/brute_force_knn.hpp"
+#include "neighbor_search/sparse_knn.hpp"
+#include "neighbor_search/distributed_neighbor_search.hpp"
 
 #endif
@@ -0,0 +1,148 @@
+/**
+ * @file methods/neighbor_search/brute_force_knn.hpp
+ *
+ * Definition of BruteForceKNN, which finds the exact k nearest neighbors
+ * (with the Euclidean distance) with blocked matrix products, so that it can
+ * run on any dense matrix type, including Bandicoot matrices on a GPU.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_KNN_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_KNN_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * BruteForceKNN performs exact k-nearest-neighbor search with the Euclidean
+ * distance by comparing every query point with every reference point.  The
+ * squared distances are computed one block of queries and references at a
+ * time as
+ *
+ *   ||q - r||^2 = ||q||^2 + ||r||^2 - 2 r^T q,
+ *
+ * so that nearly all of the work is one matrix product per block.  Only these
+ * products and the norms of the points are computed with `MatType`; the
+ * selection of the k smallest distances of each query is done on the CPU (in
+ * parallel over the queries).  So, with a Bandicoot matrix type (like
+ * `coot::fmat`) the distances are computed on the GPU, and only one block of
+ * products at a time is copied back to the host.
+ *
+ * On the CPU with Armadillo matrices, this is often faster than tree-based
+ * search (NeighborSearch or KNN) when the dimensionality is high.  Ties are
+ * broken by the index of the reference point, so the results are the same as
+ * those of KNN in NAIVE_MODE up to rounding.
+ *
+ * @code
+ * BruteForceKNN<arma::mat> knn(referenceSet);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType Type of dense matrix to compute on (e.g. arma::mat,
+ *     arma::fmat or coot::fmat).
+ */
+template<typename MatType = arma::mat>
+class BruteForceKNN
+{
+ public:
+  //! The element type of the data.
+  using ElemType = typename MatType::elem_type;
+
+  /**
+   * Create the object without a reference set; Train() must be called
+   * before searching.
+   *
+   * @param blockSize Number of points of each block of the computation.
+   */
+  BruteForceKNN(const size_t blockSize = 2048);
+
+  /**
+   * Create the object with the given reference set.
+   *
+   * @param referenceSet Set of reference points (one per column).
+   * @param blockSize Number of points of each block of the computation.
+   */
+  BruteForceKNN(MatType referenceSet, const size_t blockSize = 2048);
+
+  /**
+   * Set the reference set.  Use std::move() to avoid a copy.
+   *
+   * @param referenceSet Set of reference points (one per column).
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Find the k nearest neighbors in the reference set of each point of the
+   * query set.  Column i of `neighbors` and `distances` holds the indices of
+   * and distances to the neighbors of query point i, nearest first.
+   *
+   * @param querySet Set of query points (one per column).
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  /**
+   * Find the k nearest neighbors of each point of the reference set, other
+   * than the point itself.
+   *
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  //! Get the reference set.
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the number of points of each block of the computation.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of points of each block of the computation.
+  size_t& BlockSize() { return blockSize; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Compute the squared norms of the points of the given set, on the host.
+  static arma::Mat<ElemType> SquaredNorms(const MatType& data);
+
+  /**
+   * Search for the neighbors of the given query set, with the given squared
+   * norms of the queries.  If `monochromatic` is true, the query set is the
+   * reference set, and each point is not its own neighbor.
+   */
+  void SearchInternal(const MatType& querySet,
+                      const arma::Mat<ElemType>& queryNorms,
+                      const size_t k,
+                      const bool monochromatic,
+                      arma::Mat<size_t>& neighbors,
+                      arma::Mat<ElemType>& distances) const;
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The squared norms of the reference points, on the host.
+  arma::Mat<ElemType> referenceNorms;
+  //! The number of points of each block of the computation.
+  size_t blockSize;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "brute_force_knn_impl.hpp"
+
+#endif
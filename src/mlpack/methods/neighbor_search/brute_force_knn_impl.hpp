@@ -0,0 +1,187 @@
+/**
+ * @file methods/neighbor_search/brute_force_knn_impl.hpp
+ *
+ * Implementation of BruteForceKNN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_KNN_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_BRUTE_FORCE_KNN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "brute_force_knn.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+BruteForceKNN<MatType>::BruteForceKNN(const size_t blockSize) :
+    blockSize(blockSize)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+BruteForceKNN<MatType>::BruteForceKNN(MatType referenceSetIn,
+                                      const size_t blockSize) :
+    blockSize(blockSize)
+{
+  Train(std::move(referenceSetIn));
+}
+
+template<typename MatType>
+void BruteForceKNN<MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  referenceNorms = SquaredNorms(referenceSet);
+}
+
+template<typename MatType>
+void BruteForceKNN<MatType>::Search(const MatType& querySet,
+                                    const size_t k,
+                                    arma::Mat<size_t>& neighbors,
+                                    arma::Mat<ElemType>& distances) const
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("BruteForceKNN::Search(): dimensionality of "
+        "query set (" + std::to_string(querySet.n_rows) + ") is not equal to "
+        "the dimensionality of the reference set (" +
+        std::to_string(referenceSet.n_rows) + ")!");
+  }
+
+  SearchInternal(querySet, SquaredNorms(querySet), k, false, neighbors,
+      distances);
+}
+
+template<typename MatType>
+void BruteForceKNN<MatType>::Search(const size_t k,
+                                    arma::Mat<size_t>& neighbors,
+                                    arma::Mat<ElemType>& distances) const
+{
+  SearchInternal(referenceSet, referenceNorms, k, true, neighbors, distances);
+}
+
+template<typename MatType>
+template<typename Archive>
+void BruteForceKNN<MatType>::serialize(Archive& ar,
+                                       const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(blockSize));
+
+  if (cereal::is_loading<Archive>())
+    referenceNorms = SquaredNorms(referenceSet);
+}
+
+template<typename MatType>
+arma::Mat<typename MatType::elem_type> BruteForceKNN<MatType>::SquaredNorms(
+    const MatType& data)
+{
+  // The norms are computed with MatType (so on the GPU for Bandicoot), and
+  // only the resulting row is copied to the host.
+  const MatType norms = sum(square(data), 0);
+  arma::Mat<ElemType> buffer;
+  return HostMatrix(norms, buffer);
+}
+
+template<typename MatType>
+void BruteForceKNN<MatType>::SearchInternal(
+    const MatType& querySet,
+    const arma::Mat<ElemType>& queryNorms,
+    const size_t k,
+    const bool monochromatic,
+    arma::Mat<size_t>& neighbors,
+    arma::Mat<ElemType>& distances) const
+{
+  const size_t numCandidates = referenceSet.n_cols - (monochromatic ? 1 : 0);
+  if (k > numCandidates || (monochromatic && referenceSet.n_cols == 0))
+  {
+    throw std::invalid_argument("BruteForceKNN::Search(): requested value of "
+        "k (" + std::to_string(k) + ") is greater than the number of "
+        "candidate reference points (" + std::to_string(numCandidates) +
+        ")!");
+  }
+
+  if (blockSize == 0)
+  {
+    throw std::invalid_argument("BruteForceKNN::Search(): the block size "
+        "must be positive!");
+  }
+
+  // The squared distances to the best candidates so far, sorted, with the
+  // indices of the candidates.
+  const size_t numQueries = querySet.n_cols;
+  distances.set_size(k, numQueries);
+  distances.fill(std::numeric_limits<ElemType>::max());
+  neighbors.set_size(k, numQueries);
+  neighbors.fill(SIZE_MAX);
+  if (k == 0)
+    return;
+
+  arma::Mat<ElemType> buffer;
+  for (size_t qBegin = 0; qBegin < numQueries; qBegin += blockSize)
+  {
+    const size_t qEnd = std::min(qBegin + blockSize, numQueries);
+    for (size_t rBegin = 0; rBegin < referenceSet.n_cols; rBegin += blockSize)
+    {
+      const size_t rEnd = std::min(rBegin + blockSize,
+          (size_t) referenceSet.n_cols);
+
+      // This is the only computation with the whole block, so for a GPU
+      // matrix type, only its result has to be copied to the host.
+      const MatType deviceProducts = referenceSet.cols(rBegin, rEnd - 1).t() *
+          querySet.cols(qBegin, qEnd - 1);
+      const arma::Mat<ElemType>& products = HostMatrix(deviceProducts,
+          buffer);
+
+      #pragma omp parallel
+      {
+        std::vector<std::pair<ElemType, size_t>> candidates;
+        candidates.reserve(k + rEnd - rBegin);
+
+        #pragma omp for schedule(static)
+        for (size_t j = 0; j < qEnd - qBegin; ++j)
+        {
+          const size_t q = qBegin + j;
+          candidates.clear();
+          for (size_t i = 0; i < k; ++i)
+            candidates.emplace_back(distances(i, q), neighbors(i, q));
+
+          // The candidates of this block have larger indices than every
+          // earlier one, so they must be strictly closer than the worst.
+          const ElemType worst = distances(k - 1, q);
+          for (size_t i = 0; i < rEnd - rBegin; ++i)
+          {
+            if (monochromatic && rBegin + i == q)
+              continue;
+
+            const ElemType d = std::max(ElemType(0), queryNorms[q] +
+                referenceNorms[rBegin + i] - 2 * products(i, j));
+            if (d < worst)
+              candidates.emplace_back(d, rBegin + i);
+          }
+
+          if (candidates.size() == k)
+            continue;
+
+          std::partial_sort(candidates.begin(), candidates.begin() + k,
+              candidates.end());
+          for (size_t i = 0; i < k; ++i)
+          {
+            distances(i, q) = candidates[i].first;
+            neighbors(i, q) = candidates[i].second;
+          }
+        }
+      }
+    }
+  }
+
+  distances = arma::sqrt(distances);
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,265 @@
+/**
+ * @file methods/neighbor_search/distributed_neighbor_search.hpp
+ *
+ * Definition of DistributedNeighborSearch, which finds the exact k nearest
+ * (or furthest) neighbors of points in a reference set that is partitioned
+ * spatially across the ranks of a communicator (for instance, the processes of
+ * an MPI job).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/communicator.hpp>
+
+#include "neighbor_search.hpp"
+
+namespace mlpack {
+
+/**
+ * DistributedNeighborSearch performs exact k-nearest-neighbor (or
+ * k-furthest-neighbor) search with the Euclidean distance on a reference set
+ * that is too large for one machine.  Each rank of the communicator holds a
+ * part of the reference set; Train() redistributes the points so that each
+ * rank owns one spatial partition:
+ *
+ *  - every rank sends a small random sample of its points to all ranks, and
+ *    all ranks build the same top-level split tree from the sample (each node
+ *    splits its ranks in two, at the quantile of the widest dimension that
+ *    gives each half its share of the points);
+ *  - every point is sent to the rank of the leaf of the split tree that
+ *    contains it, and each rank builds a tree on its partition;
+ *  - the bounding box of each partition is sent to all ranks.
+ *
+ * A search is then done in two rounds.  First, each query is searched for in
+ * the partition that contains it, which gives a good candidate list; then it
+ * is sent only to the partitions whose bounding box could hold a better
+ * neighbor than the current k-th candidate.  The candidate lists of the
+ * partitions are merged with the ordering of SortPolicy, and ties are broken
+ * by the index of the reference point, so the results are the same as those
+ * of NeighborSearch on the whole reference set.
+ *
+ * The points are numbered globally in the order of the ranks: point i of the
+ * reference set given to Train() on rank r has index (the number of points on
+ * the ranks before r) + i.  The neighbors are given by these indices.
+ *
+ * All methods that communicate must be called by every rank, in the same
+ * order and with the same parameters (like k); the query sets may differ.
+ * The queries are processed in batches of BatchSize() points, to bound the
+ * size of the messages.
+ *
+ * @code
+ * // With MPI (include <mpi.h> and define MLPACK_HAS_MPI before mlpack):
+ * MPICommunicator comm;
+ * arma::mat localReferences; // The points of this rank.
+ * DistributedNeighborSearch<MPICommunicator> knn(comm);
+ * knn.Train(localReferences);
+ *
+ * // Find the 5 nearest neighbors of every point of this partition.
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam CommunicatorType Type of communicator (e.g. LocalCommunicator or
+ *     MPICommunicator).
+ * @tparam SortPolicy NearestNeighborSort or FurthestNeighborSort.
+ * @tparam MatType Type of dense matrix of the points.
+ * @tparam TreeType Type of tree built on each partition.
+ */
+template<typename CommunicatorType,
+         typename SortPolicy = NearestNeighborSort,
+         typename MatType = arma::mat,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType = KDTree>
+class DistributedNeighborSearch
+{
+ public:
+  static_assert(std::is_same_v<SortPolicy, NearestNeighborSort> ||
+      std::is_same_v<SortPolicy, FurthestNeighborSort>,
+      "DistributedNeighborSearch only supports NearestNeighborSort and "
+      "FurthestNeighborSort!");
+
+  //! The element type of the points.
+  using ElemType = typename MatType::elem_type;
+  //! The type of the search on the partition of this rank.
+  using LocalSearchType = NeighborSearch<SortPolicy, EuclideanDistance,
+      MatType, TreeType>;
+  //! The type of tree built on the partition of this rank.
+  using Tree = typename LocalSearchType::Tree;
+  //! The type of the bounding box of each partition.
+  using BoundType = HRectBound<EuclideanDistance, ElemType>;
+
+  /**
+   * Create the object; Train() must be called before searching.
+   *
+   * @param comm Communicator of the ranks.
+   * @param sampleSize Total number of points sampled to build the split tree.
+   * @param batchSize Number of queries of each rank processed at once.
+   */
+  DistributedNeighborSearch(CommunicatorType& comm,
+                            const size_t sampleSize = 10000,
+                            const size_t batchSize = 100000);
+
+  /**
+   * Partition the reference points of all ranks spatially, and build the tree
+   * of the partition of this rank.  This is a collective operation.  A rank
+   * may have no points, but all points must have the same dimensionality.
+   *
+   * @param referenceSet Reference points of this rank.
+   */
+  void Train(const MatType& referenceSet);
+
+  /**
+   * Find the k neighbors of each of the given query points in the reference
+   * points of all ranks.  This is a collective operation; each rank may
+   * search for a different query set.  Column i of `neighbors` and
+   * `distances` holds the (global) indices of and distances to the neighbors
+   * of query point i, best first.
+   *
+   * @param querySet Query points of this rank.
+   * @param k Number of neighbors to find; must be the same on all ranks.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              MatType& distances);
+
+  /**
+   * Find the k neighbors of each point of the partition of this rank (that
+   * is, of each column of LocalReferenceSet()) among the reference points of
+   * all ranks, other than the point itself.  This is a collective operation.
+   * The global index of the point of column i is LocalIndices()[i].
+   *
+   * @param k Number of neighbors to find; must be the same on all ranks.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              MatType& distances);
+
+  //! Get the points of the partition of this rank.
+  const MatType& LocalReferenceSet() const
+  { return localSearch.ReferenceSet(); }
+  //! Get the global indices of the points of the partition of this rank.
+  const std::vector<size_t>& LocalIndices() const { return localIndices; }
+  //! Get the total number of reference points of all ranks.
+  size_t GlobalSize() const { return globalSize; }
+  //! Get the bounding box of the partition of each rank.
+  const std::vector<BoundType>& Bounds() const { return bounds; }
+  //! Get the number of points of the partition of each rank.
+  const std::vector<size_t>& PartitionSizes() const { return partitionSizes; }
+
+  //! Get the number of (query, partition) searches done by this rank in the
+  //! last call to Search().
+  size_t PartitionSearches() const { return partitionSearches; }
+  //! Get the number of (query, partition) searches that this rank skipped in
+  //! the last call to Search(), because of the bounds of the partitions.
+  size_t PrunedPartitions() const { return prunedPartitions; }
+
+  //! Get the number of queries of each rank processed at once.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of queries of each rank processed at once.
+  size_t& BatchSize() { return batchSize; }
+
+ private:
+  //! A node of the split tree.  Leaves have a valid rank.
+  struct SplitNode
+  {
+    size_t dimension;
+    ElemType value;
+    size_t left;
+    size_t right;
+    size_t rank;
+  };
+
+  //! Build the subtree of the split tree for the given ranks, from the given
+  //! sample points; return the index of its root.
+  size_t BuildSplitTree(const arma::Mat<ElemType>& sample,
+                        const std::vector<size_t>& points,
+                        const size_t rankBegin,
+                        const size_t rankEnd);
+
+  //! Get the rank of the partition that contains the given point.
+  template<typename VecType>
+  size_t Route(const VecType& point) const;
+
+  //! Return whether the partition of the given rank might hold a neighbor at
+  //! least as good as the given k-th distance.
+  template<typename VecType>
+  bool CanImprove(const size_t rank,
+                  const VecType& point,
+                  const ElemType kthDistance) const;
+
+  //! Get the number of batches of queries; this is collective.
+  size_t NumBatches(const size_t numQueries);
+
+  /**
+   * Send the given queries to the given ranks (`requests[r]` are the indices
+   * of the columns of `querySet` to send to rank r), search for them there,
+   * and merge the results into the candidates of each query.  This is
+   * collective.
+   */
+  void SearchPartitions(const MatType& querySet,
+                        const std::vector<std::vector<size_t>>& requests,
+                        const size_t k,
+                        arma::Mat<size_t>& neighbors,
+                        MatType& distances);
+
+  //! Search the partition of this rank for the given queries, giving global
+  //! indices; the lists are padded to k with the worst distance.
+  void SearchLocal(const MatType& queries,
+                   const size_t k,
+                   arma::Mat<size_t>& neighbors,
+                   MatType& distances);
+
+  //! Merge the given candidate list into the candidates of query column q.
+  void Merge(const size_t q,
+             const size_t* candidateIndices,
+             const ElemType* candidateDistances,
+             arma::Mat<size_t>& neighbors,
+             MatType& distances) const;
+
+  //! Communicator of the ranks.
+  CommunicatorType& comm;
+  //! Total number of points sampled to build the split tree.
+  size_t sampleSize;
+  //! Number of queries of each rank processed at once.
+  size_t batchSize;
+
+  //! The dimensionality of the points.
+  size_t dimensionality;
+  //! The total number of reference points.
+  size_t globalSize;
+  //! The split tree (the same on all ranks); node 0 is the root.
+  std::vector<SplitNode> splitTree;
+  //! The search on the partition of this rank.
+  LocalSearchType localSearch;
+  //! The global indices of the points of the partition of this rank.
+  std::vector<size_t> localIndices;
+  //! The bounding box of the partition of each rank.
+  std::vector<BoundType> bounds;
+  //! The number of points of the partition of each rank.
+  std::vector<size_t> partitionSizes;
+
+  //! The number of (query, partition) searches of the last Search().
+  size_t partitionSearches;
+  //! The number of pruned (query, partition) pairs of the last Search().
+  size_t prunedPartitions;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "distributed_neighbor_search_impl.hpp"
+
+#endif
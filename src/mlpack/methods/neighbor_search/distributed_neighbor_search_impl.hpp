@@ -0,0 +1,612 @@
+/**
+ * @file methods/neighbor_search/distributed_neighbor_search_impl.hpp
+ *
+ * Implementation of DistributedNeighborSearch.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_DISTRIBUTED_NEIGHBOR_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "distributed_neighbor_search.hpp"
+
+namespace mlpack {
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType, TreeType>::
+DistributedNeighborSearch(CommunicatorType& comm,
+                          const size_t sampleSize,
+                          const size_t batchSize) :
+    comm(comm),
+    sampleSize(sampleSize),
+    batchSize(batchSize),
+    dimensionality(0),
+    globalSize(0),
+    partitionSearches(0),
+    prunedPartitions(0)
+{
+  // Nothing to do.
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::Train(const MatType& referenceSet)
+{
+  const size_t numRanks = comm.Size();
+
+  // Find the number of points and the dimensionality of each rank.
+  std::vector<std::vector<size_t>> shapes;
+  comm.AllGather(std::vector<size_t>({ (size_t) referenceSet.n_cols,
+      (size_t) referenceSet.n_rows }), shapes);
+
+  globalSize = 0;
+  size_t globalOffset = 0;
+  dimensionality = 0;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    if (r < comm.Rank())
+      globalOffset += shapes[r][0];
+    globalSize += shapes[r][0];
+
+    if (shapes[r][0] == 0)
+      continue;
+    if (dimensionality != 0 && shapes[r][1] != dimensionality)
+    {
+      throw std::invalid_argument("DistributedNeighborSearch::Train(): the "
+          "reference sets of the ranks have different dimensionalities (" +
+          std::to_string(dimensionality) + " and " +
+          std::to_string(shapes[r][1]) + ")!");
+    }
+    dimensionality = shapes[r][1];
+  }
+
+  if (globalSize == 0)
+  {
+    throw std::invalid_argument("DistributedNeighborSearch::Train(): the "
+        "reference set is empty!");
+  }
+
+  // Each rank samples its share of the points, and every rank builds the same
+  // split tree from the whole sample.
+  const size_t localSamples = (referenceSet.n_cols == 0) ? 0 :
+      std::min((size_t) referenceSet.n_cols, std::max((size_t) 1,
+      (size_t) std::ceil(double(sampleSize) * referenceSet.n_cols /
+      globalSize)));
+  const arma::uvec sampleIndices = arma::randperm(referenceSet.n_cols,
+      localSamples);
+  std::vector<ElemType> localSample;
+  localSample.reserve(localSamples * dimensionality);
+  for (size_t i = 0; i < localSamples; ++i)
+  {
+    const ElemType* point = referenceSet.colptr(sampleIndices[i]);
+    localSample.insert(localSample.end(), point, point + dimensionality);
+  }
+
+  std::vector<std::vector<ElemType>> samples;
+  comm.AllGather(localSample, samples);
+  std::vector<ElemType> allSamples;
+  for (size_t r = 0; r < numRanks; ++r)
+    allSamples.insert(allSamples.end(), samples[r].begin(), samples[r].end());
+  const arma::Mat<ElemType> sample(allSamples.data(), dimensionality,
+      allSamples.size() / dimensionality, false, true);
+
+  std::vector<size_t> samplePoints(sample.n_cols);
+  std::iota(samplePoints.begin(), samplePoints.end(), 0);
+  splitTree.clear();
+  BuildSplitTree(sample, samplePoints, 0, numRanks);
+
+  // Send every point (and its global index) to the rank of its partition.
+  std::vector<std::vector<ElemType>> sendPoints(numRanks), receivedPoints;
+  std::vector<std::vector<size_t>> sendIndices(numRanks), receivedIndices;
+  for (size_t i = 0; i < referenceSet.n_cols; ++i)
+  {
+    const size_t r = Route(referenceSet.col(i));
+    const ElemType* point = referenceSet.colptr(i);
+    sendPoints[r].insert(sendPoints[r].end(), point, point + dimensionality);
+    sendIndices[r].push_back(globalOffset + i);
+  }
+  comm.AllToAll(sendPoints, receivedPoints);
+  comm.AllToAll(sendIndices, receivedIndices);
+  // Free the memory of the sent points.
+  sendPoints = std::vector<std::vector<ElemType>>();
+
+  localIndices.clear();
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    localIndices.insert(localIndices.end(), receivedIndices[r].begin(),
+        receivedIndices[r].end());
+  }
+
+  MatType partition(dimensionality, localIndices.size());
+  size_t column = 0;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    if (receivedPoints[r].empty())
+      continue;
+    const size_t numPoints = receivedPoints[r].size() / dimensionality;
+    std::copy(receivedPoints[r].begin(), receivedPoints[r].end(),
+        partition.colptr(column));
+    column += numPoints;
+    receivedPoints[r] = std::vector<ElemType>();
+  }
+
+  // Build the tree of the partition; if it rearranges the points, the global
+  // indices are rearranged too.
+  std::vector<size_t> oldFromNew;
+  Tree* tree = BuildTree<Tree>(std::move(partition), oldFromNew);
+  if (!oldFromNew.empty())
+  {
+    std::vector<size_t> newIndices(localIndices.size());
+    for (size_t i = 0; i < newIndices.size(); ++i)
+      newIndices[i] = localIndices[oldFromNew[i]];
+    localIndices.swap(newIndices);
+  }
+  localSearch.Train(std::move(*tree));
+  delete tree;
+
+  // Send the bounding box of the partition to all ranks.
+  std::vector<ElemType> localBound;
+  if (!localIndices.empty())
+  {
+    BoundType bound(dimensionality);
+    bound |= localSearch.ReferenceSet();
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      localBound.push_back(bound[d].Lo());
+      localBound.push_back(bound[d].Hi());
+    }
+  }
+
+  std::vector<std::vector<ElemType>> allBounds;
+  comm.AllGather(localBound, allBounds);
+  std::vector<std::vector<size_t>> allSizes;
+  comm.AllGather(std::vector<size_t>({ localIndices.size() }), allSizes);
+
+  bounds.assign(numRanks, BoundType(dimensionality));
+  partitionSizes.resize(numRanks);
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    partitionSizes[r] = allSizes[r][0];
+    if (allBounds[r].empty())
+      continue;
+    for (size_t d = 0; d < dimensionality; ++d)
+    {
+      bounds[r][d] = RangeType<ElemType>(allBounds[r][2 * d],
+          allBounds[r][2 * d + 1]);
+    }
+  }
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::Search(const MatType& querySet,
+                      const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      MatType& distances)
+{
+  if (k > globalSize)
+  {
+    throw std::invalid_argument("DistributedNeighborSearch::Search(): "
+        "requested value of k (" + std::to_string(k) + ") is greater than "
+        "the number of reference points (" + std::to_string(globalSize) +
+        ")!");
+  }
+
+  // Every rank must know if any query set is invalid, so that they all throw
+  // instead of waiting for each other.
+  const bool valid = (querySet.n_cols == 0 ||
+      querySet.n_rows == dimensionality);
+  std::vector<size_t> invalid = { valid ? (size_t) 0 : (size_t) 1 };
+  comm.AllReduceSum(invalid.data(), 1);
+  if (invalid[0] > 0)
+  {
+    throw std::invalid_argument("DistributedNeighborSearch::Search(): the "
+        "query set of " + std::to_string(invalid[0]) + " rank(s) does not "
+        "have the dimensionality of the reference set (" +
+        std::to_string(dimensionality) + ")!");
+  }
+
+  const size_t numRanks = comm.Size();
+  const size_t numQueries = querySet.n_cols;
+  neighbors.set_size(k, numQueries);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, numQueries);
+  distances.fill(SortPolicy::WorstDistance());
+  partitionSearches = 0;
+  prunedPartitions = 0;
+
+  std::vector<size_t> home(numQueries);
+  std::vector<std::vector<size_t>> requests(numRanks);
+  const size_t numBatches = NumBatches(numQueries);
+  for (size_t b = 0; b < numBatches; ++b)
+  {
+    const size_t begin = std::min(b * batchSize, numQueries);
+    const size_t end = std::min(begin + batchSize, numQueries);
+
+    // First, search the partition that contains each query, to find good
+    // candidates.
+    for (size_t r = 0; r < numRanks; ++r)
+      requests[r].clear();
+    for (size_t q = begin; q < end; ++q)
+    {
+      home[q] = Route(querySet.col(q));
+      requests[home[q]].push_back(q);
+    }
+    SearchPartitions(querySet, requests, k, neighbors, distances);
+
+    // Then, search the other partitions that may hold better neighbors.
+    for (size_t r = 0; r < numRanks; ++r)
+      requests[r].clear();
+    for (size_t q = begin; q < end; ++q)
+    {
+      for (size_t r = 0; r < numRanks; ++r)
+      {
+        if (r == home[q] || partitionSizes[r] == 0)
+          continue;
+        if (k > 0 && CanImprove(r, querySet.col(q), distances(k - 1, q)))
+          requests[r].push_back(q);
+        else
+          ++prunedPartitions;
+      }
+    }
+    SearchPartitions(querySet, requests, k, neighbors, distances);
+  }
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::Search(const size_t k,
+                      arma::Mat<size_t>& neighbors,
+                      MatType& distances)
+{
+  if (k >= globalSize)
+  {
+    throw std::invalid_argument("DistributedNeighborSearch::Search(): "
+        "requested value of k (" + std::to_string(k) + ") is greater than or "
+        "equal to the number of reference points (" +
+        std::to_string(globalSize) + ")!");
+  }
+
+  const size_t numRanks = comm.Size();
+  const MatType& querySet = localSearch.ReferenceSet();
+  const size_t numQueries = localIndices.size();
+  neighbors.set_size(k, numQueries);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, numQueries);
+  distances.fill(SortPolicy::WorstDistance());
+  partitionSearches = 0;
+  prunedPartitions = 0;
+
+  // The points of this partition are searched for here first, without
+  // themselves.
+  const size_t localK = (numQueries == 0) ? 0 : std::min(k, numQueries - 1);
+  if (localK > 0)
+  {
+    arma::Mat<size_t> localNeighbors;
+    MatType localDistances;
+    localSearch.Search(localK, localNeighbors, localDistances);
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+      for (size_t i = 0; i < localK; ++i)
+      {
+        neighbors(i, q) = localIndices[localNeighbors(i, q)];
+        distances(i, q) = localDistances(i, q);
+      }
+    }
+  }
+  partitionSearches += numQueries;
+
+  // Then, search the other partitions that may hold better neighbors.
+  std::vector<std::vector<size_t>> requests(numRanks);
+  const size_t numBatches = NumBatches(numQueries);
+  for (size_t b = 0; b < numBatches; ++b)
+  {
+    const size_t begin = std::min(b * batchSize, numQueries);
+    const size_t end = std::min(begin + batchSize, numQueries);
+
+    for (size_t r = 0; r < numRanks; ++r)
+      requests[r].clear();
+    for (size_t q = begin; q < end; ++q)
+    {
+      for (size_t r = 0; r < numRanks; ++r)
+      {
+        if (r == comm.Rank() || partitionSizes[r] == 0)
+          continue;
+        if (k > 0 && CanImprove(r, querySet.col(q), distances(k - 1, q)))
+          requests[r].push_back(q);
+        else
+          ++prunedPartitions;
+      }
+    }
+    SearchPartitions(querySet, requests, k, neighbors, distances);
+  }
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+size_t DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::BuildSplitTree(const arma::Mat<ElemType>& sample,
+                              const std::vector<size_t>& points,
+                              const size_t rankBegin,
+                              const size_t rankEnd)
+{
+  const size_t node = splitTree.size();
+  splitTree.push_back({ 0, ElemType(0), 0, 0, SIZE_MAX });
+  if (rankEnd - rankBegin == 1)
+  {
+    splitTree[node].rank = rankBegin;
+    return node;
+  }
+
+  // Split along the widest dimension of the sample points of this node.
+  size_t dimension = 0;
+  ElemType widest = -1;
+  for (size_t d = 0; d < sample.n_rows && !points.empty(); ++d)
+  {
+    ElemType lo = std::numeric_limits<ElemType>::max();
+    ElemType hi = std::numeric_limits<ElemType>::lowest();
+    for (const size_t p : points)
+    {
+      lo = std::min(lo, sample(d, p));
+      hi = std::max(hi, sample(d, p));
+    }
+
+    if (hi - lo > widest)
+    {
+      widest = hi - lo;
+      dimension = d;
+    }
+  }
+
+  // The left half of the ranks gets its share of the sample points.
+  const size_t rankMid = (rankBegin + rankEnd) / 2;
+  ElemType value = 0;
+  if (!points.empty())
+  {
+    std::vector<ElemType> values(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+      values[i] = sample(dimension, points[i]);
+
+    const size_t position = std::min(points.size() - 1, points.size() *
+        (rankMid - rankBegin) / (rankEnd - rankBegin));
+    std::nth_element(values.begin(), values.begin() + position, values.end());
+    value = values[position];
+  }
+
+  std::vector<size_t> leftPoints, rightPoints;
+  for (const size_t p : points)
+  {
+    if (sample(dimension, p) < value)
+      leftPoints.push_back(p);
+    else
+      rightPoints.push_back(p);
+  }
+
+  splitTree[node].dimension = dimension;
+  splitTree[node].value = value;
+  const size_t left = BuildSplitTree(sample, leftPoints, rankBegin, rankMid);
+  const size_t right = BuildSplitTree(sample, rightPoints, rankMid, rankEnd);
+  splitTree[node].left = left;
+  splitTree[node].right = right;
+  return node;
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+template<typename VecType>
+size_t DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::Route(const VecType& point) const
+{
+  size_t node = 0;
+  while (splitTree[node].rank == SIZE_MAX)
+  {
+    node = (point[splitTree[node].dimension] < splitTree[node].value) ?
+        splitTree[node].left : splitTree[node].right;
+  }
+
+  return splitTree[node].rank;
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+template<typename VecType>
+bool DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::CanImprove(const size_t rank,
+                          const VecType& point,
+                          const ElemType kthDistance) const
+{
+  // The best distance from the point to any point of the partition.
+  const ElemType bestDistance =
+      std::is_same_v<SortPolicy, FurthestNeighborSort> ?
+      bounds[rank].MaxDistance(point) : bounds[rank].MinDistance(point);
+
+  // IsBetter() is true for equal distances, which may still give a better
+  // candidate by index.
+  return SortPolicy::IsBetter(bestDistance, kthDistance);
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+size_t DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::NumBatches(const size_t numQueries)
+{
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("DistributedNeighborSearch::Search(): the "
+        "batch size must be positive!");
+  }
+
+  std::vector<std::vector<size_t>> allQueries;
+  comm.AllGather(std::vector<size_t>({ numQueries }), allQueries);
+
+  size_t numBatches = 0;
+  for (size_t r = 0; r < comm.Size(); ++r)
+  {
+    numBatches = std::max(numBatches,
+        (allQueries[r][0] + batchSize - 1) / batchSize);
+  }
+
+  return numBatches;
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::SearchPartitions(
+    const MatType& querySet,
+    const std::vector<std::vector<size_t>>& requests,
+    const size_t k,
+    arma::Mat<size_t>& neighbors,
+    MatType& distances)
+{
+  const size_t numRanks = comm.Size();
+
+  // Send the queries.
+  std::vector<std::vector<ElemType>> sendPoints(numRanks), receivedPoints;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    sendPoints[r].reserve(requests[r].size() * dimensionality);
+    for (const size_t q : requests[r])
+    {
+      const ElemType* point = querySet.colptr(q);
+      sendPoints[r].insert(sendPoints[r].end(), point,
+          point + dimensionality);
+    }
+    partitionSearches += requests[r].size();
+  }
+  comm.AllToAll(sendPoints, receivedPoints);
+
+  // Search for the queries of each rank in this partition, and send the
+  // candidate lists back (in the order of the queries).
+  std::vector<std::vector<size_t>> sendIndices(numRanks), receivedIndices;
+  std::vector<std::vector<ElemType>> sendDistances(numRanks),
+      receivedDistances;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    if (receivedPoints[r].empty())
+      continue;
+
+    const MatType queries(receivedPoints[r].data(), dimensionality,
+        receivedPoints[r].size() / dimensionality, false, true);
+    arma::Mat<size_t> candidateIndices;
+    MatType candidateDistances;
+    SearchLocal(queries, k, candidateIndices, candidateDistances);
+
+    sendIndices[r].assign(candidateIndices.begin(), candidateIndices.end());
+    sendDistances[r].assign(candidateDistances.begin(),
+        candidateDistances.end());
+  }
+  comm.AllToAll(sendIndices, receivedIndices);
+  comm.AllToAll(sendDistances, receivedDistances);
+
+  // Merge the candidates.  Each query is sent at most once to each rank, so
+  // the queries of one rank can be merged in parallel.
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    #pragma omp parallel for schedule(static)
+    for (size_t j = 0; j < requests[r].size(); ++j)
+    {
+      Merge(requests[r][j], receivedIndices[r].data() + j * k,
+          receivedDistances[r].data() + j * k, neighbors, distances);
+    }
+  }
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::SearchLocal(const MatType& queries,
+                           const size_t k,
+                           arma::Mat<size_t>& neighbors,
+                           MatType& distances)
+{
+  neighbors.set_size(k, queries.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.set_size(k, queries.n_cols);
+  distances.fill(SortPolicy::WorstDistance());
+
+  const size_t localK = std::min(k, localIndices.size());
+  if (localK == 0)
+    return;
+
+  arma::Mat<size_t> localNeighbors;
+  MatType localDistances;
+  localSearch.Search(queries, localK, localNeighbors, localDistances);
+  for (size_t q = 0; q < queries.n_cols; ++q)
+  {
+    for (size_t i = 0; i < localK; ++i)
+    {
+      neighbors(i, q) = localIndices[localNeighbors(i, q)];
+      distances(i, q) = localDistances(i, q);
+    }
+  }
+}
+
+template<typename CommunicatorType,
+         typename SortPolicy,
+         typename MatType,
+         template<typename, typename, typename> class TreeType>
+void DistributedNeighborSearch<CommunicatorType, SortPolicy, MatType,
+    TreeType>::Merge(const size_t q,
+                     const size_t* candidateIndices,
+                     const ElemType* candidateDistances,
+                     arma::Mat<size_t>& neighbors,
+                     MatType& distances) const
+{
+  const size_t k = neighbors.n_rows;
+  std::vector<std::pair<ElemType, size_t>> candidates;
+  candidates.reserve(2 * k);
+  for (size_t i = 0; i < k; ++i)
+  {
+    candidates.emplace_back(distances(i, q), neighbors(i, q));
+    candidates.emplace_back(candidateDistances[i], candidateIndices[i]);
+  }
+
+  // Ties are broken by index; padding entries have the largest index.
+  std::partial_sort(candidates.begin(), candidates.begin() + k,
+      candidates.end(), [](const std::pair<ElemType, size_t>& a,
+                           const std::pair<ElemType, size_t>& b)
+      {
+        if (a.first != b.first)
+          return SortPolicy::IsBetter(a.first, b.first);
+        return a.second < b.second;
+      });
+
+  for (size_t i = 0; i < k; ++i)
+  {
+    distances(i, q) = candidates[i].first;
+    neighbors(i, q) = candidates[i].second;
+  }
+}
+
+} // namespace mlpack
+
+#endif
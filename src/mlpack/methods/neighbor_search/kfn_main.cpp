@@ -93,17 +93,25 @@ PARAM_INT_IN("k", "Number of furthest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'oct', 'auto'.  With 'auto', the tree type, the leaf size "
+    "and (unless 'algorithm' is given) the single-tree or dual-tree algorithm "
+    "are chosen with short trial searches on samples of the data.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "vp trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference set and trees in single "
+    "precision (32-bit floating point), which halves their memory use.", "f");
+PARAM_FLAG("traversal_statistics", "If set, collect detailed statistics "
+    "about the tree traversal (prunes per tree level, base cases per leaf, "
+    "traversal depth and revisited nodes) and print them, along with the split "
+    "of time between tree building and search as verbose output.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'parallel_single_tree'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate furthest neighbor"
     " search with given relative error. Must be in the range [0,1).", "e", 0);
 PARAM_DOUBLE_IN("percentage", "If specified, will do approximate furthest "
@@ -123,6 +131,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree_type");
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
 
   // Notify the user of parameters that will be only be considered for query
   // tree.
@@ -178,7 +187,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   const string algorithm = params.Get<string>("algorithm");
   RequireParamInSet<string>(params, "algorithm", { "naive", "single_tree",
-      "dual_tree", "greedy" }, true, "unknown neighbor search algorithm");
+      "dual_tree", "greedy", "parallel_single_tree" }, true,
+      "unknown neighbor search algorithm");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -189,13 +199,15 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "parallel_single_tree")
+    searchMode = PARALLEL_SINGLE_TREE_MODE;
 
   if (params.Has("reference"))
   {
     // Get all the parameters.
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "auto" }, true, "unknown tree type");
     const string treeType = params.Get<string>("tree_type");
     const bool randomBasis = params.Has("random_basis");
 
@@ -230,9 +242,12 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       tree = KFNModel::UB_TREE;
     else if (treeType == "oct")
       tree = KFNModel::OCTREE;
+    else if (treeType == "auto")
+      tree = KFNModel::AUTO_TREE;
 
     kfn->TreeType() = tree;
     kfn->RandomBasis() = randomBasis;
+    kfn->SinglePrecision() = params.Has("single_precision");
     kfn->LeafSize() = size_t(lsInt);
 
     arma::mat& referenceSet = params.Get<arma::mat>("reference");
@@ -240,6 +255,24 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     Log::Info << "Using reference data from "
         << params.GetPrintable<arma::mat>("reference") << "." << endl;
 
+    // Choose the tree type and leaf size (and the algorithm, if it was not
+    // given) for the search that will be done.
+    if (tree == KFNModel::AUTO_TREE && searchMode != NAIVE_MODE)
+    {
+      const arma::mat emptyQuery;
+      const size_t k = params.Has("k") ? (size_t) params.Get<int>("k") : 1;
+      const NeighborSearchMode selectedMode = kfn->SelectTree(timers,
+          referenceSet, params.Has("query") ? params.Get<arma::mat>("query") :
+          emptyQuery, k, epsilon);
+      if (!params.Has("algorithm"))
+        searchMode = selectedMode;
+    }
+    else if (tree == KFNModel::AUTO_TREE)
+    {
+      // The tree type does not matter for naive search.
+      kfn->TreeType() = KFNModel::KD_TREE;
+    }
+
     kfn->BuildModel(timers, std::move(referenceSet), searchMode, epsilon);
   }
   else
@@ -259,7 +292,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Using kFN model from '"
         << params.GetPrintable<KFNModel*>("input_model") << "' (trained on "
-        << kfn->Dataset().n_rows << "x" << kfn->Dataset().n_cols
+        << kfn->Dimensionality() << "x" << kfn->NumReferencePoints()
         << " dataset)." << endl;
   }
 
@@ -280,10 +313,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       Log::Info << "Using query data from "
           << params.GetPrintable<arma::mat>("query") << "." << endl;
       queryData = std::move(params.Get<arma::mat>("query"));
-      if (queryData.n_rows != kfn->Dataset().n_rows)
+      if (queryData.n_rows != kfn->Dimensionality())
       {
         // Clean memory if needed.
-        const size_t dimensions = kfn->Dataset().n_rows;
+        const size_t dimensions = kfn->Dimensionality();
         if (params.Has("reference"))
           delete kfn;
         Log::Fatal << "Query has invalid dimensions (" << queryData.n_rows <<
@@ -294,10 +327,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > kfn->Dataset().n_cols)
+    if (k > kfn->NumReferencePoints())
     {
       // Clean memory if needed.
-      const size_t referencePoints = kfn->Dataset().n_cols;
+      const size_t referencePoints = kfn->NumReferencePoints();
       if (params.Has("reference"))
         delete kfn;
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
@@ -307,10 +340,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!params.Has("query") && k == kfn->Dataset().n_cols)
+    if (!params.Has("query") && k == kfn->NumReferencePoints())
     {
       // Clean memory if needed.
-      const size_t referencePoints = kfn->Dataset().n_cols;
+      const size_t referencePoints = kfn->NumReferencePoints();
       if (params.Has("reference"))
         delete kfn;
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
@@ -322,12 +355,28 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
+    // Collect traversal statistics, if requested.
+    TraversalStatistics statistics;
+    if (params.Has("traversal_statistics"))
+      kfn->Statistics() = &statistics;
+
     if (params.Has("query"))
       kfn->Search(timers, std::move(queryData), k, neighbors, distances);
     else
       kfn->Search(timers, k, neighbors, distances);
     Log::Info << "Search complete." << endl;
 
+    if (params.Has("traversal_statistics"))
+    {
+      kfn->Statistics() = NULL;
+      statistics.Print(Log::Info);
+
+      const double buildTime = timers.Get("tree_building").count() / 1e6;
+      const double searchTime = timers.Get("computing_neighbors").count() / 1e6;
+      Log::Info << "Time spent building trees: " << buildTime << "s; time "
+          << "spent searching: " << searchTime << "s." << endl;
+    }
+
     // Calculate the effective error, if desired.
     if (params.Has("true_distances"))
     {
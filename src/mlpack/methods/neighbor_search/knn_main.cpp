@@ -20,6 +20,7 @@
 #include "neighbor_search.hpp"
 #include "unmap.hpp"
 #include "ns_model.hpp"
+#include "sparse_knn.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -44,7 +45,16 @@ BINDING_LONG_DESC(
     "points using kd-trees or cover trees (cover tree support is experimental "
     "and may be slow). You may specify a separate set of "
     "reference points and query points, or just a reference set which will be "
-    "used as both the reference and query set.");
+    "used as both the reference and query set."
+    "\n\n"
+    "For high-dimensional sparse data, the " + PRINT_PARAM_STRING("sparse") +
+    " option holds the reference and query sets as sparse matrices and "
+    "searches them with an inverted index instead of a tree.  With this "
+    "option the " + PRINT_PARAM_STRING("metric") + " parameter can be 'cosine'"
+    " (the distances are then 1 minus the cosine similarity) or "
+    "'inner_product' (the distances are then the inner products, largest "
+    "first) instead of 'euclidean'.  Models can't be saved or loaded for "
+    "sparse search.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -95,7 +105,10 @@ PARAM_INT_IN("k", "Number of nearest neighbors to find.", "k", 0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'spill', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'spill', 'oct', 'auto'.  With 'auto', the tree type, the "
+    "leaf size and (unless 'algorithm' is given) the single-tree or dual-tree "
+    "algorithm are chosen with short trial searches on samples of the data.",
+    "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, vp "
     "trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, spill trees, and octrees).", "l",
@@ -107,14 +120,99 @@ PARAM_DOUBLE_IN("rho", "Balance threshold (only valid for spill trees).", "b",
 
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference set and trees in single "
+    "precision (32-bit floating point), which halves their memory use.", "f");
+PARAM_FLAG("traversal_statistics", "If set, collect detailed statistics "
+    "about the tree traversal (prunes per tree level, base cases per leaf, "
+    "traversal depth and revisited nodes) and print them, along with the split "
+    "of time between tree building and search as verbose output.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
 PARAM_STRING_IN("algorithm", "Type of neighbor search: 'naive', 'single_tree', "
-    "'dual_tree', 'greedy'.", "a", "dual_tree");
+    "'dual_tree', 'greedy', 'parallel_single_tree'.", "a", "dual_tree");
 PARAM_DOUBLE_IN("epsilon", "If specified, will do approximate nearest neighbor "
     "search with given relative error.", "e", 0);
 
+// Sparse search settings.
+PARAM_FLAG("sparse", "Hold the reference and query sets as sparse matrices, "
+    "and search them with an inverted index instead of a tree.", "");
+PARAM_STRING_IN("metric", "Measure of closeness for sparse search: "
+    "'euclidean', 'cosine', or 'inner_product'.", "", "euclidean");
+
+// Run the search with SparseKNN.
+void SparseSearch(util::Params& params, util::Timers& timers)
+{
+  RequireParamInSet<string>(params, "metric", { "euclidean", "cosine",
+      "inner_product" }, true, "unknown metric");
+  if (params.Has("input_model") || params.Has("output_model"))
+  {
+    Log::Fatal << "Models can't be loaded or saved with "
+        << PRINT_PARAM_STRING("sparse") << "!" << endl;
+  }
+
+  for (const char* name : { "tree_type", "leaf_size", "algorithm", "epsilon",
+      "random_basis", "single_precision", "traversal_statistics",
+      "true_distances", "true_neighbors" })
+  {
+    ReportIgnoredParam(params, name, "the sparse search is exact and does not "
+        "use trees");
+  }
+
+  const string metricName = params.Get<string>("metric");
+  SparseSearchMetric metric = EUCLIDEAN_SEARCH;
+  if (metricName == "cosine")
+    metric = COSINE_SEARCH;
+  else if (metricName == "inner_product")
+    metric = INNER_PRODUCT_SEARCH;
+
+  Log::Info << "Using reference data from "
+      << params.GetPrintable<arma::mat>("reference") << "." << endl;
+
+  timers.Start("tree_building");
+  SparseKNN<> knn(arma::sp_mat(params.Get<arma::mat>("reference")), metric);
+  timers.Stop("tree_building");
+
+  if (!params.Has("k"))
+    return;
+
+  const size_t k = (size_t) params.Get<int>("k");
+  const size_t referencePoints = knn.ReferenceSet().n_cols;
+  if (k > referencePoints || (!params.Has("query") && k == referencePoints))
+  {
+    Log::Fatal << "Invalid k: " << k << "; must be less than or equal to the "
+        << "number of reference points (" << referencePoints << "), and less "
+        << "than it if query data has not been provided." << endl;
+  }
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  if (params.Has("query"))
+  {
+    const arma::sp_mat querySet(params.Get<arma::mat>("query"));
+    if (querySet.n_rows != knn.ReferenceSet().n_rows)
+    {
+      Log::Fatal << "Query has invalid dimensions(" << querySet.n_rows <<
+          "); should be " << knn.ReferenceSet().n_rows << "!" << endl;
+    }
+
+    timers.Start("computing_neighbors");
+    knn.Search(querySet, k, neighbors, distances);
+    timers.Stop("computing_neighbors");
+  }
+  else
+  {
+    timers.Start("computing_neighbors");
+    knn.Search(k, neighbors, distances);
+    timers.Stop("computing_neighbors");
+  }
+
+  Log::Info << "Search complete." << endl;
+
+  params.Get<arma::Mat<size_t>>("neighbors") = std::move(neighbors);
+  params.Get<arma::mat>("distances") = std::move(distances);
+}
+
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
   if (params.Get<int>("seed") != 0)
@@ -127,6 +225,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree_type");
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
   ReportIgnoredParam(params, {{ "input_model", true }}, "tau");
   ReportIgnoredParam(params, {{ "input_model", true }}, "rho");
   if (params.Has("input_model") && params.Has("leaf_size"))
@@ -153,6 +252,13 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   ReportIgnoredParam(params, {{ "k", false }}, "true_neighbors");
   ReportIgnoredParam(params, {{ "k", false }}, "true_distances");
   ReportIgnoredParam(params, {{ "k", false }}, "query");
+  ReportIgnoredParam(params, {{ "sparse", false }}, "metric");
+
+  if (params.Has("sparse"))
+  {
+    SparseSearch(params, timers);
+    return;
+  }
 
   // Sanity check on leaf size.
   RequireParamValue<int>(params, "leaf_size", [](int x) { return x > 0; },
@@ -186,7 +292,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   const string algorithm = params.Get<string>("algorithm");
   RequireParamInSet<string>(params, "algorithm", { "naive", "single_tree",
-      "dual_tree", "greedy" }, true, "unknown neighbor search algorithm");
+      "dual_tree", "greedy", "parallel_single_tree" }, true,
+      "unknown neighbor search algorithm");
   NeighborSearchMode searchMode = DUAL_TREE_MODE;
 
   if (algorithm == "naive")
@@ -197,6 +304,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     searchMode = DUAL_TREE_MODE;
   else if (algorithm == "greedy")
     searchMode = GREEDY_SINGLE_TREE_MODE;
+  else if (algorithm == "parallel_single_tree")
+    searchMode = PARALLEL_SINGLE_TREE_MODE;
 
   if (params.Has("reference"))
   {
@@ -207,7 +316,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     KNNModel::TreeTypes tree = KNNModel::KD_TREE;
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "spill",
-        "vp", "rp", "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "vp", "rp", "max-rp", "ub", "oct", "auto" }, true,
+        "unknown tree type");
 
     knn = new KNNModel();
 
@@ -241,9 +351,12 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       tree = KNNModel::UB_TREE;
     else if (treeType == "oct")
       tree = KNNModel::OCTREE;
+    else if (treeType == "auto")
+      tree = KNNModel::AUTO_TREE;
 
     knn->TreeType() = tree;
     knn->RandomBasis() = randomBasis;
+    knn->SinglePrecision() = params.Has("single_precision");
     knn->LeafSize() = size_t(lsInt);
     knn->Tau() = tau;
     knn->Rho() = rho;
@@ -253,6 +366,24 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     Log::Info << "Using reference data from "
         << params.GetPrintable<arma::mat>("reference") << "." << endl;
 
+    // Choose the tree type and leaf size (and the algorithm, if it was not
+    // given) for the search that will be done.
+    if (tree == KNNModel::AUTO_TREE && searchMode != NAIVE_MODE)
+    {
+      const arma::mat emptyQuery;
+      const size_t k = params.Has("k") ? (size_t) params.Get<int>("k") : 1;
+      const NeighborSearchMode selectedMode = knn->SelectTree(timers,
+          referenceSet, params.Has("query") ? params.Get<arma::mat>("query") :
+          emptyQuery, k, epsilon);
+      if (!params.Has("algorithm"))
+        searchMode = selectedMode;
+    }
+    else if (tree == KNNModel::AUTO_TREE)
+    {
+      // The tree type does not matter for naive search.
+      knn->TreeType() = KNNModel::KD_TREE;
+    }
+
     knn->BuildModel(timers, std::move(referenceSet), searchMode, epsilon);
   }
   else
@@ -272,7 +403,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Loaded kNN model from '"
         << params.GetPrintable<KNNModel*>("input_model") << "' (trained on "
-        << knn->Dataset().n_rows << "x" << knn->Dataset().n_cols
+        << knn->Dimensionality() << "x" << knn->NumReferencePoints()
         << " dataset)." << endl;
   }
 
@@ -293,10 +424,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       Log::Info << "Using query data from "
           << params.GetPrintable<arma::mat>("query") << "." << endl;
       queryData = std::move(params.Get<arma::mat>("query"));
-      if (queryData.n_rows != knn->Dataset().n_rows)
+      if (queryData.n_rows != knn->Dimensionality())
       {
         // Clean memory if needed before crashing.
-        const size_t dimensions = knn->Dataset().n_rows;
+        const size_t dimensions = knn->Dimensionality();
         if (params.Has("reference"))
           delete knn;
         Log::Fatal << "Query has invalid dimensions(" << queryData.n_rows <<
@@ -307,10 +438,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     // Sanity check on k value: must be greater than 0, must be less than or
     // equal to the number of reference points.  Since it is unsigned,
     // we only test the upper bound.
-    if (k > knn->Dataset().n_cols)
+    if (k > knn->NumReferencePoints())
     {
       // Clean memory if needed before crashing.
-      const size_t referencePoints = knn->Dataset().n_cols;
+      const size_t referencePoints = knn->NumReferencePoints();
       if (params.Has("reference"))
         delete knn;
       Log::Fatal << "Invalid k: " << k << "; must be greater than 0 and less "
@@ -320,10 +451,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     // Sanity check on k value: must not be equal to the number of reference
     // points when query data has not been provided.
-    if (!params.Has("query") && k == knn->Dataset().n_cols)
+    if (!params.Has("query") && k == knn->NumReferencePoints())
     {
       // Clean memory if needed before crashing.
-      const size_t referencePoints = knn->Dataset().n_cols;
+      const size_t referencePoints = knn->NumReferencePoints();
       if (params.Has("reference"))
         delete knn;
       Log::Fatal << "Invalid k: " << k << "; must be less than the number of "
@@ -335,6 +466,11 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     arma::Mat<size_t> neighbors;
     arma::mat distances;
 
+    // Collect traversal statistics, if requested.
+    TraversalStatistics statistics;
+    if (params.Has("traversal_statistics"))
+      knn->Statistics() = &statistics;
+
     if (params.Has("query"))
       knn->Search(timers, std::move(queryData), k, neighbors, distances);
     else
@@ -342,6 +478,17 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Search complete." << endl;
 
+    if (params.Has("traversal_statistics"))
+    {
+      knn->Statistics() = NULL;
+      statistics.Print(Log::Info);
+
+      const double buildTime = timers.Get("tree_building").count() / 1e6;
+      const double searchTime = timers.Get("computing_neighbors").count() / 1e6;
+      Log::Info << "Time spent building trees: " << buildTime << "s; time "
+          << "spent searching: " << searchTime << "s." << endl;
+    }
+
     // Calculate the effective error, if desired.
     if (params.Has("true_distances"))
     {
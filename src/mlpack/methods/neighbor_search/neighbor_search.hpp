@@ -28,6 +28,7 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 class LeafSizeNSWrapper;
@@ -38,7 +39,9 @@ enum NeighborSearchMode
   NAIVE_MODE,
   SINGLE_TREE_MODE,
   DUAL_TREE_MODE,
-  GREEDY_SINGLE_TREE_MODE
+  GREEDY_SINGLE_TREE_MODE,
+  //! Single-tree search where the query points are split across threads.
+  PARALLEL_SINGLE_TREE_MODE
 };
 
 /**
@@ -54,6 +57,11 @@ enum NeighborSearchMode
  * and the distance metric used.  More information on those classes can be found
  * in the NearestNeighborSort class and the ExampleKernel class.
  *
+ * When OpenMP is enabled, dual-tree search is parallelized by traversing
+ * independent subtrees of the query tree on different threads.  The results
+ * are identical to a serial search, but the number of base cases and scores
+ * may differ slightly, since pruning opportunities depend on traversal order.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  * @tparam DistanceType The distance metric to use for computation.
  * @tparam MatType The type of data matrix.
@@ -205,6 +213,40 @@ class NeighborSearch
    */
   void Train(Tree referenceTree);
 
+  /**
+   * Add the given points to the reference set, so that they can be returned by
+   * later searches.  The new points take the indices following the existing
+   * reference points, as if they were appended to the original reference set.
+   *
+   * If the tree type supports it (BinarySpaceTree and RectangleTree), the
+   * points are inserted into the existing reference tree; a BinarySpaceTree
+   * only expands the bounds of the leaves the points are added to, and does
+   * not split them.  For other tree types, the reference tree is rebuilt.
+   * Once the number of points inserted or removed since the reference tree was
+   * built exceeds RebuildFraction() times the number of reference points, the
+   * reference tree is rebuilt, so that it stays balanced.
+   *
+   * @param points Points to add to the reference set.
+   */
+  void Insert(const MatType& points);
+
+  /**
+   * Remove the reference points with the given indices (as returned by
+   * Search()) from the reference set.  The remaining points are renumbered as
+   * if the points were removed from the original reference set with
+   * `shed_cols()`: each index is reduced by the number of removed indices
+   * smaller than it.
+   *
+   * If the tree type supports it (BinarySpaceTree and RectangleTree), the
+   * points are removed from the existing reference tree; the bounds of a
+   * BinarySpaceTree are not tightened until the tree is rebuilt.  For other
+   * tree types, the reference tree is rebuilt.  As with Insert(), the
+   * reference tree is rebuilt once enough points have changed.
+   *
+   * @param indices Indices of the reference points to remove.
+   */
+  void Remove(const arma::uvec& indices);
+
   /**
    * For each point in the query set, compute the nearest neighbors and store
    * the output in the given matrices.  The matrices will be set to the size of
@@ -213,8 +255,8 @@ class NeighborSearch
    *
    * If querySet contains only a few query points, the extra cost of building a
    * tree on the points for dual-tree search may not be warranted, and it may be
-   * worthwhile to set singleMode = false (either in the constructor or with
-   * SingleMode()).
+   * worthwhile to use SINGLE_TREE_MODE or PARALLEL_SINGLE_TREE_MODE instead
+   * (either in the constructor or with SearchMode()).
    *
    * @param querySet Set of query points (can be just one point).
    * @param k Number of neighbors to search for.
@@ -257,6 +299,47 @@ class NeighborSearch
               arma::Mat<ElemType>& distances,
               bool sameSet = false);
 
+  /**
+   * For each point in the query set, search for the k neighbors with a
+   * best-first single-tree traversal (see BestFirstSingleTreeTraverser) that
+   * stops after `timeLimit` seconds or after `maxNodes` reference nodes have
+   * been visited, whichever comes first, and returns the best candidates found
+   * so far.  This bounds the latency of each query.  The query points are
+   * searched for in parallel when OpenMP is available.
+   *
+   * `quality[i]` tells how close the results of query point i are to the exact
+   * results: it is 1 if the search of the point was exact (every reference
+   * node was visited or pruned); otherwise, for nearest neighbor search, every
+   * reference point that was not considered is at a distance of at least
+   * `quality[i]` times the k-th distance found (for furthest neighbor search,
+   * at most the k-th distance divided by `quality[i]`).  It is 0 if fewer than
+   * k candidates were found.  With a nonzero Epsilon(), the nodes pruned by
+   * the approximation are not taken into account.
+   *
+   * The search mode is not used, but a reference tree is needed (so the mode
+   * must not be NAIVE_MODE); spill trees are not supported.
+   *
+   * @param querySet Set of query points (can be just one point).
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix storing lists of neighbors for each query point.
+   * @param distances Matrix storing distances of neighbors for each query
+   *     point.
+   * @param quality Vector storing the quality of the results of each query
+   *     point.
+   * @param timeLimit Maximum time of the search of each query point, in
+   *     seconds (0 means no limit).
+   * @param maxNodes Maximum number of reference nodes visited for each query
+   *     point (0 means no limit).
+   */
+  template<typename IndexType = size_t>
+  void AnytimeSearch(const MatType& querySet,
+                     const size_t k,
+                     arma::Mat<IndexType>& neighbors,
+                     arma::Mat<ElemType>& distances,
+                     arma::vec& quality,
+                     const double timeLimit,
+                     const size_t maxNodes = 0);
+
   /**
    * Search for the nearest neighbors of every point in the reference set.  This
    * is basically equivalent to calling any other overload of Search() with the
@@ -328,6 +411,44 @@ class NeighborSearch
   //! Modify the relative error to be considered in approximate search.
   double& Epsilon() { return epsilon; }
 
+  //! Get the fraction of the reference set that must be inserted or removed
+  //! before the reference tree is rebuilt (see Insert() and Remove()).
+  double RebuildFraction() const { return rebuildFraction; }
+  //! Modify the fraction of the reference set that must be inserted or removed
+  //! before the reference tree is rebuilt.  The tree is rebuilt with default
+  //! parameters; if the tree needs specific parameters (such as a leaf size),
+  //! set this to DBL_MAX and call Train() to rebuild it instead.
+  double& RebuildFraction() { return rebuildFraction; }
+
+  //! Get the maximum number of reference leaves visited for each query (0
+  //! means no limit).
+  size_t MaxLeaves() const { return maxLeaves; }
+  //! Modify the maximum number of reference leaves visited for each query.
+  //! This bounds the time of each query in tree-based search, but results may
+  //! be less accurate; it is only used by traversers that support a budget
+  //! (such as the spill tree traversers), and it is not serialized.
+  size_t& MaxLeaves() { return maxLeaves; }
+
+  //! Get the collector of detailed traversal statistics (NULL by default).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the collector of detailed traversal statistics.  When it is not
+  //! NULL, every subsequent search records its statistics into it (see
+  //! TraversalStatistics).  The object is not owned by the NeighborSearch and
+  //! is not serialized.
+  TraversalStatistics*& Statistics() { return statistics; }
+
+  //! Get whether monochromatic searches are symmetric self-joins.
+  bool Symmetric() const { return symmetric; }
+  //! Modify whether monochromatic searches (without a query set) are symmetric
+  //! self-joins.  In dual-tree and naive mode, each pair of points is then
+  //! evaluated only once and is a candidate for both points, which nearly
+  //! halves the number of base cases.  Symmetric searches run in one thread,
+  //! because each base case updates the candidates of two points.  The
+  //! reference tree must hold each point in exactly one leaf (see
+  //! SymmetricTraversalTraits); otherwise, and in the other modes, this is
+  //! ignored.  This is not serialized.
+  bool& Symmetric() { return symmetric; }
+
   //! Access the reference dataset.
   const MatType& ReferenceSet() const { return *referenceSet; }
 
@@ -365,9 +486,70 @@ class NeighborSearch
   //! Search() without a query set.
   bool treeNeedsReset;
 
+  //! The reference tree is rebuilt once numChanges exceeds this fraction of the
+  //! number of reference points.
+  double rebuildFraction;
+  //! The number of points inserted or removed since the reference tree was
+  //! built.
+  size_t numChanges;
+
+  //! The maximum number of reference leaves visited for each query (0 means no
+  //! limit).
+  size_t maxLeaves;
+
+  //! Optional collector of traversal statistics; not owned.
+  TraversalStatistics* statistics;
+
+  //! If true, monochromatic searches are symmetric self-joins.
+  bool symmetric;
+
+  //! Return a copy of the reference set with the points in their original
+  //! order (that is, the order of the indices returned by Search()).
+  MatType OriginalReferenceSet() const;
+
+  /**
+   * Traverse the given query tree and the reference tree with a dual-tree
+   * traversal, using the given rules.  If OpenMP is available and more than
+   * one thread can be used, the query tree is split into disjoint subtrees
+   * that are traversed in parallel against the reference tree; each thread
+   * uses its own rules object that shares the candidate lists of `rules`, and
+   * the number of base cases and scores of every thread are accumulated into
+   * `rules`.
+   *
+   * @param rules Rules object to use for the traversal.
+   * @param queryTree Tree built on the query points.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(RuleType& rules, Tree& queryTree);
+
+  /**
+   * Traverse the reference tree against itself with the
+   * SymmetricDualTreeTraverser, after making the given rules symmetric.  If the
+   * tree type can't be traversed symmetrically, this is a regular dual-tree
+   * traversal.
+   *
+   * @param rules Rules object to use for the traversal.
+   */
+  template<typename RuleType>
+  void SymmetricTraversal(RuleType& rules);
+
+  /**
+   * Run a single-tree traversal of the reference tree for each of the given
+   * number of query points, splitting the query points across threads if
+   * OpenMP is available.  Each thread uses its own rules object and traverser
+   * against the shared reference tree.  Trees that cache base case results in
+   * the reference tree during single-tree search (i.e. those whose first point
+   * is the centroid, like the cover tree) are traversed serially.
+   *
+   * @param rules Rules object to use for the traversal.
+   * @param numQueries Number of query points.
+   */
+  template<typename RuleType>
+  void ParallelSingleTreeTraversal(RuleType& rules, const size_t numQueries);
+
   //! The NSModel class should have access to internal members.
-  friend class LeafSizeNSWrapper<SortPolicy, TreeType, DualTreeTraversalType,
-      SingleTreeTraversalType>;
+  friend class LeafSizeNSWrapper<SortPolicy, TreeType, MatType,
+      DualTreeTraversalType, SingleTreeTraversalType>;
 }; // class NeighborSearch
 
 } // namespace mlpack
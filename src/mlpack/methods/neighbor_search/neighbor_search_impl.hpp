@@ -15,11 +15,51 @@
 
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/tree/greedy_single_tree_traverser.hpp>
+#include <mlpack/core/tree/best_first_single_tree_traverser.hpp>
+#include <mlpack/core/tree/incremental_tree.hpp>
+#include <mlpack/core/util/sfinae_utility.hpp>
 #include "neighbor_search_rules.hpp"
 #include <mlpack/core/tree/spill_tree/is_spill_tree.hpp>
 
 namespace mlpack {
 
+HAS_MEM_FUNC(MaxLeaves, TraverserHasMaxLeaves);
+
+/**
+ * Set the maximum number of leaves visited for each query by the given
+ * traverser, if the traverser supports such a budget.
+ */
+template<typename TraverserType>
+inline void SetTraverserMaxLeaves(TraverserType& traverser,
+                                  const size_t maxLeaves)
+{
+  if constexpr (TraverserHasMaxLeaves<TraverserType,
+      size_t&(TraverserType::*)()>::value)
+  {
+    traverser.MaxLeaves() = maxLeaves;
+  }
+}
+
+/**
+ * Return true if no point of the given tree is held by more than one child of
+ * a node, so that the subtrees of the tree can be traversed independently.
+ */
+template<typename TreeType>
+bool HasDisjointSubtrees(const TreeType& node)
+{
+  size_t childDescendants = 0;
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    childDescendants += node.Child(i).NumDescendants();
+  if (node.NumChildren() > 0 && childDescendants != node.NumDescendants())
+    return false;
+
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+    if (!HasDisjointSubtrees(node.Child(i)))
+      return false;
+
+  return true;
+}
+
 // Construct the object.
 template<typename SortPolicy,
          typename DistanceType,
@@ -44,7 +84,12 @@ NeighborSearch(MatType referenceSetIn,
     distance(distance),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildFraction(0.25),
+    numChanges(0),
+    maxLeaves(0),
+    statistics(NULL),
+    symmetric(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -72,7 +117,12 @@ NeighborSearch(Tree referenceTree,
     distance(distance),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildFraction(0.25),
+    numChanges(0),
+    maxLeaves(0),
+    statistics(NULL),
+    symmetric(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -99,7 +149,12 @@ NeighborSearch(const NeighborSearchMode mode,
     distance(distance),
     baseCases(0),
     scores(0),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildFraction(0.25),
+    numChanges(0),
+    maxLeaves(0),
+    statistics(NULL),
+    symmetric(false)
 {
   if (epsilon < 0)
     throw std::invalid_argument("epsilon must be non-negative");
@@ -134,7 +189,12 @@ NeighborSearch(const NeighborSearch& other) :
     distance(other.distance),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(false)
+    treeNeedsReset(false),
+    rebuildFraction(other.rebuildFraction),
+    numChanges(other.numChanges),
+    maxLeaves(other.maxLeaves),
+    statistics(other.statistics),
+    symmetric(other.symmetric)
 {
   // Nothing else to do.
 }
@@ -159,7 +219,12 @@ NeighborSearch(NeighborSearch&& other) :
     distance(std::move(other.distance)),
     baseCases(other.baseCases),
     scores(other.scores),
-    treeNeedsReset(other.treeNeedsReset)
+    treeNeedsReset(other.treeNeedsReset),
+    rebuildFraction(other.rebuildFraction),
+    numChanges(other.numChanges),
+    maxLeaves(other.maxLeaves),
+    statistics(other.statistics),
+    symmetric(other.symmetric)
 {
   // Clear the other model.
   other.referenceTree = BuildTree<Tree>(std::move(MatType()),
@@ -170,6 +235,11 @@ NeighborSearch(NeighborSearch&& other) :
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.rebuildFraction = 0.25;
+  other.numChanges = 0;
+  other.maxLeaves = 0;
+  other.statistics = NULL;
+  other.symmetric = false;
 }
 
 // Copy operator.
@@ -213,6 +283,11 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = false;
+  rebuildFraction = other.rebuildFraction;
+  numChanges = other.numChanges;
+  maxLeaves = other.maxLeaves;
+  statistics = other.statistics;
+  symmetric = other.symmetric;
 }
 
 // Move operator.
@@ -255,6 +330,11 @@ NeighborSearch<SortPolicy,
   baseCases = other.baseCases;
   scores = other.scores;
   treeNeedsReset = other.treeNeedsReset;
+  rebuildFraction = other.rebuildFraction;
+  numChanges = other.numChanges;
+  maxLeaves = other.maxLeaves;
+  statistics = other.statistics;
+  symmetric = other.symmetric;
 
   // Reset the other object.  Clean memory if needed.
   if (!other.referenceTree)
@@ -268,6 +348,11 @@ NeighborSearch<SortPolicy,
   other.baseCases = 0;
   other.scores = 0;
   other.treeNeedsReset = false;
+  other.rebuildFraction = 0.25;
+  other.numChanges = 0;
+  other.maxLeaves = 0;
+  other.statistics = NULL;
+  other.symmetric = false;
 }
 
 // Clean memory.
@@ -323,6 +408,8 @@ Train(MatType referenceSetIn)
   {
     referenceSet = new MatType(std::move(referenceSetIn));
   }
+
+  numChanges = 0;
 }
 
 template<typename SortPolicy,
@@ -352,6 +439,155 @@ DualTreeTraversalType, SingleTreeTraversalType>::Train(Tree referenceTree)
 
   this->referenceTree = new Tree(std::move(referenceTree));
   this->referenceSet = &this->referenceTree->Dataset();
+  numChanges = 0;
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Insert(const MatType& points)
+{
+  if (points.n_cols == 0)
+    return;
+
+  if (referenceSet->n_cols > 0 && points.n_rows != referenceSet->n_rows)
+  {
+    std::stringstream ss;
+    ss << "NeighborSearch::Insert(): dimensionality of points ("
+        << points.n_rows << ") does not match dimensionality of reference set ("
+        << referenceSet->n_rows << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  // Without a tree there is nothing to update, and a tree built on an empty
+  // reference set is better built again on the new points.
+  if (!referenceTree || referenceSet->n_cols == 0)
+  {
+    Train(MatType(arma::join_rows(OriginalReferenceSet(), points)));
+    return;
+  }
+
+  if constexpr (HasRemove<Tree>::value)
+  {
+    // A tree given to Train() has no mapping; its points keep the indices they
+    // have in its dataset.
+    if (oldFromNewReferences.empty())
+    {
+      oldFromNewReferences.resize(referenceSet->n_cols);
+      for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+        oldFromNewReferences[i] = i;
+    }
+
+    referenceTree->Insert(points, oldFromNewReferences);
+  }
+  else if constexpr (HasDelete<Tree>::value)
+  {
+    referenceTree->Insert(points);
+  }
+  else
+  {
+    Train(MatType(arma::join_rows(OriginalReferenceSet(), points)));
+    return;
+  }
+
+  referenceSet = &referenceTree->Dataset();
+  numChanges += points.n_cols;
+  if (numChanges > rebuildFraction * referenceSet->n_cols)
+    Train(OriginalReferenceSet());
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+void NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::Remove(
+    const arma::uvec& indices)
+{
+  // Sort the indices and ignore any duplicates.
+  const arma::uvec sortedIndices = arma::unique(indices);
+  if (sortedIndices.n_elem == 0)
+    return;
+
+  if (sortedIndices[sortedIndices.n_elem - 1] >= referenceSet->n_cols)
+  {
+    std::stringstream ss;
+    ss << "NeighborSearch::Remove(): point index ("
+        << sortedIndices[sortedIndices.n_elem - 1] << ") is greater than the "
+        << "number of points in the reference set (" << referenceSet->n_cols
+        << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (!referenceTree)
+  {
+    MatType newReferenceSet(OriginalReferenceSet());
+    newReferenceSet.shed_cols(sortedIndices);
+    Train(std::move(newReferenceSet));
+    return;
+  }
+
+  if constexpr (HasRemove<Tree>::value)
+  {
+    if (oldFromNewReferences.empty())
+    {
+      oldFromNewReferences.resize(referenceSet->n_cols);
+      for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+        oldFromNewReferences[i] = i;
+    }
+
+    referenceTree->Remove(sortedIndices, oldFromNewReferences);
+  }
+  else if constexpr (HasDelete<Tree>::value)
+  {
+    // Delete the points with the largest indices first, so that the indices
+    // of the points that are still to be deleted do not change.
+    for (size_t i = sortedIndices.n_elem; i > 0; --i)
+      referenceTree->Delete(sortedIndices[i - 1]);
+  }
+  else
+  {
+    MatType newReferenceSet(OriginalReferenceSet());
+    newReferenceSet.shed_cols(sortedIndices);
+    Train(std::move(newReferenceSet));
+    return;
+  }
+
+  referenceSet = &referenceTree->Dataset();
+  numChanges += sortedIndices.n_elem;
+  if (numChanges > rebuildFraction * referenceSet->n_cols)
+    Train(OriginalReferenceSet());
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+MatType NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::OriginalReferenceSet() const
+{
+  if (oldFromNewReferences.empty())
+    return *referenceSet;
+
+  MatType originalSet(referenceSet->n_rows, referenceSet->n_cols);
+  for (size_t i = 0; i < oldFromNewReferences.size(); ++i)
+    originalSet.col(oldFromNewReferences[i]) = referenceSet->col(i);
+
+  return originalSet;
 }
 
 /**
@@ -419,6 +655,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, distance, epsilon);
+      rules.Statistics() = statistics;
 
       // The naive brute-force traversal.
       for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -434,9 +671,11 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, distance, epsilon);
+      rules.Statistics() = statistics;
 
       // Create the traverser.
       SingleTreeTraversalType<RuleType> traverser(rules);
+      SetTraverserMaxLeaves(traverser, maxLeaves);
 
       // Now have it traverse for each point.
       for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -460,11 +699,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
 
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, queryTree->Dataset(), k, distance, epsilon);
+      rules.Statistics() = statistics;
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
-      traverser.Traverse(*queryTree, *referenceTree);
+      DualTreeTraversal(rules, *queryTree);
 
       scores += rules.Scores();
       baseCases += rules.BaseCases();
@@ -479,10 +716,30 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       delete queryTree;
       break;
     }
+    case PARALLEL_SINGLE_TREE_MODE:
+    {
+      // Create the helper object for the tree traversal.
+      RuleType rules(*referenceSet, querySet, k, distance, epsilon);
+      rules.Statistics() = statistics;
+
+      ParallelSingleTreeTraversal(rules, querySet.n_cols);
+
+      scores += rules.Scores();
+      baseCases += rules.BaseCases();
+
+      Log::Info << rules.Scores() << " node combinations were scored."
+          << std::endl;
+      Log::Info << rules.BaseCases() << " base cases were calculated."
+          << std::endl;
+
+      rules.GetResults(*neighborPtr, *distancePtr);
+      break;
+    }
     case GREEDY_SINGLE_TREE_MODE:
     {
       // Create the helper object for the tree traversal.
       RuleType rules(*referenceSet, querySet, k, distance);
+      rules.Statistics() = statistics;
 
       // Create the traverser.
       GreedySingleTreeTraverser<Tree, RuleType> traverser(rules);
@@ -564,6 +821,138 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 } // Search()
 
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename IndexType>
+void NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::AnytimeSearch(
+    const MatType& querySet,
+    const size_t k,
+    arma::Mat<IndexType>& neighbors,
+    arma::Mat<ElemType>& distances,
+    arma::vec& quality,
+    const double timeLimit,
+    const size_t maxNodes)
+{
+  if (k > referenceSet->n_cols)
+  {
+    std::stringstream ss;
+    ss << "Requested value of k (" << k << ") is greater than the number of "
+        << "points in the reference set (" << referenceSet->n_cols << ")";
+    throw std::invalid_argument(ss.str());
+  }
+
+  if (searchMode == NAIVE_MODE || IsSpillTree<Tree>::value)
+  {
+    throw std::invalid_argument("NeighborSearch::AnytimeSearch(): a reference "
+        "tree is needed, so the search mode cannot be NAIVE_MODE, and spill "
+        "trees are not supported!");
+  }
+
+  baseCases = 0;
+  scores = 0;
+
+  // Reference indices need to be mapped if the tree rearranged the points.
+  arma::Mat<IndexType>* neighborPtr = &neighbors;
+  if (TreeTraits<Tree>::RearrangesDataset && !oldFromNewReferences.empty())
+    neighborPtr = new arma::Mat<IndexType>;
+
+  neighborPtr->set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+
+  using RuleType = NeighborSearchRules<SortPolicy, DistanceType, Tree>;
+  RuleType rules(*referenceSet, querySet, k, distance, epsilon);
+  rules.Statistics() = statistics;
+
+  // The best score of the nodes that were not visited for each query point
+  // (DBL_MAX if its search was exact).
+  arma::vec unvisitedScores(querySet.n_cols);
+  size_t threadScores = 0;
+  size_t threadBaseCases = 0;
+
+  // As in ParallelSingleTreeTraversal(), the reference tree cannot be shared
+  // between threads when its first point is the centroid; each thread has its
+  // own rules object, that shares the candidate lists.
+  #ifdef MLPACK_USE_OPENMP
+  const bool parallel = (omp_get_max_threads() > 1 &&
+      !TreeTraits<Tree>::FirstPointIsCentroid);
+  #endif
+  #pragma omp parallel if(parallel) reduction(+:threadScores, threadBaseCases)
+  {
+    RuleType localRules(rules);
+    TraversalStatistics localStatistics;
+    if (rules.Statistics())
+      localRules.Statistics() = &localStatistics;
+    BestFirstSingleTreeTraverser<Tree, RuleType> traverser(localRules);
+    traverser.TimeLimit() = timeLimit;
+    traverser.MaxNodes() = maxNodes;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      traverser.Traverse(i, *referenceTree);
+      unvisitedScores[i] = traverser.BestUnvisitedScore();
+    }
+
+    threadScores += localRules.Scores();
+    threadBaseCases += localRules.BaseCases();
+
+    if (rules.Statistics())
+    {
+      #pragma omp critical
+      rules.Statistics()->Merge(localStatistics);
+    }
+  }
+
+  scores += threadScores;
+  baseCases += threadBaseCases;
+  Log::Info << scores << " node combinations were scored." << std::endl;
+  Log::Info << baseCases << " base cases were calculated." << std::endl;
+
+  rules.GetResults(*neighborPtr, distances);
+
+  // Compare the best possible distance of the nodes that were not visited
+  // with the k-th candidate of each query point.
+  quality.set_size(querySet.n_cols);
+  size_t stopped = 0;
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    if (unvisitedScores[i] == DBL_MAX || k == 0)
+    {
+      quality[i] = 1.0;
+      continue;
+    }
+
+    ++stopped;
+    const double kthDistance = distances(k - 1, i);
+    const double bound = SortPolicy::ConvertToDistance(unvisitedScores[i]);
+    if (kthDistance == SortPolicy::WorstDistance())
+      quality[i] = 0.0;
+    else if (SortPolicy::IsBetter(kthDistance, bound))
+      quality[i] = 1.0;
+    else
+      quality[i] = std::min(bound, kthDistance) / std::max(bound, kthDistance);
+  }
+  Log::Info << "The search of " << stopped << " of " << querySet.n_cols
+      << " query points was stopped early." << std::endl;
+
+  if (neighborPtr != &neighbors)
+  {
+    neighbors.set_size(k, querySet.n_cols);
+    for (size_t i = 0; i < neighbors.n_cols; ++i)
+      for (size_t j = 0; j < neighbors.n_rows; ++j)
+        neighbors(j, i) = oldFromNewReferences[(*neighborPtr)(j, i)];
+
+    delete neighborPtr;
+  }
+}
+
 template<typename SortPolicy,
          typename DistanceType,
          typename MatType,
@@ -612,10 +1001,9 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   // Create the helper object for the traversal.
   using RuleType = NeighborSearchRules<SortPolicy, DistanceType, Tree>;
   RuleType rules(*referenceSet, querySet, k, distance, epsilon, sameSet);
+  rules.Statistics() = statistics;
 
-  // Create the traverser.
-  DualTreeTraversalType<RuleType> traverser(rules);
-  traverser.Traverse(queryTree, *referenceTree);
+  DualTreeTraversal(rules, queryTree);
 
   scores += rules.Scores();
   baseCases += rules.BaseCases();
@@ -696,11 +1084,24 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   using RuleType = NeighborSearchRules<SortPolicy, DistanceType, Tree>;
   RuleType rules(*referenceSet, *referenceSet, k, distance, epsilon,
       true /* don't return the same point as nearest neighbor */);
+  rules.Statistics() = statistics;
 
   switch (searchMode)
   {
     case NAIVE_MODE:
     {
+      if (symmetric)
+      {
+        // Each pair of points is evaluated once.
+        rules.Symmetric() = true;
+        for (size_t i = 0; i < referenceSet->n_cols; ++i)
+          for (size_t j = i + 1; j < referenceSet->n_cols; ++j)
+            rules.BaseCase(i, j);
+
+        baseCases += referenceSet->n_cols * (referenceSet->n_cols - 1) / 2;
+        break;
+      }
+
       // The naive brute-force solution.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
         for (size_t j = 0; j < referenceSet->n_cols; ++j)
@@ -713,6 +1114,7 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
     {
       // Create the traverser.
       SingleTreeTraversalType<RuleType> traverser(rules);
+      SetTraverserMaxLeaves(traverser, maxLeaves);
 
       // Now have it traverse for each point.
       for (size_t i = 0; i < referenceSet->n_cols; ++i)
@@ -749,19 +1151,20 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
         }
       }
 
-      // Create the traverser.
-      DualTreeTraversalType<RuleType> traverser(rules);
-
       if (IsSpillTree<Tree>::value)
       {
         // For Dual Tree Search on SpillTree, the queryTree must be built with
         // non overlapping (tau = 0).
         Tree queryTree(*referenceSet);
-        traverser.Traverse(queryTree, *referenceTree);
+        DualTreeTraversal(rules, queryTree);
+      }
+      else if (symmetric)
+      {
+        SymmetricTraversal(rules);
       }
       else
       {
-        traverser.Traverse(*referenceTree, *referenceTree);
+        DualTreeTraversal(rules, *referenceTree);
         // Next time we perform this search, we'll need to reset the tree.
         treeNeedsReset = true;
       }
@@ -778,6 +1181,19 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
       treeNeedsReset = true;
       break;
     }
+    case PARALLEL_SINGLE_TREE_MODE:
+    {
+      ParallelSingleTreeTraversal(rules, referenceSet->n_cols);
+
+      scores += rules.Scores();
+      baseCases += rules.BaseCases();
+
+      Log::Info << rules.Scores() << " node combinations were scored."
+          << std::endl;
+      Log::Info << rules.BaseCases() << " base cases were calculated."
+          << std::endl;
+      break;
+    }
     case GREEDY_SINGLE_TREE_MODE:
     {
       // Create the traverser.
@@ -823,6 +1239,164 @@ DualTreeTraversalType, SingleTreeTraversalType>::Search(
   }
 }
 
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::DualTreeTraversal(
+    RuleType& rules,
+    Tree& queryTree)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // Spill trees may hold the same query point in multiple subtrees, and then
+  // the subtrees could not be traversed independently.  The query trees built
+  // by Search() have no overlap (tau = 0), so they can be.
+  const size_t numThreads = omp_get_max_threads();
+  bool disjointSubtrees = true;
+  if constexpr (IsSpillTree<Tree>::value)
+  {
+    if (numThreads > 1)
+      disjointSubtrees = HasDisjointSubtrees(queryTree);
+  }
+
+  if (numThreads > 1 && disjointSubtrees)
+  {
+    // Collect a few more subtrees than threads, so that the work can be
+    // balanced dynamically.
+    std::vector<Tree*> frontier;
+    QueryFrontier(queryTree, 4 * numThreads, frontier);
+
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      // Each thread gets its own base case cache and traversal info, but
+      // writes to the shared candidate lists; this is safe because the query
+      // subtrees are disjoint.
+      RuleType localRules(rules);
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      DualTreeTraversalType<RuleType> traverser(localRules);
+      SetTraverserMaxLeaves(traverser, maxLeaves);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+        traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadScores += localRules.Scores();
+      threadBaseCases += localRules.BaseCases();
+
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return;
+  }
+  #endif
+
+  DualTreeTraversalType<RuleType> traverser(rules);
+  SetTraverserMaxLeaves(traverser, maxLeaves);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::SymmetricTraversal(
+    RuleType& rules)
+{
+  if constexpr (!SymmetricTraversalTraits<Tree>::Supported)
+  {
+    DualTreeTraversal(rules, *referenceTree);
+  }
+  else
+  {
+    // Each base case may insert a candidate for a point of any subtree, so the
+    // traversal can't be split between threads.
+    rules.Symmetric() = true;
+    SymmetricDualTreeTraverser<Tree, RuleType> traverser(rules);
+    traverser.Traverse(*referenceTree);
+  }
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType,
+         template<typename> class DualTreeTraversalType,
+         template<typename> class SingleTreeTraversalType>
+template<typename RuleType>
+void NeighborSearch<SortPolicy, DistanceType, MatType, TreeType,
+DualTreeTraversalType, SingleTreeTraversalType>::ParallelSingleTreeTraversal(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // When the first point of each node is the centroid, Score() stores the last
+  // base case in the statistic of the reference node, so the reference tree
+  // cannot be shared between threads.
+  if (omp_get_max_threads() > 1 && !TreeTraits<Tree>::FirstPointIsCentroid)
+  {
+    size_t threadScores = 0;
+    size_t threadBaseCases = 0;
+    #pragma omp parallel reduction(+:threadScores, threadBaseCases)
+    {
+      // Each query point is handled by exactly one thread, so the candidate
+      // lists can be shared.
+      RuleType localRules(rules);
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      SingleTreeTraversalType<RuleType> traverser(localRules);
+      SetTraverserMaxLeaves(traverser, maxLeaves);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadScores += localRules.Scores();
+      threadBaseCases += localRules.BaseCases();
+
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
+
+    rules.Scores() += threadScores;
+    rules.BaseCases() += threadBaseCases;
+    return;
+  }
+  #endif
+
+  SingleTreeTraversalType<RuleType> traverser(rules);
+  SetTraverserMaxLeaves(traverser, maxLeaves);
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+}
+
 //! Calculate the average relative error.
 template<typename SortPolicy,
          typename DistanceType,
@@ -954,11 +1528,12 @@ DualTreeTraversalType, SingleTreeTraversalType>::serialize(
     }
   }
 
-  // Reset base cases and scores.
+  // Reset base cases, scores, and the count of changed points.
   if (cereal::is_loading<Archive>())
   {
     baseCases = 0;
     scores = 0;
+    numChanges = 0;
   }
 }
 
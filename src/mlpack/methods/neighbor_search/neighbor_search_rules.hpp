@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_NEIGHBOR_SEARCH_NEIGHBOR_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
 
 #include <queue>
 
@@ -56,6 +57,18 @@ class NeighborSearchRules
                       const double epsilon = 0,
                       const bool sameSet = false);
 
+  /**
+   * Construct a NeighborSearchRules object that shares the candidate lists of
+   * the given rules object, but holds its own base case cache, traversal info,
+   * and score and base case counters.  This is used for parallel dual-tree
+   * traversals, where each thread traverses a disjoint set of query subtrees
+   * and thus never modifies the candidate list of a query point that is owned
+   * by another thread.
+   *
+   * @param other Rules object whose candidate lists will be shared.
+   */
+  NeighborSearchRules(NeighborSearchRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -78,6 +91,25 @@ class NeighborSearchRules
    */
   double BaseCase(const size_t queryIndex, const size_t referenceIndex);
 
+  /**
+   * Compute the base cases between each of the given query points and each of
+   * the reference points in the given (contiguous) range.  This has the same
+   * effect as calling BaseCase() for every combination, but when the distance
+   * metric is the Euclidean or squared Euclidean distance and the data is
+   * dense, the distances between all the points are computed at once with a
+   * matrix multiplication, using ||q - r||^2 = ||q||^2 + ||r||^2 - 2 q^T r.
+   * The exact distance is then computed only for those reference points that
+   * may be inserted into the candidate list of a query point, so the results
+   * are the same as with BaseCase().
+   *
+   * @param queryIndices Indices of query points.
+   * @param referenceBegin Index of first reference point.
+   * @param referenceCount Number of reference points.
+   */
+  void BlockBaseCase(const arma::uvec& queryIndices,
+                     const size_t referenceBegin,
+                     const size_t referenceCount);
+
   /**
    * Get the score for recursion order.  A low score indicates priority for
    * recursion, while DBL_MAX indicates that the node should not be recursed
@@ -154,6 +186,11 @@ class NeighborSearchRules
   //! Modify the number of scores that have been performed.
   size_t& Scores() { return scores; }
 
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
   //! Convenience typedef.
   using TraversalInfoType = mlpack::TraversalInfo<TreeType>;
 
@@ -166,6 +203,15 @@ class NeighborSearchRules
   //! results.  This is only needed in defeatist search mode.
   size_t MinimumBaseCases() const { return k; }
 
+  //! Get whether the rules are symmetric (see Symmetric()).
+  bool Symmetric() const { return symmetric; }
+  //! Modify whether the rules are symmetric.  Symmetric rules are used with the
+  //! SymmetricDualTreeTraverser when the query set is the reference set: each
+  //! base case (i, j) is also a candidate for j, and a pair of nodes is only
+  //! pruned if it can be pruned for both nodes.  The traversal info is not
+  //! used.
+  bool& Symmetric() { return symmetric; }
+
  protected:
   //! The reference set.
   const typename TreeType::Mat& referenceSet;
@@ -188,8 +234,12 @@ class NeighborSearchRules
   using CandidateList = std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp>;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Storage for the candidate neighbors of each point, if this object owns
+  //! them.
+  std::vector<CandidateList> localCandidates;
+  //! Set of candidate neighbors for each point (possibly shared with another
+  //! NeighborSearchRules object).
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -200,6 +250,9 @@ class NeighborSearchRules
   //! Denotes whether or not the reference and query sets are the same.
   bool sameSet;
 
+  //! Denotes whether each result is also recorded in the reverse direction.
+  bool symmetric;
+
   //! Relative error to be considered in approximate search.
   const double epsilon;
 
@@ -214,6 +267,8 @@ class NeighborSearchRules
   size_t baseCases;
   //! The number of scores that have been performed.
   size_t scores;
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
 
   //! Traversal info for the parent combination; this is updated by the
   //! traversal before each call to Score().
@@ -224,6 +279,13 @@ class NeighborSearchRules
    */
   double CalculateBound(TreeType& queryNode) const;
 
+  /**
+   * Get the bound that the given distance between the two nodes must be better
+   * than for the pair to be kept by symmetric rules: the worse of the bounds of
+   * the two nodes.
+   */
+  double SymmetricBound(TreeType& queryNode, TreeType& referenceNode) const;
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
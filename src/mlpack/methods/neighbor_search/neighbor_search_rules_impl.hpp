@@ -28,14 +28,17 @@ NeighborSearchRules<SortPolicy, DistanceType, TreeType>::NeighborSearchRules(
     const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(localCandidates),
     k(k),
     distance(distance),
     sameSet(sameSet),
+    symmetric(false),
     epsilon(epsilon),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL)
 {
   // We must set the traversal info last query and reference node pointers to
   // something that is both invalid (i.e. not a tree node) and not NULL.  We'll
@@ -58,6 +61,28 @@ NeighborSearchRules<SortPolicy, DistanceType, TreeType>::NeighborSearchRules(
     candidates.push_back(pqueue);
 }
 
+template<typename SortPolicy, typename DistanceType, typename TreeType>
+NeighborSearchRules<SortPolicy, DistanceType, TreeType>::NeighborSearchRules(
+    NeighborSearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    distance(other.distance),
+    sameSet(other.sameSet),
+    symmetric(other.symmetric),
+    epsilon(other.epsilon),
+    lastQueryIndex(querySet.n_cols),
+    lastReferenceIndex(referenceSet.n_cols),
+    baseCases(0),
+    scores(0),
+    statistics(other.statistics)
+{
+  // See the other constructor for why we use the this pointer.
+  traversalInfo.LastQueryNode() = (TreeType*) this;
+  traversalInfo.LastReferenceNode() = (TreeType*) this;
+}
+
 template<typename SortPolicy, typename DistanceType, typename TreeType>
 template<typename IndexType>
 void NeighborSearchRules<SortPolicy, DistanceType, TreeType>::GetResults(
@@ -96,8 +121,12 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   double dist = distance.Evaluate(querySet.col(queryIndex),
                                   referenceSet.col(referenceIndex));
   ++baseCases;
+  if (statistics)
+    statistics->RecordBaseCases();
 
   InsertNeighbor(queryIndex, referenceIndex, dist);
+  if (symmetric)
+    InsertNeighbor(referenceIndex, queryIndex, dist);
 
   // Cache this information for the next time BaseCase() is called.
   lastQueryIndex = queryIndex;
@@ -107,6 +136,80 @@ BaseCase(const size_t queryIndex, const size_t referenceIndex)
   return dist;
 }
 
+template<typename SortPolicy, typename DistanceType, typename TreeType>
+void NeighborSearchRules<SortPolicy, DistanceType, TreeType>::BlockBaseCase(
+    const arma::uvec& queryIndices,
+    const size_t referenceBegin,
+    const size_t referenceCount)
+{
+  using MatType = typename TreeType::Mat;
+
+  if (queryIndices.n_elem == 0 || referenceCount == 0)
+    return;
+
+  // The blocked computation only applies to the L2 distance on dense data.
+  if constexpr (!std::is_same_v<MatType, arma::Mat<ElemType>> ||
+                !(std::is_same_v<DistanceType, LMetric<2, true>> ||
+                  std::is_same_v<DistanceType, LMetric<2, false>>))
+  {
+    for (size_t i = 0; i < queryIndices.n_elem; ++i)
+      for (size_t r = referenceBegin; r < referenceBegin + referenceCount; ++r)
+        BaseCase(queryIndices[i], r);
+  }
+  else
+  {
+    const arma::Mat<ElemType> queries = querySet.cols(queryIndices);
+    const auto references = referenceSet.cols(referenceBegin,
+        referenceBegin + referenceCount - 1);
+
+    const arma::Row<ElemType> queryNorms = arma::sum(arma::square(queries), 0);
+    const arma::Col<ElemType> referenceNorms =
+        arma::sum(arma::square(references), 0).t();
+
+    // Squared distances between each reference point (row) and each query
+    // point (column).
+    arma::Mat<ElemType> sqDistances = -2 * references.t() * queries;
+    sqDistances.each_col() += referenceNorms;
+    sqDistances.each_row() += queryNorms;
+
+    // The error of each squared distance is bounded by a small multiple of the
+    // machine epsilon times the sum of the squared norms of the points, so any
+    // reference point that could be good enough is within that tolerance.
+    const double tolerance = 4.0 * (querySet.n_rows + 2) *
+        std::numeric_limits<ElemType>::epsilon();
+
+    for (size_t i = 0; i < queryIndices.n_elem; ++i)
+    {
+      const size_t queryIndex = queryIndices[i];
+      for (size_t j = 0; j < referenceCount; ++j)
+      {
+        const size_t referenceIndex = referenceBegin + j;
+        if (sameSet && (queryIndex == referenceIndex))
+          continue;
+
+        ++baseCases;
+        if (statistics)
+          statistics->RecordBaseCases();
+
+        // Compare against the current worst candidate in squared units.
+        const double bestDistance = candidates[queryIndex].top().first;
+        const double bound = (DistanceType::TakeRoot) ?
+            bestDistance * bestDistance : bestDistance;
+        const double sqDistance = sqDistances(j, i);
+        const double error = tolerance *
+            (queryNorms[i] + referenceNorms[j]);
+        if (!SortPolicy::IsBetter(sqDistance - error, bound) &&
+            !SortPolicy::IsBetter(sqDistance + error, bound))
+          continue;
+
+        const double dist = distance.Evaluate(querySet.col(queryIndex),
+            referenceSet.col(referenceIndex));
+        InsertNeighbor(queryIndex, referenceIndex, dist);
+      }
+    }
+  }
+}
+
 template<typename SortPolicy, typename DistanceType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Score(
     const size_t queryIndex,
@@ -146,8 +249,12 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Score(
   double bestDistance = candidates[queryIndex].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
-  return (SortPolicy::IsBetter(dist, bestDistance)) ?
+  const double newScore = (SortPolicy::IsBetter(dist, bestDistance)) ?
       SortPolicy::ConvertToScore(dist) : DBL_MAX;
+  if (statistics)
+    statistics->RecordScore(referenceNode, newScore);
+
+  return newScore;
 }
 
 template<typename SortPolicy, typename DistanceType, typename TreeType>
@@ -182,7 +289,12 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Rescore(
   double bestDistance = candidates[queryIndex].top().first;
   bestDistance = SortPolicy::Relax(bestDistance, epsilon);
 
-  return (SortPolicy::IsBetter(dist, bestDistance)) ? oldScore : DBL_MAX;
+  const double newScore = (SortPolicy::IsBetter(dist, bestDistance)) ?
+      oldScore : DBL_MAX;
+  if (statistics)
+    statistics->RecordRescore(newScore);
+
+  return newScore;
 }
 
 template<typename SortPolicy, typename DistanceType, typename TreeType>
@@ -192,6 +304,21 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Score(
 {
   ++scores; // Count number of Score() calls.
 
+  if (symmetric)
+  {
+    // The traversal info only describes the pairs visited in one direction, so
+    // only the distance between the nodes is used.
+    const double dist = SortPolicy::BestNodeToNodeDistance(&queryNode,
+        &referenceNode);
+    const double newScore = SortPolicy::IsBetter(dist,
+        SymmetricBound(queryNode, referenceNode)) ?
+        SortPolicy::ConvertToScore(dist) : DBL_MAX;
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, newScore);
+
+    return newScore;
+  }
+
   // Update our bound.
   const double bestDistance = CalculateBound(queryNode);
 
@@ -290,6 +417,9 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Score(
       // There isn't any need to set the traversal information because no
       // descendant combinations will be visited, and those are the only
       // combinations that would depend on the traversal information.
+      if (statistics)
+        statistics->RecordScore(queryNode, referenceNode, DBL_MAX);
+
       return DBL_MAX;
     }
   }
@@ -335,13 +465,20 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Score(
     traversalInfo.LastReferenceNode() = &referenceNode;
     traversalInfo.LastScore() = dist;
 
-    return SortPolicy::ConvertToScore(dist);
+    const double newScore = SortPolicy::ConvertToScore(dist);
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, newScore);
+
+    return newScore;
   }
   else
   {
     // There isn't any need to set the traversal information because no
     // descendant combinations will be visited, and those are the only
     // combinations that would depend on the traversal information.
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, DBL_MAX);
+
     return DBL_MAX;
   }
 }
@@ -349,7 +486,7 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Score(
 template<typename SortPolicy, typename DistanceType, typename TreeType>
 inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Rescore(
     TreeType& queryNode,
-    TreeType& /* referenceNode */,
+    TreeType& referenceNode,
     const double oldScore) const
 {
   if (oldScore == DBL_MAX || oldScore == 0.0)
@@ -358,9 +495,15 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::Rescore(
   const double dist = SortPolicy::ConvertToDistance(oldScore);
 
   // Update our bound.
-  const double bestDistance = CalculateBound(queryNode);
+  const double bestDistance = symmetric ?
+      SymmetricBound(queryNode, referenceNode) : CalculateBound(queryNode);
 
-  return (SortPolicy::IsBetter(dist, bestDistance)) ? oldScore : DBL_MAX;
+  const double newScore = (SortPolicy::IsBetter(dist, bestDistance)) ?
+      oldScore : DBL_MAX;
+  if (statistics)
+    statistics->RecordRescore(newScore);
+
+  return newScore;
 }
 
 // Calculate the bound for a given query node in its current state and update
@@ -483,6 +626,19 @@ inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::
     return bestDistance;
 }
 
+// The pair can only be pruned if the points of neither node can get a better
+// candidate from the other node.
+template<typename SortPolicy, typename DistanceType, typename TreeType>
+inline double NeighborSearchRules<SortPolicy, DistanceType, TreeType>::
+    SymmetricBound(TreeType& queryNode, TreeType& referenceNode) const
+{
+  const double queryBound = CalculateBound(queryNode);
+  const double referenceBound = CalculateBound(referenceNode);
+
+  return SortPolicy::IsBetter(queryBound, referenceBound) ? referenceBound :
+      queryBound;
+}
+
 /**
  * Helper function to insert a point into the list of candidate points.
  *
@@ -21,6 +21,8 @@
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/spill_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+#include <mlpack/core/math/intrinsic_dimension.hpp>
 #include "neighbor_search.hpp"
 
 namespace mlpack {
@@ -45,8 +47,12 @@ class NSWrapperBase
   //! Destruct the NSWrapperBase (nothing to do).
   virtual ~NSWrapperBase() { }
 
-  //! Return a reference to the dataset.
+  //! Return a reference to the dataset.  This throws std::logic_error if the
+  //! dataset is held in single precision.
   virtual const arma::mat& Dataset() const = 0;
+  //! Return a reference to the dataset, if it is held in single precision.
+  //! Otherwise, std::logic_error is thrown.
+  virtual const arma::fmat& FloatDataset() const = 0;
 
   //! Get the search mode.
   virtual NeighborSearchMode SearchMode() const = 0;
@@ -58,7 +64,13 @@ class NSWrapperBase
   //! Modify the approximation parameter epsilon.
   virtual double& Epsilon() = 0;
 
-  //! Train the NeighborSearch model with the given parameters.
+  //! Get the collector of traversal statistics (NULL by default).
+  virtual TraversalStatistics* Statistics() const = 0;
+  //! Modify the collector of traversal statistics.
+  virtual TraversalStatistics*& Statistics() = 0;
+
+  //! Train the NeighborSearch model with the given parameters.  The reference
+  //! set is converted to the element type held by the wrapper, if needed.
   virtual void Train(util::Timers& timers,
                      arma::mat&& referenceSet,
                      const size_t leafSize,
@@ -84,20 +96,23 @@ class NSWrapperBase
 };
 
 /**
- * NSWrapper is a wrapper class for most NeighborSearch types.
+ * NSWrapper is a wrapper class for most NeighborSearch types.  The data is held
+ * as `MatType`; data passed through the NSWrapperBase interface is converted to
+ * and from `MatType` as needed.
  */
 template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType = arma::mat,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
+                      MatType>::template SingleTreeTraverser>
 class NSWrapper : public NSWrapperBase
 {
  public:
@@ -117,8 +132,25 @@ class NSWrapper : public NSWrapperBase
   //! polymorphism.
   virtual NSWrapper* Clone() const { return new NSWrapper(*this); }
 
-  //! Get a reference to the reference set.
-  const arma::mat& Dataset() const { return ns.ReferenceSet(); }
+  //! Get a reference to the reference set, if it is held in double precision.
+  const arma::mat& Dataset() const
+  {
+    if constexpr (std::is_same_v<MatType, arma::mat>)
+      return ns.ReferenceSet();
+    else
+      throw std::logic_error("NSWrapper::Dataset(): the reference set is held "
+          "in single precision; use FloatDataset() instead");
+  }
+
+  //! Get a reference to the reference set, if it is held in single precision.
+  const arma::fmat& FloatDataset() const
+  {
+    if constexpr (std::is_same_v<MatType, arma::fmat>)
+      return ns.ReferenceSet();
+    else
+      throw std::logic_error("NSWrapper::FloatDataset(): the reference set is "
+          "not held in single precision; use Dataset() instead");
+  }
 
   //! Get the search mode.
   NeighborSearchMode SearchMode() const { return ns.SearchMode(); }
@@ -130,6 +162,11 @@ class NSWrapper : public NSWrapperBase
   //! Modify epsilon, the approximation parameter.
   double& Epsilon() { return ns.Epsilon(); }
 
+  //! Get the collector of traversal statistics.
+  TraversalStatistics* Statistics() const { return ns.Statistics(); }
+  //! Modify the collector of traversal statistics.
+  TraversalStatistics*& Statistics() { return ns.Statistics(); }
+
   //! Train the model with the given options.  For NSWrapper, we ignore the
   //! extra parameters.
   virtual void Train(util::Timers& timers,
@@ -166,7 +203,7 @@ class NSWrapper : public NSWrapperBase
   // Convenience typedef for the neighbor search type held by this class.
   using NSType = NeighborSearch<SortPolicy,
                                 EuclideanDistance,
-                                arma::mat,
+                                MatType,
                                 TreeType,
                                 DualTreeTraversalType,
                                 SingleTreeTraversalType>;
@@ -184,17 +221,19 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType = arma::mat,
          template<typename RuleType> class DualTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template DualTreeTraverser,
+                      MatType>::template DualTreeTraverser,
          template<typename RuleType> class SingleTreeTraversalType =
              TreeType<EuclideanDistance,
                       NeighborSearchStat<SortPolicy>,
-                      arma::mat>::template SingleTreeTraverser>
+                      MatType>::template SingleTreeTraverser>
 class LeafSizeNSWrapper :
     public NSWrapper<SortPolicy,
                      TreeType,
+                     MatType,
                      DualTreeTraversalType,
                      SingleTreeTraversalType>
 {
@@ -205,6 +244,7 @@ class LeafSizeNSWrapper :
                     const double epsilon) :
       NSWrapper<SortPolicy,
                 TreeType,
+                MatType,
                 DualTreeTraversalType,
                 SingleTreeTraversalType>(searchMode, epsilon)
   {
@@ -248,6 +288,7 @@ class LeafSizeNSWrapper :
  protected:
   using NSWrapper<SortPolicy,
                   TreeType,
+                  MatType,
                   DualTreeTraversalType,
                   SingleTreeTraversalType>::ns;
 };
@@ -256,17 +297,18 @@ class LeafSizeNSWrapper :
  * The SpillNSWrapper class wraps the NeighborSearch class when the spill tree
  * is used.
  */
-template<typename SortPolicy>
+template<typename SortPolicy, typename MatType = arma::mat>
 class SpillNSWrapper :
     public NSWrapper<
         SortPolicy,
         SPTree,
+        MatType,
         SPTree<EuclideanDistance,
                NeighborSearchStat<SortPolicy>,
-               arma::mat>::template DefeatistDualTreeTraverser,
+               MatType>::template DefeatistDualTreeTraverser,
         SPTree<EuclideanDistance,
                NeighborSearchStat<SortPolicy>,
-               arma::mat>::template DefeatistSingleTreeTraverser>
+               MatType>::template DefeatistSingleTreeTraverser>
 {
  public:
   //! Construct the SpillNSWrapper.
@@ -275,12 +317,13 @@ class SpillNSWrapper :
       NSWrapper<
           SortPolicy,
           SPTree,
+          MatType,
           SPTree<EuclideanDistance,
                  NeighborSearchStat<SortPolicy>,
-                 arma::mat>::template DefeatistDualTreeTraverser,
+                 MatType>::template DefeatistDualTreeTraverser,
           SPTree<EuclideanDistance,
                  NeighborSearchStat<SortPolicy>,
-                 arma::mat>::template DefeatistSingleTreeTraverser>(
+                 MatType>::template DefeatistSingleTreeTraverser>(
           searchMode, epsilon)
   {
     // Nothing to do.
@@ -320,12 +363,13 @@ class SpillNSWrapper :
   using NSWrapper<
       SortPolicy,
       SPTree,
+      MatType,
       SPTree<EuclideanDistance,
              NeighborSearchStat<SortPolicy>,
-             arma::mat>::template DefeatistDualTreeTraverser,
+             MatType>::template DefeatistDualTreeTraverser,
       SPTree<EuclideanDistance,
              NeighborSearchStat<SortPolicy>,
-             arma::mat>::template DefeatistSingleTreeTraverser>::ns;
+             MatType>::template DefeatistSingleTreeTraverser>::ns;
 };
 
 /**
@@ -336,6 +380,16 @@ class SpillNSWrapper :
  * flexibility as the NeighborSearch class.  So if you are using it outside of
  * mlpack_knn and mlpack_kfn, be aware that it is limited!
  *
+ * If SinglePrecision() is set before BuildModel() is called, the reference set
+ * and trees are held and searched with single-precision (32-bit) floating
+ * point values, which halves their memory use.  Data is still passed to and
+ * returned from the model in double precision.
+ *
+ * If the tree type is AUTO_TREE, SelectTree() must be called before
+ * BuildModel(): it chooses the tree type, the leaf size and the search mode
+ * from short trial searches on samples of the data.  The choice (and the
+ * estimated intrinsic dimension of the data) is saved with the model.
+ *
  * @tparam SortPolicy The sort policy for distances; see NearestNeighborSort.
  */
 template<typename SortPolicy>
@@ -359,7 +413,9 @@ class NSModel
     MAX_RP_TREE,
     SPILL_TREE,
     UB_TREE,
-    OCTREE
+    OCTREE,
+    //! The tree type is chosen by SelectTree().
+    AUTO_TREE
   };
 
  private:
@@ -368,6 +424,8 @@ class NSModel
 
   //! If true, random projections are used.
   bool randomBasis;
+  //! If true, the reference set is held in single precision.
+  bool singlePrecision;
   //! This is the random projection matrix; only used if randomBasis is true.
   arma::mat q;
 
@@ -375,12 +433,22 @@ class NSModel
   double tau;
   double rho;
 
+  //! If true, the tree type and leaf size were chosen by SelectTree().
+  bool autoSelected;
+  //! The intrinsic dimension of the data estimated by SelectTree() (0 if it
+  //! was not called).
+  double intrinsicDimension;
+
   /**
    * nSearch holds an instance of the NeighborSearch class for the current
    * treeType. It is initialized every time BuildModel is executed.
    */
   NSWrapperBase* nSearch;
 
+  //! If the model was loaded with data::LoadMapped(), this holds the mapped
+  //! file that the reference set lives in.
+  std::shared_ptr<data::MappedFile> mapping;
+
  public:
   /**
    * Initialize the NSModel with the given type and whether or not a random
@@ -425,10 +493,23 @@ class NSModel
 
   //! Serialize the neighbor search model.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
-  //! Expose the dataset.
+  //! Expose the dataset, if it is held in double precision.
   const arma::mat& Dataset() const;
+  //! Expose the dataset, if it is held in single precision.
+  const arma::fmat& FloatDataset() const;
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const;
+  //! Get the number of points in the reference set.
+  size_t NumReferencePoints() const;
+
+  //! Get the mapped file holding the reference set, if any (see
+  //! data::LoadMapped()).
+  const std::shared_ptr<data::MappedFile>& Mapping() const { return mapping; }
+  //! Modify the mapped file holding the reference set.
+  std::shared_ptr<data::MappedFile>& Mapping() { return mapping; }
 
   //! Expose SearchMode.
   NeighborSearchMode SearchMode() const;
@@ -450,6 +531,11 @@ class NSModel
   double Epsilon() const;
   double& Epsilon();
 
+  //! Expose the collector of traversal statistics.  BuildModel() and
+  //! InitializeModel() reset it to NULL, so set it after the model is built.
+  TraversalStatistics* Statistics() const;
+  TraversalStatistics*& Statistics();
+
   //! Expose treeType.
   TreeTypes TreeType() const { return treeType; }
   TreeTypes& TreeType() { return treeType; }
@@ -458,6 +544,48 @@ class NSModel
   bool RandomBasis() const { return randomBasis; }
   bool& RandomBasis() { return randomBasis; }
 
+  //! Get whether the tree type and leaf size were chosen by SelectTree().
+  bool AutoSelected() const { return autoSelected; }
+  //! Get the intrinsic dimension of the data estimated by SelectTree() (0 if
+  //! it was not called).
+  double IntrinsicDimension() const { return intrinsicDimension; }
+
+  //! Expose singlePrecision.  Setting this only takes effect the next time
+  //! BuildModel() is called.
+  bool SinglePrecision() const { return singlePrecision; }
+  bool& SinglePrecision() { return singlePrecision; }
+
+  /**
+   * Choose the tree type, the leaf size and the search mode (single-tree or
+   * dual-tree) for the given data, and set the tree type and leaf size of the
+   * model; the search mode to pass to BuildModel() is returned.  Up to 5000
+   * reference points and up to 1000 query points are sampled, their
+   * intrinsic dimension is estimated (see EstimateIntrinsicDimension()), and
+   * for each candidate tree type and leaf size, a tree is built on the
+   * reference sample and both search modes are timed for the query sample.
+   * The fastest combination is chosen.
+   *
+   * The candidates are kd-trees and ball trees, octrees if there are at most
+   * 4 dimensions, and cover trees, vantage point trees and max-split random
+   * projection trees if there are more than 10 dimensions or the intrinsic
+   * dimension is less than half of the dimensionality; the leaf sizes 10, 20
+   * and 40 are tried.  Timing makes the choice depend on the machine; it is a
+   * heuristic, since the samples are much smaller than large datasets.
+   *
+   * @param timers Timers; the time is recorded as "selecting_tree".
+   * @param referenceSet Reference set that will be passed to BuildModel().
+   * @param querySet Query set that will be searched (empty for monochromatic
+   *     search).
+   * @param k Number of neighbors that will be searched for.
+   * @param epsilon Relative error of the search.
+   * @return The chosen search mode.
+   */
+  NeighborSearchMode SelectTree(util::Timers& timers,
+                                const arma::mat& referenceSet,
+                                const arma::mat& querySet,
+                                const size_t k,
+                                const double epsilon = 0);
+
   //! Initialize the model type.  (This does not perform any training.)
   void InitializeModel(const NeighborSearchMode searchMode,
                        const double epsilon);
@@ -483,10 +611,25 @@ class NSModel
 
   //! Return a string representation of the current tree type.
   std::string TreeName() const;
+
+ private:
+  //! Create the wrapper for the current tree type that holds its data as
+  //! `MatType`.
+  template<typename MatType>
+  NSWrapperBase* CreateWrapper(const NeighborSearchMode searchMode,
+                               const double epsilon) const;
+
+  //! Serialize the wrapper for the current tree type that holds its data as
+  //! `MatType`.
+  template<typename MatType, typename Archive>
+  void SerializeWrapper(Archive& ar);
 };
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename SortPolicy),
+    (mlpack::NSModel<SortPolicy>), (2));
+
 // Include implementation.
 #include "ns_model_impl.hpp"
 
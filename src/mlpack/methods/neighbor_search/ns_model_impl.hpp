@@ -26,20 +26,25 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Train(util::Timers& timers,
          arma::mat&& referenceSet,
          const size_t /* leafSize */,
          const double /* tau */,
          const double /* rho */)
 {
+  MatType typedReferenceSet;
+  MoveOrConvert(referenceSet, typedReferenceSet);
+
   if (ns.SearchMode() != NAIVE_MODE)
     timers.Start("tree_building");
 
-  ns.Train(std::move(referenceSet));
+  ns.Train(std::move(typedReferenceSet));
 
   if (ns.SearchMode() != NAIVE_MODE)
     timers.Stop("tree_building");
@@ -51,10 +56,12 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           arma::mat&& querySet,
           const size_t k,
@@ -63,23 +70,29 @@ void NSWrapper<
           const size_t /* leafSize */,
           const double /* rho */)
 {
+  MatType typedQuerySet;
+  MoveOrConvert(querySet, typedQuerySet);
+  arma::Mat<typename MatType::elem_type> typedDistances;
+
   if (ns.SearchMode() == DUAL_TREE_MODE)
   {
     // We build the query tree manually, so that we can time how long it takes.
     timers.Start("tree_building");
-    typename decltype(ns)::Tree queryTree(std::move(querySet));
+    typename decltype(ns)::Tree queryTree(std::move(typedQuerySet));
     timers.Stop("tree_building");
 
     timers.Start("computing_neighbors");
-    ns.Search(queryTree, k, neighbors, distances);
+    ns.Search(queryTree, k, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
   }
   else
   {
     timers.Start("computing_neighbors");
-    ns.Search(std::move(querySet), k, neighbors, distances);
+    ns.Search(std::move(typedQuerySet), k, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
   }
+
+  MoveOrConvert(typedDistances, distances);
 }
 
 //! Perform monochromatic neighbor search (i.e. use the reference set as the
@@ -88,18 +101,24 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void NSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           const size_t k,
           arma::Mat<size_t>& neighbors,
           arma::mat& distances)
 {
+  arma::Mat<typename MatType::elem_type> typedDistances;
+
   timers.Start("computing_neighbors");
-  ns.Search(k, neighbors, distances);
+  ns.Search(k, neighbors, typedDistances);
   timers.Stop("computing_neighbors");
+
+  MoveOrConvert(typedDistances, distances);
 }
 
 //! Train a model with the given parameters.  This overload uses leafSize but
@@ -108,26 +127,31 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Train(util::Timers& timers,
          arma::mat&& referenceSet,
          const size_t leafSize,
          const double /* tau */,
          const double /* rho */)
 {
+  MatType typedReferenceSet;
+  MoveOrConvert(referenceSet, typedReferenceSet);
+
   if (ns.SearchMode() == NAIVE_MODE)
   {
-    ns.Train(std::move(referenceSet));
+    ns.Train(std::move(typedReferenceSet));
   }
   else
   {
     // Build the tree with the specified leaf size.
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewReferences;
-    typename decltype(ns)::Tree referenceTree(std::move(referenceSet),
+    typename decltype(ns)::Tree referenceTree(std::move(typedReferenceSet),
         oldFromNewReferences, leafSize);
     ns.Train(std::move(referenceTree));
     ns.oldFromNewReferences = std::move(oldFromNewReferences);
@@ -141,10 +165,12 @@ template<typename SortPolicy,
          template<typename TreeDistanceType,
                   typename TreeStatType,
                   typename TreeMatType> class TreeType,
+         typename MatType,
          template<typename RuleType> class DualTreeTraversalType,
          template<typename RuleType> class SingleTreeTraversalType>
 void LeafSizeNSWrapper<
-    SortPolicy, TreeType, DualTreeTraversalType, SingleTreeTraversalType
+    SortPolicy, TreeType, MatType, DualTreeTraversalType,
+    SingleTreeTraversalType
 >::Search(util::Timers& timers,
           arma::mat&& querySet,
           const size_t k,
@@ -153,6 +179,9 @@ void LeafSizeNSWrapper<
           const size_t leafSize,
           const double /* rho */)
 {
+  MatType typedQuerySet;
+  MoveOrConvert(querySet, typedQuerySet);
+
   if (ns.SearchMode() == DUAL_TREE_MODE)
   {
     // We actually have to do the mapping of query points ourselves, since the
@@ -161,12 +190,12 @@ void LeafSizeNSWrapper<
     // query tree manually.)
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewQueries;
-    typename decltype(ns)::Tree queryTree(std::move(querySet),
+    typename decltype(ns)::Tree queryTree(std::move(typedQuerySet),
         oldFromNewQueries, leafSize);
     timers.Stop("tree_building");
 
     arma::Mat<size_t> neighborsOut;
-    arma::mat distancesOut;
+    arma::Mat<typename MatType::elem_type> distancesOut;
     timers.Start("computing_neighbors");
     ns.Search(queryTree, k, neighborsOut, distancesOut);
     timers.Stop("computing_neighbors");
@@ -177,27 +206,35 @@ void LeafSizeNSWrapper<
     for (size_t i = 0; i < neighborsOut.n_cols; ++i)
     {
       neighbors.col(oldFromNewQueries[i]) = neighborsOut.col(i);
-      distances.col(oldFromNewQueries[i]) = distancesOut.col(i);
+      distances.col(oldFromNewQueries[i]) =
+          ConvTo<arma::vec>::From(distancesOut.col(i));
     }
   }
   else
   {
+    arma::Mat<typename MatType::elem_type> typedDistances;
+
     timers.Start("computing_neighbors");
-    ns.Search(querySet, k, neighbors, distances);
+    ns.Search(typedQuerySet, k, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
+
+    MoveOrConvert(typedDistances, distances);
   }
 }
 
 //! Train the model using the given parameters.
-template<typename SortPolicy>
-void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
-                                       arma::mat&& referenceSet,
-                                       const size_t leafSize,
-                                       const double tau,
-                                       const double rho)
+template<typename SortPolicy, typename MatType>
+void SpillNSWrapper<SortPolicy, MatType>::Train(util::Timers& timers,
+                                                arma::mat&& referenceSet,
+                                                const size_t leafSize,
+                                                const double tau,
+                                                const double rho)
 {
+  MatType typedReferenceSet;
+  MoveOrConvert(referenceSet, typedReferenceSet);
+
   timers.Start("tree_building");
-  typename decltype(ns)::Tree tree(std::move(referenceSet), tau, leafSize,
+  typename decltype(ns)::Tree tree(std::move(typedReferenceSet), tau, leafSize,
       rho);
   timers.Stop("tree_building");
 
@@ -206,34 +243,40 @@ void SpillNSWrapper<SortPolicy>::Train(util::Timers& timers,
 
 //! Perform bichromatic search (i.e. search with a different query set) using
 //! the given parameters.
-template<typename SortPolicy>
-void SpillNSWrapper<SortPolicy>::Search(util::Timers& timers,
-                                        arma::mat&& querySet,
-                                        const size_t k,
-                                        arma::Mat<size_t>& neighbors,
-                                        arma::mat& distances,
-                                        const size_t leafSize,
-                                        const double rho)
+template<typename SortPolicy, typename MatType>
+void SpillNSWrapper<SortPolicy, MatType>::Search(util::Timers& timers,
+                                                 arma::mat&& querySet,
+                                                 const size_t k,
+                                                 arma::Mat<size_t>& neighbors,
+                                                 arma::mat& distances,
+                                                 const size_t leafSize,
+                                                 const double rho)
 {
+  MatType typedQuerySet;
+  MoveOrConvert(querySet, typedQuerySet);
+  arma::Mat<typename MatType::elem_type> typedDistances;
+
   if (ns.SearchMode() == DUAL_TREE_MODE)
   {
     // For Dual Tree Search on SpillTrees, the queryTree must be built with
     // non overlapping (tau = 0).
     timers.Start("tree_building");
-    typename decltype(ns)::Tree queryTree(std::move(querySet), 0 /* tau */,
-        leafSize, rho);
+    typename decltype(ns)::Tree queryTree(std::move(typedQuerySet),
+        0 /* tau */, leafSize, rho);
     timers.Stop("tree_building");
 
     timers.Start("computing_neighbors");
-    ns.Search(queryTree, k, neighbors, distances);
+    ns.Search(queryTree, k, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
   }
   else
   {
     timers.Start("computing_neighbors");
-    ns.Search(querySet, k, neighbors, distances);
+    ns.Search(typedQuerySet, k, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
   }
+
+  MoveOrConvert(typedDistances, distances);
 }
 
 /**
@@ -244,9 +287,12 @@ template<typename SortPolicy>
 NSModel<SortPolicy>::NSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     randomBasis(randomBasis),
+    singlePrecision(false),
     leafSize(20),
     tau(0.0),
     rho(0.7),
+    autoSelected(false),
+    intrinsicDimension(0.0),
     nSearch(NULL)
 {
   // Nothing to do.
@@ -256,11 +302,15 @@ template<typename SortPolicy>
 NSModel<SortPolicy>::NSModel(const NSModel& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
+    singlePrecision(other.singlePrecision),
     q(other.q),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
-    nSearch(other.nSearch->Clone())
+    autoSelected(other.autoSelected),
+    intrinsicDimension(other.intrinsicDimension),
+    nSearch(other.nSearch->Clone()),
+    mapping(other.mapping)
 {
   // Nothing to do.
 }
@@ -269,18 +319,25 @@ template<typename SortPolicy>
 NSModel<SortPolicy>::NSModel(NSModel&& other) :
     treeType(other.treeType),
     randomBasis(other.randomBasis),
+    singlePrecision(other.singlePrecision),
     q(std::move(other.q)),
     leafSize(other.leafSize),
     tau(other.tau),
     rho(other.rho),
-    nSearch(other.nSearch)
+    autoSelected(other.autoSelected),
+    intrinsicDimension(other.intrinsicDimension),
+    nSearch(other.nSearch),
+    mapping(std::move(other.mapping))
 {
   // Reset parameters of the other model.
   other.treeType = TreeTypes::KD_TREE;
   other.randomBasis = false;
+  other.singlePrecision = false;
   other.leafSize = 20;
   other.tau = 0.0;
   other.rho = 0.7;
+  other.autoSelected = false;
+  other.intrinsicDimension = 0.0;
   other.nSearch = NULL;
 }
 
@@ -293,11 +350,15 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(const NSModel& other)
 
     treeType = other.treeType;
     randomBasis = other.randomBasis;
+    singlePrecision = other.singlePrecision;
     q = other.q;
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
+    autoSelected = other.autoSelected;
+    intrinsicDimension = other.intrinsicDimension;
     nSearch = other.nSearch->Clone();
+    mapping = other.mapping;
   }
 
   return *this;
@@ -312,18 +373,25 @@ NSModel<SortPolicy>& NSModel<SortPolicy>::operator=(NSModel&& other)
 
     treeType = other.treeType;
     randomBasis = other.randomBasis;
+    singlePrecision = other.singlePrecision;
     q = std::move(other.q);
     leafSize = other.leafSize;
     tau = other.tau;
     rho = other.rho;
+    autoSelected = other.autoSelected;
+    intrinsicDimension = other.intrinsicDimension;
     nSearch = other.nSearch;
+    mapping = std::move(other.mapping);
 
     // Reset parameters of the other model.
     other.treeType = TreeTypes::KD_TREE;
     other.randomBasis = false;
+    other.singlePrecision = false;
     other.leafSize = 20;
     other.tau = 0.0;
     other.rho = 0.7;
+    other.autoSelected = false;
+    other.intrinsicDimension = 0.0;
     other.nSearch = NULL;
   }
 
@@ -340,7 +408,7 @@ NSModel<SortPolicy>::~NSModel()
 //! Serialize the kNN model.
 template<typename SortPolicy>
 template<typename Archive>
-void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
+void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
@@ -349,118 +417,152 @@ void NSModel<SortPolicy>::serialize(Archive& ar, const uint32_t /* version */)
   ar(CEREAL_NVP(tau));
   ar(CEREAL_NVP(rho));
 
+  // Models saved before single precision was supported always hold their
+  // reference set in double precision.
+  if (cereal::is_loading<Archive>() && version == 0)
+    singlePrecision = false;
+  else
+    ar(CEREAL_NVP(singlePrecision));
+
+  // Models saved before automatic tree selection was supported never used it.
+  if (cereal::is_loading<Archive>() && version < 2)
+  {
+    autoSelected = false;
+    intrinsicDimension = 0.0;
+  }
+  else
+  {
+    ar(CEREAL_NVP(autoSelected));
+    ar(CEREAL_NVP(intrinsicDimension));
+  }
+
   // This should never happen, but just in case, be clean with memory.
   if (cereal::is_loading<Archive>())
     InitializeModel(DUAL_TREE_MODE, 0.0); // Values will be overwritten.
 
+  if (singlePrecision)
+    SerializeWrapper<arma::fmat>(ar);
+  else
+    SerializeWrapper<arma::mat>(ar);
+}
+
+//! Serialize the wrapper for the current tree type.
+template<typename SortPolicy>
+template<typename MatType, typename Archive>
+void NSModel<SortPolicy>::SerializeWrapper(Archive& ar)
+{
   // Avoid polymorphic serialization by explicitly serializing the correct type.
   switch (treeType)
   {
     case KD_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, KDTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, KDTree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, KDTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case COVER_TREE:
       {
-        NSWrapper<SortPolicy, StandardCoverTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, StandardCoverTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, StandardCoverTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_TREE:
       {
-        NSWrapper<SortPolicy, RTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, RTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_STAR_TREE:
       {
-        NSWrapper<SortPolicy, RStarTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RStarTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, RStarTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case BALL_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, BallTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, BallTree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, BallTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case X_TREE:
       {
-        NSWrapper<SortPolicy, XTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, XTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, XTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case HILBERT_R_TREE:
       {
-        NSWrapper<SortPolicy, HilbertRTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, HilbertRTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, HilbertRTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_PLUS_TREE:
       {
-        NSWrapper<SortPolicy, RPlusTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RPlusTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, RPlusTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case R_PLUS_PLUS_TREE:
       {
-        NSWrapper<SortPolicy, RPlusPlusTree>& typedSearch =
-            dynamic_cast<NSWrapper<SortPolicy, RPlusPlusTree>&>(*nSearch);
+        using WrapperType = NSWrapper<SortPolicy, RPlusPlusTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case SPILL_TREE:
       {
-        SpillNSWrapper<SortPolicy>& typedSearch =
-            dynamic_cast<SpillNSWrapper<SortPolicy>&>(*nSearch);
+        using WrapperType = SpillNSWrapper<SortPolicy, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case VP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, VPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, VPTree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, VPTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case RP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, RPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, RPTree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, RPTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case MAX_RP_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, MaxRPTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, MaxRPTree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, MaxRPTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case UB_TREE:
       {
-        LeafSizeNSWrapper<SortPolicy, UBTree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, UBTree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, UBTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
     case OCTREE:
       {
-        LeafSizeNSWrapper<SortPolicy, Octree>& typedSearch =
-            dynamic_cast<LeafSizeNSWrapper<SortPolicy, Octree>&>(*nSearch);
+        using WrapperType = LeafSizeNSWrapper<SortPolicy, Octree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*nSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+    case AUTO_TREE:
+      // A model is never built (or loaded) with this tree type; see
+      // CreateWrapper().
+      break;
   }
 }
 
@@ -471,6 +573,27 @@ const arma::mat& NSModel<SortPolicy>::Dataset() const
   return nSearch->Dataset();
 }
 
+//! Expose the dataset, if it is held in single precision.
+template<typename SortPolicy>
+const arma::fmat& NSModel<SortPolicy>::FloatDataset() const
+{
+  return nSearch->FloatDataset();
+}
+
+//! Get the dimensionality of the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::Dimensionality() const
+{
+  return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+}
+
+//! Get the number of points in the reference set.
+template<typename SortPolicy>
+size_t NSModel<SortPolicy>::NumReferencePoints() const
+{
+  return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
+}
+
 //! Access the search mode.
 template<typename SortPolicy>
 NeighborSearchMode NSModel<SortPolicy>::SearchMode() const
@@ -497,6 +620,18 @@ double& NSModel<SortPolicy>::Epsilon()
   return nSearch->Epsilon();
 }
 
+template<typename SortPolicy>
+TraversalStatistics* NSModel<SortPolicy>::Statistics() const
+{
+  return nSearch->Statistics();
+}
+
+template<typename SortPolicy>
+TraversalStatistics*& NSModel<SortPolicy>::Statistics()
+{
+  return nSearch->Statistics();
+}
+
 //! Initialize a model given the tree type.  (No training happens here.)
 template<typename SortPolicy>
 void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
@@ -506,57 +641,67 @@ void NSModel<SortPolicy>::InitializeModel(const NeighborSearchMode searchMode,
   if (nSearch)
     delete nSearch;
 
+  if (singlePrecision)
+    nSearch = CreateWrapper<arma::fmat>(searchMode, epsilon);
+  else
+    nSearch = CreateWrapper<arma::mat>(searchMode, epsilon);
+}
+
+//! Create the wrapper for the current tree type.
+template<typename SortPolicy>
+template<typename MatType>
+NSWrapperBase* NSModel<SortPolicy>::CreateWrapper(
+    const NeighborSearchMode searchMode,
+    const double epsilon) const
+{
   switch (treeType)
   {
     case KD_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, KDTree>(searchMode, epsilon);
-      break;
+      return new LeafSizeNSWrapper<SortPolicy, KDTree, MatType>(searchMode,
+          epsilon);
     case COVER_TREE:
-      nSearch = new NSWrapper<SortPolicy, StandardCoverTree>(searchMode,
+      return new NSWrapper<SortPolicy, StandardCoverTree, MatType>(searchMode,
           epsilon);
-      break;
     case R_TREE:
-      nSearch = new NSWrapper<SortPolicy, RTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, RTree, MatType>(searchMode, epsilon);
     case R_STAR_TREE:
-      nSearch = new NSWrapper<SortPolicy, RStarTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, RStarTree, MatType>(searchMode, epsilon);
     case BALL_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, BallTree>(searchMode,
+      return new LeafSizeNSWrapper<SortPolicy, BallTree, MatType>(searchMode,
           epsilon);
-      break;
     case X_TREE:
-      nSearch = new NSWrapper<SortPolicy, XTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, XTree, MatType>(searchMode, epsilon);
     case HILBERT_R_TREE:
-      nSearch = new NSWrapper<SortPolicy, HilbertRTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, HilbertRTree, MatType>(searchMode,
+          epsilon);
     case R_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, RPlusTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, RPlusTree, MatType>(searchMode, epsilon);
     case R_PLUS_PLUS_TREE:
-      nSearch = new NSWrapper<SortPolicy, RPlusPlusTree>(searchMode, epsilon);
-      break;
+      return new NSWrapper<SortPolicy, RPlusPlusTree, MatType>(searchMode,
+          epsilon);
     case VP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, VPTree>(searchMode, epsilon);
-      break;
+      return new LeafSizeNSWrapper<SortPolicy, VPTree, MatType>(searchMode,
+          epsilon);
     case RP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, RPTree>(searchMode, epsilon);
-      break;
+      return new LeafSizeNSWrapper<SortPolicy, RPTree, MatType>(searchMode,
+          epsilon);
     case MAX_RP_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, MaxRPTree>(searchMode,
+      return new LeafSizeNSWrapper<SortPolicy, MaxRPTree, MatType>(searchMode,
           epsilon);
-      break;
     case SPILL_TREE:
-      nSearch = new SpillNSWrapper<SortPolicy>(searchMode, epsilon);
-      break;
+      return new SpillNSWrapper<SortPolicy, MatType>(searchMode, epsilon);
     case UB_TREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, UBTree>(searchMode, epsilon);
-      break;
+      return new LeafSizeNSWrapper<SortPolicy, UBTree, MatType>(searchMode,
+          epsilon);
     case OCTREE:
-      nSearch = new LeafSizeNSWrapper<SortPolicy, Octree>(searchMode, epsilon);
-      break;
+      return new LeafSizeNSWrapper<SortPolicy, Octree, MatType>(searchMode,
+          epsilon);
+    case AUTO_TREE:
+      throw std::invalid_argument("NSModel::InitializeModel(): the tree type "
+          "must be chosen with SelectTree() before the model is built!");
   }
+
+  return NULL; // This should never happen.
 }
 
 //! Build the reference tree.
@@ -612,6 +757,134 @@ void NSModel<SortPolicy>::BuildModel(util::Timers& timers,
     Log::Info << "Tree built." << std::endl;
 }
 
+//! Choose the tree type, leaf size and search mode with trial searches.
+template<typename SortPolicy>
+NeighborSearchMode NSModel<SortPolicy>::SelectTree(
+    util::Timers& timers,
+    const arma::mat& referenceSet,
+    const arma::mat& querySet,
+    const size_t k,
+    const double epsilon)
+{
+  const bool monochromatic = (querySet.n_cols == 0);
+  if (!monochromatic && querySet.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("NSModel::SelectTree(): the query set has " +
+        std::to_string(querySet.n_rows) + " dimensions, but the reference set "
+        "has " + std::to_string(referenceSet.n_rows) + "!");
+  }
+
+  timers.Start("selecting_tree");
+
+  // Sample the reference and query sets.
+  const size_t referenceSamples = std::min((size_t) referenceSet.n_cols,
+      (size_t) 5000);
+  const arma::mat referenceSample = (referenceSamples == referenceSet.n_cols) ?
+      referenceSet : arma::mat(referenceSet.cols(arma::randperm(
+      referenceSet.n_cols, referenceSamples)));
+  arma::mat querySample;
+  if (!monochromatic)
+  {
+    const size_t querySamples = std::min((size_t) querySet.n_cols,
+        (size_t) 1000);
+    querySample = querySet.cols(arma::randperm(querySet.n_cols,
+        querySamples));
+  }
+
+  const size_t d = referenceSet.n_rows;
+  intrinsicDimension = EstimateIntrinsicDimension(referenceSample);
+  Log::Info << "Estimated intrinsic dimension: " << intrinsicDimension
+      << " (of " << d << " dimensions)." << std::endl;
+
+  std::vector<TreeTypes> candidateTypes = { KD_TREE, BALL_TREE };
+  if (d <= 4)
+    candidateTypes.push_back(OCTREE);
+  if (d > 10 || intrinsicDimension < 0.5 * d)
+  {
+    candidateTypes.push_back(COVER_TREE);
+    candidateTypes.push_back(VP_TREE);
+    candidateTypes.push_back(MAX_RP_TREE);
+  }
+  const size_t candidateLeafSizes[] = { 10, 20, 40 };
+
+  // The trial searches must be valid for the size of the sample.
+  const size_t maxK = monochromatic ? referenceSamples - 1 : referenceSamples;
+  const size_t trialK = std::max(std::min(k, maxK), (size_t) 1);
+
+  TreeTypes bestType = KD_TREE;
+  size_t bestLeafSize = leafSize;
+  NeighborSearchMode bestMode = DUAL_TREE_MODE;
+  double bestTime = DBL_MAX;
+  if (maxK >= 1)
+  {
+    const NeighborSearchMode modes[] = { SINGLE_TREE_MODE, DUAL_TREE_MODE };
+    for (const TreeTypes type : candidateTypes)
+    {
+      for (const size_t candidateLeafSize : candidateLeafSizes)
+      {
+        for (const NeighborSearchMode mode : modes)
+        {
+          NSModel trial(type);
+          trial.singlePrecision = singlePrecision;
+          trial.tau = tau;
+          trial.rho = rho;
+          trial.InitializeModel(mode, epsilon);
+
+          util::Timers trialTimers;
+          arma::Mat<size_t> neighbors;
+          arma::mat distances;
+          const std::chrono::steady_clock::time_point start =
+              std::chrono::steady_clock::now();
+          trial.nSearch->Train(trialTimers, arma::mat(referenceSample),
+              candidateLeafSize, tau, rho);
+          if (monochromatic)
+          {
+            trial.nSearch->Search(trialTimers, trialK, neighbors, distances);
+          }
+          else
+          {
+            trial.nSearch->Search(trialTimers, arma::mat(querySample), trialK,
+                neighbors, distances, candidateLeafSize, rho);
+          }
+          const double time = std::chrono::duration<double>(
+              std::chrono::steady_clock::now() - start).count();
+
+          Log::Info << "Trial " << ((mode == SINGLE_TREE_MODE) ? "single" :
+              "dual") << "-tree search with " << trial.TreeName();
+          if (type != COVER_TREE)
+            Log::Info << " (leaf size " << candidateLeafSize << ")";
+          Log::Info << ": " << time << "s." << std::endl;
+
+          if (time < bestTime)
+          {
+            bestTime = time;
+            bestType = type;
+            bestLeafSize = candidateLeafSize;
+            bestMode = mode;
+          }
+        }
+
+        // The cover tree has no leaf size.
+        if (type == COVER_TREE)
+          break;
+      }
+    }
+  }
+
+  treeType = bestType;
+  leafSize = bestLeafSize;
+  autoSelected = true;
+  timers.Stop("selecting_tree");
+
+  Log::Info << "Selected " << ((bestMode == SINGLE_TREE_MODE) ? "single" :
+      "dual") << "-tree search with " << TreeName();
+  if (treeType != COVER_TREE)
+    Log::Info << " (leaf size " << leafSize << ")";
+  Log::Info << "." << std::endl;
+
+  return bestMode;
+}
+
 //! Perform neighbor search.  The query set will be reordered.
 template<typename SortPolicy>
 void NSModel<SortPolicy>::Search(util::Timers& timers,
@@ -645,6 +918,10 @@ void NSModel<SortPolicy>::Search(util::Timers& timers,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case PARALLEL_SINGLE_TREE_MODE:
+      Log::Info << "parallel single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   nSearch->Search(timers, std::move(querySet), k, neighbors, distances,
@@ -675,6 +952,10 @@ void NSModel<SortPolicy>::Search(util::Timers& timers,
       Log::Info << "greedy single-tree " << TreeName() << " search..."
           << std::endl;
       break;
+    case PARALLEL_SINGLE_TREE_MODE:
+      Log::Info << "parallel single-tree " << TreeName() << " search..."
+          << std::endl;
+      break;
   }
 
   if (Epsilon() != 0 && SearchMode() != NAIVE_MODE)
@@ -720,6 +1001,8 @@ std::string NSModel<SortPolicy>::TreeName() const
       return "UB tree";
     case OCTREE:
       return "octree";
+    case AUTO_TREE:
+      return "automatically selected tree";
     default:
       return "unknown tree";
   }
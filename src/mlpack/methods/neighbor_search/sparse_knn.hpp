@@ -0,0 +1,188 @@
+/**
+ * @file methods/neighbor_search/sparse_knn.hpp
+ *
+ * Definition of SparseKNN, which finds the exact k nearest neighbors of sparse
+ * points (with the Euclidean distance, the cosine similarity, or the inner
+ * product) with an inverted index.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPARSE_KNN_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPARSE_KNN_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+//! The measures of closeness that SparseKNN can search with.
+enum SparseSearchMetric
+{
+  //! The Euclidean distance (smallest first).
+  EUCLIDEAN_SEARCH,
+  //! The cosine similarity; the distances are 1 - similarity.
+  COSINE_SEARCH,
+  //! The inner product; the "distances" are inner products, largest first.
+  INNER_PRODUCT_SEARCH
+};
+
+/**
+ * SparseKNN performs exact k-nearest-neighbor search on sparse data, like
+ * user-feature or TF-IDF vectors, where the trees of NeighborSearch do not
+ * work well (and need dense data).  Every search is reduced to finding the
+ * largest scores
+ *
+ *   s(q, r) = a q^T r + b(r),
+ *
+ * where a = 1 and b(r) = 0 for the inner product, the reference points are
+ * normalized for the cosine similarity, and a = 2 and b(r) = -||r||^2 for the
+ * Euclidean distance (since ||q - r||^2 = ||q||^2 - s(q, r)).
+ *
+ * The products q^T r of a query with all the reference points (a row of the
+ * sparse product of the query set and the reference set) are accumulated term
+ * by term from an inverted index, which holds, for each dimension, the
+ * reference points that are nonzero in it; so only the reference points that
+ * share a nonzero dimension with the query are visited.  The queries are
+ * searched in parallel, each thread with its own dense accumulator.
+ *
+ * The terms of a query are visited by decreasing upper bound on their
+ * contribution to any score (|q_t| times the largest |r_t| of the references),
+ * and, as in MaxScore, once the k best lower bounds on the scores of the
+ * reference points that were already visited are larger than any score that
+ * the remaining terms can give to a reference point that was not visited, the
+ * inverted index is no longer used: the remaining terms are added only to the
+ * visited points whose upper bound is still competitive, directly from their
+ * (sorted) sparse columns.  This never changes the results.
+ *
+ * Ties are broken by the index of the reference point.
+ *
+ * @code
+ * arma::sp_mat referenceSet = ...;
+ * SparseKNN<> knn(referenceSet, COSINE_SEARCH);
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * knn.Search(querySet, 5, neighbors, distances);
+ * @endcode
+ *
+ * @tparam MatType Type of sparse matrix (e.g. arma::sp_mat or arma::sp_fmat).
+ */
+template<typename MatType = arma::sp_mat>
+class SparseKNN
+{
+ public:
+  //! The element type of the data.
+  using ElemType = typename MatType::elem_type;
+
+  /**
+   * Create the object without a reference set; Train() must be called before
+   * searching.
+   *
+   * @param metric Measure of closeness to search with.
+   */
+  SparseKNN(const SparseSearchMetric metric = EUCLIDEAN_SEARCH);
+
+  /**
+   * Create the object with the given reference set.
+   *
+   * @param referenceSet Set of reference points (one per column).
+   * @param metric Measure of closeness to search with.
+   */
+  SparseKNN(MatType referenceSet,
+            const SparseSearchMetric metric = EUCLIDEAN_SEARCH);
+
+  /**
+   * Set the reference set and build the inverted index.  Use std::move() to
+   * avoid a copy.
+   *
+   * @param referenceSet Set of reference points (one per column).
+   */
+  void Train(MatType referenceSet);
+
+  /**
+   * Find the k nearest neighbors in the reference set of each point of the
+   * query set.  Column i of `neighbors` and `distances` holds the indices of
+   * and distances to the neighbors of query point i, nearest first (for
+   * INNER_PRODUCT_SEARCH, `distances` holds the inner products, largest
+   * first).
+   *
+   * @param querySet Set of query points (one per column).
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  /**
+   * Find the k nearest neighbors of each point of the reference set, other
+   * than the point itself.
+   *
+   * @param k Number of neighbors to find.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  //! Get the reference set (normalized, for COSINE_SEARCH).
+  const MatType& ReferenceSet() const { return referenceSet; }
+
+  //! Get the measure of closeness to search with.
+  SparseSearchMetric Metric() const { return metric; }
+
+  //! Get whether the inverted index is pruned during the search.
+  bool Pruning() const { return pruning; }
+  //! Modify whether the inverted index is pruned during the search.
+  bool& Pruning() { return pruning; }
+
+  //! Serialize the model.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Build the inverted index and the offsets of the scores.
+  void BuildIndex();
+
+  /**
+   * Search for the neighbors of the given query set.  If `monochromatic` is
+   * true, the query set is the reference set, and each point is not its own
+   * neighbor.  The scores of the neighbors are stored in `scores`.
+   */
+  void SearchInternal(const MatType& querySet,
+                      const size_t k,
+                      const bool monochromatic,
+                      arma::Mat<size_t>& neighbors,
+                      arma::Mat<ElemType>& scores) const;
+
+  //! Convert the scores of the neighbors of the given queries to distances.
+  void ScoresToDistances(const MatType& querySet,
+                         arma::Mat<ElemType>& distances) const;
+
+  //! The reference set.
+  MatType referenceSet;
+  //! The measure of closeness.
+  SparseSearchMetric metric;
+  //! Whether to prune the inverted index.
+  bool pruning;
+
+  //! The inverted index: the transpose of the reference set.
+  MatType invertedIndex;
+  //! The largest absolute value of each dimension of the reference set.
+  arma::Col<ElemType> termBounds;
+  //! The term b(r) of the score of each reference point.
+  arma::Col<ElemType> offsets;
+  //! The reference points by decreasing offset (then by index).
+  arma::uvec offsetOrder;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "sparse_knn_impl.hpp"
+
+#endif
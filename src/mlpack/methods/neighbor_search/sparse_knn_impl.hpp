@@ -0,0 +1,373 @@
+/**
+ * @file methods/neighbor_search/sparse_knn_impl.hpp
+ *
+ * Implementation of SparseKNN.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_NEIGHBOR_SEARCH_SPARSE_KNN_IMPL_HPP
+#define MLPACK_METHODS_NEIGHBOR_SEARCH_SPARSE_KNN_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "sparse_knn.hpp"
+
+namespace mlpack {
+
+namespace detail {
+
+//! Compute the squared norm of each column of the given sparse matrix.
+template<typename MatType>
+arma::Col<typename MatType::elem_type> SparseSquaredNorms(const MatType& data)
+{
+  data.sync();
+  arma::Col<typename MatType::elem_type> norms(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    typename MatType::elem_type norm = 0;
+    for (size_t j = data.col_ptrs[i]; j < data.col_ptrs[i + 1]; ++j)
+      norm += data.values[j] * data.values[j];
+    norms[i] = norm;
+  }
+
+  return norms;
+}
+
+} // namespace detail
+
+template<typename MatType>
+SparseKNN<MatType>::SparseKNN(const SparseSearchMetric metric) :
+    metric(metric),
+    pruning(true)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+SparseKNN<MatType>::SparseKNN(MatType referenceSetIn,
+                              const SparseSearchMetric metric) :
+    metric(metric),
+    pruning(true)
+{
+  Train(std::move(referenceSetIn));
+}
+
+template<typename MatType>
+void SparseKNN<MatType>::Train(MatType referenceSetIn)
+{
+  referenceSet = std::move(referenceSetIn);
+  BuildIndex();
+}
+
+template<typename MatType>
+void SparseKNN<MatType>::Search(const MatType& querySet,
+                                const size_t k,
+                                arma::Mat<size_t>& neighbors,
+                                arma::Mat<ElemType>& distances) const
+{
+  if (querySet.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("SparseKNN::Search(): dimensionality of "
+        "query set (" + std::to_string(querySet.n_rows) + ") is not equal to "
+        "the dimensionality of the reference set (" +
+        std::to_string(referenceSet.n_rows) + ")!");
+  }
+
+  SearchInternal(querySet, k, false, neighbors, distances);
+  ScoresToDistances(querySet, distances);
+}
+
+template<typename MatType>
+void SparseKNN<MatType>::Search(const size_t k,
+                                arma::Mat<size_t>& neighbors,
+                                arma::Mat<ElemType>& distances) const
+{
+  SearchInternal(referenceSet, k, true, neighbors, distances);
+  ScoresToDistances(referenceSet, distances);
+}
+
+template<typename MatType>
+template<typename Archive>
+void SparseKNN<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(referenceSet));
+  ar(CEREAL_NVP(metric));
+  ar(CEREAL_NVP(pruning));
+
+  if (cereal::is_loading<Archive>())
+    BuildIndex();
+}
+
+template<typename MatType>
+void SparseKNN<MatType>::BuildIndex()
+{
+  if (metric == COSINE_SEARCH)
+  {
+    // Normalize the reference points; zero points stay zero.
+    const arma::Col<ElemType> norms = arma::sqrt(
+        detail::SparseSquaredNorms(referenceSet));
+    for (typename MatType::iterator it = referenceSet.begin();
+         it != referenceSet.end(); ++it)
+      (*it) /= norms[it.col()];
+  }
+
+  referenceSet.sync();
+  invertedIndex = referenceSet.t();
+  invertedIndex.sync();
+
+  termBounds.zeros(referenceSet.n_rows);
+  for (size_t t = 0; t < referenceSet.n_rows; ++t)
+  {
+    for (size_t j = invertedIndex.col_ptrs[t];
+         j < invertedIndex.col_ptrs[t + 1]; ++j)
+    {
+      termBounds[t] = std::max(termBounds[t],
+          std::abs(invertedIndex.values[j]));
+    }
+  }
+
+  if (metric == EUCLIDEAN_SEARCH)
+    offsets = -detail::SparseSquaredNorms(referenceSet);
+  else
+    offsets.zeros(referenceSet.n_cols);
+
+  offsetOrder = arma::stable_sort_index(offsets, "descend");
+}
+
+template<typename MatType>
+void SparseKNN<MatType>::SearchInternal(const MatType& querySet,
+                                        const size_t k,
+                                        const bool monochromatic,
+                                        arma::Mat<size_t>& neighbors,
+                                        arma::Mat<ElemType>& scores) const
+{
+  const size_t numReferences = referenceSet.n_cols;
+  const size_t numCandidates = numReferences - (monochromatic ? 1 : 0);
+  if (k > numCandidates || (monochromatic && numReferences == 0))
+  {
+    throw std::invalid_argument("SparseKNN::Search(): requested value of "
+        "k (" + std::to_string(k) + ") is greater than the number of "
+        "candidate reference points (" + std::to_string(numCandidates) +
+        ")!");
+  }
+
+  const size_t numQueries = querySet.n_cols;
+  neighbors.set_size(k, numQueries);
+  scores.set_size(k, numQueries);
+  if (k == 0)
+    return;
+
+  // The score of reference point r is a q^T r + offsets[r].
+  const ElemType a = (metric == EUCLIDEAN_SEARCH) ? 2 : 1;
+  const ElemType maxOffset = offsets.max();
+  querySet.sync();
+
+  #pragma omp parallel
+  {
+    // The products of the current query with the reference points, and the
+    // reference points they are nonzero for.
+    arma::Col<ElemType> products(numReferences, arma::fill::zeros);
+    std::vector<char> visited(numReferences, 0);
+    std::vector<size_t> visitedPoints;
+
+    std::vector<size_t> termOrder;
+    std::vector<ElemType> remainingBounds, lowerBounds;
+    std::vector<std::pair<size_t, ElemType>> remainingTerms;
+    std::vector<std::pair<ElemType, size_t>> candidates;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t q = 0; q < numQueries; ++q)
+    {
+      const size_t begin = querySet.col_ptrs[q];
+      const size_t numTerms = querySet.col_ptrs[q + 1] - begin;
+      auto termBound = [&](const size_t j)
+      {
+        return std::abs(querySet.values[begin + j]) *
+            termBounds[querySet.row_indices[begin + j]];
+      };
+
+      // Visit the terms by decreasing bound on their contribution; for each,
+      // remainingBounds holds the sum of the bounds of it and the next terms.
+      termOrder.resize(numTerms);
+      for (size_t j = 0; j < numTerms; ++j)
+        termOrder[j] = j;
+      std::sort(termOrder.begin(), termOrder.end(),
+          [&](const size_t x, const size_t y)
+          { return termBound(x) > termBound(y); });
+
+      remainingBounds.assign(numTerms + 1, 0);
+      for (size_t s = numTerms; s > 0; --s)
+      {
+        remainingBounds[s - 1] = remainingBounds[s] +
+            termBound(termOrder[s - 1]);
+      }
+
+      visitedPoints.clear();
+      size_t stop = numTerms;
+      ElemType threshold = 0;
+      size_t work = 0;
+      for (size_t s = 0; s < numTerms; ++s)
+      {
+        const size_t t = querySet.row_indices[begin + termOrder[s]];
+        const ElemType value = querySet.values[begin + termOrder[s]];
+        const size_t postings = invertedIndex.col_ptrs[t + 1] -
+            invertedIndex.col_ptrs[t];
+
+        // Check whether the points that were not visited can still be among
+        // the k best; the check takes as long as the postings of the visited
+        // points, so it is only done once that much work has been done since
+        // the last check, or before a long list of postings.
+        if (pruning && visitedPoints.size() >= k &&
+            (work >= visitedPoints.size() || postings >= visitedPoints.size()))
+        {
+          work = 0;
+          lowerBounds.clear();
+          for (const size_t r : visitedPoints)
+          {
+            lowerBounds.push_back(a * (products[r] - remainingBounds[s]) +
+                offsets[r]);
+          }
+
+          std::nth_element(lowerBounds.begin(), lowerBounds.begin() + (k - 1),
+              lowerBounds.end(), std::greater<ElemType>());
+          threshold = lowerBounds[k - 1];
+          if (threshold > a * remainingBounds[s] + maxOffset)
+          {
+            stop = s;
+            break;
+          }
+        }
+
+        for (size_t j = invertedIndex.col_ptrs[t];
+             j < invertedIndex.col_ptrs[t + 1]; ++j)
+        {
+          const size_t r = invertedIndex.row_indices[j];
+          if (monochromatic && r == q)
+            continue;
+
+          if (!visited[r])
+          {
+            visited[r] = 1;
+            visitedPoints.push_back(r);
+          }
+          products[r] += value * invertedIndex.values[j];
+        }
+        work += postings;
+      }
+
+      candidates.clear();
+      if (stop < numTerms)
+      {
+        // Add the remaining terms, sorted by dimension, to the visited points
+        // that can still be among the k best.
+        remainingTerms.clear();
+        for (size_t s = stop; s < numTerms; ++s)
+        {
+          remainingTerms.emplace_back(
+              querySet.row_indices[begin + termOrder[s]],
+              querySet.values[begin + termOrder[s]]);
+        }
+        std::sort(remainingTerms.begin(), remainingTerms.end());
+
+        for (const size_t r : visitedPoints)
+        {
+          if (a * (products[r] + remainingBounds[stop]) + offsets[r] <
+              threshold)
+            continue;
+
+          ElemType product = products[r];
+          size_t j = referenceSet.col_ptrs[r];
+          const size_t end = referenceSet.col_ptrs[r + 1];
+          size_t p = 0;
+          while (j < end && p < remainingTerms.size())
+          {
+            if (referenceSet.row_indices[j] < remainingTerms[p].first)
+            {
+              ++j;
+            }
+            else if (referenceSet.row_indices[j] > remainingTerms[p].first)
+            {
+              ++p;
+            }
+            else
+            {
+              product += referenceSet.values[j] * remainingTerms[p].second;
+              ++j;
+              ++p;
+            }
+          }
+
+          candidates.emplace_back(-(a * product + offsets[r]), r);
+        }
+      }
+      else
+      {
+        for (const size_t r : visitedPoints)
+          candidates.emplace_back(-(a * products[r] + offsets[r]), r);
+
+        // The points that were not visited have a zero product, so the best
+        // of them are those with the largest offsets.
+        size_t added = 0;
+        for (size_t i = 0; i < numReferences && added < k; ++i)
+        {
+          const size_t r = offsetOrder[i];
+          if (visited[r] || (monochromatic && r == q))
+            continue;
+
+          candidates.emplace_back(-offsets[r], r);
+          ++added;
+        }
+      }
+
+      std::partial_sort(candidates.begin(), candidates.begin() + k,
+          candidates.end());
+      for (size_t i = 0; i < k; ++i)
+      {
+        scores(i, q) = -candidates[i].first;
+        neighbors(i, q) = candidates[i].second;
+      }
+
+      // Reset the accumulators for the next query.
+      for (const size_t r : visitedPoints)
+      {
+        products[r] = 0;
+        visited[r] = 0;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void SparseKNN<MatType>::ScoresToDistances(
+    const MatType& querySet,
+    arma::Mat<ElemType>& distances) const
+{
+  if (metric == INNER_PRODUCT_SEARCH)
+    return;
+
+  const arma::Col<ElemType> queryNorms = detail::SparseSquaredNorms(querySet);
+  for (size_t q = 0; q < distances.n_cols; ++q)
+  {
+    if (metric == EUCLIDEAN_SEARCH)
+    {
+      // ||q - r||^2 = ||q||^2 - s(q, r).
+      distances.col(q) = arma::sqrt(arma::clamp(queryNorms[q] -
+          distances.col(q), 0, std::numeric_limits<ElemType>::max()));
+    }
+    else
+    {
+      // The reference points are normalized, but not the query points.
+      const ElemType norm = std::sqrt(queryNorms[q]);
+      if (norm > 0)
+        distances.col(q) = 1 - distances.col(q) / norm;
+      else
+        distances.col(q).ones();
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * @file methods/pca/decomposition_policies/covariance_eig_method.hpp
+ *
+ * Implementation of the covariance eigendecomposition policy for PCA, which
+ * accumulates the covariance matrix of the data in one blocked, parallel pass,
+ * so that the data never has to be copied or centered.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_COVARIANCE_EIG_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_COVARIANCE_EIG_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/covariance_accumulator.hpp>
+
+#include "pca_policy_traits.hpp"
+
+namespace mlpack {
+
+/**
+ * Implementation of the covariance eigendecomposition policy.  The covariance
+ * matrix of the data is computed with a CovarianceAccumulator (one pass over
+ * the data, in parallel, with extra memory proportional to the square of the
+ * dimensionality only), and its eigendecomposition gives the components.  The
+ * points are then projected one block at a time.
+ *
+ * When used with the PCA class (and the data is not scaled), the data is not
+ * copied or centered before the decomposition, so this policy has the lowest
+ * peak memory when there are many more points than dimensions.  Because the
+ * eigenvalues are computed from the covariance matrix instead of the data,
+ * small eigenvalues are less accurate than with ExactSVDPolicy.
+ */
+class CovarianceEigPolicy
+{
+ public:
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * eigendecomposition of its covariance matrix.  centeredData does not need
+   * to be centered.
+   *
+   * @param data Data matrix.
+   * @param centeredData Data matrix (centered or not) to decompose.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param * (rank) Rank of the decomposition.
+   */
+  template<typename InMatType, typename MatType, typename VecType>
+  void Apply(const InMatType& /* data */,
+             const MatType& centeredData,
+             MatType& transformedData,
+             VecType& eigVal,
+             MatType& eigvec,
+             const size_t /* rank */)
+  {
+    CovarianceAccumulator<MatType> statistics;
+    statistics.Update(centeredData);
+
+    if (!arma::eig_sym(eigVal, eigvec, statistics.Covariance()))
+    {
+      throw std::runtime_error("CovarianceEigPolicy::Apply(): "
+          "eigendecomposition failed!");
+    }
+
+    // eig_sym() gives the eigenvalues in ascending order, but PCA expects
+    // them in descending order.
+    eigVal = arma::reverse(eigVal);
+    eigvec = arma::fliplr(eigvec);
+
+    // Project the samples to the principals, one block at a time.
+    // transformedData may be the same matrix as centeredData.
+    const typename GetColType<MatType>::type& mean = statistics.Mean();
+    MatType projected(eigvec.n_cols, centeredData.n_cols);
+    MatType block;
+    for (size_t start = 0; start < centeredData.n_cols; start += BlockSize)
+    {
+      const size_t end = std::min(start + BlockSize,
+          (size_t) centeredData.n_cols);
+      block = centeredData.cols(start, end - 1);
+      block.each_col() -= mean;
+      projected.cols(start, end - 1) = eigvec.t() * block;
+    }
+
+    transformedData = std::move(projected);
+  }
+
+ private:
+  //! Number of points that are projected at once.
+  static constexpr size_t BlockSize = 1024;
+};
+
+//! The covariance eigendecomposition policy centers the data itself.
+template<>
+class PCAPolicyTraits<CovarianceEigPolicy>
+{
+ public:
+  static const bool CentersData = true;
+};
+
+} // namespace mlpack
+
+#endif
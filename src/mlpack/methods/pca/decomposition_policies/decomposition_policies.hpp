@@ -12,7 +12,10 @@
 #ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_DECOMPOSITION_POLICIES_HPP
 #define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_DECOMPOSITION_POLICIES_HPP
 
+#include "pca_policy_traits.hpp"
+#include "covariance_eig_method.hpp"
 #include "exact_svd_method.hpp"
+#include "incremental_svd_method.hpp"
 #include "quic_svd_method.hpp"
 #include "randomized_block_krylov_method.hpp"
 #include "randomized_svd_method.hpp"
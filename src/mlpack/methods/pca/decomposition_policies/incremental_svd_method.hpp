@@ -0,0 +1,291 @@
+/**
+ * @file methods/pca/decomposition_policies/incremental_svd_method.hpp
+ *
+ * Implementation of the incremental SVD policy for PCA, which updates the
+ * principal components from blocks of points, so that the data never has to be
+ * held (or centered) in memory all at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_INCREMENTAL_SVD_METHOD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "pca_policy_traits.hpp"
+
+namespace mlpack {
+
+/**
+ * Implementation of the incremental SVD policy, following the sequential
+ * Karhunen-Loeve update of Ross et al. (as used by scikit-learn's
+ * IncrementalPCA).  The data is processed in blocks of at most BlockSize()
+ * points; for each block, the current components (scaled by their singular
+ * values), the centered block, and a correction for the shift of the mean are
+ * stacked into one matrix, whose thin SVD gives the updated components.  Only
+ * the mean, the components and the singular values are kept between blocks.
+ *
+ * When used with the PCA class (and the data is not scaled), the data is not
+ * copied or centered before the decomposition: the policy centers each block
+ * itself.  The policy can also be fed directly with Update(), for instance with
+ * the blocks of a data::MatrixReader, and then used to Transform() new points:
+ *
+ * @code
+ * IncrementalSVDPolicy ipca(100000, 64);
+ * data::MatrixReader reader("embeddings.bin", 100000);
+ * arma::mat block;
+ * while (reader.Next(block))
+ *   ipca.Update(block);
+ *
+ * arma::mat reduced;
+ * ipca.Transform(newPoints, reduced);
+ * @endcode
+ *
+ * If a rank is given, only that many components are kept between blocks, and
+ * the result is an approximation; otherwise (rank 0) the decomposition is
+ * exact up to floating-point error.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{ross2008incremental,
+ *   title   = {Incremental Learning for Robust Visual Tracking},
+ *   author  = {Ross, David A. and Lim, Jongwoo and Lin, Ruei-Sung and
+ *              Yang, Ming-Hsuan},
+ *   journal = {International Journal of Computer Vision},
+ *   volume  = {77},
+ *   number  = {1--3},
+ *   pages   = {125--141},
+ *   year    = {2008}
+ * }
+ * @endcode
+ */
+class IncrementalSVDPolicy
+{
+ public:
+  /**
+   * Create the incremental SVD policy.
+   *
+   * @param blockSize Maximum number of points in each update.
+   * @param rank Number of components to keep between updates; 0 keeps all of
+   *     them.
+   */
+  IncrementalSVDPolicy(const size_t blockSize = 1000, const size_t rank = 0) :
+      blockSize(blockSize),
+      rank(rank),
+      count(0),
+      totalVariance(0.0)
+  {
+    if (blockSize == 0)
+    {
+      throw std::invalid_argument("IncrementalSVDPolicy::"
+          "IncrementalSVDPolicy(): blockSize must be greater than 0!");
+    }
+  }
+
+  /**
+   * Apply Principal Component Analysis to the provided data set using the
+   * incremental SVD.  Any previous updates are discarded.  centeredData does
+   * not need to be centered.
+   *
+   * @param data Data matrix.
+   * @param centeredData Data matrix (centered or not) to decompose.
+   * @param transformedData Matrix to put results of PCA into.
+   * @param eigVal Vector to put eigenvalues into.
+   * @param eigvec Matrix to put eigenvectors (loadings) into.
+   * @param * (rank) Rank of the decomposition.
+   */
+  template<typename InMatType, typename MatType, typename VecType>
+  void Apply(const InMatType& /* data */,
+             const MatType& centeredData,
+             MatType& transformedData,
+             VecType& eigVal,
+             MatType& eigvec,
+             const size_t /* rank */)
+  {
+    Reset();
+    Update(centeredData);
+
+    eigVal = arma::conv_to<VecType>::from(EigenValues());
+    eigvec = arma::conv_to<MatType>::from(components);
+
+    // Project the samples to the principals.  transformedData may be the same
+    // matrix as centeredData.
+    Transform(centeredData, transformedData);
+  }
+
+  /**
+   * Update the decomposition with the given points.  The points are processed
+   * in blocks of at most BlockSize() points, and must have the dimensionality
+   * of the points given before.
+   *
+   * @param data Points to update the decomposition with.
+   */
+  template<typename MatType>
+  void Update(const MatType& data)
+  {
+    for (size_t start = 0; start < data.n_cols; start += blockSize)
+    {
+      const size_t end = std::min(start + blockSize, (size_t) data.n_cols);
+      UpdateBlock(arma::conv_to<arma::mat>::from(data.cols(start, end - 1)));
+    }
+  }
+
+  /**
+   * Project the given points onto the components, after subtracting the mean
+   * of the points the decomposition was computed on.  It is safe to pass the
+   * same matrix for both data and transformedData.
+   *
+   * @param data Points to project.
+   * @param transformedData Matrix to store the projected points in.
+   */
+  template<typename MatType, typename OutMatType>
+  void Transform(const MatType& data, OutMatType& transformedData) const
+  {
+    OutMatType projected(components.n_cols, data.n_cols);
+    for (size_t start = 0; start < data.n_cols; start += blockSize)
+    {
+      const size_t end = std::min(start + blockSize, (size_t) data.n_cols);
+      arma::mat block = arma::conv_to<arma::mat>::from(
+          data.cols(start, end - 1));
+      block.each_col() -= mean;
+      projected.cols(start, end - 1) = arma::conv_to<OutMatType>::from(
+          components.t() * block);
+    }
+
+    transformedData = std::move(projected);
+  }
+
+  //! Discard all updates.
+  void Reset()
+  {
+    count = 0;
+    totalVariance = 0.0;
+    mean.clear();
+    components.clear();
+    singularValues.clear();
+  }
+
+  /**
+   * Get the eigenvalues of the covariance matrix of the points seen so far
+   * (the variance along each component).
+   */
+  arma::vec EigenValues() const
+  {
+    return arma::square(singularValues) /
+        (double) (std::max(count, (size_t) 2) - 1);
+  }
+
+  //! Get the maximum number of points in each update.
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the maximum number of points in each update.
+  size_t& BlockSize() { return blockSize; }
+
+  //! Get the number of components kept between updates (0 keeps all).
+  size_t Rank() const { return rank; }
+  //! Modify the number of components kept between updates (0 keeps all).
+  size_t& Rank() { return rank; }
+
+  //! Get the number of points seen so far.
+  size_t Count() const { return count; }
+  //! Get the mean of the points seen so far.
+  const arma::vec& Mean() const { return mean; }
+  //! Get the components (one per column).
+  const arma::mat& Components() const { return components; }
+  //! Get the singular values of the centered points seen so far.
+  const arma::vec& SingularValues() const { return singularValues; }
+  //! Get the total variance of the points seen so far (including the variance
+  //! along components that were not kept).
+  double TotalVariance() const
+  {
+    return (count > 1) ? totalVariance / (count - 1) : 0.0;
+  }
+
+ private:
+  //! Update the decomposition with one block of points.
+  void UpdateBlock(const arma::mat& block)
+  {
+    if (block.n_cols == 0)
+      return;
+
+    if (count == 0)
+    {
+      mean.zeros(block.n_rows);
+    }
+    else if (block.n_rows != mean.n_elem)
+    {
+      std::ostringstream oss;
+      oss << "IncrementalSVDPolicy::Update(): points have dimensionality "
+          << block.n_rows << ", but the decomposition has dimensionality "
+          << mean.n_elem << "!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // Stack the scaled components, the centered block, and (if there were
+    // points before) the correction for the shift of the mean.
+    const size_t k = singularValues.n_elem;
+    const size_t m = block.n_cols;
+    const size_t newCount = count + m;
+    const arma::vec blockMean = arma::mean(block, 1);
+    const arma::vec shift = blockMean - mean;
+    const double shiftScale = std::sqrt((double) count * m / newCount);
+
+    arma::mat stacked(block.n_rows, k + m + ((count > 0) ? 1 : 0));
+    if (k > 0)
+    {
+      stacked.cols(0, k - 1) = components.each_row() %
+          singularValues.t();
+    }
+    stacked.cols(k, k + m - 1) = block.each_col() - blockMean;
+    if (count > 0)
+      stacked.col(k + m) = shiftScale * shift;
+
+    totalVariance += arma::accu(arma::square(stacked.cols(k, k + m - 1))) +
+        shiftScale * shiftScale * arma::dot(shift, shift);
+    mean += shift * ((double) m / newCount);
+    count = newCount;
+
+    // Only the left singular vectors are needed.
+    arma::mat u, v;
+    arma::vec s;
+    if (!arma::svd_econ(u, s, v, stacked, 'l'))
+    {
+      throw std::runtime_error("IncrementalSVDPolicy::Update(): SVD "
+          "failed!");
+    }
+
+    const size_t keep = (rank == 0) ? s.n_elem : std::min(rank, s.n_elem);
+    components = u.cols(0, keep - 1);
+    singularValues = s.subvec(0, keep - 1);
+  }
+
+  //! The maximum number of points in each update.
+  size_t blockSize;
+  //! The number of components kept between updates (0 keeps all).
+  size_t rank;
+  //! The number of points seen so far.
+  size_t count;
+  //! The sum of squared deviations from the mean of the points seen so far.
+  double totalVariance;
+  //! The mean of the points seen so far.
+  arma::vec mean;
+  //! The components (one per column).
+  arma::mat components;
+  //! The singular values of the centered points seen so far.
+  arma::vec singularValues;
+};
+
+//! The incremental SVD policy centers the data itself.
+template<>
+class PCAPolicyTraits<IncrementalSVDPolicy>
+{
+ public:
+  static const bool CentersData = true;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,36 @@
+/**
+ * @file methods/pca/decomposition_policies/pca_policy_traits.hpp
+ *
+ * Traits of the decomposition policies of PCA.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_PCA_POLICY_TRAITS_HPP
+#define MLPACK_METHODS_PCA_DECOMPOSITION_POLICIES_PCA_POLICY_TRAITS_HPP
+
+namespace mlpack {
+
+/**
+ * This is a template class that can provide information about a decomposition
+ * policy of PCA.  By default, this class will provide the weakest possible
+ * assumptions on the policy, and each policy should override values as
+ * necessary.  If a policy doesn't need to override a value, then there's no
+ * need to write a PCAPolicyTraits specialization for that class.
+ */
+template<typename DecompositionPolicy>
+class PCAPolicyTraits
+{
+ public:
+  /**
+   * If true, the policy centers the data itself, so PCA passes the data
+   * without making a centered copy of it (unless the data is scaled).
+   */
+  static const bool CentersData = false;
+};
+
+} // namespace mlpack
+
+#endif
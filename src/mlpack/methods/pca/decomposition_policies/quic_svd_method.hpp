@@ -20,7 +20,11 @@
 namespace mlpack {
 
 /**
- * Implementation of the QUIC-SVD policy.
+ * Implementation of the QUIC-SVD policy.  If `warmStart` is true, each call to
+ * Apply() warm-starts the cosine tree from the subspace basis of the previous
+ * call, which is much faster when the data only changes slightly between calls
+ * (e.g. for PCA over a sliding window).  Call ResetBasis() every now and then
+ * to force a cold start, since the basis can only grow with warm starts.
  */
 class QUICSVDPolicy
 {
@@ -30,10 +34,15 @@ class QUICSVDPolicy
    *
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
+   * @param warmStart Whether to warm-start from the basis of the previous
+   *     call to Apply().
    */
-  QUICSVDPolicy(const double epsilon = 0.03, const double delta = 0.1) :
+  QUICSVDPolicy(const double epsilon = 0.03,
+                const double delta = 0.1,
+                const bool warmStart = false) :
        epsilon(epsilon),
-       delta(delta)
+       delta(delta),
+       warmStart(warmStart)
   {
     /* Nothing to do here */
   }
@@ -61,7 +70,14 @@ class QUICSVDPolicy
     MatType v, sigma;
 
     // Do singular value decomposition using the QUIC-SVD algorithm.
-    QUIC_SVD<MatType> quicsvd(centeredData, eigvec, v, sigma, epsilon, delta);
+    // The first call has no basis to start from yet.
+    QUIC_SVD<MatType> quicsvd;
+    const bool useBasis = warmStart && basis.n_cols > 0;
+    if (useBasis)
+      quicsvd.Basis() = arma::conv_to<MatType>::from(basis);
+    quicsvd.Apply(centeredData, eigvec, v, sigma, epsilon, delta, useBasis);
+    if (warmStart)
+      basis = arma::conv_to<arma::mat>::from(quicsvd.Basis());
 
     // Now we must square the singular values to get the eigenvalues.
     // In addition we must divide by the number of points, because the
@@ -82,12 +98,26 @@ class QUICSVDPolicy
   //! Modify the cumulative probability for Monte Carlo error lower bound.
   double& Delta() { return delta; }
 
+  //! Get whether the basis of the previous call is used as a warm start.
+  bool WarmStart() const { return warmStart; }
+  //! Modify whether the basis of the previous call is used as a warm start.
+  bool& WarmStart() { return warmStart; }
+
+  //! Forget the basis of the previous call, so the next call is a cold start.
+  void ResetBasis() { basis.reset(); }
+
  private:
   //! Error tolerance fraction for calculated subspace.
   double epsilon;
 
   //! Cumulative probability for Monte Carlo error lower bound.
   double delta;
+
+  //! Whether the basis of the previous call is used as a warm start.
+  bool warmStart;
+
+  //! Subspace basis of the previous call.
+  arma::mat basis;
 };
 
 } // namespace mlpack
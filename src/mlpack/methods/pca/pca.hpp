@@ -177,7 +177,37 @@ class PCA
   //! the data when PCA is performed.
   bool& ScaleData() { return scaleData; }
 
+  //! Get the decomposition policy (which, for IncrementalSVDPolicy, holds the
+  //! mean and components of the last decomposition).
+  const DecompositionPolicy& Decomposition() const { return decomposition; }
+  //! Modify the decomposition policy.
+  DecompositionPolicy& Decomposition() { return decomposition; }
+
  private:
+  /**
+   * Center and scale the data as requested, and decompose it with the given
+   * rank (0 means the dimensionality of the data).
+   */
+  template<typename MatType, typename OutMatType, typename VecType>
+  void Decompose(const MatType& data,
+                 OutMatType& transformedData,
+                 VecType& eigVal,
+                 OutMatType& eigvec,
+                 const size_t rank);
+
+  //! Ensure that the rank is not greater than the dimensionality of the data.
+  static void CheckRank(const size_t rank, const size_t dimensionality)
+  {
+    if (rank > dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "PCA::Apply(): newDimension (" << rank << ") cannot "
+          << "be greater than the existing dimensionality of the data ("
+          << dimensionality << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+  }
+
   //! Scaling the data is when we reduce the variance of each dimension to 1.
   template<typename MatType>
   void ScaleData(MatType& centeredData)
@@ -52,15 +52,7 @@ void PCA<DecompositionPolicy>::Apply(const MatType& data,
       "PCA::Apply(): data and transformedData must have the same element "
       "types!");
 
-  // Center the data into a temporary matrix.
-  OutMatType centeredData = arma::conv_to<OutMatType>::from(data);
-  centeredData.each_col() -= arma::mean(centeredData, 1);
-
-  // Scale the data if the user asked for it.
-  ScaleData(centeredData);
-
-  decomposition.Apply(data, centeredData, transformedData, eigVal, eigvec,
-      centeredData.n_rows);
+  Decompose(data, transformedData, eigVal, eigvec, 0);
 }
 
 /**
@@ -118,6 +110,59 @@ void PCA<DecompositionPolicy>::Apply(const MatType& data,
   Apply(data, transformedData, eigVal, eigvec);
 }
 
+/**
+ * Center (and scale, if requested) the data, and decompose it with the
+ * decomposition policy.  If the policy centers the data itself, and the data
+ * is not scaled, then no centered copy of the data is made.
+ */
+template<typename DecompositionPolicy>
+template<typename MatType, typename OutMatType, typename VecType>
+void PCA<DecompositionPolicy>::Decompose(const MatType& data,
+                                         OutMatType& transformedData,
+                                         VecType& eigVal,
+                                         OutMatType& eigvec,
+                                         const size_t rank)
+{
+  // If the policy centers the data itself, we can pass the data along as-is
+  // (if it is already a matrix of the output type).
+  if constexpr (PCAPolicyTraits<DecompositionPolicy>::CentersData)
+  {
+    if (!scaleData)
+    {
+      if constexpr (std::is_same_v<MatType, OutMatType>)
+      {
+        CheckRank(rank, data.n_rows);
+        decomposition.Apply(data, data, transformedData, eigVal, eigvec,
+            (rank == 0) ? data.n_rows : rank);
+      }
+      else
+      {
+        const OutMatType convertedData =
+            arma::conv_to<OutMatType>::from(data);
+        CheckRank(rank, convertedData.n_rows);
+        decomposition.Apply(data, convertedData, transformedData, eigVal,
+            eigvec, (rank == 0) ? convertedData.n_rows : rank);
+      }
+
+      return;
+    }
+  }
+
+  // Center the data into a temporary matrix.
+  OutMatType centeredData = arma::conv_to<OutMatType>::from(data);
+  centeredData.each_col() -= arma::mean(centeredData, 1);
+
+  // This check cannot happen until here, as `data` may not have a .n_rows
+  // member if it is an expression.
+  CheckRank(rank, centeredData.n_rows);
+
+  // Scale the data if the user asked for it.
+  ScaleData(centeredData);
+
+  decomposition.Apply(data, centeredData, transformedData, eigVal, eigvec,
+      (rank == 0) ? centeredData.n_rows : rank);
+}
+
 /**
  * Use PCA for dimensionality reduction on the given dataset.  This will save
  * the newDimension largest principal components of the data and remove the
@@ -158,30 +203,11 @@ double PCA<DecompositionPolicy>::Apply(const MatType& data,
   BaseMatType eigvec;
   BaseColType eigVal;
 
-  // Center the data into a temporary matrix.
-  BaseMatType centeredData = arma::conv_to<OutMatType>::from(data);
-  centeredData.each_col() -= arma::mean(centeredData, 1);
+  Decompose(data, transformedData, eigVal, eigvec, newDimension);
 
-  // This check cannot happen until here, as `data` may not have a .n_rows
-  // member if it is an expression.
-  if (newDimension > centeredData.n_rows)
-  {
-    std::ostringstream oss;
-    oss << "PCA::Apply(): newDimension (" << newDimension << ") cannot "
-        << "be greater than the existing dimensionality of the data ("
-        << data.n_rows << ")!";
-    throw std::invalid_argument(oss.str());
-  }
-
-  // Scale the data if the user ask for.
-  ScaleData(centeredData);
-
-  decomposition.Apply(data, centeredData, transformedData, eigVal, eigvec,
-      newDimension);
-
-  if (newDimension < eigvec.n_rows)
+  if (newDimension < transformedData.n_rows)
     // Drop unnecessary rows.
-    transformedData.shed_rows(newDimension, data.n_rows - 1);
+    transformedData.shed_rows(newDimension, transformedData.n_rows - 1);
 
   // The svd method returns only non-zero eigenvalues so we have to calculate
   // the right dimension before calculating the amount of variance retained.
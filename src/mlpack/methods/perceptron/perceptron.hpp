@@ -24,6 +24,18 @@ namespace mlpack {
  * network).  It converges if the supplied training dataset is linearly
  * separable.
  *
+ * Training can be done in mini-batches (see `BatchSize()`): the predictions
+ * for a block of points are computed with one matrix product using the weights
+ * at the start of the block, and then the weights are updated for each
+ * misclassified point of the block.  With a batch size of 1 (the default), this
+ * is the classical perceptron algorithm.
+ *
+ * If `Average()` is set, the averaged perceptron is trained: at the end of
+ * training, the weights are the average of the weights after each point that
+ * was visited.  The average is maintained lazily (an update costs the same as
+ * for the classical algorithm), which requires the learning policy to be
+ * linear in the instance weight, as SimpleWeightUpdate is.
+ *
  * @tparam LearnPolicy Options of SimpleWeightUpdate and GradientDescent.
  * @tparam WeightInitializationPolicy Option of ZeroInitialization and
  *      RandomPerceptronInitialization.
@@ -200,6 +212,18 @@ class Perceptron
   //! Modify the maximum number of iterations.
   size_t& MaxIterations() { return maxIterations; }
 
+  //! Get the number of points whose predictions are computed at once during
+  //! training.
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the number of points whose predictions are computed at once during
+  //! training.
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get whether the averaged perceptron is trained.
+  bool Average() const { return average; }
+  //! Modify whether the averaged perceptron is trained.
+  bool& Average() { return average; }
+
   //! Get the number of classes this perceptron has been trained for.
   size_t NumClasses() const { return weights.n_cols; }
 
@@ -226,9 +250,19 @@ class Perceptron
                      const size_t numClasses,
                      const WeightsType& instanceWeights = WeightsType());
 
+  //! Number of points in each block of Classify() that is processed by one
+  //! thread.
+  static constexpr size_t ClassifyBlockSize = 1024;
+
   //! The maximum number of iterations during training.
   size_t maxIterations;
 
+  //! The number of points whose predictions are computed at once in training.
+  size_t batchSize;
+
+  //! Whether to train the averaged perceptron.
+  bool average;
+
   /**
    * Stores the weights for each of the input class labels.  Each column
    * corresponds to the weights for one class label, and each row corresponds to
@@ -243,6 +277,12 @@ class Perceptron
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename LearnPolicy,
+                               typename WeightInitializationPolicy,
+                               typename MatType),
+    (mlpack::Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>),
+    (1));
+
 #include "perceptron_impl.hpp"
 
 #endif
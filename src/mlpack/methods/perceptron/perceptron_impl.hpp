@@ -29,7 +29,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const size_t dimensionality,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   WeightInitializationPolicy wip;
   wip.Initialize(weights, biases, dimensionality, numClasses);
@@ -55,7 +57,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const arma::Row<size_t>& labels,
     const size_t numClasses,
     const size_t maxIterations) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   // Start training.
   TrainInternal<false, arma::Row<typename MatType::elem_type>>(data, labels,
@@ -84,7 +88,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const WeightsType& instanceWeights,
     const size_t maxIterations,
     const std::enable_if_t<arma::is_arma_type<WeightsType>::value>*) :
-    maxIterations(maxIterations)
+    maxIterations(maxIterations),
+    batchSize(1),
+    average(false)
 {
   // Start training.
   TrainInternal<true>(data, labels, numClasses, instanceWeights);
@@ -114,7 +120,9 @@ Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Perceptron(
     const size_t numClasses,
     const WeightsType& instanceWeights,
     const std::enable_if_t<arma::is_arma_type<WeightsType>::value>*) :
-    maxIterations(other.maxIterations)
+    maxIterations(other.maxIterations),
+    batchSize(other.batchSize),
+    average(other.average)
 {
   TrainInternal<true>(data, labels, numClasses, instanceWeights);
 }
@@ -222,14 +230,32 @@ void Perceptron<
     wip.Initialize(weights, biases, data.n_rows, numClasses);
   }
 
-  size_t j, i = 0;
+  if (batchSize == 0)
+  {
+    throw std::invalid_argument("Perceptron::Train(): the batch size must be "
+        "greater than 0!");
+  }
+
+  size_t i = 0;
   bool converged = false;
-  size_t tempLabel;
-  arma::uword maxIndexRow = 0;
-  arma::Mat<ElemType> tempLabelMat;
+  arma::Mat<ElemType> scores;
 
   LearnPolicy LP;
 
+  // For the averaged perceptron, the sum of the weights after each point is
+  // not kept; instead, each update is also applied to avgWeights and avgBiases
+  // with its instance weight scaled by the number of points visited before it.
+  // Then the average of the weights over the t points visited is
+  // weights - avgWeights / t.
+  arma::Mat<ElemType> avgWeights;
+  arma::Col<ElemType> avgBiases;
+  size_t visited = 0;
+  if (average)
+  {
+    avgWeights.zeros(weights.n_rows, weights.n_cols);
+    avgBiases.zeros(biases.n_elem);
+  }
+
   while ((i < maxIterations) && (!converged))
   {
     // This outer loop is for each iteration, and we use the 'converged'
@@ -237,35 +263,49 @@ void Perceptron<
     ++i;
     converged = true;
 
-    // Now this inner loop is for going through the dataset in each iteration.
-    for (j = 0; j < data.n_cols; ++j)
+    // Now this inner loop is for going through the dataset in each iteration,
+    // one block of points at a time.
+    for (size_t first = 0; first < data.n_cols; first += batchSize)
     {
-      // Multiply for each variable and check whether the current weight vector
-      // correctly classifies this.
-      tempLabelMat = weights.t() * data.col(j) + biases;
+      const size_t last = std::min(first + batchSize, (size_t) data.n_cols) - 1;
 
-      maxIndexRow = arma::ind2sub(arma::size(tempLabelMat),
-          tempLabelMat.index_max())(0);
+      // Compute the predictions of the current weights for the whole block.
+      scores = weights.t() * data.cols(first, last);
+      scores.each_col() += biases;
 
-      // Check whether prediction is correct.
-      if (maxIndexRow != labels(0, j))
+      for (size_t j = first; j <= last; ++j, ++visited)
       {
+        const size_t maxIndexRow = scores.col(j - first).index_max();
+
+        // Check whether prediction is correct.
+        if (maxIndexRow == labels(0, j))
+          continue;
+
         // Due to incorrect prediction, convergence set to false.
         converged = false;
-        tempLabel = labels(0, j);
+        const size_t tempLabel = labels(0, j);
+        const ElemType instanceWeight = HasWeights ?
+            (ElemType) instanceWeights(j) : ElemType(1);
 
         // Send maxIndexRow for knowing which weight to update, send j to know
         // the value of the vector to update it with.  Send tempLabel to know
         // the correct class.
-        if (HasWeights)
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
-              (typename MatType::elem_type) instanceWeights(j));
-        else
-          LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow,
-              tempLabel);
+        LP.UpdateWeights(data.col(j), weights, biases, maxIndexRow, tempLabel,
+            instanceWeight);
+        if (average && visited > 0)
+        {
+          LP.UpdateWeights(data.col(j), avgWeights, avgBiases, maxIndexRow,
+              tempLabel, ElemType(visited) * instanceWeight);
+        }
       }
     }
   }
+
+  if (average && visited > 0)
+  {
+    weights -= avgWeights / ElemType(visited);
+    biases -= avgBiases / ElemType(visited);
+  }
 }
 
 /**
@@ -315,16 +355,22 @@ void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::Classify(
   util::CheckSameDimensionality(test, weights.n_rows, "Perceptron::Classify()",
       "points");
 
-  arma::Col<ElemType> tempLabelMat;
-  arma::uword maxIndex = 0;
   predictedLabels.set_size(test.n_cols);
 
-  // Could probably be faster if done in batch.
-  for (size_t i = 0; i < test.n_cols; ++i)
+  // The points are classified in blocks, with one matrix product per block.
+  const size_t numBlocks = (test.n_cols + ClassifyBlockSize - 1) /
+      ClassifyBlockSize;
+
+  #pragma omp parallel for schedule(static) if (numBlocks > 1)
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    tempLabelMat = weights.t() * test.col(i) + biases;
-    maxIndex = tempLabelMat.index_max();
-    predictedLabels(i) = maxIndex;
+    const size_t first = b * ClassifyBlockSize;
+    const size_t last = std::min(first + ClassifyBlockSize,
+        (size_t) test.n_cols) - 1;
+
+    arma::Mat<ElemType> scores = weights.t() * test.cols(first, last);
+    scores.each_col() += biases;
+    predictedLabels.subvec(first, last) = arma::index_max(scores, 0);
   }
 }
 
@@ -348,11 +394,22 @@ template<typename LearnPolicy,
 template<typename Archive>
 void Perceptron<LearnPolicy, WeightInitializationPolicy, MatType>::serialize(
     Archive& ar,
-    const uint32_t /* version */)
+    const uint32_t version)
 {
-  // We just need to serialize the maximum number of iterations, the weights,
-  // and the biases.
+  // We just need to serialize the training options, the weights, and the
+  // biases.
   ar(CEREAL_NVP(maxIterations));
+  if (cereal::is_loading<Archive>() && version == 0)
+  {
+    // Older versions did not have mini-batch or averaged training.
+    batchSize = 1;
+    average = false;
+  }
+  else
+  {
+    ar(CEREAL_NVP(batchSize));
+    ar(CEREAL_NVP(average));
+  }
   ar(CEREAL_NVP(weights));
   ar(CEREAL_NVP(biases));
 }
@@ -0,0 +1,245 @@
+/**
+ * @file methods/pq/pq_search.hpp
+ *
+ * Definition of the PQSearch class, an approximate nearest neighbor index
+ * that stores its reference set compressed with product quantization, in the
+ * inverted lists of a k-means coarse quantizer (IVFADC).
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PQ_SEARCH_HPP
+#define MLPACK_METHODS_PQ_PQ_SEARCH_HPP
+
+#include <mlpack/core.hpp>
+
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+
+/**
+ * The PQSearch class is an approximate nearest neighbor index (for the
+ * Euclidean distance) that does not hold the reference set: each reference
+ * point is assigned to the nearest of NumLists() centroids learned with
+ * k-means (the coarse quantizer), and the residual of the point from its
+ * centroid is compressed by a ProductQuantizer into NumSubspaces() bytes.  So,
+ * 500 million 128-dimensional points with 16 subspaces take about 12 GB (with
+ * their indices), instead of 512 GB in double precision.
+ *
+ * A search scans the inverted lists of the NumProbes() centroids nearest to
+ * each query point, and computes the distances to the compressed points
+ * asymmetrically, with one lookup table for each list, in parallel over the
+ * query points.  Optionally, the RerankCandidates() best points are then
+ * re-ranked by their exact distances to the query point, with a
+ * full-precision copy of the reference set that is given to Search(); that
+ * copy can be memory mapped with data::LoadMapped(), so that only the
+ * candidates are read from disk.
+ *
+ * The quantizers can be trained on a sample of the reference set, and the
+ * points added (for instance, block by block with data::MatrixReader) with
+ * Add():
+ *
+ * @code
+ * PQSearch<> pq(1024, 16);
+ * pq.Train(sample);
+ * data::MatrixReader reader("huge.bin", 1000000);
+ * arma::mat block;
+ * while (reader.Next(block))
+ *   pq.Add(block);
+ *
+ * pq.NumProbes() = 16;
+ * arma::Mat<size_t> neighbors;
+ * arma::mat distances;
+ * pq.Search(queries, 10, neighbors, distances);
+ * @endcode
+ *
+ * The results of Search() have the same form as those of
+ * NeighborSearch::Search(), so NeighborSearch::Recall() can be used to
+ * compare them with exact results.
+ *
+ * @tparam MatType Type of matrix of the points.
+ */
+template<typename MatType = arma::mat>
+class PQSearch
+{
+ public:
+  //! The element type of the points.
+  using ElemType = typename MatType::elem_type;
+
+  /**
+   * Create an empty index.  Call Train() before Add() or Search().
+   *
+   * @param numLists Number of centroids of the coarse quantizer.
+   * @param numSubspaces Number of subspaces of the product quantizer (bytes
+   *     of each code).
+   * @param numCentroids Number of centroids of each subspace (at most 256).
+   * @param opqIterations Number of optimizations of the rotation of the
+   *     product quantizer (0 means no rotation).
+   * @param maxIterations Maximum number of k-means iterations of each
+   *     quantizer.
+   */
+  PQSearch(const size_t numLists = 1,
+           const size_t numSubspaces = 8,
+           const size_t numCentroids = 256,
+           const size_t opqIterations = 0,
+           const size_t maxIterations = 25);
+
+  /**
+   * Train the quantizers on the given reference set, and add its points to
+   * the index.
+   *
+   * @param referenceSet Set of reference points.
+   * @param numLists Number of centroids of the coarse quantizer.
+   * @param numSubspaces Number of subspaces of the product quantizer (bytes
+   *     of each code).
+   * @param numCentroids Number of centroids of each subspace (at most 256).
+   * @param opqIterations Number of optimizations of the rotation of the
+   *     product quantizer (0 means no rotation).
+   * @param maxIterations Maximum number of k-means iterations of each
+   *     quantizer.
+   */
+  PQSearch(const MatType& referenceSet,
+           const size_t numLists = 1,
+           const size_t numSubspaces = 8,
+           const size_t numCentroids = 256,
+           const size_t opqIterations = 0,
+           const size_t maxIterations = 25);
+
+  /**
+   * Train the coarse quantizer and the product quantizer on the given points,
+   * and empty the index.  The points are not added to the index.
+   *
+   * @param data Training points.
+   */
+  void Train(const MatType& data);
+
+  /**
+   * Compress the given points and add them to the index.  The new points get
+   * the indices following the points already in the index.
+   *
+   * @param points Points to add.
+   */
+  void Add(const MatType& points);
+
+  /**
+   * Find the approximate k nearest neighbors of each point in the query set,
+   * with the compressed distances.  The matrices are set to k rows and one
+   * column for each query point, sorted by distance, like with
+   * NeighborSearch::Search().  If fewer than k points are in the probed
+   * lists, the remaining neighbors are SIZE_MAX and their distances are the
+   * largest ElemType.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances) const;
+
+  /**
+   * Find the approximate k nearest neighbors of each point in the query set,
+   * and re-rank the RerankCandidates() best candidates (at least k) by their
+   * exact distances, computed with the given full-precision reference set.
+   * The returned distances are exact.
+   *
+   * @param querySet Set of query points.
+   * @param k Number of neighbors to search for.
+   * @param neighbors Matrix to store the indices of the neighbors in.
+   * @param distances Matrix to store the distances to the neighbors in.
+   * @param referenceSet Full-precision reference set, with the points in the
+   *     order they were added (it may be memory mapped).
+   */
+  void Search(const MatType& querySet,
+              const size_t k,
+              arma::Mat<size_t>& neighbors,
+              arma::Mat<ElemType>& distances,
+              const MatType& referenceSet) const;
+
+  //! Get the number of points in the index.
+  size_t Size() const { return size; }
+  //! Get the number of centroids of the coarse quantizer.
+  size_t NumLists() const { return numLists; }
+  //! Get the number of lists scanned for each query point.
+  size_t NumProbes() const { return numProbes; }
+  //! Modify the number of lists scanned for each query point.
+  size_t& NumProbes() { return numProbes; }
+  //! Get the number of candidates re-ranked when a full-precision reference
+  //! set is given (0 means 10 times k).
+  size_t RerankCandidates() const { return rerankCandidates; }
+  //! Modify the number of candidates re-ranked when a full-precision
+  //! reference set is given (0 means 10 times k).
+  size_t& RerankCandidates() { return rerankCandidates; }
+
+  //! Get the centroids of the coarse quantizer.
+  const MatType& Centroids() const { return centroids; }
+  //! Get the product quantizer of the residuals.
+  const ProductQuantizer<MatType>& Quantizer() const { return quantizer; }
+  //! Get the indices of the points of the given list.
+  const std::vector<size_t>& ListIndices(const size_t list) const
+  {
+    return listIndices[list];
+  }
+  //! Get the codes of the points of the given list (NumSubspaces() bytes for
+  //! each point).
+  const std::vector<unsigned char>& ListCodes(const size_t list) const
+  {
+    return listCodes[list];
+  }
+
+  //! Serialize the index.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! A candidate: its (squared) distance to the query point, and its index.
+  using Candidate = std::pair<ElemType, size_t>;
+
+  //! Find the given number of best candidates of the given query point
+  //! with the compressed distances, sorted by squared distance.
+  template<typename VecType>
+  void SearchPoint(const VecType& query,
+                   const size_t numCandidates,
+                   std::vector<Candidate>& candidates,
+                   MatType& table) const;
+
+  //! Assign each of the given points to its nearest coarse centroid.
+  void Assign(const MatType& points, arma::Col<size_t>& assignments) const;
+
+  //! Check the dimensionality of the given query set and the value of k.
+  void CheckSearch(const MatType& querySet, const size_t k) const;
+
+  //! Number of points of each block that is added at once.
+  static constexpr size_t BlockSize = 65536;
+
+  //! The number of centroids of the coarse quantizer.
+  size_t numLists;
+  //! The maximum number of k-means iterations of the coarse quantizer.
+  size_t maxIterations;
+  //! The number of lists scanned for each query point.
+  size_t numProbes;
+  //! The number of candidates to re-rank (0 means 10 times k).
+  size_t rerankCandidates;
+
+  //! The centroids of the coarse quantizer.
+  MatType centroids;
+  //! The product quantizer of the residuals.
+  ProductQuantizer<MatType> quantizer;
+  //! The indices of the points of each list.
+  std::vector<std::vector<size_t>> listIndices;
+  //! The codes of the points of each list.
+  std::vector<std::vector<unsigned char>> listCodes;
+  //! The number of points in the index.
+  size_t size;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "pq_search_impl.hpp"
+
+#endif
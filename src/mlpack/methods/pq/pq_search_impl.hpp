@@ -0,0 +1,343 @@
+/**
+ * @file methods/pq/pq_search_impl.hpp
+ *
+ * Implementation of the PQSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PQ_SEARCH_IMPL_HPP
+#define MLPACK_METHODS_PQ_PQ_SEARCH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "pq_search.hpp"
+
+#include <queue>
+
+namespace mlpack {
+
+template<typename MatType>
+PQSearch<MatType>::PQSearch(const size_t numLists,
+                            const size_t numSubspaces,
+                            const size_t numCentroids,
+                            const size_t opqIterations,
+                            const size_t maxIterations) :
+    numLists(numLists),
+    maxIterations(maxIterations),
+    numProbes(1),
+    rerankCandidates(0),
+    quantizer(numSubspaces, numCentroids, maxIterations, opqIterations),
+    size(0)
+{
+  if (numLists == 0)
+  {
+    throw std::invalid_argument("PQSearch::PQSearch(): the number of lists "
+        "must be positive!");
+  }
+}
+
+template<typename MatType>
+PQSearch<MatType>::PQSearch(const MatType& referenceSet,
+                            const size_t numLists,
+                            const size_t numSubspaces,
+                            const size_t numCentroids,
+                            const size_t opqIterations,
+                            const size_t maxIterations) :
+    PQSearch(numLists, numSubspaces, numCentroids, opqIterations,
+        maxIterations)
+{
+  Train(referenceSet);
+  Add(referenceSet);
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Train(const MatType& data)
+{
+  if (data.n_cols < numLists)
+  {
+    throw std::invalid_argument("PQSearch::Train(): there are " +
+        std::to_string(data.n_cols) + " points, but at least " +
+        std::to_string(numLists) + " are needed to learn the lists!");
+  }
+
+  if (numLists == 1)
+  {
+    centroids = arma::mean(data, 1);
+  }
+  else
+  {
+    KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+        NaiveKMeans, MatType> kmeans(maxIterations);
+    arma::mat kmeansCentroids;
+    kmeans.Cluster(data, numLists, kmeansCentroids);
+    centroids = arma::conv_to<MatType>::from(kmeansCentroids);
+  }
+
+  // The product quantizer compresses the residuals from the centroids.
+  arma::Col<size_t> assignments;
+  Assign(data, assignments);
+  MatType residuals(data);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < residuals.n_cols; ++i)
+    residuals.col(i) -= centroids.col(assignments[i]);
+
+  quantizer.Train(residuals);
+
+  listIndices.clear();
+  listIndices.resize(numLists);
+  listCodes.clear();
+  listCodes.resize(numLists);
+  size = 0;
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Add(const MatType& points)
+{
+  if (centroids.is_empty())
+  {
+    throw std::invalid_argument("PQSearch::Add(): the index must be trained "
+        "before points are added!");
+  }
+
+  if (points.n_rows != centroids.n_rows)
+  {
+    throw std::invalid_argument("PQSearch::Add(): the points have " +
+        std::to_string(points.n_rows) + " dimensions, but the index has " +
+        std::to_string(centroids.n_rows) + "!");
+  }
+
+  // Compress the points one block at a time, so that the residuals of all
+  // points are never held at once.
+  const size_t numSubspaces = quantizer.NumSubspaces();
+  arma::Col<size_t> assignments;
+  arma::Mat<unsigned char> codes;
+  MatType residuals;
+  for (size_t begin = 0; begin < points.n_cols; begin += BlockSize)
+  {
+    const size_t end = std::min(begin + BlockSize, (size_t) points.n_cols);
+    residuals = points.cols(begin, end - 1);
+    Assign(residuals, assignments);
+
+    #pragma omp parallel for schedule(static)
+    for (size_t i = 0; i < residuals.n_cols; ++i)
+      residuals.col(i) -= centroids.col(assignments[i]);
+    quantizer.Encode(residuals, codes);
+
+    for (size_t i = 0; i < codes.n_cols; ++i)
+    {
+      listIndices[assignments[i]].push_back(size + begin + i);
+      listCodes[assignments[i]].insert(listCodes[assignments[i]].end(),
+          codes.colptr(i), codes.colptr(i) + numSubspaces);
+    }
+  }
+
+  size += points.n_cols;
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Assign(const MatType& points,
+                               arma::Col<size_t>& assignments) const
+{
+  assignments.set_size(points.n_cols);
+
+  // The nearest centroid of a point x minimizes |c|^2 - 2 c^T x.
+  const arma::Col<ElemType> norms = arma::sum(arma::square(centroids), 0).t();
+  const size_t blockSize = 1024;
+  const size_t numBlocks = (points.n_cols + blockSize - 1) / blockSize;
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * blockSize;
+    const size_t end = std::min(begin + blockSize, (size_t) points.n_cols);
+
+    MatType scores = ElemType(-2) * centroids.t() *
+        points.cols(begin, end - 1);
+    scores.each_col() += norms;
+    const arma::urowvec nearest = arma::index_min(scores, 0);
+    for (size_t i = 0; i < nearest.n_elem; ++i)
+      assignments[begin + i] = nearest[i];
+  }
+}
+
+template<typename MatType>
+template<typename VecType>
+void PQSearch<MatType>::SearchPoint(const VecType& query,
+                                    const size_t numCandidates,
+                                    std::vector<Candidate>& candidates,
+                                    MatType& table) const
+{
+  // Find the lists to probe.
+  std::vector<Candidate> lists(numLists);
+  for (size_t l = 0; l < numLists; ++l)
+  {
+    lists[l] = Candidate(arma::accu(arma::square(centroids.col(l) - query)),
+        l);
+  }
+  const size_t probes = std::min(std::max(numProbes, (size_t) 1), numLists);
+  std::partial_sort(lists.begin(), lists.begin() + probes, lists.end());
+
+  // Keep the best candidates in a max-heap.
+  std::priority_queue<Candidate> best;
+  const size_t numSubspaces = quantizer.NumSubspaces();
+  for (size_t p = 0; p < probes; ++p)
+  {
+    const size_t l = lists[p].second;
+    if (listIndices[l].empty())
+      continue;
+
+    quantizer.LookupTable(query - centroids.col(l), table);
+    const unsigned char* code = listCodes[l].data();
+    for (size_t j = 0; j < listIndices[l].size(); ++j, code += numSubspaces)
+    {
+      const ElemType d = quantizer.Distance(table, code);
+      if (best.size() < numCandidates)
+        best.push(Candidate(d, listIndices[l][j]));
+      else if (d < best.top().first)
+      {
+        best.pop();
+        best.push(Candidate(d, listIndices[l][j]));
+      }
+    }
+  }
+
+  candidates.resize(best.size());
+  for (size_t i = candidates.size(); i-- > 0; )
+  {
+    candidates[i] = best.top();
+    best.pop();
+  }
+}
+
+template<typename MatType>
+void PQSearch<MatType>::CheckSearch(const MatType& querySet,
+                                    const size_t k) const
+{
+  if (centroids.is_empty())
+  {
+    throw std::invalid_argument("PQSearch::Search(): the index must be "
+        "trained before searching!");
+  }
+
+  if (k > size)
+  {
+    throw std::invalid_argument("PQSearch::Search(): requested value of k (" +
+        std::to_string(k) + ") is greater than the number of points in the "
+        "index (" + std::to_string(size) + ")!");
+  }
+
+  if (querySet.n_rows != centroids.n_rows)
+  {
+    throw std::invalid_argument("PQSearch::Search(): the query set has " +
+        std::to_string(querySet.n_rows) + " dimensions, but the index has " +
+        std::to_string(centroids.n_rows) + "!");
+  }
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Search(const MatType& querySet,
+                               const size_t k,
+                               arma::Mat<size_t>& neighbors,
+                               arma::Mat<ElemType>& distances) const
+{
+  CheckSearch(querySet, k);
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.fill(std::numeric_limits<ElemType>::max());
+  if (k == 0)
+    return;
+
+  #pragma omp parallel
+  {
+    std::vector<Candidate> candidates;
+    MatType table;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.col(i), k, candidates, table);
+      for (size_t j = 0; j < candidates.size(); ++j)
+      {
+        distances(j, i) = std::sqrt(candidates[j].first);
+        neighbors(j, i) = candidates[j].second;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+void PQSearch<MatType>::Search(const MatType& querySet,
+                               const size_t k,
+                               arma::Mat<size_t>& neighbors,
+                               arma::Mat<ElemType>& distances,
+                               const MatType& referenceSet) const
+{
+  CheckSearch(querySet, k);
+
+  if (referenceSet.n_cols != size || referenceSet.n_rows != centroids.n_rows)
+  {
+    throw std::invalid_argument("PQSearch::Search(): the full-precision "
+        "reference set must have " + std::to_string(size) + " points of " +
+        std::to_string(centroids.n_rows) + " dimensions!");
+  }
+
+  neighbors.set_size(k, querySet.n_cols);
+  distances.set_size(k, querySet.n_cols);
+  neighbors.fill(SIZE_MAX);
+  distances.fill(std::numeric_limits<ElemType>::max());
+  if (k == 0)
+    return;
+
+  const size_t numCandidates = std::max(k,
+      (rerankCandidates == 0) ? 10 * k : rerankCandidates);
+
+  #pragma omp parallel
+  {
+    std::vector<Candidate> candidates;
+    MatType table;
+
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < querySet.n_cols; ++i)
+    {
+      SearchPoint(querySet.col(i), numCandidates, candidates, table);
+
+      // Replace the compressed distances with exact ones.
+      for (Candidate& c : candidates)
+      {
+        c.first = EuclideanDistance::Evaluate(querySet.col(i),
+            referenceSet.col(c.second));
+      }
+
+      const size_t found = std::min(k, candidates.size());
+      std::partial_sort(candidates.begin(), candidates.begin() + found,
+          candidates.end());
+      for (size_t j = 0; j < found; ++j)
+      {
+        distances(j, i) = candidates[j].first;
+        neighbors(j, i) = candidates[j].second;
+      }
+    }
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void PQSearch<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numLists));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(numProbes));
+  ar(CEREAL_NVP(rerankCandidates));
+  ar(CEREAL_NVP(centroids));
+  ar(CEREAL_NVP(quantizer));
+  ar(CEREAL_NVP(listIndices));
+  ar(CEREAL_NVP(listCodes));
+  ar(CEREAL_NVP(size));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file methods/pq/product_quantizer.hpp
+ *
+ * Definition of the ProductQuantizer class, which compresses points into
+ * short codes with product quantization (and, optionally, an optimized
+ * rotation), and computes asymmetric distances to the compressed points with
+ * lookup tables.  Product quantization is described in the following paper:
+ *
+ * @code
+ * @article{jegou2011product,
+ *   title={Product quantization for nearest neighbor search},
+ *   author={J{\'e}gou, Herv{\'e} and Douze, Matthijs and Schmid, Cordelia},
+ *   journal={IEEE Transactions on Pattern Analysis and Machine Intelligence},
+ *   volume={33},
+ *   number={1},
+ *   pages={117--128},
+ *   year={2011}
+ * }
+ * @endcode
+ *
+ * and the optimized rotation in this paper:
+ *
+ * @code
+ * @inproceedings{ge2013optimized,
+ *   title={Optimized product quantization for approximate nearest neighbor
+ *       search},
+ *   author={Ge, Tiezheng and He, Kaiming and Ke, Qifa and Sun, Jian},
+ *   booktitle={Proceedings of the IEEE Conference on Computer Vision and
+ *       Pattern Recognition (CVPR 2013)},
+ *   pages={2946--2953},
+ *   year={2013}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PRODUCT_QUANTIZER_HPP
+#define MLPACK_METHODS_PQ_PRODUCT_QUANTIZER_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kmeans/kmeans.hpp>
+
+namespace mlpack {
+
+/**
+ * A product quantizer splits the dimensions into NumSubspaces() contiguous
+ * subspaces, and quantizes each subspace with its own codebook of at most 256
+ * centroids, learned with k-means.  So, each point is compressed into
+ * NumSubspaces() bytes.  The squared Euclidean distance between a query point
+ * and a compressed point is computed asymmetrically, without decoding the
+ * point: LookupTable() computes the squared distances between the query point
+ * and every centroid of every subspace, and Distance() sums the entries of
+ * the table that the code of the point selects.
+ *
+ * If `opqIterations` is nonzero, an orthogonal rotation of the data is
+ * learned first (optimized product quantization, non-parametric version):
+ * the codebooks and the rotation that minimize the quantization error are
+ * optimized alternately.  This balances the variance of the subspaces and
+ * lowers the quantization error of correlated data; the rotation is applied
+ * by Encode() and LookupTable(), and undone by Decode().
+ *
+ * @code
+ * ProductQuantizer<> pq(16);
+ * pq.Train(sample);
+ * arma::Mat<unsigned char> codes;
+ * pq.Encode(dataset, codes);
+ *
+ * arma::mat table;
+ * pq.LookupTable(query, table);
+ * const double d = pq.Distance(table, codes.colptr(0));
+ * @endcode
+ *
+ * @tparam MatType Type of matrix of the points and codebooks.
+ */
+template<typename MatType = arma::mat>
+class ProductQuantizer
+{
+ public:
+  //! The element type of the points.
+  using ElemType = typename MatType::elem_type;
+  //! The type of a point.
+  using VecType = typename GetColType<MatType>::type;
+
+  /**
+   * Create a product quantizer.  Call Train() before encoding.
+   *
+   * @param numSubspaces Number of subspaces (bytes of each code).
+   * @param numCentroids Number of centroids of each subspace (at most 256).
+   * @param maxIterations Maximum number of k-means iterations to learn each
+   *     codebook.
+   * @param opqIterations Number of alternating optimizations of the rotation
+   *     and the codebooks (0 means no rotation).
+   */
+  ProductQuantizer(const size_t numSubspaces = 8,
+                   const size_t numCentroids = 256,
+                   const size_t maxIterations = 25,
+                   const size_t opqIterations = 0);
+
+  /**
+   * Learn the codebooks (and the rotation, if opqIterations is nonzero) from
+   * the given points.  There must be at least NumCentroids() points, and at
+   * least NumSubspaces() dimensions.
+   *
+   * @param data Training points (one per column).
+   */
+  void Train(const MatType& data);
+
+  /**
+   * Compress the given points, in parallel.  Each column of codes holds the
+   * code of a point, with one entry for each subspace.
+   *
+   * @param data Points to compress.
+   * @param codes Matrix to store the codes in.
+   */
+  void Encode(const MatType& data, arma::Mat<unsigned char>& codes) const;
+
+  /**
+   * Reconstruct the points of the given codes.
+   *
+   * @param codes Codes of the points.
+   * @param data Matrix to store the reconstructed points in.
+   */
+  void Decode(const arma::Mat<unsigned char>& codes, MatType& data) const;
+
+  /**
+   * Compute the lookup table of the given point: the entry (c, s) is the
+   * squared Euclidean distance between the point and centroid c of subspace
+   * s.
+   *
+   * @param point Point (in the original space, not rotated).
+   * @param table Matrix to store the table in.
+   */
+  template<typename PointType>
+  void LookupTable(const PointType& point, MatType& table) const;
+
+  /**
+   * Compute the squared Euclidean distance between the point of the given
+   * lookup table and the point with the given code.
+   *
+   * @param table Lookup table computed by LookupTable().
+   * @param code NumSubspaces() entries of the code of the point.
+   */
+  ElemType Distance(const MatType& table, const unsigned char* code) const
+  {
+    ElemType result = 0;
+    const ElemType* t = table.memptr();
+    for (size_t s = 0; s < codebooks.size(); ++s, t += numCentroids)
+      result += t[code[s]];
+    return result;
+  }
+
+  /**
+   * Compute the mean squared Euclidean error of the quantization of the given
+   * points.
+   *
+   * @param data Points to quantize.
+   */
+  double QuantizationError(const MatType& data) const;
+
+  //! Get the number of subspaces (bytes of each code).
+  size_t NumSubspaces() const { return numSubspaces; }
+  //! Get the number of centroids of each subspace.
+  size_t NumCentroids() const { return numCentroids; }
+  //! Get the dimensionality of the points (0 before training).
+  size_t Dimensionality() const { return subspaceOffsets.empty() ? 0 :
+      subspaceOffsets[subspaceOffsets.n_elem - 1]; }
+  //! Get the first dimension of each subspace, followed by the
+  //! dimensionality.
+  const arma::Col<size_t>& SubspaceOffsets() const { return subspaceOffsets; }
+  //! Get the codebook (one centroid per column) of the given subspace.
+  const MatType& Codebook(const size_t s) const { return codebooks[s]; }
+  //! Get the rotation (empty if no rotation was learned).
+  const MatType& Rotation() const { return rotation; }
+
+  //! Serialize the quantizer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Learn the codebooks from the given (rotated) points, starting from the
+  //! current codebooks if warmStart is true.
+  void TrainCodebooks(const MatType& data, const bool warmStart);
+
+  //! Encode the given (rotated) points.
+  void EncodeRotated(const MatType& data,
+                     arma::Mat<unsigned char>& codes) const;
+
+  //! Reconstruct the given codes, without undoing the rotation.
+  void DecodeRotated(const arma::Mat<unsigned char>& codes,
+                     MatType& data) const;
+
+  //! Number of points of each block that is encoded at once.
+  static constexpr size_t BlockSize = 1024;
+
+  //! The number of subspaces.
+  size_t numSubspaces;
+  //! The number of centroids of each subspace.
+  size_t numCentroids;
+  //! The maximum number of k-means iterations.
+  size_t maxIterations;
+  //! The number of alternating optimizations of the rotation.
+  size_t opqIterations;
+
+  //! The first dimension of each subspace, followed by the dimensionality.
+  arma::Col<size_t> subspaceOffsets;
+  //! The codebook of each subspace.
+  std::vector<MatType> codebooks;
+  //! The rotation applied before quantization (empty if none).
+  MatType rotation;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "product_quantizer_impl.hpp"
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file methods/pq/product_quantizer_impl.hpp
+ *
+ * Implementation of the ProductQuantizer class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_PQ_PRODUCT_QUANTIZER_IMPL_HPP
+#define MLPACK_METHODS_PQ_PRODUCT_QUANTIZER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "product_quantizer.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+ProductQuantizer<MatType>::ProductQuantizer(const size_t numSubspaces,
+                                            const size_t numCentroids,
+                                            const size_t maxIterations,
+                                            const size_t opqIterations) :
+    numSubspaces(numSubspaces),
+    numCentroids(numCentroids),
+    maxIterations(maxIterations),
+    opqIterations(opqIterations)
+{
+  if (numSubspaces == 0)
+  {
+    throw std::invalid_argument("ProductQuantizer::ProductQuantizer(): the "
+        "number of subspaces must be positive!");
+  }
+
+  if (numCentroids == 0 || numCentroids > 256)
+  {
+    throw std::invalid_argument("ProductQuantizer::ProductQuantizer(): the "
+        "number of centroids must be between 1 and 256!");
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Train(const MatType& data)
+{
+  if (data.n_rows < numSubspaces)
+  {
+    throw std::invalid_argument("ProductQuantizer::Train(): the data has " +
+        std::to_string(data.n_rows) + " dimensions, but there are " +
+        std::to_string(numSubspaces) + " subspaces!");
+  }
+
+  if (data.n_cols < numCentroids)
+  {
+    throw std::invalid_argument("ProductQuantizer::Train(): there are " +
+        std::to_string(data.n_cols) + " points, but at least " +
+        std::to_string(numCentroids) + " are needed to learn the codebooks!");
+  }
+
+  // Split the dimensions as evenly as possible.
+  subspaceOffsets.set_size(numSubspaces + 1);
+  for (size_t s = 0; s <= numSubspaces; ++s)
+    subspaceOffsets[s] = s * data.n_rows / numSubspaces;
+
+  codebooks.resize(numSubspaces);
+  rotation.reset();
+
+  if (opqIterations == 0)
+  {
+    TrainCodebooks(data, false);
+    return;
+  }
+
+  // Alternate between the codebooks of the rotated data, and the rotation
+  // that brings the data closest to its reconstruction: if
+  // data * decoded^T = U S V^T, that rotation is V U^T.
+  MatType rotated(data);
+  rotation.eye(data.n_rows, data.n_rows);
+  TrainCodebooks(rotated, false);
+
+  arma::Mat<unsigned char> codes;
+  MatType decoded, u, v;
+  arma::Col<ElemType> sigma;
+  for (size_t i = 0; i < opqIterations; ++i)
+  {
+    EncodeRotated(rotated, codes);
+    DecodeRotated(codes, decoded);
+    Log::Info << "ProductQuantizer::Train(): quantization error "
+        << arma::accu(arma::square(rotated - decoded)) / data.n_cols
+        << " after " << i << " rotation updates." << std::endl;
+
+    if (!arma::svd(u, sigma, v, data * decoded.t()))
+    {
+      throw std::runtime_error("ProductQuantizer::Train(): singular value "
+          "decomposition failed!");
+    }
+
+    rotation = v * u.t();
+    rotated = rotation * data;
+    TrainCodebooks(rotated, true);
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::TrainCodebooks(const MatType& data,
+                                               const bool warmStart)
+{
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      NaiveKMeans, MatType> kmeans(maxIterations);
+
+  MatType subspace;
+  arma::mat centroids;
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    subspace = data.rows(subspaceOffsets[s], subspaceOffsets[s + 1] - 1);
+    if (warmStart)
+      centroids = arma::conv_to<arma::mat>::from(codebooks[s]);
+
+    kmeans.Cluster(subspace, numCentroids, centroids, warmStart);
+    codebooks[s] = arma::conv_to<MatType>::from(centroids);
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Encode(const MatType& data,
+                                       arma::Mat<unsigned char>& codes) const
+{
+  if (data.n_rows != Dimensionality())
+  {
+    throw std::invalid_argument("ProductQuantizer::Encode(): the data has " +
+        std::to_string(data.n_rows) + " dimensions, but the quantizer has " +
+        std::to_string(Dimensionality()) + "!");
+  }
+
+  if (rotation.is_empty())
+    EncodeRotated(data, codes);
+  else
+    EncodeRotated(MatType(rotation * data), codes);
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::EncodeRotated(
+    const MatType& data,
+    arma::Mat<unsigned char>& codes) const
+{
+  codes.set_size(numSubspaces, data.n_cols);
+
+  // The squared norms of the centroids; the nearest centroid of a subspace is
+  // the one that minimizes |c|^2 - 2 c^T x.
+  std::vector<arma::Row<ElemType>> norms(numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+    norms[s] = arma::sum(arma::square(codebooks[s]), 0);
+
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    MatType scores;
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      scores = ElemType(-2) * codebooks[s].t() * data.submat(
+          subspaceOffsets[s], begin, subspaceOffsets[s + 1] - 1, end - 1);
+      scores.each_col() += norms[s].t();
+      const arma::urowvec nearest = arma::index_min(scores, 0);
+      for (size_t i = 0; i < nearest.n_elem; ++i)
+        codes(s, begin + i) = (unsigned char) nearest[i];
+    }
+  }
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::Decode(const arma::Mat<unsigned char>& codes,
+                                       MatType& data) const
+{
+  DecodeRotated(codes, data);
+  if (!rotation.is_empty())
+    data = rotation.t() * data;
+}
+
+template<typename MatType>
+void ProductQuantizer<MatType>::DecodeRotated(
+    const arma::Mat<unsigned char>& codes,
+    MatType& data) const
+{
+  if (codes.n_rows != numSubspaces)
+  {
+    throw std::invalid_argument("ProductQuantizer::Decode(): the codes have " +
+        std::to_string(codes.n_rows) + " entries, but there are " +
+        std::to_string(numSubspaces) + " subspaces!");
+  }
+
+  data.set_size(Dimensionality(), codes.n_cols);
+  #pragma omp parallel for schedule(static)
+  for (size_t i = 0; i < codes.n_cols; ++i)
+  {
+    for (size_t s = 0; s < numSubspaces; ++s)
+    {
+      data.submat(subspaceOffsets[s], i, subspaceOffsets[s + 1] - 1, i) =
+          codebooks[s].col(codes(s, i));
+    }
+  }
+}
+
+template<typename MatType>
+template<typename PointType>
+void ProductQuantizer<MatType>::LookupTable(const PointType& point,
+                                            MatType& table) const
+{
+  VecType rotated(point);
+  if (!rotation.is_empty())
+    rotated = rotation * rotated;
+
+  table.set_size(numCentroids, numSubspaces);
+  for (size_t s = 0; s < numSubspaces; ++s)
+  {
+    const VecType sub = rotated.subvec(subspaceOffsets[s],
+        subspaceOffsets[s + 1] - 1);
+    table.col(s) = arma::sum(arma::square(codebooks[s].each_col() - sub),
+        0).t();
+  }
+}
+
+template<typename MatType>
+double ProductQuantizer<MatType>::QuantizationError(const MatType& data) const
+{
+  arma::Mat<unsigned char> codes;
+  MatType decoded;
+  Encode(data, codes);
+  Decode(codes, decoded);
+  return arma::accu(arma::square(data - decoded)) / data.n_cols;
+}
+
+template<typename MatType>
+template<typename Archive>
+void ProductQuantizer<MatType>::serialize(Archive& ar,
+                                          const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(numSubspaces));
+  ar(CEREAL_NVP(numCentroids));
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(opqIterations));
+  ar(CEREAL_NVP(subspaceOffsets));
+  ar(CEREAL_NVP(codebooks));
+  ar(CEREAL_NVP(rotation));
+}
+
+} // namespace mlpack
+
+#endif
@@ -46,7 +46,23 @@ BINDING_LONG_DESC(
     "specific dimension to analyze if there are too many dimensions. The " +
     PRINT_PARAM_STRING("population") + " parameter can be specified when the "
     "dataset should be considered as a population.  Otherwise, the dataset "
-    "will be considered as a sample.");
+    "will be considered as a sample."
+    "\n\n"
+    "Instead of " + PRINT_PARAM_STRING("input") + ", the name of a numeric "
+    "CSV, TSV or text file may be given with " +
+    PRINT_PARAM_STRING("input_file") + "; then the file is never loaded "
+    "entirely, but read in chunks of " + PRINT_PARAM_STRING("chunk_size") +
+    " points, and all the statistics are computed in a single (parallel) pass "
+    "over it, so datasets larger than memory can be described.  In that case "
+    "the median is estimated with a KLL sketch of " +
+    PRINT_PARAM_STRING("sketch_size") + " values, and the " +
+    PRINT_PARAM_STRING("row_major") + " parameter cannot be used."
+    "\n\n"
+    "The " + PRINT_PARAM_STRING("quantiles") + " parameter can be used to "
+    "also print the given quantiles of each dimension, which are estimated "
+    "with a KLL sketch (its error in rank is about 2% of the number of points "
+    "for the default " + PRINT_PARAM_STRING("sketch_size") + ", and is "
+    "inversely proportional to it).");
 
 // Example.
 BINDING_EXAMPLE(
@@ -70,7 +86,12 @@ BINDING_SEE_ALSO("@preprocess_imputer", "#preprocess_imputer");
 BINDING_SEE_ALSO("@preprocess_split", "#preprocess_split");
 
 // Define parameters for data.
-PARAM_MATRIX_IN_REQ("input", "Matrix containing data,", "i");
+PARAM_MATRIX_IN("input", "Matrix containing data,", "i");
+PARAM_STRING_IN("input_file", "Name of a numeric CSV, TSV or text file to "
+    "describe in a single streaming pass, instead of loading it as 'input'.",
+    "f", "");
+PARAM_INT_IN("chunk_size", "Number of points of 'input_file' that are read "
+    "at once.", "c", 100000);
 PARAM_INT_IN("dimension", "Dimension of the data. Use this to specify a "
     "dimension", "d", 0);
 PARAM_INT_IN("precision", "Precision of the output statistics.", "p", 4);
@@ -81,85 +102,10 @@ PARAM_FLAG("population", "If specified, the program will calculate statistics "
 PARAM_FLAG("row_major", "If specified, the program will calculate statistics "
     "across rows, not across columns.  (Remember that in mlpack, a column "
     "represents a point, so this option is generally not necessary.)", "r");
-
-/**
- * Calculates the sum of deviations to the Nth Power.
- *
- * @param input Vector that captures a dimension of a dataset.
- * @param rowMean Mean of the given vector.
- * @param n Degree of power.
- * @return sum of nth power deviations.
- */
-double SumNthPowerDeviations(const arma::rowvec& input,
-                             const double& fMean,
-                             size_t n)
-{
-  return sum(pow(input - fMean, static_cast<double>(n)));
-}
-
-/**
- * Calculates Skewness of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Skewness of the given vector.
- */
-double Skewness(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double skewness = 0;
-  const double S3 = pow(fStd, 3);
-  const double M3 = SumNthPowerDeviations(input, fMean, 3);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population skewness
-    skewness = M3 / (n * S3);
-  }
-  else
-  {
-    // Calculate sample skewness.
-    skewness = n * M3 / ((n - 1) * (n - 2) * S3);
-  }
-  return skewness;
-}
-
-/**
- * Calculates excess kurtosis of the given vector.
- *
- * @param input Vector that captures a dimension of a dataset
- * @param rowStd Standard Deviation of the given vector.
- * @param rowMean Mean of the given vector.
- * @return Kurtosis of the given vector.
- */
-double Kurtosis(const arma::rowvec& input,
-                const double& fStd,
-                const double& fMean,
-                const bool population)
-{
-  double kurtosis = 0;
-  const double M4 = SumNthPowerDeviations(input, fMean, 4);
-  const double n = input.n_elem;
-  if (population)
-  {
-    // Calculate population excess kurtosis.
-    const double M2 = SumNthPowerDeviations(input, fMean, 2);
-    kurtosis = n * (M4 / pow(M2, 2)) - 3;
-  }
-  else
-  {
-    // Calculate sample excess kurtosis.
-    const double S4 = pow(fStd, 4);
-    const double norm3 = (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
-    const double normC = (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3));
-    const double normM = M4 / S4;
-    kurtosis = normC * normM - norm3;
-  }
-  return kurtosis;
-}
+PARAM_VECTOR_IN(double, "quantiles", "Quantiles (between 0 and 1) to "
+    "estimate and print for each dimension.", "q");
+PARAM_INT_IN("sketch_size", "Size of the sketches used to estimate quantiles; "
+    "larger sketches are more accurate.", "k", 200);
 
 /**
  * Calculates standard error of standard deviation.
@@ -175,65 +121,157 @@ double StandardError(const size_t size, const double& fStd)
 
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
+  RequireOnlyOnePassed(params, { "input", "input_file" });
+  RequireParamValue<int>(params, "chunk_size", [](int x) { return x > 0; },
+      true, "chunk size must be positive");
+  RequireParamValue<int>(params, "sketch_size", [](int x) { return x > 1; },
+      true, "sketch size must be greater than 1");
+  RequireParamValue<std::vector<double>>(params, "quantiles",
+      [](const std::vector<double>& q)
+      {
+        return std::all_of(q.begin(), q.end(),
+            [](const double x) { return x >= 0.0 && x <= 1.0; });
+      }, true, "quantiles must be between 0 and 1");
+
   const size_t dimension = static_cast<size_t>(params.Get<int>("dimension"));
   const size_t precision = static_cast<size_t>(params.Get<int>("precision"));
   const size_t width = static_cast<size_t>(params.Get<int>("width"));
   const bool population = params.Has("population");
   const bool rowMajor = params.Has("row_major");
+  const bool streaming = params.Has("input_file");
+  const std::vector<double> quantiles =
+      params.Get<std::vector<double>>("quantiles");
+  const size_t sketchSize = static_cast<size_t>(params.Get<int>("sketch_size"));
+
+  if (streaming && rowMajor)
+  {
+    Log::Fatal << PRINT_PARAM_STRING("row_major") << " cannot be used with "
+        << PRINT_PARAM_STRING("input_file") << "!" << endl;
+  }
 
-  // Load the data.
-  arma::mat& data = params.Get<arma::mat>("input");
+  // The moments of every dimension are computed in a single pass; a sketch of
+  // each dimension is only needed for the quantiles (and for the median, if
+  // the data is not all in memory).
+  MomentsAccumulator<arma::mat> moments;
+  std::vector<KLLSketch<double>> sketches;
+  const bool sketch = streaming || !quantiles.empty();
+  arma::vec medians;
+
+  // Add the given points (one per column; each row is a dimension to
+  // describe) to the statistics.
+  auto Accumulate = [&](const arma::mat& features)
+  {
+    moments.Update(features);
+    if (!sketch)
+      return;
+
+    if (sketches.empty())
+    {
+      for (size_t i = 0; i < features.n_rows; ++i)
+        sketches.emplace_back(sketchSize, i);
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < (size_t) features.n_rows; ++i)
+      for (size_t j = 0; j < (size_t) features.n_cols; ++j)
+        sketches[i].Insert(features(i, j));
+  };
 
   timers.Start("statistics");
+  if (streaming)
+  {
+    data::CSVChunkReader reader(params.Get<string>("input_file"),
+        (size_t) params.Get<int>("chunk_size"));
+    arma::mat chunk;
+    while (reader.Next(chunk))
+    {
+      if (params.Has("dimension"))
+      {
+        if (dimension >= chunk.n_rows)
+        {
+          Log::Fatal << "Dimension " << dimension << " is out of range: "
+              << "the dataset has " << chunk.n_rows << " dimensions!" << endl;
+        }
+        Accumulate(chunk.row(dimension));
+      }
+      else
+      {
+        Accumulate(chunk);
+      }
+    }
+
+    medians.set_size(sketches.size());
+    for (size_t i = 0; i < sketches.size(); ++i)
+      medians[i] = sketches[i].Quantile(0.5);
+  }
+  else
+  {
+    // Load the data.
+    arma::mat& data = params.Get<arma::mat>("input");
+    arma::mat features;
+    if (params.Has("dimension"))
+    {
+      if (rowMajor)
+        features = ConvTo<arma::rowvec>::From(data.col(dimension));
+      else
+        features = data.row(dimension);
+    }
+    else if (rowMajor)
+    {
+      features = data.t();
+    }
+
+    // Avoid a copy when all the dimensions are described.
+    const arma::mat& described = (params.Has("dimension") || rowMajor) ?
+        features : data;
+    Accumulate(described);
+    medians = arma::median(described, 1);
+  }
+
   // Print the headers.
   Log::Info << setw(width) << "dim" << setw(width) << "var" << setw(width)
       << "mean" << setw(width) << "std" << setw(width)
       << "median" << setw(width) << "min" << setw(width)
       << "max" << setw(width) << "range" << setw(width)
-      << "skew" << setw(width) << "kurt" << setw(width) << "SE" << endl;
-
-  // Lambda function to print out the results.
-  auto PrintStatResults = [&](size_t dim, bool rowMajor)
+      << "skew" << setw(width) << "kurt" << setw(width) << "SE";
+  for (const double q : quantiles)
   {
-    arma::rowvec feature;
-    if (rowMajor)
-      feature = ConvTo<arma::rowvec>::From(data.col(dim));
-    else
-      feature = data.row(dim);
+    std::ostringstream header;
+    header << "q" << q;
+    Log::Info << setw(width) << header.str();
+  }
+  Log::Info << endl;
+
+  const size_t normType = population ? 1 : 0;
+  const arma::vec variances = moments.Variance(normType);
+  const arma::vec skewness = moments.Skewness(normType);
+  const arma::vec kurtosis = moments.Kurtosis(normType);
 
+  // If the user specified dimension, describe statistics of the given
+  // dimension. If a dimension is not specified, describe all dimensions.
+  for (size_t i = 0; i < moments.Dimensionality(); ++i)
+  {
     // f at the front of the variable names means "feature".
-    const double fMax = max(feature);
-    const double fMin = min(feature);
-    const double fMean = arma::mean(feature);
-    const double fStd = arma::stddev(feature, population);
+    const double fMax = moments.Max()[i];
+    const double fMin = moments.Min()[i];
+    const double fStd = std::sqrt(variances[i]);
 
     // Print statistics of the given dimension.
-    Log::Info << setprecision(precision) << setw(width) << dim <<
-        setw(width) << arma::var(feature, population) <<
-        setw(width) << fMean <<
+    Log::Info << setprecision(precision) << setw(width) <<
+        (params.Has("dimension") ? dimension : i) <<
+        setw(width) << variances[i] <<
+        setw(width) << moments.Mean()[i] <<
         setw(width) << fStd <<
-        setw(width) << arma::median(feature) <<
+        setw(width) << medians[i] <<
         setw(width) << fMin <<
         setw(width) << fMax <<
         setw(width) << (fMax - fMin) <<
-        setw(width) << Skewness(feature, fStd, fMean, population) <<
-        setw(width) << Kurtosis(feature, fStd, fMean, population) <<
-        setw(width) << StandardError(feature.n_elem, fStd) << endl;
-  };
-
-  // If the user specified dimension, describe statistics of the given
-  // dimension. If a dimension is not specified, describe all dimensions.
-  if (params.Has("dimension"))
-  {
-    PrintStatResults(dimension, rowMajor);
-  }
-  else
-  {
-    const size_t dimensions = rowMajor ? data.n_cols : data.n_rows;
-    for (size_t i = 0; i < dimensions; ++i)
-    {
-      PrintStatResults(i, rowMajor);
-    }
+        setw(width) << skewness[i] <<
+        setw(width) << kurtosis[i] <<
+        setw(width) << StandardError(moments.Count(), fStd);
+    for (const double q : quantiles)
+      Log::Info << setw(width) << sketches[i].Quantile(q);
+    Log::Info << endl;
   }
   timers.Stop("statistics");
 }
@@ -80,10 +80,18 @@ class ScalingModel
   template<typename MatType>
   void Transform(const MatType& input, MatType& output);
 
+  //! Transform to scale features in place.
+  template<typename MatType>
+  void Transform(MatType& data);
+
   // Fit to intialize the scaling parameter.
   template<typename MatType>
   void Fit(const MatType& input);
 
+  // Fit the scaling parameter incrementally, with one more block of points.
+  template<typename MatType>
+  void PartialFit(const MatType& input);
+
   // Scale back the dataset to their original values.
   template<typename MatType>
   void InverseTransform(const MatType& input, MatType& output);
@@ -50,6 +50,20 @@ namespace mlpack {
  * // Use the Apply() method to get a factorization.
  * qSVD.Apply(data, u, v, sigma, epsilon, delta);
  * @endcode
+ *
+ * If the matrix only changes slightly between calls to Apply() (for instance,
+ * for a sliding window of the data), the cosine tree can be warm-started from
+ * the basis of the previous call by passing `warmStart = true`.  The previous
+ * basis is then part of the subspace from the start, and the tree is only
+ * split until the part of the new matrix that it does not capture is small
+ * enough; often the tree is not split at all.  Since the basis can only grow
+ * with warm starts, it is a good idea to do a cold start every now and then.
+ *
+ * @code
+ * qSVD.Apply(data, u, v, sigma, epsilon, delta);
+ * // ... data changes slightly ...
+ * qSVD.Apply(data, u, v, sigma, epsilon, delta, true);
+ * @endcode
  */
 template<typename MatType = arma::mat>
 class QUIC_SVD
@@ -93,13 +107,17 @@ class QUIC_SVD
    * @param sigma Diagonal matrix of singular values.
    * @param epsilon Error tolerance fraction for calculated subspace.
    * @param delta Cumulative probability for Monte Carlo error lower bound.
+   * @param warmStart If true, start from the basis of the previous call (or
+   *     the basis given with Basis()); ignored if there is no such basis or
+   *     its dimensions do not match the dataset.
    */
   void Apply(const MatType& dataset,
              MatType& u,
              MatType& v,
              MatType& sigma,
              const double epsilon = 0.03,
-             const double delta = 0.1);
+             const double delta = 0.1,
+             const bool warmStart = false);
 
   /**
    * This function uses the vector subspace created using a cosine tree to
@@ -114,6 +132,11 @@ class QUIC_SVD
                   MatType& v,
                   MatType& sigma);
 
+  //! Get the subspace basis of the last decomposition.
+  const MatType& Basis() const { return basis; }
+  //! Modify the subspace basis (used by the next warm start).
+  MatType& Basis() { return basis; }
+
  private:
   //! Subspace basis of the input dataset.
   MatType basis;
@@ -44,15 +44,32 @@ inline void QUIC_SVD<MatType>::Apply(
     MatType& v,
     MatType& sigma,
     const double epsilon,
-    const double delta)
+    const double delta,
+    const bool warmStart)
 {
+  // The basis spans the columns of the matrix that the tree is built on.
+  const size_t treeRows = std::min(dataset.n_rows, dataset.n_cols);
+  MatType initialBasis;
+  if (warmStart)
+  {
+    if (basis.n_cols > 0 && basis.n_rows == treeRows)
+    {
+      initialBasis = std::move(basis);
+    }
+    else
+    {
+      Log::Warn << "QUIC_SVD::Apply(): no basis of a previous decomposition "
+          << "with " << treeRows << " rows; not warm-starting." << std::endl;
+    }
+  }
+
   // Since columns are sample in the implementation, the matrix is transposed if
   // necessary for maximum speedup.
   CosineTree<MatType>* ctree;
   if (dataset.n_cols > dataset.n_rows)
-    ctree = new CosineTree<MatType>(dataset, epsilon, delta);
+    ctree = new CosineTree<MatType>(dataset, initialBasis, epsilon, delta);
   else
-    ctree = new CosineTree<MatType>(dataset.t(), epsilon, delta);
+    ctree = new CosineTree<MatType>(dataset.t(), initialBasis, epsilon, delta);
 
   // Get subspace basis by creating the cosine tree.
   ctree->GetFinalBasis(basis);
@@ -112,7 +112,12 @@ class Radical
   template<typename MatType>
   void CopyAndPerturb(MatType& xNew, const MatType& x) const;
 
-  //! Two-dimensional version of RADICAL.
+  /**
+   * Two-dimensional version of RADICAL: return the rotation angle (in
+   * [0, pi/2)) that minimizes the entropy of the perturbed and rotated points.
+   * The candidate angles are evaluated in parallel with OpenMP.  `perturbed`
+   * and `candidate` are auxiliary memory, which is reused between calls.
+   */
   template<typename MatType>
   typename MatType::elem_type Apply2D(
       const MatType& matX,
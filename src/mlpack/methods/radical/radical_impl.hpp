@@ -47,7 +47,8 @@ inline typename VecType::elem_type Radical::Vasicek(
 {
   using ElemType = typename VecType::elem_type;
 
-  z = sort(z);
+  // Sort in place, so that no memory is allocated.
+  std::sort(z.begin(), z.end());
 
   // Apparently slower.
   /*
@@ -82,25 +83,42 @@ inline typename MatType::elem_type Radical::Apply2D(const MatType& matX,
   CopyAndPerturb(perturbed, matX);
   timers.Stop("radical_copy_and_perturb");
 
-  typename MatType::template fixed<2, 2> matJacobi;
-  VecType values(angles);
+  // The candidate angles are evaluated in parallel.  Each thread rotates the
+  // points into its own two columns of 'candidate', which are allocated once
+  // and sorted in place by Vasicek(), so no memory is allocated per angle.
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  #else
+  const size_t numThreads = 1;
+  #endif
+  const size_t nPoints = perturbed.n_rows;
+  candidate.set_size(nPoints, 2 * numThreads);
 
-  for (size_t i = 0; i < angles; ++i)
+  VecType values(angles);
+  #pragma omp parallel
   {
-    const ElemType theta = (i / (ElemType) angles) * M_PI / 2.0;
-    const ElemType cosTheta = cos(theta);
-    const ElemType sinTheta = sin(theta);
-
-    matJacobi(0, 0) = cosTheta;
-    matJacobi(1, 0) = -sinTheta;
-    matJacobi(0, 1) = sinTheta;
-    matJacobi(1, 1) = cosTheta;
+    #ifdef MLPACK_USE_OPENMP
+    const size_t thread = omp_get_thread_num();
+    #else
+    const size_t thread = 0;
+    #endif
+    VecType candidateY1(candidate.colptr(2 * thread), nPoints, false, true);
+    VecType candidateY2(candidate.colptr(2 * thread + 1), nPoints, false,
+        true);
+
+    #pragma omp for schedule(static)
+    for (size_t i = 0; i < angles; ++i)
+    {
+      const ElemType theta = (i / (ElemType) angles) * M_PI / 2.0;
+      const ElemType cosTheta = cos(theta);
+      const ElemType sinTheta = sin(theta);
 
-    candidate = perturbed * matJacobi;
-    VecType candidateY1 = candidate.unsafe_col(0);
-    VecType candidateY2 = candidate.unsafe_col(1);
+      // These are the columns of perturbed * [cos sin; -sin cos].
+      candidateY1 = cosTheta * perturbed.col(0) - sinTheta * perturbed.col(1);
+      candidateY2 = sinTheta * perturbed.col(0) + cosTheta * perturbed.col(1);
 
-    values(i) = Vasicek(candidateY1, m) + Vasicek(candidateY2, m);
+      values(i) = Vasicek(candidateY1, m) + Vasicek(candidateY2, m);
+    }
   }
 
   arma::uword indOpt = values.index_min();
@@ -168,8 +186,6 @@ inline void Radical::Apply(const MatType& matXT,
 
   MatType matYSubspace(nPoints, 2);
 
-  MatType matJ = arma::eye<MatType>(nDims, nDims);
-
   for (size_t sweepNum = 0; sweepNum < localSweeps; sweepNum++)
   {
     Log::Info << "RADICAL: sweep " << sweepNum << "." << std::endl;
@@ -190,19 +206,13 @@ inline void Radical::Apply(const MatType& matXT,
         const ElemType cosThetaOpt = cos(thetaOpt);
         const ElemType sinThetaOpt = sin(thetaOpt);
 
-        // Set elements of transformation matrix.
-        matJ(i, i) = cosThetaOpt;
-        matJ(j, i) = -sinThetaOpt;
-        matJ(i, j) = sinThetaOpt;
-        matJ(j, j) = cosThetaOpt;
-
-        matY *= matJ;
-
-        // Unset elements of transformation matrix, so matJ = eye() again.
-        matJ(i, i) = 1;
-        matJ(j, i) = 0;
-        matJ(i, j) = 0;
-        matJ(j, j) = 1;
+        // Apply the Jacobi rotation to columns i and j of matY.  Only those
+        // two columns change, so we do not multiply by the full rotation
+        // matrix; matYSubspace still holds the old columns.
+        matY.col(i) = cosThetaOpt * matYSubspace.col(0) -
+            sinThetaOpt * matYSubspace.col(1);
+        matY.col(j) = sinThetaOpt * matYSubspace.col(0) +
+            cosThetaOpt * matYSubspace.col(1);
       }
     }
   }
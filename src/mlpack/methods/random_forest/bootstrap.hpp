@@ -13,14 +13,43 @@
 #ifndef MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 #define MLPACK_METHODS_RANDOM_FOREST_BOOTSTRAP_HPP
 
+#include <mlpack/core/util/sfinae_utility.hpp>
+
 namespace mlpack {
 
+// This gives us a HasBootstrapIndices<T, U> type (where U is a function
+// pointer) we can use with SFINAE to catch when a bootstrap type can return the
+// indices of the points it samples, instead of a copy of the dataset.
+HAS_MEM_FUNC(BootstrapIndices, HasBootstrapIndices);
+
+// This struct will have `value` set to `true` if a BootstrapIndices() function
+// of the right signature is detected.  RandomForest then trains each tree on
+// the sampled indices of the original dataset, instead of on a copy.
+template<typename T>
+struct HasBootstrapIndicesForm
+{
+  static const bool value = HasBootstrapIndices<T,
+      arma::uvec(T::*)(const size_t)>::value;
+};
+
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
  */
 class DefaultBootstrap
 {
  public:
+  /**
+   * Sample the indices of a bootstrapped dataset: numPoints indices, drawn
+   * uniformly with replacement from [0, numPoints).
+   *
+   * @param numPoints Number of points in the dataset.
+   */
+  arma::uvec BootstrapIndices(const size_t numPoints)
+  {
+    // Random sampling with replacement.
+    return randi<arma::uvec>(numPoints, DistrParam(0, numPoints - 1));
+  }
+
   template<bool UseWeights,
            typename MatType,
            typename LabelsType,
@@ -37,9 +66,7 @@ class DefaultBootstrap
     if (UseWeights)
       bootstrapWeights.set_size(weights.n_elem);
 
-    // Random sampling with replacement.
-    arma::uvec indices = randi<arma::uvec>(dataset.n_cols,
-        DistrParam(0, dataset.n_cols - 1));
+    const arma::uvec indices = BootstrapIndices(dataset.n_cols);
     bootstrapDataset = dataset.cols(indices);
     bootstrapLabels = labels.cols(indices);
     if (UseWeights)
@@ -208,6 +235,25 @@ class SequentialBootstrap
     return phi;
   }
 
+  /**
+   * Sample the indices of a bootstrapped dataset with the sequential
+   * bootstrap.
+   *
+   * @param[in] numPoints Number of points in the dataset; this must be the
+   *                      number of intervals.
+   *
+   * @return A list of indices referring to the observations that
+   *         should be sampled.
+   */
+  arma::uvec BootstrapIndices(const size_t numPoints)
+  {
+    if (numPoints != intervals.n_cols)
+      throw std::invalid_argument("SequentialBootstrap::BootstrapIndices(): "
+          "number of points and intervals n_cols differ!");
+
+    return ComputeSamples(numPoints);
+  }
+
   template<
       bool UseWeights,
       typename MatType,
@@ -0,0 +1,167 @@
+/**
+ * @file methods/random_forest/flat_forest.hpp
+ *
+ * Definition of the FlatForest class, a flattened copy of the trees of a
+ * random forest that is laid out for fast classification.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/decision_tree/splits/split_traits.hpp>
+
+namespace mlpack {
+
+/**
+ * The FlatForest class holds the trees of a trained forest of DecisionTrees as
+ * contiguous arrays instead of linked nodes.  The nodes of every tree are
+ * stored breadth-first in one array of small packed structs, with the children
+ * of each node stored next to each other, so that finding the child of a point
+ * is a single comparison (or table lookup) and an addition.  The class
+ * probabilities of all leaves are the columns of one matrix.
+ *
+ * Batch classification walks blocks of points through one tree after the
+ * other, so that the nodes of a tree stay in cache while a whole block is
+ * evaluated.  The results are the same as those of the original trees.
+ *
+ * A forest can only be flattened if both its numeric and categorical split
+ * types are described by SplitTraits; see CanFlatten().
+ */
+class FlatForest
+{
+ public:
+  //! The number of points classified together by each tree in batch
+  //! classification.
+  static constexpr size_t BlockSize = 64;
+
+  /**
+   * Whether trees of the given type can be flattened: this is true when the
+   * numeric split type of the tree is a threshold split, and its categorical
+   * split type either sends each category to its own child or looks up the
+   * child of each category in a table.
+   */
+  template<typename TreeType>
+  static constexpr bool CanFlatten()
+  {
+    using NumericTraits = SplitTraits<typename TreeType::NumericSplit>;
+    using CategoricalTraits = SplitTraits<typename TreeType::CategoricalSplit>;
+    return NumericTraits::IsThresholdSplit &&
+        (CategoricalTraits::IsCategoryChildSplit ||
+         CategoricalTraits::IsCategoryTableSplit);
+  }
+
+  /**
+   * Create an empty flattened forest.
+   */
+  FlatForest() : numClasses(0) { }
+
+  /**
+   * Flatten the given trees, replacing any trees already held.  The trees
+   * must have been trained, and CanFlatten<TreeType>() must be true.
+   *
+   * @param trees Trees to flatten.
+   */
+  template<typename TreeType>
+  void Build(const std::vector<TreeType>& trees);
+
+  //! Remove all trees.
+  void Clear();
+
+  //! Return whether there are no trees.
+  bool Empty() const { return roots.empty(); }
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.size(); }
+
+  //! Get the total number of nodes of all trees.
+  size_t NumNodes() const { return nodes.size(); }
+
+  /**
+   * Compute the class probabilities of the given point, averaged over all
+   * trees.
+   *
+   * @param point Point to classify.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Probabilities(const VecType& point, arma::vec& probabilities) const;
+
+  /**
+   * Compute the class probabilities of each point of the given dataset,
+   * averaged over all trees.  Blocks of points are classified in parallel
+   * with OpenMP.
+   *
+   * @param data Dataset to classify.
+   * @param probabilities Output matrix of class probabilities of each point.
+   */
+  template<typename MatType>
+  void Probabilities(const MatType& data, arma::mat& probabilities) const;
+
+ private:
+  //! The ways a node can send points to its children.
+  enum NodeType : uint8_t
+  {
+    //! The node is a leaf.
+    Leaf,
+    //! Points with a value at most the threshold go to the first child.
+    Threshold,
+    //! A point with category c goes to child c.
+    CategoryChild,
+    //! A point with category c goes to the child given by the direction table.
+    CategoryTable
+  };
+
+  //! A node of a flattened tree.
+  struct Node
+  {
+    //! For internal nodes, the index of the first child in the node array; for
+    //! leaves, the column of the class probabilities in leafProbabilities.
+    size_t index;
+    //! The dimension this node splits on.
+    size_t splitDimension;
+    union
+    {
+      //! The threshold of a Threshold node.
+      double threshold;
+      //! The offset of the directions of a CategoryTable node in
+      //! directionTable.
+      size_t tableOffset;
+    };
+    //! The type of the node.
+    NodeType type;
+  };
+
+  /**
+   * Find the leaf of the given tree that the given point falls into.
+   *
+   * @param tree Index of the tree.
+   * @param point Point to classify; any type with operator[] (including a
+   *     pointer to the elements of the point).
+   * @return The column of the class probabilities of the leaf.
+   */
+  template<typename PointType>
+  size_t FindLeaf(const size_t tree, const PointType& point) const;
+
+  //! The nodes of all trees.
+  std::vector<Node> nodes;
+  //! The index of the root of each tree in nodes.
+  std::vector<size_t> roots;
+  //! The directions of each category of all CategoryTable nodes.
+  std::vector<size_t> directionTable;
+  //! The class probabilities of every leaf, one column per leaf.
+  arma::mat leafProbabilities;
+  //! The number of classes.
+  size_t numClasses;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "flat_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,172 @@
+/**
+ * @file methods/random_forest/flat_forest_impl.hpp
+ *
+ * Implementation of the FlatForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_FLAT_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "flat_forest.hpp"
+
+namespace mlpack {
+
+template<typename TreeType>
+void FlatForest::Build(const std::vector<TreeType>& trees)
+{
+  static_assert(CanFlatten<TreeType>(), "FlatForest::Build(): the split types "
+      "of the trees must be described by SplitTraits!");
+
+  Clear();
+  if (trees.empty())
+    return;
+
+  using CategoricalTraits = SplitTraits<typename TreeType::CategoricalSplit>;
+
+  numClasses = trees[0].NumClasses();
+  std::vector<double> leafValues;
+  std::vector<const TreeType*> queue;
+  for (size_t t = 0; t < trees.size(); ++t)
+  {
+    // Lay out the nodes of the tree breadth-first, so that the children of
+    // each node are next to each other.
+    const size_t root = nodes.size();
+    roots.push_back(root);
+    queue.clear();
+    queue.push_back(&trees[t]);
+    for (size_t q = 0; q < queue.size(); ++q)
+    {
+      const TreeType& tree = *queue[q];
+
+      Node node;
+      if (tree.NumChildren() == 0)
+      {
+        node.type = Leaf;
+        node.index = leafValues.size() / numClasses;
+        node.splitDimension = 0;
+        node.threshold = 0.0;
+        const arma::vec& probabilities = tree.ClassProbabilities();
+        leafValues.insert(leafValues.end(), probabilities.begin(),
+            probabilities.end());
+      }
+      else
+      {
+        node.index = root + queue.size();
+        node.splitDimension = tree.SplitDimension();
+        if (tree.SplitDimensionType() == data::Datatype::categorical)
+        {
+          if (CategoricalTraits::IsCategoryChildSplit)
+          {
+            node.type = CategoryChild;
+            node.tableOffset = 0;
+          }
+          else
+          {
+            node.type = CategoryTable;
+            node.tableOffset = directionTable.size();
+            const arma::vec& splitInfo = tree.ClassProbabilities();
+            for (size_t c = 0; c < splitInfo.n_elem; ++c)
+              directionTable.push_back((size_t) splitInfo[c]);
+          }
+        }
+        else
+        {
+          node.type = Threshold;
+          node.threshold = tree.ClassProbabilities()[0];
+        }
+
+        for (size_t c = 0; c < tree.NumChildren(); ++c)
+          queue.push_back(&tree.Child(c));
+      }
+
+      nodes.push_back(node);
+    }
+  }
+
+  leafProbabilities = arma::mat(leafValues.data(), numClasses,
+      leafValues.size() / numClasses);
+}
+
+inline void FlatForest::Clear()
+{
+  nodes.clear();
+  roots.clear();
+  directionTable.clear();
+  leafProbabilities.clear();
+  numClasses = 0;
+}
+
+template<typename PointType>
+size_t FlatForest::FindLeaf(const size_t tree, const PointType& point) const
+{
+  const Node* node = &nodes[roots[tree]];
+  while (node->type != Leaf)
+  {
+    const double value = point[node->splitDimension];
+    size_t child;
+    if (node->type == Threshold)
+      child = (value <= node->threshold) ? 0 : 1;
+    else if (node->type == CategoryChild)
+      child = (size_t) value;
+    else
+      child = directionTable[node->tableOffset + (size_t) value];
+
+    node = &nodes[node->index + child];
+  }
+
+  return node->index;
+}
+
+template<typename VecType>
+void FlatForest::Probabilities(const VecType& point,
+                               arma::vec& probabilities) const
+{
+  probabilities.zeros(numClasses);
+  for (size_t t = 0; t < roots.size(); ++t)
+    probabilities += leafProbabilities.col(FindLeaf(t, point));
+
+  probabilities /= roots.size();
+}
+
+template<typename MatType>
+void FlatForest::Probabilities(const MatType& data,
+                               arma::mat& probabilities) const
+{
+  probabilities.zeros(numClasses, data.n_cols);
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t end = std::min(begin + BlockSize, (size_t) data.n_cols);
+
+    // Each tree classifies the whole block before moving to the next tree, so
+    // that the nodes of the tree are only loaded once per block.
+    for (size_t t = 0; t < roots.size(); ++t)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        // Dense points are read through a pointer to their elements.
+        size_t leaf;
+        if constexpr (arma::is_arma_sparse_type<MatType>::value)
+          leaf = FindLeaf(t, data.col(i));
+        else
+          leaf = FindLeaf(t, data.colptr(i));
+
+        probabilities.col(i) += leafProbabilities.col(leaf);
+      }
+    }
+  }
+
+  probabilities /= roots.size();
+}
+
+} // namespace mlpack
+
+#endif
@@ -14,6 +14,7 @@
 
 #include <mlpack/methods/decision_tree/decision_tree.hpp>
 #include "bootstrap.hpp"
+#include "flat_forest.hpp"
 
 namespace mlpack {
 
@@ -373,12 +374,27 @@ class RandomForest
 
   //! Access a tree in the forest.
   const DecisionTreeType& Tree(const size_t i) const { return trees[i]; }
-  //! Modify a tree in the forest (be careful!).
+  //! Modify a tree in the forest (be careful!).  Call Compile() afterwards so
+  //! that Classify() uses the modified tree.
   DecisionTreeType& Tree(const size_t i) { return trees[i]; }
 
   //! Get the number of trees in the forest.
   size_t NumTrees() const { return trees.size(); }
 
+  /**
+   * Lay out the trees of the forest as contiguous arrays (see FlatForest),
+   * which Classify() then uses instead of walking the nodes of each tree.
+   * This is done automatically after training and loading, so it only needs
+   * to be called after modifying a tree with Tree().  If the split types of
+   * the forest cannot be flattened, this does nothing and Classify() uses the
+   * trees directly.
+   */
+  void Compile();
+
+  //! Get the flattened layout of the trees (empty if the forest has not been
+  //! compiled).
+  const FlatForest& Flat() const { return flatForest; }
+
   /**
    * Serialize the random forest.
    */
@@ -431,6 +447,9 @@ class RandomForest
   //! The trees in the forest.
   std::vector<DecisionTreeType> trees;
 
+  //! The trees laid out for classification.
+  FlatForest flatForest;
+
   //! The average gain of the forest.
   double avgGain;
 };
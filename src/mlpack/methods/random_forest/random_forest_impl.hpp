@@ -378,6 +378,13 @@ void RandomForest<
         "trained!");
   }
 
+  if (!flatForest.Empty())
+  {
+    flatForest.Probabilities(point, probabilities);
+    prediction = (size_t) probabilities.index_max();
+    return;
+  }
+
   probabilities.zeros(trees[0].NumClasses());
   for (size_t i = 0; i < trees.size(); ++i)
   {
@@ -424,6 +431,13 @@ void RandomForest<
         "trained!");
   }
 
+  if (!flatForest.Empty())
+  {
+    arma::mat probabilities;
+    Classify(data, predictions, probabilities);
+    return;
+  }
+
   predictions.set_size(data.n_cols);
 
   #pragma omp parallel for
@@ -463,6 +477,15 @@ void RandomForest<
         "trained!");
   }
 
+  if (!flatForest.Empty())
+  {
+    flatForest.Probabilities(data, probabilities);
+    predictions.set_size(data.n_cols);
+    for (size_t i = 0; i < data.n_cols; ++i)
+      predictions[i] = (size_t) probabilities.col(i).index_max();
+    return;
+  }
+
   probabilities.set_size(trees[0].NumClasses(), data.n_cols);
   predictions.set_size(data.n_cols);
   #pragma omp parallel for
@@ -505,6 +528,33 @@ void RandomForest<
 
   ar(CEREAL_NVP(trees));
   ar(CEREAL_NVP(avgGain));
+
+  // The flattened trees are not serialized; rebuild them instead.
+  if (cereal::is_loading<Archive>())
+    Compile();
+}
+
+template<
+    typename FitnessFunction,
+    typename DimensionSelectionType,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    bool UseBootstrap,
+    typename BootstrapType
+>
+void RandomForest<
+    FitnessFunction,
+    DimensionSelectionType,
+    NumericSplitType,
+    CategoricalSplitType,
+    UseBootstrap,
+    BootstrapType
+>::Compile()
+{
+  if constexpr (FlatForest::CanFlatten<DecisionTreeType>())
+    flatForest.Build(trees);
+  else
+    flatForest.Clear();
 }
 
 template<
@@ -545,7 +595,9 @@ double RandomForest<
   // Convert avgGain to total gain.
   double totalGain = avgGain * oldNumTrees;
 
-  // Train each tree individually.
+  // Train each tree individually.  BLAS is single-threaded meanwhile, since
+  // each tree may call it.
+  ThreadBudget budget;
   #pragma omp parallel for reduction( + : totalGain)
   for (size_t i = 0; i < numTrees; ++i)
   {
@@ -567,26 +619,46 @@ double RandomForest<
       #endif
     #endif
 
+    // When the bootstrap policy can sample indices, each tree is trained on
+    // its sampled points of the shared dataset, so the dataset is never copied
+    // and only O(n) memory is used for each tree.  Otherwise the tree is
+    // trained on the dataset created by the bootstrap policy.
     MatType bootstrapDataset;
+    arma::uvec indices;
     arma::Row<size_t> bootstrapLabels;
     arma::rowvec bootstrapWeights;
-    bootstrap.template Bootstrap<UseWeights>(dataset, labels, weights,
-        bootstrapDataset, bootstrapLabels, bootstrapWeights);
+    if constexpr (HasBootstrapIndicesForm<BootstrapType>::value)
+    {
+      indices = bootstrap.BootstrapIndices(dataset.n_cols);
+      bootstrapLabels = labels.cols(indices);
+      if (UseWeights)
+        bootstrapWeights = weights.cols(indices);
+    }
+    else
+    {
+      bootstrap.template Bootstrap<UseWeights>(dataset, labels, weights,
+          bootstrapDataset, bootstrapLabels, bootstrapWeights);
+      indices = arma::regspace<arma::uvec>(0, bootstrapDataset.n_cols - 1);
+    }
 
+    const MatType& treeDataset = HasBootstrapIndicesForm<BootstrapType>::value ?
+        dataset : bootstrapDataset;
     if (UseWeights)
     {
       if (UseDatasetInfo)
       {
         totalGain +=
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, bootstrapWeights, minimumLeafSize,
+            trees[oldNumTrees + i].Train(treeDataset, std::move(indices),
+                datasetInfo, std::move(bootstrapLabels), numClasses,
+                std::move(bootstrapWeights), minimumLeafSize,
                 minimumGainSplit, maximumDepth, dimensionSelector);
       }
       else
       {
         totalGain +=
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, bootstrapWeights, minimumLeafSize,
+            trees[oldNumTrees + i].Train(treeDataset, std::move(indices),
+                std::move(bootstrapLabels), numClasses,
+                std::move(bootstrapWeights), minimumLeafSize,
                 minimumGainSplit, maximumDepth, dimensionSelector);
       }
     }
@@ -595,21 +667,23 @@ double RandomForest<
       if (UseDatasetInfo)
       {
         totalGain +=
-            trees[oldNumTrees + i].Train(bootstrapDataset, datasetInfo,
-                bootstrapLabels, numClasses, minimumLeafSize, minimumGainSplit,
-                maximumDepth, dimensionSelector);
+            trees[oldNumTrees + i].Train(treeDataset, std::move(indices),
+                datasetInfo, std::move(bootstrapLabels), numClasses,
+                minimumLeafSize, minimumGainSplit, maximumDepth,
+                dimensionSelector);
       }
       else
       {
         totalGain +=
-            trees[oldNumTrees + i].Train(bootstrapDataset, bootstrapLabels,
-                numClasses, minimumLeafSize, minimumGainSplit, maximumDepth,
-                dimensionSelector);
+            trees[oldNumTrees + i].Train(treeDataset, std::move(indices),
+                std::move(bootstrapLabels), numClasses, minimumLeafSize,
+                minimumGainSplit, maximumDepth, dimensionSelector);
       }
     }
   }
 
   avgGain = totalGain / trees.size();
+  Compile();
   return avgGain;
 }
 
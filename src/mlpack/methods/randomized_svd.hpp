@@ -1,7 +1,8 @@
 /**
  * @file randomized_svd.hpp
  *
- * Convenience include for mlpack/methods/randomized_svd/randomized_svd.hpp
+ * Convenience include for mlpack/methods/randomized_svd/randomized_svd.hpp and
+ * mlpack/methods/randomized_svd/streaming_randomized_svd.hpp.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -12,5 +13,6 @@
 #define MLPACK_RANDOMIZED_SVD_HPP
 
 #include "randomized_svd/randomized_svd.hpp"
+#include "randomized_svd/streaming_randomized_svd.hpp"
 
 #endif
@@ -0,0 +1,200 @@
+/**
+ * @file methods/randomized_svd/column_sources.hpp
+ *
+ * Sources that hand the columns of a matrix to StreamingRandomizedSVD one
+ * block at a time, so that the matrix does not have to be held in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_COLUMN_SOURCES_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_COLUMN_SOURCES_HPP
+
+#include <mlpack/core.hpp>
+
+namespace mlpack {
+
+/**
+ * A column source over a matrix that is already in memory.  Each block is an
+ * alias of the columns of the matrix, so no data is copied.  This is mostly
+ * useful to run StreamingRandomizedSVD on a matrix that fits in memory, or as
+ * a model for other sources.
+ *
+ * Any class with the same four functions (Rows(), Cols(), Reset() and Next())
+ * can be used as a column source.
+ *
+ * @tparam MatType Type of the matrix.
+ */
+template<typename MatType = arma::mat>
+class MatrixColumnSource
+{
+ public:
+  /**
+   * Create the source over the given matrix, which must outlive the source.
+   *
+   * @param matrix Matrix whose columns are given.
+   * @param blockSize Number of columns in each block.
+   */
+  MatrixColumnSource(const MatType& matrix, const size_t blockSize = 1024) :
+      matrix(matrix),
+      blockSize(std::max(blockSize, (size_t) 1)),
+      position(0)
+  {
+    // Nothing to do.
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t Rows() const { return matrix.n_rows; }
+  //! Get the number of columns of the matrix.
+  size_t Cols() const { return matrix.n_cols; }
+
+  //! Start again from the first column.
+  void Reset() { position = 0; }
+
+  /**
+   * Get the next block of columns.  Returns false (and leaves the block
+   * unchanged) when all columns were given.
+   *
+   * @param block Matrix to store the next block of columns in.
+   */
+  bool Next(MatType& block)
+  {
+    if (position >= matrix.n_cols)
+      return false;
+
+    const size_t count = std::min(blockSize, (size_t) matrix.n_cols -
+        position);
+    MakeAlias(block, matrix, matrix.n_rows, count, position * matrix.n_rows,
+        false);
+    position += count;
+    return true;
+  }
+
+ private:
+  //! The matrix whose columns are given.
+  const MatType& matrix;
+  //! Number of columns in each block.
+  size_t blockSize;
+  //! Index of the next column to give.
+  size_t position;
+};
+
+/**
+ * A column source that reads the columns of a dense matrix from a file in
+ * Armadillo's binary format (as written by `matrix.save(filename,
+ * arma::arma_binary)`), one block at a time.  The elements of the file are
+ * stored column by column, so each block is one contiguous read, and only one
+ * block is held in memory at a time.
+ *
+ * Note that `data::Save()` transposes matrices by default, so a matrix saved
+ * with it has to be saved with `transpose = false` for its columns to be the
+ * points.
+ *
+ * @tparam MatType Type of the blocks; its element type must match the file.
+ */
+template<typename MatType = arma::mat>
+class BinaryFileColumnSource
+{
+ public:
+  //! The element type of the matrix.
+  using ElemType = typename MatType::elem_type;
+
+  /**
+   * Open the given file and read its header.  std::runtime_error is thrown if
+   * the file cannot be opened or is not a binary Armadillo matrix with the
+   * element type of MatType.
+   *
+   * @param filename File to read.
+   * @param blockSize Number of columns in each block.
+   */
+  BinaryFileColumnSource(const std::string& filename,
+                         const size_t blockSize = 1024) :
+      blockSize(std::max(blockSize, (size_t) 1)),
+      rows(0),
+      cols(0),
+      position(0)
+  {
+    static_assert(std::is_same<ElemType, double>::value ||
+        std::is_same<ElemType, float>::value, "BinaryFileColumnSource: only "
+        "float and double matrices are supported!");
+    const std::string expected = std::is_same<ElemType, float>::value ?
+        "ARMA_MAT_BIN_FN004" : "ARMA_MAT_BIN_FN008";
+
+    stream.open(filename, std::ios::in | std::ios::binary);
+    if (!stream.is_open())
+    {
+      throw std::runtime_error("BinaryFileColumnSource: cannot open '" +
+          filename + "'!");
+    }
+
+    std::string header;
+    stream >> header >> rows >> cols;
+    stream.get();
+    if (!stream.good() || header != expected)
+    {
+      throw std::runtime_error("BinaryFileColumnSource: '" + filename + "' is "
+          "not a binary Armadillo matrix with the expected element type!");
+    }
+
+    dataStart = stream.tellg();
+  }
+
+  //! Get the number of rows of the matrix.
+  size_t Rows() const { return rows; }
+  //! Get the number of columns of the matrix.
+  size_t Cols() const { return cols; }
+
+  //! Start again from the first column.
+  void Reset()
+  {
+    stream.clear();
+    stream.seekg(dataStart);
+    position = 0;
+  }
+
+  /**
+   * Read the next block of columns.  Returns false (and leaves the block
+   * unchanged) when all columns were read.  std::runtime_error is thrown if
+   * the file ends early.
+   *
+   * @param block Matrix to store the next block of columns in.
+   */
+  bool Next(MatType& block)
+  {
+    if (position >= cols)
+      return false;
+
+    const size_t count = std::min(blockSize, cols - position);
+    block.set_size(rows, count);
+    stream.read(reinterpret_cast<char*>(block.memptr()),
+        std::streamsize(block.n_elem * sizeof(ElemType)));
+    if (!stream.good())
+    {
+      throw std::runtime_error("BinaryFileColumnSource: the file ended before "
+          "all columns were read!");
+    }
+
+    position += count;
+    return true;
+  }
+
+ private:
+  //! The file that is read.
+  std::ifstream stream;
+  //! Position of the first element in the file.
+  std::streampos dataStart;
+  //! Number of columns in each block.
+  size_t blockSize;
+  //! Number of rows of the matrix.
+  size_t rows;
+  //! Number of columns of the matrix.
+  size_t cols;
+  //! Index of the next column to read.
+  size_t position;
+};
+
+} // namespace mlpack
+
+#endif
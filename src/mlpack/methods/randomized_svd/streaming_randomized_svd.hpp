@@ -0,0 +1,183 @@
+/**
+ * @file methods/randomized_svd/streaming_randomized_svd.hpp
+ *
+ * A randomized SVD of a matrix whose columns are read one block at a time, so
+ * that the matrix never has to be held in memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_STREAMING_RANDOMIZED_SVD_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_STREAMING_RANDOMIZED_SVD_HPP
+
+#include <mlpack/core.hpp>
+
+#include "column_sources.hpp"
+
+namespace mlpack {
+
+/**
+ * StreamingRandomizedSVD computes a truncated SVD of an m x n matrix A from a
+ * column source, which hands the columns of A out one block at a time (see
+ * MatrixColumnSource and BinaryFileColumnSource).  Only one block of A is
+ * held in memory at a time, along with sketches with `rank + oversampling`
+ * columns, so matrices that are larger than the memory can be decomposed, as
+ * long as the m x k and n x k factors fit.
+ *
+ * Apply() is the randomized subspace iteration of RandomizedSVD: one pass
+ * computes the range sketch `Y = A * Omega` for a Gaussian `Omega`, each power
+ * iteration is one more pass that computes `A * (A^T * Q)` block by block, and
+ * a last pass projects A onto the basis Q; so it reads A
+ * `2 + powerIterations` times.  If `krylov` is true, the bases of all power
+ * iterations are kept and orthonormalized together, like
+ * RandomizedBlockKrylovSVD does, for more accurate singular vectors.
+ *
+ * ApplySinglePass() reads A only once, which is the only option if the
+ * columns can only be read once (for instance from a network stream).  It
+ * uses the single-pass sketch of
+ *
+ * @code
+ * @article{tropp2017practical,
+ *   title={{Practical Sketching Algorithms for Low-Rank Matrix
+ *       Approximation}},
+ *   author={Tropp, J.A. and Yurtsever, A. and Udell, M. and Cevher, V.},
+ *   journal={SIAM Journal on Matrix Analysis and Applications},
+ *   volume={38},
+ *   number={4},
+ *   pages={1454--1485},
+ *   year={2017}
+ * }
+ * @endcode
+ *
+ * which accumulates the range sketch along with a co-range sketch
+ * `W = Psi * A`, and recovers the factorization from both of them; it is less
+ * accurate than Apply() when the singular values decay slowly.
+ *
+ * Within each block, the products with the sketches are split over the
+ * columns of the block and computed in parallel with OpenMP.  If `center` is
+ * true, the decomposition is that of A with its mean column subtracted (as
+ * RandomizedSVD does); the mean is accumulated during the first pass, since
+ * all the sketches are linear in A.
+ *
+ * @code
+ * // The columns of data.bin are read 1024 at a time.
+ * BinaryFileColumnSource<> source("data.bin", 1024);
+ *
+ * arma::mat u, v;
+ * arma::vec s;
+ * StreamingRandomizedSVD svd;
+ * svd.Apply(source, u, s, v, 20);
+ * @endcode
+ */
+class StreamingRandomizedSVD
+{
+ public:
+  /**
+   * Create the object, setting the parameters of the decomposition.
+   *
+   * @param powerIterations Number of power iterations, each of which is one
+   *     more pass over the data (only used by Apply()).
+   * @param oversampling Number of extra columns of the sketches.
+   * @param krylov Whether to keep the bases of all power iterations (the
+   *     block Krylov subspace), instead of only the last one.
+   * @param center Whether to subtract the mean column from the data.
+   */
+  StreamingRandomizedSVD(const size_t powerIterations = 2,
+                         const size_t oversampling = 10,
+                         const bool krylov = false,
+                         const bool center = false);
+
+  /**
+   * Compute the truncated SVD of the matrix given by the column source with
+   * `2 + powerIterations` passes over it.
+   *
+   * @param source Source of the columns of the matrix.
+   * @param u Left singular vectors (m x rank).
+   * @param s Singular values.
+   * @param v Right singular vectors (n x rank).
+   * @param rank Rank of the decomposition.
+   */
+  template<typename SourceType, typename MatType, typename VecType>
+  void Apply(SourceType& source,
+             MatType& u,
+             VecType& s,
+             MatType& v,
+             const size_t rank);
+
+  /**
+   * Compute the truncated SVD of the matrix given by the column source with a
+   * single pass over it.
+   *
+   * @param source Source of the columns of the matrix.
+   * @param u Left singular vectors (m x rank).
+   * @param s Singular values.
+   * @param v Right singular vectors (n x rank).
+   * @param rank Rank of the decomposition.
+   */
+  template<typename SourceType, typename MatType, typename VecType>
+  void ApplySinglePass(SourceType& source,
+                       MatType& u,
+                       VecType& s,
+                       MatType& v,
+                       const size_t rank);
+
+  //! Get the number of power iterations.
+  size_t PowerIterations() const { return powerIterations; }
+  //! Modify the number of power iterations.
+  size_t& PowerIterations() { return powerIterations; }
+
+  //! Get the number of extra columns of the sketches.
+  size_t Oversampling() const { return oversampling; }
+  //! Modify the number of extra columns of the sketches.
+  size_t& Oversampling() { return oversampling; }
+
+  //! Get whether the block Krylov subspace is used.
+  bool Krylov() const { return krylov; }
+  //! Modify whether the block Krylov subspace is used.
+  bool& Krylov() { return krylov; }
+
+  //! Get whether the mean column is subtracted.
+  bool Center() const { return center; }
+  //! Modify whether the mean column is subtracted.
+  bool& Center() { return center; }
+
+ private:
+  /**
+   * Compute `result += block * right`, splitting the columns of the block
+   * over the threads.
+   */
+  template<typename MatType>
+  static void AccumulateProduct(const MatType& block,
+                                const MatType& right,
+                                MatType& result);
+
+  /**
+   * Compute `result = block^T * right`, splitting the columns of the block
+   * over the threads.
+   */
+  template<typename MatType>
+  static void TransposedProduct(const MatType& block,
+                                const MatType& right,
+                                MatType& result);
+
+  //! Number of columns of each thread's share of a block.
+  static constexpr size_t ChunkSize = 256;
+
+  //! Number of power iterations.
+  size_t powerIterations;
+  //! Number of extra columns of the sketches.
+  size_t oversampling;
+  //! Whether the block Krylov subspace is used.
+  bool krylov;
+  //! Whether the mean column is subtracted.
+  bool center;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "streaming_randomized_svd_impl.hpp"
+
+#endif
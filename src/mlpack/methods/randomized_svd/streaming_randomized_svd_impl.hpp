@@ -0,0 +1,268 @@
+/**
+ * @file methods/randomized_svd/streaming_randomized_svd_impl.hpp
+ *
+ * Implementation of the StreamingRandomizedSVD class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOMIZED_SVD_STREAMING_RANDOMIZED_SVD_IMPL_HPP
+#define MLPACK_METHODS_RANDOMIZED_SVD_STREAMING_RANDOMIZED_SVD_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "streaming_randomized_svd.hpp"
+
+namespace mlpack {
+
+inline StreamingRandomizedSVD::StreamingRandomizedSVD(
+    const size_t powerIterations,
+    const size_t oversampling,
+    const bool krylov,
+    const bool center) :
+    powerIterations(powerIterations),
+    oversampling(oversampling),
+    krylov(krylov),
+    center(center)
+{
+  /* Nothing to do here */
+}
+
+template<typename SourceType, typename MatType, typename VecType>
+inline void StreamingRandomizedSVD::Apply(SourceType& source,
+                                          MatType& u,
+                                          VecType& s,
+                                          MatType& v,
+                                          const size_t rank)
+{
+  const size_t m = source.Rows();
+  const size_t n = source.Cols();
+  const size_t k = std::min(rank + oversampling, std::min(m, n));
+
+  MatType block, omega, z, q, r, mean;
+  MatType y(m, k, arma::fill::zeros);
+  MatType colSum(m, 1, arma::fill::zeros);
+  MatType omegaSum(1, k, arma::fill::zeros);
+
+  // The first pass computes the range sketch, and the mean column if needed.
+  source.Reset();
+  while (source.Next(block))
+  {
+    omega.randn(block.n_cols, k);
+    AccumulateProduct(block, omega, y);
+    if (center)
+    {
+      colSum += sum(block, 1);
+      omegaSum += sum(omega, 0);
+    }
+  }
+
+  // The sketch of the centered data is A * Omega - mean * (1^T * Omega).
+  if (center)
+  {
+    mean = colSum / n;
+    y -= mean * omegaSum;
+  }
+
+  arma::qr_econ(q, r, y);
+  MatType basis = q;
+
+  // Each power iteration computes A * (A^T * Q) in one pass.
+  for (size_t i = 0; i < powerIterations; ++i)
+  {
+    y.zeros(m, q.n_cols);
+    MatType zSum(1, q.n_cols, arma::fill::zeros);
+    MatType meanQ;
+    if (center)
+      meanQ = mean.t() * q;
+
+    source.Reset();
+    while (source.Next(block))
+    {
+      TransposedProduct(block, q, z);
+      if (center)
+      {
+        z.each_row() -= meanQ;
+        zSum += sum(z, 0);
+      }
+      AccumulateProduct(block, z, y);
+    }
+
+    if (center)
+      y -= mean * zSum;
+
+    arma::qr_econ(q, r, y);
+    if (krylov)
+      basis = arma::join_rows(basis, q);
+    else
+      basis = q;
+  }
+
+  if (krylov && powerIterations > 0)
+    arma::qr_econ(q, r, basis);
+
+  // The last pass projects the data onto the basis: B = Q^T * A.
+  MatType b(q.n_cols, n);
+  MatType qMean;
+  if (center)
+    qMean = q.t() * mean;
+
+  size_t col = 0;
+  source.Reset();
+  while (source.Next(block))
+  {
+    if (col + block.n_cols > n)
+    {
+      throw std::invalid_argument("StreamingRandomizedSVD::Apply(): the source "
+          "gave more columns than Cols()!");
+    }
+
+    TransposedProduct(block, q, z);
+    b.cols(col, col + block.n_cols - 1) = z.t();
+    if (center)
+      b.cols(col, col + block.n_cols - 1).each_col() -= qMean;
+    col += block.n_cols;
+  }
+
+  MatType ub;
+  arma::svd_econ(ub, s, v, b);
+  u = q * ub;
+
+  if (s.n_elem > rank)
+  {
+    u.shed_cols(rank, u.n_cols - 1);
+    s.shed_rows(rank, s.n_elem - 1);
+    v.shed_cols(rank, v.n_cols - 1);
+  }
+}
+
+template<typename SourceType, typename MatType, typename VecType>
+inline void StreamingRandomizedSVD::ApplySinglePass(SourceType& source,
+                                                    MatType& u,
+                                                    VecType& s,
+                                                    MatType& v,
+                                                    const size_t rank)
+{
+  const size_t m = source.Rows();
+  const size_t n = source.Cols();
+  const size_t k = std::min(rank + oversampling, std::min(m, n));
+  // The co-range sketch needs more rows than the range sketch has columns, so
+  // that the least-squares problem below is well-posed.
+  const size_t l = std::min(2 * k + 1, m);
+
+  // The columns of psiT are the rows of the test matrix Psi.
+  const MatType psiT = arma::randn<MatType>(m, l);
+
+  MatType block, omega, z, q, r;
+  MatType y(m, k, arma::fill::zeros);
+  MatType w(l, n);
+  MatType colSum(m, 1, arma::fill::zeros);
+  MatType omegaSum(1, k, arma::fill::zeros);
+
+  // Accumulate the range sketch Y = A * Omega, and fill the co-range sketch
+  // W = Psi * A one block of columns at a time.
+  size_t col = 0;
+  source.Reset();
+  while (source.Next(block))
+  {
+    if (col + block.n_cols > n)
+    {
+      throw std::invalid_argument("StreamingRandomizedSVD::ApplySinglePass(): "
+          "the source gave more columns than Cols()!");
+    }
+
+    omega.randn(block.n_cols, k);
+    AccumulateProduct(block, omega, y);
+    TransposedProduct(block, psiT, z);
+    w.cols(col, col + block.n_cols - 1) = z.t();
+
+    if (center)
+    {
+      colSum += sum(block, 1);
+      omegaSum += sum(omega, 0);
+    }
+    col += block.n_cols;
+  }
+
+  // Both sketches are linear in the data, so they are centered afterwards.
+  if (center)
+  {
+    const MatType mean = colSum / n;
+    y -= mean * omegaSum;
+    w.each_col() -= psiT.t() * mean;
+  }
+
+  // A is approximated by Q * X, where X minimizes ||(Psi * Q) * X - W||.
+  arma::qr_econ(q, r, y);
+  MatType x;
+  if (!arma::solve(x, psiT.t() * q, w))
+  {
+    throw std::runtime_error("StreamingRandomizedSVD::ApplySinglePass(): "
+        "could not solve for the factorization!");
+  }
+
+  MatType ux;
+  arma::svd_econ(ux, s, v, x);
+  u = q * ux;
+
+  if (s.n_elem > rank)
+  {
+    u.shed_cols(rank, u.n_cols - 1);
+    s.shed_rows(rank, s.n_elem - 1);
+    v.shed_cols(rank, v.n_cols - 1);
+  }
+}
+
+template<typename MatType>
+inline void StreamingRandomizedSVD::AccumulateProduct(const MatType& block,
+                                                      const MatType& right,
+                                                      MatType& result)
+{
+  const size_t numChunks = (block.n_cols + ChunkSize - 1) / ChunkSize;
+  if (numChunks <= 1)
+  {
+    result += block * right;
+    return;
+  }
+
+  // Each thread sums the products of its chunks, and then adds them to the
+  // result.
+  #pragma omp parallel
+  {
+    MatType partial(result.n_rows, result.n_cols, arma::fill::zeros);
+
+    #pragma omp for schedule(static)
+    for (size_t c = 0; c < numChunks; ++c)
+    {
+      const size_t begin = c * ChunkSize;
+      const size_t end = std::min(begin + ChunkSize, (size_t) block.n_cols) - 1;
+      partial += block.cols(begin, end) * right.rows(begin, end);
+    }
+
+    #pragma omp critical
+    result += partial;
+  }
+}
+
+template<typename MatType>
+inline void StreamingRandomizedSVD::TransposedProduct(const MatType& block,
+                                                      const MatType& right,
+                                                      MatType& result)
+{
+  const size_t numChunks = (block.n_cols + ChunkSize - 1) / ChunkSize;
+  result.set_size(block.n_cols, right.n_cols);
+
+  // The rows of the result are independent.
+  #pragma omp parallel for schedule(static)
+  for (size_t c = 0; c < numChunks; ++c)
+  {
+    const size_t begin = c * ChunkSize;
+    const size_t end = std::min(begin + ChunkSize, (size_t) block.n_cols) - 1;
+    result.rows(begin, end) = block.cols(begin, end).t() * right;
+  }
+}
+
+} // namespace mlpack
+
+#endif
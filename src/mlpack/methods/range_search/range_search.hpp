@@ -16,6 +16,8 @@
 #include <mlpack/prereqs.hpp>
 #include <mlpack/core/distances/lmetric.hpp>
 #include <mlpack/core/tree/binary_space_tree.hpp>
+#include <mlpack/core/tree/query_frontier.hpp>
+#include <mlpack/core/tree/symmetric_dual_tree_traverser.hpp>
 #include "range_search_stat.hpp"
 
 namespace mlpack {
@@ -23,7 +25,8 @@ namespace mlpack {
 //! Forward declaration.
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType>
 class LeafSizeRSWrapper;
 
 /**
@@ -271,6 +274,63 @@ class RangeSearch
               std::vector<std::vector<size_t>>& neighbors,
               std::vector<std::vector<ElemType>>& distances);
 
+  /**
+   * Search for all reference points in the given range for each point in the
+   * query set, and pass each result to the given callback as soon as it is
+   * found, as callback(queryIndex, referenceIndex, distance).  No results are
+   * stored, so the memory used does not depend on the number of results.  The
+   * indices are the indices in the original query and reference sets, and the
+   * results are passed in no particular order.
+   *
+   * When OpenMP is used, the callback may be called from several threads at
+   * once, but all the results of one query point are passed by the same
+   * thread.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param callback Callback that receives the results.
+   */
+  template<typename CallbackType>
+  void Search(const MatType& querySet,
+              const RangeType<ElemType>& range,
+              CallbackType&& callback);
+
+  /**
+   * Search for all points in the given range for each point in the reference
+   * set, and pass each result to the given callback as soon as it is found, as
+   * callback(queryIndex, referenceIndex, distance).  A point is not returned in
+   * its own results.  See the overload with a query set for details.
+   *
+   * @param range Range of distances in which to search.
+   * @param callback Callback that receives the results.
+   */
+  template<typename CallbackType>
+  void Search(const RangeType<ElemType>& range, CallbackType&& callback);
+
+  /**
+   * Count the reference points in the given range for each point in the query
+   * set, without storing them; counts[i] is the number of reference points in
+   * the range of query point i.  This is useful for density estimation.
+   *
+   * @param querySet Set of query points to search with.
+   * @param range Range of distances in which to search.
+   * @param counts Vector to store the number of points in the range of each
+   *      query point in.
+   */
+  void Count(const MatType& querySet,
+             const RangeType<ElemType>& range,
+             arma::Col<size_t>& counts);
+
+  /**
+   * Count the other reference points in the given range for each point in the
+   * reference set, without storing them.
+   *
+   * @param range Range of distances in which to search.
+   * @param counts Vector to store the number of points in the range of each
+   *      reference point in.
+   */
+  void Count(const RangeType<ElemType>& range, arma::Col<size_t>& counts);
+
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return singleMode; }
   //! Modify whether single-tree search is being used.
@@ -281,11 +341,30 @@ class RangeSearch
   //! Modify whether naive search is being used.
   bool& Naive() { return naive; }
 
+  //! Get whether monochromatic searches are symmetric self-joins.
+  bool Symmetric() const { return symmetric; }
+  //! Modify whether monochromatic searches (without a query set) are symmetric
+  //! self-joins.  Dual-tree and naive searches then evaluate each pair of
+  //! points only once and record it for both points, which nearly halves the
+  //! number of base cases; the order of the results of each point may differ.
+  //! The reference tree must hold each point in exactly one leaf (see
+  //! SymmetricTraversalTraits); otherwise, and in single-tree mode, this is
+  //! ignored.  This is not serialized.
+  bool& Symmetric() { return symmetric; }
+
   //! Get the number of base cases during the last search.
   size_t BaseCases() const { return baseCases; }
   //! Get the number of scores during the last search.
   size_t Scores() const { return scores; }
 
+  //! Get the collector of detailed traversal statistics (NULL by default).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the collector of detailed traversal statistics.  When it is not
+  //! NULL, every subsequent search records its statistics into it (see
+  //! TraversalStatistics).  The object is not owned by the RangeSearch and is
+  //! not serialized.
+  TraversalStatistics*& Statistics() { return statistics; }
+
   //! Serialize the model.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t version);
@@ -320,9 +399,64 @@ class RangeSearch
   size_t baseCases;
   //! The total number of scores during the last search.
   size_t scores;
+  //! Optional collector of traversal statistics; not owned.
+  TraversalStatistics* statistics;
+  //! If true, monochromatic searches are symmetric self-joins.
+  bool symmetric;
+
+  /**
+   * Perform single-tree search with the given rules for every point in the
+   * query set, adding to the base case and score counts.  If OpenMP is
+   * available, the query points are split across threads, each running its own
+   * single-tree traversal of the shared reference tree.
+   *
+   * @param rules Rules for the traversal.
+   * @param numQueries Number of query points.
+   */
+  template<typename RuleType>
+  void SingleTreeSearch(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Search with the current search mode and pass the results to a sink, which
+   * is created with makeSink(queryMap, referenceMap), where the mappings (or
+   * NULL) map the indices of the trees back to the original indices.
+   *
+   * @param querySet Set of query points, or NULL for the reference set.
+   * @param range Range of distances in which to search.
+   * @param makeSink Function that creates the sink.
+   */
+  template<typename SinkFactoryType>
+  void SinkSearch(const MatType* querySet,
+                  const RangeType<ElemType>& range,
+                  SinkFactoryType makeSink);
+
+  /**
+   * Traverse the given query tree and the reference tree with the given rules,
+   * adding the base cases and scores of the traversal to the counts.  If
+   * OpenMP is available, the query tree is split into disjoint subtrees, which
+   * are traversed by different threads against the shared reference tree.
+   *
+   * @param rules Rules for the traversal.
+   * @param queryTree Root of the query tree.
+   */
+  template<typename RuleType>
+  void DualTreeSearch(RuleType& rules, Tree& queryTree);
+
+  /**
+   * Traverse the reference tree against itself with the given rules, which are
+   * made symmetric, adding the base cases and scores of the traversal to the
+   * counts.  If OpenMP is available, the tree is split into disjoint subtrees,
+   * and each thread handles the pairs of subtrees starting with the subtrees it
+   * is given.  If the tree type can't be traversed symmetrically, this is a
+   * regular dual-tree search.
+   *
+   * @param rules Rules for the traversal.
+   */
+  template<typename RuleType>
+  void SymmetricSearch(RuleType& rules);
 
   //! For access to mappings when building models.
-  friend class LeafSizeRSWrapper<TreeType>;
+  friend class LeafSizeRSWrapper<TreeType, MatType>;
 };
 
 } // namespace mlpack
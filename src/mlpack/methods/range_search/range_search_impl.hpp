@@ -39,7 +39,9 @@ RangeSearch<DistanceType, MatType, TreeType>::RangeSearch(
     singleMode(!naive && singleMode),
     distance(distance),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL),
+    symmetric(false)
 {
   // Nothing to do.
 }
@@ -60,7 +62,9 @@ RangeSearch<DistanceType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     distance(distance),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL),
+    symmetric(false)
 {
   // Nothing else to initialize.
 }
@@ -81,7 +85,9 @@ RangeSearch<DistanceType, MatType, TreeType>::RangeSearch(
     singleMode(singleMode),
     distance(distance),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL),
+    symmetric(false)
 {
   // Build the tree on the empty dataset, if necessary.
   if (!naive)
@@ -109,7 +115,9 @@ RangeSearch<DistanceType, MatType, TreeType>::RangeSearch(
     singleMode(other.singleMode),
     distance(other.distance),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    statistics(other.statistics),
+    symmetric(other.symmetric)
 {
   // Nothing to do.
 }
@@ -128,7 +136,9 @@ RangeSearch<DistanceType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
     singleMode(other.singleMode),
     distance(std::move(other.distance)),
     baseCases(other.baseCases),
-    scores(other.scores)
+    scores(other.scores),
+    statistics(other.statistics),
+    symmetric(other.symmetric)
 {
   // Clear other object.
   other.referenceTree =
@@ -139,6 +149,8 @@ RangeSearch<DistanceType, MatType, TreeType>::RangeSearch(RangeSearch&& other) :
   other.singleMode = false;
   other.baseCases = 0;
   other.scores = 0;
+  other.statistics = NULL;
+  other.symmetric = false;
 }
 
 template<typename DistanceType,
@@ -163,6 +175,8 @@ RangeSearch<DistanceType, MatType, TreeType>::operator=(
     distance = other.distance;
     baseCases = other.baseCases;
     scores = other.scores;
+    statistics = other.statistics;
+    symmetric = other.symmetric;
   }
   return *this;
 }
@@ -193,6 +207,8 @@ RangeSearch<DistanceType, MatType, TreeType>::operator=(RangeSearch&& other)
     distance = std::move(other.distance);
     baseCases = other.baseCases;
     scores = other.scores;
+    statistics = other.statistics;
+    symmetric = other.symmetric;
 
     // Clear other object.
     other.referenceTree = nullptr;
@@ -202,6 +218,8 @@ RangeSearch<DistanceType, MatType, TreeType>::operator=(RangeSearch&& other)
     other.singleMode = false;
     other.baseCases = 0;
     other.scores = 0;
+    other.statistics = NULL;
+    other.symmetric = false;
   }
   return *this;
 }
@@ -342,6 +360,7 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
   {
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         distance);
+    rules.Statistics() = statistics;
 
     // The naive brute-force solution.
     for (size_t i = 0; i < querySet.n_cols; ++i)
@@ -352,17 +371,10 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
     RuleType rules(*referenceSet, querySet, range, *neighborPtr, *distancePtr,
         distance);
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    rules.Statistics() = statistics;
+    SingleTreeSearch(rules, querySet.n_cols);
   }
   else // Dual-tree recursion.
   {
@@ -372,12 +384,8 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
     // Create the traverser.
     RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
         *distancePtr, distance);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*queryTree, *referenceTree);
-
-    baseCases += rules.BaseCases();
-    scores += rules.Scores();
+    rules.Statistics() = statistics;
+    DualTreeSearch(rules, *queryTree);
 
     // Clean up tree memory.
     delete queryTree;
@@ -489,14 +497,11 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
   using RuleType = RangeSearchRules<DistanceType, Tree>;
   RuleType rules(*referenceSet, queryTree->Dataset(), range, *neighborPtr,
       distances, distance);
+  rules.Statistics() = statistics;
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-  traverser.Traverse(*queryTree, *referenceTree);
-
-  baseCases = rules.BaseCases();
-  scores = rules.Scores();
+  baseCases = 0;
+  scores = 0;
+  DualTreeSearch(rules, *queryTree);
 
   // Do we need to map indices?
   if (treeOwner && TreeTraits<Tree>::RearrangesDataset)
@@ -552,8 +557,21 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
   using RuleType = RangeSearchRules<DistanceType, Tree>;
   RuleType rules(*referenceSet, *referenceSet, range, *neighborPtr,
       *distancePtr, distance, true /* don't return the query in the results */);
+  rules.Statistics() = statistics;
 
-  if (naive)
+  if (naive && symmetric)
+  {
+    // Each pair of points is evaluated once.
+    rules.Symmetric() = true;
+    for (size_t i = 0; i < referenceSet->n_cols; ++i)
+      for (size_t j = i + 1; j < referenceSet->n_cols; ++j)
+        rules.BaseCase(i, j);
+    rules.FlushReverseResults();
+
+    baseCases = (referenceSet->n_cols * (referenceSet->n_cols - 1) / 2);
+    scores = 0;
+  }
+  else if (naive)
   {
     // The naive brute-force solution.
     for (size_t i = 0; i < referenceSet->n_cols; ++i)
@@ -565,25 +583,21 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = 0;
+    scores = 0;
+    SingleTreeSearch(rules, referenceSet->n_cols);
+  }
+  else if (symmetric)
+  {
+    baseCases = 0;
+    scores = 0;
+    SymmetricSearch(rules);
   }
   else // Dual-tree recursion.
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
-
-    baseCases = rules.BaseCases();
-    scores = rules.Scores();
+    baseCases = 0;
+    scores = 0;
+    DualTreeSearch(rules, *referenceTree);
   }
 
   // Do we need to map the reference indices?
@@ -614,6 +628,383 @@ void RangeSearch<DistanceType, MatType, TreeType>::Search(
   }
 }
 
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<DistanceType, MatType, TreeType>::Search(
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    CallbackType&& callback)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Search()", "query set");
+
+  using SinkType = RangeSearchCallbackSink<
+      std::remove_reference_t<CallbackType>, ElemType>;
+  SinkSearch(&querySet, range, [&callback](
+      const std::vector<size_t>* queryMap,
+      const std::vector<size_t>* referenceMap)
+  {
+    return SinkType(callback, queryMap, referenceMap);
+  });
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename CallbackType>
+void RangeSearch<DistanceType, MatType, TreeType>::Search(
+    const RangeType<ElemType>& range,
+    CallbackType&& callback)
+{
+  using SinkType = RangeSearchCallbackSink<
+      std::remove_reference_t<CallbackType>, ElemType>;
+  SinkSearch(NULL, range, [&callback](
+      const std::vector<size_t>* queryMap,
+      const std::vector<size_t>* referenceMap)
+  {
+    return SinkType(callback, queryMap, referenceMap);
+  });
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<DistanceType, MatType, TreeType>::Count(
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& counts)
+{
+  util::CheckSameDimensionality(querySet, *referenceSet,
+      "RangeSearch::Count()", "query set");
+
+  counts.zeros(querySet.n_cols);
+  SinkSearch(&querySet, range, [&counts](
+      const std::vector<size_t>* queryMap,
+      const std::vector<size_t>* /* referenceMap */)
+  {
+    return RangeSearchCountSink<ElemType>(counts, queryMap);
+  });
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void RangeSearch<DistanceType, MatType, TreeType>::Count(
+    const RangeType<ElemType>& range,
+    arma::Col<size_t>& counts)
+{
+  counts.zeros(referenceSet->n_cols);
+  SinkSearch(NULL, range, [&counts](
+      const std::vector<size_t>* queryMap,
+      const std::vector<size_t>* /* referenceMap */)
+  {
+    return RangeSearchCountSink<ElemType>(counts, queryMap);
+  });
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename SinkFactoryType>
+void RangeSearch<DistanceType, MatType, TreeType>::SinkSearch(
+    const MatType* querySet,
+    const RangeType<ElemType>& range,
+    SinkFactoryType makeSink)
+{
+  using SinkType = std::invoke_result_t<SinkFactoryType,
+      const std::vector<size_t>*, const std::vector<size_t>*>;
+  using RuleType = RangeSearchRules<DistanceType, Tree, SinkType>;
+
+  baseCases = 0;
+  scores = 0;
+
+  // If there are no points, there is no search to be done.
+  if (referenceSet->n_cols == 0)
+    return;
+
+  // The reference indices must be mapped back if we built the reference tree.
+  const std::vector<size_t>* referenceMap =
+      (treeOwner && TreeTraits<Tree>::RearrangesDataset) ?
+      &oldFromNewReferences : NULL;
+
+  if (querySet == NULL)
+  {
+    // The query set is the reference set, so the query indices are mapped in
+    // the same way.
+    RuleType rules(*referenceSet, *referenceSet, range,
+        makeSink(referenceMap, referenceMap), distance,
+        true /* don't return the query in the results */);
+    rules.Statistics() = statistics;
+
+    if (naive && symmetric)
+    {
+      rules.Symmetric() = true;
+      for (size_t i = 0; i < referenceSet->n_cols; ++i)
+        for (size_t j = i + 1; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+      rules.FlushReverseResults();
+
+      baseCases = (referenceSet->n_cols * (referenceSet->n_cols - 1) / 2);
+    }
+    else if (naive)
+    {
+      for (size_t i = 0; i < referenceSet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+
+      baseCases = (referenceSet->n_cols * referenceSet->n_cols);
+    }
+    else if (singleMode)
+    {
+      SingleTreeSearch(rules, referenceSet->n_cols);
+    }
+    else if (symmetric)
+    {
+      SymmetricSearch(rules);
+    }
+    else
+    {
+      DualTreeSearch(rules, *referenceTree);
+    }
+  }
+  else if (naive || singleMode)
+  {
+    RuleType rules(*referenceSet, *querySet, range,
+        makeSink(NULL, referenceMap), distance);
+    rules.Statistics() = statistics;
+
+    if (naive)
+    {
+      for (size_t i = 0; i < querySet->n_cols; ++i)
+        for (size_t j = 0; j < referenceSet->n_cols; ++j)
+          rules.BaseCase(i, j);
+
+      baseCases = (querySet->n_cols * referenceSet->n_cols);
+    }
+    else
+    {
+      SingleTreeSearch(rules, querySet->n_cols);
+    }
+  }
+  else
+  {
+    // Build the query tree; if it rearranges the points, the query indices
+    // must be mapped back too.
+    std::vector<size_t> oldFromNewQueries;
+    Tree* queryTree = BuildTree<Tree>(*querySet, oldFromNewQueries);
+    const std::vector<size_t>* queryMap =
+        TreeTraits<Tree>::RearrangesDataset ? &oldFromNewQueries : NULL;
+
+    RuleType rules(*referenceSet, queryTree->Dataset(), range,
+        makeSink(queryMap, referenceMap), distance);
+    rules.Statistics() = statistics;
+    DualTreeSearch(rules, *queryTree);
+
+    delete queryTree;
+  }
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RangeSearch<DistanceType, MatType, TreeType>::SingleTreeSearch(
+    RuleType& rules,
+    const size_t numQueries)
+{
+  #ifdef MLPACK_USE_OPENMP
+  // When the first point of each node is the centroid, Score() stores the last
+  // base case in the statistic of the reference node, so the reference tree
+  // cannot be shared between threads.
+  if (omp_get_max_threads() > 1 && !TreeTraits<Tree>::FirstPointIsCentroid)
+  {
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      // Every query point is handled by only one thread, so all threads can
+      // pass their results to the same sink.
+      RuleType localRules(rules);
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(localRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < numQueries; ++i)
+        traverser.Traverse(i, *referenceTree);
+
+      threadBaseCases += localRules.BaseCases();
+      threadScores += localRules.Scores();
+
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
+
+    baseCases += threadBaseCases;
+    scores += threadScores;
+    return;
+  }
+  #endif
+
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+
+  // Now have it traverse for each point.
+  for (size_t i = 0; i < numQueries; ++i)
+    traverser.Traverse(i, *referenceTree);
+
+  baseCases += rules.BaseCases();
+  scores += rules.Scores();
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RangeSearch<DistanceType, MatType, TreeType>::DualTreeSearch(
+    RuleType& rules,
+    Tree& queryTree)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1)
+  {
+    // Collect a few more subtrees than threads, so that the work can be
+    // balanced dynamically.
+    std::vector<Tree*> frontier;
+    QueryFrontier(queryTree, 4 * numThreads, frontier);
+
+    size_t threadBaseCases = 0;
+    size_t threadScores = 0;
+    #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+    {
+      // Each thread gets its own base case cache and traversal info, but
+      // writes to the shared result vectors; this is safe because the query
+      // subtrees are disjoint.
+      RuleType localRules(rules);
+      TraversalStatistics localStatistics;
+      if (rules.Statistics())
+        localRules.Statistics() = &localStatistics;
+      typename Tree::template DualTreeTraverser<RuleType>
+          traverser(localRules);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+        traverser.Traverse(*frontier[i], *referenceTree);
+
+      threadBaseCases += localRules.BaseCases();
+      threadScores += localRules.Scores();
+
+      if (rules.Statistics())
+      {
+        #pragma omp critical
+        rules.Statistics()->Merge(localStatistics);
+      }
+    }
+
+    baseCases += threadBaseCases;
+    scores += threadScores;
+    return;
+  }
+  #endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+
+  baseCases += rules.BaseCases();
+  scores += rules.Scores();
+}
+
+template<typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RangeSearch<DistanceType, MatType, TreeType>::SymmetricSearch(
+    RuleType& rules)
+{
+  if constexpr (!SymmetricTraversalTraits<Tree>::Supported)
+  {
+    DualTreeSearch(rules, *referenceTree);
+  }
+  else
+  {
+    rules.Symmetric() = true;
+
+    #ifdef MLPACK_USE_OPENMP
+    const size_t numThreads = omp_get_max_threads();
+    if (numThreads > 1)
+    {
+      std::vector<Tree*> frontier;
+      QueryFrontier(*referenceTree, 4 * numThreads, frontier);
+
+      size_t threadBaseCases = 0;
+      size_t threadScores = 0;
+      #pragma omp parallel reduction(+:threadBaseCases, threadScores)
+      {
+        // The thread that handles the pairs (frontier[i], frontier[j]) for
+        // j >= i passes the results of the points of frontier[i] to the sink,
+        // and keeps the reversed results, for the points of other subtrees,
+        // until all the pairs are done.
+        RuleType localRules(rules);
+        TraversalStatistics localStatistics;
+        if (rules.Statistics())
+          localRules.Statistics() = &localStatistics;
+        SymmetricDualTreeTraverser<Tree, RuleType> traverser(localRules);
+
+        #pragma omp for schedule(dynamic)
+        for (size_t i = 0; i < frontier.size(); ++i)
+          for (size_t j = i; j < frontier.size(); ++j)
+            traverser.Traverse(*frontier[i], *frontier[j]);
+
+        // All the threads have finished the loop.
+        #pragma omp critical
+        {
+          localRules.FlushReverseResults();
+          if (rules.Statistics())
+            rules.Statistics()->Merge(localStatistics);
+        }
+
+        threadBaseCases += localRules.BaseCases();
+        threadScores += localRules.Scores();
+      }
+
+      baseCases += threadBaseCases;
+      scores += threadScores;
+      return;
+    }
+    #endif
+
+    SymmetricDualTreeTraverser<Tree, RuleType> traverser(rules);
+    traverser.Traverse(*referenceTree);
+    rules.FlushReverseResults();
+
+    baseCases += rules.BaseCases();
+    scores += rules.Scores();
+  }
+}
+
 template<typename DistanceType,
          typename MatType,
          template<typename TreeDistanceType,
@@ -100,12 +100,21 @@ PARAM_DOUBLE_IN("min", "Lower bound in range.", "L", 0.0);
 // building.
 PARAM_STRING_IN("tree_type", "Type of tree to use: 'kd', 'vp', 'rp', 'max-rp', "
     "'ub', 'cover', 'r', 'r-star', 'x', 'ball', 'hilbert-r', 'r-plus', "
-    "'r-plus-plus', 'oct'.", "t", "kd");
+    "'r-plus-plus', 'oct', 'auto'.  With 'auto', the tree type, the leaf size "
+    "and (unless 'single_mode' is given) the single-tree or dual-tree "
+    "algorithm are chosen with short trial searches on samples of the data; "
+    "this requires 'min' or 'max'.", "t", "kd");
 PARAM_INT_IN("leaf_size", "Leaf size for tree building (used for kd-trees, "
     "vp trees, random projection trees, UB trees, R trees, R* trees, X trees, "
     "Hilbert R trees, R+ trees, R++ trees, and octrees).", "l", 20);
 PARAM_FLAG("random_basis", "Before tree-building, project the data onto a "
     "random orthogonal basis.", "R");
+PARAM_FLAG("single_precision", "Hold the reference set and trees in single "
+    "precision (32-bit floating point), which halves their memory use.", "f");
+PARAM_FLAG("traversal_statistics", "If set, collect detailed statistics "
+    "about the tree traversal (prunes per tree level, base cases per leaf, "
+    "traversal depth and revisited nodes) and print them, along with the split "
+    "of time between tree building and search as verbose output.", "");
 PARAM_INT_IN("seed", "Random seed (if 0, std::time(NULL) is used).", "s", 0);
 
 // Search settings.
@@ -125,6 +134,7 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
   ReportIgnoredParam(params, {{ "input_model", true }}, "tree_type");
   ReportIgnoredParam(params, {{ "input_model", true }}, "random_basis");
+  ReportIgnoredParam(params, {{ "input_model", true }}, "single_precision");
   ReportIgnoredParam(params, {{ "input_model", true }}, "leaf_size");
   ReportIgnoredParam(params, {{ "input_model", true }}, "naive");
 
@@ -161,14 +171,14 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   // We either have to load the reference data, or we have to load the model.
   RSModel* rs;
   const bool naive = params.Has("naive");
-  const bool singleMode = params.Has("single_mode");
+  bool singleMode = params.Has("single_mode");
   if (params.Has("reference"))
   {
     // Get all the parameters.
     const string treeType = params.Get<string>("tree_type");
     RequireParamInSet<string>(params, "tree_type", { "kd", "cover", "r",
         "r-star", "ball", "x", "hilbert-r", "r-plus", "r-plus-plus", "vp", "rp",
-        "max-rp", "ub", "oct" }, true, "unknown tree type");
+        "max-rp", "ub", "oct", "auto" }, true, "unknown tree type");
     const bool randomBasis = params.Has("random_basis");
 
     rs = new RSModel();
@@ -202,16 +212,47 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       tree = RSModel::UB_TREE;
     else if (treeType == "oct")
       tree = RSModel::OCTREE;
+    else if (treeType == "auto")
+      tree = RSModel::AUTO_TREE;
 
     rs->TreeType() = tree;
     rs->RandomBasis() = randomBasis;
+    rs->SinglePrecision() = params.Has("single_precision");
 
     arma::mat& referenceSet = params.Get<arma::mat>("reference");
 
     Log::Info << "Using reference data from "
         << params.GetPrintable<arma::mat>("reference") << "." << endl;
 
-    const size_t leafSize = size_t(lsInt);
+    size_t leafSize = size_t(lsInt);
+
+    // Choose the tree type and leaf size (and the search mode, if single-tree
+    // search was not requested) for the search that will be done.
+    if (tree == RSModel::AUTO_TREE && !naive)
+    {
+      if (!params.Has("min") && !params.Has("max"))
+      {
+        delete rs;
+        Log::Fatal << "Automatic tree selection (" <<
+            PRINT_PARAM_STRING("tree_type") << " 'auto') needs the range to "
+            << "search for; pass " << PRINT_PARAM_STRING("min") << " or "
+            << PRINT_PARAM_STRING("max") << "." << endl;
+      }
+
+      const Range r(params.Get<double>("min"), params.Has("max") ?
+          params.Get<double>("max") : DBL_MAX);
+      const arma::mat emptyQuery;
+      const bool selectedSingleMode = rs->SelectTree(timers, referenceSet,
+          params.Has("query") ? params.Get<arma::mat>("query") : emptyQuery,
+          r);
+      singleMode = singleMode || selectedSingleMode;
+      leafSize = rs->LeafSize();
+    }
+    else if (tree == RSModel::AUTO_TREE)
+    {
+      // The tree type does not matter for naive search.
+      rs->TreeType() = RSModel::KD_TREE;
+    }
 
     rs->BuildModel(timers, std::move(referenceSet), leafSize, naive,
         singleMode);
@@ -223,8 +264,8 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Using range search model from '"
         << params.GetPrintable<RSModel*>("input_model") << "' ("
-        << "trained on " << rs->Dataset().n_rows << "x" << rs->Dataset().n_cols
-        << " dataset)." << endl;
+        << "trained on " << rs->Dimensionality() << "x"
+        << rs->NumReferencePoints() << " dataset)." << endl;
 
     // Adjust singleMode and naive if necessary.
     rs->SingleMode() = params.Has("single_mode");
@@ -264,6 +305,11 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
     vector<vector<size_t>> neighbors;
     vector<vector<double>> distances;
 
+    // Collect traversal statistics, if requested.
+    TraversalStatistics statistics;
+    if (params.Has("traversal_statistics"))
+      rs->Statistics() = &statistics;
+
     if (params.Has("query"))
       rs->Search(timers, std::move(queryData), r, neighbors, distances);
     else
@@ -271,6 +317,17 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     Log::Info << "Search complete." << endl;
 
+    if (params.Has("traversal_statistics"))
+    {
+      rs->Statistics() = NULL;
+      statistics.Print(Log::Info);
+
+      const double buildTime = timers.Get("tree_building").count() / 1e6;
+      const double searchTime = timers.Get("computing_neighbors").count() / 1e6;
+      Log::Info << "Time spent building trees: " << buildTime << "s; time "
+          << "spent searching: " << searchTime << "s." << endl;
+    }
+
     // Save output, if desired.  We have to do this by hand.
     if (params.Has("distances_file"))
     {
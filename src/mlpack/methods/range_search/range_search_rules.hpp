@@ -13,17 +13,26 @@
 #define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_RULES_HPP
 
 #include <mlpack/core/tree/traversal_info.hpp>
+#include <mlpack/core/tree/traversal_statistics.hpp>
+
+#include "range_search_sinks.hpp"
 
 namespace mlpack {
 
 /**
  * The RangeSearchRules class is a template helper class used by RangeSearch
- * class when performing range searches.
+ * class when performing range searches.  Each result is passed to a sink as
+ * soon as it is found (see range_search_sinks.hpp); by default, the results
+ * are stored in vectors.
  *
  * @tparam DistanceType The distance metric to use for computation.
  * @tparam TreeType The tree type to use; must adhere to the TreeType API.
+ * @tparam SinkType The type of sink that receives the results.
  */
-template<typename DistanceType, typename TreeType>
+template<typename DistanceType,
+         typename TreeType,
+         typename SinkType =
+             RangeSearchVectorSink<typename TreeType::Mat::elem_type>>
 class RangeSearchRules
 {
  public:
@@ -53,6 +62,25 @@ class RangeSearchRules
                    DistanceType& distance,
                    const bool sameSet = false);
 
+  /**
+   * Construct the RangeSearchRules object to pass the results to the given
+   * sink.
+   *
+   * @param referenceSet Set of reference data.
+   * @param querySet Set of query data.
+   * @param range Range to search for.
+   * @param sink Sink to pass the results to (it is copied).
+   * @param distance Instantiated distance metric.
+   * @param sameSet If true, the query and reference set are taken to be the
+   *      same, and a query point will not return itself in the results.
+   */
+  RangeSearchRules(const MatType& referenceSet,
+                   const MatType& querySet,
+                   const RangeType<ElemType>& range,
+                   const SinkType& sink,
+                   DistanceType& distance,
+                   const bool sameSet = false);
+
   /**
    * Compute the base case between the given query point and reference point.
    *
@@ -121,10 +149,28 @@ class RangeSearchRules
   //! Get the number of scores (that is, calls to RangeDistance()).
   size_t Scores() const { return scores; }
 
+  //! Get the statistics collector (NULL if statistics are not collected).
+  TraversalStatistics* Statistics() const { return statistics; }
+  //! Modify the statistics collector.  It is not owned by the rules.
+  TraversalStatistics*& Statistics() { return statistics; }
+
   //! Get the minimum number of base cases we need to perform to have acceptable
   //! results.
   size_t MinimumBaseCases() const { return 0; }
 
+  //! Get whether the rules are symmetric (see Symmetric()).
+  bool Symmetric() const { return symmetric; }
+  //! Modify whether the rules are symmetric.  Symmetric rules are used with the
+  //! SymmetricDualTreeTraverser when the query set is the reference set: each
+  //! result (i, j) found by BaseCase() or Score() also gives the result (j, i).
+  //! The reversed results are kept until FlushReverseResults() is called, so
+  //! that several threads can traverse disjoint parts of the tree at once.
+  bool& Symmetric() { return symmetric; }
+
+  //! Pass the reversed results found so far to the sink (symmetric rules
+  //! only).
+  void FlushReverseResults();
+
  private:
   //! The reference set.
   const MatType& referenceSet;
@@ -135,11 +181,8 @@ class RangeSearchRules
   //! The range of distances for which we are searching.
   const RangeType<ElemType>& range;
 
-  //! The vector the resultant neighbor indices should be stored in.
-  std::vector<std::vector<size_t> >& neighbors;
-
-  //! The vector the resultant neighbor distances should be stored in.
-  std::vector<std::vector<ElemType> >& distances;
+  //! The sink the results are passed to.
+  SinkType sink;
 
   //! The instantiated distance metric.
   DistanceType& distance;
@@ -147,6 +190,13 @@ class RangeSearchRules
   //! If true, the query and reference set are taken to be the same.
   bool sameSet;
 
+  //! If true, each result is also recorded in the reverse direction.
+  bool symmetric;
+
+  //! The reversed results (reference point, query point, distance) that have
+  //! not been passed to the sink yet.
+  std::vector<std::tuple<size_t, size_t, ElemType>> reverseResults;
+
   //! The last query index.
   size_t lastQueryIndex;
   //! The last reference index.
@@ -158,12 +208,19 @@ class RangeSearchRules
   void AddResult(const size_t queryIndex,
                  TreeType& referenceNode);
 
+  //! Keep the results of all the points of the given query node for the given
+  //! reference point, for FlushReverseResults() (symmetric rules only).
+  void AddReverseResult(const size_t referenceIndex,
+                        TreeType& queryNode);
+
   TraversalInfoType traversalInfo;
 
   //! The number of base cases.
   size_t baseCases;
   //! THe number of scores.
   size_t scores;
+  //! Optional collector of detailed traversal statistics (may be NULL).
+  TraversalStatistics* statistics;
 };
 
 } // namespace mlpack
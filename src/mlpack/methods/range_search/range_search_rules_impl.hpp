@@ -17,8 +17,8 @@
 
 namespace mlpack {
 
-template<typename DistanceType, typename TreeType>
-RangeSearchRules<DistanceType, TreeType>::RangeSearchRules(
+template<typename DistanceType, typename TreeType, typename SinkType>
+RangeSearchRules<DistanceType, TreeType, SinkType>::RangeSearchRules(
     const MatType& referenceSet,
     const MatType& querySet,
     const RangeType<ElemType>& range,
@@ -26,27 +26,42 @@ RangeSearchRules<DistanceType, TreeType>::RangeSearchRules(
     std::vector<std::vector<ElemType> >& distances,
     DistanceType& distance,
     const bool sameSet) :
+    RangeSearchRules(referenceSet, querySet, range,
+        SinkType(neighbors, distances), distance, sameSet)
+{
+  // Nothing to do.
+}
+
+template<typename DistanceType, typename TreeType, typename SinkType>
+RangeSearchRules<DistanceType, TreeType, SinkType>::RangeSearchRules(
+    const MatType& referenceSet,
+    const MatType& querySet,
+    const RangeType<ElemType>& range,
+    const SinkType& sink,
+    DistanceType& distance,
+    const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
     range(range),
-    neighbors(neighbors),
-    distances(distances),
+    sink(sink),
     distance(distance),
     sameSet(sameSet),
+    symmetric(false),
     lastQueryIndex(querySet.n_cols),
     lastReferenceIndex(referenceSet.n_cols),
     baseCases(0),
-    scores(0)
+    scores(0),
+    statistics(NULL)
 {
   // Nothing to do.
 }
 
 //! The base case.  Evaluate the distance between the two points and add to the
 //! results if necessary.
-template<typename DistanceType, typename TreeType>
+template<typename DistanceType, typename TreeType, typename SinkType>
 inline mlpack_force_inline
-typename RangeSearchRules<DistanceType, TreeType>::ElemType
-RangeSearchRules<DistanceType, TreeType>::BaseCase(
+typename RangeSearchRules<DistanceType, TreeType, SinkType>::ElemType
+RangeSearchRules<DistanceType, TreeType, SinkType>::BaseCase(
     const size_t queryIndex,
     const size_t referenceIndex)
 {
@@ -61,6 +76,8 @@ RangeSearchRules<DistanceType, TreeType>::BaseCase(
   const ElemType d = distance.Evaluate(querySet.unsafe_col(queryIndex),
       referenceSet.unsafe_col(referenceIndex));
   ++baseCases;
+  if (statistics)
+    statistics->RecordBaseCases();
 
   // Update last indices, so we don't accidentally perform a base case twice.
   lastQueryIndex = queryIndex;
@@ -68,18 +85,20 @@ RangeSearchRules<DistanceType, TreeType>::BaseCase(
 
   if (range.Contains(d))
   {
-    neighbors[queryIndex].push_back(referenceIndex);
-    distances[queryIndex].push_back(d);
+    sink.Add(queryIndex, referenceIndex, d);
+    if (symmetric)
+      reverseResults.emplace_back(referenceIndex, queryIndex, d);
   }
 
   return d;
 }
 
 //! Single-tree scoring function.
-template<typename DistanceType, typename TreeType>
-typename RangeSearchRules<DistanceType, TreeType>::ElemType
-RangeSearchRules<DistanceType, TreeType>::Score(const size_t queryIndex,
-                                                TreeType& referenceNode)
+template<typename DistanceType, typename TreeType, typename SinkType>
+typename RangeSearchRules<DistanceType, TreeType, SinkType>::ElemType
+RangeSearchRules<DistanceType, TreeType, SinkType>::Score(
+    const size_t queryIndex,
+    TreeType& referenceNode)
 {
   // We must get the minimum and maximum distances and store them in this
   // object.
@@ -121,38 +140,49 @@ RangeSearchRules<DistanceType, TreeType>::Score(const size_t queryIndex,
 
   // If the ranges do not overlap, prune this node.
   if (!distances.Contains(range))
+  {
+    if (statistics)
+      statistics->RecordScore(referenceNode, DBL_MAX);
     return DBL_MAX;
+  }
 
   // In this case, all of the points in the reference node will be part of the
   // results.
   if ((distances.Lo() >= range.Lo()) && (distances.Hi() <= range.Hi()))
   {
     AddResult(queryIndex, referenceNode);
+    if (statistics)
+      statistics->RecordScore(referenceNode, DBL_MAX);
     return DBL_MAX; // We don't need to go any deeper.
   }
 
   // Otherwise the score doesn't matter.  Recursion order is irrelevant in
   // range search.
+  if (statistics)
+    statistics->RecordScore(referenceNode, 0.0);
   return 0.0;
 }
 
 //! Single-tree rescoring function.
-template<typename DistanceType, typename TreeType>
-typename RangeSearchRules<DistanceType, TreeType>::ElemType
-RangeSearchRules<DistanceType, TreeType>::Rescore(
+template<typename DistanceType, typename TreeType, typename SinkType>
+typename RangeSearchRules<DistanceType, TreeType, SinkType>::ElemType
+RangeSearchRules<DistanceType, TreeType, SinkType>::Rescore(
     const size_t /* queryIndex */,
     TreeType& /* referenceNode */,
     const ElemType oldScore) const
 {
   // If it wasn't pruned before, it isn't pruned now.
+  if (statistics)
+    statistics->RecordRescore(oldScore);
   return oldScore;
 }
 
 //! Dual-tree scoring function.
-template<typename DistanceType, typename TreeType>
-typename RangeSearchRules<DistanceType, TreeType>::ElemType
-RangeSearchRules<DistanceType, TreeType>::Score(TreeType& queryNode,
-                                                TreeType& referenceNode)
+template<typename DistanceType, typename TreeType, typename SinkType>
+typename RangeSearchRules<DistanceType, TreeType, SinkType>::ElemType
+RangeSearchRules<DistanceType, TreeType, SinkType>::Score(
+    TreeType& queryNode,
+    TreeType& referenceNode)
 {
   RangeType<ElemType> distances;
   if (TreeTraits<TreeType>::FirstPointIsCentroid)
@@ -193,7 +223,11 @@ RangeSearchRules<DistanceType, TreeType>::Score(TreeType& queryNode,
 
   // If the ranges do not overlap, prune this node.
   if (!distances.Contains(range))
+  {
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, DBL_MAX);
     return DBL_MAX;
+  }
 
   // In this case, all of the points in the reference node will be part of all
   // the results for each point in the query node.
@@ -201,6 +235,13 @@ RangeSearchRules<DistanceType, TreeType>::Score(TreeType& queryNode,
   {
     for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
       AddResult(queryNode.Descendant(i), referenceNode);
+    if (symmetric)
+    {
+      for (size_t i = 0; i < referenceNode.NumDescendants(); ++i)
+        AddReverseResult(referenceNode.Descendant(i), queryNode);
+    }
+    if (statistics)
+      statistics->RecordScore(queryNode, referenceNode, DBL_MAX);
     return DBL_MAX; // We don't need to go any deeper.
   }
 
@@ -208,25 +249,29 @@ RangeSearchRules<DistanceType, TreeType>::Score(TreeType& queryNode,
   // search.
   traversalInfo.LastQueryNode() = &queryNode;
   traversalInfo.LastReferenceNode() = &referenceNode;
+  if (statistics)
+    statistics->RecordScore(queryNode, referenceNode, 0.0);
   return 0.0;
 }
 
 //! Dual-tree rescoring function.
-template<typename DistanceType, typename TreeType>
-typename RangeSearchRules<DistanceType, TreeType>::ElemType
-RangeSearchRules<DistanceType, TreeType>::Rescore(
+template<typename DistanceType, typename TreeType, typename SinkType>
+typename RangeSearchRules<DistanceType, TreeType, SinkType>::ElemType
+RangeSearchRules<DistanceType, TreeType, SinkType>::Rescore(
     TreeType& /* queryNode */,
     TreeType& /* referenceNode */,
     const ElemType oldScore) const
 {
   // If it wasn't pruned before, it isn't pruned now.
+  if (statistics)
+    statistics->RecordRescore(oldScore);
   return oldScore;
 }
 
 //! Add all the points in the given node to the results for the given query
 //! point.
-template<typename DistanceType, typename TreeType>
-void RangeSearchRules<DistanceType, TreeType>::AddResult(
+template<typename DistanceType, typename TreeType, typename SinkType>
+void RangeSearchRules<DistanceType, TreeType, SinkType>::AddResult(
     const size_t queryIndex, TreeType& referenceNode)
 {
   // Some types of trees calculate the base case evaluation before Score() is
@@ -240,14 +285,10 @@ void RangeSearchRules<DistanceType, TreeType>::AddResult(
     baseCaseMod = 1;
   }
 
-  // Resize distances and neighbors vectors appropriately.  We have to use
-  // reserve() and not resize(), because we don't know if we will encounter the
-  // case where the datasets and points are the same (and we skip in that case).
-  const size_t oldSize = neighbors[queryIndex].size();
-  neighbors[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
-  distances[queryIndex].reserve(oldSize + referenceNode.NumDescendants() -
-      baseCaseMod);
+  // The number of results is only an upper bound, because we don't know if we
+  // will encounter the case where the datasets and points are the same (and we
+  // skip in that case).
+  sink.Reserve(queryIndex, referenceNode.NumDescendants() - baseCaseMod);
 
   for (size_t i = baseCaseMod; i < referenceNode.NumDescendants(); ++i)
   {
@@ -255,12 +296,52 @@ void RangeSearchRules<DistanceType, TreeType>::AddResult(
         (queryIndex == referenceNode.Descendant(i)))
       continue;
 
-    const ElemType d = distance.Evaluate(querySet.unsafe_col(queryIndex),
-        referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
+    // Every point of the node is in the range, so the distance is only needed
+    // if the sink uses it.
+    ElemType d = 0;
+    if constexpr (SinkType::NeedsDistances)
+    {
+      d = distance.Evaluate(querySet.unsafe_col(queryIndex),
+          referenceNode.Dataset().unsafe_col(referenceNode.Descendant(i)));
+    }
+
+    sink.Add(queryIndex, referenceNode.Descendant(i), d);
+  }
+}
+
+//! Keep the results of all the points in the given query node for the given
+//! reference point.
+template<typename DistanceType, typename TreeType, typename SinkType>
+void RangeSearchRules<DistanceType, TreeType, SinkType>::AddReverseResult(
+    const size_t referenceIndex, TreeType& queryNode)
+{
+  // Symmetric rules are not used with trees whose first point is the centroid,
+  // and the two nodes are disjoint, so no result can be added twice here.
+  for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
+  {
+    ElemType d = 0;
+    if constexpr (SinkType::NeedsDistances)
+    {
+      d = distance.Evaluate(querySet.unsafe_col(queryNode.Descendant(i)),
+          referenceSet.unsafe_col(referenceIndex));
+    }
+
+    reverseResults.emplace_back(referenceIndex, queryNode.Descendant(i), d);
+  }
+}
 
-    neighbors[queryIndex].push_back(referenceNode.Descendant(i));
-    distances[queryIndex].push_back(d);
+//! Pass the reversed results to the sink.
+template<typename DistanceType, typename TreeType, typename SinkType>
+void RangeSearchRules<DistanceType, TreeType, SinkType>::FlushReverseResults()
+{
+  for (size_t i = 0; i < reverseResults.size(); ++i)
+  {
+    sink.Add(std::get<0>(reverseResults[i]), std::get<1>(reverseResults[i]),
+        std::get<2>(reverseResults[i]));
   }
+
+  reverseResults.clear();
+  reverseResults.shrink_to_fit();
 }
 
 } // namespace mlpack
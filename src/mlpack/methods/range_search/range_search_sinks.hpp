@@ -0,0 +1,171 @@
+/**
+ * @file methods/range_search/range_search_sinks.hpp
+ *
+ * Sinks that receive the results of range search as they are found by
+ * RangeSearchRules: they can be stored in vectors, passed to a callback, or
+ * only counted.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_SINKS_HPP
+#define MLPACK_METHODS_RANGE_SEARCH_RANGE_SEARCH_SINKS_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A sink that stores the neighbors and distances of each query point in
+ * vectors; this is what RangeSearch::Search() returns.  A sink must provide
+ * Reserve(), which is called with an upper bound on the number of results
+ * about to be added for a query point, Add(), which is called for each result,
+ * and NeedsDistances, which is false if Add() ignores the distances (so that
+ * they are not computed when a whole node is in the range).
+ */
+template<typename ElemType>
+class RangeSearchVectorSink
+{
+ public:
+  //! Distances are stored, so they must be computed.
+  static constexpr bool NeedsDistances = true;
+
+  /**
+   * Create the sink to store results in the given vectors, which must already
+   * hold one (empty) vector for each query point.
+   */
+  RangeSearchVectorSink(std::vector<std::vector<size_t>>& neighbors,
+                        std::vector<std::vector<ElemType>>& distances) :
+      neighbors(&neighbors),
+      distances(&distances)
+  { }
+
+  //! Reserve space for the given number of results for the query point.
+  void Reserve(const size_t queryIndex, const size_t numResults)
+  {
+    (*neighbors)[queryIndex].reserve((*neighbors)[queryIndex].size() +
+        numResults);
+    (*distances)[queryIndex].reserve((*distances)[queryIndex].size() +
+        numResults);
+  }
+
+  //! Store a result.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const ElemType distance)
+  {
+    (*neighbors)[queryIndex].push_back(referenceIndex);
+    (*distances)[queryIndex].push_back(distance);
+  }
+
+ private:
+  //! The neighbors of each query point.
+  std::vector<std::vector<size_t>>* neighbors;
+  //! The distances of each query point.
+  std::vector<std::vector<ElemType>>* distances;
+};
+
+/**
+ * A sink that passes each result to a callback as callback(queryIndex,
+ * referenceIndex, distance), as soon as it is found, so that no results are
+ * stored.  The indices passed to the callback are the indices in the original
+ * datasets; if the trees rearranged the points, they are mapped back with the
+ * given mappings.
+ *
+ * When OpenMP is used, the callback is called from several threads at once,
+ * but every query point is handled by only one thread.
+ */
+template<typename CallbackType, typename ElemType>
+class RangeSearchCallbackSink
+{
+ public:
+  //! The callback receives the distances.
+  static constexpr bool NeedsDistances = true;
+
+  /**
+   * Create the sink for the given callback.
+   *
+   * @param callback Callback to pass the results to.
+   * @param queryMap Mapping from new to old query indices (or NULL).
+   * @param referenceMap Mapping from new to old reference indices (or NULL).
+   */
+  RangeSearchCallbackSink(CallbackType& callback,
+                          const std::vector<size_t>* queryMap = NULL,
+                          const std::vector<size_t>* referenceMap = NULL) :
+      callback(&callback),
+      queryMap(queryMap),
+      referenceMap(referenceMap)
+  { }
+
+  //! Nothing is stored, so there is nothing to reserve.
+  void Reserve(const size_t /* queryIndex */, const size_t /* numResults */)
+  { }
+
+  //! Pass a result to the callback.
+  void Add(const size_t queryIndex,
+           const size_t referenceIndex,
+           const ElemType distance)
+  {
+    (*callback)(queryMap ? (*queryMap)[queryIndex] : queryIndex,
+        referenceMap ? (*referenceMap)[referenceIndex] : referenceIndex,
+        distance);
+  }
+
+ private:
+  //! The callback.
+  CallbackType* callback;
+  //! Mapping from new to old query indices (or NULL).
+  const std::vector<size_t>* queryMap;
+  //! Mapping from new to old reference indices (or NULL).
+  const std::vector<size_t>* referenceMap;
+};
+
+/**
+ * A sink that only counts the results of each query point, for instance for
+ * density estimation.  Distances are not computed when a whole node is in the
+ * range.
+ */
+template<typename ElemType>
+class RangeSearchCountSink
+{
+ public:
+  //! Only the number of results is needed.
+  static constexpr bool NeedsDistances = false;
+
+  /**
+   * Create the sink to count results in the given vector, which must already
+   * have one element for each query point.
+   *
+   * @param counts Number of results of each query point.
+   * @param queryMap Mapping from new to old query indices (or NULL).
+   */
+  RangeSearchCountSink(arma::Col<size_t>& counts,
+                       const std::vector<size_t>* queryMap = NULL) :
+      counts(&counts),
+      queryMap(queryMap)
+  { }
+
+  //! Nothing is stored, so there is nothing to reserve.
+  void Reserve(const size_t /* queryIndex */, const size_t /* numResults */)
+  { }
+
+  //! Count a result.
+  void Add(const size_t queryIndex,
+           const size_t /* referenceIndex */,
+           const ElemType /* distance */)
+  {
+    ++(*counts)[queryMap ? (*queryMap)[queryIndex] : queryIndex];
+  }
+
+ private:
+  //! The number of results of each query point.
+  arma::Col<size_t>* counts;
+  //! Mapping from new to old query indices (or NULL).
+  const std::vector<size_t>* queryMap;
+};
+
+} // namespace mlpack
+
+#endif
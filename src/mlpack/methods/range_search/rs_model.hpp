@@ -19,6 +19,8 @@
 #include <mlpack/core/tree/cover_tree.hpp>
 #include <mlpack/core/tree/rectangle_tree.hpp>
 #include <mlpack/core/tree/octree.hpp>
+#include <mlpack/core/data/mapped_file.hpp>
+#include <mlpack/core/math/intrinsic_dimension.hpp>
 
 #include "range_search.hpp"
 
@@ -44,8 +46,12 @@ class RSWrapperBase
   //! Destruct the RSWrapperBase (nothing to do).
   virtual ~RSWrapperBase() { }
 
-  //! Get the dataset.
+  //! Get the dataset.  This throws std::logic_error if the dataset is held in
+  //! single precision.
   virtual const arma::mat& Dataset() const = 0;
+  //! Get the dataset, if it is held in single precision.  Otherwise,
+  //! std::logic_error is thrown.
+  virtual const arma::fmat& FloatDataset() const = 0;
 
   //! Get whether single-tree search is being used.
   virtual bool SingleMode() const = 0;
@@ -57,7 +63,13 @@ class RSWrapperBase
   //! Modify whether naive search is being used.
   virtual bool& Naive() = 0;
 
-  //! Train the model (build the reference tree if needed).
+  //! Get the collector of traversal statistics (NULL by default).
+  virtual TraversalStatistics* Statistics() const = 0;
+  //! Modify the collector of traversal statistics.
+  virtual TraversalStatistics*& Statistics() = 0;
+
+  //! Train the model (build the reference tree if needed).  The reference set
+  //! is converted to the element type held by the wrapper, if needed.
   virtual void Train(util::Timers& timers,
                      arma::mat&& referenceSet,
                      const size_t leafSize) = 0;
@@ -80,11 +92,14 @@ class RSWrapperBase
 };
 
 /**
- * RSWrapper is a wrapper class for most RangeSearch types.
+ * RSWrapper is a wrapper class for most RangeSearch types.  The data is held as
+ * `MatType`; data passed through the RSWrapperBase interface is converted to
+ * and from `MatType` as needed.
  */
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
 class RSWrapper : public RSWrapperBase
 {
  public:
@@ -102,8 +117,25 @@ class RSWrapper : public RSWrapperBase
   //! Destruct the RSWrapper (nothing to do).
   virtual ~RSWrapper() { }
 
-  //! Get the dataset.
-  const arma::mat& Dataset() const { return rs.ReferenceSet(); }
+  //! Get the dataset, if it is held in double precision.
+  const arma::mat& Dataset() const
+  {
+    if constexpr (std::is_same_v<MatType, arma::mat>)
+      return rs.ReferenceSet();
+    else
+      throw std::logic_error("RSWrapper::Dataset(): the reference set is held "
+          "in single precision; use FloatDataset() instead");
+  }
+
+  //! Get the dataset, if it is held in single precision.
+  const arma::fmat& FloatDataset() const
+  {
+    if constexpr (std::is_same_v<MatType, arma::fmat>)
+      return rs.ReferenceSet();
+    else
+      throw std::logic_error("RSWrapper::FloatDataset(): the reference set is "
+          "not held in single precision; use Dataset() instead");
+  }
 
   //! Get whether single-tree search is being used.
   bool SingleMode() const { return rs.SingleMode(); }
@@ -115,6 +147,11 @@ class RSWrapper : public RSWrapperBase
   //! Modify whether naive search is being used.
   bool& Naive() { return rs.Naive(); }
 
+  //! Get the collector of traversal statistics.
+  TraversalStatistics* Statistics() const { return rs.Statistics(); }
+  //! Modify the collector of traversal statistics.
+  TraversalStatistics*& Statistics() { return rs.Statistics(); }
+
   //! Train the model (build the reference tree if needed).  This ignores the
   //! leaf size.
   virtual void Train(util::Timers& timers,
@@ -145,7 +182,39 @@ class RSWrapper : public RSWrapperBase
   }
 
  protected:
-  using RSType = RangeSearch<EuclideanDistance, arma::mat, TreeType>;
+  using RSType = RangeSearch<EuclideanDistance, MatType, TreeType>;
+  using ElemType = typename MatType::elem_type;
+
+  //! Convert the given range to the element type of the data.  The bounds are
+  //! clamped to what ElemType can represent (e.g. DBL_MAX for an open range).
+  static RangeType<ElemType> TypedRange(const Range& range)
+  {
+    const double maxValue = (double) std::numeric_limits<ElemType>::max();
+    return RangeType<ElemType>(
+        (ElemType) std::min(std::max(range.Lo(), -maxValue), maxValue),
+        (ElemType) std::min(std::max(range.Hi(), -maxValue), maxValue));
+  }
+
+  //! Move the given distances into `distances`, converting them to double
+  //! precision if needed.
+  static void StoreDistances(std::vector<std::vector<ElemType>>& typedDistances,
+                             std::vector<std::vector<double>>& distances)
+  {
+    if constexpr (std::is_same_v<ElemType, double>)
+    {
+      distances = std::move(typedDistances);
+    }
+    else
+    {
+      distances.resize(typedDistances.size());
+      for (size_t i = 0; i < typedDistances.size(); ++i)
+      {
+        distances[i].assign(typedDistances[i].begin(),
+            typedDistances[i].end());
+      }
+      typedDistances.clear();
+    }
+  }
 
   //! The instantiated RangeSearch object that we are wrapping.
   RSType rs;
@@ -158,14 +227,15 @@ class RSWrapper : public RSWrapperBase
  */
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-class LeafSizeRSWrapper : public RSWrapper<TreeType>
+                  typename TreeMatType> class TreeType,
+         typename MatType = arma::mat>
+class LeafSizeRSWrapper : public RSWrapper<TreeType, MatType>
 {
  public:
   //! Construct the LeafSizeRSWrapper by delegating to the RSWrapper
   //! constructor.
   LeafSizeRSWrapper(const bool singleMode, const bool naive) :
-      RSWrapper<TreeType>(singleMode, naive)
+      RSWrapper<TreeType, MatType>(singleMode, naive)
   {
     // Nothing else to do.
   }
@@ -201,7 +271,10 @@ class LeafSizeRSWrapper : public RSWrapper<TreeType>
   }
 
  protected:
-  using RSWrapper<TreeType>::rs;
+  using RSWrapper<TreeType, MatType>::rs;
+  using typename RSWrapper<TreeType, MatType>::ElemType;
+  using RSWrapper<TreeType, MatType>::TypedRange;
+  using RSWrapper<TreeType, MatType>::StoreDistances;
 };
 
 /**
@@ -209,6 +282,16 @@ class LeafSizeRSWrapper : public RSWrapper<TreeType>
  * abstracting away the TreeType parameter and allowing it to be specified at
  * runtime.  This class is written for the sake of the `range_search` binding,
  * but is not necessarily restricted to that usage.
+ *
+ * If SinglePrecision() is set before BuildModel() is called, the reference set
+ * and trees are held and searched with single-precision (32-bit) floating
+ * point values, which halves their memory use.  Data is still passed to and
+ * returned from the model in double precision.
+ *
+ * If the tree type is AUTO_TREE, SelectTree() must be called before
+ * BuildModel(): it chooses the tree type, the leaf size and the search mode
+ * from short trial searches on samples of the data.  The choice (and the
+ * estimated intrinsic dimension of the data) is saved with the model.
  */
 class RSModel
 {
@@ -228,7 +311,9 @@ class RSModel
     RP_TREE,
     MAX_RP_TREE,
     UB_TREE,
-    OCTREE
+    OCTREE,
+    //! The tree type is chosen by SelectTree().
+    AUTO_TREE
   };
 
   /**
@@ -276,10 +361,30 @@ class RSModel
 
   //! Serialize the range search model.
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
-  //! Expose the dataset.
+  //! Expose the dataset, if it is held in double precision.
   const arma::mat& Dataset() const { return rSearch->Dataset(); }
+  //! Expose the dataset, if it is held in single precision.
+  const arma::fmat& FloatDataset() const { return rSearch->FloatDataset(); }
+
+  //! Get the dimensionality of the reference set.
+  size_t Dimensionality() const
+  {
+    return singlePrecision ? FloatDataset().n_rows : Dataset().n_rows;
+  }
+
+  //! Get the number of points in the reference set.
+  size_t NumReferencePoints() const
+  {
+    return singlePrecision ? FloatDataset().n_cols : Dataset().n_cols;
+  }
+
+  //! Get the mapped file holding the reference set, if any (see
+  //! data::LoadMapped()).
+  const std::shared_ptr<data::MappedFile>& Mapping() const { return mapping; }
+  //! Modify the mapped file holding the reference set.
+  std::shared_ptr<data::MappedFile>& Mapping() { return mapping; }
 
   //! Get whether the model is in single-tree search mode.
   bool SingleMode() const { return rSearch->SingleMode(); }
@@ -291,6 +396,12 @@ class RSModel
   //! Modify whether the model is in naive search mode.
   bool& Naive() { return rSearch->Naive(); }
 
+  //! Get the collector of traversal statistics.  BuildModel() resets it to
+  //! NULL, so set it after the model is built.
+  TraversalStatistics* Statistics() const { return rSearch->Statistics(); }
+  //! Modify the collector of traversal statistics.
+  TraversalStatistics*& Statistics() { return rSearch->Statistics(); }
+
   //! Get the leaf size (applicable to everything but the cover tree).
   size_t LeafSize() const { return leafSize; }
   //! Modify the leaf size (applicable to everything but the cover tree).
@@ -307,6 +418,46 @@ class RSModel
   //! been built).
   bool& RandomBasis() { return randomBasis; }
 
+  //! Get whether the reference set is held in single precision.
+  bool SinglePrecision() const { return singlePrecision; }
+  //! Modify whether the reference set is held in single precision (don't do
+  //! this after the model has been built).
+  bool& SinglePrecision() { return singlePrecision; }
+
+  //! Get whether the tree type and leaf size were chosen by SelectTree().
+  bool AutoSelected() const { return autoSelected; }
+  //! Get the intrinsic dimension of the data estimated by SelectTree() (0 if
+  //! it was not called).
+  double IntrinsicDimension() const { return intrinsicDimension; }
+
+  /**
+   * Choose the tree type, the leaf size and the search mode (single-tree or
+   * dual-tree) for the given data and range, and set the tree type and leaf
+   * size of the model; pass LeafSize() and the returned search mode to
+   * BuildModel().  Up to 5000 reference points and up to 1000 query points
+   * are sampled, their intrinsic dimension is estimated (see
+   * EstimateIntrinsicDimension()), and for each candidate tree type and leaf
+   * size, a tree is built on the reference sample and both search modes are
+   * timed for the query sample.  The fastest combination is chosen.
+   *
+   * The candidates are the same as for NSModel::SelectTree(): kd-trees and
+   * ball trees, octrees if there are at most 4 dimensions, and cover trees,
+   * vantage point trees and max-split random projection trees if there are
+   * more than 10 dimensions or the intrinsic dimension is less than half of
+   * the dimensionality, with leaf sizes 10, 20 and 40.
+   *
+   * @param timers Timers; the time is recorded as "selecting_tree".
+   * @param referenceSet Reference set that will be passed to BuildModel().
+   * @param querySet Query set that will be searched (empty for monochromatic
+   *     search).
+   * @param range Range that will be searched for.
+   * @return Whether single-tree search was chosen.
+   */
+  bool SelectTree(util::Timers& timers,
+                  const arma::mat& referenceSet,
+                  const arma::mat& querySet,
+                  const Range& range);
+
   /**
    * Allocate the memory for the range search model.
    */
@@ -368,6 +519,13 @@ class RSModel
   bool randomBasis;
   //! Random projection matrix.
   arma::mat q;
+  //! If true, the reference set is held in single precision.
+  bool singlePrecision;
+  //! If true, the tree type and leaf size were chosen by SelectTree().
+  bool autoSelected;
+  //! The intrinsic dimension of the data estimated by SelectTree() (0 if it
+  //! was not called).
+  double intrinsicDimension;
 
   /**
    * rSearch holds an instance of the RangeSearch class for the current
@@ -375,6 +533,10 @@ class RSModel
    */
   RSWrapperBase* rSearch;
 
+  //! If the model was loaded with data::LoadMapped(), this holds the mapped
+  //! file that the reference set lives in.
+  std::shared_ptr<data::MappedFile> mapping;
+
   /**
    * Return a string representing the name of the tree.  This is used for
    * logging output.
@@ -385,10 +547,25 @@ class RSModel
    * Clean up memory.
    */
   void CleanMemory();
+
+  //! Create the wrapper for the current tree type that holds its data as
+  //! `MatType`.
+  template<typename MatType>
+  RSWrapperBase* CreateWrapper(const bool naive, const bool singleMode) const;
+
+  //! Serialize the wrapper for the current tree type that holds its data as
+  //! `MatType`.
+  template<typename MatType, typename Archive>
+  void SerializeWrapper(Archive& ar);
 };
 
 } // namespace mlpack
 
+// CEREAL_CLASS_VERSION() does not mark the version as inline, so it cannot be
+// used in a header; CEREAL_TEMPLATE_CLASS_VERSION() with no template arguments
+// can.
+CEREAL_TEMPLATE_CLASS_VERSION((), (mlpack::RSModel), (2));
+
 // Include implementation (of serialize() and templated wrapper classes).
 #include "rs_model_impl.hpp"
 
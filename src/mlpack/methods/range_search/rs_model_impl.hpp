@@ -27,6 +27,9 @@ inline RSModel::RSModel(TreeTypes treeType, bool randomBasis) :
     treeType(treeType),
     leafSize(0),
     randomBasis(randomBasis),
+    singlePrecision(false),
+    autoSelected(false),
+    intrinsicDimension(0.0),
     rSearch(NULL)
 {
   // Nothing to do.
@@ -38,7 +41,11 @@ inline RSModel::RSModel(const RSModel& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(other.q),
-    rSearch(other.rSearch->Clone())
+    singlePrecision(other.singlePrecision),
+    autoSelected(other.autoSelected),
+    intrinsicDimension(other.intrinsicDimension),
+    rSearch(other.rSearch->Clone()),
+    mapping(other.mapping)
 {
   // Nothing to do.
 }
@@ -49,12 +56,19 @@ inline RSModel::RSModel(RSModel&& other) :
     leafSize(other.leafSize),
     randomBasis(other.randomBasis),
     q(std::move(other.q)),
-    rSearch(std::move(other.rSearch))
+    singlePrecision(other.singlePrecision),
+    autoSelected(other.autoSelected),
+    intrinsicDimension(other.intrinsicDimension),
+    rSearch(std::move(other.rSearch)),
+    mapping(std::move(other.mapping))
 {
   // Reset other model.
   other.treeType = TreeTypes::KD_TREE;
   other.leafSize = 0;
   other.randomBasis = false;
+  other.singlePrecision = false;
+  other.autoSelected = false;
+  other.intrinsicDimension = 0.0;
 }
 
 // Copy operator.
@@ -68,7 +82,11 @@ inline RSModel& RSModel::operator=(const RSModel& other)
     leafSize = other.leafSize;
     randomBasis = other.randomBasis;
     q = other.q;
+    singlePrecision = other.singlePrecision;
+    autoSelected = other.autoSelected;
+    intrinsicDimension = other.intrinsicDimension;
     rSearch = other.rSearch->Clone();
+    mapping = other.mapping;
   }
 
   return *this;
@@ -85,11 +103,18 @@ inline RSModel& RSModel::operator=(RSModel&& other)
     leafSize = other.leafSize;
     randomBasis = other.randomBasis;
     q = std::move(other.q);
+    singlePrecision = other.singlePrecision;
+    autoSelected = other.autoSelected;
+    intrinsicDimension = other.intrinsicDimension;
     rSearch = std::move(other.rSearch);
+    mapping = std::move(other.mapping);
 
     other.treeType = TreeTypes::KD_TREE;
     other.leafSize = 0;
     other.randomBasis = false;
+    other.singlePrecision = false;
+    other.autoSelected = false;
+    other.intrinsicDimension = 0.0;
   }
 
   return *this;
@@ -107,64 +132,66 @@ inline void RSModel::InitializeModel(const bool naive,
   // Clean memory, if necessary.
   delete rSearch;
 
+  if (singlePrecision)
+    rSearch = CreateWrapper<arma::fmat>(naive, singleMode);
+  else
+    rSearch = CreateWrapper<arma::mat>(naive, singleMode);
+}
+
+template<typename MatType>
+RSWrapperBase* RSModel::CreateWrapper(const bool naive,
+                                      const bool singleMode) const
+{
   switch (treeType)
   {
     case KD_TREE:
-      rSearch = new LeafSizeRSWrapper<KDTree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<KDTree, MatType>(naive, singleMode);
 
     case COVER_TREE:
-      rSearch = new RSWrapper<StandardCoverTree>(naive, singleMode);
-      break;
+      return new RSWrapper<StandardCoverTree, MatType>(naive, singleMode);
 
     case R_TREE:
-      rSearch = new RSWrapper<RTree>(naive, singleMode);
-      break;
+      return new RSWrapper<RTree, MatType>(naive, singleMode);
 
     case R_STAR_TREE:
-      rSearch = new RSWrapper<RStarTree>(naive, singleMode);
-      break;
+      return new RSWrapper<RStarTree, MatType>(naive, singleMode);
 
     case BALL_TREE:
-      rSearch = new LeafSizeRSWrapper<BallTree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<BallTree, MatType>(naive, singleMode);
 
     case X_TREE:
-      rSearch = new RSWrapper<XTree>(naive, singleMode);
-      break;
+      return new RSWrapper<XTree, MatType>(naive, singleMode);
 
     case HILBERT_R_TREE:
-      rSearch = new RSWrapper<HilbertRTree>(naive, singleMode);
-      break;
+      return new RSWrapper<HilbertRTree, MatType>(naive, singleMode);
 
     case R_PLUS_TREE:
-      rSearch = new RSWrapper<RPlusTree>(naive, singleMode);
-      break;
+      return new RSWrapper<RPlusTree, MatType>(naive, singleMode);
 
     case R_PLUS_PLUS_TREE:
-      rSearch = new RSWrapper<RPlusPlusTree>(naive, singleMode);
-      break;
+      return new RSWrapper<RPlusPlusTree, MatType>(naive, singleMode);
 
     case VP_TREE:
-      rSearch = new LeafSizeRSWrapper<VPTree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<VPTree, MatType>(naive, singleMode);
 
     case RP_TREE:
-      rSearch = new LeafSizeRSWrapper<RPTree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<RPTree, MatType>(naive, singleMode);
 
     case MAX_RP_TREE:
-      rSearch = new LeafSizeRSWrapper<MaxRPTree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<MaxRPTree, MatType>(naive, singleMode);
 
     case UB_TREE:
-      rSearch = new LeafSizeRSWrapper<UBTree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<UBTree, MatType>(naive, singleMode);
 
     case OCTREE:
-      rSearch = new LeafSizeRSWrapper<Octree>(naive, singleMode);
-      break;
+      return new LeafSizeRSWrapper<Octree, MatType>(naive, singleMode);
+
+    case AUTO_TREE:
+      throw std::invalid_argument("RSModel::InitializeModel(): the tree type "
+          "must be chosen with SelectTree() before the model is built!");
   }
+
+  return NULL; // This should never happen.
 }
 
 inline void RSModel::BuildModel(util::Timers& timers,
@@ -200,6 +227,123 @@ inline void RSModel::BuildModel(util::Timers& timers,
 }
 
 // Perform range search.
+inline bool RSModel::SelectTree(util::Timers& timers,
+                                const arma::mat& referenceSet,
+                                const arma::mat& querySet,
+                                const Range& range)
+{
+  const bool monochromatic = (querySet.n_cols == 0);
+  if (!monochromatic && querySet.n_rows != referenceSet.n_rows)
+  {
+    throw std::invalid_argument("RSModel::SelectTree(): the query set has " +
+        std::to_string(querySet.n_rows) + " dimensions, but the reference set "
+        "has " + std::to_string(referenceSet.n_rows) + "!");
+  }
+
+  timers.Start("selecting_tree");
+
+  // Sample the reference and query sets.
+  const size_t referenceSamples = std::min((size_t) referenceSet.n_cols,
+      (size_t) 5000);
+  const arma::mat referenceSample = (referenceSamples == referenceSet.n_cols) ?
+      referenceSet : arma::mat(referenceSet.cols(arma::randperm(
+      referenceSet.n_cols, referenceSamples)));
+  arma::mat querySample;
+  if (!monochromatic)
+  {
+    const size_t querySamples = std::min((size_t) querySet.n_cols,
+        (size_t) 1000);
+    querySample = querySet.cols(arma::randperm(querySet.n_cols,
+        querySamples));
+  }
+
+  const size_t d = referenceSet.n_rows;
+  intrinsicDimension = EstimateIntrinsicDimension(referenceSample);
+  Log::Info << "Estimated intrinsic dimension: " << intrinsicDimension
+      << " (of " << d << " dimensions)." << std::endl;
+
+  std::vector<TreeTypes> candidateTypes = { KD_TREE, BALL_TREE };
+  if (d <= 4)
+    candidateTypes.push_back(OCTREE);
+  if (d > 10 || intrinsicDimension < 0.5 * d)
+  {
+    candidateTypes.push_back(COVER_TREE);
+    candidateTypes.push_back(VP_TREE);
+    candidateTypes.push_back(MAX_RP_TREE);
+  }
+  const size_t candidateLeafSizes[] = { 10, 20, 40 };
+
+  TreeTypes bestType = KD_TREE;
+  size_t bestLeafSize = (leafSize == 0) ? 20 : leafSize;
+  bool bestSingleMode = false;
+  double bestTime = DBL_MAX;
+  if (referenceSamples > 0)
+  {
+    for (const TreeTypes type : candidateTypes)
+    {
+      for (const size_t candidateLeafSize : candidateLeafSizes)
+      {
+        for (const bool singleMode : { true, false })
+        {
+          RSModel trial(type);
+          trial.singlePrecision = singlePrecision;
+          trial.InitializeModel(false, singleMode);
+
+          util::Timers trialTimers;
+          std::vector<std::vector<size_t>> neighbors;
+          std::vector<std::vector<double>> distances;
+          const std::chrono::steady_clock::time_point start =
+              std::chrono::steady_clock::now();
+          trial.rSearch->Train(trialTimers, arma::mat(referenceSample),
+              candidateLeafSize);
+          if (monochromatic)
+          {
+            trial.rSearch->Search(trialTimers, range, neighbors, distances);
+          }
+          else
+          {
+            trial.rSearch->Search(trialTimers, arma::mat(querySample), range,
+                neighbors, distances, candidateLeafSize);
+          }
+          const double time = std::chrono::duration<double>(
+              std::chrono::steady_clock::now() - start).count();
+
+          Log::Info << "Trial " << (singleMode ? "single" : "dual")
+              << "-tree search with " << trial.TreeName();
+          if (type != COVER_TREE)
+            Log::Info << " (leaf size " << candidateLeafSize << ")";
+          Log::Info << ": " << time << "s." << std::endl;
+
+          if (time < bestTime)
+          {
+            bestTime = time;
+            bestType = type;
+            bestLeafSize = candidateLeafSize;
+            bestSingleMode = singleMode;
+          }
+        }
+
+        // The cover tree has no leaf size.
+        if (type == COVER_TREE)
+          break;
+      }
+    }
+  }
+
+  treeType = bestType;
+  leafSize = bestLeafSize;
+  autoSelected = true;
+  timers.Stop("selecting_tree");
+
+  Log::Info << "Selected " << (bestSingleMode ? "single" : "dual")
+      << "-tree search with " << TreeName();
+  if (treeType != COVER_TREE)
+    Log::Info << " (leaf size " << leafSize << ")";
+  Log::Info << "." << std::endl;
+
+  return bestSingleMode;
+}
+
 inline void RSModel::Search(util::Timers& timers,
                             arma::mat&& querySet,
                             const Range& range,
@@ -278,6 +422,8 @@ inline std::string RSModel::TreeName() const
       return "UB tree";
     case OCTREE:
       return "octree";
+    case AUTO_TREE:
+      return "automatically selected tree";
     default:
       return "unknown tree";
   }
@@ -291,78 +437,103 @@ inline void RSModel::CleanMemory()
 
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RSWrapper<TreeType>::Train(util::Timers& timers,
-                                arma::mat&& referenceSet,
-                                const size_t /* leafSize */)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void RSWrapper<TreeType, MatType>::Train(util::Timers& timers,
+                                         arma::mat&& referenceSet,
+                                         const size_t /* leafSize */)
 {
+  MatType typedReferenceSet;
+  MoveOrConvert(referenceSet, typedReferenceSet);
+
   if (!Naive())
     timers.Start("tree_building");
 
-  rs.Train(std::move(referenceSet));
+  rs.Train(std::move(typedReferenceSet));
   if (!Naive())
     timers.Stop("tree_building");
 }
 
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RSWrapper<TreeType>::Search(util::Timers& timers,
-                                 arma::mat&& querySet,
-                                 const Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances,
-                                 const size_t /* leafSize */)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void RSWrapper<TreeType, MatType>::Search(
+    util::Timers& timers,
+    arma::mat&& querySet,
+    const Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances,
+    const size_t /* leafSize */)
 {
+  MatType typedQuerySet;
+  MoveOrConvert(querySet, typedQuerySet);
+  const RangeType<ElemType> typedRange = TypedRange(range);
+  std::vector<std::vector<ElemType>> typedDistances;
+
   if (!Naive() && !SingleMode())
   {
     // We build the query tree manually, so that we can time how long it takes.
     timers.Start("tree_building");
-    typename decltype(rs)::Tree queryTree(std::move(querySet));
+    typename decltype(rs)::Tree queryTree(std::move(typedQuerySet));
     timers.Stop("tree_building");
 
     timers.Start("computing_neighbors");
-    rs.Search(&queryTree, range, neighbors, distances);
+    rs.Search(&queryTree, typedRange, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
   }
   else
   {
     timers.Start("computing_neighbors");
-    rs.Search(std::move(querySet), range, neighbors, distances);
+    rs.Search(std::move(typedQuerySet), typedRange, neighbors,
+        typedDistances);
     timers.Stop("computing_neighbors");
   }
+
+  StoreDistances(typedDistances, distances);
 }
 
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void RSWrapper<TreeType>::Search(util::Timers& timers,
-                                 const Range& range,
-                                 std::vector<std::vector<size_t>>& neighbors,
-                                 std::vector<std::vector<double>>& distances)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void RSWrapper<TreeType, MatType>::Search(
+    util::Timers& timers,
+    const Range& range,
+    std::vector<std::vector<size_t>>& neighbors,
+    std::vector<std::vector<double>>& distances)
 {
+  const RangeType<ElemType> typedRange = TypedRange(range);
+  std::vector<std::vector<ElemType>> typedDistances;
+
   timers.Start("computing_neighbors");
-  rs.Search(range, neighbors, distances);
+  rs.Search(typedRange, neighbors, typedDistances);
   timers.Stop("computing_neighbors");
+
+  StoreDistances(typedDistances, distances);
 }
 
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void LeafSizeRSWrapper<TreeType>::Train(util::Timers& timers,
-                                        arma::mat&& referenceSet,
-                                        const size_t leafSize)
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void LeafSizeRSWrapper<TreeType, MatType>::Train(util::Timers& timers,
+                                                 arma::mat&& referenceSet,
+                                                 const size_t leafSize)
 {
+  MatType typedReferenceSet;
+  MoveOrConvert(referenceSet, typedReferenceSet);
+
   if (rs.Naive())
   {
-    rs.Train(std::move(referenceSet));
+    rs.Train(std::move(typedReferenceSet));
   }
   else
   {
     timers.Start("tree_building");
     std::vector<size_t> oldFromNewReferences;
     typename decltype(rs)::Tree* tree =
-        new typename decltype(rs)::Tree(std::move(referenceSet),
+        new typename decltype(rs)::Tree(std::move(typedReferenceSet),
                                         oldFromNewReferences,
                                         leafSize);
     rs.Train(tree);
@@ -376,8 +547,9 @@ void LeafSizeRSWrapper<TreeType>::Train(util::Timers& timers,
 
 template<template<typename TreeDistanceType,
                   typename TreeStatType,
-                  typename TreeMatType> class TreeType>
-void LeafSizeRSWrapper<TreeType>::Search(
+                  typename TreeMatType> class TreeType,
+         typename MatType>
+void LeafSizeRSWrapper<TreeType, MatType>::Search(
     util::Timers& timers,
     arma::mat&& querySet,
     const Range& range,
@@ -385,163 +557,210 @@ void LeafSizeRSWrapper<TreeType>::Search(
     std::vector<std::vector<double>>& distances,
     const size_t leafSize)
 {
+  MatType typedQuerySet;
+  MoveOrConvert(querySet, typedQuerySet);
+  const RangeType<ElemType> typedRange = TypedRange(range);
+  std::vector<std::vector<ElemType>> typedDistances;
+
   if (!rs.Naive() && !rs.SingleMode())
   {
     // Build a second tree and search.
     timers.Start("tree_building");
     Log::Info << "Building query tree..." << std::endl;
     std::vector<size_t> oldFromNewQueries;
-    typename decltype(rs)::Tree queryTree(std::move(querySet),
+    typename decltype(rs)::Tree queryTree(std::move(typedQuerySet),
                                           oldFromNewQueries,
                                           leafSize);
     Log::Info << "Tree built." << std::endl;
     timers.Stop("tree_building");
 
     std::vector<std::vector<size_t>> neighborsOut;
-    std::vector<std::vector<double>> distancesOut;
+    std::vector<std::vector<ElemType>> distancesOut;
     timers.Start("computing_neighbors");
-    rs.Search(&queryTree, range, neighborsOut, distancesOut);
+    rs.Search(&queryTree, typedRange, neighborsOut, distancesOut);
     timers.Stop("computing_neighbors");
 
     // Remap the query points.
     neighbors.resize(queryTree.Dataset().n_cols);
-    distances.resize(queryTree.Dataset().n_cols);
+    typedDistances.resize(queryTree.Dataset().n_cols);
     for (size_t i = 0; i < queryTree.Dataset().n_cols; ++i)
     {
-      neighbors[oldFromNewQueries[i]] = neighborsOut[i];
-      distances[oldFromNewQueries[i]] = distancesOut[i];
+      neighbors[oldFromNewQueries[i]] = std::move(neighborsOut[i]);
+      typedDistances[oldFromNewQueries[i]] = std::move(distancesOut[i]);
     }
   }
   else
   {
     timers.Start("computing_neighbors");
-    rs.Search(std::move(querySet), range, neighbors, distances);
+    rs.Search(std::move(typedQuerySet), typedRange, neighbors, typedDistances);
     timers.Stop("computing_neighbors");
   }
+
+  StoreDistances(typedDistances, distances);
 }
 
 // Serialize the model.
 template<typename Archive>
-void RSModel::serialize(Archive& ar, const uint32_t /* version */)
+void RSModel::serialize(Archive& ar, const uint32_t version)
 {
   ar(CEREAL_NVP(treeType));
   ar(CEREAL_NVP(randomBasis));
   ar(CEREAL_NVP(q));
 
+  // Models saved before single precision was supported always hold their
+  // reference set in double precision.
+  if (cereal::is_loading<Archive>() && version == 0)
+    singlePrecision = false;
+  else
+    ar(CEREAL_NVP(singlePrecision));
+
+  // Models saved before automatic tree selection was supported never used it,
+  // and did not save their leaf size.
+  if (cereal::is_loading<Archive>() && version < 2)
+  {
+    autoSelected = false;
+    intrinsicDimension = 0.0;
+  }
+  else
+  {
+    ar(CEREAL_NVP(leafSize));
+    ar(CEREAL_NVP(autoSelected));
+    ar(CEREAL_NVP(intrinsicDimension));
+  }
+
   // This should never happen, but just in case...
   if (cereal::is_loading<Archive>())
     InitializeModel(false, false); // Values will be overwritten.
 
+  if (singlePrecision)
+    SerializeWrapper<arma::fmat>(ar);
+  else
+    SerializeWrapper<arma::mat>(ar);
+}
+
+// Serialize the wrapper for the current tree type.
+template<typename MatType, typename Archive>
+void RSModel::SerializeWrapper(Archive& ar)
+{
   // Avoid polymorphic serialization by explicitly serializing the correct type.
   switch (treeType)
   {
     case KD_TREE:
       {
-        LeafSizeRSWrapper<KDTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<KDTree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<KDTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+
     case COVER_TREE:
       {
-        RSWrapper<StandardCoverTree>& typedSearch =
-            dynamic_cast<RSWrapper<StandardCoverTree>&>(*rSearch);
+        using WrapperType = RSWrapper<StandardCoverTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_TREE:
       {
-        RSWrapper<RTree>& typedSearch =
-            dynamic_cast<RSWrapper<RTree>&>(*rSearch);
+        using WrapperType = RSWrapper<RTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_STAR_TREE:
       {
-        RSWrapper<RStarTree>& typedSearch =
-            dynamic_cast<RSWrapper<RStarTree>&>(*rSearch);
+        using WrapperType = RSWrapper<RStarTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case BALL_TREE:
       {
-        LeafSizeRSWrapper<BallTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<BallTree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<BallTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+
     case X_TREE:
       {
-        RSWrapper<XTree>& typedSearch =
-            dynamic_cast<RSWrapper<XTree>&>(*rSearch);
+        using WrapperType = RSWrapper<XTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case HILBERT_R_TREE:
       {
-        RSWrapper<HilbertRTree>& typedSearch =
-            dynamic_cast<RSWrapper<HilbertRTree>&>(*rSearch);
+        using WrapperType = RSWrapper<HilbertRTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_PLUS_TREE:
       {
-        RSWrapper<RPlusTree>& typedSearch =
-            dynamic_cast<RSWrapper<RPlusTree>&>(*rSearch);
+        using WrapperType = RSWrapper<RPlusTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case R_PLUS_PLUS_TREE:
       {
-        RSWrapper<RPlusPlusTree>& typedSearch =
-            dynamic_cast<RSWrapper<RPlusPlusTree>&>(*rSearch);
+        using WrapperType = RSWrapper<RPlusPlusTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case VP_TREE:
       {
-        LeafSizeRSWrapper<VPTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<VPTree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<VPTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case RP_TREE:
       {
-        LeafSizeRSWrapper<RPTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<RPTree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<RPTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
 
     case MAX_RP_TREE:
       {
-        LeafSizeRSWrapper<MaxRPTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<MaxRPTree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<MaxRPTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+
     case UB_TREE:
       {
-        LeafSizeRSWrapper<UBTree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<UBTree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<UBTree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+
     case OCTREE:
       {
-        LeafSizeRSWrapper<Octree>& typedSearch =
-            dynamic_cast<LeafSizeRSWrapper<Octree>&>(*rSearch);
+        using WrapperType = LeafSizeRSWrapper<Octree, MatType>;
+        WrapperType& typedSearch = dynamic_cast<WrapperType&>(*rSearch);
         ar(CEREAL_NVP(typedSearch));
         break;
       }
+
+    case AUTO_TREE:
+      // A model is never built (or loaded) with this tree type; see
+      // CreateWrapper().
+      break;
   }
 }
 
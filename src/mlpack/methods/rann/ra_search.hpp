@@ -391,6 +391,35 @@ class RASearch
   //! Instantiation of distance metric.
   DistanceType distance;
 
+  /**
+   * Run the base case on every combination of the first numQueries query
+   * points and the given reference points, in parallel over the query points
+   * if OpenMP is available.
+   */
+  template<typename RuleType>
+  void NaiveBaseCases(RuleType& rules,
+                      const size_t numQueries,
+                      const arma::uvec& samples);
+
+  /**
+   * Run a single-tree traversal of the reference tree for each of the first
+   * numQueries query points, in parallel if OpenMP is available.  The random
+   * engine of the rules is reseeded for each query point, so the results do
+   * not depend on the number of threads.
+   */
+  template<typename RuleType>
+  void SingleTreeTraversal(RuleType& rules, const size_t numQueries);
+
+  /**
+   * Run a dual-tree traversal of the given query tree and the reference tree.
+   * If OpenMP is available, the query tree is split into disjoint subtrees
+   * that are traversed in parallel, each with a random engine seeded from the
+   * one of the rules; the results are then reproducible for a fixed number of
+   * threads.
+   */
+  template<typename RuleType>
+  void DualTreeTraversal(RuleType& rules, Tree& queryTree);
+
   //! For access to mappings when building models.
   friend class LeafSizeRAWrapper<TreeType>;
 }; // class RASearch
@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_RANN_RA_SEARCH_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/tree/query_frontier.hpp>
 
 #include "ra_search_rules.hpp"
 
@@ -276,9 +277,7 @@ Search(const MatType& querySet,
 
     // Run the base case on each combination of query point and sampled
     // reference point.
-    for (size_t i = 0; i < querySet.n_cols; ++i)
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        rules.BaseCase(i, (size_t) distinctSamples[j]);
+    NaiveBaseCases(rules, querySet.n_cols, distinctSamples);
 
     rules.GetResults(*neighborPtr, *distancePtr);
   }
@@ -293,12 +292,8 @@ Search(const MatType& querySet,
     {
       Log::Info << "Performing single-tree traversal..." << std::endl;
 
-      // Create the traverser.
-      typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-      // Now have it traverse for each point.
-      for (size_t i = 0; i < querySet.n_cols; ++i)
-        traverser.Traverse(i, *referenceTree);
+      // Traverse for each point.
+      SingleTreeTraversal(rules, querySet.n_cols);
 
       Log::Info << "Single-tree traversal complete." << std::endl;
       Log::Info << "Average number of distance calculations per query point: "
@@ -318,12 +313,11 @@ Search(const MatType& querySet,
 
     RuleType rules(*referenceSet, queryTree->Dataset(), k, distance, tau, alpha,
         naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
 
     Log::Info << "Query statistic pre-search: "
         << queryTree->Stat().NumSamplesMade() << std::endl;
 
-    traverser.Traverse(*queryTree, *referenceTree);
+    DualTreeTraversal(rules, *queryTree);
 
     Log::Info << "Dual-tree traversal complete." << std::endl;
     Log::Info << "Average number of distance calculations per query point: "
@@ -428,9 +422,7 @@ void RASearch<SortPolicy, DistanceType, MatType, TreeType>::Search(
   RuleType rules(*referenceSet, queryTree->Dataset(), k, distance, tau, alpha,
       naive, sampleAtLeaves, firstLeafExact, singleSampleLimit, false);
 
-  // Create the traverser.
-  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-  traverser.Traverse(*queryTree, *referenceTree);
+  DualTreeTraversal(rules, *queryTree);
 
   rules.GetResults(*neighborPtr, distances);
 
@@ -490,25 +482,21 @@ void RASearch<SortPolicy, DistanceType, MatType, TreeType>::Search(
         numSamples);
 
     // The naive brute-force solution.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      for (size_t j = 0; j < referenceSet->n_cols; ++j)
-        rules.BaseCase(i, j);
+    const arma::uvec allPoints = arma::regspace<arma::uvec>(0,
+        referenceSet->n_cols - 1);
+    NaiveBaseCases(rules, referenceSet->n_cols, allPoints);
   }
   else if (singleMode)
   {
-    // Create the traverser.
-    typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
-
-    // Now have it traverse for each point.
-    for (size_t i = 0; i < referenceSet->n_cols; ++i)
-      traverser.Traverse(i, *referenceTree);
+    // Traverse for each point.
+    SingleTreeTraversal(rules, referenceSet->n_cols);
   }
   else
   {
-    // Create the traverser.
-    typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
-
-    traverser.Traverse(*referenceTree, *referenceTree);
+    // The reference tree is also the query tree, so its statistics may be left
+    // over from an earlier search.
+    ResetQueryTree(referenceTree);
+    DualTreeTraversal(rules, *referenceTree);
   }
 
   rules.GetResults(*neighborPtr, *distancePtr);
@@ -552,6 +540,143 @@ void RASearch<SortPolicy, DistanceType, MatType, TreeType>::ResetQueryTree(
     ResetQueryTree(&queryNode->Child(i));
 }
 
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, DistanceType, MatType, TreeType>::NaiveBaseCases(
+    RuleType& rules,
+    const size_t numQueries,
+    const arma::uvec& samples)
+{
+  #ifdef MLPACK_USE_OPENMP
+  if (omp_get_max_threads() > 1)
+  {
+    // Each query point is handled by exactly one thread, so the candidate
+    // lists can be shared.
+    size_t threadDistComputations = 0;
+    #pragma omp parallel reduction(+:threadDistComputations)
+    {
+      RuleType localRules(rules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < numQueries; ++i)
+        for (size_t j = 0; j < samples.n_elem; ++j)
+          localRules.BaseCase(i, (size_t) samples[j]);
+
+      threadDistComputations += localRules.NumDistComputations();
+    }
+
+    rules.NumDistComputations() += threadDistComputations;
+    return;
+  }
+  #endif
+
+  for (size_t i = 0; i < numQueries; ++i)
+    for (size_t j = 0; j < samples.n_elem; ++j)
+      rules.BaseCase(i, (size_t) samples[j]);
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, DistanceType, MatType, TreeType>::
+SingleTreeTraversal(RuleType& rules, const size_t numQueries)
+{
+  // Each query point is sampled with its own random engine.
+  const size_t seed = rules.RNG()();
+
+  #ifdef MLPACK_USE_OPENMP
+  if (omp_get_max_threads() > 1)
+  {
+    // Each query point is handled by exactly one thread, so the candidate
+    // lists and the counts of samples made can be shared.
+    size_t threadDistComputations = 0;
+    #pragma omp parallel reduction(+:threadDistComputations)
+    {
+      RuleType localRules(rules);
+      typename Tree::template SingleTreeTraverser<RuleType>
+          traverser(localRules);
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        localRules.RNG().seed((uint32_t) (seed + i));
+        traverser.Traverse(i, *referenceTree);
+      }
+
+      threadDistComputations += localRules.NumDistComputations();
+    }
+
+    rules.NumDistComputations() += threadDistComputations;
+    return;
+  }
+  #endif
+
+  typename Tree::template SingleTreeTraverser<RuleType> traverser(rules);
+  for (size_t i = 0; i < numQueries; ++i)
+  {
+    rules.RNG().seed((uint32_t) (seed + i));
+    traverser.Traverse(i, *referenceTree);
+  }
+}
+
+template<typename SortPolicy,
+         typename DistanceType,
+         typename MatType,
+         template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+template<typename RuleType>
+void RASearch<SortPolicy, DistanceType, MatType, TreeType>::DualTreeTraversal(
+    RuleType& rules,
+    Tree& queryTree)
+{
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = omp_get_max_threads();
+  if (numThreads > 1 && !queryTree.IsLeaf())
+  {
+    // Each query subtree in the frontier is traversed by one thread.  Score()
+    // only reads and writes the statistics of the query node and its
+    // children, so no statistic is touched by two threads.
+    std::vector<Tree*> frontier;
+    QueryFrontier(queryTree, 4 * numThreads, frontier);
+
+    // Each subtree is sampled with its own random engine, so the results only
+    // depend on the frontier (and thus on the number of threads).
+    const size_t seed = rules.RNG()();
+    size_t threadDistComputations = 0;
+    #pragma omp parallel reduction(+:threadDistComputations)
+    {
+      RuleType localRules(rules);
+      typename Tree::template DualTreeTraverser<RuleType> traverser(localRules);
+
+      #pragma omp for schedule(dynamic)
+      for (size_t i = 0; i < frontier.size(); ++i)
+      {
+        localRules.RNG().seed((uint32_t) (seed + i));
+        traverser.Traverse(*frontier[i], *referenceTree);
+      }
+
+      threadDistComputations += localRules.NumDistComputations();
+    }
+
+    rules.NumDistComputations() += threadDistComputations;
+    return;
+  }
+  #endif
+
+  typename Tree::template DualTreeTraverser<RuleType> traverser(rules);
+  traverser.Traverse(queryTree, *referenceTree);
+}
+
 template<typename SortPolicy,
          typename DistanceType,
          typename MatType,
@@ -17,6 +17,7 @@
 #include <mlpack/core/tree/traversal_info.hpp>
 
 #include <queue>
+#include <unordered_set>
 
 namespace mlpack {
 
@@ -65,6 +66,15 @@ class RASearchRules
                 const size_t singleSampleLimit = 20,
                 const bool sameSet = false);
 
+  /**
+   * Create a copy of the given rules that shares its candidate lists and its
+   * counts of samples made for each query.  The copy has its own random engine
+   * (a copy of the other one's engine), traversal information and count of
+   * distance computations.  This can be used to process disjoint subsets of
+   * the query points in parallel.
+   */
+  RASearchRules(RASearchRules& other);
+
   /**
    * Store the list of candidates for each query point in the given matrices.
    *
@@ -226,7 +236,11 @@ class RASearchRules
                  const double oldScore);
 
 
-  size_t NumDistComputations() { return numDistComputations; }
+  //! Get the number of distance computations performed.
+  size_t NumDistComputations() const { return numDistComputations; }
+  //! Modify the number of distance computations performed.
+  size_t& NumDistComputations() { return numDistComputations; }
+
   size_t NumEffectiveSamples()
   {
     if (numSamplesMade.n_elem == 0)
@@ -240,6 +254,10 @@ class RASearchRules
   const TraversalInfoType& TraversalInfo() const { return traversalInfo; }
   TraversalInfoType& TraversalInfo() { return traversalInfo; }
 
+  //! Modify the random engine used for sampling.  It is seeded from RandGen()
+  //! when the rules are constructed.
+  std::mt19937& RNG() { return rng; }
+
   //! Get the minimum number of base cases that must be performed for each query
   //! point for an acceptable result.  This is only needed in defeatist search
   //! mode.
@@ -267,8 +285,12 @@ class RASearchRules
   using CandidateList = std::priority_queue<Candidate, std::vector<Candidate>,
       CandidateCmp>;
 
-  //! Set of candidate neighbors for each point.
-  std::vector<CandidateList> candidates;
+  //! Set of candidate neighbors for each point, if owned by these rules.
+  std::vector<CandidateList> localCandidates;
+
+  //! Set of candidate neighbors for each point (possibly shared with other
+  //! rules).
+  std::vector<CandidateList>& candidates;
 
   //! Number of neighbors to search for.
   const size_t k;
@@ -288,8 +310,12 @@ class RASearchRules
   //! The minimum number of samples required per query.
   size_t numSamplesReqd;
 
-  //! The number of samples made for every query.
-  arma::Col<size_t> numSamplesMade;
+  //! The number of samples made for every query, if owned by these rules.
+  arma::Col<size_t> localNumSamplesMade;
+
+  //! The number of samples made for every query (possibly shared with other
+  //! rules).
+  arma::Col<size_t>& numSamplesMade;
 
   //! The sampling ratio.
   double samplingRatio;
@@ -302,6 +328,21 @@ class RASearchRules
 
   TraversalInfoType traversalInfo;
 
+  //! The random engine used for sampling.
+  std::mt19937 rng;
+
+  /**
+   * Sample numSamples distinct indices in [0, n) uniformly at random with the
+   * random engine of the rules.
+   *
+   * @param n Number of indices to sample from.
+   * @param numSamples Number of indices to sample (at most n).
+   * @param samples Vector to store the sampled indices in.
+   */
+  void SampleDistinct(const size_t n,
+                      const size_t numSamples,
+                      arma::uvec& samples);
+
   /**
    * Helper function to insert a point into the list of candidate points.
    *
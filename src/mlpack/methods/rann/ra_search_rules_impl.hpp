@@ -32,12 +32,15 @@ RASearchRules(const arma::mat& referenceSet,
               const bool sameSet) :
     referenceSet(referenceSet),
     querySet(querySet),
+    candidates(localCandidates),
     k(k),
     distance(distance),
     sampleAtLeaves(sampleAtLeaves),
     firstLeafExact(firstLeafExact),
     singleSampleLimit(singleSampleLimit),
-    sameSet(sameSet)
+    numSamplesMade(localNumSamplesMade),
+    sameSet(sameSet),
+    rng(RandGen()())
 {
   // Validate tau to make sure that the rank approximation is greater than the
   // number of neighbors requested.
@@ -83,17 +86,52 @@ RASearchRules(const arma::mat& referenceSet,
 
   if (naive) // No tree traversal; just do naive sampling here.
   {
-    // Sample enough points.
-    arma::uvec distinctSamples;
-    for (size_t i = 0; i < querySet.n_cols; ++i)
+    // Each query point is sampled with its own random engine, so the results
+    // do not depend on the number of threads.
+    const size_t seed = rng();
+    size_t threadDistComputations = 0;
+    #pragma omp parallel reduction(+:threadDistComputations)
     {
-      distinctSamples = arma::randperm(n, numSamplesReqd);
-      for (size_t j = 0; j < distinctSamples.n_elem; ++j)
-        BaseCase(i, (size_t) distinctSamples[j]);
+      RASearchRules localRules(*this);
+      arma::uvec distinctSamples;
+
+      #pragma omp for schedule(dynamic, 16)
+      for (size_t i = 0; i < querySet.n_cols; ++i)
+      {
+        localRules.rng.seed((uint32_t) (seed + i));
+        localRules.SampleDistinct(n, numSamplesReqd, distinctSamples);
+        for (size_t j = 0; j < distinctSamples.n_elem; ++j)
+          localRules.BaseCase(i, (size_t) distinctSamples[j]);
+      }
+
+      threadDistComputations += localRules.numDistComputations;
     }
+
+    numDistComputations += threadDistComputations;
   }
 }
 
+template<typename SortPolicy, typename DistanceType, typename TreeType>
+RASearchRules<SortPolicy, DistanceType, TreeType>::
+RASearchRules(RASearchRules& other) :
+    referenceSet(other.referenceSet),
+    querySet(other.querySet),
+    candidates(other.candidates),
+    k(other.k),
+    distance(other.distance),
+    sampleAtLeaves(other.sampleAtLeaves),
+    firstLeafExact(other.firstLeafExact),
+    singleSampleLimit(other.singleSampleLimit),
+    numSamplesReqd(other.numSamplesReqd),
+    numSamplesMade(other.numSamplesMade),
+    samplingRatio(other.samplingRatio),
+    numDistComputations(0),
+    sameSet(other.sameSet),
+    rng(other.rng)
+{
+  // Nothing else to do.
+}
+
 template<typename SortPolicy, typename DistanceType, typename TreeType>
 void RASearchRules<SortPolicy, DistanceType, TreeType>::GetResults(
     arma::Mat<size_t>& neighbors,
@@ -200,8 +238,9 @@ inline double RASearchRules<SortPolicy, DistanceType, TreeType>::Score(
         {
           // Then samplesReqd <= singleSampleLimit.
           // Hence, approximate the node by sampling enough number of points.
-          arma::uvec distinctSamples =
-              arma::randperm(referenceNode.NumDescendants(), samplesReqd);
+          arma::uvec distinctSamples;
+          SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+              distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; ++i)
             // The counting of the samples are done in the 'BaseCase' function
             // so no book-keeping is required here.
@@ -215,8 +254,9 @@ inline double RASearchRules<SortPolicy, DistanceType, TreeType>::Score(
           if (sampleAtLeaves) // If allowed to sample at leaves.
           {
             // Approximate node by sampling enough number of points.
-            arma::uvec distinctSamples =
-                arma::randperm(referenceNode.NumDescendants(), samplesReqd);
+            arma::uvec distinctSamples;
+            SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+                distinctSamples);
             for (size_t i = 0; i < distinctSamples.n_elem; ++i)
               // The counting of the samples are done in the 'BaseCase' function
               // so no book-keeping is required here.
@@ -302,8 +342,9 @@ Rescore(const size_t queryIndex,
       {
         // Then, samplesReqd <= singleSampleLimit.  Hence, approximate the node
         // by sampling enough number of points.
-        arma::uvec distinctSamples =
-            arma::randperm(referenceNode.NumDescendants(), samplesReqd);
+        arma::uvec distinctSamples;
+        SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+            distinctSamples);
         for (size_t i = 0; i < distinctSamples.n_elem; ++i)
           // The counting of the samples are done in the 'BaseCase' function so
           // no book-keeping is required here.
@@ -317,8 +358,9 @@ Rescore(const size_t queryIndex,
         if (sampleAtLeaves)
         {
           // Approximate node by sampling enough points.
-          arma::uvec distinctSamples =
-              arma::randperm(referenceNode.NumDescendants(), samplesReqd);
+          arma::uvec distinctSamples;
+          SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+              distinctSamples);
           for (size_t i = 0; i < distinctSamples.n_elem; ++i)
             // The counting of the samples are done in the 'BaseCase' function
             // so no book-keeping is required here.
@@ -504,8 +546,8 @@ inline double RASearchRules<SortPolicy, DistanceType, TreeType>::Score(
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            distinctSamples = arma::randperm(referenceNode.NumDescendants(),
-                samplesReqd);
+            SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+                distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; ++j)
               // The counting of the samples are done in the 'BaseCase' function
               // so no book-keeping is required here.
@@ -534,8 +576,8 @@ inline double RASearchRules<SortPolicy, DistanceType, TreeType>::Score(
             for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
             {
               const size_t queryIndex = queryNode.Descendant(i);
-              distinctSamples = arma::randperm(referenceNode.NumDescendants(),
-                  samplesReqd);
+              SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+                  distinctSamples);
               for (size_t j = 0; j < distinctSamples.n_elem; ++j)
                 // The counting of the samples are done in the 'BaseCase'
                 // function so no book-keeping is required here.
@@ -709,8 +751,8 @@ Rescore(TreeType& queryNode,
         for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
         {
           const size_t queryIndex = queryNode.Descendant(i);
-          distinctSamples = arma::randperm(referenceNode.NumDescendants(),
-              samplesReqd);
+          SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+              distinctSamples);
           for (size_t j = 0; j < distinctSamples.n_elem; ++j)
             // The counting of the samples are done in the 'BaseCase'
             // function so no book-keeping is required here.
@@ -738,8 +780,8 @@ Rescore(TreeType& queryNode,
           for (size_t i = 0; i < queryNode.NumDescendants(); ++i)
           {
             const size_t queryIndex = queryNode.Descendant(i);
-            distinctSamples = arma::randperm(referenceNode.NumDescendants(),
-                samplesReqd);
+            SampleDistinct(referenceNode.NumDescendants(), samplesReqd,
+                distinctSamples);
             for (size_t j = 0; j < distinctSamples.n_elem; ++j)
               // The counting of the samples are done in BaseCase() so no
               // book-keeping is required here.
@@ -798,6 +840,42 @@ Rescore(TreeType& queryNode,
  * @param neighbor Index of reference point which is being inserted.
  * @param dist Distance from query point to reference point.
  */
+template<typename SortPolicy, typename DistanceType, typename TreeType>
+inline void RASearchRules<SortPolicy, DistanceType, TreeType>::
+SampleDistinct(const size_t n,
+               const size_t numSamples,
+               arma::uvec& samples)
+{
+  // Floyd's algorithm: for j = n - numSamples, ..., n - 1, draw t in [0, j]
+  // and take t, or j if t was already taken.  This takes O(numSamples) time
+  // and memory, no matter how large n is.
+  samples.set_size(numSamples);
+  if (numSamples <= 32)
+  {
+    // For few samples, a linear search is faster than a hash set.
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+      const size_t j = n - numSamples + i;
+      const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+      const bool taken = std::find(samples.begin(), samples.begin() + i, t) !=
+          samples.begin() + i;
+      samples[i] = taken ? j : t;
+    }
+  }
+  else
+  {
+    std::unordered_set<size_t> taken;
+    taken.reserve(numSamples);
+    for (size_t i = 0; i < numSamples; ++i)
+    {
+      const size_t j = n - numSamples + i;
+      const size_t t = std::uniform_int_distribution<size_t>(0, j)(rng);
+      // j can't have been taken yet, because all earlier draws are below j.
+      samples[i] = taken.insert(t).second ? t : *taken.insert(j).first;
+    }
+  }
+}
+
 template<typename SortPolicy, typename DistanceType, typename TreeType>
 inline void RASearchRules<SortPolicy, DistanceType, TreeType>::
 InsertNeighbor(
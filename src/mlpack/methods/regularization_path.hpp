@@ -0,0 +1,17 @@
+/**
+ * @file regularization_path.hpp
+ *
+ * Convenience include for
+ * mlpack/methods/regularization_path/regularization_path.hpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_REGULARIZATION_PATH_HPP
+#define MLPACK_REGULARIZATION_PATH_HPP
+
+#include "regularization_path/regularization_path.hpp"
+
+#endif
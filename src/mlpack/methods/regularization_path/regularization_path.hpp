@@ -0,0 +1,224 @@
+/**
+ * @file methods/regularization_path/regularization_path.hpp
+ *
+ * Definition of the RegularizationPath class, which trains elastic-net
+ * penalized logistic and softmax regression models for a sequence of
+ * regularization strengths with coordinate descent.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZATION_PATH_REGULARIZATION_PATH_HPP
+#define MLPACK_METHODS_REGULARIZATION_PATH_REGULARIZATION_PATH_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/logistic_regression/logistic_regression.hpp>
+#include <mlpack/methods/softmax_regression/softmax_regression.hpp>
+
+namespace mlpack {
+
+/**
+ * RegularizationPath computes the solutions of elastic-net penalized logistic
+ * regression (two classes) or softmax regression (any number of classes) for a
+ * decreasing sequence of regularization strengths lambda, as in glmnet:
+ *
+ * @code
+ * @article{friedman2010regularization,
+ *   title={Regularization Paths for Generalized Linear Models via Coordinate
+ *       Descent},
+ *   author={Friedman, J. and Hastie, T. and Tibshirani, R.},
+ *   journal={Journal of Statistical Software},
+ *   volume={33},
+ *   number={1},
+ *   pages={1--22},
+ *   year={2010}
+ * }
+ * @endcode
+ *
+ * For each lambda, the objective
+ *
+ * \f[
+ * -\frac{1}{n} \log L(b, W) + \lambda \left( \alpha \| W \|_1 +
+ *     \frac{1 - \alpha}{2} \| W \|_F^2 \right)
+ * \f]
+ *
+ * is minimized, where L is the likelihood of the labels, b holds the
+ * intercepts (which are not penalized), and W holds the weights of the
+ * features.  alpha = 1 is the lasso, and alpha = 0 is ridge regression.
+ *
+ * The log-likelihood is approximated by a weighted least squares problem
+ * around the current solution, which is solved by cyclic coordinate descent
+ * (one class at a time for softmax regression).  Each lambda starts from the
+ * solution of the previous one, and the features that can't become nonzero
+ * under the sequential strong rule are skipped; the first-order optimality
+ * conditions are checked on them afterwards, and the violating features are
+ * added back.
+ *
+ * Sparse matrices are supported; only the nonzero values are visited.  The
+ * features are not standardized, so they should have comparable scales.
+ *
+ * @tparam MatType Type of data matrix.
+ */
+template<typename MatType = arma::mat>
+class RegularizationPath
+{
+ public:
+  using ElemType = typename MatType::elem_type;
+  using ColType = typename GetDenseColType<MatType>::type;
+  using DenseMatType = typename GetDenseMatType<MatType>::type;
+
+  /**
+   * Set the parameters of the path.  Unless the lambdas are given to Train(),
+   * numLambdas values are spaced logarithmically between the smallest lambda
+   * for which all weights are zero and that value times lambdaMinRatio.
+   *
+   * @param alpha Mixing of the L1 penalty (alpha = 1) and the squared L2
+   *     penalty (alpha = 0); must be in [0, 1].
+   * @param numLambdas Number of lambdas of the path.
+   * @param lambdaMinRatio Ratio of the last lambda to the first lambda.
+   * @param maxIterations Maximum number of iterations of each of the
+   *     weighted least squares approximations, and of coordinate descent passes
+   *     for each of them.
+   * @param tolerance The iterations stop when no weighted squared change of a
+   *     parameter is larger than this.
+   */
+  RegularizationPath(const double alpha = 1.0,
+                     const size_t numLambdas = 100,
+                     const double lambdaMinRatio = 1e-4,
+                     const size_t maxIterations = 1000,
+                     const double tolerance = 1e-7);
+
+  /**
+   * Compute the path of logistic regression models on the given data; the
+   * labels must be 0 or 1.  `models[i]` is the solution for `Lambdas()[i]`.
+   * The L2 penalty of each model (`Lambda()`) is set to the equivalent of the
+   * L2 part of the elastic-net penalty; the L1 part is not represented.
+   *
+   * @param data Training data (one point per column).
+   * @param labels Labels (0 or 1) of the points.
+   * @param models Vector to store the models in.
+   * @param lambdas Decreasing lambdas of the path; if empty, they are chosen
+   *     from the data.
+   */
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             std::vector<LogisticRegression<MatType>>& models,
+             const arma::vec& lambdas = arma::vec());
+
+  /**
+   * Compute the path of softmax regression models (with intercepts) on the
+   * given data.  `models[i]` is the solution for `Lambdas()[i]`.  The L2
+   * penalty of each model (`Lambda()`) is set to the equivalent of the L2 part
+   * of the elastic-net penalty; the L1 part is not represented.
+   *
+   * @param data Training data (one point per column).
+   * @param labels Labels of the points, between 0 and numClasses - 1.
+   * @param numClasses Number of classes.
+   * @param models Vector to store the models in.
+   * @param lambdas Decreasing lambdas of the path; if empty, they are chosen
+   *     from the data.
+   */
+  void Train(const MatType& data,
+             const arma::Row<size_t>& labels,
+             const size_t numClasses,
+             std::vector<SoftmaxRegression<MatType>>& models,
+             const arma::vec& lambdas = arma::vec());
+
+  //! Get the mixing of the L1 and L2 penalties.
+  double Alpha() const { return alpha; }
+  //! Modify the mixing of the L1 and L2 penalties.
+  double& Alpha() { return alpha; }
+
+  //! Get the number of lambdas of a computed path.
+  size_t NumLambdas() const { return numLambdas; }
+  //! Modify the number of lambdas of a computed path.
+  size_t& NumLambdas() { return numLambdas; }
+
+  //! Get the ratio of the last lambda to the first lambda.
+  double LambdaMinRatio() const { return lambdaMinRatio; }
+  //! Modify the ratio of the last lambda to the first lambda.
+  double& LambdaMinRatio() { return lambdaMinRatio; }
+
+  //! Get the maximum number of iterations.
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of iterations.
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for convergence.
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for convergence.
+  double& Tolerance() { return tolerance; }
+
+  //! Get the lambdas of the last computed path.
+  const arma::vec& Lambdas() const { return lambdas; }
+
+ private:
+  /**
+   * Compute the parameters of the path.  Each element of `path` has one row
+   * per class (a single row for logistic regression), with the intercept in
+   * the first column.
+   */
+  void ComputePath(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   const size_t numClasses,
+                   const bool binary,
+                   const arma::vec& givenLambdas,
+                   std::vector<DenseMatType>& path);
+
+  /**
+   * Minimize the penalized log-likelihood for one lambda over the features in
+   * `features`, starting from the given parameters.  `eta` holds the linear
+   * predictors of the points (one column per class), and is kept up to date.
+   */
+  void Solve(const MatType& dataT,
+             const DenseMatType& responses,
+             const bool binary,
+             const double lambda,
+             const std::vector<size_t>& features,
+             ColType& intercepts,
+             DenseMatType& weights,
+             DenseMatType& eta) const;
+
+  /**
+   * Run coordinate descent on the weighted least squares problem
+   * (1 / 2n) sum_i v_i r_i^2 + lambda * penalty(w) of class c, where r is
+   * the residual of the working response.  Returns the largest weighted
+   * squared change of a parameter in the first pass.
+   */
+  ElemType WeightedLeastSquares(const MatType& dataT,
+                                const ColType& v,
+                                ColType& r,
+                                const double lambda,
+                                const std::vector<size_t>& features,
+                                ElemType& intercept,
+                                DenseMatType& weights,
+                                const size_t c) const;
+
+  //! Compute the class probabilities (one column per class) from the linear
+  //! predictors.
+  static void Probabilities(const DenseMatType& eta,
+                            const bool binary,
+                            DenseMatType& probabilities);
+
+  //! Mixing of the L1 and L2 penalties.
+  double alpha;
+  //! Number of lambdas of a computed path.
+  size_t numLambdas;
+  //! Ratio of the last lambda to the first lambda.
+  double lambdaMinRatio;
+  //! Maximum number of iterations.
+  size_t maxIterations;
+  //! Tolerance for convergence.
+  double tolerance;
+  //! Lambdas of the last computed path.
+  arma::vec lambdas;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "regularization_path_impl.hpp"
+
+#endif
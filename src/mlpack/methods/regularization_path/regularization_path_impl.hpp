@@ -0,0 +1,407 @@
+/**
+ * @file methods/regularization_path/regularization_path_impl.hpp
+ *
+ * Implementation of the RegularizationPath class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_REGULARIZATION_PATH_REGULARIZATION_PATH_IMPL_HPP
+#define MLPACK_METHODS_REGULARIZATION_PATH_REGULARIZATION_PATH_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "regularization_path.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+RegularizationPath<MatType>::RegularizationPath(const double alpha,
+                                                const size_t numLambdas,
+                                                const double lambdaMinRatio,
+                                                const size_t maxIterations,
+                                                const double tolerance) :
+    alpha(alpha),
+    numLambdas(numLambdas),
+    lambdaMinRatio(lambdaMinRatio),
+    maxIterations(maxIterations),
+    tolerance(tolerance)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+void RegularizationPath<MatType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    std::vector<LogisticRegression<MatType>>& models,
+    const arma::vec& givenLambdas)
+{
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    if (labels[i] > 1)
+    {
+      throw std::invalid_argument("RegularizationPath::Train(): labels must "
+          "be 0 or 1 for logistic regression!");
+    }
+  }
+
+  std::vector<DenseMatType> path;
+  ComputePath(data, labels, 1, true, givenLambdas, path);
+
+  // LogisticRegressionFunction sums the losses of the points, so its L2
+  // penalty is n times larger.
+  models.clear();
+  for (size_t l = 0; l < path.size(); ++l)
+  {
+    models.emplace_back(data.n_rows,
+        data.n_cols * lambdas[l] * (1.0 - alpha));
+    models.back().Parameters() = path[l].row(0);
+  }
+}
+
+template<typename MatType>
+void RegularizationPath<MatType>::Train(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    std::vector<SoftmaxRegression<MatType>>& models,
+    const arma::vec& givenLambdas)
+{
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("RegularizationPath::Train(): there must be "
+        "at least two classes!");
+  }
+
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    if (labels[i] >= numClasses)
+    {
+      throw std::invalid_argument("RegularizationPath::Train(): labels must "
+          "be less than the number of classes!");
+    }
+  }
+
+  std::vector<DenseMatType> path;
+  ComputePath(data, labels, numClasses, false, givenLambdas, path);
+
+  models.clear();
+  for (size_t l = 0; l < path.size(); ++l)
+  {
+    models.emplace_back(data.n_rows, numClasses, true);
+    models.back().Parameters() = path[l];
+    models.back().Lambda() = lambdas[l] * (1.0 - alpha);
+  }
+}
+
+template<typename MatType>
+void RegularizationPath<MatType>::ComputePath(
+    const MatType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const bool binary,
+    const arma::vec& givenLambdas,
+    std::vector<DenseMatType>& path)
+{
+  util::CheckSameSizes(data, labels, "RegularizationPath::Train()");
+  if (alpha < 0.0 || alpha > 1.0)
+  {
+    throw std::invalid_argument("RegularizationPath::Train(): alpha must be "
+        "in [0, 1]!");
+  }
+  if (givenLambdas.is_empty() &&
+      (numLambdas == 0 || lambdaMinRatio <= 0.0 || lambdaMinRatio > 1.0))
+  {
+    throw std::invalid_argument("RegularizationPath::Train(): numLambdas must "
+        "be positive and lambdaMinRatio must be in (0, 1]!");
+  }
+  for (size_t l = 0; l < givenLambdas.n_elem; ++l)
+  {
+    if (givenLambdas[l] < 0.0 ||
+        (l > 0 && givenLambdas[l] > givenLambdas[l - 1]))
+    {
+      throw std::invalid_argument("RegularizationPath::Train(): the lambdas "
+          "must be nonnegative and decreasing!");
+    }
+  }
+
+  const size_t n = data.n_cols;
+  const size_t d = data.n_rows;
+  const size_t k = binary ? 1 : numClasses;
+
+  // Coordinate descent visits one feature at a time, so the values of each
+  // feature are stored contiguously.
+  const MatType dataT = data.t();
+
+  // One column of indicators per class (the second class, for logistic
+  // regression).
+  DenseMatType responses(n, k, arma::fill::zeros);
+  for (size_t i = 0; i < n; ++i)
+  {
+    if (binary)
+      responses(i, 0) = (ElemType) labels[i];
+    else
+      responses(i, labels[i]) = 1;
+  }
+
+  // Start from the model without features: each intercept reproduces the
+  // frequency of its class.  The frequencies are kept away from 0 and 1 so
+  // that the intercepts are finite.
+  const ElemType minFrequency = (ElemType) (1.0 / (2.0 * n));
+  const arma::Row<ElemType> frequencies = arma::clamp(
+      arma::mean(responses, 0), minFrequency, 1 - minFrequency);
+  ColType intercepts(k);
+  for (size_t c = 0; c < k; ++c)
+  {
+    intercepts[c] = binary ?
+        std::log(frequencies[c] / (1 - frequencies[c])) :
+        std::log(frequencies[c]);
+  }
+  DenseMatType weights(k, d, arma::fill::zeros);
+  DenseMatType eta = arma::repmat(intercepts.t(), n, 1);
+
+  // The gradient of the log-likelihood with respect to the weights of each
+  // feature (one row per feature) decides which features may be nonzero.
+  DenseMatType probabilities, gradient;
+  Probabilities(eta, binary, probabilities);
+  gradient = data * (responses - probabilities) / (ElemType) n;
+
+  if (givenLambdas.is_empty())
+  {
+    // The smallest lambda for which all weights are zero.  (With alpha = 0, no
+    // lambda makes the weights zero, so the lambdas of alpha = 0.001 are
+    // used, as in glmnet.)
+    const double lambdaMax = std::max((double) arma::abs(gradient).max(),
+        1e-10) / std::max(alpha, 1e-3);
+    lambdas = arma::exp(arma::linspace<arma::vec>(std::log(lambdaMax),
+        std::log(lambdaMax * lambdaMinRatio), numLambdas));
+  }
+  else
+  {
+    lambdas = givenLambdas;
+  }
+
+  path.resize(lambdas.n_elem);
+  std::vector<char> everActive(d, 0);
+  double previousLambda = lambdas[0];
+  for (size_t l = 0; l < lambdas.n_elem; ++l)
+  {
+    const double lambda = lambdas[l];
+
+    // Sequential strong rule: a feature stays zero if its gradient at the
+    // previous solution is less than alpha * (2 lambda - previous lambda).
+    const double threshold = alpha * (2 * lambda - previousLambda);
+    std::vector<char> candidate(d, 0);
+    for (size_t j = 0; j < d; ++j)
+    {
+      candidate[j] = everActive[j] ||
+          (double) arma::abs(gradient.row(j)).max() >= threshold;
+    }
+
+    while (true)
+    {
+      std::vector<size_t> features;
+      for (size_t j = 0; j < d; ++j)
+        if (candidate[j])
+          features.push_back(j);
+
+      Solve(dataT, responses, binary, lambda, features, intercepts, weights,
+          eta);
+
+      // A skipped feature must satisfy |gradient| <= alpha * lambda.
+      Probabilities(eta, binary, probabilities);
+      gradient = data * (responses - probabilities) / (ElemType) n;
+      bool violations = false;
+      for (size_t j = 0; j < d; ++j)
+      {
+        if (!candidate[j] &&
+            (double) arma::abs(gradient.row(j)).max() > alpha * lambda)
+        {
+          candidate[j] = 1;
+          violations = true;
+        }
+      }
+
+      if (!violations)
+        break;
+    }
+
+    for (size_t j = 0; j < d; ++j)
+      if (arma::any(weights.col(j) != 0))
+        everActive[j] = 1;
+
+    path[l] = arma::join_rows(intercepts, weights);
+    previousLambda = lambda;
+
+    Log::Info << "RegularizationPath::Train(): lambda " << lambda << ", "
+        << arma::accu(weights != 0) << " nonzero weights." << std::endl;
+  }
+}
+
+template<typename MatType>
+void RegularizationPath<MatType>::Solve(
+    const MatType& dataT,
+    const DenseMatType& responses,
+    const bool binary,
+    const double lambda,
+    const std::vector<size_t>& features,
+    ColType& intercepts,
+    DenseMatType& weights,
+    DenseMatType& eta) const
+{
+  // Probabilities are kept away from 0 and 1, so that the weights of the
+  // approximation are positive.
+  const ElemType minProbability = (ElemType) 1e-5;
+
+  DenseMatType probabilities;
+  ColType v, r, r0;
+  for (size_t iteration = 0; iteration < maxIterations; ++iteration)
+  {
+    ElemType change = 0;
+    for (size_t c = 0; c < intercepts.n_elem; ++c)
+    {
+      // Approximate the log-likelihood of class c around the current model:
+      // the working response is eta + (y - p) / v, with weights v = p (1 - p).
+      Probabilities(eta, binary, probabilities);
+      const ColType p = arma::clamp(probabilities.col(c), minProbability,
+          1 - minProbability);
+      v = p % (1 - p);
+      r = (responses.col(c) - p) / v;
+      r0 = r;
+
+      change = std::max(change, WeightedLeastSquares(dataT, v, r, lambda,
+          features, intercepts[c], weights, c));
+
+      // The working response is unchanged, so eta moves by the decrease of
+      // the residual.
+      eta.col(c) += r0 - r;
+    }
+
+    if (change < tolerance)
+      break;
+  }
+}
+
+template<typename MatType>
+typename RegularizationPath<MatType>::ElemType
+RegularizationPath<MatType>::WeightedLeastSquares(
+    const MatType& dataT,
+    const ColType& v,
+    ColType& r,
+    const double lambda,
+    const std::vector<size_t>& features,
+    ElemType& intercept,
+    DenseMatType& weights,
+    const size_t c) const
+{
+  const ElemType n = (ElemType) v.n_elem;
+  const ElemType l1 = (ElemType) (lambda * alpha);
+  const ElemType l2 = (ElemType) (lambda * (1.0 - alpha));
+
+  // The curvature of the approximation along each weight.
+  const ElemType vSum = arma::accu(v) / n;
+  std::vector<ElemType> curvatures(features.size());
+  for (size_t f = 0; f < features.size(); ++f)
+  {
+    const size_t j = features[f];
+    ElemType curvature = 0;
+    if constexpr (arma::is_SpMat<MatType>::value)
+    {
+      for (auto it = dataT.begin_col(j); it != dataT.end_col(j); ++it)
+        curvature += v[it.row()] * (*it) * (*it);
+    }
+    else
+    {
+      const ElemType* x = dataT.colptr(j);
+      for (size_t i = 0; i < dataT.n_rows; ++i)
+        curvature += v[i] * x[i] * x[i];
+    }
+    curvatures[f] = curvature / n;
+  }
+
+  ElemType firstChange = 0;
+  for (size_t pass = 0; pass < maxIterations; ++pass)
+  {
+    // The intercept is not penalized.
+    const ElemType delta = arma::dot(v, r) / n / vSum;
+    intercept += delta;
+    r -= delta;
+    ElemType change = vSum * delta * delta;
+
+    for (size_t f = 0; f < features.size(); ++f)
+    {
+      const size_t j = features[f];
+      if (curvatures[f] == 0)
+        continue;
+
+      // Minimize along weight j: soft-threshold the partial residual's
+      // correlation with the feature.
+      ElemType correlation = 0;
+      if constexpr (arma::is_SpMat<MatType>::value)
+      {
+        for (auto it = dataT.begin_col(j); it != dataT.end_col(j); ++it)
+          correlation += v[it.row()] * (*it) * r[it.row()];
+      }
+      else
+      {
+        const ElemType* x = dataT.colptr(j);
+        for (size_t i = 0; i < dataT.n_rows; ++i)
+          correlation += v[i] * x[i] * r[i];
+      }
+
+      const ElemType oldWeight = weights(c, j);
+      const ElemType z = correlation / n + curvatures[f] * oldWeight;
+      const ElemType newWeight = (z > l1) ? (z - l1) / (curvatures[f] + l2) :
+          (z < -l1) ? (z + l1) / (curvatures[f] + l2) : 0;
+      if (newWeight == oldWeight)
+        continue;
+
+      const ElemType step = newWeight - oldWeight;
+      weights(c, j) = newWeight;
+      if constexpr (arma::is_SpMat<MatType>::value)
+      {
+        for (auto it = dataT.begin_col(j); it != dataT.end_col(j); ++it)
+          r[it.row()] -= step * (*it);
+      }
+      else
+      {
+        const ElemType* x = dataT.colptr(j);
+        for (size_t i = 0; i < dataT.n_rows; ++i)
+          r[i] -= step * x[i];
+      }
+
+      change = std::max(change, curvatures[f] * step * step);
+    }
+
+    if (pass == 0)
+      firstChange = change;
+    if (change < tolerance)
+      break;
+  }
+
+  return firstChange;
+}
+
+template<typename MatType>
+void RegularizationPath<MatType>::Probabilities(
+    const DenseMatType& eta,
+    const bool binary,
+    DenseMatType& probabilities)
+{
+  if (binary)
+  {
+    probabilities = 1 / (1 + arma::exp(-eta));
+  }
+  else
+  {
+    // Subtract the largest linear predictor of each point, for stability.
+    probabilities = arma::exp(eta.each_col() - arma::max(eta, 1));
+    probabilities.each_col() /= arma::sum(probabilities, 1);
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -64,10 +64,14 @@ class RegularizedSVD
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
    * @param lambda Regularization parameter for the optimization.
+   * @param parallel If true, train with lock-free parallel SGD (Hogwild!),
+   *     where every thread updates the factors from its own blocks of the
+   *     shuffled ratings.
    */
   RegularizedSVD(const size_t iterations = 10,
                  const double alpha = 0.01,
-                 const double lambda = 0.02);
+                 const double lambda = 0.02,
+                 const bool parallel = false);
 
   /**
    * Obtains the user and item matrices using the provided data and rank.
@@ -89,6 +93,8 @@ class RegularizedSVD
   double alpha;
   //! Regularization parameter for the optimization.
   double lambda;
+  //! Whether to train with lock-free parallel SGD.
+  bool parallel;
 };
 
 } // namespace mlpack
@@ -231,6 +231,8 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       (function.NumFunctions() - 1), function.NumFunctions());
 
   const arma::mat data = function.Dataset();
+  const size_t numUsers = function.NumUsers();
+  const double lambda = function.Lambda();
 
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
@@ -273,45 +275,46 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::RandGen());
 
+    // Hogwild!: each thread takes blocks of threadShareSize ratings of the
+    // shuffled order and updates the parameters without any locks.  Each
+    // update only touches the columns of one user and one item, so the updates
+    // of different threads rarely overlap.
+    const size_t blockSize = std::max(threadShareSize, (size_t) 1);
     #pragma omp parallel
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
       size_t threadId = 0;
+      size_t numThreads = 1;
       #ifdef MLPACK_USE_OPENMP
         threadId = omp_get_thread_num();
+        numThreads = omp_get_num_threads();
       #endif
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      for (size_t start = threadId * blockSize; start < visitationOrder.n_elem;
+          start += numThreads * blockSize)
       {
-        const size_t numUsers = function.NumUsers();
-
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        double ratingError = rating - dot(iterate.col(user),
-            iterate.col(item));
-
-        double lambda = function.Lambda();
-
-        arma::mat userUpdate = stepSize * (lambda * iterate.col(user) -
-            ratingError * iterate.col(item));
-        arma::mat itemUpdate = stepSize * (lambda * iterate.col(item) -
-            ratingError * iterate.col(user));
-
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < iterate.n_rows; ++i)
+        const size_t end = std::min(start + blockSize,
+            (size_t) visitationOrder.n_elem);
+        for (size_t j = start; j < end; ++j)
         {
-          #pragma omp atomic
-          iterate(i, user) -= userUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemUpdate(i);
+          // Indices for accessing the the correct parameter columns.
+          const size_t user = data(0, visitationOrder[j]);
+          const size_t item = data(1, visitationOrder[j]) + numUsers;
+          double* userCol = iterate.colptr(user);
+          double* itemCol = iterate.colptr(item);
+
+          // Prediction error for the example.
+          double ratingError = data(2, visitationOrder[j]);
+          for (size_t k = 0; k < iterate.n_rows; ++k)
+            ratingError -= userCol[k] * itemCol[k];
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          for (size_t k = 0; k < iterate.n_rows; ++k)
+          {
+            const double u = userCol[k];
+            userCol[k] -= stepSize * (lambda * u - ratingError * itemCol[k]);
+            itemCol[k] -= stepSize * (lambda * itemCol[k] - ratingError * u);
+          }
         }
       }
     }
@@ -18,10 +18,12 @@ namespace mlpack {
 template<typename OptimizerType>
 RegularizedSVD<OptimizerType>::RegularizedSVD(const size_t iterations,
                                               const double alpha,
-                                              const double lambda) :
+                                              const double lambda,
+                                              const bool parallel) :
     iterations(iterations),
     alpha(alpha),
-    lambda(lambda)
+    lambda(lambda),
+    parallel(parallel)
 {
   // Nothing to do.
 }
@@ -40,12 +42,28 @@ void RegularizedSVD<OptimizerType>::Apply(const arma::mat& data,
 
   // Make the optimizer object using a RegularizedSVDFunction object.
   RegularizedSVDFunction<arma::mat> rSVDFunc(data, rank, lambda);
-  ens::StandardSGD optimizer(alpha, batchSize,
-      iterations * data.n_cols);
 
   // Get optimized parameters.
   arma::mat parameters = rSVDFunc.GetInitialPoint();
-  optimizer.Optimize(rSVDFunc, parameters);
+  if (parallel)
+  {
+    // Each thread gets one block of the shuffled ratings per epoch.  The
+    // step size stays constant, like for the serial SGD.
+    size_t numThreads = 1;
+    #ifdef MLPACK_USE_OPENMP
+      numThreads = omp_get_max_threads();
+    #endif
+    ens::ParallelSGD<ens::ExponentialBackoff> optimizer(iterations + 1,
+        (data.n_cols + numThreads - 1) / numThreads, 1e-5, true,
+        ens::ExponentialBackoff(iterations + 1, alpha, 1.0));
+    optimizer.Optimize(rSVDFunc, parameters);
+  }
+  else
+  {
+    ens::StandardSGD optimizer(alpha, batchSize,
+        iterations * data.n_cols);
+    optimizer.Optimize(rSVDFunc, parameters);
+  }
 
   // Constants for extracting user and item matrices.
   const size_t numUsers = max(data.row(0)) + 1;
@@ -14,7 +14,8 @@
 #define MLPACK_METHODS_RL_ASYNC_LEARNING_IMPL_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "queue"
+
+#include <atomic>
 
 namespace mlpack {
 
@@ -74,7 +75,7 @@ void AsyncLearning<
   NetworkType targetNetwork = learningNetwork;
   size_t totalSteps = 0;
   PolicyType policy = this->policy;
-  bool stop = false;
+  std::atomic<bool> stop(false);
 
   // Set up worker pool, worker 0 will be deterministic for evaluation.
   std::vector<WorkerType> workers;
@@ -83,59 +84,39 @@ void AsyncLearning<
     workers.push_back(WorkerType(updater, environment, config, !i));
     workers.back().Initialize(learningNetwork);
   }
-  // Set up task queue corresponding to worker pool.
-  std::queue<size_t> tasks;
-  for (size_t i = 0; i <= config.NumWorkers(); ++i)
-    tasks.push(i);
 
   /**
-   * Compute the number of threads for the for-loop. In general, we should use
-   * OpenMP task rather than for-loop, here we do so to be compatible with some
-   * compiler. We can switch to OpenMP task once MSVC supports OpenMP 3.0.
+   * Every round, each worker runs as an OpenMP task for a few steps.  Since no
+   * thread is bound to a worker, there may be more workers than threads, and
+   * no lock is needed to hand out work.  Without OpenMP, the workers simply
+   * run one after the other.
    */
-  size_t numThreads = 0;
-  #pragma omp parallel reduction(+:numThreads)
-  numThreads++;
-  Log::Debug << numThreads << " threads will be used in total." << std::endl;
-
-  #pragma omp parallel for shared(stop, workers, tasks, learningNetwork, \
-      targetNetwork, totalSteps, policy)
-  for (size_t i = 0; i < numThreads; ++i)
+  const size_t stepsPerTask = std::max(config.UpdateInterval(), (size_t) 1);
+  #pragma omp parallel shared(stop, workers, learningNetwork, targetNetwork, \
+      totalSteps, policy)
   {
-    #pragma omp critical
-    {
-      #ifdef MLPACK_USE_OPENMP
-        Log::Debug << "Thread " << omp_get_thread_num() <<
-            " started." << std::endl;
-      #endif
-    }
-    size_t task = std::numeric_limits<size_t>::max();
-    while (!stop)
+    #pragma omp single
     {
-      // Assign task to current thread from queue.
-      #pragma omp critical
+      while (!stop)
       {
-        if (task != std::numeric_limits<size_t>::max())
-          tasks.push(task);
-
-        if (!tasks.empty())
+        for (size_t task = 0; task < workers.size(); ++task)
         {
-          task = tasks.front();
-          tasks.pop();
+          #pragma omp task firstprivate(task)
+          {
+            WorkerType& worker = workers[task];
+            for (size_t i = 0; i < stepsPerTask && !stop; ++i)
+            {
+              double episodeReturn;
+              if (worker.Step(learningNetwork, targetNetwork, totalSteps,
+                  policy, episodeReturn) && !task)
+              {
+                stop = measure(episodeReturn);
+              }
+            }
+          }
         }
-      };
 
-      // This may happen when threads are more than workers.
-      if (task == std::numeric_limits<size_t>::max())
-        continue;
-
-      // Get corresponding worker.
-      WorkerType& worker = workers[task];
-      double episodeReturn;
-      if (worker.Step(learningNetwork, targetNetwork, totalSteps,
-          policy, episodeReturn) && !task)
-      {
-        stop = measure(episodeReturn);
+        #pragma omp taskwait
       }
     }
   }
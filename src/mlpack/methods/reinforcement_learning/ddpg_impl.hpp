@@ -350,5 +350,67 @@ double DDPG<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename QNetworkType,
+  typename PolicyNetworkType,
+  typename NoiseType,
+  typename UpdaterType,
+  typename ReplayType
+>
+size_t DDPG<
+  EnvironmentType,
+  QNetworkType,
+  PolicyNetworkType,
+  NoiseType,
+  UpdaterType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the actions at the current states, from the policy.
+  arma::mat encodedStates;
+  environments.Encode(encodedStates);
+  arma::mat outputActions;
+  policyNetwork.Predict(encodedStates, outputActions);
+
+  std::vector<ActionType> actions(outputActions.n_cols);
+  for (size_t i = 0; i < outputActions.n_cols; ++i)
+  {
+    arma::colvec outputAction = outputActions.col(i);
+    if (!deterministic)
+    {
+      arma::colvec sample = noise.sample() * 0.1;
+      sample = arma::clamp(sample, -0.25, 0.25);
+      outputAction = outputAction + sample;
+    }
+    actions[i].action = ConvTo<std::vector<double>>::From(outputAction);
+  }
+
+  // Interact with the environments to advance to the next states.
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isEnd;
+  const size_t ended = environments.Step(actions, rewards, nextStates, isEnd);
+
+  // Store all transitions for replay at once.
+  arma::mat encodedNextStates(encodedStates.n_rows, nextStates.size());
+  for (size_t i = 0; i < nextStates.size(); ++i)
+    encodedNextStates.col(i) = nextStates[i].Encode();
+  replayMethod.Store(encodedStates, actions, rewards, encodedNextStates,
+      isEnd);
+
+  // Train as if the steps had been taken one after the other.
+  for (size_t i = 0; i < nextStates.size(); ++i)
+  {
+    totalSteps++;
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    for (size_t j = 0; j < config.UpdateInterval(); j++)
+      Update();
+  }
+
+  return ended;
+}
+
 } // namespace mlpack
 #endif
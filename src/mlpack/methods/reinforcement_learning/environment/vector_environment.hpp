@@ -0,0 +1,193 @@
+/**
+ * @file methods/reinforcement_learning/environment/vector_environment.hpp
+ *
+ * This file is an implementation of a wrapper that runs several copies of an
+ * environment at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+#define MLPACK_METHODS_RL_ENVIRONMENT_VECTOR_ENVIRONMENT_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * A wrapper around a number of copies of an environment that are stepped
+ * together, so that an agent can choose the actions of all of them with one
+ * batched forward pass of its network (see the `Step()` methods of QLearning,
+ * DDPG, TD3 and SAC).
+ *
+ * Each copy has its own current state.  When the episode of a copy ends,
+ * because its next state is terminal or because it reached the step limit, the
+ * return of the episode is recorded in `EpisodeReturns()` and the copy is
+ * restarted from a new initial sample.
+ *
+ * @code
+ * VectorEnvironment<CartPole> environments(16);
+ * environments.Reset();
+ * while (environments.EpisodeReturns().size() < 100)
+ *   agent.Step(environments);
+ * @endcode
+ *
+ * @tparam EnvironmentType The environment to run copies of.
+ */
+template<typename EnvironmentType>
+class VectorEnvironment
+{
+ public:
+  //! Convenient typedef for state.
+  using State = typename EnvironmentType::State;
+
+  //! Convenient typedef for action.
+  using Action = typename EnvironmentType::Action;
+
+  /**
+   * Create the given number of copies of the given environment.  `Reset()`
+   * must be called before the first `Step()`.
+   *
+   * @param numEnvironments Number of copies of the environment.
+   * @param environment The environment to copy.
+   * @param stepLimit Maximum number of steps of an episode; 0 means no limit.
+   */
+  VectorEnvironment(const size_t numEnvironments,
+                    const EnvironmentType& environment = EnvironmentType(),
+                    const size_t stepLimit = 0) :
+      environments(numEnvironments, environment),
+      states(numEnvironments),
+      steps(numEnvironments, 0),
+      returns(numEnvironments, 0.0),
+      stepLimit(stepLimit)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Start a new episode in every environment, and forget the returns of the
+   * episodes that have finished.
+   */
+  void Reset()
+  {
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      states[i] = environments[i].InitialSample();
+      steps[i] = 0;
+      returns[i] = 0.0;
+    }
+    episodeReturns.clear();
+  }
+
+  /**
+   * Store the encoded current state of each environment as a column of
+   * `encodedStates`.
+   *
+   * @param encodedStates Matrix to store the encoded states in.
+   */
+  void Encode(arma::mat& encodedStates) const
+  {
+    encodedStates.set_size(states[0].Encode().n_elem, states.size());
+    for (size_t i = 0; i < states.size(); ++i)
+      encodedStates.col(i) = states[i].Encode();
+  }
+
+  /**
+   * Advance every environment by one step.  The transition of environment `i`
+   * goes from `States()[i]` to `nextStates[i]`; afterwards, `States()[i]` is
+   * the next state, or a new initial state if the episode has ended.
+   *
+   * @param actions The action to take in each environment.
+   * @param rewards The reward of each transition.
+   * @param nextStates The next state of each transition.
+   * @param isEnd Whether the next state of each transition is terminal.
+   * @return The number of episodes that ended in this step.
+   */
+  size_t Step(const std::vector<Action>& actions,
+              arma::rowvec& rewards,
+              std::vector<State>& nextStates,
+              arma::irowvec& isEnd)
+  {
+    if (actions.size() != environments.size())
+    {
+      throw std::invalid_argument("VectorEnvironment::Step(): need one action "
+          "for each environment!");
+    }
+
+    rewards.set_size(environments.size());
+    nextStates.resize(environments.size());
+    isEnd.set_size(environments.size());
+
+    size_t ended = 0;
+    for (size_t i = 0; i < environments.size(); ++i)
+    {
+      rewards[i] = environments[i].Sample(states[i], actions[i],
+          nextStates[i]);
+      isEnd[i] = environments[i].IsTerminal(nextStates[i]);
+      returns[i] += rewards[i];
+      ++steps[i];
+
+      if (isEnd[i] || (stepLimit != 0 && steps[i] >= stepLimit))
+      {
+        episodeReturns.push_back(returns[i]);
+        states[i] = environments[i].InitialSample();
+        steps[i] = 0;
+        returns[i] = 0.0;
+        ++ended;
+      }
+      else
+      {
+        states[i] = nextStates[i];
+      }
+    }
+
+    return ended;
+  }
+
+  //! Get the number of environments.
+  size_t NumEnvironments() const { return environments.size(); }
+
+  //! Get the current state of each environment.
+  const std::vector<State>& States() const { return states; }
+
+  //! Modify the given environment.
+  EnvironmentType& Environment(const size_t i) { return environments[i]; }
+  //! Get the given environment.
+  const EnvironmentType& Environment(const size_t i) const
+  {
+    return environments[i];
+  }
+
+  //! Get the returns of the episodes that have ended since `Reset()`.
+  const std::vector<double>& EpisodeReturns() const { return episodeReturns; }
+  //! Modify the returns of the episodes that have ended since `Reset()`.
+  std::vector<double>& EpisodeReturns() { return episodeReturns; }
+
+  //! Get the maximum number of steps of an episode (0 means no limit).
+  size_t StepLimit() const { return stepLimit; }
+  //! Modify the maximum number of steps of an episode (0 means no limit).
+  size_t& StepLimit() { return stepLimit; }
+
+ private:
+  //! The copies of the environment.
+  std::vector<EnvironmentType> environments;
+
+  //! The current state of each environment.
+  std::vector<State> states;
+
+  //! The number of steps of the current episode of each environment.
+  std::vector<size_t> steps;
+
+  //! The return of the current episode of each environment.
+  std::vector<double> returns;
+
+  //! The returns of the episodes that have ended.
+  std::vector<double> episodeReturns;
+
+  //! The maximum number of steps of an episode.
+  size_t stepLimit;
+};
+
+} // namespace mlpack
+
+#endif
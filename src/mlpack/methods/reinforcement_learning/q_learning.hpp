@@ -17,6 +17,7 @@
 #include <mlpack/methods/ann/ann.hpp>
 
 #include "replay/replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -109,6 +110,20 @@ class QLearning
    */
   double Episode();
 
+  /**
+   * Take one step in each of the given environments.  The actions for all of
+   * them are selected with one forward pass of the learning network on a batch
+   * of all current states, and the transitions are stored in the replay as
+   * one batch (so the replay must support that, and look one step ahead).
+   * Then the agent is trained as often as `Episode()` would for the same
+   * number of steps.
+   *
+   * @param environments The environments to step.
+   * @return The number of episodes that ended in this step; their returns are
+   *     appended to `environments.EpisodeReturns()`.
+   */
+  size_t Step(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
@@ -180,6 +195,21 @@ class QLearning
 
   //! Locally-stored flag indicating training mode or test mode.
   bool deterministic;
+
+  //! Locally-stored encoded states of the last sample from the replay.
+  arma::mat sampledStates;
+
+  //! Locally-stored actions of the last sample from the replay.
+  std::vector<ActionType> sampledActions;
+
+  //! Locally-stored rewards of the last sample from the replay.
+  arma::rowvec sampledRewards;
+
+  //! Locally-stored encoded next states of the last sample from the replay.
+  arma::mat sampledNextStates;
+
+  //! Locally-stored termination flags of the last sample from the replay.
+  arma::irowvec isTerminal;
 };
 
 } // namespace mlpack
@@ -135,13 +135,8 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience.  The members holding the sample are reused
+  // between updates.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -222,13 +217,8 @@ void QLearning<
 {
   // Start experience replay.
 
-  // Sample from previous experience.
-  arma::mat sampledStates;
-  std::vector<ActionType> sampledActions;
-  arma::rowvec sampledRewards;
-  arma::mat sampledNextStates;
-  arma::irowvec isTerminal;
-
+  // Sample from previous experience.  The members holding the sample are reused
+  // between updates.
   replayMethod.Sample(sampledStates, sampledActions, sampledRewards,
       sampledNextStates, isTerminal);
 
@@ -388,6 +378,63 @@ double QLearning<
   return totalReturn;
 }
 
+template <
+  typename EnvironmentType,
+  typename NetworkType,
+  typename UpdaterType,
+  typename BehaviorPolicyType,
+  typename ReplayType
+>
+size_t QLearning<
+  EnvironmentType,
+  NetworkType,
+  UpdaterType,
+  BehaviorPolicyType,
+  ReplayType
+>::Step(VectorEnvironment<EnvironmentType>& environments)
+{
+  // Get the action values for each action at the current states.
+  arma::mat encodedStates;
+  environments.Encode(encodedStates);
+  arma::mat actionValues;
+  learningNetwork.Predict(encodedStates, actionValues);
+
+  // Select the actions according to the behavior policy.
+  std::vector<ActionType> actions(actionValues.n_cols);
+  for (size_t i = 0; i < actionValues.n_cols; ++i)
+  {
+    actions[i] = policy.Sample(actionValues.col(i), deterministic,
+        config.NoisyQLearning());
+  }
+
+  // Interact with the environments to advance to the next states.
+  std::vector<StateType> nextStates;
+  arma::rowvec rewards;
+  arma::irowvec isEnd;
+  const size_t ended = environments.Step(actions, rewards, nextStates, isEnd);
+
+  // Store all transitions for replay at once.
+  arma::mat encodedNextStates(encodedStates.n_rows, nextStates.size());
+  for (size_t i = 0; i < nextStates.size(); ++i)
+    encodedNextStates.col(i) = nextStates[i].Encode();
+  replayMethod.Store(encodedStates, actions, rewards, encodedNextStates,
+      isEnd);
+
+  // Train as if the steps had been taken one after the other.
+  for (size_t i = 0; i < nextStates.size(); ++i)
+  {
+    totalSteps++;
+    if (deterministic || totalSteps < config.ExplorationSteps())
+      continue;
+    if (config.IsCategorical())
+      TrainCategoricalAgent();
+    else
+      TrainAgent();
+  }
+
+  return ended;
+}
+
 } // namespace mlpack
 
 #endif
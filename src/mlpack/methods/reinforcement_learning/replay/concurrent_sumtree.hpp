@@ -0,0 +1,300 @@
+/**
+ * @file methods/reinforcement_learning/replay/concurrent_sumtree.hpp
+ *
+ * This file is an implementation of a sumtree that can be updated and queried
+ * by many threads at once.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RL_CONCURRENT_SUMTREE_HPP
+#define MLPACK_METHODS_RL_CONCURRENT_SUMTREE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <atomic>
+
+namespace mlpack {
+
+/**
+ * A lock-free SumTree, with the same interface as SumTree, that allows Set(),
+ * BatchUpdate(), Get(), Sum() and FindPrefixSum() to be called concurrently
+ * from different threads.
+ *
+ * Each node of the tree is atomic.  Instead of recomputing the parents of a
+ * changed element from their children (which could lose the update of another
+ * thread), Set() atomically swaps the element and adds the difference to each
+ * ancestor; since additions commute, every internal node holds the sum of its
+ * children as soon as all updates have finished.  BatchUpdate() merges the
+ * differences of elements with a common ancestor before adding them, so the
+ * nodes near the root are only touched once per batch.
+ *
+ * While updates are in progress, a query may see some of them only partially
+ * propagated, so its result is approximate; `FindPrefixSum()` always returns a
+ * valid index.  Because the differences are accumulated, floating-point
+ * rounding may slowly build up in the internal nodes; `Rebuild()` recomputes
+ * them exactly.
+ *
+ * @tparam T The array's element type.
+ */
+template<typename T>
+class ConcurrentSumTree
+{
+ public:
+  /**
+   * Default constructor.
+   */
+  ConcurrentSumTree() : capacity(0)
+  { /* Nothing to do here. */ }
+
+  /**
+   * Construct an instance of ConcurrentSumTree class.
+   *
+   * @param capacity Size of data.
+   */
+  ConcurrentSumTree(const size_t capacity) :
+      capacity(capacity),
+      element(2 * capacity)
+  {
+    for (size_t i = 0; i < element.size(); ++i)
+      element[i].store(T(0), std::memory_order_relaxed);
+  }
+
+  //! Copy the given tree.  No other thread may modify it during the copy.
+  ConcurrentSumTree(const ConcurrentSumTree& other) :
+      capacity(other.capacity),
+      element(other.element.size())
+  {
+    for (size_t i = 0; i < element.size(); ++i)
+      element[i].store(other.element[i].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+  }
+
+  //! Take ownership of the memory of the given tree.
+  ConcurrentSumTree(ConcurrentSumTree&& other) :
+      capacity(other.capacity),
+      element(std::move(other.element))
+  {
+    other.capacity = 0;
+  }
+
+  //! Copy the given tree.  No other thread may use either tree during the copy.
+  ConcurrentSumTree& operator=(const ConcurrentSumTree& other)
+  {
+    if (this != &other)
+    {
+      capacity = other.capacity;
+      element = std::vector<std::atomic<T>>(other.element.size());
+      for (size_t i = 0; i < element.size(); ++i)
+        element[i].store(other.element[i].load(std::memory_order_relaxed),
+            std::memory_order_relaxed);
+    }
+
+    return *this;
+  }
+
+  //! Take ownership of the memory of the given tree.
+  ConcurrentSumTree& operator=(ConcurrentSumTree&& other)
+  {
+    if (this != &other)
+    {
+      capacity = other.capacity;
+      element = std::move(other.element);
+      other.capacity = 0;
+    }
+
+    return *this;
+  }
+
+  /**
+   * Set the data array with idx.
+   *
+   * @param idx The array idx to be changed.
+   * @param value The data that array with idx to be.
+   */
+  void Set(size_t idx, const T value)
+  {
+    idx += capacity;
+    const T delta = value - element[idx].exchange(value,
+        std::memory_order_relaxed);
+    for (idx /= 2; idx >= 1; idx /= 2)
+      Add(element[idx], delta);
+  }
+
+  /**
+   * Update the data with batch rather loop over the indices with set method.
+   * The differences are propagated one level at a time, and the differences of
+   * siblings are added to their parent together.
+   *
+   * @param indices The indices of data to be changed.
+   * @param data The data that array with indices to be.
+   */
+  void BatchUpdate(const arma::ucolvec& indices, const arma::Col<T>& data)
+  {
+    // Swap each element, and collect the differences in order of node.
+    std::vector<std::pair<size_t, T>> deltas(indices.n_elem);
+    for (size_t i = 0; i < indices.n_elem; ++i)
+    {
+      const size_t idx = indices[i] + capacity;
+      deltas[i] = std::make_pair(idx, data[i] - element[idx].exchange(data[i],
+          std::memory_order_relaxed));
+    }
+    std::sort(deltas.begin(), deltas.end(),
+        [](const std::pair<size_t, T>& a, const std::pair<size_t, T>& b)
+        { return a.first < b.first; });
+
+    // Moving to the parents keeps the nodes sorted, so the differences with the
+    // same parent are next to each other.
+    while (!deltas.empty() && deltas[0].first > 1)
+    {
+      size_t n = 0;
+      for (size_t i = 0; i < deltas.size(); ++i)
+      {
+        const size_t parent = deltas[i].first / 2;
+        if (n > 0 && deltas[n - 1].first == parent)
+        {
+          deltas[n - 1].second += deltas[i].second;
+        }
+        else
+        {
+          deltas[n] = std::make_pair(parent, deltas[i].second);
+          ++n;
+        }
+      }
+      deltas.resize(n);
+
+      for (size_t i = 0; i < deltas.size(); ++i)
+        Add(element[deltas[i].first], deltas[i].second);
+    }
+  }
+
+  /**
+   * Recompute all internal nodes from the data array, removing any rounding
+   * error accumulated by updates.  This must not be called while other threads
+   * use the tree.
+   */
+  void Rebuild()
+  {
+    for (size_t i = capacity - 1; i > 0; i--)
+    {
+      element[i].store(element[2 * i].load(std::memory_order_relaxed) +
+          element[2 * i + 1].load(std::memory_order_relaxed),
+          std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * Get the data array with idx.
+   *
+   * @param idx The array idx to get data.
+   */
+  T Get(size_t idx) const
+  {
+    idx += capacity;
+    return element[idx].load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Help function for the `sum` function
+   *
+   * @param start The starting position of subsequence.
+   * @param end The end position of subsequence.
+   * @param node Reference position.
+   * @param nodeStart Starting position of reference segment.
+   * @param nodeEnd End position of reference segment.
+   */
+  T SumHelper(const size_t start,
+              const size_t end,
+              const size_t node,
+              const size_t nodeStart,
+              const size_t nodeEnd) const
+  {
+    if (start == nodeStart && end == nodeEnd)
+    {
+      return element[node].load(std::memory_order_relaxed);
+    }
+    size_t mid = (nodeStart + nodeEnd) / 2;
+    if (end <= mid)
+    {
+      return SumHelper(start, end, 2 * node, nodeStart, mid);
+    }
+    else
+    {
+      if (mid + 1 <= start)
+      {
+        return SumHelper(start, end, 2 * node + 1, mid + 1, nodeEnd);
+      }
+      else
+      {
+        return SumHelper(start, mid, 2 * node, nodeStart, mid) +
+            SumHelper(mid + 1, end, 2 * node + 1, mid + 1, nodeEnd);
+      }
+    }
+  }
+
+  /**
+   * Calculate the sum of contiguous subsequence of the array.
+   *
+   * @param start The starting position of subsequence.
+   * @param end The end position of subsequence.
+   */
+  T Sum(const size_t start, size_t end) const
+  {
+    end -= 1;
+    return SumHelper(start, end, 1, 0, capacity - 1);
+  }
+
+  /**
+   * Shortcut for calculating the sum of whole array.
+   */
+  T Sum() const
+  {
+    return Sum(0, capacity);
+  }
+
+  /**
+   * Find the highest index `idx` in the array such that
+   * sum(arr[0] + arr[1] + ... + arr[idx]) <= mass.
+   *
+   * @param mass The upper bound of segment array sum.
+   */
+  size_t FindPrefixSum(T mass) const
+  {
+    size_t idx = 1;
+    while (idx < capacity)
+    {
+      const T left = element[2 * idx].load(std::memory_order_relaxed);
+      if (left > mass)
+      {
+        idx = 2 * idx;
+      }
+      else
+      {
+        mass -= left;
+        idx = 2 * idx + 1;
+      }
+    }
+    return idx - capacity;
+  }
+
+ private:
+  //! Atomically add `delta` to `x`.
+  static void Add(std::atomic<T>& x, const T delta)
+  {
+    T old = x.load(std::memory_order_relaxed);
+    while (!x.compare_exchange_weak(old, old + delta,
+        std::memory_order_relaxed, std::memory_order_relaxed)) { }
+  }
+
+  //! The capacity of the data array.
+  size_t capacity;
+
+  //! Double size of capacity, maintain the segment sum of data.
+  std::vector<std::atomic<T>> element;
+};
+
+} // namespace mlpack
+
+#endif
@@ -13,7 +13,10 @@
 #define MLPACK_METHODS_RL_PRIORITIZED_REPLAY_HPP
 
 #include <mlpack/prereqs.hpp>
-#include "sumtree.hpp"
+#include "concurrent_sumtree.hpp"
+
+#include <atomic>
+#include <mutex>
 
 namespace mlpack {
 
@@ -32,6 +35,15 @@ namespace mlpack {
  *  }
  * @endcode
  *
+ * One PrioritizedReplay can be shared between threads, as in the distributed
+ * setup of Ape-X: any number of actor threads may call `Store()` while a
+ * learner thread calls `Sample()`, `Update()` and `UpdatePriorities()`.  The
+ * priorities are held in a lock-free ConcurrentSumTree, so updating them never
+ * waits for the actors; only the copies of transitions into and out of the
+ * memory are serialized by a mutex.  The n-step buffer holds the transitions of
+ * one episode, so actors that share the memory should use one step, or store
+ * batches of finished transitions.
+ *
  * @tparam EnvironmentType Desired task.
  */
 template <typename EnvironmentType>
@@ -105,7 +117,7 @@ class PrioritizedReplay
     }
 
     beta = initialBeta;
-    idxSum = SumTree<double>(size);
+    idxSum = ConcurrentSumTree<double>(size);
   }
 
   /**
@@ -125,6 +137,8 @@ class PrioritizedReplay
              bool isEnd,
              const double& discount)
   {
+    std::lock_guard<std::mutex> lock(mutex);
+
     nStepBuffer.push_back({state, action, reward, nextState, isEnd});
 
     // Single step transition is not ready.
@@ -149,7 +163,7 @@ class PrioritizedReplay
     nextStates.col(position) = nextState.Encode();
     isTerminal(position) = isEnd;
 
-    idxSum.Set(position, maxPriority * alpha);
+    idxSum.Set(position, maxPriority.load() * alpha);
 
     position++;
     if (position == capacity)
@@ -159,6 +173,73 @@ class PrioritizedReplay
     }
   }
 
+  /**
+   * Store a batch of single step transitions at once, for instance one from
+   * each of a number of environments that are run in parallel.  Column `i` of
+   * `states` and `nextStates` holds the encoded state and next state of the
+   * `i`th transition.  The transitions are copied into the memory in blocks,
+   * so this is much cheaper than calling `Store()` for each of them; however,
+   * this bypasses the buffer of n-step transitions, so it can only be used if
+   * `NSteps()` is 1.
+   *
+   * @param states Encoded states, one column per transition.
+   * @param actions Actions, one per transition.
+   * @param rewards Rewards, one per transition.
+   * @param nextStates Encoded next states, one column per transition.
+   * @param isEnd Whether each next state is a terminal state.
+   */
+  void Store(const arma::mat& states,
+             const std::vector<ActionType>& actions,
+             const arma::rowvec& rewards,
+             const arma::mat& nextStates,
+             const arma::irowvec& isEnd)
+  {
+    if (nSteps != 1)
+    {
+      throw std::invalid_argument("Store(): batches of transitions can only be "
+          "stored if the number of steps is 1!");
+    }
+
+    const size_t n = states.n_cols;
+    if (actions.size() != n || rewards.n_elem != n || nextStates.n_cols != n ||
+        isEnd.n_elem != n)
+    {
+      throw std::invalid_argument("Store(): the number of states, actions, "
+          "rewards, next states, and terminal flags must be the same!");
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Copy the transitions up to the end of the memory, then wrap around.
+    const double priority = maxPriority.load() * alpha;
+    size_t stored = 0;
+    while (stored < n)
+    {
+      const size_t count = std::min(n - stored, capacity - position);
+      const size_t last = position + count - 1;
+      this->states.cols(position, last) =
+          states.cols(stored, stored + count - 1);
+      std::copy(actions.begin() + stored, actions.begin() + stored + count,
+          this->actions.begin() + position);
+      this->rewards.subvec(position, last) =
+          rewards.subvec(stored, stored + count - 1);
+      this->nextStates.cols(position, last) =
+          nextStates.cols(stored, stored + count - 1);
+      this->isTerminal.subvec(position, last) =
+          isEnd.subvec(stored, stored + count - 1);
+      for (size_t i = 0; i < count; ++i)
+        idxSum.Set(position + i, priority);
+
+      stored += count;
+      position += count;
+      if (position == capacity)
+      {
+        full = true;
+        position = 0;
+      }
+    }
+  }
+
   /**
    * Get the reward, next state and terminal boolean for nth step.
    *
@@ -197,12 +278,15 @@ class PrioritizedReplay
   arma::ucolvec SampleProportional()
   {
     arma::ucolvec idxes(batchSize);
-    double totalSum = idxSum.Sum(0, (full ? capacity : position));
+    const size_t numSample = full ? capacity : position;
+    double totalSum = idxSum.Sum(0, numSample);
     double sumPerRange = totalSum / batchSize;
     for (size_t bt = 0; bt < batchSize; bt++)
     {
+      // If the priorities are being updated by another thread, the prefix
+      // sums may be slightly inconsistent; never return an empty slot.
       const double mass = arma::randu() * sumPerRange + bt * sumPerRange;
-      idxes(bt) = idxSum.FindPrefixSum(mass);
+      idxes(bt) = std::min(idxSum.FindPrefixSum(mass), numSample - 1);
     }
     return idxes;
   }
@@ -216,6 +300,9 @@ class PrioritizedReplay
    * @param sampledNextStates Sampled encoded next states.
    * @param isTerminal Indicate whether corresponding next state is terminal
    *        state.
+   *
+   * All of the outputs are resized to the batch size; if they already have
+   * that size, no memory is allocated.
    */
   void Sample(arma::mat& sampledStates,
               std::vector<ActionType>& sampledActions,
@@ -223,22 +310,35 @@ class PrioritizedReplay
               arma::mat& sampledNextStates,
               arma::irowvec& isTerminal)
   {
+    std::lock_guard<std::mutex> lock(mutex);
+
     sampledIndices = SampleProportional();
     BetaAnneal();
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    // Gather the transitions directly into the given objects, so that their
+    // memory is reused if they already have the right size.
+    const size_t n = sampledIndices.n_elem;
+    sampledStates.set_size(states.n_rows, n);
+    sampledActions.resize(n);
+    sampledRewards.set_size(n);
+    sampledNextStates.set_size(nextStates.n_rows, n);
+    isTerminal.set_size(n);
+    for (size_t t = 0; t < n; ++t)
+    {
+      const size_t index = sampledIndices[t];
+      sampledStates.col(t) = states.col(index);
+      sampledActions[t] = actions[index];
+      sampledRewards[t] = rewards[index];
+      sampledNextStates.col(t) = nextStates.col(index);
+      isTerminal[t] = this->isTerminal[index];
+    }
 
     // Calculate the weights of sampled transitions.
 
     size_t numSample = full ? capacity : position;
-    weights = arma::rowvec(sampledIndices.n_rows);
+    weights.set_size(n);
 
-    for (size_t i = 0; i < sampledIndices.n_rows; ++i)
+    for (size_t i = 0; i < n; ++i)
     {
       double p_sample = idxSum.Get(sampledIndices(i)) / idxSum.Sum();
       weights(i) = std::pow(numSample * p_sample, -beta);
@@ -255,7 +355,7 @@ class PrioritizedReplay
   void UpdatePriorities(arma::ucolvec& indices, arma::colvec& priorities)
   {
       arma::colvec alphaPri = alpha * priorities;
-      maxPriority = std::max(maxPriority, max(priorities));
+      maxPriority.store(std::max(maxPriority.load(), max(priorities)));
       idxSum.BatchUpdate(indices, alphaPri);
   }
 
@@ -285,9 +385,9 @@ class PrioritizedReplay
    * @param nextActionValues Agent's next action.
    * @param gradients The model's gradients.
    */
-  void Update(arma::mat target,
-              std::vector<ActionType> sampledActions,
-              arma::mat nextActionValues,
+  void Update(const arma::mat& target,
+              const std::vector<ActionType>& sampledActions,
+              const arma::mat& nextActionValues,
               arma::mat& gradients)
   {
     arma::colvec tdError(target.n_cols);
@@ -323,8 +423,9 @@ class PrioritizedReplay
   //! (0 - no prioritization, 1 - full prioritization)
   double alpha;
 
-  //! Locally-stored the max priority.
-  double maxPriority;
+  //! Locally-stored the max priority.  This is read by the actors when they
+  //! store transitions.
+  std::atomic<double> maxPriority;
 
   //! Initial value of beta for prioritized replay buffer.
   double initialBeta;
@@ -336,7 +437,7 @@ class PrioritizedReplay
   size_t replayBetaIters;
 
   //! Locally-stored the prefix sum of prioritization.
-  SumTree<double> idxSum;
+  ConcurrentSumTree<double> idxSum;
 
   //! Locally-stored the indices of sampled transitions.
   arma::ucolvec sampledIndices;
@@ -364,6 +465,9 @@ class PrioritizedReplay
 
   //! Locally-stored termination information of previous experience.
   arma::irowvec isTerminal;
+
+  //! Serializes access to the stored transitions.
+  std::mutex mutex;
 };
 
 } // namespace mlpack
@@ -139,6 +139,68 @@ class RandomReplay
     }
   }
 
+  /**
+   * Store a batch of single step transitions at once, for instance one from
+   * each of a number of environments that are run in parallel.  Column `i` of
+   * `states` and `nextStates` holds the encoded state and next state of the
+   * `i`th transition.  The transitions are copied into the memory in blocks,
+   * so this is much cheaper than calling `Store()` for each of them; however,
+   * this bypasses the buffer of n-step transitions, so it can only be used if
+   * `NSteps()` is 1.
+   *
+   * @param states Encoded states, one column per transition.
+   * @param actions Actions, one per transition.
+   * @param rewards Rewards, one per transition.
+   * @param nextStates Encoded next states, one column per transition.
+   * @param isEnd Whether each next state is a terminal state.
+   */
+  void Store(const arma::mat& states,
+             const std::vector<ActionType>& actions,
+             const arma::rowvec& rewards,
+             const arma::mat& nextStates,
+             const arma::irowvec& isEnd)
+  {
+    if (nSteps != 1)
+    {
+      throw std::invalid_argument("Store(): batches of transitions can only be "
+          "stored if the number of steps is 1!");
+    }
+
+    const size_t n = states.n_cols;
+    if (actions.size() != n || rewards.n_elem != n || nextStates.n_cols != n ||
+        isEnd.n_elem != n)
+    {
+      throw std::invalid_argument("Store(): the number of states, actions, "
+          "rewards, next states, and terminal flags must be the same!");
+    }
+
+    // Copy the transitions up to the end of the memory, then wrap around.
+    size_t stored = 0;
+    while (stored < n)
+    {
+      const size_t count = std::min(n - stored, capacity - position);
+      const size_t last = position + count - 1;
+      this->states.cols(position, last) =
+          states.cols(stored, stored + count - 1);
+      std::copy(actions.begin() + stored, actions.begin() + stored + count,
+          this->actions.begin() + position);
+      this->rewards.subvec(position, last) =
+          rewards.subvec(stored, stored + count - 1);
+      this->nextStates.cols(position, last) =
+          nextStates.cols(stored, stored + count - 1);
+      this->isTerminal.subvec(position, last) =
+          isEnd.subvec(stored, stored + count - 1);
+
+      stored += count;
+      position += count;
+      if (position == capacity)
+      {
+        full = true;
+        position = 0;
+      }
+    }
+  }
+
   /**
    * Get the reward, next state and terminal boolean for nth step.
    *
@@ -178,6 +240,9 @@ class RandomReplay
    * @param sampledNextStates Sampled encoded next states.
    * @param isTerminal Indicate whether corresponding next state is terminal
    *        state.
+   *
+   * All of the outputs are resized to the batch size; if they already have
+   * that size, no memory is allocated.
    */
   void Sample(arma::mat& sampledStates,
               std::vector<ActionType>& sampledActions,
@@ -189,12 +254,23 @@ class RandomReplay
     arma::uvec sampledIndices = randi<arma::uvec>(
         batchSize, DistrParam(0, upperBound - 1));
 
-    sampledStates = states.cols(sampledIndices);
-    for (size_t t = 0; t < sampledIndices.n_rows; t ++)
-      sampledActions.push_back(actions[sampledIndices[t]]);
-    sampledRewards = rewards.elem(sampledIndices).t();
-    sampledNextStates = nextStates.cols(sampledIndices);
-    isTerminal = this->isTerminal.elem(sampledIndices).t();
+    // Gather the transitions directly into the given objects, so that their
+    // memory is reused if they already have the right size.
+    const size_t n = sampledIndices.n_elem;
+    sampledStates.set_size(states.n_rows, n);
+    sampledActions.resize(n);
+    sampledRewards.set_size(n);
+    sampledNextStates.set_size(nextStates.n_rows, n);
+    isTerminal.set_size(n);
+    for (size_t t = 0; t < n; ++t)
+    {
+      const size_t index = sampledIndices[t];
+      sampledStates.col(t) = states.col(index);
+      sampledActions[t] = actions[index];
+      sampledRewards[t] = rewards[index];
+      sampledNextStates.col(t) = nextStates.col(index);
+      isTerminal[t] = this->isTerminal[index];
+    }
   }
 
   /**
@@ -215,9 +291,9 @@ class RandomReplay
    * @param * (nextActionValues) Agent's next action
    * @param * (gradients) The model's gradients
    */
-  void Update(arma::mat /* target */,
-              std::vector<ActionType> /* sampledActions */,
-              arma::mat /* nextActionValues */,
+  void Update(const arma::mat& /* target */,
+              const std::vector<ActionType>& /* sampledActions */,
+              const arma::mat& /* nextActionValues */,
               arma::mat& /* gradients */)
   {
     /* Do nothing for random replay. */
@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/ann.hpp>
 
 #include "replay/replay.hpp"
+#include "environment/vector_environment.hpp"
 #include "training_config.hpp"
 
 namespace mlpack {
@@ -120,6 +121,20 @@ class SAC
    */
   double Episode();
 
+  /**
+   * Take one step in each of the given environments.  The actions for all of
+   * them are selected with one forward pass of the policy network on a batch
+   * of all current states, and the transitions are stored in the replay as
+   * one batch (so the replay must support that, and look one step ahead).
+   * Then the agent is trained as often as `Episode()` would for the same
+   * number of steps.
+   *
+   * @param environments The environments to step.
+   * @return The number of episodes that ended in this step; their returns are
+   *     appended to `environments.EpisodeReturns()`.
+   */
+  size_t Step(VectorEnvironment<EnvironmentType>& environments);
+
   //! Modify total steps from beginning.
   size_t& TotalSteps() { return totalSteps; }
   //! Get total steps from beginning.
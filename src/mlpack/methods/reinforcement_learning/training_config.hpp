@@ -33,7 +33,8 @@ class TrainingConfig
       atomSize(51),
       vMin(0),
       vMax(200),
-      rho(0.005)
+      rho(0.005),
+      lockFreeUpdates(false)
   { /* Nothing to do here. */ }
 
   TrainingConfig(
@@ -51,7 +52,8 @@ class TrainingConfig
       size_t atomSize,
       double vMin,
       double vMax,
-      double rho) :
+      double rho,
+      bool lockFreeUpdates = false) :
       numWorkers(numWorkers),
       updateInterval(updateInterval),
       targetNetworkSyncInterval(targetNetworkSyncInterval),
@@ -66,7 +68,8 @@ class TrainingConfig
       atomSize(atomSize),
       vMin(vMin),
       vMax(vMax),
-      rho(rho)
+      rho(rho),
+      lockFreeUpdates(lockFreeUpdates)
   { /* Nothing to do here. */ }
 
   //! Get the amount of workers.
@@ -148,6 +151,11 @@ class TrainingConfig
   //! Modify the rho value for sac.
   double& Rho() { return rho; }
 
+  //! Get the indicator of lock-free updates.
+  bool LockFreeUpdates() const { return lockFreeUpdates; }
+  //! Modify the indicator of lock-free updates.
+  bool& LockFreeUpdates() { return lockFreeUpdates; }
+
  private:
   /**
    * Locally-stored number of workers.
@@ -241,6 +249,14 @@ class TrainingConfig
    * This is valid only for Soft Actor-Critic.
    */
   double rho;
+
+  /**
+   * Locally-stored indicator for lock-free updates.  If set, every worker
+   * keeps its own copy of the target network instead of sharing one that is
+   * guarded by a lock.
+   * This is valid only for async RL agent.
+   */
+  bool lockFreeUpdates;
 };
 
 } // namespace mlpack
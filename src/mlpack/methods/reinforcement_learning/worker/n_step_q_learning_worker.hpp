@@ -60,7 +60,8 @@ class NStepQLearningWorker
       environment(environment),
       config(config),
       deterministic(deterministic),
-      pending(config.UpdateInterval())
+      pending(config.UpdateInterval()),
+      lastTargetSync(0)
   { Reset(); }
 
   /**
@@ -81,6 +82,8 @@ class NStepQLearningWorker
       pending(other.pending),
       pendingIndex(other.pendingIndex),
       network(other.network),
+      localTargetNetwork(other.localTargetNetwork),
+      lastTargetSync(other.lastTargetSync),
       state(other.state)
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -111,6 +114,8 @@ class NStepQLearningWorker
       pending(std::move(other.pending)),
       pendingIndex(std::move(other.pendingIndex)),
       network(std::move(other.network)),
+      localTargetNetwork(std::move(other.localTargetNetwork)),
+      lastTargetSync(std::move(other.lastTargetSync)),
       state(std::move(other.state))
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -146,6 +151,8 @@ class NStepQLearningWorker
     pending = other.pending;
     pendingIndex = other.pendingIndex;
     network = other.network;
+    localTargetNetwork = other.localTargetNetwork;
+    lastTargetSync = other.lastTargetSync;
     state = other.state;
 
     #if ENS_VERSION_MAJOR >= 2
@@ -183,6 +190,8 @@ class NStepQLearningWorker
     pending = std::move(other.pending);
     pendingIndex = std::move(other.pendingIndex);
     network = std::move(other.network);
+    localTargetNetwork = std::move(other.localTargetNetwork);
+    lastTargetSync = std::move(other.lastTargetSync);
     state = std::move(other.state);
 
     #if ENS_VERSION_MAJOR >= 2
@@ -225,15 +234,19 @@ class NStepQLearningWorker
                                      learningNetwork.Parameters().n_cols);
     #endif
 
-    // Build local network.
+    // Build local network, and a local target network if the target network
+    // is not shared.
     network = learningNetwork;
+    if (config.LockFreeUpdates())
+      localTargetNetwork = learningNetwork;
   }
 
   /**
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetNetwork The shared target network; it is not used if
+   *     `config.LockFreeUpdates()` is set.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -265,15 +278,16 @@ class NStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    size_t currentSteps;
+    #pragma omp atomic capture
+    currentSteps = ++totalSteps;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
@@ -289,8 +303,7 @@ class NStepQLearningWorker
       double target = 0;
       if (!terminal)
       {
-        #pragma omp critical
-        { targetNetwork.Predict(nextState.Encode(), actionValue); };
+        PredictTarget(targetNetwork, nextState.Encode(), actionValue);
         target = actionValue.max();
       }
 
@@ -329,13 +342,21 @@ class NStepQLearningWorker
       #endif
 
       // Sync the local network with the global network.
-      network = learningNetwork;
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+    // Update the target network.
+    if (config.LockFreeUpdates())
+    {
+      if (currentSteps >= lastTargetSync + config.TargetNetworkSyncInterval())
+      {
+        localTargetNetwork.Parameters() = learningNetwork.Parameters();
+        lastTargetSync = currentSteps;
+      }
+    }
+    else if (currentSteps % config.TargetNetworkSyncInterval() == 0)
     {
       #pragma omp critical
       { targetNetwork = learningNetwork; }
@@ -354,6 +375,28 @@ class NStepQLearningWorker
   }
 
  private:
+  /**
+   * Compute the action values of the given state with the target network:
+   * either the local copy of this worker, or the shared one under a lock.
+   *
+   * @param targetNetwork The shared target network.
+   * @param encodedState The encoded state.
+   * @param actionValue The computed action values.
+   */
+  void PredictTarget(NetworkType& targetNetwork,
+                     const arma::colvec& encodedState,
+                     arma::colvec& actionValue)
+  {
+    if (config.LockFreeUpdates())
+    {
+      localTargetNetwork.Predict(encodedState, actionValue);
+      return;
+    }
+
+    #pragma omp critical
+    { targetNetwork.Predict(encodedState, actionValue); };
+  }
+
   /**
    * Reset the worker for a new episode.
    */
@@ -395,6 +438,12 @@ class NStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network, only used for lock-free updates.
+  NetworkType localTargetNetwork;
+
+  //! Total steps of all workers at the last sync of the local target network.
+  size_t lastTargetSync;
+
   //! Current state of the agent.
   StateType state;
 };
@@ -60,7 +60,8 @@ class OneStepQLearningWorker
       environment(environment),
       config(config),
       deterministic(deterministic),
-      pending(config.UpdateInterval())
+      pending(config.UpdateInterval()),
+      lastTargetSync(0)
   { Reset(); }
 
   /**
@@ -81,6 +82,8 @@ class OneStepQLearningWorker
       pending(other.pending),
       pendingIndex(other.pendingIndex),
       network(other.network),
+      localTargetNetwork(other.localTargetNetwork),
+      lastTargetSync(other.lastTargetSync),
       state(other.state)
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -111,6 +114,8 @@ class OneStepQLearningWorker
       pending(std::move(other.pending)),
       pendingIndex(std::move(other.pendingIndex)),
       network(std::move(other.network)),
+      localTargetNetwork(std::move(other.localTargetNetwork)),
+      lastTargetSync(std::move(other.lastTargetSync)),
       state(std::move(other.state))
   {
     #if ENS_VERSION_MAJOR >= 2
@@ -146,6 +151,8 @@ class OneStepQLearningWorker
     pending = other.pending;
     pendingIndex = other.pendingIndex;
     network = other.network;
+    localTargetNetwork = other.localTargetNetwork;
+    lastTargetSync = other.lastTargetSync;
     state = other.state;
 
     #if ENS_VERSION_MAJOR >= 2
@@ -183,6 +190,8 @@ class OneStepQLearningWorker
     pending = std::move(other.pending);
     pendingIndex = std::move(other.pendingIndex);
     network = std::move(other.network);
+    localTargetNetwork = std::move(other.localTargetNetwork);
+    lastTargetSync = std::move(other.lastTargetSync);
     state = std::move(other.state);
 
     #if ENS_VERSION_MAJOR >= 2
@@ -225,15 +234,19 @@ class OneStepQLearningWorker
                                      learningNetwork.Parameters().n_cols);
     #endif
 
-    // Build local network.
+    // Build local network, and a local target network if the target network
+    // is not shared.
     network = learningNetwork;
+    if (config.LockFreeUpdates())
+      localTargetNetwork = learningNetwork;
   }
 
   /**
    * The agent will execute one step.
    *
    * @param learningNetwork The shared learning network.
-   * @param targetNetwork The shared target network.
+   * @param targetNetwork The shared target network; it is not used if
+   *     `config.LockFreeUpdates()` is set.
    * @param totalSteps The shared counter for total steps.
    * @param policy The shared behavior policy.
    * @param totalReward This will be the episode return if the episode ends
@@ -265,15 +278,16 @@ class OneStepQLearningWorker
         totalReward = episodeReturn;
         Reset();
         // Sync with latest learning network.
-        network = learningNetwork;
+        network.Parameters() = learningNetwork.Parameters();
         return true;
       }
       state = nextState;
       return false;
     }
 
-    #pragma omp atomic
-    totalSteps++;
+    size_t currentSteps;
+    #pragma omp atomic capture
+    currentSteps = ++totalSteps;
 
     pending[pendingIndex] = std::make_tuple(state, action, reward, nextState);
     pendingIndex++;
@@ -289,11 +303,8 @@ class OneStepQLearningWorker
 
         // Compute the target state-action value.
         arma::colvec actionValue;
-        #pragma omp critical
-        {
-          targetNetwork.Predict(
-              std::get<3>(transition).Encode(), actionValue);
-        };
+        PredictTarget(targetNetwork, std::get<3>(transition).Encode(),
+            actionValue);
         double targetActionValue = actionValue.max();
         if (terminal && i == pending.size() - 1)
           targetActionValue = 0;
@@ -329,13 +340,21 @@ class OneStepQLearningWorker
       #endif
 
       // Sync the local network with the global network.
-      network = learningNetwork;
+      network.Parameters() = learningNetwork.Parameters();
 
       pendingIndex = 0;
     }
 
-    // Update global target network.
-    if (totalSteps % config.TargetNetworkSyncInterval() == 0)
+    // Update the target network.
+    if (config.LockFreeUpdates())
+    {
+      if (currentSteps >= lastTargetSync + config.TargetNetworkSyncInterval())
+      {
+        localTargetNetwork.Parameters() = learningNetwork.Parameters();
+        lastTargetSync = currentSteps;
+      }
+    }
+    else if (currentSteps % config.TargetNetworkSyncInterval() == 0)
     {
       #pragma omp critical
       { targetNetwork = learningNetwork; }
@@ -354,6 +373,28 @@ class OneStepQLearningWorker
   }
 
  private:
+  /**
+   * Compute the action values of the given state with the target network:
+   * either the local copy of this worker, or the shared one under a lock.
+   *
+   * @param targetNetwork The shared target network.
+   * @param encodedState The encoded state.
+   * @param actionValue The computed action values.
+   */
+  void PredictTarget(NetworkType& targetNetwork,
+                     const arma::colvec& encodedState,
+                     arma::colvec& actionValue)
+  {
+    if (config.LockFreeUpdates())
+    {
+      localTargetNetwork.Predict(encodedState, actionValue);
+      return;
+    }
+
+    #pragma omp critical
+    { targetNetwork.Predict(encodedState, actionValue); };
+  }
+
   /**
    * Reset the worker for a new episode.
    */
@@ -395,6 +436,12 @@ class OneStepQLearningWorker
   //! Local network of the worker.
   NetworkType network;
 
+  //! Local copy of the target network, only used for lock-free updates.
+  NetworkType localTargetNetwork;
+
+  //! Total steps of all workers at the last sync of the local target network.
+  size_t lastTargetSync;
+
   //! Current state of the agent.
   StateType state;
 };
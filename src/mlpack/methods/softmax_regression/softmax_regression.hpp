@@ -313,9 +313,9 @@ class SoftmaxRegression
   bool FitIntercept() const { return fitIntercept; }
 
   //! Get the model parameters.
-  MatType& Parameters() { return parameters; }
+  DenseMatType& Parameters() { return parameters; }
   //! Get the model parameters.
-  const MatType& Parameters() const { return parameters; }
+  const DenseMatType& Parameters() const { return parameters; }
 
   /**
    * Reset the weights in the model to small random values.  This function can
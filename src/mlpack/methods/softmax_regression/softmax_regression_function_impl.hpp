@@ -243,7 +243,7 @@ SoftmaxRegressionFunction<MatType>::Evaluate(
     const size_t start,
     const size_t batchSize) const
 {
-  MatType probabilities;
+  DenseMatType probabilities;
   GetProbabilitiesMatrix(parameters, probabilities, start, batchSize);
 
   // Calculate the log likelihood and regularization terms.
@@ -285,14 +285,16 @@ inline void SoftmaxRegressionFunction<MatType>::Gradient(
     gradient.col(0) =
         inner * ones<DenseMatType>(data.n_cols, 1) / data.n_cols +
         lambda * parameters.col(0);
+    // The data is multiplied on the left, so that sparse data is never
+    // transposed.
     gradient.cols(1, parameters.n_cols - 1) =
-        inner * data.t() / data.n_cols +
+        (data * inner.t()).t() / data.n_cols +
         lambda * parameters.cols(1, parameters.n_cols - 1);
   }
   else
   {
-    gradient = (probabilities - groundTruth) * data.t() / data.n_cols +
-               lambda * parameters;
+    const DenseMatType inner = probabilities - groundTruth;
+    gradient = (data * inner.t()).t() / data.n_cols + lambda * parameters;
   }
 }
 
@@ -317,14 +319,15 @@ inline void SoftmaxRegressionFunction<MatType>::Gradient(
         inner * ones<DenseMatType>(batchSize, 1) / batchSize +
         lambda * parameters.col(0);
     gradient.cols(1, parameters.n_cols - 1) =
-        inner * data.cols(start, start + batchSize - 1).t() / batchSize +
-        lambda * parameters.cols(1, parameters.n_cols - 1);
+        (data.cols(start, start + batchSize - 1) * inner.t()).t() /
+        batchSize + lambda * parameters.cols(1, parameters.n_cols - 1);
   }
   else
   {
-    gradient = (probabilities - groundTruth.cols(start, start + batchSize - 1))
-        * data.cols(start, start + batchSize - 1).t() / batchSize
-        + lambda * parameters;
+    const DenseMatType inner = probabilities -
+        groundTruth.cols(start, start + batchSize - 1);
+    gradient = (data.cols(start, start + batchSize - 1) * inner.t()).t() /
+        batchSize + lambda * parameters;
   }
 }
 
@@ -144,7 +144,7 @@ inline void SoftmaxRegression<MatType>::Classify(const MatType& dataset,
                                                  arma::Row<size_t>& labels)
     const
 {
-  MatType probabilities;
+  DenseMatType probabilities;
   Classify(dataset, labels, probabilities);
 }
 
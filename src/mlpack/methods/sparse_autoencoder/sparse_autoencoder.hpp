@@ -45,7 +45,7 @@ namespace mlpack {
  *
  * // Use an instantiated optimizer for the training.
  * SparseAutoencoderFunction saf(data, vSize, hSize);
- * L_BFGS<SparseAutoencoderFunction> optimizer(saf, numBasis, numIterations);
+ * L_BFGS<SparseAutoencoderFunction<>> optimizer(saf, numBasis, numIterations);
  * SparseAutoencoder<L_BFGS> encoder2(optimizer);
  *
  * arma::mat features1, features2; // Matrices for storing new representations.
@@ -56,7 +56,10 @@ namespace mlpack {
  * @endcode
  *
  * This implementation allows the use of arbitrary mlpack optimizers via the
- * OptimizerType template parameter.
+ * OptimizerType template parameter.  Since the objective function is
+ * separable, SGD-type optimizers (which see one mini-batch at a time) can be
+ * used as well as L-BFGS.  The data may be dense (arma::mat) or sparse
+ * (arma::sp_mat).
  *
  */
 class SparseAutoencoder
@@ -68,6 +71,7 @@ class SparseAutoencoder
    * optionally. Changing these parameters will have an effect on regularization
    * and sparsity of the model.
    *
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @tparam OptimizerType The optimizer to use.
    * @param data Input data with each column as one example.
    * @param visibleSize Size of input vector expected at the visible layer.
@@ -77,8 +81,8 @@ class SparseAutoencoder
    * @param rho Sparsity parameter.
    * @param optimizer Desired optimizer.
    */
-  template<typename OptimizerType = ens::L_BFGS>
-  SparseAutoencoder(const arma::mat& data,
+  template<typename MatType, typename OptimizerType = ens::L_BFGS>
+  SparseAutoencoder(const MatType& data,
                     const size_t visibleSize,
                     const size_t hiddenSize,
                     const double lambda = 0.0001,
@@ -92,6 +96,7 @@ class SparseAutoencoder
    * optionally. Changing these parameters will have an effect on regularization
    * and sparsity of the model.
    *
+   * @tparam MatType Type of the data (arma::mat or arma::sp_mat).
    * @tparam OptimizerType The optimizer to use.
    * @tparam CallbackTypes Types of Callback Functions.
    * @param data Input data with each column as one example.
@@ -104,8 +109,10 @@ class SparseAutoencoder
    * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
    *        See https://www.ensmallen.org/docs.html#callback-documentation.
    */
-  template<typename OptimizerType, typename... CallbackTypes>
-  SparseAutoencoder(const arma::mat& data,
+  template<typename MatType,
+           typename OptimizerType,
+           typename... CallbackTypes>
+  SparseAutoencoder(const MatType& data,
                     const size_t visibleSize,
                     const size_t hiddenSize,
                     const double lambda,
@@ -119,10 +126,11 @@ class SparseAutoencoder
    * autoencoder. The function basically performs a feedforward computation
    * using the learned weights, and returns the hidden layer activations.
    *
-   * @param data Matrix of the provided data.
+   * @param data Matrix of the provided data (dense or sparse).
    * @param features The hidden layer representation of the provided data.
    */
-  void GetNewFeatures(arma::mat& data, arma::mat& features);
+  template<typename MatType>
+  void GetNewFeatures(const MatType& data, arma::mat& features);
 
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
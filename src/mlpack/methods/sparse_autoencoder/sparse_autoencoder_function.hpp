@@ -14,6 +14,7 @@
 #define MLPACK_METHODS_SPARSE_AUTOENCODER_SPARSE_AUTOENCODER_FUNCTION_HPP
 
 #include <mlpack/prereqs.hpp>
+#include <mlpack/core/math/make_alias.hpp>
 
 namespace mlpack {
 
@@ -21,7 +22,18 @@ namespace mlpack {
  * This is a class for the sparse autoencoder objective function. It can be used
  * to create learning models like self-taught learning, stacked autoencoders,
  * conditional random fields (CRFs), and so forth.
+ *
+ * The function is separable, so it can be optimized with SGD-type optimizers
+ * as well as with full-batch optimizers like L-BFGS.  The objective of a batch
+ * of points is the objective of the full dataset with the average activations
+ * of the hidden layer (and the reconstruction error) computed over the points
+ * of the batch only.  The batch is processed in blocks of points in parallel
+ * with OpenMP.
+ *
+ * @tparam MatType Type of the data matrix: a dense matrix (arma::mat) or a
+ *     sparse matrix (arma::sp_mat).
  */
+template<typename MatType = arma::mat>
 class SparseAutoencoderFunction
 {
  public:
@@ -36,7 +48,7 @@ class SparseAutoencoderFunction
    * @param beta KL divergence parameter.
    * @param rho Sparsity parameter.
    */
-  SparseAutoencoderFunction(const arma::mat& data,
+  SparseAutoencoderFunction(const MatType& data,
                             const size_t visibleSize,
                             const size_t hiddenSize,
                             const double lambda = 0.0001,
@@ -58,6 +70,20 @@ class SparseAutoencoderFunction
    */
   double Evaluate(const arma::mat& parameters) const;
 
+  /**
+   * Evaluates the objective function of the sparse autoencoder model on the
+   * points [begin, begin + batchSize) of the (possibly shuffled) data, using
+   * the given parameters.  The reconstruction error and the average
+   * activations of the hidden layer are computed over these points only.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  double Evaluate(const arma::mat& parameters,
+                  const size_t begin,
+                  const size_t batchSize) const;
+
   /**
    * Evaluates the gradient values of the objective function given the current
    * set of parameters. The function performs a feedforward pass and computes
@@ -69,6 +95,51 @@ class SparseAutoencoderFunction
    */
   void Gradient(const arma::mat& parameters, arma::mat& gradient) const;
 
+  /**
+   * Evaluates the gradient values of the objective function on the points
+   * [begin, begin + batchSize) of the (possibly shuffled) data.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  void Gradient(const arma::mat& parameters,
+                const size_t begin,
+                arma::mat& gradient,
+                const size_t batchSize) const;
+
+  /**
+   * Evaluates the objective function and its gradient over the whole dataset
+   * in one feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param gradient Matrix where gradient values will be stored.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              arma::mat& gradient) const;
+
+  /**
+   * Evaluates the objective function and its gradient on the points
+   * [begin, begin + batchSize) of the (possibly shuffled) data, in one
+   * feedforward pass.
+   *
+   * @param parameters Current values of the model parameters.
+   * @param begin Index of the first point of the batch.
+   * @param gradient Matrix where gradient values will be stored.
+   * @param batchSize Number of points in the batch.
+   */
+  double EvaluateWithGradient(const arma::mat& parameters,
+                              const size_t begin,
+                              arma::mat& gradient,
+                              const size_t batchSize) const;
+
+  //! Shuffle the points of the dataset (for SGD-type optimizers).
+  void Shuffle();
+
+  //! Return the number of points (separable functions) in the dataset.
+  size_t NumFunctions() const { return data.n_cols; }
+
   /**
    * Returns the elementwise sigmoid of the passed matrix, where the sigmoid
    * function of a real number 'x' is [1 / (1 + exp(-x))].
@@ -145,8 +216,20 @@ class SparseAutoencoderFunction
   }
 
  private:
-  //! The matrix of data points.
-  const arma::mat& data;
+  /**
+   * Compute the objective function on the points [begin, begin + batchSize),
+   * and its gradient if `gradient` is not NULL.
+   */
+  double Compute(const arma::mat& parameters,
+                 const size_t begin,
+                 const size_t batchSize,
+                 arma::mat* gradient) const;
+
+  //! Number of points in each block that is processed by one thread.
+  static constexpr size_t BlockSize = 256;
+
+  //! The matrix of data points.  This is an alias until the data is shuffled.
+  MatType data;
   //! Initial parameter vector.
   arma::mat initialPoint;
   //! Size of the visible layer.
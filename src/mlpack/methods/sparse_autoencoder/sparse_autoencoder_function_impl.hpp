@@ -16,20 +16,22 @@
 
 namespace mlpack {
 
-inline SparseAutoencoderFunction::SparseAutoencoderFunction(
-    const arma::mat& data,
+template<typename MatType>
+inline SparseAutoencoderFunction<MatType>::SparseAutoencoderFunction(
+    const MatType& dataIn,
     const size_t visibleSize,
     const size_t hiddenSize,
     const double lambda,
     const double beta,
     const double rho) :
-    data(data),
     visibleSize(visibleSize),
     hiddenSize(hiddenSize),
     lambda(lambda),
     beta(beta),
     rho(rho)
 {
+  MakeAlias(data, dataIn, dataIn.n_rows, dataIn.n_cols, 0, false);
+
   // Initialize the parameters to suitable values.
   initialPoint = InitializeWeights();
 }
@@ -39,7 +41,8 @@ inline SparseAutoencoderFunction::SparseAutoencoderFunction(
   * [-r, r] where 'r' is decided using the sizes of the visible and hidden
   * layers. The biases b1, b2 are initialized to 0.
   */
-inline const arma::mat SparseAutoencoderFunction::InitializeWeights()
+template<typename MatType>
+inline const arma::mat SparseAutoencoderFunction<MatType>::InitializeWeights()
 {
   // The module uses a matrix to store the parameters, its structure looks like:
   //          vSize   1
@@ -73,10 +76,79 @@ inline const arma::mat SparseAutoencoderFunction::InitializeWeights()
   return parameters;
 }
 
+/**
+ * Shuffle the points of the dataset.
+ */
+template<typename MatType>
+inline void SparseAutoencoderFunction<MatType>::Shuffle()
+{
+  MatType newData = data.cols(arma::randperm(data.n_cols));
+  ClearAlias(data);
+  data = std::move(newData);
+}
+
 /** Evaluates the objective function given the parameters.
   */
-inline double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters)
-    const
+template<typename MatType>
+inline double SparseAutoencoderFunction<MatType>::Evaluate(
+    const arma::mat& parameters) const
+{
+  return Compute(parameters, 0, data.n_cols, NULL);
+}
+
+template<typename MatType>
+inline double SparseAutoencoderFunction<MatType>::Evaluate(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize) const
+{
+  return Compute(parameters, begin, batchSize, NULL);
+}
+
+/** Calculates and stores the gradient values given a set of parameters.
+  */
+template<typename MatType>
+inline void SparseAutoencoderFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  Compute(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+inline void SparseAutoencoderFunction<MatType>::Gradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  Compute(parameters, begin, batchSize, &gradient);
+}
+
+template<typename MatType>
+inline double SparseAutoencoderFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    arma::mat& gradient) const
+{
+  return Compute(parameters, 0, data.n_cols, &gradient);
+}
+
+template<typename MatType>
+inline double SparseAutoencoderFunction<MatType>::EvaluateWithGradient(
+    const arma::mat& parameters,
+    const size_t begin,
+    arma::mat& gradient,
+    const size_t batchSize) const
+{
+  return Compute(parameters, begin, batchSize, &gradient);
+}
+
+template<typename MatType>
+inline double SparseAutoencoderFunction<MatType>::Compute(
+    const arma::mat& parameters,
+    const size_t begin,
+    const size_t batchSize,
+    arma::mat* gradient) const
 {
   // The objective function is the average squared reconstruction error of the
   // network. w1 and b1 are the weights and biases associated with the hidden
@@ -85,6 +157,11 @@ inline double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters)
   // 'm' is the number of training examples.
   // The cost also takes into account the regularization and KL divergence terms
   // to control the parameter weights and sparsity of the model respectively.
+  //
+  // When the gradient is needed, the delta values of each layer (except for
+  // the input layer) are computed with the backpropagation algorithm, and then
+  // used with the input layer and hidden layer activations to get the
+  // parameter gradients.
 
   // Compute the limits for the parameters w1, w2, b1 and b2.
   const size_t l1 = hiddenSize;
@@ -99,117 +176,129 @@ inline double SparseAutoencoderFunction::Evaluate(const arma::mat& parameters)
   // b1 <- parameters.submat(0, l2, l1-1, l2)
   // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
 
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
+  // The points are processed in blocks, in parallel.  The activations of the
+  // hidden layer are needed for the whole batch, because the KL divergence
+  // term depends on their average; the other quantities are computed one
+  // block at a time.
+  const size_t numBlocks = (batchSize + BlockSize - 1) / BlockSize;
+  arma::mat hiddenLayer(l1, batchSize);
+  arma::mat blockActivations(l1, numBlocks);
+
+  // First pass: compute the activations of the hidden layer, and the sum of
+  // the activations of each block.  Summing the block sums gives the same
+  // result for any number of threads.
+  #pragma omp parallel for schedule(static)
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t first = b * BlockSize;
+    const size_t last = std::min(first + BlockSize, batchSize) - 1;
+
+    arma::mat hiddenBlock;
+    Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) *
+        data.cols(begin + first, begin + last) +
+        repmat(parameters.submat(0, l2, l1 - 1, l2), 1, last - first + 1),
+        hiddenBlock);
+    hiddenLayer.cols(first, last) = hiddenBlock;
+    blockActivations.col(b) = sum(hiddenBlock, 1);
+  }
 
   // Average activations of the hidden layer.
-  rhoCap = sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
+  const arma::vec rhoCap = sum(blockActivations, 1) / batchSize;
 
-  double wL2SquaredNorm;
+  // The delta vector for the output layer is given by diff * f'(z), where z is
+  // the preactivation and f is the activation function. The derivative of the
+  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
+  // in the neural network which comes before the output layer, the delta values
+  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
+  // includes the KL divergence term, we adjust for that in the formula below.
+  const arma::vec klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) /
+      (1 - rhoCap));
+
+  // Second pass: compute the reconstruction error and the gradient terms of
+  // each block.  Each thread accumulates its own terms, which are added in
+  // the order of the threads.
+  #ifdef MLPACK_USE_OPENMP
+  const size_t numThreads = std::max((size_t) 1,
+      std::min((size_t) omp_get_max_threads(), numBlocks));
+  #else
+  const size_t numThreads = 1;
+  #endif
+  arma::vec threadErrors(numThreads, arma::fill::zeros);
+  std::vector<arma::mat> threadGradients((gradient != NULL) ? numThreads : 0);
+
+  #pragma omp parallel num_threads(numThreads)
+  {
+    #ifdef MLPACK_USE_OPENMP
+    const size_t thread = omp_get_thread_num();
+    #else
+    const size_t thread = 0;
+    #endif
+    if (gradient != NULL)
+      threadGradients[thread].zeros(2 * hiddenSize + 1, visibleSize + 1);
+
+    #pragma omp for schedule(static)
+    for (size_t b = 0; b < numBlocks; ++b)
+    {
+      const size_t first = b * BlockSize;
+      const size_t last = std::min(first + BlockSize, batchSize) - 1;
+      const size_t n = last - first + 1;
+
+      const auto hiddenBlock = hiddenLayer.cols(first, last);
+      arma::mat outputBlock;
+      Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenBlock +
+          repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, n),
+          outputBlock);
+
+      // Difference between the reconstructed data and the original data.
+      const arma::mat diff = outputBlock -
+          data.cols(begin + first, begin + last);
+      threadErrors[thread] += accu(diff % diff);
+
+      if (gradient == NULL)
+        continue;
+
+      const arma::mat delOut = diff % outputBlock % (1 - outputBlock);
+      const arma::mat delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) *
+          delOut + repmat(klDivGrad, 1, n)) % hiddenBlock % (1 - hiddenBlock);
+
+      arma::mat& g = threadGradients[thread];
+      g.submat(0, 0, l1 - 1, l2 - 1) += delHid *
+          data.cols(begin + first, begin + last).t();
+      g.submat(l1, 0, l3 - 1, l2 - 1) += hiddenBlock * delOut.t();
+      g.submat(0, l2, l1 - 1, l2) += sum(delHid, 1);
+      g.submat(l3, 0, l3, l2 - 1) += sum(delOut, 1).t();
+    }
+  }
 
   // Calculate squared L2-norms of w1 and w2.
-  wL2SquaredNorm = accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
+  const double wL2SquaredNorm = accu(parameters.submat(0, 0, l3 - 1, l2 - 1) %
       parameters.submat(0, 0, l3 - 1, l2 - 1));
 
-  double sumOfSquaresError, weightDecay, klDivergence, cost;
-
   // Calculate the reconstruction error, the regularization cost and the KL
   // divergence cost terms. 'sumOfSquaresError' is the average squared l2-norm
   // of the reconstructed data difference. 'weightDecay' is the squared l2-norm
   // of the weights w1 and w2. 'klDivergence' is the cost of the hidden layer
   // activations not being low. It is given by the following formula:
   // KL = sum_over_hSize(rho*log(rho/rhoCaq) + (1-rho)*log((1-rho)/(1-rhoCap)))
-  sumOfSquaresError = 0.5 * accu(diff % diff) / data.n_cols;
-  weightDecay = 0.5 * lambda * wL2SquaredNorm;
-  klDivergence = beta * accu(rho * log(rho / rhoCap) + (1 - rho) *
-      log((1 - rho) / (1 - rhoCap)));
+  const double sumOfSquaresError = 0.5 * accu(threadErrors) / batchSize;
+  const double weightDecay = 0.5 * lambda * wL2SquaredNorm;
+  const double klDivergence = beta * accu(rho * log(rho / rhoCap) +
+      (1 - rho) * log((1 - rho) / (1 - rhoCap)));
+
+  if (gradient != NULL)
+  {
+    // Average the terms of the threads.  The formula also accounts for the
+    // regularization terms in the objective function.
+    *gradient = std::move(threadGradients[0]);
+    for (size_t t = 1; t < numThreads; ++t)
+      *gradient += threadGradients[t];
+    *gradient /= batchSize;
+    gradient->submat(0, 0, l3 - 1, l2 - 1) += lambda *
+        parameters.submat(0, 0, l3 - 1, l2 - 1);
+  }
 
   // The cost is the sum of the terms calculated above.
-  cost = sumOfSquaresError + weightDecay + klDivergence;
-
-  return cost;
-}
-
-/** Calculates and stores the gradient values given a set of parameters.
-  */
-inline void SparseAutoencoderFunction::Gradient(const arma::mat& parameters,
-                                                arma::mat& gradient) const
-{
-  // Performs a feedforward pass of the neural network, and computes the
-  // activations of the output layer as in the Evaluate() method. It uses the
-  // Backpropagation algorithm to calculate the delta values at each layer,
-  // except for the input layer. The delta values are then used with input layer
-  // and hidden layer activations to get the parameter gradients.
-
-  // Compute the limits for the parameters w1, w2, b1 and b2.
-  const size_t l1 = hiddenSize;
-  const size_t l2 = visibleSize;
-  const size_t l3 = 2 * hiddenSize;
-
-  // w1, w2, b1 and b2 are not extracted separately, 'parameters' is directly
-  // used in their place to avoid copying data. The following representations
-  // are used:
-  // w1 <- parameters.submat(0, 0, l1-1, l2-1)
-  // w2 <- parameters.submat(l1, 0, l3-1, l2-1).t()
-  // b1 <- parameters.submat(0, l2, l1-1, l2)
-  // b2 <- parameters.submat(l3, 0, l3, l2-1).t()
-
-  arma::mat hiddenLayer, outputLayer;
-
-  // Compute activations of the hidden and output layers.
-  Sigmoid(parameters.submat(0, 0, l1 - 1, l2 - 1) * data +
-      repmat(parameters.submat(0, l2, l1 - 1, l2), 1, data.n_cols),
-      hiddenLayer);
-
-  Sigmoid(parameters.submat(l1, 0, l3 - 1, l2 - 1).t() * hiddenLayer +
-      repmat(parameters.submat(l3, 0, l3, l2 - 1).t(), 1, data.n_cols),
-      outputLayer);
-
-  arma::mat rhoCap, diff;
-
-  // Average activations of the hidden layer.
-  rhoCap = sum(hiddenLayer, 1) / data.n_cols;
-  // Difference between the reconstructed data and the original data.
-  diff = outputLayer - data;
-
-  arma::mat klDivGrad, delOut, delHid;
-
-  // The delta vector for the output layer is given by diff * f'(z), where z is
-  // the preactivation and f is the activation function. The derivative of the
-  // sigmoid function turns out to be f(z) * (1 - f(z)). For every other layer
-  // in the neural network which comes before the output layer, the delta values
-  // are given del_n = w_n' * del_(n+1) * f'(z_n). Since our cost function also
-  // includes the KL divergence term, we adjust for that in the formula below.
-  klDivGrad = beta * (-(rho / rhoCap) + (1 - rho) / (1 - rhoCap));
-  delOut = diff % outputLayer % (1 - outputLayer);
-  delHid = (parameters.submat(l1, 0, l3 - 1, l2 - 1) * delOut +
-      repmat(klDivGrad, 1, data.n_cols)) % hiddenLayer %
-      (1 - hiddenLayer);
-
-  gradient.zeros(2 * hiddenSize + 1, visibleSize + 1);
-
-  // Compute the gradient values using the activations and the delta values. The
-  // formula also accounts for the regularization terms in the objective.
-  // function.
-  gradient.submat(0, 0, l1 - 1, l2 - 1) = delHid * data.t() / data.n_cols +
-      lambda * parameters.submat(0, 0, l1 - 1, l2 - 1);
-  gradient.submat(l1, 0, l3 - 1, l2 - 1) =
-      (delOut * hiddenLayer.t() / data.n_cols +
-      lambda * parameters.submat(l1, 0, l3 - 1, l2 - 1).t()).t();
-  gradient.submat(0, l2, l1 - 1, l2) = sum(delHid, 1) / data.n_cols;
-  gradient.submat(l3, 0, l3, l2 - 1) = (sum(delOut, 1) / data.n_cols).t();
+  return sumOfSquaresError + weightDecay + klDivergence;
 }
 
 } // namespace mlpack
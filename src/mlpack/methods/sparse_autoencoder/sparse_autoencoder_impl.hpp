@@ -17,8 +17,8 @@
 
 namespace mlpack {
 
-template<typename OptimizerType>
-SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
+template<typename MatType, typename OptimizerType>
+SparseAutoencoder::SparseAutoencoder(const MatType& data,
                                      const size_t visibleSize,
                                      const size_t hiddenSize,
                                      double lambda,
@@ -31,8 +31,8 @@ SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
     beta(beta),
     rho(rho)
 {
-  SparseAutoencoderFunction encoderFunction(data, visibleSize, hiddenSize,
-                                            lambda, beta, rho);
+  SparseAutoencoderFunction<MatType> encoderFunction(data, visibleSize,
+      hiddenSize, lambda, beta, rho);
 
   parameters = encoderFunction.GetInitialPoint();
 
@@ -43,8 +43,10 @@ SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
       << "trained model is " << out << "." << std::endl;
 }
 
-template<typename OptimizerType, typename... CallbackTypes>
-SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
+template<typename MatType,
+         typename OptimizerType,
+         typename... CallbackTypes>
+SparseAutoencoder::SparseAutoencoder(const MatType& data,
                                      const size_t visibleSize,
                                      const size_t hiddenSize,
                                      double lambda,
@@ -58,8 +60,8 @@ SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
     beta(beta),
     rho(rho)
 {
-  SparseAutoencoderFunction encoderFunction(data, visibleSize, hiddenSize,
-                                            lambda, beta, rho);
+  SparseAutoencoderFunction<MatType> encoderFunction(data, visibleSize,
+      hiddenSize, lambda, beta, rho);
 
   parameters = encoderFunction.GetInitialPoint();
 
@@ -71,7 +73,8 @@ SparseAutoencoder::SparseAutoencoder(const arma::mat& data,
       << "trained model is " << out << "." << std::endl;
 }
 
-inline void SparseAutoencoder::GetNewFeatures(arma::mat& data,
+template<typename MatType>
+inline void SparseAutoencoder::GetNewFeatures(const MatType& data,
                                               arma::mat& features)
 {
   const size_t l1 = hiddenSize;
@@ -63,27 +63,32 @@ inline void SparseCoding<MatType>::Encode(const MatType& data,
 {
   // When using the Cholesky version of LARS, this is correct even if
   // lambda2 > 0.
-  MatType matGram = trans(dictionary) * dictionary;
+  // The Gram matrix is computed only once, and shared by all points.
+  const MatType matGram = trans(dictionary) * dictionary;
 
+  Log::Debug << "Encoding " << data.n_cols << " points." << std::endl;
+
+  // Each point is an independent LARS problem, so the points are encoded in
+  // parallel, with one LARS object for each thread.
   codes.set_size(atoms, data.n_cols);
-  for (size_t i = 0; i < data.n_cols; ++i)
+  #pragma omp parallel
   {
-    // Report progress.
-    if ((i % 100) == 0)
-      Log::Debug << "Optimization at point " << i << "." << std::endl;
-
-    bool useCholesky = true;
+    const bool useCholesky = true;
     // Intercept fitting and data normalization is disabled.
     LARS<MatType> lars(useCholesky, lambda1, lambda2,
         1e-16 /* default tolerance */, false, false);
 
-    // Create an alias of the code (using the same memory), and then LARS will
-    // place the result directly into that; then we will not need to have an
-    // extra copy.
-    ColType code = codes.unsafe_col(i);
-    RowType responses = data.unsafe_col(i).t();
-    lars.Train(dictionary, responses, false, useCholesky, matGram);
-    code = lars.Beta();
+    #pragma omp for schedule(dynamic, 16)
+    for (size_t i = 0; i < (size_t) data.n_cols; ++i)
+    {
+      // Create an alias of the code (using the same memory), and then LARS
+      // will place the result directly into that; then we will not need to
+      // have an extra copy.
+      ColType code = codes.unsafe_col(i);
+      RowType responses = data.unsafe_col(i).t();
+      lars.Train(dictionary, responses, false, useCholesky, matGram);
+      code = lars.Beta();
+    }
   }
 }
 
@@ -198,16 +203,19 @@ inline double SparseCoding<MatType>::OptimizeDictionary(
     const double rho = 0.9;
     double sufficientDecrease = c * dot(gradient, searchDirection);
 
+    // Calculate the objective at the current point.  trace(X' * Y) is
+    // computed as accu(X % Y), so that the (large) dims x dims product is never
+    // formed.
+    const double sumDualVars = sum(dualVars);
+    const double fOld = accu(codesXT % matAInvZXT) + sumDualVars;
+
     // A maxIterations parameter for the Armijo line search may be a good idea,
     // but it doesn't seem to be causing any problems for now.
     while (true)
     {
-      // Calculate objective.
-      double sumDualVars = sum(dualVars);
-      double fOld = -(-trace(trans(codesXT) * matAInvZXT) - sumDualVars);
-      double fNew = -(-trace(trans(codesXT) * solve(codesZT +
-          diagmat(dualVars + alpha * searchDirection), codesXT)) -
-          (sumDualVars + alpha * sum(searchDirection)));
+      const double fNew = accu(codesXT % solve(codesZT +
+          diagmat(dualVars + alpha * searchDirection), codesXT)) +
+          (sumDualVars + alpha * sum(searchDirection));
 
       if (fNew <= fOld + alpha * sufficientDecrease)
       {
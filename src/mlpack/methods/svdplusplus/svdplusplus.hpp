@@ -79,10 +79,14 @@ class SVDPlusPlus
    * @param iterations Number of optimization iterations.
    * @param alpha Learning rate for the SGD optimizer.
    * @param lambda Regularization parameter for the optimization.
+   * @param parallel If true, train with lock-free parallel SGD (Hogwild!),
+   *     where every thread updates the factors from its own blocks of the
+   *     shuffled ratings.
    */
   SVDPlusPlus(const size_t iterations = 10,
               const double alpha = 0.001,
-              const double lambda = 0.1);
+              const double lambda = 0.1,
+              const bool parallel = false);
 
   /**
    * Trains the model and obtains user/item matrices, user/item bias, and
@@ -142,6 +146,8 @@ class SVDPlusPlus
   double alpha;
   //! Regularization parameter for the optimization.
   double lambda;
+  //! Whether to train with lock-free parallel SGD.
+  bool parallel;
 };
 
 } // namespace mlpack
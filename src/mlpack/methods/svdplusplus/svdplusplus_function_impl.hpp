@@ -414,6 +414,13 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
   // Rank of decomposition.
   const size_t rank = function.Rank();
 
+  // The implicit vectors start after the user and item columns.  The CSC
+  // arrays of the implicit data are read directly from every thread.
+  const size_t implicitStart = numUsers + numItems;
+  implicitData.sync();
+  const arma::uword* implicitColPtrs = implicitData.col_ptrs;
+  const arma::uword* implicitRows = implicitData.row_indices;
+
   // Iterate till the objective is within tolerance or the maximum number of
   // allowed iterations is reached. If maxIterations is 0, this will iterate
   // till convergence.
@@ -455,94 +462,89 @@ inline double ParallelSGD<ExponentialBackoff>::Optimize(
       std::shuffle(visitationOrder.begin(), visitationOrder.end(),
           mlpack::RandGen());
 
+    // Hogwild!: each thread takes blocks of threadShareSize ratings of the
+    // shuffled order and updates the parameters without any locks.  Each
+    // update only touches the columns of one user and one item (and the
+    // implicit vectors of the items the user interacted with), so the updates
+    // of different threads rarely overlap.
+    const size_t blockSize = std::max(threadShareSize, (size_t) 1);
     #pragma omp parallel
     {
-      // Each processor gets a subset of the instances.
-      // Each subset is of size threadShareSize.
       size_t threadId = 0;
+      size_t numThreads = 1;
       #ifdef MLPACK_USE_OPENMP
         threadId = omp_get_thread_num();
+        numThreads = omp_get_num_threads();
       #endif
 
-      for (size_t j = threadId * threadShareSize;
-          j < (threadId + 1) * threadShareSize && j < visitationOrder.n_elem;
-          ++j)
+      // Interpolated user vector of each example.
+      arma::vec userVec(rank);
+
+      for (size_t start = threadId * blockSize; start < visitationOrder.n_elem;
+          start += numThreads * blockSize)
       {
-        // Indices for accessing the the correct parameter columns.
-        const size_t user = data(0, visitationOrder[j]);
-        const size_t item = data(1, visitationOrder[j]) + numUsers;
-        const size_t implicitStart = numUsers + numItems;
-
-        // Prediction error for the example.
-        const double rating = data(2, visitationOrder[j]);
-        const double userBias = iterate(rank, user);
-        const double itemBias = iterate(rank, item);
-        // Iterate through each item which the user interacted with to calculate
-        // user vector.
-        arma::vec userVec(rank);
-        arma::sp_mat::const_iterator it = implicitData.begin_col(user);
-        arma::sp_mat::const_iterator it_end = implicitData.end_col(user);
-        size_t implicitCount = 0;
-        for (; it != it_end; ++it)
-        {
-          userVec += iterate.col(implicitStart + it.row()).subvec(0, rank - 1);
-          implicitCount += 1;
-        }
-        if (implicitCount != 0)
-          userVec /= std::sqrt(implicitCount);
-        userVec += iterate.col(user).subvec(0, rank - 1);
-
-        double ratingError = rating - userBias - itemBias -
-        dot(userVec, iterate.col(item).subvec(0, rank - 1));
-
-        arma::mat userVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(user).subvec(0, rank - 1) -
-            ratingError * iterate.col(item).subvec(0, rank - 1));
-        arma::mat itemVecUpdate = stepSize * 2 * (
-            lambda * iterate.col(item).subvec(0, rank - 1) -
-            ratingError * userVec);
-        double userBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, user) - ratingError);
-        double itemBiasUpdate = stepSize * 2 * (
-            lambda * iterate(rank, item) - ratingError);
-
-        // Update of item implicit vectors.
-        arma::mat itemImplicitUpdate(rank, implicitCount);
-        arma::Col<size_t> implicitItems(implicitCount);
-        it = implicitData.begin_col(user);
-        it_end = implicitData.end_col(user);
-        size_t implicitIndex = 0;
-        for (; it != it_end; ++it, ++implicitIndex)
+        const size_t end = std::min(start + blockSize,
+            (size_t) visitationOrder.n_elem);
+        for (size_t j = start; j < end; ++j)
         {
-          itemImplicitUpdate.col(implicitIndex) =
-              stepSize * 2.0 * (lambda / implicitCount *
-              iterate.col(implicitStart + it.row()).subvec(0, rank - 1) -
-              ratingError / std::sqrt(implicitCount) *
-              iterate.col(item).subvec(0, rank - 1));
-          implicitItems(implicitIndex) = it.row();
-        }
+          // Indices for accessing the the correct parameter columns.
+          const size_t user = data(0, visitationOrder[j]);
+          const size_t item = data(1, visitationOrder[j]) + numUsers;
+          double* userCol = iterate.colptr(user);
+          double* itemCol = iterate.colptr(item);
+
+          // The items which the user interacted with.
+          const arma::uword implicitBegin = implicitColPtrs[user];
+          const arma::uword implicitEnd = implicitColPtrs[user + 1];
+          const size_t implicitCount = implicitEnd - implicitBegin;
+          const double implicitScale = (implicitCount == 0) ? 0.0 :
+              1.0 / std::sqrt((double) implicitCount);
+
+          // Iterate through each item which the user interacted with to
+          // calculate user vector.
+          userVec.zeros();
+          for (arma::uword t = implicitBegin; t < implicitEnd; ++t)
+          {
+            const double* implicitCol =
+                iterate.colptr(implicitStart + implicitRows[t]);
+            for (size_t k = 0; k < rank; ++k)
+              userVec[k] += implicitCol[k];
+          }
 
-        // Gradient is non-zero only for the parameter columns corresponding to
-        // the example.
-        for (size_t i = 0; i < rank; ++i)
-        {
-          #pragma omp atomic
-          iterate(i, user) -= userVecUpdate(i);
-          #pragma omp atomic
-          iterate(i, item) -= itemVecUpdate(i);
-        }
-        #pragma omp atomic
-        iterate(rank, user) -= userBiasUpdate;
-        #pragma omp atomic
-        iterate(rank, item) -= itemBiasUpdate;
-        for (size_t k = 0; k < implicitCount; ++k)
-        {
-          for (size_t i = 0; i < rank; ++i)
+          // Prediction error for the example.
+          double ratingError = data(2, visitationOrder[j]) - userCol[rank] -
+              itemCol[rank];
+          for (size_t k = 0; k < rank; ++k)
+          {
+            userVec[k] = implicitScale * userVec[k] + userCol[k];
+            ratingError -= userVec[k] * itemCol[k];
+          }
+
+          // Update of item implicit vectors, with the old item vector.
+          for (arma::uword t = implicitBegin; t < implicitEnd; ++t)
+          {
+            double* implicitCol =
+                iterate.colptr(implicitStart + implicitRows[t]);
+            for (size_t k = 0; k < rank; ++k)
+            {
+              implicitCol[k] -= stepSize * 2.0 * (lambda / implicitCount *
+                  implicitCol[k] - ratingError * implicitScale * itemCol[k]);
+            }
+          }
+
+          // Gradient is non-zero only for the parameter columns corresponding
+          // to the example.
+          for (size_t k = 0; k < rank; ++k)
           {
-            #pragma omp atomic
-            iterate(i, implicitStart + implicitItems(k)) -=
-                itemImplicitUpdate(i, k);
+            userCol[k] -= stepSize * 2 * (lambda * userCol[k] -
+                ratingError * itemCol[k]);
+            itemCol[k] -= stepSize * 2 * (lambda * itemCol[k] -
+                ratingError * userVec[k]);
           }
+          userCol[rank] -= stepSize * 2 * (lambda * userCol[rank] -
+              ratingError);
+          itemCol[rank] -= stepSize * 2 * (lambda * itemCol[rank] -
+              ratingError);
         }
       }
     }
@@ -0,0 +1,67 @@
+/**
+ * @file methods/xgboost/fit_tree.hpp
+ *
+ * Fit one tree of a gradient boosting model to the gradients and hessians of
+ * its loss.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_FIT_TREE_HPP
+#define MLPACK_METHODS_XGBOOST_FIT_TREE_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "second_order_gain.hpp"
+
+namespace mlpack {
+
+/**
+ * Fit the given tree to the Newton steps `-g / h` of a loss, weighted by the
+ * hessians `h`, and add the shrunk output of the tree on the training points
+ * to the current predictions.  Hessians are floored to a small positive value
+ * so that the steps stay finite.
+ *
+ * @param tree Tree to train.
+ * @param data Dataset to train on.
+ * @param gradients Gradients of the loss of each point.
+ * @param hessians Hessians of the loss of each point.
+ * @param maximumDepth Maximum depth of the tree.
+ * @param minimumLeafSize Minimum number of points in each leaf.
+ * @param minimumGainSplit Minimum gain for splitting a node.
+ * @param lambda L2 regularization of the leaf values.
+ * @param colSampleRatio Ratio of the dimensions to search at each node.
+ * @param learningRate Shrinkage of the output of the tree.
+ * @param predictions Current predictions on the training points, updated.
+ */
+template<typename TreeType, typename MatType>
+void FitXGBoostTree(TreeType& tree,
+                    const MatType& data,
+                    const arma::rowvec& gradients,
+                    arma::rowvec hessians,
+                    const size_t maximumDepth,
+                    const size_t minimumLeafSize,
+                    const double minimumGainSplit,
+                    const double lambda,
+                    const double colSampleRatio,
+                    const double learningRate,
+                    arma::rowvec& predictions)
+{
+  hessians.clamp(1e-6, DBL_MAX);
+  arma::rowvec steps = -gradients / hessians;
+
+  const size_t numDimensions = std::max(
+      (size_t) std::ceil(colSampleRatio * data.n_rows), (size_t) 1);
+  tree.Train(data, std::move(steps), std::move(hessians), minimumLeafSize,
+      minimumGainSplit, maximumDepth,
+      MultipleRandomDimensionSelect(numDimensions), SecondOrderGain(lambda));
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] += learningRate * tree.Predict(data.col(i));
+}
+
+} // namespace mlpack
+
+#endif
@@ -91,6 +91,39 @@ class SSELoss
 
     return std::pow(ApplyL1(accu(gradients)), 2) / (accu(hessians) + lambda);
   }
+
+  /**
+   * Compute the gradients and hessians of the loss of each point, with respect
+   * to the current predictions.  This is used by XGBoostRegressor.
+   *
+   * @param observed The true observed values.
+   * @param predicted The predictions at the current step of boosting.
+   * @param grad The computed gradients.
+   * @param hess The computed hessians.
+   */
+  void Derivatives(const arma::rowvec& observed,
+                   const arma::rowvec& predicted,
+                   arma::rowvec& grad,
+                   arma::rowvec& hess) const
+  {
+    grad = predicted - observed;
+    hess.ones(observed.n_elem);
+  }
+
+  /**
+   * Compute the mean loss of the given predictions.
+   *
+   * @param observed The true observed values.
+   * @param predicted The predictions.
+   */
+  double Loss(const arma::rowvec& observed, const arma::rowvec& predicted) const
+  {
+    if (observed.n_elem == 0)
+      return 0.0;
+
+    return 0.5 * accu(square(observed - predicted)) / observed.n_elem;
+  }
+
  private:
   //! The L1 regularization parameter.
   const double alpha;
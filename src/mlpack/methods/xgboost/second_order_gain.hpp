@@ -0,0 +1,208 @@
+/**
+ * @file methods/xgboost/second_order_gain.hpp
+ *
+ * The second order gain class, which is the fitness function used to build the
+ * trees of gradient boosting.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_SECOND_ORDER_GAIN_HPP
+#define MLPACK_METHODS_XGBOOST_SECOND_ORDER_GAIN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The second order gain is the fitness function of XGBoost-style gradient
+ * boosting, for use with DecisionTreeRegressor.  Each boosting round fits a
+ * tree to the Newton steps `z = -g / h` of the loss, weighted by the hessians
+ * `h` (where `g` are the gradients); so the responses of the tree are the
+ * Newton steps and its weights are the hessians.
+ *
+ * With `G = sum(h * z)`, `H = sum(h)` and `S = sum(h * z^2)` over the points
+ * of a node, the gain of the node is
+ *
+ * @f{eqnarray*}{
+ *   gain = \frac{1}{H} \left( \frac{G^2}{H + \lambda} - S \right),
+ * @f}
+ *
+ * which is never positive, and the value of a leaf is `G / (H + lambda)`.  The
+ * gain of a split (as computed by the splitters) is then the XGBoost split
+ * score divided by `H`, and with `lambda = 0` this is the same as MSEGain.
+ */
+class SecondOrderGain
+{
+ public:
+  /**
+   * Create the second order gain with the given L2 regularization on the leaf
+   * values.
+   *
+   * @param lambda L2 regularization parameter.
+   */
+  SecondOrderGain(const double lambda = 0.0) :
+      lambda(lambda),
+      leftG(0.0),
+      leftH(0.0),
+      leftS(0.0),
+      totalG(0.0),
+      totalH(0.0),
+      totalS(0.0)
+  { }
+
+  /**
+   * Evaluate the second order gain of values from begin to end index.  Note
+   * that gain can be slightly greater than 0 due to floating-point
+   * representation issues.
+   *
+   * @param values Newton steps of the points.
+   * @param weights Hessians of the points (1 if UseWeights is false).
+   * @param begin Start index.
+   * @param end End index.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  double Evaluate(const VecType& values,
+                  const WeightVecType& weights,
+                  const size_t begin,
+                  const size_t end)
+  {
+    double g = 0.0, h = 0.0, s = 0.0;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double w = UseWeights ? (double) weights[i] : 1.0;
+      g += w * values[i];
+      h += w;
+      s += w * values[i] * values[i];
+    }
+
+    return Gain(g, h, s);
+  }
+
+  /**
+   * Evaluate the second order gain on the complete vector.
+   *
+   * @param values Newton steps of the points.
+   * @param weights Hessians of the points (1 if UseWeights is false).
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  double Evaluate(const VecType& values,
+                  const WeightVecType& weights)
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (values.n_elem == 0)
+      return 0.0;
+
+    return Evaluate<UseWeights>(values, weights, 0, values.n_elem);
+  }
+
+  /**
+   * Returns the output value of a leaf: the regularized Newton step
+   * `G / (H + lambda)` of its points.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightsType>
+  double OutputLeafValue(const ResponsesType& responses,
+                         const WeightsType& weights)
+  {
+    double g = 0.0, h = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      const double w = UseWeights ? (double) weights[i] : 1.0;
+      g += w * responses[i];
+      h += w;
+    }
+
+    return (h + lambda == 0.0) ? 0.0 : g / (h + lambda);
+  }
+
+  /**
+   * Calculates the second order gain of the left and right children for the
+   * current index.  The sums of the right child are those of the node minus
+   * those of the left child.
+   */
+  std::tuple<double, double> BinaryGains()
+  {
+    return std::make_tuple(Gain(leftG, leftH, leftS),
+        Gain(totalG - leftG, totalH - leftH, totalS - leftS));
+  }
+
+  /**
+   * Caches the sums of the node and of the initial left child, to efficiently
+   * compute the gain of each split.
+   *
+   * @param responses The Newton steps of the points.
+   * @param weights The hessians of the points.
+   * @param minimum The minimum number of elements in a leaf.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  void BinaryScanInitialize(const ResponsesType& responses,
+                            const WeightVecType& weights,
+                            const size_t minimum)
+  {
+    leftG = leftH = leftS = 0.0;
+    totalG = totalH = totalS = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      const double w = UseWeights ? (double) weights[i] : 1.0;
+      const double x = responses[i];
+      totalG += w * x;
+      totalH += w;
+      totalS += w * x * x;
+      if (i + 1 < minimum)
+      {
+        leftG += w * x;
+        leftH += w;
+        leftS += w * x * x;
+      }
+    }
+  }
+
+  /**
+   * Moves the point at the given index to the left child.
+   *
+   * @param responses The Newton steps of the points.
+   * @param weights The hessians of the points.
+   * @param index The current index.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  void BinaryStep(const ResponsesType& responses,
+                  const WeightVecType& weights,
+                  const size_t index)
+  {
+    const double w = UseWeights ? (double) weights[index] : 1.0;
+    const double x = responses[index];
+    leftG += w * x;
+    leftH += w;
+    leftS += w * x * x;
+  }
+
+  //! Get the L2 regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 regularization parameter.
+  double& Lambda() { return lambda; }
+
+ private:
+  //! Compute the gain from the sums of a node.
+  double Gain(const double g, const double h, const double s) const
+  {
+    // Catch edge case: if there are no weights, the impurity is zero.
+    if (h <= 0.0)
+      return 0.0;
+
+    return (g * g / (h + lambda) - s) / h;
+  }
+
+  //! The L2 regularization parameter.
+  double lambda;
+
+  //! The sums of h * z, h and h * z^2 of the left child, during a scan.
+  double leftG, leftH, leftS;
+  //! The sums of h * z, h and h * z^2 of the node, during a scan.
+  double totalG, totalH, totalS;
+};
+
+} // namespace mlpack
+
+#endif
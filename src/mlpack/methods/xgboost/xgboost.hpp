@@ -0,0 +1,17 @@
+/**
+ * @file methods/xgboost/xgboost.hpp
+ *
+ * Include all of the gradient boosting (XGBoost-style) learners.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_HPP
+
+#include "xgboost_regressor.hpp"
+#include "xgboost_classifier.hpp"
+
+#endif
@@ -0,0 +1,207 @@
+/**
+ * @file methods/xgboost/xgboost_classifier.hpp
+ *
+ * Definition of the XGBoostClassifier class, a gradient boosting classifier.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_CLASSIFIER_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_CLASSIFIER_HPP
+
+#include <mlpack/core.hpp>
+#include "xgboost_regressor.hpp"
+
+namespace mlpack {
+
+/**
+ * The XGBoostClassifier class implements gradient boosting of regression trees
+ * for classification, in the style of XGBoost (see XGBoostRegressor).  Each
+ * class has a score, and the class probabilities are the softmax of the
+ * scores; each boosting round fits one tree per class to the second order
+ * approximation of the cross-entropy loss.  For two classes, only the score of
+ * the second class is modeled (the score of the first is 0), so that the
+ * probabilities are a logistic function of one score and each round fits a
+ * single tree.
+ *
+ * All dimensions of the data are assumed to be numeric.
+ */
+class XGBoostClassifier
+{
+ public:
+  //! Allow access to the underlying decision tree type.
+  using TreeType = XGBoostRegressor<>::TreeType;
+
+  /**
+   * Construct the model without any training.  Classify() will throw an
+   * exception until Train() is called.
+   */
+  XGBoostClassifier() : numClasses(0), learningRate(0.0) { }
+
+  /**
+   * Create the model and train it on the given labeled data.  See Train() for
+   * the meaning of the parameters.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of boosting rounds.
+   * @param learningRate Shrinkage of the output of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param lambda L2 regularization of the leaf values.
+   * @param colSampleRatio Ratio of the dimensions to search at each node.
+   */
+  template<typename MatType>
+  XGBoostClassifier(const MatType& data,
+                    const arma::Row<size_t>& labels,
+                    const size_t numClasses,
+                    const size_t numTrees = 100,
+                    const double learningRate = 0.3,
+                    const size_t maximumDepth = 6,
+                    const size_t minimumLeafSize = 1,
+                    const double minimumGainSplit = 1e-7,
+                    const double lambda = 1.0,
+                    const double colSampleRatio = 1.0);
+
+  /**
+   * Train the model on the given labeled data, discarding any previous trees.
+   * The trees are built one after the other; within each tree, the dimensions
+   * of each node are searched in parallel with OpenMP when the node is large
+   * enough.
+   *
+   * @param data Dataset to train on.
+   * @param labels Labels for each point of the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param numTrees Number of boosting rounds.
+   * @param learningRate Shrinkage of the output of each tree, in (0, 1].
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node; note that the
+   *     gain is per unit of hessian (see SecondOrderGain).
+   * @param lambda L2 regularization of the leaf values.
+   * @param colSampleRatio Ratio of the dimensions to search at each node, in
+   *     (0, 1].
+   * @return The mean cross-entropy of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t numTrees = 100,
+               const double learningRate = 0.3,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double minimumGainSplit = 1e-7,
+               const double lambda = 1.0,
+               const double colSampleRatio = 1.0);
+
+  /**
+   * Predict the class of the given point.  If the model has not been trained,
+   * this will throw an exception.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities.  If the model has not been trained, this will throw an
+   * exception.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.  The points are
+   * classified in parallel with OpenMP.  If the model has not been trained,
+   * this will throw an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.  The points are classified in
+   * parallel with OpenMP.  If the model has not been trained, this will throw
+   * an exception.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Access a tree of the model.  The trees of round `t` are those from index
+  //! `t * NumScores()` to `(t + 1) * NumScores() - 1`, one per score.
+  const TreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Modify a tree of the model (be careful!).
+  TreeType& Tree(const size_t i) { return trees[i]; }
+
+  //! Get the number of trees of the model.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get the number of classes of the model.
+  size_t NumClasses() const { return numClasses; }
+
+  //! Get the number of scores (and trees per round) of the model: 1 for two
+  //! classes, otherwise the number of classes.
+  size_t NumScores() const { return (numClasses == 2) ? 1 : numClasses; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Compute the scores of the given point.
+   *
+   * @param point Point to compute the scores of.
+   * @param scores Output scores, one for each of NumScores().
+   */
+  template<typename VecType>
+  void Scores(const VecType& point, arma::vec& scores) const;
+
+  /**
+   * Compute the class probabilities for each column of the given scores.
+   *
+   * @param scores Scores of each point.
+   * @param probabilities Output class probabilities of each point.
+   */
+  void Probabilities(const arma::mat& scores, arma::mat& probabilities) const;
+
+  //! The number of classes.
+  size_t numClasses;
+  //! The trees of the model, round after round.
+  std::vector<TreeType> trees;
+  //! The scores before any tree is added.
+  arma::vec initialScores;
+  //! The shrinkage of the output of each tree.
+  double learningRate;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_classifier_impl.hpp"
+
+#endif
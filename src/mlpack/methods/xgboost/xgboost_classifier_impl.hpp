@@ -0,0 +1,240 @@
+/**
+ * @file methods/xgboost/xgboost_classifier_impl.hpp
+ *
+ * Implementation of the XGBoostClassifier class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_CLASSIFIER_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_CLASSIFIER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost_classifier.hpp"
+#include "fit_tree.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+XGBoostClassifier::XGBoostClassifier(const MatType& data,
+                                     const arma::Row<size_t>& labels,
+                                     const size_t numClasses,
+                                     const size_t numTrees,
+                                     const double learningRate,
+                                     const size_t maximumDepth,
+                                     const size_t minimumLeafSize,
+                                     const double minimumGainSplit,
+                                     const double lambda,
+                                     const double colSampleRatio) :
+    numClasses(0),
+    learningRate(0.0)
+{
+  Train(data, labels, numClasses, numTrees, learningRate, maximumDepth,
+      minimumLeafSize, minimumGainSplit, lambda, colSampleRatio);
+}
+
+template<typename MatType>
+double XGBoostClassifier::Train(const MatType& data,
+                                const arma::Row<size_t>& labels,
+                                const size_t numClasses,
+                                const size_t numTrees,
+                                const double learningRate,
+                                const size_t maximumDepth,
+                                const size_t minimumLeafSize,
+                                const double minimumGainSplit,
+                                const double lambda,
+                                const double colSampleRatio)
+{
+  util::CheckSameSizes(data, labels, "XGBoostClassifier::Train()");
+
+  if (numClasses < 2)
+  {
+    throw std::invalid_argument("XGBoostClassifier::Train(): numClasses "
+        "must be at least 2!");
+  }
+  if (learningRate <= 0.0 || learningRate > 1.0)
+  {
+    throw std::invalid_argument("XGBoostClassifier::Train(): learningRate "
+        "must be in (0, 1]!");
+  }
+  if (colSampleRatio <= 0.0 || colSampleRatio > 1.0)
+  {
+    throw std::invalid_argument("XGBoostClassifier::Train(): colSampleRatio "
+        "must be in (0, 1]!");
+  }
+
+  this->numClasses = numClasses;
+  this->learningRate = learningRate;
+  const size_t numScores = NumScores();
+
+  // The initial scores match the frequencies of the classes.
+  arma::vec frequencies(numClasses, arma::fill::zeros);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    ++frequencies[labels[i]];
+  frequencies /= std::max((double) labels.n_elem, 1.0);
+  frequencies.clamp(1e-6, 1.0 - 1e-6);
+  if (numScores == 1)
+  {
+    initialScores.set_size(1);
+    initialScores[0] = std::log(frequencies[1] / frequencies[0]);
+  }
+  else
+  {
+    initialScores = arma::log(frequencies);
+  }
+
+  arma::mat scores = arma::repmat(initialScores, 1, data.n_cols);
+  arma::mat probabilities;
+  arma::rowvec gradients, hessians, treeScores;
+  trees.clear();
+  trees.resize(numTrees * numScores);
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    // All trees of a round are fit to the same probabilities.
+    Probabilities(scores, probabilities);
+    for (size_t k = 0; k < numScores; ++k)
+    {
+      // The gradient of the cross-entropy with respect to the score of class c
+      // is p_c - [y = c], and its hessian is p_c (1 - p_c).
+      const size_t c = (numScores == 1) ? 1 : k;
+      gradients = probabilities.row(c);
+      hessians = gradients % (1.0 - gradients);
+      for (size_t i = 0; i < labels.n_elem; ++i)
+      {
+        if (labels[i] == c)
+          gradients[i] -= 1.0;
+      }
+
+      treeScores = scores.row(k);
+      FitXGBoostTree(trees[t * numScores + k], data, gradients,
+          std::move(hessians), maximumDepth, minimumLeafSize,
+          minimumGainSplit, lambda, colSampleRatio, learningRate, treeScores);
+      scores.row(k) = treeScores;
+    }
+  }
+
+  // Compute the mean cross-entropy on the training set.
+  Probabilities(scores, probabilities);
+  double loss = 0.0;
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    loss -= std::log(std::max(probabilities(labels[i], i), 1e-15));
+
+  return loss / std::max((double) labels.n_elem, 1.0);
+}
+
+template<typename VecType>
+size_t XGBoostClassifier::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+  return prediction;
+}
+
+template<typename VecType>
+void XGBoostClassifier::Classify(const VecType& point,
+                                 size_t& prediction,
+                                 arma::vec& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("XGBoostClassifier::Classify(): no model "
+        "trained!");
+  }
+
+  arma::vec scores;
+  Scores(point, scores);
+  arma::mat pointProbabilities;
+  Probabilities(scores, pointProbabilities);
+  probabilities = pointProbabilities.col(0);
+  prediction = probabilities.index_max();
+}
+
+template<typename MatType>
+void XGBoostClassifier::Classify(const MatType& data,
+                                 arma::Row<size_t>& predictions) const
+{
+  arma::mat probabilities;
+  Classify(data, predictions, probabilities);
+}
+
+template<typename MatType>
+void XGBoostClassifier::Classify(const MatType& data,
+                                 arma::Row<size_t>& predictions,
+                                 arma::mat& probabilities) const
+{
+  if (numClasses == 0)
+  {
+    throw std::invalid_argument("XGBoostClassifier::Classify(): no model "
+        "trained!");
+  }
+
+  arma::mat scores(NumScores(), data.n_cols);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    arma::vec pointScores;
+    Scores(data.col(i), pointScores);
+    scores.col(i) = pointScores;
+  }
+
+  Probabilities(scores, probabilities);
+  predictions.set_size(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = probabilities.col(i).index_max();
+}
+
+template<typename VecType>
+void XGBoostClassifier::Scores(const VecType& point, arma::vec& scores) const
+{
+  const size_t numScores = NumScores();
+  scores.zeros(numScores);
+  for (size_t t = 0; t < trees.size(); ++t)
+    scores[t % numScores] += trees[t].Predict(point);
+
+  scores = initialScores + learningRate * scores;
+}
+
+inline void XGBoostClassifier::Probabilities(const arma::mat& scores,
+                                             arma::mat& probabilities) const
+{
+  probabilities.set_size(numClasses, scores.n_cols);
+  if (NumScores() == 1)
+  {
+    probabilities.row(1) = 1.0 / (1.0 + arma::exp(-scores.row(0)));
+    probabilities.row(0) = 1.0 - probabilities.row(1);
+    return;
+  }
+
+  // Softmax, shifted by the largest score of each point for stability.
+  probabilities = arma::exp(scores.each_row() - arma::max(scores, 0));
+  probabilities.each_row() /= arma::sum(probabilities, 0);
+}
+
+template<typename Archive>
+void XGBoostClassifier::serialize(Archive& ar, const uint32_t /* version */)
+{
+  size_t numTrees;
+  if (cereal::is_loading<Archive>())
+    trees.clear();
+  else
+    numTrees = trees.size();
+
+  ar(CEREAL_NVP(numTrees));
+
+  // Allocate space if needed.
+  if (cereal::is_loading<Archive>())
+    trees.resize(numTrees);
+
+  ar(CEREAL_NVP(trees));
+  ar(CEREAL_NVP(numClasses));
+  ar(CEREAL_NVP(initialScores));
+  ar(CEREAL_NVP(learningRate));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,170 @@
+/**
+ * @file methods/xgboost/xgboost_regressor.hpp
+ *
+ * Definition of the XGBoostRegressor class, a gradient boosting regressor.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree_regressor.hpp>
+#include "loss_functions/sse_loss.hpp"
+#include "second_order_gain.hpp"
+
+namespace mlpack {
+
+/**
+ * The XGBoostRegressor class implements gradient boosting of regression trees
+ * in the style of XGBoost:
+ *
+ * @code
+ * @inproceedings{chen2016xgboost,
+ *   title={XGBoost: A scalable tree boosting system},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Each boosting round fits a DecisionTreeRegressor to the second order
+ * (Newton) approximation of the loss around the current predictions, using
+ * SecondOrderGain as the fitness function, HistogramNumericSplit to find the
+ * splits, and a random subset of the dimensions at each node.  The prediction
+ * is the initial prediction of the loss plus the sum of the outputs of all
+ * trees, shrunk by the learning rate.
+ *
+ * All dimensions of the data are assumed to be numeric.
+ *
+ * @tparam LossFunction Loss to minimize; it must provide InitialPrediction(),
+ *     Derivatives() and Loss(), like SSELoss.
+ */
+template<typename LossFunction = SSELoss>
+class XGBoostRegressor
+{
+ public:
+  //! Allow access to the underlying decision tree type.
+  using TreeType = DecisionTreeRegressor<SecondOrderGain,
+      HistogramNumericSplit, AllCategoricalSplit,
+      MultipleRandomDimensionSelect>;
+
+  /**
+   * Construct the model without any training.  Until Train() is called, the
+   * model predicts 0 for every point.
+   */
+  XGBoostRegressor();
+
+  /**
+   * Create the model and train it on the given data and responses.  See
+   * Train() for the meaning of the parameters.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for each point of the dataset.
+   * @param numTrees Number of boosting rounds (and trees).
+   * @param learningRate Shrinkage of the output of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node.
+   * @param lambda L2 regularization of the leaf values.
+   * @param colSampleRatio Ratio of the dimensions to search at each node.
+   */
+  template<typename MatType, typename ResponsesType>
+  XGBoostRegressor(const MatType& data,
+                   const ResponsesType& responses,
+                   const size_t numTrees = 100,
+                   const double learningRate = 0.3,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 1,
+                   const double minimumGainSplit = 1e-7,
+                   const double lambda = 1.0,
+                   const double colSampleRatio = 1.0);
+
+  /**
+   * Train the model on the given data and responses, discarding any previous
+   * trees.  The trees are built one after the other; within each tree, the
+   * dimensions of each node are searched in parallel with OpenMP when the
+   * node is large enough.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for each point of the dataset.
+   * @param numTrees Number of boosting rounds (and trees).
+   * @param learningRate Shrinkage of the output of each tree, in (0, 1].
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf.
+   * @param minimumGainSplit Minimum gain for splitting a node; note that the
+   *     gain is per unit of hessian (see SecondOrderGain).
+   * @param lambda L2 regularization of the leaf values.
+   * @param colSampleRatio Ratio of the dimensions to search at each node, in
+   *     (0, 1].
+   * @return The loss of the model on the training set.
+   */
+  template<typename MatType, typename ResponsesType>
+  double Train(const MatType& data,
+               const ResponsesType& responses,
+               const size_t numTrees = 100,
+               const double learningRate = 0.3,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double minimumGainSplit = 1e-7,
+               const double lambda = 1.0,
+               const double colSampleRatio = 1.0);
+
+  /**
+   * Predict the response of the given point.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the responses of each point in the given dataset.  The points are
+   * predicted in parallel with OpenMP.
+   *
+   * @param data Dataset to predict.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  //! Access a tree of the model.
+  const TreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Modify a tree of the model (be careful!).
+  TreeType& Tree(const size_t i) { return trees[i]; }
+
+  //! Get the number of trees of the model.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get the initial prediction of the model.
+  double InitialPrediction() const { return initialPrediction; }
+
+  //! Get the learning rate the model was trained with.
+  double LearningRate() const { return learningRate; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The trees of the model.
+  std::vector<TreeType> trees;
+  //! The prediction before any tree is added.
+  double initialPrediction;
+  //! The shrinkage of the output of each tree.
+  double learningRate;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_regressor_impl.hpp"
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * @file methods/xgboost/xgboost_regressor_impl.hpp
+ *
+ * Implementation of the XGBoostRegressor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost_regressor.hpp"
+#include "fit_tree.hpp"
+
+namespace mlpack {
+
+template<typename LossFunction>
+XGBoostRegressor<LossFunction>::XGBoostRegressor() :
+    initialPrediction(0.0),
+    learningRate(0.0)
+{
+  // Nothing to do.
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType>
+XGBoostRegressor<LossFunction>::XGBoostRegressor(
+    const MatType& data,
+    const ResponsesType& responses,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double lambda,
+    const double colSampleRatio) :
+    initialPrediction(0.0),
+    learningRate(0.0)
+{
+  Train(data, responses, numTrees, learningRate, maximumDepth,
+      minimumLeafSize, minimumGainSplit, lambda, colSampleRatio);
+}
+
+template<typename LossFunction>
+template<typename MatType, typename ResponsesType>
+double XGBoostRegressor<LossFunction>::Train(
+    const MatType& data,
+    const ResponsesType& responses,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double lambda,
+    const double colSampleRatio)
+{
+  util::CheckSameSizes(data, responses, "XGBoostRegressor::Train()");
+
+  if (learningRate <= 0.0 || learningRate > 1.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): learningRate "
+        "must be in (0, 1]!");
+  }
+  if (colSampleRatio <= 0.0 || colSampleRatio > 1.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): colSampleRatio "
+        "must be in (0, 1]!");
+  }
+
+  const arma::rowvec observed = ConvTo<arma::rowvec>::From(responses);
+
+  LossFunction loss;
+  trees.clear();
+  trees.resize(numTrees);
+  this->learningRate = learningRate;
+  initialPrediction = loss.InitialPrediction(observed);
+
+  arma::rowvec predictions(observed.n_elem);
+  predictions.fill(initialPrediction);
+  arma::rowvec gradients, hessians;
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    loss.Derivatives(observed, predictions, gradients, hessians);
+    FitXGBoostTree(trees[t], data, gradients, std::move(hessians),
+        maximumDepth, minimumLeafSize, minimumGainSplit, lambda,
+        colSampleRatio, learningRate, predictions);
+  }
+
+  return loss.Loss(observed, predictions);
+}
+
+template<typename LossFunction>
+template<typename VecType>
+double XGBoostRegressor<LossFunction>::Predict(const VecType& point) const
+{
+  double prediction = 0.0;
+  for (size_t t = 0; t < trees.size(); ++t)
+    prediction += trees[t].Predict(point);
+
+  return initialPrediction + learningRate * prediction;
+}
+
+template<typename LossFunction>
+template<typename MatType>
+void XGBoostRegressor<LossFunction>::Predict(const MatType& data,
+                                             arma::rowvec& predictions) const
+{
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < data.n_cols; ++i)
+    predictions[i] = Predict(data.col(i));
+}
+
+template<typename LossFunction>
+template<typename Archive>
+void XGBoostRegressor<LossFunction>::serialize(
+    Archive& ar,
+    const uint32_t /* version */)
+{
+  size_t numTrees;
+  if (cereal::is_loading<Archive>())
+    trees.clear();
+  else
+    numTrees = trees.size();
+
+  ar(CEREAL_NVP(numTrees));
+
+  // Allocate space if needed.
+  if (cereal::is_loading<Archive>())
+    trees.resize(numTrees);
+
+  ar(CEREAL_NVP(trees));
+  ar(CEREAL_NVP(initialPrediction));
+  ar(CEREAL_NVP(learningRate));
+}
+
+} // namespace mlpack
+
+#endif
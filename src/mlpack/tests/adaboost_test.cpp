@@ -1019,6 +1019,47 @@ TEMPLATE_TEST_CASE("AdaBoostSinglePointClassifyWithProbs", "[AdaBoostTest]",
   }
 }
 
+// Make sure that batch classification, which is done in parallel, gives the
+// same results as classifying each point on its own.
+TEMPLATE_TEST_CASE("AdaBoostBatchClassifyMatchesSinglePoint", "[AdaBoostTest]",
+    mat, fmat)
+{
+  using MatType = TestType;
+  using eT = typename MatType::elem_type;
+
+  // Create random data.
+  MatType data = randu<MatType>(10, 500);
+  // Create random labels.
+  Row<size_t> labels = randi<Row<size_t>>(500, DistrParam(0, 3));
+
+  // Train a model.
+  using PerceptronType =
+      Perceptron<SimpleWeightUpdate, ZeroInitialization, MatType>;
+  AdaBoost<PerceptronType, MatType> ab(data, labels, 4);
+
+  Row<size_t> predictions;
+  Mat<eT> probabilities;
+  ab.Classify(data, predictions, probabilities);
+
+  REQUIRE(predictions.n_elem == data.n_cols);
+  REQUIRE(probabilities.n_rows == 4);
+  REQUIRE(probabilities.n_cols == data.n_cols);
+
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    size_t prediction;
+    Row<eT> pointProbabilities;
+    ab.Classify(data.col(i), prediction, pointProbabilities);
+
+    REQUIRE(predictions[i] == prediction);
+    for (size_t c = 0; c < 4; ++c)
+    {
+      REQUIRE(probabilities(c, i) ==
+          Approx(pointProbabilities[c]).margin(1e-5));
+    }
+  }
+}
+
 // Make sure that everything works when we use the constructor that takes extra
 // hyperparameters.
 TEMPLATE_TEST_CASE("AdaBoostParamsConstructor", "[AdaBoostTest]", fmat, mat)
@@ -1104,3 +1145,30 @@ TEMPLATE_TEST_CASE("AdaBoostTrainOverloads", "[AdaBoostTest]", fmat, mat)
   REQUIRE(a3.WeakLearner(0).MaxIterations() == 1000);
   REQUIRE(a4.WeakLearner(0).MaxIterations() == 100);
 }
+
+/**
+ * Make sure that AdaBoost with decision stumps can be trained on sparse data,
+ * and gives about the same model as with the same data as a dense matrix.
+ */
+TEST_CASE("AdaBoostSparseDecisionStumpTest", "[AdaBoostTest]")
+{
+  sp_mat sparseData = sprandu<sp_mat>(20, 500, 0.3);
+  const mat data(sparseData);
+  Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(1, i) > 0.4) ? 1 : ((data(6, i) > 0.0) ? 2 : 0);
+
+  AdaBoost<ID3DecisionStump> dense(1e-10);
+  AdaBoost<ID3DecisionStump, sp_mat> sparse(1e-10);
+  dense.Train(data, labels, 3, 20, 1e-10, 5);
+  sparse.Train(sparseData, labels, 3, 20, 1e-10, 5);
+  REQUIRE(sparse.WeakLearners() == dense.WeakLearners());
+
+  Row<size_t> densePredictions, sparsePredictions;
+  dense.Classify(data, densePredictions);
+  sparse.Classify(sparseData, sparsePredictions);
+  // The weights of the points are not exact, so the sums of the weights of the
+  // sparse stumps may be rounded differently.
+  REQUIRE(accu(densePredictions == sparsePredictions) > 0.98 * data.n_cols);
+  REQUIRE(accu(sparsePredictions == labels) > 0.9 * data.n_cols);
+}
@@ -16,6 +16,7 @@
 
 #include "./ann_test_tools.hpp"
 #include "../catch.hpp"
+#include "../test_catch_tools.hpp"
 
 using namespace mlpack;
 
@@ -864,3 +865,95 @@ TEST_CASE("BipolaSigmoidFunctionTest", "[ActivationFunctionsTest]")
       inputTemp, -2, 2);
   REQUIRE(maxRelativeError <= 1e-3);
 }
+
+/**
+ * Make sure that the fast approximations of exp(), expm1(), log(), and tanh()
+ * are accurate for double and float, and handle special values.
+ */
+TEST_CASE("FastMathTest", "[ActivationFunctionsTest]")
+{
+  const arma::vec x = 700 * (2 * arma::randu<arma::vec>(10000) - 1);
+  const arma::vec small = arma::randn<arma::vec>(10000);
+  const arma::vec positive = arma::exp(x);
+  for (size_t i = 0; i < x.n_elem; ++i)
+  {
+    REQUIRE(FastExp(x[i]) == Approx(std::exp(x[i])).epsilon(1e-14));
+    REQUIRE(FastLog(positive[i]) ==
+        Approx(std::log(positive[i])).epsilon(1e-14));
+    REQUIRE(FastExpm1(small[i]) ==
+        Approx(std::expm1(small[i])).epsilon(1e-14));
+    REQUIRE(FastTanh(small[i]) == Approx(std::tanh(small[i])).epsilon(1e-14));
+
+    const float xf = (float) (x[i] / 10);
+    const float smallf = (float) small[i];
+    REQUIRE(FastExp(xf) == Approx(std::exp(xf)).epsilon(1e-6));
+    REQUIRE(FastLog(std::abs(xf)) ==
+        Approx(std::log(std::abs(xf))).epsilon(1e-6).margin(1e-6));
+    REQUIRE(FastTanh(smallf) == Approx(std::tanh(smallf)).epsilon(1e-6));
+  }
+
+  // Fewer terms still give a reasonable approximation.
+  REQUIRE(FastExp<double, 5>(0.3) == Approx(std::exp(0.3)).epsilon(1e-5));
+  REQUIRE(FastExpm1(1e-10) == Approx(std::expm1(1e-10)).epsilon(1e-14));
+  REQUIRE(FastLog(1e-310) == Approx(std::log(1e-310)).epsilon(1e-14));
+
+  const double inf = std::numeric_limits<double>::infinity();
+  REQUIRE(FastExp(1000.0) == inf);
+  REQUIRE(FastExp(-1000.0) == 0.0);
+  REQUIRE(FastExp(-inf) == 0.0);
+  REQUIRE(FastExpm1(-1000.0) == -1.0);
+  REQUIRE(FastLog(0.0) == -inf);
+  REQUIRE(FastLog(inf) == inf);
+  REQUIRE(std::isnan(FastLog(-1.0)));
+  REQUIRE(FastTanh(inf) == 1.0);
+  REQUIRE(FastTanh(-inf) == -1.0);
+  REQUIRE(std::isnan(FastExp(std::nan(""))));
+  REQUIRE(std::isnan(FastTanh(std::nan(""))));
+}
+
+/**
+ * Make sure that the fast implementations of the activation functions used for
+ * dense matrices agree with the Armadillo expressions, which are used for
+ * other types such as subviews.
+ */
+template<typename ActivationFunction>
+void CheckFastActivation()
+{
+  arma::mat x(10, 30, arma::fill::randn);
+  x *= 5;
+  x(0, 0) = 0.0;
+
+  arma::mat y, yRef, dy, dyRef;
+  ActivationFunction::Fn(x, y);
+  ActivationFunction::Fn(x.cols(0, x.n_cols - 1), yRef);
+  ActivationFunction::Deriv(x, y, dy);
+  ActivationFunction::Deriv(x.cols(0, x.n_cols - 1), yRef, dyRef);
+  CheckMatrices(y, yRef, 1e-10);
+  CheckMatrices(dy, dyRef, 1e-8);
+
+  // Single precision uses the same code.
+  const arma::fmat xf = arma::conv_to<arma::fmat>::from(x);
+  arma::fmat yf;
+  ActivationFunction::Fn(xf, yf);
+  CheckMatrices(yf, arma::conv_to<arma::fmat>::from(yRef), 1e-5);
+}
+
+TEST_CASE("FastActivationFunctionsTest", "[ActivationFunctionsTest]")
+{
+  CheckFastActivation<LogisticFunction>();
+  CheckFastActivation<TanhFunction>();
+  CheckFastActivation<SoftplusFunction>();
+  CheckFastActivation<SILUFunction>();
+  CheckFastActivation<GELUFunction>();
+  CheckFastActivation<MishFunction>();
+
+  // The matrix overload of SwishFunction::Fn() needs matching types.
+  arma::mat x(10, 30, arma::fill::randn), y;
+  SwishFunction::Fn(x, y);
+  CheckMatrices(y, arma::mat(x / (1 + arma::exp(-x))), 1e-10);
+
+  // The fast implementations work in place.
+  arma::mat z(x);
+  TanhFunction::Fn(z, z);
+  CheckMatrices(z, arma::mat(arma::tanh(x)), 1e-10);
+}
@@ -0,0 +1,326 @@
+/**
+ * @file tests/ann/dag_network_test.cpp
+ *
+ * Tests the DAGNetwork class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_ENABLE_ANN_SERIALIZATION
+  #define MLPACK_ENABLE_ANN_SERIALIZATION
+#endif
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann/ann.hpp>
+
+#include "../catch.hpp"
+#include "../serialization.hpp"
+#include "../test_catch_tools.hpp"
+#include "ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Build a two-tower network: a Linear and ReLU layer on each tower, and a
+ * Linear and LogSoftMax layer on the concatenated towers.
+ */
+void TwoTowers(DAGNetwork<>& model)
+{
+  const size_t a = model.Add<Linear>(6);
+  const size_t aRelu = model.Add<ReLU>();
+  const size_t b = model.Add<Linear>(4);
+  const size_t bRelu = model.Add<ReLU>();
+  const size_t merge = model.Add<Linear>(3);
+  const size_t out = model.Add<LogSoftMax>();
+  model.Connect(a, aRelu);
+  model.Connect(b, bRelu);
+  model.Connect(aRelu, merge);
+  model.Connect(bRelu, merge);
+  model.Connect(merge, out);
+}
+
+/**
+ * Generate a dataset of three classes, where the class depends on the first
+ * two dimensions.
+ */
+void ThreeClasses(arma::mat& data, arma::mat& labels, const size_t points)
+{
+  data.randu(5, points);
+  labels = arma::conv_to<arma::mat>::from(
+      (data.row(0) > 0.5) + (data.row(1) > 0.5));
+}
+
+/**
+ * Make sure that a chain of layers gives the same results as an FFN with the
+ * same layers and parameters.
+ */
+TEST_CASE("DAGNetworkChainTest", "[DAGNetworkTest]")
+{
+  arma::mat data, labels;
+  ThreeClasses(data, labels, 50);
+
+  FFN<> ffn;
+  ffn.Add<Linear>(8);
+  ffn.Add<Sigmoid>();
+  ffn.Add<Linear>(3);
+  ffn.Add<LogSoftMax>();
+  ffn.Reset(5);
+
+  DAGNetwork<> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  for (size_t i = 0; i < 3; ++i)
+    model.Connect(i, i + 1);
+  model.Reset(5);
+
+  REQUIRE(model.Parameters().n_elem == ffn.Parameters().n_elem);
+  model.Parameters() = ffn.Parameters();
+
+  arma::mat ffnPredictions, predictions;
+  ffn.Predict(data, ffnPredictions);
+  model.Predict(data, predictions, 16);
+  CheckMatrices(predictions, ffnPredictions);
+
+  ffn.ResetData(data, labels);
+  model.ResetData(data, labels);
+  arma::mat ffnGradient, gradient;
+  const double ffnObjective = ffn.EvaluateWithGradient(ffn.Parameters(), 5,
+      ffnGradient, 20);
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 5,
+      gradient, 20);
+
+  REQUIRE(objective == Approx(ffnObjective).epsilon(1e-7));
+  CheckMatrices(gradient, ffnGradient);
+}
+
+/**
+ * Make sure that a two-tower network gives the same results as an FFN where
+ * the towers are held by a Concat layer, with and without parallel branches.
+ */
+TEST_CASE("DAGNetworkTwoTowerTest", "[DAGNetworkTest]")
+{
+  arma::mat data, labels;
+  ThreeClasses(data, labels, 50);
+
+  // The ReLU layers of the towers are the same as one ReLU layer after the
+  // concatenation.
+  FFN<> ffn;
+  Concat* concat = new Concat();
+  concat->Add<Linear>(6);
+  concat->Add<Linear>(4);
+  ffn.Add(concat);
+  ffn.Add<ReLU>();
+  ffn.Add<Linear>(3);
+  ffn.Add<LogSoftMax>();
+  ffn.Reset(5);
+
+  DAGNetwork<> model;
+  TwoTowers(model);
+  model.Reset(5);
+  model.Parameters() = ffn.Parameters();
+
+  ffn.ResetData(data, labels);
+  model.ResetData(data, labels);
+  arma::mat ffnGradient;
+  const double ffnObjective = ffn.EvaluateWithGradient(ffn.Parameters(), 0,
+      ffnGradient, 50);
+
+  for (const size_t threads : { 0, 1, 2 })
+  {
+    model.BranchThreads() = threads;
+    arma::mat gradient;
+    const double objective = model.EvaluateWithGradient(model.Parameters(), 0,
+        gradient, 50);
+
+    REQUIRE(objective == Approx(ffnObjective).epsilon(1e-7));
+    CheckMatrices(gradient, ffnGradient);
+
+    REQUIRE(model.Evaluate(model.Parameters(), 0, 50) ==
+        Approx(ffnObjective).epsilon(1e-7));
+  }
+}
+
+/**
+ * Check the gradient of a network with a residual connection, where the inputs
+ * of a layer are summed, and a layer with two children.
+ */
+TEST_CASE("DAGNetworkSumGradientTest", "[DAGNetworkTest]")
+{
+  // Simple function to evaluate the network and its gradient.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(6, 4)),
+        target(arma::mat("0 1 2 1"))
+    {
+      model.ResetData(input, target);
+
+      // input -> a -> b -> c, and c = tanh(b) + a.
+      const size_t a = model.Add<Linear>(5);
+      const size_t b = model.Add<Linear>(5);
+      const size_t bTanh = model.Add<TanH>();
+      const size_t sum = model.Add<Linear>(3);
+      const size_t out = model.Add<LogSoftMax>();
+      model.Connect(a, b);
+      model.Connect(b, bTanh);
+      model.Connect(bTanh, sum);
+      model.Connect(a, sum);
+      model.SumInputs(sum);
+      model.Connect(sum, out);
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      const double error = model.Evaluate(model.Parameters(), 0, 4);
+      model.Gradient(model.Parameters(), 0, gradient, 4);
+      return error;
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    DAGNetwork<> model;
+    arma::mat input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+  REQUIRE(function.model.Network()[3]->InputDimensions()[0] == 5);
+}
+
+/**
+ * Make sure that a network with several branches gives the same output in
+ * Predict(), where the outputs of the layers share buffers, and in Forward(),
+ * where they are kept for the backward pass.
+ */
+TEST_CASE("DAGNetworkSharedBuffersTest", "[DAGNetworkTest]")
+{
+  // Three towers of different depths on the same input, and a skip connection
+  // from the first tower to the output.
+  DAGNetwork<> model;
+  const size_t a1 = model.Add<Linear>(7);
+  const size_t a2 = model.Add<Sigmoid>();
+  const size_t a3 = model.Add<Linear>(7);
+  const size_t b1 = model.Add<Linear>(3);
+  const size_t b2 = model.Add<LeakyReLU>();
+  const size_t c1 = model.Add<Linear>(9);
+  const size_t c2 = model.Add<TanH>();
+  const size_t c3 = model.Add<Linear>(4);
+  const size_t c4 = model.Add<Sigmoid>();
+  const size_t merge = model.Add<Linear>(5);
+  const size_t out = model.Add<Linear>(2);
+  model.Connect(a1, a2);
+  model.Connect(a2, a3);
+  model.Connect(b1, b2);
+  model.Connect(c1, c2);
+  model.Connect(c2, c3);
+  model.Connect(c3, c4);
+  model.Connect(a3, merge);
+  model.Connect(b2, merge);
+  model.Connect(c4, merge);
+  model.Connect(merge, out);
+  model.Connect(a2, out);
+
+  arma::mat data(4, 37, arma::fill::randu);
+  arma::mat forwardOutput, predictions, serialPredictions;
+  model.Reset(4);
+  model.Forward(data, forwardOutput);
+  model.Predict(data, predictions, 10);
+
+  model.BranchThreads() = 1;
+  model.Predict(data, serialPredictions, 10);
+
+  REQUIRE(model.Network()[out]->InputDimensions()[0] == 12);
+  CheckMatrices(predictions, forwardOutput);
+  CheckMatrices(serialPredictions, forwardOutput);
+}
+
+/**
+ * Train a two-tower network on a simple dataset.
+ */
+TEST_CASE("DAGNetworkTrainTest", "[DAGNetworkTest]")
+{
+  arma::mat data, labels;
+  ThreeClasses(data, labels, 1000);
+
+  DAGNetwork<> model;
+  TwoTowers(model);
+
+  ens::Adam opt(0.01, 32, 0.9, 0.999, 1e-8, 30 * data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+  const arma::urowvec classes = arma::index_max(predictions, 0);
+  const double accuracy = arma::accu(arma::conv_to<arma::mat>::from(classes) ==
+      labels) / (double) data.n_cols;
+  REQUIRE(accuracy > 0.9);
+}
+
+/**
+ * Make sure that a serialized network gives the same predictions.
+ */
+TEST_CASE("DAGNetworkSerializationTest", "[DAGNetworkTest]")
+{
+  arma::mat data, labels;
+  ThreeClasses(data, labels, 100);
+
+  DAGNetwork<> model;
+  TwoTowers(model);
+  ens::Adam opt(0.01, 32, 0.9, 0.999, 1e-8, data.n_cols, -1);
+  model.Train(data, labels, opt);
+
+  DAGNetwork<> xmlModel, jsonModel, binaryModel;
+  xmlModel.Add<Linear>(10); // Layer that will get removed.
+
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(data, predictions);
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+
+  // A copy gives the same predictions too.
+  DAGNetwork<> copy(model);
+  arma::mat copyPredictions;
+  copy.Predict(data, copyPredictions);
+  CheckMatrices(predictions, copyPredictions);
+}
+
+/**
+ * Make sure that invalid graphs are rejected.
+ */
+TEST_CASE("DAGNetworkInvalidGraphTest", "[DAGNetworkTest]")
+{
+  DAGNetwork<> model;
+  const size_t a = model.Add<Linear>(4);
+  const size_t b = model.Add<Linear>(4);
+  const size_t c = model.Add<Linear>(3);
+  model.Connect(a, b);
+  model.Connect(b, c);
+
+  REQUIRE_THROWS_AS(model.Connect(c, a), std::invalid_argument);
+  REQUIRE_THROWS_AS(model.Connect(a, a), std::invalid_argument);
+  REQUIRE_THROWS_AS(model.Connect(a, b), std::invalid_argument);
+  REQUIRE_THROWS_AS(model.Connect(a, 3), std::invalid_argument);
+  REQUIRE_THROWS_AS(model.SumInputs(3), std::invalid_argument);
+
+  // Two layers without children.
+  const size_t d = model.Add<Linear>(3);
+  model.Connect(a, d);
+  REQUIRE_THROWS_AS(model.Reset(5), std::invalid_argument);
+
+  // Outputs of different sizes can't be summed.
+  model.Connect(d, c);
+  model.SumInputs(c);
+  REQUIRE_THROWS_AS(model.Reset(5), std::invalid_argument);
+
+  model.SumInputs(c, false);
+  model.Reset(5);
+  REQUIRE(model.Network()[c]->InputDimensions()[0] == 7);
+}
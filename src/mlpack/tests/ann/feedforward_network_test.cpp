@@ -19,6 +19,7 @@
 
 #include "../catch.hpp"
 #include "../serialization.hpp"
+#include "../thread_communicator.hpp"
 
 using namespace mlpack;
 
@@ -992,3 +993,724 @@ TEST_CASE("RBFNetworkTest", "[FeedForwardNetworkTest]")
   // RBFN neural net with MeanSquaredError.
   TestNetwork<>(model1, dataset, labels1, dataset, labels, 10, 0.1);
 }
+
+/**
+ * Make sure that predictions with a frozen network and workspaces are the same
+ * as the usual predictions, also when several threads share the network.
+ */
+TEST_CASE("FFNFrozenWorkspacePredictTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(20);
+  model.Add<ReLU>();
+  model.Add<Dropout>(0.3);
+  model.Add<Linear>(30);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+
+  // The workspace can only be used once the network is frozen.
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat results;
+  FFNWorkspace<arma::mat> workspace;
+  REQUIRE_THROWS_AS(model.Predict(data, results, workspace),
+      std::logic_error);
+
+  model.Freeze(10);
+  arma::mat predictions;
+  model.Predict(data, predictions, 32);
+
+  model.Predict(data, results, workspace, 32);
+  REQUIRE(workspace.BatchSize() == 32);
+  CheckMatrices(results, predictions);
+
+  // Smaller batches reuse the workspace.
+  model.Predict(data.cols(0, 9), results, workspace, 8);
+  REQUIRE(workspace.BatchSize() == 32);
+  CheckMatrices(results, predictions.cols(0, 9));
+
+  // Each thread uses its own workspace with the shared (const) network.
+  const FFN<NegativeLogLikelihood, RandomInitialization>& sharedModel = model;
+  arma::mat concurrentResults(predictions.n_rows, predictions.n_cols);
+  #pragma omp parallel
+  {
+    FFNWorkspace<arma::mat> threadWorkspace;
+    arma::mat threadResults;
+
+    #pragma omp for
+    for (size_t i = 0; i < 10; ++i)
+    {
+      sharedModel.Predict(data.cols(10 * i, 10 * i + 9), threadResults,
+          threadWorkspace, 4);
+      concurrentResults.cols(10 * i, 10 * i + 9) = threadResults;
+    }
+  }
+
+  CheckMatrices(concurrentResults, predictions);
+}
+
+/**
+ * Make sure that folding BatchNorm layers and fusing activations in the
+ * workspace does not change the predictions.
+ */
+TEST_CASE("FFNFusedWorkspacePredictTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(20);
+  model.Add<BatchNorm>();
+  model.Add<ReLU>();
+  model.Add<Linear>(30);
+  model.Add<BatchNorm>();
+  model.Add<LeakyReLU>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.Freeze(10);
+
+  // Give the BatchNorm layers some statistics to fold.  (The const overload
+  // of Network() does not reset the network.)
+  const FFN<NegativeLogLikelihood, RandomInitialization>& constModel = model;
+  for (size_t i : { 1, 4 })
+  {
+    BatchNorm* batchNorm = dynamic_cast<BatchNorm*>(constModel.Network()[i]);
+    batchNorm->TrainingMean().randn();
+    batchNorm->TrainingVariance().randu();
+    batchNorm->TrainingVariance() += 0.5;
+  }
+
+  arma::mat data(10, 50, arma::fill::randu);
+  arma::mat predictions, results;
+  model.Predict(data, predictions);
+
+  FFNWorkspace<arma::mat> workspace(true);
+  model.Predict(data, results, workspace, 16);
+  REQUIRE(workspace.Layers().size() == 6);
+  CheckMatrices(results, predictions, 1e-6);
+
+  // The same for a convolutional network.
+  FFN<NegativeLogLikelihood, RandomInitialization> convModel;
+  convModel.Add<Convolution>(4, 3, 3);
+  convModel.Add<BatchNorm>();
+  convModel.Add<ELU>();
+  convModel.Add<Linear>(3);
+  convModel.Add<LogSoftMax>();
+  convModel.InputDimensions() = std::vector<size_t>({ 7, 6, 2 });
+  convModel.Freeze();
+
+  const FFN<NegativeLogLikelihood, RandomInitialization>& constConvModel =
+      convModel;
+  BatchNorm* batchNorm =
+      dynamic_cast<BatchNorm*>(constConvModel.Network()[1]);
+  batchNorm->TrainingMean().randn();
+  batchNorm->TrainingVariance().randu();
+  batchNorm->TrainingVariance() += 0.5;
+
+  arma::mat convData(7 * 6 * 2, 20, arma::fill::randu);
+  convModel.Predict(convData, predictions);
+
+  FFNWorkspace<arma::mat> convWorkspace(true);
+  convModel.Predict(convData, results, convWorkspace, 16);
+  REQUIRE(convWorkspace.Layers().size() == 4);
+  CheckMatrices(results, predictions, 1e-6);
+}
+
+/**
+ * Quantize a network with Linear, LinearNoBias and Convolution layers, and make
+ * sure that the predictions are close to the original ones, and the same after
+ * serialization.
+ */
+TEST_CASE("FFNQuantizeTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  model.Add<ReLU>();
+  model.Add<LinearNoBias>(20);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 6, 5, 2 });
+
+  arma::mat data(6 * 5 * 2, 100, arma::fill::randu);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  model.Quantize(data.cols(0, 49), 16);
+
+  // Only the quantized layers had weights.
+  REQUIRE(model.Parameters().n_elem == 0);
+  const FFN<NegativeLogLikelihood, RandomInitialization>& constModel = model;
+  REQUIRE(dynamic_cast<QuantizedConvolution*>(constModel.Network()[0]) !=
+      nullptr);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(constModel.Network()[2]) != nullptr);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(constModel.Network()[4]) != nullptr);
+
+  arma::mat quantizedPredictions;
+  model.Predict(data, quantizedPredictions);
+  REQUIRE(arma::approx_equal(quantizedPredictions, predictions, "absdiff",
+      0.1));
+
+  FFN<NegativeLogLikelihood, RandomInitialization> xmlModel, jsonModel,
+      binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(quantizedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that PruneWeights() zeroes the right fraction of the smallest
+ * weights or blocks, and that SparseLinear layers with any block size give the
+ * same results as the dense weights.
+ */
+TEST_CASE("SparseLinearTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat weight(10, 7, arma::fill::randn);
+  arma::mat pruned(weight);
+  PruneWeights(pruned, 0.6);
+  REQUIRE(arma::accu(pruned == 0) == 42);
+  REQUIRE(arma::abs(weight.elem(arma::find(pruned == 0))).max() <=
+      arma::abs(pruned.elem(arma::find(pruned != 0))).min());
+
+  // With blocks of 3 x 3 there are 4 x 3 blocks; the last ones are smaller.
+  arma::mat blockPruned(weight);
+  PruneWeights(blockPruned, 0.5, 3);
+  size_t zeroBlocks = 0;
+  for (size_t i = 0; i < 10; i += 3)
+  {
+    for (size_t j = 0; j < 7; j += 3)
+    {
+      const arma::mat block = blockPruned.submat(i, j, std::min(i + 2,
+          (size_t) 9), std::min(j + 2, (size_t) 6));
+      if (arma::all(arma::vectorise(block) == 0))
+        ++zeroBlocks;
+      else
+        REQUIRE(arma::all(arma::vectorise(block) != 0));
+    }
+  }
+  REQUIRE(zeroBlocks == 6);
+
+  REQUIRE_THROWS_AS(PruneWeights(pruned, 1.5), std::invalid_argument);
+  REQUIRE_THROWS_AS(PruneWeights(pruned, 0.5, 0), std::invalid_argument);
+
+  const arma::mat bias(10, 1, arma::fill::randn);
+  const arma::mat input(7, 13, arma::fill::randn);
+  for (const size_t blockSize : { 1, 2, 3, 4, 8 })
+  {
+    SparseLinear layer(blockPruned, bias, blockSize);
+    layer.InputDimensions() = std::vector<size_t>({ 7 });
+    REQUIRE(layer.OutputSize() == 10);
+    CheckMatrices(layer.DenseWeight(), blockPruned);
+
+    arma::mat output;
+    layer.Forward(input, output);
+    arma::mat expected = blockPruned * input;
+    expected.each_col() += bias;
+    CheckMatrices(output, expected, 1e-10);
+
+    // Without a bias.
+    SparseLinear noBias(blockPruned, arma::mat(), blockSize);
+    noBias.Forward(input, output);
+    CheckMatrices(output, arma::mat(blockPruned * input), 1e-10);
+  }
+
+  // Only the blocks that were not pruned are stored.
+  SparseLinear blockLayer(blockPruned, bias, 3);
+  REQUIRE(blockLayer.NonZeros() == 6 * 9);
+  SparseLinear elementLayer(blockPruned, bias);
+  REQUIRE(elementLayer.NonZeros() == arma::accu(blockPruned != 0));
+  REQUIRE(elementLayer.RowPointers()[10] == elementLayer.NonZeros());
+}
+
+/**
+ * Prune a network with Linear and LinearNoBias layers, and make sure that the
+ * pruned layers have the pruned weights, and that the predictions are the same
+ * after serialization.
+ */
+TEST_CASE("FFNPruneTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(40);
+  model.Add<ReLU>();
+  model.Add<LinearNoBias>(20);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  // A model pruned with sparsity 0 gives the same predictions.
+  FFN<NegativeLogLikelihood, RandomInitialization> denseModel(model);
+  denseModel.Prune(0.0);
+  arma::mat densePredictions;
+  denseModel.Predict(data, densePredictions);
+  CheckMatrices(densePredictions, predictions, 1e-10);
+
+  const arma::mat weight = arma::reshape(model.Parameters().rows(0, 399), 40,
+      10);
+  model.Prune(0.9, 2);
+
+  // Only the pruned layers had weights.
+  REQUIRE(model.Parameters().n_elem == 0);
+  const FFN<NegativeLogLikelihood, RandomInitialization>& constModel = model;
+  SparseLinear* first = dynamic_cast<SparseLinear*>(constModel.Network()[0]);
+  REQUIRE(first != nullptr);
+  REQUIRE(dynamic_cast<SparseLinear*>(constModel.Network()[2]) != nullptr);
+  REQUIRE(dynamic_cast<SparseLinear*>(constModel.Network()[4]) != nullptr);
+
+  // 90% of the 20 x 5 blocks of the first layer were pruned.
+  REQUIRE(first->BlockSize() == 2);
+  REQUIRE(first->NonZeros() == 10 * 4);
+  arma::mat pruned(weight);
+  PruneWeights(pruned, 0.9, 2);
+  CheckMatrices(first->DenseWeight(), pruned);
+
+  arma::mat prunedPredictions;
+  model.Predict(data, prunedPredictions);
+  REQUIRE(prunedPredictions.n_rows == 3);
+  // There are no weights left to prune.
+  REQUIRE_THROWS_AS(model.Prune(0.5), std::logic_error);
+
+  FFN<NegativeLogLikelihood, RandomInitialization> xmlModel, jsonModel,
+      binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::mat xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(prunedPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that splitting each batch between threads during training gives the
+ * same objective and gradient, and that such a network can be trained.
+ */
+TEST_CASE("FFNTrainingThreadsTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(20);
+  model.Add<ReLU>();
+  model.Add<Linear>(10);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat labels = arma::conv_to<arma::mat>::from(
+      (data.row(0) > 0.5) + (data.row(1) > 0.5));
+  model.Reset(10);
+  model.ResetData(data, labels);
+
+  arma::mat gradient;
+  const double objective = model.EvaluateWithGradient(model.Parameters(), 10,
+      gradient, 37);
+
+  for (size_t threads : { 2, 4, 37 })
+  {
+    model.TrainingThreads() = threads;
+    arma::mat threadGradient;
+    const double threadObjective = model.EvaluateWithGradient(
+        model.Parameters(), 10, threadGradient, 37);
+
+    REQUIRE(threadObjective == Approx(objective).epsilon(1e-7));
+    CheckMatrices(threadGradient, gradient, 1e-5);
+  }
+
+  // Training with threads reduces the objective.
+  model.TrainingThreads() = 4;
+  ens::Adam opt(0.01, 32, 0.9, 0.999, 1e-8, 20 * data.n_cols, -1);
+  const double finalObjective = model.Train(data, labels, opt);
+  REQUIRE(finalObjective < objective * 100 / 37);
+}
+
+/**
+ * Make sure that training on the batches of a DataPipeline, which are prepared
+ * on other threads, gives the same network as training on the whole dataset,
+ * and that the transforms of the pipeline are applied to each batch.
+ */
+TEST_CASE("FFNDataPipelineTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(20);
+  model.Add<ReLU>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.Reset(10);
+
+  arma::mat data(10, 200, arma::fill::randu);
+  data *= 5.0;
+  arma::mat labels = arma::conv_to<arma::mat>::from(
+      (data.row(0) > 2.5) + (data.row(1) > 2.5));
+
+  // Without shuffling, the batches are the same.
+  FFN<NegativeLogLikelihood, RandomInitialization> pipelineModel(model);
+  ens::Adam opt(0.01, 32, 0.9, 0.999, 1e-8, 5 * data.n_cols, -1, false);
+  const double objective = model.Train(data, labels, opt);
+
+  for (size_t prefetch : { 1, 3 })
+  {
+    FFN<NegativeLogLikelihood, RandomInitialization> copy(pipelineModel);
+    DataPipeline<> pipeline(data, labels, prefetch);
+    const double pipelineObjective = copy.Train(pipeline, opt);
+
+    REQUIRE(pipelineObjective == Approx(objective).epsilon(1e-7));
+    CheckMatrices(copy.Parameters(), model.Parameters(), 1e-5);
+  }
+
+  // A pipeline with a scaler gives the network trained on the scaled data.
+  data::StandardScaler scaler;
+  scaler.Fit(data);
+  arma::mat scaledData;
+  scaler.Transform(data, scaledData);
+
+  FFN<NegativeLogLikelihood, RandomInitialization> scaledModel(pipelineModel);
+  const double scaledObjective = scaledModel.Train(scaledData, labels, opt);
+
+  DataPipeline<> scaledPipeline(data.n_cols, [&](const arma::uvec& indices,
+      arma::mat& predictors, arma::mat& responses)
+  {
+    predictors = data.cols(indices);
+    responses = labels.cols(indices);
+  }, 2);
+  scaledPipeline.AddScaler(scaler);
+
+  const double pipelineObjective = pipelineModel.Train(scaledPipeline, opt);
+  REQUIRE(pipelineObjective == Approx(scaledObjective).epsilon(1e-7));
+  CheckMatrices(pipelineModel.Parameters(), scaledModel.Parameters(), 1e-5);
+
+  // With shuffling, the network is still trained.
+  ens::Adam shuffleOpt(0.01, 32, 0.9, 0.999, 1e-8, 20 * data.n_cols, -1);
+  const double shuffledObjective = pipelineModel.Train(scaledPipeline,
+      shuffleOpt);
+  REQUIRE(shuffledObjective < scaledObjective);
+}
+
+/**
+ * Make sure that distributed training gives the same network as training on
+ * the batches made of the batches of every rank, and that every rank ends with
+ * the same parameters.
+ */
+TEST_CASE("FFNTrainDistributedTest", "[FeedForwardNetworkTest]")
+{
+  FFN<NegativeLogLikelihood, RandomInitialization> model;
+  model.Add<Linear>(20);
+  model.Add<ReLU>();
+  model.Add<Linear>(10);
+  model.Add<ReLU>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.Reset(10);
+
+  arma::mat data(10, 200, arma::fill::randu);
+  arma::mat labels = arma::conv_to<arma::mat>::from(
+      (data.row(0) > 0.5) + (data.row(1) > 0.5));
+
+  // With one rank, this is the same as Train().
+  FFN<NegativeLogLikelihood, RandomInitialization> localModel(model);
+  FFN<NegativeLogLikelihood, RandomInitialization> trainedModel(model);
+  ens::Adam opt(0.01, 10, 0.9, 0.999, 1e-8, 5 * data.n_cols, -1, false);
+  const double objective = trainedModel.Train(data, labels, opt);
+
+  LocalCommunicator localComm;
+  const double localObjective = localModel.TrainDistributed(data, labels,
+      localComm, opt);
+  REQUIRE(localObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(localModel.Parameters(), trainedModel.Parameters(), 1e-5);
+
+  // Split the points between 4 ranks.  Batch j of the network trained on one
+  // rank is made of batch j of every rank.
+  const size_t numRanks = 4;
+  const size_t rankPoints = data.n_cols / numRanks;
+  const size_t batchSize = 10;
+  arma::mat batchedData(data.n_rows, data.n_cols);
+  arma::mat batchedLabels(labels.n_rows, labels.n_cols);
+  size_t next = 0;
+  for (size_t j = 0; j < rankPoints; j += batchSize)
+  {
+    for (size_t r = 0; r < numRanks; ++r)
+    {
+      batchedData.cols(next, next + batchSize - 1) =
+          data.cols(r * rankPoints + j, r * rankPoints + j + batchSize - 1);
+      batchedLabels.cols(next, next + batchSize - 1) =
+          labels.cols(r * rankPoints + j, r * rankPoints + j + batchSize - 1);
+      next += batchSize;
+    }
+  }
+
+  FFN<NegativeLogLikelihood, RandomInitialization> batchedModel(model);
+  ens::Adam batchedOpt(0.01, numRanks * batchSize, 0.9, 0.999, 1e-8,
+      5 * data.n_cols, -1, false);
+  const double batchedObjective = batchedModel.Train(batchedData,
+      batchedLabels, batchedOpt);
+
+  // Every rank but the first starts from other parameters, which are replaced
+  // by those of the first rank.
+  std::vector<FFN<NegativeLogLikelihood, RandomInitialization>> rankModels(
+      numRanks, model);
+  for (size_t r = 1; r < numRanks; ++r)
+    rankModels[r].Parameters().randu();
+
+  std::vector<double> rankObjectives(numRanks);
+  RunOnThreads(numRanks, [&](ThreadCommunicator& comm)
+  {
+    const size_t r = comm.Rank();
+    ens::Adam rankOpt(0.01, batchSize, 0.9, 0.999, 1e-8, 5 * rankPoints, -1,
+        false);
+    rankObjectives[r] = rankModels[r].TrainDistributed(
+        data.cols(r * rankPoints, (r + 1) * rankPoints - 1),
+        labels.cols(r * rankPoints, (r + 1) * rankPoints - 1), comm, rankOpt);
+  });
+
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    REQUIRE(rankObjectives[r] == Approx(batchedObjective).epsilon(1e-7));
+    REQUIRE(arma::all(arma::vectorise(rankModels[r].Parameters() ==
+        rankModels[0].Parameters())));
+  }
+  CheckMatrices(rankModels[0].Parameters(), batchedModel.Parameters(), 1e-5);
+}
+
+/**
+ * Make sure that an FFN with 32-bit floats trains, and computes the same
+ * objective and gradient as the same network with doubles, up to the precision
+ * of floats.
+ */
+TEST_CASE("FFNFloatTest", "[FeedForwardNetworkTest]")
+{
+  arma::fmat trainData;
+  if (!data::Load("thyroid_train.csv", trainData))
+    FAIL("Cannot open thyroid_train.csv");
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+  trainLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  arma::fmat testData;
+  if (!data::Load("thyroid_test.csv", testData))
+    FAIL("Cannot load dataset thyroid_test.csv");
+
+  arma::fmat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+  testLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization,
+      arma::fmat> model;
+  model.Add<LinearType<arma::fmat>>(8);
+  model.Add<BatchNormType<arma::fmat>>();
+  model.Add<SigmoidType<arma::fmat>>();
+  model.Add<LinearType<arma::fmat>>(3);
+  model.Add<LogSoftMaxType<arma::fmat>>();
+
+  TestNetwork<arma::fmat>(model, trainData, trainLabels, testData, testLabels,
+      10, 0.1);
+
+  // Now build the same network with doubles and the same parameters.
+  FFN<NegativeLogLikelihood> doubleModel;
+  doubleModel.Add<Linear>(8);
+  doubleModel.Add<BatchNorm>();
+  doubleModel.Add<Sigmoid>();
+  doubleModel.Add<Linear>(3);
+  doubleModel.Add<LogSoftMax>();
+  doubleModel.Reset(trainData.n_rows);
+  doubleModel.Parameters() = ConvTo<arma::mat>::From(model.Parameters());
+
+  const arma::mat doubleData = ConvTo<arma::mat>::From(trainData);
+  const arma::mat doubleLabels = ConvTo<arma::mat>::From(trainLabels);
+  model.SetNetworkMode(true);
+  doubleModel.SetNetworkMode(true);
+  model.ResetData(trainData, trainLabels);
+  doubleModel.ResetData(doubleData, doubleLabels);
+
+  arma::fmat gradient;
+  arma::mat doubleGradient;
+  const float objective = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 50);
+  const double doubleObjective = doubleModel.EvaluateWithGradient(
+      doubleModel.Parameters(), 0, doubleGradient, 50);
+
+  REQUIRE(objective == Approx(doubleObjective).epsilon(1e-4));
+  REQUIRE(arma::approx_equal(ConvTo<arma::mat>::From(gradient),
+      doubleGradient, "both", 1e-4, 1e-3));
+}
+
+/**
+ * Make sure that training with sparse gradients gives the same model as
+ * training with dense gradients, and doesn't change the embeddings of unused
+ * indices.
+ */
+TEST_CASE("FFNTrainSparseTest", "[FeedForwardNetworkTest]")
+{
+  // Only the first 30 of the 50 indices are used.
+  arma::mat data = arma::floor(30 * arma::randu<arma::mat>(3, 40));
+  arma::mat labels = arma::floor(arma::sum(data) / 45);
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Embedding>(50, 4);
+  model.Add<Linear>(2);
+  model.Add<LogSoftMax>();
+  model.Reset(3);
+
+  FFN<NegativeLogLikelihood> sparseModel(model);
+  const arma::mat initialParameters = model.Parameters();
+
+  ens::StandardSGD opt(0.1, 8, 5 * data.n_cols, -1, false);
+  model.Train(data, labels, opt);
+
+  ens::StandardSGD sparseOpt(0.1, 8, 5 * data.n_cols, -1, false);
+  sparseModel.TrainSparse(data, labels, sparseOpt);
+
+  CheckMatrices(model.Parameters(), sparseModel.Parameters());
+
+  // The embeddings are the first parameters.
+  CheckMatrices(sparseModel.Parameters().rows(30 * 4, 50 * 4 - 1),
+      initialParameters.rows(30 * 4, 50 * 4 - 1));
+}
+
+/**
+ * Make sure that the statistics of each layer are recorded when profiling is
+ * enabled, and match the calls made by training.
+ */
+TEST_CASE("FFNProfilingTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 64, arma::fill::randu);
+  arma::mat labels = arma::floor(2 * arma::randu<arma::mat>(1, 64));
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Linear>(8);
+  model.Add<ReLU>();
+  model.Add<Linear>(2);
+  model.Add<LogSoftMax>();
+
+  // Nothing is recorded by default.
+  ens::StandardSGD opt(0.1, 16, 2 * data.n_cols, -1, false);
+  model.Train(data, labels, opt);
+  REQUIRE(model.Profile().size() == 0);
+
+  model.Profiling() = true;
+  model.Train(data, labels, opt);
+
+  const std::vector<LayerProfile>& profile = model.Profile();
+  REQUIRE(profile.size() == 4);
+  for (size_t i = 0; i < profile.size(); ++i)
+  {
+    // Each batch is one call of each pass.
+    REQUIRE(profile[i].forwardCalls >= 8);
+    REQUIRE(profile[i].backwardCalls == 8);
+    REQUIRE(profile[i].gradientCalls == 8);
+    REQUIRE(profile[i].forwardTime >= 0.0);
+    REQUIRE(profile[i].flops > 0.0);
+    REQUIRE(profile[i].outputBytes > 0);
+    REQUIRE(profile[i].deltaBytes > 0);
+  }
+
+  // The first layer does the most work.
+  REQUIRE(profile[0].flops > profile[2].flops);
+  REQUIRE(profile[0].outputBytes == 8 * 16 * sizeof(double));
+  REQUIRE(profile[0].deltaBytes == 10 * 16 * sizeof(double));
+
+  // There is a line for each layer, after the header.
+  std::ostringstream stream;
+  model.PrintProfile(stream);
+  const std::string table = stream.str();
+  REQUIRE(std::count(table.begin(), table.end(), '\n') == 5);
+
+  model.ResetProfile();
+  REQUIRE(model.Profile()[0].forwardCalls == 0);
+}
+
+/**
+ * Make sure that training and predicting with sparse input gives the same
+ * model and predictions as with the same input as a dense matrix, with dense
+ * and sparse gradients.
+ */
+TEST_CASE("FFNSparseInputTest", "[FeedForwardNetworkTest]")
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(500, 60, 0.02);
+  const arma::mat denseData(data);
+  const arma::mat labels = arma::conv_to<arma::mat>::from(
+      arma::sum(denseData.rows(0, 249)) > arma::sum(denseData.rows(250, 499)));
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Linear>(6);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(2);
+  model.Add<LogSoftMax>();
+  model.Reset(500);
+
+  FFN<NegativeLogLikelihood> sparseModel(model);
+  FFN<NegativeLogLikelihood> sparseGradientModel(model);
+  const arma::mat initialParameters = model.Parameters();
+
+  ens::StandardSGD opt(0.1, 8, 5 * data.n_cols, -1, false);
+  model.Train(denseData, labels, opt);
+
+  ens::StandardSGD sparseOpt(0.1, 8, 5 * data.n_cols, -1, false);
+  sparseModel.Train(data, labels, sparseOpt);
+  CheckMatrices(model.Parameters(), sparseModel.Parameters());
+
+  ens::StandardSGD sparseGradientOpt(0.1, 8, 5 * data.n_cols, -1, false);
+  sparseGradientModel.TrainSparse(data, labels, sparseGradientOpt);
+  CheckMatrices(model.Parameters(), sparseGradientModel.Parameters());
+
+  // The weights of the inputs that are never nonzero are not changed; the
+  // weights of the first layer are its first parameters, one column of 6 for
+  // each input.
+  for (size_t i = 0; i < data.n_rows; ++i)
+  {
+    if (arma::any(denseData.row(i) != 0))
+      continue;
+
+    CheckMatrices(sparseGradientModel.Parameters().rows(6 * i, 6 * i + 5),
+        initialParameters.rows(6 * i, 6 * i + 5));
+  }
+
+  arma::mat predictions, sparsePredictions;
+  model.Predict(denseData, predictions, 16);
+  sparseModel.Predict(data, sparsePredictions, 16);
+  CheckMatrices(predictions, sparsePredictions);
+
+  REQUIRE(sparseModel.Evaluate(data, labels) ==
+      Approx(model.Evaluate(denseData, labels)).epsilon(1e-5));
+}
+
+/**
+ * Make sure that a network with sparse input can start with LinearNoBias, and
+ * that other first layers are rejected.
+ */
+TEST_CASE("FFNSparseInputFirstLayerTest", "[FeedForwardNetworkTest]")
+{
+  arma::sp_mat data = arma::sprandu<arma::sp_mat>(200, 30, 0.05);
+  const arma::mat denseData(data);
+  const arma::mat labels = arma::conv_to<arma::mat>::from(
+      arma::sum(denseData.rows(0, 99)) > arma::sum(denseData.rows(100, 199)));
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<LinearNoBias>(2);
+  model.Add<LogSoftMax>();
+  model.Reset(200);
+
+  FFN<NegativeLogLikelihood> sparseModel(model);
+
+  ens::StandardSGD opt(0.1, 4, 3 * data.n_cols, -1, false);
+  model.Train(denseData, labels, opt);
+
+  ens::StandardSGD sparseOpt(0.1, 4, 3 * data.n_cols, -1, false);
+  sparseModel.TrainSparse(data, labels, sparseOpt);
+  CheckMatrices(model.Parameters(), sparseModel.Parameters());
+
+  FFN<NegativeLogLikelihood> badModel;
+  badModel.Add<Sigmoid>();
+  badModel.Add<Linear>(2);
+  badModel.Add<LogSoftMax>();
+
+  arma::mat predictions;
+  REQUIRE_THROWS_AS(badModel.Predict(data, predictions), std::invalid_argument);
+}
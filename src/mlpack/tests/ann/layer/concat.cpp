@@ -225,3 +225,52 @@ TEST_CASE("GradientConcatLayerTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 1e-4);
 }
+
+/**
+ * Make sure that the Concat layer gives the same results for a single point,
+ * where the held layers write directly into the output, as for a batch.
+ */
+TEST_CASE("ConcatSinglePointTest", "[ANNLayerTest]")
+{
+  Concat module;
+  module.Add<Linear>(4);
+  module.Add<TanH>();
+  module.Add<Linear>(3);
+  module.InputDimensions() = std::vector<size_t>({ 5 });
+  module.ComputeOutputDimensions();
+  REQUIRE(module.OutputSize() == 12);
+
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randn);
+  module.SetWeights(weights);
+
+  arma::mat input(5, 3, arma::fill::randn);
+  arma::mat output(module.OutputSize(), 3);
+  module.Forward(input, output);
+
+  arma::mat gy(output.n_rows, output.n_cols, arma::fill::randn);
+  arma::mat g(input.n_rows, input.n_cols);
+  module.Backward(input, output, gy, g);
+
+  arma::mat gradient(module.WeightSize(), 1);
+  module.Gradient(input, gy, gradient);
+
+  arma::mat gradientSum(module.WeightSize(), 1, arma::fill::zeros);
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    arma::mat pointInput = input.col(i);
+    arma::mat pointOutput(module.OutputSize(), 1);
+    module.Forward(pointInput, pointOutput);
+    REQUIRE(arma::approx_equal(pointOutput, output.col(i), "absdiff", 1e-10));
+
+    arma::mat pointGy = gy.col(i);
+    arma::mat pointG(pointInput.n_rows, 1);
+    module.Backward(pointInput, pointOutput, pointGy, pointG);
+    REQUIRE(arma::approx_equal(pointG, g.col(i), "absdiff", 1e-10));
+
+    arma::mat pointGradient(module.WeightSize(), 1);
+    module.Gradient(pointInput, pointGy, pointGradient);
+    gradientSum += pointGradient;
+  }
+
+  REQUIRE(arma::approx_equal(gradientSum, gradient, "absdiff", 1e-10));
+}
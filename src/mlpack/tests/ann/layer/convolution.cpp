@@ -462,3 +462,73 @@ TEST_CASE("NonSquareConvolutionTest", "[ANNLayerTest]")
   arma::mat gradientResult(module1.WeightSize(), 1);
   REQUIRE_NOTHROW(module1.Gradient(data, backwardResult, gradientResult));
 }
+
+/**
+ * Make sure that the convolution layer with the Im2ColConvolution rule gives
+ * the same results as with the naive rule, for the forward and backward passes
+ * and the gradient, with several maps, padding, strides and higher dimensions.
+ */
+TEST_CASE("GEMMConvolutionLayerTest", "[ANNLayerTest]")
+{
+  for (size_t stride = 1; stride <= 2; ++stride)
+  {
+    Convolution naive(4, 3, 2, stride, stride, std::tuple<size_t, size_t>(1, 2),
+        std::tuple<size_t, size_t>(0, 1));
+    GEMMConvolution gemm(4, 3, 2, stride, stride,
+        std::tuple<size_t, size_t>(1, 2), std::tuple<size_t, size_t>(0, 1));
+    naive.InputDimensions() = std::vector<size_t>({ 9, 7, 3, 2 });
+    gemm.InputDimensions() = naive.InputDimensions();
+    naive.ComputeOutputDimensions();
+    gemm.ComputeOutputDimensions();
+    REQUIRE(gemm.OutputDimensions() == naive.OutputDimensions());
+
+    arma::mat weights(naive.WeightSize(), 1, arma::fill::randn);
+    naive.SetWeights(weights);
+    gemm.SetWeights(weights);
+
+    arma::mat input(9 * 7 * 3 * 2, 5, arma::fill::randu);
+    arma::mat naiveOutput(naive.OutputSize(), 5), gemmOutput(gemm.OutputSize(),
+        5);
+    naive.Forward(input, naiveOutput);
+    gemm.Forward(input, gemmOutput);
+    CheckMatrices(gemmOutput, naiveOutput, 1e-6);
+
+    arma::mat gy(naive.OutputSize(), 5, arma::fill::randn);
+    arma::mat naiveDelta(input.n_rows, 5), gemmDelta(input.n_rows, 5);
+    naive.Backward(input, naiveOutput, gy, naiveDelta);
+    gemm.Backward(input, gemmOutput, gy, gemmDelta);
+    CheckMatrices(gemmDelta, naiveDelta, 1e-6);
+
+    arma::mat naiveGradient(naive.WeightSize(), 1);
+    arma::mat gemmGradient(gemm.WeightSize(), 1);
+    naive.Gradient(input, gy, naiveGradient);
+    gemm.Gradient(input, gy, gemmGradient);
+    CheckMatrices(gemmGradient, naiveGradient, 1e-6);
+  }
+}
+
+/**
+ * Make sure that the Winograd transform, which the convolution layer uses for
+ * 3x3 filters with unit strides, gives the same results as a direct
+ * convolution, also when the output has an odd size.
+ */
+TEST_CASE("WinogradConvolutionLayerTest", "[ANNLayerTest]")
+{
+  Convolution winograd(3, 3, 3, 1, 1, 1, 0);
+  GEMMConvolution gemm(3, 3, 3, 1, 1, 1, 0);
+  winograd.InputDimensions() = std::vector<size_t>({ 8, 7, 2 });
+  gemm.InputDimensions() = winograd.InputDimensions();
+  winograd.ComputeOutputDimensions();
+  gemm.ComputeOutputDimensions();
+
+  arma::mat weights(winograd.WeightSize(), 1, arma::fill::randn);
+  winograd.SetWeights(weights);
+  gemm.SetWeights(weights);
+
+  arma::mat input(8 * 7 * 2, 4, arma::fill::randu);
+  arma::mat winogradOutput(winograd.OutputSize(), 4);
+  arma::mat gemmOutput(gemm.OutputSize(), 4);
+  winograd.Forward(input, winogradOutput);
+  gemm.Forward(input, gemmOutput);
+  CheckMatrices(winogradOutput, gemmOutput, 1e-6);
+}
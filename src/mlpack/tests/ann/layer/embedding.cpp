@@ -0,0 +1,91 @@
+/**
+ * @file tests/ann/layer/embedding.cpp
+ *
+ * Tests the Embedding layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the Embedding layer outputs the columns of its table for each
+ * index.
+ */
+TEST_CASE("EmbeddingLayerForwardTest", "[ANNLayerTest]")
+{
+  Embedding module(10, 4);
+  module.InputDimensions() = std::vector<size_t>({ 3 });
+  module.ComputeOutputDimensions();
+  REQUIRE(module.OutputDimensions()[0] == 4);
+  REQUIRE(module.OutputDimensions()[1] == 3);
+
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+  module.SetWeights(weights);
+
+  arma::mat input = { { 0, 9 }, { 3, 3 }, { 7, 0 } };
+  arma::mat output(12, 2);
+  module.Forward(input, output);
+
+  for (size_t i = 0; i < input.n_cols; ++i)
+  {
+    for (size_t j = 0; j < input.n_rows; ++j)
+    {
+      CheckMatrices(output.submat(4 * j, i, 4 * j + 3, i),
+          module.Parameters().col((size_t) input(j, i)));
+    }
+  }
+
+  // No delta is passed through the indices.
+  arma::mat delta(3, 2, arma::fill::randu);
+  module.Backward(input, output, output, delta);
+  REQUIRE(arma::accu(arma::abs(delta)) == 0.0);
+}
+
+/**
+ * Make sure that the sparse gradient of the Embedding layer is the same as its
+ * dense gradient, and only holds the columns for the used indices.
+ */
+TEST_CASE("EmbeddingLayerSparseGradientTest", "[ANNLayerTest]")
+{
+  Embedding module(20, 5);
+  module.InputDimensions() = std::vector<size_t>({ 4 });
+  module.ComputeOutputDimensions();
+
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+  module.SetWeights(weights);
+
+  // Index 2 is used several times so its errors must be summed.
+  arma::mat input = { { 2, 11, 2 }, { 5, 2, 19 }, { 0, 5, 2 }, { 2, 7, 7 } };
+  arma::mat error(20, 3, arma::fill::randn);
+
+  arma::mat gradient(module.WeightSize(), 1);
+  module.Gradient(input, error, gradient);
+
+  arma::sp_mat sparseGradient;
+  module.SparseGradient(input, error, sparseGradient);
+
+  REQUIRE(sparseGradient.n_rows == module.WeightSize());
+  REQUIRE(sparseGradient.n_cols == 1);
+  // Six distinct indices are used.
+  REQUIRE(sparseGradient.n_nonzero == 6 * 5);
+  CheckMatrices(arma::mat(sparseGradient), gradient);
+
+  // Check the gradient of index 2 by hand.
+  arma::vec expected(5, arma::fill::zeros);
+  for (size_t i = 0; i < input.n_cols; ++i)
+    for (size_t j = 0; j < input.n_rows; ++j)
+      if (input(j, i) == 2)
+        expected += error.submat(5 * j, i, 5 * j + 4, i);
+  CheckMatrices(gradient.rows(10, 14), expected);
+}
@@ -0,0 +1,106 @@
+/**
+ * @file tests/ann/layer/fast_lstm.cpp
+ *
+ * Tests the FastLSTM layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * FastLSTM layer numerical gradient test, through several time steps.
+ */
+TEST_CASE("GradientFastLSTMLayerTest", "[ANNLayerTest]")
+{
+  // FastLSTM function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(4, 2, 5)),
+        target(arma::randu(1, 2, 5))
+    {
+      const size_t rho = 5;
+
+      model = RNN<MeanSquaredError, RandomInitialization>(rho);
+      model.ResetData(input, target);
+      model.Add<FastLSTM>(3);
+      model.Add<Linear>(1);
+      model.InputDimensions() = std::vector<size_t>{ 4 };
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      gradient.zeros(model.Parameters().n_elem, 1);
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 2);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    RNN<MeanSquaredError, RandomInitialization> model;
+    arma::cube input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Make sure that the FastLSTM layer computes the LSTM equations in
+ * forward-only mode, where the recurrent state of each step overwrites the
+ * last one.
+ */
+TEST_CASE("FastLSTMForwardTest", "[ANNLayerTest]")
+{
+  const size_t inputSize = 4;
+  const size_t batchSize = 3;
+  const size_t outputSize = 5;
+  const size_t steps = 4;
+
+  FastLSTM l(outputSize);
+  l.InputDimensions() = std::vector<size_t>{ inputSize };
+  l.ComputeOutputDimensions();
+  REQUIRE(l.WeightSize() == 4 * (outputSize * inputSize + outputSize +
+      outputSize * outputSize));
+
+  arma::mat weights(l.WeightSize(), 1, arma::fill::randn);
+  l.SetWeights(weights);
+  l.ClearRecurrentState(0, batchSize);
+
+  arma::cube input(inputSize, batchSize, steps, arma::fill::randu);
+  arma::mat output, h, c;
+  for (size_t t = 0; t < steps; ++t)
+  {
+    l.CurrentStep(t, (t == steps - 1));
+    l.Forward(input.slice(t), output);
+
+    arma::mat gates = l.InputWeight() * input.slice(t) +
+        repmat(l.Bias(), 1, batchSize);
+    if (t > 0)
+      gates += l.RecurrentWeight() * h;
+
+    const arma::mat ifo = 1.0 / (1.0 + exp(-gates.rows(0,
+        3 * outputSize - 1)));
+    const arma::mat i = ifo.rows(0, outputSize - 1);
+    const arma::mat o = ifo.rows(outputSize, 2 * outputSize - 1);
+    const arma::mat f = ifo.rows(2 * outputSize, 3 * outputSize - 1);
+    const arma::mat z = tanh(gates.rows(3 * outputSize, 4 * outputSize - 1));
+
+    if (t > 0)
+      c = f % c + i % z;
+    else
+      c = i % z;
+    h = o % tanh(c);
+
+    REQUIRE(approx_equal(output, h, "both", 1e-5, 1e-5));
+  }
+}
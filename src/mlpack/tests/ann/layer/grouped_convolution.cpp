@@ -224,3 +224,35 @@ TEST_CASE("NonSquareGroupedConvolutionTest", "[ANNLayerTest]")
   arma::mat gradientResult(module1.WeightSize(), 1);
   REQUIRE_NOTHROW(module1.Gradient(data, backwardResult, gradientResult));
 }
+
+/**
+ * Make sure that the Winograd transform, which the grouped convolution layer
+ * uses for 3x3 filters with unit strides, gives the same results as a direct
+ * convolution.
+ */
+TEST_CASE("WinogradGroupedConvolutionLayerTest", "[ANNLayerTest]")
+{
+  using DirectGroupedConvolution = GroupedConvolutionType<
+      Im2ColConvolution<ValidConvolution>,
+      NaiveConvolution<FullConvolution>,
+      NaiveConvolution<ValidConvolution>,
+      arma::mat>;
+
+  GroupedConvolution winograd(4, 3, 3, 2, 1, 1, 1, 1);
+  DirectGroupedConvolution direct(4, 3, 3, 2, 1, 1, 1, 1);
+  winograd.InputDimensions() = std::vector<size_t>({ 7, 6, 4 });
+  direct.InputDimensions() = winograd.InputDimensions();
+  winograd.ComputeOutputDimensions();
+  direct.ComputeOutputDimensions();
+
+  arma::mat weights(winograd.WeightSize(), 1, arma::fill::randn);
+  winograd.SetWeights(weights);
+  direct.SetWeights(weights);
+
+  arma::mat input(7 * 6 * 4, 3, arma::fill::randu);
+  arma::mat winogradOutput(winograd.OutputSize(), 3);
+  arma::mat directOutput(direct.OutputSize(), 3);
+  winograd.Forward(input, winogradOutput);
+  direct.Forward(input, directOutput);
+  CheckMatrices(winogradOutput, directOutput, 1e-6);
+}
@@ -0,0 +1,113 @@
+/**
+ * @file tests/ann/layer/gru.cpp
+ *
+ * Tests the GRU layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/ann.hpp>
+
+#include "../../test_catch_tools.hpp"
+#include "../../catch.hpp"
+#include "../../serialization.hpp"
+#include "../ann_test_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * GRU layer numerical gradient test, through several time steps.
+ */
+TEST_CASE("GradientGRULayerTest", "[ANNLayerTest]")
+{
+  // GRU function gradient instantiation.
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(4, 2, 5)),
+        target(arma::randu(1, 2, 5))
+    {
+      const size_t rho = 5;
+
+      model = RNN<MeanSquaredError, RandomInitialization>(rho);
+      model.ResetData(input, target);
+      model.Add<GRU>(3);
+      model.Add<Linear>(1);
+      model.InputDimensions() = std::vector<size_t>{ 4 };
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      gradient.zeros(model.Parameters().n_elem, 1);
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 2);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    RNN<MeanSquaredError, RandomInitialization> model;
+    arma::cube input, target;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-4);
+}
+
+/**
+ * Make sure that the GRU layer computes the GRU equations in forward-only mode,
+ * where the recurrent state of each step overwrites the last one.
+ */
+TEST_CASE("GRUForwardTest", "[ANNLayerTest]")
+{
+  const size_t inputSize = 4;
+  const size_t batchSize = 3;
+  const size_t outputSize = 5;
+  const size_t steps = 4;
+
+  GRU l(outputSize);
+  l.InputDimensions() = std::vector<size_t>{ inputSize };
+  l.ComputeOutputDimensions();
+
+  // The GRU has 3 gates, and a FastLSTM of the same size has 4.
+  REQUIRE(l.WeightSize() == 3 * (outputSize * inputSize + outputSize +
+      outputSize * outputSize));
+
+  arma::mat weights(l.WeightSize(), 1, arma::fill::randn);
+  l.SetWeights(weights);
+  l.ClearRecurrentState(0, batchSize);
+
+  const arma::mat& w = l.InputWeight();
+  const arma::mat& b = l.Bias();
+  const arma::mat& u = l.RecurrentGateWeight();
+  const arma::mat& uo = l.RecurrentCandidateWeight();
+
+  arma::cube input(inputSize, batchSize, steps, arma::fill::randu);
+  arma::mat output, h;
+  for (size_t t = 0; t < steps; ++t)
+  {
+    l.CurrentStep(t, (t == steps - 1));
+    l.Forward(input.slice(t), output);
+
+    arma::mat zr = w.rows(0, 2 * outputSize - 1) * input.slice(t) +
+        repmat(b.rows(0, 2 * outputSize - 1), 1, batchSize);
+    arma::mat o = w.rows(2 * outputSize, 3 * outputSize - 1) *
+        input.slice(t) + repmat(b.rows(2 * outputSize, 3 * outputSize - 1), 1,
+        batchSize);
+    if (t > 0)
+      zr += u * h;
+
+    zr = 1.0 / (1.0 + exp(-zr));
+    const arma::mat z = zr.rows(0, outputSize - 1);
+    if (t > 0)
+      o += uo * (zr.rows(outputSize, 2 * outputSize - 1) % h);
+    o = tanh(o);
+
+    if (t > 0)
+      h = z % h + (1 - z) % o;
+    else
+      h = (1 - z) % o;
+
+    REQUIRE(approx_equal(output, h, "both", 1e-5, 1e-5));
+  }
+}
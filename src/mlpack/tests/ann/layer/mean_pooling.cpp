@@ -86,3 +86,73 @@ TEST_CASE("MeanPoolingTestCase", "[ANNLayerTest]")
   module2.Backward(input, output2, prevDelta2, delta2);
   REQUIRE(accu(delta2) == Approx(8.1).epsilon(1e-3));
 }
+
+/**
+ * Make sure that the unrolled and the generic kernels of the MeanPooling layer
+ * give the same results as a naive implementation for several window sizes,
+ * with and without `floor`.
+ */
+TEST_CASE("MeanPoolingKernelSizesTest", "[ANNLayerTest]")
+{
+  // Each row holds the kernel width, kernel height, stride width and stride
+  // height.  The last configuration uses the prefix sum backward pass.
+  const arma::umat configurations = { { 2, 2, 2, 2 },
+                                      { 2, 2, 1, 1 },
+                                      { 3, 3, 2, 2 },
+                                      { 3, 3, 1, 1 },
+                                      { 4, 3, 3, 2 },
+                                      { 5, 4, 1, 1 } };
+  const size_t rows = 7, cols = 6, channels = 2, batchSize = 3;
+
+  for (size_t c = 0; c < configurations.n_rows; ++c)
+  {
+    for (const bool floor : { true, false })
+    {
+      const size_t kw = configurations(c, 0), kh = configurations(c, 1);
+      const size_t sw = configurations(c, 2), sh = configurations(c, 3);
+
+      MeanPooling module(kw, kh, sw, sh, floor);
+      module.InputDimensions() = std::vector<size_t>({ rows, cols, channels });
+      module.ComputeOutputDimensions();
+      const size_t outRows = module.OutputDimensions()[0];
+      const size_t outCols = module.OutputDimensions()[1];
+
+      arma::mat input(rows * cols * channels, batchSize, arma::fill::randn);
+      arma::mat output(module.OutputSize(), batchSize);
+      module.Forward(input, output);
+
+      arma::mat gy(output.n_rows, output.n_cols, arma::fill::randn);
+      arma::mat g(input.n_rows, input.n_cols);
+      module.Backward(input, output, gy, g);
+
+      // Compute the same with subviews.
+      arma::cube in(input.memptr(), rows, cols, channels * batchSize);
+      arma::cube out(outRows, outCols, channels * batchSize);
+      arma::cube gyCube(gy.memptr(), outRows, outCols, channels * batchSize);
+      arma::cube gCube(rows, cols, channels * batchSize, arma::fill::zeros);
+      for (size_t s = 0; s < in.n_slices; ++s)
+      {
+        for (size_t j = 0; j < outCols; ++j)
+        {
+          const size_t col = std::min(j * sh, cols - 1);
+          const size_t colEnd = std::min(col + kh, cols) - 1;
+          for (size_t i = 0; i < outRows; ++i)
+          {
+            const size_t row = std::min(i * sw, rows - 1);
+            const size_t rowEnd = std::min(row + kw, rows) - 1;
+            const arma::mat window = in.slice(s).submat(row, col, rowEnd,
+                colEnd);
+            out(i, j, s) = arma::mean(arma::vectorise(window));
+            gCube.slice(s).submat(row, col, rowEnd, colEnd) +=
+                gyCube(i, j, s) / window.n_elem;
+          }
+        }
+      }
+
+      REQUIRE(arma::approx_equal(output, arma::vectorise(out).eval().reshape(
+          output.n_rows, output.n_cols), "absdiff", 1e-10));
+      REQUIRE(arma::approx_equal(g, arma::vectorise(gCube).eval().reshape(
+          g.n_rows, g.n_cols), "absdiff", 1e-10));
+    }
+  }
+}
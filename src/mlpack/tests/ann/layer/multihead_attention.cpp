@@ -233,3 +233,55 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 3e-06);
 }
+
+/**
+ * Make sure that computing the attention scores in blocks of keys gives the
+ * same results as storing all the scores, including with masks and blocks that
+ * don't divide the source sequence length.
+ */
+TEST_CASE("BlockedMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tLen = 6;
+  const size_t sLen = 7;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t bsz = 3;
+
+  arma::mat attnMask = arma::zeros(tLen, sLen);
+  for (size_t i = 0; i < tLen; ++i)
+  {
+    for (size_t j = i + 2; j < sLen; ++j)
+      attnMask(i, j) = std::numeric_limits<double>::lowest();
+  }
+
+  arma::mat keyPaddingMask = arma::zeros(1, sLen);
+  keyPaddingMask(0) = std::numeric_limits<double>::lowest();
+
+  MultiheadAttention module(tLen, numHeads, attnMask, keyPaddingMask);
+  module.InputDimensions() = std::vector<size_t>({ embedDim, 2 * sLen + tLen });
+  module.ComputeOutputDimensions();
+  arma::mat weights(module.WeightSize(), 1, arma::fill::randu);
+  module.SetWeights(weights);
+
+  arma::mat input(embedDim * (2 * sLen + tLen), bsz, arma::fill::randu);
+  arma::mat gy(embedDim * tLen, bsz, arma::fill::randu);
+
+  arma::mat output, g, gradient;
+  module.Forward(input, output);
+  module.Backward(input, output, gy, g);
+  module.Gradient(input, gy, gradient);
+
+  for (const size_t blockSize : { 1, 3, 7, 10 })
+  {
+    module.BlockSize() = blockSize;
+
+    arma::mat blockOutput, blockG, blockGradient;
+    module.Forward(input, blockOutput);
+    module.Backward(input, blockOutput, gy, blockG);
+    module.Gradient(input, gy, blockGradient);
+
+    CheckMatrices(blockOutput, output, 1e-6);
+    CheckMatrices(blockG, g, 1e-6);
+    CheckMatrices(blockGradient, gradient, 1e-6);
+  }
+}
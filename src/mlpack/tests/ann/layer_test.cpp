@@ -30,6 +30,7 @@
 #include "layer/concatenate.cpp"
 #include "layer/c_relu.cpp"
 #include "layer/dropout.cpp"
+#include "layer/embedding.cpp"
 #include "layer/flexible_relu.cpp"
 #include "layer/grouped_convolution.cpp"
 #include "layer/hard_tanh.cpp"
@@ -38,6 +39,8 @@
 #include "layer/linear_no_bias.cpp"
 #include "layer/linear_recurrent.cpp"
 #include "layer/log_softmax.cpp"
+#include "layer/fast_lstm.cpp"
+#include "layer/gru.cpp"
 #include "layer/lstm.cpp"
 #include "layer/max_pooling.cpp"
 #include "layer/mean_pooling.cpp"
@@ -314,6 +314,22 @@ TEST_CASE("LSTMBatchSizeTest", "[RecurrentNetworkTest]")
   BatchSizeTest<LSTM>();
 }
 
+/**
+ * Ensure FastLSTMs work with larger batch sizes.
+ */
+TEST_CASE("FastLSTMBatchSizeTest", "[RecurrentNetworkTest]")
+{
+  BatchSizeTest<FastLSTM>();
+}
+
+/**
+ * Ensure GRUs work with larger batch sizes.
+ */
+TEST_CASE("GRUBatchSizeTest", "[RecurrentNetworkTest]")
+{
+  BatchSizeTest<GRU>();
+}
+
 /**
  * Test that RNN::Train() does not give an error for large rho.
  */
@@ -1106,3 +1122,253 @@ TEST_CASE("RNNRaggedSequenceTest", "[RecurrentNetworkTest]")
   // much data for the ragged sequences.
   REQUIRE(abs(averageError - refAverageError) <= 0.1);
 }
+
+/**
+ * Make sure that predictions with a frozen RNN and per-thread workspaces are
+ * the same as the usual predictions, when several threads share the network.
+ */
+TEST_CASE("RNNConcurrentWorkspacePredictTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+
+  RNN<MeanSquaredError> net(rho);
+  net.Add<LSTM>(8);
+  net.Add<Linear>(1);
+  net.Reset(1);
+
+  arma::cube data(1, 40, rho, arma::fill::randu);
+  arma::urowvec lengths = arma::randi<arma::urowvec>(40, DistrParam(5, 10));
+
+  arma::cube predictions, raggedPredictions;
+  net.Predict(data, predictions, 5);
+  net.Predict(data, raggedPredictions, lengths);
+
+  net.Freeze();
+  const RNN<MeanSquaredError>& sharedNet = net;
+  arma::cube concurrentPredictions(predictions.n_rows, predictions.n_cols,
+      predictions.n_slices);
+  arma::cube concurrentRaggedPredictions(raggedPredictions.n_rows,
+      raggedPredictions.n_cols, raggedPredictions.n_slices);
+  #pragma omp parallel
+  {
+    RNNWorkspace<arma::mat> workspace;
+    arma::cube threadPredictions;
+
+    #pragma omp for
+    for (size_t i = 0; i < 4; ++i)
+    {
+      const arma::cube threadData = data.cols(10 * i, 10 * i + 9);
+      sharedNet.Predict(threadData, threadPredictions, workspace, 5);
+      concurrentPredictions.cols(10 * i, 10 * i + 9) = threadPredictions;
+
+      sharedNet.Predict(threadData, threadPredictions, workspace,
+          arma::urowvec(lengths.cols(10 * i, 10 * i + 9)));
+      concurrentRaggedPredictions.cols(10 * i, 10 * i + 9) =
+          threadPredictions;
+    }
+  }
+
+  CheckMatrices(concurrentPredictions, predictions);
+  for (size_t c = 0; c < 40; ++c)
+  {
+    const arma::cube concurrentSequence = concurrentRaggedPredictions.subcube(
+        0, c, 0, 0, c, lengths[c] - 1);
+    const arma::cube sequence = raggedPredictions.subcube(0, c, 0, 0, c,
+        lengths[c] - 1);
+    CheckMatrices(concurrentSequence, sequence);
+  }
+}
+
+/**
+ * Make sure that BPTT with checkpoints computes the same objective and gradient
+ * as BPTT that keeps the state of every step, with one response per step and
+ * with a single response per sequence.
+ */
+TEST_CASE("RNNCheckpointGradientTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 20;
+  arma::cube data(2, 6, 25, arma::fill::randu);
+
+  for (const bool single : { false, true })
+  {
+    arma::cube responses(3, 6, single ? 1 : 25, arma::fill::randu);
+
+    RNN<MeanSquaredError> net(rho, single);
+    net.Add<LSTM>(3);
+    net.Reset(2);
+    net.ResetData(data, responses);
+
+    arma::mat gradient, checkpointGradient;
+    const double objective = net.EvaluateWithGradient(net.Parameters(), 0,
+        gradient, 6);
+
+    net.CheckpointSteps() = 4;
+    const double checkpointObjective = net.EvaluateWithGradient(
+        net.Parameters(), 0, checkpointGradient, 6);
+
+    REQUIRE(checkpointObjective == Approx(objective).epsilon(1e-7));
+    CheckMatrices(checkpointGradient, gradient, 1e-5);
+  }
+}
+
+/**
+ * Make sure that batches of packed sequences of different lengths give the same
+ * objective, gradient and predictions as ragged sequences taken one at a time,
+ * with one response per step and with a single response per sequence.
+ */
+TEST_CASE("RNNPackedSequenceTest", "[RecurrentNetworkTest]")
+{
+  const size_t numSequences = 7;
+  const size_t maxLength = 20;
+  arma::urowvec lengths = arma::randi<arma::urowvec>(numSequences,
+      DistrParam(5, maxLength));
+  lengths[3] = maxLength;
+  arma::cube data(2, numSequences, maxLength, arma::fill::randu);
+
+  for (const bool single : { false, true })
+  {
+    arma::cube responses(3, numSequences, single ? 1 : maxLength,
+        arma::fill::randu);
+
+    // Pack the sequences without their padding.
+    arma::mat packedData(2, accu(lengths));
+    arma::mat packedResponses(3, single ? numSequences : accu(lengths));
+    size_t offset = 0;
+    for (size_t i = 0; i < numSequences; ++i)
+    {
+      for (size_t t = 0; t < lengths[i]; ++t)
+      {
+        packedData.col(offset + t) = data.slice(t).col(i);
+        if (!single)
+          packedResponses.col(offset + t) = responses.slice(t).col(i);
+      }
+
+      if (single)
+        packedResponses.col(i) = responses.slice(0).col(i);
+      offset += lengths[i];
+    }
+
+    // The losses are summed, so that they don't depend on the batch size.
+    RNN<MeanSquaredError> net(maxLength, single, MeanSquaredError(true));
+    net.Add<LSTM>(4);
+    net.Add<Linear>(3);
+    net.Reset(2);
+
+    net.ResetData(data, responses, lengths);
+    double objective = 0.0;
+    arma::mat gradient(net.Parameters().n_rows, net.Parameters().n_cols,
+        arma::fill::zeros);
+    arma::mat sequenceGradient;
+    for (size_t i = 0; i < numSequences; ++i)
+    {
+      objective += net.EvaluateWithGradient(net.Parameters(), i,
+          sequenceGradient, 1);
+      gradient += sequenceGradient;
+    }
+
+    // Shuffling only reorders sequences of the same length, so the batches
+    // below still hold all the sequences.
+    net.ResetData(packedData, packedResponses, lengths);
+    net.Shuffle();
+    REQUIRE(net.NumFunctions() == numSequences);
+
+    arma::mat packedGradient, batchGradient;
+    const double packedObjective = net.EvaluateWithGradient(net.Parameters(),
+        0, packedGradient, 4);
+    const double packedEvaluate = net.Evaluate(net.Parameters(), 0, 4);
+    REQUIRE(packedEvaluate == Approx(packedObjective).epsilon(1e-7));
+
+    const double batchObjective = packedObjective + net.EvaluateWithGradient(
+        net.Parameters(), 4, batchGradient, numSequences - 4);
+    packedGradient += batchGradient;
+
+    REQUIRE(batchObjective == Approx(objective).epsilon(1e-7));
+    CheckMatrices(packedGradient, gradient, 1e-5);
+
+    // The predictions of the valid steps must match.
+    arma::cube prediction;
+    arma::mat packedPrediction;
+    net.Predict(data, prediction, lengths);
+    net.Predict(packedData, packedPrediction, lengths, 3);
+    REQUIRE(packedPrediction.n_cols == packedResponses.n_cols);
+
+    offset = 0;
+    for (size_t i = 0; i < numSequences; ++i)
+    {
+      if (single)
+      {
+        CheckMatrices(packedPrediction.col(i),
+            arma::mat(prediction.slice(0).col(i)));
+      }
+      else
+      {
+        for (size_t t = 0; t < lengths[i]; ++t)
+        {
+          CheckMatrices(packedPrediction.col(offset + t),
+              arma::mat(prediction.slice(t).col(i)));
+        }
+      }
+      offset += lengths[i];
+    }
+
+    // Training with batches of packed sequences must work.
+    RMSProp opt(0.003, 4, 0.99, 1e-08, 5 * numSequences, 1e-5);
+    const double trainedObjective = net.Train(packedData, packedResponses,
+        lengths, opt);
+    REQUIRE(std::isfinite(trainedObjective));
+  }
+
+  // The lengths must match the packed data.
+  RNN<MeanSquaredError> net(maxLength);
+  net.Add<LSTM>(4);
+  arma::mat packedData(2, accu(lengths) + 1, arma::fill::randu);
+  arma::mat packedPrediction;
+  REQUIRE_THROWS_AS(net.Predict(packedData, packedPrediction, lengths),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that an RNN with 32-bit floats computes the same objective and
+ * gradient as the same network with doubles, up to the precision of floats.
+ */
+TEST_CASE("RNNFloatTest", "[RecurrentNetworkTest]")
+{
+  const size_t rho = 10;
+  arma::fcube data(2, 8, rho, arma::fill::randu);
+  arma::fcube responses(1, 8, rho, arma::fill::randu);
+
+  RNN<MeanSquaredErrorType<arma::fmat>, RandomInitialization, arma::fmat>
+      net(rho);
+  net.Add<LSTMType<arma::fmat>>(4);
+  net.Add<LinearType<arma::fmat>>(1);
+  net.Reset(2);
+
+  RNN<MeanSquaredError> doubleNet(rho);
+  doubleNet.Add<LSTM>(4);
+  doubleNet.Add<Linear>(1);
+  doubleNet.Reset(2);
+  doubleNet.Parameters() = ConvTo<arma::mat>::From(net.Parameters());
+
+  net.ResetData(data, responses);
+  doubleNet.ResetData(ConvTo<arma::cube>::From(data),
+      ConvTo<arma::cube>::From(responses));
+
+  arma::fmat gradient;
+  arma::mat doubleGradient;
+  const float objective = net.EvaluateWithGradient(net.Parameters(), 0,
+      gradient, 8);
+  const double doubleObjective = doubleNet.EvaluateWithGradient(
+      doubleNet.Parameters(), 0, doubleGradient, 8);
+
+  REQUIRE(objective == Approx(doubleObjective).epsilon(1e-4));
+  REQUIRE(arma::approx_equal(ConvTo<arma::mat>::From(gradient),
+      doubleGradient, "both", 1e-4, 1e-3));
+
+  // Training with floats should work too.
+  ens::Adam opt(0.01, 8, 0.9, 0.999, 1e-8, 8 * 20);
+  net.Train(data, responses, opt);
+  arma::fcube predictions;
+  net.Predict(data, predictions);
+  REQUIRE(predictions.n_slices == rho);
+  REQUIRE(predictions.is_finite());
+}
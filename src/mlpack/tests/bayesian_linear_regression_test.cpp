@@ -313,3 +313,51 @@ TEMPLATE_TEST_CASE("BayesianLinearRegressionTrainVariantTest",
   REQUIRE(blr5.MaxIterations() == 110);
   REQUIRE(blr5.Tolerance() == 1e-3);
 }
+
+// Make sure that training on statistics accumulated over chunks of the data
+// gives the same model as training on all of the data at once.
+TEST_CASE("BayesianLinearRegressionNormalEquationsTest",
+          "[BayesianLinearRegressionTest]")
+{
+  arma::mat matX;
+  arma::rowvec y;
+  GenerateProblem(matX, y, 3000, 8, 0.5);
+  matX += 3.0;
+  y += 2.0;
+
+  NormalEquations<> stats;
+  for (size_t i = 0; i < 3000; i += 1300)
+  {
+    const size_t end = std::min(i + 1300, (size_t) 3000) - 1;
+    stats.Update(matX.cols(i, end), y.subvec(i, end));
+  }
+
+  for (size_t config = 0; config < 4; ++config)
+  {
+    const bool centerData = (config & 1);
+    const bool scaleData = (config & 2);
+
+    // Both models are trained to convergence, so that they do not stop at
+    // different iterations.
+    BayesianLinearRegression<> blr(centerData, scaleData, 200, 1e-12);
+    const double rmse = blr.Train(matX, y);
+    BayesianLinearRegression<> streamBlr(centerData, scaleData, 200, 1e-12);
+    const double streamRmse = streamBlr.Train(stats);
+
+    REQUIRE(arma::approx_equal(streamBlr.Omega(), blr.Omega(), "reldiff",
+        1e-6));
+    REQUIRE(streamBlr.Alpha() == Approx(blr.Alpha()).epsilon(1e-6));
+    REQUIRE(streamBlr.Beta() == Approx(blr.Beta()).epsilon(1e-6));
+    REQUIRE(streamBlr.ResponsesOffset() ==
+        Approx(blr.ResponsesOffset()).epsilon(1e-8));
+    REQUIRE(streamRmse == Approx(rmse).epsilon(1e-6));
+
+    // The predictions (and their uncertainties) are the same.
+    arma::rowvec predictions, streamPredictions, stds, streamStds;
+    blr.Predict(matX, predictions, stds);
+    streamBlr.Predict(matX, streamPredictions, streamStds);
+    REQUIRE(arma::approx_equal(streamPredictions, predictions, "absdiff",
+        1e-6));
+    REQUIRE(arma::approx_equal(streamStds, stds, "reldiff", 1e-6));
+  }
+}
@@ -501,7 +501,7 @@ void Serialization()
 TEMPLATE_TEST_CASE("CFGetRecommendationsAllUsersTest", "[CFTest]",
     RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
     SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-    QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   GetRecommendationsAllUsers<TestType>();
 }
@@ -513,7 +513,7 @@ TEMPLATE_TEST_CASE("CFGetRecommendationsAllUsersTest", "[CFTest]",
 TEMPLATE_TEST_CASE("CFGetRecommendationsQueriedUsersTest", "[CFTest]",
   RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
   SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-  QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+  QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   GetRecommendationsQueriedUser<TestType>();
 }
@@ -558,7 +558,7 @@ TEMPLATE_TEST_CASE("CFPredictTest", "[CFTest]",
 TEMPLATE_TEST_CASE("CFBatchPredictTest", "[CFTest]",
     RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
     SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, SVDPlusPlusPolicy,
-    QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   BatchPredict<TestType>();
 }
@@ -569,7 +569,7 @@ TEMPLATE_TEST_CASE("CFBatchPredictTest", "[CFTest]",
  */
 TEMPLATE_TEST_CASE("TrainTest_1", "[CFTest]",
     RandomizedSVDPolicy, BatchSVDPolicy, NMFPolicy, SVDCompletePolicy,
-    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   TestType decomposition;
   Train(decomposition);
@@ -593,7 +593,7 @@ TEMPLATE_TEST_CASE("TrainTest_2", "[CFTest]",
 TEMPLATE_TEST_CASE("EmptyConstructorTrainTest", "[CFTest]",
   RandomizedSVDPolicy, RegSVDPolicy, BatchSVDPolicy, NMFPolicy,
   SVDCompletePolicy, SVDIncompletePolicy, BiasSVDPolicy, QUIC_SVDPolicy,
-  BlockKrylovSVDPolicy)
+  BlockKrylovSVDPolicy, ALSPolicy)
 {
   EmptyConstructorTrain<TestType>();
 }
@@ -603,7 +603,7 @@ TEMPLATE_TEST_CASE("EmptyConstructorTrainTest", "[CFTest]",
  */
 TEMPLATE_TEST_CASE("SerializationTest", "[CFTest]",
     RandomizedSVDPolicy, BatchSVDPolicy, NMFPolicy, SVDCompletePolicy,
-    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy)
+    SVDIncompletePolicy, QUIC_SVDPolicy, BlockKrylovSVDPolicy, ALSPolicy)
 {
   Serialization<TestType>();
 }
@@ -721,3 +721,303 @@ TEST_CASE("CFPredictRegressionInterpolation", "[CFTest]")
             EuclideanSearch,
             RegressionInterpolation>(2.2);
 }
+
+/**
+ * Make sure that ALSPolicy predicts higher preferences for the unrated items
+ * of the group of items that a user's ratings come from.
+ */
+TEST_CASE("ALSPolicyImplicitPreferenceTest", "[CFTest]")
+{
+  // There are two groups of 20 users and 20 items, and each user rates 8
+  // random items of its own group.
+  arma::sp_mat ratings(40, 40);
+  for (size_t user = 0; user < 40; ++user)
+  {
+    const size_t group = user / 20;
+    const arma::uvec items = arma::randperm(20, 8);
+    for (size_t i = 0; i < items.n_elem; ++i)
+      ratings(20 * group + items[i], user) = RandInt(1, 6);
+  }
+
+  ALSPolicy als;
+  als.Apply(arma::mat(), ratings, 2, 15, 1e-5, true);
+
+  REQUIRE(als.W().n_rows == 40);
+  REQUIRE(als.W().n_cols == 2);
+  REQUIRE(als.H().n_rows == 2);
+  REQUIRE(als.H().n_cols == 40);
+
+  for (size_t user = 0; user < 40; ++user)
+  {
+    const size_t group = user / 20;
+    arma::vec predictions;
+    als.GetRatingOfUser(user, predictions);
+
+    double ownGroup = 0.0, otherGroup = 0.0;
+    for (size_t item = 0; item < 20; ++item)
+    {
+      ownGroup += predictions[20 * group + item];
+      otherGroup += predictions[20 * (1 - group) + item];
+    }
+
+    REQUIRE(ownGroup > otherGroup);
+  }
+}
+
+/**
+ * Make sure that ItemFactorIndex recommends the unrated items with the largest
+ * predicted ratings, including item biases and item mean normalization.
+ */
+TEMPLATE_TEST_CASE("ItemFactorIndexTest", "[CFTest]", RegSVDPolicy,
+    BiasSVDPolicy, SVDPlusPlusPolicy)
+{
+  using CFModelType = CFType<TestType, ItemMeanNormalization>;
+
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  TestType decomposition;
+  CFModelType c(dataset, decomposition, 5, 5, 10);
+  ItemFactorIndex<CFModelType> index(c);
+
+  const size_t numRecs = 10;
+  arma::Col<size_t> users = { 0, 1, 2, 10, 50 };
+  arma::Mat<size_t> recommendations;
+  index.GetRecommendations(numRecs, recommendations, users);
+
+  REQUIRE(recommendations.n_rows == numRecs);
+  REQUIRE(recommendations.n_cols == users.n_elem);
+
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    // Compute the predicted rating of every unrated item by brute force.
+    arma::vec ratings(cleanedData.n_rows);
+    for (size_t item = 0; item < cleanedData.n_rows; ++item)
+    {
+      ratings[item] = (cleanedData(item, users(i)) != 0.0) ? -DBL_MAX :
+          c.Normalization().Denormalize(users(i), item,
+          c.Decomposition().GetRating(users(i), item));
+    }
+    const arma::vec sorted = arma::sort(ratings, "descend");
+
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      const size_t item = recommendations(j, i);
+      REQUIRE(item < cleanedData.n_rows);
+      REQUIRE(cleanedData(item, users(i)) == 0.0);
+      REQUIRE(ratings[item] == Approx(sorted[j]).epsilon(1e-5));
+    }
+  }
+}
+
+/**
+ * Make sure that the blocked and parallel GetRecommendations() and Predict()
+ * agree with the predictions for single user/item combinations.
+ */
+TEMPLATE_TEST_CASE("CFBlockedRecommendationsTest", "[CFTest]", RegSVDPolicy,
+    BiasSVDPolicy, SVDPlusPlusPolicy, NMFPolicy)
+{
+  using CFModelType = CFType<TestType, ItemMeanNormalization>;
+
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  TestType decomposition;
+  CFModelType c(dataset, decomposition, 5, 5, 10);
+
+  // Generate recommendations for all users, which spans several blocks.
+  const size_t numRecs = 10;
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(numRecs, recommendations);
+
+  const arma::sp_mat& cleanedData = c.CleanedData();
+  REQUIRE(recommendations.n_rows == numRecs);
+  REQUIRE(recommendations.n_cols == cleanedData.n_cols);
+
+  arma::Col<size_t> users = { 0, 1, 2, 70, (size_t) cleanedData.n_cols - 1 };
+  for (size_t i = 0; i < users.n_elem; ++i)
+  {
+    // Predict the rating of every item for the user at once.
+    arma::Mat<size_t> combinations(2, cleanedData.n_rows);
+    combinations.row(0).fill(users(i));
+    combinations.row(1) = arma::linspace<arma::Row<size_t>>(0,
+        cleanedData.n_rows - 1, cleanedData.n_rows);
+    arma::vec predictions;
+    c.Predict(combinations, predictions);
+
+    for (size_t item = 0; item < cleanedData.n_rows; item += 97)
+    {
+      REQUIRE(predictions[item] ==
+          Approx(c.Predict(users(i), item)).epsilon(1e-5));
+    }
+
+    for (size_t item = 0; item < cleanedData.n_rows; ++item)
+    {
+      if (cleanedData(item, users(i)) != 0.0)
+        predictions[item] = -DBL_MAX;
+    }
+    const arma::vec sorted = arma::sort(predictions, "descend");
+
+    for (size_t j = 0; j < numRecs; ++j)
+    {
+      const size_t item = recommendations(j, users(i));
+      REQUIRE(item < cleanedData.n_rows);
+      REQUIRE(cleanedData(item, users(i)) == 0.0);
+      REQUIRE(predictions[item] == Approx(sorted[j]).epsilon(1e-5));
+    }
+  }
+}
+
+/**
+ * Make sure that a user and an item held out of training can be folded into
+ * the model, and that their factors fit their ratings.
+ */
+TEMPLATE_TEST_CASE("CFFoldInTest", "[CFTest]", RegSVDPolicy, BiasSVDPolicy,
+    NMFPolicy)
+{
+  using CFModelType = CFType<TestType, ItemMeanNormalization>;
+
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  // Hold out the ratings of the last user and of the last item.
+  const double lastUser = max(dataset.row(0));
+  const double lastItem = max(dataset.row(1));
+  const arma::mat trainData = dataset.cols(arma::find(
+      (dataset.row(0) != lastUser) % (dataset.row(1) != lastItem)));
+
+  TestType decomposition;
+  CFModelType c(trainData, decomposition, 5, 5, 10);
+  const size_t numUsers = c.CleanedData().n_cols;
+  const size_t numItems = c.CleanedData().n_rows;
+
+  // Only keep the ratings of known items and users.
+  const arma::mat userData = dataset.cols(arma::find(
+      (dataset.row(0) == lastUser) % (dataset.row(1) < (double) numItems)));
+  const arma::mat itemData = dataset.cols(arma::find(
+      (dataset.row(1) == lastItem) % (dataset.row(0) < (double) numUsers)));
+  REQUIRE(userData.n_cols > 0);
+  REQUIRE(itemData.n_cols > 0);
+
+  // Compute the RMSE of the model's own factors on the given ratings, with
+  // the ratings of the new user or item replaced by newId.
+  auto rmse = [&](const arma::mat& data, const size_t row, const size_t newId,
+                  const bool useFactors)
+  {
+    double error = 0.0;
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      const size_t user = (row == 0) ? newId : (size_t) data(0, i);
+      const size_t item = (row == 1) ? newId : (size_t) data(1, i);
+      const double rating = useFactors ?
+          c.Decomposition().GetRating(user, item) : 0.0;
+      error += std::pow(c.Normalization().Denormalize(user, item, rating) -
+          data(2, i), 2.0);
+    }
+    return std::sqrt(error / data.n_cols);
+  };
+
+  const size_t user = c.FoldInUser(userData.rows(1, 2));
+  REQUIRE(user == numUsers);
+  REQUIRE(c.CleanedData().n_cols == numUsers + 1);
+  for (size_t i = 0; i < userData.n_cols; ++i)
+    REQUIRE(c.CleanedData()((size_t) userData(1, i), user) != 0.0);
+  const double userError = rmse(userData, 0, user, true);
+  REQUIRE(userError < rmse(userData, 0, user, false));
+
+  arma::mat itemRatings(2, itemData.n_cols);
+  itemRatings.row(0) = itemData.row(0);
+  itemRatings.row(1) = itemData.row(2);
+  const size_t item = c.FoldInItem(itemRatings);
+  REQUIRE(item == numItems);
+  REQUIRE(c.CleanedData().n_rows == numItems + 1);
+  const double itemError = rmse(itemData, 1, item, true);
+  REQUIRE(itemError < rmse(itemData, 1, item, false));
+
+  // The new user can be given recommendations right away.
+  arma::Mat<size_t> recommendations;
+  c.GetRecommendations(10, recommendations, arma::Col<size_t>({ user }));
+  for (size_t j = 0; j < recommendations.n_rows; ++j)
+  {
+    REQUIRE(recommendations(j) < numItems + 1);
+    REQUIRE(c.CleanedData()(recommendations(j), user) == 0.0);
+  }
+
+  // The new user did not rate the new item, so refining both of them gives
+  // the new user the same factor again.
+  c.Refine(arma::Col<size_t>({ user }), arma::Col<size_t>({ item }), 2);
+  REQUIRE(rmse(userData, 0, user, true) == Approx(userError).epsilon(1e-5));
+  REQUIRE(rmse(itemData, 1, item, true) < rmse(itemData, 1, item, false));
+}
+
+/**
+ * Make sure that folding in is refused by decompositions that do not support
+ * it.
+ */
+TEST_CASE("CFFoldInUnsupportedTest", "[CFTest]")
+{
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  SVDPlusPlusPolicy decomposition;
+  CFType<SVDPlusPlusPolicy> c(dataset, decomposition, 5, 5, 10);
+
+  const arma::mat ratings = { { 0.0, 1.0 }, { 3.0, 4.0 } };
+  REQUIRE_THROWS_AS(c.FoldInUser(ratings), std::invalid_argument);
+  REQUIRE_THROWS_AS(c.FoldInItem(ratings), std::invalid_argument);
+  REQUIRE_THROWS_AS(c.Refine(arma::Col<size_t>({ 0 }),
+      arma::Col<size_t>({ 0 })), std::invalid_argument);
+}
+
+/**
+ * Make sure that the cached neighborhoods give the same recommendations and
+ * predictions as searching, and that they are serialized with the model.
+ */
+TEST_CASE("CFNeighborhoodCacheTest", "[CFTest]")
+{
+  arma::mat dataset;
+  arma::mat savedCols;
+  GetDatasets(dataset, savedCols);
+
+  RegSVDPolicy decomposition;
+  CFType<RegSVDPolicy> c(dataset, decomposition, 5, 5, 10);
+
+  arma::Mat<size_t> recommendations, cachedRecommendations;
+  c.GetRecommendations<CosineSearch>(10, recommendations);
+  arma::Mat<size_t> combinations(2, 300);
+  combinations.row(0) = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, c.CleanedData().n_cols - 1));
+  combinations.row(1) = arma::randi<arma::Row<size_t>>(300,
+      arma::distr_param(0, c.CleanedData().n_rows - 1));
+  arma::vec predictions, cachedPredictions;
+  c.Predict<CosineSearch, SimilarityInterpolation>(combinations, predictions);
+
+  c.CacheNeighborhoods<CosineSearch>();
+  REQUIRE(c.CachedNeighbors().n_rows == 5);
+  REQUIRE(c.CachedNeighbors().n_cols == c.CleanedData().n_cols);
+  REQUIRE(c.CachedSimilarities().n_cols == c.CleanedData().n_cols);
+
+  c.GetRecommendations<CosineSearch>(10, cachedRecommendations);
+  REQUIRE(arma::accu(recommendations != cachedRecommendations) == 0);
+  c.Predict<CosineSearch, SimilarityInterpolation>(combinations,
+      cachedPredictions);
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+    REQUIRE(cachedPredictions[i] == Approx(predictions[i]).epsilon(1e-4));
+
+  CFType<RegSVDPolicy> cXml, cText, cBinary;
+  SerializeObjectAll(c, cXml, cText, cBinary);
+  REQUIRE(arma::accu(c.CachedNeighbors() != cXml.CachedNeighbors()) == 0);
+  REQUIRE(arma::accu(c.CachedNeighbors() != cText.CachedNeighbors()) == 0);
+  REQUIRE(arma::accu(c.CachedNeighbors() != cBinary.CachedNeighbors()) == 0);
+  CheckMatrices(c.CachedSimilarities(), cXml.CachedSimilarities(),
+      cText.CachedSimilarities(), cBinary.CachedSimilarities());
+
+  // Retraining discards the cache.
+  c.Train(dataset, decomposition, 10);
+  REQUIRE(c.CachedNeighbors().n_elem == 0);
+}
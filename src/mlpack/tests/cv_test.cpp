@@ -631,6 +631,71 @@ TEST_CASE("KFoldCVWithWeightedLRTest", "[CVTest]")
   REQUIRE((1.0 - mse) == Approx(1.0).epsilon(1e-7));
 }
 
+/**
+ * Make sure that training the folds in parallel gives the same result and the
+ * same last model as training them serially.
+ */
+TEST_CASE("KFoldCVParallelFoldsTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 203);
+  arma::rowvec responses = arma::randu<arma::rowvec>(203);
+  arma::rowvec weights = arma::randu<arma::rowvec>(203);
+
+  KFoldCV<LinearRegression<>, MSE> cv(10, data, responses, weights, false);
+  const double serialMSE = cv.Evaluate(0.01);
+  const arma::vec serialParameters = cv.Model().Parameters();
+
+  for (size_t threads : { 0, 3, 10 })
+  {
+    cv.FoldThreads() = threads;
+    REQUIRE(cv.Evaluate(0.01) == Approx(serialMSE).epsilon(1e-10));
+    REQUIRE(arma::approx_equal(cv.Model().Parameters(), serialParameters,
+        "absdiff", 1e-10));
+  }
+}
+
+/**
+ * Test that PartialEvaluate() of KFoldCV and SimpleCV evaluates on the
+ * expected part of the data, and leaves Model() alone.
+ */
+TEST_CASE("CVPartialEvaluateTest", "[CVTest]")
+{
+  arma::mat data = arma::randu<arma::mat>(4, 200);
+  arma::rowvec responses = arma::randu<arma::rowvec>(200);
+
+  KFoldCV<LinearRegression<>, MSE> kfcv(10, data, responses, false);
+  const double kfcvMSE = kfcv.Evaluate(0.01);
+  const arma::vec kfcvParameters = kfcv.Model().Parameters();
+
+  std::unique_ptr<LinearRegression<>> model;
+  REQUIRE(kfcv.PartialEvaluate(1.0, model, 0.01) ==
+      Approx(kfcvMSE).epsilon(1e-10));
+  REQUIRE(arma::approx_equal(model->Parameters(), kfcvParameters, "absdiff",
+      1e-10));
+  REQUIRE(std::isfinite(kfcv.PartialEvaluate(0.25, model, 0.01)));
+  REQUIRE_THROWS_AS(kfcv.PartialEvaluate(0.0, model, 0.01),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(kfcv.PartialEvaluate(1.5, model, 0.01),
+      std::invalid_argument);
+  REQUIRE(arma::approx_equal(kfcv.Model().Parameters(), kfcvParameters,
+      "absdiff", 1e-10));
+
+  // With a budget of 0.5, SimpleCV trains on the first 80 of the 160
+  // training points.
+  SimpleCV<LinearRegression<>, MSE> cv(0.2, data, responses);
+  const double simpleMSE = cv.Evaluate(0.01);
+  REQUIRE(cv.PartialEvaluate(1.0, model, 0.01) ==
+      Approx(simpleMSE).epsilon(1e-10));
+
+  LinearRegression<> lr(data.cols(0, 79), responses.cols(0, 79), 0.01);
+  const double halfMSE = MSE::Evaluate(lr, data.cols(160, 199),
+      responses.cols(160, 199));
+  REQUIRE(cv.PartialEvaluate(0.5, model, 0.01) ==
+      Approx(halfMSE).epsilon(1e-10));
+  REQUIRE(arma::approx_equal(model->Parameters(), lr.Parameters(), "absdiff",
+      1e-10));
+}
+
 /**
  * Test k-fold cross-validation with decision trees constructed in multiple
  * ways.
@@ -856,3 +921,50 @@ TEST_CASE("SilhouetteScoreTest", "[CVTest]")
   double silhouetteScore = SilhouetteScore::Overall(X, labels, metric);
   REQUIRE(silhouetteScore == Approx(0.1121684822489150).epsilon(1e-7));
 }
+
+/**
+ * Test that the blocked silhouette scores match the ones computed from the
+ * pairwise distances, and that the sampled estimate is consistent with them.
+ */
+TEST_CASE("SilhouetteScoreBlockedAndSampledTest", "[CVTest]")
+{
+  // Three clusters, with labels that are not contiguous; there are more points
+  // than one block.
+  arma::mat X = arma::randn<arma::mat>(3, 500);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < 500; ++i)
+  {
+    labels[i] = 3 * (i % 3) + 1;
+    X.col(i) += 4.0 * labels[i];
+  }
+
+  EuclideanDistance metric;
+  const arma::mat distances = PairwiseDistances(X, metric);
+  const arma::rowvec expected = SilhouetteScore::SamplesScore(distances,
+      labels);
+  const arma::rowvec actual = SilhouetteScore::SamplesScore(X, labels,
+      metric);
+  REQUIRE(arma::approx_equal(actual, expected, "absdiff", 1e-10));
+
+  const double overall = SilhouetteScore::Overall(X, labels, metric);
+  REQUIRE(overall == Approx(arma::mean(expected)).epsilon(1e-10));
+
+  // With all points, the estimate is exact.
+  double lower, upper;
+  double estimate = SilhouetteScore::Sampled(X, labels, metric, 1000, lower,
+      upper);
+  REQUIRE(estimate == Approx(overall).epsilon(1e-10));
+  REQUIRE(lower == estimate);
+  REQUIRE(upper == estimate);
+
+  // With a sample, the (wide) interval should contain the exact score.
+  estimate = SilhouetteScore::Sampled(X, labels, metric, 100, lower, upper,
+      0.9999);
+  REQUIRE(lower < estimate);
+  REQUIRE(upper > estimate);
+  REQUIRE(lower <= overall);
+  REQUIRE(upper >= overall);
+
+  REQUIRE_THROWS_AS(SilhouetteScore::Sampled(X, labels, metric, 0, lower,
+      upper), std::invalid_argument);
+}
@@ -17,6 +17,36 @@
 
 using namespace mlpack;
 
+/**
+ * Check that two sets of assignments give the same clusters and noise points,
+ * possibly with different cluster labels.
+ */
+void CheckSameClusters(const arma::Row<size_t>& assignments,
+                       const arma::Row<size_t>& otherAssignments,
+                       const size_t clusters)
+{
+  REQUIRE(otherAssignments.n_elem == assignments.n_elem);
+
+  arma::Col<size_t> labelMap(clusters);
+  labelMap.fill(SIZE_MAX);
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+  {
+    if (assignments[i] == SIZE_MAX)
+    {
+      REQUIRE(otherAssignments[i] == SIZE_MAX);
+      continue;
+    }
+
+    REQUIRE(otherAssignments[i] != SIZE_MAX);
+    if (labelMap[assignments[i]] == SIZE_MAX)
+      labelMap[assignments[i]] = otherAssignments[i];
+    REQUIRE(labelMap[assignments[i]] == otherAssignments[i]);
+  }
+
+  // Every cluster maps to a different cluster.
+  REQUIRE(arma::Col<size_t>(arma::unique(labelMap)).n_elem == clusters);
+}
+
 TEST_CASE("OneClusterTest", "[DBSCANTest]")
 {
   // Make sure that if we have points in the unit box, and if we set epsilon
@@ -364,3 +394,121 @@ TEST_CASE("NoiseConnectionTest", "[DBSCANTest]")
 
   REQUIRE(numClusters == 2);
 }
+
+/**
+ * Make sure that multi-threaded batch clustering gives the same clusters as
+ * single-threaded batch clustering.
+ */
+TEST_CASE("ParallelBatchClusterTest", "[DBSCANTest]")
+{
+  // Points from a few Gaussians, with some noise.
+  arma::mat points(2, 3000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    if (i < 2700)
+      points.col(i) = 5.0 * (i % 3) + arma::randn<arma::vec>(2);
+    else
+      points.col(i) = 20.0 * arma::randu<arma::vec>(2) - 5.0;
+  }
+
+  // Use the range search, not the grid.
+  DBSCAN<> d(0.4, 8);
+  d.UseGrid() = false;
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  arma::Row<size_t> serialAssignments;
+  const size_t serialClusters = d.Cluster(points, serialAssignments);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+  #endif
+
+  arma::Row<size_t> parallelAssignments;
+  const size_t parallelClusters = d.Cluster(points, parallelAssignments);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  REQUIRE(serialClusters > 0);
+  REQUIRE(parallelClusters == serialClusters);
+
+  CheckSameClusters(serialAssignments, parallelAssignments, serialClusters);
+}
+
+/**
+ * Make sure that searching in blocks gives the same clusters as searching each
+ * point separately.
+ */
+TEST_CASE("BlockClusterTest", "[DBSCANTest]")
+{
+  arma::mat points(2, 1000);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    if (i < 900)
+      points.col(i) = 5.0 * (i % 3) + arma::randn<arma::vec>(2);
+    else
+      points.col(i) = 20.0 * arma::randu<arma::vec>(2) - 5.0;
+  }
+
+  // Use the range search, not the grid.
+  DBSCAN<> pointwise(0.5, 6, false);
+  pointwise.UseGrid() = false;
+  arma::Row<size_t> pointwiseAssignments;
+  const size_t pointwiseClusters = pointwise.Cluster(points,
+      pointwiseAssignments);
+  REQUIRE(pointwiseClusters > 0);
+
+  // Use a block size that does not divide the number of points.
+  DBSCAN<> block(0.5, 6, true, RangeSearch<>(), OrderedPointSelection(), 64);
+  REQUIRE(block.BlockSize() == 64);
+  block.UseGrid() = false;
+  arma::Row<size_t> blockAssignments;
+  const size_t blockClusters = block.Cluster(points, blockAssignments);
+
+  REQUIRE(blockClusters == pointwiseClusters);
+  CheckSameClusters(pointwiseAssignments, blockAssignments, pointwiseClusters);
+}
+
+/**
+ * Make sure that clustering low-dimensional data with a grid gives the same
+ * clusters as with the range search, in one, two and three dimensions.
+ */
+TEST_CASE("GridClusterTest", "[DBSCANTest]")
+{
+  for (size_t dims = 1; dims <= 3; ++dims)
+  {
+    arma::mat points(dims, 2000);
+    for (size_t i = 0; i < points.n_cols; ++i)
+    {
+      if (i < 1800)
+        points.col(i) = 5.0 * (i % 3) + arma::randn<arma::vec>(dims);
+      else
+        points.col(i) = 20.0 * arma::randu<arma::vec>(dims) - 5.0;
+    }
+    // Some points are on a lattice, so that some distances are exactly
+    // epsilon.
+    points.cols(0, 99) = arma::round(points.cols(0, 99) * 4.0) / 4.0;
+
+    for (const size_t minPoints : { 1, 5, 20 })
+    {
+      DBSCAN<> search(0.25, minPoints);
+      search.UseGrid() = false;
+      arma::Row<size_t> searchAssignments;
+      const size_t searchClusters = search.Cluster(points, searchAssignments);
+
+      DBSCAN<> grid(0.25, minPoints);
+      REQUIRE(grid.UseGrid() == true);
+      arma::Row<size_t> gridAssignments;
+      const size_t gridClusters = grid.Cluster(points, gridAssignments);
+
+      REQUIRE(searchClusters > 0);
+      REQUIRE(gridClusters == searchClusters);
+      CheckSameClusters(searchAssignments, gridAssignments, searchClusters);
+    }
+  }
+}
@@ -376,6 +376,58 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest_", "[DecisionTreeRegressorTest]")
   REQUIRE(gain == DBL_MAX);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when every distinct value gets its own bin, both with
+ * a fitness function that has an optimized binary scan and one that does not.
+ */
+TEST_CASE("HistogramNumericSplitMatchesBestTest_",
+    "[DecisionTreeRegressorTest]")
+{
+  arma::rowvec predictors(500);
+  arma::rowvec responses(500);
+  arma::rowvec weights;
+  for (size_t i = 0; i < predictors.n_elem; ++i)
+  {
+    predictors[i] = RandInt(0, 50) / 5.0;
+    responses[i] = (predictors[i] > 4.0 ? 3.0 : 1.0) + Random(-1, 1);
+  }
+
+  arma::vec bestSplitInfo, histogramSplitInfo;
+
+  MSEGain mse;
+  double bestGain = mse.Evaluate<false>(responses, weights);
+  BestBinaryNumericSplit<MSEGain>::AuxiliarySplitInfo mseBestAux;
+  HistogramNumericSplit<MSEGain>::AuxiliarySplitInfo mseHistogramAux;
+  double gain = BestBinaryNumericSplit<MSEGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, bestSplitInfo,
+      mseBestAux, mse);
+  double histogramGain = HistogramNumericSplit<MSEGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, histogramSplitInfo,
+      mseHistogramAux, mse);
+
+  REQUIRE(gain < DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramSplitInfo.n_elem == 1);
+  REQUIRE(histogramSplitInfo[0] == Approx(bestSplitInfo[0]).epsilon(1e-7));
+
+  MADGain mad;
+  bestGain = mad.Evaluate<false>(responses, weights);
+  BestBinaryNumericSplit<MADGain>::AuxiliarySplitInfo madBestAux;
+  HistogramNumericSplit<MADGain>::AuxiliarySplitInfo madHistogramAux;
+  gain = BestBinaryNumericSplit<MADGain>::SplitIfBetter<false>(bestGain,
+      predictors, responses, weights, 3, 1e-7, bestSplitInfo, madBestAux,
+      mad);
+  histogramGain = HistogramNumericSplit<MADGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, histogramSplitInfo,
+      madHistogramAux, mad);
+
+  REQUIRE(gain < DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramSplitInfo.n_elem == 1);
+  REQUIRE(histogramSplitInfo[0] == Approx(bestSplitInfo[0]).epsilon(1e-7));
+}
+
 /**
  * Check that the RandomBinaryNumericSplit always splits when splitIfBetterGain
  * is false.
@@ -468,6 +468,123 @@ TEST_CASE("RandomBinaryNumericSplitDiffSplitTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities[0] != classProbabilities1[0]);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when every distinct value gets its own bin.
+ */
+TEST_CASE("HistogramNumericSplitMatchesBestTest", "[DecisionTreeTest]")
+{
+  arma::vec values(1000);
+  arma::Row<size_t> labels(1000);
+  arma::rowvec weights(1000, arma::fill::randu);
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    values[i] = RandInt(0, 100) / 10.0;
+    // Noisy labels, mostly determined by the value.
+    labels[i] = (values[i] + Random(-2, 2) > 6.0) ? 1 : 0;
+  }
+
+  arma::vec bestSplitInfo, histogramSplitInfo;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo bestAux;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo histogramAux;
+
+  // Unweighted.
+  double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, bestSplitInfo, bestAux);
+  double histogramGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, histogramSplitInfo, histogramAux);
+
+  REQUIRE(gain < DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramSplitInfo.n_elem == 1);
+  REQUIRE(histogramSplitInfo[0] == Approx(bestSplitInfo[0]).epsilon(1e-7));
+
+  // Weighted.
+  bestGain = GiniGain::Evaluate<true>(labels, 2, weights);
+  gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain,
+      values, labels, 2, weights, 3, 1e-7, bestSplitInfo, bestAux);
+  histogramGain = HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, histogramSplitInfo,
+      histogramAux);
+
+  REQUIRE(gain < DBL_MAX);
+  REQUIRE(histogramGain == Approx(gain).epsilon(1e-7));
+  REQUIRE(histogramSplitInfo.n_elem == 1);
+  REQUIRE(histogramSplitInfo[0] == Approx(bestSplitInfo[0]).epsilon(1e-7));
+}
+
+/**
+ * Check that the HistogramNumericSplit finds a split close to the best one
+ * when there are many more distinct values than bins.
+ */
+TEST_CASE("HistogramNumericSplitManyValuesTest", "[DecisionTreeTest]")
+{
+  arma::vec values(20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  arma::rowvec weights;
+  for (size_t i = 0; i < values.n_elem; ++i)
+    labels[i] = (values[i] > 0.3) ? 1 : 0;
+
+  arma::vec splitInfo;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, splitInfo, aux);
+
+  // The bins are about 1/256 wide, so the split must be nearly perfect.
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == Approx(0.0).margin(0.02));
+  REQUIRE(splitInfo.n_elem == 1);
+  REQUIRE(splitInfo[0] == Approx(0.3).margin(0.02));
+}
+
+/**
+ * Check that the HistogramNumericSplit won't split if not enough points are
+ * given, or if all points have the same value.
+ */
+TEST_CASE("HistogramNumericSplitNoSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec splitInfo;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 8, 1e-7, splitInfo, aux);
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(splitInfo.n_elem == 0);
+
+  values.fill(0.5);
+  gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain,
+      values, labels, 2, weights, 1, 1e-7, splitInfo, aux);
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(splitInfo.n_elem == 0);
+}
+
+/**
+ * Make sure that a decision tree built with the HistogramNumericSplit can fit
+ * a perfectly separable training set.
+ */
+TEST_CASE("HistogramNumericSplitPerfectTrainingSet", "[DecisionTreeTest]")
+{
+  arma::mat dataset(10, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (dataset(3, i) > 0.5) ? 1 : 0;
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(dataset, labels, 2, 1, 0.0);
+
+  arma::Row<size_t> predictions;
+  d.Classify(dataset, predictions);
+  REQUIRE(accu(predictions == labels) == 1000);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -1852,3 +1969,237 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that a tree built with several threads (where large nodes search
+ * their dimensions and train their children in parallel) is the same as a tree
+ * built with one thread.
+ */
+TEST_CASE("ParallelDecisionTreeMatchesSerialTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(4, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(0, i) + dataset(1, i) > 1.0) ? 1 : 0;
+    if (dataset(2, i) > 0.8)
+      labels[i] = 2;
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  DecisionTree<> parallelTree(dataset, labels, 3, 5);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(1);
+  #endif
+
+  DecisionTree<> serialTree(dataset, labels, 3, 5);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  REQUIRE(parallelTree.NumChildren() == serialTree.NumChildren());
+  REQUIRE(parallelTree.SplitDimension() == serialTree.SplitDimension());
+
+  arma::Row<size_t> parallelPredictions, serialPredictions;
+  arma::mat parallelProbabilities, serialProbabilities;
+  parallelTree.Classify(dataset, parallelPredictions, parallelProbabilities);
+  serialTree.Classify(dataset, serialPredictions, serialProbabilities);
+
+  REQUIRE(arma::all(parallelPredictions == serialPredictions));
+  REQUIRE(arma::approx_equal(parallelProbabilities, serialProbabilities,
+      "absdiff", 1e-10));
+}
+
+/**
+ * Make sure that a tree can be trained directly on a subview of a dataset, and
+ * that it is the same as a tree trained on a copy of those points.
+ */
+TEST_CASE("DecisionTreeSubviewTrainTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(500);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (dataset(0, i) > 0.3 && dataset(2, i) < 0.6) ? 1 : 0;
+
+  const arma::mat original(dataset);
+  DecisionTree<> subviewTree(dataset.cols(0, 499), labels, 2, 5);
+  const arma::mat points = dataset.cols(0, 499);
+  DecisionTree<> copyTree(points, labels, 2, 5);
+
+  // The dataset must not be modified by training.
+  REQUIRE(arma::approx_equal(dataset, original, "absdiff", 0.0));
+
+  arma::Row<size_t> subviewPredictions, copyPredictions;
+  subviewTree.Classify(dataset, subviewPredictions);
+  copyTree.Classify(dataset, copyPredictions);
+  REQUIRE(arma::all(subviewPredictions == copyPredictions));
+}
+
+/**
+ * Make sure that training on a list of point indices (with repeats) gives the
+ * same tree as training on a copy of those points.
+ */
+TEST_CASE("DecisionTreeIndexTrainTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (dataset(0, i) > 0.3 && dataset(2, i) < 0.6) ? 1 : 0;
+  const arma::rowvec weights(1000, arma::fill::randu);
+
+  const arma::uvec indices = randi<arma::uvec>(1000, DistrParam(0, 999));
+  const arma::mat sampled = dataset.cols(indices);
+  const arma::Row<size_t> sampledLabels = labels.cols(indices);
+  const arma::rowvec sampledWeights = weights.cols(indices);
+
+  DecisionTree<> indexTree, copyTree;
+  indexTree.Train(dataset, indices, sampledLabels, 2, 5);
+  copyTree.Train(sampled, sampledLabels, 2, 5);
+
+  DecisionTree<> weightedIndexTree, weightedCopyTree;
+  weightedIndexTree.Train(dataset, indices, sampledLabels, 2, sampledWeights,
+      5);
+  weightedCopyTree.Train(sampled, sampledLabels, 2, sampledWeights, 5);
+
+  REQUIRE(indexTree.NumChildren() > 0);
+  REQUIRE(weightedIndexTree.NumChildren() > 0);
+
+  arma::Row<size_t> indexPredictions, copyPredictions;
+  arma::mat indexProbabilities, copyProbabilities;
+  indexTree.Classify(dataset, indexPredictions, indexProbabilities);
+  copyTree.Classify(dataset, copyPredictions, copyProbabilities);
+  REQUIRE(arma::all(indexPredictions == copyPredictions));
+  REQUIRE(arma::approx_equal(indexProbabilities, copyProbabilities, "absdiff",
+      1e-12));
+
+  weightedIndexTree.Classify(dataset, indexPredictions, indexProbabilities);
+  weightedCopyTree.Classify(dataset, copyPredictions, copyProbabilities);
+  REQUIRE(arma::all(indexPredictions == copyPredictions));
+  REQUIRE(arma::approx_equal(indexProbabilities, copyProbabilities, "absdiff",
+      1e-12));
+
+  // An out of bounds index is an error.
+  arma::uvec badIndices(indices);
+  badIndices[10] = 1000;
+  REQUIRE_THROWS_AS(indexTree.Train(dataset, badIndices, sampledLabels, 2),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that RandomProjectionSplit learns an oblique boundary with a
+ * smaller tree than BestBinaryNumericSplit, and gives the same predictions for
+ * single points and batches.
+ */
+TEST_CASE("RandomProjectionSplitObliqueTest", "[DecisionTreeTest]")
+{
+  arma::mat dataset(5, 2000, arma::fill::randu);
+  arma::mat testDataset(5, 1000, arma::fill::randu);
+  auto label = [](const arma::mat& data, const size_t i)
+  {
+    return (data(0, i) + data(1, i) > data(2, i) + data(3, i)) ? 1 : 0;
+  };
+  arma::Row<size_t> labels(dataset.n_cols), testLabels(testDataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    labels[i] = label(dataset, i);
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+    testLabels[i] = label(testDataset, i);
+
+  DecisionTree<> axisTree(dataset, labels, 2, 5);
+  DecisionTree<GiniGain, RandomProjectionSplit> projectionTree(dataset, labels,
+      2, 5);
+
+  std::function<size_t(const DecisionTree<>&)> axisLeaves;
+  axisLeaves = [&](const DecisionTree<>& node)
+  {
+    size_t leaves = (node.NumChildren() == 0) ? 1 : 0;
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      leaves += axisLeaves(node.Child(i));
+    return leaves;
+  };
+  using ProjectionTree = DecisionTree<GiniGain, RandomProjectionSplit>;
+  std::function<size_t(const ProjectionTree&)> projectionLeaves;
+  projectionLeaves = [&](const ProjectionTree& node)
+  {
+    size_t leaves = (node.NumChildren() == 0) ? 1 : 0;
+    for (size_t i = 0; i < node.NumChildren(); ++i)
+      leaves += projectionLeaves(node.Child(i));
+    return leaves;
+  };
+  REQUIRE(projectionLeaves(projectionTree) < axisLeaves(axisTree));
+
+  arma::Row<size_t> predictions;
+  projectionTree.Classify(testDataset, predictions);
+  REQUIRE(accu(predictions == testLabels) > 900);
+
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+    REQUIRE(projectionTree.Classify(testDataset.col(i)) == predictions[i]);
+}
+
+/**
+ * Make sure that a classification tree trained on sparse data, whose numeric
+ * splits are searched from the nonzero values only, is the same as the tree
+ * trained on the same data as a dense matrix, with and without weights.
+ */
+TEST_CASE("DecisionTreeSparseMatchesDenseTest", "[DecisionTreeTest]")
+{
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(20, 1000, 0.3);
+  // Negative values are split around the block of zeros.
+  sparseData.row(5) *= -1.0;
+  const arma::mat data(sparseData);
+
+  arma::Row<size_t> labels(data.n_cols);
+  arma::rowvec weights(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (data(3, i) > 0.5)
+      labels[i] = 1;
+    else if (data(5, i) < -0.2 || data(7, i) > 0.0)
+      labels[i] = 2;
+    else
+      labels[i] = 0;
+
+    // These weights have exact sums, so both trees see the same gains.
+    weights[i] = (i % 3 == 0) ? 0.5 : ((i % 3 == 1) ? 1.0 : 2.0);
+  }
+
+  DecisionTree<> denseTree(data, labels, 3, 5);
+  DecisionTree<> sparseTree(sparseData, labels, 3, 5);
+  DecisionTree<> denseWeightedTree(data, labels, 3, weights, 5);
+  DecisionTree<> sparseWeightedTree(sparseData, labels, 3, weights, 5);
+
+  arma::Row<size_t> densePredictions, sparsePredictions;
+  arma::mat denseProbabilities, sparseProbabilities;
+  denseTree.Classify(data, densePredictions, denseProbabilities);
+  sparseTree.Classify(data, sparsePredictions, sparseProbabilities);
+  REQUIRE(sparseTree.NumChildren() > 0);
+  REQUIRE(arma::all(densePredictions == sparsePredictions));
+  REQUIRE(arma::approx_equal(denseProbabilities, sparseProbabilities,
+      "absdiff", 1e-12));
+
+  denseWeightedTree.Classify(data, densePredictions, denseProbabilities);
+  sparseWeightedTree.Classify(data, sparsePredictions, sparseProbabilities);
+  REQUIRE(arma::all(densePredictions == sparsePredictions));
+  REQUIRE(arma::approx_equal(denseProbabilities, sparseProbabilities,
+      "absdiff", 1e-12));
+
+  // Sparse points are classified like their dense copies.
+  sparseTree.Classify(sparseData, sparsePredictions);
+  denseTree.Classify(data, densePredictions);
+  REQUIRE(arma::all(densePredictions == sparsePredictions));
+
+  // The same holds with random splits, given the same random seed.
+  using RandomTree = DecisionTree<GiniGain, RandomBinaryNumericSplit>;
+  RandomSeed(12);
+  RandomTree denseRandomTree(data, labels, 3, 5);
+  RandomSeed(12);
+  RandomTree sparseRandomTree(sparseData, labels, 3, 5);
+  denseRandomTree.Classify(data, densePredictions);
+  sparseRandomTree.Classify(data, sparsePredictions);
+  REQUIRE(arma::all(densePredictions == sparsePredictions));
+}
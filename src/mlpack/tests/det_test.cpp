@@ -12,6 +12,7 @@
  */
 #include <mlpack/core.hpp>
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 // This trick does not work on Windows.  We will have to comment out the tests
 // that depend on it.
@@ -317,6 +318,79 @@ TEST_CASE("TestGrow", "[DETTest]")
   REQUIRE(alpha == Approx(min(rootAlpha, rAlpha)).epsilon(1e-12));
 }
 
+// Recursively check that two trees have the same structure.
+template<typename TreeType>
+void CheckSameDTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Start() == b.Start());
+  REQUIRE(a.End() == b.End());
+  REQUIRE(a.SubtreeLeaves() == b.SubtreeLeaves());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  REQUIRE(a.LogNegError() == Approx(b.LogNegError()).epsilon(1e-10));
+  if (a.NumChildren() > 0)
+  {
+    REQUIRE(a.SplitDim() == b.SplitDim());
+    REQUIRE(a.SplitValue() == b.SplitValue());
+    CheckSameDTree(*a.Left(), *b.Left());
+    CheckSameDTree(*a.Right(), *b.Right());
+  }
+}
+
+// Growing a tree with the presorted points (the default for dense data) should
+// give the same tree as sorting the points in every node.  The sorted lists are
+// not used when the indices in oldFromNew are not distinct, so that path is
+// taken when oldFromNew is all zeros.  The dataset is large enough for the
+// subtrees to be grown in parallel.
+TEST_CASE("TestGrowPresorted", "[DETTest]")
+{
+  arma::mat data(3, 20000, arma::fill::randn);
+  data.row(1) = arma::round(4 * data.row(1)); // Some ties.
+
+  arma::mat presortedData(data);
+  arma::Col<size_t> oldFromNew = arma::regspace<arma::Col<size_t>>(0,
+      data.n_cols - 1);
+  DTree<arma::mat> presortedTree(presortedData);
+  const double presortedAlpha = presortedTree.Grow(presortedData, oldFromNew,
+      false, 10, 5);
+
+  arma::mat sortedData(data);
+  arma::Col<size_t> zeros(data.n_cols, arma::fill::zeros);
+  DTree<arma::mat> sortedTree(sortedData);
+  const double sortedAlpha = sortedTree.Grow(sortedData, zeros, false, 10, 5);
+
+  REQUIRE(presortedTree.SubtreeLeaves() > 100);
+  REQUIRE(presortedAlpha == Approx(sortedAlpha).epsilon(1e-10));
+  CheckSameDTree(presortedTree, sortedTree);
+  CheckMatrices(presortedData, sortedData);
+  CheckMatrices(data.cols(arma::conv_to<arma::uvec>::from(oldFromNew)),
+      presortedData);
+}
+
+// The trained tree should not depend on the number of threads.
+TEST_CASE("TestTrainerThreads", "[DETTest]")
+{
+  arma::mat data(2, 3000, arma::fill::randu);
+  util::Timers timers;
+
+  #ifdef MLPACK_USE_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+  DTree<arma::mat, int>* serialTree = Trainer<arma::mat, int>(data, 5, false,
+      10, 5, false, timers);
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(threads);
+  #endif
+  DTree<arma::mat, int>* parallelTree = Trainer<arma::mat, int>(data, 5, false,
+      10, 5, false, timers);
+
+  REQUIRE(serialTree->SubtreeLeaves() > 1);
+  CheckSameDTree(*serialTree, *parallelTree);
+
+  delete serialTree;
+  delete parallelTree;
+}
+
 TEST_CASE("TestPruneAndUpdate", "[DETTest]")
 {
   arma::mat testData(3, 5);
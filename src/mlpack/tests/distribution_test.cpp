@@ -601,6 +601,51 @@ TEMPLATE_TEST_CASE("GaussianMultipointMultivariateProbabilityTest",
   REQUIRE(phis(5) == Approx(-14.900192463287908).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batch log-probability over many points (more than one block)
+ * matches the single-point log-probability, and that a workspace can be
+ * reused.
+ */
+TEMPLATE_TEST_CASE("GaussianBatchLogProbabilityTest", "[DistributionTest]",
+    float, double)
+{
+  using ElemType = TestType;
+  using VecType = arma::Col<ElemType>;
+  using MatType = arma::Mat<ElemType>;
+
+  VecType mean = "5 6 3 3 2";
+  MatType cov("6 1 1 1 2;"
+              "1 7 1 0 0;"
+              "1 1 4 1 1;"
+              "1 0 1 7 0;"
+              "2 0 1 0 6");
+  GaussianDistribution<MatType> g(mean, cov);
+
+  MatType points(5, 2500, arma::fill::randn);
+  points *= 3;
+
+  VecType phis, phisWorkspace;
+  MatType workspace;
+  g.LogProbability(points, phis);
+  g.LogProbability(points, phisWorkspace, workspace);
+
+  // Reuse the workspace with fewer points.
+  VecType phisSmall;
+  g.LogProbability(points.cols(0, 9), phisSmall, workspace);
+
+  REQUIRE(phis.n_elem == points.n_cols);
+  REQUIRE(phisWorkspace.n_elem == points.n_cols);
+  REQUIRE(phisSmall.n_elem == 10);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const ElemType p = g.LogProbability(VecType(points.col(i)));
+    REQUIRE(phis[i] == Approx(p).epsilon(1e-4));
+    REQUIRE(phisWorkspace[i] == Approx(p).epsilon(1e-4));
+    if (i < 10)
+      REQUIRE(phisSmall[i] == Approx(p).epsilon(1e-4));
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -1696,6 +1741,37 @@ TEMPLATE_TEST_CASE("DiagonalGaussianMultipointMultivariateProbabilityTest",
   REQUIRE(phis(5) == Approx(-13.647746496371308).epsilon(1e-7));
 }
 
+/**
+ * Make sure the batch log-probability over many points matches the single
+ * point log-probability and the dense Gaussian.
+ */
+TEMPLATE_TEST_CASE("DiagonalGaussianBatchLogProbabilityTest",
+    "[DistributionTest]", float, double)
+{
+  using ElemType = TestType;
+  using VecType = arma::Col<ElemType>;
+  using MatType = arma::Mat<ElemType>;
+
+  VecType mean = "2 5 3 7 2";
+  VecType cov("9 2 1 4 8");
+  DiagonalGaussianDistribution<MatType> d(mean, cov);
+  GaussianDistribution<MatType> g(mean, MatType(arma::diagmat(cov)));
+
+  MatType points(5, 20000, arma::fill::randn);
+  points *= 3;
+
+  VecType phis;
+  d.LogProbability(points, phis);
+
+  REQUIRE(phis.n_elem == points.n_cols);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    const VecType point = points.col(i);
+    REQUIRE(phis[i] == Approx(d.LogProbability(point)).epsilon(1e-4));
+    REQUIRE(phis[i] == Approx(g.LogProbability(point)).epsilon(1e-4));
+  }
+}
+
 /**
  * Make sure random observations follow the probability distribution correctly.
  */
@@ -144,6 +144,36 @@ TEST_CASE("DrusillaSelectSerializationTest", "[DrusillaSelectTest]")
   }
 }
 
+// Make sure that the batched search over many query points returns the exact
+// furthest neighbors among the candidate points.
+TEST_CASE("DrusillaSelectBatchedSearchTest", "[DrusillaSelectTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 300);
+  arma::mat querySet = arma::randu<arma::mat>(5, 1000);
+
+  DrusillaSelect<> ds(dataset, 5, 10);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  ds.Search(querySet, 5, neighbors, distances);
+
+  KFN kfn(ds.CandidateSet());
+  arma::Mat<size_t> neighborsTrue;
+  arma::mat distancesTrue;
+  kfn.Search(querySet, 5, neighborsTrue, distancesTrue);
+
+  REQUIRE(neighbors.n_rows == 5);
+  REQUIRE(neighbors.n_cols == 1000);
+  REQUIRE(distances.n_rows == 5);
+  REQUIRE(distances.n_cols == 1000);
+
+  for (size_t i = 0; i < distances.n_elem; ++i)
+  {
+    REQUIRE(neighbors[i] == ds.CandidateIndices()[neighborsTrue[i]]);
+    REQUIRE(distances[i] == Approx(distancesTrue[i]).epsilon(1e-7));
+  }
+}
+
 // Make sure we can create the object with a sparse matrix.
 TEST_CASE("SparseTest", "[DrusillaSelectTest]")
 {
@@ -269,3 +269,116 @@ TEST_CASE("EMSTBallTreeTest", "[EMSTTest]")
     REQUIRE(bstResults(2, i) == Approx(ballResults(2, i)).epsilon(1e-7));
   }
 }
+
+/**
+ * Make sure the multi-threaded dual-tree computation gives the same results as
+ * the naive computation, with the kd-tree and the cover tree.
+ */
+TEST_CASE("EMSTParallelTest", "[EMSTTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  DualTreeBoruvka<> naive(inputData, true);
+  arma::mat naiveResults;
+  naive.ComputeMST(naiveResults);
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  DualTreeBoruvka<> kd(inputData);
+  DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+      ct(inputData);
+
+  arma::mat kdResults;
+  arma::mat coverResults;
+  kd.ComputeMST(kdResults);
+  ct.ComputeMST(coverResults);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  REQUIRE(kdResults.n_cols == naiveResults.n_cols);
+  REQUIRE(coverResults.n_cols == naiveResults.n_cols);
+  for (size_t i = 0; i < naiveResults.n_cols; ++i)
+  {
+    REQUIRE(kdResults(0, i) == naiveResults(0, i));
+    REQUIRE(kdResults(1, i) == naiveResults(1, i));
+    REQUIRE(kdResults(2, i) == Approx(naiveResults(2, i)).epsilon(1e-7));
+
+    REQUIRE(coverResults(0, i) == naiveResults(0, i));
+    REQUIRE(coverResults(1, i) == naiveResults(1, i));
+    REQUIRE(coverResults(2, i) == Approx(naiveResults(2, i)).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure the mutual reachability MST of the dual-tree computation has the
+ * same edge weights as the naive computation, with and without threads, and
+ * that the weights include the core distances.
+ */
+TEST_CASE("EMSTMutualReachabilityTest", "[EMSTTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("test_data_3_1000.csv", inputData))
+    FAIL("Cannot load test dataset test_data_3_1000.csv!");
+
+  arma::vec coreDistances(inputData.n_cols, arma::fill::randu);
+  coreDistances *= 0.1;
+
+  DualTreeBoruvka<> naive(inputData, true);
+  arma::mat naiveResults;
+  naive.ComputeMST(naiveResults, coreDistances);
+
+  for (size_t i = 0; i < naiveResults.n_cols; ++i)
+  {
+    const size_t a = (size_t) naiveResults(0, i);
+    const size_t b = (size_t) naiveResults(1, i);
+    const double d = std::max(arma::norm(inputData.col(a) -
+        inputData.col(b)), std::max(coreDistances[a], coreDistances[b]));
+    REQUIRE(naiveResults(2, i) == Approx(d).epsilon(1e-7));
+  }
+
+  for (const size_t threads : { 1, 4 })
+  {
+    #ifdef MLPACK_USE_OPENMP
+    const int oldThreads = omp_get_max_threads();
+    omp_set_num_threads((int) threads);
+    #else
+    (void) threads;
+    #endif
+
+    DualTreeBoruvka<> kd(inputData);
+    DualTreeBoruvka<EuclideanDistance, arma::mat, StandardCoverTree>
+        ct(inputData);
+
+    arma::mat kdResults;
+    arma::mat coverResults;
+    kd.ComputeMST(kdResults, coreDistances);
+    ct.ComputeMST(coverResults, coreDistances);
+
+    #ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads(oldThreads);
+    #endif
+
+    // Many edges have the same weight (a core distance), so the trees may
+    // differ, but not their sorted weights.
+    REQUIRE(kdResults.n_cols == naiveResults.n_cols);
+    REQUIRE(coverResults.n_cols == naiveResults.n_cols);
+    for (size_t i = 0; i < naiveResults.n_cols; ++i)
+    {
+      REQUIRE(kdResults(2, i) == Approx(naiveResults(2, i)).epsilon(1e-7));
+      REQUIRE(coverResults(2, i) ==
+          Approx(naiveResults(2, i)).epsilon(1e-7));
+    }
+  }
+
+  arma::vec wrongSize(10, arma::fill::zeros);
+  DualTreeBoruvka<> wrong(inputData);
+  REQUIRE_THROWS_AS(wrong.ComputeMST(naiveResults, wrongSize),
+      std::invalid_argument);
+}
@@ -122,6 +122,82 @@ TEST_CASE("DualTreeVsSingleTree", "[FastMKSTest]")
   }
 }
 
+/**
+ * Make sure that FastMKS with several threads gives the same results as the
+ * naive search (whose kernels are computed with matrix products), for the
+ * linear and polynomial kernels and for bichromatic and monochromatic search.
+ */
+template<typename KernelType>
+void CheckParallelFastMKS(KernelType& kernel)
+{
+  arma::mat referenceData(10, 1500, arma::fill::randu);
+  arma::mat queryData(10, 600, arma::fill::randu);
+
+  // The naive search is parallel too, so compare it with one kernel at a time.
+  arma::mat naiveProducts(10, queryData.n_cols);
+  for (size_t q = 0; q < queryData.n_cols; ++q)
+  {
+    arma::vec products(referenceData.n_cols);
+    for (size_t r = 0; r < referenceData.n_cols; ++r)
+      products[r] = kernel.Evaluate(queryData.col(q), referenceData.col(r));
+    naiveProducts.col(q) = arma::sort(products, "descend").eval().head(10);
+  }
+
+  FastMKS<KernelType> naive(referenceData, kernel, false, true);
+  FastMKS<KernelType> single(referenceData, kernel, true);
+  FastMKS<KernelType> dual(referenceData, kernel);
+
+  arma::Mat<size_t> naiveIndices, singleIndices, dualIndices;
+  arma::mat blockProducts, singleProducts, dualProducts;
+  naive.Search(queryData, 10, naiveIndices, blockProducts);
+  single.Search(queryData, 10, singleIndices, singleProducts);
+  dual.Search(queryData, 10, dualIndices, dualProducts);
+
+  for (size_t i = 0; i < naiveProducts.n_elem; ++i)
+  {
+    REQUIRE(blockProducts[i] == Approx(naiveProducts[i]).epsilon(1e-7));
+    REQUIRE(singleIndices[i] == naiveIndices[i]);
+    REQUIRE(singleProducts[i] == Approx(blockProducts[i]).epsilon(1e-7));
+    REQUIRE(dualIndices[i] == naiveIndices[i]);
+    REQUIRE(dualProducts[i] == Approx(blockProducts[i]).epsilon(1e-7));
+  }
+
+  // Monochromatic search is run twice, so that the second dual-tree search
+  // starts with the bounds left in the tree by the first one.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    naive.Search(10, naiveIndices, blockProducts);
+    single.Search(10, singleIndices, singleProducts);
+    dual.Search(10, dualIndices, dualProducts);
+
+    for (size_t i = 0; i < naiveIndices.n_elem; ++i)
+    {
+      REQUIRE(singleIndices[i] == naiveIndices[i]);
+      REQUIRE(singleProducts[i] == Approx(blockProducts[i]).epsilon(1e-7));
+      REQUIRE(dualIndices[i] == naiveIndices[i]);
+      REQUIRE(dualProducts[i] == Approx(blockProducts[i]).epsilon(1e-7));
+    }
+  }
+}
+
+TEST_CASE("ParallelFastMKSTest", "[FastMKSTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  LinearKernel lk;
+  CheckParallelFastMKS(lk);
+
+  PolynomialKernel pk(3.0, 1.0);
+  CheckParallelFastMKS(pk);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
 /**
  * Test sparse FastMKS (how useful is this, I'm not sure).
  */
@@ -1231,3 +1231,128 @@ TEST_CASE("DiagonalGMMLoadSaveTest", "[GMMTest]")
     }
   }
 }
+
+/**
+ * One iteration of the blocked, parallel EM should match an EM update computed
+ * directly from the full matrix of responsibilities, with or without
+ * probabilities for each point.
+ */
+TEST_CASE("EMFitBlockedIterationTest", "[GMMTest]")
+{
+  // Use enough points for several blocks, with a partial last block.
+  arma::mat data = arma::randn<arma::mat>(3, 2500);
+  data.cols(0, 999).each_col() += arma::vec("4 0 0");
+  data.cols(1000, 1999).each_col() -= arma::vec("0 4 1");
+  const arma::vec probabilities = arma::randu<arma::vec>(data.n_cols);
+
+  std::vector<GaussianDistribution<>> initialDists(3,
+      GaussianDistribution<>(3));
+  initialDists[0].Mean() = arma::vec("3 0 0");
+  initialDists[1].Mean() = arma::vec("0 -3 -1");
+  initialDists[2].Mean() = arma::vec("0 0 0.5");
+  initialDists[2].Covariance(2.0 * arma::eye<arma::mat>(3, 3));
+  const arma::vec initialWeights("0.3 0.3 0.4");
+
+  for (size_t weighted = 0; weighted < 2; ++weighted)
+  {
+    const arma::vec p = weighted ? probabilities :
+        arma::ones<arma::vec>(data.n_cols);
+
+    // Compute the reference update.
+    arma::mat resp(3, data.n_cols);
+    for (size_t i = 0; i < 3; ++i)
+    {
+      arma::vec logPhis;
+      initialDists[i].LogProbability(data, logPhis);
+      resp.row(i) = std::log(initialWeights[i]) + logPhis.t();
+    }
+    for (size_t j = 0; j < data.n_cols; ++j)
+      resp.col(j) = arma::exp(resp.col(j) - AccuLog(resp.col(j))) * p[j];
+
+    // Run exactly one iteration.
+    std::vector<GaussianDistribution<>> dists(initialDists);
+    arma::vec weights(initialWeights);
+    EMFit<> fitter(2, 1e-10);
+    if (weighted)
+      fitter.Estimate(data, probabilities, dists, weights, true);
+    else
+      fitter.Estimate(data, dists, weights, true);
+
+    for (size_t i = 0; i < 3; ++i)
+    {
+      const double n = accu(resp.row(i));
+      const arma::vec mean = data * resp.row(i).t() / n;
+      const arma::mat diffs = data.each_col() - mean;
+      const arma::mat cov = (diffs.each_row() % resp.row(i)) * diffs.t() / n;
+
+      REQUIRE(arma::norm(dists[i].Mean() - mean) < 1e-8);
+      REQUIRE(arma::norm(dists[i].Covariance() - cov, "fro") < 1e-8);
+      REQUIRE(weights[i] == Approx(n / accu(p)).epsilon(1e-8));
+    }
+  }
+}
+
+/**
+ * Generate a chunk of points from a mixture of two well-separated Gaussians,
+ * with weights 0.3 and 0.7.
+ */
+static arma::mat OnlineEMChunk(const size_t points)
+{
+  arma::mat chunk = arma::randn<arma::mat>(2, points);
+  for (size_t j = 0; j < points; ++j)
+  {
+    if (arma::randu() < 0.3)
+      chunk.col(j) = 0.5 * chunk.col(j) + arma::vec("5 5");
+    else
+      chunk.col(j) -= arma::vec("2 0");
+  }
+  return chunk;
+}
+
+/**
+ * Online EM over a stream of chunks should recover the components of the
+ * mixture, for both GMM and DiagonalGMM.
+ */
+TEST_CASE("GMMTrainOnlineTest", "[GMMTest]")
+{
+  GMM gmm(2, 2);
+  OnlineEMFit<> fitter(0.7);
+  DiagonalGMM dgmm(2, 2);
+  OnlineEMFit<KMeans<>, DiagonalConstraint, DiagonalGaussianDistribution<>>
+      diagFitter(0.7);
+
+  for (size_t t = 0; t < 20; ++t)
+  {
+    const arma::mat chunk = OnlineEMChunk(500);
+    gmm.TrainOnline(chunk, fitter);
+    dgmm.TrainOnline(chunk, diagFitter);
+  }
+
+  REQUIRE(fitter.Steps() == 20);
+  REQUIRE(diagFitter.Steps() == 20);
+
+  // Find the component around (5, 5).
+  const size_t g = (gmm.Component(0).Mean()[0] > 0) ? 0 : 1;
+  const size_t d = (dgmm.Component(0).Mean()[0] > 0) ? 0 : 1;
+
+  REQUIRE(arma::norm(gmm.Component(g).Mean() - arma::vec("5 5")) < 0.2);
+  REQUIRE(arma::norm(gmm.Component(1 - g).Mean() - arma::vec("-2 0")) < 0.2);
+  REQUIRE(gmm.Weights()[g] == Approx(0.3).margin(0.05));
+  REQUIRE(arma::norm(gmm.Component(g).Covariance() -
+      0.25 * arma::eye<arma::mat>(2, 2), "fro") < 0.1);
+  REQUIRE(arma::norm(gmm.Component(1 - g).Covariance() -
+      arma::eye<arma::mat>(2, 2), "fro") < 0.2);
+
+  REQUIRE(arma::norm(dgmm.Component(d).Mean() - arma::vec("5 5")) < 0.2);
+  REQUIRE(arma::norm(dgmm.Component(1 - d).Mean() - arma::vec("-2 0")) < 0.2);
+  REQUIRE(dgmm.Weights()[d] == Approx(0.3).margin(0.05));
+  REQUIRE(arma::norm(dgmm.Component(d).Covariance() - arma::vec("0.25 0.25"))
+      < 0.1);
+
+  // The wrong dimensionality should be rejected.
+  REQUIRE_THROWS_AS(gmm.TrainOnline(arma::mat(3, 10, arma::fill::randn),
+      fitter), std::invalid_argument);
+
+  // So should a step exponent outside of (0.5, 1].
+  REQUIRE_THROWS_AS(OnlineEMFit<>(0.5), std::invalid_argument);
+}
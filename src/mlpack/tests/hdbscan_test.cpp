@@ -0,0 +1,192 @@
+/**
+ * @file tests/hdbscan_test.cpp
+ *
+ * Test the HDBSCAN implementation.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hdbscan.hpp>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+
+/**
+ * Generate three Gaussians of 200 points each, with different spreads, and
+ * three far outliers (the last three points).
+ */
+void GaussiansWithOutliers(arma::mat& points)
+{
+  points.set_size(3, 603);
+  points.cols(0, 199) = 0.5 * arma::randn<arma::mat>(3, 200);
+  points.cols(200, 399) = 1.5 * arma::randn<arma::mat>(3, 200) +
+      arma::repmat(arma::vec("15.0 15.0 15.0"), 1, 200);
+  points.cols(400, 599) = arma::randn<arma::mat>(3, 200) +
+      arma::repmat(arma::vec("-15.0 10.0 -15.0"), 1, 200);
+  points.col(600) = arma::vec("100.0 0.0 0.0");
+  points.col(601) = arma::vec("0.0 -100.0 0.0");
+  points.col(602) = arma::vec("-60.0 60.0 60.0");
+}
+
+/**
+ * Check that each Gaussian is found as one cluster, and that the outliers are
+ * noise.
+ */
+template<template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckGaussians()
+{
+  arma::mat points;
+  GaussiansWithOutliers(points);
+
+  HDBSCAN<EuclideanDistance, TreeType> h(20);
+  arma::Row<size_t> assignments;
+  arma::rowvec probabilities;
+  const size_t clusters = h.Cluster(points, assignments, probabilities);
+
+  REQUIRE(clusters == 3);
+  REQUIRE(assignments.n_elem == points.n_cols);
+  REQUIRE(probabilities.n_elem == points.n_cols);
+
+  // The points of each Gaussian that are not noise are in the same cluster.
+  arma::Row<size_t> labels(3);
+  labels.fill(SIZE_MAX);
+  for (size_t g = 0; g < 3; ++g)
+  {
+    size_t noise = 0;
+    for (size_t i = 200 * g; i < 200 * (g + 1); ++i)
+    {
+      if (assignments[i] == SIZE_MAX)
+      {
+        ++noise;
+        REQUIRE(probabilities[i] == 0.0);
+        continue;
+      }
+
+      if (labels[g] == SIZE_MAX)
+        labels[g] = assignments[i];
+      REQUIRE(assignments[i] == labels[g]);
+      REQUIRE(probabilities[i] > 0.0);
+      REQUIRE(probabilities[i] <= 1.0);
+    }
+
+    REQUIRE(noise < 40);
+  }
+
+  REQUIRE(labels[0] != labels[1]);
+  REQUIRE(labels[1] != labels[2]);
+  REQUIRE(labels[2] != labels[0]);
+
+  for (size_t i = 600; i < 603; ++i)
+  {
+    REQUIRE(assignments[i] == SIZE_MAX);
+    REQUIRE(probabilities[i] == 0.0);
+  }
+}
+
+/**
+ * Check that Gaussians of different spreads are found with the default tree.
+ */
+TEST_CASE("HDBSCANGaussiansTest", "[HDBSCANTest]")
+{
+  CheckGaussians<KDTree>();
+}
+
+/**
+ * Check that the clusters are the same with other types of trees.
+ */
+TEST_CASE("HDBSCANTreeTypesTest", "[HDBSCANTest]")
+{
+  CheckGaussians<BallTree>();
+  CheckGaussians<StandardCoverTree>();
+}
+
+/**
+ * Check that minPoints changes the core distances without breaking the
+ * clusters, and that a neighborhood of one point (single linkage) works.
+ */
+TEST_CASE("HDBSCANMinPointsTest", "[HDBSCANTest]")
+{
+  arma::mat points;
+  GaussiansWithOutliers(points);
+
+  arma::Row<size_t> assignments;
+  HDBSCAN<> h(20, 5);
+  REQUIRE(h.Cluster(points, assignments) == 3);
+  REQUIRE(assignments[600] == SIZE_MAX);
+
+  h.MinPoints() = 1;
+  REQUIRE(h.Cluster(points, assignments) >= 3);
+  REQUIRE(assignments.n_elem == points.n_cols);
+  REQUIRE(assignments[600] == SIZE_MAX);
+}
+
+/**
+ * Check that one Gaussian is returned as a single cluster only if that is
+ * allowed.
+ */
+TEST_CASE("HDBSCANSingleClusterTest", "[HDBSCANTest]")
+{
+  arma::mat points(2, 300, arma::fill::randn);
+
+  arma::Row<size_t> assignments;
+  HDBSCAN<> h(150, 10, true);
+  REQUIRE(h.Cluster(points, assignments) == 1);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    REQUIRE(assignments[i] == 0);
+
+  // No split creates two clusters of 150 points, so without the root cluster
+  // everything is noise.
+  h.AllowSingleCluster() = false;
+  REQUIRE(h.Cluster(points, assignments) == 0);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    REQUIRE(assignments[i] == SIZE_MAX);
+}
+
+/**
+ * Check that duplicate points don't break the cluster selection.
+ */
+TEST_CASE("HDBSCANDuplicatePointsTest", "[HDBSCANTest]")
+{
+  arma::mat points(2, 60);
+  points.cols(0, 29).zeros();
+  points.cols(30, 59).fill(10.0);
+
+  arma::Row<size_t> assignments;
+  arma::rowvec probabilities;
+  HDBSCAN<> h(10);
+  REQUIRE(h.Cluster(points, assignments, probabilities) == 2);
+  for (size_t i = 0; i < points.n_cols; ++i)
+  {
+    REQUIRE(assignments[i] == assignments[30 * (i / 30)]);
+    REQUIRE(probabilities[i] == Approx(1.0));
+  }
+  REQUIRE(assignments[0] != assignments[30]);
+}
+
+/**
+ * Check the handling of small datasets and invalid parameters.
+ */
+TEST_CASE("HDBSCANInvalidParametersTest", "[HDBSCANTest]")
+{
+  arma::mat points(3, 10, arma::fill::randu);
+  arma::Row<size_t> assignments;
+
+  // Fewer points than a cluster: everything is noise.
+  HDBSCAN<> h(20);
+  REQUIRE(h.Cluster(points, assignments) == 0);
+  REQUIRE(assignments.n_elem == 10);
+  for (size_t i = 0; i < points.n_cols; ++i)
+    REQUIRE(assignments[i] == SIZE_MAX);
+
+  HDBSCAN<> h2(1);
+  REQUIRE_THROWS_AS(h2.Cluster(points, assignments), std::invalid_argument);
+
+  HDBSCAN<> h3(5, 11);
+  REQUIRE_THROWS_AS(h3.Cluster(points, assignments), std::invalid_argument);
+}
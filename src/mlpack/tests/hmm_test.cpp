@@ -1507,6 +1507,181 @@ TEST_CASE("HMMTrainReturnLogLikelihood", "[HMMTest]")
   REQUIRE(std::isfinite(loglik) == true);
 }
 
+/**
+ * Baum-Welch training on many sequences of different lengths (processed in
+ * parallel) should not depend on the order of the sequences.
+ */
+TEST_CASE("HMMTrainSequenceOrderTest", "[HMMTest]")
+{
+  HMM<DiscreteDistribution<>> hmm(3, DiscreteDistribution<>(4));
+  hmm.Transition() = arma::mat("0.6 0.2 0.3; 0.3 0.6 0.1; 0.1 0.2 0.6");
+  hmm.Emission()[0].Probabilities() = "0.7 0.1 0.1 0.1";
+  hmm.Emission()[1].Probabilities() = "0.1 0.7 0.1 0.1";
+  hmm.Emission()[2].Probabilities() = "0.1 0.1 0.4 0.4";
+
+  // Generate sequences of lengths from 1 to 40.
+  std::vector<arma::mat> observations;
+  for (size_t i = 0; i < 200; ++i)
+  {
+    arma::mat dataSeq;
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(1 + (i % 40), dataSeq, stateSeq);
+    observations.push_back(dataSeq);
+  }
+
+  std::vector<arma::mat> reversed(observations.rbegin(), observations.rend());
+
+  HMM<DiscreteDistribution<>> hmm1(hmm), hmm2(hmm);
+  const double loglik1 = hmm1.Train(observations);
+  const double loglik2 = hmm2.Train(reversed);
+
+  REQUIRE(loglik1 == Approx(loglik2).epsilon(1e-6));
+  REQUIRE(arma::approx_equal(hmm1.Transition(), hmm2.Transition(), "absdiff",
+      1e-4));
+  REQUIRE(arma::approx_equal(hmm1.Initial(), hmm2.Initial(), "absdiff",
+      1e-4));
+  for (size_t i = 0; i < 3; ++i)
+  {
+    REQUIRE(arma::approx_equal(hmm1.Emission()[i].Probabilities(),
+        hmm2.Emission()[i].Probabilities(), "absdiff", 1e-4));
+  }
+}
+
+/**
+ * Make sure that the batched Predict() and LogLikelihood() give the same
+ * results as calling them on each sequence, for discrete and Gaussian HMMs.
+ */
+TEST_CASE("HMMBatchPredictLogLikelihoodTest", "[HMMTest]")
+{
+  HMM<DiscreteDistribution<>> hmm(3, DiscreteDistribution<>(4));
+  hmm.Transition() = arma::mat("0.6 0.2 0.3; 0.3 0.6 0.1; 0.1 0.2 0.6");
+  hmm.Emission()[0].Probabilities() = "0.7 0.1 0.1 0.1";
+  hmm.Emission()[1].Probabilities() = "0.1 0.7 0.1 0.1";
+  hmm.Emission()[2].Probabilities() = "0.1 0.1 0.4 0.4";
+
+  HMM<GaussianDistribution<>> gHmm(2, GaussianDistribution<>(2));
+  gHmm.Transition() = arma::mat("0.9 0.2; 0.1 0.8");
+  gHmm.Emission()[0] = GaussianDistribution<>("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  gHmm.Emission()[1] = GaussianDistribution<>("3.0 1.0", "0.5 0.1; 0.1 0.8");
+
+  std::vector<arma::mat> observations, gObservations;
+  for (size_t i = 0; i < 50; ++i)
+  {
+    arma::mat dataSeq;
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(1 + (i % 25), dataSeq, stateSeq);
+    observations.push_back(dataSeq);
+    gHmm.Generate(1 + (i % 25), dataSeq, stateSeq);
+    gObservations.push_back(dataSeq);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs, gStateSeqs;
+  const arma::vec viterbi = hmm.Predict(observations, stateSeqs);
+  const arma::vec gViterbi = gHmm.Predict(gObservations, gStateSeqs);
+  const arma::vec logLikelihoods = hmm.LogLikelihood(observations);
+  const arma::vec gLogLikelihoods = gHmm.LogLikelihood(gObservations);
+
+  REQUIRE(stateSeqs.size() == observations.size());
+  REQUIRE(gStateSeqs.size() == gObservations.size());
+  REQUIRE(viterbi.n_elem == observations.size());
+  REQUIRE(logLikelihoods.n_elem == observations.size());
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> stateSeq;
+    REQUIRE(viterbi[i] ==
+        Approx(hmm.Predict(observations[i], stateSeq)).epsilon(1e-10));
+    REQUIRE(arma::all(stateSeqs[i] == stateSeq));
+    REQUIRE(logLikelihoods[i] ==
+        Approx(hmm.LogLikelihood(observations[i])).epsilon(1e-10));
+
+    REQUIRE(gViterbi[i] ==
+        Approx(gHmm.Predict(gObservations[i], stateSeq)).epsilon(1e-10));
+    REQUIRE(arma::all(gStateSeqs[i] == stateSeq));
+    REQUIRE(gLogLikelihoods[i] ==
+        Approx(gHmm.LogLikelihood(gObservations[i])).epsilon(1e-10));
+
+    // The most likely state sequence can't be more likely than the sequence.
+    REQUIRE(viterbi[i] <= logLikelihoods[i] + 1e-10);
+    REQUIRE(gViterbi[i] <= gLogLikelihoods[i] + 1e-10);
+  }
+}
+
+/**
+ * Make sure that an HMM with a sparse (left-to-right) transition matrix gives
+ * the same results as an HMM whose zero transitions are replaced by tiny
+ * nonzero transitions, which uses the dense computations.
+ */
+TEST_CASE("HMMSparseTransitionTest", "[HMMTest]")
+{
+  const size_t states = 40;
+  arma::mat transition(states, states, arma::fill::zeros);
+  for (size_t i = 0; i < states - 1; ++i)
+  {
+    transition(i, i) = 0.7;
+    transition(i + 1, i) = 0.3;
+  }
+  transition(states - 1, states - 1) = 1.0;
+  const arma::mat denseTransition = transition + 1e-300;
+
+  // Every state can be the first, so that all of them are visited in the
+  // training.
+  const arma::vec initial = arma::ones<arma::vec>(states) / states;
+
+  std::vector<DiscreteDistribution<>> emissions(states,
+      DiscreteDistribution<>(4));
+  for (size_t i = 0; i < states; ++i)
+  {
+    emissions[i].Probabilities().fill(0.1);
+    emissions[i].Probabilities()[i % 4] = 0.7;
+  }
+
+  HMM<DiscreteDistribution<>> hmm(initial, transition, emissions, 1e-3);
+  HMM<DiscreteDistribution<>> denseHmm(initial, denseTransition, emissions,
+      1e-3);
+
+  std::vector<arma::mat> observations;
+  for (size_t i = 0; i < 5; ++i)
+  {
+    arma::mat dataSeq;
+    arma::Row<size_t> stateSeq;
+    hmm.Generate(60, dataSeq, stateSeq, 8 * i);
+    observations.push_back(dataSeq);
+  }
+
+  std::vector<arma::Row<size_t>> stateSeqs, denseStateSeqs;
+  const arma::vec viterbi = hmm.Predict(observations, stateSeqs);
+  const arma::vec denseViterbi = denseHmm.Predict(observations,
+      denseStateSeqs);
+  const arma::vec logLikelihoods = hmm.LogLikelihood(observations);
+  const arma::vec denseLogLikelihoods = denseHmm.LogLikelihood(observations);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    REQUIRE(viterbi[i] == Approx(denseViterbi[i]).epsilon(1e-10));
+    REQUIRE(arma::all(stateSeqs[i] == denseStateSeqs[i]));
+    REQUIRE(logLikelihoods[i] ==
+        Approx(denseLogLikelihoods[i]).epsilon(1e-10));
+
+    // The states can only move forward.
+    for (size_t t = 1; t < stateSeqs[i].n_elem; ++t)
+      REQUIRE(stateSeqs[i][t] >= stateSeqs[i][t - 1]);
+  }
+
+  const double loglik = hmm.Train(observations);
+  const double denseLoglik = denseHmm.Train(observations);
+  REQUIRE(loglik == Approx(denseLoglik).epsilon(1e-8));
+  REQUIRE(arma::approx_equal(hmm.Transition(), denseHmm.Transition(),
+      "absdiff", 1e-8));
+  for (size_t i = 0; i < states; ++i)
+  {
+    REQUIRE(arma::approx_equal(hmm.Emission()[i].Probabilities(),
+        denseHmm.Emission()[i].Probabilities(), "absdiff", 1e-8));
+  }
+
+  // Training keeps the zero transitions at zero.
+  REQUIRE(arma::all(arma::vectorise(hmm.Transition()(arma::find(
+      transition == 0.0))) == 0.0));
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
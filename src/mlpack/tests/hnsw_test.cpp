@@ -0,0 +1,232 @@
+/**
+ * @file tests/hnsw_test.cpp
+ *
+ * Tests for the HNSWSearch class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/hnsw.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the graph has the structure of an HNSW graph: no point has
+ * too many neighbors, all neighbors exist on the level, and the entry point
+ * is on the top level.
+ */
+TEST_CASE("HNSWGraphStructureTest", "[HNSWTest]")
+{
+  arma::fmat dataset(10, 3000, arma::fill::randu);
+  HNSWSearch<> hnsw(dataset, 8, 50);
+
+  REQUIRE(hnsw.ReferenceSet().n_cols == 3000);
+  size_t maxLevel = 0;
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    maxLevel = std::max(maxLevel, hnsw.Level(i));
+    for (size_t l = 0; l <= hnsw.Level(i); ++l)
+    {
+      const std::vector<size_t>& neighbors = hnsw.Neighbors(i, l);
+      REQUIRE(neighbors.size() <= ((l == 0) ? 16 : 8));
+      for (const size_t n : neighbors)
+      {
+        REQUIRE(n < dataset.n_cols);
+        REQUIRE(n != i);
+        REQUIRE(hnsw.Level(n) >= l);
+      }
+    }
+
+    // Only the first point may be isolated.
+    if (i > 0)
+      REQUIRE(hnsw.Neighbors(i, 0).size() > 0);
+  }
+
+  REQUIRE(hnsw.MaxLevel() == maxLevel);
+  REQUIRE(maxLevel > 0);
+}
+
+/**
+ * Make sure that the recall of HNSW search on high-dimensional data is high
+ * when compared with exact search.
+ */
+TEST_CASE("HNSWRecallTest", "[HNSWTest]")
+{
+  arma::fmat referenceData(128, 4000, arma::fill::randn);
+  arma::fmat queryData(128, 200, arma::fill::randn);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::fmat> knn(
+      referenceData, NAIVE_MODE);
+  arma::Mat<size_t> trueNeighbors, neighbors;
+  arma::fmat trueDistances, distances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  HNSWSearch<> hnsw(referenceData);
+  hnsw.EfSearch() = 100;
+  hnsw.Search(queryData, 10, neighbors, distances);
+
+  REQUIRE(neighbors.n_rows == 10);
+  REQUIRE(neighbors.n_cols == 200);
+  REQUIRE(distances.n_rows == 10);
+  REQUIRE(distances.n_cols == 200);
+  REQUIRE(NeighborSearch<>::Recall(neighbors, trueNeighbors) >= 0.9);
+
+  // Fewer distances should be computed than with a linear scan.
+  REQUIRE(hnsw.DistanceEvaluations() < queryData.n_cols *
+      referenceData.n_cols / 2);
+
+  // The distances must be sorted and correct.
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+    {
+      REQUIRE(distances(j, i) == Approx(arma::norm(queryData.col(i) -
+          referenceData.col(neighbors(j, i)))).epsilon(1e-4));
+      if (j > 0)
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+    }
+  }
+
+  // A larger EfSearch() gives a recall at least as good.
+  arma::Mat<size_t> moreNeighbors;
+  hnsw.EfSearch() = 400;
+  hnsw.Search(queryData, 10, moreNeighbors, distances);
+  REQUIRE(NeighborSearch<>::Recall(moreNeighbors, trueNeighbors) >=
+      NeighborSearch<>::Recall(neighbors, trueNeighbors) - 0.01);
+}
+
+/**
+ * Make sure that monochromatic search does not return the query point
+ * itself, and finds the neighbors of low-dimensional data nearly exactly.
+ */
+TEST_CASE("HNSWMonochromaticTest", "[HNSWTest]")
+{
+  arma::mat dataset(3, 2000, arma::fill::randu);
+
+  KNN knn(dataset);
+  arma::Mat<size_t> trueNeighbors, neighbors;
+  arma::mat trueDistances, distances;
+  knn.Search(5, trueNeighbors, trueDistances);
+
+  HNSWSearch<EuclideanDistance, arma::mat> hnsw(dataset);
+  hnsw.Search(5, neighbors, distances);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    for (size_t j = 0; j < 5; ++j)
+      REQUIRE(neighbors(j, i) != i);
+
+  REQUIRE(KNN::Recall(neighbors, trueNeighbors) >= 0.98);
+}
+
+/**
+ * Make sure that points can be inserted after training, and that an
+ * inserted point is found as its own nearest neighbor.
+ */
+TEST_CASE("HNSWInsertTest", "[HNSWTest]")
+{
+  arma::fmat dataset(20, 2000, arma::fill::randu);
+  arma::fmat newPoints(20, 500, arma::fill::randu);
+
+  HNSWSearch<> hnsw(dataset);
+  hnsw.Insert(newPoints);
+  REQUIRE(hnsw.ReferenceSet().n_cols == 2500);
+
+  arma::Mat<size_t> neighbors;
+  arma::fmat distances;
+  hnsw.Search(newPoints, 1, neighbors, distances);
+
+  size_t found = 0;
+  for (size_t i = 0; i < newPoints.n_cols; ++i)
+    if (neighbors(0, i) == 2000 + i)
+      ++found;
+  REQUIRE(found >= 495);
+
+  REQUIRE_THROWS_AS(hnsw.Insert(arma::fmat(19, 10, arma::fill::randu)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the graph does not depend on the number of threads.
+ */
+TEST_CASE("HNSWDeterministicTest", "[HNSWTest]")
+{
+  arma::fmat dataset(16, 3000, arma::fill::randu);
+
+  RandomSeed(7);
+  HNSWSearch<> hnsw1(dataset);
+  #ifdef MLPACK_USE_OPENMP
+  const int threads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+  RandomSeed(7);
+  HNSWSearch<> hnsw2(dataset);
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(threads);
+  #endif
+
+  REQUIRE(hnsw1.MaxLevel() == hnsw2.MaxLevel());
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(hnsw1.Level(i) == hnsw2.Level(i));
+    for (size_t l = 0; l <= hnsw1.Level(i); ++l)
+      REQUIRE(hnsw1.Neighbors(i, l) == hnsw2.Neighbors(i, l));
+  }
+}
+
+/**
+ * Make sure that a saved and loaded model gives the same results.
+ */
+TEST_CASE("HNSWSerializationTest", "[HNSWTest]")
+{
+  arma::fmat dataset(32, 2000, arma::fill::randu);
+  arma::fmat queries(32, 100, arma::fill::randu);
+
+  HNSWSearch<> hnsw(dataset, 12, 100, 80);
+  arma::Mat<size_t> neighbors;
+  arma::fmat distances;
+  hnsw.Search(queries, 5, neighbors, distances);
+
+  REQUIRE(data::Save("hnsw_model.bin", "hnsw_model", hnsw));
+  HNSWSearch<> loaded;
+  REQUIRE(data::Load("hnsw_model.bin", "hnsw_model", loaded));
+  remove("hnsw_model.bin");
+
+  REQUIRE(loaded.M() == 12);
+  REQUIRE(loaded.EfConstruction() == 100);
+  REQUIRE(loaded.EfSearch() == 80);
+
+  arma::Mat<size_t> loadedNeighbors;
+  arma::fmat loadedDistances;
+  loaded.Search(queries, 5, loadedNeighbors, loadedDistances);
+  CheckMatrices(neighbors, loadedNeighbors);
+  CheckMatrices(distances, loadedDistances);
+}
+
+/**
+ * Make sure that invalid searches throw.
+ */
+TEST_CASE("HNSWInvalidSearchTest", "[HNSWTest]")
+{
+  arma::Mat<size_t> neighbors;
+  arma::fmat distances;
+
+  HNSWSearch<> untrained;
+  REQUIRE_THROWS_AS(untrained.Search(arma::fmat(5, 10, arma::fill::randu), 1,
+      neighbors, distances), std::invalid_argument);
+
+  HNSWSearch<> hnsw(arma::fmat(5, 100, arma::fill::randu));
+  REQUIRE_THROWS_AS(hnsw.Search(arma::fmat(5, 10, arma::fill::randu), 101,
+      neighbors, distances), std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(arma::fmat(4, 10, arma::fill::randu), 1,
+      neighbors, distances), std::invalid_argument);
+  REQUIRE_THROWS_AS(hnsw.Search(100, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(HNSWSearch<>(1), std::invalid_argument);
+}
@@ -1835,3 +1835,141 @@ TEST_CASE("HoeffdingTreeCategoricalFloatDataTest", "[HoeffdingTreeTest]")
   REQUIRE(accu(batchPredictions == labels) > (labels.n_elem / 2));
   REQUIRE(accu(streamPredictions == labels) > (labels.n_elem / 2));
 }
+
+/**
+ * Make sure that streaming training on a whole dataset (which routes batches of
+ * points to the leaves before training the leaves in parallel) gives the same
+ * tree as training on one point at a time.
+ */
+TEST_CASE("HoeffdingTreeBatchedStreamingTest", "[HoeffdingTreeTest]")
+{
+  // Use more points than one streaming batch.
+  const size_t numPoints = 3 * HoeffdingTree<>::StreamingBatchSize + 100;
+  arma::mat dataset(4, numPoints, arma::fill::randu);
+  arma::Row<size_t> labels(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    labels[i] = i % 3;
+    dataset(labels[i], i) += 0.5;
+  }
+
+  data::DatasetInfo info(4);
+  HoeffdingTree<> streamTree(dataset, info, labels, 3, false);
+  HoeffdingTree<> pointTree(info, 3);
+  for (size_t i = 0; i < numPoints; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  REQUIRE(streamTree.NumChildren() > 0);
+  REQUIRE(streamTree.NumDescendants() == pointTree.NumDescendants());
+
+  arma::Row<size_t> streamPredictions, pointPredictions;
+  arma::rowvec streamProbabilities, pointProbabilities;
+  streamTree.Classify(dataset, streamPredictions, streamProbabilities);
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+  REQUIRE(arma::all(streamPredictions == pointPredictions));
+  REQUIRE(arma::approx_equal(streamProbabilities, pointProbabilities,
+      "absdiff", 0.0));
+}
+
+/**
+ * Make sure that ADWIN keeps its whole window when the mean of the stream does
+ * not change, and drops the old part of the window when it does.
+ */
+TEST_CASE("ADWINChangeDetectionTest", "[HoeffdingTreeTest]")
+{
+  ADWIN adwin;
+  bool change = false;
+  for (size_t i = 0; i < 2000; ++i)
+    change |= adwin.Update((i % 10 < 2) ? 1.0 : 0.0);
+
+  REQUIRE(!change);
+  REQUIRE(adwin.Width() == 2000);
+  REQUIRE(adwin.Estimation() == Approx(0.2).epsilon(1e-5));
+
+  for (size_t i = 0; i < 2000; ++i)
+    change |= adwin.Update((i % 10 < 8) ? 1.0 : 0.0);
+
+  REQUIRE(change);
+  REQUIRE(adwin.Width() < 4000);
+  REQUIRE(adwin.Estimation() > 0.7);
+}
+
+/**
+ * Make sure that a memory budget limits the number of active leaves.
+ */
+TEST_CASE("HoeffdingTreeMaxActiveLeavesTest", "[HoeffdingTreeTest]")
+{
+  arma::mat dataset(2, 20000, arma::fill::randu);
+  arma::Row<size_t> labels(20000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+    labels[i] = (size_t) (4 * dataset(0, i)) + 4 * (size_t) (2 * dataset(1, i));
+
+  data::DatasetInfo info(2);
+  HoeffdingTree<> tree(info, 8);
+  tree.MaxActiveLeaves(3);
+  tree.Train(dataset, labels, 8, false);
+
+  // Count the leaves, and the active leaves.
+  size_t numLeaves = 0;
+  size_t numActive = 0;
+  std::stack<const HoeffdingTree<>*> stack;
+  stack.push(&tree);
+  while (!stack.empty())
+  {
+    const HoeffdingTree<>* node = stack.top();
+    stack.pop();
+    if (node->NumChildren() == 0)
+    {
+      ++numLeaves;
+      if (node->IsActive())
+        ++numActive;
+    }
+
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      stack.push(&node->Child(i));
+  }
+
+  REQUIRE(numLeaves > 3);
+  REQUIRE(numActive <= 3);
+
+  // The tree still classifies points.
+  arma::Row<size_t> predictions;
+  tree.Classify(dataset, predictions);
+  REQUIRE(accu(predictions == labels) > labels.n_elem / 4);
+}
+
+/**
+ * Make sure that drift detection lets a tree adapt to a changed concept.
+ */
+TEST_CASE("HoeffdingTreeDriftDetectionTest", "[HoeffdingTreeTest]")
+{
+  // In the first concept, the label is 1 if the first dimension is greater
+  // than 0.5; in the second concept, the labels are flipped.
+  arma::mat dataset(2, 40000, arma::fill::randu);
+  arma::Row<size_t> labels(40000);
+  for (size_t i = 0; i < labels.n_elem; ++i)
+  {
+    const bool greater = (dataset(0, i) > 0.5);
+    labels[i] = (i < 20000) ? greater : !greater;
+  }
+
+  data::DatasetInfo info(2);
+  HoeffdingTree<> driftTree(info, 2);
+  driftTree.DriftDetection(true);
+  HoeffdingTree<> tree(info, 2);
+  driftTree.Train(dataset, labels, 2, false);
+  tree.Train(dataset, labels, 2, false);
+
+  arma::mat testDataset(2, 1000, arma::fill::randu);
+  arma::Row<size_t> testLabels(1000);
+  for (size_t i = 0; i < testLabels.n_elem; ++i)
+    testLabels[i] = (testDataset(0, i) <= 0.5);
+
+  arma::Row<size_t> driftPredictions, predictions;
+  driftTree.Classify(testDataset, driftPredictions);
+  tree.Classify(testDataset, predictions);
+
+  const size_t driftCorrect = accu(driftPredictions == testLabels);
+  REQUIRE(driftCorrect > 850);
+  REQUIRE(driftCorrect > accu(predictions == testLabels));
+}
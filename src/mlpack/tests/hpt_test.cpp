@@ -53,6 +53,52 @@ TEST_CASE("CVFunctionTest", "[HPTTest]")
   REQUIRE(expected == Approx(actual).epsilon(1e-7));
 }
 
+/**
+ * Test CVFunction memoizes the objectives of parameters it has already
+ * evaluated, and counts the hits and misses.
+ */
+TEST_CASE("CVFunctionMemoizationTest", "[HPTTest]")
+{
+  arma::mat xs = arma::randn(5, 100);
+  arma::vec beta = arma::randn(5, 1);
+  arma::rowvec ys = beta.t() * xs + 0.1 * arma::randn(1, 100);
+
+  SimpleCV<LARS<>, MSE> cv(0.2, xs, ys);
+
+  IncrementPolicy policy(true);
+  DatasetMapper<IncrementPolicy, double> datasetInfo(policy, 2);
+
+  FixedArg<bool, 0> fixedTransposeData{true};
+  FixedArg<bool, 1> fixedUseCholesky{false};
+  CVFunction<decltype(cv), LARS<>, 4, FixedArg<bool, 0>, FixedArg<bool, 1>>
+      cvFun(cv, datasetInfo, 0.0, 1e-3, fixedTransposeData, fixedUseCholesky);
+
+  arma::vec parameters("0.1 0.2");
+  const double objective = cvFun.Evaluate(parameters);
+  REQUIRE(cvFun.Evaluate(parameters) == objective);
+  REQUIRE(cvFun.CacheHits() == 1);
+  REQUIRE(cvFun.CacheMisses() == 1);
+
+  // The gradient evaluates the parameters again (a hit), and each increased
+  // parameter once.
+  arma::mat gradient;
+  cvFun.Gradient(parameters, gradient);
+  REQUIRE(cvFun.CacheHits() == 2);
+  REQUIRE(cvFun.CacheMisses() == 3);
+
+  // Partial evaluations are memoized separately for each budget.
+  const double partialObjective = cvFun.PartialEvaluate(parameters, 0.5);
+  REQUIRE(cvFun.PartialEvaluate(parameters, 0.5) == partialObjective);
+  REQUIRE(cvFun.PartialEvaluate(parameters, 1.0) == objective);
+  REQUIRE(cvFun.CacheHits() == 4);
+  REQUIRE(cvFun.CacheMisses() == 4);
+
+  cvFun.Memoize() = false;
+  REQUIRE(cvFun.Evaluate(parameters) == Approx(objective).epsilon(1e-7));
+  REQUIRE(cvFun.CacheHits() == 4);
+  REQUIRE(cvFun.CacheMisses() == 5);
+}
+
 /**
  * Test CVFunction runs cross-validation in according with specified fixed
  * arguments and passed parameters, where the passed parameters are categorical
@@ -315,6 +361,100 @@ TEST_CASE("HPTTest", "[HPTTest]")
   REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
 }
 
+/**
+ * Test that HyperParameterTuner with ParallelGridSearch finds the same
+ * hyper-parameters and best model as with GridSearch, for any number of
+ * threads.
+ */
+TEST_CASE("HPTParallelGridSearchTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  size_t validationFirstColumn = round(xs.n_cols * (1.0 - validationSize));
+  arma::mat validationXs = xs.cols(validationFirstColumn, xs.n_cols - 1);
+  arma::rowvec validationYs = ys.cols(validationFirstColumn, ys.n_cols - 1);
+
+  for (size_t threads : { 0, 1, 3 })
+  {
+    double actualLambda1, actualLambda2;
+    HyperParameterTuner<LARS<>, MSE, SimpleCV, ParallelGridSearch>
+        hpt(validationSize, xs, ys);
+    hpt.Optimizer().Threads() = threads;
+    std::tie(actualLambda1, actualLambda2) = hpt.Optimize(
+        Fixed(transposeData), Fixed(useCholesky), lambda1Set, lambda2Set);
+
+    REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+    REQUIRE(expectedLambda1 == Approx(actualLambda1).epsilon(1e-7));
+    REQUIRE(expectedLambda2 == Approx(actualLambda2).epsilon(1e-7));
+
+    double objective = MSE::Evaluate(hpt.BestModel(), validationXs,
+        validationYs);
+    REQUIRE(expectedObjective == Approx(objective).epsilon(1e-7));
+  }
+}
+
+/**
+ * Test HyperParameterTuner with SuccessiveHalving: with a minimum budget of 1
+ * it is a grid search, and otherwise the returned objective is the one of the
+ * returned hyper-parameters with the full budget.
+ */
+TEST_CASE("HPTSuccessiveHalvingTest", "[HPTTest]")
+{
+  arma::mat xs;
+  arma::rowvec ys;
+  double validationSize;
+  InitProneToOverfittingData(xs, ys, validationSize);
+
+  bool transposeData = true;
+  bool useCholesky = false;
+  arma::vec lambda1Set("0 0.001 0.01 0.1 1.0 10.0 100.0");
+  arma::vec lambda2Set("0.0 0.05 0.5 5.0");
+
+  double expectedLambda1, expectedLambda2, expectedObjective;
+  FindLARSBestLambdas(xs, ys, validationSize, transposeData, useCholesky,
+      lambda1Set, lambda2Set, expectedLambda1, expectedLambda2,
+      expectedObjective);
+
+  double actualLambda1, actualLambda2;
+  HyperParameterTuner<LARS<>, MSE, SimpleCV, SuccessiveHalving>
+      hpt(validationSize, xs, ys);
+  hpt.Optimizer().MinBudget() = 1.0;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  REQUIRE(expectedObjective == Approx(hpt.BestObjective()).epsilon(1e-7));
+  REQUIRE(expectedLambda1 == Approx(actualLambda1).epsilon(1e-7));
+  REQUIRE(expectedLambda2 == Approx(actualLambda2).epsilon(1e-7));
+
+  hpt.Optimizer().MinBudget() = 0.25;
+  hpt.Optimizer().Eta() = 2.0;
+  std::tie(actualLambda1, actualLambda2) = hpt.Optimize(Fixed(transposeData),
+      Fixed(useCholesky), lambda1Set, lambda2Set);
+
+  SimpleCV<LARS<>, MSE> cv(validationSize, xs, ys);
+  const double objective = cv.Evaluate(transposeData, useCholesky,
+      actualLambda1, actualLambda2);
+  REQUIRE(hpt.BestObjective() == Approx(objective).epsilon(1e-7));
+  REQUIRE(hpt.BestObjective() >= expectedObjective - 1e-7);
+
+  hpt.Optimizer().Eta() = 1.0;
+  REQUIRE_THROWS_AS(hpt.Optimize(Fixed(transposeData), Fixed(useCholesky),
+      lambda1Set, lambda2Set), std::invalid_argument);
+}
+
 /**
  * Test HyperParamterTuner maximizes Accuracy rather than minimizes it.
  */
@@ -389,4 +529,7 @@ TEST_CASE("HPTGradientDescentTest", "[HPTTest]")
   std::tie(xOptimized, zOptimized) = hpt.Optimize(x0, Fixed(y), z0);
   REQUIRE(xOptimized == Approx(xMin).epsilon(1e-6));
   REQUIRE(zOptimized == Approx(zMin).epsilon(1e-6));
+
+  // Each gradient evaluates the current point again, which is memoized.
+  REQUIRE(hpt.CacheHits() > 0);
 }
@@ -399,3 +399,45 @@ TEMPLATE_TEST_CASE("ResizeCropUpscaleTest", "[ImageTest]", unsigned char,
   REQUIRE(info.Channels() == inputChannels);
   REQUIRE(image.n_elem == info.Height() * info.Width() * info.Channels());
 }
+
+/**
+ * Make sure that images of different sizes can be loaded together and resized
+ * as they are decoded, with the same results as resizing each one of them
+ * after loading it.
+ */
+TEST_CASE("LoadResizedImagesTest", "[ImageTest]")
+{
+  std::vector<std::string> files =
+      {"sheep_1.jpg", "sheep_2.jpg", "sheep_3.jpg", "sheep_4.jpg",
+       "sheep_5.jpg", "sheep_6.jpg", "sheep_7.jpg", "sheep_8.jpg",
+       "sheep_9.jpg"};
+
+  // The images do not have the same sizes, so they can't be loaded together
+  // without resizing them.
+  arma::Mat<unsigned char> images;
+  data::ImageInfo info;
+  REQUIRE(data::Load(files, images, info, false) == false);
+
+  for (const bool crop : { false, true })
+  {
+    data::ImageInfo resizedInfo;
+    REQUIRE(data::Load(files, images, resizedInfo, 64, 64, crop) == true);
+    REQUIRE(resizedInfo.Width() == 64);
+    REQUIRE(resizedInfo.Height() == 64);
+    REQUIRE(images.n_rows == 64 * 64 * resizedInfo.Channels());
+    REQUIRE(images.n_cols == files.size());
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+      arma::Mat<unsigned char> image;
+      data::ImageInfo imageInfo;
+      REQUIRE(data::Load(files[i], image, imageInfo) == true);
+      if (crop)
+        ResizeCropImages(image, imageInfo, 64, 64);
+      else
+        ResizeImages(image, imageInfo, 64, 64);
+
+      REQUIRE(arma::all(images.col(i) == image));
+    }
+  }
+}
@@ -304,3 +304,54 @@ TEST_CASE("DatasetMapperPointerMapping", "[ImputationTest]")
   REQUIRE(dm.UnmapString(1, 0) == &b);
   REQUIRE(dm.UnmapString(2, 0) == &c);
 }
+
+/**
+ * Impute several dimensions of a random matrix one at a time and all at once
+ * with the given strategy, and make sure that both give the same result.
+ */
+template<typename StrategyType>
+void CheckBatchImputation(StrategyType& strategy, const bool columnMajor)
+{
+  // About a tenth of the values are missing (0); points are columns if the
+  // matrix is column major, and rows otherwise.
+  arma::mat input = arma::randi<arma::mat>(6, 3001, arma::distr_param(1, 20));
+  input.elem(arma::find(arma::randu<arma::mat>(6, 3001) < 0.1)).zeros();
+  if (!columnMajor)
+    input = input.t();
+
+  const std::vector<size_t> dimensions = { 0, 2, 3, 5 };
+  const std::vector<double> mappedValues(dimensions.size(), 0.0);
+
+  arma::mat sequential(input);
+  for (size_t d : dimensions)
+    strategy.Impute(sequential, 0.0, d, columnMajor);
+
+  strategy.Impute(input, mappedValues, dimensions, columnMajor);
+  CheckMatrices(sequential, input);
+}
+
+/**
+ * Make sure that imputing all dimensions at once gives the same result as
+ * imputing them one by one, for each strategy.
+ */
+TEST_CASE("BatchImputationTest", "[ImputationTest]")
+{
+  for (const bool columnMajor : { true, false })
+  {
+    MeanImputation<double> mean;
+    CheckBatchImputation(mean, columnMajor);
+    MedianImputation<double> median;
+    CheckBatchImputation(median, columnMajor);
+    CustomImputation<double> custom(99);
+    CheckBatchImputation(custom, columnMajor);
+    ListwiseDeletion<double> listwise;
+    CheckBatchImputation(listwise, columnMajor);
+  }
+
+  // The median of an even number of elements is the average of the middle
+  // elements.
+  arma::mat input("3.0 0.0 1.0 4.0 2.0");
+  MedianImputation<double> median;
+  median.Impute(input, 0.0, 0, true);
+  REQUIRE(input(0, 1) == Approx(2.5).epsilon(1e-7));
+}
@@ -26,6 +26,7 @@ using Option = mlpack::bindings::cli::CLIOption<T>;
 #include <mlpack/core/util/param.hpp>
 #include <mlpack/bindings/cli/parse_command_line.hpp>
 #include <mlpack/bindings/cli/end_program.hpp>
+#include <mlpack/bindings/cli/serve.hpp>
 
 #include "catch.hpp"
 
@@ -94,6 +95,74 @@ TEST_CASE("TestOption", "[IOTest]")
   REQUIRE(p.Get<int>("test") == 42);
 }
 
+/**
+ * Make sure that each call to IO::Parameters() returns a fresh copy of the
+ * default parameters, even though the result is cached, and that parameters
+ * added after a call are seen by the next one.
+ */
+TEST_CASE("TestParametersCache", "[IOTest]")
+{
+  AddRequiredCLIOptions("TestParametersCache");
+
+  #define BINDING_NAME TestParametersCache
+  PARAM_IN(int, "test", "test desc", "", 42, false);
+  #undef BINDING_NAME
+
+  util::Params p = IO::Parameters("TestParametersCache");
+  p.Get<int>("test") = 5;
+  p.SetPassed("test");
+  REQUIRE(p.Get<int>("test") == 5);
+
+  util::Params p2 = IO::Parameters("TestParametersCache");
+  REQUIRE(p2.Get<int>("test") == 42);
+  REQUIRE(!p2.Has("test"));
+  REQUIRE(!p2.Parameters().count("test2"));
+
+  #define BINDING_NAME TestParametersCache
+  PARAM_IN(int, "test2", "test desc", "", 7, false);
+  #undef BINDING_NAME
+
+  util::Params p3 = IO::Parameters("TestParametersCache");
+  REQUIRE(p3.Get<int>("test") == 42);
+  REQUIRE(p3.Get<int>("test2") == 7);
+}
+
+/**
+ * Make sure that Params objects given back with IO::ReleaseParameters() are
+ * reused, with their values reset to the defaults.
+ */
+TEST_CASE("TestAcquireReleaseParameters", "[IOTest]")
+{
+  AddRequiredCLIOptions("TestAcquireReleaseParameters");
+
+  #define BINDING_NAME TestAcquireReleaseParameters
+  PARAM_IN(int, "test", "test desc", "", 42, false);
+  PARAM_IN(std::string, "name", "test desc", "", "default", false);
+  #undef BINDING_NAME
+
+  util::Params* p = IO::AcquireParameters("TestAcquireReleaseParameters");
+  REQUIRE(p->BindingName() == "TestAcquireReleaseParameters");
+  p->Get<int>("test") = 5;
+  p->SetPassed("test");
+  p->Get<string>("name") = "changed";
+  IO::ReleaseParameters(p);
+
+  util::Params* p2 = IO::AcquireParameters("TestAcquireReleaseParameters");
+  REQUIRE(p2 == p);
+  REQUIRE(p2->Get<int>("test") == 42);
+  REQUIRE(!p2->Has("test"));
+  REQUIRE(p2->Get<string>("name") == "default");
+
+  // A second object is needed while the first one is in use.
+  util::Params* p3 = IO::AcquireParameters("TestAcquireReleaseParameters");
+  REQUIRE(p3 != p2);
+  REQUIRE(p3->Get<int>("test") == 42);
+
+  IO::ReleaseParameters(p2);
+  IO::ReleaseParameters(p3);
+  IO::ReleaseParameters(NULL);
+}
+
 /**
  * Test that duplicate flags are filtered out correctly.
  */
@@ -1252,3 +1321,119 @@ TEST_CASE("CppNameTest", "[IOTest]")
   REQUIRE(p.Parameters().at("help").cppType == "bool");
   REQUIRE(p.Parameters().at("double").cppType == "double");
 }
+
+/**
+ * Make sure that requests are split into arguments correctly.
+ */
+TEST_CASE("SplitRequestTest", "[IOTest]")
+{
+  vector<string> args = SplitRequest("  --test_file a.csv\t-v ");
+  REQUIRE(args.size() == 3);
+  REQUIRE(args[0] == "--test_file");
+  REQUIRE(args[1] == "a.csv");
+  REQUIRE(args[2] == "-v");
+
+  args = SplitRequest("--name \"a b.csv\" --other 'c \"d' ''");
+  REQUIRE(args.size() == 5);
+  REQUIRE(args[1] == "a b.csv");
+  REQUIRE(args[3] == "c \"d");
+  REQUIRE(args[4] == "");
+
+  REQUIRE(SplitRequest("   ").empty());
+  REQUIRE_THROWS_AS(SplitRequest("--name \"a.csv"), std::invalid_argument);
+}
+
+/**
+ * Test that the serving mode runs the binding once for each request, with the
+ * options of the command line and of the request, and that failed requests
+ * are reported.
+ */
+TEST_CASE("ServeRequestsTest", "[IOTest]")
+{
+  AddRequiredCLIOptions("ServeRequestsTest");
+
+  #define BINDING_NAME ServeRequestsTest
+  PARAM_INT_IN("a", "First value", "a", 0);
+  PARAM_INT_IN("b", "Second value", "b", 0);
+  #undef BINDING_NAME
+
+  const char* argv[3];
+  argv[0] = "./test";
+  argv[1] = "--a";
+  argv[2] = "3";
+
+  vector<int> sums;
+  auto binding = [&sums](util::Params& p, util::Timers& /* timers */)
+  {
+    sums.push_back(p.Get<int>("a") + p.Get<int>("b"));
+  };
+
+  istringstream in("--b 4\n\n-b '5'\n--unknown 1\n--help\n");
+  ostringstream out;
+  Serve(3, const_cast<char**>(argv), binding, in, out, "ServeRequestsTest");
+
+  REQUIRE(sums.size() == 2);
+  REQUIRE(sums[0] == 7);
+  REQUIRE(sums[1] == 8);
+
+  istringstream results(out.str());
+  vector<string> lines;
+  string line;
+  while (getline(results, line))
+    lines.push_back(line);
+
+  REQUIRE(lines.size() == 4);
+  REQUIRE(lines[0] == "done");
+  REQUIRE(lines[1] == "done");
+  REQUIRE(lines[2].substr(0, 7) == "error: ");
+  REQUIRE(lines[3].substr(0, 7) == "error: ");
+}
+
+/**
+ * Test that the serving mode loads each input model only once, and loads it
+ * again when a request gives another file.
+ */
+TEST_CASE("ServeModelTest", "[IOTest]")
+{
+  GaussianKernel gk(0.5), gk2(1.5);
+  data::Save("kernel.json", "model", gk, true);
+  data::Save("kernel2.json", "model", gk2, true);
+
+  AddRequiredCLIOptions("ServeModelTest");
+
+  #define BINDING_NAME ServeModelTest
+  PARAM_MODEL_IN(GaussianKernel, "kernel", "Test kernel", "k");
+  #undef BINDING_NAME
+
+  const char* argv[1];
+  argv[0] = "./test";
+
+  vector<GaussianKernel*> kernels;
+  vector<double> bandwidths;
+  auto binding = [&](util::Params& p, util::Timers& /* timers */)
+  {
+    kernels.push_back(p.Get<GaussianKernel*>("kernel"));
+    bandwidths.push_back(kernels.back()->Bandwidth());
+  };
+
+  istringstream in("--kernel_file kernel.json\n"
+                   "--kernel_file kernel.json\n"
+                   "--kernel_file kernel2.json\n"
+                   "--kernel_file kernel2.json\n"
+                   "--kernel_file kernel.json\n");
+  ostringstream out;
+  Serve(1, const_cast<char**>(argv), binding, in, out, "ServeModelTest");
+
+  REQUIRE(out.str() == "done\ndone\ndone\ndone\ndone\n");
+  REQUIRE(kernels.size() == 5);
+  REQUIRE(kernels[1] == kernels[0]);
+  REQUIRE(kernels[3] == kernels[2]);
+  REQUIRE(bandwidths[0] == Approx(0.5));
+  REQUIRE(bandwidths[1] == Approx(0.5));
+  REQUIRE(bandwidths[2] == Approx(1.5));
+  REQUIRE(bandwidths[3] == Approx(1.5));
+  REQUIRE(bandwidths[4] == Approx(0.5));
+
+  remove("kernel.json");
+  remove("kernel2.json");
+}
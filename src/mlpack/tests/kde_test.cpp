@@ -1228,3 +1228,216 @@ TEST_CASE("GaussianBreadthDualKDTreeMonteCarloKDE", "[KDETest]")
 
   REQUIRE(correctResults > 70);
 }
+
+/**
+ * Test that multi-threaded single-tree and dual-tree evaluations are correct,
+ * with and without Monte Carlo estimations.
+ */
+TEST_CASE("ParallelKDETest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 3000);
+  arma::mat query = arma::randu(2, 500);
+  arma::vec bfEstimations = arma::vec(query.n_cols);
+  arma::vec treeEstimations;
+  const double relError = 0.05;
+
+  GaussianKernel kernel(0.3);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree> kde(relError, 0.0,
+      kernel);
+  kde.Train(reference);
+
+  kde.Mode() = KDEMode::KDE_DUAL_TREE_MODE;
+  kde.Evaluate(query, treeEstimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(treeEstimations[i] == Approx(bfEstimations[i]).epsilon(relError));
+
+  kde.Mode() = KDEMode::KDE_SINGLE_TREE_MODE;
+  kde.Evaluate(query, treeEstimations);
+  for (size_t i = 0; i < query.n_cols; ++i)
+    REQUIRE(treeEstimations[i] == Approx(bfEstimations[i]).epsilon(relError));
+
+  // With Monte Carlo estimations, we require a reasonable amount of results to
+  // be right.
+  kde.Mode() = KDEMode::KDE_DUAL_TREE_MODE;
+  kde.MonteCarlo() = true;
+  kde.Evaluate(query, treeEstimations);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  size_t correctResults = 0;
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    const double resultRelativeError =
+      std::abs((bfEstimations[i] - treeEstimations[i]) / bfEstimations[i]);
+    if (resultRelativeError < relError)
+      ++correctResults;
+  }
+
+  REQUIRE(correctResults > 175);
+}
+
+/**
+ * Test that evaluating several bandwidths at once gives the same results as
+ * brute force for each bandwidth, in all modes.
+ */
+TEST_CASE("MultiBandwidthKDETest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 1000);
+  arma::mat query = arma::randu(2, 200);
+  const arma::vec bandwidths = { 0.05, 0.2, 0.8 };
+  const double relError = 0.05;
+
+  KDE<EpanechnikovKernel, EuclideanDistance, arma::mat, KDTree> kde(relError,
+      0.0);
+  kde.Train(reference);
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    kde.Mode() = (m == 0) ? KDEMode::KDE_DUAL_TREE_MODE :
+        KDEMode::KDE_SINGLE_TREE_MODE;
+
+    arma::mat estimations, monoEstimations;
+    kde.Evaluate(query, bandwidths, estimations);
+    kde.Evaluate(bandwidths, monoEstimations);
+
+    REQUIRE(estimations.n_rows == bandwidths.n_elem);
+    REQUIRE(estimations.n_cols == query.n_cols);
+    REQUIRE(monoEstimations.n_rows == bandwidths.n_elem);
+    REQUIRE(monoEstimations.n_cols == reference.n_cols);
+
+    for (size_t b = 0; b < bandwidths.n_elem; ++b)
+    {
+      EpanechnikovKernel kernel(bandwidths[b]);
+      arma::vec bfEstimations(query.n_cols);
+      BruteForceKDE<EpanechnikovKernel>(reference, query, bfEstimations,
+          kernel);
+      for (size_t i = 0; i < query.n_cols; ++i)
+      {
+        REQUIRE(estimations(b, i) ==
+            Approx(bfEstimations[i]).epsilon(relError).margin(1e-10));
+      }
+
+      // The monochromatic evaluation does not include each point itself.
+      arma::vec bfMonoEstimations(reference.n_cols);
+      BruteForceKDE<EpanechnikovKernel>(reference, reference,
+          bfMonoEstimations, kernel);
+      bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+      for (size_t i = 0; i < reference.n_cols; ++i)
+      {
+        REQUIRE(monoEstimations(b, i) ==
+            Approx(bfMonoEstimations[i]).epsilon(relError).margin(1e-10));
+      }
+    }
+  }
+
+  // Invalid bandwidths should be rejected.
+  arma::mat estimations;
+  REQUIRE_THROWS_AS(kde.Evaluate(query, arma::vec(), estimations),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(kde.Evaluate(query, arma::vec("0.5 -1.0"), estimations),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a Hermite expansion approximates the kernel sum of a node
+ * within its error bound.
+ */
+TEST_CASE("HermiteExpansionTest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(2, 300);
+  KDTree<EuclideanDistance, KDEStat, arma::mat> tree(reference);
+  const double bandwidth = 1.0;
+  GaussianKernel kernel(bandwidth);
+
+  HermiteExpansion expansion;
+  expansion.Compute(tree, bandwidth, 6);
+  REQUIRE(expansion.Order() == 6);
+  REQUIRE(expansion.NumPoints() == reference.n_cols);
+
+  arma::mat query = 3.0 * arma::randu(2, 20) - 1.0;
+  arma::mat workspace;
+  for (size_t i = 0; i < query.n_cols; ++i)
+  {
+    double sum = 0.0;
+    for (size_t j = 0; j < reference.n_cols; ++j)
+      sum += kernel.Evaluate(arma::norm(query.col(i) - reference.col(j)));
+
+    for (size_t p = 1; p <= expansion.Order(); ++p)
+    {
+      const double approximation = expansion.Evaluate(query.col(i), p,
+          workspace);
+      REQUIRE(std::abs(approximation - sum) <= expansion.ErrorBound(p));
+    }
+  }
+
+  // A node that is too wide compared to the bandwidth gets no expansion.
+  HermiteExpansion wideExpansion;
+  wideExpansion.Compute(tree, 0.1, 6);
+  REQUIRE(wideExpansion.Order() == 0);
+}
+
+/**
+ * Make sure that KDE with series expansions is within the error tolerance of
+ * brute-force KDE, for all modes and with different trees.
+ */
+TEST_CASE("SeriesExpansionKDETest", "[KDETest]")
+{
+  arma::mat reference = arma::randu(3, 2000);
+  arma::mat query = arma::randu(3, 300);
+  const double bandwidth = 0.4;
+  const double relError = 0.01;
+  GaussianKernel kernel(bandwidth);
+
+  arma::vec bfEstimations(query.n_cols);
+  BruteForceKDE<GaussianKernel>(reference, query, bfEstimations, kernel);
+  arma::vec bfMonoEstimations(reference.n_cols);
+  BruteForceKDE<GaussianKernel>(reference, reference, bfMonoEstimations,
+      kernel);
+  bfMonoEstimations -= kernel.Evaluate(0.0) / reference.n_cols;
+
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, KDTree> kdKDE(relError,
+      0.0, kernel);
+  KDE<GaussianKernel, EuclideanDistance, arma::mat, StandardCoverTree>
+      coverKDE(relError, 0.0, kernel);
+  kdKDE.Train(reference);
+  coverKDE.Train(reference);
+  kdKDE.SeriesOrder() = 6;
+  coverKDE.SeriesOrder() = 6;
+
+  for (size_t m = 0; m < 2; ++m)
+  {
+    const KDEMode mode = (m == 0) ? KDEMode::KDE_DUAL_TREE_MODE :
+        KDEMode::KDE_SINGLE_TREE_MODE;
+    kdKDE.Mode() = mode;
+    coverKDE.Mode() = mode;
+
+    arma::vec kdEstimations, coverEstimations, kdMono, coverMono;
+    kdKDE.Evaluate(query, kdEstimations);
+    coverKDE.Evaluate(query, coverEstimations);
+    kdKDE.Evaluate(kdMono);
+    coverKDE.Evaluate(coverMono);
+
+    for (size_t i = 0; i < query.n_cols; ++i)
+    {
+      REQUIRE(kdEstimations[i] ==
+          Approx(bfEstimations[i]).epsilon(relError));
+      REQUIRE(coverEstimations[i] ==
+          Approx(bfEstimations[i]).epsilon(relError));
+    }
+
+    for (size_t i = 0; i < reference.n_cols; ++i)
+    {
+      REQUIRE(kdMono[i] == Approx(bfMonoEstimations[i]).epsilon(relError));
+      REQUIRE(coverMono[i] == Approx(bfMonoEstimations[i]).epsilon(relError));
+    }
+  }
+}
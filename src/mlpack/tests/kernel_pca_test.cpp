@@ -142,3 +142,89 @@ TEST_CASE("CircleTransformationTestNystroem", "[KernelPCATest]")
   REQUIRE(ranges[0].Contains(ranges[2]) == false);
   REQUIRE(ranges[1].Contains(ranges[2]) == false);
 }
+
+/**
+ * If KernelPCA is working right, then it should turn a circle dataset into a
+ * linearly separable dataset in one dimension (which is easy to check).
+ */
+TEST_CASE("CircleTransformationTestRandomFourierFeatures", "[KernelPCATest]")
+{
+  // The dataset, which will have three concentric rings in three dimensions.
+  arma::mat dataset;
+
+  // Now, there are 750 points centered at the origin with unit variance.
+  dataset.randn(3, 750);
+  dataset *= 0.05;
+
+  // Take the second 250 points and spread them away from the origin.
+  for (size_t i = 250; i < 500; ++i)
+  {
+    // Push the point away from the origin by 2.
+    const double pointNorm = norm(dataset.col(i), 2);
+
+    dataset(0, i) += 2.0 * (dataset(0, i) / pointNorm);
+    dataset(1, i) += 2.0 * (dataset(1, i) / pointNorm);
+    dataset(2, i) += 2.0 * (dataset(2, i) / pointNorm);
+  }
+
+  // Take the third 500 points and spread them away from the origin.
+  for (size_t i = 500; i < 750; ++i)
+  {
+    // Push the point away from the origin by 5.
+    const double pointNorm = norm(dataset.col(i), 2);
+
+    dataset(0, i) += 5.0 * (dataset(0, i) / pointNorm);
+    dataset(1, i) += 5.0 * (dataset(1, i) / pointNorm);
+    dataset(2, i) += 5.0 * (dataset(2, i) / pointNorm);
+  }
+
+  // Now we have a dataset; we will use the GaussianKernel to perform KernelPCA
+  // using random Fourier features to take it down to one dimension.
+  KernelPCA<GaussianKernel, RandomFourierFeaturesKernelRule<GaussianKernel>> p;
+  p.Apply(dataset, 1);
+
+  // Get the ranges of each "class".  These are all initialized as empty ranges
+  // containing no points.
+  Range ranges[3];
+  ranges[0] = Range();
+  ranges[1] = Range();
+  ranges[2] = Range();
+
+  // Expand the ranges to hold all of the points in the class.
+  for (size_t i = 0; i < 250; ++i)
+    ranges[0] |= dataset(0, i);
+  for (size_t i = 250; i < 500; ++i)
+    ranges[1] |= dataset(0, i);
+  for (size_t i = 500; i < 750; ++i)
+    ranges[2] |= dataset(0, i);
+
+  // None of these ranges should overlap -- the classes should be linearly
+  // separable.
+  REQUIRE(ranges[0].Contains(ranges[1]) == false);
+  REQUIRE(ranges[0].Contains(ranges[2]) == false);
+  REQUIRE(ranges[1].Contains(ranges[2]) == false);
+}
+
+/**
+ * The eigenvalues found with random Fourier features should approximate the
+ * ones of the exact kernel matrix, for the Laplacian kernel too.
+ */
+TEST_CASE("RandomFourierFeaturesEigenvaluesTest", "[KernelPCATest]")
+{
+  arma::mat dataset = arma::randn<arma::mat>(3, 200);
+
+  arma::mat transformedData, eigvec;
+  arma::vec expected, actual;
+  KernelPCA<LaplacianKernel> naive;
+  naive.Apply(dataset, transformedData, expected, eigvec);
+
+  KernelPCA<LaplacianKernel,
+      RandomFourierFeaturesKernelRule<LaplacianKernel, 2000>> rff;
+  rff.Apply(dataset, transformedData, actual, eigvec);
+
+  REQUIRE(actual.n_elem == 2000);
+  REQUIRE(transformedData.n_rows == 2000);
+  REQUIRE(transformedData.n_cols == 200);
+  for (size_t i = 0; i < 3; ++i)
+    REQUIRE(actual[i] == Approx(expected[i]).epsilon(0.1));
+}
@@ -0,0 +1,247 @@
+/**
+ * @file tests/kernel_svm_test.cpp
+ *
+ * Test the KernelSVM class, its SMO solver and its kernel cache.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/kernel_svm.hpp>
+
+#include "serialization.hpp"
+#include "catch.hpp"
+
+using namespace mlpack;
+
+/**
+ * Generate points inside the unit disc (class 0) and in a ring around it
+ * (class 1), which can't be separated linearly.
+ */
+void DiscAndRing(const size_t n, arma::mat& data, arma::Row<size_t>& labels)
+{
+  data.set_size(2, n);
+  labels.set_size(n);
+  for (size_t i = 0; i < n; ++i)
+  {
+    labels[i] = i % 2;
+    const double radius = (labels[i] == 0) ? 0.8 * Random() :
+        1.2 + 0.8 * Random();
+    const double angle = 2 * M_PI * Random();
+    data(0, i) = radius * std::cos(angle);
+    data(1, i) = radius * std::sin(angle);
+  }
+}
+
+/**
+ * Check that the cache computes the right columns, keeps the most recently
+ * used ones, and doesn't keep more than its capacity.
+ */
+TEST_CASE("KernelCacheTest", "[KernelSVMTest]")
+{
+  arma::mat data(3, 10, arma::fill::randu);
+  GaussianKernel kernel(0.5);
+
+  // The capacity is at least two columns.
+  KernelCache<GaussianKernel, arma::mat> cache(data, kernel, 0.0);
+  REQUIRE(cache.Capacity() == 2);
+
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(cache.Diagonal()[i] == Approx(1.0));
+
+  const arma::vec& column = cache.Column(3);
+  REQUIRE(column.n_elem == 10);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(column[i] ==
+        Approx(kernel.Evaluate(data.col(i), data.col(3))).epsilon(1e-10));
+  }
+
+  cache.Column(4);
+  cache.Column(3);
+  REQUIRE(cache.Evaluations() == 2);
+
+  // Column 4 is the least recently used one, so it is discarded.
+  cache.Column(5);
+  cache.Column(3);
+  REQUIRE(cache.Evaluations() == 3);
+  cache.Column(4);
+  REQUIRE(cache.Evaluations() == 4);
+
+  // A large cache keeps everything.
+  KernelCache<GaussianKernel, arma::mat> largeCache(data, kernel, 1.0);
+  for (size_t i = 0; i < 30; ++i)
+    largeCache.Column(i % 10);
+  REQUIRE(largeCache.Evaluations() == 10);
+}
+
+/**
+ * Check that the solution satisfies the optimality conditions of the dual
+ * problem, and that shrinking and the size of the cache don't change it.
+ */
+TEST_CASE("KernelSVMOptimalityTest", "[KernelSVMTest]")
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  DiscAndRing(300, data, labels);
+  // Add some noise to the labels, so that some points violate the margin.
+  for (size_t i = 0; i < 300; i += 20)
+    labels[i] = 1 - labels[i];
+
+  const double c = 2.0;
+  KernelSVM<> svm(data, labels, 2, c, GaussianKernel(0.5), 1e-4);
+  REQUIRE(svm.NumClasses() == 2);
+  REQUIRE(svm.Coefficients().n_cols == 1);
+  REQUIRE(svm.Biases().n_elem == 1);
+  REQUIRE(svm.SupportVectors().n_cols == svm.Coefficients().n_rows);
+  REQUIRE(svm.SupportVectors().n_cols < 300);
+
+  // The equality constraint sum_i y_i alpha_i = 0 holds.
+  REQUIRE(std::abs(arma::accu(svm.Coefficients())) < 1e-8);
+
+  // Find the dual variable of each point.
+  arma::vec alpha(300, arma::fill::zeros);
+  for (size_t s = 0; s < svm.SupportVectors().n_cols; ++s)
+  {
+    for (size_t i = 0; i < 300; ++i)
+    {
+      if (arma::all(svm.SupportVectors().col(s) == data.col(i)))
+        alpha[i] = std::abs(svm.Coefficients()(s, 0));
+    }
+  }
+
+  arma::Row<size_t> predictions;
+  arma::mat scores;
+  svm.Classify(data, predictions, scores);
+  REQUIRE(scores.n_rows == 1);
+  REQUIRE(scores.n_cols == 300);
+  for (size_t i = 0; i < 300; ++i)
+  {
+    REQUIRE(alpha[i] <= c + 1e-10);
+    const double margin = (labels[i] == 1 ? 1.0 : -1.0) * scores[i];
+    if (alpha[i] == 0.0)
+      REQUIRE(margin >= 1.0 - 1e-3);
+    else if (alpha[i] < c)
+      REQUIRE(margin == Approx(1.0).margin(1e-3));
+    else
+      REQUIRE(margin <= 1.0 + 1e-3);
+  }
+
+  // Shrinking and a cache of two columns give the same solution.
+  KernelSVM<> svm2(c, GaussianKernel(0.5), 1e-4, 0.0, false);
+  svm2.Train(data, labels, 2);
+  arma::mat scores2;
+  svm2.Classify(data, predictions, scores2);
+  for (size_t i = 0; i < 300; ++i)
+    REQUIRE(scores2[i] == Approx(scores[i]).margin(1e-2));
+}
+
+/**
+ * Check that the Gaussian kernel separates a disc from a ring around it.
+ */
+TEST_CASE("KernelSVMGaussianTest", "[KernelSVMTest]")
+{
+  arma::mat data, testData;
+  arma::Row<size_t> labels, testLabels;
+  DiscAndRing(500, data, labels);
+  DiscAndRing(500, testData, testLabels);
+
+  KernelSVM<> svm(data, labels, 2, 1.0, GaussianKernel(0.5));
+  REQUIRE(svm.ComputeAccuracy(data, labels) > 98.0);
+  REQUIRE(svm.ComputeAccuracy(testData, testLabels) > 95.0);
+
+  // Single points are classified in the same way.
+  arma::Row<size_t> predictions;
+  svm.Classify(testData, predictions);
+  for (size_t i = 0; i < 20; ++i)
+    REQUIRE(svm.Classify(testData.col(i)) == predictions[i]);
+}
+
+/**
+ * Check one-vs-rest classification of four classes with other kernels.
+ */
+TEST_CASE("KernelSVMMulticlassTest", "[KernelSVMTest]")
+{
+  arma::mat data(3, 800, arma::fill::randn);
+  arma::Row<size_t> labels(800);
+  for (size_t i = 0; i < 800; ++i)
+  {
+    labels[i] = i % 4;
+    data(labels[i] % 3, i) += (labels[i] == 3) ? -4.0 : 4.0;
+  }
+
+  KernelSVM<LinearKernel> linearSvm(data, labels, 4);
+  REQUIRE(linearSvm.Coefficients().n_cols == 4);
+  REQUIRE(linearSvm.Biases().n_elem == 4);
+  REQUIRE(linearSvm.ComputeAccuracy(data, labels) > 90.0);
+
+  KernelSVM<PolynomialKernel> polySvm(data, labels, 4, 0.1,
+      PolynomialKernel(2.0, 1.0));
+  REQUIRE(polySvm.ComputeAccuracy(data, labels) > 90.0);
+}
+
+/**
+ * Check that a serialized model gives the same predictions.
+ */
+TEST_CASE("KernelSVMSerializationTest", "[KernelSVMTest]")
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  DiscAndRing(200, data, labels);
+
+  KernelSVM<> svm(data, labels, 2, 1.0, GaussianKernel(0.5));
+  KernelSVM<> xmlSvm(2.0), jsonSvm, binarySvm;
+  jsonSvm.Train(data.cols(0, 99), labels.cols(0, 99), 2);
+
+  SerializeObjectAll(svm, xmlSvm, jsonSvm, binarySvm);
+
+  arma::Row<size_t> predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions;
+  arma::mat scores, xmlScores, jsonScores, binaryScores;
+  svm.Classify(data, predictions, scores);
+  xmlSvm.Classify(data, xmlPredictions, xmlScores);
+  jsonSvm.Classify(data, jsonPredictions, jsonScores);
+  binarySvm.Classify(data, binaryPredictions, binaryScores);
+
+  REQUIRE(xmlSvm.C() == svm.C());
+  REQUIRE(xmlSvm.Kernel().Bandwidth() == svm.Kernel().Bandwidth());
+  REQUIRE(arma::all(predictions == xmlPredictions));
+  REQUIRE(arma::all(predictions == jsonPredictions));
+  REQUIRE(arma::all(predictions == binaryPredictions));
+  for (size_t i = 0; i < scores.n_elem; ++i)
+  {
+    REQUIRE(xmlScores[i] == Approx(scores[i]).epsilon(1e-10));
+    REQUIRE(jsonScores[i] == Approx(scores[i]).epsilon(1e-10));
+    REQUIRE(binaryScores[i] == Approx(scores[i]).epsilon(1e-10));
+  }
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("KernelSVMInvalidTest", "[KernelSVMTest]")
+{
+  arma::mat data(2, 10, arma::fill::randu);
+  arma::Row<size_t> labels(10);
+  for (size_t i = 0; i < 10; ++i)
+    labels[i] = i % 3;
+
+  KernelSVM<> svm;
+  arma::Row<size_t> predictions;
+  REQUIRE_THROWS_AS(svm.Classify(data, predictions), std::invalid_argument);
+
+  REQUIRE_THROWS_AS(svm.Train(data, labels, 1), std::invalid_argument);
+  REQUIRE_THROWS_AS(svm.Train(data, labels, 2), std::invalid_argument);
+  REQUIRE_THROWS_AS(svm.Train(data, labels.cols(0, 8), 3),
+      std::invalid_argument);
+
+  svm.C() = 0.0;
+  REQUIRE_THROWS_AS(svm.Train(data, labels, 3), std::invalid_argument);
+
+  svm.C() = 1.0;
+  svm.Train(data, labels, 3);
+  REQUIRE_THROWS_AS(svm.Classify(arma::mat(3, 5, arma::fill::randu),
+      predictions), std::invalid_argument);
+}
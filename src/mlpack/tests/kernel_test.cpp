@@ -420,3 +420,61 @@ TEST_CASE("CauchyKernelTest", "[KernelTest]")
   REQUIRE(ck.Evaluate(a, b) == Approx(0.92592588).epsilon(1e-7));
   REQUIRE(ck.Evaluate(b, a) == Approx(0.92592588).epsilon(1e-7));
 }
+
+/**
+ * Check that KernelBlock() gives the same kernel values as evaluating the
+ * kernel on each pair of points.
+ */
+template<typename KernelType>
+void CheckKernelBlock(KernelType kernel)
+{
+  arma::mat a = arma::randn<arma::mat>(4, 30);
+  arma::mat b = arma::randn<arma::mat>(4, 20);
+  // Include a zero vector and a duplicated point.
+  a.col(0).zeros();
+  b.col(0) = a.col(1);
+
+  arma::mat block, symmetricBlock;
+  KernelBlock(kernel, a, b, block);
+  KernelBlock(kernel, a, symmetricBlock);
+
+  REQUIRE(block.n_rows == 30);
+  REQUIRE(block.n_cols == 20);
+  for (size_t j = 0; j < b.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      REQUIRE(block(i, j) ==
+          Approx(kernel.Evaluate(a.col(i), b.col(j))).margin(1e-6));
+
+  REQUIRE(symmetricBlock.n_rows == 30);
+  REQUIRE(symmetricBlock.n_cols == 30);
+  for (size_t j = 0; j < a.n_cols; ++j)
+    for (size_t i = 0; i < a.n_cols; ++i)
+      REQUIRE(symmetricBlock(i, j) ==
+          Approx(kernel.Evaluate(a.col(i), a.col(j))).margin(1e-6));
+}
+
+/**
+ * Test that the kernels with EvaluateBlock() are detected, and that the block
+ * evaluations (and the fallback for other kernels) are correct.
+ */
+TEST_CASE("KernelBlockTest", "[KernelTest]")
+{
+  REQUIRE(HasEvaluateBlock<LinearKernel>::value);
+  REQUIRE(HasEvaluateBlock<GaussianKernel>::value);
+  REQUIRE(HasEvaluateBlock<CosineSimilarity>::value);
+  REQUIRE(HasEvaluateBlock<EpanechnikovKernel>::value);
+  REQUIRE(!HasEvaluateBlock<PSpectrumStringKernel>::value);
+  REQUIRE(!HasEvaluateBlock<ExampleKernel>::value);
+
+  CheckKernelBlock(LinearKernel());
+  CheckKernelBlock(PolynomialKernel(3.0, 1.5));
+  CheckKernelBlock(HyperbolicTangentKernel(0.5, 0.2));
+  CheckKernelBlock(CosineSimilarity());
+  CheckKernelBlock(GaussianKernel(2.0));
+  CheckKernelBlock(LaplacianKernel(2.0));
+  CheckKernelBlock(CauchyKernel(2.0));
+  CheckKernelBlock(EpanechnikovKernel(3.0));
+  CheckKernelBlock(TriangularKernel(3.0));
+  CheckKernelBlock(SphericalKernel(2.5));
+  CheckKernelBlock(ExampleKernel());
+}
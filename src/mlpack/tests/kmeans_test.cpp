@@ -11,6 +11,7 @@
 #include <mlpack/methods/kmeans.hpp>
 #include <mlpack/methods/neighbor_search.hpp>
 
+#include "thread_communicator.hpp"
 #include "catch.hpp"
 
 using namespace mlpack;
@@ -536,6 +537,61 @@ TEST_CASE("KMeansPlusPlusTest", "[KMeansTest]")
   REQUIRE(distortion < 14500.0);
 }
 
+/**
+ * Test that the k-means|| initialization strategy returns initial cluster
+ * estimates that are as good as those of k-means++, and that it can be used
+ * with KMeans.
+ */
+TEST_CASE("KMeansParallelInitializationTest", "[KMeansTest]")
+{
+  // The same five Gaussians as in KMeansPlusPlusTest.
+  arma::mat data(3, 3000);
+  data.randn();
+
+  arma::mat centroids(" 0  5 -2 -6  1;"
+                      " 0  0 -2  8  6;"
+                      " 0 -2 -2  8  1");
+
+  for (size_t i = 1000; i < 1200; ++i)
+    data.col(i) += centroids.col(1);
+  for (size_t i = 1200; i < 1700; ++i)
+    data.col(i) += centroids.col(2);
+  for (size_t i = 1700; i < 1800; ++i)
+    data.col(i) += centroids.col(3);
+  for (size_t i = 1800; i < 3000; ++i)
+    data.col(i) += centroids.col(4);
+
+  KMeansParallelInitialization k;
+  arma::mat resultingCentroids;
+  k.Cluster(data, 5, resultingCentroids);
+  REQUIRE(resultingCentroids.n_rows == 3);
+  REQUIRE(resultingCentroids.n_cols == 5);
+
+  // Calculate the sum of distances to the closest centroids.
+  double distortion = 0;
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    double bestDist = DBL_MAX;
+    for (size_t j = 0; j < 5; ++j)
+    {
+      bestDist = std::min(bestDist, EuclideanDistance::Evaluate(data.col(i),
+          resultingCentroids.col(j)));
+    }
+    distortion += bestDist;
+  }
+
+  // The reclustering step makes these centroids better than those of
+  // k-means++, so the bound of KMeansPlusPlusTest is easily satisfied.
+  REQUIRE(distortion < 14500.0);
+
+  // Now use it as the initial partition policy of KMeans.
+  KMeans<EuclideanDistance, KMeansParallelInitialization> kmeans;
+  arma::Row<size_t> assignments;
+  kmeans.Cluster(data, 5, assignments);
+  REQUIRE(assignments.n_elem == data.n_cols);
+  REQUIRE(arma::max(assignments) < 5);
+}
+
 #ifdef ARMA_HAS_SPMAT
 /**
  * Make sure sparse k-means works okay.
@@ -617,6 +673,117 @@ TEST_CASE("ElkanTest", "[KMeansTest]")
   }
 }
 
+TEST_CASE("BlasKMeansTest", "[KMeansTest]")
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    // Use enough points that there is more than one block.
+    arma::mat dataset(10, 5000);
+    dataset.randu();
+
+    const size_t k = 5 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    // Make sure the blocked algorithm and the naive method return the same
+    // clusters.
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        BlasKMeans> blas;
+    arma::Row<size_t> blasAssignments;
+    arma::mat blasCentroids(centroids);
+    blas.Cluster(dataset, k, blasAssignments, blasCentroids, false, true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == blasAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      REQUIRE(naiveCentroids[i] == Approx(blasCentroids[i]).epsilon(1e-7));
+  }
+}
+
+TEST_CASE("BruteForceKMeansTest", "[KMeansTest]")
+{
+  const size_t trials = 5;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    // Use enough points that there is more than one block.
+    arma::mat dataset(10, 10000);
+    dataset.randu();
+
+    const size_t k = 5 * (t + 1);
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    // Make sure the matrix product algorithm and the naive method return the
+    // same clusters.
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        BruteForceKMeans> bruteForce;
+    arma::Row<size_t> bruteForceAssignments;
+    arma::mat bruteForceCentroids(centroids);
+    bruteForce.Cluster(dataset, k, bruteForceAssignments, bruteForceCentroids,
+        false, true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == bruteForceAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+    {
+      REQUIRE(naiveCentroids[i] ==
+          Approx(bruteForceCentroids[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that one BruteForceKMeans step on single-precision data gives the
+ * same centroids as a NaiveKMeans step.
+ */
+TEST_CASE("BruteForceKMeansFloatStepTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 6000, arma::fill::randu);
+  const arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+  dataset = arma::conv_to<arma::mat>::from(floatDataset);
+  arma::mat centroids(5, 8, arma::fill::randu);
+
+  EuclideanDistance distance;
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, distance);
+  BruteForceKMeans<EuclideanDistance, arma::fmat> bruteForce(floatDataset,
+      distance);
+
+  arma::mat naiveCentroids, bruteForceCentroids;
+  arma::Col<size_t> naiveCounts, bruteForceCounts;
+  const double naiveNorm = naive.Iterate(centroids, naiveCentroids,
+      naiveCounts);
+  const double bruteForceNorm = bruteForce.Iterate(centroids,
+      bruteForceCentroids, bruteForceCounts);
+
+  // A few points may be assigned differently because of rounding.
+  REQUIRE(arma::accu(bruteForceCounts) == dataset.n_cols);
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    REQUIRE(std::abs((double) bruteForceCounts[i] -
+        (double) naiveCounts[i]) <= 2.0);
+  }
+  REQUIRE(arma::approx_equal(naiveCentroids, bruteForceCentroids, "absdiff",
+      1e-3));
+  REQUIRE(bruteForceNorm == Approx(naiveNorm).epsilon(1e-3));
+  REQUIRE(bruteForce.DistanceCalculations() ==
+      naive.DistanceCalculations());
+}
+
 TEST_CASE("HamerlyTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -652,6 +819,184 @@ TEST_CASE("HamerlyTest", "[KMeansTest]")
   }
 }
 
+#ifdef ARMA_HAS_SPMAT
+
+/**
+ * Make sure that Elkan's and Hamerly's algorithms on sparse data, where the
+ * distances are computed from the norms and the nonzero elements of the
+ * points, return the same clusters as the naive method on the same dense data.
+ */
+TEST_CASE("SparseElkanHamerlyTest", "[KMeansTest]")
+{
+  const size_t trials = 3;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::sp_mat dataset;
+    dataset.sprandu(200, 1000, 0.05);
+    const arma::mat denseDataset(dataset);
+
+    const size_t k = 5 * (t + 1);
+    const arma::mat centroids = denseDataset.cols(0, k - 1);
+
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(denseDataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        ElkanKMeans, arma::sp_mat> elkan;
+    arma::Row<size_t> elkanAssignments;
+    arma::mat elkanCentroids(centroids);
+    elkan.Cluster(dataset, k, elkanAssignments, elkanCentroids, false, true);
+
+    KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        HamerlyKMeans, arma::sp_mat> hamerly;
+    arma::Row<size_t> hamerlyAssignments;
+    arma::mat hamerlyCentroids(centroids);
+    hamerly.Cluster(dataset, k, hamerlyAssignments, hamerlyCentroids, false,
+        true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      REQUIRE(assignments[i] == elkanAssignments[i]);
+      REQUIRE(assignments[i] == hamerlyAssignments[i]);
+    }
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+    {
+      REQUIRE(naiveCentroids[i] == Approx(elkanCentroids[i]).epsilon(1e-7));
+      REQUIRE(naiveCentroids[i] ==
+          Approx(hamerlyCentroids[i]).epsilon(1e-7));
+    }
+  }
+}
+
+/**
+ * Make sure that spherical k-means clusters sparse documents by topic, even
+ * when their lengths are very different, and that it gives the same clusters
+ * on sparse and dense data.
+ */
+TEST_CASE("SphericalKMeansTest", "[KMeansTest]")
+{
+  // Each document uses the words of one of three topics of 100 words, and has
+  // a random length.
+  const size_t points = 600;
+  arma::sp_mat dataset(300, points);
+  arma::Row<size_t> topics(points);
+  for (size_t i = 0; i < points; ++i)
+  {
+    topics[i] = i % 3;
+    const double length = std::pow(10.0, 3.0 * Random());
+    for (size_t w = 0; w < 10; ++w)
+      dataset(100 * topics[i] + RandInt(100), i) = length * (1.0 + Random());
+  }
+
+  // Start from the sum of the first 30 documents of each topic.
+  arma::mat centroids(300, 3, arma::fill::zeros);
+  for (size_t i = 0; i < 90; ++i)
+    centroids.col(topics[i]) += arma::vec(dataset.col(i));
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      SphericalKMeans, arma::sp_mat> kmeans;
+  arma::Row<size_t> assignments;
+  arma::mat sparseCentroids(centroids);
+  kmeans.Cluster(dataset, 3, assignments, sparseCentroids, false, true);
+
+  for (size_t i = 0; i < points; ++i)
+    REQUIRE(assignments[i] == topics[i]);
+
+  // The centroids have unit length.
+  for (size_t c = 0; c < 3; ++c)
+    REQUIRE(arma::norm(sparseCentroids.col(c), 2) == Approx(1.0));
+
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      SphericalKMeans> denseKMeans;
+  arma::Row<size_t> denseAssignments;
+  arma::mat denseCentroids(centroids);
+  denseKMeans.Cluster(arma::mat(dataset), 3, denseAssignments, denseCentroids,
+      false, true);
+
+  for (size_t i = 0; i < points; ++i)
+    REQUIRE(denseAssignments[i] == assignments[i]);
+
+  for (size_t i = 0; i < denseCentroids.n_elem; ++i)
+  {
+    REQUIRE(denseCentroids[i] ==
+        Approx(sparseCentroids[i]).epsilon(1e-7).margin(1e-10));
+  }
+}
+
+#endif // ARMA_HAS_SPMAT
+
+TEST_CASE("YinyangTest", "[KMeansTest]")
+{
+  const size_t trials = 4;
+
+  for (size_t t = 0; t < trials; ++t)
+  {
+    arma::mat dataset(10, 2000);
+    dataset.randu();
+
+    // Use enough clusters that there are several groups.
+    const size_t k = 5 + 15 * t;
+    arma::mat centroids(10, k);
+    centroids.randu();
+
+    // Make sure Yinyang k-means and the naive method return the same clusters.
+    arma::mat naiveCentroids(centroids);
+    KMeans<> km;
+    arma::Row<size_t> assignments;
+    km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+    KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+        YinyangKMeans> yinyang;
+    arma::Row<size_t> yinyangAssignments;
+    arma::mat yinyangCentroids(centroids);
+    yinyang.Cluster(dataset, k, yinyangAssignments, yinyangCentroids, false,
+        true);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+      REQUIRE(assignments[i] == yinyangAssignments[i]);
+
+    for (size_t i = 0; i < centroids.n_elem; ++i)
+      REQUIRE(naiveCentroids[i] == Approx(yinyangCentroids[i]).epsilon(1e-7));
+  }
+}
+
+/**
+ * Make sure that the centroids are split into the expected number of groups,
+ * and that one step gives the same centroids as a NaiveKMeans step.
+ */
+TEST_CASE("YinyangGroupsTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 1000, arma::fill::randu);
+  arma::mat centroids = dataset.cols(0, 44);
+
+  EuclideanDistance distance;
+  YinyangKMeans<EuclideanDistance, arma::mat> yinyang(dataset, distance);
+  NaiveKMeans<EuclideanDistance, arma::mat> naive(dataset, distance);
+
+  arma::mat yinyangCentroids, naiveCentroids;
+  arma::Col<size_t> yinyangCounts, naiveCounts;
+  yinyang.Iterate(centroids, yinyangCentroids, yinyangCounts);
+  naive.Iterate(centroids, naiveCentroids, naiveCounts);
+
+  REQUIRE(yinyang.CentroidGroups().n_elem == 45);
+  REQUIRE(yinyang.CentroidGroups().max() < 4);
+  REQUIRE(arma::all(yinyangCounts == naiveCounts));
+  for (size_t i = 0; i < naiveCentroids.n_elem; ++i)
+    REQUIRE(yinyangCentroids[i] == Approx(naiveCentroids[i]).epsilon(1e-7));
+
+  // The second step uses the bounds.
+  centroids = yinyangCentroids;
+  yinyang.Iterate(centroids, yinyangCentroids, yinyangCounts);
+  naive.Iterate(centroids, naiveCentroids, naiveCounts);
+  REQUIRE(arma::all(yinyangCounts == naiveCounts));
+  for (size_t i = 0; i < naiveCentroids.n_elem; ++i)
+    REQUIRE(yinyangCentroids[i] == Approx(naiveCentroids[i]).epsilon(1e-7));
+}
+
 TEST_CASE("PellegMooreTest", "[KMeansTest]")
 {
   const size_t trials = 5;
@@ -750,6 +1095,67 @@ TEST_CASE("DTNNCoverTreeTest", "[KMeansTest]")
   }
 }
 
+/**
+ * Make sure that the tree-based algorithms give the same results as the naive
+ * algorithm when they run with several threads, on low-dimensional data with
+ * enough points that the trees are split between the threads.
+ */
+TEST_CASE("ParallelTreeKMeansTest", "[KMeansTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat dataset(2, 5000);
+  dataset.randu();
+
+  const size_t k = 20;
+  arma::mat centroids(2, k);
+  centroids.randu();
+
+  arma::mat naiveCentroids(centroids);
+  KMeans<> km;
+  arma::Row<size_t> assignments;
+  km.Cluster(dataset, k, assignments, naiveCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      PellegMooreKMeans> pellegMoore;
+  arma::Row<size_t> pmAssignments;
+  arma::mat pmCentroids(centroids);
+  pellegMoore.Cluster(dataset, k, pmAssignments, pmCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      DefaultDualTreeKMeans> dtnn;
+  arma::Row<size_t> dtnnAssignments;
+  arma::mat dtnnCentroids(centroids);
+  dtnn.Cluster(dataset, k, dtnnAssignments, dtnnCentroids, false, true);
+
+  KMeans<EuclideanDistance, RandomPartition, MaxVarianceNewCluster,
+      CoverTreeDualTreeKMeans> dtnnCover;
+  arma::Row<size_t> coverAssignments;
+  arma::mat coverCentroids(centroids);
+  dtnnCover.Cluster(dataset, k, coverAssignments, coverCentroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(assignments[i] == pmAssignments[i]);
+    REQUIRE(assignments[i] == dtnnAssignments[i]);
+    REQUIRE(assignments[i] == coverAssignments[i]);
+  }
+
+  for (size_t i = 0; i < centroids.n_elem; ++i)
+  {
+    REQUIRE(naiveCentroids[i] == Approx(pmCentroids[i]).epsilon(1e-7));
+    REQUIRE(naiveCentroids[i] == Approx(dtnnCentroids[i]).epsilon(1e-7));
+    REQUIRE(naiveCentroids[i] == Approx(coverCentroids[i]).epsilon(1e-7));
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
 /**
  * Make sure that the sample initialization strategy successfully samples points
  * from the dataset.
@@ -783,3 +1189,160 @@ TEST_CASE("SampleInitializationTest", "[KMeansTest]")
     REQUIRE(j < dataset.n_cols);
   }
 }
+
+/**
+ * Generate three well-separated Gaussian clusters for the mini-batch and
+ * streaming tests.
+ */
+inline void MiniBatchTestData(arma::mat& dataset,
+                              arma::Row<size_t>& labels,
+                              arma::mat& centers)
+{
+  centers = arma::mat("0.0 10.0 0.0;"
+                      "0.0 0.0 10.0;"
+                      "0.0 5.0 -5.0");
+  dataset.randn(3, 6000);
+  dataset *= 0.5;
+  labels.set_size(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = i % 3;
+    dataset.col(i) += centers.col(i % 3);
+  }
+}
+
+/**
+ * Make sure that mini-batch k-means, used through KMeans, finds the centers of
+ * well-separated clusters.
+ */
+TEST_CASE("MiniBatchKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset, centers;
+  arma::Row<size_t> labels;
+  MiniBatchTestData(dataset, labels, centers);
+
+  // Start from one point of each cluster, so that no centroid is lost.
+  arma::mat centroids = dataset.cols(0, 2);
+  arma::Row<size_t> assignments;
+  KMeans<EuclideanDistance, SampleInitialization, MaxVarianceNewCluster,
+      MiniBatchKMeans> kmeans(50);
+  kmeans.Cluster(dataset, 3, assignments, centroids, false, true);
+
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == labels[i]);
+
+  for (size_t i = 0; i < centers.n_elem; ++i)
+    REQUIRE(centroids[i] == Approx(centers[i]).margin(0.1));
+
+  // A single iteration only touches a batch of the dataset.
+  EuclideanDistance distance;
+  MiniBatchKMeans<EuclideanDistance, arma::mat> step(dataset, distance, 100);
+  arma::mat newCentroids;
+  arma::Col<size_t> counts;
+  step.Iterate(dataset.cols(0, 2), newCentroids, counts);
+  REQUIRE(accu(counts) == 100);
+  step.Iterate(newCentroids, centroids, counts);
+  REQUIRE(accu(counts) == 200);
+  REQUIRE(step.DistanceCalculations() == 2 * (100 * 3 + 3));
+}
+
+/**
+ * Make sure that StreamingKMeans finds the same clusters when the data is given
+ * in chunks, both from memory and from a file.
+ */
+TEST_CASE("StreamingKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset, centers;
+  arma::Row<size_t> labels;
+  MiniBatchTestData(dataset, labels, centers);
+
+  StreamingKMeans<> kmeans(3, 256);
+  kmeans.Centroids() = dataset.cols(0, 2);
+  kmeans.Counts().zeros(3);
+  for (size_t i = 0; i < dataset.n_cols; i += 1000)
+    kmeans.Update(dataset.cols(i, i + 999));
+
+  REQUIRE(accu(kmeans.Counts()) == dataset.n_cols);
+  for (size_t i = 0; i < centers.n_elem; ++i)
+    REQUIRE(kmeans.Centroids()[i] == Approx(centers[i]).margin(0.1));
+
+  arma::Row<size_t> assignments;
+  kmeans.Assign(dataset, assignments);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(assignments[i] == labels[i]);
+
+  // Now cluster the same data from a file, with two passes.
+  REQUIRE(data::Save("streaming_kmeans.csv", dataset) == true);
+  data::CSVChunkReader reader("streaming_kmeans.csv", 1000);
+  StreamingKMeans<> fileKMeans(3, 256);
+  fileKMeans.Centroids() = dataset.cols(0, 2);
+  fileKMeans.Counts().zeros(3);
+  fileKMeans.Cluster(reader, 2);
+  remove("streaming_kmeans.csv");
+
+  REQUIRE(accu(fileKMeans.Counts()) == 2 * dataset.n_cols);
+  for (size_t i = 0; i < centers.n_elem; ++i)
+    REQUIRE(fileKMeans.Centroids()[i] == Approx(centers[i]).margin(0.1));
+
+  // Without initial centroids, the first chunk is sampled.
+  StreamingKMeans<> sampledKMeans(3);
+  sampledKMeans.Update(dataset.cols(0, 999));
+  REQUIRE(sampledKMeans.Centroids().n_cols == 3);
+  REQUIRE(accu(sampledKMeans.Counts()) == 1000);
+
+  // The first chunk must have enough points.
+  StreamingKMeans<> tooSmall(3);
+  REQUIRE_THROWS_AS(tooSmall.Update(dataset.cols(0, 1)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that DistributedKMeans with several ranks (one of which has no
+ * points) gives the same clusters as KMeans on the whole dataset.
+ */
+TEST_CASE("DistributedKMeansTest", "[KMeansTest]")
+{
+  arma::mat dataset(5, 3000, arma::fill::randu);
+  arma::mat initialCentroids(5, 6, arma::fill::randu);
+
+  arma::mat naiveCentroids(initialCentroids);
+  KMeans<> km;
+  arma::Row<size_t> naiveAssignments;
+  km.Cluster(dataset, 6, naiveAssignments, naiveCentroids, false, true);
+
+  const std::vector<size_t> splits = { 0, 700, 700, 1800, 3000 };
+  std::vector<arma::mat> centroids(4), randomCentroids(4);
+  std::vector<arma::Row<size_t>> assignments(4);
+  std::vector<size_t> iterations(4);
+  RunOnThreads(4, [&](ThreadCommunicator& comm)
+  {
+    const size_t r = comm.Rank();
+    const arma::mat localData = (splits[r] == splits[r + 1]) ?
+        arma::mat(5, 0) : arma::mat(dataset.cols(splits[r],
+        splits[r + 1] - 1));
+
+    DistributedKMeans<ThreadCommunicator> kmeans(comm);
+    centroids[r] = initialCentroids;
+    kmeans.Cluster(localData, 6, assignments[r], centroids[r], true);
+
+    // Without an initial guess, every rank must choose the same centroids.
+    kmeans.MaxIterations() = 3;
+    kmeans.Cluster(localData, 6, randomCentroids[r]);
+    iterations[r] = kmeans.Iterations();
+  });
+
+  for (size_t r = 0; r < 4; ++r)
+  {
+    REQUIRE(arma::approx_equal(centroids[r], naiveCentroids, "absdiff",
+        1e-8));
+    REQUIRE(assignments[r].n_elem == splits[r + 1] - splits[r]);
+    for (size_t i = 0; i < assignments[r].n_elem; ++i)
+      REQUIRE(assignments[r][i] == naiveAssignments[splits[r] + i]);
+
+    REQUIRE(randomCentroids[r].n_rows == 5);
+    REQUIRE(randomCentroids[r].n_cols == 6);
+    REQUIRE(arma::approx_equal(randomCentroids[r], randomCentroids[0],
+        "absdiff", 0.0));
+    REQUIRE(iterations[r] <= 3);
+  }
+}
@@ -12,6 +12,7 @@
 #include <mlpack/methods/neighbor_search.hpp>
 #include <mlpack/methods/neighbor_search/ns_model.hpp>
 #include "test_catch_tools.hpp"
+#include "thread_communicator.hpp"
 #include "catch.hpp"
 
 using namespace mlpack;
@@ -1186,6 +1187,218 @@ TEST_CASE("KNNModelTest", "[KNNTest]")
   }
 }
 
+/**
+ * Make sure that an NSModel saved with data::SaveMapped() and loaded with
+ * data::LoadMapped() gives the same results as the original model, for several
+ * tree types and search modes.
+ */
+TEST_CASE("KNNModelMappedTest", "[KNNTest]")
+{
+  using KNNModel = NSModel<NearestNeighborSort>;
+  util::Timers timers;
+
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 500);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::COVER_TREE, KNNModel::TreeTypes::R_TREE,
+      KNNModel::TreeTypes::OCTREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, NAIVE_MODE };
+
+  for (size_t i = 0; i < 4; ++i)
+  {
+    for (size_t j = 0; j < 2; ++j)
+    {
+      KNNModel model(treeTypes[i], i == 0);
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(timers, std::move(referenceCopy), modes[j]);
+
+      REQUIRE(data::SaveMapped("knn_model_mapped.bin", "knn_model", model));
+      // Saving must not change the model.
+      REQUIRE(model.Dataset().n_cols == referenceData.n_cols);
+
+      KNNModel mappedModel;
+      REQUIRE(data::LoadMapped("knn_model_mapped.bin", "knn_model",
+          mappedModel));
+      REQUIRE(mappedModel.Mapping());
+      CheckMatrices(mappedModel.Dataset(), model.Dataset());
+
+      arma::Mat<size_t> neighbors, mappedNeighbors;
+      arma::mat distances, mappedDistances;
+      arma::mat queryCopy(queryData);
+      arma::mat mappedQueryCopy(queryData);
+      model.Search(timers, std::move(queryCopy), 3, neighbors, distances);
+      mappedModel.Search(timers, std::move(mappedQueryCopy), 3,
+          mappedNeighbors, mappedDistances);
+
+      CheckMatrices(mappedNeighbors, neighbors);
+      CheckMatrices(mappedDistances, distances);
+
+      // A copy of the model must still work once the loaded model is gone.
+      KNNModel* copiedModel = new KNNModel(mappedModel);
+      mappedModel = KNNModel();
+      copiedModel->Search(timers, 3, mappedNeighbors, mappedDistances);
+      model.Search(timers, 3, neighbors, distances);
+      delete copiedModel;
+
+      CheckMatrices(mappedNeighbors, neighbors);
+      CheckMatrices(mappedDistances, distances);
+    }
+  }
+
+  // Loading a file that is not a mapped model must fail.
+  std::ofstream("knn_model_unmapped.bin") << "not a mapped model";
+  KNNModel failedModel;
+  REQUIRE(!data::LoadMapped("knn_model_unmapped.bin", "knn_model",
+      failedModel));
+  REQUIRE(!failedModel.Mapping());
+
+  remove("knn_model_mapped.bin");
+  remove("knn_model_unmapped.bin");
+}
+
+/**
+ * Make sure that an NSModel that holds its reference set in single precision
+ * gives the same results as double-precision search, before and after
+ * serialization.
+ */
+TEST_CASE("KNNModelSinglePrecisionTest", "[KNNTest]")
+{
+  using KNNModel = NSModel<NearestNeighborSort>;
+  util::Timers timers;
+
+  arma::mat queryData = arma::randu<arma::mat>(5, 100);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 500);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  const KNNModel::TreeTypes treeTypes[] = { KNNModel::TreeTypes::KD_TREE,
+      KNNModel::TreeTypes::COVER_TREE, KNNModel::TreeTypes::R_TREE,
+      KNNModel::TreeTypes::BALL_TREE, KNNModel::TreeTypes::OCTREE };
+  const NeighborSearchMode modes[] = { DUAL_TREE_MODE, SINGLE_TREE_MODE,
+      NAIVE_MODE };
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    for (size_t j = 0; j < 3; ++j)
+    {
+      KNNModel model(treeTypes[i]);
+      model.SinglePrecision() = true;
+      arma::mat referenceCopy(referenceData);
+      model.BuildModel(timers, std::move(referenceCopy), modes[j]);
+
+      REQUIRE(model.FloatDataset().n_cols == referenceData.n_cols);
+      REQUIRE(model.NumReferencePoints() == referenceData.n_cols);
+      REQUIRE(model.Dimensionality() == referenceData.n_rows);
+      REQUIRE_THROWS_AS(model.Dataset(), std::logic_error);
+
+      REQUIRE(data::Save("knn_float_model.bin", "knn_model", model));
+      KNNModel loadedModel;
+      REQUIRE(data::Load("knn_float_model.bin", "knn_model", loadedModel));
+      REQUIRE(loadedModel.SinglePrecision());
+
+      arma::Mat<size_t> neighbors, loadedNeighbors;
+      arma::mat distances, loadedDistances;
+      arma::mat queryCopy(queryData);
+      arma::mat loadedQueryCopy(queryData);
+      model.Search(timers, std::move(queryCopy), 3, neighbors, distances);
+      loadedModel.Search(timers, std::move(loadedQueryCopy), 3,
+          loadedNeighbors, loadedDistances);
+
+      CheckMatrices(neighbors, baselineNeighbors);
+      CheckMatrices(loadedNeighbors, baselineNeighbors);
+      for (size_t k = 0; k < distances.n_elem; ++k)
+      {
+        REQUIRE(distances[k] ==
+            Approx(baselineDistances[k]).epsilon(1e-5).margin(1e-6));
+        REQUIRE(loadedDistances[k] == Approx(distances[k]));
+      }
+    }
+  }
+
+  remove("knn_float_model.bin");
+}
+
+/**
+ * Make sure that NSModel::SelectTree() chooses a tree type and leaf size that
+ * give correct results, and that the choice is saved with the model.
+ */
+TEST_CASE("KNNModelAutoSelectTest", "[KNNTest]")
+{
+  using KNNModel = NSModel<NearestNeighborSort>;
+  util::Timers timers;
+
+  // Points on a 2-dimensional plane in 8 dimensions.
+  arma::mat referenceData = arma::randn<arma::mat>(8, 2) *
+      arma::randu<arma::mat>(2, 2000);
+  arma::mat queryData = arma::randn<arma::mat>(8, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> baselineNeighbors;
+  arma::mat baselineDistances;
+  knn.Search(queryData, 3, baselineNeighbors, baselineDistances);
+
+  KNNModel model(KNNModel::TreeTypes::AUTO_TREE);
+  REQUIRE(!model.AutoSelected());
+
+  // The model cannot be built before the tree type is chosen.
+  REQUIRE_THROWS_AS(model.BuildModel(timers, arma::mat(referenceData),
+      DUAL_TREE_MODE), std::invalid_argument);
+  // The query set must have the right dimensionality.
+  REQUIRE_THROWS_AS(model.SelectTree(timers, referenceData,
+      arma::mat(5, 10, arma::fill::randu), 3), std::invalid_argument);
+
+  const NeighborSearchMode mode = model.SelectTree(timers, referenceData,
+      queryData, 3);
+  REQUIRE(model.TreeType() != KNNModel::TreeTypes::AUTO_TREE);
+  REQUIRE(model.AutoSelected());
+  REQUIRE((mode == SINGLE_TREE_MODE || mode == DUAL_TREE_MODE));
+  REQUIRE(model.IntrinsicDimension() > 1.0);
+  REQUIRE(model.IntrinsicDimension() < 4.0);
+
+  model.BuildModel(timers, arma::mat(referenceData), mode);
+  REQUIRE(model.SearchMode() == mode);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  model.Search(timers, arma::mat(queryData), 3, neighbors, distances);
+  CheckMatrices(neighbors, baselineNeighbors);
+  CheckMatrices(distances, baselineDistances);
+
+  // The choice must survive serialization.
+  REQUIRE(data::Save("knn_auto_model.bin", "knn_model", model));
+  KNNModel loadedModel;
+  REQUIRE(data::Load("knn_auto_model.bin", "knn_model", loadedModel));
+  REQUIRE(loadedModel.TreeType() == model.TreeType());
+  REQUIRE(loadedModel.LeafSize() == model.LeafSize());
+  REQUIRE(loadedModel.SearchMode() == mode);
+  REQUIRE(loadedModel.AutoSelected());
+  REQUIRE(loadedModel.IntrinsicDimension() ==
+      Approx(model.IntrinsicDimension()));
+
+  arma::Mat<size_t> loadedNeighbors;
+  arma::mat loadedDistances;
+  loadedModel.Search(timers, arma::mat(queryData), 3, loadedNeighbors,
+      loadedDistances);
+  CheckMatrices(loadedNeighbors, baselineNeighbors);
+
+  // Monochromatic selection works too.
+  KNNModel monoModel(KNNModel::TreeTypes::AUTO_TREE);
+  const NeighborSearchMode monoMode = monoModel.SelectTree(timers,
+      referenceData, arma::mat(), 3);
+  monoModel.BuildModel(timers, arma::mat(referenceData), monoMode);
+  arma::Mat<size_t> monoNeighbors, monoBaselineNeighbors;
+  arma::mat monoDistances, monoBaselineDistances;
+  monoModel.Search(timers, 3, monoNeighbors, monoDistances);
+  knn.Search(3, monoBaselineNeighbors, monoBaselineDistances);
+  CheckMatrices(monoNeighbors, monoBaselineNeighbors);
+
+  remove("knn_auto_model.bin");
+}
+
 TEST_CASE("KNNModelMonochromaticTest", "[KNNTest]")
 {
   // Ensure that we can build an NSModel<NearestNeighborSearch> and get correct
@@ -1491,6 +1704,31 @@ TEST_CASE("KNNCopyConstructorAndOperatorOctreeTest", "[KNNTest]")
   CheckMatrices(distances, distances3);
 }
 
+/**
+ * Make sure that an Octree built from Morton codes gives exact results.
+ */
+TEST_CASE("KNNMortonOctreeTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(3, 6000);
+  using TreeType = Octree<EuclideanDistance, NeighborSearchStat<
+      NearestNeighborSort>, arma::mat>;
+  TreeType tree(std::move(dataset), MORTON_OCTREE_BUILD, 10);
+  const arma::mat sortedDataset = tree.Dataset();
+
+  using NeighborSearchType = NeighborSearch<NearestNeighborSort,
+      EuclideanDistance, arma::mat, Octree>;
+  NeighborSearchType knn(std::move(tree));
+  KNN naive(sortedDataset, NAIVE_MODE);
+
+  arma::mat distances, naiveDistances;
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  knn.Search(3, neighbors, distances);
+  naive.Search(3, naiveNeighbors, naiveDistances);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
 /**
  * Test the move constructor.
  */
@@ -1865,3 +2103,846 @@ TEST_CASE("KNNSpillTreeSearchEnoughResults", "[KNNTest]")
   REQUIRE(accu(distancesGreedy < 0.0 || distancesGreedy > std::sqrt(3.0))
       == 0);
 }
+
+/**
+ * Make sure that parallel dual-tree search with several threads gives the same
+ * results as naive search, for both bichromatic and monochromatic search and
+ * for trees of different types.
+ */
+TEST_CASE("KNNParallelDualTreeTest", "[KNNTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(3, 500);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, naiveMonoNeighbors;
+  arma::mat naiveDistances, naiveMonoDistances;
+  naive.Search(queryData, 10, naiveNeighbors, naiveDistances);
+  naive.Search(10, naiveMonoNeighbors, naiveMonoDistances);
+
+  KNN kdSearch(referenceData);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverSearch(referenceData);
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, BallTree>
+      ballSearch(referenceData);
+
+  arma::Mat<size_t> kdNeighbors, coverNeighbors, ballNeighbors;
+  arma::mat kdDistances, coverDistances, ballDistances;
+
+  // Run each search twice, to make sure the bounds in the monochromatic case
+  // are reset properly.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    kdSearch.Search(queryData, 10, kdNeighbors, kdDistances);
+    coverSearch.Search(queryData, 10, coverNeighbors, coverDistances);
+    ballSearch.Search(queryData, 10, ballNeighbors, ballDistances);
+
+    CheckMatrices(kdNeighbors, naiveNeighbors);
+    CheckMatrices(kdDistances, naiveDistances);
+    CheckMatrices(coverNeighbors, naiveNeighbors);
+    CheckMatrices(coverDistances, naiveDistances);
+    CheckMatrices(ballNeighbors, naiveNeighbors);
+    CheckMatrices(ballDistances, naiveDistances);
+
+    kdSearch.Search(10, kdNeighbors, kdDistances);
+    coverSearch.Search(10, coverNeighbors, coverDistances);
+    ballSearch.Search(10, ballNeighbors, ballDistances);
+
+    CheckMatrices(kdNeighbors, naiveMonoNeighbors);
+    CheckMatrices(kdDistances, naiveMonoDistances);
+    CheckMatrices(coverNeighbors, naiveMonoNeighbors);
+    CheckMatrices(coverDistances, naiveMonoDistances);
+    CheckMatrices(ballNeighbors, naiveMonoNeighbors);
+    CheckMatrices(ballDistances, naiveMonoDistances);
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Make sure that parallel single-tree search gives the same results as naive
+ * search, for both bichromatic and monochromatic search.
+ */
+TEST_CASE("KNNParallelSingleTreeTest", "[KNNTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  KNN parallelSingle(referenceData, PARALLEL_SINGLE_TREE_MODE);
+  // Cover trees are searched serially, but must still give correct results.
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverSearch(referenceData, PARALLEL_SINGLE_TREE_MODE);
+
+  arma::Mat<size_t> naiveNeighbors, treeNeighbors, coverNeighbors;
+  arma::mat naiveDistances, treeDistances, coverDistances;
+
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+  parallelSingle.Search(queryData, 5, treeNeighbors, treeDistances);
+  coverSearch.Search(queryData, 5, coverNeighbors, coverDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+  CheckMatrices(coverNeighbors, naiveNeighbors);
+  CheckMatrices(coverDistances, naiveDistances);
+
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  parallelSingle.Search(5, treeNeighbors, treeDistances);
+
+  CheckMatrices(treeNeighbors, naiveNeighbors);
+  CheckMatrices(treeDistances, naiveDistances);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Make sure that parallel dual-tree search with spill trees gives the same
+ * results as naive search when the overlapping size is large enough for the
+ * search to be exact, and that a leaf budget bounds the work of each query.
+ */
+TEST_CASE("KNNSpillTreeParallelAndBudgetTest", "[KNNTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, spillNeighbors;
+  arma::mat naiveDistances, spillDistances;
+
+  // With tau larger than the diameter of the data, no overlapping split
+  // satisfies rho, so no node overlaps and the search is exact.
+  SpillKNN exactSearch(SpillKNN::Tree(referenceData, 2.0));
+  naive.Search(queryData, 3, naiveNeighbors, naiveDistances);
+  exactSearch.Search(queryData, 3, spillNeighbors, spillDistances);
+  CheckMatrices(spillNeighbors, naiveNeighbors);
+  CheckMatrices(spillDistances, naiveDistances);
+
+  naive.Search(3, naiveNeighbors, naiveDistances);
+  exactSearch.Search(3, spillNeighbors, spillDistances);
+  CheckMatrices(spillNeighbors, naiveNeighbors);
+  CheckMatrices(spillDistances, naiveDistances);
+
+  // With a budget of one leaf, single-tree search computes at most one leaf of
+  // base cases for each query point.
+  SpillKNN budgetSearch(SpillKNN::Tree(referenceData, 0.05, 20),
+      SINGLE_TREE_MODE);
+  budgetSearch.Search(queryData, 1, spillNeighbors, spillDistances);
+  const size_t unlimitedBaseCases = budgetSearch.BaseCases();
+
+  budgetSearch.MaxLeaves() = 1;
+  budgetSearch.Search(queryData, 1, spillNeighbors, spillDistances);
+  REQUIRE(budgetSearch.BaseCases() <= unlimitedBaseCases);
+  REQUIRE(budgetSearch.BaseCases() <= 20 * queryData.n_cols);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    REQUIRE(spillDistances(0, i) < DBL_MAX);
+
+  // The budget also holds for parallel single-tree and dual-tree search.
+  budgetSearch.SearchMode() = PARALLEL_SINGLE_TREE_MODE;
+  budgetSearch.Search(queryData, 1, spillNeighbors, spillDistances);
+  REQUIRE(budgetSearch.BaseCases() <= 20 * queryData.n_cols);
+
+  budgetSearch.SearchMode() = DUAL_TREE_MODE;
+  budgetSearch.Search(queryData, 1, spillNeighbors, spillDistances);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    REQUIRE(spillDistances(0, i) < DBL_MAX);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+/**
+ * Make sure that the blocked base cases used by the dual-tree traversal of
+ * binary space trees give the same results as naive search, also when the
+ * points are far from the origin (where computing distances through the norms
+ * of the points loses precision) and for furthest neighbor search.
+ */
+TEST_CASE("KNNBlockBaseCaseTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(20, 1000) + 100.0;
+  arma::mat queryData = arma::randu<arma::mat>(20, 300) + 100.0;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  KNN kdSearch(referenceData);
+  KFN naiveFurthest(referenceData, NAIVE_MODE);
+  KFN kdFurthest(referenceData);
+  NeighborSearch<NearestNeighborSort, SquaredEuclideanDistance> naiveSquared(
+      referenceData, NAIVE_MODE);
+  NeighborSearch<NearestNeighborSort, SquaredEuclideanDistance> kdSquared(
+      referenceData);
+
+  arma::Mat<size_t> naiveNeighbors, kdNeighbors;
+  arma::mat naiveDistances, kdDistances;
+
+  naive.Search(queryData, 10, naiveNeighbors, naiveDistances);
+  kdSearch.Search(queryData, 10, kdNeighbors, kdDistances);
+  CheckMatrices(kdNeighbors, naiveNeighbors);
+  CheckMatrices(kdDistances, naiveDistances);
+
+  naive.Search(10, naiveNeighbors, naiveDistances);
+  kdSearch.Search(10, kdNeighbors, kdDistances);
+  CheckMatrices(kdNeighbors, naiveNeighbors);
+  CheckMatrices(kdDistances, naiveDistances);
+
+  naiveFurthest.Search(queryData, 10, naiveNeighbors, naiveDistances);
+  kdFurthest.Search(queryData, 10, kdNeighbors, kdDistances);
+  CheckMatrices(kdNeighbors, naiveNeighbors);
+  CheckMatrices(kdDistances, naiveDistances);
+
+  naiveSquared.Search(queryData, 10, naiveNeighbors, naiveDistances);
+  kdSquared.Search(queryData, 10, kdNeighbors, kdDistances);
+  CheckMatrices(kdNeighbors, naiveNeighbors);
+  CheckMatrices(kdDistances, naiveDistances);
+}
+
+/**
+ * Insert points into and remove points from the given NeighborSearch object,
+ * and make sure that its results match a naive search on the same reference
+ * set after each change.
+ */
+template<typename NSType>
+void CheckInsertRemove(NSType& search)
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(5, 200);
+
+  search.Train(dataset.cols(0, 599));
+  search.Insert(dataset.cols(600, 799));
+  search.Insert(dataset.cols(800, 999));
+  REQUIRE(search.ReferenceSet().n_cols == 1000);
+
+  // Remove every seventh point (and one point twice).
+  arma::uvec removed = arma::regspace<arma::uvec>(0, 7, 999);
+  removed.resize(removed.n_elem + 1);
+  removed[removed.n_elem - 1] = 7;
+  search.Remove(removed);
+  REQUIRE(search.ReferenceSet().n_cols == 1000 - 143);
+
+  arma::mat remaining(dataset);
+  remaining.shed_cols(arma::regspace<arma::uvec>(0, 7, 999));
+  KNN naive(remaining, NAIVE_MODE);
+
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  search.Search(queryData, 5, neighbors, distances);
+  naive.Search(queryData, 5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  search.Search(5, neighbors, distances);
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that points can be inserted into and removed from the reference set
+ * of NeighborSearch, whether the tree is updated in place or rebuilt.
+ */
+TEST_CASE("KNNInsertRemoveTest", "[KNNTest]")
+{
+  // Updates in place, without any rebuilds.
+  KNN kdSearch;
+  kdSearch.RebuildFraction() = DBL_MAX;
+  CheckInsertRemove(kdSearch);
+
+  KNN singleKDSearch(SINGLE_TREE_MODE);
+  singleKDSearch.RebuildFraction() = DBL_MAX;
+  CheckInsertRemove(singleKDSearch);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, BallTree>
+      ballSearch;
+  ballSearch.RebuildFraction() = DBL_MAX;
+  CheckInsertRemove(ballSearch);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, VPTree>
+      vpSearch;
+  vpSearch.RebuildFraction() = DBL_MAX;
+  CheckInsertRemove(vpSearch);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, RTree>
+      rSearch;
+  rSearch.RebuildFraction() = DBL_MAX;
+  CheckInsertRemove(rSearch);
+
+  // Updates with the default rebuilds.
+  KNN rebuiltKDSearch;
+  CheckInsertRemove(rebuiltKDSearch);
+
+  // Trees without incremental updates, and no tree at all.
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+      StandardCoverTree> coverSearch;
+  CheckInsertRemove(coverSearch);
+
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, Octree>
+      octreeSearch;
+  CheckInsertRemove(octreeSearch);
+
+  KNN naiveSearch(NAIVE_MODE);
+  CheckInsertRemove(naiveSearch);
+}
+
+/**
+ * Make sure that the traversal statistics agree with the counts kept by the
+ * search, and that collecting them does not change the results.
+ */
+TEST_CASE("KNNTraversalStatisticsTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(5, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(5, 200);
+
+  arma::Mat<size_t> neighbors, statNeighbors;
+  arma::mat distances, statDistances;
+
+  // Single-tree search scores the root once for each query point.
+  KNN singleSearch(dataset, SINGLE_TREE_MODE);
+  singleSearch.Search(querySet, 5, neighbors, distances);
+
+  TraversalStatistics singleStats;
+  singleSearch.Statistics() = &singleStats;
+  singleSearch.Search(querySet, 5, statNeighbors, statDistances);
+
+  CheckMatrices(neighbors, statNeighbors);
+  CheckMatrices(distances, statDistances);
+
+  REQUIRE(singleStats.BaseCases() == singleSearch.BaseCases());
+  REQUIRE(singleStats.LevelScores().size() > 1);
+  REQUIRE(singleStats.LevelScores()[0] == querySet.n_cols);
+  REQUIRE(singleStats.LeafVisits() > 0);
+  REQUIRE(singleStats.MaxReferenceDepth() ==
+      singleStats.LevelScores().size() - 1);
+
+  size_t totalScores = 0;
+  size_t totalPrunes = 0;
+  for (size_t i = 0; i < singleStats.LevelScores().size(); ++i)
+  {
+    REQUIRE(singleStats.LevelPrunes()[i] <= singleStats.LevelScores()[i]);
+    totalScores += singleStats.LevelScores()[i];
+    totalPrunes += singleStats.LevelPrunes()[i];
+  }
+  REQUIRE(totalScores == singleSearch.Scores());
+  REQUIRE(totalPrunes > 0);
+  REQUIRE(singleStats.RescorePrunes() <= singleStats.Rescores());
+
+  // Dual-tree search (which may be parallel) merges the statistics of every
+  // thread.
+  KNN dualSearch(dataset);
+  TraversalStatistics dualStats;
+  dualSearch.Statistics() = &dualStats;
+  dualSearch.Search(querySet, 5, statNeighbors, statDistances);
+
+  CheckMatrices(neighbors, statNeighbors);
+  CheckMatrices(distances, statDistances);
+
+  REQUIRE(dualStats.BaseCases() == dualSearch.BaseCases());
+  REQUIRE(dualStats.MaxQueryDepth() > 0);
+
+  // Statistics accumulate until they are reset.
+  const size_t baseCases = dualStats.BaseCases();
+  dualSearch.Search(querySet, 5, statNeighbors, statDistances);
+  REQUIRE(dualStats.BaseCases() > baseCases);
+
+  dualStats.Reset();
+  REQUIRE(dualStats.BaseCases() == 0);
+  REQUIRE(dualStats.LevelScores().size() == 0);
+}
+
+/**
+ * Make sure that BruteForceKNN finds the same neighbors as a naive search,
+ * with blocks smaller than the datasets.
+ */
+TEST_CASE("BruteForceKNNTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(20, 3000);
+  arma::mat queryData = arma::randu<arma::mat>(20, 700);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  BruteForceKNN<arma::mat> bruteForce(referenceData, 512);
+  REQUIRE(bruteForce.BlockSize() == 512);
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+
+  naive.Search(queryData, 10, naiveNeighbors, naiveDistances);
+  bruteForce.Search(queryData, 10, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  naive.Search(10, naiveNeighbors, naiveDistances);
+  bruteForce.Search(10, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Too many neighbors are requested.
+  REQUIRE_THROWS_AS(bruteForce.Search(3000, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Find the k largest scores of each column (breaking ties by index) with a
+ * dense computation.
+ */
+static void DenseTopScores(const arma::mat& scores,
+                           const size_t k,
+                           arma::Mat<size_t>& neighbors,
+                           arma::mat& topScores)
+{
+  neighbors.set_size(k, scores.n_cols);
+  topScores.set_size(k, scores.n_cols);
+  for (size_t q = 0; q < scores.n_cols; ++q)
+  {
+    const arma::uvec order = arma::stable_sort_index(scores.col(q), "descend");
+    for (size_t i = 0; i < k; ++i)
+    {
+      neighbors(i, q) = order[i];
+      topScores(i, q) = scores(order[i], q);
+    }
+  }
+}
+
+/**
+ * Make sure that SparseKNN finds the same neighbors as a dense search with
+ * each metric, with and without pruning.
+ */
+TEST_CASE("SparseKNNTest", "[KNNTest]")
+{
+  arma::sp_mat referenceData, queryData;
+  referenceData.sprandu(100, 2000, 0.05);
+  queryData.sprandu(100, 300, 0.05);
+  // A query with no nonzero values.
+  queryData.col(7).zeros();
+
+  const arma::mat references(referenceData), queries(queryData);
+
+  // Euclidean distance: compare with a naive KNN search.
+  KNN naive(references, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  naive.Search(queries, 10, naiveNeighbors, naiveDistances);
+
+  SparseKNN<> euclidean(referenceData);
+  REQUIRE(euclidean.Metric() == EUCLIDEAN_SEARCH);
+  for (const bool pruning : { true, false })
+  {
+    euclidean.Pruning() = pruning;
+    euclidean.Search(queryData, 10, neighbors, distances);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances, 1e-5);
+  }
+
+  naive.Search(10, naiveNeighbors, naiveDistances);
+  euclidean.Search(10, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances, 1e-5);
+
+  // Inner product.
+  arma::Mat<size_t> denseNeighbors;
+  arma::mat denseScores;
+  DenseTopScores(references.t() * queries, 10, denseNeighbors, denseScores);
+
+  SparseKNN<> innerProduct(referenceData, INNER_PRODUCT_SEARCH);
+  for (const bool pruning : { true, false })
+  {
+    innerProduct.Pruning() = pruning;
+    innerProduct.Search(queryData, 10, neighbors, distances);
+    CheckMatrices(neighbors, denseNeighbors);
+    CheckMatrices(distances, denseScores, 1e-5);
+  }
+
+  // Cosine similarity.
+  arma::mat normalizedReferences = arma::normalise(references);
+  arma::mat normalizedQueries = arma::normalise(queries);
+  DenseTopScores(normalizedReferences.t() * normalizedQueries, 10,
+      denseNeighbors, denseScores);
+
+  SparseKNN<> cosine(referenceData, COSINE_SEARCH);
+  for (const bool pruning : { true, false })
+  {
+    cosine.Pruning() = pruning;
+    cosine.Search(queryData, 10, neighbors, distances);
+    CheckMatrices(neighbors, denseNeighbors);
+    CheckMatrices(distances, arma::mat(1 - denseScores), 1e-5);
+  }
+
+  // Too many neighbors are requested.
+  REQUIRE_THROWS_AS(cosine.Search(2000, neighbors, distances),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that the pruning of SparseKNN gives exact results on TF-IDF-like
+ * data, where the frequent dimensions have long lists of small values.
+ */
+TEST_CASE("SparseKNNPruningTest", "[KNNTest]")
+{
+  arma::sp_mat referenceData(500, 3000), queryData(500, 100);
+  for (size_t d = 0; d < 500; ++d)
+  {
+    // Dimension d appears in about 1 / (d / 10 + 2) of the points, with a
+    // value of about its inverse document frequency.
+    const double frequency = 1.0 / (d / 10.0 + 2.0);
+    for (size_t i = 0; i < referenceData.n_cols; ++i)
+      if (Random() < frequency)
+        referenceData(d, i) = -std::log(frequency) * (1.0 + Random());
+    for (size_t i = 0; i < queryData.n_cols; ++i)
+      if (Random() < frequency)
+        queryData(d, i) = -std::log(frequency) * (1.0 + Random());
+  }
+
+  arma::Mat<size_t> neighbors, exactNeighbors;
+  arma::mat distances, exactDistances;
+  for (const SparseSearchMetric metric :
+      { EUCLIDEAN_SEARCH, COSINE_SEARCH, INNER_PRODUCT_SEARCH })
+  {
+    SparseKNN<> knn(referenceData, metric);
+    knn.Search(queryData, 5, neighbors, distances);
+    knn.Pruning() = false;
+    knn.Search(queryData, 5, exactNeighbors, exactDistances);
+
+    CheckMatrices(neighbors, exactNeighbors);
+    CheckMatrices(distances, exactDistances, 1e-5);
+  }
+}
+
+/**
+ * Run DistributedNeighborSearch on the given parts of a reference set and a
+ * query set (one per rank), and make sure that it finds the same neighbors as
+ * a naive search on the whole reference set.  Return the number of pruned
+ * (query, partition) pairs.
+ */
+template<typename SortPolicy>
+static size_t CheckDistributedSearch(const std::vector<arma::mat>& references,
+                                     const std::vector<arma::mat>& queries,
+                                     const size_t k)
+{
+  const size_t numRanks = references.size();
+  std::vector<arma::Mat<size_t>> neighbors(numRanks), allNeighbors(numRanks);
+  std::vector<arma::mat> distances(numRanks), allDistances(numRanks);
+  std::vector<std::vector<size_t>> indices(numRanks);
+  std::vector<size_t> pruned(numRanks);
+  RunOnThreads(numRanks, [&](ThreadCommunicator& comm)
+  {
+    const size_t r = comm.Rank();
+    DistributedNeighborSearch<ThreadCommunicator, SortPolicy> search(comm,
+        500, 40);
+    search.Train(references[r]);
+    search.Search(queries[r], k, neighbors[r], distances[r]);
+    search.Search(k, allNeighbors[r], allDistances[r]);
+    indices[r] = search.LocalIndices();
+    pruned[r] = search.PrunedPartitions();
+  });
+
+  // The global indices are the columns of the whole reference set.
+  arma::mat referenceSet, querySet;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    referenceSet = arma::join_rows(referenceSet, references[r]);
+    querySet = arma::join_rows(querySet, queries[r]);
+  }
+
+  NeighborSearch<SortPolicy> naive(referenceSet, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors;
+  arma::mat naiveDistances;
+  naive.Search(querySet, k, naiveNeighbors, naiveDistances);
+
+  arma::Mat<size_t> distributedNeighbors;
+  arma::mat distributedDistances;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    distributedNeighbors = arma::join_rows(distributedNeighbors,
+        neighbors[r]);
+    distributedDistances = arma::join_rows(distributedDistances,
+        distances[r]);
+  }
+  CheckMatrices(distributedNeighbors, naiveNeighbors);
+  CheckMatrices(distributedDistances, naiveDistances);
+
+  // Every point is in exactly one partition, and its neighbors are those of
+  // the naive monochromatic search.
+  naive.Search(k, naiveNeighbors, naiveDistances);
+  std::vector<bool> seen(referenceSet.n_cols, false);
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    REQUIRE(indices[r].size() == allNeighbors[r].n_cols);
+    for (size_t i = 0; i < indices[r].size(); ++i)
+    {
+      REQUIRE(!seen[indices[r][i]]);
+      seen[indices[r][i]] = true;
+      CheckMatrices(allNeighbors[r].col(i),
+          naiveNeighbors.col(indices[r][i]));
+      CheckMatrices(allDistances[r].col(i),
+          naiveDistances.col(indices[r][i]));
+    }
+  }
+  REQUIRE(std::count(seen.begin(), seen.end(), true) ==
+      (long) referenceSet.n_cols);
+
+  size_t totalPruned = 0;
+  for (size_t r = 0; r < numRanks; ++r)
+    totalPruned += pruned[r];
+  return totalPruned;
+}
+
+/**
+ * Make sure that DistributedNeighborSearch with several ranks (one of which
+ * has no points) gives the results of a naive search, and that the bounds of
+ * the partitions prune searches on clustered data.
+ */
+TEST_CASE("DistributedKNNTest", "[KNNTest]")
+{
+  // Clustered data, split unevenly (and not spatially) across the ranks.
+  arma::mat dataset(3, 4000, arma::fill::randn);
+  const arma::mat centers = 20.0 * arma::randu<arma::mat>(3, 8);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    dataset.col(i) = 0.5 * dataset.col(i) + centers.col(i % 8);
+  const arma::mat querySet = 20.0 * arma::randu<arma::mat>(3, 600);
+
+  const std::vector<size_t> splits = { 0, 500, 1700, 1700, 4000 };
+  std::vector<arma::mat> references, queries;
+  for (size_t r = 0; r < 4; ++r)
+  {
+    references.push_back((splits[r] == splits[r + 1]) ? arma::mat(3, 0) :
+        arma::mat(dataset.cols(splits[r], splits[r + 1] - 1)));
+    queries.push_back(querySet.cols(150 * r, 150 * (r + 1) - 1));
+  }
+
+  REQUIRE(CheckDistributedSearch<NearestNeighborSort>(references, queries,
+      5) > 0);
+  CheckDistributedSearch<FurthestNeighborSort>(references, queries, 3);
+
+  // With one rank, the search is the same as NeighborSearch.
+  CheckDistributedSearch<NearestNeighborSort>({ dataset }, { querySet }, 5);
+}
+
+/**
+ * Make sure that DistributedNeighborSearch works with LocalCommunicator.
+ */
+TEST_CASE("DistributedKNNLocalCommunicatorTest", "[KNNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1000);
+  arma::mat querySet = arma::randu<arma::mat>(4, 100);
+
+  LocalCommunicator comm;
+  DistributedNeighborSearch<LocalCommunicator> search(comm);
+  search.Train(dataset);
+  REQUIRE(search.GlobalSize() == 1000);
+  REQUIRE(search.PartitionSizes().size() == 1);
+  REQUIRE(search.PartitionSizes()[0] == 1000);
+
+  KNN naive(dataset, NAIVE_MODE);
+  arma::Mat<size_t> neighbors, naiveNeighbors;
+  arma::mat distances, naiveDistances;
+  search.Search(querySet, 4, neighbors, distances);
+  naive.Search(querySet, 4, naiveNeighbors, naiveDistances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Too many neighbors, or queries of the wrong dimensionality.
+  REQUIRE_THROWS_AS(search.Search(1000, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(search.Search(arma::mat(3, 10, arma::fill::randu), 4,
+      neighbors, distances), std::invalid_argument);
+}
+
+/**
+ * Make sure that AnytimeSearch() without a budget gives exact results, with a
+ * quality of 1, for several tree types.
+ */
+TEMPLATE_TEST_CASE("KNNAnytimeSearchExactTest", "[KNNTest]", KNN,
+    (NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        BallTree>),
+    (NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        StandardCoverTree>),
+    (NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat,
+        RStarTree>))
+{
+  arma::mat referenceData = arma::randu<arma::mat>(4, 1500);
+  arma::mat queryData = arma::randu<arma::mat>(4, 200);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  TestType search(referenceData);
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  arma::vec quality;
+  naive.Search(queryData, 6, naiveNeighbors, naiveDistances);
+  search.AnytimeSearch(queryData, 6, neighbors, distances, quality, 0.0);
+
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+  REQUIRE(quality.n_elem == queryData.n_cols);
+  REQUIRE(arma::all(quality == 1.0));
+}
+
+/**
+ * Make sure that when AnytimeSearch() is stopped by the node budget, the
+ * quality of each query point bounds the distances of the true neighbors.
+ */
+TEST_CASE("KNNAnytimeSearchBudgetTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(6, 5000);
+  arma::mat queryData = arma::randu<arma::mat>(6, 300);
+  const size_t k = 5;
+
+  KNN naive(referenceData, NAIVE_MODE);
+  KFN naiveFurthest(referenceData, NAIVE_MODE);
+  arma::Mat<size_t> naiveNeighbors, naiveFurthestNeighbors;
+  arma::mat naiveDistances, naiveFurthestDistances;
+  naive.Search(queryData, k, naiveNeighbors, naiveDistances);
+  naiveFurthest.Search(queryData, k, naiveFurthestNeighbors,
+      naiveFurthestDistances);
+
+  KNN knn(referenceData);
+  KFN kfn(referenceData);
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  arma::vec quality;
+
+  knn.AnytimeSearch(queryData, k, neighbors, distances, quality, 0.0, 8);
+  REQUIRE(arma::any(quality < 1.0));
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    REQUIRE(quality[i] >= 0.0);
+    REQUIRE(quality[i] <= 1.0);
+
+    // The candidates are real neighbors, so they cannot be better than the
+    // true ones; and the true k-th neighbor is either a candidate or was not
+    // considered.
+    REQUIRE(distances(k - 1, i) >= naiveDistances(k - 1, i) - 1e-10);
+    REQUIRE(naiveDistances(k - 1, i) >=
+        quality[i] * distances(k - 1, i) - 1e-10);
+    if (quality[i] == 1.0)
+      REQUIRE(distances(k - 1, i) == Approx(naiveDistances(k - 1, i)));
+
+    for (size_t j = 0; j < k; ++j)
+    {
+      REQUIRE(neighbors(j, i) < referenceData.n_cols);
+      REQUIRE(distances(j, i) == Approx(arma::norm(queryData.col(i) -
+          referenceData.col(neighbors(j, i)))));
+    }
+  }
+
+  kfn.AnytimeSearch(queryData, k, neighbors, distances, quality, 0.0, 8);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    REQUIRE(distances(k - 1, i) <= naiveFurthestDistances(k - 1, i) + 1e-10);
+    if (quality[i] > 0.0)
+    {
+      REQUIRE(naiveFurthestDistances(k - 1, i) <=
+          distances(k - 1, i) / quality[i] + 1e-10);
+    }
+  }
+
+  // A tiny time limit still gives the candidates of at least one leaf.
+  knn.AnytimeSearch(queryData, 1, neighbors, distances, quality, 1e-9);
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+    REQUIRE(neighbors(0, i) < referenceData.n_cols);
+
+  // A reference tree is needed.
+  KNN naiveSearch(referenceData, NAIVE_MODE);
+  REQUIRE_THROWS_AS(naiveSearch.AnytimeSearch(queryData, k, neighbors,
+      distances, quality, 0.001), std::invalid_argument);
+}
+
+/**
+ * Make sure that symmetric monochromatic search gives the same results as
+ * naive search for nearest and furthest neighbors, with fewer base cases than
+ * the regular dual-tree search.
+ */
+TEST_CASE("KNNSymmetricTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+
+  KNN naive(referenceData, NAIVE_MODE);
+  KNN knn(referenceData);
+  KNN naiveSymmetric(referenceData, NAIVE_MODE);
+  KNN symmetric(referenceData);
+  naiveSymmetric.Symmetric() = true;
+  symmetric.Symmetric() = true;
+
+  arma::Mat<size_t> naiveNeighbors, neighbors;
+  arma::mat naiveDistances, distances;
+  naive.Search(5, naiveNeighbors, naiveDistances);
+  knn.Search(5, neighbors, distances);
+  const size_t dualTreeBaseCases = knn.BaseCases();
+
+  naiveSymmetric.Search(5, neighbors, distances);
+  REQUIRE(naiveSymmetric.BaseCases() == 1000 * 999 / 2);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  // Search twice, so that the bounds of the tree are reset.
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    symmetric.Search(5, neighbors, distances);
+    REQUIRE(symmetric.BaseCases() < dualTreeBaseCases);
+    CheckMatrices(neighbors, naiveNeighbors);
+    CheckMatrices(distances, naiveDistances);
+  }
+
+  // R trees and furthest neighbors.
+  NeighborSearch<NearestNeighborSort, EuclideanDistance, arma::mat, RTree>
+      rTreeSearch(referenceData);
+  rTreeSearch.Symmetric() = true;
+  rTreeSearch.Search(5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+
+  KFN naiveFurthest(referenceData, NAIVE_MODE);
+  KFN kfn(referenceData);
+  kfn.Symmetric() = true;
+  naiveFurthest.Search(5, naiveNeighbors, naiveDistances);
+  kfn.Search(5, neighbors, distances);
+  CheckMatrices(neighbors, naiveNeighbors);
+  CheckMatrices(distances, naiveDistances);
+}
+
+/**
+ * Make sure that a kd-tree whose dimensionality is fixed by its distance
+ * metric gives the same results as the default kd-tree.
+ */
+TEST_CASE("KNNFixedDimTest", "[KNNTest]")
+{
+  arma::mat referenceData = arma::randu<arma::mat>(2, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(2, 200);
+
+  KNN knn(referenceData);
+  NeighborSearch<NearestNeighborSort, LMetric<2, true, 2>> fixedKnn(
+      referenceData);
+
+  arma::Mat<size_t> neighbors, fixedNeighbors;
+  arma::mat distances, fixedDistances;
+  knn.Search(queryData, 5, neighbors, distances);
+  fixedKnn.Search(queryData, 5, fixedNeighbors, fixedDistances);
+  CheckMatrices(fixedNeighbors, neighbors);
+  CheckMatrices(fixedDistances, distances);
+
+  knn.Search(5, neighbors, distances);
+  fixedKnn.Search(5, fixedNeighbors, fixedDistances);
+  CheckMatrices(fixedNeighbors, neighbors);
+  CheckMatrices(fixedDistances, distances);
+
+  // The tree can't be built on data of another dimensionality.
+  arma::mat wrongData = arma::randu<arma::mat>(3, 100);
+  REQUIRE_THROWS_AS((NeighborSearch<NearestNeighborSort, LMetric<2, true, 2>>(
+      wrongData)), std::invalid_argument);
+}
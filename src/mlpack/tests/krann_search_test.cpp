@@ -15,6 +15,7 @@
 #include <mlpack/methods/rann/ra_model.hpp>
 
 #include "catch.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace std;
 using namespace mlpack;
@@ -270,6 +271,50 @@ TEST_CASE("SingleDatasetSearch", "[KRANNTest]")
   REQUIRE(distances.n_cols == 2500);
 }
 
+// Make sure that rank-approximate search with several threads gives the same
+// results for the same random seed, in every search mode.
+TEST_CASE("KRANNParallelReproducibilityTest", "[KRANNTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat refData(5, 2000, arma::fill::randu);
+  arma::mat queryData(5, 500, arma::fill::randu);
+
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    RASearch<> rann(refData, mode == 0, mode == 1, 5.0, 0.95);
+
+    // Search with a query set and then monochromatically.
+    for (size_t mono = 0; mono < 2; ++mono)
+    {
+      arma::Mat<size_t> neighbors1, neighbors2;
+      arma::mat distances1, distances2;
+
+      RandomSeed(42);
+      if (mono)
+        rann.Search(3, neighbors1, distances1);
+      else
+        rann.Search(queryData, 3, neighbors1, distances1);
+
+      RandomSeed(42);
+      if (mono)
+        rann.Search(3, neighbors2, distances2);
+      else
+        rann.Search(queryData, 3, neighbors2, distances2);
+
+      CheckMatrices(neighbors1, neighbors2);
+      CheckMatrices(distances1, distances2);
+    }
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
 // Test single-tree rank-approximate search with cover trees.
 TEST_CASE("SingleCoverTreeTest", "[KRANNTest]")
 {
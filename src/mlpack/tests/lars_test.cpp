@@ -1346,3 +1346,46 @@ TEMPLATE_TEST_CASE("LARSSparseModelDenseData", "[LARSTest]", float, double)
   REQUIRE(lars2.ActiveSet().size() < 1000);
   REQUIRE(lars2.ActiveSet().size() > 0);
 }
+
+// Make sure that training in covariance form (on X^T X and X^T y only) gives
+// the same path as training on the data.
+TEST_CASE("LARSCovarianceFormTest", "[LARSTest]")
+{
+  // The data has large means, to check that the moments are centered stably.
+  arma::mat data = arma::randn<arma::mat>(20, 5000) + 10.0;
+  arma::vec beta = arma::randn<arma::vec>(20);
+  beta.subvec(10, 19).zeros();
+  arma::rowvec responses = beta.t() * data + 3.0 +
+      0.1 * arma::randn<arma::rowvec>(5000);
+  arma::mat dataTrans = data.t();
+
+  for (size_t config = 0; config < 16; ++config)
+  {
+    const bool useCholesky = (config & 1);
+    const bool fitIntercept = (config & 2);
+    const bool normalizeData = (config & 4);
+    const double lambda2 = (config & 8) ? 0.5 : 0.0;
+
+    LARS<> lars(useCholesky, 10.0, lambda2, 1e-16, fitIntercept,
+        normalizeData);
+    LARS<> covLars(lars);
+    covLars.CovarianceForm() = true;
+
+    lars.Train(data, responses);
+    const double error = covLars.Train(data, responses);
+    REQUIRE(error == Approx(lars.ComputeError(data, responses)));
+
+    REQUIRE(covLars.BetaPath().size() == lars.BetaPath().size());
+    REQUIRE(covLars.ActiveSet().size() == lars.ActiveSet().size());
+    REQUIRE(arma::approx_equal(covLars.Beta(), lars.Beta(), "absdiff", 1e-6));
+    REQUIRE(covLars.Intercept() ==
+        Approx(lars.Intercept()).epsilon(1e-6).margin(1e-6));
+
+    // Row-major data gives the same solution.
+    LARS<> rowLars(useCholesky, 10.0, lambda2, 1e-16, fitIntercept,
+        normalizeData);
+    rowLars.CovarianceForm() = true;
+    rowLars.Train(dataTrans, responses, false);
+    REQUIRE(arma::approx_equal(rowLars.Beta(), lars.Beta(), "absdiff", 1e-6));
+  }
+}
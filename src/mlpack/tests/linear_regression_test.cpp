@@ -423,3 +423,80 @@ TEST_CASE("LinearRegressionSparseTrainingTest", "[LinearRegressionTest]")
 
   REQUIRE(predictions.n_elem == 5000);
 }
+
+// Make sure that training on statistics accumulated over chunks of the data
+// gives the same model as training on all of the data at once.
+TEST_CASE("LinearRegressionNormalEquationsTest", "[LinearRegressionTest]")
+{
+  arma::mat predictors = arma::randn<arma::mat>(10, 5000) + 10.0;
+  arma::rowvec responses = arma::randn<arma::rowvec>(10) * predictors + 5.0 +
+      0.1 * arma::randn<arma::rowvec>(5000);
+
+  // Uneven chunks, with one spanning several blocks.
+  NormalEquations<> stats;
+  stats.Update(predictors.cols(0, 0), responses.subvec(0, 0));
+  stats.Update(predictors.cols(1, 1999), responses.subvec(1, 1999));
+  stats.Update(predictors.cols(2000, 4999), responses.subvec(2000, 4999));
+  REQUIRE(stats.Count() == 5000);
+  REQUIRE(arma::approx_equal(stats.Means(), arma::mean(predictors, 1),
+      "absdiff", 1e-10));
+  REQUIRE(arma::approx_equal(stats.Scatter(), 4999.0 * arma::cov(
+      predictors.t()), "reldiff", 1e-8));
+
+  // Accumulating the chunks given by a function, or merging the statistics of
+  // two halves, gives the same statistics.
+  size_t position = 0;
+  NormalEquations<> streamStats;
+  const size_t points = streamStats.Accumulate(
+      [&](arma::mat& chunk, arma::rowvec& chunkResponses)
+      {
+        if (position == predictors.n_cols)
+          return false;
+
+        const size_t end = std::min(position + 700,
+            (size_t) predictors.n_cols) - 1;
+        chunk = predictors.cols(position, end);
+        chunkResponses = responses.subvec(position, end);
+        position = end + 1;
+        return true;
+      });
+  REQUIRE(points == 5000);
+
+  NormalEquations<> firstHalf, secondHalf;
+  firstHalf.Update(predictors.cols(0, 2499), responses.subvec(0, 2499));
+  secondHalf.Update(predictors.cols(2500, 4999),
+      responses.subvec(2500, 4999));
+  firstHalf.Merge(secondHalf);
+
+  for (const NormalEquations<>* other : { &streamStats, &firstHalf })
+  {
+    REQUIRE(other->Count() == 5000);
+    REQUIRE(arma::approx_equal(other->Scatter(), stats.Scatter(), "reldiff",
+        1e-8));
+    REQUIRE(arma::approx_equal(other->Cross(), stats.Cross(), "reldiff",
+        1e-8));
+    REQUIRE(other->ResponsesScatter() ==
+        Approx(stats.ResponsesScatter()).epsilon(1e-8));
+  }
+
+  for (const double lambda : { 0.0, 0.5 })
+  {
+    for (const bool intercept : { true, false })
+    {
+      LinearRegression<> lr(predictors, responses, lambda, intercept);
+      LinearRegression<> streamLr;
+      const double error = streamLr.Train(stats, lambda, intercept);
+
+      REQUIRE(streamLr.Lambda() == lambda);
+      REQUIRE(streamLr.Intercept() == intercept);
+      REQUIRE(arma::approx_equal(streamLr.Parameters(), lr.Parameters(),
+          "reldiff", 1e-6));
+      REQUIRE(error == Approx(lr.ComputeError(predictors, responses))
+          .epsilon(1e-6));
+    }
+  }
+
+  // Chunks of different dimensionality cannot be accumulated.
+  REQUIRE_THROWS_AS(stats.Update(predictors.rows(0, 4), responses),
+      std::invalid_argument);
+}
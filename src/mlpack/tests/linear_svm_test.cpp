@@ -462,6 +462,49 @@ TEST_CASE("LinearSVMFunctionSeparableGradient", "[LinearSVMTest]")
   }
 }
 
+/**
+ * Make sure that the objective and gradient on a dataset of many blocks (which
+ * are computed in parallel) match the sums over the individual points.
+ */
+TEST_CASE("LinearSVMFunctionBlockedEvaluateWithGradient", "[LinearSVMTest]")
+{
+  const size_t points = 5000;
+  const size_t inputSize = 10;
+  const size_t numClasses = 4;
+
+  arma::mat data;
+  data.randu(inputSize, points);
+  arma::Row<size_t> labels(points);
+  for (size_t i = 0; i < points; ++i)
+    labels(i) = RandInt(0, numClasses);
+
+  for (const bool fitIntercept : { false, true })
+  {
+    LinearSVMFunction<> svmf(data, labels, numClasses, 0.0, 1.0,
+        fitIntercept);
+
+    arma::mat parameters;
+    parameters.randn(inputSize + (fitIntercept ? 1 : 0), numClasses);
+
+    arma::mat gradient, pointGradient;
+    const double objective = svmf.EvaluateWithGradient(parameters, gradient);
+
+    double pointObjectives = 0.0;
+    arma::mat pointGradients(arma::size(parameters), arma::fill::zeros);
+    for (size_t i = 0; i < points; ++i)
+    {
+      pointObjectives += svmf.Evaluate(parameters, i, 1);
+      svmf.Gradient(parameters, i, pointGradient, 1);
+      pointGradients += pointGradient;
+    }
+
+    REQUIRE(objective == Approx(pointObjectives / points).epsilon(1e-7));
+    REQUIRE(svmf.Evaluate(parameters) == Approx(objective).epsilon(1e-10));
+    REQUIRE(arma::approx_equal(gradient, pointGradients / points, "absdiff",
+        1e-8));
+  }
+}
+
 /**
  * Test training of linear svm on a simple dataset using
  * L-BFGS optimizer
@@ -1475,3 +1518,75 @@ TEMPLATE_TEST_CASE("LinearSVMTrainVariantTest", "[LinearSVMTest]", arma::fmat,
   REQUIRE(lsvm16.FeatureSize() == 10);
   REQUIRE(lsvm16.NumClasses() == 2);
 }
+
+/**
+ * Make sure that dual coordinate descent finds an objective at least as good
+ * as L-BFGS, with and without shrinking and an intercept.
+ */
+TEST_CASE("LinearSVMDualCoordinateDescentTest", "[LinearSVMTest]")
+{
+  // Three Gaussians that overlap a little.
+  arma::mat dataset(5, 600, arma::fill::randn);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = i % 3;
+    dataset(labels[i], i) += 2.0;
+  }
+
+  for (const bool fitIntercept : { false, true })
+  {
+    LinearSVM<> lbfgsSvm;
+    const double lbfgsObjective = lbfgsSvm.Train(dataset, labels, 3, 0.01,
+        1.0, fitIntercept);
+
+    for (const bool shrinking : { false, true })
+    {
+      DualCoordinateDescent dcd(0, 1e-5, shrinking);
+      LinearSVM<> svm;
+      const double objective = svm.Train(dataset, labels, 3, dcd, 0.01, 1.0,
+          fitIntercept);
+
+      REQUIRE(svm.Parameters().n_rows == (fitIntercept ? 6 : 5));
+      REQUIRE(svm.Parameters().n_cols == 3);
+      REQUIRE(objective <= lbfgsObjective + 1e-4);
+      REQUIRE(objective == Approx(lbfgsObjective).epsilon(1e-2));
+      REQUIRE(svm.ComputeAccuracy(dataset, labels) > 80.0);
+    }
+  }
+}
+
+/**
+ * Make sure that dual coordinate descent gives the same solution on sparse and
+ * dense data.
+ */
+TEST_CASE("LinearSVMDualCoordinateDescentSparseTest", "[LinearSVMTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(100, 500, 0.05);
+  const arma::mat denseDataset(dataset);
+  const arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::sum(denseDataset.rows(0, 49), 0) >
+      arma::sum(denseDataset.rows(50, 99), 0));
+
+  DualCoordinateDescent dcd(0, 1e-5);
+  LinearSVM<> svm, sparseSvm;
+  const double objective = svm.Train(denseDataset, labels, 2, dcd, 0.001, 1.0,
+      true);
+  const double sparseObjective = sparseSvm.Train(dataset, labels, 2, dcd,
+      0.001, 1.0, true);
+
+  REQUIRE(sparseObjective == Approx(objective).epsilon(1e-4));
+  for (size_t i = 0; i < svm.Parameters().n_elem; ++i)
+  {
+    REQUIRE(sparseSvm.Parameters()[i] ==
+        Approx(svm.Parameters()[i]).margin(1e-2));
+  }
+
+  // The limit on the number of passes is respected.
+  dcd.MaxIterations() = 1;
+  dcd.Shrinking() = false;
+  sparseSvm.Train(dataset, labels, 2, dcd, 0.001, 1.0, true);
+  REQUIRE(sparseSvm.Parameters().n_rows == 101);
+  REQUIRE(sparseSvm.Parameters().n_cols == 2);
+}
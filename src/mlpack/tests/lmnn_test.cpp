@@ -97,6 +97,73 @@ TEMPLATE_TEST_CASE("LMNNImpostorsTest", "[LMNNTest]", float, double)
   REQUIRE(impostors(0, 5) == 2);
 }
 
+/**
+ * Recomputing the impostors of only some points should give the same results
+ * as recomputing them for the whole dataset, whether a brute-force search (for
+ * a few points) or a tree search is used, and should not modify the impostors
+ * of the other points.
+ */
+TEMPLATE_TEST_CASE("LMNNImpostorsSubsetTest", "[LMNNTest]", float, double)
+{
+  using ElemType = TestType;
+
+  arma::Mat<ElemType> dataset;
+  arma::Row<size_t> labels;
+  if (!data::Load("iris.csv", dataset))
+    FAIL("Cannot load dataset iris.csv");
+  if (!data::Load("iris_labels.txt", labels))
+    FAIL("Cannot load dataset iris_labels.txt");
+
+  Constraints<arma::Mat<ElemType>, arma::Row<size_t>> constraint(dataset,
+      labels, 3);
+
+  arma::Col<ElemType> norm(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    norm(i) = arma::norm(dataset.col(i));
+
+  arma::umat impostors(3, dataset.n_cols);
+  arma::Mat<ElemType> distances(3, dataset.n_cols);
+  constraint.Impostors(impostors, distances, dataset, labels, norm);
+
+  // A few points (brute-force search) and many points (tree search).
+  arma::uvec points = arma::randperm(dataset.n_cols);
+  for (const size_t numPoints : { (size_t) 0, (size_t) 2, (size_t) 100 })
+  {
+    arma::umat subImpostors(3, dataset.n_cols);
+    subImpostors.fill(dataset.n_cols);
+    arma::Mat<ElemType> subDistances(3, dataset.n_cols);
+    subDistances.fill(-1);
+
+    constraint.Impostors(subImpostors, subDistances, dataset, labels, norm,
+        points, numPoints);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      const bool queried = arma::any(points.head(numPoints) == i);
+      for (size_t j = 0; j < 3; ++j)
+      {
+        if (queried)
+        {
+          // Duplicate points make the indices ambiguous, so only check that
+          // the impostor is at the right distance and has a different label.
+          REQUIRE(subImpostors(j, i) < dataset.n_cols);
+          REQUIRE(labels(subImpostors(j, i)) != labels(i));
+          REQUIRE(subDistances(j, i) ==
+              Approx(distances(j, i)).epsilon(1e-5));
+          REQUIRE(SquaredEuclideanDistance::Evaluate(dataset.col(i),
+              dataset.col(subImpostors(j, i))) ==
+              Approx(distances(j, i)).epsilon(1e-5));
+        }
+        else
+        {
+          REQUIRE(subImpostors(j, i) == dataset.n_cols);
+          REQUIRE(subDistances(j, i) == ElemType(-1));
+        }
+      }
+    }
+  }
+}
+
 //
 // Tests for the LMNNFunction
 //
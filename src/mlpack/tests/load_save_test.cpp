@@ -9,9 +9,13 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#include <cstring>
 #include <sstream>
 
 #include <mlpack/core.hpp>
+#ifdef MLPACK_HAS_ARROW
+  #include <parquet/arrow/writer.h>
+#endif
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
 
@@ -2555,3 +2559,740 @@ TEST_CASE("LoadCSVHeaderTest", "[LoadSaveTest]")
   REQUIRE(dataset.n_rows == 4);
   REQUIRE(dataset.n_cols == 2);
 }
+
+/**
+ * Make sure that CSVChunkReader returns the same points as data::Load(), one
+ * chunk at a time.
+ */
+TEST_CASE("CSVChunkReaderTest", "[LoadSaveTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(4, 1050);
+  REQUIRE(data::Save("test_chunks.csv", dataset) == true);
+
+  arma::mat loaded;
+  REQUIRE(data::Load("test_chunks.csv", loaded) == true);
+
+  data::CSVChunkReader reader("test_chunks.csv", 100);
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    arma::mat chunk;
+    size_t chunks = 0;
+    size_t points = 0;
+    while (reader.Next(chunk))
+    {
+      REQUIRE(chunk.n_rows == 4);
+      REQUIRE(chunk.n_cols == ((chunks < 10) ? 100 : 50));
+      CheckMatrices(chunk, loaded.cols(points, points + chunk.n_cols - 1));
+
+      points += chunk.n_cols;
+      ++chunks;
+    }
+
+    REQUIRE(chunks == 11);
+    REQUIRE(points == 1050);
+    REQUIRE(reader.Dimensionality() == 4);
+    reader.Reset();
+  }
+
+  remove("test_chunks.csv");
+}
+
+/**
+ * Make sure that CSVChunkReader rejects rows with the wrong number of values.
+ */
+TEST_CASE("CSVChunkReaderBadRowTest", "[LoadSaveTest]")
+{
+  std::fstream f;
+  f.open("test_chunks.csv", std::fstream::out);
+  f << "1, 2, 3" << std::endl;
+  f << std::endl;
+  f << "4, 5, 6" << std::endl;
+  f << "7, 8" << std::endl;
+  f.close();
+
+  data::CSVChunkReader reader("test_chunks.csv", 2);
+  arma::mat chunk;
+  REQUIRE(reader.Next(chunk) == true);
+  REQUIRE(chunk.n_rows == 3);
+  REQUIRE(chunk.n_cols == 2);
+  REQUIRE(chunk(2, 1) == 6.0);
+  REQUIRE_THROWS_AS(reader.Next(chunk), std::runtime_error);
+
+  remove("test_chunks.csv");
+
+  REQUIRE_THROWS_AS(data::CSVChunkReader("nonexistent_file.csv", 10),
+      std::runtime_error);
+}
+
+/**
+ * Make sure that the parallel numeric CSV parser gives the same matrix as the
+ * stream parser, with irregular rows, special values, and a blank line that
+ * ends the data.
+ */
+TEST_CASE("ParallelNumericCSVTest", "[LoadSaveTest]")
+{
+  const std::string contents = "1, 2.5, -3e2, 4\n"
+                               "+5,inf,-INF,nan\r\n"
+                               ",7,\n"
+                               "8\n"
+                               "\n"
+                               "9, 10, 11, 12, 13\n";
+
+  fstream f;
+  f.open("test_parallel.csv", fstream::out | fstream::binary);
+  f << contents;
+  f.close();
+
+  arma::mat streamMatrix;
+  f.open("test_parallel.csv", fstream::in | fstream::binary);
+  LoadCSV streamLoader;
+  REQUIRE(streamLoader.LoadNumericCSV(streamMatrix, f) == true);
+  f.close();
+
+  for (const bool transpose : { false, true })
+  {
+    arma::mat x;
+    LoadCSV loader;
+    REQUIRE(loader.LoadNumericCSV(x, contents.data(), contents.size(),
+        transpose) == true);
+    if (transpose)
+      x = x.t();
+
+    REQUIRE(x.n_rows == 4);
+    REQUIRE(x.n_cols == 4);
+    REQUIRE(x.n_rows == streamMatrix.n_rows);
+    REQUIRE(x.n_cols == streamMatrix.n_cols);
+    for (size_t i = 0; i < x.n_elem; ++i)
+    {
+      if (std::isnan(streamMatrix[i]))
+        REQUIRE(std::isnan(x[i]));
+      else
+        REQUIRE(x[i] == streamMatrix[i]);
+    }
+  }
+
+  // data::Load() uses the parallel parser.
+  arma::mat loaded;
+  REQUIRE(data::Load("test_parallel.csv", loaded) == true);
+  REQUIRE(loaded.n_rows == 4);
+  REQUIRE(loaded.n_cols == 4);
+  REQUIRE(loaded(2, 0) == -300.0);
+  REQUIRE(loaded(1, 1) == std::numeric_limits<double>::infinity());
+  REQUIRE(loaded(2, 1) == -std::numeric_limits<double>::infinity());
+  REQUIRE(std::isnan(loaded(3, 1)));
+  REQUIRE(loaded(0, 2) == 0.0);
+  REQUIRE(loaded(3, 3) == 0.0);
+
+  // Negative values are loaded as 0 into unsigned matrices.
+  arma::Mat<size_t> unsignedMatrix;
+  LoadCSV loader;
+  const std::string unsignedContents = "1,-2,3\n4,5,6\n";
+  REQUIRE(loader.LoadNumericCSV(unsignedMatrix, unsignedContents.data(),
+      unsignedContents.size(), false) == true);
+  REQUIRE(unsignedMatrix(0, 1) == 0);
+  REQUIRE(unsignedMatrix(1, 2) == 6);
+
+  remove("test_parallel.csv");
+}
+
+/**
+ * Make sure that the parallel numeric CSV parser handles contents spanning
+ * many blocks, and reports bad tokens in any of them.
+ */
+TEST_CASE("ParallelNumericCSVManyBlocksTest", "[LoadSaveTest]")
+{
+  // About 20MB of data.
+  const size_t rows = 1000000;
+  std::ostringstream oss;
+  arma::mat expected(3, rows);
+  for (size_t i = 0; i < rows; ++i)
+  {
+    oss << i << "," << (i % 7) << ".5," << (rows - i) << "\n";
+    expected(0, i) = (double) i;
+    expected(1, i) = (i % 7) + 0.5;
+    expected(2, i) = (double) (rows - i);
+  }
+  std::string contents = oss.str();
+
+  arma::mat x;
+  LoadCSV loader;
+  REQUIRE(loader.LoadNumericCSV(x, contents.data(), contents.size(), true) ==
+      true);
+  REQUIRE(x.n_rows == 3);
+  REQUIRE(x.n_cols == rows);
+  REQUIRE(arma::approx_equal(x, expected, "absdiff", 0.0));
+
+  // Break the last token.
+  contents[contents.size() - 2] = 'x';
+  REQUIRE(loader.LoadNumericCSV(x, contents.data(), contents.size(), true) ==
+      false);
+}
+
+/**
+ * Make sure that the parallel categorical CSV parser gives the same matrix and
+ * mappings as the serial parser.
+ */
+TEST_CASE("ParallelCategoricalCSVTest", "[LoadSaveTest]")
+{
+  const std::string contents = "1, hello, 3.5,\"a, b\", 7\n"
+                               "  2,world ,4, c, 8 \r\n"
+                               "\n"
+                               "3, hello, x,\"d,e, f\", 9\n"
+                               "4, 1, 5, c, 10\n";
+
+  fstream f;
+  f.open("test_parallel_categorical.csv", fstream::out | fstream::binary);
+  f << contents;
+  f.close();
+
+  for (const bool transpose : { false, true })
+  {
+    arma::mat serial, parallel;
+    DatasetInfo serialInfo, parallelInfo;
+
+    // The serial parser does not allow empty lines.
+    std::string serialContents = contents;
+    serialContents.erase(serialContents.find("\n\n"), 1);
+    f.open("test_parallel_categorical.csv", fstream::out | fstream::binary);
+    f << serialContents;
+    f.close();
+
+    LoadCSV serialLoader("test_parallel_categorical.csv");
+    serialLoader.LoadCategoricalCSV(serial, serialInfo, transpose);
+
+    LoadCSV loader("test_parallel_categorical.csv");
+    loader.LoadCategoricalCSV(parallel, parallelInfo, contents.data(),
+        contents.size(), transpose);
+
+    REQUIRE(parallel.n_rows == serial.n_rows);
+    REQUIRE(parallel.n_cols == serial.n_cols);
+    REQUIRE(arma::approx_equal(parallel, serial, "absdiff", 0.0));
+
+    REQUIRE(parallelInfo.Dimensionality() == serialInfo.Dimensionality());
+    for (size_t d = 0; d < serialInfo.Dimensionality(); ++d)
+    {
+      REQUIRE(parallelInfo.Type(d) == serialInfo.Type(d));
+      REQUIRE(parallelInfo.NumMappings(d) == serialInfo.NumMappings(d));
+    }
+
+    for (size_t i = 0; i < serial.n_elem; ++i)
+    {
+      const size_t d = i % serial.n_rows;
+      if (serialInfo.Type(d) == Datatype::categorical)
+      {
+        REQUIRE(parallelInfo.UnmapString(parallel[i], d) ==
+            serialInfo.UnmapString(serial[i], d));
+      }
+    }
+  }
+
+  // Check a few values of the transposed matrix.
+  arma::mat x;
+  DatasetInfo info;
+  LoadCSV loader("test_parallel_categorical.csv");
+  loader.LoadCategoricalCSV(x, info, contents.data(), contents.size(), true);
+  REQUIRE(x.n_rows == 5);
+  REQUIRE(x.n_cols == 4);
+  REQUIRE(info.Type(0) == Datatype::numeric);
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(info.Type(2) == Datatype::categorical);
+  REQUIRE(x(0, 1) == 2.0);
+  REQUIRE(x(4, 1) == 8.0);
+  REQUIRE(info.UnmapString(x(1, 1), 1) == "world");
+  REQUIRE(info.UnmapString(x(2, 2), 2) == "x");
+  REQUIRE(info.UnmapString(x(3, 0), 3) == "\"a, b\"");
+  REQUIRE(info.UnmapString(x(3, 2), 3) == "\"d,e, f\"");
+  REQUIRE(x(3, 1) == x(3, 3));
+
+  // Lines with the wrong number of dimensions are an error.
+  const std::string wrong = "1,a\n2,b,3\n";
+  REQUIRE_THROWS_AS(loader.LoadCategoricalCSV(x, info, wrong.data(),
+      wrong.size(), true), std::runtime_error);
+
+  remove("test_parallel_categorical.csv");
+}
+
+/**
+ * Make sure that the mappings of the parallel categorical CSV parser follow
+ * the order of the file when it spans many blocks.
+ */
+TEST_CASE("ParallelCategoricalCSVManyBlocksTest", "[LoadSaveTest]")
+{
+  // About 20MB of data.  The last dimension is only categorical because of
+  // its last value.
+  const size_t rows = 1000000;
+  std::ostringstream oss;
+  for (size_t i = 0; i < rows; ++i)
+  {
+    oss << i << ",color" << ((7 * i) % 11) << ",";
+    if (i == rows - 1)
+      oss << "x\n";
+    else
+      oss << (i % 3) << "\n";
+  }
+  const std::string contents = oss.str();
+
+  arma::mat x;
+  DatasetInfo info;
+  LoadCSV loader;
+  loader.LoadCategoricalCSV(x, info, contents.data(), contents.size(), true);
+
+  REQUIRE(x.n_rows == 3);
+  REQUIRE(x.n_cols == rows);
+  REQUIRE(info.Type(0) == Datatype::numeric);
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(info.Type(2) == Datatype::categorical);
+  REQUIRE(info.NumMappings(1) == 11);
+  REQUIRE(info.NumMappings(2) == 4);
+
+  // The tokens are numbered in order of first occurrence.
+  for (size_t i = 0; i < rows; ++i)
+  {
+    REQUIRE(x(0, i) == (double) i);
+    REQUIRE(x(1, i) == (double) (i % 11));
+    REQUIRE(x(2, i) == ((i == rows - 1) ? 3.0 : (double) (i % 3)));
+  }
+}
+
+/**
+ * Make sure that MatrixReader gives the blocks of numeric and categorical text
+ * files that data::Load() gives for the whole file.
+ */
+TEST_CASE("MatrixReaderTextTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_reader.csv", fstream::out);
+  for (size_t i = 0; i < 10; ++i)
+    f << i << ", " << (0.5 * i) << ", " << (10 - i) << endl;
+  f << endl;
+  f.close();
+
+  arma::mat dataset;
+  REQUIRE(data::Load("test_reader.csv", dataset, true) == true);
+
+  data::MatrixReader reader("test_reader.csv", 4);
+  REQUIRE(reader.Dimensionality() == 3);
+
+  // Read the file twice.
+  for (size_t pass = 0; pass < 2; ++pass)
+  {
+    arma::mat block, blocks;
+    std::vector<size_t> sizes;
+    while (reader.Next(block))
+    {
+      sizes.push_back(block.n_cols);
+      blocks = arma::join_rows(blocks, block);
+    }
+
+    REQUIRE(block.n_cols == 0);
+    REQUIRE(sizes == std::vector<size_t>({ 4, 4, 2 }));
+    REQUIRE(reader.Position() == 10);
+    REQUIRE(arma::approx_equal(blocks, dataset, "absdiff", 0.0));
+    reader.Reset();
+  }
+
+  // A categorical file; the last dimension only becomes categorical on the
+  // last line, which is in the last block.
+  f.open("test_reader.csv", fstream::out);
+  f << "1, red, 3" << endl;
+  f << "2, \"dark, green\", 4" << endl;
+  f << "3, red, 5" << endl;
+  f << "4, blue, 6" << endl;
+  f << "5, \"dark, green\", x" << endl;
+  f.close();
+
+  DatasetInfo loadedInfo;
+  REQUIRE(data::Load("test_reader.csv", dataset, loadedInfo, true) == true);
+
+  DatasetInfo info;
+  data::MatrixReader categoricalReader("test_reader.csv", 2);
+  arma::mat block, blocks;
+  while (categoricalReader.Next(block, info))
+    blocks = arma::join_rows(blocks, block);
+
+  REQUIRE(arma::approx_equal(blocks, dataset, "absdiff", 0.0));
+  REQUIRE(info.Dimensionality() == 3);
+  for (size_t d = 0; d < 3; ++d)
+  {
+    REQUIRE(info.Type(d) == loadedInfo.Type(d));
+    REQUIRE(info.NumMappings(d) == loadedInfo.NumMappings(d));
+  }
+  REQUIRE(info.Type(2) == Datatype::categorical);
+  REQUIRE(info.UnmapString(blocks(1, 1), 1) == "\"dark, green\"");
+  REQUIRE(info.UnmapString(blocks(2, 4), 2) == "x");
+
+  // Lines with the wrong number of values are an error.
+  f.open("test_reader.csv", fstream::out);
+  f << "1, 2, 3" << endl;
+  f << "4, 5" << endl;
+  f.close();
+
+  data::MatrixReader badReader("test_reader.csv", 10);
+  REQUIRE_THROWS_AS(badReader.Next(block), std::runtime_error);
+
+  remove("test_reader.csv");
+}
+
+/**
+ * Make sure that MatrixReader reads ARFF files with the categories of their
+ * header.
+ */
+TEST_CASE("MatrixReaderARFFTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("test_reader.arff", fstream::out);
+  f << "@relation test" << endl;
+  f << "@attribute one NUMERIC" << endl;
+  f << "@attribute two {b, a, c}" << endl;
+  f << "@data" << endl;
+  f << "1.5, a" << endl;
+  f << "% a comment line" << endl;
+  f << "2, c" << endl;
+  f << "3, b" << endl;
+  f.close();
+
+  arma::mat dataset;
+  DatasetInfo loadedInfo;
+  REQUIRE(data::Load("test_reader.arff", dataset, loadedInfo) == true);
+
+  DatasetInfo info;
+  data::MatrixReader reader("test_reader.arff", 2);
+  REQUIRE(reader.Dimensionality() == 2);
+
+  arma::mat block;
+  REQUIRE(reader.Next(block, info) == true);
+  REQUIRE(block.n_cols == 2);
+  REQUIRE(block(0, 0) == 1.5);
+  REQUIRE(block(0, 1) == 2.0);
+  REQUIRE(block(1, 0) == dataset(1, 0));
+  REQUIRE(block(1, 1) == dataset(1, 1));
+  REQUIRE(reader.Next(block, info) == true);
+  REQUIRE(block.n_cols == 1);
+  REQUIRE(block(1, 0) == dataset(1, 2));
+  REQUIRE(reader.Next(block, info) == false);
+
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(info.NumMappings(1) == 3);
+  REQUIRE(info.UnmapString(0, 1) == "b");
+
+  // Categorical dimensions need a DatasetInfo.
+  reader.Reset();
+  REQUIRE_THROWS_AS(reader.Next(block), std::runtime_error);
+
+  remove("test_reader.arff");
+}
+
+/**
+ * Make sure that MatrixReader reads the points of Armadillo binary files, in
+ * both orientations and with conversion of the element type.
+ */
+TEST_CASE("MatrixReaderBinaryTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(5, 23, arma::fill::randu);
+
+  // data::Save() stores the points as rows.
+  REQUIRE(data::Save("test_reader.bin", dataset, true) == true);
+  for (const bool transpose : { true, false })
+  {
+    data::MatrixReader reader("test_reader.bin", 10, transpose);
+    REQUIRE(reader.Dimensionality() == (transpose ? 5 : 23));
+
+    arma::mat block, blocks;
+    size_t count = 0;
+    while (reader.Next(block))
+    {
+      blocks = arma::join_rows(blocks, block);
+      ++count;
+    }
+
+    REQUIRE(count == (transpose ? 3 : 1));
+    if (transpose)
+      REQUIRE(arma::approx_equal(blocks, dataset, "absdiff", 0.0));
+    else
+      REQUIRE(arma::approx_equal(blocks, dataset.t(), "absdiff", 0.0));
+  }
+
+  // Read a matrix of integers into a matrix of doubles.
+  arma::Mat<size_t> labels = arma::randi<arma::Mat<size_t>>(3, 17,
+      arma::distr_param(0, 9));
+  REQUIRE(labels.save("test_reader.bin", arma::arma_binary) == true);
+
+  data::MatrixReader reader("test_reader.bin", 5, false);
+  arma::mat block, blocks;
+  while (reader.Next(block))
+    blocks = arma::join_rows(blocks, block);
+  REQUIRE(arma::approx_equal(blocks, arma::conv_to<arma::mat>::from(labels),
+      "absdiff", 0.0));
+
+  remove("test_reader.bin");
+}
+
+/**
+ * Make sure that a matrix saved with data::SaveMapped() can be mapped without
+ * a copy, and loaded as usual.
+ */
+TEST_CASE("MappedMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(7, 31, arma::fill::randu);
+  REQUIRE(data::SaveMapped("test_mapped.bin", dataset) == true);
+
+  arma::mat mapped;
+  std::shared_ptr<data::MappedFile> mapping;
+  REQUIRE(data::LoadMapped("test_mapped.bin", mapped, mapping, false, true,
+      true) == true);
+  REQUIRE(mapping);
+  REQUIRE((const char*) mapped.memptr() == mapping->Data() + 4096);
+  REQUIRE(arma::approx_equal(mapped, dataset, "absdiff", 0.0));
+
+  // The file is a valid Armadillo binary file.
+  arma::mat loaded;
+  REQUIRE(loaded.load("test_mapped.bin", arma::arma_binary) == true);
+  REQUIRE(arma::approx_equal(loaded, dataset, "absdiff", 0.0));
+
+  // The element type must match.
+  arma::fmat wrongType;
+  std::shared_ptr<data::MappedFile> wrongMapping;
+  REQUIRE(data::LoadMapped("test_mapped.bin", wrongType, wrongMapping) ==
+      false);
+  REQUIRE(!wrongMapping);
+
+  // A file saved by Armadillo can be mapped too.
+  arma::Mat<size_t> labels = arma::randi<arma::Mat<size_t>>(3, 17,
+      arma::distr_param(0, 9));
+  REQUIRE(labels.save("test_mapped.bin", arma::arma_binary) == true);
+  arma::Mat<size_t> mappedLabels;
+  std::shared_ptr<data::MappedFile> labelsMapping;
+  REQUIRE(data::LoadMapped("test_mapped.bin", mappedLabels, labelsMapping) ==
+      true);
+  REQUIRE(arma::all(arma::vectorise(mappedLabels == labels)));
+
+  // Raw binary files are loaded as one column.
+  REQUIRE(dataset.save("test_mapped.raw", arma::raw_binary) == true);
+  arma::mat raw;
+  std::shared_ptr<data::MappedFile> rawMapping;
+  REQUIRE(data::LoadMapped("test_mapped.raw", raw, rawMapping, false, false,
+      false, FileType::RawBinary) == true);
+  REQUIRE((const char*) raw.memptr() == rawMapping->Data());
+  REQUIRE(arma::approx_equal(raw, arma::vectorise(dataset), "absdiff", 0.0));
+
+  remove("test_mapped.bin");
+  remove("test_mapped.raw");
+}
+
+/**
+ * Make sure that matrices serialized with the binary archive are stored as raw
+ * memory after their sizes, and loaded back.
+ */
+TEST_CASE("BinaryArchiveMatrixTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(9, 13, arma::fill::randu);
+  std::ostringstream oss(std::ios::out | std::ios::binary);
+  {
+    cereal::BinaryOutputArchive ar(oss);
+    ar(cereal::make_nvp("dataset", dataset));
+  }
+
+  const std::string bytes = oss.str();
+  REQUIRE(bytes.size() == 3 * sizeof(arma::uword) +
+      dataset.n_elem * sizeof(double));
+  REQUIRE(std::memcmp(bytes.data() + 3 * sizeof(arma::uword),
+      dataset.memptr(), dataset.n_elem * sizeof(double)) == 0);
+
+  arma::sp_mat sparse;
+  sparse.sprandu(40, 30, 0.1);
+  arma::cube cube(4, 5, 6, arma::fill::randu);
+  std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+  {
+    cereal::BinaryOutputArchive ar(stream);
+    ar(cereal::make_nvp("sparse", sparse));
+    ar(cereal::make_nvp("cube", cube));
+  }
+
+  arma::sp_mat sparseLoaded;
+  arma::cube cubeLoaded;
+  {
+    cereal::BinaryInputArchive ar(stream);
+    ar(cereal::make_nvp("sparse", sparseLoaded));
+    ar(cereal::make_nvp("cube", cubeLoaded));
+  }
+
+  CheckMatrices(arma::mat(sparseLoaded), arma::mat(sparse));
+  REQUIRE(arma::approx_equal(cubeLoaded, cube, "absdiff", 0.0));
+}
+
+/**
+ * Make sure that objects saved in a blob model file can be loaded one at a
+ * time, with copied or mapped matrices.
+ */
+TEST_CASE("BlobModelTest", "[LoadSaveTest]")
+{
+  arma::mat dataset(50, 100, arma::fill::randu);
+  arma::mat small(2, 3, arma::fill::randu);
+  arma::sp_mat sparse;
+  sparse.sprandu(200, 300, 0.05);
+  arma::cube cube(10, 20, 30, arma::fill::randu);
+  std::vector<arma::vec> vectors(3);
+  for (size_t i = 0; i < vectors.size(); ++i)
+    vectors[i].randu(1000);
+
+  {
+    data::BlobModelWriter writer("test_blob.mlblob");
+    writer.Add("dataset", dataset);
+    writer.Add("small", small);
+    writer.Add("sparse", sparse);
+    writer.Add("cube", cube);
+    writer.Add("vectors", vectors);
+    REQUIRE_THROWS_AS(writer.Add("dataset", small), std::invalid_argument);
+    REQUIRE(writer.NumEntries() == 5);
+  }
+
+  for (const bool mapped : { false, true })
+  {
+    data::BlobModelReader reader("test_blob.mlblob", mapped);
+    REQUIRE(reader.Names() == std::vector<std::string>({ "dataset", "small",
+        "sparse", "cube", "vectors" }));
+    REQUIRE(reader.Contains("cube"));
+    REQUIRE(!reader.Contains("tree"));
+
+    // Load the entries in another order than they were saved.
+    std::vector<arma::vec> vectorsLoaded;
+    reader.Load("vectors", vectorsLoaded);
+    REQUIRE(vectorsLoaded.size() == vectors.size());
+    for (size_t i = 0; i < vectors.size(); ++i)
+    {
+      REQUIRE(vectorsLoaded[i].n_cols == 1);
+      REQUIRE(arma::approx_equal(vectorsLoaded[i], vectors[i], "absdiff",
+          0.0));
+    }
+
+    arma::mat datasetLoaded, smallLoaded;
+    reader.Load("dataset", datasetLoaded);
+    reader.Load("small", smallLoaded);
+    REQUIRE(arma::approx_equal(datasetLoaded, dataset, "absdiff", 0.0));
+    REQUIRE(arma::approx_equal(smallLoaded, small, "absdiff", 0.0));
+
+    // Only large dense matrices use the mapping.
+    const char* begin = reader.Mapping()->Data();
+    const char* end = begin + reader.Mapping()->Size();
+    const char* mem = (const char*) datasetLoaded.memptr();
+    REQUIRE((mem >= begin && mem < end) == mapped);
+    if (mapped)
+      REQUIRE((mem - begin) % 64 == 0);
+    mem = (const char*) smallLoaded.memptr();
+    REQUIRE(!(mem >= begin && mem < end));
+
+    arma::sp_mat sparseLoaded;
+    arma::cube cubeLoaded;
+    reader.Load("sparse", sparseLoaded);
+    reader.Load("cube", cubeLoaded);
+    CheckMatrices(arma::mat(sparseLoaded), arma::mat(sparse));
+    REQUIRE(arma::approx_equal(cubeLoaded, cube, "absdiff", 0.0));
+
+    REQUIRE_THROWS_AS(reader.Load("tree", datasetLoaded), std::runtime_error);
+  }
+
+  // The shortcuts report errors instead of throwing.
+  arma::mat loaded;
+  std::shared_ptr<data::MappedFile> mapping;
+  REQUIRE(data::LoadBlobModel("test_blob.mlblob", "dataset", loaded, mapping,
+      true) == true);
+  REQUIRE(mapping);
+  REQUIRE(arma::approx_equal(loaded, dataset, "absdiff", 0.0));
+  REQUIRE(data::LoadBlobModel("test_blob.mlblob", "tree", loaded) == false);
+  REQUIRE(data::LoadBlobModel("test_mapped_none.bin", "dataset", loaded) ==
+      false);
+
+  // The file is overwritten below, so the mapping must not be used anymore.
+  loaded.reset();
+  mapping.reset();
+
+#ifdef MLPACK_HAS_ZLIB
+  // Compressible blobs are compressed, and loaded back correctly.
+  arma::mat zeros(100, 100, arma::fill::zeros);
+  REQUIRE(data::SaveBlobModel("test_blob.mlblob", "zeros", zeros, true) ==
+      true);
+  REQUIRE(data::LoadBlobModel("test_blob.mlblob", "zeros", loaded, mapping,
+      true) == true);
+  REQUIRE(arma::approx_equal(loaded, zeros, "absdiff", 0.0));
+  const char* mem = (const char*) loaded.memptr();
+  REQUIRE(!(mem >= mapping->Data() && mem < mapping->Data() +
+      mapping->Size()));
+#else
+  REQUIRE(data::SaveBlobModel("test_blob.mlblob", "dataset", dataset, true) ==
+      false);
+#endif
+
+  remove("test_blob.mlblob");
+}
+
+#ifdef MLPACK_HAS_ARROW
+/**
+ * Make sure that a Parquet file can be loaded with data::Load(), and read one
+ * row group at a time, with only some of its columns.
+ */
+TEST_CASE("ArrowReaderParquetTest", "[LoadSaveTest]")
+{
+  arrow::DoubleBuilder xBuilder;
+  arrow::Int32Builder yBuilder;
+  arrow::StringBuilder zBuilder;
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(xBuilder.Append(0.5 * i).ok());
+    REQUIRE(yBuilder.Append(i).ok());
+    REQUIRE(zBuilder.Append(i % 3 == 0 ? "a" : "b").ok());
+  }
+
+  std::shared_ptr<arrow::Array> x, y, z;
+  REQUIRE(xBuilder.Finish(&x).ok());
+  REQUIRE(yBuilder.Finish(&y).ok());
+  REQUIRE(zBuilder.Finish(&z).ok());
+  std::shared_ptr<arrow::Table> table = arrow::Table::Make(arrow::schema({
+      arrow::field("x", arrow::float64()), arrow::field("y", arrow::int32()),
+      arrow::field("z", arrow::utf8()) }), { x, y, z });
+
+  // Write row groups of four rows.
+  arrow::Result<std::shared_ptr<arrow::io::FileOutputStream>> output =
+      arrow::io::FileOutputStream::Open("test_arrow.parquet");
+  REQUIRE(output.ok());
+  REQUIRE(parquet::arrow::WriteTable(*table, arrow::default_memory_pool(),
+      *output, 4).ok());
+  REQUIRE((*output)->Close().ok());
+
+  // The string column can only be loaded with a DatasetInfo.
+  arma::mat dataset;
+  REQUIRE(data::Load("test_arrow.parquet", dataset) == false);
+
+  data::DatasetInfo info;
+  REQUIRE(data::Load("test_arrow.parquet", dataset, info) == true);
+  REQUIRE(dataset.n_rows == 3);
+  REQUIRE(dataset.n_cols == 10);
+  REQUIRE(info.Type(0) == data::Datatype::numeric);
+  REQUIRE(info.Type(2) == data::Datatype::categorical);
+  REQUIRE(info.NumMappings(2) == 2);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(dataset(0, i) == Approx(0.5 * i));
+    REQUIRE(dataset(1, i) == Approx((double) i));
+    REQUIRE(info.UnmapString(dataset(2, i), 2) == (i % 3 == 0 ? "a" : "b"));
+  }
+
+  // Read two numeric columns, in another order, one row group at a time.
+  data::ArrowReader reader("test_arrow.parquet", { "y", "x" });
+  REQUIRE(reader.Dimensionality() == 2);
+  REQUIRE(reader.Points() == 10);
+  REQUIRE(reader.Blocks() == 3);
+
+  arma::mat block, blocks;
+  while (reader.Next(block, false))
+    blocks = arma::join_cols(blocks, block);
+  REQUIRE(blocks.n_rows == 10);
+  REQUIRE(blocks.n_cols == 2);
+  for (size_t i = 0; i < 10; ++i)
+  {
+    REQUIRE(blocks(i, 0) == Approx((double) i));
+    REQUIRE(blocks(i, 1) == Approx(0.5 * i));
+  }
+
+  remove("test_arrow.parquet");
+}
+#endif
@@ -204,3 +204,39 @@ TEMPLATE_TEST_CASE("LocalCoordinateCodingTrainReturnObjective",
 
   REQUIRE(std::isfinite(objVal) == true);
 }
+
+/**
+ * Make sure that encoding all points at once (in parallel) gives the same codes
+ * as encoding each point by itself.
+ */
+TEMPLATE_TEST_CASE("LocalCoordinateCodingParallelEncodeTest",
+    "[LocalCoordinateCodingTest]", arma::mat, arma::fmat)
+{
+  using MatType = TestType;
+
+  const double tol = std::is_same_v<typename MatType::elem_type, float> ?
+      1e-4 : 1e-8;
+  const size_t nAtoms = 15;
+
+  arma::mat inX; // The .arm file contains an arma::mat.
+  inX.load("mnist_first250_training_4s_and_9s.csv");
+  MatType X = arma::conv_to<MatType>::from(inX);
+
+  // Normalize each point since these are images.
+  for (uword i = 0; i < X.n_cols; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  LocalCoordinateCoding<MatType> lcc(X, nAtoms, 0.1, 2);
+
+  MatType Z;
+  lcc.Encode(X, Z);
+  REQUIRE(Z.n_rows == nAtoms);
+  REQUIRE(Z.n_cols == X.n_cols);
+
+  for (uword i = 0; i < X.n_cols; i += 7)
+  {
+    MatType z;
+    lcc.Encode(MatType(X.col(i)), z);
+    REQUIRE(arma::approx_equal(z, Z.col(i), "absdiff", tol));
+  }
+}
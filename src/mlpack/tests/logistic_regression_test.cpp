@@ -430,6 +430,41 @@ TEST_CASE("LogisticRegressionFunctionRegularizationGradient",
   }
 }
 
+/**
+ * Make sure that the objective and gradient on a dataset of many blocks (which
+ * are computed in parallel) match the sums over the individual points.
+ */
+TEST_CASE("LogisticRegressionFunctionBlockedEvaluateWithGradient",
+          "[LogisticRegressionTest]")
+{
+  const size_t points = 5000;
+  arma::mat data(10, points, arma::fill::randu);
+  arma::Row<size_t> responses(points);
+  for (size_t i = 0; i < points; ++i)
+    responses[i] = RandInt(0, 2);
+
+  LogisticRegressionFunction<> lrf(data, responses, 0.5);
+  arma::rowvec parameters(11, arma::fill::randn);
+
+  arma::rowvec gradient, pointGradient;
+  const double objective = lrf.EvaluateWithGradient(parameters, gradient);
+
+  // The regularization of the separable objective is also split over the
+  // points.
+  double pointObjectives = 0.0;
+  arma::rowvec pointGradients(11, arma::fill::zeros);
+  for (size_t i = 0; i < points; ++i)
+  {
+    pointObjectives += lrf.Evaluate(parameters, i, 1);
+    lrf.Gradient(parameters, i, pointGradient, 1);
+    pointGradients += pointGradient;
+  }
+
+  REQUIRE(objective == Approx(pointObjectives).epsilon(1e-7));
+  REQUIRE(lrf.Evaluate(parameters) == Approx(objective).epsilon(1e-10));
+  REQUIRE(arma::approx_equal(gradient, pointGradients, "reldiff", 1e-7));
+}
+
 /**
  * Test separable Gradient() function when regularization is used.
  */
@@ -836,6 +871,40 @@ TEST_CASE("LogisticRegressionSparseSGDTest", "[LogisticRegressionTest]")
         Approx(lrSparse.Parameters()[i]).epsilon(1e-5));
 }
 
+/**
+ * Make sure that a model trained on sparse data classifies sparse data the same
+ * way that the equivalent dense model classifies dense data.
+ */
+TEST_CASE("LogisticRegressionSparseClassifyTest", "[LogisticRegressionTest]")
+{
+  arma::sp_mat dataset;
+  dataset.sprandu(200, 1000, 0.05);
+  arma::mat denseDataset(dataset);
+
+  // The labels depend on a few of the features.
+  arma::Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (denseDataset(3, i) + denseDataset(17, i) > 0.0) ? 1 : 0;
+
+  LogisticRegression<> lr(denseDataset, labels, 0.001);
+  LogisticRegression<arma::sp_mat> lrSparse(dataset, labels, 0.001);
+
+  REQUIRE(arma::approx_equal(lr.Parameters(), lrSparse.Parameters(),
+      "absdiff", 1e-3));
+
+  arma::Row<size_t> predictions, sparsePredictions;
+  arma::mat probabilities, sparseProbabilities;
+  lr.Classify(denseDataset, predictions, probabilities);
+  lrSparse.Classify(dataset, sparsePredictions, sparseProbabilities);
+
+  REQUIRE(arma::accu(predictions != sparsePredictions) <= 5);
+  REQUIRE(arma::approx_equal(probabilities, sparseProbabilities, "absdiff",
+      1e-3));
+  REQUIRE(lrSparse.ComputeError(dataset, labels) ==
+      Approx(lr.ComputeError(denseDataset, labels)).epsilon(1e-3));
+  REQUIRE(lrSparse.ComputeAccuracy(dataset, labels) > 90.0);
+}
+
 /**
  * Test multi-point classification (Classify()).
  */
@@ -764,6 +764,82 @@ TEST_CASE("LSHTestEmptyConstructorTest", "[LSHTest]")
   REQUIRE(distances.n_rows == 3);
 }
 
+/**
+ * Test: with unlimited bucket sizes, every reference point is stored once in
+ * each table, and each reference point used as a query is hashed to the
+ * buckets that hold it, so that it is its own nearest neighbor.  The data is
+ * centered so that many first-level hash codes are negative.
+ */
+TEST_CASE("LSHCompactTableSelfQueryTest", "[LSHTest]")
+{
+  arma::mat dataset = arma::randn<arma::mat>(6, 1000);
+  const size_t numTables = 8;
+
+  LSHSearch<> lsh(dataset, 5, numTables, 1.0, 99901, 0);
+
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  REQUIRE(offsets[offsets.n_elem - 1] == numTables * dataset.n_cols);
+  arma::Col<size_t> found(dataset.n_cols, arma::fill::zeros);
+  const std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  REQUIRE(table.size() == offsets.n_elem - 1);
+  for (size_t i = 0; i < table.size(); ++i)
+  {
+    REQUIRE(table[i].n_elem == offsets[i + 1] - offsets[i]);
+    for (size_t j = 0; j < table[i].n_elem; ++j)
+      found[table[i][j]]++;
+  }
+  REQUIRE(arma::all(found == numTables));
+
+  // Search with and without multiprobe.
+  for (size_t T = 0; T < 3; ++T)
+  {
+    arma::Mat<size_t> neighbors;
+    arma::mat distances;
+    lsh.Search(dataset, 1, neighbors, distances, 0, T);
+
+    for (size_t i = 0; i < dataset.n_cols; ++i)
+    {
+      REQUIRE(neighbors(0, i) == i);
+      REQUIRE(distances(0, i) == Approx(0.0).margin(1e-10));
+    }
+  }
+}
+
+/**
+ * Test: points inserted into a trained model are found just like the points
+ * the model was trained on, and the existing points are still found.
+ */
+TEST_CASE("LSHInsertTest", "[LSHTest]")
+{
+  arma::mat dataset = arma::randn<arma::mat>(6, 1000);
+  const size_t numTables = 8;
+
+  LSHSearch<> untrained;
+  REQUIRE_THROWS_AS(untrained.Insert(dataset), std::invalid_argument);
+
+  LSHSearch<> lsh(dataset.cols(0, 599), 5, numTables, 1.0, 99901, 0);
+  lsh.Insert(dataset.cols(600, 799));
+  lsh.Insert(dataset.cols(800, 999));
+
+  REQUIRE(lsh.ReferenceSet().n_cols == dataset.n_cols);
+  CheckMatrices(lsh.ReferenceSet(), dataset);
+  const arma::Col<size_t>& offsets = lsh.BucketOffsets();
+  REQUIRE(offsets[offsets.n_elem - 1] == numTables * dataset.n_cols);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  lsh.Search(dataset, 1, neighbors, distances);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    REQUIRE(neighbors(0, i) == i);
+    REQUIRE(distances(0, i) == Approx(0.0).margin(1e-10));
+  }
+
+  // Points of the wrong dimensionality can't be inserted.
+  REQUIRE_THROWS_AS(lsh.Insert(arma::randu<arma::mat>(5, 10)),
+      std::invalid_argument);
+}
+
 // These two tests are only compiled if the user has specified OpenMP to be
 // used.
 #ifdef MLPACK_USE_OPENMP
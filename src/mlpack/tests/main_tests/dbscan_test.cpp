@@ -63,6 +63,22 @@ TEST_CASE_METHOD(DBSCANTestFixture, "DBSCANEpsilonTest",
   REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
 }
 
+/**
+ * Check that a negative block size is rejected.
+ */
+TEST_CASE_METHOD(DBSCANTestFixture, "DBSCANBlockSizeTest",
+                 "[DBSCANMainTest][BindingTests]")
+{
+  arma::mat inputData;
+  if (!data::Load("iris.csv", inputData))
+    FAIL("Unable to load dataset iris.csv!");
+
+  SetInputParam("input", inputData);
+  SetInputParam("block_size", (int) -1);
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
+
 /**
  * Check that minimum size of cluster is always non-negative.
  */
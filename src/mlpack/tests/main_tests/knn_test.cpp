@@ -448,6 +448,46 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNRandomBasisTest",
   REQUIRE(params.Get<KNNModel*>("output_model")->RandomBasis() == false);
 }
 
+/*
+ * Ensure that we get the same neighbors when single_precision is specified, and
+ * that the output model holds a single-precision reference set.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNSinglePrecisionTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::mat referenceData;
+  referenceData.randu(3, 1000); // 1000 points in 3 dimensions.
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 10);
+  SetInputParam("single_precision", true);
+
+  RUN_BINDING();
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  neighbors = std::move(params.Get<arma::Mat<size_t>>("neighbors"));
+  distances = std::move(params.Get<arma::mat>("distances"));
+  REQUIRE(params.Get<KNNModel*>("output_model")->SinglePrecision() == true);
+  REQUIRE(params.Get<KNNModel*>("output_model")->NumReferencePoints() ==
+      1000);
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("reference", std::move(referenceData));
+  SetInputParam("k", (int) 10);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<KNNModel*>("output_model")->SinglePrecision() == false);
+  CheckMatrices(neighbors, params.Get<arma::Mat<size_t>>("neighbors"));
+  const arma::mat& doubleDistances = params.Get<arma::mat>("distances");
+  REQUIRE(distances.n_elem == doubleDistances.n_elem);
+  for (size_t i = 0; i < distances.n_elem; ++i)
+    REQUIRE(distances[i] == Approx(doubleDistances[i]).epsilon(1e-5));
+}
+
 /*
  * Ensure that the program runs successfully when we pass true_neighbors
  * and/or true_distances and fails when those matrices have the wrong shape.
@@ -647,3 +687,66 @@ TEST_CASE_METHOD(KNNTestFixture, "KNNDifferentLeafSizes",
   REQUIRE(params.Get<KNNModel*>("output_model")->LeafSize() == (int) 10);
   delete output_model;
 }
+
+/**
+ * Ensure that sparse search gives the same results as tree search with the
+ * Euclidean distance, and that other metrics can only be used with it.
+ */
+TEST_CASE_METHOD(KNNTestFixture, "KNNSparseTest",
+                 "[KNNMainTest][BindingTests]")
+{
+  arma::sp_mat sparseReference;
+  sparseReference.sprandu(50, 200, 0.1);
+  arma::sp_mat sparseQuery;
+  sparseQuery.sprandu(50, 40, 0.1);
+  const arma::mat referenceData(sparseReference);
+  const arma::mat queryData(sparseQuery);
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("query", queryData);
+  SetInputParam("k", (int) 5);
+
+  RUN_BINDING();
+
+  const arma::Mat<size_t> neighbors =
+      params.Get<arma::Mat<size_t>>("neighbors");
+  const arma::mat distances = params.Get<arma::mat>("distances");
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("query", queryData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("sparse", true);
+
+  RUN_BINDING();
+
+  CheckMatrices(params.Get<arma::Mat<size_t>>("neighbors"), neighbors);
+  CheckMatrices(params.Get<arma::mat>("distances"), distances);
+
+  CleanMemory();
+  ResetSettings();
+
+  // The cosine distances are between 0 and 1 for nonnegative data.
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("sparse", true);
+  SetInputParam("metric", std::string("cosine"));
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("distances").n_cols == 200);
+  REQUIRE(params.Get<arma::mat>("distances").min() >= -1e-10);
+  REQUIRE(params.Get<arma::mat>("distances").max() <= 1.0 + 1e-10);
+
+  CleanMemory();
+  ResetSettings();
+
+  SetInputParam("reference", referenceData);
+  SetInputParam("k", (int) 5);
+  SetInputParam("sparse", true);
+  SetInputParam("metric", std::string("manhattan"));
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
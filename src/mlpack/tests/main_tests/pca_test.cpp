@@ -96,3 +96,21 @@ TEST_CASE_METHOD(PCATestFixture, "PCATooHighNewDimensionalityTest",
 
   REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
 }
+
+/**
+ * Make sure the incremental decomposition method can be used.
+ */
+TEST_CASE_METHOD(PCATestFixture, "PCAIncrementalDecompositionTest",
+                 "[PCAMainTest][BindingTests]")
+{
+  arma::mat x = arma::randu<arma::mat>(5, 200);
+
+  SetInputParam("input", std::move(x));
+  SetInputParam("new_dimensionality", (int) 2);
+  SetInputParam("decomposition_method", std::string("incremental"));
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<arma::mat>("output").n_rows == 2);
+  REQUIRE(params.Get<arma::mat>("output").n_cols == 200);
+}
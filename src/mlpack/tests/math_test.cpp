@@ -1003,3 +1003,249 @@ TEST_CASE("InplaceSparseShuffleWeightsTest", "[MathTest]")
     REQUIRE(weightCounts[i] == 1);
   }
 }
+
+/**
+ * Make sure ColumnCovariance() matches Armadillo's cov() on data with many
+ * blocks, for both normalizations.
+ */
+TEMPLATE_TEST_CASE("ColumnCovarianceTest", "[MathTest]", float, double)
+{
+  using MatType = arma::Mat<TestType>;
+
+  // Use a large offset, so that any loss of precision from not centering
+  // would show.
+  MatType data(7, 5000, arma::fill::randn);
+  data.each_col() += arma::linspace<arma::Col<TestType>>(100, 700, 7);
+
+  for (size_t normType = 0; normType < 2; ++normType)
+  {
+    const MatType cov = ColumnCovariance(data, normType);
+    const MatType armaCov = arma::cov(data.t(), normType);
+
+    REQUIRE(cov.n_rows == 7);
+    REQUIRE(cov.n_cols == 7);
+    for (size_t i = 0; i < cov.n_elem; ++i)
+      REQUIRE(cov[i] == Approx(armaCov[i]).epsilon(1e-3).margin(1e-3));
+  }
+
+  // A single column is treated as a row vector of observations.
+  const MatType column = data.col(0);
+  const MatType var = ColumnCovariance(column);
+  REQUIRE(var.n_elem == 1);
+  REQUIRE(var[0] == Approx(arma::var(column.col(0))).epsilon(1e-4));
+}
+
+/**
+ * Make sure a CovarianceAccumulator updated one block at a time, or merged
+ * from the statistics of several blocks, gives the same result as when it is
+ * updated with the whole dataset.
+ */
+TEST_CASE("CovarianceAccumulatorStreamingTest", "[MathTest]")
+{
+  arma::mat data(5, 4321, arma::fill::randn);
+  data.row(2) *= 10.0;
+  data.row(3) += 50.0;
+
+  CovarianceAccumulator<arma::mat> all, streamed, merged;
+  all.Update(data);
+
+  for (size_t start = 0; start < data.n_cols; start += 500)
+  {
+    const size_t end = std::min(start + 500, (size_t) data.n_cols);
+    streamed.Update(data.cols(start, end - 1));
+
+    CovarianceAccumulator<arma::mat> block;
+    block.Update(data.cols(start, end - 1));
+    merged.Merge(block);
+  }
+
+  REQUIRE(all.Count() == data.n_cols);
+  REQUIRE(streamed.Count() == data.n_cols);
+  REQUIRE(merged.Count() == data.n_cols);
+  REQUIRE(all.Dimensionality() == 5);
+
+  const arma::vec mean = arma::mean(data, 1);
+  const arma::mat cov = arma::cov(data.t());
+  for (size_t i = 0; i < 5; ++i)
+  {
+    REQUIRE(all.Mean()[i] == Approx(mean[i]).epsilon(1e-10).margin(1e-10));
+    REQUIRE(streamed.Mean()[i] ==
+        Approx(mean[i]).epsilon(1e-10).margin(1e-10));
+    REQUIRE(merged.Mean()[i] == Approx(mean[i]).epsilon(1e-10).margin(1e-10));
+  }
+
+  const arma::mat allCov = all.Covariance();
+  const arma::mat streamedCov = streamed.Covariance();
+  const arma::mat mergedCov = merged.Covariance(0);
+  for (size_t i = 0; i < cov.n_elem; ++i)
+  {
+    REQUIRE(allCov[i] == Approx(cov[i]).epsilon(1e-10).margin(1e-10));
+    REQUIRE(streamedCov[i] == Approx(cov[i]).epsilon(1e-10).margin(1e-10));
+    REQUIRE(mergedCov[i] == Approx(cov[i]).epsilon(1e-10).margin(1e-10));
+  }
+
+  // A block of the wrong dimensionality must be rejected.
+  REQUIRE_THROWS_AS(streamed.Update(arma::mat(4, 10, arma::fill::randu)),
+      std::invalid_argument);
+
+  all.Reset();
+  REQUIRE(all.Count() == 0);
+  REQUIRE(all.Covariance().n_elem == 0);
+}
+
+/**
+ * Make sure a MomentsAccumulator updated one block at a time, or merged from
+ * the statistics of several blocks, gives the moments of the whole dataset.
+ */
+TEST_CASE("MomentsAccumulatorStreamingTest", "[MathTest]")
+{
+  arma::mat data(4, 5321, arma::fill::randn);
+  data.row(1) = arma::exp(data.row(1));
+  data.row(2) *= 10.0;
+  data.row(3) += 50.0;
+
+  MomentsAccumulator<arma::mat> all, streamed, merged;
+  all.Update(data);
+
+  for (size_t start = 0; start < data.n_cols; start += 700)
+  {
+    const size_t end = std::min(start + 700, (size_t) data.n_cols);
+    streamed.Update(data.cols(start, end - 1));
+
+    MomentsAccumulator<arma::mat> block;
+    block.Update(data.cols(start, end - 1));
+    merged.Merge(block);
+  }
+
+  REQUIRE(all.Count() == data.n_cols);
+  REQUIRE(streamed.Count() == data.n_cols);
+  REQUIRE(merged.Count() == data.n_cols);
+  REQUIRE(all.Dimensionality() == 4);
+
+  const double n = data.n_cols;
+  for (const MomentsAccumulator<arma::mat>* acc : { &all, &streamed, &merged })
+  {
+    for (size_t normType = 0; normType < 2; ++normType)
+    {
+      const arma::vec variance = acc->Variance(normType);
+      const arma::vec skewness = acc->Skewness(normType);
+      const arma::vec kurtosis = acc->Kurtosis(normType);
+      for (size_t i = 0; i < data.n_rows; ++i)
+      {
+        const arma::rowvec d = data.row(i) - arma::mean(data.row(i));
+        const double m2 = arma::accu(arma::pow(d, 2));
+        const double m3 = arma::accu(arma::pow(d, 3));
+        const double m4 = arma::accu(arma::pow(d, 4));
+        const double var = arma::var(data.row(i), normType);
+        const double s = std::sqrt(var);
+
+        const double skew = (normType == 1) ? m3 / (n * s * s * s) :
+            n * m3 / ((n - 1) * (n - 2) * s * s * s);
+        const double kurt = (normType == 1) ? n * m4 / (m2 * m2) - 3 :
+            (n * (n + 1)) / ((n - 1) * (n - 2) * (n - 3)) * m4 / (var * var) -
+            (3 * (n - 1) * (n - 1)) / ((n - 2) * (n - 3));
+
+        REQUIRE(acc->Mean()[i] ==
+            Approx(arma::mean(data.row(i))).epsilon(1e-10).margin(1e-10));
+        REQUIRE(variance[i] == Approx(var).epsilon(1e-10));
+        REQUIRE(skewness[i] == Approx(skew).epsilon(1e-8).margin(1e-10));
+        REQUIRE(kurtosis[i] == Approx(kurt).epsilon(1e-8).margin(1e-10));
+        REQUIRE(acc->Min()[i] == data.row(i).min());
+        REQUIRE(acc->Max()[i] == data.row(i).max());
+      }
+    }
+  }
+
+  // A block of the wrong dimensionality must be rejected.
+  REQUIRE_THROWS_AS(streamed.Update(arma::mat(3, 10, arma::fill::randu)),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(all.Variance(2), std::invalid_argument);
+
+  all.Reset();
+  REQUIRE(all.Count() == 0);
+  REQUIRE(all.Variance().n_elem == 0);
+}
+
+/**
+ * Make sure that the quantiles of a KLLSketch are exact for few values, and
+ * close in rank for many values, also when sketches are merged.
+ */
+TEST_CASE("KLLSketchQuantileTest", "[MathTest]")
+{
+  KLLSketch<> small;
+  for (size_t i = 100; i > 0; --i)
+    small.Insert(double(i));
+  REQUIRE(small.Count() == 100);
+  REQUIRE(small.Quantile(0.0) == 1.0);
+  REQUIRE(small.Quantile(0.5) == 50.0);
+  REQUIRE(small.Quantile(1.0) == 100.0);
+  REQUIRE_THROWS_AS(small.Quantile(1.5), std::invalid_argument);
+
+  arma::rowvec values(200000, arma::fill::randn);
+  KLLSketch<> all, first, second(200, 1);
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    all.Insert(values[i]);
+    if (i % 2 == 0)
+      first.Insert(values[i]);
+    else
+      second.Insert(values[i]);
+  }
+  first.Merge(second);
+
+  REQUIRE(all.Count() == values.n_elem);
+  REQUIRE(first.Count() == values.n_elem);
+  // The memory of the sketch does not grow with the number of values.
+  REQUIRE(all.Size() < 4 * all.K());
+  REQUIRE(first.Size() < 4 * first.K());
+
+  const arma::rowvec sorted = arma::sort(values);
+  for (const double q : { 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99 })
+  {
+    for (const KLLSketch<>* sketch : { &all, &first })
+    {
+      const double estimate = sketch->Quantile(q);
+      const double rank = std::lower_bound(sorted.begin(), sorted.end(),
+          estimate) - sorted.begin();
+      REQUIRE(std::abs(rank / values.n_elem - q) < 0.03);
+    }
+  }
+
+  // NaNs are not counted.
+  small.Insert(std::nan(""));
+  REQUIRE(small.Count() == 100);
+}
+
+/**
+ * Make sure that the intrinsic dimension of points on a low-dimensional
+ * subspace is estimated correctly.
+ */
+TEST_CASE("EstimateIntrinsicDimensionTest", "[MathTest]")
+{
+  // Points on a 2-dimensional plane and a 5-dimensional subspace of a
+  // 20-dimensional space.
+  const arma::mat plane = arma::randn<arma::mat>(20, 2) *
+      arma::randu<arma::mat>(2, 3000);
+  const arma::mat subspace = arma::randn<arma::mat>(20, 5) *
+      arma::randu<arma::mat>(5, 3000);
+  const arma::mat full(3, 3000, arma::fill::randu);
+
+  const double planeDim = EstimateIntrinsicDimension(plane);
+  const double subspaceDim = EstimateIntrinsicDimension(subspace, 2000);
+  const double fullDim = EstimateIntrinsicDimension(full);
+
+  REQUIRE(planeDim == Approx(2.0).epsilon(0.25));
+  REQUIRE(subspaceDim == Approx(5.0).epsilon(0.25));
+  REQUIRE(fullDim == Approx(3.0).epsilon(0.25));
+
+  // Single precision works too.
+  const arma::fmat floatPlane = arma::conv_to<arma::fmat>::from(plane);
+  REQUIRE(EstimateIntrinsicDimension(floatPlane) ==
+      Approx(2.0).epsilon(0.25));
+
+  // With too few (distinct) points, the dimensionality is returned.
+  REQUIRE(EstimateIntrinsicDimension(arma::mat(7, 2, arma::fill::randu)) ==
+      7.0);
+  REQUIRE(EstimateIntrinsicDimension(arma::mat(4, 100, arma::fill::zeros)) ==
+      4.0);
+}
@@ -59,3 +59,73 @@ TEST_CASE("UniformMatrixCompletionSDP", "[MatrixCompletionTest]")
        Approx(Xorig(indices(0, i), indices(1, i))).epsilon(1e-7));
   }
 }
+
+/**
+ * SoftImpute should recover a low-rank matrix from half of its entries, given
+ * as a sparse matrix.
+ */
+TEST_CASE("SoftImputeSparseRecoveryTest", "[MatrixCompletionTest]")
+{
+  const arma::mat x = arma::randn<arma::mat>(100, 3) *
+      arma::randn<arma::mat>(3, 80);
+
+  // Observe about half of the entries.
+  arma::sp_mat observations(x.n_rows, x.n_cols);
+  for (size_t j = 0; j < x.n_cols; ++j)
+    for (size_t i = 0; i < x.n_rows; ++i)
+      if (arma::randu() < 0.5)
+        observations(i, j) = x(i, j);
+
+  arma::mat u, v;
+  arma::vec s;
+  SoftImpute si(0.001, 10, 500, 1e-8);
+  si.Recover(observations, u, s, v);
+
+  REQUIRE(u.n_rows == x.n_rows);
+  REQUIRE(v.n_rows == x.n_cols);
+  REQUIRE(s.n_elem <= 10);
+  REQUIRE(u.n_cols == s.n_elem);
+  REQUIRE(v.n_cols == s.n_elem);
+
+  const arma::mat recovered = u * arma::diagmat(s) * v.t();
+  const double err = arma::norm(x - recovered, "fro") / arma::norm(x, "fro");
+  REQUIRE(err < 0.05);
+}
+
+/**
+ * SoftImpute should fit the observed entries given by indices and values,
+ * including observed entries that are zero.
+ */
+TEST_CASE("SoftImputeIndicesRecoveryTest", "[MatrixCompletionTest]")
+{
+  arma::mat x = arma::randn<arma::mat>(60, 2) * arma::randn<arma::mat>(2, 50);
+  x.row(0).zeros();
+
+  // Observe every row but one in each column, so that the zero row is known.
+  arma::umat indices(2, x.n_cols * (x.n_rows - 1));
+  arma::vec values(indices.n_cols);
+  size_t p = 0;
+  for (size_t j = 0; j < x.n_cols; ++j)
+  {
+    for (size_t i = 0; i < x.n_rows; ++i)
+    {
+      if (i == (j % (x.n_rows - 1)) + 1)
+        continue;
+      indices(0, p) = i;
+      indices(1, p) = j;
+      values(p++) = x(i, j);
+    }
+  }
+
+  arma::mat recovered;
+  SoftImpute si(0.001, 5, 500, 1e-8);
+  si.Recover(x.n_rows, x.n_cols, indices, values, recovered);
+
+  REQUIRE(recovered.n_rows == x.n_rows);
+  REQUIRE(recovered.n_cols == x.n_cols);
+  REQUIRE(si.Iterations() > 0);
+
+  const double err = arma::norm(x - recovered, "fro") / arma::norm(x, "fro");
+  REQUIRE(err < 0.05);
+  REQUIRE(arma::norm(recovered.row(0), 2) < 0.05 * arma::norm(x, "fro"));
+}
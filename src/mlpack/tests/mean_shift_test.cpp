@@ -106,6 +106,41 @@ TEMPLATE_TEST_CASE("MeanShiftSimpleCentroidsOnlyTest", "[MeanShiftTest]", float,
   REQUIRE(centroids.n_cols == 3);
 }
 
+// Make sure that merging seeds during clustering finds the same clusters, with
+// and without seeds.
+TEMPLATE_TEST_CASE("MeanShiftEarlyMergeTest", "[MeanShiftTest]", float, double)
+{
+  using ElemType = TestType;
+  using MatType = arma::Mat<ElemType>;
+
+  const MatType data = GetMeanShiftData<MatType>();
+
+  for (size_t useSeeds = 0; useSeeds < 2; ++useSeeds)
+  {
+    MeanShift<> meanShift;
+    arma::Row<size_t> assignments, mergedAssignments;
+    MatType centroids, mergedCentroids;
+    meanShift.Cluster(data, assignments, centroids, false, (bool) useSeeds);
+
+    meanShift.EarlyMerge() = true;
+    meanShift.Cluster(data, mergedAssignments, mergedCentroids, false,
+        (bool) useSeeds);
+
+    REQUIRE(mergedCentroids.n_cols == 3);
+    REQUIRE(mergedCentroids.n_cols == centroids.n_cols);
+
+    // The clusters must be the same, up to their order.
+    for (size_t i = 0; i < data.n_cols; ++i)
+    {
+      for (size_t j = 0; j < data.n_cols; ++j)
+      {
+        REQUIRE((assignments[i] == assignments[j]) ==
+            (mergedAssignments[i] == mergedAssignments[j]));
+      }
+    }
+  }
+}
+
 // Generate samples from four Gaussians, and make sure mean shift nearly
 // recovers those four centers.
 TEMPLATE_TEST_CASE("GaussianClustering", "[MeanShiftTest]", float, double)
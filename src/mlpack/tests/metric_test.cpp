@@ -219,6 +219,147 @@ TEST_CASE("NMSMetricTest", "[MetricTest]")
   CheckMatrices(desiredBoundingBox, selectedBoundingBox);
 }
 
+/**
+ * Greedy NMS reference, comparing each box against all selected boxes.  The
+ * boxes are in {x0, y0, x1, y1} format.
+ */
+static arma::uvec ReferenceNMS(const arma::mat& bbox,
+                               const arma::vec& scores,
+                               const double threshold)
+{
+  const arma::uvec order = arma::sort_index(scores, "descend");
+  std::vector<size_t> selected;
+  for (size_t i = 0; i < order.n_elem; ++i)
+  {
+    const size_t a = order[i];
+    bool suppressed = false;
+    for (const size_t b : selected)
+    {
+      const double w = std::max(std::min(bbox(2, a), bbox(2, b)) -
+          std::max(bbox(0, a), bbox(0, b)), 0.0);
+      const double h = std::max(std::min(bbox(3, a), bbox(3, b)) -
+          std::max(bbox(1, a), bbox(1, b)), 0.0);
+      const double areaA = (bbox(2, a) - bbox(0, a)) *
+          (bbox(3, a) - bbox(1, a));
+      const double areaB = (bbox(2, b) - bbox(0, b)) *
+          (bbox(3, b) - bbox(1, b));
+      if (w * h / (areaA - w * h + areaB) > threshold)
+      {
+        suppressed = true;
+        break;
+      }
+    }
+
+    if (!suppressed)
+      selected.push_back(a);
+  }
+
+  return arma::conv_to<arma::uvec>::from(selected);
+}
+
+// Generate random boxes in {x0, y0, x1, y1} format.
+static arma::mat RandomBoxes(const size_t n)
+{
+  arma::mat bbox(4, n);
+  bbox.rows(0, 1) = 1000.0 * arma::randu<arma::mat>(2, n);
+  bbox.rows(2, 3) = bbox.rows(0, 1) + 10.0 + 50.0 *
+      arma::randu<arma::mat>(2, n);
+  return bbox;
+}
+
+/**
+ * Make sure the grid-based NMS used for many boxes gives the same result as
+ * greedy NMS over all pairs.
+ */
+TEST_CASE("NMSGridTest", "[MetricTest]")
+{
+  const arma::mat bbox = RandomBoxes(2000);
+  arma::vec scores(2000, arma::fill::randu);
+
+  for (const double threshold : { 0.0, 0.1, 0.5, 0.9 })
+  {
+    arma::uvec selectedIndices;
+    NMS<true>::Evaluate(bbox, scores, selectedIndices, threshold);
+
+    const arma::uvec desiredIndices = ReferenceNMS(bbox, scores, threshold);
+    REQUIRE(selectedIndices.n_elem == desiredIndices.n_elem);
+    for (size_t i = 0; i < desiredIndices.n_elem; ++i)
+      REQUIRE(selectedIndices[i] == desiredIndices[i]);
+  }
+
+  // The {x0, y0, h, w} representation must give the same result.
+  arma::mat hwBox = bbox;
+  hwBox.rows(2, 3) -= hwBox.rows(0, 1);
+  arma::uvec selectedIndices, hwSelectedIndices;
+  NMS<true>::Evaluate(bbox, scores, selectedIndices, 0.3);
+  NMS<false>::Evaluate(hwBox, scores, hwSelectedIndices, 0.3);
+  REQUIRE(selectedIndices.n_elem == hwSelectedIndices.n_elem);
+  for (size_t i = 0; i < selectedIndices.n_elem; ++i)
+    REQUIRE(selectedIndices[i] == hwSelectedIndices[i]);
+}
+
+/**
+ * Make sure per-class NMS is the same as running NMS on each class, and that
+ * batched NMS is the same as running NMS on each image.
+ */
+TEST_CASE("NMSPerClassAndBatchTest", "[MetricTest]")
+{
+  const size_t numImages = 6;
+  std::vector<arma::mat> bboxes;
+  std::vector<arma::vec> scores;
+  std::vector<arma::Row<size_t>> labels;
+  for (size_t i = 0; i < numImages; ++i)
+  {
+    bboxes.push_back(RandomBoxes(300 + 100 * i));
+    scores.push_back(arma::randu<arma::vec>(bboxes.back().n_cols));
+    labels.push_back(arma::randi<arma::Row<size_t>>(bboxes.back().n_cols,
+        arma::distr_param(0, 4)));
+  }
+
+  std::vector<arma::uvec> selected, classSelected;
+  NMS<true>::EvaluateBatch(bboxes, scores, selected, 0.4);
+  NMS<true>::EvaluateBatch(bboxes, scores, labels, classSelected, 0.4);
+  REQUIRE(selected.size() == numImages);
+  REQUIRE(classSelected.size() == numImages);
+
+  for (size_t i = 0; i < numImages; ++i)
+  {
+    arma::uvec imageSelected;
+    NMS<true>::Evaluate(bboxes[i], scores[i], imageSelected, 0.4);
+    REQUIRE(selected[i].n_elem == imageSelected.n_elem);
+    for (size_t j = 0; j < imageSelected.n_elem; ++j)
+      REQUIRE(selected[i][j] == imageSelected[j]);
+
+    arma::uvec imageClassSelected;
+    NMS<true>::EvaluatePerClass(bboxes[i], scores[i], labels[i],
+        imageClassSelected, 0.4);
+    REQUIRE(classSelected[i].n_elem == imageClassSelected.n_elem);
+    for (size_t j = 0; j < imageClassSelected.n_elem; ++j)
+      REQUIRE(classSelected[i][j] == imageClassSelected[j]);
+
+    // Compute the reference by running NMS on each class separately; the
+    // result must be sorted by score.
+    std::vector<size_t> desired;
+    for (size_t c = 0; c < 5; ++c)
+    {
+      const arma::uvec members = arma::find(labels[i] == c);
+      if (members.n_elem == 0)
+        continue;
+
+      const arma::uvec kept = ReferenceNMS(bboxes[i].cols(members),
+          scores[i].elem(members), 0.4);
+      for (size_t j = 0; j < kept.n_elem; ++j)
+        desired.push_back(members[kept[j]]);
+    }
+    std::sort(desired.begin(), desired.end(), [&](size_t a, size_t b)
+        { return scores[i][a] > scores[i][b]; });
+
+    REQUIRE(imageClassSelected.n_elem == desired.size());
+    for (size_t j = 0; j < desired.size(); ++j)
+      REQUIRE(imageClassSelected[j] == desired[j]);
+  }
+}
+
 /**
  *
  */
@@ -276,3 +417,73 @@ TEST_CASE("BLEUScoreTest", "[MetricTest]")
         Approx(expectedPrecision[i]).epsilon(1e-4));
   }
 }
+
+/**
+ * Make sure the BLEU score of a large corpus is the same with string, string
+ * view and integer tokens.
+ */
+TEST_CASE("BLEUTokenTypesTest", "[MetricTest]")
+{
+  const std::vector<std::string> vocabulary = { "the", "a", "cat", "dog",
+      "sat", "on", "mat", "ran", "and", "big" };
+
+  // Generate random sentences of integer token ids.
+  using IdVector = std::vector<size_t>;
+  std::vector<std::vector<IdVector>> idReferences(3000);
+  std::vector<IdVector> idTranslations(3000);
+  for (size_t i = 0; i < idTranslations.size(); ++i)
+  {
+    idTranslations[i] = arma::conv_to<IdVector>::from(
+        arma::randi<arma::uvec>(RandInt(3, 15),
+        arma::distr_param(0, vocabulary.size() - 1)));
+    idReferences[i].resize(RandInt(1, 4));
+    for (IdVector& r : idReferences[i])
+    {
+      r = arma::conv_to<IdVector>::from(arma::randi<arma::uvec>(
+          RandInt(3, 15), arma::distr_param(0, vocabulary.size() - 1)));
+    }
+  }
+
+  // Convert the ids to strings and string views.
+  using WordVector = std::vector<std::string>;
+  using ViewVector = std::vector<std::string_view>;
+  std::vector<std::vector<WordVector>> references(idReferences.size());
+  std::vector<std::vector<ViewVector>> viewReferences(idReferences.size());
+  std::vector<WordVector> translations(idTranslations.size());
+  std::vector<ViewVector> viewTranslations(idTranslations.size());
+  for (size_t i = 0; i < idTranslations.size(); ++i)
+  {
+    for (const size_t id : idTranslations[i])
+    {
+      translations[i].push_back(vocabulary[id]);
+      viewTranslations[i].push_back(vocabulary[id]);
+    }
+
+    references[i].resize(idReferences[i].size());
+    viewReferences[i].resize(idReferences[i].size());
+    for (size_t j = 0; j < idReferences[i].size(); ++j)
+    {
+      for (const size_t id : idReferences[i][j])
+      {
+        references[i][j].push_back(vocabulary[id]);
+        viewReferences[i][j].push_back(vocabulary[id]);
+      }
+    }
+  }
+
+  BLEU<double> bleu(4), idBleu(4), viewBleu(4);
+  const double score = bleu.Evaluate(references, translations);
+  REQUIRE(score > 0.0);
+  REQUIRE(idBleu.Evaluate(idReferences, idTranslations) == score);
+  REQUIRE(viewBleu.Evaluate(viewReferences, viewTranslations) == score);
+
+  REQUIRE(idBleu.TranslationLength() == bleu.TranslationLength());
+  REQUIRE(idBleu.ReferenceLength() == bleu.ReferenceLength());
+  REQUIRE(viewBleu.TranslationLength() == bleu.TranslationLength());
+  REQUIRE(viewBleu.ReferenceLength() == bleu.ReferenceLength());
+  for (size_t i = 0; i < 4; ++i)
+  {
+    REQUIRE(idBleu.Precisions()[i] == bleu.Precisions()[i]);
+    REQUIRE(viewBleu.Precisions()[i] == bleu.Precisions()[i]);
+  }
+}
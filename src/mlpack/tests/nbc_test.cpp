@@ -498,3 +498,45 @@ TEMPLATE_TEST_CASE("NBCModelMatTypeTest", "[NBCTest]", float, double)
   REQUIRE(nbc.Variances().n_rows == data.n_rows);
   REQUIRE(nbc.Variances().n_cols == 4);
 }
+
+/**
+ * Make sure that incremental training on chunks of the data gives the same
+ * model as training on all of the data at once, and that batch classification
+ * matches single-point classification.
+ */
+TEST_CASE("NBCChunkedIncrementalTest", "[NBCTest]")
+{
+  arma::mat data = arma::randn<arma::mat>(5, 3000);
+  arma::Row<size_t> labels =
+      arma::randi<arma::Row<size_t>>(3000, DistrParam(0, 2));
+  for (size_t i = 0; i < data.n_cols; ++i)
+    data.col(i) = 3.0 * labels[i] + (1.0 + labels[i]) * data.col(i);
+
+  NaiveBayesClassifier<> nbc(data, labels, 3, false);
+  NaiveBayesClassifier<> nbcChunked(data.n_rows, 3);
+  for (size_t begin = 0; begin < data.n_cols; begin += 700)
+  {
+    const size_t end = std::min(begin + 700, (size_t) data.n_cols) - 1;
+    nbcChunked.Train(data.cols(begin, end), labels.subvec(begin, end), 3);
+  }
+
+  REQUIRE(nbcChunked.TrainingPoints() == data.n_cols);
+  REQUIRE(approx_equal(nbc.Probabilities(), nbcChunked.Probabilities(),
+      "reldiff", 1e-8));
+  REQUIRE(approx_equal(nbc.Means(), nbcChunked.Means(), "reldiff", 1e-8));
+  REQUIRE(approx_equal(nbc.Variances(), nbcChunked.Variances(), "reldiff",
+      1e-8));
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  nbcChunked.Classify(data, predictions, probabilities);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    nbcChunked.Classify(data.col(i), prediction, pointProbabilities);
+    REQUIRE(predictions[i] == prediction);
+    REQUIRE(approx_equal(probabilities.col(i), pointProbabilities, "absdiff",
+        1e-10));
+  }
+}
@@ -352,3 +352,118 @@ TEMPLATE_TEST_CASE("NCALBFGSSimpleDataset", "[NCATest]", float, double)
   // norm is close to 0.
   REQUIRE(arma::norm(finalGradient, 2) < 1e-5);
 }
+
+/**
+ * With as many neighbors as there are other points, the truncated softmax
+ * error function should be the same as the full one.
+ */
+TEMPLATE_TEST_CASE("SoftmaxTruncatedAllNeighbors", "[NCATest]", float, double)
+{
+  using eT = TestType;
+
+  arma::Mat<eT> data(3, 40, arma::fill::randu);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(40,
+      arma::distr_param(0, 2));
+  arma::Mat<eT> coordinates = arma::eye<arma::Mat<eT>>(3, 3) +
+      0.2 * arma::randu<arma::Mat<eT>>(3, 3);
+
+  SoftmaxErrorFunction<arma::Mat<eT>, arma::Row<size_t>,
+      SquaredEuclideanDistance> full(data, labels);
+  SoftmaxErrorFunction<arma::Mat<eT>, arma::Row<size_t>,
+      SquaredEuclideanDistance> truncated(data, labels,
+      SquaredEuclideanDistance(), 39);
+
+  const eT tol = std::is_same_v<eT, float> ? 1e-4 : 1e-10;
+  REQUIRE(truncated.Evaluate(coordinates) ==
+      Approx(full.Evaluate(coordinates)).epsilon(tol));
+  REQUIRE(truncated.NeighborLists().n_rows == 39);
+  REQUIRE(truncated.NeighborLists().n_cols == 40);
+
+  arma::Mat<eT> fullGradient, truncatedGradient;
+  full.Gradient(coordinates, fullGradient);
+  truncated.Gradient(coordinates, truncatedGradient);
+  REQUIRE(arma::approx_equal(fullGradient, truncatedGradient, "both", tol,
+      tol));
+
+  // Check the separable versions too.
+  for (size_t i = 0; i < 40; i += 8)
+  {
+    REQUIRE(truncated.Evaluate(coordinates, i, 8) ==
+        Approx(full.Evaluate(coordinates, i, 8)).epsilon(tol));
+
+    full.Gradient(coordinates, i, fullGradient, 8);
+    truncated.Gradient(coordinates, i, truncatedGradient, 8);
+    REQUIRE(arma::approx_equal(fullGradient, truncatedGradient, "both", tol,
+        tol));
+  }
+}
+
+/**
+ * Check the gradient of the truncated softmax error function against finite
+ * differences of its objective, while the neighbor lists are fixed.
+ */
+TEST_CASE("SoftmaxTruncatedGradientFiniteDifferences", "[NCATest]")
+{
+  arma::mat data(3, 100, arma::fill::randu);
+  arma::Row<size_t> labels = arma::randi<arma::Row<size_t>>(100,
+      arma::distr_param(0, 1));
+  arma::mat coordinates = arma::eye<arma::mat>(3, 3) +
+      0.1 * arma::randu<arma::mat>(3, 3);
+
+  // Use a large refresh interval, so that the neighbors do not change.
+  SoftmaxErrorFunction<> sef(data, labels, SquaredEuclideanDistance(), 10,
+      1000);
+
+  arma::mat gradient;
+  sef.Gradient(coordinates, gradient);
+  const arma::umat neighborLists = sef.NeighborLists();
+  REQUIRE(neighborLists.n_rows == 10);
+
+  const double h = 1e-6;
+  for (size_t i = 0; i < coordinates.n_elem; ++i)
+  {
+    arma::mat plus = coordinates, minus = coordinates;
+    plus[i] += h;
+    minus[i] -= h;
+    const double estimate = (sef.Evaluate(plus) - sef.Evaluate(minus)) /
+        (2 * h);
+    REQUIRE(gradient[i] == Approx(estimate).epsilon(1e-4).margin(1e-6));
+  }
+
+  REQUIRE(arma::all(arma::vectorise(sef.NeighborLists() == neighborLists)));
+}
+
+/**
+ * Make sure that NCA can be trained with the truncated objective.
+ */
+TEST_CASE("NCALBFGSTruncated", "[NCATest]")
+{
+  // Two classes that are separated along the first dimension only.
+  arma::mat data = arma::randu<arma::mat>(2, 200);
+  data.row(0) *= 0.1;
+  data.row(1) *= 10.0;
+  arma::Row<size_t> labels(200);
+  for (size_t i = 0; i < 200; ++i)
+  {
+    labels[i] = (i < 100) ? 0 : 1;
+    if (i >= 100)
+      data(0, i) += 0.2;
+  }
+
+  L_BFGS lbfgs;
+  lbfgs.NumBasis() = 5;
+  lbfgs.MaxIterations() = 50;
+
+  arma::mat outputMatrix;
+  NCA nca(SquaredEuclideanDistance(), 15, 2);
+  REQUIRE(nca.Neighbors() == 15);
+  REQUIRE(nca.RefreshInterval() == 2);
+  nca.LearnDistance(data, labels, outputMatrix, lbfgs);
+
+  // The full objective should be better now.
+  SoftmaxErrorFunction<> sef(data, labels);
+  const double initObj = sef.Evaluate(arma::eye<arma::mat>(2, 2));
+  const double finalObj = sef.Evaluate(outputMatrix);
+  REQUIRE(finalObj < initObj);
+  REQUIRE(finalObj < -180.0);
+}
@@ -174,6 +174,42 @@ TEST_CASE("SparseNMFAcolDistTest", "[NMFTest]")
       Approx(0.0).margin(1e-5));
 }
 
+/**
+ * Check that the sparse divergence update rules, which only compute the ratios
+ * of V and W * H at the nonzero elements of V, give the same factorization as
+ * the dense update rules.
+ */
+TEST_CASE("SparseNMFDivTest", "[NMFTest]")
+{
+  sp_mat v;
+  v.sprandu(30, 25, 0.3);
+  // Ensure there is at least one nonzero element in every row and column.
+  for (size_t i = 0; i < 25; ++i)
+    v(i, i) += 0.01;
+  mat dv(v); // Make a dense copy.
+  const size_t r = 5;
+
+  // Get an initialization.
+  arma::mat iw, ih;
+  RandomAcolInitialization<>::Initialize(v, r, iw, ih);
+  GivenInitialization<> g(std::move(iw), std::move(ih));
+
+  // The GivenInitialization will force the same initialization for both
+  // Apply() calls.
+  MaxIterationTermination mit(100);
+  AMF<MaxIterationTermination, GivenInitialization<>,
+      NMFMultiplicativeDivergenceUpdate> nmf(mit, g);
+  mat w, h, dw, dh;
+  nmf.Apply(v, r, w, h);
+  nmf.Apply(dv, r, dw, dh);
+
+  // Make sure the results are about equal for the W and H matrices.
+  const mat vp = w * h;
+  const mat dvp = dw * dh;
+  REQUIRE(arma::norm(vp - dvp, "fro") / arma::norm(vp, "fro") ==
+      Approx(0.0).margin(1e-5));
+}
+
 /**
  * Check that the product of the calculated factorization is close to the
  * input matrix, with a sparse input matrix.  This uses the random
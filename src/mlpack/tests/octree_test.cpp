@@ -318,6 +318,32 @@ TEST_CASE("OcTreeTestMoveConstructorTest", "[OctreeTest]")
   CheckSameNode(tcopy, t2);
 }
 
+/**
+ * Make sure that trees whose nodes are held in node pools can be assigned to
+ * each other.  The trees are large enough that the pools need several blocks.
+ */
+TEST_CASE("OctreePooledAssignmentTest", "[OctreeTest]")
+{
+  arma::mat dataset(3, 5000, arma::fill::randu);
+  arma::mat dataset2(3, 3000, arma::fill::randu);
+
+  Octree<> t(dataset, 5);
+  Octree<> tcopy(t);
+  Octree<> t2(dataset2, 5);
+  Octree<> t3(dataset2, 5);
+
+  // Copy assignment must free the old pooled nodes.
+  t2 = t;
+  CheckSameNode(tcopy, t2);
+
+  // Move assignment must free the old pooled nodes, and take the new ones.
+  t3 = std::move(t);
+  CheckSameNode(tcopy, t3);
+  REQUIRE(t.NumChildren() == 0);
+  for (size_t i = 0; i < t3.NumChildren(); ++i)
+    REQUIRE(t3.Child(i).Parent() == &t3);
+}
+
 /**
  * Test serialization.
  */
@@ -341,3 +367,86 @@ TEST_CASE("OctreeSerializationTest", "[OctreeTest]")
   delete binaryTree;
   delete jsonTree;
 }
+
+/**
+ * Check the structure of an octree built from Morton codes: the points of each
+ * node are contiguous and in Z-order, no node has a single child, the leaves
+ * respect maxLeafSize, and the bounds of siblings do not overlap.
+ */
+template<typename TreeType>
+static void CheckMortonNode(TreeType& node, const size_t maxLeafSize)
+{
+  if (node.IsLeaf())
+  {
+    REQUIRE(node.NumPoints() <= maxLeafSize);
+    return;
+  }
+
+  REQUIRE(node.NumChildren() >= 2);
+  size_t next = node.Descendant(0);
+  for (size_t i = 0; i < node.NumChildren(); ++i)
+  {
+    REQUIRE(node.Child(i).Descendant(0) == next);
+    next += node.Child(i).NumDescendants();
+    CheckMortonNode(node.Child(i), maxLeafSize);
+  }
+
+  REQUIRE(next == node.Descendant(0) + node.NumDescendants());
+}
+
+TEST_CASE("MortonOctreeTest", "[OctreeTest]")
+{
+  // Use enough points that subtrees are built in parallel.
+  arma::mat dataset(3, 20000, arma::fill::randu);
+  arma::mat datacopy(dataset);
+  std::vector<size_t> oldFromNewCopy, oldFromNewMove;
+
+  Octree<> t1(dataset, oldFromNewCopy, MORTON_OCTREE_BUILD, 15);
+  Octree<> t2(std::move(dataset), oldFromNewMove, MORTON_OCTREE_BUILD, 15);
+
+  REQUIRE(t1.NumDescendants() == 20000);
+  REQUIRE(oldFromNewCopy == oldFromNewMove);
+  REQUIRE(arma::approx_equal(t1.Dataset(), datacopy.cols(
+      arma::conv_to<arma::uvec>::from(oldFromNewCopy)), "absdiff", 0.0));
+
+  CheckMortonNode(t1, 15);
+  CheckOverlap(t1);
+  CheckFurthestDistances(t1);
+  CheckSameNode(t1, t2);
+
+  // Every point must be inside the bound of the leaf that holds it.
+  std::stack<Octree<>*> nodes;
+  nodes.push(&t1);
+  while (!nodes.empty())
+  {
+    Octree<>* node = nodes.top();
+    nodes.pop();
+    for (size_t i = 0; i < node->NumPoints(); ++i)
+      REQUIRE(node->Bound().Contains(node->Dataset().col(node->Point(i))));
+    for (size_t i = 0; i < node->NumChildren(); ++i)
+      nodes.push(&node->Child(i));
+  }
+
+  // Duplicated points cannot be split, so they end up in one leaf.
+  arma::mat duplicates(2, 50);
+  duplicates.cols(0, 29).fill(1.0);
+  duplicates.cols(30, 49).randu();
+  Octree<> t3(duplicates, MORTON_OCTREE_BUILD, 5);
+  REQUIRE(t3.NumDescendants() == 50);
+
+  // Higher-dimensional data gets fewer bits per dimension, and too many
+  // dimensions are rejected.
+  arma::mat wide(8, 1000, arma::fill::randu);
+  Octree<> t4(wide, MORTON_OCTREE_BUILD, 10);
+  CheckNumChildren(t4);
+  CheckOverlap(t4);
+
+  arma::mat tooWide(65, 10, arma::fill::randu);
+  REQUIRE_THROWS_AS(Octree<>(tooWide, MORTON_OCTREE_BUILD),
+      std::invalid_argument);
+
+  // An empty dataset gives an empty leaf.
+  Octree<> t5(arma::mat(3, 0), MORTON_OCTREE_BUILD);
+  REQUIRE(t5.NumChildren() == 0);
+  REQUIRE(t5.NumDescendants() == 0);
+}
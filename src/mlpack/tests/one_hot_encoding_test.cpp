@@ -229,3 +229,44 @@ TEST_CASE("OneHotEncodingDatasetinfoTest", "[OneHotEncodingTest]")
 
   remove("test.csv");
 }
+
+/**
+ * Make sure that the sparse one-hot encoding is the same as the dense one, for
+ * dimensions with many categories and numeric dimensions with zeros.
+ */
+TEST_CASE("OneHotEncodingSparseOutputTest", "[OneHotEncodingTest]")
+{
+  arma::mat input(4, 3000);
+  input.row(0) = arma::randi<arma::rowvec>(3000, arma::distr_param(0, 999));
+  input.row(1) = arma::randi<arma::rowvec>(3000, arma::distr_param(-2, 2));
+  input.row(2) = arma::randi<arma::rowvec>(3000, arma::distr_param(0, 49));
+  input.row(3) = arma::randn<arma::rowvec>(3000);
+
+  const arma::Col<size_t> indices("0 2");
+  arma::mat dense;
+  arma::sp_mat sparse;
+  data::OneHotEncoding(input, indices, dense);
+  data::OneHotEncoding(input, indices, sparse);
+
+  REQUIRE(sparse.n_rows == dense.n_rows);
+  REQUIRE(sparse.n_cols == 3000);
+  // One nonzero for each encoded dimension, and for each nonzero value of the
+  // other dimensions.
+  REQUIRE(sparse.n_nonzero == 6000 + arma::accu(input.row(1) != 0) +
+      arma::accu(input.row(3) != 0));
+  CheckMatrices(dense, arma::mat(sparse));
+
+  // The same with a DatasetInfo, where only the last dimension is numeric.
+  DatasetInfo info(4);
+  info.Type(0) = Datatype::categorical;
+  info.Type(1) = Datatype::categorical;
+  info.Type(2) = Datatype::categorical;
+  data::OneHotEncoding(input, dense, info);
+  data::OneHotEncoding(input, sparse, info);
+  REQUIRE(sparse.n_nonzero == 9000 + arma::accu(input.row(3) != 0));
+  CheckMatrices(dense, arma::mat(sparse));
+
+  const arma::Col<size_t> badIndices("4");
+  REQUIRE_THROWS_AS(data::OneHotEncoding(input, badIndices, sparse),
+      std::invalid_argument);
+}
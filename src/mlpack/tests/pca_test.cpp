@@ -198,6 +198,24 @@ TEST_CASE("ArmaComparisonRandomizedPCATest", "[PCATest]")
   ArmaComparisonPCA<RandomizedSVDPCAPolicy>();
 }
 
+/**
+ * Compare the output of our incremental PCA implementation with Armadillo's.
+ */
+TEST_CASE("ArmaComparisonIncrementalPCATest", "[PCATest]")
+{
+  IncrementalSVDPolicy decomposition(73);
+  ArmaComparisonPCA<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Compare the output of our covariance eigendecomposition PCA implementation
+ * with Armadillo's.
+ */
+TEST_CASE("ArmaComparisonCovarianceEigPCATest", "[PCATest]")
+{
+  ArmaComparisonPCA<CovarianceEigPolicy>();
+}
+
 /**
  * Test that dimensionality reduction with exact-svd PCA works the same way
  * MATLAB does (which should be correct!).
@@ -227,6 +245,25 @@ TEST_CASE("RandomizedPCADimensionalityReductionTest", "[PCATest]")
   PCADimensionalityReduction<RandomizedSVDPCAPolicy>();
 }
 
+/**
+ * Test that dimensionality reduction with incremental PCA works the same way
+ * MATLAB does, when the points are split over several blocks.
+ */
+TEST_CASE("IncrementalPCADimensionalityReductionTest", "[PCATest]")
+{
+  IncrementalSVDPolicy decomposition(2);
+  PCADimensionalityReduction<IncrementalSVDPolicy>(false, decomposition);
+}
+
+/**
+ * Test that dimensionality reduction with covariance eigendecomposition PCA
+ * works the same way MATLAB does.
+ */
+TEST_CASE("CovarianceEigPCADimensionalityReductionTest", "[PCATest]")
+{
+  PCADimensionalityReduction<CovarianceEigPolicy>();
+}
+
 /**
  * Test that dimensionality reduction with QUIC-SVD PCA works the same way
  * as the Exact-SVD PCA method.
@@ -335,7 +372,8 @@ TEST_CASE("PCAScalingTest", "[PCATest]")
  * Test PCA on a subview of a matrix with different decomposition strategies.
  */
 TEMPLATE_TEST_CASE("PCASubviewTest", "[PCATest]", ExactSVDPolicy,
-    RandomizedSVDPCAPolicy, RandomizedBlockKrylovSVDPolicy, QUICSVDPolicy)
+    RandomizedSVDPCAPolicy, RandomizedBlockKrylovSVDPolicy, QUICSVDPolicy,
+    IncrementalSVDPolicy, CovarianceEigPolicy)
 {
   using DecompositionPolicy = TestType;
 
@@ -382,7 +420,8 @@ TEMPLATE_TEST_CASE("PCASubviewTest", "[PCATest]", ExactSVDPolicy,
  * Test PCA on an input expression.
  */
 TEMPLATE_TEST_CASE("PCAExpressionTest", "[PCATest]", ExactSVDPolicy,
-    RandomizedSVDPCAPolicy, RandomizedBlockKrylovSVDPolicy, QUICSVDPolicy)
+    RandomizedSVDPCAPolicy, RandomizedBlockKrylovSVDPolicy, QUICSVDPolicy,
+    IncrementalSVDPolicy, CovarianceEigPolicy)
 {
   using DecompositionPolicy = TestType;
 
@@ -429,7 +468,8 @@ TEMPLATE_TEST_CASE("PCAExpressionTest", "[PCATest]", ExactSVDPolicy,
  * Test PCA on 32-bit data.
  */
 TEMPLATE_TEST_CASE("PCAFloatTest", "[PCATest]", ExactSVDPolicy,
-    RandomizedSVDPCAPolicy, RandomizedBlockKrylovSVDPolicy, QUICSVDPolicy)
+    RandomizedSVDPCAPolicy, RandomizedBlockKrylovSVDPolicy, QUICSVDPolicy,
+    IncrementalSVDPolicy, CovarianceEigPolicy)
 {
   using DecompositionPolicy = TestType;
 
@@ -507,3 +547,99 @@ TEMPLATE_TEST_CASE("PCASparseToDenseTest", "[PCATest]", float, double)
 
   REQUIRE(denseData2.n_rows == transformedDataset2.n_rows);
 }
+
+/**
+ * Make sure that streaming blocks of different sizes into the incremental SVD
+ * policy gives the same decomposition as the exact SVD on the whole dataset.
+ */
+TEST_CASE("IncrementalPCAStreamingTest", "[PCATest]")
+{
+  arma::mat data = arma::randn<arma::mat>(6, 1500);
+  data.row(0) *= 5.0;
+  data.row(1) += 0.5 * data.row(0);
+  data.row(3) *= 0.1;
+  data.each_col() += arma::vec("3.0 -1.0 0.0 10.0 2.0 -4.0");
+
+  arma::mat exactTransformed, exactEigvec;
+  arma::vec exactEigval;
+  PCA<ExactSVDPolicy> exact;
+  exact.Apply(data, exactTransformed, exactEigval, exactEigvec);
+
+  IncrementalSVDPolicy ipca(250);
+  ipca.Update(data.cols(0, 9));
+  ipca.Update(data.cols(10, 700));
+  ipca.Update(data.cols(701, 1499));
+
+  REQUIRE(ipca.Count() == 1500);
+  REQUIRE(arma::approx_equal(ipca.Mean(), arma::vec(arma::mean(data, 1)),
+      "absdiff", 1e-10));
+  REQUIRE(ipca.TotalVariance() ==
+      Approx(arma::accu(exactEigval)).epsilon(1e-8));
+
+  const arma::vec eigval = ipca.EigenValues();
+  REQUIRE(eigval.n_elem == exactEigval.n_elem);
+  for (size_t i = 0; i < eigval.n_elem; ++i)
+  {
+    REQUIRE(eigval[i] == Approx(exactEigval[i]).epsilon(1e-8));
+
+    // The components may differ in sign.
+    REQUIRE(std::abs(arma::dot(ipca.Components().col(i),
+        exactEigvec.col(i))) == Approx(1.0).epsilon(1e-6));
+  }
+
+  // Projecting the data should give the same result (up to sign).
+  arma::mat transformed;
+  ipca.Transform(data, transformed);
+  REQUIRE(arma::approx_equal(arma::abs(transformed),
+      arma::abs(exactTransformed), "absdiff", 1e-6));
+
+  // Points of the wrong dimensionality cannot be added.
+  REQUIRE_THROWS_AS(ipca.Update(arma::mat(5, 10, arma::fill::randu)),
+      std::invalid_argument);
+
+  // After a reset, the policy can be used with other data.
+  ipca.Reset();
+  REQUIRE(ipca.Count() == 0);
+  ipca.Update(arma::mat(5, 10, arma::fill::randu));
+  REQUIRE(ipca.Components().n_rows == 5);
+}
+
+/**
+ * Make sure that keeping only a few components of the incremental SVD policy
+ * still finds the dominant subspace of low-rank data.
+ */
+TEST_CASE("IncrementalPCALowRankTest", "[PCATest]")
+{
+  // 20-dimensional data that lies (up to a little noise) in a 3-dimensional
+  // subspace.
+  arma::mat basis, r;
+  arma::qr_econ(basis, r, arma::randn<arma::mat>(20, 3));
+  arma::mat data = basis * (arma::diagmat(arma::vec("10.0 5.0 2.0")) *
+      arma::randn<arma::mat>(3, 3000)) +
+      0.01 * arma::randn<arma::mat>(20, 3000);
+
+  IncrementalSVDPolicy ipca(200, 3);
+  ipca.Update(data);
+
+  REQUIRE(ipca.Components().n_cols == 3);
+  REQUIRE(ipca.SingularValues().n_elem == 3);
+
+  // The components should span the same subspace as the basis.
+  const arma::mat overlap = basis.t() * ipca.Components();
+  const arma::vec s = arma::svd(overlap);
+  for (size_t i = 0; i < s.n_elem; ++i)
+    REQUIRE(s[i] == Approx(1.0).epsilon(1e-3));
+
+  // Almost all of the variance is along the kept components.
+  REQUIRE(arma::accu(ipca.EigenValues()) / ipca.TotalVariance() >
+      0.999);
+
+  // Use the policy through PCA for dimensionality reduction.
+  PCA<IncrementalSVDPolicy> p(false, IncrementalSVDPolicy(500));
+  arma::mat reduced;
+  const double varRetained = p.Apply(data, reduced, (size_t) 3);
+  REQUIRE(reduced.n_rows == 3);
+  REQUIRE(reduced.n_cols == 3000);
+  REQUIRE(varRetained > 0.999);
+  REQUIRE(p.Decomposition().Count() == 3000);
+}
@@ -363,3 +363,101 @@ TEST_CASE("TrainFormTest", "[PerceptronTest]")
   REQUIRE(all(predictions5 == trueLabels));
   REQUIRE(all(predictions6 == trueLabels));
 }
+
+/**
+ * Make sure that mini-batch training converges on linearly separable data, and
+ * that the batch Classify() gives the same predictions as the single-point
+ * Classify() on a dataset with several blocks.
+ */
+TEST_CASE("PerceptronBatchTrainingTest", "[PerceptronTest]")
+{
+  // Three well-separated Gaussian clusters.
+  mat trainData(4, 3000, fill::randn);
+  Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+  {
+    labels[i] = i % 3;
+    trainData(labels[i], i) += 20.0;
+  }
+
+  Perceptron<> p1(trainData, labels, 3, 100);
+  Perceptron<> p2;
+  p2.BatchSize() = 64;
+  p2.Train(trainData, labels, 3, 100);
+  REQUIRE(p2.BatchSize() == 64);
+
+  Row<size_t> predictions1, predictions2;
+  p1.Classify(trainData, predictions1);
+  p2.Classify(trainData, predictions2);
+
+  REQUIRE(all(predictions1 == labels));
+  REQUIRE(all(predictions2 == labels));
+
+  for (size_t i = 0; i < trainData.n_cols; ++i)
+    REQUIRE(p2.Classify(trainData.col(i)) == predictions2[i]);
+
+  // A batch size of 0 is invalid.
+  p2.BatchSize() = 0;
+  REQUIRE_THROWS_AS(p2.Train(trainData, labels, 3), std::invalid_argument);
+
+  // Sparse data gives the same model as dense data.
+  sp_mat sparseData(trainData);
+  Perceptron<SimpleWeightUpdate, ZeroInitialization, sp_mat> p3;
+  p3.BatchSize() = 64;
+  p3.Train(sparseData, labels, 3, 100);
+
+  Row<size_t> predictions3;
+  p3.Classify(sparseData, predictions3);
+  REQUIRE(approx_equal(p3.Weights(), p2.Weights(), "reldiff", 1e-10));
+  REQUIRE(all(predictions3 == labels));
+}
+
+/**
+ * Make sure that the lazily averaged perceptron gives the average of the
+ * weights after every point, computed naively.
+ */
+TEST_CASE("AveragedPerceptronTest", "[PerceptronTest]")
+{
+  mat trainData;
+  trainData = { { 1, 2, 3, 4, 5, 6, 7, 8, 1, 2, 3, 4, 5, 6, 7, 8 },
+                { 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 } };
+  Row<size_t> labels = { 0, 0, 0, 1, 0, 1, 1, 1, 0, 0, 0, 1, 0, 1, 1, 1 };
+  rowvec instanceWeights = linspace<rowvec>(0.5, 2.0, 16);
+
+  for (const size_t batchSize : { 1, 5 })
+  {
+    Perceptron<> p;
+    p.BatchSize() = batchSize;
+    p.Average() = true;
+    p.Train(trainData, labels, 2, instanceWeights, 7);
+
+    // Compute the average naively.
+    mat weights(2, 2, fill::zeros), weightSum(2, 2, fill::zeros);
+    vec biases(2, fill::zeros), biasSum(2, fill::zeros);
+    SimpleWeightUpdate update;
+    for (size_t it = 0; it < 7; ++it)
+    {
+      for (size_t first = 0; first < 16; first += batchSize)
+      {
+        const size_t last = std::min(first + batchSize, (size_t) 16) - 1;
+        mat scores = weights.t() * trainData.cols(first, last);
+        scores.each_col() += biases;
+        for (size_t j = first; j <= last; ++j)
+        {
+          const size_t predicted = scores.col(j - first).index_max();
+          if (predicted != labels[j])
+          {
+            update.UpdateWeights(trainData.col(j), weights, biases, predicted,
+                labels[j], instanceWeights[j]);
+          }
+          weightSum += weights;
+          biasSum += biases;
+        }
+      }
+    }
+
+    REQUIRE(approx_equal(p.Weights(), weightSum / (7 * 16), "absdiff",
+        1e-10));
+    REQUIRE(approx_equal(p.Biases(), biasSum / (7 * 16), "absdiff", 1e-10));
+  }
+}
@@ -395,3 +395,49 @@ TEST_CASE("SACForMultipleActions", "[PolicyGradientTest]")
   // If the agent is able to reach till this point of the test, it is assured
   // that the agent can handle multiple actions in continuous space.
 }
+
+//! Test DDPG stepping several Pendulum environments at once.
+TEST_CASE("PendulumWithVectorDDPG", "[PolicyGradientTest]")
+{
+  RandomReplay<Pendulum> replayMethod(32, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.001;
+  config.TargetNetworkSyncInterval() = 1;
+  config.UpdateInterval() = 1;
+  config.ExplorationSteps() = 40;
+
+  FFN<EmptyLoss, GaussianInitialization>
+      policyNetwork(EmptyLoss(), GaussianInitialization(0, 0.1));
+  policyNetwork.Add(new Linear(32));
+  policyNetwork.Add(new ReLU());
+  policyNetwork.Add(new Linear(1));
+  policyNetwork.Add(new TanH());
+
+  FFN<EmptyLoss, GaussianInitialization>
+      qNetwork(EmptyLoss(), GaussianInitialization(0, 0.1));
+  qNetwork.Add(new Linear(32));
+  qNetwork.Add(new ReLU());
+  qNetwork.Add(new Linear(1));
+
+  OUNoise ouNoise(1, 0.0, 1.0, 0.01);
+
+  DDPG<Pendulum, decltype(qNetwork), decltype(policyNetwork),
+      OUNoise, AdamUpdate>
+      agent(config, qNetwork, policyNetwork, ouNoise, replayMethod);
+
+  // Every episode of Pendulum(20) lasts 20 steps.
+  VectorEnvironment<Pendulum> environments(4, Pendulum(20));
+  environments.Reset();
+
+  size_t ended = 0;
+  for (size_t i = 0; i < 30; ++i)
+    ended += agent.Step(environments);
+
+  REQUIRE(agent.TotalSteps() == 120);
+  REQUIRE(replayMethod.Size() == 120);
+  REQUIRE(ended == 4);
+  REQUIRE(environments.EpisodeReturns().size() == 4);
+  for (const double episodeReturn : environments.EpisodeReturns())
+    REQUIRE(std::isfinite(episodeReturn));
+}
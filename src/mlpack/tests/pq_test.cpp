@@ -0,0 +1,314 @@
+/**
+ * @file tests/pq_test.cpp
+ *
+ * Tests for the ProductQuantizer and PQSearch classes.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/pq.hpp>
+#include <mlpack/methods/neighbor_search.hpp>
+
+#include "catch.hpp"
+#include "test_catch_tools.hpp"
+
+using namespace mlpack;
+
+/**
+ * Create a dataset of the given dimensionality with 20 Gaussian clusters.
+ */
+static arma::mat ClusteredData(const size_t dimensionality, const size_t n)
+{
+  const arma::mat centers = 10.0 * arma::randu<arma::mat>(dimensionality, 20);
+  arma::mat data = arma::randn<arma::mat>(dimensionality, n);
+  for (size_t i = 0; i < n; ++i)
+    data.col(i) += centers.col(i % 20);
+  return data;
+}
+
+/**
+ * Make sure that the codes are valid, that the subspaces cover all
+ * dimensions, and that more centroids give a lower quantization error.
+ */
+TEST_CASE("ProductQuantizerEncodeDecodeTest", "[PQTest]")
+{
+  // The dimensionality is not a multiple of the number of subspaces.
+  const arma::mat data = ClusteredData(10, 3000);
+
+  ProductQuantizer<> pq(3, 64);
+  pq.Train(data);
+
+  REQUIRE(pq.Dimensionality() == 10);
+  REQUIRE(pq.SubspaceOffsets().n_elem == 4);
+  REQUIRE(pq.SubspaceOffsets()[0] == 0);
+  REQUIRE(pq.SubspaceOffsets()[3] == 10);
+  for (size_t s = 0; s < 3; ++s)
+  {
+    REQUIRE(pq.Codebook(s).n_rows ==
+        pq.SubspaceOffsets()[s + 1] - pq.SubspaceOffsets()[s]);
+    REQUIRE(pq.Codebook(s).n_cols == 64);
+  }
+
+  arma::Mat<unsigned char> codes;
+  pq.Encode(data, codes);
+  REQUIRE(codes.n_rows == 3);
+  REQUIRE(codes.n_cols == data.n_cols);
+  REQUIRE(codes.max() < 64);
+
+  // Each subspace of each point must be encoded with its nearest centroid.
+  arma::mat decoded;
+  pq.Decode(codes, decoded);
+  for (size_t i = 0; i < 100; ++i)
+  {
+    for (size_t s = 0; s < 3; ++s)
+    {
+      const arma::vec sub = data.submat(pq.SubspaceOffsets()[s], i,
+          pq.SubspaceOffsets()[s + 1] - 1, i);
+      const arma::rowvec d = arma::sum(arma::square(
+          pq.Codebook(s).each_col() - sub), 0);
+      REQUIRE(d[codes(s, i)] == Approx(d.min()).margin(1e-10));
+    }
+  }
+
+  ProductQuantizer<> smallPQ(3, 4);
+  smallPQ.Train(data);
+  REQUIRE(pq.QuantizationError(data) < smallPQ.QuantizationError(data));
+}
+
+/**
+ * Make sure that asymmetric distances with a lookup table are the distances
+ * to the reconstructed points, with and without a rotation.
+ */
+TEST_CASE("ProductQuantizerLookupTableTest", "[PQTest]")
+{
+  const arma::mat data = ClusteredData(12, 2000);
+  const arma::mat queries = ClusteredData(12, 20);
+
+  for (const size_t opqIterations : { 0, 3 })
+  {
+    ProductQuantizer<> pq(4, 32, 10, opqIterations);
+    pq.Train(data);
+    REQUIRE(pq.Rotation().is_empty() == (opqIterations == 0));
+
+    arma::Mat<unsigned char> codes;
+    arma::mat decoded, table;
+    pq.Encode(data, codes);
+    pq.Decode(codes, decoded);
+    for (size_t q = 0; q < queries.n_cols; ++q)
+    {
+      pq.LookupTable(queries.col(q), table);
+      REQUIRE(table.n_rows == 32);
+      REQUIRE(table.n_cols == 4);
+      for (size_t i = 0; i < 50; ++i)
+      {
+        const double d = arma::accu(arma::square(queries.col(q) -
+            decoded.col(i)));
+        REQUIRE(pq.Distance(table, codes.colptr(i)) ==
+            Approx(d).epsilon(1e-8));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that the rotation learned by OPQ is orthogonal and lowers the
+ * quantization error of correlated data.
+ */
+TEST_CASE("ProductQuantizerOPQTest", "[PQTest]")
+{
+  // Most of the variance is in the first dimensions, mixed by a random
+  // rotation.
+  arma::mat q, r;
+  arma::qr(q, r, arma::randn<arma::mat>(16, 16));
+  arma::vec scales = arma::linspace<arma::vec>(4.0, 0.1, 16);
+  const arma::mat data = q * arma::diagmat(scales) *
+      arma::randn<arma::mat>(16, 4000);
+
+  ProductQuantizer<> pq(4, 16, 20);
+  pq.Train(data);
+  ProductQuantizer<> opq(4, 16, 20, 5);
+  opq.Train(data);
+
+  const arma::mat& rotation = opq.Rotation();
+  REQUIRE(rotation.n_rows == 16);
+  REQUIRE(rotation.n_cols == 16);
+  REQUIRE(arma::approx_equal(rotation.t() * rotation,
+      arma::eye<arma::mat>(16, 16), "absdiff", 1e-8));
+  REQUIRE(opq.QuantizationError(data) < pq.QuantizationError(data));
+}
+
+/**
+ * Make sure that PQSearch finds most of the true neighbors, and that
+ * re-ranking with the full-precision reference set improves the recall and
+ * gives exact distances.
+ */
+TEST_CASE("PQSearchRecallTest", "[PQTest]")
+{
+  const arma::mat referenceData = ClusteredData(32, 6000);
+  const arma::mat queryData = ClusteredData(32, 200);
+
+  KNN knn(referenceData);
+  arma::Mat<size_t> trueNeighbors;
+  arma::mat trueDistances;
+  knn.Search(queryData, 10, trueNeighbors, trueDistances);
+
+  PQSearch<> pq(referenceData, 16, 8);
+  REQUIRE(pq.Size() == referenceData.n_cols);
+  size_t total = 0;
+  for (size_t l = 0; l < pq.NumLists(); ++l)
+  {
+    total += pq.ListIndices(l).size();
+    REQUIRE(pq.ListCodes(l).size() == 8 * pq.ListIndices(l).size());
+  }
+  REQUIRE(total == referenceData.n_cols);
+
+  pq.NumProbes() = 4;
+  arma::Mat<size_t> neighbors, rerankedNeighbors;
+  arma::mat distances, rerankedDistances;
+  pq.Search(queryData, 10, neighbors, distances);
+  const double recall = KNN::Recall(neighbors, trueNeighbors);
+  REQUIRE(recall >= 0.4);
+
+  pq.RerankCandidates() = 100;
+  pq.Search(queryData, 10, rerankedNeighbors, rerankedDistances,
+      referenceData);
+  const double rerankedRecall = KNN::Recall(rerankedNeighbors, trueNeighbors);
+  REQUIRE(rerankedRecall >= 0.9);
+  REQUIRE(rerankedRecall >= recall);
+
+  for (size_t i = 0; i < queryData.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 10; ++j)
+    {
+      REQUIRE(rerankedDistances(j, i) == Approx(arma::norm(queryData.col(i) -
+          referenceData.col(rerankedNeighbors(j, i)))));
+      if (j > 0)
+      {
+        REQUIRE(distances(j, i) >= distances(j - 1, i));
+        REQUIRE(rerankedDistances(j, i) >= rerankedDistances(j - 1, i));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that re-ranking with a memory-mapped reference set gives the same
+ * results as with the reference set in memory.
+ */
+TEST_CASE("PQSearchMappedRerankTest", "[PQTest]")
+{
+  const arma::mat referenceData = ClusteredData(16, 3000);
+  const arma::mat queryData = ClusteredData(16, 50);
+
+  PQSearch<> pq(referenceData, 8, 4);
+  pq.NumProbes() = 2;
+
+  REQUIRE(data::SaveMapped("pq_reference.bin", referenceData));
+  arma::mat mapped;
+  std::shared_ptr<data::MappedFile> mapping;
+  REQUIRE(data::LoadMapped("pq_reference.bin", mapped, mapping));
+
+  arma::Mat<size_t> neighbors, mappedNeighbors;
+  arma::mat distances, mappedDistances;
+  pq.Search(queryData, 5, neighbors, distances, referenceData);
+  pq.Search(queryData, 5, mappedNeighbors, mappedDistances, mapped);
+  mapping.reset();
+  remove("pq_reference.bin");
+
+  CheckMatrices(neighbors, mappedNeighbors);
+  CheckMatrices(distances, mappedDistances);
+}
+
+/**
+ * Make sure that points added in several blocks get consecutive indices, and
+ * that each point is found as its own nearest neighbor with re-ranking.
+ */
+TEST_CASE("PQSearchAddTest", "[PQTest]")
+{
+  const arma::fmat referenceData = arma::conv_to<arma::fmat>::from(
+      ClusteredData(16, 4000));
+
+  PQSearch<arma::fmat> pq(8, 4, 64);
+  pq.Train(referenceData.cols(0, 999));
+  REQUIRE(pq.Size() == 0);
+  pq.Add(referenceData.cols(0, 2499));
+  pq.Add(referenceData.cols(2500, 3999));
+  REQUIRE(pq.Size() == 4000);
+
+  pq.NumProbes() = 8;
+  arma::Mat<size_t> neighbors;
+  arma::fmat distances;
+  const arma::fmat queries = referenceData.cols(3900, 3999);
+  pq.Search(queries, 1, neighbors, distances, referenceData);
+  for (size_t i = 0; i < queries.n_cols; ++i)
+  {
+    REQUIRE(neighbors(0, i) == 3900 + i);
+    REQUIRE(distances(0, i) == Approx(0.0).margin(1e-5));
+  }
+
+  REQUIRE_THROWS_AS(pq.Add(arma::fmat(15, 10, arma::fill::randu)),
+      std::invalid_argument);
+}
+
+/**
+ * Make sure that a saved and loaded index gives the same results.
+ */
+TEST_CASE("PQSearchSerializationTest", "[PQTest]")
+{
+  const arma::mat referenceData = ClusteredData(16, 2000);
+  const arma::mat queryData = ClusteredData(16, 50);
+
+  PQSearch<> pq(referenceData, 4, 4, 32, 2);
+  pq.NumProbes() = 2;
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  pq.Search(queryData, 5, neighbors, distances);
+
+  REQUIRE(data::Save("pq_model.bin", "pq_model", pq));
+  PQSearch<> loaded;
+  REQUIRE(data::Load("pq_model.bin", "pq_model", loaded));
+  remove("pq_model.bin");
+
+  REQUIRE(loaded.Size() == pq.Size());
+  REQUIRE(loaded.NumProbes() == 2);
+  arma::Mat<size_t> loadedNeighbors;
+  arma::mat loadedDistances;
+  loaded.Search(queryData, 5, loadedNeighbors, loadedDistances);
+  CheckMatrices(neighbors, loadedNeighbors);
+  CheckMatrices(distances, loadedDistances);
+}
+
+/**
+ * Make sure that invalid parameters and searches throw.
+ */
+TEST_CASE("PQSearchInvalidTest", "[PQTest]")
+{
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  const arma::mat data(8, 100, arma::fill::randu);
+
+  REQUIRE_THROWS_AS(ProductQuantizer<>(4, 257), std::invalid_argument);
+  REQUIRE_THROWS_AS(PQSearch<>(0), std::invalid_argument);
+
+  // Too few points for the centroids, and too few dimensions for the
+  // subspaces.
+  ProductQuantizer<> pq(4, 256);
+  REQUIRE_THROWS_AS(pq.Train(data), std::invalid_argument);
+  ProductQuantizer<> pq2(9, 16);
+  REQUIRE_THROWS_AS(pq2.Train(data), std::invalid_argument);
+
+  PQSearch<> untrained;
+  REQUIRE_THROWS_AS(untrained.Search(data, 1, neighbors, distances),
+      std::invalid_argument);
+
+  PQSearch<> index(data, 2, 4, 16);
+  REQUIRE_THROWS_AS(index.Search(data, 101, neighbors, distances),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(index.Search(arma::mat(7, 5, arma::fill::randu), 1,
+      neighbors, distances), std::invalid_argument);
+  REQUIRE_THROWS_AS(index.Search(data, 1, neighbors, distances,
+      data.cols(0, 49)), std::invalid_argument);
+}
@@ -431,3 +431,112 @@ TEST_CASE("CartPoleWithCategoricalDQN", "[QLearningTest]")
   }
   REQUIRE(converged);
 }
+
+/**
+ * Store batches of transitions from several environments into the given
+ * replay, and make sure that a sample holds complete, recent transitions.
+ */
+template<typename ReplayType>
+void CheckBatchStore(ReplayType& replay)
+{
+  using ActionType = typename CartPole::Action;
+
+  // Transition i has encoded state i, reward i, and encoded next state
+  // i + 0.5.  There are 6 environments, and the memory holds 8 transitions.
+  for (size_t batch = 0; batch < 2; ++batch)
+  {
+    arma::mat states(4, 6), nextStates(4, 6);
+    std::vector<ActionType> actions(6);
+    arma::rowvec rewards(6);
+    arma::irowvec isEnd(6);
+    for (size_t i = 0; i < 6; ++i)
+    {
+      const size_t t = 6 * batch + i;
+      states.col(i).fill(t);
+      nextStates.col(i).fill(t + 0.5);
+      actions[i].action = (t % 2 == 0) ? ActionType::backward :
+          ActionType::forward;
+      rewards[i] = t;
+      isEnd[i] = (t % 3 == 0);
+    }
+
+    replay.Store(states, actions, rewards, nextStates, isEnd);
+  }
+
+  REQUIRE(replay.Size() == 8);
+
+  // The same matrices are used for two samples.
+  arma::mat sampledStates, sampledNextStates;
+  std::vector<ActionType> sampledActions;
+  arma::rowvec sampledRewards;
+  arma::irowvec isTerminal;
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    replay.Sample(sampledStates, sampledActions, sampledRewards,
+        sampledNextStates, isTerminal);
+
+    REQUIRE(sampledStates.n_cols == 5);
+    REQUIRE(sampledActions.size() == 5);
+    for (size_t i = 0; i < 5; ++i)
+    {
+      const size_t t = (size_t) sampledRewards[i];
+      // Only the last 8 transitions are left.
+      REQUIRE(t >= 4);
+      REQUIRE(t < 12);
+      REQUIRE(arma::all(sampledStates.col(i) == (double) t));
+      REQUIRE(arma::all(sampledNextStates.col(i) == (double) t + 0.5));
+      REQUIRE(sampledActions[i].action == ((t % 2 == 0) ?
+          ActionType::backward : ActionType::forward));
+      REQUIRE(isTerminal[i] == (t % 3 == 0));
+    }
+  }
+}
+
+//! Test storing batches of transitions in the replay memories.
+TEST_CASE("ReplayBatchStoreTest", "[QLearningTest]")
+{
+  RandomReplay<CartPole> randomReplay(5, 8);
+  CheckBatchStore(randomReplay);
+
+  PrioritizedReplay<CartPole> prioritizedReplay(5, 8, 0.6);
+  CheckBatchStore(prioritizedReplay);
+
+  // Batches can't be combined with n-step transitions.
+  RandomReplay<CartPole> nStepReplay(5, 8, 3);
+  arma::mat states(4, 1);
+  std::vector<CartPole::Action> actions(1);
+  arma::rowvec rewards(1);
+  arma::irowvec isEnd(1);
+  REQUIRE_THROWS_AS(nStepReplay.Store(states, actions, rewards, states,
+      isEnd), std::invalid_argument);
+}
+
+//! Test DQN stepping several Cart Pole environments at once.
+TEST_CASE("CartPoleWithVectorDQN", "[QLearningTest]")
+{
+  SimpleDQN<> network(32, 32, 2);
+  GreedyPolicy<CartPole> policy(1.0, 1000, 0.1, 0.99);
+  RandomReplay<CartPole> replayMethod(10, 10000);
+
+  TrainingConfig config;
+  config.StepSize() = 0.01;
+  config.ExplorationSteps() = 50;
+
+  QLearning<CartPole, decltype(network), AdamUpdate, decltype(policy)>
+      agent(config, network, policy, replayMethod);
+
+  // Each episode lasts at most 50 steps.
+  VectorEnvironment<CartPole> environments(8, CartPole(), 50);
+  environments.Reset();
+
+  size_t ended = 0;
+  for (size_t i = 0; i < 100; ++i)
+    ended += agent.Step(environments);
+
+  REQUIRE(agent.TotalSteps() == 800);
+  REQUIRE(replayMethod.Size() == 800);
+  REQUIRE(environments.EpisodeReturns().size() == ended);
+  REQUIRE(ended >= 16);
+  for (const double episodeReturn : environments.EpisodeReturns())
+    REQUIRE(episodeReturn <= 50.0);
+}
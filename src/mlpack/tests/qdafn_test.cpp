@@ -140,6 +140,36 @@ TEST_CASE("QDAFNMultipleNeighbors", "[QDAFNTest]")
   }
 }
 
+/**
+ * Make sure that the returned distances are the distances to the returned
+ * neighbors, and that no neighbor is returned twice.
+ */
+TEST_CASE("QDAFNNeighborDistancesTest", "[QDAFNTest]")
+{
+  arma::mat dataset = arma::randu<arma::mat>(10, 500);
+  arma::mat querySet = arma::randu<arma::mat>(10, 300);
+
+  QDAFN<> qdafn(dataset, 10, 30);
+
+  arma::Mat<size_t> neighbors;
+  arma::mat distances;
+  qdafn.Search(querySet, 5, neighbors, distances);
+
+  for (size_t i = 0; i < querySet.n_cols; ++i)
+  {
+    for (size_t j = 0; j < 5; ++j)
+    {
+      REQUIRE(neighbors(j, i) < dataset.n_cols);
+      const double dist = EuclideanDistance::Evaluate(querySet.col(i),
+          dataset.col(neighbors(j, i)));
+      REQUIRE(distances(j, i) == Approx(dist).epsilon(1e-7));
+
+      for (size_t k = 0; k < j; ++k)
+        REQUIRE(neighbors(k, i) != neighbors(j, i));
+    }
+  }
+}
+
 /**
  * Test re-training method.
  */
@@ -89,3 +89,53 @@ TEST_CASE("QUICSVDSameDimensionTest", "[QUICSVDTest]")
   arma::mat u, v, sigma;
   QUIC_SVD<> quicsvd(dataset, u, v, sigma);
 }
+
+/**
+ * Warm-starting from the basis of a decomposition of a slightly different
+ * matrix should give an accurate SVD without growing the basis.
+ */
+TEST_CASE("QUICSVDWarmStartTest", "[QUICSVDTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("test_data_3_1000.csv", dataset))
+    FAIL("Cannot load dataset test_data_3_1000.csv");
+
+  // As above, the Monte Carlo error calculation is random, so we require at
+  // least one success.
+  size_t successes = 0;
+  for (size_t i = 0; i < 3; ++i)
+  {
+    arma::mat u, v, sigma;
+    QUIC_SVD<> quicsvd;
+    quicsvd.Apply(dataset, u, v, sigma);
+
+    // Perturb the matrix slightly and warm-start from the previous basis.
+    arma::mat perturbed = dataset + 1e-3 * arma::randn<arma::mat>(
+        dataset.n_rows, dataset.n_cols);
+    quicsvd.Apply(perturbed, u, v, sigma, 0.03, 0.1, true);
+
+    const double relativeError = arma::norm(perturbed - u * sigma * v.t(),
+        "frob") / arma::norm(perturbed, "frob");
+    if (relativeError < 1e-5 && quicsvd.Basis().n_cols <= dataset.n_rows)
+      ++successes;
+  }
+
+  REQUIRE(successes > 0);
+}
+
+/**
+ * A warm start with a basis of the wrong size should fall back to a cold start.
+ */
+TEST_CASE("QUICSVDWarmStartMismatchTest", "[QUICSVDTest]")
+{
+  arma::mat dataset = arma::randn<arma::mat>(5, 200);
+
+  arma::mat u, v, sigma;
+  QUIC_SVD<> quicsvd;
+  quicsvd.Basis() = arma::randn<arma::mat>(7, 2);
+  quicsvd.Apply(dataset, u, v, sigma, 0.03, 0.1, true);
+
+  REQUIRE(quicsvd.Basis().n_rows == dataset.n_rows);
+  REQUIRE(u.n_rows == dataset.n_rows);
+  REQUIRE(v.n_rows == dataset.n_cols);
+}
@@ -60,3 +60,50 @@ TEMPLATE_TEST_CASE("Radical_Test_Radical3D", "[RadicalTest]", float, double)
   // Larger tolerance is sometimes needed.
   REQUIRE(valBest == Approx(valEst).epsilon(0.02));
 }
+
+/**
+ * Make sure the parallel Apply2D() chooses the same angle as a serial
+ * evaluation of every candidate angle on the same perturbed points.
+ */
+TEMPLATE_TEST_CASE("RadicalApply2DTest", "[RadicalTest]", float, double)
+{
+  using ElemType = TestType;
+  using VecType = arma::Col<ElemType>;
+  using MatType = arma::Mat<ElemType>;
+
+  // Two independent uniform sources, mixed by a rotation.
+  MatType s(500, 2, arma::fill::randu);
+  s = (s - 0.5) * std::sqrt(12.0);
+  const ElemType mix = 0.4;
+  MatType rotation = { { std::cos(mix), std::sin(mix) },
+                       { -std::sin(mix), std::cos(mix) } };
+  const MatType x = s * rotation;
+
+  Radical rad(0.175, 10, 60);
+  const size_t m = std::floor(std::sqrt((ElemType) x.n_rows));
+
+  MatType perturbed, candidate;
+  RandomSeed(42);
+  const ElemType theta = rad.Apply2D(x, m, perturbed, candidate);
+
+  // Reuse the auxiliary memory for a second call.
+  RandomSeed(42);
+  MatType perturbed2;
+  REQUIRE(rad.Apply2D(x, m, perturbed2, candidate) == theta);
+  REQUIRE(arma::approx_equal(perturbed, perturbed2, "absdiff", 0));
+
+  VecType values(rad.Angles());
+  for (size_t i = 0; i < rad.Angles(); ++i)
+  {
+    const ElemType t = (i / (ElemType) rad.Angles()) * M_PI / 2.0;
+    VecType y1 = std::cos(t) * perturbed.col(0) - std::sin(t) *
+        perturbed.col(1);
+    VecType y2 = std::sin(t) * perturbed.col(0) + std::cos(t) *
+        perturbed.col(1);
+    values[i] = rad.Vasicek(y1, m) + rad.Vasicek(y2, m);
+  }
+
+  const ElemType expected = (values.index_min() / (ElemType) rad.Angles()) *
+      M_PI / 2.0;
+  REQUIRE(theta == Approx(expected).margin(1e-6));
+}
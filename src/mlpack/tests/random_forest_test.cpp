@@ -795,3 +795,75 @@ TEST_CASE("RandomForestWithSequentialBootstrapTest", "[RandomForestTest]")
   for (size_t i = 0; i < predictions.n_elem; ++i)
     REQUIRE((predictions[i] == 0 || predictions[i] == 1));
 }
+
+/**
+ * Make sure that classifying with the flattened trees of a forest gives the
+ * same results as averaging the predictions of the trees themselves, for a
+ * forest with both numeric and categorical splits.
+ */
+TEST_CASE("FlatForestMatchesTreesTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 20, 1, 1e-7, 0,
+      MultipleRandomDimensionSelect(3));
+  REQUIRE(rf.Flat().NumTrees() == 20);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  rf.Classify(testData, predictions, probabilities);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    arma::vec expected(5, arma::fill::zeros);
+    for (size_t t = 0; t < rf.NumTrees(); ++t)
+    {
+      size_t treePrediction;
+      arma::vec treeProbabilities;
+      rf.Tree(t).Classify(testData.col(i), treePrediction, treeProbabilities);
+      expected += treeProbabilities;
+    }
+    expected /= rf.NumTrees();
+
+    REQUIRE(arma::approx_equal(probabilities.col(i), expected, "absdiff",
+        1e-12));
+    REQUIRE(predictions[i] == expected.index_max());
+
+    // The single-point overload must agree too.
+    REQUIRE(rf.Classify(testData.col(i)) == predictions[i]);
+  }
+}
+
+/**
+ * Make sure that a random forest can be trained on sparse data, and is about
+ * as accurate as the forest trained on the same data as a dense matrix.
+ */
+TEST_CASE("RandomForestSparseTest", "[RandomForestTest]")
+{
+  arma::sp_mat sparseData = arma::sprandu<arma::sp_mat>(30, 2000, 0.2);
+  const arma::mat data(sparseData);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    labels[i] = (data(2, i) > 0.3 || data(11, i) > 0.6) ? 1 : 0;
+
+  RandomForest<> denseForest(data, labels, 2, 10, 3);
+  RandomForest<> sparseForest(sparseData, labels, 2, 10, 3);
+
+  arma::Row<size_t> densePredictions, sparsePredictions;
+  denseForest.Classify(data, densePredictions);
+  sparseForest.Classify(sparseData, sparsePredictions);
+
+  const double denseAccuracy = arma::accu(densePredictions == labels) /
+      (double) labels.n_elem;
+  const double sparseAccuracy = arma::accu(sparsePredictions == labels) /
+      (double) labels.n_elem;
+  REQUIRE(sparseAccuracy > 0.95);
+  REQUIRE(sparseAccuracy == Approx(denseAccuracy).epsilon(0.03));
+}
@@ -91,3 +91,110 @@ TEST_CASE("WeightedRandomTest", "[RandomTest]")
     }
   }
 }
+
+// The Philox4x32-10 bijection should match the known-answer vectors of the
+// reference implementation (Random123).
+TEST_CASE("PhiloxKnownAnswerTest", "[RandomTest]")
+{
+  uint32_t out[4];
+
+  const uint32_t ctr1[4] = { 0, 0, 0, 0 };
+  const uint32_t key1[2] = { 0, 0 };
+  PhiloxRNG::Philox4x32(ctr1, key1, out);
+  REQUIRE(out[0] == 0x6627e8d5);
+  REQUIRE(out[1] == 0xe169c58d);
+  REQUIRE(out[2] == 0xbc57ac4c);
+  REQUIRE(out[3] == 0x9b00dbd8);
+
+  const uint32_t ctr2[4] = { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff };
+  const uint32_t key2[2] = { 0xffffffff, 0xffffffff };
+  PhiloxRNG::Philox4x32(ctr2, key2, out);
+  REQUIRE(out[0] == 0x408f276d);
+  REQUIRE(out[1] == 0x41c83b0e);
+  REQUIRE(out[2] == 0xa20bc7c6);
+  REQUIRE(out[3] == 0x6d5451fd);
+
+  const uint32_t ctr3[4] = { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 };
+  const uint32_t key3[2] = { 0xa4093822, 0x299f31d0 };
+  PhiloxRNG::Philox4x32(ctr3, key3, out);
+  REQUIRE(out[0] == 0xd16cfe09);
+  REQUIRE(out[1] == 0x94fdcceb);
+  REQUIRE(out[2] == 0x5001e420);
+  REQUIRE(out[3] == 0x24126ea1);
+}
+
+// A stream should only depend on its seed, its index and its position, and
+// different streams should differ.
+TEST_CASE("PhiloxStreamTest", "[RandomTest]")
+{
+  PhiloxRNG a(12, 3), b(12, 3), c(12, 4), d(13, 3);
+  size_t sameC = 0, sameD = 0;
+  for (size_t i = 0; i < 1000; ++i)
+  {
+    const uint32_t x = a();
+    REQUIRE(x == b());
+    sameC += (x == c()) ? 1 : 0;
+    sameD += (x == d()) ? 1 : 0;
+  }
+  REQUIRE(sameC < 5);
+  REQUIRE(sameD < 5);
+
+  // Jumping ahead gives the same integers as generating them.
+  PhiloxRNG e(12, 3);
+  e.Discard(250);
+  PhiloxRNG f(12, 3, 250);
+  REQUIRE(e.Counter() == a.Counter());
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const uint32_t x = a();
+    REQUIRE(x == e());
+    REQUIRE(x == f());
+  }
+
+  // RandStream() uses the seed set by RandomSeed().
+  RandomSeed(42);
+  PhiloxRNG g = RandStream(7);
+  PhiloxRNG h(42, 7);
+  REQUIRE(g.Seed() == 42);
+  for (size_t i = 0; i < 100; ++i)
+    REQUIRE(g() == h());
+}
+
+// Bulk fills should give the same values as serial draws from the stream, for
+// any number of threads, and should follow the right distributions.
+TEST_CASE("PhiloxFillTest", "[RandomTest]")
+{
+  arma::mat x(7, 1001);
+  PhiloxRNG rng(5, 1);
+  rng.FillUniform(x, -2.0, 3.0);
+
+  PhiloxRNG serial(5, 1);
+  for (size_t i = 0; i < x.n_elem; ++i)
+    REQUIRE(x[i] == -2.0 + 5.0 * serial.Uniform());
+  REQUIRE(x.min() >= -2.0);
+  REQUIRE(x.max() < 3.0);
+  REQUIRE(arma::mean(arma::vectorise(x)) == Approx(0.5).margin(0.1));
+  REQUIRE(rng.Counter() == (x.n_elem + 1) / 2);
+
+  arma::fmat y(50, 2000);
+  rng.FillNormal(y, 1.0, 2.0);
+  REQUIRE(arma::mean(arma::vectorise(y)) == Approx(1.0).margin(0.05));
+  REQUIRE(arma::stddev(arma::vectorise(y)) == Approx(2.0).margin(0.05));
+
+  // Filling the same stream again with an odd number of elements gives the
+  // same values.
+  arma::fmat z(49, 2001);
+  PhiloxRNG rng2(5, 1);
+  rng2.Discard((x.n_elem + 1) / 2);
+  rng2.FillNormal(z, 1.0, 2.0);
+  for (size_t i = 0; i < z.n_elem; ++i)
+    REQUIRE(z[i] == y[i]);
+
+  // The generator can be used with the distributions of <random>.
+  std::uniform_int_distribution<int> dist(0, 9);
+  std::vector<size_t> counts(10, 0);
+  for (size_t i = 0; i < 10000; ++i)
+    ++counts[dist(rng)];
+  for (size_t i = 0; i < 10; ++i)
+    REQUIRE(counts[i] > 800);
+}
@@ -59,3 +59,85 @@ TEST_CASE("RandomizedSVDReconstructionError", "[RandomizedSVDTest]")
       arma::norm(centeredData, "frob");
   REQUIRE(error == Approx(0.0).margin(1e-5));
 }
+
+/**
+ * The streaming randomized SVD should recover the singular values and the
+ * reconstruction of a low-rank matrix, with or without the block Krylov
+ * subspace and with a single pass.
+ */
+TEST_CASE("StreamingRandomizedSVDReconstructionError", "[RandomizedSVDTest]")
+{
+  arma::mat U = arma::randn<arma::mat>(50, 4);
+  arma::mat V = arma::randn<arma::mat>(1000, 4);
+
+  arma::mat R;
+  arma::qr_econ(U, R, U);
+  arma::qr_econ(V, R, V);
+
+  arma::vec s = { 10.0, 5.0, 1.0, 0.5 };
+  arma::mat data = U * arma::diagmat(s) * V.t();
+
+  // Use blocks that do not divide the number of columns.
+  MatrixColumnSource<> source(data, 300);
+
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    arma::mat U2, V2;
+    arma::vec s2;
+    StreamingRandomizedSVD svd(2, 10, (trial == 1));
+    if (trial < 2)
+      svd.Apply(source, U2, s2, V2, 4);
+    else
+      svd.ApplySinglePass(source, U2, s2, V2, 4);
+
+    REQUIRE(s2.n_elem == 4);
+    REQUIRE(U2.n_rows == 50);
+    REQUIRE(V2.n_rows == 1000);
+
+    // The singular value error should be small.
+    double error = arma::norm(s2 - s, "frob") / arma::norm(s, "frob");
+    REQUIRE(error == Approx(0.0).margin(1e-5));
+
+    // The relative reconstruction error should be small.
+    arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+    error = arma::norm(data - reconstruct, "frob") / arma::norm(data, "frob");
+    REQUIRE(error == Approx(0.0).margin(1e-5));
+  }
+}
+
+/**
+ * The centered streaming randomized SVD of a matrix read from a file should
+ * match the exact SVD of the centered matrix.
+ */
+TEST_CASE("StreamingRandomizedSVDFileSourceTest", "[RandomizedSVDTest]")
+{
+  arma::mat U = arma::randn<arma::mat>(20, 3);
+  arma::mat V = arma::randn<arma::mat>(500, 3);
+  arma::mat data = U * V.t();
+  data.each_col() += arma::randu<arma::vec>(20);
+  REQUIRE(data.save("streaming_svd_test.bin", arma::arma_binary));
+
+  arma::mat centeredData = data.each_col() - arma::mean(data, 1);
+  arma::mat U1, V1;
+  arma::vec s1;
+  arma::svd_econ(U1, s1, V1, centeredData);
+
+  BinaryFileColumnSource<> source("streaming_svd_test.bin", 64);
+  REQUIRE(source.Rows() == 20);
+  REQUIRE(source.Cols() == 500);
+
+  arma::mat U2, V2;
+  arma::vec s2;
+  StreamingRandomizedSVD svd(2, 10, false, true);
+  svd.Apply(source, U2, s2, V2, 3);
+
+  const double error = arma::norm(s2 - s1.subvec(0, 2), "frob") /
+      arma::norm(s2, "frob");
+  REQUIRE(error == Approx(0.0).margin(1e-5));
+
+  arma::mat reconstruct = U2 * arma::diagmat(s2) * V2.t();
+  REQUIRE(arma::norm(centeredData - reconstruct, "frob") /
+      arma::norm(centeredData, "frob") == Approx(0.0).margin(1e-5));
+
+  remove("streaming_svd_test.bin");
+}
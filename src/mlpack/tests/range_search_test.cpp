@@ -1349,6 +1349,131 @@ TEST_CASE("RSModelTest", "[RangeSearchTest]")
   }
 }
 
+/**
+ * Make sure that an RSModel saved with data::SaveMapped() and loaded with
+ * data::LoadMapped() gives the same results as the original model.
+ */
+TEST_CASE("RSModelMappedTest", "[RangeSearchTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(10, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(10, 500);
+  util::Timers timers;
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::TreeTypes::KD_TREE,
+      RSModel::TreeTypes::COVER_TREE, RSModel::TreeTypes::R_STAR_TREE };
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    RSModel model(treeTypes[i]);
+    arma::mat referenceCopy(referenceData);
+    model.BuildModel(timers, std::move(referenceCopy), 5, false, false);
+
+    REQUIRE(data::SaveMapped("rs_model_mapped.bin", "rs_model", model));
+
+    RSModel mappedModel;
+    REQUIRE(data::LoadMapped("rs_model_mapped.bin", "rs_model", mappedModel));
+    REQUIRE(mappedModel.Mapping());
+    CheckMatrices(mappedModel.Dataset(), model.Dataset());
+
+    vector<vector<size_t>> neighbors, mappedNeighbors;
+    vector<vector<double>> distances, mappedDistances;
+    arma::mat queryCopy(queryData);
+    arma::mat mappedQueryCopy(queryData);
+    model.Search(timers, std::move(queryCopy), Range(0.25, 0.75), neighbors,
+        distances);
+    mappedModel.Search(timers, std::move(mappedQueryCopy), Range(0.25, 0.75),
+        mappedNeighbors, mappedDistances);
+
+    vector<vector<pair<double, size_t>>> sorted, mappedSorted;
+    SortResults(neighbors, distances, sorted);
+    SortResults(mappedNeighbors, mappedDistances, mappedSorted);
+
+    REQUIRE(mappedSorted.size() == sorted.size());
+    for (size_t k = 0; k < sorted.size(); ++k)
+    {
+      REQUIRE(mappedSorted[k].size() == sorted[k].size());
+      for (size_t l = 0; l < sorted[k].size(); ++l)
+      {
+        REQUIRE(mappedSorted[k][l].second == sorted[k][l].second);
+        REQUIRE(mappedSorted[k][l].first ==
+            Approx(sorted[k][l].first).epsilon(1e-7));
+      }
+    }
+  }
+
+  remove("rs_model_mapped.bin");
+}
+
+/**
+ * Make sure that an RSModel that holds its reference set in single precision
+ * gives the same results as double-precision search, before and after
+ * serialization.  An open range is used, so that every pair of points is
+ * reported and rounding near the bounds of the range cannot matter.
+ */
+TEST_CASE("RSModelSinglePrecisionTest", "[RangeSearchTest]")
+{
+  arma::mat queryData = arma::randu<arma::mat>(5, 50);
+  arma::mat referenceData = arma::randu<arma::mat>(5, 200);
+  util::Timers timers;
+
+  RangeSearch<> rs(referenceData);
+  vector<vector<size_t>> baselineNeighbors;
+  vector<vector<double>> baselineDistances;
+  rs.Search(queryData, Range(0.0, DBL_MAX), baselineNeighbors,
+      baselineDistances);
+  vector<vector<pair<double, size_t>>> baselineSorted;
+  SortResults(baselineNeighbors, baselineDistances, baselineSorted);
+
+  const RSModel::TreeTypes treeTypes[] = { RSModel::TreeTypes::KD_TREE,
+      RSModel::TreeTypes::COVER_TREE, RSModel::TreeTypes::R_STAR_TREE };
+
+  for (size_t i = 0; i < 3; ++i)
+  {
+    RSModel model(treeTypes[i]);
+    model.SinglePrecision() = true;
+    arma::mat referenceCopy(referenceData);
+    model.BuildModel(timers, std::move(referenceCopy), 5, false, false);
+
+    REQUIRE(model.FloatDataset().n_cols == referenceData.n_cols);
+    REQUIRE(model.Dimensionality() == referenceData.n_rows);
+    REQUIRE_THROWS_AS(model.Dataset(), std::logic_error);
+
+    REQUIRE(data::Save("rs_float_model.bin", "rs_model", model));
+    RSModel loadedModel;
+    REQUIRE(data::Load("rs_float_model.bin", "rs_model", loadedModel));
+    REQUIRE(loadedModel.SinglePrecision());
+
+    vector<vector<size_t>> neighbors, loadedNeighbors;
+    vector<vector<double>> distances, loadedDistances;
+    arma::mat queryCopy(queryData);
+    arma::mat loadedQueryCopy(queryData);
+    model.Search(timers, std::move(queryCopy), Range(0.0, DBL_MAX), neighbors,
+        distances);
+    loadedModel.Search(timers, std::move(loadedQueryCopy),
+        Range(0.0, DBL_MAX), loadedNeighbors, loadedDistances);
+
+    vector<vector<pair<double, size_t>>> sorted, loadedSorted;
+    SortResults(neighbors, distances, sorted);
+    SortResults(loadedNeighbors, loadedDistances, loadedSorted);
+
+    REQUIRE(sorted.size() == baselineSorted.size());
+    REQUIRE(loadedSorted.size() == baselineSorted.size());
+    for (size_t k = 0; k < sorted.size(); ++k)
+    {
+      REQUIRE(sorted[k].size() == baselineSorted[k].size());
+      REQUIRE(loadedSorted[k].size() == baselineSorted[k].size());
+      for (size_t l = 0; l < sorted[k].size(); ++l)
+      {
+        REQUIRE(sorted[k][l].first ==
+            Approx(baselineSorted[k][l].first).epsilon(1e-5).margin(1e-6));
+        REQUIRE(loadedSorted[k][l].first == Approx(sorted[k][l].first));
+      }
+    }
+  }
+
+  remove("rs_float_model.bin");
+}
+
 TEST_CASE("RSModelMonochromaticTest", "[RangeSearchTest]")
 {
   // Ensure that we can build an RSModel and get correct results.
@@ -1675,6 +1800,64 @@ TEST_CASE("MoveConstructorNaiveTest", "[RangeSearchTest]")
 /**
  * Test move operator.
  */
+/**
+ * Make sure that RSModel::SelectTree() chooses a tree type and leaf size that
+ * give correct results, and that the choice is saved with the model.
+ */
+TEST_CASE("RSModelAutoSelectTest", "[RangeSearchTest]")
+{
+  util::Timers timers;
+  arma::mat queryData = arma::randu<arma::mat>(3, 100);
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  const Range range(0.05, 0.15);
+
+  RangeSearch<> naive(referenceData, true);
+  std::vector<std::vector<size_t>> baselineNeighbors;
+  std::vector<std::vector<double>> baselineDistances;
+  naive.Search(queryData, range, baselineNeighbors, baselineDistances);
+
+  RSModel model(RSModel::TreeTypes::AUTO_TREE);
+  REQUIRE_THROWS_AS(model.BuildModel(timers, arma::mat(referenceData), 20,
+      false, false), std::invalid_argument);
+
+  const bool singleMode = model.SelectTree(timers, referenceData, queryData,
+      range);
+  REQUIRE(model.TreeType() != RSModel::TreeTypes::AUTO_TREE);
+  REQUIRE(model.AutoSelected());
+  REQUIRE(model.IntrinsicDimension() > 2.0);
+  REQUIRE(model.IntrinsicDimension() < 4.0);
+
+  model.BuildModel(timers, arma::mat(referenceData), model.LeafSize(), false,
+      singleMode);
+
+  REQUIRE(data::Save("rs_auto_model.bin", "rs_model", model));
+  RSModel loadedModel;
+  REQUIRE(data::Load("rs_auto_model.bin", "rs_model", loadedModel));
+  REQUIRE(loadedModel.TreeType() == model.TreeType());
+  REQUIRE(loadedModel.LeafSize() == model.LeafSize());
+  REQUIRE(loadedModel.SingleMode() == singleMode);
+  REQUIRE(loadedModel.AutoSelected());
+
+  for (RSModel* m : { &model, &loadedModel })
+  {
+    std::vector<std::vector<size_t>> neighbors;
+    std::vector<std::vector<double>> distances;
+    m->Search(timers, arma::mat(queryData), range, neighbors, distances);
+
+    REQUIRE(neighbors.size() == baselineNeighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      std::vector<size_t> sorted = neighbors[i];
+      std::vector<size_t> baselineSorted = baselineNeighbors[i];
+      std::sort(sorted.begin(), sorted.end());
+      std::sort(baselineSorted.begin(), baselineSorted.end());
+      REQUIRE(sorted == baselineSorted);
+    }
+  }
+
+  remove("rs_auto_model.bin");
+}
+
 TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
 {
   arma::mat dataset = arma::randu<arma::mat>(5, 500);
@@ -1712,3 +1895,236 @@ TEST_CASE("MoveOperatorNaiveTest", "[RangeSearchTest]")
     }
   }
 }
+
+/**
+ * Make sure that single-tree search with several threads gives the same results
+ * as naive search, for both a separate query set and monochromatic search.
+ */
+TEST_CASE("ParallelSingleTreeVsNaive", "[RangeSearchTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 1000);
+  arma::mat queryData = arma::randu<arma::mat>(3, 300);
+
+  RangeSearch<> single(referenceData, false, true);
+  RangeSearch<> naive(referenceData, true);
+
+  for (size_t trial = 0; trial < 2; ++trial)
+  {
+    vector<vector<size_t>> neighborsSingle, neighborsNaive;
+    vector<vector<double>> distancesSingle, distancesNaive;
+    if (trial == 0)
+    {
+      single.Search(queryData, Range(0.1, 0.3), neighborsSingle,
+          distancesSingle);
+      naive.Search(queryData, Range(0.1, 0.3), neighborsNaive,
+          distancesNaive);
+    }
+    else
+    {
+      single.Search(Range(0.1, 0.3), neighborsSingle, distancesSingle);
+      naive.Search(Range(0.1, 0.3), neighborsNaive, distancesNaive);
+    }
+
+    vector<vector<pair<double, size_t>>> sortedTree, sortedNaive;
+    SortResults(neighborsSingle, distancesSingle, sortedTree);
+    SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+    REQUIRE(sortedTree.size() == sortedNaive.size());
+    for (size_t i = 0; i < sortedTree.size(); ++i)
+    {
+      REQUIRE(sortedTree[i].size() == sortedNaive[i].size());
+      for (size_t j = 0; j < sortedTree[i].size(); ++j)
+      {
+        REQUIRE(sortedTree[i][j].second == sortedNaive[i][j].second);
+        REQUIRE(sortedTree[i][j].first ==
+            Approx(sortedNaive[i][j].first).epsilon(1e-7));
+      }
+    }
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+// Check that the results passed to a callback and the counts of results are
+// the same as the results of naive search, in every search mode, for both a
+// separate query set and monochromatic search.
+template<template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckCallbackAndCount()
+{
+  using SearchType = RangeSearch<EuclideanDistance, arma::mat, TreeType>;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 800);
+  arma::mat queryData = arma::randu<arma::mat>(3, 200);
+  const Range range(0.05, 0.25);
+
+  RangeSearch<> naive(referenceData, true);
+  for (size_t mode = 0; mode < 3; ++mode)
+  {
+    SearchType search(referenceData, mode == 0, mode == 1);
+
+    for (size_t trial = 0; trial < 2; ++trial)
+    {
+      vector<vector<size_t>> neighborsNaive;
+      vector<vector<double>> distancesNaive;
+      const size_t numQueries = (trial == 0) ? queryData.n_cols :
+          referenceData.n_cols;
+
+      // Every query point is handled by only one thread, so the callback can
+      // write to the vectors of the query points without locking.
+      vector<vector<size_t>> neighbors(numQueries);
+      vector<vector<double>> distances(numQueries);
+      auto callback = [&](const size_t queryIndex,
+                          const size_t referenceIndex,
+                          const double distance)
+      {
+        neighbors[queryIndex].push_back(referenceIndex);
+        distances[queryIndex].push_back(distance);
+      };
+
+      arma::Col<size_t> counts;
+      if (trial == 0)
+      {
+        naive.Search(queryData, range, neighborsNaive, distancesNaive);
+        search.Search(queryData, range, callback);
+        search.Count(queryData, range, counts);
+      }
+      else
+      {
+        naive.Search(range, neighborsNaive, distancesNaive);
+        search.Search(range, callback);
+        search.Count(range, counts);
+      }
+
+      vector<vector<pair<double, size_t>>> sorted, sortedNaive;
+      SortResults(neighbors, distances, sorted);
+      SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+      REQUIRE(counts.n_elem == numQueries);
+      for (size_t i = 0; i < numQueries; ++i)
+      {
+        REQUIRE(counts[i] == sortedNaive[i].size());
+        REQUIRE(sorted[i].size() == sortedNaive[i].size());
+        for (size_t j = 0; j < sorted[i].size(); ++j)
+        {
+          REQUIRE(sorted[i][j].second == sortedNaive[i][j].second);
+          REQUIRE(sorted[i][j].first ==
+              Approx(sortedNaive[i][j].first).epsilon(1e-7));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that callback search and counting give the same results as naive
+ * search, with several threads, for kd-trees and cover trees.
+ */
+TEST_CASE("RangeSearchCallbackAndCountTest", "[RangeSearchTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  CheckCallbackAndCount<KDTree>();
+  CheckCallbackAndCount<StandardCoverTree>();
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
+
+// Check that symmetric monochromatic search gives the same results as naive
+// search, with fewer base cases than the regular dual-tree search.
+template<template<typename TreeDistanceType,
+                  typename TreeStatType,
+                  typename TreeMatType> class TreeType>
+void CheckSymmetricSearch(const bool fewerBaseCases)
+{
+  using SearchType = RangeSearch<EuclideanDistance, arma::mat, TreeType>;
+
+  arma::mat referenceData = arma::randu<arma::mat>(3, 800);
+  const Range range(0.05, 0.25);
+
+  RangeSearch<> naive(referenceData, true);
+  vector<vector<size_t>> neighborsNaive;
+  vector<vector<double>> distancesNaive;
+  naive.Search(range, neighborsNaive, distancesNaive);
+  vector<vector<pair<double, size_t>>> sortedNaive;
+  SortResults(neighborsNaive, distancesNaive, sortedNaive);
+
+  SearchType dualTree(referenceData);
+  vector<vector<size_t>> neighbors;
+  vector<vector<double>> distances;
+  dualTree.Search(range, neighbors, distances);
+  const size_t dualTreeBaseCases = dualTree.BaseCases();
+
+  for (size_t mode = 0; mode < 2; ++mode)
+  {
+    SearchType search(referenceData, mode == 0);
+    search.Symmetric() = true;
+
+    search.Search(range, neighbors, distances);
+    if (mode == 0)
+      REQUIRE(search.BaseCases() == 800 * 799 / 2);
+    else if (fewerBaseCases)
+      REQUIRE(search.BaseCases() < dualTreeBaseCases);
+
+    arma::Col<size_t> counts;
+    search.Count(range, counts);
+
+    vector<vector<pair<double, size_t>>> sorted;
+    SortResults(neighbors, distances, sorted);
+
+    REQUIRE(sorted.size() == sortedNaive.size());
+    REQUIRE(counts.n_elem == sortedNaive.size());
+    for (size_t i = 0; i < sorted.size(); ++i)
+    {
+      REQUIRE(counts[i] == sortedNaive[i].size());
+      REQUIRE(sorted[i].size() == sortedNaive[i].size());
+      for (size_t j = 0; j < sorted[i].size(); ++j)
+      {
+        REQUIRE(sorted[i][j].second == sortedNaive[i][j].second);
+        REQUIRE(sorted[i][j].first ==
+            Approx(sortedNaive[i][j].first).epsilon(1e-7));
+      }
+    }
+  }
+}
+
+/**
+ * Make sure that symmetric self-joins give the same results as naive search,
+ * with one thread and with several threads.  Cover trees can't be traversed
+ * symmetrically, so the regular search is used for them.
+ */
+TEST_CASE("RangeSearchSymmetricTest", "[RangeSearchTest]")
+{
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  #endif
+
+  for (size_t threads = 1; threads <= 4; threads += 3)
+  {
+    #ifdef MLPACK_USE_OPENMP
+    omp_set_num_threads(threads);
+    #endif
+
+    CheckSymmetricSearch<KDTree>(true);
+    CheckSymmetricSearch<BallTree>(true);
+    CheckSymmetricSearch<RTree>(true);
+    CheckSymmetricSearch<StandardCoverTree>(false);
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+}
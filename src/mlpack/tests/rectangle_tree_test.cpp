@@ -13,6 +13,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/neighbor_search.hpp>
+#include <mlpack/methods/range_search.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -1424,3 +1425,154 @@ TEST_CASE("RectangleTreeDeleteTest", "[RectangleTreeTest]")
   REQUIRE(tree.NumDescendants() == 0);
   REQUIRE(tree.NumPoints() == 0);
 }
+
+// Make sure that bulk-loaded trees are valid, balanced, and hold each point
+// exactly once, and that points can still be inserted afterwards.
+TEMPLATE_TEST_CASE("RectangleTreeBulkLoadTest", "[RectangleTreeTest]",
+    (RTree<EuclideanDistance, EmptyStatistic, arma::mat>),
+    (RStarTree<EuclideanDistance, EmptyStatistic, arma::mat>),
+    (XTree<EuclideanDistance, EmptyStatistic, arma::mat>),
+    (RPlusTree<EuclideanDistance, EmptyStatistic, arma::mat>))
+{
+  using TreeType = TestType;
+
+  arma::mat dataset(5, 5000, arma::fill::randu);
+  const bool canOverlap = TreeTraits<TreeType>::HasOverlappingChildren;
+
+  for (const RectangleTreeBulkLoad bulkLoad :
+      { STR_BULK_LOAD, HILBERT_BULK_LOAD })
+  {
+    if (!canOverlap && bulkLoad == HILBERT_BULK_LOAD)
+    {
+      REQUIRE_THROWS_AS(TreeType(dataset, bulkLoad), std::invalid_argument);
+      continue;
+    }
+
+    TreeType tree(dataset, bulkLoad, 20, 6, 5, 2);
+
+    REQUIRE(tree.NumDescendants() == dataset.n_cols);
+    CheckContainment(tree);
+    CheckExactContainment(tree);
+    CheckHierarchy(tree);
+    CheckNumDescendants(tree);
+    CheckFills(tree);
+    if (!canOverlap)
+      CheckOverlap(tree);
+
+    // A tree with four levels only holds 20 * 5^3 = 2500 points, so the
+    // packed tree has five levels.
+    REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+    REQUIRE(tree.TreeDepth() == 5);
+
+    // Every point is in exactly one leaf.
+    arma::Col<size_t> counts(dataset.n_cols, arma::fill::zeros);
+    std::stack<const TreeType*> s;
+    s.push(&tree);
+    while (!s.empty())
+    {
+      const TreeType* node = s.top();
+      s.pop();
+      for (size_t i = 0; i < node->NumPoints(); ++i)
+        ++counts[node->Point(i)];
+      for (size_t i = 0; i < node->NumChildren(); ++i)
+        s.push(&node->Child(i));
+    }
+    REQUIRE(arma::all(counts == 1));
+
+    // Insertion still works on the bulk-loaded tree.
+    tree.Insert(arma::mat(5, 200, arma::fill::randu));
+    REQUIRE(tree.NumDescendants() == dataset.n_cols + 200);
+    CheckContainment(tree);
+    CheckHierarchy(tree);
+    CheckNumDescendants(tree);
+    REQUIRE(GetMinLevel(tree) == GetMaxLevel(tree));
+  }
+}
+
+// A bulk-loaded tree must give the same nearest neighbors as a naive search.
+TEST_CASE("RectangleTreeBulkLoadTraverserTest", "[RectangleTreeTest]")
+{
+  arma::mat dataset;
+  dataset.randu(8, 1000); // 1000 points in 8 dimensions.
+  arma::Mat<size_t> neighbors1, neighbors2;
+  arma::mat distances1, distances2;
+
+  // Nearest neighbor search the naive way.
+  KNN knn2(dataset, NAIVE_MODE);
+  knn2.Search(5, neighbors2, distances2);
+
+  using TreeType = RStarTree<EuclideanDistance,
+      NeighborSearchStat<NearestNeighborSort>, arma::mat>;
+  for (const RectangleTreeBulkLoad bulkLoad :
+      { STR_BULK_LOAD, HILBERT_BULK_LOAD })
+  {
+    TreeType tree(dataset, bulkLoad, 20, 6, 5, 2);
+
+    NeighborSearch<NearestNeighborSort, LMetric<2, true>, arma::mat, RStarTree>
+        knn1(std::move(tree), DUAL_TREE_MODE);
+    knn1.Search(5, neighbors1, distances1);
+
+    for (size_t i = 0; i < neighbors1.size(); ++i)
+    {
+      REQUIRE(neighbors1[i] == neighbors2[i]);
+      REQUIRE(distances1[i] == distances2[i]);
+    }
+  }
+}
+
+// Make sure that readers of a ConcurrentRectangleTree always see a complete
+// tree while other threads insert points.
+TEST_CASE("ConcurrentRectangleTreeReadWriteTest", "[RectangleTreeTest]")
+{
+  using TreeType = RStarTree<EuclideanDistance, EmptyStatistic, arma::mat>;
+
+  arma::mat dataset(3, 1000, arma::fill::randu);
+  ConcurrentRectangleTree<TreeType> tree(TreeType(dataset, STR_BULK_LOAD));
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(4);
+  #endif
+
+  size_t failures = 0;
+  #pragma omp parallel for schedule(dynamic) reduction(+:failures)
+  for (size_t task = 0; task < 40; ++task)
+  {
+    if (task % 4 == 0)
+    {
+      // Writers insert batches of points.
+      tree.Insert(arma::mat(3, 50, arma::fill::randu));
+    }
+    else
+    {
+      // Readers check that the tree is consistent and search it.
+      tree.Read([&](TreeType& t)
+      {
+        if (t.NumDescendants() != t.Dataset().n_cols)
+          ++failures;
+
+        RangeSearch<EuclideanDistance, arma::mat, RStarTree> rs(&t);
+        std::vector<std::vector<size_t>> neighbors;
+        std::vector<std::vector<double>> distances;
+        rs.Search(dataset.cols(0, 9), Range(0.0, 0.2), neighbors,
+            distances);
+        for (size_t i = 0; i < neighbors.size(); ++i)
+          for (size_t j = 0; j < neighbors[i].size(); ++j)
+            if (neighbors[i][j] >= t.Dataset().n_cols)
+              ++failures;
+      });
+    }
+  }
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  REQUIRE(failures == 0);
+  REQUIRE(tree.NumDescendants() == 1500);
+  tree.Read([](TreeType& t)
+  {
+    CheckContainment(t);
+    CheckNumDescendants(t);
+  });
+}
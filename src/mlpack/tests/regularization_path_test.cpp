@@ -0,0 +1,249 @@
+/**
+ * @file tests/regularization_path_test.cpp
+ *
+ * Test the RegularizationPath class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+#include <mlpack/methods/regularization_path.hpp>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+
+/**
+ * Check the optimality conditions of the elastic-net penalized objective for
+ * the given parameters (one row per class, with the intercepts in the first
+ * column).
+ */
+template<typename MatType>
+void CheckOptimality(const MatType& data,
+                     const arma::Row<size_t>& labels,
+                     const arma::mat& parameters,
+                     const bool binary,
+                     const double lambda,
+                     const double alpha,
+                     const double tolerance)
+{
+  const size_t k = parameters.n_rows;
+  arma::mat responses(data.n_cols, k, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    if (binary)
+      responses(i, 0) = (double) labels[i];
+    else
+      responses(i, labels[i]) = 1.0;
+  }
+
+  arma::mat eta = arma::mat(parameters.cols(1, parameters.n_cols - 1) *
+      data).t();
+  eta.each_row() += parameters.col(0).t();
+  arma::mat probabilities;
+  if (binary)
+  {
+    probabilities = 1.0 / (1.0 + arma::exp(-eta));
+  }
+  else
+  {
+    probabilities = arma::exp(eta.each_col() - arma::max(eta, 1));
+    probabilities.each_col() /= arma::sum(probabilities, 1);
+  }
+
+  const arma::mat residual = responses - probabilities;
+  const arma::mat gradient = arma::mat(data * residual) / data.n_cols;
+
+  // The intercepts are not penalized.
+  REQUIRE(arma::abs(arma::mean(residual, 0)).max() < tolerance);
+
+  for (size_t c = 0; c < k; ++c)
+  {
+    for (size_t j = 0; j < data.n_rows; ++j)
+    {
+      const double w = parameters(c, j + 1);
+      const double g = gradient(j, c) - lambda * (1.0 - alpha) * w;
+      if (w == 0.0)
+        REQUIRE(std::abs(g) <= lambda * alpha + tolerance);
+      else
+        REQUIRE(std::abs(g - lambda * alpha * ((w > 0) ? 1 : -1)) < tolerance);
+    }
+  }
+}
+
+/**
+ * Generate a binary classification dataset where only the first two of ten
+ * features are informative.
+ */
+void LogisticDataset(arma::mat& data, arma::Row<size_t>& labels)
+{
+  data.randn(10, 500);
+  const arma::rowvec logits = 1.5 * data.row(0) - 2.0 * data.row(1) + 0.5;
+  const arma::rowvec p = 1.0 / (1.0 + arma::exp(-logits));
+  labels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::randu<arma::rowvec>(500) < p);
+}
+
+/**
+ * Check a lasso path of logistic regression: it starts with no nonzero
+ * weights, each solution is optimal, and the last one classifies well.
+ */
+TEST_CASE("RegularizationPathLogisticLassoTest", "[RegularizationPathTest]")
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  LogisticDataset(data, labels);
+
+  RegularizationPath<> path(1.0, 20, 1e-3, 1000, 1e-10);
+  std::vector<LogisticRegression<>> models;
+  path.Train(data, labels, models);
+
+  REQUIRE(models.size() == 20);
+  REQUIRE(path.Lambdas().n_elem == 20);
+  REQUIRE(arma::all(arma::diff(path.Lambdas()) < 0.0));
+
+  // At the first lambda, all the weights are zero (up to roundoff).
+  REQUIRE(arma::abs(models[0].Parameters().tail_cols(10)).max() < 1e-8);
+
+  for (size_t l = 0; l < models.size(); ++l)
+  {
+    CheckOptimality(data, labels, arma::mat(models[l].Parameters()), true,
+        path.Lambdas()[l], 1.0, 1e-4);
+  }
+
+  // The informative features have the largest weights at the end of the path.
+  const arma::rowvec& w = models.back().Parameters();
+  REQUIRE(w[1] > 0.5);
+  REQUIRE(w[2] < -0.5);
+  REQUIRE(arma::abs(w.tail_cols(8)).max() < 0.5);
+  REQUIRE(models.back().ComputeAccuracy(data, labels) > 70.0);
+}
+
+/**
+ * Make sure that a ridge path gives the same model as LogisticRegression
+ * trained with L-BFGS and the equivalent penalty.
+ */
+TEST_CASE("RegularizationPathRidgeTest", "[RegularizationPathTest]")
+{
+  arma::mat data;
+  arma::Row<size_t> labels;
+  LogisticDataset(data, labels);
+
+  RegularizationPath<> path(0.0);
+  path.Tolerance() = 1e-12;
+  std::vector<LogisticRegression<>> models;
+  path.Train(data, labels, models, arma::vec("0.1 0.01"));
+
+  REQUIRE(models.size() == 2);
+  for (size_t l = 0; l < 2; ++l)
+  {
+    REQUIRE(models[l].Lambda() == Approx(500 * path.Lambdas()[l]));
+
+    LogisticRegression<> lr(data, labels, models[l].Lambda());
+    for (size_t j = 0; j < lr.Parameters().n_elem; ++j)
+    {
+      REQUIRE(models[l].Parameters()[j] ==
+          Approx(lr.Parameters()[j]).margin(1e-4));
+    }
+  }
+}
+
+/**
+ * Make sure that sparse data gives the same path as the same dense data.
+ */
+TEST_CASE("RegularizationPathSparseTest", "[RegularizationPathTest]")
+{
+  arma::sp_mat sparseData;
+  sparseData.sprandu(30, 400, 0.1);
+  const arma::mat data(sparseData);
+  const arma::Row<size_t> labels = arma::conv_to<arma::Row<size_t>>::from(
+      arma::sum(data.rows(0, 4), 0) > arma::sum(data.rows(5, 9), 0));
+
+  RegularizationPath<> densePath(0.5, 10, 1e-2, 1000, 1e-12);
+  RegularizationPath<arma::sp_mat> sparsePath(0.5, 10, 1e-2, 1000, 1e-12);
+  std::vector<LogisticRegression<>> denseModels;
+  std::vector<LogisticRegression<arma::sp_mat>> sparseModels;
+  densePath.Train(data, labels, denseModels);
+  sparsePath.Train(sparseData, labels, sparseModels);
+
+  REQUIRE(sparseModels.size() == denseModels.size());
+  for (size_t l = 0; l < denseModels.size(); ++l)
+  {
+    REQUIRE(sparsePath.Lambdas()[l] == Approx(densePath.Lambdas()[l]));
+    for (size_t j = 0; j < denseModels[l].Parameters().n_elem; ++j)
+    {
+      REQUIRE(sparseModels[l].Parameters()[j] ==
+          Approx(denseModels[l].Parameters()[j]).margin(1e-5));
+    }
+  }
+
+  // Softmax regression works with sparse data too.
+  std::vector<SoftmaxRegression<arma::sp_mat>> softmaxModels;
+  sparsePath.Train(sparseData, labels, 2, softmaxModels);
+  CheckOptimality(sparseData, labels, arma::mat(softmaxModels.back().
+      Parameters()), false, sparsePath.Lambdas().back(), 0.5, 1e-4);
+}
+
+/**
+ * Check an elastic-net path of softmax regression on three Gaussians.
+ */
+TEST_CASE("RegularizationPathSoftmaxTest", "[RegularizationPathTest]")
+{
+  arma::mat data(5, 600, arma::fill::randn);
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = i % 3;
+    if (labels[i] < 2)
+      data(labels[i], i) += 3.0;
+  }
+
+  RegularizationPath<> path(0.5, 15, 1e-3, 1000, 1e-10);
+  std::vector<SoftmaxRegression<>> models;
+  path.Train(data, labels, 3, models);
+
+  REQUIRE(models.size() == 15);
+  for (size_t l = 0; l < models.size(); ++l)
+  {
+    REQUIRE(models[l].NumClasses() == 3);
+    REQUIRE(models[l].FeatureSize() == 5);
+    REQUIRE(models[l].Lambda() == Approx(0.5 * path.Lambdas()[l]));
+    CheckOptimality(data, labels, models[l].Parameters(), false,
+        path.Lambdas()[l], 0.5, 1e-4);
+  }
+
+  // The uninformative features are not used early in the path.
+  REQUIRE(arma::accu(models[3].Parameters().cols(3, 5) != 0.0) == 0);
+  REQUIRE(models.back().ComputeAccuracy(data, labels) > 85.0);
+}
+
+/**
+ * Make sure that invalid parameters are rejected.
+ */
+TEST_CASE("RegularizationPathInvalidTest", "[RegularizationPathTest]")
+{
+  arma::mat data(3, 20, arma::fill::randu);
+  arma::Row<size_t> labels(20);
+  for (size_t i = 0; i < 20; ++i)
+    labels[i] = i % 3;
+
+  RegularizationPath<> path;
+  std::vector<LogisticRegression<>> models;
+  std::vector<SoftmaxRegression<>> softmaxModels;
+
+  // Logistic regression needs binary labels.
+  REQUIRE_THROWS_AS(path.Train(data, labels, models), std::invalid_argument);
+  REQUIRE_THROWS_AS(path.Train(data, labels, 2, softmaxModels),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(path.Train(data, labels.cols(0, 9), 3, softmaxModels),
+      std::invalid_argument);
+
+  REQUIRE_THROWS_AS(path.Train(data, labels, 3, softmaxModels,
+      arma::vec("0.1 0.2")), std::invalid_argument);
+
+  path.Alpha() = 1.5;
+  REQUIRE_THROWS_AS(path.Train(data, labels, 3, softmaxModels),
+      std::invalid_argument);
+}
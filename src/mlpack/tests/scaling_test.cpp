@@ -166,3 +166,60 @@ TEST_CASE("ZCAWhiteningTest", "[ScalingTest]")
   scale.InverseTransform(output, temp);
   CheckMatrices(dataset, temp);
 }
+
+/**
+ * Fit a scaler with Fit() and with PartialFit() on blocks of the same data,
+ * and check that both give the same transformation, whether it is done in
+ * place or not.
+ */
+template<typename ScalerType>
+void CheckPartialFit(const arma::mat& input)
+{
+  ScalerType scale, partialScale;
+  scale.Fit(input);
+  // The first block is larger than the blocks of the parallel pass.
+  const arma::mat block1 = input.cols(0, 1499);
+  const arma::mat block2 = input.cols(1500, 1999);
+  const arma::mat block3 = input.cols(2000, input.n_cols - 1);
+  partialScale.PartialFit(block1);
+  partialScale.PartialFit(block2);
+  partialScale.PartialFit(block3);
+
+  arma::mat output, partialOutput;
+  scale.Transform(input, output);
+  partialScale.Transform(input, partialOutput);
+  CheckMatrices(output, partialOutput, 1e-3);
+
+  arma::mat inPlace = input;
+  scale.Transform(inPlace);
+  CheckMatrices(output, inPlace);
+
+  scale.InverseTransform(output, inPlace);
+  CheckMatrices(input, inPlace, 1e-5);
+}
+
+/**
+ * Make sure that PartialFit() matches Fit() and that the in-place Transform()
+ * matches the other one, for every scaler.
+ */
+TEST_CASE("ScalerPartialFitTest", "[ScalingTest]")
+{
+  // Use large means, so that inaccurate statistics would be noticed.
+  arma::mat input(5, 2500, arma::fill::randn);
+  input.each_col() += arma::vec("1000 -50 3 0 200");
+
+  CheckPartialFit<data::MinMaxScaler>(input);
+  CheckPartialFit<data::MaxAbsScaler>(input);
+  CheckPartialFit<data::StandardScaler>(input);
+  CheckPartialFit<data::MeanNormalization>(input);
+  CheckPartialFit<data::PCAWhitening>(input);
+  CheckPartialFit<data::ZCAWhitening>(input);
+
+  // The standard scaler uses the population standard deviation.
+  data::StandardScaler scale;
+  scale.Fit(input);
+  arma::mat output;
+  scale.Transform(input, output);
+  CheckMatrices(arma::mean(output, 1), arma::zeros<arma::vec>(5), 1e-5);
+  CheckMatrices(arma::stddev(output, 1, 1), arma::ones<arma::vec>(5), 1e-5);
+}
@@ -126,6 +126,64 @@ TEST_CASE("EmptySparseMatrixSerializeTest", "[SerializationTest]")
   TestAllArmadilloSerialization(m);
 }
 
+// Serialize the given elements one at a time, as older versions of mlpack did.
+template<typename OArchiveType, typename eT>
+void SerializeElements(OArchiveType& ar, const eT* mem, const size_t n)
+{
+  for (size_t i = 0; i < n; ++i)
+    ar(mem[i]);
+}
+
+// Check that a dense matrix, a sparse matrix and a cube, serialized with the
+// given archive, have the same bytes as if their elements were serialized one
+// at a time.
+template<typename eT, typename OArchiveType>
+void CheckRawArmadilloSerialization()
+{
+  arma::Mat<eT> m = arma::conv_to<arma::Mat<eT>>::from(
+      100 * arma::randu<arma::mat>(7, 11));
+  arma::SpMat<eT> sp(arma::conv_to<arma::Mat<eT>>::from(
+      100 * arma::mat(arma::sprandu<arma::sp_mat>(30, 20, 0.2))));
+  arma::Cube<eT> c = arma::conv_to<arma::Cube<eT>>::from(
+      100 * arma::randu<arma::cube>(3, 4, 5));
+
+  std::ostringstream raw(std::ios::out | std::ios::binary);
+  {
+    OArchiveType ar(raw);
+    ar(CEREAL_NVP(m), CEREAL_NVP(sp), CEREAL_NVP(c));
+  }
+
+  std::ostringstream elements(std::ios::out | std::ios::binary);
+  {
+    OArchiveType ar(elements);
+    ar(m.n_rows, m.n_cols, (arma::uword) m.vec_state);
+    SerializeElements(ar, m.memptr(), m.n_elem);
+
+    ar(sp.n_rows, sp.n_cols, sp.n_nonzero, (arma::uword) sp.vec_state);
+    SerializeElements(ar, sp.values, sp.n_nonzero);
+    SerializeElements(ar, sp.row_indices, sp.n_nonzero);
+    SerializeElements(ar, sp.col_ptrs, sp.n_cols + 1);
+
+    ar(c.n_rows, c.n_cols, c.n_slices);
+    SerializeElements(ar, c.memptr(), c.n_elem);
+  }
+
+  REQUIRE(raw.str() == elements.str());
+}
+
+/**
+ * Make sure that the binary archives store the memory of Armadillo objects as
+ * one block, with the same bytes as element-by-element serialization.
+ */
+TEST_CASE("RawArmadilloSerializationTest", "[SerializationTest]")
+{
+  CheckRawArmadilloSerialization<double, BinaryOutputArchive>();
+  CheckRawArmadilloSerialization<float, BinaryOutputArchive>();
+  CheckRawArmadilloSerialization<size_t, BinaryOutputArchive>();
+  CheckRawArmadilloSerialization<double, PortableBinaryOutputArchive>();
+  CheckRawArmadilloSerialization<size_t, PortableBinaryOutputArchive>();
+}
+
 TEST_CASE("BallBoundTest", "[SerializationTest]")
 {
   BallBound<> b(100);
@@ -1041,16 +1099,21 @@ TEST_CASE("LSHTest", "[SerializationTest]")
   REQUIRE(lsh.BucketSize() == jsonLsh.BucketSize());
   REQUIRE(lsh.BucketSize() == binaryLsh.BucketSize());
 
-  REQUIRE(lsh.SecondHashTable().size() ==
-      xmlLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      jsonLsh.SecondHashTable().size());
-  REQUIRE(lsh.SecondHashTable().size() ==
-      binaryLsh.SecondHashTable().size());
+  CheckMatrices(lsh.BucketOffsets(), xmlLsh.BucketOffsets(),
+      jsonLsh.BucketOffsets(), binaryLsh.BucketOffsets());
+
+  const std::vector<arma::Col<size_t>> table = lsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> xmlTable = xmlLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> jsonTable = jsonLsh.SecondHashTable();
+  const std::vector<arma::Col<size_t>> binaryTable =
+      binaryLsh.SecondHashTable();
+
+  REQUIRE(table.size() == xmlTable.size());
+  REQUIRE(table.size() == jsonTable.size());
+  REQUIRE(table.size() == binaryTable.size());
 
-  for (size_t i = 0; i < lsh.SecondHashTable().size(); ++i)
-  CheckMatrices(lsh.SecondHashTable()[i], xmlLsh.SecondHashTable()[i],
-      jsonLsh.SecondHashTable()[i], binaryLsh.SecondHashTable()[i]);
+  for (size_t i = 0; i < table.size(); ++i)
+    CheckMatrices(table[i], xmlTable[i], jsonTable[i], binaryTable[i]);
 }
 
 // Make sure serialization works for LARS.
@@ -911,3 +911,50 @@ TEST_CASE("SoftmaxRegressionResetTest", "[SoftmaxRegressionTest]")
   REQUIRE(
       !arma::approx_equal(sr1.Parameters(), sr2.Parameters(), "absdiff", 1e-5));
 }
+
+/**
+ * Make sure that softmax regression trained on sparse data gives the same model
+ * and the same predictions as on the equivalent dense data.
+ */
+TEST_CASE("SoftmaxRegressionSparseTest", "[SoftmaxRegressionTest]")
+{
+  arma::sp_mat data;
+  data.sprandu(100, 600, 0.1);
+  arma::mat denseData(data);
+
+  // Each class is marked by one feature.
+  arma::Row<size_t> labels(600);
+  for (size_t i = 0; i < 600; ++i)
+  {
+    labels[i] = 0;
+    for (size_t c = 1; c < 3; ++c)
+    {
+      if (denseData(c, i) > denseData(labels[i], i))
+        labels[i] = c;
+    }
+  }
+
+  for (const bool fitIntercept : { true, false })
+  {
+    SoftmaxRegression<> sr(100, 3, fitIntercept);
+    SoftmaxRegression<arma::sp_mat> srSparse(100, 3, fitIntercept);
+    sr.Parameters().zeros();
+    srSparse.Parameters().zeros();
+
+    ens::L_BFGS lbfgs, lbfgsSparse;
+    sr.Train(denseData, labels, 3, lbfgs, 0.0001, fitIntercept);
+    srSparse.Train(data, labels, 3, lbfgsSparse, 0.0001, fitIntercept);
+
+    REQUIRE(arma::approx_equal(sr.Parameters(), srSparse.Parameters(),
+        "absdiff", 1e-3));
+
+    arma::Row<size_t> predictions, sparsePredictions;
+    arma::mat probabilities, sparseProbabilities;
+    sr.Classify(denseData, predictions, probabilities);
+    srSparse.Classify(data, sparsePredictions, sparseProbabilities);
+
+    REQUIRE(arma::accu(predictions != sparsePredictions) <= 5);
+    REQUIRE(arma::approx_equal(probabilities, sparseProbabilities, "absdiff",
+        1e-3));
+  }
+}
@@ -273,3 +273,125 @@ TEST_CASE("SparseAutoencoderFunctionGradient", "[SparseAutoencoderTest]")
     }
   }
 }
+
+/**
+ * Make sure that the batch objective and gradient over the whole dataset match
+ * the full objective and gradient, that the batch gradient matches a numerical
+ * gradient of the batch objective, and that EvaluateWithGradient() agrees.
+ */
+TEST_CASE("SparseAutoencoderFunctionBatchTest", "[SparseAutoencoderTest]")
+{
+  const size_t points = 700;
+  const size_t vSize = 12;
+  const size_t hSize = 6;
+
+  arma::mat data(vSize, points, arma::fill::randu);
+  SparseAutoencoderFunction saf(data, vSize, hSize, 0.5, 3, 0.1);
+  REQUIRE(saf.NumFunctions() == points);
+
+  arma::mat parameters(2 * hSize + 1, vSize + 1, arma::fill::randu);
+
+  arma::mat gradient, batchGradient, gradient2;
+  saf.Gradient(parameters, gradient);
+  saf.Gradient(parameters, 0, batchGradient, points);
+  const double cost = saf.EvaluateWithGradient(parameters, gradient2);
+
+  REQUIRE(saf.Evaluate(parameters, 0, points) ==
+      Approx(saf.Evaluate(parameters)).epsilon(1e-10));
+  REQUIRE(cost == Approx(saf.Evaluate(parameters)).epsilon(1e-10));
+  REQUIRE(arma::approx_equal(gradient, batchGradient, "reldiff", 1e-10));
+  REQUIRE(arma::approx_equal(gradient, gradient2, "reldiff", 1e-10));
+
+  // Check the gradient of a batch of points numerically.
+  const size_t begin = 150;
+  const size_t batchSize = 300;
+  const double batchCost = saf.EvaluateWithGradient(parameters, begin,
+      batchGradient, batchSize);
+  REQUIRE(batchCost ==
+      Approx(saf.Evaluate(parameters, begin, batchSize)).epsilon(1e-10));
+
+  const double epsilon = 0.0001;
+  for (size_t i = 0; i < parameters.n_rows; ++i)
+  {
+    for (size_t j = 0; j < parameters.n_cols; ++j)
+    {
+      parameters(i, j) += epsilon;
+      const double costPlus = saf.Evaluate(parameters, begin, batchSize);
+      parameters(i, j) -= 2 * epsilon;
+      const double costMinus = saf.Evaluate(parameters, begin, batchSize);
+      parameters(i, j) += epsilon;
+
+      REQUIRE((costPlus - costMinus) / (2 * epsilon) ==
+          Approx(batchGradient(i, j)).epsilon(1e-4));
+    }
+  }
+}
+
+/**
+ * Make sure that sparse data gives the same objective, gradient and features
+ * as the same data stored densely.
+ */
+TEST_CASE("SparseAutoencoderSparseDataTest", "[SparseAutoencoderTest]")
+{
+  const size_t points = 500;
+  const size_t vSize = 30;
+  const size_t hSize = 8;
+
+  arma::sp_mat sparseData;
+  sparseData.sprandu(vSize, points, 0.1);
+  const arma::mat data(sparseData);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize);
+  SparseAutoencoderFunction<arma::sp_mat> sparseSaf(sparseData, vSize, hSize);
+
+  arma::mat parameters(2 * hSize + 1, vSize + 1, arma::fill::randu);
+  arma::mat gradient, sparseGradient;
+  const double cost = saf.EvaluateWithGradient(parameters, 100, gradient, 250);
+  const double sparseCost = sparseSaf.EvaluateWithGradient(parameters, 100,
+      sparseGradient, 250);
+
+  REQUIRE(sparseCost == Approx(cost).epsilon(1e-10));
+  REQUIRE(arma::approx_equal(gradient, sparseGradient, "reldiff", 1e-8));
+
+  // Train on the sparse data, and check that the features match those of the
+  // dense data.
+  ens::L_BFGS optimizer(5, 20);
+  SparseAutoencoder encoder(sparseData, vSize, hSize, 0.0001, 3, 0.01,
+      optimizer);
+
+  arma::mat features, sparseFeatures;
+  encoder.GetNewFeatures(data, features);
+  encoder.GetNewFeatures(sparseData, sparseFeatures);
+
+  REQUIRE(features.n_rows == hSize);
+  REQUIRE(features.n_cols == points);
+  REQUIRE(arma::approx_equal(features, sparseFeatures, "reldiff", 1e-8));
+}
+
+/**
+ * Make sure that a sparse autoencoder can be trained with a mini-batch
+ * optimizer, and that training reduces the objective.
+ */
+TEST_CASE("SparseAutoencoderSGDTest", "[SparseAutoencoderTest]")
+{
+  const size_t points = 400;
+  const size_t vSize = 10;
+  const size_t hSize = 4;
+
+  arma::mat data(vSize, points, arma::fill::randu);
+
+  SparseAutoencoderFunction saf(data, vSize, hSize);
+  arma::mat parameters = saf.GetInitialPoint();
+  const double initialCost = saf.Evaluate(parameters);
+
+  ens::StandardSGD optimizer(0.1, 32, 20 * points, 1e-10, true);
+  optimizer.Optimize(saf, parameters);
+
+  REQUIRE(saf.Evaluate(parameters) < initialCost);
+
+  // The data held by the function was shuffled, but the objective over the
+  // whole dataset does not depend on the order of the points.
+  SparseAutoencoderFunction saf2(data, vSize, hSize);
+  REQUIRE(saf.Evaluate(parameters) ==
+      Approx(saf2.Evaluate(parameters)).epsilon(1e-8));
+}
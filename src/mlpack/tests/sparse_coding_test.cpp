@@ -235,3 +235,40 @@ TEMPLATE_TEST_CASE("SparseCodingTrainReturnObjective", "[SparseCodingTest]",
 
   REQUIRE(std::isfinite(objVal) == true);
 }
+
+/**
+ * Make sure that encoding all points at once (in parallel) gives the same codes
+ * as encoding each point by itself.
+ */
+TEMPLATE_TEST_CASE("SparseCodingParallelEncodeTest", "[SparseCodingTest]",
+    arma::mat, arma::fmat)
+{
+  using MatType = TestType;
+
+  const double tol = std::is_same_v<typename MatType::elem_type, float> ?
+      1e-4 : 1e-8;
+  const size_t nAtoms = 15;
+
+  arma::mat inX; // The .arm file contains an arma::mat.
+  inX.load("mnist_first250_training_4s_and_9s.csv");
+  MatType X = arma::conv_to<MatType>::from(inX);
+
+  // Normalize each point since these are images.
+  for (uword i = 0; i < X.n_cols; ++i)
+    X.col(i) /= norm(X.col(i), 2);
+
+  SparseCoding<MatType> sc(nAtoms, 0.1, 0.01);
+  DataDependentRandomInitializer::Initialize(X, nAtoms, sc.Dictionary());
+
+  MatType Z;
+  sc.Encode(X, Z);
+  REQUIRE(Z.n_rows == nAtoms);
+  REQUIRE(Z.n_cols == X.n_cols);
+
+  for (uword i = 0; i < X.n_cols; i += 7)
+  {
+    MatType z;
+    sc.Encode(MatType(X.col(i)), z);
+    REQUIRE(arma::approx_equal(z, Z.col(i), "absdiff", tol));
+  }
+}
@@ -948,3 +948,72 @@ TEST_CASE("SplitMatDataShuffleWithLabelsAndWeights", "[SplitDataTest]")
   for (size_t c = 0; c < 30; ++c)
     REQUIRE(found[c]);
 }
+
+/**
+ * Make sure that the index splits partition the points, that gathering the
+ * indices gives the same result as Split() and StratifiedSplit() with the same
+ * random seed, and that the k-fold split has the bins of KFoldCV.
+ */
+TEST_CASE("SplitIndicesTest", "[SplitDataTest]")
+{
+  mat input(4, 2003, fill::randu);
+  Row<size_t> labels = randi<Row<size_t>>(2003, distr_param(0, 3));
+
+  uvec trainIndices, testIndices;
+  RandomSeed(10);
+  SplitIndices(input.n_cols, trainIndices, testIndices, 0.2);
+  REQUIRE(testIndices.n_elem == 400);
+  REQUIRE(trainIndices.n_elem == 1603);
+  uvec sorted = sort(join_cols(trainIndices, testIndices));
+  REQUIRE(sorted.n_elem == 2003);
+  for (size_t i = 0; i < sorted.n_elem; ++i)
+    REQUIRE(sorted[i] == i);
+
+  mat trainData, testData, gathered;
+  Row<size_t> trainLabels, testLabels;
+  RandomSeed(10);
+  Split(input, labels, trainData, testData, trainLabels, testLabels, 0.2);
+  GatherColumns(input, trainIndices, gathered);
+  CheckMatrices(trainData, gathered);
+  GatherColumns(input, testIndices, gathered);
+  CheckMatrices(testData, gathered);
+
+  // Gathering in place must give the same columns.
+  gathered = input;
+  GatherColumns(gathered, testIndices, gathered);
+  CheckMatrices(testData, gathered);
+
+  RandomSeed(11);
+  StratifiedSplitIndices(labels, trainIndices, testIndices, 0.3);
+  RandomSeed(11);
+  StratifiedSplit(input, labels, trainData, testData, trainLabels, testLabels,
+      0.3);
+  GatherColumns(input, trainIndices, gathered);
+  CheckMatrices(trainData, gathered);
+  GatherColumns(input, testIndices, gathered);
+  CheckMatrices(testData, gathered);
+  const Row<size_t> gatheredLabels = labels.cols(testIndices);
+  CheckMatrices(testLabels, gatheredLabels);
+
+  std::vector<uvec> folds;
+  KFoldSplitIndices(input.n_cols, 5, folds);
+  REQUIRE(folds.size() == 5);
+  for (size_t i = 0; i < 4; ++i)
+    REQUIRE(folds[i].n_elem == 400);
+  REQUIRE(folds[4].n_elem == 403);
+
+  for (size_t i = 0; i < 5; ++i)
+  {
+    KFoldTrainingIndices(folds, i, trainIndices);
+    sorted = sort(join_cols(trainIndices, folds[i]));
+    REQUIRE(sorted.n_elem == 2003);
+    for (size_t j = 0; j < sorted.n_elem; ++j)
+      REQUIRE(sorted[j] == j);
+  }
+
+  REQUIRE_THROWS_AS(KFoldSplitIndices(input.n_cols, 1, folds),
+      std::invalid_argument);
+  testIndices[0] = 2003;
+  REQUIRE_THROWS_AS(GatherColumns(input, testIndices, gathered),
+      std::invalid_argument);
+}
@@ -11,6 +11,7 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
+#include <mlpack/methods/logistic_regression.hpp>
 #include <memory>
 #include "test_catch_tools.hpp"
 #include "catch.hpp"
@@ -1427,3 +1428,120 @@ TEST_CASE("SplitByAnyOfTfIdfEncodingSerialization", "[StringEncodingTest]")
 
   CheckMatrices(output, xmlOutput, jsonOutput, binaryOutput);
 }
+
+/**
+ * Make sure that encoding a large corpus into a sparse matrix, which is done
+ * in parallel, gives the same dictionary and values as the dense encoding.
+ */
+TEST_CASE("SparseParallelEncodingTest", "[StringEncodingTest]")
+{
+  // More strings than one chunk, some of them empty.
+  vector<string> input(3000);
+  for (string& line : input)
+  {
+    const size_t numTokens = RandInt(20);
+    for (size_t i = 0; i < numTokens; ++i)
+      line += "w" + to_string(RandInt(500)) + ((i % 3 == 0) ? ", " : " ");
+  }
+
+  SplitByAnyOf tokenizer(" ,");
+
+  BagOfWordsEncoding<SplitByAnyOf::TokenType> bowEncoder, sparseBowEncoder;
+  arma::mat output;
+  arma::sp_mat sparseOutput;
+  bowEncoder.Encode(input, output, tokenizer);
+  sparseBowEncoder.Encode(input, sparseOutput, tokenizer);
+
+  CheckDictionaries(bowEncoder.Dictionary(), sparseBowEncoder.Dictionary());
+  CheckMatrices(output, arma::mat(sparseOutput));
+
+  for (TfIdfEncodingPolicy::TfTypes tfType :
+      { TfIdfEncodingPolicy::TfTypes::BINARY,
+        TfIdfEncodingPolicy::TfTypes::TERM_FREQUENCY,
+        TfIdfEncodingPolicy::TfTypes::SUBLINEAR_TF })
+  {
+    TfIdfEncoding<SplitByAnyOf::TokenType> encoder(tfType, false);
+    TfIdfEncoding<SplitByAnyOf::TokenType> sparseEncoder(tfType, false);
+    encoder.Encode(input, output, tokenizer);
+    sparseEncoder.Encode(input, sparseOutput, tokenizer);
+
+    CheckDictionaries(encoder.Dictionary(), sparseEncoder.Dictionary());
+    CheckMatrices(output, arma::mat(sparseOutput));
+  }
+
+  // The characters of each string are labeled in the same order, too.
+  BagOfWordsEncoding<CharExtract::TokenType> charEncoder, sparseCharEncoder;
+  charEncoder.Encode(input, output, CharExtract());
+  sparseCharEncoder.Encode(input, sparseOutput, CharExtract());
+
+  CheckDictionaries(charEncoder.Dictionary(), sparseCharEncoder.Dictionary());
+  CheckMatrices(output, arma::mat(sparseOutput));
+}
+
+/**
+ * Make sure that the hashing encoding sums the signs of the tokens of each
+ * string in the dimensions they hash to, and that its output can be used to
+ * train a sparse model.
+ */
+TEST_CASE("HashingEncodingTest", "[StringEncodingTest]")
+{
+  // More strings than one chunk; the first word of each string gives its
+  // label.
+  vector<string> input(2000);
+  arma::Row<size_t> labels(input.size());
+  for (size_t i = 0; i < input.size(); ++i)
+  {
+    labels[i] = RandInt(2);
+    input[i] = (labels[i] == 0) ? "bad" : "good";
+    const size_t numTokens = RandInt(10);
+    for (size_t j = 0; j < numTokens; ++j)
+      input[i] += " w" + to_string(RandInt(200));
+  }
+
+  SplitByAnyOf tokenizer(" ");
+  for (const bool alternateSign : { true, false })
+  {
+    HashingEncoding<SplitByAnyOf::TokenType> encoder(10, alternateSign);
+    arma::sp_mat output;
+    encoder.Encode(input, output, tokenizer);
+
+    REQUIRE(output.n_rows == 1024);
+    REQUIRE(output.n_cols == input.size());
+    REQUIRE(encoder.Dictionary().Size() == 0);
+
+    // Compute the encoding naively.
+    arma::mat expected(1024, input.size(), arma::fill::zeros);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+      std::string_view strView(input[i]);
+      std::string_view token = tokenizer(strView);
+      while (!tokenizer.IsTokenEmpty(token))
+      {
+        int sign;
+        const size_t index = encoder.EncodingPolicy().Index(token, sign);
+        REQUIRE(index < 1024);
+        if (!alternateSign)
+          REQUIRE(sign == 1);
+
+        expected(index, i) += sign;
+        token = tokenizer(strView);
+      }
+    }
+
+    CheckMatrices(arma::mat(output), expected);
+  }
+
+  // The label is given by the first word.
+  HashingEncoding<SplitByAnyOf::TokenType> encoder(12);
+  arma::sp_mat output;
+  encoder.Encode(input, output, tokenizer);
+
+  LogisticRegression<arma::sp_mat> lr(output, labels, 0.001);
+  REQUIRE(lr.ComputeAccuracy(output, labels) > 95.0);
+
+  // Characters are hashed too.
+  HashingEncoding<CharExtract::TokenType> charEncoder(8);
+  charEncoder.Encode(input, output, CharExtract());
+  REQUIRE(output.n_rows == 256);
+  REQUIRE(output.n_cols == input.size());
+}
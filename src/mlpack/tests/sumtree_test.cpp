@@ -12,6 +12,7 @@
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/reinforcement_learning/replay/sumtree.hpp>
+#include <mlpack/methods/reinforcement_learning/replay/concurrent_sumtree.hpp>
 
 #include "catch.hpp"
 #include "test_catch_tools.hpp"
@@ -87,3 +88,89 @@ TEST_CASE("BatchUpdate", "[SumTreeTest]")
   REQUIRE(sumtree.FindPrefixSum(2.8) <= 3);
   REQUIRE(sumtree.FindPrefixSum(3.0) <= 3);
 }
+
+/**
+ * Test that ConcurrentSumTree gives the same results as SumTree.
+ */
+TEST_CASE("ConcurrentSumTreeMatchesSumTree", "[SumTreeTest]")
+{
+  SumTree<double> sumtree(16);
+  ConcurrentSumTree<double> concurrentSumtree(16);
+
+  for (size_t i = 0; i < 50; ++i)
+  {
+    const size_t idx = RandInt(16);
+    const double value = Random();
+    sumtree.Set(idx, value);
+    concurrentSumtree.Set(idx, value);
+  }
+
+  // Some indices appear twice in the batch; the last value is kept.
+  arma::ucolvec indices = { 3, 7, 3, 12, 0, 15, 7 };
+  arma::colvec data(indices.n_elem, arma::fill::randu);
+  sumtree.BatchUpdate(indices, data);
+  concurrentSumtree.BatchUpdate(indices, data);
+
+  for (size_t i = 0; i < 16; ++i)
+    REQUIRE(concurrentSumtree.Get(i) == sumtree.Get(i));
+
+  for (size_t start = 0; start < 16; ++start)
+  {
+    for (size_t end = start + 1; end <= 16; ++end)
+    {
+      REQUIRE(concurrentSumtree.Sum(start, end) ==
+          Approx(sumtree.Sum(start, end)).epsilon(1e-10));
+    }
+  }
+
+  for (size_t i = 0; i < 100; ++i)
+  {
+    const double mass = Random(0.0, 0.999 * sumtree.Sum());
+    REQUIRE(concurrentSumtree.FindPrefixSum(mass) ==
+        sumtree.FindPrefixSum(mass));
+  }
+}
+
+/**
+ * Test that the sums of a ConcurrentSumTree are right after many threads have
+ * updated it at the same time.
+ */
+TEST_CASE("ConcurrentSumTreeParallelUpdates", "[SumTreeTest]")
+{
+  const size_t capacity = 64;
+  ConcurrentSumTree<double> sumtree(capacity);
+
+  arma::mat values(4, 1000, arma::fill::randu);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < (size_t) values.n_cols; ++i)
+  {
+    if (i % 10 == 0)
+    {
+      arma::ucolvec indices = { (i / 10) % capacity, (7 * i) % capacity };
+      arma::colvec data = { values(0, i), values(1, i) };
+      sumtree.BatchUpdate(indices, data);
+    }
+    else
+    {
+      sumtree.Set(i % capacity, values(2, i));
+      sumtree.Set((3 * i + 1) % capacity, values(3, i));
+    }
+  }
+
+  // Whichever update of each element came last, all internal nodes must be the
+  // sum of their children.
+  double total = 0.0;
+  for (size_t i = 0; i < capacity; ++i)
+    total += sumtree.Get(i);
+  REQUIRE(sumtree.Sum() == Approx(total).epsilon(1e-10));
+  for (size_t i = 0; i < capacity; i += 4)
+  {
+    REQUIRE(sumtree.Sum(i, i + 4) == Approx(sumtree.Get(i) + sumtree.Get(i + 1)
+        + sumtree.Get(i + 2) + sumtree.Get(i + 3)).epsilon(1e-10));
+  }
+
+  ConcurrentSumTree<double> rebuilt(sumtree);
+  rebuilt.Rebuild();
+  REQUIRE(rebuilt.Sum() == Approx(sumtree.Sum()).epsilon(1e-10));
+}
@@ -0,0 +1,160 @@
+/**
+ * @file tests/thread_communicator.hpp
+ *
+ * A communicator whose ranks are threads of one process, to test the
+ * distributed algorithms with several ranks without MPI.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_TESTS_THREAD_COMMUNICATOR_HPP
+#define MLPACK_TESTS_THREAD_COMMUNICATOR_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/core/util/communicator.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/**
+ * The state shared by the ranks of a group of ThreadCommunicators: one
+ * message slot for each pair of ranks, and a barrier.
+ */
+class ThreadCommunicatorGroup
+{
+ public:
+  ThreadCommunicatorGroup(const size_t size) :
+      size(size),
+      slots(size * size),
+      waiting(0),
+      generation(0)
+  { }
+
+  //! Wait until every rank has reached the barrier.
+  void Barrier()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    const size_t currentGeneration = generation;
+    if (++waiting == size)
+    {
+      waiting = 0;
+      ++generation;
+      condition.notify_all();
+    }
+    else
+    {
+      condition.wait(lock, [&]() { return generation != currentGeneration; });
+    }
+  }
+
+  //! The number of ranks.
+  size_t size;
+  //! The message from rank s to rank d is in slots[s * size + d].
+  std::vector<std::vector<char>> slots;
+
+ private:
+  std::mutex mutex;
+  std::condition_variable condition;
+  size_t waiting;
+  size_t generation;
+};
+
+/**
+ * One rank of a ThreadCommunicatorGroup; it has the interface of
+ * LocalCommunicator.
+ */
+class ThreadCommunicator
+{
+ public:
+  ThreadCommunicator(ThreadCommunicatorGroup& group, const size_t rank) :
+      group(group),
+      rank(rank)
+  { }
+
+  size_t Rank() const { return rank; }
+  size_t Size() const { return group.size; }
+
+  template<typename T>
+  void AllToAll(const std::vector<std::vector<T>>& send,
+                std::vector<std::vector<T>>& received)
+  {
+    for (size_t r = 0; r < group.size; ++r)
+    {
+      const char* bytes = reinterpret_cast<const char*>(send[r].data());
+      group.slots[rank * group.size + r].assign(bytes,
+          bytes + send[r].size() * sizeof(T));
+    }
+    group.Barrier();
+
+    received.resize(group.size);
+    for (size_t r = 0; r < group.size; ++r)
+    {
+      const std::vector<char>& slot = group.slots[r * group.size + rank];
+      received[r].resize(slot.size() / sizeof(T));
+      if (!slot.empty())
+        std::memcpy(received[r].data(), slot.data(), slot.size());
+    }
+    group.Barrier();
+  }
+
+  template<typename T>
+  void AllGather(const std::vector<T>& send,
+                 std::vector<std::vector<T>>& received)
+  {
+    AllToAll(std::vector<std::vector<T>>(group.size, send), received);
+  }
+
+  template<typename T>
+  void AllReduceSum(T* data, const size_t n)
+  {
+    // The sum is computed in the order of the ranks, so it is the same on
+    // every rank.
+    std::vector<std::vector<T>> all;
+    AllGather(std::vector<T>(data, data + n), all);
+    for (size_t i = 0; i < n; ++i)
+    {
+      data[i] = T(0);
+      for (size_t r = 0; r < group.size; ++r)
+        data[i] += all[r][i];
+    }
+  }
+
+  // The sum is computed at once, so there is nothing to wait for.
+  template<typename T>
+  void StartAllReduceSum(T* data, const size_t n) { AllReduceSum(data, n); }
+
+  void WaitAll() { }
+
+ private:
+  ThreadCommunicatorGroup& group;
+  size_t rank;
+};
+
+/**
+ * Run the given function on the given number of ranks, each in its own
+ * thread.  The function takes a ThreadCommunicator&.  Catch assertions are not
+ * thread-safe, so the function should store its results for the caller to
+ * check.
+ */
+template<typename FunctionType>
+inline void RunOnThreads(const size_t numRanks, FunctionType f)
+{
+  ThreadCommunicatorGroup group(numRanks);
+  std::vector<std::thread> threads;
+  for (size_t r = 0; r < numRanks; ++r)
+  {
+    threads.emplace_back([&group, &f, r]()
+    {
+      ThreadCommunicator comm(group, r);
+      f(comm);
+    });
+  }
+
+  for (std::thread& thread : threads)
+    thread.join();
+}
+
+#endif
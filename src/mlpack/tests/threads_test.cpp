@@ -0,0 +1,115 @@
+/**
+ * @file tests/threads_test.cpp
+ *
+ * Tests for the Threads and ThreadBudget classes and FirstTouch().
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#include "catch.hpp"
+
+using namespace mlpack;
+
+/**
+ * Make sure that the number of threads can be set and restored.
+ */
+TEST_CASE("ThreadsSetTest", "[ThreadsTest]")
+{
+  const size_t defaultThreads = Threads::Get();
+  REQUIRE(defaultThreads >= 1);
+  REQUIRE(!Threads::InParallel());
+  REQUIRE(Threads::Available() == defaultThreads);
+
+  Threads::Set(3);
+  REQUIRE(Threads::Get() == 3);
+  #ifdef MLPACK_USE_OPENMP
+  REQUIRE(omp_get_max_threads() == 3);
+  #endif
+
+  Threads::Set(0);
+  REQUIRE(Threads::Get() == defaultThreads);
+}
+
+/**
+ * Make sure that a ThreadBudget limits the regions it contains, is one thread
+ * inside a parallel region, and restores the previous settings.
+ */
+TEST_CASE("ThreadBudgetTest", "[ThreadsTest]")
+{
+  const size_t oldThreads = Threads::Get();
+  const size_t oldBLASThreads = Threads::BLASThreads();
+
+  {
+    ThreadBudget budget(2);
+    REQUIRE(budget.NumThreads() == std::min(oldThreads, (size_t) 2));
+    if (budget.NumThreads() > 1 && oldBLASThreads > 0)
+      REQUIRE(Threads::BLASThreads() == 1);
+
+    // Catch is not thread-safe, so the results are checked afterwards.
+    size_t teamSize = 1;
+    size_t nestedBudgets = 0;
+    size_t available = 0;
+    #pragma omp parallel reduction(+:nestedBudgets, available)
+    {
+      #ifdef MLPACK_USE_OPENMP
+      #pragma omp single
+      teamSize = omp_get_num_threads();
+      #endif
+
+      available += Threads::Available();
+      ThreadBudget nestedBudget;
+      nestedBudgets += nestedBudget.NumThreads();
+    }
+
+    REQUIRE(teamSize == budget.NumThreads());
+    REQUIRE(available == teamSize);
+    REQUIRE(nestedBudgets == teamSize);
+  }
+
+  REQUIRE(Threads::Get() == oldThreads);
+  REQUIRE(Threads::BLASThreads() == oldBLASThreads);
+}
+
+/**
+ * Make sure that FirstTouch() keeps the contents of matrices and vectors, and
+ * that data::Load() can use it.
+ */
+TEST_CASE("FirstTouchTest", "[ThreadsTest]")
+{
+  arma::mat m(7, 1000, arma::fill::randu);
+  arma::mat mCopy(m);
+  FirstTouch(m);
+  REQUIRE(m.n_rows == 7);
+  REQUIRE(m.n_cols == 1000);
+  REQUIRE(arma::approx_equal(m, mCopy, "absdiff", 0.0));
+
+  arma::fvec v(1500, arma::fill::randu);
+  arma::fvec vCopy(v);
+  FirstTouch(v);
+  REQUIRE(v.n_elem == 1500);
+  REQUIRE(arma::approx_equal(v, vCopy, "absdiff", 0.0));
+
+  arma::Row<size_t> r = arma::randi<arma::Row<size_t>>(999,
+      DistrParam(0, 100));
+  arma::Row<size_t> rCopy(r);
+  FirstTouch(r);
+  REQUIRE(arma::all(r == rCopy));
+
+  // Aliases of other memory are left alone.
+  arma::mat alias(mCopy.memptr(), 7, 1000, false, true);
+  FirstTouch(alias);
+  REQUIRE(alias.memptr() == mCopy.memptr());
+
+  REQUIRE(data::Save("first_touch_test.csv", mCopy));
+  arma::mat loaded;
+  REQUIRE(data::Load("first_touch_test.csv", loaded, true, true,
+      data::FileType::AutoDetect, true));
+  REQUIRE(loaded.n_rows == 7);
+  REQUIRE(loaded.n_cols == 1000);
+  REQUIRE(arma::approx_equal(loaded, mCopy, "absdiff", 1e-5));
+  remove("first_touch_test.csv");
+}
@@ -143,3 +143,130 @@ TEST_CASE("DisabledTimingTest", "[TimerTest]")
 
   REQUIRE(Timer::Get("test_timer") == std::chrono::microseconds(0));
 }
+
+/**
+ * Make sure that nested scoped timers are named after their enclosing scoped
+ * timers, and that their sections are recorded for the trace.
+ */
+TEST_CASE("ScopedTimerTest", "[TimerTest]")
+{
+  util::Timers timers;
+  timers.Enabled() = true;
+  timers.Tracing() = true;
+
+  {
+    util::ScopedTimer outer(timers, "outer");
+    REQUIRE(outer.Name() == "outer");
+    for (size_t i = 0; i < 2; ++i)
+    {
+      util::ScopedTimer inner(timers, "inner");
+      REQUIRE(inner.Name() == "outer/inner");
+      #ifdef _WIN32
+      Sleep(10);
+      #else
+      usleep(10000);
+      #endif
+    }
+  }
+
+  // The enclosing timer is gone, so this one is not prefixed.
+  {
+    util::ScopedTimer other(timers, "other");
+    REQUIRE(other.Name() == "other");
+  }
+
+  REQUIRE(timers.Get("outer/inner") >= std::chrono::microseconds(20000));
+  REQUIRE(timers.Get("outer") >= timers.Get("outer/inner"));
+  REQUIRE(timers.GetAllTimers().size() == 3);
+
+  std::ostringstream trace;
+  timers.PrintTrace(trace);
+  REQUIRE(trace.str().find("\"traceEvents\"") != std::string::npos);
+  REQUIRE(trace.str().find("\"name\": \"outer/inner\"") != std::string::npos);
+  REQUIRE(trace.str().find("\"name\": \"other\"") != std::string::npos);
+
+  // Nothing is timed or recorded when timing is disabled.
+  timers.Reset();
+  timers.Enabled() = false;
+  {
+    util::ScopedTimer disabled(timers, "disabled");
+    REQUIRE(disabled.Name() == "");
+  }
+  REQUIRE(timers.GetAllTimers().empty());
+}
+
+/**
+ * Make sure that the memory used while a timer runs is recorded: the peak of a
+ * phase includes memory that was allocated and freed during it.
+ */
+TEST_CASE("TimerMemoryTrackingTest", "[TimerTest]")
+{
+  util::Timers timers;
+  timers.Enabled() = true;
+  timers.MemoryTracking() = true;
+
+  const size_t current = util::MemoryTracker::CurrentBytes();
+  const size_t bytes = 1 << 20;
+
+  timers.Start("tracked");
+  {
+    util::TrackedBytes tracked(bytes);
+    REQUIRE(util::MemoryTracker::CurrentBytes() >= current + bytes);
+
+    util::ScopedTimer inner(timers, "inner");
+    util::TrackedBytes tracked2(2 * bytes);
+  }
+  timers.Stop("tracked");
+
+  REQUIRE(util::MemoryTracker::CurrentBytes() <= current);
+
+  util::PhaseMemory m = timers.GetMemory("tracked");
+  REQUIRE(m.peakTrackedBytes >= 3 * bytes);
+  REQUIRE(m.allocatedBytes >= 3 * bytes);
+  REQUIRE(m.allocations >= 2);
+
+  util::PhaseMemory inner = timers.GetMemory("inner");
+  REQUIRE(inner.peakTrackedBytes >= 3 * bytes);
+  REQUIRE(inner.allocatedBytes >= 2 * bytes);
+  REQUIRE(inner.allocations >= 1);
+
+  #ifdef __linux__
+  REQUIRE(m.peakRSS > 0);
+  #endif
+
+  // A second run is merged with the first.
+  timers.Start("tracked");
+  {
+    util::TrackedBytes tracked(bytes);
+  }
+  timers.Stop("tracked");
+  REQUIRE(timers.GetMemory("tracked").allocatedBytes >= 4 * bytes);
+  REQUIRE(timers.GetAllMemory().size() == 2);
+
+  // Nothing is recorded when memory tracking is disabled.
+  timers.Reset();
+  timers.MemoryTracking() = false;
+  timers.Start("untracked");
+  timers.Stop("untracked");
+  REQUIRE(timers.GetAllMemory().empty());
+}
+
+/**
+ * Make sure that the memory of the nodes of a tree is tracked.
+ */
+TEST_CASE("TreeMemoryTrackingTest", "[TimerTest]")
+{
+  arma::mat dataset(3, 1000, arma::fill::randu);
+
+  const size_t current = util::MemoryTracker::CurrentBytes();
+  {
+    KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset, 5);
+    REQUIRE(util::MemoryTracker::CurrentBytes() >= current +
+        sizeof(KDTree<EuclideanDistance, EmptyStatistic, arma::mat>));
+  }
+  REQUIRE(util::MemoryTracker::CurrentBytes() <= current);
+
+  REQUIRE(util::Timers::PrintBytes(512) == "512 B");
+  REQUIRE(util::Timers::PrintBytes(1536) == "1.5 KiB");
+  REQUIRE(util::Timers::PrintBytes(3 << 20) == "3.0 MiB");
+}
@@ -1030,6 +1030,54 @@ TEST_CASE("HRectBoundDiameter", "[TreeTest]")
   REQUIRE(d.Diameter() == Approx(0.0).margin(1e-5));
 }
 
+/**
+ * Ensure that a bound whose dimensionality is fixed by its distance metric
+ * gives the same results as the usual bound, and that it can't be created with
+ * a different dimensionality.
+ */
+TEST_CASE("HRectBoundFixedDim", "[TreeTest]")
+{
+  HRectBound<EuclideanDistance> a(3), b(3);
+  HRectBound<LMetric<2, true, 3>> fixedA(3), fixedB;
+  REQUIRE(fixedB.Dim() == 3);
+
+  for (size_t trial = 0; trial < 20; ++trial)
+  {
+    arma::mat points(3, 10, arma::fill::randn);
+    a.Clear();
+    b.Clear();
+    fixedA.Clear();
+    fixedB.Clear();
+    a |= points.cols(0, 4);
+    b |= points.cols(5, 9);
+    fixedA |= points.cols(0, 4);
+    fixedB |= points.cols(5, 9);
+
+    for (size_t d = 0; d < 3; ++d)
+    {
+      REQUIRE(fixedA[d].Lo() == a[d].Lo());
+      REQUIRE(fixedA[d].Hi() == a[d].Hi());
+    }
+
+    const arma::vec point(3, arma::fill::randn);
+    REQUIRE(fixedA.MinDistance(fixedB) == Approx(a.MinDistance(b)));
+    REQUIRE(fixedA.MaxDistance(fixedB) == Approx(a.MaxDistance(b)));
+    REQUIRE(fixedA.MinDistance(point) == Approx(a.MinDistance(point)));
+    REQUIRE(fixedA.MaxDistance(point) == Approx(a.MaxDistance(point)));
+    REQUIRE(fixedA.Diameter() == Approx(a.Diameter()));
+    REQUIRE(fixedA.Contains(point) == a.Contains(point));
+    REQUIRE(LMetric<2, true, 3>::Evaluate(point, points.col(0)) ==
+        Approx(EuclideanDistance::Evaluate(point, points.col(0))));
+  }
+
+  HRectBound<LMetric<2, true, 3>> copy(fixedA);
+  REQUIRE(copy.MinDistance(fixedB) == Approx(a.MinDistance(b)));
+  HRectBound<LMetric<2, true, 3>> moved(std::move(copy));
+  REQUIRE(moved.MinDistance(fixedB) == Approx(a.MinDistance(b)));
+
+  REQUIRE_THROWS_AS(HRectBound<LMetric<2, true, 3>>(4), std::invalid_argument);
+}
+
 /**
  * It seems as though Bill has stumbled across a bug where
  * BinarySpaceTree<>::count() returns something different than
@@ -1772,6 +1820,157 @@ TEST_CASE("BinarySpaceTreeMoveConstructorTest", "[TreeTest]")
   REQUIRE(tree2.NumChildren() == 2);
 }
 
+// Make sure two binary space trees have the same structure, and that the
+// parent pointers of the first tree are correct.
+template<typename TreeType>
+void CheckSameBinarySpaceTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Begin() == b.Begin());
+  REQUIRE(a.Count() == b.Count());
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  for (size_t d = 0; d < a.Bound().Dim(); ++d)
+  {
+    REQUIRE(a.Bound()[d].Lo() == Approx(b.Bound()[d].Lo()));
+    REQUIRE(a.Bound()[d].Hi() == Approx(b.Bound()[d].Hi()));
+  }
+
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+  {
+    REQUIRE(a.Child(i).Parent() == &a);
+    REQUIRE(&a.Child(i).Dataset() == &a.Dataset());
+    CheckSameBinarySpaceTree(a.Child(i), b.Child(i));
+  }
+}
+
+/**
+ * Make sure that compacting a tree keeps its structure, and stores the nodes
+ * contiguously in breadth-first order.
+ */
+TEST_CASE("BinarySpaceTreeCompactTest", "[TreeTest]")
+{
+  arma::mat dataset(4, 1000, arma::fill::randu);
+
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset, 5);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> original(tree);
+
+  REQUIRE(!tree.IsCompact());
+  tree.Compact();
+  REQUIRE(tree.IsCompact());
+
+  CheckSameBinarySpaceTree(tree, original);
+
+  // Check breadth-first order in memory.
+  std::queue<KDTree<EuclideanDistance, EmptyStatistic, arma::mat>*> queue;
+  queue.push(tree.Left());
+  queue.push(tree.Right());
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat>* expected = tree.Left();
+  while (!queue.empty())
+  {
+    REQUIRE(queue.front() == expected);
+    if (!queue.front()->IsLeaf())
+    {
+      queue.push(queue.front()->Left());
+      queue.push(queue.front()->Right());
+    }
+    queue.pop();
+    ++expected;
+  }
+
+  // Compacting again should do nothing.
+  tree.Compact();
+  CheckSameBinarySpaceTree(tree, original);
+
+  // A copy of the tree is not compact, but has the same structure.
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> copy(tree);
+  REQUIRE(!copy.IsCompact());
+  CheckSameBinarySpaceTree(copy, original);
+
+  // Moving the tree keeps it compact.
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> moved(std::move(tree));
+  REQUIRE(moved.IsCompact());
+  REQUIRE(!tree.IsCompact());
+  CheckSameBinarySpaceTree(moved, original);
+
+  // Move assignment must free the old compacted nodes and take the new ones.
+  copy.Compact();
+  copy = std::move(moved);
+  REQUIRE(copy.IsCompact());
+  CheckSameBinarySpaceTree(copy, original);
+}
+
+/**
+ * Make sure that trees whose nodes are held in node pools can be assigned to
+ * each other, and that the assigned trees are correct.
+ */
+TEST_CASE("BinarySpaceTreeNodePoolTest", "[TreeTest]")
+{
+  arma::mat dataset(3, 5000, arma::fill::randu);
+  arma::mat dataset2(3, 3000, arma::fill::randu);
+
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree(dataset, 2);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> original(tree);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree2(dataset2, 2);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree3(dataset2, 2);
+
+  // Copy assignment must free the old pooled nodes.
+  tree2 = tree;
+  CheckSameBinarySpaceTree(tree2, original);
+
+  // Move assignment must free the old pooled nodes, and take the new ones.
+  tree3 = std::move(tree);
+  CheckSameBinarySpaceTree(tree3, original);
+  REQUIRE(tree.NumChildren() == 0);
+
+  // A tree built from a moved tree is still correct once the tree that it was
+  // moved from is gone.
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat>* moved =
+      new KDTree<EuclideanDistance, EmptyStatistic, arma::mat>(dataset2, 2);
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> tree4(
+      std::move(*moved));
+  delete moved;
+  KDTree<EuclideanDistance, EmptyStatistic, arma::mat> copy(tree4);
+  tree4.Compact();
+  REQUIRE(tree4.IsCompact());
+  CheckSameBinarySpaceTree(tree4, copy);
+}
+
+/**
+ * Make sure that building a tree with several threads gives the same tree and
+ * the same mappings as building it with one thread.
+ */
+TEMPLATE_TEST_CASE("BinarySpaceTreeParallelBuildTest", "[TreeTest]",
+    (KDTree<EuclideanDistance, EmptyStatistic, arma::mat>),
+    (MeanSplitKDTree<EuclideanDistance, EmptyStatistic, arma::mat>))
+{
+  using TreeType = TestType;
+
+  arma::mat dataset(4, 40000, arma::fill::randu);
+  std::vector<size_t> oldFromNew, newFromOld;
+  std::vector<size_t> serialOldFromNew, serialNewFromOld;
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  TreeType serialTree(dataset, serialOldFromNew, serialNewFromOld, 5);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+  #endif
+
+  TreeType tree(dataset, oldFromNew, newFromOld, 5);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  REQUIRE(oldFromNew == serialOldFromNew);
+  REQUIRE(newFromOld == serialNewFromOld);
+  CheckMatrices(tree.Dataset(), serialTree.Dataset());
+  CheckSameBinarySpaceTree(tree, serialTree);
+}
+
 template<typename TreeType>
 void RecurseTreeCountLeaves(const TreeType& node, arma::vec& counts)
 {
@@ -1920,6 +2119,72 @@ TEST_CASE("CoverTreeConstructionTest", "[TreeTest]")
   // implementation.
 }
 
+// Check that two cover trees have the same structure.
+template<typename TreeType>
+void CheckSameCoverTree(const TreeType& a, const TreeType& b)
+{
+  REQUIRE(a.Point() == b.Point());
+  REQUIRE(a.Scale() == b.Scale());
+  REQUIRE(a.NumDescendants() == b.NumDescendants());
+  REQUIRE(a.ParentDistance() == Approx(b.ParentDistance()).epsilon(1e-7));
+  REQUIRE(a.FurthestDescendantDistance() ==
+      Approx(b.FurthestDescendantDistance()).epsilon(1e-7));
+  REQUIRE(a.NumChildren() == b.NumChildren());
+  for (size_t i = 0; i < a.NumChildren(); ++i)
+    CheckSameCoverTree(a.Child(i), b.Child(i));
+}
+
+/**
+ * Make sure that a cover tree built with several threads is the same as one
+ * built with one thread, and that the build works for float data too.
+ */
+TEST_CASE("CoverTreeParallelBuildTest", "[TreeTest]")
+{
+  // The point set of the root is large enough to use several threads.
+  arma::mat dataset(3, 20000, arma::fill::randu);
+
+  using TreeType =
+      StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::mat>;
+
+  #ifdef MLPACK_USE_OPENMP
+  const int oldThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  TreeType serialTree(dataset);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(4);
+  #endif
+
+  TreeType tree(dataset);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(oldThreads);
+  #endif
+
+  CheckSameCoverTree(tree, serialTree);
+
+  arma::vec counts;
+  counts.zeros(dataset.n_cols);
+  RecurseTreeCountLeaves(tree, counts);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(counts[i] == 1);
+
+  // The distances are stored as doubles during the build of float trees too.
+  using FloatTreeType =
+      StandardCoverTree<EuclideanDistance, EmptyStatistic, arma::fmat>;
+  arma::fmat floatDataset = arma::conv_to<arma::fmat>::from(dataset);
+  FloatTreeType floatTree(floatDataset);
+
+  counts.zeros();
+  RecurseTreeCountLeaves(floatTree, counts);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    REQUIRE(counts[i] == 1);
+
+  CheckSelfChild<FloatTreeType>(floatTree);
+}
+
 /**
  * Create a cover tree on sparse data and make sure it's accurate.
  */
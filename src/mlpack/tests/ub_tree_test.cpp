@@ -93,6 +93,43 @@ TEST_CASE("UBTreeSplitTest", "[UBTreeTest]")
   CheckSplit(tree);
 }
 
+/**
+ * Make sure that the radix sort of the addresses puts the dataset in address
+ * order, with duplicate points and large enough datasets to sort the buckets
+ * in parallel, and that the mappings are correct.
+ */
+TEMPLATE_TEST_CASE("UBTreeSortTest", "[UBTreeTest]", float, double)
+{
+  using ElemType = TestType;
+  using AddressElemType = std::conditional_t<
+      (sizeof(ElemType) * CHAR_BIT <= 32), uint32_t, uint64_t>;
+  using TreeType = UBTree<EuclideanDistance, EmptyStatistic,
+      arma::Mat<ElemType>>;
+
+  arma::Mat<ElemType> dataset(3, 50000, arma::fill::randn);
+  dataset.cols(40000, 49999) = dataset.cols(0, 9999);
+  dataset.col(100).zeros();
+
+  std::vector<size_t> oldFromNew;
+  TreeType tree(dataset, oldFromNew);
+  const arma::Mat<ElemType>& sorted = tree.Dataset();
+
+  arma::Col<AddressElemType> address(dataset.n_rows);
+  arma::Col<AddressElemType> lastAddress(dataset.n_rows);
+  for (size_t i = 0; i < sorted.n_cols; ++i)
+  {
+    REQUIRE(arma::approx_equal(sorted.col(i), dataset.col(oldFromNew[i]),
+        "absdiff", 0.0));
+
+    PointToAddress(address, sorted.col(i));
+    if (i > 0)
+      REQUIRE(CompareAddresses(lastAddress, address) <= 0);
+    lastAddress = address;
+  }
+
+  CheckSplit(tree);
+}
+
 template<typename TreeType>
 void CheckBound(const TreeType& tree)
 {
@@ -11,6 +11,7 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/emst/union_find.hpp>
+#include <mlpack/methods/emst/concurrent_union_find.hpp>
 #include "catch.hpp"
 
 using namespace mlpack;
@@ -45,3 +46,19 @@ TEST_CASE("TestUnion", "[UnionFindTest]")
   REQUIRE(testUnionFind.Find(1) == testUnionFind.Find(5));
   REQUIRE(testUnionFind.Find(6) == testUnionFind.Find(3));
 }
+
+TEST_CASE("TestConcurrentUnion", "[UnionFindTest]")
+{
+  static const size_t testSize = 10000;
+  ConcurrentUnionFind testUnionFind(testSize);
+
+  // Connect all even and all odd points, from many threads and in an order
+  // that creates long chains.
+  #pragma omp parallel for schedule(dynamic, 16)
+  for (size_t i = 0; i < testSize - 2; ++i)
+    testUnionFind.Union(testSize - 1 - i, testSize - 3 - i);
+
+  // The root of a component is its smallest element.
+  for (size_t i = 0; i < testSize; ++i)
+    REQUIRE(testUnionFind.Find(i) == i % 2);
+}
@@ -11,9 +11,12 @@
  */
 #include <mlpack/core.hpp>
 #include <mlpack/methods/xgboost/loss_functions/sse_loss.hpp>
+#include <mlpack/methods/xgboost.hpp>
+#include <mlpack/methods/decision_tree.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
+#include "test_catch_tools.hpp"
 
 using namespace mlpack;
 
@@ -63,3 +66,185 @@ TEST_CASE("SSEGainTest", "[XGBTest]")
   SSELoss Loss;
   REQUIRE(Loss.Evaluate<false>(input, weights) == gain);
 }
+
+/**
+ * Test that the second order gain is the MSE gain when there is no
+ * regularization, and that it is smaller with regularization.
+ */
+TEST_CASE("SecondOrderGainMSETest", "[XGBTest]")
+{
+  arma::rowvec values = { 1, 3, 2, 2, 5, 6, 9, 11, 8, 8 };
+  arma::rowvec weights = { 1, 0.5, 2, 1, 1, 3, 0.25, 1, 1, 2 };
+
+  SecondOrderGain gain;
+  REQUIRE(gain.Evaluate<true>(values, weights) ==
+      Approx(MSEGain::Evaluate<true>(values, weights)).epsilon(1e-7));
+  REQUIRE(gain.Evaluate<false>(values, weights) ==
+      Approx(MSEGain::Evaluate<false>(values, weights)).epsilon(1e-7));
+
+  SecondOrderGain regularizedGain(1.0);
+  REQUIRE(regularizedGain.Evaluate<true>(values, weights) <
+      gain.Evaluate<true>(values, weights));
+
+  // The leaf value is the regularized weighted mean.
+  REQUIRE(regularizedGain.OutputLeafValue<true>(values, weights) ==
+      Approx(accu(values % weights) / (accu(weights) + 1.0)).epsilon(1e-7));
+}
+
+/**
+ * Test that a boosted regressor fits a nonlinear function much better than a
+ * constant, and that more trees fit better.
+ */
+TEST_CASE("XGBoostRegressorFitTest", "[XGBTest]")
+{
+  arma::mat data(3, 1000, arma::fill::randu);
+  arma::rowvec responses = arma::sin(6.0 * data.row(0)) + 2.0 * data.row(1) %
+      data.row(2) + 0.05 * arma::randn<arma::rowvec>(data.n_cols);
+
+  arma::mat testData(3, 500, arma::fill::randu);
+  arma::rowvec testResponses = arma::sin(6.0 * testData.row(0)) + 2.0 *
+      testData.row(1) % testData.row(2);
+
+  XGBoostRegressor<> small(data, responses, 5);
+  XGBoostRegressor<> xgb;
+  const double trainLoss = xgb.Train(data, responses, 100, 0.3, 4, 5);
+
+  REQUIRE(xgb.NumTrees() == 100);
+  REQUIRE(std::isfinite(trainLoss));
+
+  arma::rowvec smallPredictions, predictions;
+  small.Predict(testData, smallPredictions);
+  xgb.Predict(testData, predictions);
+
+  const double variance = arma::var(testResponses);
+  const double smallMSE = arma::mean(arma::square(smallPredictions -
+      testResponses));
+  const double mse = arma::mean(arma::square(predictions - testResponses));
+  REQUIRE(mse < 0.1 * variance);
+  REQUIRE(mse < smallMSE);
+
+  // The batch predictions are the same as those of each point.
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE(predictions[i] == Approx(xgb.Predict(testData.col(i))));
+}
+
+/**
+ * Test that column subsampling still gives a good fit.
+ */
+TEST_CASE("XGBoostRegressorColSampleTest", "[XGBTest]")
+{
+  arma::mat data(10, 1000, arma::fill::randu);
+  arma::rowvec responses = 3.0 * data.row(0) - 2.0 * data.row(5);
+
+  XGBoostRegressor<> xgb(data, responses, 100, 0.3, 4, 5, 1e-7, 1.0, 0.5);
+
+  arma::rowvec predictions;
+  xgb.Predict(data, predictions);
+  const double mse = arma::mean(arma::square(predictions - responses));
+  REQUIRE(mse < 0.05 * arma::var(responses));
+}
+
+/**
+ * Test binary classification on two separable clouds of points.
+ */
+TEST_CASE("XGBoostClassifierBinaryTest", "[XGBTest]")
+{
+  arma::mat data(2, 1000, arma::fill::randn);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = i % 2;
+    data.col(i) += (labels[i] == 0) ? -2.0 : 2.0;
+  }
+
+  XGBoostClassifier xgb;
+  const double trainLoss = xgb.Train(data, labels, 2, 20);
+
+  REQUIRE(xgb.NumScores() == 1);
+  REQUIRE(xgb.NumTrees() == 20);
+  REQUIRE(trainLoss < 0.2);
+
+  arma::Row<size_t> predictions;
+  arma::mat probabilities;
+  xgb.Classify(data, predictions, probabilities);
+
+  REQUIRE(probabilities.n_rows == 2);
+  for (size_t i = 0; i < data.n_cols; ++i)
+    REQUIRE(accu(probabilities.col(i)) == Approx(1.0));
+  REQUIRE(accu(predictions == labels) >= 0.95 * data.n_cols);
+}
+
+/**
+ * Test multiclass classification on the vc2 dataset, making sure that the
+ * accuracy is comparable to a single decision tree.
+ */
+TEST_CASE("XGBoostClassifierMulticlassTest", "[XGBTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+  arma::Row<size_t> testLabels;
+  if (!data::Load("vc2_test_labels.txt", testLabels))
+    FAIL("Cannot load dataset vc2_test_labels.txt");
+
+  XGBoostClassifier xgb(dataset, labels, 3, 50, 0.3, 4);
+  DecisionTree<> dt(dataset, labels, 3, 5);
+
+  REQUIRE(xgb.NumScores() == 3);
+  REQUIRE(xgb.NumTrees() == 150);
+
+  arma::Row<size_t> xgbPredictions, dtPredictions;
+  xgb.Classify(testDataset, xgbPredictions);
+  dt.Classify(testDataset, dtPredictions);
+
+  const size_t xgbCorrect = accu(xgbPredictions == testLabels);
+  const size_t dtCorrect = accu(dtPredictions == testLabels);
+  REQUIRE(xgbCorrect >= dtCorrect * 0.9);
+  REQUIRE(xgbCorrect >= size_t(0.7 * testDataset.n_cols));
+
+  // The batch predictions are the same as those of each point.
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+    REQUIRE(xgbPredictions[i] == xgb.Classify(testDataset.col(i)));
+}
+
+/**
+ * Make sure that a trained classifier gives the same predictions after
+ * serialization.
+ */
+TEST_CASE("XGBoostClassifierSerializationTest", "[XGBTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+
+  XGBoostClassifier xgb(dataset, labels, 3, 10, 0.3, 4);
+
+  arma::Row<size_t> beforePredictions;
+  arma::mat beforeProbabilities;
+  xgb.Classify(dataset, beforePredictions, beforeProbabilities);
+
+  XGBoostClassifier xmlXGB, jsonXGB, binaryXGB;
+  binaryXGB.Train(dataset, labels, 3, 2);
+  SerializeObjectAll(xgb, xmlXGB, jsonXGB, binaryXGB);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, jsonProbabilities, binaryProbabilities;
+
+  xmlXGB.Classify(dataset, xmlPredictions, xmlProbabilities);
+  jsonXGB.Classify(dataset, jsonPredictions, jsonProbabilities);
+  binaryXGB.Classify(dataset, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(beforePredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+  CheckMatrices(beforeProbabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities);
+}